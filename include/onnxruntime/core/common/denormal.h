@@ -9,4 +9,25 @@ namespace onnxruntime {
 // Return true if SSE3 instruction is supported, otherwise return false.
 bool SetDenormalAsZero(bool on);
 
+// Return true if flush-to-zero and denormal-as-zero are set for the calling thread.
+bool IsDenormalAsZero();
+
+// Return true if the calling thread is in the scope of a ScopedDenormalAsZero which set flush-to-zero and
+// denormal-as-zero. The intra-op thread pool runs the parallel loops of such a thread the same way.
+bool InDenormalAsZeroScope();
+
+// Set flush-to-zero and denormal-as-zero for the calling thread during the lifetime of this object, if they are not
+// set already, e.g. to run a kernel which is not sensitive to denormals.
+class ScopedDenormalAsZero {
+ public:
+  ScopedDenormalAsZero();
+  ~ScopedDenormalAsZero();
+
+  ScopedDenormalAsZero(const ScopedDenormalAsZero&) = delete;
+  ScopedDenormalAsZero& operator=(const ScopedDenormalAsZero&) = delete;
+
+ private:
+  bool set_ = false;
+};
+
 }  // namespace onnxruntime
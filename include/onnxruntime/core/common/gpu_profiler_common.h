@@ -3,11 +3,13 @@
 #include "core/common/profiler_common.h"
 #include "core/common/inlined_containers.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -31,6 +33,11 @@ namespace profiling {
 // We solve this by implementing base classes that are common to all GPU profilers
 // inline in this header.
 
+// Values of the "kind" argument of the GPU events, which tells the kernels from the memory copies.
+// Events without a "kind" argument are counted as kernels.
+static constexpr const char* kGPUKernelEventKind = "kernel";
+static constexpr const char* kGPUMemcpyEventKind = "memcpy";
+
 class ProfilerActivityBuffer {
  public:
   ProfilerActivityBuffer() noexcept
@@ -376,60 +383,96 @@ class GPUProfilerBase : public EpProfiler {
   GPUProfilerBase() = default;
   virtual ~GPUProfilerBase() {}
 
+  // Inserts the GPU events of each op after the event of the op, the event recorded by the CPU profiler with the
+  // timestamp the op was started with. The events are matched on their timestamp rather than on their position, as
+  // the CPU events are recorded when they end and are not sorted by timestamp. When several CPU events share the
+  // timestamp, the last one recorded is taken: it encloses the others, which ended before it.
   void MergeEvents(std::map<uint64_t, Events>& events_to_merge, Events& events) {
-    Events merged_events;
+    std::unordered_map<long long, size_t> parent_index_by_ts;
+    for (size_t i = 0; i < events.size(); ++i) {
+      parent_index_by_ts[events[i].ts] = i;
+    }
 
-    auto event_iter = std::make_move_iterator(events.begin());
-    auto event_end = std::make_move_iterator(events.end());
+    std::vector<Events*> children_by_parent(events.size(), nullptr);
+    Events orphans;
     for (auto& map_iter : events_to_merge) {
       if (map_iter.second.empty()) {
         continue;
       }
 
-      auto ts = static_cast<long long>(map_iter.first);
-
-      // find the last occurrence of a matching timestamp,
-      // if one exists
-      while (event_iter != event_end &&
-             (event_iter->ts < ts ||
-              (event_iter->ts == ts &&
-               (event_iter + 1) != event_end &&
-               (event_iter + 1)->ts == ts))) {
-        merged_events.emplace_back(*event_iter);
-        ++event_iter;
+      auto parent_it = parent_index_by_ts.find(static_cast<long long>(map_iter.first));
+      if (parent_it == parent_index_by_ts.end()) {
+        orphans.insert(orphans.end(),
+                       std::make_move_iterator(map_iter.second.begin()),
+                       std::make_move_iterator(map_iter.second.end()));
+        continue;
       }
 
-      bool copy_op_names = false;
-      std::string op_name;
-      std::string parent_name;
-
-      if (event_iter != event_end && event_iter->ts == ts) {
-        // We've located a parent event, copy the op_name and set
-        // this event's parent_name property to the name of the parent.
-        copy_op_names = true;
-        op_name = event_iter->args["op_name"];
-        parent_name = event_iter->name;
-        merged_events.emplace_back(*event_iter);
-        ++event_iter;
+      auto& parent = events[parent_it->second];
+      const std::string op_name = parent.args["op_name"];
+      for (auto& evt : map_iter.second) {
+        // Inherit some names from the parent.
+        evt.args["op_name"] = op_name;
+        evt.args["parent_name"] = parent.name;
       }
+      AddGPUSummary(map_iter.second, parent);
+      children_by_parent[parent_it->second] = &map_iter.second;
+    }
 
-      for (auto& evt : map_iter.second) {
-        if (copy_op_names) {
-          // If we have found a matching parent event,
-          // then inherit some names from the parent.
-          evt.args["op_name"] = op_name;
-          evt.args["parent_name"] = parent_name;
-        }
+    Events merged_events;
+    merged_events.reserve(events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+      merged_events.emplace_back(std::move(events[i]));
+      if (children_by_parent[i] != nullptr) {
+        merged_events.insert(merged_events.end(),
+                             std::make_move_iterator(children_by_parent[i]->begin()),
+                             std::make_move_iterator(children_by_parent[i]->end()));
       }
+    }
+    merged_events.insert(merged_events.end(),
+                         std::make_move_iterator(orphans.begin()),
+                         std::make_move_iterator(orphans.end()));
+    std::swap(events, merged_events);
+  }
+
+  // Adds to the event of an op the breakdown of its GPU work, in microseconds: the time of its kernels
+  // ("gpu_kernel_dur") and copies ("gpu_memcpy_dur"), the host time spent launching them ("gpu_launch_dur"), the time
+  // from the start of its first to the end of its last GPU event ("gpu_span_dur") and the part of it during which none
+  // of them ran ("gpu_idle_dur"). An op whose idle time dominates is bound by the launches rather than the device.
+  static void AddGPUSummary(const Events& gpu_events, EventRecord& parent) {
+    long long kernel_dur = 0;
+    long long memcpy_dur = 0;
+    long long launch_dur = 0;
+    std::vector<std::pair<long long, long long>> intervals;
+    intervals.reserve(gpu_events.size());
+    for (const auto& evt : gpu_events) {
+      auto kind_it = evt.args.find("kind");
+      if (kind_it != evt.args.end() && kind_it->second == kGPUMemcpyEventKind) {
+        memcpy_dur += evt.dur;
+      } else {
+        kernel_dur += evt.dur;
+      }
+      auto launch_it = evt.args.find("launch_dur");
+      if (launch_it != evt.args.end()) {
+        launch_dur += std::stoll(launch_it->second);
+      }
+      intervals.emplace_back(evt.ts, evt.ts + evt.dur);
+    }
 
-      merged_events.insert(merged_events.end(),
-                           std::make_move_iterator(map_iter.second.begin()),
-                           std::make_move_iterator(map_iter.second.end()));
+    std::sort(intervals.begin(), intervals.end());
+    long long busy_dur = 0;
+    long long busy_end = intervals.front().first;
+    for (const auto& [begin, end] : intervals) {
+      busy_dur += std::max(0LL, end - std::max(begin, busy_end));
+      busy_end = std::max(busy_end, end);
     }
+    const long long span_dur = busy_end - intervals.front().first;
 
-    // move any remaining events
-    merged_events.insert(merged_events.end(), event_iter, event_end);
-    std::swap(events, merged_events);
+    parent.args["gpu_kernel_dur"] = std::to_string(kernel_dur);
+    parent.args["gpu_memcpy_dur"] = std::to_string(memcpy_dur);
+    parent.args["gpu_launch_dur"] = std::to_string(launch_dur);
+    parent.args["gpu_span_dur"] = std::to_string(span_dur);
+    parent.args["gpu_idle_dur"] = std::to_string(span_dur - busy_dur);
   }
 
   uint64_t client_handle_;
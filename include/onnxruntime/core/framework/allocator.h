@@ -20,16 +20,18 @@ struct OrtArenaCfg {
                   initial_chunk_size_bytes(-1),
                   max_dead_bytes_per_chunk(-1),
                   initial_growth_chunk_size_bytes(-1),
-                  max_power_of_two_extend_bytes(-1) {}
+                  max_power_of_two_extend_bytes(-1),
+                  thread_cache_max_chunk_size_bytes(-1) {}
   OrtArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
               int max_dead_bytes_per_chunk, int initial_growth_chunk_size_bytes,
-              int64_t max_power_of_two_extend_bytes)
+              int64_t max_power_of_two_extend_bytes, int thread_cache_max_chunk_size_bytes = -1)
       : max_mem(max_mem),
         arena_extend_strategy(arena_extend_strategy),
         initial_chunk_size_bytes(initial_chunk_size_bytes),
         max_dead_bytes_per_chunk(max_dead_bytes_per_chunk),
         initial_growth_chunk_size_bytes(initial_growth_chunk_size_bytes),
-        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes) {}
+        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes),
+        thread_cache_max_chunk_size_bytes(thread_cache_max_chunk_size_bytes) {}
 
   size_t max_mem;                         // use 0 to allow ORT to choose the default
   int arena_extend_strategy;              // use -1 to allow ORT to choose the default, 0 = kNextPowerOfTwo, 1 = kSameAsRequested
@@ -37,6 +39,7 @@ struct OrtArenaCfg {
   int max_dead_bytes_per_chunk;           // use -1 to allow ORT to choose the default
   int initial_growth_chunk_size_bytes;    // use -1 to allow ORT to choose the default
   int64_t max_power_of_two_extend_bytes;  // use -1 to allow ORT to choose the default
+  int thread_cache_max_chunk_size_bytes;  // use -1 to allow ORT to choose the default, 0 disables the thread caches
 };
 
 namespace onnxruntime {
@@ -88,6 +91,14 @@ class IAllocator {
   // By default, the base implementation  just calls Alloc().
   virtual void* Reserve(size_t size) { return Alloc(size); }
 
+  // Stream-ordered allocators, e.g. a device memory pool that the driver reuses in the order of the work on a stream,
+  // override these. Memory from AllocStreamOrdered() is used with `stream` and may be reused by later work on it once
+  // freed. ReleaseStreamOrderedBuffers() is called when the work of `stream` for a run is done, after which its memory
+  // may be reused by any stream.
+  virtual bool IsStreamOrdered() const { return false; }
+  virtual void* AllocStreamOrdered(size_t size, Stream* /*stream*/) { return Alloc(size); }
+  virtual void ReleaseStreamOrderedBuffers(Stream* /*stream*/) {}
+
   const OrtMemoryInfo& Info() const { return memory_info_; };
 
   // Each implementation of IAllocator can override and provide their own implementation
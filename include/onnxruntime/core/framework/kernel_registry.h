@@ -6,6 +6,7 @@
 #include <string_view>
 
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -79,12 +80,25 @@ class KernelRegistry {
   }
 
  private:
+  // The result of matching the kernels of a node: the kernel found, or the reasons why each kernel did not match.
+  struct KernelLookup {
+    const KernelCreateInfo* kernel_create_info = nullptr;
+    std::vector<std::string> errors;
+  };
+
   // TryFindKernel implementation. Either kernel_type_str_resolver or type_constraints is provided.
   Status TryFindKernelImpl(const Node& node, ProviderType exec_provider,
                            const IKernelTypeStrResolver* kernel_type_str_resolver,
                            const TypeConstraintMap* type_constraints,
                            const KernelCreateInfo** out) const;
 
+  static Status KernelLookupStatus(const Node& node, std::string_view provider, const KernelLookup& lookup,
+                                   const KernelCreateInfo** out);
+
+  // The key of the lookups of the nodes which match the same kernel: the op, domain, since version and the types
+  // of the arguments of the node, and the provider.
+  static std::string GetKernelLookupKey(const Node& node, std::string_view provider);
+
   // Check whether the types of inputs/outputs of the given node match the extra
   // type-constraints of the given kernel. This serves two purposes: first, to
   // select the right kernel implementation based on the types of the arguments
@@ -121,5 +135,11 @@ class KernelRegistry {
   // Kernel create function map from op name to kernel creation info.
   // key is opname+domain_name+provider_name
   KernelCreateMap kernel_creator_fn_map_;
+
+  // Lookups of nodes using the types from the node, by GetKernelLookupKey(). The registries of the execution
+  // providers are shared by the sessions, so the kernel matching is done once per distinct node signature in the
+  // process rather than for every node of every graph and subgraph. Cleared when a kernel is registered.
+  mutable OrtMutex kernel_lookup_cache_mutex_;
+  mutable InlinedHashMap<std::string, KernelLookup> kernel_lookup_cache_;
 };
 }  // namespace onnxruntime
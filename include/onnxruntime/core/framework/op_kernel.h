@@ -129,6 +129,16 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to return true if UseSharedPrePackedBuffers() restores all the state PrePack() sets for
+  // the tensor of input_idx, so that the session can skip PrePack() when the pre-packed buffers of the tensor were
+  // persisted by a previous session (see kOrtSessionOptionsConfigPrepackedWeightsFile).
+  // This is only valid if the pre-packed buffers of input_idx depend on nothing but that tensor, the attributes of
+  // the node and the CPU features.
+  // @param input_idx: The input index of the tensor in this kernel
+  virtual bool CanSkipPrePackWithPersistedBuffers(int /*input_idx*/) const {
+    return false;
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
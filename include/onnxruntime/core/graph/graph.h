@@ -1696,6 +1696,10 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
 
   bool graph_proto_sync_needed_ = false;
 
+  // The NodeProtos of the GraphProto the graph was created from have been released, so the GraphProto needs to be
+  // synced even if the graph has not changed since it was loaded.
+  bool graph_proto_nodes_released_ = false;
+
   // The topological order of node index used to do node and op match verification temporarily.
   std::vector<NodeIndex> nodes_in_topological_order_;
 
@@ -5,6 +5,7 @@
 
 #include "core/graph/graph.h"
 #include "core/framework/session_options.h"
+#include <mutex>
 #include <unordered_set>
 
 namespace onnxruntime {
@@ -205,6 +206,11 @@ class GraphViewer {
 #if !defined(ORT_MINIMAL_BUILD)
   // The NodeIndex values of the graph nodes sorted in topological order with priority.
   std::vector<NodeIndex> nodes_in_topological_order_with_priority_;
+
+  // The NodeIndex values of the graph nodes sorted in memory minimizing topological order.
+  // Computed on first use, as it is more expensive than the other orders and rarely used.
+  mutable std::once_flag nodes_in_memory_minimizing_topological_order_flag_;
+  mutable std::vector<NodeIndex> nodes_in_memory_minimizing_topological_order_;
 #endif
 
 #ifdef ENABLE_TRAINING
@@ -11,6 +11,9 @@
 #include "core/optimizer/graph_transformer_level.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
 
 /**
 @class GraphTransformer
@@ -43,6 +46,11 @@ class GraphTransformer {
 
   virtual bool ShouldOnlyApplyOnce() const { return false; }
 
+  /** Sets the thread pool RecurseConcurrently may transform subgraphs on. nullptr transforms them sequentially. */
+  void SetThreadPool(concurrency::ThreadPool* thread_pool) noexcept {
+    thread_pool_ = thread_pool;
+  }
+
  protected:
   /** Helper method to call ApplyImpl on any subgraphs in the Node. */
   Status Recurse(Node& node, bool& modified, int graph_level, const logging::Logger& logger) const {
@@ -55,6 +63,14 @@ class GraphTransformer {
     return Status::OK();
   }
 
+  /** Helper method to call ApplyImpl on the subgraphs of the nodes, which must be nodes of the same graph.
+  The subgraphs of the main graph are transformed concurrently on the thread pool set with SetThreadPool, if any.
+  Only transformers whose ApplyImpl modifies nothing but the graph it is given and its subgraphs may call it.
+  Nested subgraphs are transformed sequentially by the thread transforming their parent graph.
+  */
+  Status RecurseConcurrently(gsl::span<Node* const> nodes, bool& modified, int graph_level,
+                             const logging::Logger& logger) const;
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GraphTransformer);
 
@@ -69,6 +85,7 @@ class GraphTransformer {
 
   const std::string name_;
   const InlinedHashSet<std::string_view> compatible_provider_types_;
+  concurrency::ThreadPool* thread_pool_ = nullptr;
 };
 
 /**
@@ -39,6 +39,8 @@
 #pragma warning(disable : 4127)
 #pragma warning(disable : 4805)
 #endif
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include "unsupported/Eigen/CXX11/ThreadPool"
 
@@ -78,6 +80,8 @@
 //
 //   This spin-then-block behavior is configured via a flag provided
 //   when creating the thread pool, and by the constant spin_count.
+//   With ThreadOptions::adaptive_spinning, each worker tunes how long
+//   it spins from the idle gaps it observed (see AdaptiveSpin).
 //
 // - Although all tasks are simple void()->void functions,
 //   conceptually there are three different kinds:
@@ -230,6 +234,9 @@ class ThreadPoolProfiler {
   void LogStartAndCoreAndBlock(std::ptrdiff_t){};
   void LogCoreAndBlock(std::ptrdiff_t){};
   void LogThreadId(int){};
+  void LogSpinStart(int){};
+  void LogSpinEnd(int){};
+  void LogRunStart(int){};
   void LogRun(int){};
   std::string DumpChildThreadStat() { return {}; }
 };
@@ -256,7 +263,10 @@ class ThreadPoolProfiler {
   void LogStartAndCoreAndBlock(std::ptrdiff_t block_size);
   void LogCoreAndBlock(std::ptrdiff_t block_size);  // called in main thread to log core and block size for task breakdown
   void LogThreadId(int thread_idx);                 // called in child thread to log its id
-  void LogRun(int thread_idx);                      // called in child thread to log num of run
+  void LogSpinStart(int thread_idx);                // called in child thread when it starts spinning for work
+  void LogSpinEnd(int thread_idx);                  // called in child thread to log the time spent spinning
+  void LogRunStart(int thread_idx);                 // called in child thread before running a task
+  void LogRun(int thread_idx);                      // called in child thread to log num of run and run time
   std::string DumpChildThreadStat();                // return all child statitics collected so far
 
  private:
@@ -286,6 +296,11 @@ class ThreadPoolProfiler {
     uint64_t num_run_ = 0;
     onnxruntime::TimePoint last_logged_point_ = Clock::now();
     int32_t core_ = -1;  // core that the child thread is running on
+    // time spent spinning for work, versus running tasks
+    std::chrono::nanoseconds spin_time_{};
+    std::chrono::nanoseconds run_time_{};
+    onnxruntime::TimePoint spin_start_point_;
+    onnxruntime::TimePoint run_start_point_;
   };
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -337,6 +352,13 @@ class ExtendedThreadPoolInterface : public Eigen::ThreadPoolInterface {
   // two loops execute in series in a parallel section. ]
   virtual void RunInParallel(std::function<void(unsigned idx)> fn,
                              unsigned n, std::ptrdiff_t block_size) = 0;
+  // Schedule fn() to run after work that was completed by the calling thread.
+  // When called from a worker thread of this pool, fn() is handed to an idle
+  // worker if there is one, and otherwise is added to the caller's own queue
+  // so that the caller runs it next (while the data it produced is still in
+  // cache) unless another worker steals it first.  Otherwise it is the same
+  // as Schedule().
+  virtual void ScheduleWithLocality(std::function<void()> fn) = 0;
   virtual void StartProfiling() = 0;
   virtual std::string StopProfiling() = 0;
 };
@@ -773,6 +795,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         env_(env),
         num_threads_(num_threads),
         allow_spinning_(allow_spinning),
+        adaptive_spinning_(thread_options.adaptive_spinning),
         set_denormal_as_zero_(thread_options.set_denormal_as_zero),
         worker_data_(num_threads),
         all_coprimes_(num_threads),
@@ -831,6 +854,50 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     }
   }
 
+  void ScheduleWithLocality(std::function<void()> fn) override {
+    PerThread* pt = GetPerThread();
+    if (pt->pool != this) {
+      Schedule(std::move(fn));
+      return;
+    }
+
+    // Prefer a spinning worker, which picks up the work without an OS wake-up.
+    unsigned r = Rand(&pt->rand);
+    unsigned inc = all_coprimes_[num_threads_ - 1][r % all_coprimes_[num_threads_ - 1].size()];
+    unsigned victim = r % num_threads_;
+    int blocked_worker = -1;
+    for (unsigned i = 0; i < num_threads_; i++) {
+      if (victim != static_cast<unsigned>(pt->thread_id)) {
+        auto status = worker_data_[victim].GetStatus();
+        if (status == WorkerData::ThreadStatus::Spinning) {
+          fn = worker_data_[victim].queue.PushBack(std::move(fn));
+          if (!fn) {
+            return;
+          }
+        } else if (status == WorkerData::ThreadStatus::Blocked && blocked_worker == -1) {
+          blocked_worker = static_cast<int>(victim);
+        }
+      }
+      victim += inc;
+      if (victim >= num_threads_) {
+        victim -= num_threads_;
+      }
+    }
+
+    // All other workers are busy or blocked.  Keep the work on our own queue,
+    // and wake a blocked worker so that it can steal the work if we are still
+    // busy when it is running.
+    fn = worker_data_[pt->thread_id].queue.PushBack(std::move(fn));
+    if (!fn) {
+      if (blocked_worker != -1) {
+        worker_data_[blocked_worker].EnsureAwake();
+      }
+    } else {
+      // Run the work directly if the queue rejected the work
+      fn();
+    }
+  }
+
   //......................................................................
   //
   // Parallel sections
@@ -1489,9 +1556,69 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     OrtCondVar cv;
   };
 
+  // Tunes the number of iterations a worker spins before blocking from the idle gaps it observed, so that it keeps
+  // spinning through the short gaps between the parallel loops of a run, but blocks soon in the long gaps between
+  // requests, where spinning only burns CPU. A gap is short if the default policy would have spun through it.
+  // Each worker has its own, so no synchronization is needed.
+  class AdaptiveSpin {
+   public:
+    AdaptiveSpin(int min_spin_count, int max_spin_count)
+        : min_spin_count_(min_spin_count),
+          max_spin_count_(max_spin_count),
+          // start with the default policy of spinning max_spin_count times
+          gap_estimate_(max_spin_count / 2),
+          spin_limit_(max_spin_count) {
+    }
+
+    int SpinLimit() const {
+      return spin_limit_;
+    }
+
+    // The worker found work after spinning the given number of iterations.
+    void OnWorkFound(int iterations) {
+      Update(iterations);
+    }
+
+    // The worker spun the given number of iterations for spin_time without finding work, and then blocked for
+    // block_time.
+    void OnBlocked(int iterations, std::chrono::nanoseconds spin_time, std::chrono::nanoseconds block_time) {
+      if (iterations <= 0 || spin_time.count() <= 0) {
+        return;
+      }
+      // the gap in iterations, i.e. how long the worker would have had to spin to find the work
+      const double iterations_per_ns = static_cast<double>(iterations) / static_cast<double>(spin_time.count());
+      const double gap = static_cast<double>(iterations) + static_cast<double>(block_time.count()) * iterations_per_ns;
+      if (gap < static_cast<double>(max_spin_count_)) {
+        Update(static_cast<int64_t>(gap));
+      } else {
+        // a long gap, the spinning was wasted
+        gap_estimate_ -= gap_estimate_ / 4;
+        UpdateSpinLimit();
+      }
+    }
+
+   private:
+    void Update(int64_t gap) {
+      // moving average over the last few gaps
+      gap_estimate_ += (gap - gap_estimate_) / 8;
+      UpdateSpinLimit();
+    }
+
+    void UpdateSpinLimit() {
+      // spin up to twice the typical gap, so that most of the short gaps are still covered
+      spin_limit_ = static_cast<int>(std::clamp<int64_t>(2 * gap_estimate_, min_spin_count_, max_spin_count_));
+    }
+
+    const int min_spin_count_;
+    const int max_spin_count_;
+    int64_t gap_estimate_;
+    int spin_limit_;
+  };
+
   Environment& env_;
   const unsigned num_threads_;
   const bool allow_spinning_;
+  const bool adaptive_spinning_;
   const bool set_denormal_as_zero_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
@@ -1535,6 +1662,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     constexpr int log2_spin = 20;
     const int spin_count = allow_spinning_ ? (1ull << log2_spin) : 0;
     const int steal_count = spin_count / 100;
+    // Spin at least until the first steal attempt.
+    AdaptiveSpin adaptive_spin(steal_count, spin_count);
+    const bool adaptive = adaptive_spinning_ && spin_count > 0;
 
     SetDenormalAsZero(set_denormal_as_zero_);
     profiler_.LogThreadId(thread_id);
@@ -1543,7 +1673,12 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       Task t = q.PopFront();
       if (!t) {
         // Spin waiting for work.
-        for (int i = 0; i < spin_count && !done_; i++) {
+        const int spin_limit = adaptive ? adaptive_spin.SpinLimit() : spin_count;
+        const auto spin_start = adaptive ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+        bool spin_interrupted = false;
+        int i = 0;
+        profiler_.LogSpinStart(thread_id);
+        for (; i < spin_limit && !done_; i++) {
           if (((i + 1) % steal_count == 0)) {
             t = Steal(StealAttemptKind::TRY_ONE);
           } else {
@@ -1552,13 +1687,20 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
           if (t) break;
 
           if (spin_loop_status_.load(std::memory_order_relaxed) == SpinLoopStatus::kIdle) {
+            spin_interrupted = true;
             break;
           }
           onnxruntime::concurrency::SpinPause();
         }
+        profiler_.LogSpinEnd(thread_id);
+        if (adaptive && t) {
+          adaptive_spin.OnWorkFound(i);
+        }
 
         // Attempt to block
         if (!t) {
+          const auto block_start = adaptive ? std::chrono::steady_clock::now()
+                                            : std::chrono::steady_clock::time_point{};
           td.SetBlocked(  // Pre-block test
               [&]() -> bool {
                 bool should_block = true;
@@ -1615,6 +1757,10 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
               [&]() {
                 blocked_--;
               });
+          // The gaps the session asked us not to spin through are not used to tune spinning.
+          if (adaptive && !spin_interrupted && !done_) {
+            adaptive_spin.OnBlocked(i, block_start - spin_start, std::chrono::steady_clock::now() - block_start);
+          }
           // Thread just unblocked.  Unless we picked up work while
           // blocking, or are exiting, then either work was pushed to
           // us, or it was pushed to an overloaded queue
@@ -1625,6 +1771,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
       if (t) {
         td.SetActive();
+        profiler_.LogRunStart(thread_id);
         t();
         profiler_.LogRun(thread_id);
         td.SetSpinning();
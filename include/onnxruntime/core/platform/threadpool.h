@@ -213,6 +213,24 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Limit the degree of parallelism of loops started by the current thread, while
+  // the object is alive.  This lets sessions sharing a thread pool each use part of
+  // it, so that one session cannot occupy all of the threads.  The limit includes
+  // the calling thread, and applies to DegreeOfParallelism() and the parallel loop
+  // methods.  Work scheduled via Schedule/ScheduleWithLocality inherits the limit of
+  // the thread that scheduled it, so that it also covers the parallel executor.
+  // A limit of 0 means no limit.  Limits may be nested, the innermost one applies.
+
+  class ScopedDegreeOfParallelismLimit {
+   public:
+    explicit ScopedDegreeOfParallelismLimit(int max_degree_of_parallelism);
+    ~ScopedDegreeOfParallelismLimit();
+
+   private:
+    int previous_limit_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedDegreeOfParallelismLimit);
+  };
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -234,6 +252,19 @@ class ThreadPool {
     }
   }
 
+  // Schedules fn() to run after the work of the calling thread.  When called from a worker
+  // of the pool, fn() is given to an idle worker if there is one, and otherwise is queued on
+  // the calling worker so that it keeps the data the caller just produced in cache, while
+  // other workers may still steal it.  Otherwise it is the same as Schedule.
+  static void ScheduleWithLocality(ThreadPool* tp,
+                                   std::function<void()> fn) {
+    if (tp) {
+      tp->ScheduleWithLocality(std::move(fn));
+    } else {
+      fn();
+    }
+  }
+
   // ParallelFor shards the "total" units of work assuming each unit of work
   // having roughly "cost_per_unit" cost, in cycles. Each unit of work is
   // indexed 0, 1, ..., total - 1. Each shard contains 1 or more units of work
@@ -254,6 +285,21 @@ class ThreadPool {
   static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
 
+  // Like TryParallelFor, for loops whose iterations vary in cost, e.g. over ragged batches or sparse rows, where
+  // blocks of the same size leave stragglers.  Rather than dividing the range up front, each thread repeatedly
+  // claims a share of the remaining iterations from a shared counter (guided scheduling), so the chunks shrink as
+  // the loop nears its end and the threads that got cheap iterations take over the rest of the work.
+  // "cost_per_unit" is the average cost of an iteration; it decides whether to parallelize the loop, and bounds
+  // the smallest chunk so that the per-chunk overhead stays small.
+
+  static void TryGuidedParallelFor(ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit,
+                                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
+    TryGuidedParallelFor(tp, total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
+  }
+
+  static void TryGuidedParallelFor(ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
+                                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
   // Directly schedule the 'total' tasks to the underlying threadpool, without
   // cutting them by halves
 
@@ -373,6 +419,10 @@ class ThreadPool {
   // value returned by DegreeOfParallelism to code using the pool.
   int NumThreads() const;
 
+  // Returns the number of threads in the pool that loops started by the calling thread
+  // may use, taking ScopedDegreeOfParallelismLimit into account.
+  int NumThreadsToUse() const;
+
   // Returns current thread id between 0 and NumThreads() - 1, if called from a
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
@@ -407,10 +457,15 @@ class ThreadPool {
   void ParallelFor(std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
                    const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn);
 
+  void GuidedParallelFor(std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
+                         const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
   void SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn);
 
   void Schedule(std::function<void()> fn);
 
+  void ScheduleWithLocality(std::function<void()> fn);
+
   void StartProfiling();
 
   std::string StopProfiling();
@@ -38,4 +38,8 @@ struct OrtCUDAProviderOptionsV2 {
   int prefer_nhwc = 0;                                                                                         // make the CUDA EP NHWC preferred
   int use_ep_level_unified_stream = 0;                                                                         // flag specifying if ep level stream is used or not
   int use_tf32 = 1;                                                                                            // use TF32
+  int use_mem_pool = 0;                                                                                        // allocate from the CUDA memory pool instead of the BFC Arena
+  size_t mem_pool_release_threshold = std::numeric_limits<size_t>::max();                                      // bytes the CUDA memory pool keeps before returning memory to the system
+  size_t weight_offload_min_bytes = 0;                                                                         // keep weights of at least this size in host memory and prefetch them on use, 0 to disable
+  size_t weight_offload_device_budget = std::numeric_limits<size_t>::max();                                   // bytes of offloaded weights kept on the device
 };
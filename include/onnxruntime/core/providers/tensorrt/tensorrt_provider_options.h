@@ -81,4 +81,9 @@ struct OrtTensorRTProviderOptionsV2 {
 
   const char* trt_engine_cache_prefix{nullptr};  // specify engine cache prefix
   int trt_engine_hw_compatible{0};               // Enable hardware compatibility. Default 0 = false, nonzero = true
+  int trt_async_engine_build_enable{0};          // Build engines for new input shapes in the background and run the subgraph on the
+                                                 // CUDA EP meanwhile. Default 0 = false, nonzero = true
+  const char* trt_engine_cache_store_lib_path{nullptr};  // specify the library of the store sharing engine caches across hosts
+  int trt_profile_observation_runs{0};                   // Number of runs whose input shapes the optimization profiles are derived
+                                                         // from, when no explicit profile is given. Default 0 = disabled
 };
@@ -301,6 +301,7 @@ ORT_RUNTIME_CLASS(Op);
 ORT_RUNTIME_CLASS(OpAttr);
 ORT_RUNTIME_CLASS(Logger);
 ORT_RUNTIME_CLASS(ShapeInferContext);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -2794,6 +2795,9 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_max_chunk_size_bytes": Allocations of at most this size are served from per-thread caches of
+   *  free chunks in front of the arena, which avoids taking the arena lock on most small allocations.
+   *  Use 0 to disable the thread caches. Use -1 to allow ORT to choose the default, which is 0.
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -4656,6 +4660,156 @@ struct OrtApi {
                   _In_reads_(num_external_initializer_files) char* const* external_initializer_file_buffer_array,
                   _In_reads_(num_external_initializer_files) const size_t* external_initializer_file_lengths,
                   size_t num_external_initializer_files);
+
+  /** \brief Get the memory usage of the allocator a session uses for a device.
+   *
+   * If the session uses the allocators registered in the env with the session.enable_env_allocator_accounting
+   * session option, the usage is the one of the session alone. Otherwise, it is the usage of the allocator, which
+   * is shared with the other sessions using it. Allocators that do not collect stats report 0.
+   *
+   * \param[in] session
+   * \param[in] mem_info The memory info of the allocator.
+   * \param[out] bytes_in_use Number of bytes currently in use.
+   * \param[out] max_bytes_in_use Maximum number of bytes in use so far.
+   * \param[out] bytes_limit Maximum number of bytes that may be in use, 0 if unknown or unlimited.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.19.
+   */
+  ORT_API2_STATUS(SessionGetAllocatorStats, _In_ const OrtSession* session, _In_ const OrtMemoryInfo* mem_info,
+                  _Out_ int64_t* bytes_in_use, _Out_ int64_t* max_bytes_in_use, _Out_ int64_t* bytes_limit);
+
+  /** \brief Get the aggregate of the runs sampled with the session.profiling_sample_rate session option.
+   *
+   * The aggregate covers the last session.profiling_sample_window sampled runs. It is a JSON object with the
+   * number of runs and sampled runs, the latency of the sampled runs, and the count, total, mean and max time of each
+   * op type ("op_types") and each node ("nodes"), sorted by decreasing total time. It can be polled periodically
+   * while the session serves requests, e.g. to export the kernel hotspots to a metrics system.
+   *
+   * \param[in] session
+   * \param[in] allocator Allocator used to allocate the returned string.
+   * \param[out] out Null terminated JSON string, to be freed with the allocator.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.19.
+   */
+  ORT_API2_STATUS(SessionGetSampledProfile, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
+
+  /** \brief Bind an ::OrtIoBinding output to a growable buffer on a device
+   *
+   * Like OrtApi::BindOutputToDevice, for tensor outputs whose shape changes between runs, e.g. when decoding token
+   * by token. The output is written to a buffer kept by the binding, which is reused by the next run if the output
+   * fits in its capacity and grown otherwise, instead of allocating the output on each run.
+   * The output ::OrtValue returned by OrtApi::GetBoundOutputValues is overwritten by the next run.
+   *
+   * \see OrtApi::RunWithBinding
+   *
+   * \param[in] binding_ptr
+   * \param[in] name Null terminated string of the model output name
+   * \param[in] mem_info_ptr Device of the buffer.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.19.
+   */
+  ORT_API2_STATUS(BindGrowableOutputToDevice, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                  _In_ const OrtMemoryInfo* mem_info_ptr);
+
+  /** \brief Run the model for a batch of requests with the same input and output names
+   *
+   * Equivalent to calling OrtApi::Run for each request, with the per call setup done once for the batch: the names
+   * are resolved, the run logger is created and the execution providers are notified once. It amortizes the
+   * overhead of OrtApi::Run when running many inferences of a small model.
+   * The requests run one after the other and the call stops at the first one that fails.
+   *
+   * \param[in] session
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input_len Number of inputs of each request
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of outputs of each request
+   * \param[in] batch_size Number of requests
+   * \param[in] inputs Array of batch_size * input_len ::OrtValue%s, the inputs of each request one request after the
+   *   other
+   * \param[inout] outputs Array of batch_size * output_names_len ::OrtValue%s in the same layout. Null entries are
+   *   allocated and returned as with OrtApi::Run, the others are used as pre-allocated outputs.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.19.
+   */
+  ORT_API2_STATUS(RunBatch, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  size_t batch_size, _In_reads_(batch_size* input_len) const OrtValue* const* inputs,
+                  _Inout_updates_all_(batch_size* output_names_len) OrtValue** outputs);
+
+  /** \brief Resolve input and output names once for OrtApi::RunPrepared
+   *
+   * Runs with an ::OrtPreparedRun skip the lookups of the names done by each call to OrtApi::Run, which matters for
+   * models that run in tens of microseconds. The inputs are still checked against the types and shapes of the model.
+   * An ::OrtPreparedRun can only be used with the session that created it, and by one run at a time. Threads
+   * running the session concurrently create one each.
+   *
+   * \param[in] session
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input_len Number of elements in the input_names array
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in the output_names array
+   * \param[out] out Newly created ::OrtPreparedRun. Must be freed with OrtApi::ReleasePreparedRun
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.19.
+   */
+  ORT_API2_STATUS(CreatePreparedRun, _In_ const OrtSession* session,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Outptr_ OrtPreparedRun** out);
+
+  /** \brief Run the model with the input and output names of an ::OrtPreparedRun
+   *
+   * Same as OrtApi::Run with the names given to OrtApi::CreatePreparedRun.
+   *
+   * \param[in] session
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] prepared_run Created from this session with OrtApi::CreatePreparedRun
+   * \param[in] inputs Array of ::OrtValue%s of the inputs, in the order of the input names of prepared_run
+   * \param[in] input_len Number of elements in the inputs array
+   * \param[inout] outputs Array of ::OrtValue%s of the outputs, in the order of the output names of prepared_run.
+   *   Null entries are allocated and returned as with OrtApi::Run.
+   * \param[in] output_len Number of elements in the outputs array
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.19.
+   */
+  ORT_API2_STATUS(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _Inout_ OrtPreparedRun* prepared_run, _In_reads_(input_len) const OrtValue* const* inputs,
+                  size_t input_len, _Inout_updates_all_(output_len) OrtValue** outputs, size_t output_len);
+
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /** \brief Get the statistics of the tensors collected with the session.collect_tensor_statistics session option.
+   *
+   * The statistics cover all the runs of the session so far, e.g. over a calibration data set. They are a JSON object
+   * with an entry per float tensor produced by a node, holding the number of finite values seen ("count"), their
+   * "min" and "max", and the "histogram" counts of session.tensor_statistics_histogram_bins equal width bins from min
+   * to max.
+   *
+   * \param[in] session
+   * \param[in] allocator Allocator used to allocate the returned string.
+   * \param[out] out Null terminated JSON string, to be freed with the allocator.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.19.
+   */
+  ORT_API2_STATUS(SessionGetTensorStatistics, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ char** out);
 };
 
 /*
@@ -517,6 +517,7 @@ ORT_DEFINE_RELEASE(TypeInfo);
 ORT_DEFINE_RELEASE(Value);
 ORT_DEFINE_RELEASE(ModelMetadata);
 ORT_DEFINE_RELEASE(IoBinding);
+ORT_DEFINE_RELEASE(PreparedRun);
 ORT_DEFINE_RELEASE(ArenaCfg);
 ORT_DEFINE_RELEASE(Status);
 ORT_DEFINE_RELEASE(OpAttr);
@@ -994,6 +995,7 @@ struct ModelMetadata : detail::Base<OrtModelMetadata> {
 };
 
 struct IoBinding;
+struct PreparedRun;
 
 namespace detail {
 
@@ -1076,6 +1078,22 @@ struct SessionImpl : ConstSessionImpl<T> {
 
   void Run(const RunOptions& run_options, const IoBinding&);  ///< Wraps OrtApi::RunWithBinding
 
+  /** \brief Run the model with the input and output names of a PreparedRun, returning results in user provided
+   * outputs
+   *
+   * Wraps OrtApi::RunPrepared
+   *
+   * \param[in] run_options
+   * \param[in] prepared_run Created from this session
+   * \param[in] input_values Array of Value objects in the order of the input names of prepared_run
+   * \param[in] input_count Number of inputs
+   * \param[out] output_values Array of Value objects in the order of the output names of prepared_run, empty ones
+   *   are allocated
+   * \param[in] output_count Number of outputs
+   */
+  void Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
+
   /** \brief Run the model asynchronously in a thread owned by intra op thread pool
    *
    * Wraps OrtApi::RunAsync
@@ -1868,6 +1886,17 @@ struct IoBinding : detail::IoBindingImpl<OrtIoBinding> {
   UnownedIoBinding GetUnowned() const { return UnownedIoBinding{this->p_}; }
 };
 
+/** \brief Wrapper around ::OrtPreparedRun
+ *
+ * The input and output names of runs resolved once, see OrtApi::CreatePreparedRun.
+ */
+struct PreparedRun : detail::Base<OrtPreparedRun> {
+  explicit PreparedRun(std::nullptr_t) {}  ///< Create an empty PreparedRun object, must be assigned a valid one to be used
+  /// Wraps OrtApi::CreatePreparedRun
+  PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+              const char* const* output_names, size_t output_count);
+};
+
 /*! \struct Ort::ArenaCfg
  * \brief it is a structure that represents the configuration of an arena based allocator
  * \details Please see docs/C_API.md for details
@@ -434,6 +434,11 @@ inline IoBinding::IoBinding(Session& session) {
   ThrowOnError(GetApi().CreateIoBinding(session, &this->p_));
 }
 
+inline PreparedRun::PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+                                const char* const* output_names, size_t output_count) {
+  ThrowOnError(GetApi().CreatePreparedRun(session, input_names, input_count, output_names, output_count, &this->p_));
+}
+
 inline ArenaCfg::ArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes, int max_dead_bytes_per_chunk) {
   ThrowOnError(GetApi().CreateArenaCfg(max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk, &p_));
 }
@@ -1057,6 +1062,15 @@ inline void SessionImpl<T>::Run(const RunOptions& run_options, const IoBinding&
   ThrowOnError(GetApi().RunWithBinding(this->p_, run_options, io_binding));
 }
 
+template <typename T>
+inline void SessionImpl<T>::Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values,
+                                size_t input_count, Value* output_values, size_t output_count) {
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(GetApi().RunPrepared(this->p_, run_options, prepared_run, ort_input_values, input_count,
+                                    ort_output_values, output_count));
+}
+
 template <typename T>
 inline void SessionImpl<T>::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
                                      const char* const* output_names, Value* output_values, size_t output_count, RunAsyncCallbackFn callback, void* user_data) {
@@ -24,10 +24,37 @@ static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.di
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
 
+// Track the memory the session allocates from the allocators registered in the env, when
+// kOrtSessionOptionsConfigUseEnvAllocators is set. The usage of the session is reported by the
+// SessionGetAllocatorStats C API. Arenas shared this way cannot be shrunk through the session with
+// kOrtRunOptionsConfigEnableMemoryArenaShrinkage.
+// Option values:
+// - "0": Disabled. [DEFAULT]
+// - "1": Enabled.
+static const char* const kOrtSessionOptionsConfigEnableEnvAllocatorAccounting = "session.enable_env_allocator_accounting";
+
+// Maximum number of bytes the session may have in use on each allocator registered in the env. An allocation that
+// would exceed it fails, while the other sessions sharing the allocator are not affected. The limit does not
+// reserve any memory for the session. Setting it enables kOrtSessionOptionsConfigEnableEnvAllocatorAccounting.
+// Option values:
+// - "0": No limit. [DEFAULT]
+// - A positive integer: Maximum number of bytes in use by the session per env allocator.
+static const char* const kOrtSessionOptionsConfigEnvAllocatorMemoryLimit = "session.env_allocator_memory_limit";
+
 // Set to 'ORT' (case sensitive) to load an ORT format model.
 // If unset, model type will default to ONNX unless inferred from filename ('.ort' == ORT format) or bytes to be ORT
 static const char* const kOrtSessionOptionsConfigLoadModelFormat = "session.load_model_format";
 
+// Minimum size in bytes of the data of an initializer of the main graph of an ONNX model loaded from a file for it to
+// be read from the file when the session is initialized, directly into the buffer of the initializer, instead of being
+// copied into the model proto when the model is parsed. The model file is mapped and only its structure is parsed,
+// which reduces the peak memory and the loading time of large models with their initializers in the model file.
+// The model file must not be modified until the session is initialized.
+// Option values:
+// - "0": The model is parsed with the data of its initializers. [DEFAULT]
+// - A positive integer: Minimum size in bytes, e.g. "1024".
+static const char* const kOrtSessionOptionsConfigLazyInitializerMinSize = "session.lazy_initializer_min_size";
+
 // Set to 'ORT' (case sensitive) to save optimized model in ORT format when SessionOptions.optimized_model_path is set.
 // If unset, format will default to ONNX unless optimized_model_filepath ends in '.ort'.
 static const char* const kOrtSessionOptionsConfigSaveModelFormat = "session.save_model_format";
@@ -41,6 +68,13 @@ static const char* const kOrtSessionOptionsConfigSaveModelFormat = "session.save
 // and that's recommended because turning this option on may hurt model accuracy.
 static const char* const kOrtSessionOptionsConfigSetDenormalAsZero = "session.set_denormal_as_zero";
 
+// Apply flush-to-zero and denormal-as-zero only while the CPU kernels of some op types run, on the thread running the
+// kernel and on the intra-op threads running its parallel loops, instead of to the whole session.
+// The value is a comma separated list of op types, e.g. "Gemm,MatMul,Conv,LSTM", or "auto" for the GEMM, convolution,
+// recurrent and activation kernels when a float initializer of the model holds denormals. The default is "", none.
+// It has no effect when kOrtSessionOptionsConfigSetDenormalAsZero is "1".
+static const char* const kOrtSessionOptionsConfigDenormalAsZeroOpTypes = "session.set_denormal_as_zero_op_types";
+
 // It controls to run quantization model in QDQ (QuantizelinearDeQuantizelinear) format or not.
 // "0": enable. ORT does fusion logic for QDQ format.
 // "1": disable. ORT doesn't do fusion logic for QDQ format.
@@ -67,6 +101,12 @@ static const char* const kOrtSessionOptionsEnableQuantQDQCleanup = "session.enab
 // GeluApproximation has side effects which may change the inference results. It is disabled by default due to this.
 static const char* const kOrtSessionOptionsEnableGeluApproximation = "optimization.enable_gelu_approximation";
 
+// Enable or disable fusing a MatMul of float 8 DequantizeLinear outputs into GemmFloat8 on the CUDA EP.
+// "0": disable; "1": enable. The default is "0".
+// The fused GEMM runs on the float 8 tensor cores, which need a GPU with compute capability 8.9 or above, and
+// accumulates in reduced precision, so the results may differ slightly.
+static const char* const kOrtSessionOptionsEnableFloat8MatMulFusion = "optimization.enable_float8_matmul_fusion";
+
 // This setting controls whether to enable AheadOfTime function inlining.
 // AOT function inlining examines the graph and attempts to inline as many locally defined functions in the model
 // as possible with the help of enabled execution providers.
@@ -83,7 +123,9 @@ static const char* const kOrtSessionOptionsDisableAheadOfTimeFunctionInlining =
 // <subgraph string: optimization strategy: number of subgraph to apply>.
 // For example, "Gelu+Cast+:1:0,Dropout+:1:1".
 //   A valid "subgraph string" should be one subgraph representation output by ORT graph transformations.
-//   "optimization strategy" currently has valid values: 0 - disabled, 1 - recompute.
+//   "optimization strategy" currently has valid values: 0 - disabled, 1 - recompute, 2 - recompute with compromise,
+//   3 - offload to host memory. Offloading uses "Offload(<op type>)" as the subgraph string, for example,
+//   "Offload(Gelu):3:-1".
 //   "number of subgraph to apply" is used to control how many subgraphs to apply optimization, to avoid "oversaving"
 //   the memory.
 static const char* const kOrtSessionOptionsMemoryOptimizerEnabler = "optimization.memory_optimizer_config";
@@ -112,6 +154,185 @@ static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "
 static const char* const kOrtSessionOptionsConfigAllowInterOpSpinning = "session.inter_op.allow_spinning";
 static const char* const kOrtSessionOptionsConfigAllowIntraOpSpinning = "session.intra_op.allow_spinning";
 
+// Configure whether the intra-op threads tune how long they spin before blocking from the idle gaps they observed.
+// Threads then keep spinning through the short gaps between the operators of a run, but block soon in the long gaps
+// between requests, which saves the CPU time burnt by spinning on lightly loaded or shared hosts.
+// "0": default, threads always spin the same number of times before blocking
+// "1": adaptive spinning. It has no effect if session.intra_op.allow_spinning is "0".
+static const char* const kOrtSessionOptionsConfigIntraOpAdaptiveSpinning = "session.intra_op.adaptive_spinning";
+
+// Configure whether the parallel executor schedules nodes on the intra-op thread pool instead of a separate
+// inter-op thread pool, so that node level and loop level parallelism share the same threads.
+// This only applies when the execution mode is ORT_PARALLEL, and avoids oversubscription of cores when both kinds of
+// work are busy. With global thread pools, the environment intra-op thread pool is used for both.
+// "0": Use separate intra-op and inter-op thread pools. [DEFAULT]
+// "1": Use the intra-op thread pool for both. Inter-op thread pool options are ignored.
+static const char* const kOrtSessionOptionsConfigUseUnifiedThreadPool = "session.use_unified_thread_pool";
+
+// Coalesce concurrent Run() calls into one batched run along the first dimension of the inputs, and split the outputs
+// back to the callers. Only enable it for models whose outputs have the batch as the first dimension, and whose rows
+// are computed independently of each other.
+// Calls are batched together only if they have the same input and output names, CPU tensor inputs with the same
+// element types and shapes except for the first dimension, no preallocated outputs, and no run options set.
+// If the batched run fails, each call is run by itself.
+// The value is the maximum number of rows of a batch. By default ("0") dynamic batching is disabled.
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize = "session.dynamic_batching.max_batch_size";
+
+// Maximum time in microseconds that the first call of a batch waits for other calls to join, if the batch is not full.
+// Default is "100".
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs =
+    "session.dynamic_batching.max_queue_delay_us";
+
+// Run the calls with large inputs as a pipeline of micro-batches: the inputs are split along their first dimension
+// into micro-batches, which are run concurrently, and the outputs are concatenated back. When the graph is partitioned
+// across execution providers, e.g. CPU and CUDA, or several GPUs, one micro-batch runs on a device while the next one
+// runs on another, instead of each device idling while the whole batch goes through the other stages.
+// Only enable it for models whose outputs have the batch as the first dimension, and whose rows are computed
+// independently of each other. Calls are split only if they have CPU tensor inputs with the same first dimension,
+// no preallocated outputs, and no run options set. If a micro-batch fails, the call is run as a whole.
+// The value is the number of rows of a micro-batch. By default ("0") pipelining is disabled.
+static const char* const kOrtSessionOptionsConfigPipelineMicroBatchSize = "session.pipeline.micro_batch_size";
+
+// Maximum number of micro-batches of a call run concurrently when session.pipeline.micro_batch_size is set, usually
+// the number of stages of the pipeline. The micro-batches beyond the first one run on the intra-op thread pool.
+// Default is "2".
+static const char* const kOrtSessionOptionsConfigPipelineMaxMicroBatchesInFlight =
+    "session.pipeline.max_micro_batches_in_flight";
+
+// Re-optimize the model for the values of the free dimensions of its inputs seen at run time, e.g. a batch size of 1.
+// Once session.shape_specialization.min_runs Run calls have had the same values, a session is created from the
+// original model with these values as free dimension overrides, so that shape subgraphs are constant folded and
+// Reshape and Expand nodes are eliminated for them, and the following calls with these values run on it.
+// Only applies to ONNX models without custom ops on the CPU execution provider. Each specialized session has its own
+// kernels, initializers and, unless the session uses the global thread pools, thread pools.
+// The value is the maximum number of specialized sessions. By default ("0") shape specialization is disabled.
+static const char* const kOrtSessionOptionsConfigShapeSpecializationMaxVariants =
+    "session.shape_specialization.max_variants";
+
+// Number of Run calls with the same values of the free dimensions before a session is specialized for them.
+// Default is "8".
+static const char* const kOrtSessionOptionsConfigShapeSpecializationMinRuns = "session.shape_specialization.min_runs";
+
+// Maximum number of memory patterns cached per graph when memory pattern optimization is enabled.
+// A memory pattern is generated for each distinct set of input shapes, so models with dynamic input shapes
+// may cache many of them. When the cache is full, the least recently used memory pattern is evicted.
+// By default ("0") the number of cached memory patterns is not limited.
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheSize = "session.memory_pattern_cache_size";
+
+// Generalize the first memory pattern generated for a graph with dynamic input shapes to other input shapes, by
+// expressing the sizes of its values in terms of the symbolic dimensions of the inputs, e.g. batch * seq * hidden.
+// A run with new input shapes then allocates its intermediate values from a single block per device, instead of
+// tracing its allocations from the arena to generate a memory pattern for the following runs.
+// Values whose shapes are not inferred in terms of the input dimensions, e.g. the outputs of NonZero, are still
+// allocated from the arena. Requires memory pattern optimization to be enabled.
+// Option values:
+// - "0": Disabled. [DEFAULT]
+// - "1": Enabled.
+static const char* const kOrtSessionOptionsConfigEnableSymbolicMemoryPatterns =
+    "session.enable_symbolic_memory_patterns";
+
+// Execute the nodes in a topological order that greedily minimizes the peak size of the live node outputs, instead of
+// the default topological order. At each step the ready node that increases the live memory the least is executed.
+// This is the same as setting the execution order of the session options to MEMORY_MINIMIZING. The estimated peak
+// activation memory of the graph with both orders is written to the session log at INFO level.
+// Not available in minimal builds.
+// Option values:
+// - "0": Use the execution order of the session options. [DEFAULT]
+// - "1": Use the memory minimizing execution order.
+static const char* const kOrtSessionOptionsConfigMemoryMinimizingExecutionOrder =
+    "session.memory_minimizing_execution_order";
+
+// Let the allocation planner compute the outputs of CPU elementwise ops (e.g. Add, Mul, activations) in place, into
+// the buffer of an input with the same shape and type that is not used after the op, even if the kernel does not
+// declare the in-place reuse. This reduces the peak memory and the cache footprint of large activations.
+// Only applies to sequential execution with memory reuse enabled.
+// Option values:
+// - "0": Disabled.
+// - "1": Enabled. [DEFAULT]
+static const char* const kOrtSessionOptionsConfigEnableElementwiseInplace = "session.enable_elementwise_inplace";
+
+// Capture the execution of a CPU-only graph on the first run, and replay it in the following runs that have the
+// same input names, output names, and input shapes. A replay calls the kernels in order with the buffers of the
+// first run, and skips the execution plan walk and the allocation of intermediate values, which reduces the
+// framework overhead of small models. The inputs are copied into the captured buffers and the outputs copied out.
+// Only models whose nodes are all assigned to the CPU EP, without control flow nodes, and whose values are all
+// tensors can be captured. Runs that do not match the captured graph are executed as usual.
+// Option values:
+// - "0": Disabled. [DEFAULT]
+// - "1": Enabled. Session initialization fails if the model cannot be captured.
+static const char* const kOrtSessionOptionsConfigEnableCpuGraphCapture = "session.enable_cpu_graph_capture";
+
+// Key the graphs captured by an execution provider with graph capture enabled (e.g. enable_cuda_graph) by the
+// signature of the run when the run options do not set a graph annotation id (gpu_graph_id). The signature is made of
+// the input names, shapes and buffers, and the output names and, for preallocated outputs, shapes and buffers. Runs
+// with the same signature replay the same graph, so the application does not have to manage annotation ids, e.g. for
+// decoding steps with inputs padded to a few sequence length buckets and bound to a buffer per bucket.
+// Option values:
+// - "0": Disabled. [DEFAULT]
+// - "1": Enabled.
+static const char* const kOrtSessionOptionsConfigGraphCaptureAutoAnnotation = "session.graph_capture_auto_annotation";
+
+// Maximum number of graphs captured with session.graph_capture_auto_annotation. Runs with other signatures once the
+// limit is reached execute without graph capture. Default is "8".
+static const char* const kOrtSessionOptionsConfigGraphCaptureMaxGraphs = "session.graph_capture_max_graphs";
+
+// Aggregate the time spent in each phase of executing a node per op type: preparing the kernel context, allocating
+// the outputs, computing, releasing the inputs that are no longer used, and waiting on other streams.
+// This tells whether a model is bound by the framework overhead between kernels or by the kernels themselves.
+// The summary is written to the session log at INFO level when the session is destroyed, and added to the
+// profiling output if profiling is enabled.
+// Option values:
+// - "0": Disabled. [DEFAULT]
+// - "1": Enabled.
+static const char* const kOrtSessionOptionsConfigEnableNodeOverheadStats = "session.enable_node_overhead_stats";
+
+// Add the hardware performance counters of the thread running each node to its kernel event in the profiling output:
+// cycles, instructions, last level cache misses, instructions per cycle and the DRAM bandwidth estimated from the
+// cache misses. A low IPC with a high bandwidth points to a kernel bound by memory, a high IPC to one bound by compute.
+// The counters are read with perf_event_open on Linux and are not available on other platforms, when
+// /proc/sys/kernel/perf_event_paranoid is above 2, or in virtual machines without a virtual PMU.
+// Work run on the intra-op thread pool by other threads is not counted, use intra_op_num_threads = 1 to count the
+// whole kernel.
+// Option values:
+// - "0": Disabled. [DEFAULT]
+// - "1": Enabled. Only used when profiling is enabled.
+static const char* const kOrtSessionOptionsConfigProfileHardwareCounters = "session.profile_hardware_counters";
+
+// Profile one in N runs of the session, at a cost low enough to leave it enabled in production, unlike
+// enable_profiling which writes every event of every run to a file.
+// A sampled run records the time of each node of the main graph, a node with subgraphs being timed as a whole, into
+// a ring buffer of the last session.profiling_sample_window sampled runs. The aggregate of the window per op type and
+// per node, sorted by decreasing total time, is returned as JSON by the SessionGetSampledProfile C API.
+// Option values:
+// - "0": Disabled. [DEFAULT]
+// - "N": One run in N is sampled, "1" samples every run.
+static const char* const kOrtSessionOptionsConfigProfilingSampleRate = "session.profiling_sample_rate";
+
+// Number of most recent sampled runs aggregated by session.profiling_sample_rate. Default is "100".
+static const char* const kOrtSessionOptionsConfigProfilingSampleWindow = "session.profiling_sample_window";
+
+// Collect the statistics of the float tensors produced by the nodes of the session across its runs, to calibrate
+// quantization without adding the intermediate tensors as graph outputs. Each tensor keeps its minimum, maximum and a
+// histogram of session.tensor_statistics_histogram_bins bins over that range, in constant memory. The statistics are
+// returned as JSON by the SessionGetTensorStatistics C API. Only the tensors in CPU memory are collected.
+// Option values:
+// - "0": Disabled. [DEFAULT]
+// - "1": Enabled.
+static const char* const kOrtSessionOptionsConfigCollectTensorStatistics = "session.collect_tensor_statistics";
+
+// Number of histogram bins of each tensor collected by session.collect_tensor_statistics. Default is "2048".
+static const char* const kOrtSessionOptionsConfigTensorStatisticsHistogramBins =
+    "session.tensor_statistics_histogram_bins";
+
+// Release the idle regions of the memory arenas of the session at the end of a run, when they hold too many free
+// bytes. This caps the resident memory of long running sessions whose arenas grow through fragmentation with dynamic
+// shapes, without shrinking them after every run like kOrtRunOptionsConfigEnableMemoryArenaShrinkage does.
+// An arena is shrunk when at least this fraction of its allocated bytes is free and one of its regions is idle.
+// Option values:
+// - "0": Disabled. [DEFAULT]
+// - A value in (0, 1]: Minimum fraction of free bytes of an arena to shrink it.
+static const char* const kOrtSessionOptionsConfigArenaCompactionFreeRatio = "session.arena_compaction_free_ratio";
+
 // Key for using model bytes directly for ORT format
 // If a session is created using an input byte array contains the ORT format model data,
 // By default we will copy the model bytes at the time of session creation to ensure the model bytes
@@ -130,6 +351,34 @@ static const char* const kOrtSessionOptionsConfigUseORTModelBytesDirectly = "ses
 static const char* const kOrtSessionOptionsConfigUseORTModelBytesForInitializers =
     "session.use_ort_model_bytes_for_initializers";
 
+// Memory map the ORT format model file when the session is created from a file path, instead of reading the file
+// into a heap buffer. The mapping is read-only from the perspective of the session, and pages are only loaded when
+// they are accessed.
+// Combined with `session.use_ort_model_bytes_for_initializers`, initializers whose data is suitably aligned in the
+// file are used in place from the mapped file without being copied, and the file is kept mapped for the lifetime of
+// the session. Otherwise the mapping is released once the session is initialized.
+// If the file cannot be mapped, it is read into a heap buffer.
+// Option values:
+// - "0": Read the ORT format model file into a heap buffer. [DEFAULT]
+// - "1": Memory map the ORT format model file.
+static const char* const kOrtSessionOptionsConfigMapORTModelFile = "session.use_mmap_for_ort_model_file";
+
+// Path of a file holding the pre-packed weights of the session, to share them across processes running the same
+// model. If the file exists, it is memory mapped into the pre-packed weights container of the session, and kernels
+// whose freshly pre-packed weights match a weight in the file use the mapped weight instead of a private copy.
+// Kernels that support it skip PrePack() altogether for inputs whose pre-packed weight is recorded in the file,
+// identified by the op, the node attributes, a hash of the weight and the CPU features, which makes session
+// creation faster for models dominated by pre-packing.
+// If the file does not exist, the pre-packed weights of the session are written to it once the session is
+// initialized, so the first process creates the file that the others map.
+// The session uses the pre-packed weights container provided with CreateSessionWithPrepackedWeightsContainer, or
+// a container of its own otherwise. All the constant initializers of the CPU execution provider are cached in the
+// container, not only the shared initializers.
+// Option values:
+// - "": Pre-packed weights are not shared through a file. [DEFAULT]
+// - A file path.
+static const char* const kOrtSessionOptionsConfigPrepackedWeightsFile = "session.prepacked_weights_file";
+
 // This should only be specified when exporting an ORT format model for use on a different platform.
 // If the ORT format model will be used on ARM platforms set to "1". For other platforms set to "0"
 // Available since version 1.11.
@@ -192,6 +441,14 @@ static const char* const kOrtSessionOptionsConfigStrictAllowReleasedOpsetsOnly =
 // The file saves configuration for partitioning node among logic streams
 static const char* const kNodePartitionConfigFile = "session.node_partition_config_file";
 
+// Maximum number of streams the nodes assigned to a non-CPU device (e.g. CUDA) are partitioned into when
+// session.node_partition_config_file does not set the partitioning. Independent branches of the graph are placed on
+// different streams, synchronized with events, so that small kernels of different branches overlap on the device.
+// Chains of nodes stay on one stream. Has no effect with a user compute stream, which all the streams share, and
+// must not be used with graph capture (e.g. enable_cuda_graph), which records a single stream.
+// Default is "1".
+static const char* const kOrtSessionOptionsConfigMaxStreamsPerDevice = "session.max_streams_per_device";
+
 // This Option allows setting affinities for intra op threads.
 // Affinity string follows format:
 // logical_processor_id,logical_processor_id;logical_processor_id,logical_processor_id
@@ -209,6 +466,34 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// Bind the session to a NUMA node, e.g. "0" for the first node. By default ("-1") the session is not bound.
+// Once set, threads of the per session intra-op thread pool are attached to the physical cores of the node, and the
+// default CPU memory arena asks the OS to place its memory on the node. If intra_op_num_threads is 0, the thread pool
+// has one thread per physical core of the node.
+// Note:
+// 1. It is ignored if session.intra_op_thread_affinities is set, and it does not apply to global thread pools;
+// 2. Only supported on Linux. Session creation fails on other platforms, or if the node does not exist.
+static const char* const kOrtSessionOptionsConfigIntraOpNumaNode = "session.intra_op.numa_node";
+
+// Restrict the per session intra-op thread pool to the performance cores of a hybrid CPU, e.g. the P-cores of Intel
+// Alder Lake and later or the big cores of ARM big.LITTLE, so that slower efficiency cores do not become the
+// stragglers of every parallel loop. Set to "1" to enable. By default ("0") all cores are used.
+// If intra_op_num_threads is 0, the thread pool has one thread per performance core.
+// Note:
+// 1. It is ignored if session.intra_op_thread_affinities is set, and it does not apply to global thread pools;
+// 2. It is combined with session.intra_op.numa_node, using the performance cores of the node;
+// 3. It has no effect if the CPU is not hybrid or the core types cannot be detected, which is supported on Linux and
+//    Windows.
+static const char* const kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly =
+    "session.intra_op.performance_cores_only";
+
+// Maximum degree of parallelism of intra-op parallel loops run by the session, including the thread calling Run().
+// This is useful when many sessions share the global thread pools, so that one session cannot use all of the
+// threads and starve the others. It also applies to nodes run by the parallel executor.
+// By default ("0") there is no limit, and loops may use all of the threads of the intra-op thread pool.
+static const char* const kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism =
+    "session.intra_op.max_degree_of_parallelism";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -260,8 +545,246 @@ static const char* const kOrtSessionOptionEpContextFilePath = "ep.context_file_p
 // "1": dump the EP context into the Onnx model. (default).
 static const char* const kOrtSessionOptionEpContextEmbedMode = "ep.context_embed_mode";
 
+// Share the EP contexts loaded from EP context models across the sessions in the process, e.g. the encoder and
+// decoder sessions of a model whose EP context models reference one context binary with the graphs of both.
+// The first session loads the context binary, the graphs it does not use are kept for the sessions created later,
+// which reuse the loaded context and its weights instead of loading the binary again.
+// The sessions must use the same EP options.
+// "0": disable. (default)
+// "1": enable.
+static const char* const kOrtSessionOptionShareEpContexts = "ep.share_ep_contexts";
+
+// Directory of the CoreML EP cache of compiled CoreML models.
+// The CoreML EP compiles the CoreML model it creates for each partition when the session is initialized. With this
+// option set the compiled model is stored in the directory, keyed by the hash of the CoreML model and the OS version,
+// and loaded from there by the sessions created later instead of compiling the model again.
+// The entry must be added before the CoreML EP is appended with OrtSessionOptionsAppendExecutionProvider_CoreML.
+// Default is empty, the compiled models are not cached.
+static const char* const kOrtSessionOptionsCoreMLModelCacheDir = "ep.coreml.model_cache_dir";
+
 // Gemm fastmath mode provides fp32 gemm acceleration with bfloat16 based matmul.
 // Option values:
 // - "0": Gemm FastMath mode is not enabled. [DEFAULT]
 // - "1": Gemm FastMath mode is enabled.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
+
+// Maximum size in bytes of past state cached by GreedySearch for prompts of GPT models on CPU.
+// When a prompt starts with the prompt of a previous generation in the same session, the cached past state of that
+// prefix is reused and only the remaining prompt tokens are run through the decoder subgraph.
+// Cached entries are evicted in least recently used order. Batch size 1 without attention_mask input is supported.
+// Option values:
+// - "0": Prefix cache is disabled. [DEFAULT]
+// - A positive integer: Maximum size in bytes of cached past state.
+static const char* const kOrtSessionOptionsGenerationPrefixCacheSizeInBytes =
+    "session.generation_prefix_cache_size_in_bytes";
+
+// Run independent parts of session initialization in parallel on the intra-op thread pool of the session: the
+// transformation of the subgraphs of the main graph by the rule-based graph transformers, the creation of the
+// kernels assigned to the CPU execution provider, and the pre-packing of the constant initializers of different
+// kernels when pre-packed weights are not cached in a shared container.
+// Kernels of other execution providers are created sequentially, as are subgraph session states.
+// Option values:
+// - "0": Initialization runs sequentially. [DEFAULT]
+// - "1": Initialization runs partly in parallel.
+static const char* const kOrtSessionOptionsConfigEnableParallelInitialization = "session.enable_parallel_initialization";
+
+// Defer the finalization of the session states of the subgraphs of control flow nodes, e.g. If, Loop, Scan and
+// BeamSearch, until the first execution of their node: the creation of their kernels, the pre-packing of their
+// weights and their memory planning. It reduces the initialization time and memory of models with subgraphs that
+// are rarely executed, at the cost of a slower first execution of the nodes holding them.
+// Pre-packed weights of subgraphs that are finalized lazily are not saved to the session.prepacked_weights_file.
+// Option values:
+// - "0": Subgraph session states are finalized during session initialization. [DEFAULT]
+// - "1": Subgraph session states are finalized on the first execution of their node.
+static const char* const kOrtSessionOptionsConfigEnableLazySubgraphInitialization =
+    "session.enable_lazy_subgraph_initialization";
+
+// Directory caching the optimized form of ONNX models, so that sessions created later for the same model skip the
+// graph optimizations. The optimized model of a session is saved in ORT format to the directory, in a file named
+// after a hash of the model bytes, the ORT version, the CPU features, the graph optimization level, the disabled
+// optimizers, the execution providers and the session configuration entries. A session that finds the file of its
+// model loads it instead of optimizing the ONNX model.
+// Only applies to ONNX models loaded from a file or a buffer, with graph optimizations enabled, in sessions that
+// only use the CPU execution provider and do not save the optimized model themselves.
+// The hash only covers the bytes of the ONNX model, not the external data files of its initializers.
+// Option values:
+// - "": Optimized models are not cached. [DEFAULT]
+// - A directory path: Optimized models are cached in the directory, which is created if it does not exist.
+static const char* const kOrtSessionOptionsConfigOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// Evaluate the constant nodes of a graph in batches in the constant folding optimizer. Instead of creating an
+// execution frame and converting the outputs to initializers for each constant node, the maximal subgraphs of nodes
+// that only depend on constant initializers are evaluated in a single execution frame with a shared allocator, and
+// only the outputs consumed outside of these subgraphs are converted to initializers.
+// It reduces the optimization time of models with long chains of constant nodes, at the cost of keeping the
+// intermediate values of a graph in memory until all its constant nodes are evaluated.
+// Option values:
+// - "0": Constant nodes are evaluated one at a time. [DEFAULT]
+// - "1": Constant nodes are evaluated in batches.
+static const char* const kOrtSessionOptionsEnableBatchedConstantFolding = "optimization.enable_batched_constant_folding";
+
+// Gemm fastmath mode provides fp32 gemm acceleration with bfloat16 based matmul on any platform MLAS has a bfloat16
+// gemm kernel for, i.e. ARM64 with the BF16 extension on Linux and x64 with AVX512-BF16. MatMul nodes with large
+// enough constant weights convert them to bfloat16 when pre-packing them, and the activations are converted to
+// bfloat16 by the kernel, while the products are accumulated in fp32.
+// kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 enables the same mode.
+// Option values:
+// - "0": Gemm FastMath mode is not enabled. [DEFAULT]
+// - "1": Gemm FastMath mode is enabled.
+static const char* const kOrtSessionOptionsMlasGemmFastMathBfloat16 = "mlas.enable_gemm_fastmath_bfloat16";
+
+// Minimum fraction of zero elements, from 0 to 1, of a constant 2D weight of a float MatMul on CPU for it to be packed
+// into a sparse format when pre-packing it. The multiplication then only reads and multiplies the nonzero elements of
+// the weight, which is faster than the dense GEMM for pruned weights with about 70% or more zero elements.
+// Nonzero elements clustered in runs along the rows of the weight, as with block or structured pruning, are stored as
+// blocks. Takes precedence over the fastmath mode for the weights it packs.
+// Option values:
+// - "": Weights are not packed into a sparse format. [DEFAULT]
+// - A fraction, e.g. "0.7".
+static const char* const kOrtSessionOptionsMlasSparseGemmMinSparsity = "mlas.sparse_gemm_min_sparsity";
+
+// TunableOp for the CPU execution provider. Kernels with tunable implementations, currently the float MatMul, time
+// their candidate implementations, e.g. the ways of splitting a GEMM across the threads of the intra-op thread
+// pool, the first time they run with a new shape, and then use the fastest one. The results are exported and
+// loaded with the tuning results APIs of the session, like the ones of the GPU execution providers.
+// Option values:
+// - "0": The default implementations are used, unless tuning results are loaded with automatic enablement. [DEFAULT]
+// - "1": The implementations found by tuning are used.
+static const char* const kOrtSessionOptionsCpuTunableOpEnable = "session.cpu_tunable_op_enable";
+
+// Tune the CPU kernels with tunable implementations for the shapes that have no tuning results yet.
+// Only has an effect if kOrtSessionOptionsCpuTunableOpEnable is "1".
+// Option values:
+// - "0": Shapes without tuning results use the default implementations. [DEFAULT]
+// - "1": Shapes without tuning results are tuned the first time they run.
+static const char* const kOrtSessionOptionsCpuTunableOpTuningEnable = "session.cpu_tunable_op_tuning_enable";
+
+// The maximum time in milliseconds spent profiling each candidate implementation of a CPU TunableOp for a shape.
+// Option values:
+// - "0": No limit, each candidate runs up to 100 times. [DEFAULT]
+// - A positive integer: The time limit in milliseconds.
+static const char* const kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs =
+    "session.cpu_tunable_op_max_tuning_duration_ms";
+
+// Thresholds used by the CPU TreeEnsemble kernels (TreeEnsembleRegressor, TreeEnsembleClassifier, TreeEnsemble) to
+// choose how a batch is split across the threads of the intra-op thread pool.
+// A single row is evaluated on several threads, each one evaluating a part of the trees, if the model has more trees
+// than kOrtSessionOptionsTreeEnsembleParallelTree.
+// Option values:
+// - "80": The default number of trees. [DEFAULT]
+// - A non negative integer: The number of trees.
+static const char* const kOrtSessionOptionsTreeEnsembleParallelTree = "session.tree_ensemble.parallel_tree";
+
+// Number of rows in the blocks evaluated by a thread of the CPU TreeEnsemble kernels. A batch of rows is split
+// across the threads by blocks of rows once there are enough blocks for every thread, and by trees before that,
+// each thread keeping its own partial scores which are summed at the end.
+// Option values:
+// - "128": The default number of rows. [DEFAULT]
+// - A positive integer: The number of rows.
+static const char* const kOrtSessionOptionsTreeEnsembleParallelTreeN = "session.tree_ensemble.parallel_tree_n";
+
+// A batch with at most kOrtSessionOptionsTreeEnsembleParallelN rows is evaluated on a single thread by the CPU
+// TreeEnsemble kernels.
+// Option values:
+// - "50": The default number of rows. [DEFAULT]
+// - A non negative integer: The number of rows.
+static const char* const kOrtSessionOptionsTreeEnsembleParallelN = "session.tree_ensemble.parallel_n";
+
+// Run fp32 convolutional networks on the CPU execution provider in the channels last (NHWC) layout.
+// The NhwcTransformer rewrites fp32 Conv and FusedConv nodes to com.microsoft.NhwcFusedConv, and MaxPool,
+// AveragePool and GlobalAveragePool to their NHWC variants, and the transpose optimizer cancels the transposes
+// between them, so that a network is transposed once at its inputs and outputs. The NCHWc layout transformer is
+// not used when this is enabled. This is usually faster when the channel counts of the model are not multiples
+// of the NCHWc block size, or on platforms without NCHWc kernels.
+// Option values:
+// - "0": fp32 convolutions use the NCHW layout, or the NCHWc layout when supported by the platform. [DEFAULT]
+// - "1": fp32 convolutions use the NHWC layout.
+static const char* const kOrtSessionOptionsCpuNhwcFp32 = "optimization.cpu_nhwc_fp32";
+
+// Use a cost model in the NCHWc layout transformer to keep in the NCHW layout the regions of convolutions and pooling
+// nodes where reordering the tensors at the boundaries of the region is estimated to cost more time than the NCHWc
+// kernels save, e.g. small convolutions between nodes that have no NCHWc implementation.
+// Option values:
+// - "0": Every supported convolution and pooling node is converted to NCHWc. [DEFAULT]
+// - "1": Only the regions estimated to be faster in NCHWc are converted.
+static const char* const kOrtSessionOptionsNchwcLayoutCostModel = "optimization.nchwc_layout_cost_model";
+
+// Lower the peak memory of inference by recomputing cheap intermediate values next to their consumers. A node that
+// broadcasts or generates a large tensor from small inputs, e.g. an Expand of an attention mask, a Range of positions
+// or a ConstantOfShape, is duplicated before each group of its consumers that are far apart in the execution order,
+// so that the large tensor is not kept alive between them. Applies to the CPU execution provider at level 3.
+// Option values:
+// - "0": Intermediate values are computed once. [DEFAULT]
+// - "1": Cheap intermediate values are recomputed near their consumers.
+static const char* const kOrtSessionOptionsEnableInferenceRecompute = "optimization.enable_inference_recompute";
+
+// Quantize the constant fp32 weights of MatMul nodes at session load time, without an offline quantization tool.
+// MatMul(A, B) with B a 2D initializer becomes com.microsoft.MatMulNBits with B quantized blockwise along its first
+// dimension, with a scale and a zero point per block. Applies to the CPU execution provider at level 2. Save the
+// optimized model, e.g. in ORT format, to avoid quantizing the weights on each load.
+// Option values:
+// - "0": Weights are not quantized. [DEFAULT]
+// - "4": Weights are quantized to 4 bits.
+static const char* const kOrtSessionOptionsMatMulWeightQuantizationBits = "optimization.matmul_weight_quantization_bits";
+
+// Number of weights along the first dimension of B sharing a scale and a zero point when
+// optimization.matmul_weight_quantization_bits is set, and in the com.microsoft.MatMulNBits nodes fused from the
+// DequantizeLinear -> MatMul of QDQ models with 4-bit weights. A power of 2 from 16 to 256. Default is "32".
+static const char* const kOrtSessionOptionsMatMulWeightQuantizationBlockSize =
+    "optimization.matmul_weight_quantization_block_size";
+
+// The accuracy_level attribute of the MatMulNBits nodes created when optimization.matmul_weight_quantization_bits is
+// set or fused from QDQ models: "0" (default) computes in fp32, "4" quantizes A to int8 and is usually faster.
+static const char* const kOrtSessionOptionsMatMulWeightQuantizationAccuracyLevel =
+    "optimization.matmul_weight_quantization_accuracy_level";
+
+// Shard the weights of the model across tensor_parallel_world_size CUDA devices with tensor parallelism. A MatMul or
+// com.microsoft.Attention node followed by a MatMul, possibly through elementwise nodes such as Add of a bias and
+// Gelu, is sharded as a pair: the first node keeps the columns (or the attention heads) of the rank, the second MatMul
+// keeps the matching rows, and a com.microsoft.AllReduce node sums its output over the ranks. Applies to the CUDA
+// execution provider at level 2 and requires a build with NCCL.
+// Every rank runs a session on the same model in its own process, with optimization.tensor_parallel_rank set to the
+// rank of the process in the NCCL communicator, i.e. its MPI rank or the LOCAL_RANK environment variable.
+// Option values:
+// - "1": The model is not sharded. [DEFAULT]
+// - "N": The weights are sharded across N devices. Weights and heads not divisible by N are not sharded.
+static const char* const kOrtSessionOptionsTensorParallelWorldSize = "optimization.tensor_parallel_world_size";
+
+// The rank of the session, from 0 to optimization.tensor_parallel_world_size - 1. Default is "0".
+static const char* const kOrtSessionOptionsTensorParallelRank = "optimization.tensor_parallel_rank";
+
+// Pairs of graph outputs and graph inputs holding the state of a streaming model, e.g. the hidden states of
+// recurrent nodes, the context of convolutions or the caches of attention nodes, that is fed back from one Run call
+// to the next. It only applies to Run calls with an IOBinding: when a Run call succeeds, the next Run call on the same
+// IOBinding binds the value produced for each output of a pair to the input of the pair, without a copy when it is
+// already on the device of the input. The value the input was bound to is then reused as the buffer of the output
+// when it was carried over by an earlier Run call and has the same type and shape, so that the state is updated in
+// place between two buffers instead of being allocated on each call. Outputs of a pair that are not bound are not
+// carried over, and binding the input of a pair with IOBinding::BindInput between two Run calls overrides the
+// carried over value, e.g. to reset the state at the start of a new stream.
+// Option values:
+// - "": No state is carried over between Run calls. [DEFAULT]
+// - A list of "<output name>:<input name>" pairs separated by ';', e.g. "h_out:h_in;c_out:c_in".
+static const char* const kOrtSessionOptionsConfigStatefulIOPairs = "session.stateful_io_pairs";
+
+// Path of a JSON file holding the results of the TunableOp kernels of the ROCm and CUDA execution providers, shared
+// by the sessions and processes running on the same machines so that only the first of them pays for the tuning.
+// The file holds a list of TuningResults, each keyed by its execution provider and validators, i.e. the GPU, the
+// driver and the ONNX Runtime versions, so that a single file can serve several SKUs: the results whose validators
+// do not match the device of the session are ignored with a warning.
+// The results found in the file are loaded when the session is initialized, which enables TunableOp. When the
+// session is released, the results it holds are merged into the file, those of the same execution provider and
+// validators replacing the ones in the file for the same op and parameters.
+// Option values:
+// - "": Tuning results are not shared through a file. [DEFAULT]
+// - A file path.
+static const char* const kOrtSessionOptionsConfigTuningResultsFile = "session.tuning_results_file";
+
+// Only used by the training API. Allocate the trainable parameters of the training Module, and their gradients, in
+// one contiguous buffer per device, in the order of the parameter inputs of the training model, with the parameters
+// and gradients as views into them. Copying the trainable parameters to and from a flat buffer is then a single copy
+// and the gradients can be reduced across processes in one call.
+// Option values:
+// - "0": Every parameter and gradient has its own allocation. [DEFAULT]
+// - "1": The trainable parameters and gradients are allocated contiguously.
+static const char* const kOrtSessionOptionsConfigTrainingContiguousParameters = "training.contiguous_parameters";
@@ -9,10 +9,85 @@
 #include "run_options_helper.h"
 #include "session_options_helper.h"
 #include "tensor_helper.h"
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 Napi::FunctionReference InferenceSessionWrap::constructor;
 
+namespace {
+// runs a session on a worker thread of the libuv thread pool and settles a promise with the outputs.
+// The feed and fetch objects are referenced until the run completes, as the input and preallocated output tensors
+// use the data of their typed arrays.
+class RunWorker : public Napi::AsyncWorker {
+public:
+  RunWorker(Napi::Env env, std::shared_ptr<Ort::Session> session, std::shared_ptr<Ort::RunOptions> runOptions,
+            Napi::Object feed, Napi::Object fetch)
+      : Napi::AsyncWorker(env, "onnxruntime-node:run"), session_(std::move(session)),
+        runOptions_(std::move(runOptions)), feed_(Napi::Persistent(feed)), fetch_(Napi::Persistent(fetch)),
+        deferred_(Napi::Promise::Deferred::New(env)) {}
+
+  std::vector<std::string> inputNames;
+  std::vector<Ort::Value> inputValues;
+  std::vector<std::string> outputNames;
+  std::vector<Ort::Value> outputValues;
+  std::vector<bool> reuseOutput;
+
+  Napi::Promise Promise() const { return deferred_.Promise(); }
+
+protected:
+  void Execute() override {
+    try {
+      std::vector<const char *> inputNames_cstr;
+      for (auto &name : inputNames) {
+        inputNames_cstr.push_back(name.c_str());
+      }
+      std::vector<const char *> outputNames_cstr;
+      for (auto &name : outputNames) {
+        outputNames_cstr.push_back(name.c_str());
+      }
+      session_->Run(*runOptions_, inputNames_cstr.empty() ? nullptr : &inputNames_cstr[0],
+                    inputValues.empty() ? nullptr : &inputValues[0], inputValues.size(),
+                    outputNames_cstr.empty() ? nullptr : &outputNames_cstr[0],
+                    outputValues.empty() ? nullptr : &outputValues[0], outputValues.size());
+    } catch (std::exception const &e) {
+      SetError(e.what());
+    }
+  }
+
+  void OnOK() override {
+    Napi::Env env = Env();
+    Napi::HandleScope scope(env);
+    try {
+      Napi::Object result = Napi::Object::New(env);
+      for (size_t i = 0; i < outputNames.size(); i++) {
+        // a preallocated output has been written in place: return the tensor given in fetch as is
+        if (reuseOutput[i]) {
+          result.Set(outputNames[i], fetch_.Value().Get(outputNames[i]));
+        } else {
+          result.Set(outputNames[i], OrtValueToNapiValue(env, std::move(outputValues[i])));
+        }
+      }
+      deferred_.Resolve(result);
+    } catch (Napi::Error const &e) {
+      deferred_.Reject(e.Value());
+    } catch (std::exception const &e) {
+      deferred_.Reject(Napi::Error::New(env, e.what()).Value());
+    }
+  }
+
+  void OnError(Napi::Error const &e) override { deferred_.Reject(e.Value()); }
+
+private:
+  std::shared_ptr<Ort::Session> session_;
+  std::shared_ptr<Ort::RunOptions> runOptions_;
+  Napi::ObjectReference feed_;
+  Napi::ObjectReference fetch_;
+  Napi::Promise::Deferred deferred_;
+};
+} // namespace
+
 Napi::Object InferenceSessionWrap::Init(Napi::Env env, Napi::Object exports) {
 #if defined(USE_DML) && defined(_WIN32)
   LoadDirectMLDll(env);
@@ -161,57 +236,42 @@ Napi::Value InferenceSessionWrap::Run(const Napi::CallbackInfo &info) {
   auto feed = info[0].As<Napi::Object>();
   auto fetch = info[1].As<Napi::Object>();
 
-  std::vector<const char *> inputNames_cstr;
-  std::vector<Ort::Value> inputValues;
-  std::vector<const char *> outputNames_cstr;
-  std::vector<Ort::Value> outputValues;
-  std::vector<bool> reuseOutput;
-  size_t inputIndex = 0;
-  size_t outputIndex = 0;
+  std::shared_ptr<Ort::RunOptions> runOptions = defaultRunOptions_;
+  if (info.Length() > 2) {
+    runOptions = std::make_shared<Ort::RunOptions>();
+    ParseRunOptions(info[2].As<Napi::Object>(), *runOptions);
+  }
+
+  // the worker deletes itself after settling the promise, once queued
+  auto worker = std::make_unique<RunWorker>(env, session_, std::move(runOptions), feed, fetch);
   OrtMemoryInfo *memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault).release();
 
   try {
     for (auto &name : inputNames_) {
       if (feed.Has(name)) {
-        inputIndex++;
-        inputNames_cstr.push_back(name.c_str());
+        worker->inputNames.push_back(name);
         auto value = feed.Get(name);
-        inputValues.push_back(NapiValueToOrtValue(env, value, memory_info));
+        worker->inputValues.push_back(NapiValueToOrtValue(env, value, memory_info));
       }
     }
     for (auto &name : outputNames_) {
       if (fetch.Has(name)) {
-        outputIndex++;
-        outputNames_cstr.push_back(name.c_str());
+        worker->outputNames.push_back(name);
         auto value = fetch.Get(name);
-        reuseOutput.push_back(!value.IsNull());
-        outputValues.emplace_back(value.IsNull() ? Ort::Value{nullptr} : NapiValueToOrtValue(env, value, memory_info));
+        worker->reuseOutput.push_back(!value.IsNull());
+        worker->outputValues.emplace_back(value.IsNull() ? Ort::Value{nullptr}
+                                                         : NapiValueToOrtValue(env, value, memory_info));
       }
     }
-
-    Ort::RunOptions runOptions{nullptr};
-    if (info.Length() > 2) {
-      runOptions = Ort::RunOptions{};
-      ParseRunOptions(info[2].As<Napi::Object>(), runOptions);
-    }
-
-    session_->Run(runOptions == nullptr ? *defaultRunOptions_.get() : runOptions,
-                  inputIndex == 0 ? nullptr : &inputNames_cstr[0], inputIndex == 0 ? nullptr : &inputValues[0],
-                  inputIndex, outputIndex == 0 ? nullptr : &outputNames_cstr[0],
-                  outputIndex == 0 ? nullptr : &outputValues[0], outputIndex);
-
-    Napi::Object result = Napi::Object::New(env);
-
-    for (size_t i = 0; i < outputIndex; i++) {
-      result.Set(outputNames_[i], OrtValueToNapiValue(env, outputValues[i]));
-    }
-
-    return scope.Escape(result);
   } catch (Napi::Error const &e) {
     throw e;
   } catch (std::exception const &e) {
     ORT_NAPI_THROW_ERROR(env, e.what());
   }
+
+  auto promise = worker->Promise();
+  worker.release()->Queue();
+  return scope.Escape(promise);
 }
 
 Napi::Value InferenceSessionWrap::Dispose(const Napi::CallbackInfo &info) {
@@ -219,8 +279,8 @@ Napi::Value InferenceSessionWrap::Dispose(const Napi::CallbackInfo &info) {
   ORT_NAPI_THROW_ERROR_IF(!this->initialized_, env, "Session is not initialized.");
   ORT_NAPI_THROW_ERROR_IF(this->disposed_, env, "Session already disposed.");
 
-  this->defaultRunOptions_.reset(nullptr);
-  this->session_.reset(nullptr);
+  this->defaultRunOptions_.reset();
+  this->session_.reset();
 
   this->disposed_ = true;
   return env.Undefined();
@@ -47,11 +47,14 @@ private:
   Napi::Value GetOutputNames(const Napi::CallbackInfo &info);
 
   /**
-   * [sync] run the model.
+   * [async] run the model on a worker thread of the libuv thread pool. Multiple runs of a session can be in flight,
+   * their number being bounded by the size of the libuv thread pool (UV_THREADPOOL_SIZE). The data of the input and
+   * preallocated output tensors must not be modified before the promise settles.
    * @param arg0 input object: all keys must present, value is object
    * @param arg1 output object: at least one key must present, value can be null.
-   * @returns an object that every output specified will present and value must be object
-   * @throw error if status code != 0
+   * @param arg2 optional run options object
+   * @returns a promise resolved with an object that every output specified will present and value must be object
+   * @throw error if the arguments are invalid. The promise is rejected if status code != 0
    */
   Napi::Value Run(const Napi::CallbackInfo &info);
 
@@ -71,8 +74,9 @@ private:
   // session objects
   bool initialized_;
   bool disposed_;
-  std::unique_ptr<Ort::Session> session_;
-  std::unique_ptr<Ort::RunOptions> defaultRunOptions_;
+  // shared with the runs in flight, which keep them alive if the session is disposed before they complete
+  std::shared_ptr<Ort::Session> session_;
+  std::shared_ptr<Ort::RunOptions> defaultRunOptions_;
 
   // input/output metadata
   std::vector<std::string> inputNames_;
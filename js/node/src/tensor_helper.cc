@@ -5,6 +5,7 @@
 #include <memory>
 #include <sstream>
 #include <unordered_map>
+#include <utility>
 
 #include "common.h"
 #include "tensor_helper.h"
@@ -190,7 +191,20 @@ Ort::Value NapiValueToOrtValue(Napi::Env env, Napi::Value value, OrtMemoryInfo *
   }
 }
 
-Napi::Value OrtValueToNapiValue(Napi::Env env, Ort::Value &value) {
+namespace {
+// finalizer of the external ArrayBuffer of an output tensor, releasing the OrtValue which owns its data
+void ReleaseOutputValue(napi_env env, void * /*data*/, void *hint) {
+  auto *value = static_cast<OrtValue *>(hint);
+  auto tensorTypeAndShapeInfo = Ort::ConstValue{value}.GetTensorTypeAndShapeInfo();
+  int64_t byteLength = static_cast<int64_t>(tensorTypeAndShapeInfo.GetElementCount() *
+                                            DATA_TYPE_ELEMENT_SIZE_MAP[tensorTypeAndShapeInfo.GetElementType()]);
+  int64_t adjustedValue;
+  napi_adjust_external_memory(env, -byteLength, &adjustedValue);
+  Ort::GetApi().ReleaseValue(value);
+}
+} // namespace
+
+Napi::Value OrtValueToNapiValue(Napi::Env env, Ort::Value &&value) {
   Napi::EscapableHandleScope scope(env);
   auto returnValue = Napi::Object::New(env);
 
@@ -245,10 +259,28 @@ Napi::Value OrtValueToNapiValue(Napi::Env env, Ort::Value &value) {
     returnValue.Set("data", Napi::Value(env, stringArray));
   } else {
     // number data
-    // TODO: optimize memory
-    auto arrayBuffer = Napi::ArrayBuffer::New(env, size * DATA_TYPE_ELEMENT_SIZE_MAP[elemType]);
+    // the ArrayBuffer takes the ownership of the OrtValue and uses its data, which is released by the finalizer when
+    // the ArrayBuffer is collected. The data is copied if the runtime does not allow external buffers (eg. Electron).
+    size_t byteLength = size * DATA_TYPE_ELEMENT_SIZE_MAP[elemType];
+    napi_value arrayBuffer = nullptr;
     if (size > 0) {
-      memcpy(arrayBuffer.Data(), value.GetTensorRawData(), size * DATA_TYPE_ELEMENT_SIZE_MAP[elemType]);
+      void *data = value.GetTensorMutableRawData();
+      OrtValue *ownedValue = value;
+      if (napi_create_external_arraybuffer(env, data, byteLength, ReleaseOutputValue, ownedValue, &arrayBuffer) ==
+          napi_ok) {
+        value.release();
+        int64_t adjustedValue;
+        napi_adjust_external_memory(env, static_cast<int64_t>(byteLength), &adjustedValue);
+      } else {
+        arrayBuffer = nullptr;
+      }
+    }
+    if (arrayBuffer == nullptr) {
+      auto copiedArrayBuffer = Napi::ArrayBuffer::New(env, byteLength);
+      if (size > 0) {
+        memcpy(copiedArrayBuffer.Data(), value.GetTensorRawData(), byteLength);
+      }
+      arrayBuffer = copiedArrayBuffer;
     }
     napi_value typedArrayData;
     napi_status status =
@@ -104,6 +104,9 @@ struct GroupQueryAttentionParameters {
   bool kv_share_buffer;
   bool is_packed_qkv;
   bool is_prompt;  // determines if seqlens_k is past or kv sequence length tensor
+  bool paged_kv_cache;          // past kv tensors are a pool of blocks indexed by block_table
+  int kv_cache_block_size;      // number of tokens per block of paged kv cache
+  int max_blocks_per_sequence;  // dimension 1 of block_table
   bool do_rotary;
   bool rotary_interleaved;
   float scale;
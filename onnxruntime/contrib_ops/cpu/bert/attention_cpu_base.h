@@ -6,9 +6,15 @@
 #include "attention_base.h"
 #include "attention_helper.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
 #include "core/common/common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/env_var_utils.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -16,7 +22,9 @@ namespace contrib {
 class AttentionCPUBase : public AttentionBase {
  protected:
   AttentionCPUBase(const OpKernelInfo& info, bool require_same_hidden_size)
-      : AttentionBase(info, require_same_hidden_size) {}
+      : AttentionBase(info, require_same_hidden_size) {
+    disable_flash_attention_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
+  }
 
   template <typename T>
   Status ApplyAttention(const T* Q,                            // Q data with shape BxNxSxH
@@ -53,11 +61,6 @@ class AttentionCPUBase : public AttentionBase {
     // Total sequence length including that of past state: T = P + L
     const int total_sequence_length = past_sequence_length + kv_sequence_length;
 
-    // Compute the attention score.
-    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * total_sequence_length * sizeof(T);
-    auto attention_probs = allocator->Alloc(bytes);
-    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
-
     bool causal = (is_unidirectional_ && sequence_length > 1);
 
     void* mask_data = nullptr;
@@ -79,16 +82,43 @@ class AttentionCPUBase : public AttentionBase {
     const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
     T* present_value_data = present_value != nullptr ? present_value->MutableData<T>() : nullptr;
 
+    // The bias may be shared by all the batches, with a shape of 1xNxSxT.
     const T* relative_position_bias_data = nullptr;
+    bool broadcast_relative_position_bias = false;
     if (relative_position_bias != nullptr) {
       relative_position_bias_data = relative_position_bias->Data<T>();
+      broadcast_relative_position_bias = relative_position_bias->Shape().GetDims()[0] == 1;
+    }
+
+    if constexpr (std::is_same<T, float>::value) {
+      if (!disable_flash_attention_ && total_sequence_length > kFlashAttentionKVBlockSize) {
+        // mask_data is nullptr when mask_index is nullptr and not unidirectional, otherwise its shape is BxSxT
+        if (mask_data != nullptr) {
+          PrepareMask(mask_index_data, mask_index_dims, static_cast<T*>(mask_data),
+                      causal, batch_size, sequence_length, past_sequence_length, mask_filter_value_);
+        }
+
+        ComputeFlashAttention(output->MutableData<T>(), Q, K, V, static_cast<const T*>(mask_data),
+                              batch_size, sequence_length, kv_sequence_length, past_sequence_length,
+                              qk_head_size == 0 ? v_head_size : qk_head_size, v_head_size, v_hidden_size,
+                              past_data, past_key_data, past_value_data,
+                              present_data, present_key_data, present_value_data,
+                              relative_position_bias_data, broadcast_relative_position_bias, allocator, tp);
+        return Status::OK();
+      }
     }
 
+    // Compute the attention score.
+    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * total_sequence_length * sizeof(T);
+    auto attention_probs = allocator->Alloc(bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
                              mask_index_data, mask_index_dims, static_cast<T*>(mask_data), causal,
                              batch_size, sequence_length, kv_sequence_length, past_sequence_length,
                              qk_head_size == 0 ? v_head_size : qk_head_size, past_data, past_key_data,
-                             present_data, present_key_data, tp, relative_position_bias_data);
+                             present_data, present_key_data, tp, relative_position_bias_data,
+                             broadcast_relative_position_bias);
 
     // Compute the attentionScore * Value: out_tmp(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
     auto out_tmp_data =
@@ -104,7 +134,211 @@ class AttentionCPUBase : public AttentionBase {
     return Status::OK();
   }
 
+  // Disables the tiled kernel of float attention with a total sequence length above kFlashAttentionKVBlockSize.
+  // Set from the ORT_DISABLE_FLASH_ATTENTION environment variable.
+  bool disable_flash_attention_;
+
  private:
+  // Block sizes of the tiled attention. A block of scores, and the blocks of K and V it multiplies, fit in the L2
+  // cache for the usual head sizes.
+  static constexpr int kFlashAttentionQBlockSize = 64;
+  static constexpr int kFlashAttentionKVBlockSize = 128;
+
+  // Tiled attention with an online softmax, which never materializes the attention probs of shape BxNxSxT.
+  // For each block of rows of Q, the blocks of K and V are processed in turn:
+  //  scores(S_q, T_kv) = 1/sqrt(H) x Q(S_q, H) x K'(H, T_kv) + mask_data(S_q, T_kv) + relative_position_bias(S_q, T_kv)
+  //  the running max of each row is updated, and the running sum of exp(scores - max) and the accumulated output
+  //  are rescaled by exp(previous max - max), then output(S_q, H_v) += exp(scores - max) x V(T_kv, H_v).
+  // The output rows are divided by the running sums once all the blocks are processed.
+  void ComputeFlashAttention(float* output,                             // output with size BxSxNxH_v
+                             const float* Q,                            // Q data. Its size is BxNxSxH
+                             const float* K,                            // K data. Its size is BxNxLxH
+                             const float* V,                            // V data. Its size is BxNxLxH_v
+                             const float* mask_data,                    // mask data with shape BxSxT, or nullptr
+                             int batch_size,                            // batch size
+                             int sequence_length,                       // sequence length of Q (S)
+                             int kv_sequence_length,                    // sequence length of K or V (L)
+                             int past_sequence_length,                  // sequence length of past state (P)
+                             int head_size,                             // head size of Q or K (H)
+                             int v_head_size,                           // head size of V (H_v)
+                             int v_hidden_size,                         // hidden size of V (D_v)
+                             const float* past,                         // past state
+                             const float* past_key,                     // past key only (if not using past state)
+                             const float* past_value,                   // past value only (if not using past state)
+                             float* present,                            // present state
+                             float* present_key,                        // present key only (if not using present state)
+                             float* present_value,                      // present value only (if not using present state)
+                             const float* relative_position_bias_data,  // bias addition matrix with shape BxNxSxT
+                             bool broadcast_relative_position_bias,     // the bias has a shape of 1xNxSxT
+                             const AllocatorPtr& allocator,
+                             ThreadPool* tp) const {
+    const int total_sequence_length = past_sequence_length + kv_sequence_length;                    // T = P + L
+    const size_t k_past_chunk_length = static_cast<size_t>(past_sequence_length) * head_size;       // P x H
+    const size_t k_input_chunk_length = static_cast<size_t>(kv_sequence_length) * head_size;        // L x H
+    const size_t k_present_chunk_length = k_past_chunk_length + k_input_chunk_length;               // T x H
+    const size_t v_past_chunk_length = static_cast<size_t>(past_sequence_length) * v_head_size;     // P x H_v
+    const size_t v_input_chunk_length = static_cast<size_t>(kv_sequence_length) * v_head_size;      // L x H_v
+    const size_t v_present_chunk_length = v_past_chunk_length + v_input_chunk_length;               // T x H_v
+    const size_t q_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;           // S x H
+    const std::ptrdiff_t loop_len = SafeInt<std::ptrdiff_t>(batch_size) * num_heads_;
+
+    // The V part of the past and present states follows the K part.
+    const float* past_v = past;
+    float* present_v = present;
+    if (nullptr != past) {
+      past_v += SafeInt<std::ptrdiff_t>(batch_size) * num_heads_ * past_sequence_length * v_head_size;
+    }
+    if (nullptr != present) {
+      present_v += SafeInt<std::ptrdiff_t>(batch_size) * num_heads_ * total_sequence_length * v_head_size;
+    }
+
+    // Concatenate past_K and K, and past_V and V, into the present state before the blocks of Q that read them.
+    const bool concat_key = nullptr != present || nullptr != present_key;
+    const bool concat_value = nullptr != present || nullptr != present_value;
+    if (concat_key || concat_value) {
+      TensorOpCost concat_cost;
+      concat_cost.bytes_loaded = static_cast<double>((k_present_chunk_length + v_present_chunk_length) * sizeof(float));
+      concat_cost.bytes_stored = concat_cost.bytes_loaded;
+      ThreadPool::TryParallelFor(tp, loop_len, concat_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          if (nullptr != present) {
+            ConcatStateChunk(past, K + k_input_chunk_length * i, present,
+                             k_past_chunk_length, k_present_chunk_length, i);
+            ConcatStateChunk(past_v, V + v_input_chunk_length * i, present_v,
+                             v_past_chunk_length, v_present_chunk_length, i);
+            continue;
+          }
+          if (nullptr != present_key) {
+            ConcatStateChunk(past_key, K + k_input_chunk_length * i, present_key,
+                             k_past_chunk_length, k_present_chunk_length, i);
+          }
+          if (nullptr != present_value) {
+            ConcatStateChunk(past_value, V + v_input_chunk_length * i, present_value,
+                             v_past_chunk_length, v_present_chunk_length, i);
+          }
+        }
+      });
+    }
+
+    const float* k_data = nullptr != present ? present : (nullptr != present_key ? present_key : K);
+    const float* v_data = nullptr != present ? present_v : (nullptr != present_value ? present_value : V);
+    const size_t k_chunk_length = concat_key ? k_present_chunk_length : k_input_chunk_length;
+    const size_t v_chunk_length = concat_value ? v_present_chunk_length : v_input_chunk_length;
+
+    const int num_q_blocks = (sequence_length + kFlashAttentionQBlockSize - 1) / kFlashAttentionQBlockSize;
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(2 * kFlashAttentionQBlockSize * total_sequence_length * (head_size + v_head_size));
+    unit_cost.bytes_loaded = static_cast<double>(
+        (kFlashAttentionQBlockSize * head_size + total_sequence_length * (head_size + v_head_size)) * sizeof(float));
+    unit_cost.bytes_stored = static_cast<double>(kFlashAttentionQBlockSize * v_head_size * sizeof(float));
+    if (mask_data != nullptr) {
+      unit_cost.bytes_loaded += static_cast<double>(kFlashAttentionQBlockSize * total_sequence_length * sizeof(float));
+    }
+    if (relative_position_bias_data != nullptr) {
+      unit_cost.bytes_loaded += static_cast<double>(kFlashAttentionQBlockSize * total_sequence_length * sizeof(float));
+    }
+
+    ThreadPool::TryParallelFor(tp, loop_len * num_q_blocks, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      // Scratch buffers of the blocks processed by this thread.
+      auto scores = IAllocator::MakeUniquePtr<float>(allocator, kFlashAttentionQBlockSize * kFlashAttentionKVBlockSize);
+      auto output_block = IAllocator::MakeUniquePtr<float>(allocator,
+                                                           SafeInt<size_t>(kFlashAttentionQBlockSize) * v_head_size);
+      auto row_max_buffer = IAllocator::MakeUniquePtr<float>(allocator, kFlashAttentionQBlockSize);
+      auto row_sum_buffer = IAllocator::MakeUniquePtr<float>(allocator, kFlashAttentionQBlockSize);
+      float* row_max = row_max_buffer.get();
+      float* row_sum = row_sum_buffer.get();
+
+      for (std::ptrdiff_t task = begin; task != end; ++task) {
+        const std::ptrdiff_t i = task / num_q_blocks;
+        const int batch_index = static_cast<int>(i / num_heads_);
+        const int head_index = static_cast<int>(i % num_heads_);
+        const int q_start = static_cast<int>(task % num_q_blocks) * kFlashAttentionQBlockSize;
+        const int q_rows = std::min(kFlashAttentionQBlockSize, sequence_length - q_start);
+
+        const float* q = Q + q_input_chunk_length * i + static_cast<size_t>(q_start) * head_size;
+        const float* k = k_data + k_chunk_length * i;
+        const float* v = v_data + v_chunk_length * i;
+
+        std::fill_n(row_max, q_rows, -std::numeric_limits<float>::infinity());
+        std::fill_n(row_sum, q_rows, 0.0f);
+        std::fill_n(output_block.get(), static_cast<size_t>(q_rows) * v_head_size, 0.0f);
+
+        for (int kv_start = 0; kv_start < total_sequence_length; kv_start += kFlashAttentionKVBlockSize) {
+          const int kv_cols = std::min(kFlashAttentionKVBlockSize, total_sequence_length - kv_start);
+
+          MlasGemm(CblasNoTrans, CblasTrans, q_rows, kv_cols, head_size, alpha,
+                   q, head_size, k + static_cast<size_t>(kv_start) * head_size, head_size,
+                   0.0f, scores.get(), kv_cols, nullptr);
+
+          for (int r = 0; r < q_rows; r++) {
+            float* row = scores.get() + static_cast<size_t>(r) * kv_cols;
+            const size_t row_offset = static_cast<size_t>(q_start + r) * total_sequence_length + kv_start;
+            if (mask_data != nullptr) {
+              const float* mask_row =
+                  mask_data + static_cast<size_t>(batch_index) * sequence_length * total_sequence_length + row_offset;
+              for (int c = 0; c < kv_cols; c++) {
+                row[c] += mask_row[c];
+              }
+            }
+            if (relative_position_bias_data != nullptr) {
+              const float* bias_row =
+                  relative_position_bias_data +
+                  static_cast<size_t>(broadcast_relative_position_bias ? head_index : i) * sequence_length *
+                      total_sequence_length +
+                  row_offset;
+              for (int c = 0; c < kv_cols; c++) {
+                row[c] += bias_row[c];
+              }
+            }
+
+            const float block_max = *std::max_element(row, row + kv_cols);
+            const float new_max = std::max(row_max[r], block_max);
+            for (int c = 0; c < kv_cols; c++) {
+              row[c] -= new_max;
+            }
+            MlasComputeExp(row, row, kv_cols);
+
+            float block_sum = 0.0f;
+            for (int c = 0; c < kv_cols; c++) {
+              block_sum += row[c];
+            }
+
+            // exp(-inf) is 0 for the first block, which discards the zero initialized sum and output.
+            const float correction = std::exp(row_max[r] - new_max);
+            row_sum[r] = row_sum[r] * correction + block_sum;
+            row_max[r] = new_max;
+            if (correction != 1.0f) {
+              float* output_row = output_block.get() + static_cast<size_t>(r) * v_head_size;
+              for (int h = 0; h < v_head_size; h++) {
+                output_row[h] *= correction;
+              }
+            }
+          }
+
+          MlasGemm(CblasNoTrans, CblasNoTrans, q_rows, v_head_size, kv_cols, 1.0f,
+                   scores.get(), kv_cols, v + static_cast<size_t>(kv_start) * v_head_size, v_head_size,
+                   1.0f, output_block.get(), v_head_size, nullptr);
+        }
+
+        // Normalize and transpose: output_block(S_q, H_v) -> out(B, S, N, H_v)
+        for (int r = 0; r < q_rows; r++) {
+          const float* src = output_block.get() + static_cast<size_t>(r) * v_head_size;
+          const std::ptrdiff_t dest_offset =
+              (SafeInt<std::ptrdiff_t>(batch_index) * sequence_length + q_start + r) * v_hidden_size +
+              SafeInt<std::ptrdiff_t>(head_index) * v_head_size;
+          float* dest = output + dest_offset;
+          const float inv_sum = 1.0f / row_sum[r];
+          for (int h = 0; h < v_head_size; h++) {
+            dest[h] = src[h] * inv_sum;
+          }
+        }
+      }
+    });
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T) +
   //                                1 x mask_data(B, N, S, T)
@@ -127,7 +361,8 @@ class AttentionCPUBase : public AttentionBase {
                              T* present,                                // present state
                              T* present_key,                            // present key only (if not using present state)
                              ThreadPool* tp,                            // thread pool
-                             const T* relative_position_bias_data       // bias addition matrix with shape BxNxSxT
+                             const T* relative_position_bias_data,      // bias addition matrix with shape BxNxSxT
+                             bool broadcast_relative_position_bias      // the bias has a shape of 1xNxSxT
   ) const {
     const int total_sequence_length = past_sequence_length + kv_sequence_length;               // T = P + L
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length) * head_size;    // P x H
@@ -153,7 +388,13 @@ class AttentionCPUBase : public AttentionBase {
 
       if (mask_data != nullptr) {
         unit_cost.bytes_loaded += static_cast<double>(probs_matrix_bytes);
-        unit_cost.bytes_stored += static_cast<double>(probs_matrix_bytes);
+        if constexpr (!std::is_same<T, float>::value) {
+          unit_cost.bytes_stored += static_cast<double>(probs_matrix_bytes);
+        }
+      }
+
+      if constexpr (std::is_same<T, float>::value) {
+        unit_cost.compute_cycles += static_cast<double>(sequence_length * total_sequence_length) * 4;
       }
 
       if (present || present_key) {
@@ -174,13 +415,18 @@ class AttentionCPUBase : public AttentionBase {
 
           const int output_offset = static_cast<int>(i) * sequence_length * total_sequence_length;
           const int mask_offset = batch_index * sequence_length * total_sequence_length;
+          const int bias_offset = broadcast_relative_position_bias
+                                      ? static_cast<int>(i % num_heads_) * sequence_length * total_sequence_length
+                                      : output_offset;
           T* output = attention_probs + output_offset;
 
-          // Broadcast mask data: (Bx)SxT -> (BxNx)SxT
-          if (mask_data != nullptr) {
-            memcpy(output,
-                   mask_data + mask_offset,
-                   probs_matrix_bytes);
+          // Broadcast mask data: (Bx)SxT -> (BxNx)SxT. For float, the softmax below adds the mask instead.
+          if constexpr (!std::is_same<T, float>::value) {
+            if (mask_data != nullptr) {
+              memcpy(output,
+                     mask_data + mask_offset,
+                     probs_matrix_bytes);
+            }
           }
 
           const T* k = K + kv_input_chunk_length * i;
@@ -196,21 +442,44 @@ class AttentionCPUBase : public AttentionBase {
           // A: Q                (B x N x) S x H          (B x N x) S x H        S x H
           // B: K'               (B x N x) T x H          (B x N x) H x T        H x T
           // C: attention_probs  (B x N x) S x T          (B x N x) S x T        S x T
-          math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_sequence_length, head_size, alpha,
-                                    Q + q_input_chunk_length * i, k, mask_data != nullptr ? 1.0f : 0.0f,
-                                    output, nullptr);
+          if constexpr (std::is_same<T, float>::value) {
+            // Compute Softmax(Q*K' + AttentionMask + RelativePositionBias) while the scores of the head are in cache.
+            // The mask, or the bias when there is no mask, is added by the softmax in the pass that finds the row
+            // maximums, instead of in separate passes over the scores.
+            math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_sequence_length, head_size,
+                                      alpha, Q + q_input_chunk_length * i, k, 0.0f, output, nullptr);
+
+            const float* additive_mask = nullptr;
+            if (mask_data != nullptr) {
+              additive_mask = mask_data + mask_offset;
+              if (relative_position_bias_data != nullptr) {
+                for (int j = 0; j < sequence_length * total_sequence_length; j++) {
+                  output[j] += relative_position_bias_data[bias_offset + j];
+                }
+              }
+            } else if (relative_position_bias_data != nullptr) {
+              additive_mask = relative_position_bias_data + bias_offset;
+            }
 
-          if (relative_position_bias_data != nullptr) {
-            for (int j = 0; j < sequence_length * total_sequence_length; j++) {
-              output[j] += relative_position_bias_data[output_offset + j];
+            MlasComputeSoftmaxWithScaleAndMask(output, output, sequence_length, total_sequence_length, 1.0f,
+                                               additive_mask, nullptr);
+          } else {
+            math::Gemm<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, total_sequence_length, head_size,
+                                      alpha, Q + q_input_chunk_length * i, k, mask_data != nullptr ? 1.0f : 0.0f,
+                                      output, nullptr);
+
+            if (relative_position_bias_data != nullptr) {
+              for (int j = 0; j < sequence_length * total_sequence_length; j++) {
+                output[j] += relative_position_bias_data[bias_offset + j];
+              }
             }
           }
         }
       });
     }
 
-    // attention_probs(B, N, S, T) = Softmax(attention_probs)
-    {
+    // attention_probs(B, N, S, T) = Softmax(attention_probs), already computed per head for float
+    if constexpr (!std::is_same<T, float>::value) {
       const int N = batch_size * num_heads_ * sequence_length;
       const int D = total_sequence_length;
       ComputeAttentionSoftmaxInplace(attention_probs, N, D, tp);
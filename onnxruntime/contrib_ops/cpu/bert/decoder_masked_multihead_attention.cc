@@ -0,0 +1,361 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/bert/decoder_masked_multihead_attention.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "contrib_ops/cpu/bert/attention_common.h"
+#include "contrib_ops/cpu/bert/multihead_attention_helper.h"
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+static constexpr int kPastInputIndex = 5;
+static constexpr int kPastSequenceLengthInputIndex = 7;
+static constexpr int kBeamWidthInputIndex = 8;
+static constexpr int kCacheIndirectionInputIndex = 9;
+static constexpr int kBiasIndex = 10;
+static constexpr int kPresentOutputIndex = 1;
+static constexpr int kQKOutputIndex = 3;
+
+// These ops are internal-only, so register outside of onnx
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DecoderMaskedMultiHeadAttention,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .MayInplace(kPastInputIndex, kPresentOutputIndex)
+        .MayInplace(kPastInputIndex + 1, kPresentOutputIndex + 1)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    DecoderMaskedMultiHeadAttention<float>);
+
+template <typename T>
+DecoderMaskedMultiHeadAttention<T>::DecoderMaskedMultiHeadAttention(const OpKernelInfo& info) : OpKernel(info) {
+  int64_t num_heads = 0;
+  ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+  num_heads_ = static_cast<int>(num_heads);
+  mask_filter_value_ = info.GetAttrOrDefault<float>("mask_filter_value", -10000.0f);
+  scale_ = info.GetAttrOrDefault<float>("scale", 0.0f);
+  past_present_share_buffer_ = info.GetAttrOrDefault<int64_t>("past_present_share_buffer", 0LL) != 0;
+  output_qk_ = info.GetAttrOrDefault<int64_t>("output_qk", 0LL) != 0;
+}
+
+template <typename T>
+Status DecoderMaskedMultiHeadAttention<T>::Compute(OpKernelContext* context) const {
+  const Tensor* query = context->Input<Tensor>(0);
+  const Tensor* key = context->Input<Tensor>(1);
+  const Tensor* value = context->Input<Tensor>(2);
+  const Tensor* mask_index = context->Input<Tensor>(3);
+  const Tensor* relative_position_bias = context->Input<Tensor>(4);
+  const Tensor* past_key = context->Input<Tensor>(kPastInputIndex);
+  const Tensor* past_value = context->Input<Tensor>(kPastInputIndex + 1);
+  const Tensor* past_seq_len = context->Input<Tensor>(kPastSequenceLengthInputIndex);
+  const Tensor* beam_width_tensor = context->Input<Tensor>(kBeamWidthInputIndex);
+  const Tensor* cache_indir = context->Input<Tensor>(kCacheIndirectionInputIndex);
+  const Tensor* bias = context->Input<Tensor>(kBiasIndex);
+
+  AttentionParameters parameters = {};
+  const bool is_dmmha_packing = (key == nullptr && value == nullptr);
+  ORT_RETURN_IF_ERROR(multihead_attention_helper::CheckInputs<Tensor>(query,
+                                                                      key,
+                                                                      value,
+                                                                      bias,
+                                                                      mask_index,
+                                                                      relative_position_bias,
+                                                                      past_key,
+                                                                      past_value,
+                                                                      past_seq_len,
+                                                                      &parameters,
+                                                                      num_heads_,
+                                                                      mask_filter_value_,
+                                                                      scale_,
+                                                                      false,  // is_unidirectional
+                                                                      past_present_share_buffer_,
+                                                                      is_dmmha_packing));
+
+  const int batch_size = parameters.batch_size;
+  const int hidden_size = parameters.hidden_size;
+  const int head_size = parameters.head_size;
+  const int v_hidden_size = parameters.v_hidden_size;
+
+  // This kernel is for decoding only (i.e.) sequence length has to be 1
+  if (parameters.sequence_length != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input sequence length should be 1 to use DecoderMaskedMultiHeadAttention. Actual length is ",
+                           parameters.sequence_length);
+  }
+
+  if (head_size != parameters.v_head_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "QK head size should be same as V head size to use DecoderMaskedMultiHeadAttention");
+  }
+
+  if (parameters.mask_type != AttentionMaskType::MASK_2D_KEY_PADDING &&
+      parameters.mask_type != AttentionMaskType::MASK_NONE) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "DecoderMaskedMultiHeadAttention only supports no mask or 2D key "
+                           "padding mask of shape [batch, total_seq_length] currently");
+  }
+
+  TensorShapeVector output_shape{batch_size, 1, v_hidden_size};
+  Tensor* output = context->Output(0, output_shape);
+
+  TensorShapeVector present_shape{
+      batch_size, num_heads_,
+      past_present_share_buffer_ ? parameters.max_sequence_length : parameters.total_sequence_length,
+      head_size};
+  Tensor* present_key = context->Output(kPresentOutputIndex, present_shape);
+  Tensor* present_value = context->Output(kPresentOutputIndex + 1, present_shape);
+
+  const bool is_cross_attention = past_key == nullptr && present_key == nullptr;
+  if (is_cross_attention) {
+    ORT_RETURN_IF_NOT(key != nullptr && key->Shape().NumDimensions() == 4,
+                      "DecoderMaskedMultiHeadAttention cross attention expects the key and value of shape "
+                      "(batch_size, num_heads, kv_sequence_length, head_size)");
+  } else {
+    ORT_RETURN_IF_NOT(past_present_share_buffer_ && past_key != nullptr && past_value != nullptr &&
+                          present_key != nullptr && present_value != nullptr,
+                      "DecoderMaskedMultiHeadAttention self attention requires past_present_share_buffer with "
+                      "past and present key and value");
+  }
+
+  // Number of keys attended to: the past and the new token for self attention, the encoder output for cross attention
+  const int total_sequence_length = is_cross_attention ? parameters.kv_sequence_length
+                                                       : parameters.past_sequence_length + 1;
+
+  Tensor* qk = nullptr;
+  if (output_qk_) {
+    TensorShapeVector qk_shape{batch_size, num_heads_, 1, total_sequence_length};
+    qk = context->Output(kQKOutputIndex, qk_shape);
+  }
+  float* qk_data = qk != nullptr ? qk->MutableData<float>() : nullptr;
+
+  int beam_width = 1;
+  if (beam_width_tensor != nullptr) {
+    beam_width = static_cast<int>(*beam_width_tensor->Data<int32_t>());
+  }
+
+  const float scale = scale_ == 0.0f ? 1.0f / std::sqrt(static_cast<float>(head_size)) : scale_;
+
+  const T* q_bias = bias != nullptr ? bias->Data<T>() : nullptr;
+  const T* k_bias = q_bias != nullptr ? q_bias + hidden_size : nullptr;
+  const T* v_bias = q_bias != nullptr ? q_bias + 2 * static_cast<size_t>(hidden_size) : nullptr;
+
+  // The query, key and value of the new token are (B, 1, D), or packed in the query as (B, 1, 3 * D).
+  const size_t qkv_stride = is_dmmha_packing ? 3 * static_cast<size_t>(hidden_size) : static_cast<size_t>(hidden_size);
+  const T* query_data = query->Data<T>();
+
+  const int32_t* mask_data = nullptr;
+  size_t mask_stride = 0;
+  if (parameters.mask_type == AttentionMaskType::MASK_2D_KEY_PADDING) {
+    mask_data = mask_index->Data<int32_t>();
+    mask_stride = static_cast<size_t>(mask_index->Shape()[1]);
+  }
+
+  const T* relative_position_bias_data = nullptr;
+  bool broadcast_relative_position_bias = false;
+  if (relative_position_bias != nullptr) {
+    relative_position_bias_data = relative_position_bias->Data<T>();
+    broadcast_relative_position_bias = relative_position_bias->Shape()[0] == 1;
+  }
+
+  // Loads the query of the new token with its bias and the scale applied.
+  auto load_query = [&](int batch_index, int head_index, T* q) {
+    const T* src = query_data + batch_index * qkv_stride + static_cast<size_t>(head_index) * head_size;
+    const T* src_bias = q_bias != nullptr ? q_bias + static_cast<size_t>(head_index) * head_size : nullptr;
+    for (int h = 0; h < head_size; h++) {
+      q[h] = (src_bias != nullptr ? src[h] + src_bias[h] : src[h]) * scale;
+    }
+  };
+
+  // Adds the mask and the relative position bias to the scores of the query, and saves them to the qk output.
+  auto finish_scores = [&](int batch_index, int head_index, T* scores) {
+    if (mask_data != nullptr) {
+      const int32_t* mask = mask_data + batch_index * mask_stride;
+      for (int t = 0; t < total_sequence_length; t++) {
+        if (mask[t] == 0) {
+          scores[t] += mask_filter_value_;
+        }
+      }
+    }
+    if (relative_position_bias_data != nullptr) {
+      const T* bias_row = relative_position_bias_data +
+                          ((broadcast_relative_position_bias ? 0 : static_cast<size_t>(batch_index)) * num_heads_ +
+                           head_index) *
+                              total_sequence_length;
+      for (int t = 0; t < total_sequence_length; t++) {
+        scores[t] += bias_row[t];
+      }
+    }
+    if (qk_data != nullptr) {
+      std::memcpy(qk_data + (static_cast<size_t>(batch_index) * num_heads_ + head_index) * total_sequence_length,
+                  scores, total_sequence_length * sizeof(float));
+    }
+  };
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  auto* tp = context->GetOperatorThreadPool();
+  T* output_data = output->MutableData<T>();
+
+  if (is_cross_attention) {
+    // The key and value of cross attention are the same for all the beams of a batch entry, so the beams are
+    // processed together against the key and value of the first beam, which are read once per head.
+    const int group_size = (beam_width > 1 && batch_size % beam_width == 0) ? beam_width : 1;
+    const std::ptrdiff_t num_groups = batch_size / group_size;
+    const size_t kv_chunk_length = static_cast<size_t>(total_sequence_length) * head_size;
+    const T* key_data = key->Data<T>();
+    const T* value_data = value->Data<T>();
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles = static_cast<double>(4 * static_cast<int64_t>(group_size) * kv_chunk_length);
+    unit_cost.bytes_loaded = static_cast<double>(2 * kv_chunk_length * sizeof(T));
+    unit_cost.bytes_stored = static_cast<double>(group_size * head_size * sizeof(T));
+
+    ThreadPool::TryParallelFor(tp, num_groups * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      auto scratch = IAllocator::MakeUniquePtr<T>(
+          allocator, SafeInt<size_t>(group_size) * (head_size + total_sequence_length));
+      T* q = scratch.get();
+      T* scores = q + static_cast<size_t>(group_size) * head_size;
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int first_batch_index = static_cast<int>(i / num_heads_) * group_size;
+        const int head_index = static_cast<int>(i % num_heads_);
+
+        for (int j = 0; j < group_size; j++) {
+          load_query(first_batch_index + j, head_index, q + static_cast<size_t>(j) * head_size);
+        }
+
+        const size_t kv_offset = (static_cast<size_t>(first_batch_index) * num_heads_ + head_index) * kv_chunk_length;
+        MlasGemm(CblasNoTrans, CblasTrans, group_size, total_sequence_length, head_size, 1.0f,
+                 q, head_size, key_data + kv_offset, head_size,
+                 0.0f, scores, total_sequence_length, nullptr);
+
+        for (int j = 0; j < group_size; j++) {
+          finish_scores(first_batch_index + j, head_index, scores + static_cast<size_t>(j) * total_sequence_length);
+        }
+
+        MlasComputeSoftmax(scores, scores, group_size, total_sequence_length, false, nullptr);
+
+        // The output rows of the beams are v_hidden_size apart.
+        MlasGemm(CblasNoTrans, CblasNoTrans, group_size, head_size, total_sequence_length, 1.0f,
+                 scores, total_sequence_length, value_data + kv_offset, head_size,
+                 0.0f, output_data + static_cast<size_t>(first_batch_index) * v_hidden_size +
+                           static_cast<size_t>(head_index) * head_size,
+                 v_hidden_size, nullptr);
+      }
+    });
+
+    return Status::OK();
+  }
+
+  // Self attention: the new key and value are written to the shared buffers at past_sequence_length. The past is
+  // read from the beam given by the cache indirection, with shape (batch_size / beam_width, beam_width, max_length).
+  const int past_sequence_length = parameters.past_sequence_length;
+  const int max_sequence_length = parameters.max_sequence_length;
+  if (past_sequence_length >= max_sequence_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "past_sequence_length ", past_sequence_length,
+                           " leaves no room for the new token in the past buffer of length ", max_sequence_length);
+  }
+
+  const int32_t* cache_indir_data = nullptr;
+  size_t cache_indir_stride = 0;
+  if (beam_width > 1) {
+    if (cache_indir == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "If beam width is greater than 1, then cache indirection buffer MUST be present");
+    }
+    cache_indir_data = cache_indir->Data<int32_t>();
+    cache_indir_stride = static_cast<size_t>(cache_indir->Shape()[2]);
+  }
+
+  T* present_key_data = present_key->MutableData<T>();
+  T* present_value_data = present_value->MutableData<T>();
+
+  // The generation ops share the past and present buffers. Otherwise, the past is copied to the present first.
+  if (present_key_data != past_key->Data<T>()) {
+    std::memcpy(present_key_data, past_key->Data<T>(), past_key->SizeInBytes());
+  }
+  if (present_value_data != past_value->Data<T>()) {
+    std::memcpy(present_value_data, past_value->Data<T>(), past_value->SizeInBytes());
+  }
+
+  const T* key_data = is_dmmha_packing ? query_data + hidden_size : key->Data<T>();
+  const T* value_data = is_dmmha_packing ? query_data + 2 * static_cast<size_t>(hidden_size) : value->Data<T>();
+  const size_t cache_chunk_length = static_cast<size_t>(max_sequence_length) * head_size;
+
+  TensorOpCost unit_cost;
+  unit_cost.compute_cycles = static_cast<double>(4 * static_cast<int64_t>(total_sequence_length) * head_size);
+  unit_cost.bytes_loaded = static_cast<double>(2 * static_cast<size_t>(total_sequence_length) * head_size * sizeof(T));
+  unit_cost.bytes_stored = static_cast<double>(3 * head_size * sizeof(T));
+
+  ThreadPool::TryParallelFor(tp, SafeInt<std::ptrdiff_t>(batch_size) * num_heads_, unit_cost,
+                             [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    auto scratch = IAllocator::MakeUniquePtr<T>(allocator, SafeInt<size_t>(head_size) + total_sequence_length);
+    T* q = scratch.get();
+    T* scores = q + head_size;
+
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const int batch_index = static_cast<int>(i / num_heads_);
+      const int head_index = static_cast<int>(i % num_heads_);
+      const size_t head_offset = static_cast<size_t>(head_index) * head_size;
+
+      load_query(batch_index, head_index, q);
+
+      // Append the key and value of the new token. Other tasks only read the past positions of this row.
+      const size_t cache_offset = static_cast<size_t>(i) * cache_chunk_length;
+      T* new_key = present_key_data + cache_offset + static_cast<size_t>(past_sequence_length) * head_size;
+      T* new_value = present_value_data + cache_offset + static_cast<size_t>(past_sequence_length) * head_size;
+      const T* key_src = key_data + batch_index * qkv_stride + head_offset;
+      const T* value_src = value_data + batch_index * qkv_stride + head_offset;
+      for (int h = 0; h < head_size; h++) {
+        new_key[h] = k_bias != nullptr ? key_src[h] + k_bias[head_offset + h] : key_src[h];
+        new_value[h] = v_bias != nullptr ? value_src[h] + v_bias[head_offset + h] : value_src[h];
+      }
+
+      // The offset of the key and value of position t in the shared buffers.
+      const int32_t* beam_indices = cache_indir_data != nullptr ? cache_indir_data + batch_index * cache_indir_stride
+                                                                : nullptr;
+      const int first_beam_index = (batch_index / beam_width) * beam_width;
+      auto position_offset = [&](int t) {
+        const int source_batch_index = (beam_indices != nullptr && t < past_sequence_length)
+                                           ? first_beam_index + beam_indices[t]
+                                           : batch_index;
+        return (static_cast<size_t>(source_batch_index) * num_heads_ + head_index) * cache_chunk_length +
+               static_cast<size_t>(t) * head_size;
+      };
+
+      ConstEigenVectorMap<T> q_vector(q, head_size);
+      for (int t = 0; t < total_sequence_length; t++) {
+        scores[t] = q_vector.dot(ConstEigenVectorMap<T>(present_key_data + position_offset(t), head_size));
+      }
+
+      finish_scores(batch_index, head_index, scores);
+
+      MlasComputeSoftmax(scores, scores, 1, total_sequence_length, false, nullptr);
+
+      EigenVectorMap<T> output_vector(output_data + static_cast<size_t>(batch_index) * v_hidden_size + head_offset,
+                                      head_size);
+      output_vector.setZero();
+      for (int t = 0; t < total_sequence_length; t++) {
+        output_vector += scores[t] * ConstEigenVectorMap<T>(present_value_data + position_offset(t), head_size);
+      }
+    }
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
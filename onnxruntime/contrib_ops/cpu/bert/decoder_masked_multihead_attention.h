@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Attention of a single query token per sequence, for the decoder steps of the generation ops.
+// Self attention appends the new key and value to the shared past/present buffers, and reads the past through the
+// cache indirection of beam search. Cross attention consumes the key and value computed once from the encoder output;
+// the beams of a batch entry share them, so they are read once for all the beams.
+template <typename T>
+class DecoderMaskedMultiHeadAttention final : public OpKernel {
+ public:
+  DecoderMaskedMultiHeadAttention(const OpKernelInfo& info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int num_heads_;  // number of attention heads
+  float mask_filter_value_;
+  float scale_;
+  bool past_present_share_buffer_;
+  bool output_qk_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
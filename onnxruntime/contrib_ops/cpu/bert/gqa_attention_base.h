@@ -5,6 +5,10 @@
 
 #include "attention_base.h"
 #include "attention_helper.h"
+#include "rotary_embedding_helper.h"
+
+#include <algorithm>
+#include <cmath>
 
 #include "core/common/common.h"
 #include "contrib_ops/cpu/bert/attention_common.h"
@@ -33,6 +37,9 @@ class GQAAttentionBase : public AttentionBase {
                         Tensor* present_key,                        // present K output tensor (if separating present KV)
                         Tensor* present_value,                      // present V output tensor (if separating present KV)
                         const Tensor* seqlens_k,                    // past sequence lengths tensor
+                        const Tensor* block_table,                  // block table of paged kv cache
+                        const Tensor* cos_cache,                    // cos cache of rotary embedding
+                        const Tensor* sin_cache,                    // sin cache of rotary embedding
                         GroupQueryAttentionParameters& parameters,  // attention parameters
                         AllocatorPtr allocator,                     // allocator for temporary tensors
                         OpKernelContext* context) const {
@@ -44,11 +51,21 @@ class GQAAttentionBase : public AttentionBase {
 
     auto* tp = context->GetOperatorThreadPool();
 
+    const bool paged_kv_cache = parameters.paged_kv_cache;
+    if (paged_kv_cache) {
+      ORT_RETURN_IF(present_key == nullptr || present_value == nullptr,
+                    "present_key and present_value are required for paged kv cache.");
+      ORT_RETURN_IF_ERROR(CheckBlockTable(seqlens_k->Data<int32_t>(), block_table->Data<int32_t>(), batch_size,
+                                          static_cast<int>(past_key->Shape()[0]), parameters.kv_cache_block_size,
+                                          parameters.max_blocks_per_sequence));
+    }
+
     int seqlen_past_kv_cache = 0;
-    if (past_key != nullptr && past_value != nullptr) {
+    if (past_key != nullptr && past_value != nullptr && !paged_kv_cache) {
       seqlen_past_kv_cache = static_cast<int>(past_key->Shape().GetDims()[2]);
     }
-    int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
+    int seqlen_present_kv_cache = paged_kv_cache ? parameters.seqlen_present_kv_cache
+                                                 : static_cast<int>(present_key->Shape().GetDims()[2]);
 
     // Compute the attention score.
     size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(T);
@@ -63,22 +80,359 @@ class GQAAttentionBase : public AttentionBase {
     bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
 
     const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+
+    // The rotary embedding is applied to Q and the new K while they are copied for the attention, instead of in a
+    // separate pass over them.
+    const T* cos_cache_data = do_rotary_ ? cos_cache->Data<T>() : nullptr;
+    const T* sin_cache_data = do_rotary_ ? sin_cache->Data<T>() : nullptr;
+    const int rotary_dim = parameters.rotary_dim;
+
+    const int32_t* block_table_data = nullptr;
+    if (paged_kv_cache) {
+      // Blocks not touched by this run are carried over from past to present.
+      if (!past_present_share_buffer) {
+        memcpy(present_key_data, past_key_data, past_key->SizeInBytes());
+        memcpy(present_value_data, past_value_data, past_value->SizeInBytes());
+      }
+      block_table_data = block_table->Data<int32_t>();
+      WriteKVCacheBlocks(k, v, present_key_data, present_value_data, seqlens_k->Data<int32_t>(), block_table_data,
+                         batch_size, sequence_length, head_size, parameters.kv_cache_block_size,
+                         parameters.max_blocks_per_sequence, packed_qkv,
+                         cos_cache_data, sin_cache_data, rotary_dim, tp);
+    }
+
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, k,
                              seqlens_k->Data<int32_t>(),
                              batch_size, sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache,
-                             head_size, past_key_data, present_key_data, past_present_share_buffer, packed_qkv, tp);
+                             head_size, past_key_data, present_key_data, past_present_share_buffer, packed_qkv,
+                             block_table_data, parameters.kv_cache_block_size, parameters.max_blocks_per_sequence,
+                             cos_cache_data, sin_cache_data, rotary_dim, allocator, tp);
 
     // Compute the attentionScore * Value: out(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
-    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
     ComputeVxAttentionScore(output->MutableData<T>(), static_cast<T*>(attention_probs),
                             v, seqlens_k->Data<int32_t>(), batch_size, sequence_length, seqlen_past_kv_cache,
                             seqlen_present_kv_cache, head_size, hidden_size, past_value_data, present_value_data,
-                            past_present_share_buffer, packed_qkv, tp);
+                            past_present_share_buffer, packed_qkv,
+                            block_table_data, parameters.kv_cache_block_size, parameters.max_blocks_per_sequence,
+                            tp);
+
+    return Status::OK();
+  }
+
+  // Attention with a kv cache quantized to int8, with a symmetric scale per kv head or for all kv heads.
+  // The new key and value are quantized while they are appended to the cache, and the cache is dequantized within
+  // the products with Q and the attention probs, so that token generation reads 1 byte per cached element.
+  template <typename T>
+  Status ApplyQuantizedKVCacheAttention(const T* Q,                                 // Q data with shape BxNxSxH
+                                        const T* K,                                 // K data with shape BxN_kvxSxH
+                                        const T* V,                                 // V data with shape BxN_kvxSxH
+                                        const Tensor* past_key,                     // int8 past K input tensor
+                                        const Tensor* past_value,                   // int8 past V input tensor
+                                        Tensor* output,                             // output tensor
+                                        Tensor* present_key,                        // int8 present K output tensor
+                                        Tensor* present_value,                      // int8 present V output tensor
+                                        const Tensor* seqlens_k,                    // past sequence lengths tensor
+                                        const Tensor* cos_cache,                    // cos cache of rotary embedding
+                                        const Tensor* sin_cache,                    // sin cache of rotary embedding
+                                        const Tensor* k_scale,                      // scales of the key cache
+                                        const Tensor* v_scale,                      // scales of the value cache
+                                        GroupQueryAttentionParameters& parameters,  // attention parameters
+                                        AllocatorPtr allocator,                     // allocator for temporary buffers
+                                        OpKernelContext* context) const {
+    if (parameters.paged_kv_cache) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "int8 kv cache is not supported with paged kv cache.");
+    }
+
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int hidden_size = parameters.hidden_size;
+    const bool packed_qkv = parameters.is_packed_qkv;
+    const bool is_prompt = sequence_length != 1;
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+
+    auto* tp = context->GetOperatorThreadPool();
+
+    const int past_buffer_sequence_length = static_cast<int>(past_key->Shape().GetDims()[2]);
+    const int present_buffer_sequence_length = static_cast<int>(present_key->Shape().GetDims()[2]);
+    const size_t q_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;                      // S x H
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;                     // S x H
+    const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;        // L x H
+    const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+    const size_t packed_batch_stride =
+        packed_qkv ? (num_heads_ + 2 * kv_num_heads_) * kv_input_chunk_length : 0;
+
+    const int8_t* past_key_data = past_key->Data<int8_t>();
+    const int8_t* past_value_data = past_value->Data<int8_t>();
+    int8_t* present_key_data = present_key->MutableData<int8_t>();
+    int8_t* present_value_data = present_value->MutableData<int8_t>();
+    const bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
+
+    const float* k_scale_data = k_scale->Data<float>();
+    const float* v_scale_data = v_scale->Data<float>();
+    const bool per_head_k_scale = k_scale->Shape().Size() > 1;
+    const bool per_head_v_scale = v_scale->Shape().Size() > 1;
+
+    const T* k = packed_qkv ? Q + num_heads_ * q_input_chunk_length : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * q_input_chunk_length : V;
+
+    const T* cos_cache_data = do_rotary_ ? cos_cache->Data<T>() : nullptr;
+    const T* sin_cache_data = do_rotary_ ? sin_cache->Data<T>() : nullptr;
+    const int rotary_dim = parameters.rotary_dim;
+
+    // Append the quantized new key and value to the past ones in the present buffers.
+    TensorOpCost append_cost;
+    append_cost.compute_cycles = static_cast<double>(4 * kv_input_chunk_length);
+    append_cost.bytes_loaded = static_cast<double>(2 * (kv_input_chunk_length * sizeof(T) + past_buff_chunk_length));
+    append_cost.bytes_stored = static_cast<double>(2 * present_buff_chunk_length);
+
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, append_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      // Rotated new key of a token.
+      IAllocatorUniquePtr<T> k_rotary;
+      if (cos_cache_data != nullptr) {
+        k_rotary = IAllocator::MakeUniquePtr<T>(allocator, head_size);
+      }
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i / kv_num_heads_);
+        const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+        const int past_seqlen = is_prompt ? 0 : static_cast<int>(seqlens_k[batch_index]);
+        const size_t past_chunk_length = static_cast<size_t>(past_seqlen) * head_size;
+        const float k_inverse_scale = 1.0f / k_scale_data[per_head_k_scale ? kv_head_index : 0];
+        const float v_inverse_scale = 1.0f / v_scale_data[per_head_v_scale ? kv_head_index : 0];
+
+        const size_t input_offset = packed_qkv ? packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index
+                                               : kv_input_chunk_length * i;
+        int8_t* present_k = present_key_data + present_buff_chunk_length * i;
+        int8_t* present_v = present_value_data + present_buff_chunk_length * i;
+        if (!past_present_share_buffer) {
+          memcpy(present_k, past_key_data + past_buff_chunk_length * i, past_chunk_length);
+          memcpy(present_v, past_value_data + past_buff_chunk_length * i, past_chunk_length);
+          const size_t end_of_new_chunk = past_chunk_length + kv_input_chunk_length;
+          if (end_of_new_chunk < present_buff_chunk_length) {
+            memset(present_k + end_of_new_chunk, 0, present_buff_chunk_length - end_of_new_chunk);
+            memset(present_v + end_of_new_chunk, 0, present_buff_chunk_length - end_of_new_chunk);
+          }
+        }
+
+        for (int seq = 0; seq < sequence_length; seq++) {
+          const T* k_token = k + input_offset + static_cast<size_t>(seq) * head_size;
+          if (cos_cache_data != nullptr) {
+            rotary_embedding_helper::RotateToken(k_token, k_rotary.get(), past_seqlen + seq, cos_cache_data,
+                                                 sin_cache_data, rotary_dim, head_size, rotary_interleaved_);
+            k_token = k_rotary.get();
+          }
+          const size_t token_offset = past_chunk_length + static_cast<size_t>(seq) * head_size;
+          QuantizeKVCacheToken(k_token, present_k + token_offset, head_size, k_inverse_scale);
+          QuantizeKVCacheToken(v + input_offset + static_cast<size_t>(seq) * head_size, present_v + token_offset,
+                               head_size, v_inverse_scale);
+        }
+      }
+    });
+
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles = static_cast<double>(4 * sequence_length * head_size * present_buffer_sequence_length);
+    unit_cost.bytes_loaded = static_cast<double>(q_input_chunk_length * sizeof(T) + 2 * present_buff_chunk_length);
+    unit_cost.bytes_stored = static_cast<double>(q_input_chunk_length * sizeof(T));
+
+    ThreadPool::TryGuidedParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      auto scores = IAllocator::MakeUniquePtr<T>(allocator, SafeInt<size_t>(sequence_length) * present_buffer_sequence_length);
+      IAllocatorUniquePtr<T> q_rotary;
+      if (cos_cache_data != nullptr) {
+        q_rotary = IAllocator::MakeUniquePtr<T>(allocator, q_input_chunk_length);
+      }
+      // A prompt has several queries per head, so its key and value are dequantized once and multiplied with GEMMs.
+      IAllocatorUniquePtr<T> dequantized;
+      if (is_prompt) {
+        dequantized = IAllocator::MakeUniquePtr<T>(allocator, present_buff_chunk_length);
+      }
+
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i / num_heads_);
+        const int head_index = static_cast<int>(i % num_heads_);
+        const int kv_head_index = head_index / kv_num_heads_factor;
+        const int total_seqlen = seqlens_k[batch_index] + 1;
+        const float k_head_scale = k_scale_data[per_head_k_scale ? kv_head_index : 0];
+        const float v_head_scale = v_scale_data[per_head_v_scale ? kv_head_index : 0];
+
+        const T* q = packed_qkv ? Q + packed_batch_stride * batch_index + q_input_chunk_length * head_index
+                                : Q + q_input_chunk_length * i;
+        if (cos_cache_data != nullptr) {
+          const int first_position = is_prompt ? 0 : static_cast<int>(seqlens_k[batch_index]);
+          for (int seq = 0; seq < sequence_length; seq++) {
+            rotary_embedding_helper::RotateToken(q + static_cast<size_t>(seq) * head_size,
+                                                 q_rotary.get() + static_cast<size_t>(seq) * head_size,
+                                                 first_position + seq, cos_cache_data, sin_cache_data, rotary_dim,
+                                                 head_size, rotary_interleaved_);
+          }
+          q = q_rotary.get();
+        }
+
+        const int8_t* present_k = present_key_data + present_buff_chunk_length * (i / kv_num_heads_factor);
+        const int8_t* present_v = present_value_data + present_buff_chunk_length * (i / kv_num_heads_factor);
+        T* output_current = output->MutableData<T>() +
+                            (static_cast<size_t>(batch_index) * sequence_length * num_heads_ + head_index) * head_size;
+
+        if (is_prompt) {
+          DequantizeKVCache(present_k, dequantized.get(), static_cast<size_t>(total_seqlen) * head_size, k_head_scale);
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans,
+                                      sequence_length, total_seqlen, head_size, alpha,
+                                      q, head_size, dequantized.get(), head_size,
+                                      0.0f /*bata*/,
+                                      scores.get(), present_buffer_sequence_length, nullptr);
+          ComputeCausalSoftmax(scores.get(), sequence_length, total_seqlen, present_buffer_sequence_length);
+
+          DequantizeKVCache(present_v, dequantized.get(), static_cast<size_t>(total_seqlen) * head_size, v_head_scale);
+          math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans,
+                                      sequence_length, head_size, total_seqlen,
+                                      1.f, /*alpha*/
+                                      scores.get(), present_buffer_sequence_length,
+                                      dequantized.get(), head_size,
+                                      0.0f /*beta*/,
+                                      output_current, hidden_size, nullptr);
+        } else {
+          // Token generation: dot products of the query with the int8 keys, then the sum of the int8 values
+          // weighted by the attention probs, with the scales applied once per key and once per output.
+          T* probs = scores.get();
+          const float qk_scale = alpha * k_head_scale;
+          for (int t = 0; t < total_seqlen; t++) {
+            const int8_t* key_token = present_k + static_cast<size_t>(t) * head_size;
+            float dot = 0.0f;
+            for (int h = 0; h < head_size; h++) {
+              dot += static_cast<float>(q[h]) * static_cast<float>(key_token[h]);
+            }
+            probs[t] = static_cast<T>(dot * qk_scale);
+          }
+          ComputeCausalSoftmax(probs, 1, total_seqlen, present_buffer_sequence_length);
+
+          std::fill_n(output_current, head_size, static_cast<T>(0.0f));
+          for (int t = 0; t < total_seqlen; t++) {
+            const float p = static_cast<float>(probs[t]);
+            if (p == 0.0f) {
+              continue;
+            }
+            const int8_t* value_token = present_v + static_cast<size_t>(t) * head_size;
+            for (int h = 0; h < head_size; h++) {
+              output_current[h] += static_cast<T>(p * static_cast<float>(value_token[h]));
+            }
+          }
+          for (int h = 0; h < head_size; h++) {
+            output_current[h] = static_cast<T>(static_cast<float>(output_current[h]) * v_head_scale);
+          }
+        }
+      }
+    });
 
     return Status::OK();
   }
 
  private:
+  // Symmetric int8 quantization of a token of the kv cache.
+  template <typename T>
+  static void QuantizeKVCacheToken(const T* input, int8_t* output, int head_size, float inverse_scale) {
+    for (int h = 0; h < head_size; h++) {
+      const float quantized = std::nearbyint(static_cast<float>(input[h]) * inverse_scale);
+      output[h] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, quantized)));
+    }
+  }
+
+  template <typename T>
+  static void DequantizeKVCache(const int8_t* input, T* output, size_t count, float scale) {
+    for (size_t j = 0; j < count; j++) {
+      output[j] = static_cast<T>(static_cast<float>(input[j]) * scale);
+    }
+  }
+
+  // Validates that every block needed by a sequence is mapped to a block inside the pool.
+  Status CheckBlockTable(const int32_t* seqlens_k,
+                         const int32_t* block_table,
+                         int batch_size,
+                         int num_blocks,
+                         int block_size,
+                         int max_blocks_per_sequence) const {
+    for (int b = 0; b < batch_size; b++) {
+      const int total_seqlen = seqlens_k[b] + 1;
+      const int num_used_blocks = (total_seqlen + block_size - 1) / block_size;
+      if (num_used_blocks > max_blocks_per_sequence) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "block_table has ", max_blocks_per_sequence, " blocks per sequence but sequence ", b,
+                               " needs ", num_used_blocks);
+      }
+      const int32_t* blocks = block_table + static_cast<size_t>(b) * max_blocks_per_sequence;
+      for (int j = 0; j < num_used_blocks; j++) {
+        if (blocks[j] < 0 || blocks[j] >= num_blocks) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                                 "block_table[", b, "][", j, "] = ", blocks[j], " is out of range [0, ", num_blocks, ")");
+        }
+      }
+    }
+    return Status::OK();
+  }
+
+  // Writes new key and value of each sequence into its blocks of the paged kv cache.
+  // A block holds block_size tokens of one kv head, so block j of kv head n starts at (j * N_kv + n) x BS x H.
+  template <typename T>
+  void WriteKVCacheBlocks(const T* K,                     // K data with shape BxN_kvxSxH
+                          const T* V,                     // V data with shape BxN_kvxSxH
+                          T* present_key,                 // block pool of key with shape NBxN_kvxBSxH
+                          T* present_value,               // block pool of value with shape NBxN_kvxBSxH
+                          const int32_t* seqlens_k,       // past sequence lengths tensor
+                          const int32_t* block_table,     // block table with shape Bx(max_blocks_per_sequence)
+                          int batch_size,                 // batch size of self-attention
+                          int sequence_length,            // sequence length of self-attention (S)
+                          int head_size,                  // head size of self-attention
+                          int block_size,                 // number of tokens per block (BS)
+                          int max_blocks_per_sequence,    // number of entries in block table per sequence
+                          bool packed_qkv,                // whether Q, K, V are packed
+                          const T* cos_cache,             // cos cache of rotary embedding, nullptr if not rotary
+                          const T* sin_cache,             // sin cache of rotary embedding, nullptr if not rotary
+                          int rotary_dim,                 // rotary embedding dimension
+                          ThreadPool* tp) const {         // thread pool
+    const bool is_prompt = sequence_length != 1;
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;  // S x H
+    const size_t packed_batch_stride =
+        packed_qkv ? (num_heads_ + 2 * kv_num_heads_) * kv_input_chunk_length : 0;
+    const size_t block_chunk_length = static_cast<size_t>(block_size) * head_size;  // BS x H
+    const size_t bytes_to_copy = static_cast<size_t>(head_size) * sizeof(T);
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles = 0;
+    unit_cost.bytes_loaded = static_cast<double>(2 * kv_input_chunk_length * sizeof(T));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i / kv_num_heads_);
+        const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+        const int past_seqlen = is_prompt ? 0 : static_cast<int>(seqlens_k[batch_index]);
+        const int total_seqlen = seqlens_k[batch_index] + 1;
+        const int32_t* blocks = block_table + static_cast<size_t>(batch_index) * max_blocks_per_sequence;
+
+        const size_t input_offset = packed_qkv ? packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index
+                                               : kv_input_chunk_length * i;
+        const T* k = K + input_offset;
+        const T* v = V + input_offset;
+        for (int seq = 0; seq < sequence_length && past_seqlen + seq < total_seqlen; seq++) {
+          const int position = past_seqlen + seq;
+          const size_t output_offset =
+              (static_cast<size_t>(blocks[position / block_size]) * kv_num_heads_ + kv_head_index) * block_chunk_length +
+              static_cast<size_t>(position % block_size) * head_size;
+          if (cos_cache != nullptr) {
+            rotary_embedding_helper::RotateToken(k + static_cast<size_t>(seq) * head_size, present_key + output_offset,
+                                                 position, cos_cache, sin_cache, rotary_dim, head_size,
+                                                 rotary_interleaved_);
+          } else {
+            memcpy(present_key + output_offset, k + static_cast<size_t>(seq) * head_size, bytes_to_copy);
+          }
+          memcpy(present_value + output_offset, v + static_cast<size_t>(seq) * head_size, bytes_to_copy);
+        }
+      }
+    });
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
@@ -96,6 +450,13 @@ class GQAAttentionBase : public AttentionBase {
                              T* present_key,                      // present key only
                              bool past_present_share_buffer,      // whether present key and value share the same buffer
                              bool packed_qkv,                     // whether Q, K, V are packed
+                             const int32_t* block_table,          // block table of paged kv cache, or nullptr
+                             int block_size,                      // number of tokens per block of paged kv cache
+                             int max_blocks_per_sequence,         // number of block table entries per sequence
+                             const T* cos_cache,                  // cos cache of rotary embedding, nullptr if not rotary
+                             const T* sin_cache,                  // sin cache of rotary embedding, nullptr if not rotary
+                             int rotary_dim,                      // rotary embedding dimension
+                             const AllocatorPtr& allocator,       // allocator for the rotated Q of a head
                              ThreadPool* tp) const {              // thread pool
     const bool is_prompt = sequence_length != 1;
     const int packed_batch_stride = packed_qkv ? (num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size : 0;
@@ -104,11 +465,45 @@ class GQAAttentionBase : public AttentionBase {
     const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;                     // L x H
     const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;        // L x H
     const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+    const size_t block_chunk_length = static_cast<size_t>(block_size) * head_size;                            // BS x H
 
-    if (!past_present_share_buffer) {
+    if (!past_present_share_buffer && block_table == nullptr) {
       memset(present_key, 0, batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(T));
     }
 
+    // With rotary embedding, the new key is rotated while it is concatenated to the past key, once per kv head rather
+    // than by each of the query heads sharing it. The paged kv cache is already written with the rotated key.
+    const bool concat_rotary_key = cos_cache != nullptr && block_table == nullptr && present_key != nullptr;
+    if (concat_rotary_key) {
+      ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_,
+                                 static_cast<double>(present_buff_chunk_length * sizeof(T)),
+                                 [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          const int batch_index = static_cast<int>(i / kv_num_heads_);
+          const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+          const int past_seqlen = is_prompt ? 0 : static_cast<int>(seqlens_k[batch_index]);
+
+          const T* k = packed_qkv ? K + packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index
+                                  : K + kv_input_chunk_length * i;
+          T* present = present_key + present_buff_chunk_length * i;
+          if (!is_prompt) {
+            if (!past_present_share_buffer) {
+              memcpy(present, past_key + past_buff_chunk_length * i,
+                     static_cast<size_t>(past_seqlen) * head_size * sizeof(T));
+            }
+            present += static_cast<size_t>(past_seqlen) * head_size;
+          }
+
+          for (int seq = 0; seq < sequence_length; seq++) {
+            rotary_embedding_helper::RotateToken(k + static_cast<size_t>(seq) * head_size,
+                                                 present + static_cast<size_t>(seq) * head_size,
+                                                 past_seqlen + seq, cos_cache, sin_cache, rotary_dim, head_size,
+                                                 rotary_interleaved_);
+          }
+        }
+      });
+    }
+
     const int loop_len = batch_size * num_heads_;
     const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
 
@@ -121,13 +516,20 @@ class GQAAttentionBase : public AttentionBase {
     unit_cost.bytes_loaded += static_cast<double>(probs_matrix_bytes);
     unit_cost.bytes_stored += static_cast<double>(probs_matrix_bytes);
 
-    if (present_key) {
+    if (present_key && block_table == nullptr) {
       double bytes_to_copy_key = static_cast<double>(sizeof(T) * present_buff_chunk_length);
       unit_cost.bytes_loaded += bytes_to_copy_key;
       unit_cost.bytes_stored += bytes_to_copy_key;
     }
 
-    ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    // The cost of a head grows with the sequence length of its batch entry, which differ within a batch.
+    ThreadPool::TryGuidedParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      // Rotated Q of the current head.
+      IAllocatorUniquePtr<T> q_rotary;
+      if (cos_cache != nullptr) {
+        q_rotary = IAllocator::MakeUniquePtr<T>(allocator, q_input_chunk_length);
+      }
+
       for (std::ptrdiff_t i = begin; i != end; ++i) {
         const int batch_index = static_cast<int>(i) / num_heads_;
         const int head_index = static_cast<int>(i) % num_heads_;
@@ -138,18 +540,6 @@ class GQAAttentionBase : public AttentionBase {
         const int output_offset = static_cast<int>(i) * sequence_length * present_buffer_sequence_length;
         T* output = attention_probs + output_offset;
 
-        const T* k;
-        if (packed_qkv) {
-          k = K + packed_batch_stride * batch_index + kv_input_chunk_length * (head_index / kv_num_heads_factor);
-        } else {
-          k = K + kv_input_chunk_length * (i / kv_num_heads_factor);
-        }
-        if (nullptr != present_key) {
-          k = ConcatStateChunkGQA(past_key, k, present_key, present_buff_chunk_length, past_buff_chunk_length,
-                                  past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
-                                  i / kv_num_heads_factor);
-        }
-
         // Compute Q*K' + AttentionMask
         //                     original                 transposed             each iteration
         // A: Q                (B x N x) S x H          (B x N x) S x H        S x H
@@ -161,36 +551,134 @@ class GQAAttentionBase : public AttentionBase {
         } else {
           q = Q + q_input_chunk_length * i;
         }
-        math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans,
-                                    sequence_length, total_seqlen, head_size, alpha,
-                                    q, head_size, k, head_size,
-                                    0.0f /*bata*/,
-                                    output, present_buffer_sequence_length, nullptr);
-
-        // compute Softmax
-        T* output_softmax = output;
-        for (int seq = 0; seq < sequence_length; seq++) {
-          int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
-          if (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1) {
-            for (int total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
-              output_softmax[total_seq_id] = 0.f;
-            }
-            ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1, local_window_size_ + 1, nullptr);
+
+        if (cos_cache != nullptr) {
+          const int first_position = is_prompt ? 0 : static_cast<int>(seqlens_k[batch_index]);
+          for (int seq = 0; seq < sequence_length; seq++) {
+            rotary_embedding_helper::RotateToken(q + static_cast<size_t>(seq) * head_size,
+                                                 q_rotary.get() + static_cast<size_t>(seq) * head_size,
+                                                 first_position + seq, cos_cache, sin_cache, rotary_dim, head_size,
+                                                 rotary_interleaved_);
+          }
+          q = q_rotary.get();
+        }
+
+        // Key of paged kv cache is contiguous only within a block, so it is multiplied block by block.
+        const T* k = nullptr;
+        const int32_t* blocks = nullptr;
+        const int kv_head_index = head_index / kv_num_heads_factor;
+        if (block_table != nullptr) {
+          blocks = block_table + static_cast<size_t>(batch_index) * max_blocks_per_sequence;
+        } else {
+          if (packed_qkv) {
+            k = K + packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
           } else {
-            ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
+            k = K + kv_input_chunk_length * (i / kv_num_heads_factor);
+          }
+          if (concat_rotary_key) {
+            k = present_key + present_buff_chunk_length * (i / kv_num_heads_factor);
+          } else if (nullptr != present_key) {
+            k = ConcatStateChunkGQA(past_key, k, present_key, present_buff_chunk_length, past_buff_chunk_length,
+                                    past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
+                                    i / kv_num_heads_factor);
           }
+        }
 
-          // set causal [seq_causal_length, total_seqlen) to 0.f
-          for (int total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
-            output_softmax[total_seq_id] = 0.f;
+        const int row_block_size = GetRowBlockSize(sequence_length);
+        for (int row_begin = 0; row_begin < sequence_length; row_begin += row_block_size) {
+          const int row_end = std::min(row_begin + row_block_size, sequence_length);
+          int key_begin;
+          int key_end;
+          GetAttendedKeys(row_begin, row_end, sequence_length, total_seqlen, key_begin, key_end);
+          const T* q_rows = q + static_cast<size_t>(row_begin) * head_size;
+          T* output_rows = output + static_cast<size_t>(row_begin) * present_buffer_sequence_length;
+
+          if (blocks != nullptr) {
+            for (int block_start = key_begin / block_size * block_size; block_start < key_end;
+                 block_start += block_size) {
+              const int first_key = std::max(block_start, key_begin);
+              const T* block_k = present_key +
+                                 (static_cast<size_t>(blocks[block_start / block_size]) * kv_num_heads_ +
+                                  kv_head_index) *
+                                     block_chunk_length +
+                                 static_cast<size_t>(first_key - block_start) * head_size;
+              math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans,
+                                          row_end - row_begin, std::min(block_start + block_size, key_end) - first_key,
+                                          head_size, alpha, q_rows, head_size, block_k, head_size,
+                                          0.0f /*bata*/,
+                                          output_rows + first_key, present_buffer_sequence_length, nullptr);
+            }
+          } else {
+            math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans,
+                                        row_end - row_begin, key_end - key_begin, head_size, alpha,
+                                        q_rows, head_size, k + static_cast<size_t>(key_begin) * head_size, head_size,
+                                        0.0f /*bata*/,
+                                        output_rows + key_begin, present_buffer_sequence_length, nullptr);
           }
 
-          output_softmax += present_buffer_sequence_length;
+          ComputeCausalSoftmax(output, row_begin, row_end, sequence_length, total_seqlen,
+                               present_buffer_sequence_length, key_begin, key_end);
         }
       }
     });
   }
 
+  // Number of query rows of a prompt computed together over the keys they attend to. With a local window the rows are
+  // split in blocks, so that the scores are computed only near the band of the window instead of for all the keys.
+  int GetRowBlockSize(int sequence_length) const {
+    constexpr int kLocalWindowRowBlockSize = 64;
+    return local_window_size_ > 0 ? std::min(sequence_length, kLocalWindowRowBlockSize) : sequence_length;
+  }
+
+  // The keys [key_begin, key_end) attended by the query rows [row_begin, row_end): all the keys, or the keys of the
+  // local windows of the rows when there is one. The range is never empty.
+  void GetAttendedKeys(int row_begin, int row_end, int sequence_length, int total_seqlen,
+                       int& key_begin, int& key_end) const {
+    key_begin = 0;
+    key_end = total_seqlen;
+    if (local_window_size_ > 0) {
+      const bool is_prompt = sequence_length != 1;
+      if (is_prompt) {
+        key_end = std::min(row_end, total_seqlen);
+      }
+      // rows of the padding of a prompt past total_seqlen attend to the last key
+      key_begin = std::min(std::max(0, (is_prompt ? row_begin + 1 : total_seqlen) - local_window_size_ - 1),
+                           key_end - 1);
+    }
+  }
+
+  // Causal softmax of the attention scores of S queries over total_seqlen keys, in rows of row_length elements.
+  // The scores outside of the causal or local window are set to 0.
+  template <typename T>
+  void ComputeCausalSoftmax(T* scores, int sequence_length, int total_seqlen, int row_length) const {
+    ComputeCausalSoftmax(scores, 0, sequence_length, sequence_length, total_seqlen, row_length, 0, total_seqlen);
+  }
+
+  // Causal softmax of the rows [row_begin, row_end) of the scores, which are only computed for the keys
+  // [key_begin, key_end). The scores of these keys outside of the causal or local window are set to 0.
+  template <typename T>
+  void ComputeCausalSoftmax(T* scores, int row_begin, int row_end, int sequence_length, int total_seqlen,
+                            int row_length, int key_begin, int key_end) const {
+    for (int seq = row_begin; seq < row_end; seq++) {
+      T* output_softmax = scores + static_cast<size_t>(seq) * row_length;
+      const int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
+      int window_begin = 0;
+      if (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1) {
+        window_begin = seq_causal_length - local_window_size_ - 1;
+      }
+
+      for (int total_seq_id = key_begin; total_seq_id < window_begin; total_seq_id++) {
+        output_softmax[total_seq_id] = 0.f;
+      }
+      ComputeAttentionSoftmaxInplace(output_softmax + window_begin, 1, seq_causal_length - window_begin, nullptr);
+
+      // set causal [seq_causal_length, key_end) to 0.f
+      for (int total_seq_id = std::max(key_begin, seq_causal_length); total_seq_id < key_end; total_seq_id++) {
+        output_softmax[total_seq_id] = 0.f;
+      }
+    }
+  }
+
   template <typename T>
   void ComputeVxAttentionScore(T* output,                           // buffer for the result with size BxSxNxH
                                const T* attention_probs,            // Attention probs with size BxNxSxT
@@ -206,6 +694,9 @@ class GQAAttentionBase : public AttentionBase {
                                T* present_value,                    // present value only
                                bool past_present_share_buffer,      // whether present key and value share the same buffer
                                bool packed_qkv,                     // whether Q, K, V are packed
+                               const int32_t* block_table,          // block table of paged kv cache, or nullptr
+                               int block_size,                      // number of tokens per block of paged kv cache
+                               int max_blocks_per_sequence,         // number of block table entries per sequence
                                ThreadPool* tp) const {
     const bool is_prompt = sequence_length != 1;
     const int packed_batch_stride = packed_qkv ? (num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size : 0;
@@ -213,8 +704,9 @@ class GQAAttentionBase : public AttentionBase {
     const int kv_input_chunk_length = sequence_length * head_size;                                             // L x H
     const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;        // L x H
     const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+    const size_t block_chunk_length = static_cast<size_t>(block_size) * head_size;                            // BS x H
 
-    if (!past_present_share_buffer) {
+    if (!past_present_share_buffer && block_table == nullptr) {
       memset(present_value, 0, batch_size * kv_num_heads_ * present_buffer_sequence_length * head_size * sizeof(T));
     }
 
@@ -224,7 +716,7 @@ class GQAAttentionBase : public AttentionBase {
     unit_cost.bytes_loaded = static_cast<double>((sequence_length + head_size) * present_buffer_sequence_length * sizeof(T));
     unit_cost.bytes_stored = static_cast<double>(sequence_length * head_size * sizeof(T));
 
-    if (present_value) {
+    if (present_value && block_table == nullptr) {
       double bytes_to_copy_value = static_cast<double>(present_buff_chunk_length * sizeof(T));
       unit_cost.bytes_loaded += bytes_to_copy_value;
       unit_cost.bytes_stored += bytes_to_copy_value;
@@ -235,7 +727,7 @@ class GQAAttentionBase : public AttentionBase {
     unit_cost.bytes_loaded += bytes_to_copy_trans_all;
     unit_cost.bytes_stored += bytes_to_copy_trans_all;
 
-    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    ThreadPool::TryGuidedParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
       for (std::ptrdiff_t i = begin; i != end; ++i) {
         const int batch_index = static_cast<int>(i / num_heads_);
         const int head_index = static_cast<int>(i % num_heads_);
@@ -243,29 +735,69 @@ class GQAAttentionBase : public AttentionBase {
         const size_t past_chunk_length = static_cast<size_t>(past_seqlen) * head_size;
         const int total_seqlen = seqlens_k[batch_index] + 1;
 
-        const T* v;
-        if (packed_qkv) {
-          v = V + packed_batch_stride * batch_index + kv_input_chunk_length * (head_index / kv_num_heads_factor);
-        } else {
-          v = V + kv_input_chunk_length * (i / kv_num_heads_factor);
-        }
-        if (nullptr != present_value) {
-          v = ConcatStateChunkGQA(past_value, v, present_value, present_buff_chunk_length, past_buff_chunk_length,
-                                  past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
-                                  i / kv_num_heads_factor);
-        }
-
         T* output_current = output + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
         ptrdiff_t attention_probs_offset = SafeInt<ptrdiff_t>(sequence_length) * present_buffer_sequence_length * i;
 
-        math::GemmEx<T, ThreadPool>(CblasNoTrans,
-                                    CblasNoTrans,
-                                    sequence_length, head_size, total_seqlen,
-                                    1.f, /*alpha*/
-                                    attention_probs + attention_probs_offset, present_buffer_sequence_length,
-                                    v, head_size,
-                                    0.0f /*beta*/,
-                                    output_current, hidden_size, nullptr);
+        const T* v = nullptr;
+        const int32_t* blocks = nullptr;
+        const int kv_head_index = head_index / kv_num_heads_factor;
+        if (block_table != nullptr) {
+          blocks = block_table + static_cast<size_t>(batch_index) * max_blocks_per_sequence;
+        } else {
+          if (packed_qkv) {
+            v = V + packed_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
+          } else {
+            v = V + kv_input_chunk_length * (i / kv_num_heads_factor);
+          }
+          if (nullptr != present_value) {
+            v = ConcatStateChunkGQA(past_value, v, present_value, present_buff_chunk_length, past_buff_chunk_length,
+                                    past_chunk_length, kv_input_chunk_length, is_prompt, past_present_share_buffer,
+                                    i / kv_num_heads_factor);
+          }
+        }
+
+        // Only the keys attended by a block of rows have probs set, see ComputeAttentionProbs().
+        const int row_block_size = GetRowBlockSize(sequence_length);
+        for (int row_begin = 0; row_begin < sequence_length; row_begin += row_block_size) {
+          const int row_end = std::min(row_begin + row_block_size, sequence_length);
+          int key_begin;
+          int key_end;
+          GetAttendedKeys(row_begin, row_end, sequence_length, total_seqlen, key_begin, key_end);
+          const T* probs_rows = attention_probs + attention_probs_offset +
+                                static_cast<size_t>(row_begin) * present_buffer_sequence_length;
+          T* output_rows = output_current + static_cast<size_t>(row_begin) * hidden_size;
+
+          if (blocks != nullptr) {
+            // Accumulate the product of each block of attention probs with the value block it refers to.
+            for (int block_start = key_begin / block_size * block_size; block_start < key_end;
+                 block_start += block_size) {
+              const int first_key = std::max(block_start, key_begin);
+              const T* block_v = present_value +
+                                 (static_cast<size_t>(blocks[block_start / block_size]) * kv_num_heads_ +
+                                  kv_head_index) *
+                                     block_chunk_length +
+                                 static_cast<size_t>(first_key - block_start) * head_size;
+              math::GemmEx<T, ThreadPool>(CblasNoTrans,
+                                          CblasNoTrans,
+                                          row_end - row_begin, head_size,
+                                          std::min(block_start + block_size, key_end) - first_key,
+                                          1.f, /*alpha*/
+                                          probs_rows + first_key, present_buffer_sequence_length,
+                                          block_v, head_size,
+                                          first_key == key_begin ? 0.0f : 1.0f /*beta*/,
+                                          output_rows, hidden_size, nullptr);
+            }
+          } else {
+            math::GemmEx<T, ThreadPool>(CblasNoTrans,
+                                        CblasNoTrans,
+                                        row_end - row_begin, head_size, key_end - key_begin,
+                                        1.f, /*alpha*/
+                                        probs_rows + key_begin, present_buffer_sequence_length,
+                                        v + static_cast<size_t>(key_begin) * head_size, head_size,
+                                        0.0f /*beta*/,
+                                        output_rows, hidden_size, nullptr);
+          }
+        }
       }
     });
   }
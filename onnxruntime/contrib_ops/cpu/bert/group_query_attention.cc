@@ -4,8 +4,6 @@
 #include "group_query_attention.h"
 #include "group_query_attention_helper.h"
 #include "attention_utils.h"
-#include "rotary_embedding.h"
-#include "rotary_embedding_helper.h"
 
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/onnx_protobuf.h"
@@ -29,6 +27,8 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
     kCpuExecutionProvider,
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T_CACHE", {DataTypeImpl::GetTensorType<float>(), DataTypeImpl::GetTensorType<int8_t>()})
+        .TypeConstraint("T_KV_SCALE", DataTypeImpl::GetTensorType<float>())
         .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
     GroupQueryAttention<float>);
 
@@ -58,6 +58,9 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* total_seqlen = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* block_table = context->Input<Tensor>(9);
+  const Tensor* k_scale = context->Input<Tensor>(10);
+  const Tensor* v_scale = context->Input<Tensor>(11);
 
   GroupQueryAttentionParameters parameters = {};
   constexpr float scale = 1.0f;
@@ -68,12 +71,17 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
                                                                 past_value,
                                                                 cos_cache,
                                                                 sin_cache,
+                                                                block_table,
                                                                 &parameters,
                                                                 num_heads_,
                                                                 kv_num_heads_,
                                                                 seqlens_k,
                                                                 total_seqlen,
                                                                 scale));
+  ORT_RETURN_IF(do_rotary_ && cos_cache == nullptr, "cos_cache and sin_cache are required when do_rotary is 1.");
+  ORT_RETURN_IF_ERROR(group_query_attention_helper::CheckKVCacheScales(past_key, past_value, k_scale, v_scale,
+                                                                       kv_num_heads_));
+  const bool quantized_kv_cache = past_key != nullptr && past_key->IsDataType<int8_t>();
 
   const int batch_size = parameters.batch_size;
   const int sequence_length = parameters.sequence_length;
@@ -88,15 +96,22 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   output_shape[2] = static_cast<int64_t>(q_hidden_size);
   Tensor* output = context->Output(0, output_shape);
 
-  std::vector<int64_t> present_k_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
-  std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
-  Tensor* present_k = context->Output(1, present_k_shape);
-  Tensor* present_v = context->Output(2, present_v_shape);
+  Tensor* present_k = nullptr;
+  Tensor* present_v = nullptr;
+  if (parameters.paged_kv_cache) {
+    // Present key/value are the whole block pool.
+    present_k = context->Output(1, past_key->Shape());
+    present_v = context->Output(2, past_value->Shape());
+  } else {
+    std::vector<int64_t> present_k_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
+    std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
+    present_k = context->Output(1, present_k_shape);
+    present_v = context->Output(2, present_v_shape);
+  }
 
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
 
-  auto element_type = DataTypeImpl::GetType<T>();
   OrtValue Q;
   OrtValue K;
   OrtValue V;
@@ -112,77 +127,17 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
         allocator, batch_size, kv_num_heads_, sequence_length, head_size, value, V));
   }
 
-  if (do_rotary_) {
-    rotary_embedding_helper::RotaryParameters rotary_params = {};
-    rotary_params.batch_size = batch_size;
-    rotary_params.sequence_length = sequence_length;
-    rotary_params.hidden_size = q_hidden_size;
-    rotary_params.head_size = head_size;
-    rotary_params.rotary_embedding_dim = parameters.rotary_dim;
-    rotary_params.num_heads = num_heads_;
-    rotary_params.max_sequence_length = sequence_length;  // unused
-    rotary_params.seq_stride = head_size;
-    rotary_params.head_stride = sequence_length * rotary_params.seq_stride;
-    rotary_params.batch_stride = (packed_qkv ? (num_heads_ + 2 * kv_num_heads_) : num_heads_) * rotary_params.head_stride;
-    rotary_params.position_ids_format = sequence_length == 1 ? 1 : 0;
-    rotary_params.transposed = true;
-    auto* tp = context->GetOperatorThreadPool();
-    std::vector<int64_t> pos_ids(sequence_length == 1 ? batch_size : 1);
-    if (sequence_length == 1) {
-      for (int b = 0; b < batch_size; b++) {
-        pos_ids[b] = static_cast<int64_t>(seqlens_k->Data<int32_t>()[b]);
-      }
-    } else {
-      pos_ids[0] = static_cast<int64_t>(0);
-    }
-    const T* q_input;
-    const T* k_input;
-    T* q_rotary;
-    T* k_rotary;
-    if (packed_qkv) {
-      OrtValue RotaryQKV;
-      Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_heads_ + 2 * kv_num_heads_, sequence_length, head_size}), allocator, RotaryQKV);
-      q_input = Q.Get<Tensor>().Data<T>();
-      k_input = q_input + num_heads_ * sequence_length * head_size;
-      q_rotary = RotaryQKV.GetMutable<Tensor>()->MutableData<T>();
-      k_rotary = q_rotary + num_heads_ * sequence_length * head_size;
-      Q = RotaryQKV;
-    } else {
-      OrtValue RotaryQ;
-      Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_heads_, sequence_length, head_size}), allocator, RotaryQ);
-      OrtValue RotaryK;
-      Tensor::InitOrtValue(element_type, TensorShape({batch_size, kv_num_heads_, sequence_length, head_size}), allocator, RotaryK);
-      q_input = Q.Get<Tensor>().Data<T>();
-      k_input = K.Get<Tensor>().Data<T>();
-      q_rotary = RotaryQ.GetMutable<Tensor>()->MutableData<T>();
-      k_rotary = RotaryK.GetMutable<Tensor>()->MutableData<T>();
-      Q = RotaryQ;
-      K = RotaryK;
-    }
-    ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, q_input,
-                                              pos_ids.data(), cos_cache->Data<T>(),
-                                              sin_cache->Data<T>(), q_rotary, rotary_interleaved_));
-
-    rotary_params.num_heads = kv_num_heads_;
-    rotary_params.hidden_size = parameters.kv_hidden_size;
-    if (!packed_qkv) {
-      rotary_params.batch_stride = kv_num_heads_ * rotary_params.head_stride;
-    }
-    ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, k_input,
-                                              pos_ids.data(), cos_cache->Data<T>(),
-                                              sin_cache->Data<T>(), k_rotary, rotary_interleaved_));
-    if (packed_qkv) {
-      const T* v_input = k_input + kv_num_heads_ * sequence_length * head_size;
-      T* v_rotary = k_rotary + kv_num_heads_ * sequence_length * head_size;
-      ORT_RETURN_IF_ERROR(group_query_attention_helper::PackVIntoRotaryQKV<T>(tp, parameters, v_input, v_rotary));
-    }
+  if (quantized_kv_cache) {
+    return ApplyQuantizedKVCacheAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
+                                          packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value,
+                                          output, present_k, present_v, seqlens_k, cos_cache, sin_cache,
+                                          k_scale, v_scale, parameters, allocator, context);
   }
 
-  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
-  // Compute the attention score and apply the score to V
+  // Compute the attention score and apply the score to V. The rotary embedding is applied to Q and K on the fly.
   return ApplyAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
                         packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, output, present_k, present_v,
-                        seqlens_k, parameters, allocator, context);
+                        seqlens_k, block_table, cos_cache, sin_cache, parameters, allocator, context);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -18,6 +18,7 @@ Status CheckInputs(const Tensor* query,
                    const Tensor* past_value,
                    const Tensor* cos_cache,
                    const Tensor* sin_cache,
+                   const Tensor* block_table,
                    void* parameters,
                    int num_heads,
                    int kv_num_heads,
@@ -27,6 +28,10 @@ Status CheckInputs(const Tensor* query,
   // Note: Here S* is seqlen_past_kv_cache, S+ is seqlen_present_kv_cache
   //     past_key                   : (B, N_k, S*, H) or (B, N_k, S+, H) or nullptr
   //     past_value                 : (B, N_k, S*, H) or (B, N_k, S+, H) or nullptr
+  // paged kv cache, where NB is number of blocks in the pool and BS is block size:
+  //     past_key                   : (NB, N_k, BS, H)
+  //     past_value                 : (NB, N_k, BS, H)
+  //     block_table                : (B, max_blocks_per_sequence)
   // no packing for q/k/v:
   //     query            (Q)       : (B, S, D) or (B, S, (D_q + 2 D_kv))
   //     key              (K)       : (B, S, D_kv) or nullptr
@@ -124,15 +129,24 @@ Status CheckInputs(const Tensor* query,
                              past_value_dims.size());
     }
 
-    if (past_key_dims[0] != batch_size) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                             "Input 'past_key' dimension 0 should be batch_size, got ",
-                             past_key_dims[0]);
-    }
-    if (past_value_dims[0] != batch_size) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                             "Input 'past_value' dimension 0 should be batch_size, got ",
-                             past_value_dims[0]);
+    if (block_table != nullptr) {
+      if (past_key_dims[0] != past_value_dims[0]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_key' and 'past_value' shall have same dimension 0 (number of blocks) "
+                               "for paged kv cache, got ",
+                               past_key_dims[0], " and ", past_value_dims[0]);
+      }
+    } else {
+      if (past_key_dims[0] != batch_size) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_key' dimension 0 should be batch_size, got ",
+                               past_key_dims[0]);
+      }
+      if (past_value_dims[0] != batch_size) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_value' dimension 0 should be batch_size, got ",
+                               past_value_dims[0]);
+      }
     }
 
     if (past_key_dims[2] != past_value_dims[2]) {
@@ -182,6 +196,32 @@ Status CheckInputs(const Tensor* query,
   int total_sequence_length = *((*total_seqlen).template Data<int32_t>());
   int present_sequence_length = std::max(total_sequence_length, past_sequence_length);
 
+  // Check block table of paged kv cache
+  int kv_cache_block_size = 0;
+  int max_blocks_per_sequence = 0;
+  if (block_table != nullptr) {
+    if (past_key == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' and 'past_value' are required when 'block_table' is given.");
+    }
+    const auto& block_table_dims = block_table->Shape().GetDims();
+    if (block_table_dims.size() != 2 || block_table_dims[0] != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "block_table must be shape (batch_size, max_blocks_per_sequence).");
+    }
+    kv_cache_block_size = past_sequence_length;
+    max_blocks_per_sequence = static_cast<int>(block_table_dims[1]);
+    if (kv_cache_block_size <= 0 ||
+        static_cast<int64_t>(kv_cache_block_size) * max_blocks_per_sequence < total_sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "block_table with ", max_blocks_per_sequence, " blocks of size ", kv_cache_block_size,
+                             " cannot hold total_sequence_length of ", total_sequence_length);
+    }
+    // Past kv tensors are not indexed by sequence, so only the total sequence length is meaningful.
+    past_sequence_length = 0;
+    present_sequence_length = total_sequence_length;
+  }
+
   int rotary_dim = 0;
   if (cos_cache != nullptr && sin_cache != nullptr) {
     const auto& cos_dims = cos_cache->Shape().GetDims();
@@ -235,6 +275,9 @@ Status CheckInputs(const Tensor* query,
     output_parameters->is_packed_qkv = is_packed_qkv;
     output_parameters->is_unidirectional = true;
     output_parameters->is_prompt = is_prompt;
+    output_parameters->paged_kv_cache = block_table != nullptr;
+    output_parameters->kv_cache_block_size = kv_cache_block_size;
+    output_parameters->max_blocks_per_sequence = max_blocks_per_sequence;
     output_parameters->scale = scale;
     output_parameters->qkv_format = qkv_format;
     output_parameters->past_kv_format = past_kv_format;
@@ -250,6 +293,7 @@ Status CheckInputs(const Tensor* query,
                    const Tensor* past_value,
                    const Tensor* cos_cache,
                    const Tensor* sin_cache,
+                   const Tensor* block_table,
                    void* parameters,
                    int num_heads,
                    int kv_num_heads,
@@ -261,36 +305,48 @@ Status CheckInputs(const Tensor* query,
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "num_heads should be no larger than ", max_threads_per_block);
   }
 
-  return CheckInputs(query, key, value, past_key, past_value, cos_cache, sin_cache, parameters, num_heads, kv_num_heads, seqlens_k, total_seqlen, scale);
+  return CheckInputs(query, key, value, past_key, past_value, cos_cache, sin_cache, block_table, parameters, num_heads, kv_num_heads, seqlens_k, total_seqlen, scale);
 }
 
-template <typename T>
-Status PackVIntoRotaryQKV(concurrency::ThreadPool* tp, GroupQueryAttentionParameters parameters, const T* input,
-                          T* output) {
-  const int batch_size = parameters.batch_size;
-  const int sequence_length = parameters.sequence_length;
-  int n_heads = parameters.num_heads;
-  const int kv_n_heads = parameters.kv_num_heads;
-  const int head_size = parameters.head_size;
-  int seq_stride = head_size;
-  int head_stride = sequence_length * seq_stride;
-  int batch_stride = (n_heads + 2 * kv_n_heads) * head_stride;
+// Checks the scales of the kv cache. An int8 kv cache requires k_scale and v_scale, each with shape (1) for a scale
+// shared by all kv heads, or (kv_num_heads) for a scale per kv head. A float kv cache does not use them.
+Status CheckKVCacheScales(const Tensor* past_key,
+                          const Tensor* past_value,
+                          const Tensor* k_scale,
+                          const Tensor* v_scale,
+                          int kv_num_heads) {
+  const bool quantized_kv_cache = past_key != nullptr && past_key->IsDataType<int8_t>();
+  if (!quantized_kv_cache) {
+    if (k_scale != nullptr || v_scale != nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'k_scale' and 'v_scale' are only used with an int8 past_key and past_value.");
+    }
+    return Status::OK();
+  }
 
-  const int loop_len = batch_size * sequence_length * kv_n_heads;
-  const double cost = static_cast<double>(head_size);
-  ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
-    for (std::ptrdiff_t ptr = begin; ptr != end; ++ptr) {
-      const int b = static_cast<int>((ptr / kv_n_heads) / sequence_length);
-      const int s = static_cast<int>((ptr / kv_n_heads) % sequence_length);
-      const int n = static_cast<int>(ptr % kv_n_heads);
-      const int block_offset = b * batch_stride + s * seq_stride + n * head_stride;
-      const T* input_data = input + block_offset;
-      T* output_data = output + block_offset;
-      for (int i = 0; i < head_size; i++) {
-        output_data[i] = input_data[i];
+  if (past_value == nullptr || !past_value->IsDataType<int8_t>()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'past_key' and 'past_value' shall both be int8 for an int8 kv cache.");
+  }
+  if (k_scale == nullptr || v_scale == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 'k_scale' and 'v_scale' are required for an int8 kv cache.");
+  }
+  for (const Tensor* kv_scale : {k_scale, v_scale}) {
+    const auto& scale_dims = kv_scale->Shape().GetDims();
+    if (scale_dims.size() != 1 || (scale_dims[0] != 1 && scale_dims[0] != kv_num_heads)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'k_scale' and 'v_scale' shall have shape (1) or (kv_num_heads). Got ",
+                             kv_scale->Shape());
+    }
+    const float* scale_data = kv_scale->Data<float>();
+    for (int64_t i = 0; i < scale_dims[0]; i++) {
+      if (!(scale_data[i] > 0.0f)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'k_scale' and 'v_scale' shall be positive. Got ", scale_data[i]);
       }
     }
-  });
+  }
   return Status::OK();
 }
 
@@ -156,6 +156,37 @@ Status CheckInputs(const T* input,
   return Status::OK();
 }
 
+// Applies the rotary embedding to the head_size elements of one token of one head. position_id selects the row of
+// the cos and sin caches, of shape (max_sequence_length, rotary_emb_dim / 2). The elements after the first
+// rotary_emb_dim are copied. input and output must not overlap.
+template <typename T>
+void RotateToken(const T* input, T* output, int position_id, const T* cos_cache, const T* sin_cache,
+                 int rotary_emb_dim, int head_size, bool interleaved) {
+  const int half_rotary_emb_dim = rotary_emb_dim / 2;
+  const int cache_offset = position_id * half_rotary_emb_dim;
+  const T* cos_data = cos_cache + cache_offset;
+  const T* sin_data = sin_cache + cache_offset;
+
+  int cache_idx = 0;
+  T sign = 0;
+  int j = 0;
+  for (int i = 0; i < rotary_emb_dim; i++) {
+    if (interleaved) {
+      cache_idx = (i / 2) % half_rotary_emb_dim;
+      sign = (i % 2 == 0) ? static_cast<T>(-1) : static_cast<T>(1);
+      j = (i % 2 == 0) ? i + 1 : i - 1;  // i - sign
+    } else {
+      cache_idx = i % half_rotary_emb_dim;
+      sign = (i < half_rotary_emb_dim) ? static_cast<T>(-1) : static_cast<T>(1);
+      j = (i + half_rotary_emb_dim) % rotary_emb_dim;
+    }
+    output[i] = input[i] * cos_data[cache_idx] + sign * input[j] * sin_data[cache_idx];
+  }
+  for (int i = rotary_emb_dim; i < head_size; i++) {
+    output[i] = input[i];
+  }
+}
+
 }  // namespace rotary_embedding_helper
 }  // namespace contrib
 }  // namespace onnxruntime
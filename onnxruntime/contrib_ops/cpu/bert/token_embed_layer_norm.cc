@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/**
+ * @brief Token embedding lookup, scaling, optional position embedding and LayerNormalization or RMSNorm.
+ *
+ * Replaces Gather -> [Mul] -> LayerNormalization/SimplifiedLayerNormalization at the input of decoder-only models
+ * (see TokenEmbedLayerNormFusion), normalizing each row while it is in cache. The table can be quantized to 4 bits in
+ * the MatMulNBits layout, in which case only the rows looked up are dequantized.
+ */
+class TokenEmbedLayerNorm final : public OpKernel {
+ public:
+  explicit TokenEmbedLayerNorm(const OpKernelInfo& info) : OpKernel(info) {
+    epsilon_ = info.GetAttrOrDefault<float>("epsilon", 1e-5f);
+    scale_ = info.GetAttrOrDefault<float>("scale", 1.0f);
+    simplified_ = info.GetAttrOrDefault<int64_t>("simplified", 0) != 0;
+    block_size_ = info.GetAttrOrDefault<int64_t>("block_size", 0);
+    ORT_ENFORCE(epsilon_ >= 0);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tid>
+  Status ComputeImpl(OpKernelContext* context, const Tensor& input_ids, const Tensor& embedding, int64_t hidden_size,
+                     const Tensor* position_ids, const Tensor* position_embedding) const;
+
+  float epsilon_;
+  float scale_;
+  bool simplified_;
+  int64_t block_size_;
+};
+
+namespace {
+
+template <typename Tid>
+Status CheckIds(const Tensor& ids, int64_t num_rows, const char* name) {
+  const Tid* data = ids.Data<Tid>();
+  for (int64_t i = 0, end = ids.Shape().Size(); i < end; ++i) {
+    if (data[i] < 0 || static_cast<int64_t>(data[i]) >= num_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, name, " element out of range, id=",
+                             static_cast<int64_t>(data[i]), " must be within the range [0, ", num_rows - 1, "]");
+    }
+  }
+  return Status::OK();
+}
+
+// Dequantizes a row of a 4-bit table in the layout of the weight of MatMulNBits, times scale.
+void DequantizeRow(const uint8_t* row, const float* row_scales, const uint8_t* row_zero_points, int64_t block_size,
+                   int64_t hidden_size, float scale, float* output) {
+  const int64_t num_blocks = (hidden_size + block_size - 1) / block_size;
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    const uint8_t* block = row + b * (block_size / 2);
+    const int zero_point = row_zero_points == nullptr ? 8 : (row_zero_points[b / 2] >> ((b & 1) * 4)) & 0xF;
+    const float block_scale = row_scales[b] * scale;
+    const int64_t block_end = std::min(block_size, hidden_size - b * block_size);
+    float* block_output = output + b * block_size;
+    for (int64_t k = 0; k < block_end; ++k) {
+      const int value = (k & 1) ? block[k / 2] >> 4 : block[k / 2] & 0xF;
+      block_output[k] = static_cast<float>(value - zero_point) * block_scale;
+    }
+  }
+}
+
+}  // namespace
+
+template <typename Tid>
+Status TokenEmbedLayerNorm::ComputeImpl(OpKernelContext* context, const Tensor& input_ids, const Tensor& embedding,
+                                        int64_t hidden_size, const Tensor* position_ids,
+                                        const Tensor* position_embedding) const {
+  const int64_t vocab_size = embedding.Shape()[0];
+  ORT_RETURN_IF_ERROR(CheckIds<Tid>(input_ids, vocab_size, "input_ids"));
+  if (position_ids != nullptr) {
+    ORT_RETURN_IF_ERROR(CheckIds<Tid>(*position_ids, position_embedding->Shape()[0], "position_ids"));
+  }
+
+  const Tensor* gamma = context->Input<Tensor>(2);
+  const Tensor* beta = simplified_ ? nullptr : context->Input<Tensor>(3);
+  const Tensor* scales = context->Input<Tensor>(4);
+  const Tensor* zero_points = context->Input<Tensor>(5);
+
+  TensorShapeVector output_dims = input_ids.Shape().AsShapeVector();
+  output_dims.push_back(hidden_size);
+  Tensor* output = context->Output(0, output_dims);
+  Tensor* embedding_sum = context->Output(1, output_dims);
+
+  const bool quantized = embedding.IsDataType<uint8_t>();
+  const int64_t num_blocks = quantized ? (hidden_size + block_size_ - 1) / block_size_ : 0;
+  const int64_t row_bytes = quantized ? num_blocks * (block_size_ / 2) : 0;
+  const int64_t zero_point_bytes = (num_blocks + 1) / 2;
+
+  const Tid* input_ids_data = input_ids.Data<Tid>();
+  const Tid* position_ids_data = position_ids != nullptr ? position_ids->Data<Tid>() : nullptr;
+  const float* position_embedding_data = position_embedding != nullptr ? position_embedding->Data<float>() : nullptr;
+  const float* float_table = quantized ? nullptr : embedding.Data<float>();
+  const uint8_t* quantized_table = quantized ? embedding.Data<uint8_t>() : nullptr;
+  const float* scales_data = quantized ? scales->Data<float>() : nullptr;
+  const uint8_t* zero_points_data = quantized && zero_points != nullptr ? zero_points->Data<uint8_t>() : nullptr;
+  const float* gamma_data = gamma->Data<float>();
+  const float* beta_data = beta != nullptr ? beta->Data<float>() : nullptr;
+  float* output_data = output->MutableData<float>();
+  float* embedding_sum_data = embedding_sum != nullptr ? embedding_sum->MutableData<float>() : nullptr;
+
+  const float scale = scale_;
+  const float epsilon = epsilon_;
+  const bool simplified = simplified_;
+  const int64_t block_size = block_size_;
+  const double row_cost = static_cast<double>(hidden_size);
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), narrow<std::ptrdiff_t>(input_ids.Shape().Size()),
+      TensorOpCost{row_cost * (quantized ? 1.0 : sizeof(float)),
+                   row_cost * sizeof(float) * (embedding_sum != nullptr ? 2 : 1), row_cost * 6},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t token = first; token < last; ++token) {
+          const int64_t id = static_cast<int64_t>(input_ids_data[token]);
+          float* y = output_data + token * hidden_size;
+          float* sum = embedding_sum_data != nullptr ? embedding_sum_data + token * hidden_size : y;
+
+          if (quantized) {
+            DequantizeRow(quantized_table + id * row_bytes, scales_data + id * num_blocks,
+                          zero_points_data != nullptr ? zero_points_data + id * zero_point_bytes : nullptr,
+                          block_size, hidden_size, scale, sum);
+          } else {
+            const float* row = float_table + id * hidden_size;
+            for (int64_t h = 0; h < hidden_size; ++h) {
+              sum[h] = row[h] * scale;
+            }
+          }
+          if (position_ids_data != nullptr) {
+            const float* position_row =
+                position_embedding_data + static_cast<int64_t>(position_ids_data[token]) * hidden_size;
+            for (int64_t h = 0; h < hidden_size; ++h) {
+              sum[h] += position_row[h];
+            }
+          }
+
+          float mean = 0.0f;
+          float mean_square = 0.0f;
+          for (int64_t h = 0; h < hidden_size; ++h) {
+            mean += sum[h];
+            mean_square += sum[h] * sum[h];
+          }
+          mean = simplified ? 0.0f : mean / hidden_size;
+          const float inv_std_dev = 1.0f / std::sqrt(mean_square / hidden_size - mean * mean + epsilon);
+          for (int64_t h = 0; h < hidden_size; ++h) {
+            y[h] = (sum[h] - mean) * inv_std_dev * gamma_data[h] + (beta_data != nullptr ? beta_data[h] : 0.0f);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+Status TokenEmbedLayerNorm::Compute(OpKernelContext* context) const {
+  const Tensor* input_ids = context->Input<Tensor>(0);
+  const Tensor* embedding = context->Input<Tensor>(1);
+  const Tensor* gamma = context->Input<Tensor>(2);
+  const Tensor* beta = context->Input<Tensor>(3);
+  const Tensor* scales = context->Input<Tensor>(4);
+  const Tensor* zero_points = context->Input<Tensor>(5);
+  const Tensor* position_ids = context->Input<Tensor>(6);
+  const Tensor* position_embedding = context->Input<Tensor>(7);
+
+  ORT_RETURN_IF_NOT(gamma->Shape().NumDimensions() == 1, "gamma is expected to have 1 dimension, got ",
+                    gamma->Shape().NumDimensions());
+  const int64_t hidden_size = gamma->Shape()[0];
+  ORT_RETURN_IF_NOT(simplified_ || beta == nullptr || beta->Shape() == gamma->Shape(),
+                    "beta is expected to have the shape of gamma, got ", beta == nullptr ? TensorShape{} : beta->Shape());
+
+  const auto& embedding_shape = embedding->Shape();
+  if (embedding->IsDataType<uint8_t>()) {
+    ORT_RETURN_IF_NOT(block_size_ >= 16 && (block_size_ & (block_size_ - 1)) == 0,
+                      "block_size must be a power of 2 not smaller than 16 for a quantized table, got ", block_size_);
+    const int64_t num_blocks = (hidden_size + block_size_ - 1) / block_size_;
+    ORT_RETURN_IF_NOT(embedding_shape.NumDimensions() == 3 && embedding_shape[1] == num_blocks &&
+                          embedding_shape[2] == block_size_ / 2,
+                      "A quantized embedding table is expected to have the shape (vocab_size, ", num_blocks, ", ",
+                      block_size_ / 2, "), got ", embedding_shape);
+    ORT_RETURN_IF_NOT(scales != nullptr && scales->Shape().Size() == embedding_shape[0] * num_blocks,
+                      "A quantized embedding table requires scales of size ", embedding_shape[0] * num_blocks);
+    ORT_RETURN_IF_NOT(zero_points == nullptr ||
+                          zero_points->Shape().Size() == embedding_shape[0] * ((num_blocks + 1) / 2),
+                      "zero_points is expected to have size ", embedding_shape[0] * ((num_blocks + 1) / 2));
+  } else {
+    ORT_RETURN_IF_NOT(embedding_shape.NumDimensions() == 2 && embedding_shape[1] == hidden_size,
+                      "embedding is expected to have the shape (vocab_size, ", hidden_size, "), got ",
+                      embedding_shape);
+  }
+
+  ORT_RETURN_IF_NOT((position_ids == nullptr) == (position_embedding == nullptr),
+                    "position_ids and position_embedding must be provided together");
+  if (position_ids != nullptr) {
+    ORT_RETURN_IF_NOT(position_ids->Shape() == input_ids->Shape(),
+                      "position_ids is expected to have the shape of input_ids, got ", position_ids->Shape());
+    ORT_RETURN_IF_NOT(position_ids->GetElementType() == input_ids->GetElementType(),
+                      "position_ids is expected to have the type of input_ids");
+    ORT_RETURN_IF_NOT(position_embedding->Shape().NumDimensions() == 2 &&
+                          position_embedding->Shape()[1] == hidden_size,
+                      "position_embedding is expected to have the shape (max_position, ", hidden_size, "), got ",
+                      position_embedding->Shape());
+  }
+
+  if (input_ids->IsDataType<int32_t>()) {
+    return ComputeImpl<int32_t>(context, *input_ids, *embedding, hidden_size, position_ids, position_embedding);
+  }
+  return ComputeImpl<int64_t>(context, *input_ids, *embedding, hidden_size, position_ids, position_embedding);
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    TokenEmbedLayerNormalization,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", {DataTypeImpl::GetTensorType<int32_t>(),
+                               DataTypeImpl::GetTensorType<int64_t>()})
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<float>(),
+                               DataTypeImpl::GetTensorType<uint8_t>()})
+        .TypeConstraint("T3", DataTypeImpl::GetTensorType<uint8_t>()),
+    TokenEmbedLayerNorm);
+
+}  // namespace contrib
+}  // namespace onnxruntime
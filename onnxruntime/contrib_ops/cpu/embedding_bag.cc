@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/**
+ * @brief Sum or mean of bags of rows of an embedding table.
+ *
+ * Replaces Gather followed by ReduceSum/ReduceMean over the last axis of the indices (see EmbeddingBagFusion):
+ * the rows are accumulated straight into the output, so the gathered tensor is never written to memory.
+ */
+class EmbeddingBag final : public OpKernel {
+ public:
+  explicit EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+    std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+    ORT_ENFORCE(mode == "sum" || mode == "mean", "EmbeddingBag: unsupported mode ", mode);
+    mean_ = mode == "mean";
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename Tind>
+  Status ComputeImpl(const Tensor& weight, const Tensor& indices, Tensor& output,
+                     concurrency::ThreadPool* tp) const;
+
+  bool mean_{false};
+};
+
+namespace {
+
+// The rows of a bag are read at random from the table, the row a few indices ahead is prefetched.
+constexpr int64_t kEmbeddingBagPrefetchDistance = 4;
+constexpr int64_t kEmbeddingBagPrefetchMaxBytes = 1024;
+
+inline void PrefetchRow(const float* row, int64_t row_size) {
+#if defined(__GNUC__) || defined(__clang__)
+  const int64_t bytes = std::min<int64_t>(row_size * static_cast<int64_t>(sizeof(float)), kEmbeddingBagPrefetchMaxBytes);
+  for (int64_t offset = 0; offset < bytes; offset += 64) {
+    __builtin_prefetch(reinterpret_cast<const char*>(row) + offset);
+  }
+#else
+  ORT_UNUSED_PARAMETER(row);
+  ORT_UNUSED_PARAMETER(row_size);
+#endif
+}
+
+}  // namespace
+
+template <typename Tind>
+Status EmbeddingBag::ComputeImpl(const Tensor& weight, const Tensor& indices, Tensor& output,
+                                 concurrency::ThreadPool* tp) const {
+  const auto& indices_shape = indices.Shape();
+  const int64_t num_rows = weight.Shape()[0];
+  const int64_t row_size = weight.Shape().SizeFromDimension(1);
+  const int64_t bag_size = indices_shape[indices_shape.NumDimensions() - 1];
+  const int64_t num_bags = indices_shape.SizeToDimension(indices_shape.NumDimensions() - 1);
+
+  const float* weight_data = weight.Data<float>();
+  const Tind* indices_data = indices.Data<Tind>();
+  float* output_data = output.MutableData<float>();
+
+  for (int64_t i = 0, end = indices_shape.Size(); i < end; ++i) {
+    const int64_t idx = static_cast<int64_t>(indices_data[i]);
+    if (idx < -num_rows || idx >= num_rows) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "indices element out of data bounds, idx=", idx,
+                             " must be within the inclusive range [", -num_rows, ",", num_rows - 1, "]");
+    }
+  }
+
+  auto row_of = [&](int64_t i) {
+    int64_t idx = static_cast<int64_t>(indices_data[i]);
+    idx = idx < 0 ? idx + num_rows : idx;
+    return weight_data + idx * row_size;
+  };
+
+  const bool mean = mean_;
+  const double bytes_per_row = static_cast<double>(row_size * sizeof(float));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(num_bags),
+      TensorOpCost{bytes_per_row * bag_size, bytes_per_row, static_cast<double>(row_size * bag_size)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t bag = first; bag < last; ++bag) {
+          const int64_t bag_start = bag * bag_size;
+          EigenVectorArrayMap<float> out(output_data + bag * row_size, onnxruntime::narrow<size_t>(row_size));
+          out.setZero();
+
+          for (int64_t l = 0; l < std::min(bag_size, kEmbeddingBagPrefetchDistance); ++l) {
+            PrefetchRow(row_of(bag_start + l), row_size);
+          }
+          for (int64_t l = 0; l < bag_size; ++l) {
+            if (l + kEmbeddingBagPrefetchDistance < bag_size) {
+              PrefetchRow(row_of(bag_start + l + kEmbeddingBagPrefetchDistance), row_size);
+            }
+            out += ConstEigenVectorArrayMap<float>(row_of(bag_start + l), onnxruntime::narrow<size_t>(row_size));
+          }
+
+          if (mean && bag_size > 0) {
+            out /= static_cast<float>(bag_size);
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+Status EmbeddingBag::Compute(OpKernelContext* context) const {
+  const auto* weight = context->Input<Tensor>(0);
+  const auto* indices = context->Input<Tensor>(1);
+
+  const auto& weight_shape = weight->Shape();
+  const auto& indices_shape = indices->Shape();
+  ORT_RETURN_IF_NOT(weight_shape.NumDimensions() >= 1 && indices_shape.NumDimensions() >= 1,
+                    "EmbeddingBag: weight and indices must have a rank of at least 1, got weight shape ",
+                    weight_shape, " and indices shape ", indices_shape);
+
+  TensorShapeVector output_dims(indices_shape.GetDims().begin(), indices_shape.GetDims().end() - 1);
+  output_dims.insert(output_dims.end(), weight_shape.GetDims().begin() + 1, weight_shape.GetDims().end());
+  auto* output = context->Output(0, output_dims);
+  if (output->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  if (indices->IsDataType<int32_t>()) {
+    return ComputeImpl<int32_t>(*weight, *indices, *output, tp);
+  }
+  return ComputeImpl<int64_t>(*weight, *indices, *output, tp);
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    EmbeddingBag,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("Tind", {DataTypeImpl::GetTensorType<int32_t>(),
+                                 DataTypeImpl::GetTensorType<int64_t>()}),
+    EmbeddingBag);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -11,4 +11,9 @@ namespace onnxruntime {
 
 common::Status GetFusedActivationAttr(const OpKernelInfo& info, MLAS_ACTIVATION& activation);
 
+// Same as above, reading the activation from the attributes named attr_name and attr_name + "_params",
+// for operators that fuse several activations.
+common::Status GetFusedActivationAttr(const OpKernelInfo& info, MLAS_ACTIVATION& activation,
+                                      const std::string& attr_name);
+
 }  // namespace onnxruntime
@@ -0,0 +1,293 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+
+enum class ElementwiseOp : uint8_t {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Max,
+  Min,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Exp,
+  Neg,
+  Abs,
+  Sqrt,
+  Erf,
+};
+
+bool ParseElementwiseOp(const std::string& name, ElementwiseOp& op) {
+  static const InlinedHashMap<std::string, ElementwiseOp> ops{
+      {"Add", ElementwiseOp::Add},
+      {"Sub", ElementwiseOp::Sub},
+      {"Mul", ElementwiseOp::Mul},
+      {"Div", ElementwiseOp::Div},
+      {"Max", ElementwiseOp::Max},
+      {"Min", ElementwiseOp::Min},
+      {"Relu", ElementwiseOp::Relu},
+      {"Sigmoid", ElementwiseOp::Sigmoid},
+      {"Tanh", ElementwiseOp::Tanh},
+      {"Exp", ElementwiseOp::Exp},
+      {"Neg", ElementwiseOp::Neg},
+      {"Abs", ElementwiseOp::Abs},
+      {"Sqrt", ElementwiseOp::Sqrt},
+      {"Erf", ElementwiseOp::Erf},
+  };
+  auto it = ops.find(name);
+  if (it == ops.end()) {
+    return false;
+  }
+  op = it->second;
+  return true;
+}
+
+bool IsBinary(ElementwiseOp op) {
+  return op <= ElementwiseOp::Min;
+}
+
+// Number of elements evaluated by every instruction before moving on to the next one. The intermediate values of
+// a tile stay in the L1 cache.
+constexpr size_t kFusedElementwiseTileSize = 256;
+
+// How an input is read for a tile of the output.
+enum class OperandKind : uint8_t {
+  Full,      // same number of elements as the output
+  Scalar,    // a single element
+  Periodic,  // matches the trailing dimensions of the output and repeats
+};
+
+}  // namespace
+
+/**
+ * @brief Evaluates a chain of elementwise operators in one pass over the output.
+ *
+ * The 'ops' attribute lists the operators in evaluation order and 'operands' holds two operand indices per operator
+ * (the second is -1 for unary operators). An index below the number of inputs refers to an input, otherwise to the
+ * result of the operator at (index - number of inputs). The output is the result of the last operator.
+ * See ElementwiseChainFusion.
+ */
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+    std::vector<std::string> ops = info.GetAttrsOrDefault<std::string>("ops");
+    std::vector<int64_t> operands = info.GetAttrsOrDefault<int64_t>("operands");
+    ORT_ENFORCE(!ops.empty() && operands.size() == 2 * ops.size(),
+                "FusedElementwise: 'operands' must hold two indices for every entry of 'ops'");
+
+    const int64_t num_inputs = static_cast<int64_t>(info.GetInputCount());
+    program_.reserve(ops.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+      Instruction instruction;
+      ORT_ENFORCE(ParseElementwiseOp(ops[i], instruction.op), "FusedElementwise: unsupported operator ", ops[i]);
+      instruction.a = operands[2 * i];
+      instruction.b = operands[2 * i + 1];
+
+      const int64_t num_values = num_inputs + static_cast<int64_t>(i);
+      ORT_ENFORCE(instruction.a >= 0 && instruction.a < num_values,
+                  "FusedElementwise: operand ", instruction.a, " of ", ops[i], " is out of range");
+      if (IsBinary(instruction.op)) {
+        ORT_ENFORCE(instruction.b >= 0 && instruction.b < num_values,
+                    "FusedElementwise: operand ", instruction.b, " of ", ops[i], " is out of range");
+      } else {
+        ORT_ENFORCE(instruction.b == -1, "FusedElementwise: unary operator ", ops[i], " takes a single operand");
+      }
+      program_.push_back(instruction);
+    }
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  struct Instruction {
+    ElementwiseOp op;
+    int64_t a;
+    int64_t b;
+  };
+
+  static void Evaluate(const Instruction& instruction, const float* a, const float* b, float* y, size_t count);
+
+  InlinedVector<Instruction> program_;
+};
+
+void FusedElementwise::Evaluate(const Instruction& instruction, const float* a, const float* b, float* y,
+                                size_t count) {
+  ConstEigenVectorArrayMap<float> xa(a, count);
+  EigenVectorArrayMap<float> ya(y, count);
+
+  switch (instruction.op) {
+    case ElementwiseOp::Add:
+      ya = xa + ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case ElementwiseOp::Sub:
+      ya = xa - ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case ElementwiseOp::Mul:
+      ya = xa * ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case ElementwiseOp::Div:
+      ya = xa / ConstEigenVectorArrayMap<float>(b, count);
+      break;
+    case ElementwiseOp::Max:
+      ya = xa.max(ConstEigenVectorArrayMap<float>(b, count));
+      break;
+    case ElementwiseOp::Min:
+      ya = xa.min(ConstEigenVectorArrayMap<float>(b, count));
+      break;
+    case ElementwiseOp::Relu:
+      ya = xa.cwiseMax(0.0f);
+      break;
+    case ElementwiseOp::Sigmoid:
+      MlasComputeLogistic(a, y, count);
+      break;
+    case ElementwiseOp::Tanh:
+      MlasComputeTanh(a, y, count);
+      break;
+    case ElementwiseOp::Exp:
+      ya = xa.exp();
+      break;
+    case ElementwiseOp::Neg:
+      ya = -xa;
+      break;
+    case ElementwiseOp::Abs:
+      ya = xa.abs();
+      break;
+    case ElementwiseOp::Sqrt:
+      ya = xa.sqrt();
+      break;
+    case ElementwiseOp::Erf:
+      MlasComputeErf(a, y, count);
+      break;
+  }
+}
+
+Status FusedElementwise::Compute(OpKernelContext* context) const {
+  const size_t num_inputs = static_cast<size_t>(context->InputCount());
+  const auto& output_shape = context->Input<Tensor>(0)->Shape();
+  auto* output = context->Output(0, output_shape);
+  const size_t output_size = onnxruntime::narrow<size_t>(output_shape.Size());
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  const auto output_dims = output_shape.GetDims();
+  InlinedVector<const float*> input_data(num_inputs);
+  InlinedVector<OperandKind> input_kinds(num_inputs);
+  InlinedVector<size_t> input_sizes(num_inputs);
+  size_t full_inputs = 0;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    const auto* input = context->Input<Tensor>(static_cast<int>(i));
+    const auto& shape = input->Shape();
+    input_data[i] = input->Data<float>();
+    input_sizes[i] = onnxruntime::narrow<size_t>(shape.Size());
+
+    if (input_sizes[i] == output_size) {
+      input_kinds[i] = OperandKind::Full;
+      ++full_inputs;
+    } else if (input_sizes[i] == 1) {
+      input_kinds[i] = OperandKind::Scalar;
+    } else {
+      // the dimensions past the leading 1s must be the trailing dimensions of the output
+      const auto dims = shape.GetDims();
+      auto first = std::find_if(dims.begin(), dims.end(), [](int64_t dim) { return dim != 1; });
+      const size_t rank = static_cast<size_t>(dims.end() - first);
+      ORT_RETURN_IF_NOT(rank <= output_dims.size() &&
+                            std::equal(first, dims.end(), output_dims.end() - rank),
+                        "FusedElementwise: input ", i, " of shape ", shape,
+                        " does not broadcast to the output shape ", output_shape);
+      input_kinds[i] = OperandKind::Periodic;
+    }
+  }
+
+  const float* const* inputs = input_data.data();
+  float* output_data = output->MutableData<float>();
+  const size_t num_instructions = program_.size();
+  const std::ptrdiff_t num_tiles =
+      static_cast<std::ptrdiff_t>((output_size + kFusedElementwiseTileSize - 1) / kFusedElementwiseTileSize);
+  const double tile_bytes = static_cast<double>(kFusedElementwiseTileSize * sizeof(float));
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), num_tiles,
+      TensorOpCost{tile_bytes * full_inputs, tile_bytes,
+                   static_cast<double>(kFusedElementwiseTileSize * num_instructions * 4)},
+      [&](std::ptrdiff_t first_tile, std::ptrdiff_t last_tile) {
+        // one tile buffer for every broadcast input and every intermediate result
+        std::vector<float> scratch((num_inputs + num_instructions) * kFusedElementwiseTileSize);
+        InlinedVector<float*> buffers(num_inputs + num_instructions);
+        InlinedVector<const float*> values(num_inputs + num_instructions);
+        for (size_t v = 0; v < buffers.size(); ++v) {
+          buffers[v] = scratch.data() + v * kFusedElementwiseTileSize;
+        }
+        for (size_t i = 0; i < num_inputs; ++i) {
+          if (input_kinds[i] == OperandKind::Scalar) {
+            std::fill_n(buffers[i], kFusedElementwiseTileSize, inputs[i][0]);
+          }
+        }
+
+        for (std::ptrdiff_t tile = first_tile; tile < last_tile; ++tile) {
+          const size_t start = static_cast<size_t>(tile) * kFusedElementwiseTileSize;
+          const size_t count = std::min(kFusedElementwiseTileSize, output_size - start);
+
+          for (size_t i = 0; i < num_inputs; ++i) {
+            switch (input_kinds[i]) {
+              case OperandKind::Full:
+                values[i] = inputs[i] + start;
+                break;
+              case OperandKind::Scalar:
+                values[i] = buffers[i];
+                break;
+              case OperandKind::Periodic: {
+                const size_t period = input_sizes[i];
+                size_t offset = start % period;
+                for (size_t copied = 0; copied < count;) {
+                  const size_t chunk = std::min(count - copied, period - offset);
+                  std::copy_n(inputs[i] + offset, chunk, buffers[i] + copied);
+                  copied += chunk;
+                  offset = 0;
+                }
+                values[i] = buffers[i];
+                break;
+              }
+            }
+          }
+
+          for (size_t k = 0; k < num_instructions; ++k) {
+            const auto& instruction = program_[k];
+            float* result = k + 1 == num_instructions ? output_data + start : buffers[num_inputs + k];
+            Evaluate(instruction, values[instruction.a], instruction.b >= 0 ? values[instruction.b] : nullptr,
+                     result, count);
+            values[num_inputs + k] = result;
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,671 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/moe/moe_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/mlas/inc/mlas_qnbit.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MoE,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    MoE);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    QMoE,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<uint8_t>()),
+    QMoE);
+
+namespace {
+
+constexpr size_t kQMoEBits = 4;
+constexpr size_t kQMoEBlockSize = 32;
+constexpr MLAS_SQNBIT_GEMM_COMPUTE_TYPE kQMoEComputeType = CompFp32;
+constexpr size_t kPackedExpertAlignment = 64;
+
+MoEActivationType GetActivationType(const OpKernelInfo& op_kernel_info) {
+  std::string activation_type_str;
+  ORT_ENFORCE(op_kernel_info.GetAttr<std::string>("activation_type", &activation_type_str).IsOK());
+  if (activation_type_str == "relu") {
+    return MoEActivationType::Relu;
+  } else if (activation_type_str == "gelu") {
+    return MoEActivationType::Gelu;
+  } else if (activation_type_str == "silu") {
+    return MoEActivationType::Silu;
+  } else if (activation_type_str == "identity") {
+    return MoEActivationType::Identity;
+  }
+  ORT_THROW("Unsupported MoE activation type: ", activation_type_str);
+}
+
+// The activations match the CUDA kernel, which uses the tanh approximation of Gelu.
+void ApplyActivation(MoEActivationType activation_type, float* data, size_t count) {
+  switch (activation_type) {
+    case MoEActivationType::Relu:
+      for (size_t i = 0; i < count; i++) {
+        data[i] = std::max(data[i], 0.0f);
+      }
+      break;
+    case MoEActivationType::Gelu:
+      for (size_t i = 0; i < count; i++) {
+        constexpr float kAlpha = 0.7978845608028654f;
+        constexpr float kBeta = 0.044715f;
+        const float x = data[i];
+        data[i] = 0.5f * x * (1.0f + std::tanh(kAlpha * x * (1.0f + kBeta * x * x)));
+      }
+      break;
+    case MoEActivationType::Silu:
+      for (size_t i = 0; i < count; i++) {
+        data[i] = data[i] / (1.0f + std::exp(-data[i]));
+      }
+      break;
+    case MoEActivationType::Identity:
+      break;
+  }
+}
+
+// The routing of the rows to their top k experts. Expanded row i is the (i % k)-th selection of row i / k. The
+// expanded rows are permuted so that the rows routed to an expert are contiguous, starting at
+// expert_row_offsets[expert].
+struct ExpertRouting {
+  std::vector<size_t> expert_for_row;
+  std::vector<float> routing_weights;
+  std::vector<size_t> expert_row_offsets;
+  std::vector<size_t> permuted_row_for_row;
+  std::vector<size_t> expert_for_permuted_row;
+};
+
+// Routes every row to its top k experts. The router logits are normalized with a softmax first, like on CUDA.
+void RouteRows(const float* router_probs, size_t num_rows, size_t num_experts, size_t k,
+               bool normalize_routing_weights, ExpertRouting& routing) {
+  const size_t expanded_rows = SafeInt<size_t>(num_rows) * k;
+  routing.expert_for_row.resize(expanded_rows);
+  routing.routing_weights.resize(expanded_rows);
+  routing.expert_row_offsets.assign(num_experts + 1, 0);
+  std::vector<float> probs(num_experts);
+  for (size_t row = 0; row < num_rows; row++) {
+    const float* logits = router_probs + row * num_experts;
+    const float max_logit = *std::max_element(logits, logits + num_experts);
+    float probs_sum = 0.0f;
+    for (size_t expert = 0; expert < num_experts; expert++) {
+      probs[expert] = std::exp(logits[expert] - max_logit);
+      probs_sum += probs[expert];
+    }
+
+    float weights_sum = 0.0f;
+    for (size_t i = row * k; i < (row + 1) * k; i++) {
+      const size_t expert = static_cast<size_t>(std::max_element(probs.begin(), probs.end()) - probs.begin());
+      routing.expert_for_row[i] = expert;
+      routing.routing_weights[i] = probs[expert] / probs_sum;
+      weights_sum += routing.routing_weights[i];
+      probs[expert] = -1.0f;  // probabilities are non-negative, so the expert is not selected again
+      routing.expert_row_offsets[expert + 1]++;
+    }
+
+    if (normalize_routing_weights) {
+      for (size_t i = row * k; i < (row + 1) * k; i++) {
+        routing.routing_weights[i] /= weights_sum;
+      }
+    }
+  }
+
+  // Sort the expanded rows by expert, so that the rows of an expert are contiguous.
+  for (size_t expert = 0; expert < num_experts; expert++) {
+    routing.expert_row_offsets[expert + 1] += routing.expert_row_offsets[expert];
+  }
+
+  routing.permuted_row_for_row.resize(expanded_rows);
+  routing.expert_for_permuted_row.resize(expanded_rows);
+  std::vector<size_t> next_permuted_row(routing.expert_row_offsets.begin(), routing.expert_row_offsets.end() - 1);
+  for (size_t i = 0; i < expanded_rows; i++) {
+    const size_t permuted_row = next_permuted_row[routing.expert_for_row[i]]++;
+    routing.permuted_row_for_row[i] = permuted_row;
+    routing.expert_for_permuted_row[permuted_row] = routing.expert_for_row[i];
+  }
+}
+
+void PermuteRows(const ExpertRouting& routing, const float* input, size_t k, size_t hidden_size,
+                 float* permuted_input, concurrency::ThreadPool* thread_pool) {
+  concurrency::ThreadPool::TryBatchParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(routing.permuted_row_for_row.size()),
+      [&](std::ptrdiff_t task_idx) {
+        const size_t i = static_cast<size_t>(task_idx);
+        std::memcpy(permuted_input + routing.permuted_row_for_row[i] * hidden_size,
+                    input + (i / k) * hidden_size, hidden_size * sizeof(float));
+      },
+      0);
+}
+
+// Adds the FC1 bias, applies the activation and multiplies by the FC3 output if any, in place in the FC1 output.
+void ApplyFc1Epilogue(const ExpertRouting& routing, MoEActivationType activation_type, float* fc1_output,
+                      const float* fc1_bias, const float* fc3_output, const float* fc3_bias, size_t inter_size,
+                      concurrency::ThreadPool* thread_pool) {
+  concurrency::ThreadPool::TryBatchParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(routing.expert_for_permuted_row.size()),
+      [&](std::ptrdiff_t task_idx) {
+        const size_t permuted_row = static_cast<size_t>(task_idx);
+        const size_t expert = routing.expert_for_permuted_row[permuted_row];
+        float* fc1_row = fc1_output + permuted_row * inter_size;
+        if (fc1_bias != nullptr) {
+          const float* bias = fc1_bias + expert * inter_size;
+          for (size_t i = 0; i < inter_size; i++) {
+            fc1_row[i] += bias[i];
+          }
+        }
+
+        ApplyActivation(activation_type, fc1_row, inter_size);
+
+        if (fc3_output != nullptr) {
+          const float* fc3_row = fc3_output + permuted_row * inter_size;
+          const float* bias = fc3_bias != nullptr ? fc3_bias + expert * inter_size : nullptr;
+          for (size_t i = 0; i < inter_size; i++) {
+            fc1_row[i] *= bias != nullptr ? fc3_row[i] + bias[i] : fc3_row[i];
+          }
+        }
+      },
+      0);
+}
+
+// Combines the outputs of the selected experts, weighted by the routing weights.
+void CombineExpertOutputs(const ExpertRouting& routing, const float* fc2_output, const float* fc2_bias,
+                          size_t num_rows, size_t k, size_t hidden_size, float* output,
+                          concurrency::ThreadPool* thread_pool) {
+  concurrency::ThreadPool::TryBatchParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_rows),
+      [&](std::ptrdiff_t task_idx) {
+        const size_t row = static_cast<size_t>(task_idx);
+        float* output_row = output + row * hidden_size;
+        std::fill_n(output_row, hidden_size, 0.0f);
+        for (size_t i = row * k; i < (row + 1) * k; i++) {
+          const float weight = routing.routing_weights[i];
+          const float* fc2_row = fc2_output + routing.permuted_row_for_row[i] * hidden_size;
+          const float* bias = fc2_bias != nullptr ? fc2_bias + routing.expert_for_row[i] * hidden_size : nullptr;
+          for (size_t h = 0; h < hidden_size; h++) {
+            output_row[h] += weight * (bias != nullptr ? fc2_row[h] + bias[h] : fc2_row[h]);
+          }
+        }
+      },
+      0);
+}
+
+// Appends one GEMM per expert that has rows routed to it. The rows of an expert are contiguous in A and C, starting at
+// expert_row_offsets[expert]. Like the CUDA kernel, the (K, N) weights of an expert are stored in column major order,
+// so they are multiplied transposed.
+void AddExpertGemms(const std::vector<size_t>& expert_row_offsets, const float* A, size_t K, const float* weights,
+                    size_t N, float* C, std::vector<MLAS_SGEMM_GROUPED_PROBLEM>& problems) {
+  for (size_t expert = 0; expert + 1 < expert_row_offsets.size(); expert++) {
+    const size_t row_offset = expert_row_offsets[expert];
+    const size_t row_count = expert_row_offsets[expert + 1] - row_offset;
+    if (row_count == 0) {
+      continue;
+    }
+
+    MLAS_SGEMM_GROUPED_PROBLEM problem;
+    problem.M = row_count;
+    problem.N = N;
+    problem.K = K;
+    problem.Data.A = A + row_offset * K;
+    problem.Data.lda = K;
+    problem.Data.B = weights + expert * K * N;
+    problem.Data.ldb = K;
+    problem.Data.C = C + row_offset * N;
+    problem.Data.ldc = N;
+    problems.push_back(problem);
+  }
+}
+
+size_t GetQuantBlockCount(size_t K) {
+  return (K + kQMoEBlockSize - 1) / kQMoEBlockSize;
+}
+
+// The size of the packed 4-bit weights of one expert, rounded up to keep the weights of every expert aligned.
+size_t GetPackedExpertDataSize(size_t K, size_t N) {
+  size_t size = MlasSQNBitGemmPackQuantBDataSize(N, K, kQMoEBits, kQMoEBlockSize, kQMoEComputeType);
+  if (size == 0) {
+    size = N * GetQuantBlockCount(K) * (kQMoEBlockSize * kQMoEBits / 8);
+  }
+  return (size + kPackedExpertAlignment - 1) / kPackedExpertAlignment * kPackedExpertAlignment;
+}
+
+// Repacks the 4-bit weights of an expert to the column-wise blocks of MatMulNBits, [N, k_blocks, block_size / 2]. The
+// padding of the last block holds the zero point, so it dequantizes to 0.
+void RepackExpertWeights(const uint8_t* weights, size_t K, size_t N, uint8_t* repacked) {
+  const size_t column_bytes = GetQuantBlockCount(K) * kQMoEBlockSize * kQMoEBits / 8;
+  std::fill_n(repacked, N * column_bytes, uint8_t{0x88});
+  for (size_t k = 0; k < K; k++) {
+    const uint8_t* weights_row = weights + k * (N / 2);
+    const int shift = 4 * static_cast<int>(k & 1);
+    for (size_t n = 0; n < N; n++) {
+      const uint8_t value = (weights_row[n / 2] >> (4 * (n & 1))) & 0x0F;
+      uint8_t& packed = repacked[n * column_bytes + k / 2];
+      packed = static_cast<uint8_t>((packed & ~(0x0F << shift)) | (value << shift));
+    }
+  }
+}
+
+// Expands the scales of the columns of an expert to one scale per block of MatMulNBits.
+void ExpandExpertScales(const float* scales, size_t K, size_t N, float* expanded) {
+  const size_t k_blocks = GetQuantBlockCount(K);
+  for (size_t n = 0; n < N; n++) {
+    std::fill_n(expanded + n * k_blocks, k_blocks, scales[n]);
+  }
+}
+
+// Dequantizes the 4-bit weights of an expert to the column major float weights of MoE.
+void DequantizeExpertWeights(const uint8_t* weights, const float* scales, size_t K, size_t N, float* dequantized,
+                             concurrency::ThreadPool* thread_pool) {
+  concurrency::ThreadPool::TryBatchParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(N),
+      [&](std::ptrdiff_t task_idx) {
+        const size_t n = static_cast<size_t>(task_idx);
+        const int shift = 4 * static_cast<int>(n & 1);
+        const float scale = scales[n];
+        float* column = dequantized + n * K;
+        for (size_t k = 0; k < K; k++) {
+          const int value = (weights[k * (N / 2) + n / 2] >> shift) & 0x0F;
+          column[k] = static_cast<float>(value - 8) * scale;
+        }
+      },
+      0);
+}
+
+}  // namespace
+
+MoE::MoE(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info), MoEBaseCPU(op_kernel_info) {
+  activation_type_ = GetActivationType(op_kernel_info);
+}
+
+Status MoE::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* router_probs = context->Input<Tensor>(1);
+  const Tensor* fc1_experts_weights = context->Input<Tensor>(2);
+  const Tensor* fc1_experts_bias_optional = context->Input<Tensor>(3);
+  const Tensor* fc2_experts_weights = context->Input<Tensor>(4);
+  const Tensor* fc2_experts_bias_optional = context->Input<Tensor>(5);
+  const Tensor* fc3_experts_weights_optional = context->Input<Tensor>(6);
+  const Tensor* fc3_experts_bias_optional = context->Input<Tensor>(7);
+
+  MoEParameters moe_params;
+  MoEQuantType quant_type = MoEQuantType::None;
+  ORT_RETURN_IF_ERROR(CheckInputs(moe_params, quant_type, input, router_probs, fc1_experts_weights,
+                                  fc1_experts_bias_optional, fc2_experts_weights, fc2_experts_bias_optional,
+                                  fc3_experts_weights_optional, fc3_experts_bias_optional));
+  ORT_RETURN_IF_NOT(moe_params.parallel_type == MoEParallelType::None,
+                    "The CPU MoE kernel requires all the experts to be local.");
+  ORT_RETURN_IF_NOT(k_ > 0 && k_ <= moe_params.num_experts, "k must be in the range [1, num_experts], got ", k_);
+
+  Tensor* output = context->Output(0, input->Shape());
+
+  const size_t num_rows = static_cast<size_t>(moe_params.num_rows);
+  const size_t num_experts = static_cast<size_t>(moe_params.num_experts);
+  const size_t hidden_size = static_cast<size_t>(moe_params.hidden_size);
+  const size_t inter_size = static_cast<size_t>(moe_params.inter_size);
+  const size_t k = static_cast<size_t>(k_);
+  const size_t expanded_rows = SafeInt<size_t>(num_rows) * k;
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+
+  ExpertRouting routing;
+  RouteRows(router_probs->Data<float>(), num_rows, num_experts, k, normalize_routing_weights_, routing);
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto permuted_input = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * hidden_size);
+  auto fc1_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * inter_size);
+  auto fc2_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * hidden_size);
+  IAllocatorUniquePtr<float> fc3_output;
+  if (fc3_experts_weights_optional != nullptr) {
+    fc3_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * inter_size);
+  }
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  PermuteRows(routing, input->Data<float>(), k, hidden_size, permuted_input.get(), thread_pool);
+
+  // FC1 and FC3 of all the experts, in one grouped GEMM.
+  std::vector<MLAS_SGEMM_GROUPED_PROBLEM> problems;
+  problems.reserve(2 * num_experts);
+  AddExpertGemms(routing.expert_row_offsets, permuted_input.get(), hidden_size, fc1_experts_weights->Data<float>(),
+                 inter_size, fc1_output.get(), problems);
+  if (fc3_experts_weights_optional != nullptr) {
+    AddExpertGemms(routing.expert_row_offsets, permuted_input.get(), hidden_size,
+                   fc3_experts_weights_optional->Data<float>(), inter_size, fc3_output.get(), problems);
+  }
+  MlasGemmGrouped(CblasNoTrans, CblasTrans, problems.data(), problems.size(), thread_pool);
+
+  ApplyFc1Epilogue(routing, activation_type_, fc1_output.get(),
+                   fc1_experts_bias_optional ? fc1_experts_bias_optional->Data<float>() : nullptr, fc3_output.get(),
+                   fc3_experts_bias_optional ? fc3_experts_bias_optional->Data<float>() : nullptr, inter_size,
+                   thread_pool);
+
+  problems.clear();
+  AddExpertGemms(routing.expert_row_offsets, fc1_output.get(), inter_size, fc2_experts_weights->Data<float>(),
+                 hidden_size, fc2_output.get(), problems);
+  MlasGemmGrouped(CblasNoTrans, CblasTrans, problems.data(), problems.size(), thread_pool);
+
+  CombineExpertOutputs(routing, fc2_output.get(),
+                       fc2_experts_bias_optional ? fc2_experts_bias_optional->Data<float>() : nullptr, num_rows, k,
+                       hidden_size, output->MutableData<float>(), thread_pool);
+
+  return Status::OK();
+}
+
+QMoE::QMoE(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info), MoEBaseCPU(op_kernel_info) {
+  activation_type_ = GetActivationType(op_kernel_info);
+}
+
+// The weights, scales and bias of FC layer fc are inputs 2 + 3 * fc, 3 + 3 * fc and 4 + 3 * fc.
+Status QMoE::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
+                     /*out*/ bool& is_packed,
+                     /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+  if (input_idx < 2) {
+    return Status::OK();
+  }
+
+  PackedExpertWeights& packed = packed_weights_[static_cast<size_t>(input_idx - 2) / 3];
+  const auto& dims = tensor.Shape().GetDims();
+  if ((input_idx - 2) % 3 == 0) {
+    if (dims.size() != 3 || !MlasIsSQNBitGemmAvailable(kQMoEBits, kQMoEBlockSize, kQMoEComputeType)) {
+      return Status::OK();
+    }
+
+    const size_t num_experts = static_cast<size_t>(dims[0]);
+    const size_t K = static_cast<size_t>(dims[1]);
+    const size_t N = static_cast<size_t>(dims[2]) * 2;
+    const size_t expert_data_size = GetPackedExpertDataSize(K, N);
+    const size_t packed_data_size = SafeInt<size_t>(num_experts) * expert_data_size;
+    packed.data = IAllocator::MakeUniquePtr<void>(alloc, packed_data_size, true);
+
+    // MLAS may pack the blockwise weights further
+    const bool is_mlas_packed =
+        MlasSQNBitGemmPackQuantBDataSize(N, K, kQMoEBits, kQMoEBlockSize, kQMoEComputeType) > 0;
+    std::vector<uint8_t> repacked(is_mlas_packed ? N * GetQuantBlockCount(K) * kQMoEBlockSize * kQMoEBits / 8 : 0);
+    const uint8_t* weights = tensor.Data<uint8_t>();
+    for (size_t expert = 0; expert < num_experts; expert++) {
+      uint8_t* expert_data = static_cast<uint8_t*>(packed.data.get()) + expert * expert_data_size;
+      const uint8_t* expert_weights = weights + expert * K * (N / 2);
+      if (is_mlas_packed) {
+        RepackExpertWeights(expert_weights, K, N, repacked.data());
+        MlasSQNBitGemmPackQuantBData(N, K, kQMoEBits, kQMoEBlockSize, kQMoEComputeType, repacked.data(),
+                                     expert_data);
+      } else {
+        RepackExpertWeights(expert_weights, K, N, expert_data);
+      }
+    }
+
+    packed.num_experts = num_experts;
+    packed.K = K;
+    packed.N = N;
+    if (prepacked_weights) {
+      prepacked_weights->buffers_.push_back(std::move(packed.data));
+      prepacked_weights->buffer_sizes_.push_back(packed_data_size);
+    }
+    is_packed = true;
+  } else if ((input_idx - 2) % 3 == 1 && packed.num_experts != 0) {
+    // the scales of packed weights
+    if (tensor.Shape() != TensorShape({static_cast<int64_t>(packed.num_experts), static_cast<int64_t>(packed.N)})) {
+      return Status::OK();
+    }
+
+    const size_t expert_scales_size = packed.N * GetQuantBlockCount(packed.K);
+    const size_t packed_scales_size = SafeInt<size_t>(packed.num_experts) * expert_scales_size * sizeof(float);
+    packed.scales = IAllocator::MakeUniquePtr<void>(alloc, packed_scales_size, true);
+    const float* scales = tensor.Data<float>();
+    for (size_t expert = 0; expert < packed.num_experts; expert++) {
+      ExpandExpertScales(scales + expert * packed.N, packed.K, packed.N,
+                         static_cast<float*>(packed.scales.get()) + expert * expert_scales_size);
+    }
+
+    if (prepacked_weights) {
+      prepacked_weights->buffers_.push_back(std::move(packed.scales));
+      prepacked_weights->buffer_sizes_.push_back(packed_scales_size);
+    }
+    is_packed = true;
+  }
+
+  return Status::OK();
+}
+
+Status QMoE::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                       /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+  if (input_idx < 2) {
+    return Status::OK();
+  }
+
+  PackedExpertWeights& packed = packed_weights_[static_cast<size_t>(input_idx - 2) / 3];
+  if ((input_idx - 2) % 3 == 0) {
+    packed.data = std::move(prepacked_buffers[0]);
+    used_shared_buffers = true;
+  } else if ((input_idx - 2) % 3 == 1) {
+    packed.scales = std::move(prepacked_buffers[0]);
+    used_shared_buffers = true;
+  }
+
+  return Status::OK();
+}
+
+// Runs the GEMMs of FC layer fc for the experts that rows are routed to, one expert at a time.
+Status QMoE::ComputeExpertGemms(OpKernelContext* context, size_t fc, const std::vector<size_t>& expert_row_offsets,
+                                const float* A, size_t K, size_t N, float* C) const {
+  const PackedExpertWeights& packed = packed_weights_[fc];
+  const Tensor* weights = context->Input<Tensor>(static_cast<int>(2 + 3 * fc));
+  const Tensor* scales = context->Input<Tensor>(static_cast<int>(3 + 3 * fc));
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  if (packed.data == nullptr) {
+    auto dequantized = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(K) * N);
+    for (size_t expert = 0; expert + 1 < expert_row_offsets.size(); expert++) {
+      const size_t row_offset = expert_row_offsets[expert];
+      const size_t row_count = expert_row_offsets[expert + 1] - row_offset;
+      if (row_count == 0) {
+        continue;
+      }
+
+      DequantizeExpertWeights(weights->Data<uint8_t>() + expert * K * (N / 2), scales->Data<float>() + expert * N, K,
+                              N, dequantized.get(), thread_pool);
+
+      MLAS_SGEMM_DATA_PARAMS data;
+      data.A = A + row_offset * K;
+      data.lda = K;
+      data.B = dequantized.get();
+      data.ldb = K;
+      data.C = C + row_offset * N;
+      data.ldc = N;
+      MlasGemm(CblasNoTrans, CblasTrans, row_count, N, K, data, thread_pool);
+    }
+    return Status::OK();
+  }
+
+  const size_t k_blocks = GetQuantBlockCount(K);
+  const size_t expert_data_size = GetPackedExpertDataSize(K, N);
+  size_t workspace_size = 0;
+  for (size_t expert = 0; expert + 1 < expert_row_offsets.size(); expert++) {
+    const size_t row_count = expert_row_offsets[expert + 1] - expert_row_offsets[expert];
+    workspace_size = std::max(workspace_size, MlasSQNBitGemmBatchWorkspaceSize(row_count, N, K, 1, kQMoEBits,
+                                                                               kQMoEBlockSize, kQMoEComputeType));
+  }
+
+  IAllocatorUniquePtr<std::byte> workspace;
+  if (workspace_size > 0) {
+    workspace = IAllocator::MakeUniquePtr<std::byte>(allocator, workspace_size);
+  }
+
+  // scales that are not constant are expanded for every expert that is run
+  IAllocatorUniquePtr<float> expanded_scales;
+  if (packed.scales == nullptr) {
+    expanded_scales = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(N) * k_blocks);
+  }
+
+  for (size_t expert = 0; expert + 1 < expert_row_offsets.size(); expert++) {
+    const size_t row_offset = expert_row_offsets[expert];
+    const size_t row_count = expert_row_offsets[expert + 1] - row_offset;
+    if (row_count == 0) {
+      continue;
+    }
+
+    const float* expert_scales = nullptr;
+    if (packed.scales != nullptr) {
+      expert_scales = static_cast<const float*>(packed.scales.get()) + expert * N * k_blocks;
+    } else {
+      ExpandExpertScales(scales->Data<float>() + expert * N, K, N, expanded_scales.get());
+      expert_scales = expanded_scales.get();
+    }
+
+    MLAS_SQNBIT_GEMM_DATA_PARAMS data;
+    data.A = A + row_offset * K;
+    data.lda = K;
+    data.QuantBData = static_cast<const std::byte*>(packed.data.get()) + expert * expert_data_size;
+    data.QuantBScale = expert_scales;
+    data.C = C + row_offset * N;
+    data.ldc = N;
+    MlasSQNBitGemmBatch(row_count, N, K, 1, kQMoEBits, kQMoEBlockSize, kQMoEComputeType, &data, workspace.get(),
+                        thread_pool);
+  }
+
+  return Status::OK();
+}
+
+Status QMoE::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* router_probs = context->Input<Tensor>(1);
+
+  const auto& input_dims = input->Shape().GetDims();
+  const auto& router_probs_dims = router_probs->Shape().GetDims();
+  ORT_RETURN_IF_NOT(input_dims.size() == 2 || input_dims.size() == 3, "input must be 2D or 3D, got ",
+                    input_dims.size());
+  ORT_RETURN_IF_NOT(router_probs_dims.size() == 2, "router_probs_dims must be 2D, got ", router_probs_dims.size());
+
+  const int64_t num_rows = input->Shape().SizeToDimension(input_dims.size() - 1);
+  const int64_t hidden_size = input_dims.back();
+  const int64_t num_experts = router_probs_dims[1];
+  ORT_RETURN_IF_NOT(router_probs_dims[0] == num_rows, "router_probs_dims[0] must be equal to num_rows, got ",
+                    router_probs_dims[0], " and ", num_rows);
+  ORT_RETURN_IF_NOT(k_ > 0 && k_ <= num_experts, "k must be in the range [1, num_experts], got ", k_);
+
+  // The shape of the weights of FC layer fc, which are not an input any more once they are prepacked.
+  auto get_weights_shape = [this, context](size_t fc) {
+    const Tensor* weights = context->Input<Tensor>(static_cast<int>(2 + 3 * fc));
+    if (weights != nullptr) {
+      return weights->Shape();
+    }
+    const PackedExpertWeights& packed = packed_weights_[fc];
+    return packed.num_experts == 0 ? TensorShape{}
+                                   : TensorShape({static_cast<int64_t>(packed.num_experts),
+                                                  static_cast<int64_t>(packed.K), static_cast<int64_t>(packed.N / 2)});
+  };
+
+  const TensorShape fc1_weights_shape = get_weights_shape(0);
+  ORT_RETURN_IF_NOT(fc1_weights_shape.NumDimensions() == 3, "fc1_experts_weights must be 3D, got ",
+                    fc1_weights_shape.NumDimensions());
+  const int64_t inter_size = fc1_weights_shape[2] * 2;
+  const bool has_fc3 = context->Input<Tensor>(8) != nullptr || packed_weights_[2].num_experts != 0;
+
+  // All the experts are local on CPU, the scales and biases have a value per output column.
+  auto check_fc = [&](size_t fc, int64_t K, int64_t N) -> Status {
+    const TensorShape weights_shape = get_weights_shape(fc);
+    ORT_RETURN_IF_NOT(weights_shape == TensorShape({num_experts, K, N / 2}), "fc", fc + 1,
+                      "_experts_weights must have shape ", TensorShape({num_experts, K, N / 2}), ", got ",
+                      weights_shape);
+    ORT_RETURN_IF(context->Input<Tensor>(static_cast<int>(3 + 3 * fc)) == nullptr &&
+                      packed_weights_[fc].scales == nullptr,
+                  "fc", fc + 1, "_scales is required");
+    for (int input_idx : {static_cast<int>(3 + 3 * fc), static_cast<int>(4 + 3 * fc)}) {
+      const Tensor* tensor = context->Input<Tensor>(input_idx);
+      ORT_RETURN_IF_NOT(tensor == nullptr || tensor->Shape() == TensorShape({num_experts, N}), "input ", input_idx,
+                        " of QMoE must have shape ", TensorShape({num_experts, N}), ", got ",
+                        tensor ? tensor->Shape() : TensorShape{});
+    }
+    return Status::OK();
+  };
+  ORT_RETURN_IF_ERROR(check_fc(0, hidden_size, inter_size));
+  ORT_RETURN_IF_ERROR(check_fc(1, inter_size, hidden_size));
+  if (has_fc3) {
+    ORT_RETURN_IF_ERROR(check_fc(2, hidden_size, inter_size));
+  }
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+
+  const size_t k = static_cast<size_t>(k_);
+  const size_t expanded_rows = SafeInt<size_t>(num_rows) * k;
+
+  ExpertRouting routing;
+  RouteRows(router_probs->Data<float>(), static_cast<size_t>(num_rows), static_cast<size_t>(num_experts), k,
+            normalize_routing_weights_, routing);
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto permuted_input = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * hidden_size);
+  auto fc1_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * inter_size);
+  auto fc2_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * hidden_size);
+  IAllocatorUniquePtr<float> fc3_output;
+  if (has_fc3) {
+    fc3_output = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(expanded_rows) * inter_size);
+  }
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  PermuteRows(routing, input->Data<float>(), k, static_cast<size_t>(hidden_size), permuted_input.get(), thread_pool);
+
+  ORT_RETURN_IF_ERROR(ComputeExpertGemms(context, 0, routing.expert_row_offsets, permuted_input.get(),
+                                         static_cast<size_t>(hidden_size), static_cast<size_t>(inter_size),
+                                         fc1_output.get()));
+  if (has_fc3) {
+    ORT_RETURN_IF_ERROR(ComputeExpertGemms(context, 2, routing.expert_row_offsets, permuted_input.get(),
+                                           static_cast<size_t>(hidden_size), static_cast<size_t>(inter_size),
+                                           fc3_output.get()));
+  }
+
+  const Tensor* fc1_experts_bias_optional = context->Input<Tensor>(4);
+  const Tensor* fc3_experts_bias_optional = context->Input<Tensor>(10);
+  ApplyFc1Epilogue(routing, activation_type_, fc1_output.get(),
+                   fc1_experts_bias_optional ? fc1_experts_bias_optional->Data<float>() : nullptr, fc3_output.get(),
+                   fc3_experts_bias_optional ? fc3_experts_bias_optional->Data<float>() : nullptr,
+                   static_cast<size_t>(inter_size), thread_pool);
+
+  ORT_RETURN_IF_ERROR(ComputeExpertGemms(context, 1, routing.expert_row_offsets, fc1_output.get(),
+                                         static_cast<size_t>(inter_size), static_cast<size_t>(hidden_size),
+                                         fc2_output.get()));
+
+  const Tensor* fc2_experts_bias_optional = context->Input<Tensor>(7);
+  CombineExpertOutputs(routing, fc2_output.get(),
+                       fc2_experts_bias_optional ? fc2_experts_bias_optional->Data<float>() : nullptr,
+                       static_cast<size_t>(num_rows), k, static_cast<size_t>(hidden_size),
+                       output->MutableData<float>(), thread_pool);
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/moe/moe_base_cpu.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+enum class MoEActivationType {
+  Relu,
+  Gelu,
+  Silu,
+  Identity,
+};
+
+// Mixture of experts. The rows routed to each expert are gathered together, so that the FC layers of all the experts
+// run as a single grouped GEMM with a per expert number of rows.
+class MoE final : public OpKernel, public MoEBaseCPU {
+ public:
+  explicit MoE(const OpKernelInfo& op_kernel_info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  MoEActivationType activation_type_;
+};
+
+// Mixture of experts with symmetric 4-bit expert weights and a scale per output column. The (hidden_size, inter_size)
+// weights of an expert are stored row by row, with two columns per byte and the even column in the low nibble. The
+// rows are routed like in MoE. Constant weights are repacked to the blockwise layout of MatMulNBits, so the GEMMs of
+// an expert run on the 4-bit MLAS kernels. Otherwise the weights of the selected experts are dequantized on the fly.
+class QMoE final : public OpKernel, public MoEBaseCPU {
+ public:
+  explicit QMoE(const OpKernelInfo& op_kernel_info);
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // The weights and scales of one FC layer of all the experts, repacked for MlasSQNBitGemmBatch.
+  struct PackedExpertWeights {
+    IAllocatorUniquePtr<void> data;
+    IAllocatorUniquePtr<void> scales;
+    size_t num_experts{0};
+    size_t K{0};
+    size_t N{0};
+  };
+
+  Status ComputeExpertGemms(OpKernelContext* context, size_t fc, const std::vector<size_t>& expert_row_offsets,
+                            const float* A, size_t K, size_t N, float* C) const;
+
+  MoEActivationType activation_type_;
+  std::array<PackedExpertWeights, 3> packed_weights_;  // FC1, FC2 and FC3
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,358 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//
+// This file contains implementation of a fp32 channels last depthwise separable convolution operator.
+//
+
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/nn/conv_attributes.h"
+#include "core/util/math.h"
+
+#include "contrib_ops/cpu/fused_activation.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using ConvPadVector = ConvAttributes::ConvPadVector;
+
+/**
+ * @brief Depthwise convolution followed by a pointwise convolution, for FP32 NHWC tensors
+ *
+ * Implements ms.NhwcFusedDepthwisePointwiseConv. The output pixels are processed by tiles:
+ * the depthwise convolution of a tile is computed into a per thread buffer small enough to
+ * stay in the cache, and the buffer is immediately multiplied by the pointwise filter, so the
+ * intermediate tensor is never written to memory.
+ */
+class NhwcFusedDepthwisePointwiseConv final : public OpKernel {
+ public:
+  NhwcFusedDepthwisePointwiseConv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
+    ORT_ENFORCE(GetFusedActivationAttr(info, dw_activation_, "dw_activation").IsOK());
+    ORT_ENFORCE(GetFusedActivationAttr(info, activation_).IsOK());
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed, /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+ private:
+  /**
+   * @brief Reorder the (C x 1 x kH x kW) depthwise filter into a (kH x kW) x C matrix,
+   *        the layout expected by MlasConvDepthwise.
+   */
+  static void ReorderDepthwiseFilter(const float* input, float* output, size_t channels, size_t kernel_size) {
+    for (size_t k = 0; k < kernel_size; k++) {
+      for (size_t c = 0; c < channels; c++) {
+        *output++ = input[c * kernel_size + k];
+      }
+    }
+  }
+
+  MLAS_ACTIVATION dw_activation_;
+  MLAS_ACTIVATION activation_;
+  ConvAttributes conv_attrs_;
+  TensorShape W_dw_shape_;
+  TensorShape W_pw_shape_;
+  BufferUniquePtr reordered_W_dw_buffer_;
+  BufferUniquePtr packed_W_pw_buffer_;
+};
+
+Status NhwcFusedDepthwisePointwiseConv::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                                                /*out*/ bool& is_packed,
+                                                /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  const auto& shape = tensor.Shape();
+  if (shape.NumDimensions() <= 2) {
+    return Status::OK();
+  }
+
+  if (input_idx == 1) {
+    // Depthwise filter.
+    const size_t channels = static_cast<size_t>(shape[0]);
+    const size_t kernel_size = static_cast<size_t>(shape.SizeFromDimension(1));
+    if (shape[1] != 1 || static_cast<int64_t>(channels) != conv_attrs_.group) {
+      return Status::OK();
+    }
+
+    const size_t reordered_size = SafeInt<size_t>(sizeof(float)) * channels * kernel_size;
+    auto* reordered = static_cast<float*>(alloc->Alloc(reordered_size));
+    reordered_W_dw_buffer_ = BufferUniquePtr(reordered, BufferDeleter(alloc));
+    ReorderDepthwiseFilter(tensor.Data<float>(), reordered, channels, kernel_size);
+    W_dw_shape_ = shape;
+
+    if (prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(reordered_W_dw_buffer_));
+      prepacked_weights->buffer_sizes_.push_back(reordered_size);
+    }
+
+    is_packed = true;
+  } else if (input_idx == 3) {
+    // Pointwise filter, packed as the B matrix of the (pixels x C) x (C x M) GEMM.
+    const size_t output_channels = static_cast<size_t>(shape[0]);
+    const size_t input_channels = static_cast<size_t>(shape.SizeFromDimension(1));
+    if (static_cast<int64_t>(input_channels) != shape[1]) {
+      return Status::OK();
+    }
+
+    const size_t packed_size = MlasGemmPackBSize(output_channels, input_channels);
+    if (packed_size == 0) {
+      return Status::OK();
+    }
+
+    auto* packed = alloc->Alloc(packed_size);
+
+    // Initialize memory to 0 as there could be some padding associated with pre-packed
+    // buffer memory and we don not want it uninitialized and generate different hashes
+    // if and when we try to cache this pre-packed buffer for sharing between sessions.
+    memset(packed, 0, packed_size);
+
+    packed_W_pw_buffer_ = BufferUniquePtr(packed, BufferDeleter(alloc));
+    MlasGemmPackB(CblasTrans, output_channels, input_channels, tensor.Data<float>(), input_channels, packed);
+    W_pw_shape_ = shape;
+
+    if (prepacked_weights != nullptr) {
+      prepacked_weights->buffers_.push_back(std::move(packed_W_pw_buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_size);
+    }
+
+    is_packed = true;
+  }
+
+  return Status::OK();
+}
+
+Status NhwcFusedDepthwisePointwiseConv::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                                  int input_idx,
+                                                                  /*out*/ bool& used_shared_buffers) {
+  if (input_idx == 1) {
+    reordered_W_dw_buffer_ = std::move(prepacked_buffers[0]);
+    used_shared_buffers = true;
+  } else if (input_idx == 3) {
+    packed_W_pw_buffer_ = std::move(prepacked_buffers[0]);
+    used_shared_buffers = true;
+  }
+
+  return Status::OK();
+}
+
+Status NhwcFusedDepthwisePointwiseConv::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const Tensor* W_dw = reordered_W_dw_buffer_ ? nullptr : context->Input<Tensor>(1);
+  const Tensor* B_dw = context->Input<Tensor>(2);
+  const Tensor* W_pw = packed_W_pw_buffer_ ? nullptr : context->Input<Tensor>(3);
+  const Tensor* B_pw = context->Input<Tensor>(4);
+  const Tensor* Sum = context->Input<Tensor>(5);
+
+  const auto& W_dw_shape = W_dw ? W_dw->Shape() : W_dw_shape_;
+  const auto& W_pw_shape = W_pw ? W_pw->Shape() : W_pw_shape_;
+
+  const int64_t N = X->Shape()[0];
+  const int64_t C = W_dw_shape[0];
+  const int64_t M = W_pw_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_dw_shape, true));
+  ORT_RETURN_IF_NOT(W_dw_shape[1] == 1 && conv_attrs_.group == C,
+                    "The first convolution must be depthwise with a channel multiplier of 1.");
+  ORT_RETURN_IF_NOT(W_pw_shape.NumDimensions() == W_dw_shape.NumDimensions() && W_pw_shape[1] == C &&
+                        W_pw_shape.SizeFromDimension(2) == 1,
+                    "The second convolution must be pointwise. W_pw: ", W_pw_shape);
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_dw_shape, kernel_shape));
+  const size_t kernel_rank = kernel_shape.size();
+
+  ConvPadVector pads(conv_attrs_.pads);
+  if (pads.empty()) {
+    pads.resize(kernel_rank * 2, 0);
+  }
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_rank, 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_rank, 1);
+  }
+
+  TensorShapeVector Y_dims({N});
+  TensorShape input_shape = X->Shape().Slice(1, 1 + kernel_rank);
+  ORT_RETURN_IF_ERROR(conv_attrs_.InferPadsAndOutputShape(input_shape, kernel_shape, strides, dilations, pads, Y_dims));
+  Y_dims.push_back(M);
+  Tensor* Y = context->Output(0, TensorShape(Y_dims));
+  TensorShape output_shape = Y->Shape().Slice(1, 1 + kernel_rank);
+
+  // Bail out early if one of the dimensions is zero.
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+  if (Sum && Sum->Shape() != Y->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Z shape does not match output shape.",
+                           " Z: ", Sum->Shape().ToString().c_str(),
+                           " Output: ", Y->Shape().ToString().c_str());
+  }
+
+  const int64_t input_image_size = input_shape.Size();
+  const int64_t output_image_size = output_shape.Size();
+  const int64_t kernel_size = TensorShape(kernel_shape).Size();
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // Handle the case of dynamic filters.
+  BufferUniquePtr reordered_W_dw_buffer;
+  const float* reordered_W_dw = static_cast<const float*>(reordered_W_dw_buffer_.get());
+  if (reordered_W_dw == nullptr) {
+    auto* reordered = static_cast<float*>(alloc->Alloc(SafeInt<size_t>(sizeof(float)) * W_dw_shape.Size()));
+    reordered_W_dw_buffer = BufferUniquePtr(reordered, BufferDeleter(alloc));
+    ReorderDepthwiseFilter(W_dw->Data<float>(), reordered, static_cast<size_t>(C), static_cast<size_t>(kernel_size));
+    reordered_W_dw = reordered;
+  }
+
+  const auto* Xdata = X->Data<float>();
+  const auto* B_dw_data = B_dw != nullptr ? B_dw->Data<float>() : nullptr;
+  const auto* W_pw_data = W_pw != nullptr ? W_pw->Data<float>() : nullptr;
+  const auto* B_pw_data = B_pw != nullptr ? B_pw->Data<float>() : nullptr;
+  auto* Ydata = Y->MutableData<float>();
+  const auto* sum_data = Sum != nullptr ? Sum->Data<float>() : nullptr;
+
+  // Size the tiles so that the depthwise output of a tile fits in the L1 cache.
+  const int64_t tile_size = std::clamp<int64_t>(int64_t{8192} / C, 4, 256);
+  const int64_t tile_count = (output_image_size + tile_size - 1) / tile_size;
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+  const int64_t thread_count = std::min<int64_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool),
+                                                 tile_count);
+
+  // Per thread indirection buffer and depthwise output tile.
+  const size_t indirection_size = SafeInt<size_t>(kernel_size) * tile_size;
+  const size_t tile_buffer_size = SafeInt<size_t>(C) * tile_size;
+  auto* indirection_data = alloc->Alloc(SafeInt<size_t>(sizeof(const float*)) * indirection_size * thread_count);
+  BufferUniquePtr indirection_buffer(indirection_data, BufferDeleter(alloc));
+  auto* tile_data = alloc->Alloc(SafeInt<size_t>(sizeof(float)) * tile_buffer_size * thread_count);
+  BufferUniquePtr tile_buffer(tile_data, BufferDeleter(alloc));
+  std::vector<float> padding_data(static_cast<size_t>(C), 0.0f);
+
+  for (int64_t image_id = 0; image_id < N; ++image_id) {
+    auto worker = [&](ptrdiff_t thread_id) {
+      auto* worker_indirection = static_cast<const float**>(indirection_buffer.get()) + thread_id * indirection_size;
+      auto* worker_tile = static_cast<float*>(tile_buffer.get()) + thread_id * tile_buffer_size;
+
+      const auto work = concurrency::ThreadPool::PartitionWork(thread_id, static_cast<std::ptrdiff_t>(thread_count),
+                                                               static_cast<std::ptrdiff_t>(tile_count));
+
+      for (std::ptrdiff_t tile = work.start; tile < work.end; tile++) {
+        const int64_t output_start = tile * tile_size;
+        const int64_t output_count = std::min(tile_size, output_image_size - output_start);
+
+        math::Im2col<float, StorageOrder::NHWC>()(
+            Xdata,
+            C,
+            input_shape.GetDims().data(),
+            output_shape.GetDims().data(),
+            kernel_shape.data(),
+            strides.data(),
+            dilations.data(),
+            pads.data(),
+            static_cast<ptrdiff_t>(kernel_rank),
+            output_start,
+            output_count,
+            worker_indirection,
+            padding_data.data());
+
+        MlasConvDepthwise(
+            worker_indirection,
+            reordered_W_dw,
+            B_dw_data,
+            worker_tile,
+            static_cast<size_t>(C),
+            static_cast<size_t>(output_count),
+            static_cast<size_t>(kernel_size));
+
+        if (dw_activation_.ActivationKind != MlasIdentityActivation) {
+          MlasActivation(&dw_activation_, worker_tile, nullptr,
+                         static_cast<size_t>(output_count),
+                         static_cast<size_t>(C),
+                         static_cast<size_t>(C));
+        }
+
+        auto* worker_output = Ydata + output_start * M;
+
+        // Seed the output with Z so that the GEMM accumulates on top of it.
+        if (sum_data != nullptr) {
+          std::copy_n(sum_data + output_start * M, output_count * M, worker_output);
+        }
+
+        MLAS_SGEMM_DATA_PARAMS gemm_params;
+        gemm_params.A = worker_tile;
+        gemm_params.lda = static_cast<size_t>(C);
+        if (packed_W_pw_buffer_) {
+          gemm_params.B = static_cast<const float*>(packed_W_pw_buffer_.get());
+          gemm_params.BIsPacked = true;
+        } else {
+          gemm_params.B = W_pw_data;
+          gemm_params.ldb = static_cast<size_t>(C);
+        }
+        gemm_params.C = worker_output;
+        gemm_params.ldc = static_cast<size_t>(M);
+        gemm_params.beta = sum_data != nullptr ? 1.0f : 0.0f;
+
+        MlasGemm(
+            CblasNoTrans,
+            CblasTrans,
+            static_cast<size_t>(output_count),
+            static_cast<size_t>(M),
+            static_cast<size_t>(C),
+            gemm_params,
+            nullptr);
+
+        if (B_pw_data != nullptr) {
+          auto* output_row = worker_output;
+          for (int64_t i = 0; i < output_count; i++) {
+            for (int64_t m = 0; m < M; m++) {
+              output_row[m] += B_pw_data[m];
+            }
+            output_row += M;
+          }
+        }
+
+        if (activation_.ActivationKind != MlasIdentityActivation) {
+          MlasActivation(&activation_, worker_output, nullptr,
+                         static_cast<size_t>(output_count),
+                         static_cast<size_t>(M),
+                         static_cast<size_t>(M));
+        }
+      }
+    };
+
+    concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, static_cast<std::ptrdiff_t>(thread_count), worker);
+
+    Xdata += input_image_size * C;
+    Ydata += output_image_size * M;
+    if (sum_data != nullptr) {
+      sum_data += output_image_size * M;
+    }
+  }
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    NhwcFusedDepthwisePointwiseConv,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NhwcFusedDepthwisePointwiseConv);
+
+}  // namespace contrib
+}  // namespace onnxruntime
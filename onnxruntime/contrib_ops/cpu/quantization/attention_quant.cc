@@ -32,6 +32,10 @@ class QAttention : public OpKernel, public AttentionCPUBase {
                                    /*out*/ bool& used_shared_buffers) override;
 
  private:
+  Status ApplyQuantizedAttention(const T* Q, const T* K, const T* V, const T* qkv_scale, const Tensor* mask_index,
+                                 Tensor* output, int batch_size, int sequence_length, int head_size,
+                                 int hidden_size, OpKernelContext* context) const;
+
   IAllocatorUniquePtr<void> packed_weights_;
   size_t packed_weights_size_;
   TensorShape weight_shape_;
@@ -141,6 +145,7 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
   //   Input  6 - input_zero_point  : scalar
   //   Input  7 - weight_zero_point : scalar for per tensor quantization, (3 * hidden_size) for per column quantization
   //   Input  8 - past              : (2, batch_size, num_heads, past_sequence_length, head_size)
+  //   Input  9 - qkv_scale         : (3)
   //   Output 0                     : (batch_size, sequence_length, hidden_size)
   //   Output 1 - present           : (2, batch_size, num_heads, past_sequence_length + sequence_length, head_size)
   //   ORT_RETURN_IF_ERROR(CheckInputs(context));
@@ -153,6 +158,7 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* i_zp_tensor = context->Input<Tensor>(6);
   const Tensor* w_zp_tensor = context->Input<Tensor>(7);
   const Tensor* past_tensor = context->Input<Tensor>(8);
+  const Tensor* qkv_scale_tensor = context->Input<Tensor>(9);
 
   const TensorShape& weights_shape = (packed_weights_ ? weight_shape_ : weights->Shape());
   ORT_RETURN_IF_ERROR(AttentionBase::CheckInputs(input->Shape(),
@@ -168,6 +174,11 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
                     "input scale must be a scalar or 1D tensor of size 1");
   T input_scale = *(input_scale_tensor->Data<T>());
 
+  if (qkv_scale_tensor != nullptr) {
+    ORT_RETURN_IF_NOT(qkv_scale_tensor->Shape().NumDimensions() == 1 && qkv_scale_tensor->Shape()[0] == 3,
+                      "qkv_scale must be a 1D tensor of size 3");
+  }
+
   bool is_weight_scale_per_column = !IsScalarOr1ElementVector(weight_scale_tensor);
   const T* weight_scale_data = weight_scale_tensor->Data<T>();
 
@@ -287,6 +298,12 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
     MlasGemmBatch(gemm_shape, gemm_data_vec.data(), loop_len, tp);
   }
 
+  // The integer attention does not read a past state, and the float attention is used with one.
+  if (qkv_scale_tensor != nullptr && past_tensor == nullptr) {
+    return ApplyQuantizedAttention(Q, K, V, qkv_scale_tensor->Data<T>(), mask_index, output,
+                                   batch_size, sequence_length, head_size, hidden_size, context);
+  }
+
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q, K, V, mask_index, past_tensor, nullptr /* past_key */, nullptr /* past_value*/,
                         output, nullptr /* present_key */, nullptr /* present_value */,
@@ -294,5 +311,141 @@ Status QAttention<T>::Compute(OpKernelContext* context) const {
                         head_size, head_size, hidden_size, nullptr /* rel_pos_bias */, context);
 }
 
+// Attention with Q, K and V quantized with their calibrated scales, Q to uint8 with a zero point of 128 and K and V
+// to symmetric int8, per batch and head:
+//   scores(S, S) = alpha x scale_Q x scale_K x (Q_q(S, H) x K_q'(H, S)) + mask(S, S)
+//   probs(S, S) = Softmax(scores), quantized to uint8 with a scale of 1/255 as it is in [0, 1]
+//   output(S, H) = scale_V / 255 x (probs_q(S, S) x V_q(S, H))
+// Both products are integer GEMMs with int32 accumulation, and their output processors write the float results.
+template <typename T>
+Status QAttention<T>::ApplyQuantizedAttention(const T* Q, const T* K, const T* V, const T* qkv_scale,
+                                              const Tensor* mask_index, Tensor* output,
+                                              int batch_size, int sequence_length, int head_size,
+                                              int hidden_size, OpKernelContext* context) const {
+  const float q_scale = qkv_scale[0];
+  const float k_scale = qkv_scale[1];
+  const float v_scale = qkv_scale[2];
+  ORT_RETURN_IF_NOT(q_scale > 0.0f && k_scale > 0.0f && v_scale > 0.0f, "qkv_scale must be positive");
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  // The present state without past is the K and V computed by this node, which are contiguous in the gemm buffer.
+  int past_sequence_length = 0;
+  Tensor* present = GetPresent(context, nullptr, batch_size, head_size, sequence_length, past_sequence_length);
+  if (present != nullptr) {
+    memcpy(present->MutableData<T>(), K, SafeInt<size_t>(2) * batch_size * sequence_length * hidden_size * sizeof(T));
+  }
+
+  const bool causal = is_unidirectional_ && sequence_length > 1;
+  T* mask_data = nullptr;
+  if (mask_index != nullptr || causal) {
+    size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * sequence_length * sizeof(T);
+    mask_data = static_cast<T*>(allocator->Alloc(mask_data_bytes));
+    memset(mask_data, 0, mask_data_bytes);
+    PrepareMask(mask_index != nullptr ? mask_index->Data<int32_t>() : nullptr,
+                mask_index != nullptr ? mask_index->Shape().GetDims() : gsl::span<const int64_t>{},
+                mask_data, causal, batch_size, sequence_length, 0, mask_filter_value_);
+  }
+  BufferUniquePtr mask_data_buffer(mask_data, BufferDeleter(allocator));
+
+  const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+  const float qk_scale = alpha * q_scale * k_scale;
+  const float pv_scale = v_scale / 255.0f;
+  constexpr uint8_t q_zero_point = 128;
+  constexpr uint8_t kv_zero_point = 0;
+
+  const size_t qkv_chunk_length = static_cast<size_t>(sequence_length) * head_size;    // S x H
+  const size_t scores_length = static_cast<size_t>(sequence_length) * sequence_length;  // S x S
+
+  MLAS_GEMM_QUANT_SHAPE_PARAMS qk_shape;
+  qk_shape.M = sequence_length;
+  qk_shape.N = sequence_length;
+  qk_shape.K = head_size;
+  qk_shape.BIsSigned = true;
+
+  MLAS_GEMM_QUANT_SHAPE_PARAMS pv_shape;
+  pv_shape.M = sequence_length;
+  pv_shape.N = head_size;
+  pv_shape.K = sequence_length;
+  pv_shape.BIsSigned = true;
+
+  TensorOpCost unit_cost;
+  unit_cost.compute_cycles = static_cast<double>(4 * scores_length * head_size);
+  unit_cost.bytes_loaded = static_cast<double>(3 * qkv_chunk_length * sizeof(T));
+  unit_cost.bytes_stored = static_cast<double>(qkv_chunk_length * sizeof(T));
+
+  auto* tp = context->GetOperatorThreadPool();
+  const std::ptrdiff_t loop_len = SafeInt<std::ptrdiff_t>(batch_size) * num_heads_;
+  ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    // Scratch buffers of the heads processed by this thread.
+    auto q_quant = IAllocator::MakeUniquePtr<uint8_t>(allocator, qkv_chunk_length);
+    auto k_quant = IAllocator::MakeUniquePtr<int8_t>(allocator, qkv_chunk_length);
+    auto k_quant_transposed = IAllocator::MakeUniquePtr<int8_t>(allocator, qkv_chunk_length);
+    auto v_quant = IAllocator::MakeUniquePtr<int8_t>(allocator, qkv_chunk_length);
+    auto scores = IAllocator::MakeUniquePtr<float>(allocator, scores_length);
+    auto probs_quant = IAllocator::MakeUniquePtr<uint8_t>(allocator, scores_length);
+    auto pv_accumulator = IAllocator::MakeUniquePtr<int32_t>(allocator, qkv_chunk_length);
+
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const int batch_index = static_cast<int>(i / num_heads_);
+      const int head_index = static_cast<int>(i % num_heads_);
+
+      MlasQuantizeLinear(Q + qkv_chunk_length * i, q_quant.get(), qkv_chunk_length, q_scale, q_zero_point);
+      MlasQuantizeLinear(K + qkv_chunk_length * i, k_quant.get(), qkv_chunk_length, k_scale,
+                         static_cast<int8_t>(kv_zero_point));
+      MlasQuantizeLinear(V + qkv_chunk_length * i, v_quant.get(), qkv_chunk_length, v_scale,
+                         static_cast<int8_t>(kv_zero_point));
+      for (int s = 0; s < sequence_length; s++) {
+        for (int h = 0; h < head_size; h++) {
+          k_quant_transposed.get()[static_cast<size_t>(h) * sequence_length + s] =
+              k_quant.get()[static_cast<size_t>(s) * head_size + h];
+        }
+      }
+
+      // The scores are written as float over their int32 accumulators.
+      MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR qk_output(scores.get(), sequence_length, &qk_scale, nullptr);
+      MLAS_GEMM_QUANT_DATA_PARAMS qk_params;
+      qk_params.A = q_quant.get();
+      qk_params.lda = head_size;
+      qk_params.ZeroPointA = q_zero_point;
+      qk_params.B = k_quant_transposed.get();
+      qk_params.ldb = sequence_length;
+      qk_params.ZeroPointB = &kv_zero_point;
+      qk_params.C = reinterpret_cast<int32_t*>(scores.get());
+      qk_params.ldc = sequence_length;
+      qk_params.OutputProcessor = &qk_output;
+      MlasGemm(qk_shape, qk_params, nullptr);
+
+      if (mask_data != nullptr) {
+        const T* mask = mask_data + scores_length * batch_index;
+        for (size_t j = 0; j < scores_length; j++) {
+          scores.get()[j] += mask[j];
+        }
+      }
+      ComputeAttentionSoftmaxInplace(scores.get(), sequence_length, sequence_length, nullptr);
+      MlasQuantizeLinear(scores.get(), probs_quant.get(), scores_length, 1.0f / 255.0f, uint8_t{0});
+
+      // out(B, S, N, H) with the rows of this head strided by the hidden size
+      T* out = output->MutableData<T>() +
+               SafeInt<size_t>(batch_index) * sequence_length * hidden_size + static_cast<size_t>(head_index) * head_size;
+      MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR pv_output(out, hidden_size, &pv_scale, nullptr);
+      MLAS_GEMM_QUANT_DATA_PARAMS pv_params;
+      pv_params.A = probs_quant.get();
+      pv_params.lda = sequence_length;
+      pv_params.ZeroPointA = 0;
+      pv_params.B = v_quant.get();
+      pv_params.ldb = head_size;
+      pv_params.ZeroPointB = &kv_zero_point;
+      pv_params.C = pv_accumulator.get();
+      pv_params.ldc = head_size;
+      pv_params.OutputProcessor = &pv_output;
+      MlasGemm(pv_shape, pv_params, nullptr);
+    }
+  });
+
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -0,0 +1,312 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "core/common/narrow.h"
+#include "core/providers/cpu/rnn/deep_cpu_gru.h"
+#include "core/providers/cpu/rnn/rnn_helpers.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+using namespace rnn::detail;
+
+/**
+ * @brief GRU with 8-bit weights, computed with the MLAS quantized GEMM.
+ *
+ * The inputs and hidden states are quantized on the fly (like DynamicQuantizeLSTM), so only the
+ * weights need to be quantized offline. W and R are stored transposed compared to GRU:
+ * [num_directions, input_size, 3*hidden_size] and [num_directions, hidden_size, 3*hidden_size].
+ */
+class DynamicQuantizeGRU : public OpKernel, public GRUBase {
+ public:
+  DynamicQuantizeGRU(const OpKernelInfo& info) : OpKernel(info), GRUBase(info) {}
+
+  Status PrePack(const Tensor& tensor, int input_idx,
+                 AllocatorPtr alloc, /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+  ~DynamicQuantizeGRU() override = default;
+
+ private:
+  bool TryPackInputWeights(const Tensor& weights, AllocatorPtr& alloc);
+
+  bool TryPackRecurrentWeights(const Tensor& weights, AllocatorPtr& alloc);
+
+  PackedWeights packed_W_;
+  // R[zr] and R[h] are packed separately, as the recurrence computes them in two GEMMs
+  PackedWeights packed_R_ZR_;
+  PackedWeights packed_R_H_;
+  bool is_W_signed_{false};
+  bool is_R_signed_{false};
+};
+
+static void PackQuantizedB(size_t N, size_t K, const uint8_t* weights_data, size_t ldb, bool is_signed,
+                           int num_directions, size_t direction_stride, PackedWeights& packed_weights,
+                           const TensorShape& shape, AllocatorPtr& alloc) {
+  const size_t packed_weights_size = MlasGemmPackBSize(N, K, false /*AIsSigned*/, is_signed);
+  const size_t packed_weights_data_size = SafeInt<size_t>(packed_weights_size) * num_directions;
+  packed_weights.buffer_ = IAllocator::MakeUniquePtr<void>(alloc, packed_weights_data_size, true);
+
+  auto* packed_weights_data = packed_weights.buffer_.get();
+
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we don not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_weights_data, 0, packed_weights_data_size);
+
+  packed_weights.buffer_size_ = packed_weights_data_size;
+  packed_weights.weights_size_ = packed_weights_size;
+  packed_weights.shape_ = shape;
+
+  for (int i = 0; i < num_directions; i++) {
+    MlasGemmPackB(N, K, weights_data, ldb, false /*AIsSigned*/, is_signed, packed_weights_data);
+    packed_weights_data = static_cast<uint8_t*>(packed_weights_data) + packed_weights_size;
+    weights_data += direction_stride;
+  }
+}
+
+bool DynamicQuantizeGRU::TryPackInputWeights(const Tensor& weights, AllocatorPtr& alloc) {
+  // weights: [num_directions, input_size, 3*hidden_size]
+  const auto& shape = weights.Shape();
+  if (shape.NumDimensions() != 3 || shape[0] != num_directions_ || shape[2] != static_cast<int64_t>(hidden_size_) * 3) {
+    return false;
+  }
+
+  const size_t K = static_cast<size_t>(shape[1]);
+  const size_t N = static_cast<size_t>(shape[2]);
+
+  is_W_signed_ = weights.IsDataType<int8_t>();
+  if (MlasGemmPackBSize(N, K, false /*AIsSigned*/, is_W_signed_) == 0) {
+    return false;
+  }
+
+  PackQuantizedB(N, K, static_cast<const uint8_t*>(weights.DataRaw()), N, is_W_signed_, num_directions_, N * K,
+                 packed_W_, shape, alloc);
+  return true;
+}
+
+bool DynamicQuantizeGRU::TryPackRecurrentWeights(const Tensor& weights, AllocatorPtr& alloc) {
+  // recurrence weights: [num_directions, hidden_size, 3*hidden_size]
+  const auto& shape = weights.Shape();
+  if (shape.NumDimensions() != 3 || shape[0] != num_directions_ || shape[1] != hidden_size_ ||
+      shape[2] != static_cast<int64_t>(hidden_size_) * 3) {
+    return false;
+  }
+
+  const size_t K = static_cast<size_t>(hidden_size_);
+  const size_t ldb = 3 * K;
+
+  is_R_signed_ = weights.IsDataType<int8_t>();
+  if (MlasGemmPackBSize(2 * K, K, false /*AIsSigned*/, is_R_signed_) == 0 ||
+      MlasGemmPackBSize(K, K, false /*AIsSigned*/, is_R_signed_) == 0) {
+    return false;
+  }
+
+  // R[zr] are the first 2*hidden_size columns of R, and R[h] the last hidden_size columns
+  const auto* weights_data = static_cast<const uint8_t*>(weights.DataRaw());
+  PackQuantizedB(2 * K, K, weights_data, ldb, is_R_signed_, num_directions_, K * ldb, packed_R_ZR_, shape, alloc);
+  PackQuantizedB(K, K, weights_data + 2 * K, ldb, is_R_signed_, num_directions_, K * ldb, packed_R_H_, shape, alloc);
+  return true;
+}
+
+Status DynamicQuantizeGRU::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                                   /*out*/ bool& is_packed,
+                                   /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  const bool share_prepacked_weights = (prepacked_weights != nullptr);
+
+  if (input_idx == 1) {
+    is_packed = TryPackInputWeights(tensor, alloc);
+    if (is_packed && share_prepacked_weights) {
+      prepacked_weights->buffers_.push_back(std::move(packed_W_.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_W_.buffer_size_);
+    }
+  } else if (input_idx == 2) {
+    is_packed = TryPackRecurrentWeights(tensor, alloc);
+    if (is_packed && share_prepacked_weights) {
+      prepacked_weights->buffers_.push_back(std::move(packed_R_ZR_.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_R_ZR_.buffer_size_);
+      prepacked_weights->buffers_.push_back(std::move(packed_R_H_.buffer_));
+      prepacked_weights->buffer_sizes_.push_back(packed_R_H_.buffer_size_);
+    }
+  }
+
+  return Status::OK();
+}
+
+Status DynamicQuantizeGRU::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                     int input_idx,
+                                                     /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    packed_W_.buffer_ = std::move(prepacked_buffers[0]);
+    used_shared_buffers = true;
+  } else if (input_idx == 2) {
+    packed_R_ZR_.buffer_ = std::move(prepacked_buffers[0]);
+    packed_R_H_.buffer_ = std::move(prepacked_buffers[1]);
+    used_shared_buffers = true;
+  }
+
+  return Status::OK();
+}
+
+// Scales and zero points are either per direction, or per direction and output channel (3*hidden_size).
+// MLAS applies a single zero point to the weights, so per channel zero points must all be equal, and zero
+// for signed weights.
+static Status ValidateQuantizationParameters(const Tensor& scale, const Tensor& zero_point, bool is_signed,
+                                             int64_t num_directions, int64_t hidden_size, const char* name) {
+  for (const auto* shape : {&scale.Shape(), &zero_point.Shape()}) {
+    if ((shape->NumDimensions() != 1 && shape->NumDimensions() != 2) ||
+        (shape->NumDimensions() == 2 && (*shape)[1] != hidden_size * 3) ||
+        (*shape)[0] != num_directions) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "DynamicQuantizeGRU : ", name,
+                             " scale and zero point must have shape {", num_directions,
+                             "} for per-tensor/layer quantization or shape {", num_directions, ", 3*", hidden_size,
+                             "} for per-channel quantization. Actual:", *shape);
+    }
+  }
+
+  if (scale.Shape() != zero_point.Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "DynamicQuantizeGRU : ", name,
+                           " scale and zero point must have the same shape");
+  }
+
+  const auto* zp_data = static_cast<const uint8_t*>(zero_point.DataRaw());
+  const int64_t zp_size = zero_point.Shape().Size();
+  for (int64_t i = 0; i < zp_size; i++) {
+    if (is_signed ? zp_data[i] != 0 : zp_data[i] != zp_data[0]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "DynamicQuantizeGRU : ", name,
+                             is_signed ? " zero point must be zero" : " zero point must be constant");
+    }
+  }
+
+  return Status::OK();
+}
+
+Status DynamicQuantizeGRU::Compute(OpKernelContext* context) const {
+  const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
+  // weights. [num_directions, input_size, 3*hidden_size]
+  const Tensor* W = packed_W_.buffer_ ? nullptr : context->Input<Tensor>(1);
+  // recurrence weights. [num_directions, hidden_size, 3*hidden_size]
+  const Tensor* R = packed_R_ZR_.buffer_ ? nullptr : context->Input<Tensor>(2);
+
+  const auto& W_shape = (W != nullptr) ? W->Shape() : packed_W_.shape_;
+  const auto& R_shape = (R != nullptr) ? R->Shape() : packed_R_ZR_.shape_;
+  ORT_RETURN_IF_NOT(W_shape.NumDimensions() == 3 && R_shape.NumDimensions() == 3,
+                    "DynamicQuantizeGRU : W and R must have 3 dimensions. Actual:", W_shape, " and ", R_shape);
+
+  // validate against the layout of GRU's weights
+  const TensorShape gru_W_shape{W_shape[0], W_shape[2], W_shape[1]};
+  const TensorShape gru_R_shape{R_shape[0], R_shape[2], R_shape[1]};
+  ORT_RETURN_IF_ERROR(ValidateCommonRnnInputs(X, gru_W_shape, gru_R_shape, context->Input<Tensor>(3), 3,
+                                              context->Input<Tensor>(4), context->Input<Tensor>(5),
+                                              num_directions_, hidden_size_));
+
+  const Tensor* w_scale = context->Input<Tensor>(6);
+  const Tensor* w_zp = context->Input<Tensor>(7);
+  const Tensor* r_scale = context->Input<Tensor>(8);
+  const Tensor* r_zp = context->Input<Tensor>(9);
+
+  const bool is_W_signed = (W != nullptr) ? W->IsDataType<int8_t>() : is_W_signed_;
+  const bool is_R_signed = (R != nullptr) ? R->IsDataType<int8_t>() : is_R_signed_;
+
+  ORT_RETURN_IF_ERROR(ValidateQuantizationParameters(*w_scale, *w_zp, is_W_signed, num_directions_, hidden_size_, "W"));
+  ORT_RETURN_IF_ERROR(ValidateQuantizationParameters(*r_scale, *r_zp, is_R_signed, num_directions_, hidden_size_, "R"));
+
+  const size_t hidden_size = static_cast<size_t>(hidden_size_);
+  const bool W_per_channel = w_scale->Shape().NumDimensions() == 2;
+  const bool R_per_channel = r_scale->Shape().NumDimensions() == 2;
+  const size_t W_scale_size = W_per_channel ? 3 * hidden_size : 1;
+  const size_t R_scale_size = R_per_channel ? 3 * hidden_size : 1;
+
+  const float* W_scale_data = w_scale->Data<float>();
+  const float* R_scale_data = r_scale->Data<float>();
+  const auto* W_zp_data = static_cast<const uint8_t*>(w_zp->DataRaw());
+  const auto* R_zp_data = static_cast<const uint8_t*>(r_zp->DataRaw());
+
+  // R[zr] and R[h] use the first 2*hidden_size and the last hidden_size per-channel scales
+  QuantizationParameter quant_para_W[2] = {
+      {W_scale_data, W_zp_data, is_W_signed, W_scale_size},
+      {W_scale_data, W_zp_data, is_W_signed, W_scale_size}};
+  QuantizationParameter quant_para_R_ZR[2] = {
+      {R_scale_data, R_zp_data, is_R_signed, R_per_channel ? 2 * hidden_size : 1},
+      {R_scale_data, R_zp_data, is_R_signed, R_per_channel ? 2 * hidden_size : 1}};
+  QuantizationParameter quant_para_R_H[2] = {
+      {R_scale_data + (R_per_channel ? 2 * hidden_size : 0), R_zp_data, is_R_signed, R_per_channel ? hidden_size : 1},
+      {R_scale_data + (R_per_channel ? 2 * hidden_size : 0), R_zp_data, is_R_signed, R_per_channel ? hidden_size : 1}};
+  if (direction_ == Direction::kBidirectional) {
+    quant_para_W[1].scale += W_scale_size;
+    quant_para_W[1].zero_point += W_scale_size;  // zero_point and scale have same size
+    quant_para_R_ZR[1].scale += R_scale_size;
+    quant_para_R_ZR[1].zero_point += R_scale_size;
+    quant_para_R_H[1].scale += R_scale_size;
+    quant_para_R_H[1].zero_point += R_scale_size;
+  }
+
+  const uint8_t* W_data = W != nullptr ? static_cast<const uint8_t*>(W->DataRaw()) : nullptr;
+  const size_t W_size_per_direction = SafeInt<size_t>(W_shape[1]) * W_shape[2];
+
+  // Without prepacking R[zr] and R[h] are copied out of R, so that each of them is a contiguous matrix
+  const size_t R_ZR_size_per_direction = 2 * hidden_size * hidden_size;
+  const size_t R_H_size_per_direction = hidden_size * hidden_size;
+  IAllocatorUniquePtr<uint8_t> R_split_buffer;
+  const uint8_t* R_ZR_data = nullptr;
+  const uint8_t* R_H_data = nullptr;
+  if (R != nullptr) {
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+    R_split_buffer = IAllocator::MakeUniquePtr<uint8_t>(
+        alloc, SafeInt<size_t>(R_ZR_size_per_direction + R_H_size_per_direction) * num_directions_);
+
+    uint8_t* R_ZR_split = R_split_buffer.get();
+    uint8_t* R_H_split = R_ZR_split + R_ZR_size_per_direction * num_directions_;
+    const auto* R_data = static_cast<const uint8_t*>(R->DataRaw());
+    for (size_t row = 0, rows = hidden_size * num_directions_; row < rows; ++row) {
+      const uint8_t* src = R_data + row * 3 * hidden_size;
+      std::copy_n(src, 2 * hidden_size, R_ZR_split + row * 2 * hidden_size);
+      std::copy_n(src + 2 * hidden_size, hidden_size, R_H_split + row * hidden_size);
+    }
+    R_ZR_data = R_ZR_split;
+    R_H_data = R_H_split;
+  }
+
+  GemmWeights<uint8_t> W_1(0, W_data, W_size_per_direction, packed_W_, &quant_para_W[0]);
+  GemmWeights<uint8_t> R_ZR_1(0, R_ZR_data, R_ZR_size_per_direction, packed_R_ZR_, &quant_para_R_ZR[0]);
+  GemmWeights<uint8_t> R_H_1(0, R_H_data, R_H_size_per_direction, packed_R_H_, &quant_para_R_H[0]);
+
+  GemmWeights<uint8_t> W_2;
+  GemmWeights<uint8_t> R_ZR_2;
+  GemmWeights<uint8_t> R_H_2;
+  if (direction_ == Direction::kBidirectional) {
+    W_2.Init(1, W_data, W_size_per_direction, packed_W_, &quant_para_W[1]);
+    R_ZR_2.Init(1, R_ZR_data, R_ZR_size_per_direction, packed_R_ZR_, &quant_para_R_ZR[1]);
+    R_H_2.Init(1, R_H_data, R_H_size_per_direction, packed_R_H_, &quant_para_R_H[1]);
+  }
+
+  return GRUBase::ComputeImpl<float, uint8_t>(*context, W_1, W_2, R_ZR_1, R_ZR_2, R_H_1, R_H_2);
+}
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DynamicQuantizeGRU,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int32_t>())
+        .TypeConstraint("T2", {DataTypeImpl::GetTensorType<uint8_t>(), DataTypeImpl::GetTensorType<int8_t>()}),
+    DynamicQuantizeGRU);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "contrib_ops/cpu/fused_activation.h"
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
 #include "core/mlas/inc/mlas.h"
@@ -54,7 +55,9 @@ class MatMulIntegerToFloatBase : public MatMulIntegerBase {
                        const Tensor* b_tensor,
                        const Tensor* b_scale,
                        const Tensor* b_zp,
-                       const Tensor* bias_tensor) const;
+                       const Tensor* bias_tensor,
+                       const MLAS_ACTIVATION* activation = nullptr,
+                       const Tensor* residual_tensor = nullptr) const;
 };
 
 Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
@@ -66,7 +69,9 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
                                                const Tensor* b_tensor,
                                                const Tensor* b_scale_tensor,
                                                const Tensor* b_zp_tensor,
-                                               const Tensor* bias_tensor) const {
+                                               const Tensor* bias_tensor,
+                                               const MLAS_ACTIVATION* activation,
+                                               const Tensor* residual_tensor) const {
   MatMulComputeHelper helper;
   ORT_RETURN_IF_ERROR(helper.Compute(a_shape,
                                      b_tensor ? b_tensor->Shape() : b_shape_,
@@ -81,6 +86,14 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
   auto* y_data = y->MutableData<float>();
   const auto* bias_data = bias_tensor != nullptr ? bias_tensor->Data<float>() : nullptr;
 
+  if (residual_tensor != nullptr) {
+    ORT_RETURN_IF_NOT(residual_tensor->Shape() == y->Shape(), "residual shape ", residual_tensor->Shape(),
+                      " must match the output shape ", y->Shape());
+  }
+  const auto* residual_data = residual_tensor != nullptr ? residual_tensor->Data<float>() : nullptr;
+  const bool has_epilogue =
+      (activation != nullptr && activation->ActivationKind != MlasIdentityActivation) || residual_data != nullptr;
+
   // process zero point of b
   bool is_b_zp_per_column = false;
   uint8_t b_zp_default = 0;
@@ -125,6 +138,14 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
   gemm_shape.BIsSigned = b_tensor ? b_tensor->IsDataType<int8_t>() : b_is_signed_;
 
   const size_t num_gemms = helper.OutputOffsets().size();
+  // activation and residual add are applied to each output tile right after it is scaled
+  std::vector<MLAS_GEMM_EPILOGUE> gemm_epilogues(has_epilogue ? num_gemms : 0);
+  for (size_t gemm_idx = 0; gemm_idx < gemm_epilogues.size(); gemm_idx++) {
+    auto& epilogue = gemm_epilogues[gemm_idx];
+    epilogue.Activation = activation;
+    epilogue.Residual = residual_data != nullptr ? residual_data + helper.OutputOffsets()[gemm_idx] : nullptr;
+    epilogue.ldr = gemm_shape.N;
+  }
   std::vector<MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR> gemm_scale_procs;
   gemm_scale_procs.reserve(num_gemms);
   std::vector<MLAS_GEMM_QUANT_DATA_PARAMS> gemm_data_vec(num_gemms);
@@ -135,7 +156,8 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
                                   b_scale_data + helper.RightScaleOffsets()[gemm_idx],
                                   bias_data,
                                   MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
-                                  is_b_scale_per_column ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix);
+                                  is_b_scale_per_column ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix,
+                                  has_epilogue ? &gemm_epilogues[gemm_idx] : nullptr);
     auto& params = gemm_data_vec[gemm_idx];
     params.OutputProcessor = &(gemm_scale_procs[gemm_idx]);
     params.A = a_data + helper.LeftOffsets()[gemm_idx];
@@ -157,7 +179,9 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
 
 class DynamicQuantizeMatMul final : public MatMulIntegerToFloatBase {
  public:
-  DynamicQuantizeMatMul(const OpKernelInfo& info) : MatMulIntegerToFloatBase(info) {}
+  DynamicQuantizeMatMul(const OpKernelInfo& info) : MatMulIntegerToFloatBase(info) {
+    ORT_THROW_IF_ERROR(GetFusedActivationAttr(info, activation_));
+  }
 
   Status Compute(OpKernelContext* context) const override;
 
@@ -166,11 +190,15 @@ class DynamicQuantizeMatMul final : public MatMulIntegerToFloatBase {
     IN_B = 1,
     IN_B_SCALE = 2,
     IN_B_ZERO_POINT = 3,
-    IN_BIAS = 4
+    IN_BIAS = 4,
+    IN_RESIDUAL = 5
   };
 
  protected:
   int GetBIdx() const override { return IN_B; }
+
+ private:
+  MLAS_ACTIVATION activation_;
 };
 
 class MatMulIntegerToFloat final : public MatMulIntegerToFloatBase {
@@ -221,6 +249,7 @@ Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
   ParQuantizeLinearStd(a_data, a_data_quant, narrow<size_t>(num_of_elements), a_scale, a_zero_point, ctx->GetOperatorThreadPool());
 
   bool is_b_scale_supported = IsBQuantParamSupported(b_scale_tensor->Shape(), b ? b->Shape() : b_shape_);
+  const Tensor* residual_tensor = ctx->Input<Tensor>(IN_RESIDUAL);
   ORT_RETURN_IF_ERROR(ComputeCommon(
       ctx,
       a_data_quant,
@@ -231,10 +260,26 @@ Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
       b,
       is_b_scale_supported ? b_scale_tensor : nullptr,
       b_zp_tensor,
-      ctx->Input<Tensor>(IN_BIAS)));
+      ctx->Input<Tensor>(IN_BIAS),
+      is_b_scale_supported ? &activation_ : nullptr,
+      is_b_scale_supported ? residual_tensor : nullptr));
 
   if (!is_b_scale_supported) {
-    ScaleOutput(*b_scale_tensor, *ctx->Output<Tensor>(0));
+    Tensor& y = *ctx->Output<Tensor>(0);
+    ScaleOutput(*b_scale_tensor, y);
+
+    // the output is only complete after scaling, so apply the epilogue as a separate pass
+    if (y.Shape().Size() != 0 &&
+        (activation_.ActivationKind != MlasIdentityActivation || residual_tensor != nullptr)) {
+      ORT_RETURN_IF(residual_tensor != nullptr && residual_tensor->Shape() != y.Shape(),
+                    "residual shape ", residual_tensor->Shape(), " must match the output shape ", y.Shape());
+      const size_t N = y.Shape().NumDimensions() > 0 ? narrow<size_t>(y.Shape()[y.Shape().NumDimensions() - 1]) : 1;
+      MLAS_GEMM_EPILOGUE epilogue;
+      epilogue.Activation = &activation_;
+      epilogue.Residual = residual_tensor != nullptr ? residual_tensor->Data<float>() : nullptr;
+      epilogue.ldr = N;
+      MlasGemmEpilogue(&epilogue, y.MutableData<float>(), 0, 0, narrow<size_t>(y.Shape().Size()) / N, N, N);
+    }
   }
 
   return Status::OK();
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "contrib_ops/cpu/quantization/matmul_nbits_impl.h"
+#include "contrib_ops/cpu/fused_activation.h"
 
 #include <cstdint>
 #include <type_traits>
@@ -54,6 +55,85 @@ int64_t GetAccuracyLevel(size_t nbits, size_t block_size, int64_t accuracy_level
 
 #endif  // defined(ORT_NEURAL_SPEED)
 }
+
+// Adds the low rank update (A * lora_a[i]) * lora_b[i] to Y, where i is the adapter selected by lora_index for each
+// item of the leading dimension of A, so that requests batched together can use different adapters.
+Status AddLoraUpdate(const Tensor& a, const Tensor& lora_a, const Tensor& lora_b, const Tensor* lora_index,
+                     size_t K, size_t N, float* y_data, const AllocatorPtr& allocator,
+                     concurrency::ThreadPool* thread_pool) {
+  const auto& lora_a_shape = lora_a.Shape();
+  const auto& lora_b_shape = lora_b.Shape();
+  const size_t lora_rank = lora_a_shape.NumDimensions();
+  ORT_RETURN_IF_NOT((lora_rank == 2 || lora_rank == 3) && lora_b_shape.NumDimensions() == lora_rank &&
+                        lora_a_shape[lora_rank - 2] == static_cast<int64_t>(K) &&
+                        lora_b_shape[lora_rank - 1] == static_cast<int64_t>(N) &&
+                        lora_a_shape[lora_rank - 1] == lora_b_shape[lora_rank - 2] &&
+                        (lora_rank == 2 || lora_a_shape[0] == lora_b_shape[0]),
+                    "MatMulNBits lora_a shape ", lora_a_shape, " and lora_b shape ", lora_b_shape,
+                    " must be [num_adapters, K, rank] and [num_adapters, rank, N], or [K, rank] and [rank, N]");
+  const size_t num_adapters = lora_rank == 3 ? narrow<size_t>(lora_a_shape[0]) : 1;
+  const size_t rank = narrow<size_t>(lora_a_shape[lora_rank - 1]);
+
+  // without lora_index the single adapter is applied to all the rows of A at once
+  const auto& a_shape = a.Shape();
+  const size_t num_rows = narrow<size_t>(a_shape.SizeToDimension(a_shape.NumDimensions() - 1));
+  const size_t num_items = lora_index != nullptr && a_shape.NumDimensions() > 1 ? narrow<size_t>(a_shape[0]) : 1;
+  if (lora_index != nullptr) {
+    ORT_RETURN_IF_NOT(lora_index->Shape().Size() == static_cast<int64_t>(num_items),
+                      "MatMulNBits lora_index must have an adapter index for each of the ", num_items,
+                      " items of the leading dimension of A, got shape ", lora_index->Shape());
+  } else {
+    ORT_RETURN_IF_NOT(num_adapters == 1, "MatMulNBits lora_index is required with ", num_adapters, " adapters");
+  }
+  if (rank == 0 || num_rows == 0) {
+    return Status::OK();
+  }
+
+  const size_t rows_per_item = num_rows / num_items;
+  const float* a_data = a.Data<float>();
+  const float* lora_a_data = lora_a.Data<float>();
+  const float* lora_b_data = lora_b.Data<float>();
+  auto a_lora_a = IAllocator::MakeUniquePtr<float>(allocator, SafeInt<size_t>(num_rows) * rank);
+
+  // one GEMM of each batch per item using an adapter: [rows, K] x [K, rank], then [rows, rank] x [rank, N] added to Y
+  InlinedVector<MLAS_SGEMM_DATA_PARAMS> down(num_items);
+  InlinedVector<MLAS_SGEMM_DATA_PARAMS> up(num_items);
+  size_t batch_count = 0;
+  for (size_t item = 0; item < num_items; ++item) {
+    const int32_t adapter = lora_index == nullptr ? 0 : lora_index->Data<int32_t>()[item];
+    ORT_RETURN_IF_NOT(adapter >= -1 && adapter < static_cast<int32_t>(num_adapters),
+                      "MatMulNBits lora_index ", adapter, " is out of range [-1, ", num_adapters, ")");
+    if (adapter < 0) {
+      continue;
+    }
+
+    const size_t row = item * rows_per_item;
+    auto& d = down[batch_count];
+    d.A = a_data + row * K;
+    d.lda = K;
+    d.B = lora_a_data + static_cast<size_t>(adapter) * K * rank;
+    d.ldb = rank;
+    d.C = a_lora_a.get() + row * rank;
+    d.ldc = rank;
+
+    auto& u = up[batch_count];
+    u.A = d.C;
+    u.lda = rank;
+    u.B = lora_b_data + static_cast<size_t>(adapter) * rank * N;
+    u.ldb = N;
+    u.C = y_data + row * N;
+    u.ldc = N;
+    u.beta = 1.0f;
+    ++batch_count;
+  }
+
+  if (batch_count > 0) {
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, rows_per_item, rank, K, down.data(), batch_count, thread_pool);
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, rows_per_item, N, rank, up.data(), batch_count, thread_pool);
+  }
+
+  return Status::OK();
+}
 }  // namespace
 
 bool GetType(const NodeArg& node_arg, int32_t& type) {
@@ -79,7 +159,7 @@ class MatMulNBits final : public OpKernel {
     const auto& node = info.node();
     auto input_defs = node.InputDefs();
     // g_idx
-    if (input_defs.size() > 4) {
+    if (input_defs.size() > 4 && input_defs[4]->Exists()) {
       act_order_ = true;
     }
     int32_t type;
@@ -87,8 +167,13 @@ class MatMulNBits final : public OpKernel {
       zero_point_is_not_quant_ = type != ONNX_NAMESPACE::TensorProto_DataType_UINT8;
     }
 
-    ORT_ENFORCE(nbits_ == 4,
-                "Only 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
+    ORT_ENFORCE(nbits_ == 2 || nbits_ == 3 || nbits_ == 4,
+                "Only 2b, 3b and 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
+    // 2b and 3b quantization is only supported by the MLAS SQNBitGemm path, which requires uint8 zero points and
+    // does not support g_idx.
+    ORT_ENFORCE(nbits_ == 4 || (!act_order_ && !zero_point_is_not_quant_),
+                "MatMulNBits with ", nbits_, "b quantization does not support g_idx or float zero points.");
+    ORT_THROW_IF_ERROR(GetFusedActivationAttr(info, activation_));
 #ifdef ORT_NEURAL_SPEED
     const Tensor* tensor_B = nullptr;
     const Tensor* tensor_scale = nullptr;
@@ -96,9 +181,15 @@ class MatMulNBits final : public OpKernel {
     bool B_constant = info.TryGetConstantInput(1, &tensor_B);
     bool scale_constant = info.TryGetConstantInput(2, &tensor_scale);
     bool zero_point_constant = info.TryGetConstantInput(3, &tensor_zero_point);
-    is_asym_ = info.GetInputCount() >= 4;
+    is_asym_ = input_defs.size() > 3 && input_defs[3]->Exists();
     all_constant_ = B_constant && scale_constant;
     all_constant_ = is_asym_ ? all_constant_ && zero_point_constant : all_constant_;
+    // Neural Speed kernels have no epilogue, so use the fallback path when bias, activation, residual or a LoRA
+    // adapter is present.
+    const bool has_epilogue_inputs = (input_defs.size() > 5 && input_defs[5]->Exists()) ||
+                                     (input_defs.size() > 6 && input_defs[6]->Exists()) ||
+                                     (input_defs.size() > 7 && input_defs[7]->Exists());
+    all_constant_ = all_constant_ && !has_epilogue_inputs && activation_.ActivationKind == MlasIdentityActivation;
 #endif
   }
 
@@ -111,6 +202,8 @@ class MatMulNBits final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  bool CanSkipPrePackWithPersistedBuffers(int input_idx) const override;
+
  private:
   const size_t K_;
   const size_t N_;
@@ -120,6 +213,7 @@ class MatMulNBits final : public OpKernel {
   bool zero_point_is_not_quant_{false};
   const int64_t accuracy_level_;
   const bool column_wise_quant_{true};
+  MLAS_ACTIVATION activation_;
   IAllocatorUniquePtr<void> packed_b_;
   size_t packed_b_size_{0};
 
@@ -241,6 +335,16 @@ Status MatMulNBits::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+bool MatMulNBits::CanSkipPrePackWithPersistedBuffers(int input_idx) const {
+#if defined(ORT_NEURAL_SPEED)
+  // the scales and zero points are packed into the buffer of B, so it depends on several inputs
+  ORT_UNUSED_PARAMETER(input_idx);
+  return false;
+#else
+  return input_idx == 1 && !act_order_ && !zero_point_is_not_quant_;
+#endif  // defined(ORT_NEURAL_SPEED)
+}
+
 Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
   const Tensor* a = ctx->Input<Tensor>(0);
@@ -289,6 +393,11 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   const Tensor* scales = ctx->Input<Tensor>(2);
   const Tensor* zero_points = ctx->InputCount() > 3 ? ctx->Input<Tensor>(3) : nullptr;
   const Tensor* reorder_idx = ctx->InputCount() > 4 ? ctx->Input<Tensor>(4) : nullptr;
+  const Tensor* bias = ctx->InputCount() > 5 ? ctx->Input<Tensor>(5) : nullptr;
+  const Tensor* residual = ctx->InputCount() > 6 ? ctx->Input<Tensor>(6) : nullptr;
+  const Tensor* lora_a = ctx->InputCount() > 7 ? ctx->Input<Tensor>(7) : nullptr;
+  const Tensor* lora_b = ctx->InputCount() > 8 ? ctx->Input<Tensor>(8) : nullptr;
+  const Tensor* lora_index = ctx->InputCount() > 9 ? ctx->Input<Tensor>(9) : nullptr;
 
   const auto* scales_data = scales->Data<float>();
   const auto* zero_points_data = zero_points == nullptr ? nullptr : zero_points->DataRaw();
@@ -314,6 +423,27 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(false);
 
+  if (bias != nullptr) {
+    ORT_RETURN_IF_NOT(bias->Shape().Size() == static_cast<int64_t>(N),
+                      "MatMulNBits bias must have ", N, " elements, got shape ", bias->Shape());
+  }
+  if (residual != nullptr) {
+    ORT_RETURN_IF_NOT(residual->Shape() == y->Shape(),
+                      "MatMulNBits residual shape ", residual->Shape(), " must match the output shape ", y->Shape());
+  }
+  ORT_RETURN_IF_NOT((lora_a == nullptr) == (lora_b == nullptr), "MatMulNBits lora_a and lora_b must be provided together");
+  const float* bias_data = bias == nullptr ? nullptr : bias->Data<float>();
+  const float* residual_data = residual == nullptr ? nullptr : residual->Data<float>();
+
+  // The epilogue applies activation(Y + bias) + residual to each output tile while it is hot in cache.
+  const bool has_epilogue = activation_.ActivationKind != MlasIdentityActivation || residual_data != nullptr;
+  InlinedVector<MLAS_GEMM_EPILOGUE> epilogues(has_epilogue ? batch_count : 0);
+  for (size_t i = 0; i < epilogues.size(); ++i) {
+    epilogues[i].Activation = &activation_;
+    epilogues[i].Residual = residual_data == nullptr ? nullptr : residual_data + helper.OutputOffsets()[i];
+    epilogues[i].ldr = N;
+  }
+
 #ifndef ORT_NEURAL_SPEED
   const bool has_single_b_matrix =
       (!act_order_) && (!zero_point_is_not_quant_) &&
@@ -323,35 +453,67 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
     const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
 
     // mlas nbits implementation requires packed b. update this logic if it changes.
-    if (MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type) && packed_b_) {
+    // 2b and 3b quantization has no fallback implementation, so pack b here if it was not prepacked.
+    if (MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type) && (packed_b_ || nbits_ != 4)) {
+      AllocatorPtr allocator;
+      ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+
       IAllocatorUniquePtr<std::byte> workspace{};
       if (const size_t workspace_size = MlasSQNBitGemmBatchWorkspaceSize(M, N, K, batch_count,
                                                                          nbits_, block_size_, compute_type);
           workspace_size > 0) {
-        AllocatorPtr allocator;
-        ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
         workspace = IAllocator::MakeUniquePtr<std::byte>(allocator, workspace_size);
       }
 
+      const void* quant_b_data = packed_b_.get();
+      IAllocatorUniquePtr<std::byte> tmp_packed_b{};
+      if (quant_b_data == nullptr) {
+        const size_t tmp_packed_b_size = MlasSQNBitGemmPackQuantBDataSize(N_, K_, nbits_, block_size_, compute_type);
+        tmp_packed_b = IAllocator::MakeUniquePtr<std::byte>(allocator, tmp_packed_b_size);
+        MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type, ctx->Input<Tensor>(1)->DataRaw(),
+                                     tmp_packed_b.get(), thread_pool);
+        quant_b_data = tmp_packed_b.get();
+      }
+
+      // the LoRA update is added before the activation, so the epilogue is applied after it
+      const bool fuse_epilogue = has_epilogue && lora_a == nullptr;
+      InlinedVector<MLAS_GEMM_EPILOGUE_POSTPROCESSOR> post_processors;
+      post_processors.reserve(epilogues.size());
+      for (const auto& epilogue : epilogues) {
+        post_processors.emplace_back(epilogue);
+      }
+
       InlinedVector<MLAS_SQNBIT_GEMM_DATA_PARAMS> data(batch_count);
       for (size_t i = 0; i < batch_count; ++i) {
         data[i].A = a_data + helper.LeftOffsets()[i];
         data[i].lda = lda;
-        data[i].QuantBData = packed_b_.get();
+        data[i].QuantBData = quant_b_data;
         data[i].QuantBScale = scales_data;
         data[i].QuantBZeroPoint = zero_points_data;
+        data[i].Bias = bias_data;
         data[i].C = y_data + helper.OutputOffsets()[i];
         data[i].ldc = N;
+        data[i].PostProcessor = fuse_epilogue ? &post_processors[i] : nullptr;
       }
 
       MlasSQNBitGemmBatch(M, N, K, batch_count, nbits_, block_size_, compute_type, data.data(), workspace.get(),
                           thread_pool);
 
+      if (lora_a != nullptr) {
+        ORT_RETURN_IF_ERROR(AddLoraUpdate(*a, *lora_a, *lora_b, lora_index, K_, N_, y_data, allocator, thread_pool));
+        for (size_t i = 0; has_epilogue && i < batch_count; i++) {
+          MlasGemmEpilogue(&epilogues[i], data[i].C, 0, 0, M, N, N);
+        }
+      }
+
       return Status::OK();
     }
   }
 #endif  // not defined(ORT_NEURAL_SPEED)
 
+  // the fallback implementation below only supports 4b quantization
+  ORT_RETURN_IF(nbits_ != 4, "MatMulNBits with ", nbits_, "b quantization is not supported in this build.");
+
   const Tensor* b = ctx->Input<Tensor>(1);
   const uint8_t* b_data = b->Data<uint8_t>();
 
@@ -420,6 +582,18 @@ Status MatMulNBits::Compute(OpKernelContext* ctx) const {
   MlasGemmBatch(CblasNoTrans, CblasTrans,
                 M, N, K, data.data(), batch_count, thread_pool);
 
+  if (lora_a != nullptr) {
+    ORT_RETURN_IF_ERROR(AddLoraUpdate(*a, *lora_a, *lora_b, lora_index, K_, N_, y_data, allocator, thread_pool));
+  }
+
+  if (bias_data != nullptr || has_epilogue) {
+    for (size_t i = 0; i < batch_count; i++) {
+      MLAS_GEMM_EPILOGUE epilogue = has_epilogue ? epilogues[i] : MLAS_GEMM_EPILOGUE{};
+      epilogue.Bias = bias_data;
+      MlasGemmEpilogue(&epilogue, data[i].C, 0, 0, M, N, N);
+    }
+  }
+
   return Status::OK();
 }
 
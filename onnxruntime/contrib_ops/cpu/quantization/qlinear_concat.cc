@@ -123,6 +123,15 @@ Status QLinearConcat::Compute(OpKernelContext* ctx) const {
   if (p.output_num_elements == 0)
     return Status::OK();
 
+  // Each input fills a slice of every output row. The rows are independent, so they are split across threads.
+  struct InputSlice {
+    const uint8_t* input;
+    const uint8_t* table;
+    size_t axis_pitch;
+    size_t output_offset;
+    bool is_copy;
+  };
+  InlinedVector<InputSlice, Prepare::kExpectedNumberOfInputs> slices;
   int64_t initial_output_offset = 0;  // initial offset for each input
   for (int input_index = 0; input_index < input_count; input_index++) {
     const auto& prep = p.inputs[input_index];
@@ -136,21 +145,32 @@ Status QLinearConcat::Compute(OpKernelContext* ctx) const {
                              ? bool(fixed_table_attrs_[input_index] & LOOKUP_TABLE_IS_COPY)
                              : bool(dynamic_table_attrs[input_index] & LOOKUP_TABLE_IS_COPY);
 
-    auto input_axis_pitch = prep.axis_pitch;
-    const uint8_t* input = static_cast<const uint8_t*>(prep.tensor->DataRaw());
-    uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw()) + initial_output_offset;
-    for (int64_t cur_in_offset = 0; cur_in_offset < prep.num_elements; cur_in_offset += input_axis_pitch) {
-      if (is_copy) {
-        memcpy(output, input + cur_in_offset, narrow<size_t>(input_axis_pitch));
-      } else {
-        QLinearLookupTableTransform(input + cur_in_offset, table, output, narrow<size_t>(input_axis_pitch));
-      }
-      output += p.output_axis_pitch;
-    }
-
-    initial_output_offset += input_axis_pitch;
+    slices.push_back({static_cast<const uint8_t*>(prep.tensor->DataRaw()), table,
+                      narrow<size_t>(prep.axis_pitch), narrow<size_t>(initial_output_offset), is_copy});
+    initial_output_offset += prep.axis_pitch;
   }
 
+  const size_t output_axis_pitch = narrow<size_t>(p.output_axis_pitch);
+  const std::ptrdiff_t row_count = narrow<std::ptrdiff_t>(p.output_num_elements / p.output_axis_pitch);
+  uint8_t* output = static_cast<uint8_t*>(p.output_tensor->MutableDataRaw());
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), row_count,
+      TensorOpCost{static_cast<double>(output_axis_pitch), static_cast<double>(output_axis_pitch),
+                   static_cast<double>(output_axis_pitch)},
+      [&](std::ptrdiff_t first_row, std::ptrdiff_t last_row) {
+        for (const auto& slice : slices) {
+          for (std::ptrdiff_t row = first_row; row < last_row; row++) {
+            const uint8_t* input_row = slice.input + row * slice.axis_pitch;
+            uint8_t* output_row = output + row * output_axis_pitch + slice.output_offset;
+            if (slice.is_copy) {
+              memcpy(output_row, input_row, slice.axis_pitch);
+            } else {
+              QLinearLookupTableTransform(input_row, slice.table, output_row, slice.axis_pitch);
+            }
+          }
+        }
+      });
+
   return Status::OK();
 }
 
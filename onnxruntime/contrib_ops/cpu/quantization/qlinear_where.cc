@@ -364,6 +364,32 @@ Status QLinearWhere::Compute(OpKernelContext* ctx) const {
   const auto& x_lookup_table = is_x_dynamic_ ? x_dynamic_lookup_table : x_fixed_lookup_table_;
   const auto& y_lookup_table = is_y_dynamic_ ? y_dynamic_lookup_table : y_fixed_lookup_table_;
 
+  const auto& condition = *ctx->Input<Tensor>(0);
+  const auto& x_input = *ctx->Input<Tensor>(1);
+  const auto& y_input = *ctx->Input<Tensor>(4);
+  if (condition.Shape() == x_input.Shape() && condition.Shape() == y_input.Shape()) {
+    // Without broadcasting, select and requantize in a single pass, split across threads.
+    Tensor& output = *ctx->Output(0, condition.Shape());
+    const bool* condition_data = condition.Data<bool>();
+    const uint8_t* x_data = static_cast<const uint8_t*>(x_input.DataRaw());
+    const uint8_t* y_data = static_cast<const uint8_t*>(y_input.DataRaw());
+    uint8_t* output_data = static_cast<uint8_t*>(output.MutableDataRaw());
+    const uint8_t* x_table = x_lookup_table.data();
+    const uint8_t* y_table = y_lookup_table.data();
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), condition.Shape().Size(), TensorOpCost{3.0, 1.0, 4.0},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; i++) {
+            if (condition_data[i]) {
+              output_data[i] = is_x_copy ? x_data[i] : x_table[x_data[i]];
+            } else {
+              output_data[i] = is_y_copy ? y_data[i] : y_table[y_data[i]];
+            }
+          }
+        });
+    return Status::OK();
+  }
+
   // Each user_data will sized at 2 + 256 bytes, and contain {is_x/y, is_x/y_copy, x/y_lookup_table} respectively
   std::vector<uint8_t> x_user_data(258);
   std::vector<uint8_t> y_user_data(258);
@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/inlined_containers.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+/**
+ * @brief Computes a small int64 tensor from the dimensions of the inputs.
+ *
+ * The 'ops' attribute lists the instructions in evaluation order and 'operands' holds two operands per instruction:
+ * the input index and the axis for Dim, the value for Const, and the indices of two previous instructions for Add,
+ * Sub, Mul and Div. 'outputs' lists the instructions whose results form the output. See ShapeComputeFusion.
+ */
+class ShapeCompute final : public OpKernel {
+ public:
+  explicit ShapeCompute(const OpKernelInfo& info) : OpKernel(info) {
+    std::vector<std::string> ops = info.GetAttrsOrDefault<std::string>("ops");
+    std::vector<int64_t> operands = info.GetAttrsOrDefault<int64_t>("operands");
+    outputs_ = info.GetAttrsOrDefault<int64_t>("outputs");
+    scalar_ = info.GetAttrOrDefault<int64_t>("scalar", 0) != 0;
+    ORT_ENFORCE(operands.size() == 2 * ops.size(),
+                "ShapeCompute: 'operands' must hold two values for every entry of 'ops'");
+    ORT_ENFORCE(!scalar_ || outputs_.size() == 1, "ShapeCompute: a scalar output must have a single element");
+
+    const int64_t num_inputs = static_cast<int64_t>(info.GetInputCount());
+    program_.reserve(ops.size());
+    for (size_t i = 0; i < ops.size(); ++i) {
+      static const InlinedHashMap<std::string, Op> op_names{
+          {"Dim", Op::Dim}, {"Const", Op::Const}, {"Add", Op::Add},
+          {"Sub", Op::Sub}, {"Mul", Op::Mul}, {"Div", Op::Div},
+      };
+      auto it = op_names.find(ops[i]);
+      ORT_ENFORCE(it != op_names.end(), "ShapeCompute: unsupported instruction ", ops[i]);
+
+      Instruction instruction{it->second, operands[2 * i], operands[2 * i + 1]};
+      if (instruction.op == Op::Dim) {
+        ORT_ENFORCE(instruction.a >= 0 && instruction.a < num_inputs && instruction.b >= 0,
+                    "ShapeCompute: Dim ", instruction.a, ", ", instruction.b, " is out of range");
+      } else if (instruction.op != Op::Const) {
+        const int64_t num_values = static_cast<int64_t>(i);
+        ORT_ENFORCE(instruction.a >= 0 && instruction.a < num_values && instruction.b >= 0 &&
+                        instruction.b < num_values,
+                    "ShapeCompute: operands of ", ops[i], " are out of range");
+      }
+      program_.push_back(instruction);
+    }
+
+    for (int64_t output : outputs_) {
+      ORT_ENFORCE(output >= 0 && output < static_cast<int64_t>(program_.size()),
+                  "ShapeCompute: output ", output, " is out of range");
+    }
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  enum class Op : uint8_t {
+    Dim,
+    Const,
+    Add,
+    Sub,
+    Mul,
+    Div,
+  };
+
+  struct Instruction {
+    Op op;
+    int64_t a;
+    int64_t b;
+  };
+
+  InlinedVector<Instruction> program_;
+  std::vector<int64_t> outputs_;
+  bool scalar_;
+};
+
+Status ShapeCompute::Compute(OpKernelContext* context) const {
+  InlinedVector<int64_t> values(program_.size());
+  for (size_t i = 0; i < program_.size(); ++i) {
+    const Instruction& instruction = program_[i];
+    switch (instruction.op) {
+      case Op::Dim: {
+        const TensorShape& shape = context->Input<Tensor>(static_cast<int>(instruction.a))->Shape();
+        ORT_RETURN_IF_NOT(instruction.b < static_cast<int64_t>(shape.NumDimensions()),
+                          "ShapeCompute: input ", instruction.a, " has no dimension ", instruction.b);
+        values[i] = shape[static_cast<size_t>(instruction.b)];
+        break;
+      }
+      case Op::Const:
+        values[i] = instruction.a;
+        break;
+      case Op::Add:
+        values[i] = values[instruction.a] + values[instruction.b];
+        break;
+      case Op::Sub:
+        values[i] = values[instruction.a] - values[instruction.b];
+        break;
+      case Op::Mul:
+        values[i] = values[instruction.a] * values[instruction.b];
+        break;
+      case Op::Div:
+        ORT_RETURN_IF(values[instruction.b] == 0, "ShapeCompute: division by zero");
+        values[i] = values[instruction.a] / values[instruction.b];
+        break;
+    }
+  }
+
+  Tensor* output = scalar_ ? context->Output(0, TensorShape{})
+                           : context->Output(0, TensorShape{static_cast<int64_t>(outputs_.size())});
+  int64_t* output_data = output->MutableData<int64_t>();
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    output_data[i] = values[static_cast<size_t>(outputs_[i])];
+  }
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    ShapeCompute,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::AllTensorTypes())
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>()),
+    ShapeCompute);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -1,8 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
+#include "core/util/qmath.h"
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
 #include "skip_layer_norm.h"
@@ -34,6 +40,64 @@ namespace contrib {
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
 
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DynamicQuantizeSkipLayerNormalization,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    DynamicQuantizeSkipLayerNorm);
+
+namespace {
+
+// Normalizes one row of hidden_size elements of input + skip (+ bias) into p_output, and stores the sum into
+// p_skip_input_bias_add_output when it is not null.
+template <typename T, bool simplified>
+void ComputeSkipLayerNormRow(const T* p_input, const T* p_skip, const T* gamma_data, const T* beta_data,
+                             const T* bias_data, float epsilon, int hidden_size, T* p_output,
+                             T* p_skip_input_bias_add_output_data) {
+  T mean = 0;
+  T mean_square = 0;
+
+  for (int64_t h = 0; h < hidden_size; h++) {
+    T value = p_input[h] + p_skip[h];
+
+    if (nullptr != bias_data) {
+      value += bias_data[h];
+    }
+
+    if (nullptr != p_skip_input_bias_add_output_data) {
+      p_skip_input_bias_add_output_data[h] = value;
+    }
+
+    p_output[h] = value;
+    mean += value;
+    mean_square += value * value;
+  }
+
+  mean = mean / hidden_size;
+  if (simplified) {
+    mean_square = sqrt(mean_square / hidden_size + epsilon);
+  } else {
+    mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon);
+  }
+
+  for (int64_t h = 0; h < hidden_size; h++) {
+    if (simplified) {
+      p_output[h] = p_output[h] / mean_square * gamma_data[h];
+    } else if (nullptr == beta_data) {
+      p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
+    } else {
+      p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+    }
+  }
+}
+
+}  // namespace
+
 template <typename T, bool simplified>
 SkipLayerNorm<T, simplified>::SkipLayerNorm(const OpKernelInfo& op_kernel_info)
     : OpKernel(op_kernel_info) {
@@ -81,6 +145,15 @@ Status SkipLayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
 
   const auto& skip_size = skip->Shape().Size();
 
+  // RMSNorm of float rows is computed by MLAS, with the residual and bias added in the pass summing the squares.
+  if constexpr (simplified && std::is_same_v<T, float>) {
+    MlasComputeRmsNorm(input_data, skip_data, onnxruntime::narrow<size_t>(skip_size / hidden_size), bias_data,
+                       gamma_data, output_data, skip_input_bias_add_output_data, nullptr,
+                       onnxruntime::narrow<size_t>(task_count), static_cast<size_t>(hidden_size), epsilon_,
+                       p_ctx->GetOperatorThreadPool());
+    return Status::OK();
+  }
+
   concurrency::ThreadPool::TryBatchParallelFor(
       p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
       [&](ptrdiff_t task_idx) {
@@ -91,43 +164,127 @@ Status SkipLayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
         T* p_output = output_data + offset;
         T* p_skip_input_bias_add_output_data = skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
 
-        T mean = 0;
-        T mean_square = 0;
+        ComputeSkipLayerNormRow<T, simplified>(p_input, p_skip, gamma_data, beta_data, bias_data, epsilon_,
+                                               hidden_size, p_output, p_skip_input_bias_add_output_data);
+      },
+      0);
+
+  return Status::OK();
+}
+
+DynamicQuantizeSkipLayerNorm::DynamicQuantizeSkipLayerNorm(const OpKernelInfo& op_kernel_info)
+    : OpKernel(op_kernel_info) {
+  ORT_ENFORCE(op_kernel_info.GetAttr<float>("epsilon", &epsilon_).IsOK());
+  ORT_ENFORCE(epsilon_ >= 0);
+  simplified_ = op_kernel_info.GetAttrOrDefault<int64_t>("simplified", 0) != 0;
+}
 
-        for (int64_t h = 0; h < hidden_size; h++) {
-          T value = p_input[h] + p_skip[h];
+template <bool simplified>
+void DynamicQuantizeSkipLayerNorm::ComputeImpl(OpKernelContext* p_ctx, const Tensor& input, const Tensor& skip,
+                                               const Tensor& gamma, const Tensor* beta, const Tensor* bias,
+                                               int hidden_size) const {
+  const auto& input_shape = input.Shape();
+  const std::ptrdiff_t task_count =
+      onnxruntime::narrow<std::ptrdiff_t>(input_shape.SizeToDimension(input_shape.NumDimensions() - 1));
 
-          if (nullptr != bias_data) {
-            value += bias_data[h];
-          }
+  const float* input_data = input.Data<float>();
+  const float* skip_data = skip.Data<float>();
+  const float* gamma_data = gamma.Data<float>();
+  const float* beta_data = beta == nullptr ? nullptr : beta->Data<float>();
+  const float* bias_data = bias == nullptr ? nullptr : bias->Data<float>();
+  const auto skip_size = skip.Shape().Size();
 
-          if (nullptr != p_skip_input_bias_add_output_data) {
-            p_skip_input_bias_add_output_data[h] = value;
-          }
+  Tensor* output = p_ctx->Output(0, input_shape);
+  Tensor* y_scale = p_ctx->Output(1, TensorShape{});
+  Tensor* y_zero_point = p_ctx->Output(2, TensorShape{});
+  Tensor* skip_input_bias_add_output = p_ctx->Output(3, input_shape);
 
-          p_output[h] = value;
-          mean += value;
-          mean_square += value * value;
-        }
+  uint8_t* output_data = output->MutableData<uint8_t>();
+  float* skip_input_bias_add_output_data =
+      skip_input_bias_add_output != nullptr ? skip_input_bias_add_output->MutableData<float>() : nullptr;
 
-        mean = mean / hidden_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / hidden_size + epsilon_);
-        } else {
-          mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
+  concurrency::ThreadPool* tp = p_ctx->GetOperatorThreadPool();
+  const double row_bytes = static_cast<double>(hidden_size) * sizeof(float);
+
+  // The quantization parameters depend on the range of the whole normalized tensor, so the rows are normalized
+  // twice: once for their range, and once more to be quantized. Each row is normalized into a small buffer
+  // that stays in cache, instead of a float output that would be written and read back from memory.
+  std::vector<float> row_min(static_cast<size_t>(task_count));
+  std::vector<float> row_max(static_cast<size_t>(task_count));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, task_count,
+      TensorOpCost{2 * row_bytes, skip_input_bias_add_output_data != nullptr ? row_bytes : 0.0,
+                   static_cast<double>(hidden_size) * 8},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<float> normalized(static_cast<size_t>(hidden_size));
+        for (std::ptrdiff_t task_idx = first; task_idx < last; ++task_idx) {
+          const auto offset = task_idx * hidden_size;
+          ComputeSkipLayerNormRow<float, simplified>(
+              input_data + offset, skip_data + (offset % skip_size), gamma_data, beta_data, bias_data, epsilon_,
+              hidden_size, normalized.data(),
+              skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr);
+          MlasFindMinMaxElement(normalized.data(), &row_min[task_idx], &row_max[task_idx],
+                                static_cast<size_t>(hidden_size));
         }
+      });
+
+  float min = *std::min_element(row_min.begin(), row_min.end());
+  float max = *std::max_element(row_max.begin(), row_max.end());
+  float scale;
+  uint8_t zero_point;
+  GetQuantizationParameterFromMinMax<uint8_t>(min, max, scale, zero_point);
+  *y_scale->MutableData<float>() = scale;
+  *y_zero_point->MutableData<uint8_t>() = zero_point;
 
-        for (int64_t h = 0; h < hidden_size; h++) {
-          if (simplified) {
-            p_output[h] = p_output[h] / mean_square * gamma_data[h];
-          } else if (nullptr == beta_data) {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
-          } else {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
-          }
+  concurrency::ThreadPool::TryParallelFor(
+      tp, task_count,
+      TensorOpCost{2 * row_bytes, static_cast<double>(hidden_size), static_cast<double>(hidden_size) * 10},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<float> normalized(static_cast<size_t>(hidden_size));
+        for (std::ptrdiff_t task_idx = first; task_idx < last; ++task_idx) {
+          const auto offset = task_idx * hidden_size;
+          ComputeSkipLayerNormRow<float, simplified>(
+              input_data + offset, skip_data + (offset % skip_size), gamma_data, beta_data, bias_data, epsilon_,
+              hidden_size, normalized.data(), nullptr);
+          MlasQuantizeLinear(normalized.data(), output_data + offset, static_cast<size_t>(hidden_size), scale,
+                             zero_point);
         }
-      },
-      0);
+      });
+}
+
+Status DynamicQuantizeSkipLayerNorm::Compute(OpKernelContext* p_ctx) const {
+  const Tensor* input = p_ctx->Input<Tensor>(0);
+  const Tensor* skip = p_ctx->Input<Tensor>(1);
+  const Tensor* gamma = p_ctx->Input<Tensor>(2);
+  const Tensor* beta = p_ctx->Input<Tensor>(3);
+  const Tensor* bias = p_ctx->Input<Tensor>(4);
+
+  const auto& input_dims = input->Shape().GetDims();
+  size_t input_dims_size = input_dims.size();
+  int hidden_size = static_cast<int>(input_dims[input_dims_size - 1]);
+
+  ORT_RETURN_IF_ERROR(onnxruntime::contrib::skip_layer_norm_helper::CheckInputs<Tensor>(input,
+                                                                                        skip,
+                                                                                        gamma,
+                                                                                        beta,
+                                                                                        bias,
+                                                                                        hidden_size,
+                                                                                        input_dims_size));
+  ORT_RETURN_IF(simplified_ && beta != nullptr, "beta is not supported when simplified is 1");
+
+  if (input->Shape().Size() == 0) {
+    p_ctx->Output(0, input->Shape());
+    *p_ctx->Output(1, TensorShape{})->MutableData<float>() = 1.0f;
+    *p_ctx->Output(2, TensorShape{})->MutableData<uint8_t>() = 0;
+    p_ctx->Output(3, input->Shape());
+    return Status::OK();
+  }
+
+  if (simplified_) {
+    ComputeImpl<true>(p_ctx, *input, *skip, *gamma, beta, bias, hidden_size);
+  } else {
+    ComputeImpl<false>(p_ctx, *input, *skip, *gamma, beta, bias, hidden_size);
+  }
 
   return Status::OK();
 }
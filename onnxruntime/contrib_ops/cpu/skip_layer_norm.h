@@ -20,5 +20,21 @@ class SkipLayerNorm final : public OpKernel {
   float epsilon_;
 };
 
+// SkipLayerNormalization (or its simplified form) followed by DynamicQuantizeLinear, see
+// DynamicQuantizeSkipLayerNormFusion. The float output is never written to memory.
+class DynamicQuantizeSkipLayerNorm final : public OpKernel {
+ public:
+  DynamicQuantizeSkipLayerNorm(const OpKernelInfo& op_kernel_info);
+  Status Compute(OpKernelContext* p_op_kernel_context) const override;
+
+ private:
+  template <bool simplified>
+  void ComputeImpl(OpKernelContext* p_ctx, const Tensor& input, const Tensor& skip, const Tensor& gamma,
+                   const Tensor* beta, const Tensor* bias, int hidden_size) const;
+
+  float epsilon_;
+  bool simplified_;
+};
+
 }  // namespace contrib
 }  // namespace onnxruntime
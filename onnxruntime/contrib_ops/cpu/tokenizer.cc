@@ -8,6 +8,7 @@
 #include "core/common/utf8_util.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
 #include "re2/re2.h"
 
 #ifdef _MSC_VER
@@ -53,7 +54,8 @@ class Tokenizer final : public OpKernel {
                          gsl::span<const int64_t> input_dims) const;
 
   void OutputData(gsl::span<const SlicesVector> rows,
-                  size_t max_tokens, size_t max_output_index, std::string* output_data) const;
+                  size_t max_tokens, size_t max_output_index, std::string* output_data,
+                  concurrency::ThreadPool* tp) const;
 
   bool mark_{false};
   std::string pad_value_;
@@ -317,27 +319,35 @@ class MemoryAllocator {
 }  // namespace
 
 void Tokenizer::OutputData(gsl::span<const SlicesVector> rows,
-                           size_t max_tokens, [[maybe_unused]] size_t max_output_index, std::string* output_data) const {
-  size_t output_index = 0;
-  for (const auto& row : rows) {
-    [[maybe_unused]] size_t c_idx = output_index;
-    if (mark_) {
-      output_data[output_index++].assign(&kStartMarker, 1);
-    }
-    // Output tokens for this row
-    for (const auto& token : row) {
-      output_data[output_index++].assign(token.data(), token.length());
-    }
-    if (mark_) {
-      output_data[output_index++].assign(&kEndMarker, 1);
-    }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
-    for (size_t p = 0; p < pads; ++p) {
-      output_data[output_index++] = pad_value_;
-    }
-    assert(output_index <= max_output_index);
-    assert((output_index - c_idx) <= max_tokens);
-  }
+                           size_t max_tokens, [[maybe_unused]] size_t max_output_index, std::string* output_data,
+                           concurrency::ThreadPool* tp) const {
+  // Every row fills exactly max_tokens outputs, so the rows are copied out independently.
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(rows.size()),
+      TensorOpCost{0, static_cast<double>(max_tokens * sizeof(std::string)), static_cast<double>(max_tokens * 16)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t r = first; r < last; ++r) {
+          const auto& row = rows[r];
+          size_t output_index = static_cast<size_t>(r) * max_tokens;
+          [[maybe_unused]] size_t c_idx = output_index;
+          if (mark_) {
+            output_data[output_index++].assign(&kStartMarker, 1);
+          }
+          // Output tokens for this row
+          for (const auto& token : row) {
+            output_data[output_index++].assign(token.data(), token.length());
+          }
+          if (mark_) {
+            output_data[output_index++].assign(&kEndMarker, 1);
+          }
+          const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
+          for (size_t p = 0; p < pads; ++p) {
+            output_data[output_index++] = pad_value_;
+          }
+          assert(output_index <= max_output_index);
+          assert((output_index - c_idx) <= max_tokens);
+        }
+      });
 }
 
 Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
@@ -474,7 +484,7 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->MutableData<std::string>();
 
-  OutputData(rows, max_tokens, narrow<size_t>(output_shape.Size()), output_data);
+  OutputData(rows, max_tokens, narrow<size_t>(output_shape.Size()), output_data, ctx->GetOperatorThreadPool());
 
   return Status::OK();
 }
@@ -574,7 +584,7 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
   auto output_tensor = ctx->Output(0, output_shape);
   auto const output_data = output_tensor->MutableData<std::string>();
 
-  OutputData(rows, max_tokens, narrow<size_t>(output_shape.Size()), output_data);
+  OutputData(rows, max_tokens, narrow<size_t>(output_shape.Size()), output_data, ctx->GetOperatorThreadPool());
 
   return Status::OK();
 }
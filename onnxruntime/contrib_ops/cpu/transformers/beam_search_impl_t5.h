@@ -220,7 +220,7 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
 
   this->beam_scorer_ = create_beam_scorer_func_
                            ? create_beam_scorer_func_(*parameters, this->temp_space_allocator_, this->cpu_allocator_, this->ort_stream_)
-                           : std::make_unique<BeamSearchScorer>(*parameters, this->cpu_allocator_);
+                           : std::make_unique<BeamSearchScorer>(*parameters, this->cpu_allocator_, this->thread_pool_);
 
   // ------------------------------------------------------------------------------
   // Generate next token from logits output from encoder, and initialize decoder inputs.
@@ -275,7 +275,12 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
       }
     }
 
-    if (decoder_subgraph_.has_decoder_masked_attention_) {
+    if (decoder_subgraph_.has_decoder_masked_attention_ && !this->IsCuda()) {
+      // The CPU kernel reads the past key in its natural layout, so only the cache indirection is initialized.
+      size_t cache_indir_input_offset = static_cast<size_t>(decoder_subgraph_.GetFirstPastInputIndex()) + 4 * static_cast<size_t>(decoder_subgraph_.num_layers) + 2;
+      Tensor* cache_indir = decoder_feeds[cache_indir_input_offset].GetMutable<Tensor>();
+      std::fill_n(cache_indir->MutableData<int32_t>(), cache_indir->Shape().Size(), 0);
+    } else if (decoder_subgraph_.has_decoder_masked_attention_) {
       size_t offset = static_cast<size_t>(decoder_subgraph_.GetFirstPastInputIndex());
       // Need to check cross attention's past key tensor size, suppose all layers cross attention key size are same
       auto first_cross_attention_key = decoder_feeds[offset + 2 * static_cast<size_t>(decoder_subgraph_.num_layers)].GetMutable<Tensor>();
@@ -369,7 +374,7 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
           decoder_feeds,
           num_present_outputs,
           ReinterpretAsSpan<const int32_t>(beam_next_tokens),
-          decoder_subgraph_.has_decoder_masked_attention_
+          decoder_subgraph_.has_decoder_masked_attention_ && this->IsCuda()
               ? place_holder
               : ReinterpretAsSpan<const int32_t>(this->beam_scorer_->GetNextIndicesCPU()),
           decoder_subgraph_.has_decoder_masked_attention_
@@ -167,6 +167,7 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
       encoder_input_ids,
       initial_decoder_input_ids_value,
       parameters->decoder_start_token_id,
+      parameters->chunk_length,
       this->implicit_inputs_,
       encoder_feeds,
       this->create_encoder_inputs_func_,
@@ -232,7 +233,7 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
 
   this->beam_scorer_ = create_beam_scorer_func_
                            ? create_beam_scorer_func_(*parameters, this->temp_space_allocator_, this->cpu_allocator_, this->ort_stream_)
-                           : std::make_unique<BeamSearchScorer>(*parameters, this->cpu_allocator_);
+                           : std::make_unique<BeamSearchScorer>(*parameters, this->cpu_allocator_, this->thread_pool_);
 
   // ------------------------------------------------------------------------------
   // Generate next token from logits output from encoder, and initialize decoder inputs.
@@ -331,7 +332,12 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
       cross_qk_buffer_data = cross_qk_buffer_value.GetMutable<Tensor>()->MutableData<float>();
     }
 
-    if (decoder_subgraph_.has_decoder_masked_attention_) {
+    if (decoder_subgraph_.has_decoder_masked_attention_ && !this->IsCuda()) {
+      // The CPU kernel reads the past key in its natural layout, so only the cache indirection is initialized.
+      size_t cache_indir_input_offset = static_cast<size_t>(decoder_subgraph_.GetFirstPastInputIndex()) + 4 * static_cast<size_t>(decoder_subgraph_.num_layers) + 2;
+      Tensor* cache_indir = decoder_feeds[cache_indir_input_offset].GetMutable<Tensor>();
+      std::fill_n(cache_indir->MutableData<int32_t>(), cache_indir->Shape().Size(), 0);
+    } else if (decoder_subgraph_.has_decoder_masked_attention_) {
       size_t offset = static_cast<size_t>(decoder_subgraph_.GetFirstPastInputIndex());
       // Need to check cross attention's past key tensor size, suppose all layers cross attention key size are same
       auto first_cross_attention_key = decoder_feeds[offset + 2 * static_cast<size_t>(decoder_subgraph_.num_layers)].GetMutable<Tensor>();
@@ -436,7 +442,7 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
           decoder_feeds,
           num_present_outputs,
           ReinterpretAsSpan<const int32_t>(beam_next_tokens),
-          decoder_subgraph_.has_decoder_masked_attention_
+          decoder_subgraph_.has_decoder_masked_attention_ && this->IsCuda()
               ? place_holder
               : ReinterpretAsSpan<const int32_t>(this->beam_scorer_->GetNextIndicesCPU()),
           decoder_subgraph_.has_decoder_masked_attention_
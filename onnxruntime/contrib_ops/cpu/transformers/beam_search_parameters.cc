@@ -46,6 +46,12 @@ void BeamSearchParameters::ParseFromInputs(OpKernelContext* context) {
     ORT_ENFORCE(dims.size() == 2, "input_ids shall have 2 dimensions. Got ", dims.size());
   }
   batch_size = static_cast<int>(dims[0]);
+  if (this->model_type == IGenerationParameters::kModelTypeWhisper && chunk_length > 0 && dims[2] > chunk_length) {
+    // Long-form audio is decoded as one batch entry per window.
+    ORT_ENFORCE(dims[2] % chunk_length == 0,
+                "input_features frames (", dims[2], ") shall be a multiple of chunk_length (", chunk_length, ")");
+    batch_size *= static_cast<int>(dims[2] / chunk_length);
+  }
 
   extra_decoding_ids = gsl::span<int32_t>();
   if (this->model_type == IGenerationParameters::kModelTypeWhisper && extra_decoding_ids_input_id > 0) {
@@ -160,6 +166,8 @@ void WhisperBeamSearchParameters::ParseFromAttributes(const OpKernelInfo& info)
   no_speech_token_id = static_cast<int>(info.GetAttrOrDefault<int64_t>("no_speech_token_id", -1LL));
   no_timestamps_token_id = static_cast<int>(info.GetAttrOrDefault<int64_t>("no_timestamps_token_id", -1LL));
   beginning_timestamp_token_id = static_cast<int>(info.GetAttrOrDefault<int64_t>("beginning_timestamp_token_id", -1LL));
+  chunk_length = static_cast<int>(info.GetAttrOrDefault<int64_t>("chunk_length", 0LL));
+  ORT_ENFORCE(chunk_length >= 0, "chunk_length shall be non-negative, got ", chunk_length);
   cross_qk_layer_head_input_id = 12;
   extra_decoding_ids_input_id = 13;
   cross_qk_output_id = 3;
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <queue>
 #include <math.h>
 #include "core/common/common.h"
@@ -73,7 +74,8 @@ void BeamHypotheses::Output(
 }
 
 BeamSearchScorer::BeamSearchScorer(const IGenerationParameters& parameters,
-                                   AllocatorPtr& allocator)
+                                   AllocatorPtr& allocator,
+                                   concurrency::ThreadPool* thread_pool)
     : batch_size_{static_cast<size_t>(parameters.batch_size)},
       num_beams_{static_cast<size_t>(parameters.num_beams)},
       max_length_{static_cast<size_t>(parameters.max_length)},
@@ -81,6 +83,7 @@ BeamSearchScorer::BeamSearchScorer(const IGenerationParameters& parameters,
       pad_token_id_{parameters.pad_token_id},
       eos_token_id_{parameters.eos_token_id},
       early_stopping_{parameters.early_stopping},
+      thread_pool_{thread_pool},
       not_done_count_{parameters.batch_size} {
   size_t batch_beam_size = batch_size_ * num_beams_;
 
@@ -95,7 +98,10 @@ BeamSearchScorer::BeamSearchScorer(const IGenerationParameters& parameters,
 
   // Space to store intermediate sequence with length sequence_length, sequence_length + 1, ..., max_sequence_length.
   size_t per_beam = (SafeInt<size_t>(max_length_) * (max_length_ + 1) - (parameters.sequence_length - 1) * parameters.sequence_length) / 2;
-  hypothesis_buffer_ = Allocate<int32_t>(allocator, batch_beam_size * per_beam, hypothesis_buffer_ptr_);
+  hypothesis_buffer_per_batch_ = SafeInt<size_t>(num_beams_) * per_beam;
+  hypothesis_buffer_ = Allocate<int32_t>(allocator, SafeInt<size_t>(batch_size_) * hypothesis_buffer_per_batch_,
+                                         hypothesis_buffer_ptr_);
+  hypothesis_buffer_used_ = Allocate<size_t>(allocator, batch_size_, hypothesis_buffer_used_ptr_, true);
 }
 
 void BeamSearchScorer::Process(ISequences& sequences,
@@ -111,7 +117,10 @@ void BeamSearchScorer::Process(ISequences& sequences,
   ORT_ENFORCE(next_scores.size() == next_tokens.size());
   ORT_ENFORCE(next_scores.size() == next_indices.size());
 
-  for (size_t batch = 0; batch < batch_size_; batch++) {
+  // The batch entries are independent: each one only touches its own hypotheses, its own region of the
+  // hypothesis buffer and its own num_beams_ slots of the next beam outputs.
+  auto process_batch = [&](std::ptrdiff_t batch_index) {
+    const size_t batch = static_cast<size_t>(batch_index);
     BeamHypotheses& beam_hyp = beam_hyps_[batch];
     if (beam_hyp.done_) {
       ORT_ENFORCE(beam_hyp.beams_used_ == gsl::narrow_cast<int>(num_beams_),
@@ -123,9 +132,13 @@ void BeamSearchScorer::Process(ISequences& sequences,
         next_beam_tokens_[batch * num_beams_ + j] = pad_token_id_;
         next_beam_indices_[batch * num_beams_ + j] = 0;
       }
-      continue;
+      return;
     }
 
+    gsl::span<int32_t> batch_hypothesis_buffer = hypothesis_buffer_.subspan(batch * hypothesis_buffer_per_batch_,
+                                                                            hypothesis_buffer_per_batch_);
+    size_t& batch_hypothesis_buffer_used = hypothesis_buffer_used_[batch];
+
     // Next tokens for this sentence.
     size_t beam_idx = 0;
     size_t top_k = 2 * num_beams_;
@@ -144,10 +157,10 @@ void BeamSearchScorer::Process(ISequences& sequences,
 
         // Clone the sequence and append to buffer.
         gsl::span<const int32_t> src = sequences.GetSequence(batch_beam_idx);
-        auto clone = hypothesis_buffer_.subspan(static_cast<size_t>(hypothesis_buffer_used_), sequence_length);
+        auto clone = batch_hypothesis_buffer.subspan(batch_hypothesis_buffer_used, sequence_length);
 
         gsl::copy(src, clone);
-        hypothesis_buffer_used_ += sequence_length;
+        batch_hypothesis_buffer_used += sequence_length;
         auto sequence = ReinterpretAsSpan<const int32_t>(clone);
         beam_hyp.Add(sequence, next_score);
       } else {
@@ -164,22 +177,25 @@ void BeamSearchScorer::Process(ISequences& sequences,
     }
 
     ORT_ENFORCE(beam_idx == num_beams_);
-    ORT_ENFORCE(static_cast<size_t>(hypothesis_buffer_used_) <= hypothesis_buffer_.size());
 
     //  Check if we are done so that we can save a pad step if all(done)
     if (static_cast<size_t>(beam_hyp.beams_used_) < num_beams_)
-      continue;
+      return;
 
     if (!early_stopping_) {
-      gsl::span<const float> topk_scores = next_scores.subspan(batch * num_beams_, top_k);
+      gsl::span<const float> topk_scores = next_scores.subspan(batch * top_k, top_k);
       const auto best_sum_logprobs = std::max_element(topk_scores.begin(), topk_scores.end());
       if (beam_hyp.CanImprove(*best_sum_logprobs, sequence_length))
-        continue;
+        return;
     }
 
     beam_hyp.done_ = true;
-    not_done_count_--;
-  }
+  };
+
+  concurrency::ThreadPool::TrySimpleParallelFor(thread_pool_, static_cast<std::ptrdiff_t>(batch_size_), process_batch);
+
+  not_done_count_ = static_cast<int>(std::count_if(beam_hyps_.begin(), beam_hyps_.end(),
+                                                   [](const BeamHypotheses& beam_hyp) { return !beam_hyp.done_; }));
 }
 
 template <typename T>
@@ -10,6 +10,7 @@
 #include "core/framework/allocator.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/cpu/containers.h"
 #include "contrib_ops/cpu/transformers/sequences.h"
@@ -49,7 +50,8 @@ struct BeamHypotheses {
 
 struct BeamSearchScorer : IBeamScorer {
   BeamSearchScorer(const IGenerationParameters& parameters,
-                   AllocatorPtr& allocator);
+                   AllocatorPtr& allocator,
+                   concurrency::ThreadPool* thread_pool = nullptr);
 
   void Process(ISequences& sequences,
                gsl::span<const float>& next_scores,
@@ -76,6 +78,7 @@ struct BeamSearchScorer : IBeamScorer {
   int pad_token_id_;
   int eos_token_id_;
   bool early_stopping_;
+  concurrency::ThreadPool* thread_pool_;  // Used to process the batch entries in parallel, may be nullptr
   int not_done_count_;  // When zero, every batch entry is done (starts at batch_size_)
 
   IAllocatorUniquePtr<float> next_beam_scores_ptr_;
@@ -87,9 +90,13 @@ struct BeamSearchScorer : IBeamScorer {
   IAllocatorUniquePtr<int32_t> next_beam_indices_ptr_;
   gsl::span<int32_t> next_beam_indices_;
 
+  // Each batch entry owns a contiguous region of hypothesis_buffer_ so that the entries can be processed in parallel
+  // and the hypotheses of one entry stay together in memory.
   IAllocatorUniquePtr<int32_t> hypothesis_buffer_ptr_;  // Allocated buffer to hold all hypotheses
   gsl::span<int32_t> hypothesis_buffer_;                // Span of the allocated buffer
-  int hypothesis_buffer_used_{};                        // Offset of available buffer, or length of used buffer.
+  size_t hypothesis_buffer_per_batch_{};                // Length of the region of each batch entry
+  IAllocatorUniquePtr<size_t> hypothesis_buffer_used_ptr_;
+  gsl::span<size_t> hypothesis_buffer_used_;  // Used length of the region of each batch entry, shape is batch_size_
 
   IAllocatorUniquePtr<HypothesisScore> hypothesis_scores_ptr_;  // num_beams_ * batch_size_, divided into num_beams_ chunks per BeamHypothesis in beam_hyps_
   IAllocatorUniquePtr<BeamHypotheses> beam_hyps_ptr_;
@@ -188,8 +188,9 @@ class GenerateBase {
                                vocab_mask_dims.size());
       }
 
-      // prefix_vocab_mask first dimension should be same as the first dimension of input_ids
-      if (static_cast<int>(vocab_mask_dims[0]) != static_cast<int>(dims[0])) {
+      // prefix_vocab_mask first dimension should be same as the batch size, which is the first dimension of input_ids
+      // unless Whisper splits long input_features into windows.
+      if (static_cast<int>(vocab_mask_dims[0]) != parameters->batch_size) {
         return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                                "input_ids and prefix_vocab_mask must have the same batch_size");
       }
@@ -227,8 +228,8 @@ class GenerateBase {
                                "Input 'presence_mask' is expected to have 2 dimensions, got ", dims_presence.size());
       }
 
-      // presence_mask first dimension should be same as the first dimension of input_ids
-      if (static_cast<int>(dims_presence[0]) != static_cast<int>(dims[0])) {
+      // presence_mask first dimension should be same as the batch size
+      if (static_cast<int>(dims_presence[0]) != parameters->batch_size) {
         return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                                "input_ids and presence_mask must have the same batch_size");
       }
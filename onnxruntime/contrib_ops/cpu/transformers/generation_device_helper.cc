@@ -813,9 +813,6 @@ Status UpdateDecoderFeeds(
     const transformers::IConsoleDumper* dumper) {
   ORT_UNUSED_PARAMETER(stream);
   ORT_UNUSED_PARAMETER(beam_indices_gpu);
-  ORT_UNUSED_PARAMETER(input_sequence_len);
-  ORT_UNUSED_PARAMETER(past_present_share_buffer);
-  ORT_UNUSED_PARAMETER(need_cache_indir);
   // last_outputs: logits, present_key_self_0, present_value_self_0, ...
   // next_inputs: input_ids,
   //              encoder_attention_mask, encoder_hidden_states(optional),
@@ -856,6 +853,42 @@ Status UpdateDecoderFeeds(
 
   // Update past state
   ORT_ENFORCE(last_outputs.size() >= static_cast<size_t>(1) + num_present_tensors);
+
+  if (past_present_share_buffer) {
+    // The presents are written in place into the past buffers by DecoderMaskedMultiHeadAttention,
+    // so only the past sequence length and the cache indirection of the beams are updated.
+    const ptrdiff_t past_sequence_length_idx = 2 * num_present_tensors + t5_decoder_first_past_input_idx;
+    *(next_inputs[past_sequence_length_idx].GetMutable<Tensor>()->MutableData<int32_t>()) = current_length - 1;
+
+    if (need_cache_indir && num_beams > 1) {
+      // The cache indirection feed comes 2 feeds after the `past_sequence_length` feed.
+      // Its shape is (batch_size, num_beams, max_sequence_length).
+      const OrtValue& old_cache_indirection = next_inputs[past_sequence_length_idx + 2];
+      const TensorShape& cache_indirection_shape = old_cache_indirection.Get<Tensor>().Shape();
+      const int max_sequence_length = static_cast<int>(cache_indirection_shape[2]);
+
+      OrtValue cache_indirection;
+      Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), cache_indirection_shape, allocator, cache_indirection);
+      const int32_t* src = old_cache_indirection.Get<Tensor>().Data<int32_t>();
+      int32_t* tgt = cache_indirection.GetMutable<Tensor>()->MutableData<int32_t>();
+
+      // The input tokens come from beam 0 and the new token from the beam itself. The other steps are taken from
+      // the beam that the beam was selected from.
+      for (int i = 0; i < batch_beam_size; i++) {
+        const int beam = i % num_beams;
+        const int src_beam = beam_indices[i] % num_beams;
+        const int32_t* src_row = src + static_cast<ptrdiff_t>(i - beam + src_beam) * max_sequence_length;
+        int32_t* tgt_row = tgt + static_cast<ptrdiff_t>(i) * max_sequence_length;
+        for (int t = 0; t < current_length; t++) {
+          tgt_row[t] = t < input_sequence_len ? 0 : (t == current_length - 1 ? beam : src_row[t]);
+        }
+      }
+
+      next_inputs[past_sequence_length_idx + 2] = cache_indirection;
+    }
+    return Status::OK();
+  }
+
   // TODO(tianleiwu): remove num_beams==1 once GreedySearch operator is available.
   if (num_beams == 1) {
     // feed present_* output to past_* inputs one by one
@@ -878,25 +911,51 @@ Status CreateWhisperEncoderInputs(
     const Tensor* original_encoder_input_features,
     const OrtValue* original_decoder_input_ids_value,
     int start_token_id,
+    int chunk_length,
     AllocatorPtr allocator,
     OrtValue& encoder_input_features,
     OrtValue& decoder_input_ids) {
   const TensorShape& input_features_shape = original_encoder_input_features->Shape();
   ORT_ENFORCE(input_features_shape.NumDimensions() == 3);
-  const int64_t& batch_size = input_features_shape[0];
+  const int64_t num_frames = input_features_shape[2];
+  const int64_t num_chunks = (chunk_length > 0 && num_frames > chunk_length) ? num_frames / chunk_length : 1;
+  const int64_t batch_size = input_features_shape[0] * num_chunks;
 
   // Allocate attention_mask based on shape of input_ids
   auto element_type = DataTypeImpl::GetType<int32_t>();
 
-  // Use original encoder_input_ids. This requires the input_ids for subgraph is also int32.
-  // Current shape is (batch_size, sequence_length)
-  // Note that we will expand it to (batch_size * num_beams, sequence_length) later.
-  // To avoid cloning input_ids, we use const_cast here since this function does not change its content.
-  Tensor::InitOrtValue(DataTypeImpl::GetType<T>(),
-                       input_features_shape,
-                       const_cast<Tensor*>(original_encoder_input_features)->MutableData<T>(),
-                       allocator->Info(),
-                       encoder_input_features);
+  if (num_chunks == 1) {
+    // Use original encoder_input_ids. This requires the input_ids for subgraph is also int32.
+    // Current shape is (batch_size, sequence_length)
+    // Note that we will expand it to (batch_size * num_beams, sequence_length) later.
+    // To avoid cloning input_ids, we use const_cast here since this function does not change its content.
+    Tensor::InitOrtValue(DataTypeImpl::GetType<T>(),
+                         input_features_shape,
+                         const_cast<Tensor*>(original_encoder_input_features)->MutableData<T>(),
+                         allocator->Info(),
+                         encoder_input_features);
+  } else {
+    // Split (original_batch_size, feature_size, num_chunks * chunk_length) into windows of shape
+    // (original_batch_size * num_chunks, feature_size, chunk_length), so that the encoder runs all windows in one batch.
+    ORT_RETURN_IF(original_encoder_input_features->Location().device.Type() != OrtDevice::CPU,
+                  "Splitting input_features into windows requires input_features in CPU memory");
+    const int64_t feature_size = input_features_shape[1];
+    int64_t dims[] = {batch_size, feature_size, static_cast<int64_t>(chunk_length)};
+    TensorShape chunked_shape(&dims[0], 3);
+    Tensor::InitOrtValue(DataTypeImpl::GetType<T>(), chunked_shape, allocator, encoder_input_features);
+
+    const T* source = original_encoder_input_features->Data<T>();
+    T* target = encoder_input_features.GetMutable<Tensor>()->MutableData<T>();
+    for (int64_t i = 0; i < input_features_shape[0]; i++) {
+      for (int64_t chunk = 0; chunk < num_chunks; chunk++) {
+        for (int64_t j = 0; j < feature_size; j++) {
+          const T* row = source + (i * feature_size + j) * num_frames + chunk * chunk_length;
+          std::copy(row, row + chunk_length, target);
+          target += chunk_length;
+        }
+      }
+    }
+  }
 
   // decoder_input_ids is optional.
   if (original_decoder_input_ids_value == nullptr) {
@@ -915,11 +974,26 @@ Status CreateWhisperEncoderInputs(
     const Tensor* original_decoder_input_ids = &(original_decoder_input_ids_value->Get<Tensor>());
     const TensorShape& original_decoder_input_ids_shape = original_decoder_input_ids->Shape();
     ORT_ENFORCE(original_decoder_input_ids_shape.NumDimensions() == 2);
-    Tensor::InitOrtValue(element_type,
-                         original_decoder_input_ids_shape,
-                         const_cast<Tensor*>(original_decoder_input_ids)->MutableData<int32_t>(),
-                         allocator->Info(),
-                         decoder_input_ids);
+    if (num_chunks == 1) {
+      Tensor::InitOrtValue(element_type,
+                           original_decoder_input_ids_shape,
+                           const_cast<Tensor*>(original_decoder_input_ids)->MutableData<int32_t>(),
+                           allocator->Info(),
+                           decoder_input_ids);
+    } else {
+      // Every window of an audio starts with the same forced tokens.
+      const int64_t sequence_length = original_decoder_input_ids_shape[1];
+      int64_t dims[] = {batch_size, sequence_length};
+      TensorShape decoder_input_ids_shape(&dims[0], 2);
+      Tensor::InitOrtValue(element_type, decoder_input_ids_shape, allocator, decoder_input_ids);
+
+      const int32_t* source = original_decoder_input_ids->Data<int32_t>();
+      int32_t* target = decoder_input_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+      for (int64_t i = 0; i < batch_size; i++) {
+        const int32_t* row = source + (i / num_chunks) * sequence_length;
+        target = std::copy(row, row + sequence_length, target);
+      }
+    }
   }
 
   return Status::OK();
@@ -1072,6 +1146,7 @@ template Status CreateWhisperEncoderInputs<float>(
     const Tensor* original_encoder_input_features,
     const OrtValue* original_decoder_input_ids_value,
     int start_token_id,
+    int chunk_length,
     AllocatorPtr allocator,
     OrtValue& encoder_input_features,
     OrtValue& decoder_input_ids);
@@ -1080,6 +1155,7 @@ template Status CreateWhisperEncoderInputs<MLFloat16>(
     const Tensor* original_encoder_input_features,
     const OrtValue* original_decoder_input_ids_value,
     int start_token_id,
+    int chunk_length,
     AllocatorPtr allocator,
     OrtValue& encoder_input_features,
     OrtValue& decoder_input_ids);
@@ -191,6 +191,7 @@ using CreateWhisperEncoderInputsFunc = std::function<Status(
     const Tensor* original_encoder_input_features,
     const OrtValue* original_decoder_input_ids_value,
     int start_token_id,
+    int chunk_length,
     AllocatorPtr allocator,
     OrtValue& encoder_input_ids,
     OrtValue& decoder_input_ids)>;
@@ -377,6 +378,7 @@ Status CreateWhisperEncoderInputs(
     const Tensor* original_encoder_input_features,
     const OrtValue* original_decoder_input_ids_value,
     int start_token_id,
+    int chunk_length,
     AllocatorPtr allocator,
     OrtValue& encoder_input_ids,
     OrtValue& decoder_input_ids);
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/generation_prefix_cache.h"
+#include <algorithm>
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+namespace {
+// FNV-1a hash, which can be updated one token at a time to get hash of every prefix.
+constexpr uint64_t kHashSeed = 14695981039346656037ULL;
+constexpr uint64_t kHashPrime = 1099511628211ULL;
+
+inline uint64_t UpdateHash(uint64_t hash, int32_t token) {
+  auto value = static_cast<uint32_t>(token);
+  for (int i = 0; i < 4; i++) {
+    hash ^= (value & 0xFF);
+    hash *= kHashPrime;
+    value >>= 8;
+  }
+  return hash;
+}
+}  // namespace
+
+int GenerationPrefixCache::Lookup(gsl::span<const int32_t> input_ids, std::vector<OrtValue>& past_state) {
+  if (input_ids.size() < 2) {
+    return 0;
+  }
+
+  // Hash of every proper prefix of input_ids.
+  std::vector<uint64_t> prefix_hashes(input_ids.size() - 1);
+  uint64_t hash = kHashSeed;
+  for (size_t i = 0; i < prefix_hashes.size(); i++) {
+    hash = UpdateHash(hash, input_ids[i]);
+    prefix_hashes[i] = hash;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (size_t length = prefix_hashes.size(); length > 0; length--) {
+    auto range = index_.equal_range(prefix_hashes[length - 1]);
+    for (auto it = range.first; it != range.second; ++it) {
+      const Entry& entry = *it->second;
+      if (entry.tokens.size() == length && std::equal(entry.tokens.begin(), entry.tokens.end(), input_ids.begin())) {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        past_state = entry.past_state;
+        return static_cast<int>(length);
+      }
+    }
+  }
+
+  return 0;
+}
+
+void GenerationPrefixCache::Insert(gsl::span<const int32_t> input_ids, const std::vector<OrtValue>& past_state) {
+  size_t size_in_bytes = input_ids.size_bytes();
+  for (const auto& past : past_state) {
+    size_in_bytes += past.Get<Tensor>().SizeInBytes();
+  }
+  if (input_ids.empty() || size_in_bytes > max_size_in_bytes_) {
+    return;
+  }
+
+  uint64_t hash = kHashSeed;
+  for (int32_t token : input_ids) {
+    hash = UpdateHash(hash, token);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Entry& entry = *it->second;
+    if (entry.tokens.size() == input_ids.size() &&
+        std::equal(entry.tokens.begin(), entry.tokens.end(), input_ids.begin())) {
+      // Already cached by another generation. Mark it as recently used.
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return;
+    }
+  }
+
+  entries_.push_front(Entry{hash, std::vector<int32_t>(input_ids.begin(), input_ids.end()), past_state,
+                            size_in_bytes});
+  index_.emplace(hash, entries_.begin());
+  size_in_bytes_ += size_in_bytes;
+  EvictToBudget();
+}
+
+void GenerationPrefixCache::EvictToBudget() {
+  while (size_in_bytes_ > max_size_in_bytes_ && !entries_.empty()) {
+    auto last = std::prev(entries_.end());
+    auto range = index_.equal_range(last->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == last) {
+        index_.erase(it);
+        break;
+      }
+    }
+    size_in_bytes_ -= last->size_in_bytes;
+    entries_.erase(last);
+  }
+}
+
+size_t GenerationPrefixCache::SizeInBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return size_in_bytes_;
+}
+
+size_t GenerationPrefixCache::NumEntries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
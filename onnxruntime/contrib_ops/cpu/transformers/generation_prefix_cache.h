@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "core/common/gsl.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// This class keeps past state computed for prompts of generation, so that a later generation whose prompt
+// starts with a cached prompt only needs to run the decoder subgraph on the remaining tokens.
+// Entries are keyed by hash of prompt token ids, and are evicted in least recently used order when the total size
+// of cached past state exceeds the budget. It is thread safe.
+class GenerationPrefixCache {
+ public:
+  explicit GenerationPrefixCache(size_t max_size_in_bytes) : max_size_in_bytes_(max_size_in_bytes) {}
+
+  // Find the longest cached prompt that is a proper prefix of input_ids.
+  // Returns the length of the prefix, or 0 when there is none. past_state is the cached past state of the prefix.
+  int Lookup(gsl::span<const int32_t> input_ids, std::vector<OrtValue>& past_state);
+
+  // Add past state of a prompt. past_state is shared with the caller, so it shall not be modified afterwards.
+  void Insert(gsl::span<const int32_t> input_ids, const std::vector<OrtValue>& past_state);
+
+  size_t SizeInBytes() const;
+  size_t NumEntries() const;
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    std::vector<int32_t> tokens;
+    std::vector<OrtValue> past_state;
+    size_t size_in_bytes;
+  };
+
+  void EvictToBudget();
+
+  mutable std::mutex mutex_;
+  std::list<Entry> entries_;  // most recently used first
+  std::unordered_multimap<uint64_t, std::list<Entry>::iterator> index_;
+  const size_t max_size_in_bytes_;
+  size_t size_in_bytes_ = 0;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -182,6 +182,7 @@ struct IGenerationParameters {
 
   // Parameters for whisper model
   bool decoder_output_cross_qk = false;
+  int chunk_length = 0;  // frames per encoder window of long-form audio, 0 to disable
   gsl::span<const int32_t> extra_decoding_ids;
 
   // Token ids are defined below in the order that they appear in the tokenizer
@@ -13,6 +13,7 @@
 #include <functional>
 #include <string>
 #include <utility>
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/providers/cpu/math/top_k.h"
 #include "core/providers/cpu/tensor/utils.h"
@@ -27,6 +28,7 @@
 #include "core/framework/TensorSeq.h"
 #include "core/framework/ort_value.h"
 #include "core/common/gsl.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "contrib_ops/cpu/transformers/greedy_search.h"
 #include "contrib_ops/cpu/transformers/logits_processor.h"
 #include "contrib_ops/cpu/transformers/sequences.h"
@@ -98,6 +100,15 @@ void GreedySearch::Init(const OpKernelInfo& info) {
 
   // Make sure the decoder sub-graph attribute is present for all model types.
   ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
+
+  const std::string prefix_cache_size =
+      info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsGenerationPrefixCacheSizeInBytes, "0");
+  size_t prefix_cache_size_in_bytes = 0;
+  ORT_ENFORCE(TryParseStringWithClassicLocale(prefix_cache_size, prefix_cache_size_in_bytes),
+              "Invalid value of ", kOrtSessionOptionsGenerationPrefixCacheSizeInBytes, ": ", prefix_cache_size);
+  if (prefix_cache_size_in_bytes > 0) {
+    prefix_cache_ = std::make_unique<GenerationPrefixCache>(prefix_cache_size_in_bytes);
+  }
 }
 
 Status GreedySearch::SetupSubgraphExecutionInfo(const SessionState& session_state,
@@ -132,6 +143,12 @@ Status GreedySearch::SetupSubgraphExecutionInfo(const SessionState& session_stat
 
       init_run_gpt_subgraph_ = std::move(res.second);
       init_run_decoder_feeds_fetches_manager_ = init_run_gpt_subgraph_->GetFeedsFetchesManager();
+    } else if (attribute_name == "draft_decoder") {
+      ORT_ENFORCE(draft_gpt_subgraph_ == nullptr, "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+      // The draft decoder has its own number of layers and heads, so it shall not update 'parameters_'.
+      draft_gpt_subgraph_ = std::make_unique<GptSubgraph>(node, attribute_name, subgraph_session_state.GetGraphViewer());
+      ORT_RETURN_IF_ERROR(draft_gpt_subgraph_->Setup(session_state, subgraph_session_state));
+      ORT_RETURN_IF(draft_gpt_subgraph_->IsOutputFloat16(), "draft_decoder subgraph shall have float logits output");
     }
   } else if (parameters_.model_type == IGenerationParameters::kModelTypeT5) {  // encoder-decoder like T5
     ORT_THROW("Not Implemented");
@@ -178,6 +195,14 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
                 "past_present_share_buffer mode must be same for init decoder and decoder subgraphes");
   }
 
+  auto* draft_decoder_session_state = ctx_internal->SubgraphSessionState("draft_decoder");
+  if (draft_gpt_subgraph_ != nullptr) {
+    ORT_ENFORCE(draft_decoder_session_state, "Subgraph SessionState was not found for 'draft_decoder' attribute.");
+    ORT_RETURN_IF(draft_gpt_subgraph_->vocab_size != gpt_subgraph_->vocab_size,
+                  "draft_decoder subgraph shall have same vocabulary size as decoder subgraph: ",
+                  draft_gpt_subgraph_->vocab_size, " vs ", gpt_subgraph_->vocab_size);
+  }
+
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
   // make a copy since we will update the parameters based on inputs later
@@ -206,6 +231,8 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
+      impl.SetPrefixCache(prefix_cache_.get());
+      impl.SetDraftDecoder(draft_decoder_session_state, draft_gpt_subgraph_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -230,6 +257,8 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
+      impl.SetPrefixCache(prefix_cache_.get());
+      impl.SetDraftDecoder(draft_decoder_session_state, draft_gpt_subgraph_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -12,6 +12,7 @@
 #include "contrib_ops/cpu/transformers/subgraph_t5_encoder.h"
 #include "contrib_ops/cpu/transformers/subgraph_t5_decoder.h"
 #include "contrib_ops/cpu/transformers/generation_device_helper.h"
+#include "contrib_ops/cpu/transformers/generation_prefix_cache.h"
 
 namespace onnxruntime {
 class FeedsFetchesManager;
@@ -113,6 +114,10 @@ class GreedySearch : public IControlFlowKernel {
   std::unique_ptr<GptSubgraph> init_run_gpt_subgraph_;
   std::unique_ptr<GptSubgraph> gpt_subgraph_;
 
+  // Relevant only for GPT2. The draft_gpt_subgraph_ (if the `draft_decoder` attribute is present) proposes
+  // tokens that are verified by gpt_subgraph_ in speculative decoding.
+  std::unique_ptr<GptSubgraph> draft_gpt_subgraph_;
+
   // Relevant only for T5
   // Same concept as above.
   // The encoder will be used for the first run and the decoder will
@@ -129,6 +134,9 @@ class GreedySearch : public IControlFlowKernel {
   GreedySearchParameters parameters_;
 
   bool has_init_decoder_ = false;
+
+  // Past state of prompts shared by runs of this node. It is nullptr when disabled by session config.
+  std::unique_ptr<GenerationPrefixCache> prefix_cache_;
 };
 
 }  // namespace transformers
@@ -7,6 +7,7 @@
 
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/generation_prefix_cache.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -21,6 +22,56 @@ std::pair<Status, std::unique_ptr<GptSubgraph>> CreateGptSubgraphAndUpdateParame
     const std::string& attribute_name,
     const SessionState& subgraph_session_state,
     /*out*/ BeamSearchParameters& parameters);
+
+// Copy the given rows along the batch axis of a CPU tensor to a new tensor.
+inline void GatherBatchRows(const OrtValue& input,
+                            size_t batch_axis,
+                            gsl::span<const int32_t> rows,
+                            AllocatorPtr allocator,
+                            OrtValue& output) {
+  const Tensor& input_tensor = input.Get<Tensor>();
+  const TensorShape& input_shape = input_tensor.Shape();
+  TensorShape output_shape = input_shape;
+  output_shape[batch_axis] = static_cast<int64_t>(rows.size());
+  Tensor::InitOrtValue(input_tensor.DataType(), output_shape, std::move(allocator), output);
+
+  const size_t outer_size = onnxruntime::narrow<size_t>(input_shape.SizeToDimension(batch_axis));
+  const size_t input_batch_size = onnxruntime::narrow<size_t>(input_shape[batch_axis]);
+  const size_t row_bytes = onnxruntime::narrow<size_t>(input_shape.SizeFromDimension(batch_axis + 1)) *
+                           input_tensor.DataType()->Size();
+  const auto* source = static_cast<const uint8_t*>(input_tensor.DataRaw());
+  auto* target = static_cast<uint8_t*>(output.GetMutable<Tensor>()->MutableDataRaw());
+  for (size_t i = 0; i < outer_size; i++) {
+    for (size_t j = 0; j < rows.size(); j++) {
+      memcpy(target + (i * rows.size() + j) * row_bytes,
+             source + (i * input_batch_size + static_cast<size_t>(rows[j])) * row_bytes,
+             row_bytes);
+    }
+  }
+}
+
+// Keep the first sequence_length entries of a CPU past state tensor with shape (2, batch_size, num_heads, past_seq_len,
+// head_size) in a new tensor.
+inline void TruncatePastState(const OrtValue& past,
+                              int64_t sequence_length,
+                              AllocatorPtr allocator,
+                              OrtValue& output) {
+  const Tensor& past_tensor = past.Get<Tensor>();
+  const TensorShape& past_shape = past_tensor.Shape();
+  TensorShape output_shape = past_shape;
+  output_shape[3] = sequence_length;
+  Tensor::InitOrtValue(past_tensor.DataType(), output_shape, std::move(allocator), output);
+
+  const size_t num_chunks = onnxruntime::narrow<size_t>(past_shape.SizeToDimension(3));
+  const size_t row_bytes = onnxruntime::narrow<size_t>(past_shape[4]) * past_tensor.DataType()->Size();
+  const size_t source_chunk_bytes = onnxruntime::narrow<size_t>(past_shape[3]) * row_bytes;
+  const size_t target_chunk_bytes = onnxruntime::narrow<size_t>(sequence_length) * row_bytes;
+  const auto* source = static_cast<const uint8_t*>(past_tensor.DataRaw());
+  auto* target = static_cast<uint8_t*>(output.GetMutable<Tensor>()->MutableDataRaw());
+  for (size_t i = 0; i < num_chunks; i++) {
+    memcpy(target + i * target_chunk_bytes, source + i * source_chunk_bytes, target_chunk_bytes);
+  }
+}
 }  // namespace gpt_details
 
 // Greedy search implementation for GPT-2 model.
@@ -79,6 +130,17 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
   }
 #endif
 
+  // Set the cache of prompt past state. It could be nullptr when prefix cache is disabled.
+  void SetPrefixCache(GenerationPrefixCache* prefix_cache) {
+    prefix_cache_ = prefix_cache;
+  }
+
+  // Set the draft decoder used to propose tokens for speculative decoding. It is not used when draft_subgraph is nullptr.
+  void SetDraftDecoder(const SessionState* draft_session_state, GptSubgraph* draft_subgraph) {
+    draft_session_state_ = draft_session_state;
+    draft_subgraph_ = draft_subgraph;
+  }
+
   // Execute beam search in iterations util stopping criteria is reached.
   // In each iteration, GPT subgraph is called, and next token for each sequence is generated.
   Status Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
@@ -101,6 +163,74 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
       gsl::span<const int32_t> next_tokens,
       int past_sequence_length);
 
+  // Whether sequences that have finished can be evicted from the batch of the decoder subgraph.
+  // Only greedy search on CPU without past-present share buffer is supported. Sampling is excluded since the
+  // random numbers drawn for a sequence depend on the logits of the whole batch.
+  bool CanEvictFinishedSequences() const {
+    return !this->IsCuda() &&
+           !std::is_same<ParametersT, SamplingParameters>::value &&
+           !gpt_subgraph_.past_present_share_buffer_ &&
+           !gpt_subgraph_.has_decoder_masked_attention_;
+  }
+
+  // Whether past state of the prompt could be reused from or added to the prefix cache. Only a single prompt on CPU
+  // without padding, attention mask input, init decoder or past-present share buffer is supported.
+  bool CanUsePrefixCache(gsl::span<const int32_t> input_ids) const {
+    return prefix_cache_ != nullptr &&
+           !this->IsCuda() &&
+           this->parameters_->BatchBeamSize() == 1 &&
+           init_run_gpt_subgraph_ == nullptr &&
+           !gpt_subgraph_.past_present_share_buffer_ &&
+           this->context_.GetInputOrtValue(6) == nullptr &&
+           std::find(input_ids.begin(), input_ids.end(), this->parameters_->pad_token_id) == input_ids.end();
+  }
+
+  // Replace the initial feeds with the tokens after a cached prefix of the prompt and the past state of the prefix.
+  // Returns the length of the prefix, or 0 when the cache has no prefix of the prompt.
+  int ApplyCachedPrefix(gsl::span<const int32_t> input_ids, std::vector<OrtValue>& feeds);
+
+  // Whether tokens could be proposed by the draft decoder and verified by the decoder. It has same constraints as
+  // prefix cache, and the draft decoder shall not use past-present share buffer.
+  bool CanUseSpeculativeDecoding(gsl::span<const int32_t> input_ids) const {
+    return draft_subgraph_ != nullptr &&
+           this->parameters_->num_speculative_tokens > 0 &&
+           !this->IsCuda() &&
+           this->parameters_->BatchBeamSize() == 1 &&
+           init_run_gpt_subgraph_ == nullptr &&
+           !gpt_subgraph_.past_present_share_buffer_ &&
+           !draft_subgraph_->past_present_share_buffer_ &&
+           this->context_.GetInputOrtValue(6) == nullptr &&
+           std::find(input_ids.begin(), input_ids.end(), this->parameters_->pad_token_id) == input_ids.end();
+  }
+
+  // Run a decoder subgraph on the tokens after past_length. The past state in feeds is replaced by the present state.
+  Status RunDecoderOnTokens(const SessionState& session_state,
+                            const FeedsFetchesManager& feeds_fetches_manager,
+                            const GptSubgraph& subgraph,
+                            gsl::span<const int32_t> tokens,
+                            int past_length,
+                            std::vector<OrtValue>& feeds,
+                            OrtValue& logits);
+
+  // Keep past state of the first past_length tokens in feeds.
+  void TruncatePastFeeds(const GptSubgraph& subgraph, int past_length, std::vector<OrtValue>& feeds);
+
+  // Generate all tokens with speculative decoding. In each round, the draft decoder proposes a few tokens one by one,
+  // then the decoder runs once on all of them. Tokens are generated from the decoder logits of each position with the
+  // same logits processors, sampling and stopping criteria as a normal step, and proposed tokens are accepted while
+  // they match the generated ones. Therefore the output is same as generating without the draft decoder.
+  Status ExecuteSpeculative(const FeedsFetchesManager& feeds_fetches_manager,
+                            std::vector<OrtValue>& feeds,
+                            GreedySearchState<T>& greedy_state,
+                            SamplingState<T>& sampling_state);
+
+  // Remove the rows of finished sequences from inputs of the decoder subgraph. active_rows holds the batch index of
+  // each row in the decoder batch, and is updated to the sequences that are still being generated.
+  void EvictFinishedSequences(std::vector<OrtValue>& feeds,
+                              OrtValue& position_ids,
+                              gsl::span<const bool> eos_meet,
+                              std::vector<int32_t>& active_rows);
+
   const SessionState* init_run_decoder_session_state_ = nullptr;
   GptSubgraph* init_run_gpt_subgraph_ = nullptr;
   GptSubgraph& gpt_subgraph_;
@@ -116,6 +246,11 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
 
   const void* cuda_device_prop_ = nullptr;
   int cuda_device_arch_ = 0;
+
+  GenerationPrefixCache* prefix_cache_ = nullptr;
+
+  const SessionState* draft_session_state_ = nullptr;
+  GptSubgraph* draft_subgraph_ = nullptr;
 };
 
 template <typename T, typename ParametersT>
@@ -187,6 +322,256 @@ Status GreedySearchGpt<T, ParametersT>::UpdateFeeds(
                             false);
 }
 
+template <typename T, typename ParametersT>
+int GreedySearchGpt<T, ParametersT>::ApplyCachedPrefix(gsl::span<const int32_t> input_ids,
+                                                       std::vector<OrtValue>& feeds) {
+  std::vector<OrtValue> past_state;
+  const int prefix_length = prefix_cache_->Lookup(input_ids, past_state);
+  if (prefix_length == 0) {
+    return 0;
+  }
+
+  // input_ids and position_ids only keep the tokens after the prefix. attention_mask still covers the whole prompt.
+  const int64_t suffix_length = static_cast<int64_t>(input_ids.size()) - prefix_length;
+  int64_t dims[] = {1, suffix_length};
+  TensorShape suffix_shape(&dims[0], 2);
+  auto element_type = DataTypeImpl::GetType<int32_t>();
+  OrtValue suffix_input_ids;
+  Tensor::InitOrtValue(element_type, suffix_shape, this->temp_space_allocator_, suffix_input_ids);
+  OrtValue suffix_position_ids;
+  Tensor::InitOrtValue(element_type, suffix_shape, this->temp_space_allocator_, suffix_position_ids);
+  int32_t* input_ids_data = suffix_input_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  int32_t* position_data = suffix_position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int64_t i = 0; i < suffix_length; i++) {
+    input_ids_data[i] = input_ids[static_cast<size_t>(prefix_length + i)];
+    position_data[i] = static_cast<int32_t>(prefix_length + i);
+  }
+  feeds[0] = suffix_input_ids;
+  feeds[1] = suffix_position_ids;
+
+  const int first_past_input_index = gpt_subgraph_.GetFirstPastInputIndex();
+  for (int i = 0; i < gpt_subgraph_.num_layers; i++) {
+    feeds[first_past_input_index + i] = past_state[i];
+  }
+  return prefix_length;
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::RunDecoderOnTokens(const SessionState& session_state,
+                                                           const FeedsFetchesManager& feeds_fetches_manager,
+                                                           const GptSubgraph& subgraph,
+                                                           gsl::span<const int32_t> tokens,
+                                                           int past_length,
+                                                           std::vector<OrtValue>& feeds,
+                                                           OrtValue& logits) {
+  const int64_t num_tokens = static_cast<int64_t>(tokens.size());
+  auto element_type = DataTypeImpl::GetType<int32_t>();
+  int64_t dims[] = {1, num_tokens};
+  TensorShape tokens_shape(&dims[0], 2);
+  OrtValue input_ids;
+  Tensor::InitOrtValue(element_type, tokens_shape, this->temp_space_allocator_, input_ids);
+  gsl::copy(tokens, input_ids.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>());
+
+  OrtValue position_ids;
+  Tensor::InitOrtValue(element_type, tokens_shape, this->temp_space_allocator_, position_ids);
+  int32_t* position_data = position_ids.GetMutable<Tensor>()->MutableData<int32_t>();
+  for (int64_t i = 0; i < num_tokens; i++) {
+    position_data[i] = static_cast<int32_t>(past_length + i);
+  }
+
+  // There is no padding, so attention mask is all ones.
+  int64_t mask_dims[] = {1, past_length + num_tokens};
+  TensorShape mask_shape(&mask_dims[0], 2);
+  OrtValue attention_mask;
+  Tensor::InitOrtValue(element_type, mask_shape, this->temp_space_allocator_, attention_mask);
+  gsl::span<int32_t> mask_data = attention_mask.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>();
+  std::fill(mask_data.begin(), mask_data.end(), 1);
+
+  feeds[0] = input_ids;
+  feeds[1] = position_ids;
+  feeds[2] = attention_mask;
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(session_state,
+                                             feeds_fetches_manager,
+                                             feeds,
+                                             fetches,
+                                             {},
+                                             ExecutionMode::ORT_SEQUENTIAL,
+                                             this->context_.GetTerminateFlag(),
+                                             this->context_.Logger(),
+                                             this->ort_stream_));
+
+  logits = fetches[0];
+  for (int i = 0; i < subgraph.num_layers; i++) {
+    feeds[subgraph.GetFirstPastInputIndex() + i] = fetches[subgraph.GetFirstPresentOutputIndex() + i];
+  }
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+void GreedySearchGpt<T, ParametersT>::TruncatePastFeeds(const GptSubgraph& subgraph,
+                                                        int past_length,
+                                                        std::vector<OrtValue>& feeds) {
+  for (int i = 0; i < subgraph.num_layers; i++) {
+    OrtValue& past = feeds[subgraph.GetFirstPastInputIndex() + i];
+    if (past.Get<Tensor>().Shape()[3] > past_length) {
+      OrtValue truncated;
+      gpt_details::TruncatePastState(past, past_length, this->temp_space_allocator_, truncated);
+      past = truncated;
+    }
+  }
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::ExecuteSpeculative(const FeedsFetchesManager& feeds_fetches_manager,
+                                                           std::vector<OrtValue>& feeds,
+                                                           GreedySearchState<T>& greedy_state,
+                                                           SamplingState<T>& sampling_state) {
+  const ParametersT* parameters = this->parameters_;
+
+  // Initial feeds of the draft decoder hold empty past state and implicit inputs.
+  std::vector<OrtValue> draft_feeds;
+  OrtValue draft_input_ids;
+  IAllocatorUniquePtr<char> draft_buffer;
+  std::vector<int32_t> draft_sequence_lengths(1);
+  gsl::span<int32_t> draft_sequence_lengths_span(draft_sequence_lengths);
+  ORT_RETURN_IF_ERROR(draft_subgraph_->CreateInitialFeeds(*this->context_.Input<Tensor>(0),
+                                                          this->implicit_inputs_,
+                                                          1,  // num_beams
+                                                          parameters->pad_token_id,
+                                                          draft_sequence_lengths_span,
+                                                          draft_input_ids,
+                                                          nullptr,
+                                                          draft_feeds,
+                                                          this->create_inputs_func_,
+                                                          this->add_to_feeds_func_,
+                                                          draft_buffer,
+                                                          this->ort_stream_));
+  const FeedsFetchesManager& draft_feeds_fetches_manager = *draft_subgraph_->GetFeedsFetchesManager();
+
+  // Number of leading tokens of the sequence that are in past state of the decoder and the draft decoder.
+  int past_length = 0;
+  int draft_past_length = 0;
+  int current_length = parameters->sequence_length;
+  int step = 0;
+
+  std::vector<int32_t> candidates;  // tokens of the sequence followed by proposed tokens
+  OrtValue logits;
+  while (current_length < parameters->max_length) {
+    gsl::span<const int32_t> sequence = greedy_state.sequences.GetSequence(0);
+    candidates.assign(sequence.begin(), sequence.end());
+
+    // The last token before max_length is generated by the decoder, so there is no need to propose it.
+    const int num_proposals = std::min(parameters->num_speculative_tokens,
+                                       parameters->max_length - current_length - 1);
+    for (int i = 0; i < num_proposals; i++) {
+      gsl::span<const int32_t> new_tokens = gsl::make_span(candidates).subspan(draft_past_length);
+      ORT_RETURN_IF_ERROR(RunDecoderOnTokens(*draft_session_state_, draft_feeds_fetches_manager, *draft_subgraph_,
+                                             new_tokens, draft_past_length, draft_feeds, logits));
+      draft_past_length = static_cast<int>(candidates.size());
+
+      // Propose the token with highest logit of the last position.
+      const Tensor& draft_logits = logits.Get<Tensor>();
+      const int64_t vocab_size = draft_logits.Shape()[2];
+      const float* last_logits = draft_logits.Data<float>() + (draft_logits.Shape()[1] - 1) * vocab_size;
+      candidates.push_back(static_cast<int32_t>(std::max_element(last_logits, last_logits + vocab_size) -
+                                                last_logits));
+    }
+
+    // Run the decoder once on all tokens that are not in its past state, including the proposed ones.
+    gsl::span<const int32_t> new_tokens = gsl::make_span(candidates).subspan(past_length);
+    ORT_RETURN_IF_ERROR(RunDecoderOnTokens(this->decoder_session_state_, feeds_fetches_manager, gpt_subgraph_,
+                                           new_tokens, past_length, feeds, logits));
+
+    // Logits at row r of the decoder output are for the token at position past_length + r + 1.
+    const Tensor& logits_tensor = logits.Get<Tensor>();
+    const int64_t vocab_size = logits_tensor.Shape()[2];
+    int64_t dims[] = {1, 1, vocab_size};
+    TensorShape position_logits_shape(&dims[0], 3);
+    bool finished = false;
+    for (int i = 0; i <= num_proposals; i++) {
+      const int64_t row = static_cast<int64_t>(current_length) - 1 - past_length;
+      OrtValue position_logits;
+      Tensor::InitOrtValue(logits_tensor.DataType(), position_logits_shape,
+                           const_cast<T*>(logits_tensor.Data<T>()) + row * vocab_size,
+                           logits_tensor.Location(), position_logits);
+
+      gsl::span<int32_t> next_tokens;
+      ORT_RETURN_IF_ERROR(this->GenerateNextToken(position_logits,
+                                                  next_tokens,
+                                                  greedy_state,
+                                                  sampling_state,
+                                                  ++step,
+                                                  parameters->eos_token_id));
+      ++current_length;
+
+      if (greedy_state.eos_meet[0] || current_length >= parameters->max_length) {
+        finished = true;
+        break;
+      }
+
+      // Stop at the first generated token that differs from the proposal, or at the token after all proposals.
+      if (i == num_proposals || next_tokens[0] != candidates[current_length - 1]) {
+        break;
+      }
+    }
+
+    if (finished) {
+      break;
+    }
+
+    // The last generated token is not in past state yet. Discard past state of rejected proposals.
+    past_length = current_length - 1;
+    TruncatePastFeeds(gpt_subgraph_, past_length, feeds);
+    if (draft_past_length > past_length) {
+      draft_past_length = past_length;
+      TruncatePastFeeds(*draft_subgraph_, draft_past_length, draft_feeds);
+    }
+  }
+
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+void GreedySearchGpt<T, ParametersT>::EvictFinishedSequences(std::vector<OrtValue>& feeds,
+                                                             OrtValue& position_ids,
+                                                             gsl::span<const bool> eos_meet,
+                                                             std::vector<int32_t>& active_rows) {
+  std::vector<int32_t> kept_rows;  // rows in the current decoder batch to keep
+  kept_rows.reserve(active_rows.size());
+  for (size_t j = 0; j < active_rows.size(); j++) {
+    if (!eos_meet[active_rows[j]]) {
+      kept_rows.push_back(static_cast<int32_t>(j));
+    }
+  }
+  if (kept_rows.size() == active_rows.size()) {
+    return;
+  }
+
+  // input_ids, position_ids and attention_mask have batch in dimension 0.
+  // Past state has shape like (2, batch_size, num_heads, past_seq_len, head_size).
+  OrtValue gathered;
+  gpt_details::GatherBatchRows(feeds[0], 0, kept_rows, this->temp_space_allocator_, gathered);
+  feeds[0] = gathered;
+  gpt_details::GatherBatchRows(position_ids, 0, kept_rows, this->temp_space_allocator_, gathered);
+  position_ids = gathered;
+  feeds[1] = position_ids;
+  gpt_details::GatherBatchRows(feeds[2], 0, kept_rows, this->temp_space_allocator_, gathered);
+  feeds[2] = gathered;
+  const int first_past_input_index = gpt_subgraph_.GetFirstPastInputIndex();
+  for (int i = 0; i < gpt_subgraph_.num_layers; i++) {
+    gpt_details::GatherBatchRows(feeds[first_past_input_index + i], 1, kept_rows, this->temp_space_allocator_,
+                                 gathered);
+    feeds[first_past_input_index + i] = gathered;
+  }
+
+  for (size_t j = 0; j < kept_rows.size(); j++) {
+    active_rows[j] = active_rows[kept_rows[j]];
+  }
+  active_rows.resize(kept_rows.size());
+}
+
 template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                                                 const FeedsFetchesManager& feeds_fetches_manager) {
@@ -254,6 +639,17 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                            parameters->max_length,
                            parameters->sequence_length);
 
+  const bool use_speculative_decoding = CanUseSpeculativeDecoding(input_ids);
+  if (use_speculative_decoding) {
+    ORT_RETURN_IF_ERROR(ExecuteSpeculative(feeds_fetches_manager, feeds, greedy_state, sampling_state));
+  }
+
+  // Reuse past state of the longest cached prefix of the prompt, so that the first run only processes the rest.
+  const bool use_prefix_cache = !use_speculative_decoding && CanUsePrefixCache(input_ids);
+  if (use_prefix_cache) {
+    ApplyCachedPrefix(input_ids, feeds);
+  }
+
 #ifdef DEBUG_GENERATION
   const IConsoleDumper* dumper = this->GetConsoleDumper();
 #endif
@@ -268,7 +664,18 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
-  int current_length = parameters->sequence_length;
+  // Batch index of each row in the decoder subgraph batch. Rows of finished sequences are evicted from the
+  // decoder batch when CanEvictFinishedSequences(), so that long sequences do not pay for finished ones.
+  const bool evict_finished_sequences = CanEvictFinishedSequences();
+  std::vector<int32_t> active_rows(static_cast<size_t>(parameters->BatchBeamSize()));
+  for (size_t i = 0; i < active_rows.size(); i++) {
+    active_rows[i] = static_cast<int32_t>(i);
+  }
+  std::vector<int32_t> active_next_tokens;
+  OrtValue full_batch_logits;
+
+  // All tokens have been generated when speculative decoding is used, so the loop below is skipped.
+  int current_length = use_speculative_decoding ? parameters->max_length : parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
 #ifdef DEBUG_GENERATION
@@ -312,10 +719,35 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 
     ORT_RETURN_IF_ERROR(status);
 
-    const OrtValue& logits = fetches[0];
+    if (iteration_counter == 1 && use_prefix_cache) {
+      const auto first_present = fetches.begin() + gpt_subgraph_.GetFirstPresentOutputIndex();
+      prefix_cache_->Insert(input_ids, std::vector<OrtValue>(first_present, first_present + gpt_subgraph_.num_layers));
+    }
+
+    const OrtValue* logits = &fetches[0];
+    if (active_rows.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+      // Scatter logits of the decoder batch to the whole batch. Finished sequences only produce pad tokens,
+      // so their logits are left as zeros.
+      const Tensor& active_logits = logits->Get<Tensor>();
+      TensorShape logits_shape = active_logits.Shape();
+      logits_shape[0] = parameters->BatchBeamSize();
+      if (!full_batch_logits.IsAllocated() || full_batch_logits.Get<Tensor>().Shape() != logits_shape) {
+        Tensor::InitOrtValue(active_logits.DataType(), logits_shape, this->temp_space_allocator_, full_batch_logits);
+      }
+      Tensor* logits_tensor = full_batch_logits.GetMutable<Tensor>();
+      memset(logits_tensor->MutableDataRaw(), 0, logits_tensor->SizeInBytes());
+      const size_t row_bytes = active_logits.SizeInBytes() / active_rows.size();
+      for (size_t j = 0; j < active_rows.size(); j++) {
+        memcpy(static_cast<uint8_t*>(logits_tensor->MutableDataRaw()) + active_rows[j] * row_bytes,
+               static_cast<const uint8_t*>(active_logits.DataRaw()) + j * row_bytes,
+               row_bytes);
+      }
+      logits = &full_batch_logits;
+    }
+
     gsl::span<int32_t> next_tokens;
 
-    ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
+    ORT_RETURN_IF_ERROR(this->GenerateNextToken(*logits,
                                                 next_tokens,
                                                 greedy_state,
                                                 sampling_state,
@@ -361,10 +793,23 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     if (current_length < parameters->max_length) {
       bool increase_position = (iteration_counter > 1);
 
+      gsl::span<const int32_t> decoder_next_tokens = ReinterpretAsSpan<const int32_t>(next_tokens);
+      if (active_rows.size() < next_tokens.size()) {
+        active_next_tokens.resize(active_rows.size());
+        for (size_t j = 0; j < active_rows.size(); j++) {
+          active_next_tokens[j] = next_tokens[active_rows[j]];
+        }
+        decoder_next_tokens = active_next_tokens;
+      }
+
       ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
                                       position_ids, increase_position,
-                                      ReinterpretAsSpan<const int32_t>(next_tokens),
+                                      decoder_next_tokens,
                                       current_length - 1));
+
+      if (evict_finished_sequences) {
+        EvictFinishedSequences(feeds, position_ids, eos_meet, active_rows);
+      }
     }
     if (gpt_subgraph_.past_present_share_buffer_) {
       // clear fetched values before presents[]
@@ -13,6 +13,9 @@ namespace transformers {
 struct GreedySearchParameters : public BeamSearchParameters {
   int BatchBeamSize() const { return batch_size; }
 
+  // Maximum number of tokens proposed by the draft decoder in each round of speculative decoding.
+  int num_speculative_tokens = 0;
+
   void ParseFromAttributes(const OpKernelInfo& info) override;
 
   void ParseFromInputs(OpKernelContext* context);
@@ -6,6 +6,7 @@
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
 #include "core/common/span_utils.h"
+#include "core/util/math_cpuonly.h"
 #include "core/providers/cpu/math/softmax_shared.h"
 #include "contrib_ops/cpu/transformers/logits_processor.h"
 #include "contrib_ops/cpu/transformers/dump_tensor.h"
@@ -17,19 +18,6 @@ namespace onnxruntime {
 namespace contrib {
 namespace transformers {
 
-// Interface for all scorers for beam search or beam sample.
-template <typename T>
-MinLengthLogitsProcessor<T>::MinLengthLogitsProcessor(int min_length, int eos_token_id)
-    : min_length_(min_length), eos_token_id_(eos_token_id) {}
-
-template <typename T>
-void MinLengthLogitsProcessor<T>::Process(const ISequences* sequences,
-                                          NextTokenScores<T>& next_token_scores) {
-  if (sequences->GetSequenceLength() < min_length_) {
-    next_token_scores.SetScore(eos_token_id_, std::numeric_limits<T>::lowest());
-  }
-}
-
 template <typename T>
 RepetitionPenaltyLogitsProcessor<T>::RepetitionPenaltyLogitsProcessor(float penalty) : penalty_(penalty) {
 }
@@ -95,29 +83,6 @@ void NoRepeatNGramLogitsProcessor<T>::Process(const ISequences* sequences,
   }
 }
 
-template <typename T>
-VocabMaskLogitsProcessor<T>::VocabMaskLogitsProcessor(const gsl::span<const int32_t>& vocab_mask)
-    : vocab_mask_(vocab_mask) {
-}
-
-template <typename T>
-void VocabMaskLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
-                                          NextTokenScores<T>& next_token_scores) {
-  assert(!vocab_mask_.empty());
-
-  // Process vocabulary mask and set tokens with mask value 0 to -inf.
-  T* p = next_token_scores.scores.data();
-  // next_token_scores shape (batch_size * num_beams, vocab_size)
-  // vocab_mask shape (vocab_size).
-  for (int i = 0; i < next_token_scores.batch_beam_size; i++) {
-    for (int j = 0; j < next_token_scores.vocab_size; j++, p++) {
-      if (vocab_mask_[j] == 0) {
-        *p = std::numeric_limits<T>::lowest();
-      }
-    }
-  }
-}
-
 template <typename T>
 PrefixVocabMaskLogitsProcessor<T>::PrefixVocabMaskLogitsProcessor(const gsl::span<const int32_t>& prefix_vocab_mask,
                                                                   int batch_size)
@@ -150,41 +115,54 @@ void PrefixVocabMaskLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
 }
 
 template <typename T>
-TemperatureLogitsProcessor<T>::TemperatureLogitsProcessor(float temperature) : temperature_(temperature) {
+ElementwiseLogitsProcessor<T>::ElementwiseLogitsProcessor(const gsl::span<const int32_t>& vocab_mask,
+                                                          int min_length, int eos_token_id,
+                                                          float temperature,
+                                                          const gsl::span<const int32_t>& presence_mask,
+                                                          float presence_penalty)
+    : vocab_mask_(vocab_mask),
+      min_length_(min_length),
+      eos_token_id_(eos_token_id),
+      temperature_(temperature),
+      presence_mask_(presence_mask),
+      presence_penalty_(presence_penalty) {
 }
 
 template <typename T>
-void TemperatureLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
+void ElementwiseLogitsProcessor<T>::Process(const ISequences* sequences,
                                             NextTokenScores<T>& next_token_scores) {
-  if (temperature_ == 1.0f) {
-    return;
-  }
-
-  T* p = next_token_scores.scores.data();
-  for (size_t i = 0; i < next_token_scores.scores.size(); i++) {
-    *p /= temperature_;
-    ++p;
-  }
-}
-
-template <typename T>
-PresencePenaltyLogitsProcessor<T>::PresencePenaltyLogitsProcessor(const gsl::span<const int32_t>& presence_mask,
-                                                                  float presence_penalty)
-    : presence_mask_(presence_mask), presence_penalty_(presence_penalty) {
-}
-
-template <typename T>
-void PresencePenaltyLogitsProcessor<T>::Process(const ISequences*,
-                                                NextTokenScores<T>& next_token_scores) {
-  if (presence_penalty_ == 0.0f) {
-    return;
+  if (sequences->GetSequenceLength() < min_length_) {
+    next_token_scores.SetScore(eos_token_id_, std::numeric_limits<T>::lowest());
   }
 
-  assert(!presence_mask_.empty());
-
-  T* p = next_token_scores.scores.data();
-  for (size_t i = 0; i < next_token_scores.scores.size(); i++) {
-    *p -= presence_mask_[i] * presence_penalty_;
+  // next_token_scores shape (batch_size * num_beams, vocab_size)
+  // vocab_mask shape (vocab_size), presence_mask shape (batch_size * num_beams, vocab_size).
+  const Eigen::Index vocab_size = next_token_scores.vocab_size;
+  const T lowest = std::numeric_limits<T>::lowest();
+  const T temperature = static_cast<T>(temperature_);
+  const T presence_penalty = static_cast<T>(presence_penalty_);
+  const bool has_vocab_mask = !vocab_mask_.empty();
+  const bool has_presence_penalty = presence_penalty_ != 0.0f;
+  ConstEigenVectorArrayMap<int32_t> vocab_mask(vocab_mask_.data(), has_vocab_mask ? vocab_size : 0);
+  // the presence mask has a row per batch entry, shared by its beams
+  const int presence_rows = has_presence_penalty ? static_cast<int>(presence_mask_.size() / vocab_size) : 1;
+  const int num_beams = std::max(next_token_scores.batch_beam_size / presence_rows, 1);
+  for (int i = 0; i < next_token_scores.batch_beam_size; i++) {
+    EigenVectorArrayMap<T> scores(next_token_scores.GetScores(i).data(), vocab_size);
+    if (has_presence_penalty) {
+      ConstEigenVectorArrayMap<int32_t> presence_mask(presence_mask_.data() + (i / num_beams) * vocab_size,
+                                                      vocab_size);
+      if (has_vocab_mask) {
+        scores = (vocab_mask == 0).select(lowest, scores) / temperature -
+                 presence_mask.cast<T>() * presence_penalty;
+      } else {
+        scores = scores / temperature - presence_mask.cast<T>() * presence_penalty;
+      }
+    } else if (has_vocab_mask) {
+      scores = (vocab_mask == 0).select(lowest, scores) / temperature;
+    } else {
+      scores /= temperature;
+    }
   }
 }
 
@@ -53,19 +53,6 @@ class ILogitsProcessor {
                        NextTokenScores<T>& next_token_scores) = 0;
 };
 
-template <typename T>
-class MinLengthLogitsProcessor : public ILogitsProcessor<T> {
- public:
-  MinLengthLogitsProcessor(int min_length, int eos_token_id);
-
-  void Process(const ISequences* sequences,
-               NextTokenScores<T>& next_token_scores) override;
-
- private:
-  int min_length_;
-  int eos_token_id_;
-};
-
 template <typename T>
 class RepetitionPenaltyLogitsProcessor : public ILogitsProcessor<T> {
  public:
@@ -90,18 +77,6 @@ class NoRepeatNGramLogitsProcessor : public ILogitsProcessor<T> {
   int ngram_size_;
 };
 
-template <typename T>
-class VocabMaskLogitsProcessor : public ILogitsProcessor<T> {
- public:
-  VocabMaskLogitsProcessor(const gsl::span<const int32_t>& vocab_mask);
-
-  void Process(const ISequences* sequences,
-               NextTokenScores<T>& next_token_scores) override;
-
- private:
-  gsl::span<const int32_t> vocab_mask_;
-};
-
 template <typename T>
 class PrefixVocabMaskLogitsProcessor : public ILogitsProcessor<T> {
  public:
@@ -115,16 +90,28 @@ class PrefixVocabMaskLogitsProcessor : public ILogitsProcessor<T> {
   const int batch_size_;
 };
 
+// Applies the processors that update every score in a single vectorized pass over the scores of each beam, in this
+// order: vocabulary mask, minimum length, temperature and presence penalty.
 template <typename T>
-class TemperatureLogitsProcessor : public ILogitsProcessor<T> {
+class ElementwiseLogitsProcessor : public ILogitsProcessor<T> {
  public:
-  TemperatureLogitsProcessor(float temperature);
+  // vocab_mask and presence_mask are empty, min_length is 0, temperature is 1 and presence_penalty is 0 when the
+  // corresponding processor is not used.
+  ElementwiseLogitsProcessor(const gsl::span<const int32_t>& vocab_mask,
+                             int min_length, int eos_token_id,
+                             float temperature,
+                             const gsl::span<const int32_t>& presence_mask, float presence_penalty);
 
   void Process(const ISequences* sequences,
                NextTokenScores<T>& next_token_scores) override;
 
  private:
+  gsl::span<const int32_t> vocab_mask_;
+  int min_length_;
+  int eos_token_id_;
   float temperature_;
+  gsl::span<const int32_t> presence_mask_;
+  float presence_penalty_;
 };
 
 // template <typename T>
@@ -142,20 +129,6 @@ class TemperatureLogitsProcessor : public ILogitsProcessor<T> {
 //   onnxruntime::concurrency::ThreadPool* thread_pool_;
 // };
 
-template <typename T>
-class PresencePenaltyLogitsProcessor : public ILogitsProcessor<T> {
- public:
-  PresencePenaltyLogitsProcessor(const gsl::span<const int32_t>& presence_mask,
-                                 float presence_penalty);
-
-  void Process(const ISequences* sequences,
-               NextTokenScores<T>& next_token_scores) override;
-
- private:
-  gsl::span<const int32_t> presence_mask_;
-  float presence_penalty_;
-};
-
 template <typename T>
 class TimestampLogitsProcessor : public ILogitsProcessor<T> {
  public:
@@ -318,11 +291,8 @@ class LogitsProcessorList : public ILogitsProcessorList {
       processor_list_.push_back(no_repeat_ngram_processor_.get());
     }
 
-    if (!parameters.vocab_mask.empty()) {
-      vocab_mask_processor_ = std::make_unique<VocabMaskLogitsProcessor<float>>(parameters.vocab_mask);
-      processor_list_.push_back(vocab_mask_processor_.get());
-    }
-
+    // The prefix vocabulary mask is applied before the elementwise processors. Both masks and the minimum length
+    // set scores to the lowest value, so the order between them does not matter.
     if (!parameters.prefix_vocab_mask.empty()) {
       prefix_vocab_mask_processor_ = std::make_unique<
           PrefixVocabMaskLogitsProcessor<float>>(parameters.prefix_vocab_mask,
@@ -330,22 +300,14 @@ class LogitsProcessorList : public ILogitsProcessorList {
       processor_list_.push_back(prefix_vocab_mask_processor_.get());
     }
 
-    if (parameters.min_length > 0) {
-      min_length_processor_ = std::make_unique<MinLengthLogitsProcessor<float>>(parameters.min_length,
-                                                                                parameters.eos_token_id);
-      processor_list_.push_back(min_length_processor_.get());
-    }
-
-    if (parameters.temperature > 0) {
-      temperature_processor_ = std::make_unique<TemperatureLogitsProcessor<float>>(parameters.temperature);
-      processor_list_.push_back(temperature_processor_.get());
-    }
-
-    if (!parameters.presence_mask.empty()) {
-      presence_penalty_processor_ = std::make_unique<
-          PresencePenaltyLogitsProcessor<float>>(parameters.presence_mask,
-                                                 parameters.presence_penalty);
-      processor_list_.push_back(presence_penalty_processor_.get());
+    const float temperature = parameters.temperature > 0 ? parameters.temperature : 1.0f;
+    const float presence_penalty = parameters.presence_mask.empty() ? 0.0f : parameters.presence_penalty;
+    if (!parameters.vocab_mask.empty() || parameters.min_length > 0 || temperature != 1.0f ||
+        presence_penalty != 0.0f) {
+      elementwise_processor_ = std::make_unique<ElementwiseLogitsProcessor<float>>(
+          parameters.vocab_mask, parameters.min_length, parameters.eos_token_id, temperature,
+          parameters.presence_mask, presence_penalty);
+      processor_list_.push_back(elementwise_processor_.get());
     }
 
     // Add timestamp processor for whisper model
@@ -373,11 +335,8 @@ class LogitsProcessorList : public ILogitsProcessorList {
 
   std::unique_ptr<RepetitionPenaltyLogitsProcessor<float>> repetition_penalty_processor_;
   std::unique_ptr<NoRepeatNGramLogitsProcessor<float>> no_repeat_ngram_processor_;
-  std::unique_ptr<VocabMaskLogitsProcessor<float>> vocab_mask_processor_;
   std::unique_ptr<PrefixVocabMaskLogitsProcessor<float>> prefix_vocab_mask_processor_;
-  std::unique_ptr<MinLengthLogitsProcessor<float>> min_length_processor_;
-  std::unique_ptr<TemperatureLogitsProcessor<float>> temperature_processor_;
-  std::unique_ptr<PresencePenaltyLogitsProcessor<float>> presence_penalty_processor_;
+  std::unique_ptr<ElementwiseLogitsProcessor<float>> elementwise_processor_;
   std::unique_ptr<TimestampLogitsProcessor<float>> timestamp_processor_;
 };
 
@@ -91,6 +91,12 @@ Status Sampling::SetupSubgraphExecutionInfo(const SessionState& session_state,
 
       init_run_gpt_subgraph_ = std::move(res.second);
       init_run_decoder_feeds_fetches_manager_ = init_run_gpt_subgraph_->GetFeedsFetchesManager();
+    } else if (attribute_name == "draft_decoder") {
+      ORT_ENFORCE(draft_gpt_subgraph_ == nullptr, "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+      // The draft decoder has its own number of layers and heads, so it shall not update 'parameters_'.
+      draft_gpt_subgraph_ = std::make_unique<GptSubgraph>(node, attribute_name, subgraph_session_state.GetGraphViewer());
+      ORT_RETURN_IF_ERROR(draft_gpt_subgraph_->Setup(session_state, subgraph_session_state));
+      ORT_RETURN_IF(draft_gpt_subgraph_->IsOutputFloat16(), "draft_decoder subgraph shall have float logits output");
     }
   } else if (parameters_.model_type == IGenerationParameters::kModelTypeT5) {  // encoder-decoder like T5
     ORT_THROW("Not Implemented");
@@ -114,6 +120,14 @@ Status Sampling::Compute(OpKernelContext* ctx) const {
                 "past_present_share_buffer mode must be same for init decoder and decoder subgraphes");
   }
 
+  auto* draft_decoder_session_state = ctx_internal->SubgraphSessionState("draft_decoder");
+  if (draft_gpt_subgraph_ != nullptr) {
+    ORT_ENFORCE(draft_decoder_session_state, "Subgraph SessionState was not found for 'draft_decoder' attribute.");
+    ORT_RETURN_IF(draft_gpt_subgraph_->vocab_size != gpt_subgraph_->vocab_size,
+                  "draft_decoder subgraph shall have same vocabulary size as decoder subgraph: ",
+                  draft_gpt_subgraph_->vocab_size, " vs ", gpt_subgraph_->vocab_size);
+  }
+
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
   // make a copy since we will update the parameters based on inputs later
@@ -142,6 +156,7 @@ Status Sampling::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, gpu_device_prop_, gpu_device_arch_));
 #endif
+      impl.SetDraftDecoder(draft_decoder_session_state, draft_gpt_subgraph_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -166,6 +181,7 @@ Status Sampling::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, gpu_device_prop_, gpu_device_arch_));
 #endif
+      impl.SetDraftDecoder(draft_decoder_session_state, draft_gpt_subgraph_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
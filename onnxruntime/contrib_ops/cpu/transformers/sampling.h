@@ -103,6 +103,10 @@ class Sampling : public IControlFlowKernel {
   std::unique_ptr<GptSubgraph> init_run_gpt_subgraph_;
   std::unique_ptr<GptSubgraph> gpt_subgraph_;
 
+  // Relevant only for GPT2. The draft_gpt_subgraph_ (if the `draft_decoder` attribute is present) proposes
+  // tokens that are verified by gpt_subgraph_ in speculative decoding.
+  std::unique_ptr<GptSubgraph> draft_gpt_subgraph_;
+
   FeedsFetchesManager* decoder_feeds_fetches_manager_;
   FeedsFetchesManager* init_run_decoder_feeds_fetches_manager_;
 
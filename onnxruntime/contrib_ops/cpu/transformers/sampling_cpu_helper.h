@@ -6,52 +6,67 @@ namespace onnxruntime {
 namespace contrib {
 namespace SamplingCpuHelper {
 
+// Sets the scores of the tokens outside of the top-p nucleus of each batch entry to the filter value.
+// The nucleus is found by partial selection of the most probable tokens, in candidate blocks that grow geometrically
+// until the kept probability mass is reached, instead of sorting the whole vocabulary.
+// The most probable token is always kept. With custom sampling, a token is kept while the probability mass of the
+// more probable tokens does not exceed top_p. Otherwise it is kept while that mass is less than top_p, and at least
+// min_tokens_to_keep tokens are kept.
 template <typename T>
-void filter_scores(std::vector<size_t>& sorted_indice,
-                   gsl::span<T>& next_token_score,
-                   const transformers::IGenerationParameters* parameters,
-                   size_t chunk_offset,
-                   size_t offset) {
-  size_t real_index = sorted_indice[chunk_offset + offset];
-  next_token_score[chunk_offset + real_index] = (T)parameters->filter_value;
-}
-
-template <typename T>
-void cumulate_and_filter_custom(gsl::span<T>& next_token_scores,
-                                gsl::span<T>& cumulative_probs,
-                                const transformers::IGenerationParameters* parameters,
-                                std::vector<size_t>& sorted_indices) {
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    size_t offset = i * parameters->vocab_size;
-    if (cumulative_probs[offset] > parameters->top_p) {
-      filter_scores(sorted_indices, next_token_scores, parameters, offset, 1);
-    }
-    for (size_t j = 1; j < static_cast<size_t>(parameters->vocab_size) - 1; j++) {
-      cumulative_probs[j + offset] += cumulative_probs[j + offset - 1];
-      if (cumulative_probs[j + offset] > parameters->top_p) {
-        filter_scores(sorted_indices, next_token_scores, parameters, offset, j + 1);
-      }
-    }
-  }
-}
-
-template <typename T>
-void cumulate_and_filter(gsl::span<T>& next_token_scores,
-                         gsl::span<T>& cumulative_probs,
-                         const transformers::IGenerationParameters* parameters,
-                         std::vector<size_t>& sorted_indices) {
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    size_t offset = i * parameters->vocab_size;
-    if (cumulative_probs[offset] <= 1 - parameters->top_p) {
-      filter_scores(sorted_indices, next_token_scores, parameters, offset, 0);
-    }
-    for (size_t j = 1; j < static_cast<size_t>(parameters->vocab_size) - static_cast<size_t>(parameters->min_tokens_to_keep); j++) {
-      cumulative_probs[j + offset] += cumulative_probs[j + offset - 1];
-      if (cumulative_probs[j + offset] <= 1 - parameters->top_p) {
-        filter_scores(sorted_indices, next_token_scores, parameters, offset, j);
-      }
-    }
-  }
+void FilterTopP(gsl::span<T>& next_token_scores,
+                gsl::span<const T> next_token_probs,
+                const transformers::IGenerationParameters* parameters,
+                onnxruntime::concurrency::ThreadPool* thread_pool) {
+  const size_t vocab_size = static_cast<size_t>(parameters->vocab_size);
+  const T top_p = static_cast<T>(parameters->top_p);
+  const size_t min_tokens_to_keep = parameters->custom_sampling
+                                        ? 1
+                                        : std::max<size_t>(static_cast<size_t>(parameters->min_tokens_to_keep), 1);
+  const bool custom_sampling = parameters->custom_sampling;
+  constexpr size_t initial_candidates = 64;
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(parameters->batch_size),
+      [&](std::ptrdiff_t batch) {
+        const size_t offset = static_cast<size_t>(batch) * vocab_size;
+        const T* probs = next_token_probs.data() + offset;
+        T* scores = next_token_scores.data() + offset;
+        const auto more_probable = [probs](int32_t i1, int32_t i2) { return probs[i1] > probs[i2]; };
+
+        std::vector<int32_t> indices(vocab_size);
+        std::iota(indices.begin(), indices.end(), 0);
+
+        // indices [0, selected) hold the most probable tokens in descending order of probability
+        size_t selected = 0;
+        size_t num_kept = vocab_size;
+        T mass = 0;
+        for (size_t candidates = std::min(initial_candidates, vocab_size); num_kept == vocab_size;
+             candidates = std::min(candidates * 2, vocab_size)) {
+          if (candidates < vocab_size) {
+            std::nth_element(indices.begin() + selected, indices.begin() + candidates - 1, indices.end(),
+                             more_probable);
+          }
+          std::sort(indices.begin() + selected, indices.begin() + candidates, more_probable);
+
+          for (; selected < candidates; ++selected) {
+            const bool keep = selected < min_tokens_to_keep ||
+                              (custom_sampling ? mass <= top_p : mass < top_p);
+            if (!keep) {
+              num_kept = selected;
+              break;
+            }
+            mass += probs[indices[selected]];
+          }
+
+          if (candidates == vocab_size) {
+            break;
+          }
+        }
+
+        for (size_t i = num_kept; i < vocab_size; ++i) {
+          scores[indices[i]] = static_cast<T>(parameters->filter_value);
+        }
+      });
 }
 
 template <typename T>
@@ -64,55 +79,18 @@ Status Sample(AllocatorPtr& allocator,
               const transformers::IConsoleDumper* dumper) {
   ORT_UNUSED_PARAMETER(dumper);
 
-  gsl::span<T>& sorted_scores = sampling_state->sorted_scores;
-  memcpy(sorted_scores.data(), next_token_scores.data(), next_token_scores.size_bytes());
-  std::vector<size_t> sorted_indices(static_cast<size_t>(parameters->batch_size) * static_cast<size_t>(parameters->vocab_size));
-
-  std::function<bool(T, T)> predicator;
-  if (parameters->custom_sampling) {
-    predicator = std::greater<T>();
-  } else {
-    predicator = std::less<T>();
-  }
-
-  // TODO: This could be optimized with allocated buffer and handwritten sort algorithm
-  for (size_t i = 0; i < static_cast<size_t>(parameters->batch_size); i++) {
-    auto indices_begin = sorted_indices.begin() + i * parameters->vocab_size;
-    auto indices_end = sorted_indices.begin() + (i + 1) * parameters->vocab_size;
-    gsl::span<T> next_token_score = next_token_scores.subspan(i * parameters->vocab_size, parameters->vocab_size);
-    std::iota(indices_begin, indices_end, 0);
-    std::sort(indices_begin, indices_end,
-              [&next_token_score, &predicator](size_t i1, size_t i2) {
-                return predicator(next_token_score[i1], next_token_score[i2]);
-              });
-
-    std::sort(sorted_scores.begin() + i * parameters->vocab_size,
-              sorted_scores.begin() + (i + 1) * parameters->vocab_size,
-              predicator);
-  }
-
-#ifdef DEBUG_GENERATION
-  dumper->Print("sorted_scores", sorted_scores.data(), parameters->batch_size, parameters->vocab_size);
-  dumper->Print("sorted_indices", sorted_indices.data(), parameters->batch_size, parameters->vocab_size);
-#endif
-
-  gsl::span<T>& cumulative_probs = sampling_state->cumulative_probs;
-
+  // the probabilities of the tokens, to select the top-p nucleus from
+  gsl::span<T>& next_token_probs = sampling_state->cumulative_probs;
   ORT_RETURN_IF_ERROR(SoftmaxCPU<T>(parameters->batch_size,
                                     parameters->vocab_size,
-                                    sorted_scores.data(),
-                                    cumulative_probs.data(),
+                                    next_token_scores.data(),
+                                    next_token_probs.data(),
                                     false,
                                     thread_pool));
 
-  if (parameters->custom_sampling) {
-    cumulate_and_filter_custom(next_token_scores, cumulative_probs, parameters, sorted_indices);
-  } else {
-    cumulate_and_filter(next_token_scores, cumulative_probs, parameters, sorted_indices);
-  }
+  FilterTopP<T>(next_token_scores, next_token_probs, parameters, thread_pool);
 
 #ifdef DEBUG_GENERATION
-  dumper->Print("cumulative_probs after filtering", cumulative_probs.data(), parameters->batch_size, parameters->vocab_size);
   dumper->Print("next_token_scores after filtering", next_token_scores.data(), parameters->batch_size, parameters->vocab_size);
 #endif
 
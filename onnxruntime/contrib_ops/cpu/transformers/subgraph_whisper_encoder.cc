@@ -96,6 +96,7 @@ Status WhisperEncoderSubgraph::CreateInitialFeeds(
     const Tensor& original_encoder_input_ids,
     const OrtValue* original_decoder_input_ids_value,
     int start_token_id,
+    int chunk_length,
     const std::vector<const OrtValue*>& implicit_inputs,
     std::vector<OrtValue>& feeds,
     const GenerationDeviceHelper::CreateWhisperEncoderInputsFunc& create_encoder_inputs_func,
@@ -120,6 +121,7 @@ Status WhisperEncoderSubgraph::CreateInitialFeeds(
   ORT_RETURN_IF_ERROR(create_encoder_inputs_func(&original_encoder_input_ids,
                                                  original_decoder_input_ids_value,
                                                  start_token_id,
+                                                 chunk_length,
                                                  cpu_allocator,
                                                  encoder_input_ids,
                                                  decoder_input_ids));
@@ -23,6 +23,7 @@ class WhisperEncoderSubgraph : public T5EncoderSubgraph {
       const Tensor& encoder_input_ids,
       const OrtValue* original_decoder_input_ids_value,
       int start_token_id,
+      int chunk_length,
       const std::vector<const OrtValue*>& implicit_inputs,
       std::vector<OrtValue>& feeds,
       const GenerationDeviceHelper::CreateWhisperEncoderInputsFunc& create_encoder_inputs_func,
@@ -0,0 +1,280 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace wordpiece_details {
+
+// Vocabulary pieces in a byte trie stored in flat arrays. The edges of a node are contiguous and sorted by byte,
+// so a node costs two integers and an edge five bytes, and lookups do not chase per-node allocations.
+class PieceTrie {
+ public:
+  void Build(const std::vector<std::pair<std::string_view, int64_t>>& pieces) {
+    // Build with a node based trie, then flatten it breadth first.
+    struct BuildNode {
+      std::map<uint8_t, size_t> children;
+      int64_t id = -1;
+    };
+    std::vector<BuildNode> nodes(1);
+    for (const auto& [piece, id] : pieces) {
+      size_t node = 0;
+      for (char c : piece) {
+        auto it = nodes[node].children.find(static_cast<uint8_t>(c));
+        if (it == nodes[node].children.end()) {
+          it = nodes[node].children.emplace(static_cast<uint8_t>(c), nodes.size()).first;
+          nodes.emplace_back();
+        }
+        node = it->second;
+      }
+      // Keep the first id of a duplicated piece.
+      if (nodes[node].id < 0) {
+        nodes[node].id = id;
+      }
+    }
+
+    std::vector<uint32_t> order{0};
+    std::vector<uint32_t> flat_index(nodes.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      flat_index[order[i]] = narrow<uint32_t>(i);
+      for (const auto& child : nodes[order[i]].children) {
+        order.push_back(narrow<uint32_t>(child.second));
+      }
+    }
+
+    ids_.resize(nodes.size());
+    edge_begin_.resize(nodes.size() + 1);
+    edge_bytes_.clear();
+    edge_targets_.clear();
+    for (size_t i = 0; i < order.size(); i++) {
+      const BuildNode& node = nodes[order[i]];
+      ids_[i] = node.id;
+      edge_begin_[i] = narrow<uint32_t>(edge_bytes_.size());
+      for (const auto& child : node.children) {
+        edge_bytes_.push_back(child.first);
+        edge_targets_.push_back(flat_index[child.second]);
+      }
+    }
+    edge_begin_[order.size()] = narrow<uint32_t>(edge_bytes_.size());
+  }
+
+  // Returns the length of the longest piece that prefixes text and sets its id, or returns 0 if there is none.
+  size_t LongestPrefix(std::string_view text, int64_t& id) const {
+    size_t longest = 0;
+    uint32_t node = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+      const auto first = edge_bytes_.begin() + edge_begin_[node];
+      const auto last = edge_bytes_.begin() + edge_begin_[node + 1];
+      const auto edge = std::lower_bound(first, last, static_cast<uint8_t>(text[i]));
+      if (edge == last || *edge != static_cast<uint8_t>(text[i])) {
+        break;
+      }
+      node = edge_targets_[edge - edge_bytes_.begin()];
+      if (ids_[node] >= 0) {
+        longest = i + 1;
+        id = ids_[node];
+      }
+    }
+    return longest;
+  }
+
+ private:
+  std::vector<int64_t> ids_;
+  std::vector<uint32_t> edge_begin_;
+  std::vector<uint8_t> edge_bytes_;
+  std::vector<uint32_t> edge_targets_;
+};
+
+inline bool IsWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool IsAsciiPunctuation(char c) {
+  return (c >= 33 && c <= 47) || (c >= 58 && c <= 64) || (c >= 91 && c <= 96) || (c >= 123 && c <= 126);
+}
+
+}  // namespace wordpiece_details
+
+using namespace wordpiece_details;
+
+class WordPieceTokenizer final : public OpKernel {
+ public:
+  explicit WordPieceTokenizer(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  void TokenizeWord(std::string_view word, InlinedVector<int64_t>& ids) const;
+  void TokenizeRow(std::string_view text, InlinedVector<int64_t>& ids) const;
+
+  PieceTrie word_pieces_;          // pieces that start a word
+  PieceTrie continuation_pieces_;  // pieces inside a word, without the suffix indicator
+  int64_t unk_token_id_;
+  int64_t pad_token_id_;
+  size_t max_input_chars_per_word_;
+  bool lower_case_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    WordPieceTokenizer,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<std::string>()),
+    WordPieceTokenizer);
+
+WordPieceTokenizer::WordPieceTokenizer(const OpKernelInfo& info) : OpKernel(info) {
+  std::vector<std::string> vocab;
+  ORT_ENFORCE(info.GetAttrs("vocab", vocab).IsOK(), "attribute vocab is not set");
+  ORT_ENFORCE(!vocab.empty(), "vocab must not be empty");
+
+  const std::string unk_token = info.GetAttrOrDefault<std::string>("unk_token", "[UNK]");
+  const std::string suffix_indicator = info.GetAttrOrDefault<std::string>("suffix_indicator", "##");
+  pad_token_id_ = info.GetAttrOrDefault<int64_t>("pad_token_id", 0);
+  const int64_t max_input_chars_per_word = info.GetAttrOrDefault<int64_t>("max_input_chars_per_word", 100);
+  ORT_ENFORCE(max_input_chars_per_word > 0, "max_input_chars_per_word must be positive");
+  max_input_chars_per_word_ = narrow<size_t>(max_input_chars_per_word);
+  lower_case_ = info.GetAttrOrDefault<int64_t>("lower_case", 0) != 0;
+
+  std::vector<std::pair<std::string_view, int64_t>> word_pieces;
+  std::vector<std::pair<std::string_view, int64_t>> continuation_pieces;
+  unk_token_id_ = -1;
+  for (size_t i = 0; i < vocab.size(); i++) {
+    std::string_view piece = vocab[i];
+    const int64_t id = static_cast<int64_t>(i);
+    if (piece == unk_token && unk_token_id_ < 0) {
+      unk_token_id_ = id;
+    }
+    if (piece.size() > suffix_indicator.size() && piece.substr(0, suffix_indicator.size()) == suffix_indicator) {
+      continuation_pieces.emplace_back(piece.substr(suffix_indicator.size()), id);
+    } else if (!piece.empty()) {
+      word_pieces.emplace_back(piece, id);
+    }
+  }
+  ORT_ENFORCE(unk_token_id_ >= 0, "unk_token ", unk_token, " is not in vocab");
+
+  word_pieces_.Build(word_pieces);
+  continuation_pieces_.Build(continuation_pieces);
+}
+
+// Greedy longest-match-first segmentation of one word. A word with a part that no piece matches is unknown as a whole.
+void WordPieceTokenizer::TokenizeWord(std::string_view word, InlinedVector<int64_t>& ids) const {
+  size_t num_chars = 0;
+  for (char c : word) {
+    // Count UTF-8 lead bytes.
+    num_chars += (static_cast<uint8_t>(c) & 0xC0) != 0x80;
+  }
+  if (num_chars > max_input_chars_per_word_) {
+    ids.push_back(unk_token_id_);
+    return;
+  }
+
+  const size_t first_piece = ids.size();
+  size_t start = 0;
+  while (start < word.size()) {
+    int64_t id = -1;
+    const PieceTrie& trie = start == 0 ? word_pieces_ : continuation_pieces_;
+    const size_t length = trie.LongestPrefix(word.substr(start), id);
+    if (length == 0) {
+      ids.resize(first_piece);
+      ids.push_back(unk_token_id_);
+      return;
+    }
+    ids.push_back(id);
+    start += length;
+  }
+}
+
+// Splits the text on whitespace and ASCII punctuation, each punctuation character being a word, and tokenizes
+// the words.
+void WordPieceTokenizer::TokenizeRow(std::string_view text, InlinedVector<int64_t>& ids) const {
+  std::string lowered;
+  if (lower_case_) {
+    lowered.assign(text);
+    std::transform(lowered.begin(), lowered.end(), lowered.begin(),
+                   [](char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; });
+    text = lowered;
+  }
+
+  size_t word_start = 0;
+  for (size_t i = 0; i <= text.size(); i++) {
+    const bool at_end = i == text.size();
+    if (at_end || IsWhitespace(text[i]) || IsAsciiPunctuation(text[i])) {
+      if (i > word_start) {
+        TokenizeWord(text.substr(word_start, i - word_start), ids);
+      }
+      if (!at_end && IsAsciiPunctuation(text[i])) {
+        TokenizeWord(text.substr(i, 1), ids);
+      }
+      word_start = i + 1;
+    }
+  }
+}
+
+Status WordPieceTokenizer::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  const auto& input_dims = X->Shape().GetDims();
+  if (input_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input is expected to have 1 dimension, got ",
+                           input_dims.size());
+  }
+
+  const auto input = X->DataAsSpan<std::string>();
+  const std::ptrdiff_t num_rows = static_cast<std::ptrdiff_t>(input.size());
+  std::vector<InlinedVector<int64_t>> rows(input.size());
+
+  double average_length = 0;
+  for (const auto& text : input) {
+    average_length += static_cast<double>(text.size());
+  }
+  average_length = num_rows > 0 ? average_length / num_rows : 0;
+
+  // Rows are independent, so they are tokenized in parallel, and gathered in the padded output afterwards.
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), num_rows,
+      TensorOpCost{average_length, average_length, average_length * 16},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; row++) {
+          TokenizeRow(input[row], rows[row]);
+        }
+      });
+
+  size_t max_tokens = 0;
+  for (const auto& ids : rows) {
+    max_tokens = std::max(max_tokens, ids.size());
+  }
+
+  Tensor* Y = context->Output(0, {static_cast<int64_t>(num_rows), static_cast<int64_t>(max_tokens)});
+  int64_t* output = Y->MutableData<int64_t>();
+  for (const auto& ids : rows) {
+    output = std::copy(ids.begin(), ids.end(), output);
+    output = std::fill_n(output, max_tokens - ids.size(), pad_token_id_);
+  }
+
+  Tensor* lengths = context->Output(1, {static_cast<int64_t>(num_rows)});
+  if (lengths != nullptr) {
+    int64_t* lengths_data = lengths->MutableData<int64_t>();
+    for (const auto& ids : rows) {
+      *lengths_data++ = static_cast<int64_t>(ids.size());
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -100,6 +100,12 @@ struct Flash_fwd_params : public Qkv_params {
   // The indices to index into the KV cache.
   int* __restrict__ cache_batch_idx = nullptr;
 
+  // Paged KV cache. When block_table is set, row i of the KV cache of batch b lives in page
+  // block_table[b * block_table_batch_stride + i / page_block_size], and k/v_batch_stride is the stride of a page.
+  int* __restrict__ block_table = nullptr;
+  index_t block_table_batch_stride = 0;
+  int page_block_size = 1;
+
   // Local window size
   int window_size_left = -1;
   int window_size_right = -1;
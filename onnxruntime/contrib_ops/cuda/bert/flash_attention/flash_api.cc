@@ -381,7 +381,18 @@ Status mha_fwd_kvcache(const cudaDeviceProp& dprops,
                        void* out_accum,          // num_splits x batch_size x seqlen_q x num_heads x head_size_rounded
                        int local_window_size,
                        bool is_rotary_interleaved,
-                       bool is_packed_qkv) {
+                       bool is_packed_qkv,
+                       int* block_table,  // batch_size x max_num_blocks_per_seq
+                       int max_num_blocks_per_seq,
+                       int page_block_size) {
+  const bool paged_kv = block_table != nullptr;
+  if (paged_kv) {
+    // The kernel moves through the cache one block of kBlockN rows at a time, and kBlockN is at most 256.
+    ORT_RETURN_IF_NOT(page_block_size > 0 && page_block_size % 256 == 0,
+                      "Paged KV cache requires a page block size that is a multiple of 256, got ", page_block_size);
+    seqlen_k = max_num_blocks_per_seq * page_block_size;
+  }
+
   auto round_multiple = [](int x, int m) { return (x + m - 1) / m * m; };
   const int head_size_rounded = round_multiple(head_size, 32);
   const int seqlen_q_rounded = round_multiple(seqlen_q, 128);
@@ -408,6 +419,20 @@ Status mha_fwd_kvcache(const cudaDeviceProp& dprops,
                    is_causal ? 0 : -1);
   params.dprops = &dprops;
 
+  if (paged_kv) {
+    // kcache and vcache are num_blocks x page_block_size x num_heads_k x head_size (or num_blocks x num_heads_k x
+    // page_block_size x head_size), and the batch stride is the stride of a page.
+    params.block_table = block_table;
+    params.block_table_batch_stride = max_num_blocks_per_seq;
+    params.page_block_size = page_block_size;
+    params.k_batch_stride = page_block_size * num_heads_k * head_size;
+    params.v_batch_stride = page_block_size * num_heads_k * head_size;
+    if (!past_bsnh) {
+      params.k_head_stride = page_block_size * head_size;
+      params.v_head_stride = page_block_size * head_size;
+    }
+  }
+
   if (k_new != nullptr && v_new != nullptr) {
     params.seqlen_knew = seqlen_k_new;
     params.knew_ptr = k_new;
@@ -461,8 +486,8 @@ Status mha_fwd_kvcache(const cudaDeviceProp& dprops,
     params.oaccum_ptr = nullptr;
   }
 
-  // Only split kernel supports appending to KV cache
-  run_mha_fwd(params, stream, /*force_split_kernel=*/k_new != nullptr);
+  // Only split kernel supports appending to KV cache and paged KV cache
+  run_mha_fwd(params, stream, /*force_split_kernel=*/k_new != nullptr || paged_kv);
 
   return Status::OK();
 }
@@ -106,7 +106,10 @@ Status mha_fwd_kvcache(const cudaDeviceProp& dprops,
                        void* out_accum = nullptr,          // num_splits x batch_size x seqlen_q x num_heads x head_size_rounded
                        int local_window_size = -1,
                        bool is_rotary_interleaved = false,
-                       bool is_packed_qkv = false);
+                       bool is_packed_qkv = false,
+                       int* block_table = nullptr,  // (optional) batch_size x max_num_blocks_per_seq for paged kv cache
+                       int max_num_blocks_per_seq = 0,
+                       int page_block_size = 1);
 
 size_t get_softmax_lse_size(int max_seqlen_q, int batch_size, int num_heads);
 
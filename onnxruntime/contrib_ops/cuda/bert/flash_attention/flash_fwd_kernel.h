@@ -510,6 +510,22 @@ inline __device__ void compute_attn_1rowblock(const Params& params, const int bi
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Offset that moves a pointer into a paged KV cache from the block of rows n_block_from to the block n_block_to.
+// page_block_size is a multiple of kBlockN, so a block of rows never straddles two pages.
+template <int kBlockN, typename Params>
+inline __device__ int64_t paged_kv_block_offset(const int* block_table, const Params& params,
+                                                const int n_block_from, const int n_block_to,
+                                                const int64_t batch_stride, const int64_t row_stride) {
+  const int page_from = n_block_from * kBlockN / params.page_block_size;
+  const int page_to = n_block_to * kBlockN / params.page_block_size;
+  const int row_in_page_from = n_block_from * kBlockN - page_from * params.page_block_size;
+  const int row_in_page_to = n_block_to * kBlockN - page_to * params.page_block_size;
+  return (static_cast<int64_t>(block_table[page_to]) - block_table[page_from]) * batch_stride +
+         static_cast<int64_t>(row_in_page_to - row_in_page_from) * row_stride;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 template <typename Kernel_traits, bool Is_causal, bool Is_local, bool Is_even_MN, bool Is_even_K, bool Split, bool Append_KV, typename Params>
 inline __device__ void compute_attn_1rowblock_splitkv(const Params& params, const int bidb, const int bidh, const int m_block, const int n_split_idx, const int num_n_splits) {
   using Element = typename Kernel_traits::Element;
@@ -596,8 +612,16 @@ inline __device__ void compute_attn_1rowblock_splitkv(const Params& params, cons
   const index_t row_offset_q = binfo.q_offset(params.q_batch_stride, params.q_row_stride, bidb) + m_block * kBlockM * params.q_row_stride + bidh * params.q_head_stride;
   // We move K and V to the last block.
   const int bidb_cache = params.cache_batch_idx == nullptr ? bidb : params.cache_batch_idx[bidb];
-  const index_t row_offset_k = binfo.k_offset(params.k_batch_stride, params.k_row_stride, bidb_cache) + (n_block_max - 1) * kBlockN * params.k_row_stride + (bidh / params.h_h_k_ratio) * params.k_head_stride;
-  const index_t row_offset_v = binfo.k_offset(params.v_batch_stride, params.v_row_stride, bidb_cache) + (n_block_max - 1) * kBlockN * params.v_row_stride + (bidh / params.h_h_k_ratio) * params.v_head_stride;
+  // With a paged KV cache, the batch stride is the stride of a page and the pages of this batch are in block_table.
+  const int* block_table = params.block_table == nullptr ? nullptr : params.block_table + bidb * params.block_table_batch_stride;
+  const int block_table_idx = block_table == nullptr ? 0 : (n_block_max - 1) * kBlockN / params.page_block_size;
+  const int block_table_offset = block_table == nullptr ? 0 : (n_block_max - 1) * kBlockN - block_table_idx * params.page_block_size;
+  const index_t row_offset_k = block_table == nullptr
+                                   ? binfo.k_offset(params.k_batch_stride, params.k_row_stride, bidb_cache) + (n_block_max - 1) * kBlockN * params.k_row_stride + (bidh / params.h_h_k_ratio) * params.k_head_stride
+                                   : block_table[block_table_idx] * params.k_batch_stride + block_table_offset * params.k_row_stride + (bidh / params.h_h_k_ratio) * params.k_head_stride;
+  const index_t row_offset_v = block_table == nullptr
+                                   ? binfo.k_offset(params.v_batch_stride, params.v_row_stride, bidb_cache) + (n_block_max - 1) * kBlockN * params.v_row_stride + (bidh / params.h_h_k_ratio) * params.v_head_stride
+                                   : block_table[block_table_idx] * params.v_batch_stride + block_table_offset * params.v_row_stride + (bidh / params.h_h_k_ratio) * params.v_head_stride;
 
   Tensor gQ = make_tensor(make_gmem_ptr(reinterpret_cast<Element*>(params.q_ptr) + row_offset_q),
                           Shape<Int<kBlockM>, Int<kHeadDim>>{},
@@ -737,7 +761,12 @@ inline __device__ void compute_attn_1rowblock_splitkv(const Params& params, cons
     for (int n_block = n_block_max - 1; n_block >= n_block_copy_min; n_block--) {
       flash::copy_w_min_idx<Is_even_K>(
           tVgVnew, tVgV, tKVcKV, tKVpKV, binfo.actual_seqlen_k - n_block * kBlockN, binfo.seqlen_k_cache - n_block * kBlockN);
-      tVgV.data() = tVgV.data() + (-int(kBlockN * params.v_row_stride));
+      if (block_table == nullptr) {
+        tVgV.data() = tVgV.data() + (-int(kBlockN * params.v_row_stride));
+      } else if (n_block > n_block_copy_min) {
+        tVgV.data() = tVgV.data() + flash::paged_kv_block_offset<kBlockN>(block_table, params, n_block, n_block - 1,
+                                                                          params.v_batch_stride, params.v_row_stride);
+      }
       tVgVnew.data() = tVgVnew.data() + (-int(kBlockN * params.vnew_row_stride));
       if (params.rotary_dim == 0) {
         flash::copy_w_min_idx<Is_even_K>(
@@ -759,14 +788,27 @@ inline __device__ void compute_attn_1rowblock_splitkv(const Params& params, cons
           tRgSinCont.data() = tRgSinCont.data() + (-int(kBlockN * params.rotary_dim / 2));
         }
       }
-      tKgK.data() = tKgK.data() + (-int(kBlockN * params.k_row_stride));
+      if (block_table == nullptr) {
+        tKgK.data() = tKgK.data() + (-int(kBlockN * params.k_row_stride));
+      } else if (n_block > n_block_copy_min) {
+        tKgK.data() = tKgK.data() + flash::paged_kv_block_offset<kBlockN>(block_table, params, n_block, n_block - 1,
+                                                                          params.k_batch_stride, params.k_row_stride);
+      }
       tKgKnew.data() = tKgKnew.data() + (-int(kBlockN * params.knew_row_stride));
     }
     // Need this before we can read in K again, so that we'll see the updated K values.
     __syncthreads();
     if (n_block_max > n_block_copy_min) {
-      tKgK.data() = tKgK.data() + (n_block_max - n_block_copy_min) * kBlockN * params.k_row_stride;
-      tVgV.data() = tVgV.data() + (n_block_max - n_block_copy_min) * kBlockN * params.v_row_stride;
+      if (block_table == nullptr) {
+        tKgK.data() = tKgK.data() + (n_block_max - n_block_copy_min) * kBlockN * params.k_row_stride;
+        tVgV.data() = tVgV.data() + (n_block_max - n_block_copy_min) * kBlockN * params.v_row_stride;
+      } else {
+        // The paged pointers stopped at n_block_copy_min rather than one block below it.
+        tKgK.data() = tKgK.data() + flash::paged_kv_block_offset<kBlockN>(block_table, params, n_block_copy_min, n_block_max - 1,
+                                                                          params.k_batch_stride, params.k_row_stride);
+        tVgV.data() = tVgV.data() + flash::paged_kv_block_offset<kBlockN>(block_table, params, n_block_copy_min, n_block_max - 1,
+                                                                          params.v_batch_stride, params.v_row_stride);
+      }
     }
   }
 
@@ -840,7 +882,12 @@ inline __device__ void compute_attn_1rowblock_splitkv(const Params& params, cons
 
     // Advance gV
     if (masking_step > 0) {
-      tVgV.data() = tVgV.data() + (-int(kBlockN * params.v_row_stride));
+      if (block_table == nullptr) {
+        tVgV.data() = tVgV.data() + (-int(kBlockN * params.v_row_stride));
+      } else {
+        tVgV.data() = tVgV.data() + flash::paged_kv_block_offset<kBlockN>(block_table, params, n_block + 1, n_block,
+                                                                          params.v_batch_stride, params.v_row_stride);
+      }
       flash::copy</*Is_even_MN=*/true, Is_even_K>(gmem_tiled_copy_QKV, tVgV, tVsV, tKVcKV, tKVpKV);
     } else {
       // Clear the smem tiles to account for predicated off loads
@@ -878,7 +925,12 @@ inline __device__ void compute_attn_1rowblock_splitkv(const Params& params, cons
 
     if (n_block > n_block_min) {
       // Advance gK
-      tKgK.data() = tKgK.data() + (-int(kBlockN * params.k_row_stride));
+      if (block_table == nullptr) {
+        tKgK.data() = tKgK.data() + (-int(kBlockN * params.k_row_stride));
+      } else {
+        tKgK.data() = tKgK.data() + flash::paged_kv_block_offset<kBlockN>(block_table, params, n_block, n_block - 1,
+                                                                          params.k_batch_stride, params.k_row_stride);
+      }
       flash::copy</*Is_even_MN=*/true, Is_even_K>(gmem_tiled_copy_QKV, tKgK, tKsK, tKVcKV, tKVpKV);
       // This cp_async_fence needs to be in the if block, otherwise the synchronization
       // isn't right and we get race conditions.
@@ -914,7 +966,12 @@ inline __device__ void compute_attn_1rowblock_splitkv(const Params& params, cons
     flash::cp_async_wait<0>();
     __syncthreads();
     // Advance gV
-    tVgV.data() = tVgV.data() + (-int(kBlockN * params.v_row_stride));
+    if (block_table == nullptr) {
+      tVgV.data() = tVgV.data() + (-int(kBlockN * params.v_row_stride));
+    } else {
+      tVgV.data() = tVgV.data() + flash::paged_kv_block_offset<kBlockN>(block_table, params, n_block + 1, n_block,
+                                                                        params.v_batch_stride, params.v_row_stride);
+    }
     flash::copy</*Is_even_MN=*/true, Is_even_K>(gmem_tiled_copy_QKV, tVgV, tVsV, tKVcKV, tKVpKV);
     cute::cp_async_fence();
 
@@ -926,7 +983,12 @@ inline __device__ void compute_attn_1rowblock_splitkv(const Params& params, cons
     __syncthreads();
     if (n_block > n_block_min) {
       // Advance gK
-      tKgK.data() = tKgK.data() + (-int(kBlockN * params.k_row_stride));
+      if (block_table == nullptr) {
+        tKgK.data() = tKgK.data() + (-int(kBlockN * params.k_row_stride));
+      } else {
+        tKgK.data() = tKgK.data() + flash::paged_kv_block_offset<kBlockN>(block_table, params, n_block, n_block - 1,
+                                                                          params.k_batch_stride, params.k_row_stride);
+      }
       flash::copy</*Is_even_MN=*/true, Is_even_K>(gmem_tiled_copy_QKV, tKgK, tKsK, tKVcKV, tKVpKV);
       // This cp_async_fence needs to be in the if block, otherwise the synchronization
       // isn't right and we get race conditions.
@@ -26,6 +26,7 @@ namespace cuda {
       kCudaExecutionProvider,                                            \
       (*KernelDefBuilder::Create())                                      \
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())         \
+          .TypeConstraint("T_CACHE", DataTypeImpl::GetTensorType<T>())   \
           .TypeConstraint("M", {DataTypeImpl::GetTensorType<int32_t>()}) \
           .MayInplace(3, 1)                                              \
           .MayInplace(4, 2)                                              \
@@ -80,6 +81,7 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
   const Tensor* total_seqlen = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* block_table = context->Input<Tensor>(9);
 
   auto& device_prop = GetDeviceProp();
   GroupQueryAttentionParameters parameters;
@@ -93,6 +95,7 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
                                                                 past_value,
                                                                 cos_cache,
                                                                 sin_cache,
+                                                                block_table,
                                                                 &parameters,
                                                                 num_heads_,
                                                                 kv_num_heads_,
@@ -127,6 +130,10 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
                                                               parameters.head_size,
                                                               parameters.num_heads,
                                                               parameters.kv_num_heads);
+  if (parameters.paged_kv_cache && !use_flash_attention) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "GroupQueryAttention with block_table (paged kv cache) requires flash attention on CUDA.");
+  }
   // Allocate buffers
   size_t softmax_lse_bytes = 0;
   size_t softmax_lse_accum_bytes = 0;
@@ -148,6 +155,10 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
   auto out_accum_buffer = GetScratchBuffer<void>(out_accum_bytes, context->GetComputeStream());
 #else
   constexpr bool use_flash_attention = false;
+  if (parameters.paged_kv_cache) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "GroupQueryAttention with block_table (paged kv cache) requires flash attention on CUDA.");
+  }
   auto softmax_lse_buffer = GetScratchBuffer<void>(0, context->GetComputeStream());        // nullptr
   auto softmax_lse_accum_buffer = GetScratchBuffer<void>(0, context->GetComputeStream());  // nullptr
   auto out_accum_buffer = GetScratchBuffer<void>(0, context->GetComputeStream());          // nullptr
@@ -207,7 +218,10 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
   auto seqlens_k_buffer = GetScratchBuffer<void>(seqlens_k_bytes, context->GetComputeStream());
 
   std::vector<int64_t> present_dims;
-  if (parameters.past_kv_format == AttentionQkvFormat::Q_K_V_BSNH) {
+  if (parameters.paged_kv_cache) {
+    // Present key/value are the whole block pool.
+    present_dims = past_key->Shape().AsShapeVector();
+  } else if (parameters.past_kv_format == AttentionQkvFormat::Q_K_V_BSNH) {
     present_dims = {
         parameters.batch_size, parameters.seqlen_present_kv_cache, parameters.kv_num_heads, parameters.head_size};
   } else {  // BNSH
@@ -227,6 +241,7 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
   data.present_key = (nullptr == present_key) ? nullptr : reinterpret_cast<CudaT*>(present_key->MutableData<T>());
   data.present_value = (nullptr == present_value) ? nullptr : reinterpret_cast<CudaT*>(present_value->MutableData<T>());
   data.seqlens_k = const_cast<int*>(seqlens_k->Data<int>());
+  data.block_table = (nullptr == block_table) ? nullptr : const_cast<int*>(block_table->Data<int>());
   data.use_flash_attention = use_flash_attention;
   data.use_memory_efficient_attention = use_memory_efficient_attention;
   if (data.past_key == data.present_key) {
@@ -234,6 +249,14 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
   } else {
     parameters.kv_share_buffer = false;
   }
+  if (parameters.paged_kv_cache && !parameters.kv_share_buffer) {
+    // The new kv is written into the block pool in place, so start from a copy of the past pool.
+    cudaStream_t stream = Stream(context);
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(present_key->MutableDataRaw(), past_key->DataRaw(), past_key->SizeInBytes(),
+                                         cudaMemcpyDeviceToDevice, stream));
+    CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(present_value->MutableDataRaw(), past_value->DataRaw(),
+                                         past_value->SizeInBytes(), cudaMemcpyDeviceToDevice, stream));
+  }
   // Flash Buffers
   if (softmax_lse_buffer != nullptr) {
     data.softmax_lse = reinterpret_cast<CudaT*>(softmax_lse_buffer.get());
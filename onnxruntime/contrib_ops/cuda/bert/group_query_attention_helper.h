@@ -18,6 +18,7 @@ Status CheckInputs(const Tensor* query,
                    const Tensor* past_value,
                    const Tensor* cos_cache,
                    const Tensor* sin_cache,
+                   const Tensor* block_table,
                    void* parameters,
                    int num_heads,
                    int kv_num_heads,
@@ -28,6 +29,10 @@ Status CheckInputs(const Tensor* query,
   // Note: Here S* is past_cache_sequence_length, S- is past_sequence_length, S+ is sequence_length
   //     past_key                   : (B, N_k, S*, H) or (B, N_k, S-, H) or nullptr
   //     past_value                 : (B, N_k, S*, H) or (B, N_k, S-, H) or nullptr
+  // paged kv cache, where NB is number of blocks in the pool and BS is block size:
+  //     past_key                   : (NB, N_k, BS, H)
+  //     past_value                 : (NB, N_k, BS, H)
+  //     block_table                : (B, max_blocks_per_sequence)
   // no packing for q/k/v:
   //     query            (Q)       : (B, S, D) or (B, S, (D_q + 2 D_kv))
   //     key              (K)       : (B, S, D_kv) or nullptr
@@ -126,15 +131,24 @@ Status CheckInputs(const Tensor* query,
                              past_value_dims.size());
     }
 
-    if (past_key_dims[0] != batch_size) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                             "Input 'past_key' dimension 0 should be batch_size, got ",
-                             past_key_dims[0]);
-    }
-    if (past_value_dims[0] != batch_size) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                             "Input 'past_value' dimension 0 should be batch_size, got ",
-                             past_value_dims[0]);
+    if (block_table != nullptr) {
+      if (past_key_dims[0] != past_value_dims[0]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_key' and 'past_value' shall have same dimension 0 (number of blocks) "
+                               "for paged kv cache, got ",
+                               past_key_dims[0], " and ", past_value_dims[0]);
+      }
+    } else {
+      if (past_key_dims[0] != batch_size) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_key' dimension 0 should be batch_size, got ",
+                               past_key_dims[0]);
+      }
+      if (past_value_dims[0] != batch_size) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Input 'past_value' dimension 0 should be batch_size, got ",
+                               past_value_dims[0]);
+      }
     }
 
     // BNSH
@@ -205,6 +219,36 @@ Status CheckInputs(const Tensor* query,
   int total_sequence_length = *((*total_seqlen).template Data<int32_t>());
   int present_sequence_length = std::max(total_sequence_length, past_sequence_length);
 
+  // Check block table of paged kv cache
+  int kv_cache_block_size = 0;
+  int max_blocks_per_sequence = 0;
+  if (block_table != nullptr) {
+    if (past_key == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' and 'past_value' are required when 'block_table' is given.");
+    }
+    if (is_past_bsnh) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Paged kv cache requires past_key and past_value in BNSH format.");
+    }
+    const auto& block_table_dims = block_table->Shape().GetDims();
+    if (block_table_dims.size() != 2 || block_table_dims[0] != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "block_table must be shape (batch_size, max_blocks_per_sequence).");
+    }
+    kv_cache_block_size = past_sequence_length;
+    max_blocks_per_sequence = static_cast<int>(block_table_dims[1]);
+    if (kv_cache_block_size <= 0 ||
+        static_cast<int64_t>(kv_cache_block_size) * max_blocks_per_sequence < total_sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "block_table with ", max_blocks_per_sequence, " blocks of size ", kv_cache_block_size,
+                             " cannot hold total_sequence_length of ", total_sequence_length);
+    }
+    // Past kv tensors are not indexed by sequence, so only the total sequence length is meaningful.
+    past_sequence_length = 0;
+    present_sequence_length = total_sequence_length;
+  }
+
   int rotary_dim = 0;
   if (cos_cache != nullptr && sin_cache != nullptr) {
     const auto& cos_dims = cos_cache->Shape().GetDims();
@@ -261,6 +305,9 @@ Status CheckInputs(const Tensor* query,
     output_parameters->scale = scale;
     output_parameters->qkv_format = qkv_format;
     output_parameters->past_kv_format = past_kv_format;
+    output_parameters->paged_kv_cache = block_table != nullptr;
+    output_parameters->kv_cache_block_size = kv_cache_block_size;
+    output_parameters->max_blocks_per_sequence = max_blocks_per_sequence;
   }
 
   return Status::OK();
@@ -273,6 +320,7 @@ Status CheckInputs(const Tensor* query,
                    const Tensor* past_value,
                    const Tensor* cos_cache,
                    const Tensor* sin_cache,
+                   const Tensor* block_table,
                    void* parameters,
                    int num_heads,
                    int kv_num_heads,
@@ -285,7 +333,7 @@ Status CheckInputs(const Tensor* query,
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "num_heads should be no larger than ", max_threads_per_block);
   }
 
-  return CheckInputs(query, key, value, past_key, past_value, cos_cache, sin_cache, parameters, num_heads, kv_num_heads, seqlens_k, total_seqlen, is_past_bsnh, scale);
+  return CheckInputs(query, key, value, past_key, past_value, cos_cache, sin_cache, block_table, parameters, num_heads, kv_num_heads, seqlens_k, total_seqlen, is_past_bsnh, scale);
 }
 
 }  // namespace group_query_attention_helper
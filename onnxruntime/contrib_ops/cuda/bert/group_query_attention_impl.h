@@ -21,6 +21,7 @@ struct GroupQueryAttentionData {
   const T* past_key = nullptr;
   const T* past_value = nullptr;
   int* seqlens_k = nullptr;
+  int* block_table = nullptr;
   const T* cos_cache = nullptr;
   const T* sin_cache = nullptr;
   // Flash buffers
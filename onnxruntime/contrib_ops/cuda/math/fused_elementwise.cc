@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cuda/math/fused_elementwise.h"
+
+#include <algorithm>
+
+using namespace onnxruntime::common;
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise, kMSDomain, 1, kCudaExecutionProvider,
+    (*KernelDefBuilder::Create()).TypeConstraint("T", BuildKernelDefConstraints<float, MLFloat16>()),
+    FusedElementwise);
+
+namespace {
+
+bool ParseElementwiseOp(const std::string& name, FusedElementwiseOp& op) {
+  static const InlinedHashMap<std::string, FusedElementwiseOp> ops{
+      {"Add", FusedElementwiseOp::Add},
+      {"Sub", FusedElementwiseOp::Sub},
+      {"Mul", FusedElementwiseOp::Mul},
+      {"Div", FusedElementwiseOp::Div},
+      {"Max", FusedElementwiseOp::Max},
+      {"Min", FusedElementwiseOp::Min},
+      {"Relu", FusedElementwiseOp::Relu},
+      {"Sigmoid", FusedElementwiseOp::Sigmoid},
+      {"Tanh", FusedElementwiseOp::Tanh},
+      {"Exp", FusedElementwiseOp::Exp},
+      {"Neg", FusedElementwiseOp::Neg},
+      {"Abs", FusedElementwiseOp::Abs},
+      {"Sqrt", FusedElementwiseOp::Sqrt},
+      {"Erf", FusedElementwiseOp::Erf},
+  };
+  auto it = ops.find(name);
+  if (it == ops.end()) {
+    return false;
+  }
+  op = it->second;
+  return true;
+}
+
+}  // namespace
+
+FusedElementwise::FusedElementwise(const OpKernelInfo& info) : CudaKernel(info) {
+  std::vector<std::string> ops = info.GetAttrsOrDefault<std::string>("ops");
+  std::vector<int64_t> operands = info.GetAttrsOrDefault<int64_t>("operands");
+  ORT_ENFORCE(!ops.empty() && operands.size() == 2 * ops.size(),
+              "FusedElementwise: 'operands' must hold two indices for every entry of 'ops'");
+
+  const int num_inputs = static_cast<int>(info.GetInputCount());
+  ORT_ENFORCE(num_inputs <= kMaxFusedElementwiseInputs && ops.size() <= kMaxFusedElementwiseOps,
+              "FusedElementwise: at most ", kMaxFusedElementwiseInputs, " inputs and ", kMaxFusedElementwiseOps,
+              " operators are supported on CUDA");
+
+  program_.num_inputs = num_inputs;
+  program_.num_ops = static_cast<int>(ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    ORT_ENFORCE(ParseElementwiseOp(ops[i], program_.ops[i]), "FusedElementwise: unsupported operator ", ops[i]);
+    const int64_t a = operands[2 * i];
+    const int64_t b = operands[2 * i + 1];
+
+    const int64_t num_values = num_inputs + static_cast<int64_t>(i);
+    ORT_ENFORCE(a >= 0 && a < num_values, "FusedElementwise: operand ", a, " of ", ops[i], " is out of range");
+    if (program_.ops[i] <= FusedElementwiseOp::Min) {
+      ORT_ENFORCE(b >= 0 && b < num_values, "FusedElementwise: operand ", b, " of ", ops[i], " is out of range");
+    } else {
+      ORT_ENFORCE(b == -1, "FusedElementwise: unary operator ", ops[i], " takes a single operand");
+    }
+    program_.operands[2 * i] = static_cast<int8_t>(a);
+    program_.operands[2 * i + 1] = static_cast<int8_t>(b);
+  }
+}
+
+template <typename T>
+void FusedElementwise::KernelLaunchDispatcher<T>::operator()(cudaStream_t stream,
+                                                             const FusedElementwiseProgram& program,
+                                                             OpKernelContext& context,
+                                                             const InlinedVector<int64_t>& input_sizes,
+                                                             Tensor& Y) const {
+  using CudaT = typename ToCudaType<T>::MappedType;
+  FusedElementwiseInputs<CudaT> inputs;
+  for (int i = 0; i < program.num_inputs; ++i) {
+    inputs.data[i] = reinterpret_cast<const CudaT*>(context.Input<Tensor>(i)->Data<T>());
+    inputs.size[i] = input_sizes[i];
+  }
+  LaunchFusedElementwiseKernel<CudaT>(stream, program, inputs, reinterpret_cast<CudaT*>(Y.MutableData<T>()),
+                                      Y.Shape().Size());
+}
+
+Status FusedElementwise::ComputeInternal(OpKernelContext* context) const {
+  const auto* X = context->Input<Tensor>(0);
+  const auto& output_shape = X->Shape();
+  auto* Y = context->Output(0, output_shape);
+  const int64_t output_size = output_shape.Size();
+  if (output_size == 0) {
+    return Status::OK();
+  }
+
+  // The other inputs are read periodically, so they must hold the trailing dimensions of the output.
+  const auto output_dims = output_shape.GetDims();
+  InlinedVector<int64_t> input_sizes(program_.num_inputs);
+  for (int i = 0; i < program_.num_inputs; ++i) {
+    const auto& shape = context->Input<Tensor>(i)->Shape();
+    input_sizes[i] = shape.Size();
+    if (input_sizes[i] == output_size || input_sizes[i] == 1) {
+      continue;
+    }
+    const auto dims = shape.GetDims();
+    auto first = std::find_if(dims.begin(), dims.end(), [](int64_t dim) { return dim != 1; });
+    const size_t rank = static_cast<size_t>(dims.end() - first);
+    ORT_RETURN_IF_NOT(rank <= output_dims.size() && std::equal(first, dims.end(), output_dims.end() - rank),
+                      "FusedElementwise: input ", i, " of shape ", shape,
+                      " does not broadcast to the output shape ", output_shape);
+  }
+
+  utils::MLTypeCallDispatcher<float, MLFloat16> dispatcher{X->GetElementType()};
+  dispatcher.Invoke<KernelLaunchDispatcher>(Stream(context), program_, *context, input_sizes, *Y);
+
+  return Status::OK();
+}
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
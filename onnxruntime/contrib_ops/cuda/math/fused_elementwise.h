@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/cuda/cuda_kernel.h"
+#include "contrib_ops/cuda/math/fused_elementwise_impl.h"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// Evaluates a chain of elementwise operators in a single kernel launch. See ElementwiseChainFusion.
+class FusedElementwise final : public CudaKernel {
+ public:
+  FusedElementwise(const OpKernelInfo& info);
+  Status ComputeInternal(OpKernelContext* context) const override;
+
+ private:
+  template <typename T>
+  struct KernelLaunchDispatcher {
+    void operator()(cudaStream_t stream, const FusedElementwiseProgram& program, OpKernelContext& context,
+                    const InlinedVector<int64_t>& input_sizes, Tensor& Y) const;
+  };
+
+  FusedElementwiseProgram program_;
+};
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
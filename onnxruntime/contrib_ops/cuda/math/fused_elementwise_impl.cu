@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cuda/math/fused_elementwise_impl.h"
+
+#include "core/providers/cuda/cu_inc/common.cuh"
+
+using namespace onnxruntime::cuda;
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+namespace {
+
+constexpr int kElementsPerThread = GridDim::maxElementsPerThread;
+constexpr int kThreadsPerBlock = GridDim::maxThreadsPerBlock;
+
+__device__ __forceinline__ float Evaluate(FusedElementwiseOp op, float a, float b) {
+  switch (op) {
+    case FusedElementwiseOp::Add:
+      return a + b;
+    case FusedElementwiseOp::Sub:
+      return a - b;
+    case FusedElementwiseOp::Mul:
+      return a * b;
+    case FusedElementwiseOp::Div:
+      return a / b;
+    case FusedElementwiseOp::Max:
+      return fmaxf(a, b);
+    case FusedElementwiseOp::Min:
+      return fminf(a, b);
+    case FusedElementwiseOp::Relu:
+      return fmaxf(a, 0.0f);
+    case FusedElementwiseOp::Sigmoid:
+      return 1.0f / (1.0f + expf(-a));
+    case FusedElementwiseOp::Tanh:
+      return tanhf(a);
+    case FusedElementwiseOp::Exp:
+      return expf(a);
+    case FusedElementwiseOp::Neg:
+      return -a;
+    case FusedElementwiseOp::Abs:
+      return fabsf(a);
+    case FusedElementwiseOp::Sqrt:
+      return sqrtf(a);
+    case FusedElementwiseOp::Erf:
+      return erff(a);
+  }
+  return a;
+}
+
+}  // namespace
+
+// Every thread runs the whole program for kElementsPerThread elements. The intermediate values stay in registers
+// (or local memory for long programs) and are computed in float.
+template <typename T>
+__global__ void FusedElementwiseKernel(const FusedElementwiseProgram program, const FusedElementwiseInputs<T> inputs,
+                                       T* output, CUDA_LONG N) {
+  const CUDA_LONG start = kElementsPerThread * kThreadsPerBlock * blockIdx.x + threadIdx.x;
+  float values[kMaxFusedElementwiseInputs + kMaxFusedElementwiseOps];
+
+#pragma unroll
+  for (int element = 0; element < kElementsPerThread; ++element) {
+    const CUDA_LONG id = start + element * kThreadsPerBlock;
+    if (id >= N) {
+      return;
+    }
+
+    for (int i = 0; i < program.num_inputs; ++i) {
+      const CUDA_LONG size = static_cast<CUDA_LONG>(inputs.size[i]);
+      values[i] = static_cast<float>(inputs.data[i][size == N ? id : id % size]);
+    }
+    for (int k = 0; k < program.num_ops; ++k) {
+      const int b = program.operands[2 * k + 1];
+      values[program.num_inputs + k] = Evaluate(program.ops[k], values[program.operands[2 * k]],
+                                                b >= 0 ? values[b] : 0.0f);
+    }
+    output[id] = static_cast<T>(values[program.num_inputs + program.num_ops - 1]);
+  }
+}
+
+template <typename T>
+void LaunchFusedElementwiseKernel(cudaStream_t stream, const FusedElementwiseProgram& program,
+                                  const FusedElementwiseInputs<T>& inputs, T* output, int64_t output_size) {
+  const int blocks_per_grid =
+      static_cast<int>(CeilDiv(output_size, static_cast<int64_t>(kElementsPerThread * kThreadsPerBlock)));
+  FusedElementwiseKernel<T><<<blocks_per_grid, kThreadsPerBlock, 0, stream>>>(
+      program, inputs, output, static_cast<CUDA_LONG>(output_size));
+}
+
+#define SPECIALIZED_FUSED_ELEMENTWISE_IMPL(T)                                                                 \
+  template void LaunchFusedElementwiseKernel<T>(cudaStream_t stream, const FusedElementwiseProgram& program, \
+                                                const FusedElementwiseInputs<T>& inputs, T* output,          \
+                                                int64_t output_size);
+
+SPECIALIZED_FUSED_ELEMENTWISE_IMPL(float)
+SPECIALIZED_FUSED_ELEMENTWISE_IMPL(half)
+
+#undef SPECIALIZED_FUSED_ELEMENTWISE_IMPL
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace onnxruntime {
+namespace contrib {
+namespace cuda {
+
+// The program of a FusedElementwise node is passed to the kernel by value, so its size is bounded.
+constexpr int kMaxFusedElementwiseInputs = 8;
+constexpr int kMaxFusedElementwiseOps = 16;
+
+enum class FusedElementwiseOp : uint8_t {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Max,
+  Min,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Exp,
+  Neg,
+  Abs,
+  Sqrt,
+  Erf,
+};
+
+// Operand indices below num_inputs refer to an input, otherwise to the result of the op at (index - num_inputs).
+struct FusedElementwiseProgram {
+  int num_inputs;
+  int num_ops;
+  FusedElementwiseOp ops[kMaxFusedElementwiseOps];
+  int8_t operands[2 * kMaxFusedElementwiseOps];
+};
+
+// Every input is read at (output index % size), which covers full-shaped, scalar, and trailing-dimension inputs.
+template <typename T>
+struct FusedElementwiseInputs {
+  const T* data[kMaxFusedElementwiseInputs];
+  int64_t size[kMaxFusedElementwiseInputs];
+};
+
+template <typename T>
+void LaunchFusedElementwiseKernel(cudaStream_t stream, const FusedElementwiseProgram& program,
+                                  const FusedElementwiseInputs<T>& inputs, T* output, int64_t output_size);
+
+}  // namespace cuda
+}  // namespace contrib
+}  // namespace onnxruntime
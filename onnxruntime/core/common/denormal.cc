@@ -42,4 +42,36 @@ bool SetDenormalAsZero(bool on) {
   return false;
 }
 
+bool IsDenormalAsZero() {
+#ifdef DENORMAL_INTRINC
+  if (CPUIDInfo::GetCPUIDInfo().HasSSE3()) {
+    return _MM_GET_DENORMALS_ZERO_MODE() == _MM_DENORMALS_ZERO_ON &&
+           _MM_GET_FLUSH_ZERO_MODE() == _MM_FLUSH_ZERO_ON;
+  }
+#endif
+  return false;
+}
+
+namespace {
+thread_local bool in_denormal_as_zero_scope = false;
+}  // namespace
+
+bool InDenormalAsZeroScope() {
+  return in_denormal_as_zero_scope;
+}
+
+ScopedDenormalAsZero::ScopedDenormalAsZero() {
+  if (!IsDenormalAsZero() && SetDenormalAsZero(true)) {
+    set_ = true;
+    in_denormal_as_zero_scope = true;
+  }
+}
+
+ScopedDenormalAsZero::~ScopedDenormalAsZero() {
+  if (set_) {
+    SetDenormalAsZero(false);
+    in_denormal_as_zero_scope = false;
+  }
+}
+
 }  // namespace onnxruntime
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/hardware_counters.h"
+
+#include <sstream>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace onnxruntime {
+namespace profiling {
+
+namespace {
+// the DRAM traffic is estimated as one cache line per last level cache miss, which ignores the prefetchers
+constexpr uint64_t kCacheLineSize = 64;
+}  // namespace
+
+#if defined(__linux__) && !defined(__ANDROID__)
+namespace {
+
+class ThreadCounters {
+ public:
+  ThreadCounters() {
+    leader_fd_ = Open(PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (leader_fd_ < 0) {
+      return;
+    }
+    instructions_fd_ = Open(PERF_COUNT_HW_INSTRUCTIONS, leader_fd_);
+    llc_misses_fd_ = Open(PERF_COUNT_HW_CACHE_MISSES, leader_fd_);
+    if (instructions_fd_ < 0 || llc_misses_fd_ < 0) {
+      Close();
+      return;
+    }
+    ioctl(leader_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+
+  ~ThreadCounters() { Close(); }
+
+  bool IsOpen() const { return leader_fd_ >= 0; }
+
+  bool Read(HardwareCounters::Values& values) const {
+    if (!IsOpen()) {
+      return false;
+    }
+    // layout of PERF_FORMAT_GROUP with the enabled and running times: nr, time_enabled, time_running, values[nr]
+    uint64_t data[6];
+    if (read(leader_fd_, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[0] != 3) {
+      return false;
+    }
+    values.time_enabled_ns = data[1];
+    values.time_running_ns = data[2];
+    values.cycles = data[3];
+    values.instructions = data[4];
+    values.llc_misses = data[5];
+    return true;
+  }
+
+ private:
+  static int Open(uint64_t config, int group_fd) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    // the leader starts disabled so that the group is enabled at once
+    attr.disabled = group_fd < 0 ? 1 : 0;
+    // user space only, which is allowed with the default perf_event_paranoid of 2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // pid 0 and cpu -1 count the calling thread on any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+  }
+
+  void Close() {
+    for (int* fd : {&llc_misses_fd_, &instructions_fd_, &leader_fd_}) {
+      if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+      }
+    }
+  }
+
+  int leader_fd_{-1};
+  int instructions_fd_{-1};
+  int llc_misses_fd_{-1};
+};
+
+const ThreadCounters& GetThreadCounters() {
+  thread_local ThreadCounters counters;
+  return counters;
+}
+
+}  // namespace
+
+bool HardwareCounters::IsAvailable() {
+  return GetThreadCounters().IsOpen();
+}
+
+bool HardwareCounters::Read(Values& values) {
+  return GetThreadCounters().Read(values);
+}
+#else
+bool HardwareCounters::IsAvailable() {
+  return false;
+}
+
+bool HardwareCounters::Read(Values& /*values*/) {
+  return false;
+}
+#endif
+
+std::string HardwareCounters::ToJson(const Values& begin, const Values& end, long long duration_us) {
+  const uint64_t enabled = end.time_enabled_ns - begin.time_enabled_ns;
+  const uint64_t running = end.time_running_ns - begin.time_running_ns;
+  // extrapolates the counts to the whole interval when the group was multiplexed with other events
+  const double scale = running > 0 ? static_cast<double>(enabled) / static_cast<double>(running) : 0.0;
+  const auto cycles = static_cast<uint64_t>(static_cast<double>(end.cycles - begin.cycles) * scale);
+  const auto instructions = static_cast<uint64_t>(static_cast<double>(end.instructions - begin.instructions) * scale);
+  const auto llc_misses = static_cast<uint64_t>(static_cast<double>(end.llc_misses - begin.llc_misses) * scale);
+
+  const uint64_t dram_bytes = llc_misses * kCacheLineSize;
+
+  std::ostringstream ss;
+  ss << "{\"cycles\":" << cycles
+     << ",\"instructions\":" << instructions
+     << ",\"llc_misses\":" << llc_misses
+     << ",\"ipc\":" << (cycles > 0 ? static_cast<double>(instructions) / static_cast<double>(cycles) : 0.0)
+     << ",\"estimated_dram_bytes\":" << dram_bytes
+     << ",\"estimated_dram_gbps\":"
+     << (duration_us > 0 ? static_cast<double>(dram_bytes) / (static_cast<double>(duration_us) * 1000.0) : 0.0)
+     << ",\"multiplexed\":" << (running < enabled ? "true" : "false") << "}";
+  return ss.str();
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
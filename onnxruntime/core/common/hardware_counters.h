@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace onnxruntime {
+namespace profiling {
+
+/**
+ * Hardware performance counters of the calling thread, read with perf_event_open on Linux.
+ * The counters are opened once per thread as a single group, so that they are scheduled on the PMU together and
+ * their values are consistent with each other. They are not available on other platforms, when the kernel
+ * doesn't allow it (see /proc/sys/kernel/perf_event_paranoid), or in virtual machines without a virtual PMU.
+ */
+class HardwareCounters {
+ public:
+  struct Values {
+    uint64_t cycles{};
+    uint64_t instructions{};
+    uint64_t llc_misses{};
+    // the time the group was enabled and counting, running is less than enabled when the PMU was multiplexed
+    uint64_t time_enabled_ns{};
+    uint64_t time_running_ns{};
+  };
+
+  /*
+  Whether the counters of the calling thread could be opened.
+  */
+  static bool IsAvailable();
+
+  /*
+  Reads the counters of the calling thread. Returns false if they are not available.
+  */
+  static bool Read(Values& values);
+
+  /*
+  The counters between two reads as the JSON object added to the args of a profiling event: the cycles,
+  instructions and last level cache misses scaled for multiplexing, the instructions per cycle, and the DRAM
+  traffic estimated from the cache misses with its bandwidth over duration_us.
+  */
+  static std::string ToJson(const Values& begin, const Values& end, long long duration_us);
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
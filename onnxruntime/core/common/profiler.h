@@ -60,6 +60,17 @@ class Profiler {
   bool IsEnabled() const {
     return enabled_;
   }
+
+  /*
+  Whether the hardware counters of the thread running a node are added to its kernel event.
+  See HardwareCounters for the platforms they are available on.
+  */
+  void EnableHardwareCounters(bool enable) {
+    hardware_counters_enabled_ = enable;
+  }
+  bool HardwareCountersEnabled() const {
+    return hardware_counters_enabled_;
+  }
   /*
   Return the stored start time of profiler.
   On some platforms, this timer may not be as precise as nanoseconds
@@ -132,6 +143,7 @@ class Profiler {
   // Mutex controlling access to profiler data
   OrtMutex mutex_;
   bool enabled_{false};
+  bool hardware_counters_enabled_{false};
 #if defined(__wasm__)
   /*
    * The simplest way to emit profiling data in WebAssembly is to print out to console,
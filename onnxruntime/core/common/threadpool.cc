@@ -19,6 +19,7 @@ limitations under the License.
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
 #include "core/common/cpuid_info.h"
+#include "core/common/denormal.h"
 #include "core/common/eigen_common_wrapper.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
@@ -202,10 +203,35 @@ void ThreadPoolProfiler::LogThreadId(int thread_idx) {
   child_thread_stats_[thread_idx].thread_id_ = std::this_thread::get_id();
 }
 
+void ThreadPoolProfiler::LogSpinStart(int thread_idx) {
+  if (enabled_) {
+    child_thread_stats_[thread_idx].spin_start_point_ = Clock::now();
+  }
+}
+
+void ThreadPoolProfiler::LogSpinEnd(int thread_idx) {
+  auto& stat = child_thread_stats_[thread_idx];
+  // the profiler may have been started while the thread was spinning
+  if (enabled_ && stat.spin_start_point_ != onnxruntime::TimePoint{}) {
+    stat.spin_time_ += Clock::now() - stat.spin_start_point_;
+    stat.spin_start_point_ = {};
+  }
+}
+
+void ThreadPoolProfiler::LogRunStart(int thread_idx) {
+  if (enabled_) {
+    child_thread_stats_[thread_idx].run_start_point_ = Clock::now();
+  }
+}
+
 void ThreadPoolProfiler::LogRun(int thread_idx) {
   if (enabled_) {
     child_thread_stats_[thread_idx].num_run_++;
     auto now = Clock::now();
+    if (child_thread_stats_[thread_idx].run_start_point_ != onnxruntime::TimePoint{}) {
+      child_thread_stats_[thread_idx].run_time_ += now - child_thread_stats_[thread_idx].run_start_point_;
+      child_thread_stats_[thread_idx].run_start_point_ = {};
+    }
     if (child_thread_stats_[thread_idx].core_ < 0 ||
         TimeDiffMicroSeconds(child_thread_stats_[thread_idx].last_logged_point_, now) > 10000) {
 #ifdef _WIN32
@@ -235,6 +261,10 @@ std::string ThreadPoolProfiler::DumpChildThreadStat() {
   for (int i = 0; i < num_threads_; ++i) {
     ss << "\"" << child_thread_stats_[i].thread_id_ << "\": {"
        << "\"num_run\": " << child_thread_stats_[i].num_run_ << ", "
+       << "\"spin_us\": "
+       << std::chrono::duration_cast<std::chrono::microseconds>(child_thread_stats_[i].spin_time_).count() << ", "
+       << "\"run_us\": "
+       << std::chrono::duration_cast<std::chrono::microseconds>(child_thread_stats_[i].run_time_).count() << ", "
        << "\"core\": " << child_thread_stats_[i].core_ << "}"
        << (i == num_threads_ - 1 ? "" : ",");
   }
@@ -410,7 +440,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
   if (total <= 0)
     return;
 
-  if (total <= block_size) {
+  if (total <= block_size || NumThreadsToUse() == 0) {
     fn(0, total);
     return;
   }
@@ -420,7 +450,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
     auto num_blocks = total / block_size;
-    auto num_threads_inc_main = NumThreads() + 1;
+    auto num_threads_inc_main = NumThreadsToUse() + 1;
     int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
     assert(num_work_items > 0);
 
@@ -459,7 +489,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     };
     // Distribute task among all threads in the pool, reduce number of work items if
     // num_of_blocks is smaller than number of threads.
-    RunInParallel(run_work, std::min(NumThreads() + 1, num_of_blocks), base_block_size);
+    RunInParallel(run_work, std::min(NumThreadsToUse() + 1, num_of_blocks), base_block_size);
   }
 }
 
@@ -471,9 +501,43 @@ void ThreadPool::SimpleParallelFor(std::ptrdiff_t total, const std::function<voi
   });
 }
 
+namespace {
+// Maximum degree of parallelism of loops started by the current thread, 0 if there is no limit.
+thread_local int max_degree_of_parallelism_limit = 0;
+
+// Make fn run with the degree of parallelism limit of the calling thread.
+std::function<void()> InheritDegreeOfParallelismLimit(std::function<void()> fn) {
+  if (max_degree_of_parallelism_limit == 0) {
+    return fn;
+  }
+  return [limit = max_degree_of_parallelism_limit, fn = std::move(fn)]() {
+    ThreadPool::ScopedDegreeOfParallelismLimit scoped_limit(limit);
+    fn();
+  };
+}
+}  // namespace
+
+ThreadPool::ScopedDegreeOfParallelismLimit::ScopedDegreeOfParallelismLimit(int max_degree_of_parallelism)
+    : previous_limit_(max_degree_of_parallelism_limit) {
+  ORT_ENFORCE(max_degree_of_parallelism >= 0, "Degree of parallelism limit must be non-negative");
+  max_degree_of_parallelism_limit = max_degree_of_parallelism;
+}
+
+ThreadPool::ScopedDegreeOfParallelismLimit::~ScopedDegreeOfParallelismLimit() {
+  max_degree_of_parallelism_limit = previous_limit_;
+}
+
 void ThreadPool::Schedule(std::function<void()> fn) {
   if (underlying_threadpool_) {
-    underlying_threadpool_->Schedule(std::move(fn));
+    underlying_threadpool_->Schedule(InheritDegreeOfParallelismLimit(std::move(fn)));
+  } else {
+    fn();
+  }
+}
+
+void ThreadPool::ScheduleWithLocality(std::function<void()> fn) {
+  if (underlying_threadpool_) {
+    underlying_threadpool_->ScheduleWithLocality(InheritDegreeOfParallelismLimit(std::move(fn)));
   } else {
     fn();
   }
@@ -517,6 +581,14 @@ ThreadPool::ParallelSection::~ParallelSection() {
 
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
   if (underlying_threadpool_) {
+    // The parallel loops of a kernel run with flush-to-zero and denormal-as-zero run the same way on the threads
+    // of the pool, unless these are set for the whole pool.
+    if (!thread_options_.set_denormal_as_zero && InDenormalAsZeroScope()) {
+      fn = [fn = std::move(fn)](unsigned idx) {
+        ScopedDenormalAsZero denormal_as_zero;
+        fn(idx);
+      };
+    }
     if (current_parallel_section.has_value()) {
       underlying_threadpool_->RunInParallelSection(*current_parallel_section,
                                                    std::move(fn),
@@ -541,7 +613,7 @@ bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
   // caller is outside the current pool (ID == -1) then we parallelize
   // if the pool has any threads.  If the caller is inside the current pool
   // (ID != -1) then we require at least one additional thread in the pool.
-  if ((CurrentThreadId() == -1 && NumThreads() == 0) ||
+  if (NumThreadsToUse() == 0 ||
       (CurrentThreadId() != -1 && NumThreads() == 1)) {
     return false;
   }
@@ -631,6 +703,49 @@ void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
   ParallelFor(total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
 }
 
+void ThreadPool::GuidedParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
+                                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& f) {
+  ORT_ENFORCE(n >= 0);
+  Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
+  auto d_of_p = DegreeOfParallelism(this);
+  // Compute small problems directly in the caller thread.
+  if ((!ShouldParallelizeLoop(n)) ||
+      CostModel::numThreads(static_cast<double>(n), cost, d_of_p) == 1) {
+    f(0, n);
+    return;
+  }
+
+  // The smallest chunk that is worth a task of its own, as in CalculateParallelForBlock.
+  const double min_chunk_f = std::min(1.0 / CostModel::taskSize(1, cost), static_cast<double>(n));
+  const std::ptrdiff_t min_chunk = std::max<std::ptrdiff_t>(1, static_cast<std::ptrdiff_t>(min_chunk_f));
+  const std::ptrdiff_t num_threads_inc_main = NumThreadsToUse() + 1;
+  const std::ptrdiff_t num_work_items = std::min(num_threads_inc_main,
+                                                 Eigen::numext::div_ceil<std::ptrdiff_t>(n, min_chunk));
+  if (num_work_items <= 1) {
+    f(0, n);
+    return;
+  }
+
+  alignas(CACHE_LINE_BYTES) std::atomic<std::ptrdiff_t> next{0};
+  std::function<void(unsigned)> run_work = [&](unsigned) {
+    std::ptrdiff_t start = next.load(std::memory_order_relaxed);
+    while (start < n) {
+      // Claim a share of what is left, so that each thread still gets some of the remaining work if the
+      // iterations claimed so far turn out to be the expensive ones.
+      const std::ptrdiff_t chunk = std::max(min_chunk, (n - start) / (2 * num_work_items));
+      const std::ptrdiff_t end = std::min(n, start + chunk);
+      // On failure, start is updated with the iterations claimed by the other threads.
+      if (next.compare_exchange_weak(start, end, std::memory_order_relaxed)) {
+        f(start, end);
+        start = next.load(std::memory_order_relaxed);
+      }
+    }
+  };
+  // Synchronization with helping threads is handled within RunInParallel, hence we can deallocate next
+  // once it returns.
+  RunInParallel(run_work, static_cast<unsigned>(num_work_items), min_chunk);
+}
+
 bool ThreadPool::ShouldParallelize(const concurrency::ThreadPool* tp) {
   return (DegreeOfParallelism(tp) != 1);
 }
@@ -640,9 +755,9 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // tp, plus 1 for the thread entering a loop.
   if (tp) {
     if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
-      return ((tp->NumThreads() + 1)) * TaskGranularityFactor;
+      return ((tp->NumThreadsToUse() + 1)) * TaskGranularityFactor;
     } else {
-      return ((tp->NumThreads() + 1));
+      return ((tp->NumThreadsToUse() + 1));
     }
   } else {
     return 1;
@@ -684,6 +799,15 @@ int ThreadPool::NumThreads() const {
   }
 }
 
+int ThreadPool::NumThreadsToUse() const {
+  const int num_threads = NumThreads();
+  if (max_degree_of_parallelism_limit > 0) {
+    // The limit includes the calling thread.
+    return std::min(num_threads, max_degree_of_parallelism_limit - 1);
+  }
+  return num_threads;
+}
+
 // Return ID of the current thread within this pool.  Returns -1 for a thread outside the
 // current pool.
 int ThreadPool::CurrentThreadId() const {
@@ -703,5 +827,15 @@ void ThreadPool::TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t tota
   tp->ParallelFor(total, cost_per_unit, fn);
 }
 
+void ThreadPool::TryGuidedParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t total,
+                                      const TensorOpCost& cost_per_unit,
+                                      const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
+  if (tp == nullptr) {
+    fn(0, total);
+    return;
+  }
+  tp->GuidedParallelFor(total, cost_per_unit, fn);
+}
+
 }  // namespace concurrency
 }  // namespace onnxruntime
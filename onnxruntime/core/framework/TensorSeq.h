@@ -98,6 +98,27 @@ class TensorSeq {
     Add(std::move(value));
   }
 
+  // Insert a tensor before the i-th one, or at the end if i is Size().
+  // Used by the kernels updating a sequence in place.
+  void InsertAt(size_t i, OrtValue&& tensor) {
+    ORT_ENFORCE(i <= tensors_.size());
+    ORT_ENFORCE(IsSameDataType(tensor.Get<Tensor>()),
+                "TensorSeq: tensor to be added has a different data type.");
+    tensors_.insert(tensors_.begin() + i, std::move(tensor));
+  }
+
+  void InsertAt(size_t i, Tensor&& tensor) {
+    OrtValue value;
+    Tensor::InitOrtValue(std::move(tensor), value);
+    InsertAt(i, std::move(value));
+  }
+
+  // Remove the i-th tensor. Used by the kernels updating a sequence in place.
+  void EraseAt(size_t i) {
+    ORT_ENFORCE(i < tensors_.size());
+    tensors_.erase(tensors_.begin() + i);
+  }
+
   static void InitOrtValue(const TensorSeq& source_tensor_seq, std::shared_ptr<IAllocator> allocator, OrtValue& ort_value) {
     auto target_tensor_seq = std::make_unique<TensorSeq>(source_tensor_seq.DataType());
     target_tensor_seq->Reserve(source_tensor_seq.Size());
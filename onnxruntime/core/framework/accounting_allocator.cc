@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/accounting_allocator.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+OrtMemoryInfo AccountingAllocator::MakeInfo(const OrtMemoryInfo& info) {
+  OrtMemoryInfo accounting_info = info;
+  accounting_info.alloc_type = OrtAllocatorType::OrtDeviceAllocator;
+  return accounting_info;
+}
+
+AccountingAllocator::AccountingAllocator(AllocatorPtr allocator, size_t memory_limit)
+    : IAllocator(MakeInfo(allocator->Info())),
+      allocator_(std::move(allocator)),
+      memory_limit_(memory_limit) {
+  stats_.bytes_limit = static_cast<int64_t>(memory_limit_);
+}
+
+void* AccountingAllocator::Alloc(size_t size) {
+  return Allocate(size, false);
+}
+
+void* AccountingAllocator::Reserve(size_t size) {
+  return Allocate(size, true);
+}
+
+void* AccountingAllocator::Allocate(size_t size, bool reserve) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    // the limit is checked before the allocation so that a session over its limit does not make the shared
+    // allocator grow. Concurrent allocations of the session may overshoot it by their sizes.
+    ORT_ENFORCE(memory_limit_ == 0 || static_cast<size_t>(stats_.bytes_in_use) + size <= memory_limit_,
+                "Session memory limit of ", memory_limit_, " bytes on ", allocator_->Info().name,
+                " exceeded by an allocation of ", size, " bytes. ", stats_.bytes_in_use, " bytes are in use.");
+  }
+
+  void* p = reserve ? allocator_->Reserve(size) : allocator_->Alloc(size);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  allocation_sizes_[p] = size;
+  stats_.num_allocs += 1;
+  if (reserve) {
+    stats_.num_reserves += 1;
+  }
+  stats_.bytes_in_use += static_cast<int64_t>(size);
+  stats_.total_allocated_bytes = stats_.bytes_in_use;
+  stats_.max_bytes_in_use = std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
+  stats_.max_alloc_size = std::max(stats_.max_alloc_size, static_cast<int64_t>(size));
+  return p;
+}
+
+void AccountingAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = allocation_sizes_.find(p);
+    if (it != allocation_sizes_.end()) {
+      stats_.bytes_in_use -= static_cast<int64_t>(it->second);
+      stats_.total_allocated_bytes = stats_.bytes_in_use;
+      allocation_sizes_.erase(it);
+    }
+  }
+
+  allocator_->Free(p);
+}
+
+void AccountingAllocator::GetStats(AllocatorStats* stats) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  *stats = stats_;
+}
+
+}  // namespace onnxruntime
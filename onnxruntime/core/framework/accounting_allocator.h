@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Tracks the memory a single session allocates from an allocator shared with other sessions, and optionally limits
+ * it. Allocations that would take the session over the limit fail as if the allocator was out of memory, without
+ * affecting the other users of the shared allocator.
+ *
+ * The wrapper reports itself as a device allocator, so that the arena specific code paths, which down cast arena
+ * allocators to BFCArena, do not apply to it. Reserve() is forwarded to the wrapped allocator.
+ */
+class AccountingAllocator : public IAllocator {
+ public:
+  // memory_limit is the maximum number of bytes in use by the session, 0 for no limit.
+  AccountingAllocator(AllocatorPtr allocator, size_t memory_limit);
+
+  void* Alloc(size_t size) override;
+  void* Reserve(size_t size) override;
+  void Free(void* p) override;
+
+  // The usage of the session. bytes_limit is the memory limit of the session.
+  void GetStats(AllocatorStats* stats) override;
+
+  const AllocatorPtr& GetWrappedAllocator() const { return allocator_; }
+
+ private:
+  void* Allocate(size_t size, bool reserve);
+
+  static OrtMemoryInfo MakeInfo(const OrtMemoryInfo& info);
+
+  AllocatorPtr allocator_;
+  const size_t memory_limit_;
+
+  OrtMutex mutex_;
+  // Size of every allocation that is not freed yet.
+  InlinedHashMap<void*, size_t> allocation_sizes_;
+  AllocatorStats stats_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(AccountingAllocator);
+};
+
+}  // namespace onnxruntime
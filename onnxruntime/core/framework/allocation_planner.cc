@@ -217,6 +217,11 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // The inputs of Concat nodes which are written to directly in the output of the Concat: the index of the output
+  // and the byte offset of the input in it. concat_outputs_ holds these outputs.
+  InlinedHashMap<OrtValueIndex, std::pair<OrtValueIndex, ptrdiff_t>> concat_slices_;
+  InlinedHashSet<OrtValueIndex> concat_outputs_;
+
   OrtValueIndex Index(const OrtValueName& name) {
     OrtValueIndex result;
     auto status = ort_value_name_idx_map_.GetIdx(name, result);
@@ -357,7 +362,8 @@ class PlannerImpl {
             auto input_arg_index = Index(p_input_arg->Name());
             auto original = Buffer(input_arg_index);
             if (1 == UseCount(original)) {
-              if (SameSize(*p_input_arg, *p_output_arg)) {
+              // A sequence has no shape, it can be updated in place into a sequence of the same type
+              if (IsSequenceOfSameType(*p_input_arg, *p_output_arg) || SameSize(*p_input_arg, *p_output_arg)) {
                 // we can reuse this input since it is its last use and permitted for in-place update
                 *reusable_input = input_arg_index;  // or original; both should be okay
                 return true;
@@ -368,6 +374,21 @@ class PlannerImpl {
       }
     }
 
+    if (context_->GetEnableElementwiseInplace() && alias_map.empty() && !variadic_alias_offsets.has_value() &&
+        inplace_map.empty() && IsInplaceSafeElementwiseOp(node) && !IsNonTensor(*p_output_arg)) {
+      // the kernel computes each output element from the input elements at the same position, so it can overwrite
+      // any input of the same shape and type that is not used after this node.
+      for (auto p_input_arg : input_args) {
+        if (p_input_arg->Exists() && !IsNonTensor(*p_input_arg) && p_input_arg->Type() == p_output_arg->Type()) {
+          auto input_arg_index = Index(p_input_arg->Name());
+          if (1 == UseCount(Buffer(input_arg_index)) && SameSize(*p_input_arg, *p_output_arg)) {
+            *reusable_input = input_arg_index;
+            return true;
+          }
+        }
+      }
+    }
+
 #ifdef ENABLE_STRIDED_TENSORS
     // If any output of the kernel can support strided tensor, and all its consumers' inputs also support
     // strided tensors at the corresponding position, this output will generate a strided tensor
@@ -407,6 +428,19 @@ class PlannerImpl {
     return false;
   }
 
+  // Whether the node is an ONNX op assigned to the CPU EP, whose kernel reads the input elements at each position
+  // of the output (or the broadcast ones) before writing the output element, in a single pass. Writing the output
+  // into such an input is safe. Variadic ops are left out as their kernels accumulate into the output.
+  static bool IsInplaceSafeElementwiseOp(const onnxruntime::Node& node) {
+    static const InlinedHashSet<std::string_view> elementwise_ops = {
+        "Abs", "Add", "Ceil", "Cos", "Div", "Elu", "Erf", "Exp", "Floor", "HardSigmoid", "LeakyRelu", "Log", "Mul",
+        "Neg", "Pow", "PRelu", "Reciprocal", "Relu", "Round", "Selu", "Sigmoid", "Sign", "Sin", "Softplus",
+        "Softsign", "Sqrt", "Sub", "Tanh", "ThresholdedRelu"};
+    return node.GetExecutionProviderType() == kCpuExecutionProvider &&
+           (node.Domain().empty() || node.Domain() == kOnnxDomain) &&
+           elementwise_ops.count(node.OpType()) > 0;
+  }
+
   static bool SameShape(const TensorShapeProto& shape1, const TensorShapeProto& shape2) {
     // TODO: This should probably be defined to be the equality operator on TensorShapeProto.
     namespace on = ONNX_NAMESPACE;
@@ -478,6 +512,107 @@ class PlannerImpl {
     return SameSize(*p_shape1, arg1, *p_shape2, arg2);
   }
 
+  // Returns the element type of a tensor with a static shape, nullptr otherwise.
+  const PrimitiveDataTypeBase* GetStaticTensorElementType(const onnxruntime::NodeArg& arg) {
+    const auto* shape = context_->GetShape(arg);
+    if (shape == nullptr || arg.TypeAsProto() == nullptr || !utils::HasTensorType(*arg.TypeAsProto())) {
+      return nullptr;
+    }
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim)) {
+        return nullptr;
+      }
+    }
+    const auto* tensor_type = utils::GetMLDataType(arg)->AsTensorType();
+    return tensor_type != nullptr ? tensor_type->GetElementType()->AsPrimitiveDataType() : nullptr;
+  }
+
+  // Finds the inputs of the CPU Concat nodes which their producers can write to directly in the output of the Concat,
+  // instead of the Concat copying them: the inputs are contiguous parts of the output when all the dimensions before
+  // the axis are 1, and a producer can write to a part of the output when the input is only consumed by the Concat.
+  // The shapes must be static for the output to be allocated when the first producer runs.
+  void ComputeConcatSlices() {
+    concat_slices_.clear();
+    concat_outputs_.clear();
+
+#if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    for (const auto& node : graph_viewer_.Nodes()) {
+      if (node.OpType() != "Concat" || node.Domain() != kOnnxDomain ||
+          node.GetExecutionProviderType() != kCpuExecutionProvider) {
+        continue;
+      }
+
+      const NodeArg& output = *node.OutputDefs()[0];
+      const auto* output_shape = context_->GetShape(output);
+      const auto* element_type = GetStaticTensorElementType(output);
+      const auto axis_attr = node.GetAttributes().find("axis");
+      if (element_type == nullptr || element_type->GetDataType() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+          axis_attr == node.GetAttributes().end()) {
+        continue;
+      }
+
+      const int rank = output_shape->dim_size();
+      const int64_t axis = axis_attr->second.i() < 0 ? axis_attr->second.i() + rank : axis_attr->second.i();
+      if (axis < 0 || axis >= rank) {
+        continue;
+      }
+      bool contiguous_inputs = true;
+      for (int i = 0; i < axis; ++i) {
+        contiguous_inputs = contiguous_inputs && output_shape->dim(i).dim_value() == 1;
+      }
+      if (!contiguous_inputs) {
+        continue;
+      }
+
+      const OrtValueIndex output_index = Index(output.Name());
+      const auto& input_defs = node.InputDefs();
+      InlinedVector<std::pair<OrtValueIndex, ptrdiff_t>> slices;
+      SafeInt<ptrdiff_t> offset = 0;
+      for (const NodeArg* input : input_defs) {
+        if (GetStaticTensorElementType(*input) != element_type) {
+          break;
+        }
+
+        const Node* producer = graph_viewer_.GetProducerNode(input->Name());
+        const OrtValueIndex input_index = Index(input->Name());
+        SafeInt<ptrdiff_t> input_size = static_cast<ptrdiff_t>(element_type->Size());
+        for (const auto& dim : context_->GetShape(*input)->dim()) {
+          input_size *= dim.dim_value();
+        }
+
+        // the output of a Concat producing an input is not a part of the output, it is written to by its own inputs
+        if (producer != nullptr && producer->GetExecutionProviderType() == kCpuExecutionProvider &&
+            producer->OpType() != "Concat" && !producer->ContainsSubgraph() && !HasExternalOutputs(*producer) &&
+            graph_viewer_.GetConsumerNodes(input->Name()).size() == 1 &&
+            std::count(input_defs.begin(), input_defs.end(), input) == 1 &&
+            std::find(graph_outputs.begin(), graph_outputs.end(), input) == graph_outputs.end() &&
+            AllocPlan(input_index).location == AllocPlan(output_index).location) {
+          const KernelCreateInfo& producer_ci = GetKernelCreateInfo(kernel_create_info_map_, producer->Index());
+          if (producer_ci.kernel_def != nullptr && producer_ci.kernel_def->Alias().empty() &&
+              !producer_ci.kernel_def->VariadicAlias().has_value()) {
+            slices.emplace_back(input_index, offset);
+          }
+        }
+
+        offset += input_size;
+      }
+
+      // all the inputs must have a known size to know the offsets
+      if (slices.empty() ||
+          static_cast<size_t>(offset) != Tensor::CalculateTensorStorageSize(
+                                             element_type, utils::GetTensorShapeFromTensorShapeProto(*output_shape))) {
+        continue;
+      }
+
+      concat_outputs_.insert(output_index);
+      for (const auto& slice : slices) {
+        concat_slices_[slice.first] = {output_index, slice.second};
+      }
+    }
+#endif
+  }
+
   // Find if freelist contains a buffer of the same size as output_arg
   bool FindReusableTensor(const onnxruntime::NodeArg& output_arg, OrtValueIndex* reusable_tensor) {
     if (!context_->GetEnableMemoryReuse()) {
@@ -1341,6 +1476,9 @@ class PlannerImpl {
     std::vector<int> ort_value_usecount;
     ort_value_usecount.reserve(ort_value_info_.size());
 #endif
+    if (IsSingleStream() && !context_->IsParallelExecutionEnabled() && context_->GetEnableMemoryReuse()) {
+      ComputeConcatSlices();
+    }
     for (size_t i = 0; i < stream_nodes_.size(); ++i) {
       // compute use count first. TODO(leca): call ComputeReuseCount() only once is enough!
       ORT_RETURN_IF_ERROR(ComputeReuseCount());
@@ -1438,6 +1576,14 @@ class PlannerImpl {
               }
             }
           }
+        } else if (auto concat_slice = concat_slices_.find(current); concat_slice != concat_slices_.end()) {
+          // the producer writes to its part of the output of the Concat consuming it
+          Reuse(concat_slice->second.first, current, AllocKind::kReuse);
+          AllocPlan(current).is_slice_of_reused_buffer = true;
+          AllocPlan(current).reused_buffer_offset = concat_slice->second.second;
+        } else if (concat_outputs_.count(current) != 0) {
+          // the output of a Concat is allocated by the first producer of its inputs, it can't reuse a buffer
+          AllocPlan(current).alloc_kind = AllocKind::kAllocate;
         } else if (!context_->IsParallelExecutionEnabled() &&
                    FindReusableInput(*pnode, static_cast<int>(output_arg_def_index), &reused, &is_strided_tensor)) {
           // Re-using inputs is applicable for tensors, sequence tensors,
@@ -1793,7 +1939,8 @@ class PlannerImpl {
   void
   PartitionIntoStreams(const logging::Logger& logger, const ExecutionProviders& execution_providers,
                        const PathString& partition_config_file) {
-    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file);
+    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file,
+                                                                 context_->GetMaxStreamsPerDevice());
     auto status = partitioner->PartitionGraph(graph_viewer_, execution_providers, stream_nodes_, context_->GetExecutionOrder());
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
     plan_.node_stream_map_.resize(SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1);
@@ -2120,6 +2267,12 @@ class PlannerImpl {
     return !utils::HasTensorType(type_proto);
   }
 
+  static bool IsSequenceOfSameType(const onnxruntime::NodeArg& arg1, const onnxruntime::NodeArg& arg2) {
+    const auto* type_proto = arg1.TypeAsProto();
+    return type_proto != nullptr && type_proto->value_case() == ONNX_NAMESPACE::TypeProto::kSequenceType &&
+           arg1.Type() == arg2.Type();
+  }
+
 #if !defined(DISABLE_OPTIONAL_TYPE)
   static bool IsOptionalType(const onnxruntime::NodeArg& nodearg) {
     const auto* type_proto = nodearg.TypeAsProto();
@@ -2256,11 +2409,18 @@ DeviceBasedPartitioner stores config in json format:
 "streams" specifies streams of nodes;
 "devices" specifies the type of device of each stream.
 Pls check definition of OrtDevice for more detail on device type.
+
+Without a config, the nodes of a device are placed on one stream, or, for the non-CPU devices, on up to
+max_streams_per_device streams: a node continues the stream that ends with one of its producers, so that chains stay
+on a stream, and otherwise starts a new stream or joins the stream with the fewest nodes. Independent branches then
+run on different streams, synchronized by the notifications of the execution plan.
 */
 class DeviceBasedPartitioner : public IGraphPartitioner {
  public:
   DeviceBasedPartitioner(const logging::Logger& logger,
-                         const PathString& config_file) : IGraphPartitioner(logger, config_file) {
+                         const PathString& config_file,
+                         size_t max_streams_per_device) : IGraphPartitioner(logger, config_file),
+                                                          max_streams_per_device_(max_streams_per_device) {
     Initialize();
   }
 
@@ -2284,6 +2444,7 @@ class DeviceBasedPartitioner : public IGraphPartitioner {
   // device_types_[i] saves the device type for nodes in node_names_by_stream_[i]
   std::vector<OrtDevice::DeviceType> device_types_;
   std::vector<InlinedVector<std::string>> node_names_by_stream_;
+  size_t max_streams_per_device_;
   bool need_save_ = false;
 };
 
@@ -2302,7 +2463,9 @@ Status DeviceBasedPartitioner::PartitionGraph(const onnxruntime::GraphViewer& gr
 
   if (node_names_by_stream_.empty()) {  // input configure empty, do it from scratch
 
-    InlinedHashMap<OrtDevice::DeviceType, int> device_to_stream;
+    InlinedHashMap<OrtDevice::DeviceType, InlinedVector<size_t>> device_to_streams;
+    // the last node placed on each stream
+    InlinedVector<NodeIndex> stream_tails;
 
     for (auto node_index : p_graph_nodes) {
       // get device info of the node
@@ -2312,19 +2475,35 @@ Status DeviceBasedPartitioner::PartitionGraph(const onnxruntime::GraphViewer& gr
       auto* ep = execution_providers.Get(*node);
       auto device_type = ep->GetOrtDeviceByMemType(OrtMemType::OrtMemTypeDefault).Type();
 
-      // log the device
-      auto it = device_to_stream.find(device_type);
-      if (it == device_to_stream.end()) {
-        device_to_stream[device_type] = static_cast<int>(node_names_by_stream_.size());
+      // pick the stream of the node among the streams of its device
+      auto& streams = device_to_streams[device_type];
+      const size_t max_streams = device_type == OrtDevice::CPU ? 1 : std::max<size_t>(1, max_streams_per_device_);
+      auto stream_it = std::find_if(streams.begin(), streams.end(), [&](size_t stream) {
+        return std::any_of(node->InputEdgesBegin(), node->InputEdgesEnd(), [&](const Node::EdgeEnd& edge) {
+          return edge.GetNode().Index() == stream_tails[stream];
+        });
+      });
+      size_t stream_idx;
+      if (stream_it != streams.end()) {
+        stream_idx = *stream_it;
+      } else if (streams.size() < max_streams) {
+        stream_idx = node_names_by_stream_.size();
+        streams.push_back(stream_idx);
         node_names_by_stream_.push_back({});
         device_types_.push_back(device_type);
-        it = device_to_stream.find(device_type);
+        stream_tails.push_back(node_index);
+      } else {
+        stream_idx = *std::min_element(streams.begin(), streams.end(), [&](size_t lhs, size_t rhs) {
+          return node_names_by_stream_[lhs].size() < node_names_by_stream_[rhs].size();
+        });
       }
+      stream_tails[stream_idx] = node_index;
+
       // put the node into the belonging stream
       if (node_name.empty()) {
-        node_names_by_stream_[it->second].push_back(op_type + std::to_string(op_type_counter[op_type]++));
+        node_names_by_stream_[stream_idx].push_back(op_type + std::to_string(op_type_counter[op_type]++));
       } else {
-        node_names_by_stream_[it->second].push_back(node_name);
+        node_names_by_stream_[stream_idx].push_back(node_name);
       }
     }
   }
@@ -2417,7 +2596,8 @@ void DeviceBasedPartitioner::SaveConfig() const {
 }
 
 std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(const logging::Logger& logger,
-                                                                             const PathString& config_file) {
+                                                                             const PathString& config_file,
+                                                                             size_t max_streams_per_device) {
   // use device based partitioner by default
   IGraphPartitioner::GraphPartitioningStrategy partitioner_type =
       IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
@@ -2440,7 +2620,7 @@ std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(con
   }
   if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition) {
     LOGS(logger, INFO) << "Use DeviceBasedPartition as default";
-    return std::make_unique<DeviceBasedPartitioner>(logger, config_file);
+    return std::make_unique<DeviceBasedPartitioner>(logger, config_file, max_streams_per_device);
   }  // else if other partitioner types ...
   ORT_THROW("Failed to create partitioner");
 }
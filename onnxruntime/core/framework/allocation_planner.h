@@ -46,15 +46,27 @@ class ISequentialPlannerContext {
   virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::DEFAULT; }
 
   virtual bool GetEnableMemoryReuse() const { return true; }
+
+  // If it returns true, planner lets the CPU kernels of elementwise ops write their output into the buffer of an
+  // input of the same shape and type at its last use, even if the kernel does not declare MayInplace.
+  // see PlannerImpl::FindReusableInput
+  virtual bool GetEnableElementwiseInplace() const { return false; }
+
+  // The number of logic streams the nodes of a non-CPU device may be partitioned into, so that independent branches
+  // of the graph run concurrently. see DeviceBasedPartitioner
+  virtual size_t GetMaxStreamsPerDevice() const { return 1; }
   virtual ~ISequentialPlannerContext() = default;
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse)
+  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse,
+                           bool enable_elementwise_inplace = false, size_t max_streams_per_device = 1)
       : execution_mode_(execution_mode),
         exection_order_(execution_order),
-        enable_memory_reuse_(enable_memory_reuse) {
+        enable_memory_reuse_(enable_memory_reuse),
+        enable_elementwise_inplace_(enable_elementwise_inplace),
+        max_streams_per_device_(max_streams_per_device) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -67,10 +79,16 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool GetEnableMemoryReuse() const override { return enable_memory_reuse_; }
 
+  bool GetEnableElementwiseInplace() const override { return enable_elementwise_inplace_; }
+
+  size_t GetMaxStreamsPerDevice() const override { return max_streams_per_device_; }
+
  private:
   ExecutionMode execution_mode_ = ExecutionMode::ORT_SEQUENTIAL;
   ExecutionOrder exection_order_ = ExecutionOrder::DEFAULT;
   bool enable_memory_reuse_ = true;
+  bool enable_elementwise_inplace_ = false;
+  size_t max_streams_per_device_ = 1;
 };
 
 #ifdef ORT_ENABLE_STREAM
@@ -91,7 +109,8 @@ class IGraphPartitioner {
   // create the partition based on the partition type.
   // perform partition based on the user input when provided.
   static std::unique_ptr<IGraphPartitioner> CreateGraphPartitioner(const logging::Logger& logger,
-                                                                   const PathString& config_file);
+                                                                   const PathString& config_file,
+                                                                   size_t max_streams_per_device = 1);
   virtual Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
                                 const ExecutionProviders& execution_providers,
                                 std::vector<InlinedVector<NodeIndex>>& stream_nodes,
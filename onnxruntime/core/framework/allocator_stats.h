@@ -22,6 +22,12 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  // Fragmentation of arena based allocators.
+  int64_t bytes_free;               // Number of allocated bytes in free chunks.
+  int64_t largest_free_chunk_size;  // Size of the largest free chunk, i.e. the largest allocation that fits without
+                                    // extending the arena.
+  int64_t num_regions;              // Number of regions the arena has allocated.
+  int64_t num_idle_regions;         // Number of regions without any chunk in use, which a shrinkage would release.
 
   AllocatorStats() { Clear(); }
 
@@ -35,6 +41,10 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->bytes_free = 0;
+    this->largest_free_chunk_size = 0;
+    this->num_regions = 0;
+    this->num_idle_regions = 0;
   }
 
   std::string DebugString() const {
@@ -47,7 +57,11 @@ struct AllocatorStats {
        << "NumReserves:              " << this->num_reserves << "\n"
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
-       << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:             " << this->max_alloc_size << "\n"
+       << "BytesFree:                " << this->bytes_free << "\n"
+       << "LargestFreeChunkSize:     " << this->largest_free_chunk_size << "\n"
+       << "NumRegions:               " << this->num_regions << "\n"
+       << "NumIdleRegions:           " << this->num_idle_regions << "\n";
     return ss.str();
   }
 };
@@ -32,6 +32,9 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
     int64_t max_power_of_two_extend_bytes = info.arena_cfg.max_power_of_two_extend_bytes == -1
                                                 ? BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES
                                                 : info.arena_cfg.max_power_of_two_extend_bytes;
+    int thread_cache_max_chunk_size_bytes = info.arena_cfg.thread_cache_max_chunk_size_bytes == -1
+                                                ? BFCArena::DEFAULT_THREAD_CACHE_MAX_CHUNK_SIZE_BYTES
+                                                : info.arena_cfg.thread_cache_max_chunk_size_bytes;
     ArenaExtendStrategy arena_extend_str;
     switch (info.arena_cfg.arena_extend_strategy) {
       case static_cast<int>(ArenaExtendStrategy::kSameAsRequested):
@@ -68,7 +71,8 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                      initial_chunk_size_bytes,
                                      max_dead_bytes_per_chunk,
                                      initial_growth_chunk_size_bytes,
-                                     max_power_of_two_extend_bytes));
+                                     max_power_of_two_extend_bytes,
+                                     thread_cache_max_chunk_size_bytes));
     }
   } else {
     return device_allocator;
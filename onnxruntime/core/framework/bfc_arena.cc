@@ -3,6 +3,8 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include <algorithm>
+#include <cstdint>
 #include <type_traits>
 
 namespace onnxruntime {
@@ -12,7 +14,8 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int thread_cache_max_chunk_size_bytes)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,12 +28,14 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      thread_cache_max_chunk_size_bytes_(thread_cache_max_chunk_size_bytes) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
+                     << " thread_cache_max_chunk_size_bytes: " << thread_cache_max_chunk_size_bytes_
                      << " memory limit: " << total_memory
                      << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
 
@@ -75,6 +80,18 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  ORT_ENFORCE(thread_cache_max_chunk_size_bytes_ >= 0,
+              "thread_cache_max_chunk_size_bytes must be non-negative but is ", thread_cache_max_chunk_size_bytes_);
+  if (thread_cache_max_chunk_size_bytes_ > 0) {
+    const size_t num_size_classes = RoundedBytes(static_cast<size_t>(thread_cache_max_chunk_size_bytes_)) /
+                                    kMinAllocationSize;
+    thread_caches_ = std::make_unique<ThreadCache[]>(kNumThreadCaches);
+    thread_cache_chunks_ = std::make_unique<ThreadCacheChunks[]>(kNumThreadCaches);
+    for (size_t i = 0; i < kNumThreadCaches; ++i) {
+      thread_caches_[i].free_chunks.resize(num_size_classes);
+    }
+  }
 }
 
 BFCArena::~BFCArena() {
@@ -269,9 +286,101 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_caches_ && UseThreadCache(size)) {
+    return AllocateFromThreadCache(size);
+  }
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
+BFCArena::ThreadCache& BFCArena::CurrentThreadCache() {
+  // threads are assigned to caches round robin, as the hash of a thread id does not spread well over a few buckets
+  static std::atomic<size_t> next_thread_index{0};
+  thread_local const size_t thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+  return thread_caches_[thread_index % kNumThreadCaches];
+}
+
+BFCArena::ThreadCacheChunks& BFCArena::ThreadCacheChunksForPtr(const void* ptr) {
+  return thread_cache_chunks_[(reinterpret_cast<std::uintptr_t>(ptr) >> kMinAllocationBits) % kNumThreadCaches];
+}
+
+void* BFCArena::AllocateFromThreadCache(size_t num_bytes) {
+  const size_t size_class = RoundedBytes(num_bytes) / kMinAllocationSize - 1;
+  void* ptr = nullptr;
+  {
+    auto& cache = CurrentThreadCache();
+    std::lock_guard<OrtMutex> lock(cache.mutex);
+    auto& free_chunks = cache.free_chunks[size_class];
+    if (!free_chunks.empty()) {
+      ptr = free_chunks.back();
+      free_chunks.pop_back();
+    }
+  }
+
+  if (ptr != nullptr) {
+    num_thread_cache_allocs_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    ptr = AllocateRawInternal(num_bytes, false, nullptr, false, nullptr);
+  }
+
+  auto& chunks = ThreadCacheChunksForPtr(ptr);
+  std::lock_guard<OrtMutex> lock(chunks.mutex);
+  chunks.size_classes[ptr] = size_class;
+  return ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* p) {
+  size_t size_class = 0;
+  {
+    auto& chunks = ThreadCacheChunksForPtr(p);
+    std::lock_guard<OrtMutex> lock(chunks.mutex);
+    auto it = chunks.size_classes.find(p);
+    if (it == chunks.size_classes.end()) {
+      return false;
+    }
+    size_class = it->second;
+    chunks.size_classes.erase(it);
+  }
+
+  std::vector<void*> returned_chunks;
+  {
+    auto& cache = CurrentThreadCache();
+    std::lock_guard<OrtMutex> lock(cache.mutex);
+    auto& free_chunks = cache.free_chunks[size_class];
+    free_chunks.push_back(p);
+    if (free_chunks.size() >= kMaxCachedChunksPerSizeClass) {
+      // return the least recently freed half in one batch, so that the arena lock is taken once per batch
+      const auto batch_end = free_chunks.begin() + kMaxCachedChunksPerSizeClass / 2;
+      returned_chunks.assign(free_chunks.begin(), batch_end);
+      free_chunks.erase(free_chunks.begin(), batch_end);
+    }
+  }
+
+  if (!returned_chunks.empty()) {
+    ReturnChunksToArena(returned_chunks);
+  }
+  return true;
+}
+
+void BFCArena::FlushThreadCaches() {
+  std::vector<void*> returned_chunks;
+  for (size_t i = 0; i < kNumThreadCaches; ++i) {
+    auto& cache = thread_caches_[i];
+    std::lock_guard<OrtMutex> lock(cache.mutex);
+    for (auto& free_chunks : cache.free_chunks) {
+      returned_chunks.insert(returned_chunks.end(), free_chunks.begin(), free_chunks.end());
+      free_chunks.clear();
+    }
+  }
+  ReturnChunksToArena(returned_chunks);
+}
+
+void BFCArena::ReturnChunksToArena(const std::vector<void*>& ptrs) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* ptr : ptrs) {
+    DeallocateRawInternal(ptr);
+  }
+}
+
 void* BFCArena::Reserve(size_t size) {
   if (size == 0)
     return nullptr;
@@ -280,7 +389,8 @@ void* BFCArena::Reserve(size_t size) {
 
   LOGS_DEFAULT(INFO) << "Reserving memory in BFCArena for " << device_allocator_->Info().name << " size: " << size;
 
-  void* ptr = device_allocator_->Alloc(size);
+  // let the device allocator place static memory, e.g. weights, differently from the memory of the arena
+  void* ptr = device_allocator_->Reserve(size);
   ORT_ENFORCE(reserved_chunks_.find(ptr) == reserved_chunks_.end());
   reserved_chunks_.insert(std::pair<void*, size_t>(ptr, size));
   stats_.bytes_in_use += size;
@@ -379,6 +489,48 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+  stats->num_allocs += num_thread_cache_allocs_.load(std::memory_order_relaxed);
+
+  // reserved chunks are counted both in total_allocated_bytes and bytes_in_use
+  stats->bytes_free = stats_.total_allocated_bytes - stats_.bytes_in_use;
+  stats->largest_free_chunk_size = 0;
+  for (BinNum b = kNumBins - 1; b >= 0; b--) {
+    const auto& free_chunks = BinFromIndex(b)->free_chunks;
+    if (!free_chunks.empty()) {
+      // the free chunks of a bin are sorted by size
+      stats->largest_free_chunk_size = static_cast<int64_t>(ChunkFromHandle(*free_chunks.rbegin())->size);
+      break;
+    }
+  }
+
+  const auto& regions = region_manager_.regions();
+  stats->num_regions = static_cast<int64_t>(regions.size());
+  stats->num_idle_regions = std::count_if(regions.begin(), regions.end(), [this](const AllocationRegion& region) {
+    return !IsRegionInUse(region.ptr());
+  });
+}
+
+std::vector<int64_t> BFCArena::GetFreeBytesByBin() {
+  std::lock_guard<OrtMutex> lock(lock_);
+  std::vector<int64_t> free_bytes(kNumBins, 0);
+  for (BinNum b = 0; b < kNumBins; b++) {
+    for (const auto h : BinFromIndex(b)->free_chunks) {
+      free_bytes[b] += static_cast<int64_t>(ChunkFromHandle(h)->size);
+    }
+  }
+  return free_bytes;
+}
+
+bool BFCArena::IsRegionInUse(const void* region_ptr) {
+  ChunkHandle h = region_manager_.get_handle(region_ptr);
+  while (h != kInvalidChunkHandle) {
+    const Chunk* c = ChunkFromHandle(h);
+    if (c->in_use()) {
+      return true;
+    }
+    h = c->next;
+  }
+  return false;
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -496,6 +648,9 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (thread_caches_ && FreeToThreadCache(p)) {
+    return;
+  }
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -509,7 +664,43 @@ void BFCArena::Free(void* p) {
 }
 
 Status BFCArena::Shrink() {
+  if (thread_caches_) {
+    FlushThreadCaches();
+  }
   std::lock_guard<OrtMutex> lock(lock_);
+  ShrinkInternal();
+  return Status::OK();
+}
+
+Status BFCArena::Compact(double min_free_ratio, bool& compacted) {
+  compacted = false;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    const auto bytes_free = stats_.total_allocated_bytes - stats_.bytes_in_use;
+    if (stats_.total_allocated_bytes == 0 ||
+        static_cast<double>(bytes_free) < min_free_ratio * static_cast<double>(stats_.total_allocated_bytes)) {
+      return Status::OK();
+    }
+  }
+
+  // cached chunks would keep otherwise idle regions in use
+  if (thread_caches_) {
+    FlushThreadCaches();
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  const auto& regions = region_manager_.regions();
+  const bool has_idle_region = std::any_of(regions.begin(), regions.end(), [this](const AllocationRegion& region) {
+    return (consider_first_allocation_region_for_shrinkage_ || region.id() != 0) && !IsRegionInUse(region.ptr());
+  });
+  if (has_idle_region) {
+    ShrinkInternal();
+    compacted = true;
+  }
+  return Status::OK();
+}
+
+void BFCArena::ShrinkInternal() {
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
   std::vector<size_t> region_sizes;
@@ -525,21 +716,8 @@ Status BFCArena::Shrink() {
 
   size_t i = 0;
   for (void* region_ptr : region_ptrs) {
-    bool deallocate_region = true;
-    ChunkHandle region_begin_chunk = region_manager_.get_handle(region_ptr);
-    ChunkHandle h = region_begin_chunk;
-    while (h != kInvalidChunkHandle) {
-      const Chunk* c = ChunkFromHandle(h);
-      if (c->in_use()) {
-        // at-least one used chunk found in the allocation region -
-        // so we cannot deallocate it
-        deallocate_region = false;
-        break;
-      }
-      h = c->next;
-    }
-
-    if (deallocate_region) {
+    // if at-least one used chunk is found in the allocation region, we cannot deallocate it
+    if (!IsRegionInUse(region_ptr)) {
       auto shrink_size = region_sizes[i];
       stats_.num_arena_shrinkages += 1;
       stats_.total_allocated_bytes -= shrink_size;
@@ -548,8 +726,8 @@ Status BFCArena::Shrink() {
                             << shrink_size << " bytes. "
                             << " The total allocated bytes is now " << stats_.total_allocated_bytes;
 
-      h = region_begin_chunk;
-      ChunkHandle temp = region_begin_chunk;
+      ChunkHandle h = region_manager_.get_handle(region_ptr);
+      ChunkHandle temp = h;
       while (h != kInvalidChunkHandle) {
         const Chunk* c = ChunkFromHandle(h);
         temp = c->next;
@@ -569,8 +747,6 @@ Status BFCArena::Shrink() {
   // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
   // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
   curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
-
-  return Status::OK();
 }
 
 void BFCArena::DeallocateRawInternal(void* ptr) {
@@ -16,13 +16,16 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
 #include "core/common/common.h"
+#include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/severity.h"
 #include "core/common/safeint.h"
@@ -61,6 +64,7 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int DEFAULT_THREAD_CACHE_MAX_CHUNK_SIZE_BYTES = 0;  // thread caches disabled
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +77,8 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int thread_cache_max_chunk_size_bytes = DEFAULT_THREAD_CACHE_MAX_CHUNK_SIZE_BYTES);
 
   ~BFCArena() override;
 
@@ -86,6 +91,7 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks held by the thread caches are returned to the arena first.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -93,8 +99,19 @@ class BFCArena : public IAllocator {
   // and the allocation request.
   Status Shrink();
 
+  // Shrinks the arena if at least min_free_ratio of its allocated bytes are in free chunks and at least one region
+  // is idle. Unlike Shrink(), it does not reset the growth of the arena when there is nothing to release, so that it
+  // can be called between runs without causing extensions in steady state.
+  // compacted is set to whether the arena was shrunk.
+  Status Compact(double min_free_ratio, bool& compacted);
+
+  // Bytes in free chunks per bin, where bin i holds the chunks of at least 256 << i bytes, and less than twice
+  // that except for the last bin.
+  std::vector<int64_t> GetFreeBytesByBin();
+
   void* Reserve(size_t size) override;
 
+  // Includes the fragmentation stats, which walks the chunks of all regions to count the idle ones.
   void GetStats(AllocatorStats* stats) override;
 
   size_t RequestedSize(const void* ptr);
@@ -123,6 +140,52 @@ class BFCArena : public IAllocator {
  private:
   void DeallocateRawInternal(void* ptr);
 
+  // Thread caches of small chunks.
+  //
+  // If thread_cache_max_chunk_size_bytes is not 0, allocations of at most that size are served from a cache of
+  // free chunks of the exact rounded size, picked by the allocating thread, and only fall back to the arena (and
+  // its lock) when that cache is empty. Freed small chunks go to the cache of the freeing thread instead of the
+  // bins, and are returned to the arena in batches when a cache holds too many chunks of one size.
+  // The chunks held by the caches stay in use from the point of view of the arena, so they are included in
+  // bytes_in_use, and they are not coalesced until they are returned.
+  //
+  // Threads are assigned to the caches round robin rather than the caches being thread_local, so that neither the
+  // exit of a thread nor the destruction of the arena needs to find the other. Each cache has its own mutex, which is
+  // uncontended unless more threads than caches allocate concurrently.
+  static constexpr size_t kNumThreadCaches = 16;
+  static constexpr size_t kMaxCachedChunksPerSizeClass = 32;
+
+  struct ThreadCache {
+    OrtMutex mutex;
+    // Free chunks by size class, where the size class of a chunk is RoundedBytes(size) / kMinAllocationSize - 1.
+    std::vector<std::vector<void*>> free_chunks;
+  };
+
+  // Size classes of the chunks handed out by the thread caches that are still in use, sharded by address.
+  struct ThreadCacheChunks {
+    OrtMutex mutex;
+    InlinedHashMap<void*, size_t> size_classes;
+  };
+
+  bool UseThreadCache(size_t num_bytes) const {
+    return num_bytes != 0 && num_bytes <= static_cast<size_t>(thread_cache_max_chunk_size_bytes_);
+  }
+
+  ThreadCache& CurrentThreadCache();
+  ThreadCacheChunks& ThreadCacheChunksForPtr(const void* ptr);
+  void* AllocateFromThreadCache(size_t num_bytes);
+  // Returns false if p was not allocated from a thread cache.
+  bool FreeToThreadCache(void* p);
+  // Returns the chunks held by all thread caches to the arena.
+  void FlushThreadCaches();
+
+  // Whether any chunk of the region starting at region_ptr is in use.
+  bool IsRegionInUse(const void* region_ptr);
+
+  // Frees the idle regions that can be shrunk. lock_ must be held.
+  void ShrinkInternal();
+  void ReturnChunksToArena(const std::vector<void*>& ptrs);
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -508,6 +571,13 @@ class BFCArena : public IAllocator {
   const int max_dead_bytes_per_chunk_;
   const int initial_growth_chunk_size_bytes_;
   const int64_t max_power_of_two_extend_bytes_;
+  const int thread_cache_max_chunk_size_bytes_;
+
+  // Empty if the thread caches are disabled.
+  std::unique_ptr<ThreadCache[]> thread_caches_;
+  std::unique_ptr<ThreadCacheChunks[]> thread_cache_chunks_;
+  // Number of allocations served by the thread caches without going to the arena, added to num_allocs.
+  std::atomic<int64_t> num_thread_cache_allocs_{0};
 
   // This flag is only relevant if Shrink() is invoked.
   // This is a boolean flag that controls whether the first allocation region
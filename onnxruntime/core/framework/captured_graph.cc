@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/captured_graph.h"
+
+#include <algorithm>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/execution_frame.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/framework/session_state.h"
+#include "core/graph/constants.h"
+#include "core/providers/cpu/tensor/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsCpuTensor(const OrtValue& value) {
+  return value.IsTensor() && value.Get<Tensor>().Location().device.Type() == OrtDevice::CPU;
+}
+
+bool IsTensorType(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type();
+}
+
+}  // namespace
+
+Status CapturedGraph::CanCapture(const SessionState& session_state) {
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  for (const auto& node : graph_viewer.Nodes()) {
+    ORT_RETURN_IF_NOT(node.GetExecutionProviderType() == kCpuExecutionProvider,
+                      "Node ", node.Name(), " is not assigned to the CPU execution provider");
+    ORT_RETURN_IF(node.ContainsSubgraph(), "Node ", node.Name(), " is a control flow node");
+    for (const auto* output : node.OutputDefs()) {
+      ORT_RETURN_IF(output->Exists() && !IsTensorType(*output), "Output ", output->Name(), " is not a tensor");
+    }
+  }
+  for (const auto* input : graph_viewer.GetInputs()) {
+    ORT_RETURN_IF_NOT(IsTensorType(*input), "Graph input ", input->Name(), " is not a tensor");
+  }
+
+  const auto* plan = session_state.GetExecutionPlan();
+  ORT_RETURN_IF(plan == nullptr, "The session has no execution plan");
+  ORT_RETURN_IF(plan->NumberOfValidStreams() > 1, "The execution plan has more than one stream");
+  return Status::OK();
+}
+
+CapturedGraph::CapturedGraph(const SessionState& session_state,
+                             gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                             gsl::span<const int> fetch_mlvalue_idxs)
+    : session_state_(session_state),
+      feed_mlvalue_idxs_(feed_mlvalue_idxs.begin(), feed_mlvalue_idxs.end()),
+      fetch_mlvalue_idxs_(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end()) {
+  auto allocator = session_state.GetAllocator(OrtDevice());
+  feeds_.resize(feeds.size());
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    const auto& feed = feeds[i].Get<Tensor>();
+    Tensor::InitOrtValue(feed.DataType(), feed.Shape(), allocator, feeds_[i]);
+  }
+
+  for (const auto& stream : session_state.GetExecutionPlan()->execution_plan) {
+    for (const auto& step : stream->steps_) {
+      kernels_.push_back(session_state.GetKernel(step->GetNodeIndex()));
+    }
+  }
+
+  frame_ = std::make_unique<ExecutionFrame>(feed_mlvalue_idxs_, feeds_, fetch_mlvalue_idxs_,
+                                            gsl::span<const OrtValue>(),
+                                            std::unordered_map<size_t, IExecutor::CustomAllocator>{},
+#ifdef ORT_ENABLE_STREAM
+                                            nullptr,
+#endif
+                                            session_state);
+}
+
+CapturedGraph::~CapturedGraph() = default;
+
+Status CapturedGraph::Create(const SessionState& session_state,
+                             gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                             gsl::span<const int> fetch_mlvalue_idxs,
+                             std::unique_ptr<CapturedGraph>& captured_graph) {
+  ORT_RETURN_IF_ERROR(CanCapture(session_state));
+  for (const auto& feed : feeds) {
+    ORT_RETURN_IF_NOT(IsCpuTensor(feed), "Only CPU tensor inputs can be captured");
+  }
+  captured_graph.reset(new CapturedGraph(session_state, feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs));
+  return Status::OK();
+}
+
+bool CapturedGraph::Matches(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                            gsl::span<const int> fetch_mlvalue_idxs) const {
+  if (!std::equal(feed_mlvalue_idxs.begin(), feed_mlvalue_idxs.end(),
+                  feed_mlvalue_idxs_.begin(), feed_mlvalue_idxs_.end()) ||
+      !std::equal(fetch_mlvalue_idxs.begin(), fetch_mlvalue_idxs.end(),
+                  fetch_mlvalue_idxs_.begin(), fetch_mlvalue_idxs_.end())) {
+    return false;
+  }
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!IsCpuTensor(feeds[i])) {
+      return false;
+    }
+    const auto& feed = feeds[i].Get<Tensor>();
+    const auto& captured_feed = feeds_[i].Get<Tensor>();
+    if (feed.DataType() != captured_feed.DataType() || feed.Shape() != captured_feed.Shape()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status CapturedGraph::Replay(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                             const bool& terminate_flag, const logging::Logger& logger) {
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    CopyCpuTensor(&feeds[i].Get<Tensor>(), feeds_[i].GetMutable<Tensor>());
+  }
+
+  for (const auto* kernel : kernels_) {
+    ORT_RETURN_IF(terminate_flag, "Exiting due to terminate flag being set to true.");
+    OpKernelContextInternal kernel_ctx(session_state_, *frame_, *kernel, logger, terminate_flag, nullptr);
+    Status status;
+    ORT_TRY {
+      status = kernel->Compute(&kernel_ctx);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+    if (!status.IsOK()) {
+      const auto& node = kernel->Node();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Non-zero status code returned while replaying ", node.OpType(),
+                             " node. Name:'", node.Name(), "' Status Message: ", status.ErrorMessage());
+    }
+  }
+
+  // The values of the frame are overwritten by the next replay, so the fetches get their own copy.
+  std::vector<OrtValue> outputs;
+  ORT_RETURN_IF_ERROR(frame_->GetOutputs(outputs));
+  if (fetches.empty()) {
+    fetches.resize(outputs.size());
+  }
+  ORT_RETURN_IF_NOT(fetches.size() == outputs.size(), "Expected ", outputs.size(), " fetches but got ",
+                    fetches.size());
+  auto allocator = session_state_.GetAllocator(OrtDevice());
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    const auto& output = outputs[i].Get<Tensor>();
+    OrtValue& fetch = fetches[i];
+    if (!fetch.IsAllocated()) {
+      Tensor::InitOrtValue(output.DataType(), output.Shape(), allocator, fetch);
+    }
+    ORT_RETURN_IF_NOT(IsCpuTensor(fetch), "Preallocated fetch ", i, " is not a CPU tensor");
+    auto& fetch_tensor = *fetch.GetMutable<Tensor>();
+    ORT_RETURN_IF_NOT(fetch_tensor.DataType() == output.DataType() && fetch_tensor.Shape() == output.Shape(),
+                      "Preallocated fetch ", i, " has shape ", fetch_tensor.Shape(), " but the output has shape ",
+                      output.Shape());
+    CopyCpuTensor(&output, &fetch_tensor);
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+
+class ExecutionFrame;
+class OpKernel;
+class SessionState;
+
+namespace logging {
+class Logger;
+}
+
+/**
+ * Captured execution of a CPU-only graph with static input shapes, which can be replayed without re-walking the
+ * execution plan.
+ *
+ * The captured graph owns an execution frame that lives across runs. The feeds are copied into buffers owned by the
+ * frame, and the values of the graph are never released, so every kernel sees the same buffers in every run.
+ * A replay copies the feeds in, calls the kernels in the order of the execution plan, and copies the fetches out.
+ * Intermediate values allocated by the first replay are reused by the following ones, so no allocation planning is
+ * done after the first replay. A replay fails if a kernel produces an output with a different shape than in the
+ * first replay.
+ *
+ * The captured graph is not thread safe, the caller must ensure that a single run uses it at a time.
+ */
+class CapturedGraph {
+ public:
+  // Whether the graph of session_state can be captured: all nodes are assigned to the CPU EP, there are no control
+  // flow nodes, all values are tensors, and the execution plan has a single stream.
+  static Status CanCapture(const SessionState& session_state);
+
+  // Capture the graph for the given feeds and fetches. The feeds must be CPU tensors.
+  // session_state must outlive the captured graph.
+  static Status Create(const SessionState& session_state,
+                       gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                       gsl::span<const int> fetch_mlvalue_idxs,
+                       std::unique_ptr<CapturedGraph>& captured_graph);
+
+  ~CapturedGraph();
+
+  // Whether a run with these feeds and fetches can be replayed by this captured graph.
+  bool Matches(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+               gsl::span<const int> fetch_mlvalue_idxs) const;
+
+  // Replay the graph with feeds that Matches() accepted. If fetches is not empty, the outputs are copied into it,
+  // otherwise new tensors are allocated for them.
+  Status Replay(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                const bool& terminate_flag, const logging::Logger& logger);
+
+ private:
+  CapturedGraph(const SessionState& session_state,
+                gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                gsl::span<const int> fetch_mlvalue_idxs);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CapturedGraph);
+
+  const SessionState& session_state_;
+  InlinedVector<int> feed_mlvalue_idxs_;
+  InlinedVector<int> fetch_mlvalue_idxs_;
+  // The buffers the feeds are copied into.
+  std::vector<OrtValue> feeds_;
+  // The kernels in execution order.
+  InlinedVector<const OpKernel*> kernels_;
+  std::unique_ptr<ExecutionFrame> frame_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/framework/ep_context_utils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "core/graph/constants.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+namespace ep_context_utils {
+
+namespace {
+
+std::string ToLower(std::string_view str) {
+  std::string lower(str);
+  std::transform(lower.begin(), lower.end(), lower.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return lower;
+}
+
+const ONNX_NAMESPACE::AttributeProto* GetAttribute(const Node& node, const char* name) {
+  const auto& attributes = node.GetAttributes();
+  auto entry = attributes.find(name);
+  return entry != attributes.end() ? &entry->second : nullptr;
+}
+
+std::vector<NodeArg*> GetOrCreateNodeArgs(Graph& graph, const ConstPointerContainer<std::vector<NodeArg*>>& defs) {
+  std::vector<NodeArg*> node_args;
+  node_args.reserve(defs.size());
+  for (const NodeArg* def : defs) {
+    node_args.push_back(&graph.GetOrCreateNodeArg(def->Name(), def->TypeAsProto()));
+  }
+  return node_args;
+}
+
+}  // namespace
+
+bool IsEpContextNode(const Node& node, std::string_view ep_type) {
+  if (node.OpType() != kEpContextOp || node.Domain() != kMSDomain) {
+    return false;
+  }
+
+  const auto* source = GetAttribute(node, kSourceAttr);
+  if (source == nullptr) {
+    return false;
+  }
+
+  constexpr std::string_view kSuffix = "executionprovider";
+  const std::string lower_source = ToLower(source->s());
+  std::string lower_ep_type = ToLower(ep_type);
+  if (lower_source == lower_ep_type) {
+    return true;
+  }
+
+  if (lower_ep_type.size() > kSuffix.size() &&
+      lower_ep_type.compare(lower_ep_type.size() - kSuffix.size(), kSuffix.size(), kSuffix) == 0) {
+    lower_ep_type.resize(lower_ep_type.size() - kSuffix.size());
+  }
+  return lower_source == lower_ep_type;
+}
+
+bool GraphHasEpContextNode(const GraphViewer& graph_viewer, std::string_view ep_type) {
+  for (const auto& node : graph_viewer.Nodes()) {
+    if (IsEpContextNode(node, ep_type)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Status AddEpContextNode(Graph& graph, const Node& fused_node, std::string_view ep_type,
+                        bool main_context, std::string_view artifact, bool embed_mode,
+                        const PathString& ep_context_model_path, const std::string& ep_sdk_version,
+                        Node*& ep_context_node) {
+  const std::string& name = fused_node.Name();
+  Node& node = graph.AddNode(name, kEpContextOp, "EP context of partition " + name,
+                             GetOrCreateNodeArgs(graph, fused_node.InputDefs()),
+                             GetOrCreateNodeArgs(graph, fused_node.OutputDefs()),
+                             nullptr, kMSDomain);
+
+  node.AddAttribute(kMainContextAttr, static_cast<int64_t>(main_context ? 1 : 0));
+  node.AddAttribute(kEmbedModeAttr, static_cast<int64_t>(embed_mode ? 1 : 0));
+  if (main_context) {
+    if (embed_mode) {
+      node.AddAttribute(kEpCacheContextAttr, std::string(artifact));
+    } else {
+      ORT_RETURN_IF(ep_context_model_path.empty(), "The EP context model path is required if embed_mode is 0.");
+      const std::filesystem::path artifact_path = ep_context_model_path + ToPathString("_" + name + ".bin");
+      std::ofstream file(artifact_path, std::ofstream::out | std::ofstream::binary);
+      ORT_RETURN_IF(!file, "Failed to create the EP context file ", artifact_path.string());
+      file.write(artifact.data(), static_cast<std::streamsize>(artifact.size()));
+      ORT_RETURN_IF(!file, "Failed to write the EP context file ", artifact_path.string());
+      node.AddAttribute(kEpCacheContextAttr, artifact_path.filename().string());
+    }
+  }
+  if (!ep_sdk_version.empty()) {
+    node.AddAttribute(kEpSdkVersionAttr, ep_sdk_version);
+  }
+  node.AddAttribute(kPartitionNameAttr, name);
+  node.AddAttribute(kSourceAttr, std::string(ep_type));
+
+  ep_context_node = &node;
+  return Status::OK();
+}
+
+Status GetEpContextArtifact(const Node& ep_context_node, const PathString& ep_context_model_path,
+                            std::string& file_buffer, std::string_view& artifact) {
+  const auto* cache_context = GetAttribute(ep_context_node, kEpCacheContextAttr);
+  if (cache_context == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The EPContext node ", ep_context_node.Name(),
+                           " has no ep_cache_context attribute.");
+  }
+
+  const auto* embed_mode = GetAttribute(ep_context_node, kEmbedModeAttr);
+  if (embed_mode == nullptr || embed_mode->i() == 1) {
+    artifact = cache_context->s();
+    return Status::OK();
+  }
+
+  const std::string& file_name = cache_context->s();
+  if (file_name.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ep_cache_context should not be empty.");
+  }
+
+  const std::filesystem::path relative_path = std::filesystem::path(ToPathString(file_name)).lexically_normal();
+  if (relative_path.has_root_path()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH,
+                           "External mode should set ep_cache_context field with a relative path, but it is an "
+                           "absolute path: ",
+                           file_name);
+  }
+  for (const auto& part : relative_path) {
+    if (part == "..") {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH,
+                             "The file path in ep_cache_context field has '..'. It's not allowed to point outside "
+                             "the directory.");
+    }
+  }
+
+  const std::filesystem::path file_path = std::filesystem::path(ep_context_model_path).parent_path() / relative_path;
+  if (!std::filesystem::is_regular_file(file_path)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH,
+                           "The file path in ep_cache_context does not exist or is not accessible.");
+  }
+
+  std::ifstream file(file_path, std::ifstream::in | std::ifstream::binary);
+  const auto file_size = static_cast<size_t>(std::filesystem::file_size(file_path));
+  if (!file || file_size == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "Failed to read the EP context file ", file_name);
+  }
+
+  file_buffer.resize(file_size);
+  if (!file.read(file_buffer.data(), static_cast<std::streamsize>(file_size))) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "Failed to read the EP context file ", file_name);
+  }
+
+  artifact = file_buffer;
+  return Status::OK();
+}
+
+}  // namespace ep_context_utils
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
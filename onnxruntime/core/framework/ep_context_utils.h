@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <string>
+#include <string_view>
+
+#include "core/common/path_string.h"
+#include "core/common/status.h"
+
+namespace onnxruntime {
+class Graph;
+class GraphViewer;
+class Node;
+
+/**
+ * Helpers for the EPContext nodes of compiling execution providers.
+ *
+ * An EP that compiles its partitions can store the compiled artifact of each partition in an EPContext node (see the
+ * com.microsoft EPContext contrib op). It returns the nodes from IExecutionProvider::GetEpContextNodes, and the graph
+ * partitioner writes them to the EP context model in place of the fused nodes when ep.context_enable is set. When a
+ * session is created from the EP context model, the EP claims its EPContext nodes in GetCapability and loads the
+ * artifacts in Compile instead of compiling the partitions again.
+ */
+namespace ep_context_utils {
+
+constexpr const char* kEpContextOp = "EPContext";
+constexpr const char* kMainContextAttr = "main_context";
+constexpr const char* kEmbedModeAttr = "embed_mode";
+constexpr const char* kEpCacheContextAttr = "ep_cache_context";
+constexpr const char* kEpSdkVersionAttr = "ep_sdk_version";
+constexpr const char* kPartitionNameAttr = "partition_name";
+constexpr const char* kSourceAttr = "source";
+
+/**
+ * Returns true if `node` is an EPContext node created by the EP `ep_type`.
+ * The source attribute matches `ep_type` case insensitively, with or without the "ExecutionProvider" suffix,
+ * e.g. "QNNExecutionProvider", "QNN" and "qnn" all match kQnnExecutionProvider.
+ */
+bool IsEpContextNode(const Node& node, std::string_view ep_type);
+
+/**
+ * Returns true if `graph_viewer` has an EPContext node created by the EP `ep_type`.
+ */
+bool GraphHasEpContextNode(const GraphViewer& graph_viewer, std::string_view ep_type);
+
+/**
+ * Adds an EPContext node for `fused_node` to `graph`, with the same name, inputs and outputs as `fused_node`.
+ *
+ * If `main_context` is true the node holds `artifact`: in its ep_cache_context attribute if `embed_mode` is true,
+ * otherwise in a file next to `ep_context_model_path` named after it and the node, whose name is the attribute.
+ * Nodes with `main_context` false refer to the artifact of the main context node of the EP, e.g. when all the
+ * partitions are compiled into a single artifact.
+ */
+Status AddEpContextNode(Graph& graph, const Node& fused_node, std::string_view ep_type,
+                        bool main_context, std::string_view artifact, bool embed_mode,
+                        const PathString& ep_context_model_path, const std::string& ep_sdk_version,
+                        Node*& ep_context_node);
+
+/**
+ * Gets the artifact of the main context EPContext node `ep_context_node`.
+ *
+ * In embed mode `artifact` refers to the ep_cache_context attribute of the node. Otherwise the artifact is read from
+ * the file named by the attribute into `file_buffer`, which `artifact` refers to. The file name must be relative to
+ * the directory of `ep_context_model_path` and must not point outside of it.
+ * Returns INVALID_GRAPH if the artifact cannot be found.
+ */
+Status GetEpContextArtifact(const Node& ep_context_node, const PathString& ep_context_model_path,
+                            std::string& file_buffer, std::string_view& artifact);
+
+}  // namespace ep_context_utils
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
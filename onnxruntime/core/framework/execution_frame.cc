@@ -13,6 +13,7 @@
 #include "core/framework/mldata_type_utils.h"
 #include "core/framework/sparse_utils.h"
 #include "core/framework/node_index_info.h"
+#include "core/framework/node_overhead_stats.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
 #include "core/framework/TensorSeq.h"
@@ -184,6 +185,7 @@ Status IExecutionFrame::GetOrCreateNodeOutputMLValue(const int output_index, int
       if (shape != nullptr && IsOutput(ort_value_idx)) {
         VerifyOutputSizes(output_index, node, *shape);
       }
+      NodeOverheadStats::AllocationTimer allocation_timer;
       status = CreateNodeOutputMLValueImpl(*p_ort_value, ort_value_idx, shape);
     }
   }
@@ -358,6 +360,7 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 #endif
       session_state_(session_state),
       mem_patterns_(nullptr) {
+  all_values_ = session_state.AcquireFrameValues();
   Init(
       feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(),
 #if !defined(DISABLE_SPARSE_TENSORS)
@@ -410,6 +413,7 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
       // if no existing patterns, generate one in this execution frame
       if (!mem_patterns_) {
         planner_.emplace(*session_state.GetExecutionPlan());
+        trace_mem_pattern_events_ = session_state.NeedsSymbolicMemoryPattern();
       } else {
         // pre-allocate the big chunk requested in memory pattern.
         // all the internal kernel's input/output tensors will be allocated on these buffer.
@@ -492,7 +496,11 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  // release the values and keep their storage for the frame of a later run
+  all_values_.clear();
+  session_state_.RecycleFrameValues(std::move(all_values_));
+}
 
 Status ExecutionFrame::CopyTensor(const Tensor& src, Tensor& dest) const {
   return session_state_.GetDataTransferMgr().CopyTensor(src, dest);
@@ -595,6 +603,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
           current_stream->GetDevice().Type(), current_stream->GetDevice().Type());
       void* p_data = stream_aware_alloc->AllocOnStream(buffer_size, current_stream, wait_handle);
       Tensor::InitOrtValue(element_type, shape, p_data, std::move(alloc), ort_value);
+    } else if (alloc->IsStreamOrdered()) {
+      size_t buffer_size = Tensor::CalculateTensorStorageSize(element_type, shape);
+      void* p_data = alloc->AllocStreamOrdered(buffer_size, current_stream);
+      Tensor::InitOrtValue(element_type, shape, p_data, std::move(alloc), ort_value);
     } else {
       Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
     }
@@ -769,6 +781,26 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
       case AllocKind::kReuse: {
         int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
 
+        if (per_alloc_plan.is_slice_of_reused_buffer) {
+          // the value is a part of the output of a Concat, which has a static shape of its own
+          std::string reused_name;
+          ORT_RETURN_IF_ERROR(session_state_.GetOrtValueNameIdxMap().GetName(reuse_mlvalue_index, reused_name));
+          const auto* reused_shape_proto = session_state_.GetGraphViewer().GetNodeArg(reused_name)->Shape();
+          ORT_RETURN_IF_NOT(reused_shape_proto != nullptr, "Missing static shape of ", reused_name);
+          const TensorShape reused_shape = utils::GetTensorShapeFromTensorShapeProto(*reused_shape_proto);
+          ORT_RETURN_IF_ERROR(AllocateReusedOrtValueIfNotAllocatedHelper(reuse_mlvalue_index, &reused_shape));
+
+          Tensor* reused_tensor = GetMutableMLValue(reuse_mlvalue_index).GetMutable<Tensor>();
+          ORT_RETURN_IF_NOT(static_cast<size_t>(per_alloc_plan.reused_buffer_offset) +
+                                    Tensor::CalculateTensorStorageSize(ml_data_type, *shape) <=
+                                reused_tensor->SizeInBytes(),
+                            "The slice of ", reused_name, " does not fit in it");
+          ORT_RETURN_IF_ERROR(AllocateTensorWithPreAllocateBufferHelper(
+              ort_value, static_cast<char*>(reused_tensor->MutableDataRaw()) + per_alloc_plan.reused_buffer_offset,
+              ml_data_type, alloc_info, *shape));
+          break;
+        }
+
         ORT_RETURN_IF_ERROR(AllocateReusedOrtValueIfNotAllocatedHelper(reuse_mlvalue_index, shape));
 
         bool is_strided_tensor = false;
@@ -905,6 +937,9 @@ void ExecutionFrame::TraceAllocate(int ort_value_idx, size_t size) {
     if (!status.IsOK()) {
       LOGS(session_state_.Logger(), WARNING) << "TraceAllocation for ort_value_idx=" << ort_value_idx
                                              << " size=" << size << " failed: " << status.ErrorMessage();
+    } else if (trace_mem_pattern_events_) {
+      std::lock_guard<OrtMutex> lock(mem_pattern_trace_mutex_);
+      mem_pattern_trace_.push_back(MemoryPatternTraceEvent{ort_value_idx, true, size});
     }
   }
 }
@@ -929,6 +964,9 @@ void ExecutionFrame::TraceFree(int ort_value_idx) {
         if (!status.IsOK()) {
           LOGS(session_state_.Logger(), WARNING)
               << "TraceFree for ort_value_idx=" << ort_value_idx << " failed: " << status.ErrorMessage();
+        } else if (trace_mem_pattern_events_) {
+          std::lock_guard<OrtMutex> lock(mem_pattern_trace_mutex_);
+          mem_pattern_trace_.push_back(MemoryPatternTraceEvent{ort_value_idx, false, 0});
         }
       }
     }
@@ -14,8 +14,10 @@
 #include "core/framework/node_index_info.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/sequential_execution_plan.h"
+#include "core/framework/symbolic_mem_pattern.h"
 #include "core/framework/tensor.h"
 #include "core/graph/graph_viewer.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -166,6 +168,12 @@ class ExecutionFrame final : public IExecutionFrame {
     return planner_.has_value();
   }
 
+  // Allocations and releases traced by the memory pattern planner, if the session generates symbolic memory
+  // patterns. Must not be called while the frame is in use by a run.
+  gsl::span<const MemoryPatternTraceEvent> GetMemoryPatternTrace() const {
+    return mem_pattern_trace_;
+  }
+
   // This function try retrieve the inferred shapes for the given NodeArg index.
   // If the retrival is sucessful, this function returns true and false otherwise.
   bool TryGetInferredShape(int index, TensorShape& shape) const override;
@@ -231,12 +239,17 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
   std::optional<OrtValuePatternPlanner> planner_;
 
+  // Events traced by planner_, recorded to create the symbolic memory pattern of the session.
+  bool trace_mem_pattern_events_ = false;
+  OrtMutex mem_pattern_trace_mutex_;
+  InlinedVector<MemoryPatternTraceEvent> mem_pattern_trace_;
+
   // Big chunks on different locations that will be used by mem_pattern.
   InlinedHashMap<OrtDevice, BufferUniquePtr> buffers_;
 
@@ -245,7 +258,7 @@ class ExecutionFrame final : public IExecutionFrame {
   // by i, if the key i exists.
   // inferred_shapes_ is generated together with mem_patterns_.
   // It is never updated after creation
-  const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
+  std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes_;
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Size of virtual memory allocated before any kernel execution.
@@ -2,7 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/framework/execution_steps.h"
+
+#include <chrono>
+
+#include "core/framework/node_overhead_stats.h"
 #include "core/framework/sequential_executor.h"
+#include "core/framework/session_state.h"
 
 namespace onnxruntime {
 
@@ -34,7 +39,19 @@ Status WaitOnEPStep::Execute(StreamExecutionContext& ctx,
                              const bool& /*terminate_flag*/,
                              bool& continue_flag) {
   ORT_ENFORCE(wait_handle_, "WaitOnEPStep.wait_handle is null");
+  auto* overhead_stats = ctx.GetSessionState().GetNodeOverheadStats();
+  std::chrono::steady_clock::time_point wait_start;
+  if (overhead_stats) {
+    wait_start = std::chrono::steady_clock::now();
+  }
   wait_handle_(*ctx.GetDeviceStream(stream_idx), *ctx.GetNotification(notification_idx_));
+  if (overhead_stats) {
+    // Attributed to the node waiting on the notification, which is counted when it is launched.
+    NodeOverheadStats::Durations durations{};
+    durations[NodeOverheadStats::kStreamSync] = std::chrono::steady_clock::now() - wait_start;
+    const auto* node = ctx.GetSessionState().GetGraphViewer().GetNode(node_index_);
+    overhead_stats->Add(node ? node->OpType() : "", durations, 0);
+  }
   // update streams clock status
   if (ctx.GetDeviceStream(stream_idx)) {
     ctx.GetDeviceStream(stream_idx)->UpdateStreamClock(ctx.GetNotification(notification_idx_)->GetStreamSyncTable());
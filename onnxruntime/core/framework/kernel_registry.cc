@@ -186,32 +186,54 @@ Status KernelRegistry::TryFindKernelImpl(const Node& node,
   const auto& node_provider = node.GetExecutionProviderType();
   const auto& expected_provider = (node_provider.empty() ? exec_provider : node_provider);
 
-  auto range = kernel_creator_fn_map_.equal_range(GetMapKey(node.OpType(), node.Domain(), expected_provider));
-  if (out) *out = nullptr;
-
-  std::vector<std::string> verify_kernel_def_error_strs;
+  // With the types from the node, the match only depends on what the lookup key holds.
+  std::string lookup_key;
+  if (kernel_type_str_resolver != nullptr) {
+    lookup_key = GetKernelLookupKey(node, expected_provider);
+    std::lock_guard<OrtMutex> lock(kernel_lookup_cache_mutex_);
+    auto cached = kernel_lookup_cache_.find(lookup_key);
+    if (cached != kernel_lookup_cache_.end()) {
+      return KernelLookupStatus(node, expected_provider, cached->second, out);
+    }
+  }
 
+  KernelLookup lookup;
+  auto range = kernel_creator_fn_map_.equal_range(GetMapKey(node.OpType(), node.Domain(), expected_provider));
   for (auto i = range.first; i != range.second; ++i) {
     std::string error_str;
     if (VerifyKernelDef(node, *i->second.kernel_def, kernel_type_str_resolver, type_constraints, error_str)) {
-      if (out) {
-        *out = &i->second;
-      }
-      return Status::OK();
+      lookup.kernel_create_info = &i->second;
+      lookup.errors.clear();
+      break;
     }
 
-    verify_kernel_def_error_strs.push_back(error_str);
+    lookup.errors.push_back(std::move(error_str));
   }
 
-  if (!verify_kernel_def_error_strs.empty()) {
+  if (kernel_type_str_resolver != nullptr) {
+    std::lock_guard<OrtMutex> lock(kernel_lookup_cache_mutex_);
+    kernel_lookup_cache_.emplace(std::move(lookup_key), lookup);
+  }
+
+  return KernelLookupStatus(node, expected_provider, lookup, out);
+}
+
+Status KernelRegistry::KernelLookupStatus(const Node& node, std::string_view provider, const KernelLookup& lookup,
+                                          const KernelCreateInfo** out) {
+  if (out) *out = lookup.kernel_create_info;
+
+  if (lookup.kernel_create_info != nullptr) {
+    return Status::OK();
+  }
+
+  if (!lookup.errors.empty()) {
     std::ostringstream oss;
     oss << "Op with name (" << node.Name() << ")"
         << " domain (" << node.Domain() << ")"
         << " and type (" << node.OpType() << ")"
-        << " kernel is not supported in " << expected_provider << "."
+        << " kernel is not supported in " << provider << "."
         << " Encountered following errors: (";
-    std::copy(verify_kernel_def_error_strs.begin(), verify_kernel_def_error_strs.end(),
-              std::ostream_iterator<std::string>(oss, "\n"));
+    std::copy(lookup.errors.begin(), lookup.errors.end(), std::ostream_iterator<std::string>(oss, "\n"));
     oss << ")";
 
     VLOGS_DEFAULT(2) << "TryFindKernel failed, Reason: " << oss.str();
@@ -221,6 +243,30 @@ Status KernelRegistry::TryFindKernelImpl(const Node& node,
   return Status(common::ONNXRUNTIME, common::FAIL, "Kernel not found");
 }
 
+std::string KernelRegistry::GetKernelLookupKey(const Node& node, std::string_view provider) {
+  std::string key = GetMapKey(node.OpType(), node.Domain(), provider);
+  key.append(1, ' ').append(std::to_string(node.SinceVersion()));
+
+  // the type strings of the NodeArgs are interned, so their addresses identify the types
+  const auto append_args = [&key](gsl::span<const NodeArg* const> args) {
+    key.append(1, '|');
+    for (const NodeArg* arg : args) {
+      const std::string* type = arg->Exists() ? arg->Type() : nullptr;
+      key.append(1, ' ').append(std::to_string(reinterpret_cast<uintptr_t>(type)));
+    }
+  };
+  append_args(node.InputDefs());
+  append_args(node.OutputDefs());
+
+  // the variadic inputs change which inputs the type constraints refer to
+  key.append(1, '|');
+  for (int count : node.InputArgCount()) {
+    key.append(1, ' ').append(std::to_string(count));
+  }
+
+  return key;
+}
+
 Status KernelRegistry::TryFindKernel(const Node& node, ProviderType exec_provider,
                                      const IKernelTypeStrResolver& kernel_type_str_resolver,
                                      const KernelCreateInfo** out) const {
@@ -319,6 +365,10 @@ Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
   // Register the kernel.
   // Ownership of the KernelDef is transferred to kernel_creator_fn_map_.
   kernel_creator_fn_map_.emplace(key, std::move(create_info));
+
+  // a cached lookup may not have found this kernel, or found a kernel registered before it
+  std::lock_guard<OrtMutex> lock(kernel_lookup_cache_mutex_);
+  kernel_lookup_cache_.clear();
   return Status::OK();
 }
 
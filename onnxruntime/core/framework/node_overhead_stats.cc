@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/node_overhead_stats.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace onnxruntime {
+
+namespace {
+// The allocation duration of the node being computed on the current thread, if any.
+thread_local std::chrono::nanoseconds* current_allocation_duration = nullptr;
+
+double ToMicroseconds(std::chrono::nanoseconds duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+}  // namespace
+
+const char* NodeOverheadStats::PhaseName(Phase phase) {
+  switch (phase) {
+    case kPrepare:
+      return "prepare";
+    case kAllocate:
+      return "allocate";
+    case kCompute:
+      return "compute";
+    case kRelease:
+      return "release";
+    case kStreamSync:
+      return "stream_sync";
+    default:
+      return "unknown";
+  }
+}
+
+void NodeOverheadStats::Add(const std::string& op_type, const Durations& durations, uint64_t count) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& summary = summaries_[op_type];
+  summary.count += count;
+  for (size_t i = 0; i < kNumPhases; ++i) {
+    summary.durations[i] += durations[i];
+  }
+}
+
+std::map<std::string, NodeOverheadStats::Summary> NodeOverheadStats::GetSummaries() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return summaries_;
+}
+
+std::string NodeOverheadStats::ToString() const {
+  const auto summaries = GetSummaries();
+
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  ss << std::left << std::setw(24) << "op_type" << std::right << std::setw(10) << "count";
+  for (size_t i = 0; i < kNumPhases; ++i) {
+    ss << std::setw(16) << (std::string(PhaseName(static_cast<Phase>(i))) + "_us");
+  }
+  ss << std::setw(12) << "overhead_%" << "\n";
+
+  Summary total;
+  auto write_row = [&ss](const std::string& name, const Summary& summary) {
+    ss << std::left << std::setw(24) << name << std::right << std::setw(10) << summary.count;
+    std::chrono::nanoseconds all{0};
+    for (size_t i = 0; i < kNumPhases; ++i) {
+      ss << std::setw(16) << ToMicroseconds(summary.durations[i]);
+      all += summary.durations[i];
+    }
+    const auto overhead = all - summary.durations[kCompute];
+    ss << std::setw(12) << (all.count() > 0 ? 100.0 * overhead.count() / all.count() : 0.0) << "\n";
+  };
+
+  for (const auto& [op_type, summary] : summaries) {
+    write_row(op_type, summary);
+    total.count += summary.count;
+    for (size_t i = 0; i < kNumPhases; ++i) {
+      total.durations[i] += summary.durations[i];
+    }
+  }
+  write_row("total", total);
+  return ss.str();
+}
+
+void NodeOverheadStats::Reset() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  summaries_.clear();
+}
+
+NodeOverheadStats::ScopedAllocationTracking::ScopedAllocationTracking(std::chrono::nanoseconds& allocation_duration)
+    : previous_(current_allocation_duration) {
+  current_allocation_duration = &allocation_duration;
+}
+
+NodeOverheadStats::ScopedAllocationTracking::~ScopedAllocationTracking() {
+  current_allocation_duration = previous_;
+}
+
+NodeOverheadStats::AllocationTimer::AllocationTimer() : allocation_duration_(current_allocation_duration) {
+  if (allocation_duration_ != nullptr) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+NodeOverheadStats::AllocationTimer::~AllocationTimer() {
+  if (allocation_duration_ != nullptr) {
+    *allocation_duration_ += std::chrono::steady_clock::now() - start_;
+  }
+}
+
+}  // namespace onnxruntime
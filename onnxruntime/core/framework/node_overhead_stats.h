@@ -0,0 +1,91 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Aggregates the time spent in each phase of executing a node, per op type, to tell apart the framework overhead
+ * between kernels from the time spent in the kernels themselves.
+ * Enabled by kOrtSessionOptionsConfigEnableNodeOverheadStats. It is shared by a session state and its subgraphs.
+ */
+class NodeOverheadStats {
+ public:
+  enum Phase {
+    // Setting up the kernel context, which resolves the inputs of the node in the execution frame.
+    kPrepare = 0,
+    // Allocating the outputs of the node in the execution frame, while the kernel is computing.
+    kAllocate,
+    // Running the kernel, excluding the allocation of its outputs.
+    kCompute,
+    // Releasing the inputs of the node that are no longer used.
+    kRelease,
+    // Waiting on notifications of other streams before running the node.
+    kStreamSync,
+  };
+
+  static constexpr size_t kNumPhases = kStreamSync + 1;
+
+  static const char* PhaseName(Phase phase);
+
+  struct Summary {
+    // Number of times a node of the op type was executed.
+    uint64_t count = 0;
+    std::array<std::chrono::nanoseconds, kNumPhases> durations{};
+  };
+
+  using Durations = std::array<std::chrono::nanoseconds, kNumPhases>;
+
+  // Record the durations of an execution of a node of op_type. count is the number of node executions it covers,
+  // 0 for a phase recorded separately from the other phases of the node, e.g. stream synchronization.
+  void Add(const std::string& op_type, const Durations& durations, uint64_t count = 1);
+
+  // Summaries of all op types executed so far, sorted by op type.
+  std::map<std::string, Summary> GetSummaries() const;
+
+  // Human readable table of the summaries, with the total of each phase.
+  std::string ToString() const;
+
+  void Reset();
+
+  /**
+   * Accumulates the time spent in the allocation of node outputs on the current thread into a duration, while it
+   * is in scope. Allocations record their time with AllocationTimer.
+   */
+  class ScopedAllocationTracking {
+   public:
+    explicit ScopedAllocationTracking(std::chrono::nanoseconds& allocation_duration);
+    ~ScopedAllocationTracking();
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedAllocationTracking);
+    std::chrono::nanoseconds* previous_;
+  };
+
+  // Times an allocation if the current thread is tracking allocations. It does nothing otherwise.
+  class AllocationTimer {
+   public:
+    AllocationTimer();
+    ~AllocationTimer();
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(AllocationTimer);
+    std::chrono::nanoseconds* allocation_duration_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+ private:
+  mutable OrtMutex mutex_;
+  std::map<std::string, Summary> summaries_;
+};
+
+}  // namespace onnxruntime
@@ -2,10 +2,80 @@
 // Licensed under the MIT License.
 
 #include "core/framework/prepacked_weights_container.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "core/common/safeint.h"
 #include "core/framework/allocator_utils.h"
 
 namespace onnxruntime {
 
+namespace {
+
+// Layout of a pre-packed weights file, in the byte order of the machine that wrote it:
+//   magic
+//   uint64 number of weights
+//   for each weight: uint64 key size, key, uint64 number of buffers, and for each buffer: uint64 offset, uint64 size
+//   uint64 number of kernel input keys
+//   for each kernel input key: uint64 kernel input key size, kernel input key, uint64 key size, key
+//   buffers, each at an offset aligned to kPrepackedWeightsFileAlignment from the start of the file
+constexpr std::array<char, 8> kPrepackedWeightsFileMagic{'O', 'R', 'T', 'P', 'P', 'W', '0', '2'};
+
+// Alignment of the buffers in the file, which is at least the alignment of the buffers returned by CPUAllocator.
+// A mapped file starts on a page boundary, so the buffers keep that alignment when mapped.
+constexpr size_t kPrepackedWeightsFileAlignment = 64;
+
+size_t AlignPrepackedWeightsFileOffset(size_t offset) {
+  return (SafeInt<size_t>(offset) + kPrepackedWeightsFileAlignment - 1) / kPrepackedWeightsFileAlignment *
+         kPrepackedWeightsFileAlignment;
+}
+
+void WriteUInt64(std::ostream& stream, uint64_t value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::ostream& stream, const std::string& value) {
+  WriteUInt64(stream, value.size());
+  stream.write(value.data(), value.size());
+}
+
+// Reads the file sequentially with bounds checks.
+class PrepackedWeightsFileReader {
+ public:
+  PrepackedWeightsFileReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  Status Read(void* out, size_t num_bytes) {
+    ORT_RETURN_IF(num_bytes > size_ - position_, "Unexpected end of pre-packed weights file.");
+    memcpy(out, data_ + position_, num_bytes);
+    position_ += num_bytes;
+    return Status::OK();
+  }
+
+  Status ReadUInt64(uint64_t& value) {
+    return Read(&value, sizeof(value));
+  }
+
+  Status ReadString(std::string& value) {
+    uint64_t size = 0;
+    ORT_RETURN_IF_ERROR(ReadUInt64(size));
+    ORT_RETURN_IF(size > size_ - position_, "Unexpected end of pre-packed weights file.");
+    value.assign(data_ + position_, static_cast<size_t>(size));
+    position_ += static_cast<size_t>(size);
+    return Status::OK();
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+}  // namespace
+
 AllocatorPtr PrepackedWeightsContainer::GetOrCreateAllocator(const std::string& device_name) {
   auto iter = allocators_.find(device_name);
 
@@ -49,4 +119,180 @@ size_t PrepackedWeightsContainer::GetNumberOfElements() const {
   return prepacked_weights_map_.size();
 }
 
+bool PrepackedWeightsContainer::WriteKernelInputKey(const std::string& kernel_input_key, const std::string& key) {
+  auto ret = kernel_input_keys_.insert(std::make_pair(kernel_input_key, key));
+  return ret.second;
+}
+
+const std::string* PrepackedWeightsContainer::GetKeyForKernelInput(const std::string& kernel_input_key) const {
+  auto iter = kernel_input_keys_.find(kernel_input_key);
+  return iter != kernel_input_keys_.end() ? &iter->second : nullptr;
+}
+
+Status PrepackedWeightsContainer::SaveToFile(const PathString& file_path) const {
+  // sort the keys so that the same weights always produce the same file
+  std::vector<const std::string*> keys;
+  keys.reserve(prepacked_weights_map_.size());
+  for (const auto& entry : prepacked_weights_map_) {
+    keys.push_back(&entry.first);
+  }
+  std::sort(keys.begin(), keys.end(), [](const std::string* a, const std::string* b) { return *a < *b; });
+
+  SafeInt<size_t> header_size = kPrepackedWeightsFileMagic.size() + sizeof(uint64_t);
+  for (const auto* key : keys) {
+    const auto& weight = prepacked_weights_map_.at(*key);
+    ORT_RETURN_IF(weight.buffers_.size() != weight.buffer_sizes_.size(),
+                  "Mismatch between the number of buffers and buffer sizes of pre-packed weight ", *key);
+    header_size += sizeof(uint64_t) + key->size() + sizeof(uint64_t) + 2 * sizeof(uint64_t) * weight.buffers_.size();
+  }
+
+  std::vector<std::pair<const std::string*, const std::string*>> kernel_input_keys;
+  kernel_input_keys.reserve(kernel_input_keys_.size());
+  header_size += sizeof(uint64_t);
+  for (const auto& entry : kernel_input_keys_) {
+    kernel_input_keys.emplace_back(&entry.first, &entry.second);
+    header_size += sizeof(uint64_t) + entry.first.size() + sizeof(uint64_t) + entry.second.size();
+  }
+  std::sort(kernel_input_keys.begin(), kernel_input_keys.end(),
+            [](const auto& a, const auto& b) { return *a.first < *b.first; });
+
+  const PathString temp_file_path = file_path + ORT_TSTR(".") +
+                                    ToPathString(std::to_string(Env::Default().GetSelfPid())) + ORT_TSTR(".tmp");
+  {
+    std::ofstream stream(temp_file_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF(!stream, "Failed to open ", ToUTF8String(temp_file_path), " for writing.");
+
+    stream.write(kPrepackedWeightsFileMagic.data(), kPrepackedWeightsFileMagic.size());
+    WriteUInt64(stream, keys.size());
+    size_t offset = AlignPrepackedWeightsFileOffset(header_size);
+    for (const auto* key : keys) {
+      const auto& weight = prepacked_weights_map_.at(*key);
+      WriteString(stream, *key);
+      WriteUInt64(stream, weight.buffers_.size());
+      for (size_t size : weight.buffer_sizes_) {
+        WriteUInt64(stream, offset);
+        WriteUInt64(stream, size);
+        offset = AlignPrepackedWeightsFileOffset(SafeInt<size_t>(offset) + size);
+      }
+    }
+
+    WriteUInt64(stream, kernel_input_keys.size());
+    for (const auto& [kernel_input_key, key] : kernel_input_keys) {
+      WriteString(stream, *kernel_input_key);
+      WriteString(stream, *key);
+    }
+
+    const std::array<char, kPrepackedWeightsFileAlignment> padding{};
+    size_t position = header_size;
+    for (const auto* key : keys) {
+      const auto& weight = prepacked_weights_map_.at(*key);
+      for (size_t i = 0; i < weight.buffers_.size(); ++i) {
+        const size_t aligned_position = AlignPrepackedWeightsFileOffset(position);
+        stream.write(padding.data(), aligned_position - position);
+        if (weight.buffer_sizes_[i] > 0) {
+          stream.write(static_cast<const char*>(weight.buffers_[i].get()), weight.buffer_sizes_[i]);
+        }
+        position = aligned_position + weight.buffer_sizes_[i];
+      }
+    }
+
+    ORT_RETURN_IF(!stream.flush(), "Failed to write pre-packed weights to ", ToUTF8String(temp_file_path), ".");
+  }
+
+#ifdef _WIN32
+  const int rename_result = _wrename(temp_file_path.c_str(), file_path.c_str());
+#else
+  const int rename_result = std::rename(temp_file_path.c_str(), file_path.c_str());
+#endif
+  if (rename_result != 0) {
+#ifdef _WIN32
+    _wremove(temp_file_path.c_str());
+#else
+    std::remove(temp_file_path.c_str());
+#endif
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to rename ", ToUTF8String(temp_file_path), " to ",
+                           ToUTF8String(file_path), ".");
+  }
+
+  return Status::OK();
+}
+
+Status PrepackedWeightsContainer::LoadFromFile(const PathString& file_path) {
+  if (IsFileLoaded(file_path)) {
+    return Status::OK();
+  }
+
+  size_t file_size = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(file_path.c_str(), file_size));
+  ORT_RETURN_IF(file_size < kPrepackedWeightsFileMagic.size(), "Invalid pre-packed weights file ",
+                ToUTF8String(file_path), ".");
+
+  Env::MappedMemoryPtr mapped_file;
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(file_path.c_str(), 0, file_size, mapped_file));
+  char* data = mapped_file.get();
+
+  PrepackedWeightsFileReader reader(data, file_size);
+  std::array<char, kPrepackedWeightsFileMagic.size()> magic{};
+  ORT_RETURN_IF_ERROR(reader.Read(magic.data(), magic.size()));
+  ORT_RETURN_IF(magic != kPrepackedWeightsFileMagic, "Invalid pre-packed weights file ", ToUTF8String(file_path),
+                ".");
+
+  // parse the whole file before adding any weight, so an invalid file leaves the container unchanged
+  std::vector<std::pair<std::string, PrePackedWeights>> weights;
+  uint64_t num_weights = 0;
+  ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_weights));
+  for (uint64_t i = 0; i < num_weights; ++i) {
+    std::string key;
+    ORT_RETURN_IF_ERROR(reader.ReadString(key));
+
+    uint64_t num_buffers = 0;
+    ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_buffers));
+    ORT_RETURN_IF(num_buffers > file_size, "Invalid number of buffers in pre-packed weights file.");
+
+    PrePackedWeights weight;
+    for (uint64_t j = 0; j < num_buffers; ++j) {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      ORT_RETURN_IF_ERROR(reader.ReadUInt64(offset));
+      ORT_RETURN_IF_ERROR(reader.ReadUInt64(size));
+      ORT_RETURN_IF(offset > file_size || size > file_size - offset,
+                    "Buffer of pre-packed weight ", key, " is out of the bounds of the file.");
+
+      // the buffers are owned by the mapping, so they are not freed individually
+      weight.buffers_.emplace_back(size > 0 ? data + offset : nullptr, [](void*) {});
+      weight.buffer_sizes_.push_back(static_cast<size_t>(size));
+    }
+    weights.emplace_back(std::move(key), std::move(weight));
+  }
+
+  std::vector<std::pair<std::string, std::string>> kernel_input_keys;
+  uint64_t num_kernel_input_keys = 0;
+  ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_kernel_input_keys));
+  for (uint64_t i = 0; i < num_kernel_input_keys; ++i) {
+    std::string kernel_input_key;
+    std::string key;
+    ORT_RETURN_IF_ERROR(reader.ReadString(kernel_input_key));
+    ORT_RETURN_IF_ERROR(reader.ReadString(key));
+    kernel_input_keys.emplace_back(std::move(kernel_input_key), std::move(key));
+  }
+
+  for (auto& [key, weight] : weights) {
+    prepacked_weights_map_.insert(std::make_pair(std::move(key), std::move(weight)));
+  }
+
+  for (auto& [kernel_input_key, key] : kernel_input_keys) {
+    if (HasWeight(key)) {
+      kernel_input_keys_.insert(std::make_pair(std::move(kernel_input_key), std::move(key)));
+    }
+  }
+
+  mapped_files_.push_back(std::move(mapped_file));
+  loaded_files_.insert(file_path);
+  return Status::OK();
+}
+
+bool PrepackedWeightsContainer::IsFileLoaded(const PathString& file_path) const {
+  return loaded_files_.find(file_path) != loaded_files_.end();
+}
+
 }  // namespace onnxruntime
@@ -7,10 +7,14 @@
 #include <unordered_set>
 #include <string>
 #include <cstdint>
+#include <vector>
 
 #include "core/framework/buffer_deleter.h"
 
+#include "core/common/path_string.h"
+#include "core/common/status.h"
 #include "core/framework/allocator.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
 #include "prepacked_weights.h"
 
@@ -47,6 +51,28 @@ class PrepackedWeightsContainer final {
   // Returns the number of elements in the container
   size_t GetNumberOfElements() const;
 
+  // Records that the weight of the provided key is the pre-packed form of a kernel input.
+  // The kernel input key identifies the kernel, the tensor and the CPU it was pre-packed for, so that sessions
+  // loading the container from a file can find the pre-packed weight of a kernel input without calling PrePack().
+  // Returns a boolean indicating if the insertion took place.
+  bool WriteKernelInputKey(const std::string& kernel_input_key, const std::string& key);
+
+  // Returns the key of the weight recorded for the kernel input key, or nullptr if there is none.
+  const std::string* GetKeyForKernelInput(const std::string& kernel_input_key) const;
+
+  // Serializes the pre-packed weights in the container into a file that LoadFromFile() can memory map, so that
+  // processes running the same model share a single copy of the pre-packed weights through the page cache.
+  // The file is written to a temporary file that is then renamed, so readers never see a partially written file.
+  Status SaveToFile(const PathString& file_path) const;
+
+  // Memory maps a file written by SaveToFile() and adds its pre-packed weights and kernel input keys to the
+  // container without copying the weights. The weights stay mapped until the container is destroyed. Entries whose
+  // key is already in the container are skipped, and a file that was already loaded is not loaded again.
+  Status LoadFromFile(const PathString& file_path);
+
+  // Returns a boolean indicating if the file was loaded with LoadFromFile().
+  bool IsFileLoaded(const PathString& file_path) const;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsContainer);
 
   // Resource to be acquired by the method that is going to invoke calls to the kernels'
@@ -60,10 +86,18 @@ class PrepackedWeightsContainer final {
   // because the Tensor buffers will be de-allocated using these allocators
   std::unordered_map<std::string, AllocatorPtr> allocators_;
 
+  // Files mapped by LoadFromFile(). They need to be unmapped after the container containing the pre-packed
+  // weights that point into them is destructed.
+  std::vector<Env::MappedMemoryPtr> mapped_files_;
+  std::unordered_set<PathString> loaded_files_;
+
   // This is an unordered map that holds a mapping between a composite key
   // to PrePackedWeights instances.
   // The key is : op_type + "+" + hash_of_prepacked_buffers_in_the_PrepackedWeights_instance.
   std::unordered_map<std::string, PrePackedWeights> prepacked_weights_map_;
+
+  // Maps kernel input keys to keys of prepacked_weights_map_.
+  std::unordered_map<std::string, std::string> kernel_input_keys_;
 };
 
 }  // namespace onnxruntime
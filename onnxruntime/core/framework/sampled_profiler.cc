@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/sampled_profiler.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include "core/graph/graph.h"
+#include "nlohmann/json.hpp"
+
+namespace onnxruntime {
+
+namespace {
+double ToMicroseconds(std::chrono::nanoseconds duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+void Add(SampledProfiler::Summary& summary, std::chrono::nanoseconds duration) {
+  ++summary.count;
+  summary.total += duration;
+  summary.max = std::max(summary.max, duration);
+}
+
+template <typename Key>
+std::vector<std::pair<Key, SampledProfiler::Summary>> SortByTotal(
+    const std::unordered_map<Key, SampledProfiler::Summary>& summaries) {
+  std::vector<std::pair<Key, SampledProfiler::Summary>> sorted(summaries.begin(), summaries.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second.total > b.second.total; });
+  return sorted;
+}
+
+nlohmann::json SummaryToJson(const SampledProfiler::Summary& summary) {
+  return {{"count", summary.count},
+          {"total_us", ToMicroseconds(summary.total)},
+          {"mean_us", summary.count > 0 ? ToMicroseconds(summary.total) / summary.count : 0.0},
+          {"max_us", ToMicroseconds(summary.max)}};
+}
+}  // namespace
+
+SampledProfiler::SampledProfiler(uint32_t sample_rate, size_t window_size)
+    : sample_rate_(sample_rate), window_size_(window_size) {
+  ORT_ENFORCE(sample_rate_ > 0, "The profiling sample rate must be positive");
+  ORT_ENFORCE(window_size_ > 0, "The profiling sample window must not be empty");
+  window_.reserve(window_size_);
+}
+
+SampledProfiler::RunRecorder::RunRecorder(SampledProfiler& profiler)
+    : profiler_(profiler), start_(std::chrono::steady_clock::now()) {
+}
+
+SampledProfiler::RunRecorder::~RunRecorder() {
+  RunSample run;
+  run.duration = std::chrono::steady_clock::now() - start_;
+  run.nodes = std::move(nodes_);
+  profiler_.AddRun(std::move(run));
+}
+
+void SampledProfiler::RunRecorder::AddNode(const Node& node, std::chrono::nanoseconds duration) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  nodes_.emplace_back(&node, duration);
+}
+
+void SampledProfiler::AddRun(RunSample&& run) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  ++num_sampled_runs_;
+  if (window_.size() < window_size_) {
+    window_.push_back(std::move(run));
+  } else {
+    window_[next_] = std::move(run);
+    next_ = (next_ + 1) % window_size_;
+  }
+}
+
+std::string SampledProfiler::ToJson() const {
+  Summary run_summary;
+  std::unordered_map<std::string, Summary> op_types;
+  std::unordered_map<const Node*, Summary> nodes;
+  uint64_t num_sampled_runs;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    num_sampled_runs = num_sampled_runs_;
+    for (const auto& run : window_) {
+      Add(run_summary, run.duration);
+      for (const auto& [node, duration] : run.nodes) {
+        Add(op_types[node->OpType()], duration);
+        Add(nodes[node], duration);
+      }
+    }
+  }
+
+  nlohmann::json json;
+  json["sample_rate"] = sample_rate_;
+  json["runs"] = run_counter_.load(std::memory_order_relaxed);
+  json["sampled_runs"] = num_sampled_runs;
+  json["window_runs"] = run_summary.count;
+  json["run"] = SummaryToJson(run_summary);
+  auto& op_types_json = json["op_types"] = nlohmann::json::array();
+  for (const auto& [op_type, summary] : SortByTotal(op_types)) {
+    auto entry = SummaryToJson(summary);
+    entry["op_type"] = op_type;
+    op_types_json.push_back(std::move(entry));
+  }
+  auto& nodes_json = json["nodes"] = nlohmann::json::array();
+  for (const auto& [node, summary] : SortByTotal(nodes)) {
+    auto entry = SummaryToJson(summary);
+    entry["name"] = node->Name();
+    entry["op_type"] = node->OpType();
+    entry["provider"] = node->GetExecutionProviderType();
+    nodes_json.push_back(std::move(entry));
+  }
+  return json.dump();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class Node;
+
+/**
+ * Profiles one in sample_rate runs of a session, cheap enough to stay enabled in production.
+ * A sampled run records the time of each node of the main graph, a node with subgraphs being timed as a whole, into
+ * a ring buffer of the last window_size sampled runs. The runs that are not sampled only pay for an atomic increment.
+ * Enabled by kOrtSessionOptionsConfigProfilingSampleRate.
+ */
+class SampledProfiler {
+ public:
+  SampledProfiler(uint32_t sample_rate, size_t window_size);
+
+  // Whether the next run is sampled.
+  bool ShouldSample() {
+    return run_counter_.fetch_add(1, std::memory_order_relaxed) % sample_rate_ == 0;
+  }
+
+  /**
+   * Records the nodes of a sampled run, which may run concurrently on several streams, and adds the run to the
+   * ring buffer when it goes out of scope.
+   */
+  class RunRecorder {
+   public:
+    explicit RunRecorder(SampledProfiler& profiler);
+    ~RunRecorder();
+
+    void AddNode(const Node& node, std::chrono::nanoseconds duration);
+
+   private:
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunRecorder);
+    SampledProfiler& profiler_;
+    std::chrono::steady_clock::time_point start_;
+    OrtMutex mutex_;
+    std::vector<std::pair<const Node*, std::chrono::nanoseconds>> nodes_;
+  };
+
+  struct Summary {
+    // Number of executions in the sampled runs of the window.
+    uint64_t count = 0;
+    std::chrono::nanoseconds total{};
+    std::chrono::nanoseconds max{};
+  };
+
+  /*
+  The aggregate of the sampled runs in the window as JSON: the number of runs seen and sampled, the run latency, and
+  the summary of each op type and of each node sorted by decreasing total time, so the hotspots come first.
+  */
+  std::string ToJson() const;
+
+ private:
+  struct RunSample {
+    std::chrono::nanoseconds duration{};
+    std::vector<std::pair<const Node*, std::chrono::nanoseconds>> nodes;
+  };
+
+  void AddRun(RunSample&& run);
+
+  const uint32_t sample_rate_;
+  std::atomic<uint64_t> run_counter_{0};
+
+  mutable OrtMutex mutex_;
+  std::vector<RunSample> window_;
+  // the index of the oldest run once the window is full
+  size_t next_ = 0;
+  const size_t window_size_;
+  uint64_t num_sampled_runs_ = 0;
+};
+
+}  // namespace onnxruntime
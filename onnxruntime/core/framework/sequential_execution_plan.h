@@ -35,6 +35,11 @@ struct AllocPlanPerValue {
   // reused_buffer is valid only if alloc_kind == kReuse. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // is_slice_of_reused_buffer indicates that this OrtValue is the part of the buffer of reused_buffer starting at
+  // reused_buffer_offset bytes, like the inputs of a Concat which are written to directly in the output of the Concat.
+  // reused_buffer has a static shape and is allocated with it when this OrtValue is.
+  bool is_slice_of_reused_buffer{false};
+  ptrdiff_t reused_buffer_offset{0};
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   IntervalT life_interval{0, 0};
   IntervalT allocate_interval{0, 0};
@@ -4,10 +4,13 @@
 #include "core/framework/sequential_executor.h"
 
 #include <chrono>
+#include <optional>
 #include <thread>
 #include <vector>
 #include <sstream>
 #include "core/common/common.h"
+#include "core/common/denormal.h"
+#include "core/common/hardware_counters.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
@@ -179,6 +182,10 @@ class SessionScope {
     if (session_state_.Profiler().IsEnabled()) {
       session_start_ = session_state.Profiler().Start();
     }
+    if (auto* sampled_profiler = session_state_.GetSampledProfiler();
+        sampled_profiler != nullptr && sampled_profiler->ShouldSample()) {
+      run_recorder_.emplace(*sampled_profiler);
+    }
 
     auto& logger = session_state_.Logger();
     VLOGS(logger, 0) << "Begin execution";
@@ -247,9 +254,15 @@ class SessionScope {
   }
 #endif
 
+  // The recorder of the nodes of the run, if it is sampled by the sampled profiler.
+  SampledProfiler::RunRecorder* GetRunRecorder() {
+    return run_recorder_ ? &*run_recorder_ : nullptr;
+  }
+
  private:
   const SessionState& session_state_;
   TimePoint session_start_;
+  std::optional<SampledProfiler::RunRecorder> run_recorder_;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   const ExecutionFrame& frame_;
   // Whether memory profiler need create events and flush to file.
@@ -336,6 +349,16 @@ class KernelScope {
     node_compute_range_.Begin();
 #endif
 
+    if (const auto* denormal_as_zero_op_types = session_state_.GetDenormalAsZeroOpTypes();
+        denormal_as_zero_op_types != nullptr && kernel_.KernelDef().Provider() == kCpuExecutionProvider &&
+        denormal_as_zero_op_types->count(kernel_.Node().OpType()) != 0) {
+      denormal_as_zero_.emplace();
+    }
+
+    if (session_scope_.GetRunRecorder() != nullptr) {
+      sample_start_ = std::chrono::steady_clock::now();
+    }
+
     if (session_state_.Profiler().IsEnabled()) {
       auto& node = kernel.Node();
       node_name_ = node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name();
@@ -351,6 +374,8 @@ class KernelScope {
       CalculateTotalInputSizes(&kernel_context, &kernel_,
                                input_activation_sizes_, input_parameter_sizes_,
                                node_name_, input_type_shape_);
+      has_hardware_counters_ = profiler.HardwareCountersEnabled() &&
+                               profiling::HardwareCounters::Read(hardware_counters_begin_);
     }
   }
 
@@ -361,8 +386,19 @@ class KernelScope {
     node_compute_range_.End();
 #endif
 
+    if (auto* run_recorder = session_scope_.GetRunRecorder(); run_recorder != nullptr) {
+      run_recorder->AddNode(kernel_.Node(), std::chrono::steady_clock::now() - sample_start_);
+    }
+
     if (session_state_.Profiler().IsEnabled()) {
       auto& profiler = session_state_.Profiler();
+      // read right after the kernel so that the counters don't include the profiling of its outputs
+      std::string hardware_counters;
+      profiling::HardwareCounters::Values hardware_counters_end;
+      if (has_hardware_counters_ && profiling::HardwareCounters::Read(hardware_counters_end)) {
+        hardware_counters = profiling::HardwareCounters::ToJson(hardware_counters_begin_, hardware_counters_end,
+                                                                TimeDiffMicroSeconds(kernel_begin_time_));
+      }
       std::string output_type_shape_;
       CalculateTotalOutputSizes(&kernel_context_, total_output_sizes_, node_name_, output_type_shape_);
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
@@ -380,6 +416,7 @@ class KernelScope {
                                          {"output_type_shape", output_type_shape_},
                                          {"thread_scheduling_stats",
                                           concurrency::ThreadPool::StopProfiling(session_state_.GetThreadPool())},
+                                         {"hardware_counters", hardware_counters},
                                      });
       auto sync_time_begin = profiler.Start();
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
@@ -402,6 +439,10 @@ class KernelScope {
                       TraceLoggingValue(elapsed.QuadPart, "time"));
 #endif
 
+    if (auto* tensor_statistics = session_state_.GetTensorStatistics(); tensor_statistics != nullptr) {
+      tensor_statistics->AddNodeOutputs(kernel_context_, kernel_.Node());
+    }
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
     utils::DumpNodeOutputs(dump_context_, kernel_context_, kernel_.Node(), session_state_);
 #endif
@@ -419,6 +460,10 @@ class KernelScope {
   size_t input_parameter_sizes_{};
   size_t total_output_sizes_{};
   std::string input_type_shape_;
+  bool has_hardware_counters_{false};
+  profiling::HardwareCounters::Values hardware_counters_begin_;
+  std::chrono::steady_clock::time_point sample_start_;
+  std::optional<ScopedDenormalAsZero> denormal_as_zero_;
 
 #ifdef CONCURRENCY_VISUALIZER
   diagnostic::span span_;
@@ -433,6 +478,14 @@ class KernelScope {
 #endif
 };
 
+// Time since start, and reset start to now.
+static std::chrono::nanoseconds ElapsedSince(std::chrono::steady_clock::time_point& start) {
+  const auto now = std::chrono::steady_clock::now();
+  const auto elapsed = now - start;
+  start = now;
+  return elapsed;
+}
+
 onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                   NodeIndex idx,
                                   size_t stream_idx,
@@ -448,6 +501,17 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
     ctx.RecycleNodeInputs(idx);
     return Status::OK();
   }
+  if (p_kernel->Node().ContainsSubgraph()) {
+    // the subgraphs may be finalized on the first execution of the node
+    ORT_RETURN_IF_ERROR(ctx.GetSessionState().EnsureSubgraphSessionStatesFinalized(idx));
+  }
+  auto* overhead_stats = ctx.GetSessionState().GetNodeOverheadStats();
+  NodeOverheadStats::Durations overhead_durations{};
+  std::chrono::steady_clock::time_point phase_start;
+  if (overhead_stats) {
+    phase_start = std::chrono::steady_clock::now();
+  }
+
   // TODO: set terminate flag from run_option
   OpKernelContextInternal kernel_ctx(ctx.GetSessionState(),
                                      ctx.GetExecutionFrame(),
@@ -455,12 +519,21 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                      ctx.GetLogger(),
                                      terminate_flag,
                                      ctx.GetDeviceStream(stream_idx));
+  if (overhead_stats) {
+    overhead_durations[NodeOverheadStats::kPrepare] = ElapsedSince(phase_start);
+  }
   onnxruntime::Status status;
   auto& logger = ctx.GetLogger();
   if (p_kernel->IsAsync()) {
     ORT_THROW("Async Kernel Support is not implemented yet.");
   } else {
     KernelScope kernel_scope(session_scope, kernel_ctx, *p_kernel);
+    // The outputs are allocated while the kernel computes, so their allocation time is tracked separately.
+    std::optional<NodeOverheadStats::ScopedAllocationTracking> allocation_tracking;
+    if (overhead_stats) {
+      allocation_tracking.emplace(overhead_durations[NodeOverheadStats::kAllocate]);
+      phase_start = std::chrono::steady_clock::now();
+    }
     ORT_TRY {
 #ifdef ENABLE_TRAINING
       // AllocateInputsContiguously - is only required for NCCL kernels
@@ -500,6 +573,11 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
         status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
       });
     }
+    if (overhead_stats) {
+      allocation_tracking.reset();
+      overhead_durations[NodeOverheadStats::kCompute] =
+          ElapsedSince(phase_start) - overhead_durations[NodeOverheadStats::kAllocate];
+    }
   }
   if (!status.IsOK()) {
     std::ostringstream ss;
@@ -516,7 +594,14 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
     LOGS(logger, ERROR) << msg_string;
     return Status(status.Category(), status.Code(), msg_string);
   }
+  if (overhead_stats) {
+    phase_start = std::chrono::steady_clock::now();
+  }
   ctx.RecycleNodeInputs(idx);
+  if (overhead_stats) {
+    overhead_durations[NodeOverheadStats::kRelease] = ElapsedSince(phase_start);
+    overhead_stats->Add(p_kernel->Node().OpType(), overhead_durations);
+  }
   VLOGS(logger, 0) << "stream " << stream_idx << " launch kernel with idx " << idx;
   return Status::OK();
 }
@@ -607,6 +692,12 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
       MemoryPatternGroup mem_patterns;
       ORT_RETURN_IF_ERROR(ctx.GetExecutionFrame().GeneratePatterns(mem_patterns));
       ORT_RETURN_IF_ERROR(session_state.UpdateMemoryPatternGroupCache(feeds, std::move(mem_patterns)));
+      // Best effort, runs with new input shapes trace their allocations if the pattern cannot be created.
+      auto status = session_state.UpdateSymbolicMemoryPattern(feeds, feed_mlvalue_idxs,
+                                                              ctx.GetExecutionFrame().GetMemoryPatternTrace());
+      if (!status.IsOK()) {
+        LOGS(logger, VERBOSE) << "Symbolic memory pattern not created: " << status.ErrorMessage();
+      }
     }
   }
 
@@ -22,9 +22,10 @@
 namespace onnxruntime {
 
 enum class ExecutionOrder {
-  DEFAULT = 0,           // default topological sort
-  PRIORITY_BASED = 1,    // priority-based topological sort
-  MEMORY_EFFICIENT = 2,  // memory-efficient topological sort for training purposes.
+  DEFAULT = 0,            // default topological sort
+  PRIORITY_BASED = 1,     // priority-based topological sort
+  MEMORY_EFFICIENT = 2,   // memory-efficient topological sort for training purposes.
+  MEMORY_MINIMIZING = 3,  // topological sort that greedily minimizes the peak size of the live node outputs.
 };
 
 inline std::ostream& operator<<(std::ostream& os, const ExecutionOrder& order) {
@@ -38,6 +39,9 @@ inline std::ostream& operator<<(std::ostream& os, const ExecutionOrder& order) {
     case ExecutionOrder::MEMORY_EFFICIENT:
       os << "MEMORY_EFFICIENT";
       break;
+    case ExecutionOrder::MEMORY_MINIMIZING:
+      os << "MEMORY_MINIMIZING";
+      break;
     default:
       os << "UNKNOWN";
       break;
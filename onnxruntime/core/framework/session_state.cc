@@ -3,18 +3,29 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <limits>
 #include <sstream>
 
 #include "core/platform/ort_mutex.h"
+#include "core/common/hash_combine.h"
 #include "core/common/logging/logging.h"
 #include "core/common/safeint.h"
+#include "core/common/string_utils.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/session_state_utils.h"
+#include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
+#include "core/graph/memory_minimizing_order.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 
@@ -87,6 +98,40 @@ SessionState::SessionState(Graph& graph,
 {
   enable_mem_pattern_ = sess_options_.enable_mem_pattern &&
                         sess_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+  const int64_t mem_patterns_cache_capacity = std::stoll(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternCacheSize, "0"));
+  ORT_ENFORCE(mem_patterns_cache_capacity >= 0, "Memory pattern cache size must not be negative");
+  mem_patterns_cache_capacity_ = static_cast<size_t>(mem_patterns_cache_capacity);
+  cache_all_prepacked_weights_ =
+      prepacked_weights_container_ != nullptr &&
+      !sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrepackedWeightsFile, "").empty();
+  enable_lazy_subgraph_initialization_ =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableLazySubgraphInitialization,
+                                                      "0") == "1";
+  enable_parallel_initialization_ =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableParallelInitialization, "0") == "1";
+  enable_symbolic_mem_patterns_ =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableSymbolicMemoryPatterns, "0") == "1";
+  if (sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableNodeOverheadStats, "0") == "1") {
+    node_overhead_stats_ = std::make_shared<NodeOverheadStats>();
+  }
+  const int64_t profiling_sample_rate = std::stoll(
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfilingSampleRate, "0"));
+  ORT_ENFORCE(profiling_sample_rate >= 0 && profiling_sample_rate <= std::numeric_limits<uint32_t>::max(),
+              "Invalid profiling sample rate: ", profiling_sample_rate);
+  if (profiling_sample_rate > 0) {
+    const int64_t profiling_sample_window = std::stoll(
+        sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfilingSampleWindow, "100"));
+    ORT_ENFORCE(profiling_sample_window > 0, "The profiling sample window must be positive");
+    sampled_profiler_ = std::make_unique<SampledProfiler>(static_cast<uint32_t>(profiling_sample_rate),
+                                                          static_cast<size_t>(profiling_sample_window));
+  }
+  if (sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigCollectTensorStatistics, "0") == "1") {
+    const int64_t histogram_bins = std::stoll(
+        sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigTensorStatisticsHistogramBins, "2048"));
+    ORT_ENFORCE(histogram_bins > 0, "The number of histogram bins of the tensor statistics must be positive");
+    tensor_statistics_ = std::make_shared<TensorStatistics>(static_cast<size_t>(histogram_bins));
+  }
   if (parent_allocators) {
     allocators_ = parent_allocators;
   } else {
@@ -222,7 +267,8 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1);
-    for (const auto& node : nodes) {
+
+    auto create_kernel = [this, &kernel_registry_manager](const Node& node) -> Status {
       // construct and save the kernels
       const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
 
@@ -231,7 +277,37 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
       const IExecutionProvider& exec_provider = *execution_providers_.Get(exec_provider_name);
 
       // assumes vector is already resize()'ed to the number of nodes in the graph
-      ORT_RETURN_IF_ERROR(kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]));
+      return kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]);
+    };
+
+    // the kernels of the CPU EP are created in parallel if requested. the kernels of other EPs are always created
+    // sequentially as they may share state while being created, e.g. compiled kernels use the FuncManager.
+    InlinedVector<const Node*> parallel_nodes;
+    for (const auto& node : nodes) {
+      if (enable_parallel_initialization_ && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+        parallel_nodes.push_back(&node);
+      } else {
+        ORT_RETURN_IF_ERROR(create_kernel(node));
+      }
+    }
+
+    if (!parallel_nodes.empty()) {
+      std::vector<Status> statuses(parallel_nodes.size());
+      concurrency::ThreadPool::TrySimpleParallelFor(
+          thread_pool_, static_cast<std::ptrdiff_t>(parallel_nodes.size()), [&](std::ptrdiff_t i) {
+            ORT_TRY {
+              statuses[i] = create_kernel(*parallel_nodes[i]);
+            }
+            ORT_CATCH(const std::exception& ex) {
+              ORT_HANDLE_EXCEPTION([&]() {
+                statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create the kernel of node ",
+                                              parallel_nodes[i]->Name(), ": ", ex.what());
+              });
+            }
+          });
+      for (const auto& status : statuses) {
+        ORT_RETURN_IF_ERROR(status);
+      }
     }
   }
   node_index_info_.emplace(*graph_viewer_, ort_value_name_idx_map_);
@@ -384,6 +460,54 @@ static Status KernelUseSharedPrePackedBuffers(OpKernel& kernel, int input_idx,
   return Status::OK();
 }
 
+// The key identifying the pre-packed form of the tensor of input_idx of the node, which is the op, the input index,
+// a hash of the node attributes and of the tensor, and the CPU signature.
+// Returns an empty string if the tensor cannot be hashed.
+static std::string GenerateKernelInputKeyForPrepackedWeights(const Node& node, int input_idx, const Tensor& tensor) {
+  if (tensor.IsDataTypeString()) {
+    return std::string();
+  }
+
+  uint32_t hash[4] = {0, 0, 0, 0};
+  auto hash_bytes = [&hash](const void* data, size_t size) {
+    // MurmurHash3 takes an int length, so hash large buffers in chunks
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    constexpr size_t kMaxChunkSize = static_cast<size_t>(std::numeric_limits<int>::max());
+    do {
+      const size_t chunk_size = std::min(size, kMaxChunkSize);
+      MurmurHash3::x86_128(bytes, static_cast<int>(chunk_size), hash[0], &hash);
+      bytes += chunk_size;
+      size -= chunk_size;
+    } while (size > 0);
+  };
+
+  std::vector<std::string> attribute_names;
+  attribute_names.reserve(node.GetAttributes().size());
+  for (const auto& [name, attribute] : node.GetAttributes()) {
+    attribute_names.push_back(name);
+  }
+  std::sort(attribute_names.begin(), attribute_names.end());
+  for (const auto& name : attribute_names) {
+    const std::string serialized_attribute = node.GetAttributes().at(name).SerializeAsString();
+    hash_bytes(serialized_attribute.data(), serialized_attribute.size());
+  }
+
+  const int32_t element_type = tensor.GetElementType();
+  hash_bytes(&element_type, sizeof(element_type));
+  const auto dims = tensor.Shape().GetDims();
+  hash_bytes(dims.data(), dims.size_bytes());
+  hash_bytes(tensor.DataRaw(), tensor.SizeInBytes());
+
+  std::ostringstream ss;
+  ss << node.Domain() << ":" << node.OpType() << ":" << node.SinceVersion() << ":" << input_idx << "+" << std::hex
+     << std::setfill('0');
+  for (uint32_t hash_part : hash) {
+    ss << std::setw(8) << hash_part;
+  }
+  ss << std::dec << "+" << session_state_utils::GetBuildAndCpuSignature();
+  return ss.str();
+}
+
 static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
                                                      const PrePackedWeights& pre_packed_weights) {
   std::ostringstream ss_1;
@@ -396,8 +520,20 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
+  // A PrePack() call deferred to run in parallel with the PrePack() calls of other kernels.
+  struct DeferredPrePack {
+    OpKernel* kernel;
+    int input_idx;
+    const Tensor* tensor;
+    SessionState* session_state;
+    int ort_value_idx;
+    const std::string* input_name;
+    bool is_packed;
+  };
+
   auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
-                                        bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
+                                        bool should_cache_prepacked_weights_for_shared_initializers,
+                                        std::vector<DeferredPrePack>* deferred_prepacks) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
       int input_idx = 0;
@@ -419,63 +555,99 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                 auto iter = initializers_to_share_map.find(input_name);
                 bool is_shared_initializer = (iter != initializers_to_share_map.end());
 
-                // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
-                if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+                // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now,
+                // unless the pre-packed weights are shared with other processes through a file
+                if ((is_shared_initializer || cache_all_prepacked_weights_) &&
+                    should_cache_prepacked_weights_for_shared_initializers &&
                     node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
 
                   AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
                   ORT_ENFORCE(allocator_for_caching.get() != nullptr);
 
-                  PrePackedWeights weights_to_be_filled_in;
-                  // The reason we invoke PrePack() before looking into the container for any pre-packed weight
-                  // cached by another instance of the same op_type (for the same constant initializer) is because
-                  // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
-                  // weight with the pre-packed weight generated by this instance of the same op_type because other static
-                  // properties of the node like node attributes could play a role in the pre-packed weights' contents.
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
-                                                      is_packed,
-                                                      &weights_to_be_filled_in));
-
-                  if (is_packed) {
-                    // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
-                    ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
-                                " doesn't have an implementation that can cache computed pre-packed weights");
-
-                    const auto& op_type = node.OpType();
-
-                    // Sanity check
-                    // TODO: Check if some version of the ONNX IR allows op_type to be empty
-                    ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
-
-                    // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
-                    // that we just got by invoking PrePack() on this kernel.
-
-                    const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
-                                                                                                           weights_to_be_filled_in);
-
-                    bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
-
-                    if (container_contains_packed_weight) {
-                      LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
-                                          << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
-
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-
-                      ++used_shared_pre_packed_weights_counter_;
-                    } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
-
-                      if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
-                        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
+                  // The pre-packed weight of the kernel input may have been persisted by a previous session, in
+                  // which case PrePack() is skipped if the kernel supports it
+                  std::string kernel_input_key;
+                  if (cache_all_prepacked_weights_ && kernel->CanSkipPrePackWithPersistedBuffers(input_idx)) {
+                    kernel_input_key = GenerateKernelInputKeyForPrepackedWeights(node, input_idx,
+                                                                                 const_initialized_tensor);
+                  }
+                  const std::string* persisted_weight_key =
+                      kernel_input_key.empty() ? nullptr
+                                               : prepacked_weights_container_->GetKeyForKernelInput(kernel_input_key);
+
+                  if (persisted_weight_key != nullptr) {
+                    LOGS(logger_, INFO) << "Using persisted pre-packed weight for constant initializer: " << input_name
+                                        << " used in the node: " << node.Name() << " which is of op type: "
+                                        << node.OpType();
+
+                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(
+                        *kernel, input_idx, prepacked_weights_container_->GetWeight(*persisted_weight_key),
+                        node.Name()));
+
+                    is_packed = true;
+                    ++used_shared_pre_packed_weights_counter_;
+                    ++skipped_prepacks_counter_;
+                  } else {
+                    PrePackedWeights weights_to_be_filled_in;
+                    // The reason we invoke PrePack() before looking into the container for any pre-packed weight
+                    // cached by another instance of the same op_type (for the same constant initializer) is because
+                    // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
+                    // weight with the pre-packed weight generated by this instance of the same op_type because other static
+                    // properties of the node like node attributes could play a role in the pre-packed weights' contents.
+                    ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
+                                                        is_packed,
+                                                        &weights_to_be_filled_in));
+
+                    if (is_packed) {
+                      // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
+                      ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
+                                  " doesn't have an implementation that can cache computed pre-packed weights");
+
+                      const auto& op_type = node.OpType();
+
+                      // Sanity check
+                      // TODO: Check if some version of the ONNX IR allows op_type to be empty
+                      ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
+
+                      // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
+                      // that we just got by invoking PrePack() on this kernel.
+
+                      const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
+                                                                                                             weights_to_be_filled_in);
+
+                      bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
+
+                      if (container_contains_packed_weight) {
+                        LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
+                                            << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
+
+                        ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                            prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                            node.Name()));
+
+                        ++used_shared_pre_packed_weights_counter_;
+                      } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
+
+                        if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
+                          return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
+                        }
+
+                        ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
+                                                                            prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                                                            node.Name()));
                       }
 
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
+                      // record the weight for the kernel input so that later sessions can skip PrePack()
+                      if (!kernel_input_key.empty()) {
+                        prepacked_weights_container_->WriteKernelInputKey(kernel_input_key,
+                                                                          prepacked_weights_container_key);
+                      }
                     }
                   }
 
+                } else if (deferred_prepacks != nullptr) {  // caching of pre-packed weights' turned OFF, in parallel
+                  deferred_prepacks->push_back(DeferredPrePack{kernel, input_idx, &const_initialized_tensor, st,
+                                                               ort_value_idx, &input_name, false});
                 } else {  // caching of pre-packed weights' turned OFF
                   AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
                   ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
@@ -517,16 +689,86 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
     // serialize calls to the method that looks up the container, calls UseCachedPrePackedWeight/PrePack
     // and writes pre-packed weights to the container
     std::lock_guard<onnxruntime::OrtMutex> l(prepacked_weights_container_->mutex_);
-    return prepacked_constant_weights(true);
-  } else {
-    return prepacked_constant_weights(false);
+    return prepacked_constant_weights(true, nullptr);
+  } else if (!enable_parallel_initialization_) {
+    return prepacked_constant_weights(false, nullptr);
+  }
+
+  // collect the PrePack() calls, run the calls of different kernels in parallel, and release the packed constant
+  // initializers afterwards. the calls of a kernel run sequentially in input order as a kernel may pack several of
+  // its inputs into the same buffer.
+  std::vector<DeferredPrePack> deferred_prepacks;
+  ORT_RETURN_IF_ERROR(prepacked_constant_weights(false, &deferred_prepacks));
+
+  InlinedVector<std::pair<size_t, size_t>> kernel_ranges;  // [begin, end) in deferred_prepacks for each kernel
+  for (size_t i = 0; i < deferred_prepacks.size(); ++i) {
+    if (kernel_ranges.empty() || deferred_prepacks[kernel_ranges.back().first].kernel != deferred_prepacks[i].kernel) {
+      kernel_ranges.emplace_back(i, i + 1);
+    } else {
+      kernel_ranges.back().second = i + 1;
+    }
   }
+
+  std::vector<Status> statuses(kernel_ranges.size());
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool_, static_cast<std::ptrdiff_t>(kernel_ranges.size()), [&](std::ptrdiff_t range_idx) {
+        ORT_TRY {
+          for (size_t i = kernel_ranges[range_idx].first; i < kernel_ranges[range_idx].second; ++i) {
+            auto& prepack = deferred_prepacks[i];
+            AllocatorPtr session_cpu_alloc =
+                GetAllocator(prepack.kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+            statuses[range_idx] = prepack.kernel->PrePack(*prepack.tensor, prepack.input_idx,
+                                                          session_cpu_alloc,  // use allocator tied to this session
+                                                          prepack.is_packed,
+                                                          nullptr  // no caching required
+            );
+            if (!statuses[range_idx].IsOK()) {
+              break;
+            }
+          }
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            statuses[range_idx] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "PrePack failed for node ",
+                                                  deferred_prepacks[kernel_ranges[range_idx].first].kernel->Node().Name(),
+                                                  ": ", ex.what());
+          });
+        }
+      });
+  for (const auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  for (const auto& prepack : deferred_prepacks) {
+    if (prepack.is_packed) {
+      ++number_of_prepacks_counter_;
+
+      const std::string& input_name = *prepack.input_name;
+      if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
+        // release the constant initialized tensor
+        prepack.session_state->initialized_tensors_.erase(prepack.ort_value_idx);
+        prepack.session_state->constant_initialized_tensors_.erase(prepack.ort_value_idx);
+      }
+    }
+  }
+
+  return Status::OK();
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
+// The signature holds the rank of each input followed by its dims, so that different input shapes never share
+// a memory pattern. The returned key is the hash of the signature.
+static size_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs,
+                                         InlinedVector<int64_t>& signature) {
+  signature.clear();
+  size_t key = 0;
   for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    signature.push_back(static_cast<int64_t>(dims.size()));
+    HashCombine(dims.size(), key);
+    for (auto dim : dims) {
+      signature.push_back(dim);
+      HashCombine(dim, key);
+    }
   }
   return key;
 }
@@ -765,41 +1007,87 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
+const SessionState::MemoryPatternCacheEntry* SessionState::FindMemoryPatternCacheEntry(
+    size_t key, const MemoryPatternsSignature& signature) const {
+  auto it = mem_patterns_index_.find(key);
+  if (it == mem_patterns_index_.end() || it->second->signature != signature) {
+    return nullptr;
+  }
+  mem_patterns_.splice(mem_patterns_.begin(), mem_patterns_, it->second);
+  return &*it->second;
+}
+
+const SessionState::MemoryPatternCacheEntry& SessionState::InsertMemoryPatternCacheEntry(
+    MemoryPatternCacheEntry entry) const {
+  const size_t key = entry.key;
+  auto it = mem_patterns_index_.find(key);
+  if (it != mem_patterns_index_.end()) {
+    if (it->second->signature == entry.signature) {
+      // Do not update if present, as another run may have generated it concurrently.
+      return *it->second;
+    }
+    // Hash collision of different signatures. Keep the most recent one.
+    mem_patterns_.erase(it->second);
+    mem_patterns_index_.erase(it);
+  }
+
+  mem_patterns_.push_front(std::move(entry));
+  mem_patterns_index_.emplace(key, mem_patterns_.begin());
+
+  while (mem_patterns_cache_capacity_ > 0 && mem_patterns_.size() > mem_patterns_cache_capacity_) {
+    // Frames using the evicted entry share ownership of its values, so it can be released here.
+    mem_patterns_index_.erase(mem_patterns_.back().key);
+    mem_patterns_.pop_back();
+  }
+
+  return mem_patterns_.front();
+}
+
+// MemoryPatternGroup is cached. It only inserted upon creation
 // and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>>& out_inferred_shapes) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  MemoryPatternsSignature signature;
+  const size_t key = CalculateMemoryPatternsKey(tensor_inputs, signature);
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+  const auto* entry = FindMemoryPatternCacheEntry(key, signature);
+  if (entry == nullptr) {
 #ifdef ENABLE_TRAINING
     MemoryPatternGroup mem_patterns;
     InlinedHashMap<int, TensorShape> inferred_shapes;
     if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+      const auto& inserted = InsertMemoryPatternCacheEntry(MemoryPatternCacheEntry{
+          key, std::move(signature),
+          std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns)),
+          std::make_shared<const InlinedHashMap<int, TensorShape>>(std::move(inferred_shapes))});
+      out_inferred_shapes = inserted.inferred_shapes;
+      return inserted.mem_patterns;
     }
-#else
-    ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
 #endif
+    if (symbolic_mem_pattern_) {
+      MemoryPatternGroup mem_patterns;
+      if (symbolic_mem_pattern_->Instantiate(tensor_inputs, feed_mlvalue_idxs, mem_patterns).IsOK()) {
+        const auto& inserted = InsertMemoryPatternCacheEntry(MemoryPatternCacheEntry{
+            key, std::move(signature), std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns)), nullptr});
+        return inserted.mem_patterns;
+      }
+    }
     return nullptr;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
-  }
-  return &it->second;
+  out_inferred_shapes = entry->inferred_shapes;
+  return entry->mem_patterns;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
+  // a subgraph session state that is finalized lazily resolves the flag once it is finalized
+  if (!p_seq_exec_plan_.has_value()) {
+    return;
+  }
+
   if (enable_mem_pattern_) {
     for (auto* input : graph_viewer_->GetInputs()) {
       if (!input->HasTensorOrScalarShape()) {
@@ -847,11 +1135,46 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  MemoryPatternsSignature signature;
+  const size_t key = CalculateMemoryPatternsKey(tensor_inputs, signature);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  InsertMemoryPatternCacheEntry(MemoryPatternCacheEntry{
+      key, std::move(signature), std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns)), nullptr});
+  return Status::OK();
+}
+
+bool SessionState::NeedsSymbolicMemoryPattern() const {
+  if (!enable_symbolic_mem_patterns_) {
+    return false;
+  }
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  return !symbolic_mem_pattern_attempted_;
+}
+
+Status SessionState::UpdateSymbolicMemoryPattern(gsl::span<const OrtValue> tensor_inputs,
+                                                 gsl::span<const int> feed_mlvalue_idxs,
+                                                 gsl::span<const MemoryPatternTraceEvent> trace) const {
+  if (!enable_symbolic_mem_patterns_) {
+    return Status::OK();
+  }
+  {
+    // Only the first traced run creates the pattern. If it fails, e.g. as the graph has no symbolic dimensions,
+    // the following runs do not try again.
+    std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+    if (symbolic_mem_pattern_attempted_) {
+      return Status::OK();
+    }
+    symbolic_mem_pattern_attempted_ = true;
+  }
+
+  std::unique_ptr<const SymbolicMemoryPattern> pattern;
+  ORT_RETURN_IF_ERROR(SymbolicMemoryPattern::Create(*this, tensor_inputs, feed_mlvalue_idxs, trace, pattern));
+  LOGS(logger_, VERBOSE) << "Created a symbolic memory pattern planning " << pattern->NumPlannedValues()
+                         << " values";
+
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  symbolic_mem_pattern_ = std::move(pattern);
   return Status::OK();
 }
 
@@ -1051,6 +1374,13 @@ Status SessionState::CreateSubgraphSessionState() {
 
       // Pass fused function manager to subgraph
       subgraph_session_state->fused_funcs_mgr_.SetFusedFuncs(fused_funcs_mgr_);
+      // Aggregate the node overhead of subgraphs with the parent graph
+      subgraph_session_state->node_overhead_stats_ = node_overhead_stats_;
+      // Subgraphs are timed as a whole by the node containing them in sampled runs
+      subgraph_session_state->sampled_profiler_.reset();
+      // The tensors of the subgraphs are collected with those of the parent graph
+      subgraph_session_state->tensor_statistics_ = tensor_statistics_;
+      subgraph_session_state->denormal_as_zero_op_types_ = denormal_as_zero_op_types_;
 
       // recurse
       ORT_RETURN_IF_ERROR(subgraph_session_state->CreateSubgraphSessionState());
@@ -1172,10 +1502,77 @@ static Status VerifyEachNodeIsAssignedToAnEp(const Graph& graph, const logging::
   return Status::OK();
 }
 
+// The kernels which keep their accuracy when denormal inputs and results are flushed to zero:
+// GEMM, convolutions, recurrent networks and activations.
+static const std::string_view kDenormalAsZeroAutoOpTypes[] = {
+    "Gemm", "MatMul", "FusedGemm", "FusedMatMul", "Conv", "FusedConv", "NhwcFusedConv", "ConvTranspose",
+    "LSTM", "GRU", "RNN", "AttnLSTM", "Relu", "LeakyRelu", "Sigmoid", "Tanh", "Gelu", "FastGelu",
+    "QuickGelu", "BiasGelu", "Softplus", "Elu"};
+
+// Number of denormal values of a float initializer, if its data is in the model.
+static size_t CountDenormals(const ONNX_NAMESPACE::TensorProto& tensor) {
+  if (tensor.data_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+      utils::HasExternalData(tensor)) {
+    return 0;
+  }
+
+  size_t count = 0;
+  if (utils::HasRawData(tensor)) {
+    const std::string& raw_data = tensor.raw_data();
+    for (size_t i = 0; i + sizeof(float) <= raw_data.size(); i += sizeof(float)) {
+      float value;
+      memcpy(&value, raw_data.data() + i, sizeof(float));
+      count += std::fpclassify(value) == FP_SUBNORMAL ? 1 : 0;
+    }
+  } else {
+    for (float value : tensor.float_data()) {
+      count += std::fpclassify(value) == FP_SUBNORMAL ? 1 : 0;
+    }
+  }
+  return count;
+}
+
+void SessionState::SetupDenormalAsZeroOpTypes() {
+  const std::string op_types =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDenormalAsZeroOpTypes, "");
+  if (op_types.empty() ||
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSetDenormalAsZero, "0") == "1") {
+    return;
+  }
+
+  auto selected = std::make_shared<InlinedHashSet<std::string>>();
+  if (op_types == "auto") {
+    size_t num_initializers = 0;
+    size_t num_denormals = 0;
+    for (const auto& [name, tensor] : graph_viewer_->GetAllInitializedTensors()) {
+      const size_t denormals = CountDenormals(*tensor);
+      num_initializers += denormals != 0 ? 1 : 0;
+      num_denormals += denormals;
+    }
+    if (num_denormals == 0) {
+      LOGS(logger_, INFO) << "No float initializer holds denormals, flush-to-zero is not applied to any kernel.";
+      return;
+    }
+
+    LOGS(logger_, INFO) << num_initializers << " float initializers hold " << num_denormals
+                        << " denormal values, flush-to-zero is applied to the GEMM, convolution, recurrent "
+                        << "and activation kernels.";
+    selected->insert(std::begin(kDenormalAsZeroAutoOpTypes), std::end(kDenormalAsZeroAutoOpTypes));
+  } else {
+    for (const auto op_type : utils::SplitString(op_types, ",")) {
+      selected->emplace(op_type);
+    }
+  }
+
+  denormal_as_zero_op_types_ = std::move(selected);
+}
+
 Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE>& graph_location,
                                           const KernelRegistryManager& kernel_registry_manager,
                                           bool remove_initializers,
                                           bool saving_ort_format) {
+  SetupDenormalAsZeroOpTypes();
+
   // recursively create the subgraph session state instances and populate the kernel create info in them.
   // it's simpler to handle the kernel create info recursively when deserializing,
   // so also do it recursively when calling PopulateKernelCreateInfo for consistency.
@@ -1376,9 +1773,20 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  ExecutionOrder execution_order = session_options.execution_order;
+  if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryMinimizingExecutionOrder,
+                                                        "0") == "1") {
+    execution_order = ExecutionOrder::MEMORY_MINIMIZING;
+  }
+
   SequentialPlannerContext context(session_options.execution_mode,
-                                   session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   execution_order,
+                                   session_options.enable_mem_reuse,
+                                   session_options.config_options.GetConfigOrDefault(
+                                       kOrtSessionOptionsConfigEnableElementwiseInplace, "1") == "1",
+                                   static_cast<size_t>(std::max<int64_t>(1, std::stoll(
+                                       session_options.config_options.GetConfigOrDefault(
+                                           kOrtSessionOptionsConfigMaxStreamsPerDevice, "1")))));
 
 #ifdef _WIN32
 
@@ -1407,6 +1815,17 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                               p_seq_exec_plan_);
   ORT_RETURN_IF_ERROR(status);
 
+#if !defined(ORT_MINIMAL_BUILD)
+  if (execution_order == ExecutionOrder::MEMORY_MINIMIZING) {
+    LOGS(logger_, INFO) << "Estimated peak activation memory of " << graph_viewer_->Name() << ": "
+                        << EstimatePeakActivationMemory(*graph_viewer_,
+                                                        graph_viewer_->GetNodesInTopologicalOrder(execution_order))
+                        << " bytes with the memory minimizing execution order, "
+                        << EstimatePeakActivationMemory(*graph_viewer_, graph_viewer_->GetNodesInTopologicalOrder())
+                        << " bytes with the default execution order";
+  }
+#endif
+
   // Record the allocation plan
 
   // Uncomment the below to dump the allocation plan to std::cout
@@ -1477,6 +1896,15 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
           GetAllocator(OrtDevice()),
+          [this](const OrtDevice& device) -> AllocatorPtr {
+            // the host memory the execution provider of the device copies from directly, e.g. pinned memory
+            for (const auto& ep : execution_providers_) {
+              if (ep->GetOrtDeviceByMemType(OrtMemTypeDefault) == device) {
+                return GetAllocator(ep->GetOrtDeviceByMemType(OrtMemTypeCPUOutput));
+              }
+            }
+            return nullptr;
+          },
           ort_value_name_idx_map_, initializer_allocation_order, *tensor_allocator,
           [this, remove_initializers](const std::string& name, int idx, const OrtValue& value, const OrtCallback& d,
                                       bool constant, bool sparse) -> Status {
@@ -1520,49 +1948,139 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   for (const auto& node_to_subgraph_ss : subgraph_session_states_) {
     Node& node = *graph_.GetNode(node_to_subgraph_ss.first);
 
-    for (const auto& attr_subgraph_pair : node.GetAttributeNameToMutableSubgraphMap()) {
-      auto& attr_name = attr_subgraph_pair.first;
-      auto entry = node_to_subgraph_ss.second.find(attr_name);
-      // CreateSubgraphSessionState should ensure all these entries are created
-      ORT_ENFORCE(entry != node_to_subgraph_ss.second.cend(),
-                  "Missing session state for subgraph. Node:'", node.Name(),
-                  "' OpType:", node.OpType(), " Index:", node.Index(), " Attribute:", attr_name);
+    if (enable_lazy_subgraph_initialization_) {
+      // finalized by EnsureSubgraphSessionStatesFinalized on the first execution of the node
+      lazy_subgraph_finalization_states_.emplace(node.Index(), std::make_unique<LazySubgraphFinalizationState>());
+      continue;
+    }
 
-      SessionState& subgraph_session_state = *entry->second;
+    ORT_RETURN_IF_ERROR(FinalizeSubgraphSessionStates(node, graph_location, kernel_registry_manager,
+                                                      subgraph_session_options, remove_initializers,
+                                                      constant_initializers_use_count));
+  }
 
-      // recurse
+  if (!lazy_subgraph_finalization_states_.empty()) {
+    lazy_subgraph_finalization_info_ = std::make_unique<LazySubgraphFinalizationInfo>(LazySubgraphFinalizationInfo{
+        graph_location, &kernel_registry_manager, subgraph_session_options, remove_initializers});
+  }
 
-      // We need to create graph info for the subgraphs because information accumulated there
-      // is used in OuterScopeNodeArgLocationAccumulator()
-      subgraph_session_state.CreateGraphInfo();
-
-      InlinedHashMap<OrtValueName, OrtDevice> subgraph_outer_scope_node_arg_to_location_map;
-      ORT_RETURN_IF_ERROR(OuterScopeNodeArgLocationAccumulator(*p_seq_exec_plan_, GetOrtValueNameIdxMap(),
-                                                               node,
-                                                               subgraph_session_state.GetGraphViewer(),
-                                                               subgraph_outer_scope_node_arg_to_location_map));
-      ORT_RETURN_IF_ERROR(subgraph_session_state.FinalizeSessionStateImpl(
-          graph_location, kernel_registry_manager, &node, subgraph_session_options, remove_initializers,
-          constant_initializers_use_count, subgraph_outer_scope_node_arg_to_location_map, true));
-
-      // setup all the info for handling the feeds and fetches used in subgraph execution
-      auto* p_op_kernel = GetMutableKernel(node.Index());
-      ORT_ENFORCE(p_op_kernel);
-
-      // Downcast is safe, since only control flow nodes have subgraphs
-      // (node.GetAttributeNameToMutableSubgraphMap() is non-empty)
-      auto& control_flow_kernel = static_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
-      ORT_RETURN_IF_ERROR(control_flow_kernel.SetupSubgraphExecutionInfo(*this, attr_name, subgraph_session_state));
-    }
+  return Status::OK();
+}
 
-    // TODO: Once the subgraph session states have been finalized, can we go back and plan the location of implicit
-    // inputs that are fed through as graph inputs in the graph level holding the subgraphs ? Ideally the planned
-    // locations for these would be the locations they are explicitly consumed on in nested subgraphs.
+Status SessionState::FinalizeSubgraphSessionStates(Node& node,
+                                                   const std::basic_string<PATH_CHAR_TYPE>& graph_location,
+                                                   const KernelRegistryManager& kernel_registry_manager,
+                                                   const SessionOptions& subgraph_session_options,
+                                                   bool remove_initializers,
+                                                   InlinedHashMap<std::string, size_t>& constant_initializers_use_count) {
+  const auto& node_to_subgraph_ss = *subgraph_session_states_.find(node.Index());
+  for (const auto& attr_subgraph_pair : node.GetAttributeNameToMutableSubgraphMap()) {
+    auto& attr_name = attr_subgraph_pair.first;
+    auto entry = node_to_subgraph_ss.second.find(attr_name);
+    // CreateSubgraphSessionState should ensure all these entries are created
+    ORT_ENFORCE(entry != node_to_subgraph_ss.second.cend(),
+                "Missing session state for subgraph. Node:'", node.Name(),
+                "' OpType:", node.OpType(), " Index:", node.Index(), " Attribute:", attr_name);
+
+    SessionState& subgraph_session_state = *entry->second;
+
+    // recurse
+
+    // We need to create graph info for the subgraphs because information accumulated there
+    // is used in OuterScopeNodeArgLocationAccumulator()
+    subgraph_session_state.CreateGraphInfo();
+
+    InlinedHashMap<OrtValueName, OrtDevice> subgraph_outer_scope_node_arg_to_location_map;
+    ORT_RETURN_IF_ERROR(OuterScopeNodeArgLocationAccumulator(*p_seq_exec_plan_, GetOrtValueNameIdxMap(),
+                                                             node,
+                                                             subgraph_session_state.GetGraphViewer(),
+                                                             subgraph_outer_scope_node_arg_to_location_map));
+    ORT_RETURN_IF_ERROR(subgraph_session_state.FinalizeSessionStateImpl(
+        graph_location, kernel_registry_manager, &node, subgraph_session_options, remove_initializers,
+        constant_initializers_use_count, subgraph_outer_scope_node_arg_to_location_map, true));
+
+    // setup all the info for handling the feeds and fetches used in subgraph execution
+    auto* p_op_kernel = GetMutableKernel(node.Index());
+    ORT_ENFORCE(p_op_kernel);
+
+    // Downcast is safe, since only control flow nodes have subgraphs
+    // (node.GetAttributeNameToMutableSubgraphMap() is non-empty)
+    auto& control_flow_kernel = static_cast<controlflow::IControlFlowKernel&>(*p_op_kernel);
+    ORT_RETURN_IF_ERROR(control_flow_kernel.SetupSubgraphExecutionInfo(*this, attr_name, subgraph_session_state));
   }
 
+  // TODO: Once the subgraph session states have been finalized, can we go back and plan the location of implicit
+  // inputs that are fed through as graph inputs in the graph level holding the subgraphs ? Ideally the planned
+  // locations for these would be the locations they are explicitly consumed on in nested subgraphs.
+
   return Status::OK();
 }
 
+Status SessionState::EnsureSubgraphSessionStatesFinalized(NodeIndex index) const {
+  auto entry = lazy_subgraph_finalization_states_.find(index);
+  if (entry == lazy_subgraph_finalization_states_.cend()) {
+    return Status::OK();
+  }
+
+  auto& state = *entry->second;
+  std::call_once(state.once, [this, index, &state]() {
+    // the kernel of the node and the subgraph session states are only modified here, before the node is executed
+    auto& session_state = const_cast<SessionState&>(*this);
+    Node& node = *session_state.graph_.GetNode(index);
+    const auto& info = *lazy_subgraph_finalization_info_;
+
+    // only the initializers of the subgraphs can be released once pre-packed. the initializers of the outer scope
+    // are still used by this graph, which was pre-packed with use counts that included the uses in the subgraphs.
+    InlinedHashMap<std::string, size_t> constant_initializers_use_count;
+    for (const gsl::not_null<const Graph*>& subgraph : node.GetSubgraphs()) {
+      ComputeConstantInitializerUseCount(*subgraph, constant_initializers_use_count);
+    }
+    for (auto it = constant_initializers_use_count.begin(); it != constant_initializers_use_count.end();) {
+      const auto& subgraphs = node.GetSubgraphs();
+      const bool is_subgraph_initializer =
+          std::any_of(subgraphs.begin(), subgraphs.end(), [&it](const gsl::not_null<const Graph*>& subgraph) {
+            return subgraph->GetConstantInitializer(it->first, false /*check_outer_scope*/) != nullptr;
+          });
+      if (is_subgraph_initializer) {
+        ++it;
+      } else {
+        it = constant_initializers_use_count.erase(it);
+      }
+    }
+
+    LOGS(logger_, VERBOSE) << "Finalizing the subgraph session states of node " << node.Name()
+                           << " on its first execution.";
+    state.status = session_state.FinalizeSubgraphSessionStates(node, info.graph_location,
+                                                               *info.kernel_registry_manager,
+                                                               info.subgraph_session_options,
+                                                               info.remove_initializers,
+                                                               constant_initializers_use_count);
+    if (state.status.IsOK()) {
+      for (const auto& name_to_subgraph_session_state : subgraph_session_states_.at(index)) {
+        name_to_subgraph_session_state.second->ResolveMemoryPatternFlag();
+      }
+    }
+  });
+
+  return state.status;
+}
+
+InlinedVector<OrtValue> SessionState::AcquireFrameValues() const {
+  std::lock_guard<onnxruntime::OrtMutex> lock(frame_values_pool_mutex_);
+  if (frame_values_pool_.empty()) {
+    return {};
+  }
+
+  auto values = std::move(frame_values_pool_.back());
+  frame_values_pool_.pop_back();
+  return values;
+}
+
+void SessionState::RecycleFrameValues(InlinedVector<OrtValue> values) const {
+  std::lock_guard<onnxruntime::OrtMutex> lock(frame_values_pool_mutex_);
+  frame_values_pool_.push_back(std::move(values));
+}
+
 #ifdef ORT_ENABLE_STREAM
 static void BindToDeviceStream(const SequentialExecutionPlan& execution_plan,
                                DeviceStreamCollection& device_stream_map,
@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -27,10 +29,14 @@
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/node_overhead_stats.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/sampled_profiler.h"
+#include "core/framework/symbolic_mem_pattern.h"
+#include "core/framework/tensor_statistics.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/platform/ort_mutex.h"
@@ -219,11 +225,13 @@ class SessionState {
   made under mutex being held. In inference scenarios,
   it is not mutable, we do not obtain a lock and simply get a pointer
   w/o copying a hashtable
+  The returned values are shared with the cache, so they stay valid if the entry is evicted
+  while the caller still uses them.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      std::shared_ptr<const InlinedHashMap<int, TensorShape>>& inferred_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -233,8 +241,44 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Whether the symbolic memory pattern is enabled and not attempted yet, so that the execution frames generating
+  memory patterns shall record the trace it is created from.
+  */
+  bool NeedsSymbolicMemoryPattern() const;
+
+  /**
+  Create the symbolic memory pattern from the trace of a run with the given feeds, if it was not attempted yet.
+  Memory patterns for new input shapes are then instantiated from it by GetMemoryPatternGroup.
+  */
+  Status UpdateSymbolicMemoryPattern(gsl::span<const OrtValue> tensor_inputs,
+                                     gsl::span<const int> feed_mlvalue_idxs,
+                                     gsl::span<const MemoryPatternTraceEvent> trace) const;
+
+  /**
+  Get the storage of the OrtValues of an execution frame, which is reused across the runs so that the frame of a
+  small model run at a high rate does not allocate it every time. It is empty, with the capacity of a previous frame.
+  */
+  InlinedVector<OrtValue> AcquireFrameValues() const;
+
+  // Return the storage of the OrtValues of an execution frame once they have been released.
+  void RecycleFrameValues(InlinedVector<OrtValue> values) const;
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
+  // Per op type time spent in each phase of node execution. nullptr if it is not enabled.
+  NodeOverheadStats* GetNodeOverheadStats() const { return node_overhead_stats_.get(); }
+
+  // Profiler of one in N runs of the main graph. nullptr if it is not enabled or for a subgraph.
+  SampledProfiler* GetSampledProfiler() const { return sampled_profiler_.get(); }
+
+  // Statistics of the float tensors produced by the nodes, shared with the subgraphs. nullptr if it is not enabled.
+  TensorStatistics* GetTensorStatistics() const { return tensor_statistics_.get(); }
+
+  // Op types of the CPU kernels run with flush-to-zero and denormal-as-zero, shared with the subgraphs.
+  // nullptr if there is none. See kOrtSessionOptionsConfigDenormalAsZeroOpTypes.
+  const InlinedHashSet<std::string>* GetDenormalAsZeroOpTypes() const { return denormal_as_zero_op_types_.get(); }
+
   /**
   Get enable memory pattern flag
   */
@@ -287,6 +331,11 @@ class SessionState {
   /// Return SessionState for the given Node index and attribute name if found.
   const SessionState* GetSubgraphSessionState(NodeIndex index, const std::string& attribute_name) const;
 
+  /// Finalize the subgraph session states of the node if their finalization was deferred until the first execution
+  /// of the node by kOrtSessionOptionsConfigEnableLazySubgraphInitialization. Thread-safe. Does nothing if the
+  /// subgraph session states of the node are already finalized or if the node has no subgraphs.
+  Status EnsureSubgraphSessionStatesFinalized(NodeIndex index) const;
+
   concurrency::ThreadPool* GetThreadPool() const noexcept { return thread_pool_; }
   concurrency::ThreadPool* GetInterOpThreadPool() const noexcept { return inter_op_thread_pool_; }
 
@@ -324,6 +373,10 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetSkippedPrePacksCounter() const {
+    return skipped_prepacks_counter_;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -379,6 +432,9 @@ class SessionState {
 
   Status CreateSubgraphSessionState();
 
+  // Select the op types of the kernels run with flush-to-zero and denormal-as-zero from the session options.
+  void SetupDenormalAsZeroOpTypes();
+
   void AddSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name,
                                std::unique_ptr<SessionState> session_state);
 
@@ -394,6 +450,14 @@ class SessionState {
                                   const InlinedHashMap<OrtValueName, OrtDevice>& outer_scope_node_arg_to_location_map = {},
                                   bool graph_info_already_created = false);
 
+  // Finalize the session states of the subgraphs of the node, and setup the execution info of its kernel.
+  Status FinalizeSubgraphSessionStates(Node& node,
+                                       const std::basic_string<PATH_CHAR_TYPE>& graph_location,
+                                       const KernelRegistryManager& kernel_registry_manager,
+                                       const SessionOptions& subgraph_session_options,
+                                       bool remove_initializers,
+                                       InlinedHashMap<std::string, size_t>& constant_initializers_use_count);
+
 #ifdef ENABLE_TRAINING
   Status GeneratePatternGroupCache(
       gsl::span<const OrtValue> inputs,
@@ -484,18 +548,55 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
+  // Rank and dims of all the inputs a memory pattern was generated for.
+  using MemoryPatternsSignature = InlinedVector<int64_t>;
+
+  struct MemoryPatternCacheEntry {
+    // hash of the signature.
+    size_t key;
+    MemoryPatternsSignature signature;
+    std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+    // Only generated in training scenarios.
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes;
+  };
+
+  using MemoryPatternCacheList = std::list<MemoryPatternCacheEntry>;
+
+  // Find the entry for the signature, and mark it as most recently used. mem_patterns_lock_ must be held.
+  const MemoryPatternCacheEntry* FindMemoryPatternCacheEntry(size_t key,
+                                                             const MemoryPatternsSignature& signature) const;
+  // Insert an entry if none is present for the signature, evicting the least recently used entries
+  // beyond mem_patterns_cache_capacity_. mem_patterns_lock_ must be held.
+  const MemoryPatternCacheEntry& InsertMemoryPatternCacheEntry(MemoryPatternCacheEntry entry) const;
+
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  // cache for the generated mem_patterns in most recently used order, indexed by the hash of their signatures.
+  mutable MemoryPatternCacheList mem_patterns_;
+  mutable InlinedHashMap<size_t, MemoryPatternCacheList::iterator> mem_patterns_index_;
+  // max number of entries in mem_patterns_. 0 if unbounded.
+  size_t mem_patterns_cache_capacity_ = 0;
+  // whether memory patterns for new input shapes are instantiated from symbolic_mem_pattern_.
+  bool enable_symbolic_mem_patterns_ = false;
+  // created from the first traced run. guarded by mem_patterns_lock_.
+  mutable std::unique_ptr<const SymbolicMemoryPattern> symbolic_mem_pattern_;
+  mutable bool symbolic_mem_pattern_attempted_ = false;
+
+  // lock for the frame_values_pool_
+  mutable OrtMutex frame_values_pool_mutex_;
+  // storage of the OrtValues of the execution frames not in use, at most one per concurrent run.
+  mutable std::vector<InlinedVector<OrtValue>> frame_values_pool_;
+
+  // Shared with the subgraph session states.
+  std::shared_ptr<NodeOverheadStats> node_overhead_stats_;
+
+  std::unique_ptr<SampledProfiler> sampled_profiler_;
+
+  // Shared with the subgraph session states.
+  std::shared_ptr<TensorStatistics> tensor_statistics_;
+
+  // Shared with the subgraph session states.
+  std::shared_ptr<const InlinedHashSet<std::string>> denormal_as_zero_op_types_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -518,6 +619,34 @@ class SessionState {
   // prepacked_weights_container_ can be nullptr if no caching is required for prepacked weights
   PrepackedWeightsContainer* const prepacked_weights_container_{};
 
+  // Cache the pre-packed weights of all constant initializers in prepacked_weights_container_, not only those of
+  // the shared initializers, as they are shared with other processes through kOrtSessionOptionsConfigPrepackedWeightsFile.
+  bool cache_all_prepacked_weights_ = false;
+
+  // Create the kernels of the CPU EP and pre-pack the weights of different kernels in parallel on thread_pool_.
+  bool enable_parallel_initialization_ = false;
+
+  // Defer the finalization of subgraph session states until the first execution of their node.
+  bool enable_lazy_subgraph_initialization_ = false;
+
+  // What FinalizeSubgraphSessionStates() needs when the subgraph session states are finalized lazily.
+  struct LazySubgraphFinalizationInfo {
+    std::basic_string<PATH_CHAR_TYPE> graph_location;
+    const KernelRegistryManager* kernel_registry_manager;
+    SessionOptions subgraph_session_options;
+    bool remove_initializers;
+  };
+
+  struct LazySubgraphFinalizationState {
+    std::once_flag once;
+    Status status;
+  };
+
+  std::unique_ptr<LazySubgraphFinalizationInfo> lazy_subgraph_finalization_info_;
+  // Nodes whose subgraph session states are finalized lazily. The map is not modified after the session state is
+  // finalized, so it can be read concurrently.
+  InlinedHashMap<NodeIndex, std::unique_ptr<LazySubgraphFinalizationState>> lazy_subgraph_finalization_states_;
+
 #ifdef ENABLE_TRAINING
 // Needed for ORTTrainer. Should be removed along with ORTTrainer code
 #ifndef DISABLE_ABSEIL
@@ -548,6 +677,10 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times PrePack() was skipped because the pre-packed weight of the kernel input was
+  // persisted in the pre-packed weights container by a previous session
+  size_t skipped_prepacks_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
@@ -1,8 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <functional>
 #include <limits>
+#include <sstream>
 #include <utility>
 
 #include <core/common/status.h>
@@ -11,6 +13,7 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/framework/session_state_utils.h"
 #include "core/common/common.h"
+#include "core/common/cpuid_info.h"
 #include "core/common/logging/logging.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/data_transfer_manager.h"
@@ -29,6 +32,7 @@
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
 #include "core/framework/memory_info.h"
 #endif
+#include "onnxruntime_config.h"
 
 namespace onnxruntime {
 namespace session_state_utils {
@@ -93,9 +97,45 @@ static inline common::Status ExtDataTensorProtoToTensor(const Env& env,
   return common::Status::OK();
 }
 
+#if !defined(__wasm__)
+// Size of the chunks in which external data is staged in host memory when it is copied to a device.
+constexpr size_t kExtDataStagingChunkSize = 16 * 1024 * 1024;
+
+// Copies external data stored in a file to a tensor on a device through a staging buffer of at most
+// kExtDataStagingChunkSize bytes, so the data is never held in CPU memory as a whole. The staging buffer is
+// allocated with staging_alloc, which is pinned memory the device can copy from directly when available.
+static common::Status CopyExtDataFileToDeviceTensor(const Env& env, const std::basic_string<ORTCHAR_T>& file_path,
+                                                    FileOffsetType file_offset, size_t length,
+                                                    const AllocatorPtr& staging_alloc,
+                                                    const DataTransferManager& data_transfer_mgr, Tensor& tensor) {
+  ORT_RETURN_IF_NOT(length == tensor.SizeInBytes(), "External data size ", length,
+                    " does not match the tensor size ", tensor.SizeInBytes());
+  const size_t chunk_size = std::min(length, kExtDataStagingChunkSize);
+  if (chunk_size == 0) {
+    return Status::OK();
+  }
+
+  auto staging_buffer = IAllocator::MakeUniquePtr<char>(staging_alloc, chunk_size);
+  const DataTypeImpl* const byte_type = DataTypeImpl::GetType<uint8_t>();
+  auto* dst_data = static_cast<char*>(tensor.MutableDataRaw());
+  for (size_t offset = 0; offset < length; offset += chunk_size) {
+    const size_t size = std::min(chunk_size, length - offset);
+    ORT_RETURN_IF_ERROR(env.ReadFileIntoBuffer(file_path.c_str(), file_offset + static_cast<FileOffsetType>(offset),
+                                               size, gsl::make_span(staging_buffer.get(), size)));
+    const TensorShape chunk_shape({static_cast<int64_t>(size)});
+    const Tensor src_chunk(byte_type, chunk_shape, staging_buffer.get(), staging_alloc->Info());
+    Tensor dst_chunk(byte_type, chunk_shape, dst_data + offset, tensor.Location());
+    ORT_RETURN_IF_ERROR(data_transfer_mgr.CopyTensor(src_chunk, dst_chunk));
+  }
+
+  return Status::OK();
+}
+#endif
+
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer* m,
                                              const AllocatorPtr& alloc, const AllocatorPtr& default_cpu_alloc,
+                                             const AllocatorPtr& staging_alloc,
                                              OrtValue& ort_value, const DataTransferManager& data_transfer_mgr,
                                              bool use_device_allocator_for_initializers = false) {
   if (bool(alloc) == (m != nullptr)) {
@@ -147,9 +187,32 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "string tensor is not supported for copying between allocators");
     }
 
+#if !defined(__wasm__)
+    if (utils::HasExternalData(tensor_proto)) {
+      std::basic_string<ORTCHAR_T> ext_data_file_path;
+      FileOffsetType ext_data_offset = 0;
+      SafeInt<size_t> ext_data_len = 0;
+      ORT_RETURN_IF_ERROR(utils::GetExtDataFileInfoFromTensorProto(proto_path.c_str(), tensor_proto,
+                                                                   ext_data_file_path, ext_data_offset,
+                                                                   ext_data_len));
+      if (ext_data_file_path != utils::kTensorProtoMemoryAddressTag) {
+        // stream the data from the file to the device
+        ORT_RETURN_IF_ERROR(CopyExtDataFileToDeviceTensor(env, ext_data_file_path, ext_data_offset, ext_data_len,
+                                                          staging_alloc ? staging_alloc : default_cpu_alloc,
+                                                          data_transfer_mgr, *p_tensor));
+        auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+        ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+        return common::Status::OK();
+      }
+    }
+#endif
+
     // deserialize to CPU first for non-CPU allocator, then copy
     std::unique_ptr<Tensor> p_deserialize_tensor;
-    if (use_device_allocator_for_initializers) {
+    if (utils::HasExternalData(tensor_proto)) {
+      // the tensor is created over the external data below
+      p_deserialize_tensor = std::make_unique<Tensor>();
+    } else if (use_device_allocator_for_initializers) {
       void* tensor_buffer = nullptr;
       ORT_RETURN_IF_ERROR(AllocateBufferUsingDeviceAllocatorFromShapeAndType(tensor_shape, type, default_cpu_alloc, tensor_buffer));
       p_deserialize_tensor = std::make_unique<Tensor>(type, tensor_shape, tensor_buffer, default_cpu_alloc);
@@ -190,6 +253,7 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const AllocatorPtr& default_cpu_alloc,
+    const StagingAllocatorFunction& get_staging_allocator,
     const OrtValueNameIdxMap& ort_value_name_idx_map,
     const std::vector<OrtValueIndex>& initializer_allocation_order,
     ITensorAllocator& planner,
@@ -317,8 +381,12 @@ common::Status SaveInitializedTensors(
       bool use_device_allocator_for_initializers =
           session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
 
+      const OrtDevice& device = exec_plan.GetLocation(ort_value_index);
+      AllocatorPtr staging_alloc =
+          device.Type() != OrtDevice::CPU && get_staging_allocator ? get_staging_allocator(device) : nullptr;
+
       Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
-                                         default_cpu_alloc, ort_value, data_transfer_mgr,
+                                         default_cpu_alloc, staging_alloc, ort_value, data_transfer_mgr,
                                          use_device_allocator_for_initializers);
       if (!st.IsOK()) {
         std::ostringstream oss;
@@ -474,5 +542,20 @@ common::Status SaveInputOutputNamesToNodeMapping(const onnxruntime::GraphViewer&
   return Status::OK();
 }
 
+const std::string& GetBuildAndCpuSignature() {
+  static const std::string signature = []() {
+    const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+    std::ostringstream ss;
+    ss << ORT_VERSION << "+" << sizeof(void*) << "+"
+       << cpuid_info.HasSSE3() << cpuid_info.HasSSE4_1() << cpuid_info.HasAVX() << cpuid_info.HasAVX2()
+       << cpuid_info.HasAVX512f() << cpuid_info.HasAVX512Skylake() << cpuid_info.HasAVX512_BF16()
+       << cpuid_info.HasAMX_BF16() << cpuid_info.HasF16C()
+       << cpuid_info.HasArmNeonDot() << cpuid_info.HasArmNeon_I8MM() << cpuid_info.HasArmSVE_I8MM()
+       << cpuid_info.HasArmNeon_BF16();
+    return ss.str();
+  }();
+  return signature;
+}
+
 }  // namespace session_state_utils
 }  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #pragma once
 #include <map>
+#include <string>
 
 #include "core/common/const_pointer_container.h"
 #include "core/framework/allocator.h"
@@ -33,10 +34,14 @@ namespace session_state_utils {
 using SaveTensorFunction = std::function<Status(const std::string& name, int idx, const OrtValue& value,
                                                 const OrtCallback& d, bool constant, bool sparse)>;
 using MemoryProfileFunction = std::function<void(ITensorAllocator& planner)>;
+// Returns the allocator of the host memory to stage initializers copied to the given device in, e.g. pinned memory,
+// or nullptr to use the default CPU allocator.
+using StagingAllocatorFunction = std::function<AllocatorPtr(const OrtDevice& device)>;
 
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const AllocatorPtr& default_cpu_memory_info,
+    const StagingAllocatorFunction& get_staging_allocator,
     const OrtValueNameIdxMap& ort_value_name_idx_map, const std::vector<OrtValueIndex>& initializer_allocation_order,
     ITensorAllocator& planner,
     const SaveTensorFunction& save_tensor_func,
@@ -49,5 +54,9 @@ common::Status SaveInitializedTensors(
 common::Status SaveInputOutputNamesToNodeMapping(const GraphViewer& graph,
                                                  SessionState& session_state,
                                                  gsl::span<const NodeArg* const> implicit_inputs);
+
+// The ORT version and the features of the build and the CPU that kernels specialize on, e.g. the pre-packed form of
+// a weight or the layout of optimized nodes. Used to key data that is persisted and reused across processes.
+const std::string& GetBuildAndCpuSignature();
 }  // namespace session_state_utils
 }  // namespace onnxruntime
@@ -254,7 +254,9 @@ void ScheduleDownstream(StreamExecutionContext& ctx, size_t trigger, bool single
     for (auto downstream : it->second) {
       // increase the task count before schedule down-stream
       ctx.AddTask();
-      concurrency::ThreadPool::Schedule(tp, [&ctx, downstream, &terminate_flag, &session_scope]() {
+      // The downstream consumes what this thread just produced, so keep it close to this thread unless
+      // another inter-op thread is idle.
+      concurrency::ThreadPool::ScheduleWithLocality(tp, [&ctx, downstream, &terminate_flag, &session_scope]() {
         RunSince(downstream.first, ctx, session_scope, terminate_flag, downstream.second);
       });
     }
@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/symbolic_mem_pattern.h"
+
+#include <algorithm>
+
+#include "core/common/safeint.h"
+#include "core/framework/allocator.h"
+#include "core/framework/data_types.h"
+#include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/framework/session_state.h"
+#include "core/framework/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Values of the symbolic dimensions of the feeds, from the shapes of their NodeArgs in the graph.
+Status ResolveDimParams(const SessionState& session_state,
+                        gsl::span<const OrtValue> feeds, gsl::span<const int> feed_mlvalue_idxs,
+                        InlinedHashMap<std::string, int64_t>& out) {
+  ORT_RETURN_IF_NOT(feeds.size() == feed_mlvalue_idxs.size(), "Expected ", feed_mlvalue_idxs.size(),
+                    " feeds but got ", feeds.size());
+  const auto& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    std::string name;
+    ORT_RETURN_IF_ERROR(name_idx_map.GetName(feed_mlvalue_idxs[i], name));
+    const auto* node_arg = graph_viewer.GetNodeArg(name);
+    if (node_arg == nullptr || node_arg->Shape() == nullptr) {
+      continue;
+    }
+
+    const auto* shape = node_arg->Shape();
+    const auto dims = feeds[i].Get<Tensor>().Shape().GetDims();
+    ORT_RETURN_IF_NOT(shape->dim_size() == static_cast<int>(dims.size()),
+                      "The rank of feed ", name, " does not match the rank of its shape in the graph");
+    for (int k = 0, end = shape->dim_size(); k < end; ++k) {
+      if (shape->dim(k).has_dim_param()) {
+        auto [it, inserted] = out.insert({shape->dim(k).dim_param(), dims[k]});
+        ORT_RETURN_IF(!inserted && it->second != dims[k],
+                      "Symbolic dimension ", it->first, " has different values in the feeds");
+      }
+    }
+  }
+  return Status::OK();
+}
+
+// Element size of the value if it is a non-string tensor, 0 otherwise.
+size_t GetTensorElementSize(MLDataType type) {
+  if (type == nullptr || !type->IsTensorType()) {
+    return 0;
+  }
+  const auto* element_type = static_cast<const TensorTypeBase*>(type)->GetElementType();
+  if (utils::IsDataTypeString(element_type)) {
+    return 0;
+  }
+  return element_type->Size();
+}
+
+}  // namespace
+
+Status SymbolicMemoryPattern::Create(const SessionState& session_state,
+                                     gsl::span<const OrtValue> feeds, gsl::span<const int> feed_mlvalue_idxs,
+                                     gsl::span<const MemoryPatternTraceEvent> trace,
+                                     std::unique_ptr<const SymbolicMemoryPattern>& pattern) {
+  InlinedHashMap<std::string, int64_t> dim_values;
+  ORT_RETURN_IF_ERROR(ResolveDimParams(session_state, feeds, feed_mlvalue_idxs, dim_values));
+  ORT_RETURN_IF(dim_values.empty(), "The feeds have no symbolic dimensions");
+
+  const auto& name_idx_map = session_state.GetOrtValueNameIdxMap();
+  const auto& graph_viewer = session_state.GetGraphViewer();
+  const auto& allocation_plan = session_state.GetExecutionPlan()->allocation_plan;
+
+  std::unique_ptr<SymbolicMemoryPattern> result(new SymbolicMemoryPattern(session_state));
+  InlinedHashMap<std::string, size_t> dim_param_indices;
+  // Index of the expression of each planned value.
+  InlinedHashMap<int, size_t> planned_values;
+
+  // Expression of the size of the value traced with the given size, or false if it cannot be expressed in terms of
+  // the symbolic dimensions.
+  auto try_create_expression = [&](int ort_value_idx, size_t traced_size, SizeExpression& expression) {
+    std::string name;
+    if (!name_idx_map.GetName(ort_value_idx, name).IsOK() ||
+        static_cast<size_t>(ort_value_idx) >= allocation_plan.size()) {
+      return false;
+    }
+    const auto* node_arg = graph_viewer.GetNodeArg(name);
+    expression.element_size = GetTensorElementSize(allocation_plan[ort_value_idx].value_type);
+    if (node_arg == nullptr || node_arg->Shape() == nullptr || expression.element_size == 0) {
+      return false;
+    }
+
+    expression.constant = 1;
+    SafeInt<size_t> num_elements = 1;
+    for (const auto& dim : node_arg->Shape()->dim()) {
+      if (dim.has_dim_value()) {
+        expression.constant *= dim.dim_value();
+        num_elements *= dim.dim_value();
+      } else if (dim.has_dim_param()) {
+        auto it = dim_values.find(dim.dim_param());
+        if (it == dim_values.end()) {
+          return false;
+        }
+        auto [index_it, inserted] = dim_param_indices.insert({it->first, result->dim_params_.size()});
+        if (inserted) {
+          result->dim_params_.push_back(it->first);
+        }
+        expression.dims.push_back(index_it->second);
+        num_elements *= it->second;
+      } else {
+        return false;
+      }
+    }
+
+    // Skip the values whose inferred shape does not match the traced allocation.
+    size_t size = 0;
+    return IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(num_elements, expression.element_size,
+                                                                         &size) &&
+           size == traced_size;
+  };
+
+  InlinedHashSet<int> skipped_values;
+  for (const auto& event : trace) {
+    if (event.is_allocation) {
+      if (planned_values.count(event.ort_value_idx) > 0 || skipped_values.count(event.ort_value_idx) > 0) {
+        continue;
+      }
+      SizeExpression expression{};
+      if (!try_create_expression(event.ort_value_idx, event.size, expression)) {
+        skipped_values.insert(event.ort_value_idx);
+        continue;
+      }
+      planned_values.insert({event.ort_value_idx, result->expressions_.size()});
+      result->expressions_.push_back(std::move(expression));
+      result->events_.push_back(Event{event.ort_value_idx, true, result->expressions_.size() - 1});
+    } else if (planned_values.count(event.ort_value_idx) > 0) {
+      result->events_.push_back(Event{event.ort_value_idx, false, 0});
+    }
+  }
+
+  ORT_RETURN_IF(planned_values.empty(), "None of the traced values has a size expressible in symbolic dimensions");
+  result->num_planned_values_ = planned_values.size();
+  pattern = std::move(result);
+  return Status::OK();
+}
+
+Status SymbolicMemoryPattern::Instantiate(gsl::span<const OrtValue> feeds, gsl::span<const int> feed_mlvalue_idxs,
+                                          MemoryPatternGroup& out) const {
+  InlinedHashMap<std::string, int64_t> resolved;
+  ORT_RETURN_IF_ERROR(ResolveDimParams(session_state_, feeds, feed_mlvalue_idxs, resolved));
+
+  InlinedVector<int64_t> dim_values;
+  dim_values.reserve(dim_params_.size());
+  for (const auto& dim_param : dim_params_) {
+    auto it = resolved.find(dim_param);
+    ORT_RETURN_IF(it == resolved.end(), "Symbolic dimension ", dim_param, " is not defined by the feeds");
+    ORT_RETURN_IF(it->second < 0, "Symbolic dimension ", dim_param, " has negative value ", it->second);
+    dim_values.push_back(it->second);
+  }
+
+  OrtValuePatternPlanner planner(*session_state_.GetExecutionPlan());
+  for (const auto& event : events_) {
+    if (!event.is_allocation) {
+      ORT_RETURN_IF_ERROR(planner.TraceFree(event.ort_value_idx));
+      continue;
+    }
+
+    const auto& expression = expressions_[event.expression_idx];
+    SafeInt<size_t> num_elements = expression.constant;
+    for (size_t dim : expression.dims) {
+      num_elements *= dim_values[dim];
+    }
+    size_t size = 0;
+    ORT_RETURN_IF_NOT(IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(
+                          num_elements, expression.element_size, &size),
+                      "Size overflow for ort_value_idx=", event.ort_value_idx);
+    ORT_RETURN_IF_ERROR(planner.TraceAllocation(event.ort_value_idx, size));
+  }
+
+  return planner.GeneratePatterns(out);
+}
+
+}  // namespace onnxruntime
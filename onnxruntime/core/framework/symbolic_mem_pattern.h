@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+
+class SessionState;
+
+// An allocation or a release of a value traced by an execution frame that generates a memory pattern.
+struct MemoryPatternTraceEvent {
+  int ort_value_idx;
+  bool is_allocation;
+  // Size of the allocation in bytes. 0 for a release.
+  size_t size;
+};
+
+/**
+ * Memory pattern of a graph with dynamic input shapes, expressed in terms of the symbolic dimensions of the graph
+ * inputs, e.g. batch * seq * hidden.
+ *
+ * It is created from the allocations and releases traced by the first run that generated a memory pattern. The size
+ * of each traced value is expressed as a product of symbolic dimensions and a constant, from the shape inferred for
+ * the value in the graph. Values whose size cannot be expressed this way, e.g. the outputs of NonZero, or whose
+ * expression does not match the traced size, are left out of the pattern and allocated by the allocator at runtime.
+ *
+ * The memory pattern for other input shapes is instantiated by replaying the trace with the sizes of the values for
+ * these shapes, so that a run with new input shapes allocates a single block per location instead of tracing its
+ * allocations first. The replay assumes that the order of allocations and releases does not depend on the shapes,
+ * which holds for the sequential execution plans memory patterns are used with.
+ */
+class SymbolicMemoryPattern {
+ public:
+  // Create the pattern from the events traced by a run with the given feeds.
+  // session_state must outlive the pattern. Fails if none of the traced values can be expressed symbolically.
+  static Status Create(const SessionState& session_state,
+                       gsl::span<const OrtValue> feeds, gsl::span<const int> feed_mlvalue_idxs,
+                       gsl::span<const MemoryPatternTraceEvent> trace,
+                       std::unique_ptr<const SymbolicMemoryPattern>& pattern);
+
+  // Generate the memory pattern for the given feeds. Fails if the feeds do not define all the symbolic dimensions
+  // of the pattern, or define a symbolic dimension with different values.
+  Status Instantiate(gsl::span<const OrtValue> feeds, gsl::span<const int> feed_mlvalue_idxs,
+                     MemoryPatternGroup& out) const;
+
+  // Number of values allocated in the memory patterns the pattern instantiates.
+  size_t NumPlannedValues() const { return num_planned_values_; }
+
+ private:
+  // The size of a value is the aligned size of constant * product(dims) elements of element_size bytes.
+  struct SizeExpression {
+    size_t element_size;
+    int64_t constant;
+    // Indices in dim_params_.
+    InlinedVector<size_t> dims;
+  };
+
+  struct Event {
+    int ort_value_idx;
+    bool is_allocation;
+    // Index in expressions_ for an allocation.
+    size_t expression_idx;
+  };
+
+  explicit SymbolicMemoryPattern(const SessionState& session_state) : session_state_(session_state) {}
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SymbolicMemoryPattern);
+
+  const SessionState& session_state_;
+  // Names of the symbolic dimensions the sizes depend on.
+  std::vector<std::string> dim_params_;
+  std::vector<SizeExpression> expressions_;
+  std::vector<Event> events_;
+  size_t num_planned_values_ = 0;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/tensor_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/graph/graph.h"
+#include "core/mlas/inc/mlas.h"
+#include "nlohmann/json.hpp"
+
+namespace onnxruntime {
+
+namespace {
+// The bin of value among equal width bins starting at min, bins_per_unit being the number of bins over the range.
+size_t BinIndex(double value, double min, double bins_per_unit, size_t num_bins) {
+  const double bin = (value - min) * bins_per_unit;
+  return bin <= 0.0 ? 0 : std::min(static_cast<size_t>(bin), num_bins - 1);
+}
+}  // namespace
+
+TensorStatistics::TensorStatistics(size_t num_bins) : num_bins_(num_bins) {
+  ORT_ENFORCE(num_bins_ > 0, "The number of histogram bins of the tensor statistics must be positive");
+}
+
+void TensorStatistics::AddNodeOutputs(OpKernelContextInternal& context, const Node& node) {
+  const auto& output_defs = node.OutputDefs();
+  for (int i = 0, end = context.OutputCount(); i < end; ++i) {
+    // the outputs are not all allocated if the kernel failed
+    const OrtValue* value = output_defs[i]->Exists() ? context.GetOutputMLValue(i) : nullptr;
+    if (value == nullptr || !value->IsAllocated() || !value->IsTensor()) {
+      continue;
+    }
+
+    const auto& tensor = value->Get<Tensor>();
+    if (tensor.IsDataType<float>() && tensor.Location().device.Type() == OrtDevice::CPU) {
+      Add(output_defs[i]->Name(), tensor.Data<float>(), narrow<size_t>(tensor.Shape().Size()));
+    }
+  }
+}
+
+void TensorStatistics::Add(const std::string& name, const float* data, size_t count) {
+  if (count == 0) {
+    return;
+  }
+
+  float min;
+  float max;
+  MlasFindMinMaxElement(data, &min, &max, count);
+  if (!std::isfinite(min) || !std::isfinite(max)) {
+    min = std::numeric_limits<float>::max();
+    max = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < count; i++) {
+      if (std::isfinite(data[i])) {
+        min = std::min(min, data[i]);
+        max = std::max(max, data[i]);
+      }
+    }
+    if (min > max) {
+      return;  // no finite value
+    }
+  }
+
+  Entry* entry;
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto& entry_ptr = entries_[name];
+    if (entry_ptr == nullptr) {
+      entry_ptr = std::make_unique<Entry>();
+    }
+    entry = entry_ptr.get();
+  }
+
+  std::lock_guard<OrtMutex> lock(entry->mutex);
+  if (entry->count == 0) {
+    entry->min = min;
+    entry->max = max;
+    entry->histogram.assign(num_bins_, 0);
+  } else if (min < entry->min || max > entry->max) {
+    Rebin(*entry, std::min(min, entry->min), std::max(max, entry->max));
+  }
+
+  const double range = static_cast<double>(entry->max) - entry->min;
+  const double bins_per_unit = range > 0.0 ? num_bins_ / range : 0.0;
+  uint64_t num_finite = 0;
+  uint64_t num_denormals = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (std::isfinite(data[i])) {
+      ++entry->histogram[BinIndex(data[i], entry->min, bins_per_unit, num_bins_)];
+      ++num_finite;
+      num_denormals += std::fpclassify(data[i]) == FP_SUBNORMAL ? 1 : 0;
+    }
+  }
+  entry->count += num_finite;
+  entry->denormals += num_denormals;
+}
+
+void TensorStatistics::Rebin(Entry& entry, float min, float max) const {
+  std::vector<uint64_t> histogram(num_bins_, 0);
+  const double bin_width = (static_cast<double>(entry.max) - entry.min) / num_bins_;
+  const double bins_per_unit = num_bins_ / (static_cast<double>(max) - min);
+  for (size_t i = 0; i < num_bins_; i++) {
+    if (entry.histogram[i] != 0) {
+      const double center = entry.min + (i + 0.5) * bin_width;
+      histogram[BinIndex(center, min, bins_per_unit, num_bins_)] += entry.histogram[i];
+    }
+  }
+  entry.histogram = std::move(histogram);
+  entry.min = min;
+  entry.max = max;
+}
+
+std::string TensorStatistics::ToJson() const {
+  nlohmann::json json = nlohmann::json::object();
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& [name, entry] : entries_) {
+    std::lock_guard<OrtMutex> entry_lock(entry->mutex);
+    json[name] = {{"count", entry->count},
+                  {"denormals", entry->denormals},
+                  {"min", entry->min},
+                  {"max", entry->max},
+                  {"histogram", entry->histogram}};
+  }
+  return json.dump();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class Node;
+class OpKernelContextInternal;
+
+/**
+ * Collects the statistics of the float tensors produced by the nodes of a session across its runs, to calibrate
+ * quantization at close to inference speed instead of adding every intermediate tensor as a graph output.
+ * Each tensor keeps its minimum and maximum, and a histogram of num_bins bins over that range. When a run widens the
+ * range, the counts of the existing bins are moved to the bins of the new range holding their centers, so the memory
+ * does not grow with the number of runs. Only the tensors in CPU memory are collected.
+ * Enabled by kOrtSessionOptionsConfigCollectTensorStatistics.
+ */
+class TensorStatistics {
+ public:
+  explicit TensorStatistics(size_t num_bins);
+
+  // Adds the float outputs of a node which has been computed.
+  void AddNodeOutputs(OpKernelContextInternal& context, const Node& node);
+
+  // Adds the values of a tensor. Values which are not finite are ignored.
+  void Add(const std::string& name, const float* data, size_t count);
+
+  /*
+  The statistics as JSON: an object with an entry per tensor name holding the number of finite values seen ("count"),
+  the number of denormal values among them ("denormals"), "min", "max" and the "histogram" counts of equal width bins
+  from min to max.
+  */
+  std::string ToJson() const;
+
+ private:
+  struct Entry {
+    OrtMutex mutex;
+    uint64_t count = 0;
+    uint64_t denormals = 0;
+    float min = 0.0f;
+    float max = 0.0f;
+    std::vector<uint64_t> histogram;
+  };
+
+  // Moves the counts of the histogram to the bins of the range [min, max], which contains its current range.
+  void Rebin(Entry& entry, float min, float max) const;
+
+  const size_t num_bins_;
+
+  mutable OrtMutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Entry>> entries_;
+};
+
+}  // namespace onnxruntime
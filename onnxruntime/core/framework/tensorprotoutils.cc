@@ -804,6 +804,18 @@ static Status GetFileContent(
 }
 #endif
 
+Status GetExtDataFileInfoFromTensorProto(const ORTCHAR_T* model_path,
+                                         const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                         std::basic_string<ORTCHAR_T>& ext_data_file_path,
+                                         FileOffsetType& ext_data_offset, SafeInt<size_t>& ext_data_len) {
+  std::basic_string<ORTCHAR_T> tensor_proto_dir;
+  if (model_path != nullptr) {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(model_path, tensor_proto_dir));
+  }
+  const ORTCHAR_T* t_prot_dir_s = tensor_proto_dir.size() == 0 ? nullptr : tensor_proto_dir.c_str();
+  return GetExternalDataInfo(tensor_proto, t_prot_dir_s, ext_data_file_path, ext_data_offset, ext_data_len);
+}
+
 Status GetExtDataFromTensorProto(const Env& env, const ORTCHAR_T* model_path,
                                  const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                  void*& ext_data_buf, SafeInt<size_t>& ext_data_len, OrtCallback& ext_data_deleter) {
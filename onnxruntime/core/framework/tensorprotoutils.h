@@ -105,6 +105,14 @@ common::Status GetExtDataFromTensorProto(const Env& env, const ORTCHAR_T* model_
                                          void*& ext_data_buf, SafeInt<size_t>& ext_data_len,
                                          OrtCallback& ext_data_deleter);
 
+// Given a tensor proto with external data obtain the path of the file containing the data, resolved relative to the
+// directory of model_path, and the offset and length of the data in it, to read the data without mapping the file.
+// The path is kTensorProtoMemoryAddressTag if the data is in memory.
+common::Status GetExtDataFileInfoFromTensorProto(const ORTCHAR_T* model_path,
+                                                 const ONNX_NAMESPACE::TensorProto& tensor_proto,
+                                                 std::basic_string<ORTCHAR_T>& ext_data_file_path,
+                                                 FileOffsetType& ext_data_offset, SafeInt<size_t>& ext_data_len);
+
 // Convert the AttributeProto from a Constant node into a TensorProto that can be used as an initializer
 // If AttributeProto contains a TensorProto, this tensor proto is converted as is including the case when the
 // the data location is external. i.e. it does not load the external data.
@@ -104,6 +104,12 @@ static common::Status AllocateHelper(const AllocatorPtr& allocator,
                              p_data,
                              allocator, target_mlvalue);
       }
+    } else if (allocator->IsStreamOrdered() && target_stream) {
+      size_t len = Tensor::CalculateTensorStorageSize(source_tensor.DataType(), source_tensor.Shape());
+      Tensor::InitOrtValue(source_tensor.DataType(),
+                           source_tensor.Shape(),
+                           allocator->AllocStreamOrdered(len, target_stream),
+                           allocator, target_mlvalue);
     } else {
       Tensor::InitOrtValue(source_tensor.DataType(),
                            source_tensor.Shape(),
@@ -741,21 +747,22 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
                             bool only_execute_path_to_fetches,
-                            Stream* parent_stream) {
+                            Stream* parent_stream,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
   ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
 
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
   FinalizeFeedFetchCopyInfo(feeds_fetches_manager, feeds, fetches);
 #ifdef ORT_ENABLE_STREAM
   DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
-  auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+  auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
                                  execution_mode, terminate_flag, logger,
                                  device_stream_collection,
                                  only_execute_path_to_fetches,
                                  parent_stream);
   return retval;
 #else
-  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
                           execution_mode, terminate_flag, logger,
                           only_execute_path_to_fetches,
                           parent_stream);
@@ -769,7 +776,8 @@ common::Status ExecuteGraph(const SessionState& session_state,
 #ifdef ORT_ENABLE_STREAM
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
-                            const logging::Logger& logger) {
+                            const logging::Logger& logger,
+                            const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators) {
   return ExecuteGraph(session_state,
                       feeds_fetches_manager,
                       feeds, fetches,
@@ -779,7 +787,9 @@ common::Status ExecuteGraph(const SessionState& session_state,
 #ifdef ORT_ENABLE_STREAM
                       device_stream_collection_holder,
 #endif
-                      run_options.only_execute_path_to_fetches);
+                      run_options.only_execute_path_to_fetches,
+                      nullptr,
+                      fetch_allocators);
 }
 
 #ifdef ENABLE_TRAINING
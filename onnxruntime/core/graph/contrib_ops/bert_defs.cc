@@ -277,11 +277,16 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
   }
 
   if (ctx.getNumOutputs() > 1) {  // has present output
-    // copy the type from query to present key
-    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 1);
-
-    // copy the type from query to present value
-    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 2);
+    // copy the type from past key and value to present key and value, as the k-v cache may be quantized,
+    // or from query when there is no past
+    if (past_key_index >= 0 && ctx.getNumInputs() > static_cast<size_t>(past_key_index) &&
+        ctx.getInputType(past_key_index) != nullptr) {
+      ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, past_key_index, 1);
+      ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, static_cast<size_t>(past_key_index) + 1, 2);
+    } else {
+      ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 1);
+      ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 2);
+    }
 
     if (past_key_index >= 0 && hasInputShape(ctx, past_key_index)) {
       auto& past_shape = getInputShape(ctx, past_key_index);
@@ -316,9 +321,14 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
   }
 }
 
-void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
+void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index,
+                                               int block_table_index = -1) {
   // TODO(aciddelgado): propagate output shapes depending if kv-share buffer is on or not
-  constexpr int use_max_past_present_buffer = -1;
+  int use_max_past_present_buffer = -1;
+  if (block_table_index >= 0 && hasInputShape(ctx, block_table_index)) {
+    // Paged KV cache: present key/value are the same block pool as past key/value.
+    use_max_past_present_buffer = 1;
+  }
   BaseGroupQueryAttentionTypeAndShapeInference(ctx, past_key_index, use_max_past_present_buffer);
 }
 
@@ -1051,6 +1061,14 @@ Supports different number of heads for q and kv for CPU and CUDA.
 Only supports causal and local attention.
 Supports rotary position embedding for CPU and CUDA.
 Supports packed input for CPU and CUDA.
+Supports paged k-v cache for CPU. When block_table is given, past_key and past_value are a pool of fixed-size blocks
+with shape (num_blocks, kv_num_heads, block_size, head_size), and block_table maps the logical blocks of each
+sequence to blocks in the pool. New key and value are written into the pool, and present_key and present_value
+have the same shape as past_key and past_value (bind them to the same buffers to avoid copying the pool).
+Supports paged k-v cache for CUDA with flash attention, where block_size shall be a multiple of 256.
+Supports int8 k-v cache for CPU. When past_key and past_value are int8, they hold the key and value quantized
+symmetrically with k_scale and v_scale, i.e. key = k_scale * past_key, and the new key and value are quantized with
+the same scales into present_key and present_value.
 )DOC";
 
 ONNX_MS_OPERATOR_SET_SCHEMA(
@@ -1094,13 +1112,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "past_key",
                "past state key with support for format BNSH. When past_key uses same tensor as present_key"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(4,
                "past_value",
                "past state value with support for format BNSH. When past_value uses same tensor as present_value"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(5,
                "seqlens_k",
@@ -1120,6 +1138,24 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "block_table",
+               "2D tensor with shape (batch_size, max_blocks_per_sequence). Indices of the blocks in past_key and "
+               "past_value that hold each sequence when paged k-v cache is used.",
+               "M",
+               OpSchema::Optional)
+        .Input(10,
+               "k_scale",
+               "Scale of the int8 key cache, with shape (1) for all kv heads or (kv_num_heads) for each kv head. "
+               "Required when past_key is int8.",
+               "T_KV_SCALE",
+               OpSchema::Optional)
+        .Input(11,
+               "v_scale",
+               "Scale of the int8 value cache, with shape (1) for all kv heads or (kv_num_heads) for each kv head. "
+               "Required when past_value is int8.",
+               "T_KV_SCALE",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
@@ -1129,17 +1165,20 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "present state key with support for format BNSH. When past_key uses same tensor as present_key"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .Output(2,
                 "present_value",
                 "present state value with support for format BNSH. When past_value uses same tensor as present_value"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .TypeConstraint("T", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)"}, "Constrain input and output to float tensors.")
+        .TypeConstraint("T_CACHE", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)", "tensor(int8)"},
+                        "Constrain k-v cache to float tensors, or int8 tensors for a quantized k-v cache.")
+        .TypeConstraint("T_KV_SCALE", {"tensor(float)"}, "Constrain k-v cache scales to float tensors.")
         .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask to int tensor.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
-          GroupQueryAttentionTypeAndShapeInference(ctx, 3);
+          GroupQueryAttentionTypeAndShapeInference(ctx, 3, 9);
         }));
 
 constexpr const char* SparseAttention_ver1_doc = R"DOC(
@@ -1468,6 +1507,73 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
         .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output float tensors types.")
         .TypeAndShapeInferenceFunction(EmbedLayerNormalizationShapeInference));
 
+constexpr const char* TokenEmbedLayerNormalization_ver1_doc = R"DOC(
+TokenEmbedLayerNormalization is the fusion of the embedding layer of decoder-only models: the rows of the token
+embedding table are looked up, multiplied by scale, optionally added to the rows of a position embedding table and
+normalized, with LayerNormalization or with SimplifiedLayerNormalization (RMSNorm) if simplified is 1.
+
+The embedding table is either a float tensor of shape (vocab_size, hidden_size), or a table of 4-bit values in the
+layout of the weight of MatMulNBits with N = vocab_size and K = hidden_size: uint8 of shape
+(vocab_size, n_blocks_per_row, block_size / 2) with the scales and optional zero points of MatMulNBits, so that a table
+shared with a quantized language model head is not dequantized. Only the rows looked up are dequantized.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    TokenEmbedLayerNormalization, 1,
+    OpSchema()
+        .SetDoc(TokenEmbedLayerNormalization_ver1_doc)
+        .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT, 1e-5f)
+        .Attr("scale", "The factor applied to the token embeddings, e.g. sqrt(hidden_size).", AttributeProto::FLOAT,
+              1.0f)
+        .Attr("simplified", "1 to normalize with SimplifiedLayerNormalization (RMSNorm), 0 for LayerNormalization.",
+              AttributeProto::INT, static_cast<int64_t>(0))
+        .Attr("block_size", "The number of 4-bit values sharing a scale in a quantized embedding table. Power of 2 "
+              "and not smaller than 16. Ignored for a float table.",
+              AttributeProto::INT, static_cast<int64_t>(0))
+        .Input(0, "input_ids", "Token IDs of any shape", "T1")
+        .Input(1, "embedding", "Token embedding table: float with shape (vocab_size, hidden_size), or uint8 with "
+               "shape (vocab_size, n_blocks_per_row, block_size / 2)", "T2")
+        .Input(2, "gamma", "1D gamma tensor for layer normalization with shape (hidden_size)", "T")
+        .Input(3, "beta", "1D beta tensor for layer normalization with shape (hidden_size). Not used if simplified "
+               "is 1", "T", OpSchema::Optional)
+        .Input(4, "scales", "Scales of a quantized embedding table with shape (vocab_size * n_blocks_per_row)", "T",
+               OpSchema::Optional)
+        .Input(5, "zero_points", "Zero points of a quantized embedding table with shape "
+               "(vocab_size * ((n_blocks_per_row + 1) / 2)), two 4-bit values per byte. Defaults to 8", "T3",
+               OpSchema::Optional)
+        .Input(6, "position_ids", "Position IDs with the shape of input_ids", "T1", OpSchema::Optional)
+        .Input(7, "position_embedding", "Position embedding table with shape (max_position, hidden_size)", "T",
+               OpSchema::Optional)
+        .Output(0, "output", "Output tensor with shape input_ids.shape + (hidden_size)", "T")
+        .Output(1, "embedding_sum", "The embeddings before normalization, with the shape of output", "T",
+                OpSchema::Optional)
+        .TypeConstraint("T1", {"tensor(int32)", "tensor(int64)"}, "Constrain the IDs to integer types.")
+        .TypeConstraint("T2", {"tensor(float)", "tensor(uint8)"}, "Constrain the embedding table to float or uint8 "
+                        "for a quantized table.")
+        .TypeConstraint("T3", {"tensor(uint8)"}, "Constrain the zero points to uint8.")
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output float tensors types.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 2, 0);
+          if (ctx.getNumOutputs() > 1) {
+            propagateElemTypeFromInputToOutput(ctx, 2, 1);
+          }
+          if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 2)) {
+            return;
+          }
+
+          auto& gamma_shape = getInputShape(ctx, 2);
+          if (gamma_shape.dim_size() != 1) {
+            fail_shape_inference("gamma shall be 1 dimension");
+          }
+
+          ONNX_NAMESPACE::TensorShapeProto output_shape = getInputShape(ctx, 0);
+          *output_shape.add_dim() = gamma_shape.dim(0);
+          updateOutputShape(ctx, 0, output_shape);
+          if (ctx.getNumOutputs() > 1) {
+            updateOutputShape(ctx, 1, output_shape);
+          }
+        }));
+
 constexpr const char* FastGelu_ver1_doc = R"DOC(
 GELU (Gaussian Error Linear Unit) approximation: Y=0.5*X*(1+tanh(0.797885*X+0.035677*X*X*X)) with an optional input of bias that will be added to X before GELU.)DOC";
 
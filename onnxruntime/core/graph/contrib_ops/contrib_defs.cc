@@ -761,6 +761,110 @@ ONNX_MS_OPERATOR_SET_SCHEMA(TorchEmbedding, 1,
                                   updateOutputShape(ctx, 0, outputs_shape);
                                 }));
 
+constexpr const char* EmbeddingBag_ver1_doc = R"DOC(
+Looks up bags of rows in an embedding table and reduces every bag to a single row. The result is the same as
+ReduceSum (mode 'sum') or ReduceMean (mode 'mean') of Gather(weight, indices) over the last axis of indices
+with keepdims=0, but the gathered rows are accumulated directly into the output instead of being materialized.
+An empty bag produces a row of zeros.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(EmbeddingBag, 1,
+                            OpSchema()
+                                .SetDoc(EmbeddingBag_ver1_doc)
+                                .Attr("mode",
+                                      "Reduction applied to the rows of a bag: 'sum' or 'mean'.",
+                                      AttributeProto::STRING,
+                                      std::string("sum"))
+                                .Input(0,
+                                       "weight",
+                                       "The embedding table, of shape (N, *) where N is the number of rows.",
+                                       "T")
+                                .Input(1,
+                                       "indices",
+                                       "Indices of the rows to look up, of shape (*, bag_size). Negative indices count from the end.",
+                                       "Tind")
+                                .Output(0,
+                                        "Y",
+                                        "Reduced bags, of shape indices.shape[:-1] + weight.shape[1:].",
+                                        "T")
+                                .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+                                .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices to integer types.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+                                  if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 1)) {
+                                    return;
+                                  }
+
+                                  auto& weight_shape = getInputShape(ctx, 0);
+                                  auto& indices_shape = getInputShape(ctx, 1);
+                                  if (weight_shape.dim_size() < 1 || indices_shape.dim_size() < 1) {
+                                    fail_shape_inference("weight and indices must have a rank of at least 1");
+                                  }
+
+                                  ONNX_NAMESPACE::TensorShapeProto output_shape;
+                                  for (int i = 0; i < indices_shape.dim_size() - 1; ++i) {
+                                    *output_shape.add_dim() = indices_shape.dim(i);
+                                  }
+                                  for (int i = 1; i < weight_shape.dim_size(); ++i) {
+                                    *output_shape.add_dim() = weight_shape.dim(i);
+                                  }
+                                  updateOutputShape(ctx, 0, output_shape);
+                                }));
+
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Evaluates a chain of elementwise operators in a single pass over the output, so the intermediate results are never
+written to memory. 'ops' lists the operators in evaluation order: Add, Sub, Mul, Div, Max, Min (binary) and Relu,
+Sigmoid, Tanh, Exp, Neg, Abs, Sqrt, Erf (unary). 'operands' holds two indices per operator; an index lower than the
+number of inputs refers to an input, otherwise to the result of the operator at (index - number of inputs), and the
+second index of a unary operator is -1. The output is the result of the last operator and has the shape of the first
+input. The other inputs have that shape, a single element, or the trailing dimensions of that shape. float16 is
+supported by the CUDA kernel, which computes in float.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(FusedElementwise, 1,
+                            OpSchema()
+                                .SetDoc(FusedElementwise_ver1_doc)
+                                .Attr("ops", "Operators of the chain, in evaluation order.", AttributeProto::STRINGS)
+                                .Attr("operands", "Two operand indices for every operator.", AttributeProto::INTS)
+                                .Input(0, "inputs", "Inputs of the chain. The first one has the shape of the output.",
+                                       "T", OpSchema::Variadic)
+                                .Output(0, "Y", "Result of the last operator.", "T")
+                                .TypeConstraint("T", {"tensor(float)", "tensor(float16)"},
+                                                "Constrain input and output types to float tensors.")
+                                .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
+
+constexpr const char* ShapeCompute_ver1_doc = R"DOC(
+Computes a small int64 tensor, e.g. the target shape of a Reshape, from the dimensions of its inputs. It replaces the
+chains of Shape, Gather, Slice, Concat, Unsqueeze, Squeeze and integer arithmetic nodes that compute such tensors. The
+data of the inputs is not read. 'ops' lists the instructions in evaluation order: Dim, Const, Add, Sub, Mul and Div
+(truncating). 'operands' holds two values per instruction: the input index and the axis for Dim, the value and -1 for
+Const, and the indices of two previous instructions for the others. 'outputs' lists the instructions whose results
+form the output, which is a 1D tensor, or a scalar if 'scalar' is 1.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(ShapeCompute, 1,
+                            OpSchema()
+                                .SetDoc(ShapeCompute_ver1_doc)
+                                .Attr("ops", "Instructions, in evaluation order.", AttributeProto::STRINGS)
+                                .Attr("operands", "Two operands for every instruction.", AttributeProto::INTS)
+                                .Attr("outputs", "Instructions whose results form the output.", AttributeProto::INTS)
+                                .Attr("scalar", "If 1, the output is a scalar.", AttributeProto::INT,
+                                      static_cast<int64_t>(0))
+                                .Input(0, "inputs", "Tensors whose dimensions are read.", "T", OpSchema::Variadic,
+                                       /*is_homogeneous*/ false)
+                                .Output(0, "Y", "Computed values.", "T1")
+                                .TypeConstraint("T", OpSchema::all_tensor_types(), "Input can be of any tensor type.")
+                                .TypeConstraint("T1", {"tensor(int64)"}, "Constrain output to int64 tensor.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::INT64);
+                                  auto* output_shape = getOutputShape(ctx, 0);
+                                  if (getAttribute(ctx, "scalar", 0) == 0) {
+                                    const auto* outputs = ctx.getAttribute("outputs");
+                                    output_shape->add_dim()->set_dim_value(
+                                        outputs != nullptr ? outputs->ints_size() : 0);
+                                  }
+                                }));
+
 constexpr const char* Trilu_ver1_doc = R"DOC(
       Returns the upper or lower triangular part of a 2-D matrix, or batches of 2-D matrices. If the attribute "upper" is set to true,
       the upper triangular matrix is retained. Lower triangular matrix is retained otherwise. Default value for upper is true.
@@ -1214,6 +1318,14 @@ ONNX_MS_OPERATOR_SET_SCHEMA(WhisperBeamSearch, 1,
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
                                       AttributeProto::INT, static_cast<int64_t>(-1))
                                 .Attr("decoder_output_cross_qk", "If nozero, decoder subgraph contains output Q*K from cross attentions. Default 0.", AttributeProto::INT, OPTIONAL_VALUE)
+                                .Attr("chunk_length",
+                                      "Number of frames of input_features in one encoder window (3000 for 30 seconds of audio). "
+                                      "When positive and input_features is longer, it is split into windows of this length that "
+                                      "are decoded together as separate batch entries, so the outputs have batch_size * num_windows "
+                                      "entries with the windows of an audio adjacent. Inputs with a batch dimension other than "
+                                      "input_features and decoder_input_ids are given per window. Default 0 decodes input_features as "
+                                      "one window.",
+                                      AttributeProto::INT, static_cast<int64_t>(0))
                                 .Input(0, "input_ids", "The sequence used as a prompt for the generation in the encoder subgraph. Shape is (batch_size, sequence_length)", "F")
                                 .Input(1, "max_length", "The maximum length of the sequence to be generated. Shape is (1)", "I")
                                 .Input(2, "min_length", "The minimum length below which the score of eos_token_id is set to -Inf. Shape is (1)", "I", OpSchema::Optional)
@@ -1321,6 +1433,12 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                       "This is relevant only for the GPT2 model. If this attribute is missing, the `decoder` subgraph will be used for all decoding runs",
                                       AttributeProto::GRAPH, OPTIONAL_VALUE)
                                 .Attr("decoder", "Decoder subgraph to execute in a loop.", AttributeProto::GRAPH)
+                                .Attr("draft_decoder",
+                                      "A smaller decoder subgraph with same inputs and outputs as `decoder`, which proposes tokens for speculative decoding. "
+                                      "In each round, it proposes up to `num_speculative_tokens` tokens, and the `decoder` subgraph runs once to verify them. "
+                                      "Generated sequences are same as without it. It is used only for GPT2 model with batch size 1 on CPU",
+                                      AttributeProto::GRAPH, OPTIONAL_VALUE)
+                                .Attr("num_speculative_tokens", "Maximum number of tokens proposed by `draft_decoder` in each round.", AttributeProto::INT, static_cast<int64_t>(4))
                                 .Attr("vocab_size",
                                       "Size of the vocabulary. "
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
@@ -1362,6 +1480,12 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Sampling, 1,
                                       "This is relevant only for the GPT2 model. If this attribute is missing, the `decoder` subgraph will be used for all decoding runs",
                                       AttributeProto::GRAPH, OPTIONAL_VALUE)
                                 .Attr("decoder", "Decoder subgraph to execute in a loop.", AttributeProto::GRAPH)
+                                .Attr("draft_decoder",
+                                      "A smaller decoder subgraph with same inputs and outputs as `decoder`, which proposes tokens for speculative decoding. "
+                                      "In each round, it proposes up to `num_speculative_tokens` tokens, and the `decoder` subgraph runs once to verify them. "
+                                      "Generated sequences are same as without it. It is used only for GPT2 model with batch size 1 on CPU",
+                                      AttributeProto::GRAPH, OPTIONAL_VALUE)
+                                .Attr("num_speculative_tokens", "Maximum number of tokens proposed by `draft_decoder` in each round.", AttributeProto::INT, static_cast<int64_t>(4))
                                 .Attr("vocab_size",
                                       "Size of the vocabulary. "
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
@@ -1461,7 +1585,7 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "2D input tensor with shape (num_rows, hidden_size) or 3D input tensor with shape "
                 "(batch_size, sequence_length, hidden_size)",
                 "T")
-        .TypeConstraint("T", {"tensor(float16)"}, "Constrain input and output types to float or float16 tensors.")
+        .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float or float16 tensors.")
         .TypeConstraint("T1", {"tensor(uint8)"}, "Constrain weights type to uint8 tensors.")
         .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
 
@@ -1933,6 +2057,57 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Tokenizer, 1,
                                   updateOutputShape(ctx, 0, output_shape);
                                 }));
 
+constexpr const char* WordPieceTokenizer_ver1_doc = R"DOC(
+WordPieceTokenizer converts each string of the 1-D input X into vocabulary ids, as the tokenizer of BERT like models.
+The string is split on whitespace and ASCII punctuation, each punctuation character being a word of its own.
+Every word is then divided greedily into the longest vocabulary pieces, the pieces after the first one being looked up
+with the suffix indicator prepended. A word that can not be divided, or that has more than max_input_chars_per_word
+characters, becomes unk_token. The output has shape [N, D] where D is the maximum number of ids of a string, and the
+shorter rows are padded with pad_token_id.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(WordPieceTokenizer, 1,
+                            OpSchema()
+                                .Input(0, "X", "Strings to tokenize. Shape is (N)", "T")
+                                .Output(0, "Y", "Token ids. Shape is (N, D)", "tensor(int64)")
+                                .Output(1, "lengths", "Number of token ids of each string. Shape is (N)", "tensor(int64)",
+                                        OpSchema::Optional)
+                                .TypeConstraint("T", {"tensor(string)"}, "Input is a string tensor")
+                                .Attr("vocab", "Vocabulary pieces. The id of a piece is its index.", AttributeProto::STRINGS)
+                                .Attr("unk_token", "The piece of unknown words, which must be in vocab.", AttributeProto::STRING,
+                                      std::string("[UNK]"))
+                                .Attr("suffix_indicator", "Prefix of the pieces that continue a word.", AttributeProto::STRING,
+                                      std::string("##"))
+                                .Attr("max_input_chars_per_word", "Words with more characters are unk_token.",
+                                      AttributeProto::INT, static_cast<int64_t>(100))
+                                .Attr("pad_token_id", "The id padding the rows with fewer tokens.", AttributeProto::INT,
+                                      static_cast<int64_t>(0))
+                                .Attr("lower_case", "If nonzero, ASCII letters are lowercased before tokenization.",
+                                      AttributeProto::INT, static_cast<int64_t>(0))
+                                .SetDoc(WordPieceTokenizer_ver1_doc)
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::INT64);
+                                  if (ctx.getNumOutputs() > 1) {
+                                    updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::INT64);
+                                  }
+                                  if (!hasInputShape(ctx, 0))
+                                    return;
+
+                                  auto& input_shape = getInputShape(ctx, 0);
+                                  if (input_shape.dim_size() != 1) {
+                                    fail_shape_inference("Input is expected to have 1 dimension");
+                                  }
+                                  ONNX_NAMESPACE::TensorShapeProto output_shape;
+                                  *output_shape.add_dim() = input_shape.dim(0);
+                                  output_shape.add_dim();
+                                  updateOutputShape(ctx, 0, output_shape);
+                                  if (ctx.getNumOutputs() > 1) {
+                                    ONNX_NAMESPACE::TensorShapeProto lengths_shape;
+                                    *lengths_shape.add_dim() = input_shape.dim(0);
+                                    updateOutputShape(ctx, 1, lengths_shape);
+                                  }
+                                }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(MatMulInteger16, 1,
                             OpSchema()
                                 .SetDoc(R"DOC(
@@ -3429,6 +3604,19 @@ Input scales is stored in same type as original type of B(float32, float16) with
 Input zero_points is stored as uint8_t or same as type(A). It has the same packing method as input B.
   - [CeilDiv((N * n_blocks_per_col + 1) *bits, 8)]
   If zero_points has same type as A, it's not packed and has the same shape as Scales.
+
+The optional epilogue is applied to the output in this order: Y = activation(A * B + lora + bias) + residual.
+  - bias has shape [N].
+  - activation is specified by attributes 'activation' and 'activation_params', like FusedConv.
+  - residual has the same shape as Y.
+
+The optional low rank adapters (LoRA) lora_a and lora_b add the update lora = (A * lora_a[i]) * lora_b[i], where
+the scaling of the adapter is applied to lora_b:
+  - lora_a has shape [num_adapters, K, rank] and lora_b has shape [num_adapters, rank, N], or [K, rank] and [rank, N]
+    for a single adapter.
+  - lora_index has shape [A.shape[0]] and selects the adapter i of each item of the leading dimension of A, so that
+    the requests of a batch can use different adapters, or -1 for no adapter. It is required with several adapters.
+    Without it the single adapter is applied to all of A.
 )DOC";
 
   ONNX_CONTRIB_OPERATOR_SCHEMA(MatMulNBits)
@@ -3446,11 +3634,22 @@ Input zero_points is stored as uint8_t or same as type(A). It has the same packi
             "computation. 4 means input A can be quantized with the same block_size to int8 internally from "
             "type T1.",
             AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("activation", "optional activation applied to the output after bias", AttributeProto::STRING,
+            OPTIONAL_VALUE)
+      .Attr("activation_params", "parameters of the activation", AttributeProto::FLOATS, OPTIONAL_VALUE)
       .Input(0, "A", "The input tensor, not quantized", "T1")
       .Input(1, "B", "1 or 2 dimensional data blob", "T2")
       .Input(2, "scales", "quantization scale", "T1")
       .Input(3, "zero_points", "quantization zero points", "T3", OpSchema::Optional)
       .Input(4, "g_idx", "group_idx", "T4", OpSchema::Optional)
+      .Input(5, "bias", "optional bias added to the output, with shape [N]", "T1", OpSchema::Optional)
+      .Input(6, "residual", "optional tensor added to the output after activation, with the same shape as Y", "T1",
+             OpSchema::Optional)
+      .Input(7, "lora_a", "optional down projections of the low rank adapters", "T1", OpSchema::Optional)
+      .Input(8, "lora_b", "optional up projections of the low rank adapters, required with lora_a", "T1",
+             OpSchema::Optional)
+      .Input(9, "lora_index", "optional index of the adapter of each item of the leading dimension of A", "T4",
+             OpSchema::Optional)
       .Output(0, "Y", "tensor. The output tensor has the same rank as the input. ", "T1")
       .TypeConstraint("T1", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float/half_float tensors.")
       .TypeConstraint("T2", {"tensor(uint8)", "tensor(int32)"}, "Constrain quantized weight types to uint8/int32.")
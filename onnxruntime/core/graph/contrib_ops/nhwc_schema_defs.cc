@@ -388,7 +388,7 @@ ONNX_MS_OPERATOR_SET_SCHEMA(NhwcFusedConv, 1,
                             OpSchema()
                                 .SetDoc(R"DOC(
 NhwcFusedConv is a Conv operator with optional activation and add operators fused in.
-Only has fp16 implementation as of 2023/04/15.
+Has fp16 and fp32 CPU implementations.
 )DOC")
                                 .Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"))
                                 .Attr("kernel_shape", "", AttributeProto::INTS, OPTIONAL_VALUE)
@@ -403,11 +403,51 @@ Only has fp16 implementation as of 2023/04/15.
                                 .Input(2, "B", "", "T", OpSchema::Optional)
                                 .Input(3, "Z", "Tensor to be added to the output, must be the same shape and format as the output tensor.", "T", OpSchema::Optional)
                                 .Output(0, "Y", "", "T")
-                                .TypeConstraint("T", {"tensor(float16)"}, "Constrain input and output types to float tensors")
+                                .TypeConstraint("T", {"tensor(float16)", "tensor(float)"}, "Constrain input and output types to float tensors")
                                 .TypeAndShapeInferenceFunction([](InferenceContext& ctx) {
                                   ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
                                   convPoolShapeInferenceNhwc(ctx, true, false, 0, 1);
                                 }));
 
+ONNX_MS_OPERATOR_SET_SCHEMA(NhwcFusedDepthwisePointwiseConv, 1,
+                            OpSchema()
+                                .SetDoc(R"DOC(
+NhwcFusedDepthwisePointwiseConv is a depthwise NhwcFusedConv followed by a pointwise (1x1) NhwcFusedConv,
+as in depthwise separable convolution blocks. Tiles of the depthwise output are consumed by the pointwise
+convolution while they are in the cache, so the intermediate tensor is not materialized.
+The convolution attributes apply to the depthwise convolution, whose group equals its number of channels.
+The pointwise convolution has unit strides, no padding and a single group.
+)DOC")
+                                .Attr("auto_pad", "", AttributeProto::STRING, std::string("NOTSET"))
+                                .Attr("kernel_shape", "", AttributeProto::INTS, OPTIONAL_VALUE)
+                                .Attr("dilations", "", AttributeProto::INTS, OPTIONAL_VALUE)
+                                .Attr("strides", "", AttributeProto::INTS, OPTIONAL_VALUE)
+                                .Attr("pads", "", AttributeProto::INTS, OPTIONAL_VALUE)
+                                .Attr("group", "", AttributeProto::INT, static_cast<int64_t>(1))
+                                .Attr("dw_activation", "Activation of the depthwise convolution.", AttributeProto::STRING, OPTIONAL_VALUE)
+                                .Attr("dw_activation_params", "", AttributeProto::FLOATS, OPTIONAL_VALUE)
+                                .Attr("activation", "Activation of the pointwise convolution.", AttributeProto::STRING, OPTIONAL_VALUE)
+                                .Attr("activation_params", "", AttributeProto::FLOATS, OPTIONAL_VALUE)
+                                .Input(0, "X", "", "T")
+                                .Input(1, "W_dw", "Depthwise filter, (C x 1 x kH x kW).", "T")
+                                .Input(2, "B_dw", "", "T", OpSchema::Optional)
+                                .Input(3, "W_pw", "Pointwise filter, (M x C x 1 x 1).", "T")
+                                .Input(4, "B_pw", "", "T", OpSchema::Optional)
+                                .Input(5, "Z", "Tensor to be added to the output, must be the same shape and format as the output tensor.", "T", OpSchema::Optional)
+                                .Output(0, "Y", "", "T")
+                                .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+                                .TypeAndShapeInferenceFunction([](InferenceContext& ctx) {
+                                  ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+                                  convPoolShapeInferenceNhwc(ctx, true, false, 0, 1);
+                                  // The pointwise convolution only changes the number of channels.
+                                  if (hasInputShape(ctx, 3) && ctx.getOutputType(0)->tensor_type().has_shape()) {
+                                    auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+                                    const auto& w_pw_shape = getInputShape(ctx, 3);
+                                    if (output_shape->dim_size() > 0 && w_pw_shape.dim_size() > 0) {
+                                      *output_shape->mutable_dim(output_shape->dim_size() - 1) = w_pw_shape.dim(0);
+                                    }
+                                  }
+                                }));
+
 }  // namespace contrib
 }  // namespace onnxruntime
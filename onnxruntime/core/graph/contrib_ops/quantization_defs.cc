@@ -397,7 +397,14 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "of elements should be equal to the number of columns of input 'B'.",
                "T2", OpSchema::Optional)
         .Input(4, "bias", "1D input tensor, whose dimension is same as B's last dimension", "T1", OpSchema::Optional)
-        .Output(0, "Y", "Matrix multiply results from A * B", "T1")
+        .Input(5, "residual",
+               "Optional tensor added to the output after the activation. Its shape is the same as Y's.",
+               "T1", OpSchema::Optional)
+        .Output(0, "Y", "Matrix multiply results from A * B, followed by the optional activation and residual add",
+                "T1")
+        .Attr("activation", "Optional activation applied to the output after bias, like FusedConv.",
+              AttributeProto::STRING, OPTIONAL_VALUE)
+        .Attr("activation_params", "Parameters of the activation.", AttributeProto::FLOATS, OPTIONAL_VALUE)
         .TypeConstraint("T1", {"tensor(float)"}, "Constrain input A, b_scale and output Y data type as float tensor.")
         .TypeConstraint("T2", {"tensor(int8)", "tensor(uint8)"}, "Constrain input B data type to 8-bit integer tensor.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
@@ -405,6 +412,54 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           ONNX_NAMESPACE::defs::math::utils::MatMulShapeInference(ctx, 0, 1);
         }));
 
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    DynamicQuantizeSkipLayerNormalization, 1,
+    OpSchema()
+        .SetDoc(R"DOC(
+SkipLayerNormalization (or SkipSimplifiedLayerNormalization) followed by DynamicQuantizeLinear of its output.
+The normalized output is quantized to uint8 with a per-tensor scale and zero point computed like DynamicQuantizeLinear
+does, without writing the float output to memory.
+)DOC")
+        .Attr("epsilon", "The epsilon value to use to avoid division by zero.", AttributeProto::FLOAT,
+              kDefaultSkipLayerNormEpsilon)
+        .Attr("simplified", "If 1, normalize like SkipSimplifiedLayerNormalization: no mean subtraction and no beta.",
+              AttributeProto::INT, static_cast<int64_t>(0))
+        .Input(0, "input", "3D input tensor with shape (batch_size, sequence_length, hidden_size)", "T")
+        .Input(1, "skip",
+               "3D skip tensor with shape (batch_size, sequence_length, hidden_size) or "
+               "(1, sequence_length, hidden_size) or (sequence_length, hidden_size)",
+               "T")
+        .Input(2, "gamma", "1D input tensor with shape (hidden_size)", "T")
+        .Input(3, "beta", "1D skip tensor with shape (hidden_size). Must be absent when simplified is 1.", "T",
+               OpSchema::Optional)
+        .Input(4, "bias", "1D bias tensor with shape (hidden_size)", "T", OpSchema::Optional)
+        .Output(0, "Y", "Quantized normalized output with the shape of input", "T2")
+        .Output(1, "Y_scale", "Output scale. It's a scalar", "T")
+        .Output(2, "Y_zero_point", "Output zero point. It's a scalar", "T2")
+        .Output(3, "input_skip_bias_sum",
+                "Sum of the input and skip inputs (and bias if it exists) with the shape of input.", "T",
+                OpSchema::Optional)
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and float output types to float tensors.")
+        .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain quantized output types to uint8 tensors.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::UINT8);
+          propagateElemTypeFromInputToOutput(ctx, 0, 1);
+          updateOutputElemType(ctx, 2, ONNX_NAMESPACE::TensorProto::UINT8);
+          if (ctx.getNumOutputs() > 3) {
+            propagateElemTypeFromInputToOutput(ctx, 0, 3);
+          }
+
+          updateOutputShape(ctx, 1, ONNX_NAMESPACE::TensorShapeProto());
+          updateOutputShape(ctx, 2, ONNX_NAMESPACE::TensorShapeProto());
+          if (!hasInputShape(ctx, 0)) {
+            return;
+          }
+          propagateShapeFromInputToOutput(ctx, 0, 0);
+          if (ctx.getNumOutputs() > 3) {
+            propagateShapeFromInputToOutput(ctx, 0, 3);
+          }
+        }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     MatMulIntegerToFloat, 1,
     OpSchema()
@@ -755,6 +810,99 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
         .TypeConstraint("T2", {"tensor(uint8)", "tensor(int8)"}, "Constrain weights types to 8 bit tensors.")
         .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::RNNShapeInference));
 
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    DynamicQuantizeGRU, 1,
+    OpSchema()
+        .SetDoc("GRU with 8-bit weights. The inputs and hidden states are quantized dynamically, "
+                "and W and R are transposed compared to GRU.")
+        .Attr("direction",
+              "Specify if the RNN is forward, reverse, or bidirectional. "
+              "Must be one of forward (default), reverse, or bidirectional.",
+              AttributeProto::STRING, std::string("forward"))
+        .Attr("hidden_size", "Number of neurons in the hidden layer", AttributeProto::INT, OPTIONAL_VALUE)
+        .Attr("activation_alpha",
+              "Optional scaling values used by some activation functions. The values "
+              "are consumed in the order of activation functions, for example (f, g) "
+              "in GRU. Default values are the same as of corresponding ONNX operators.",
+              AttributeProto::FLOATS, OPTIONAL_VALUE)
+        .Attr("activation_beta",
+              "Optional scaling values used by some activation functions. The values "
+              "are consumed in the order of activation functions, for example (f, g) "
+              "in GRU. Default values are the same as of corresponding ONNX operators.",
+              AttributeProto::FLOATS, OPTIONAL_VALUE)
+        .Attr("clip",
+              "Cell clip threshold. Clipping bounds the elements of a tensor "
+              "in the range of [-threshold, +threshold] and is applied to the input "
+              "of activations. No clip if not specified.",
+              AttributeProto::FLOAT, OPTIONAL_VALUE)
+        .Attr("activations",
+              "A list of 2 (or 4 if bidirectional) activation functions "
+              "for update, reset, and hidden gates. Optional: See the equations "
+              "of GRU for default if not specified.",
+              AttributeProto::STRINGS, OPTIONAL_VALUE)
+        .Attr("linear_before_reset",
+              "When computing the output of the hidden gate, "
+              "apply the linear transformation before multiplying by the output of the "
+              "reset gate.",
+              AttributeProto::INT, static_cast<int64_t>(0))
+        .Input(0, "X",
+               "The input sequences packed (and potentially padded) into one 3-D "
+               "tensor with the shape of `[seq_length, batch_size, input_size]`.",
+               "T")
+        .Input(1, "W",
+               "The weight tensor for the gates. Concatenation of `W[zrh]` and "
+               "`WB[zrh]` (if bidirectional) along dimension 0. The tensor has shape "
+               "`[num_directions, input_size, 3*hidden_size]`.",
+               "T2")
+        .Input(2, "R",
+               "The recurrence weight tensor. Concatenation of `R[zrh]` and "
+               "`RB[zrh]` (if bidirectional) along dimension 0. This tensor has shape "
+               "`[num_directions, hidden_size, 3*hidden_size]`.",
+               "T2")
+        .Input(3, "B",
+               "The bias tensor for the gates. Concatenation of `[Wb[zrh], Rb[zrh]]` "
+               "and `[WBb[zrh], RBb[zrh]]` (if bidirectional) along dimension 0. This "
+               "tensor has shape `[num_directions, 6*hidden_size]`. Optional: If not "
+               "specified - assumed to be 0.",
+               "T", OpSchema::Optional)
+        .Input(4, "sequence_lens",
+               "Optional tensor specifying lengths of the sequences in a batch. "
+               "If not specified - assumed all sequences in the batch to have "
+               "length `seq_length`. It has shape `[batch_size]`.",
+               "T1", OpSchema::Optional)
+        .Input(5, "initial_h",
+               "Optional initial value of the hidden. If not specified - assumed "
+               "to be 0. It has shape `[num_directions, batch_size, hidden_size]`.",
+               "T", OpSchema::Optional)
+        .Input(6, "W_scale",
+               "W's scale. Its size is [num_directions] for per-tensor/layer quantization, "
+               "or [num_directions, 3*hidden_size] for per-channel quantization on the axis input_size.",
+               "T")
+        .Input(7, "W_zero_point",
+               "W's zero point. Its size is [num_directions] for per-tensor/layer quantization, "
+               "or [num_directions, 3*hidden_size] for per-channel quantization on the axis input_size.",
+               "T2")
+        .Input(8, "R_scale",
+               "R's scale. Its size is [num_directions] for per-tensor/layer quantization, "
+               "or [num_directions, 3*hidden_size] for per-channel quantization on the axis hidden_size.",
+               "T")
+        .Input(9, "R_zero_point",
+               "R's zero point. Its size is [num_directions] for per-tensor/layer quantization, "
+               "or [num_directions, 3*hidden_size] for per-channel quantization on the axis hidden_size.",
+               "T2")
+        .Output(0, "Y",
+                "A tensor that concats all the intermediate output values of the hidden. "
+                "It has shape `[seq_length, num_directions, batch_size, hidden_size]`. ",
+                "T", OpSchema::Optional, true, 1, OpSchema::Differentiable)
+        .Output(1, "Y_h",
+                "The last output value of the hidden. It has shape "
+                "`[num_directions, batch_size, hidden_size]`.",
+                "T", OpSchema::Optional, true, 1, OpSchema::Differentiable)
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeConstraint("T1", {"tensor(int32)"}, "Constrain seq_lens to integer tensor.")
+        .TypeConstraint("T2", {"tensor(uint8)", "tensor(int8)"}, "Constrain weights types to 8 bit tensors.")
+        .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::RNNShapeInference));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     QLinearConcat, 1,
     OpSchema()
@@ -987,6 +1135,11 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
         .Input(8, "past",
                "past state for key and value with shape (2, batch_size, num_heads, past_sequence_length, head_size).",
                "T3", OpSchema::Optional)
+        .Input(9, "qkv_scale",
+               "Calibrated scales of Q, K and V, a 1D tensor of size 3, e.g. their absolute maximum divided by 127. "
+               "When given without past, Q x K' and the attention probs x V are computed as int8 matrix "
+               "multiplications, with Q, K and V quantized with these scales and the probs with a scale of 1/255.",
+               "T3", OpSchema::Optional)
         .Output(0, "output", "3D output tensor with shape (batch_size, sequence_length, hidden_size)", "T3")
         .Output(1, "present",
                 "present state for key and value with shape (2, batch_size, num_heads, past_sequence_length + "
@@ -1327,6 +1327,23 @@ Graph::Graph(const Model& owning_model,
   if (is_loaded_from_model_file_) {
     InitializeStateFromModelFileGraphProto();
   }
+
+  // The nodes and value_info of the main graph are now held by the Nodes and NodeArgs. Release their protos so that a
+  // large model does not keep a second copy of its nodes for the lifetime of the session. The GraphProto is
+  // regenerated from the graph if it is requested. Subgraph protos are kept as they are the attributes of the
+  // parent node.
+  if (is_loaded_from_model_file_ && parent_graph_ == nullptr) {
+    graph_proto_->mutable_node()->Clear();
+    for (int i = 0, num_cleared = graph_proto_->node().ClearedCount(); i < num_cleared; ++i) {
+      delete graph_proto_->mutable_node()->ReleaseCleared();
+    }
+    graph_proto_->mutable_value_info()->Clear();
+    for (int i = 0, num_cleared = graph_proto_->value_info().ClearedCount(); i < num_cleared; ++i) {
+      delete graph_proto_->mutable_value_info()->ReleaseCleared();
+    }
+    graph_proto_nodes_released_ = true;
+    SetGraphProtoSyncNeeded();
+  }
 }
 
 Graph::Graph(Graph& parent_graph, const Node& parent_node, ONNX_NAMESPACE::GraphProto& subgraph_proto)
@@ -3248,7 +3265,7 @@ Status Graph::Resolve(const ResolveOptions& options) {
 
             // if we are resolving immediately after loading from a GraphProto, we don't need to
             // do a proto sync
-            if (options.no_proto_sync_required) {
+            if (options.no_proto_sync_required && !graph.graph_proto_nodes_released_) {
                 graph.GraphProtoSyncNeeded(false);
             }
 
@@ -3872,6 +3889,7 @@ const ONNX_NAMESPACE::GraphProto& Graph::ToGraphProto() {
   ToGraphProtoInternal(*graph_proto_);
 
   GraphProtoSyncNeeded(false);
+  graph_proto_nodes_released_ = false;
 
   return *graph_proto_;
 }
@@ -299,7 +299,14 @@ Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor, TensorProto& init
   } else {
     const auto* fbs_raw_data = fbs_tensor.raw_data();
     if (fbs_raw_data) {
-      if (load_options.can_use_flatbuffer_for_initializers && fbs_raw_data->size() > 127) {
+      // the data of the initializer is used in place only if it is aligned for its element type, as the flatbuffer
+      // only guarantees byte alignment for raw_data.
+      const auto is_data_aligned = [&]() {
+        const auto* element_type = DataTypeImpl::TensorTypeFromONNXEnum(initializer.data_type())->GetElementType();
+        return reinterpret_cast<uintptr_t>(fbs_raw_data->Data()) % element_type->Size() == 0;
+      };
+
+      if (load_options.can_use_flatbuffer_for_initializers && fbs_raw_data->size() > 127 && is_data_aligned()) {
         initializer.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
 
         static_assert(sizeof(void*) <= sizeof(ExternalDataInfo::OFFSET_TYPE));
@@ -3,6 +3,7 @@
 
 #include "core/graph/graph_viewer.h"
 #include "core/graph/indexed_sub_graph.h"
+#include "core/graph/memory_minimizing_order.h"
 
 namespace onnxruntime {
 
@@ -325,6 +326,16 @@ const std::vector<NodeIndex>& GraphViewer::GetNodesInTopologicalOrder(ExecutionO
       return nodes_in_mem_efficient_topological_order_;
 #else
       ORT_THROW("Memory efficient topological order is not enabled for non-training build.");
+#endif
+    case ExecutionOrder::MEMORY_MINIMIZING:
+#if !defined(ORT_MINIMAL_BUILD)
+      std::call_once(nodes_in_memory_minimizing_topological_order_flag_, [this]() {
+        nodes_in_memory_minimizing_topological_order_ =
+            MemoryMinimizingTopologicalOrder(*this, nodes_in_topological_order_);
+      });
+      return nodes_in_memory_minimizing_topological_order_;
+#else
+      ORT_THROW("Memory minimizing topological order is not enabled for ORT minimal build.");
 #endif
     default:
       ORT_THROW("Invalid ExecutionOrder");
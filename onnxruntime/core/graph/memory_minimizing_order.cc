@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include "core/graph/memory_minimizing_order.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/safeint.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+size_t GetElementSize(int32_t elem_type) {
+  switch (elem_type) {
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E4M3FN:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E4M3FNUZ:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E5M2:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT8E5M2FNUZ:
+      return 1;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+      return 2;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+      return 4;
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+    case ONNX_NAMESPACE::TensorProto_DataType_COMPLEX64:
+      return 8;
+    case ONNX_NAMESPACE::TensorProto_DataType_COMPLEX128:
+      return 16;
+    case ONNX_NAMESPACE::TensorProto_DataType_STRING:
+      return sizeof(std::string);
+    default:
+      return 0;
+  }
+}
+
+// Size in bytes of a value, or 0 if it is not a tensor with a shape.
+size_t GetValueSize(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type() || !type->tensor_type().has_shape()) {
+    return 0;
+  }
+
+  SafeInt<size_t> size = GetElementSize(type->tensor_type().elem_type());
+  for (const auto& dim : type->tensor_type().shape().dim()) {
+    if (dim.has_dim_value()) {
+      if (dim.dim_value() <= 0) {
+        return 0;
+      }
+      size *= dim.dim_value();
+    }
+  }
+  return size;
+}
+
+// Distinct explicit and implicit inputs of a node.
+InlinedVector<const NodeArg*> GetDistinctInputs(const Node& node) {
+  InlinedVector<const NodeArg*> inputs;
+  inputs.reserve(node.InputDefs().size() + node.ImplicitInputDefs().size());
+  for (const auto* input : node.InputDefs()) {
+    if (input->Exists()) {
+      inputs.push_back(input);
+    }
+  }
+  for (const auto* input : node.ImplicitInputDefs()) {
+    inputs.push_back(input);
+  }
+  std::sort(inputs.begin(), inputs.end());
+  inputs.erase(std::unique(inputs.begin(), inputs.end()), inputs.end());
+  return inputs;
+}
+
+// Tracks the size of the live node outputs while the nodes of a graph are executed.
+class LivenessTracker {
+ public:
+  explicit LivenessTracker(const GraphViewer& graph_viewer) {
+    for (const auto& node : graph_viewer.Nodes()) {
+      for (const auto* output : node.OutputDefs()) {
+        if (output->Exists()) {
+          values_[output] = ValueInfo{GetValueSize(*output), 0};
+        }
+      }
+    }
+    for (const auto& node : graph_viewer.Nodes()) {
+      for (const auto* input : GetDistinctInputs(node)) {
+        auto it = values_.find(input);
+        if (it != values_.end()) {
+          ++it->second.remaining_consumers;
+        }
+      }
+    }
+    // Graph outputs are never freed.
+    for (const auto* output : graph_viewer.GetOutputs()) {
+      auto it = values_.find(output);
+      if (it != values_.end()) {
+        ++it->second.remaining_consumers;
+      }
+    }
+  }
+
+  // Size of the outputs of the node, which are allocated while it is executed.
+  size_t GetAllocatedSize(const Node& node) const {
+    size_t size = 0;
+    for (const auto* output : node.OutputDefs()) {
+      auto it = values_.find(output);
+      if (it != values_.end()) {
+        size += it->second.size;
+      }
+    }
+    return size;
+  }
+
+  // Size of the values that are freed after the node is executed: the inputs it is the last consumer of, and
+  // its unused outputs.
+  size_t GetFreedSize(const Node& node) const {
+    size_t size = 0;
+    for (const auto* input : GetDistinctInputs(node)) {
+      auto it = values_.find(input);
+      if (it != values_.end() && it->second.remaining_consumers == 1) {
+        size += it->second.size;
+      }
+    }
+    for (const auto* output : node.OutputDefs()) {
+      auto it = values_.find(output);
+      if (it != values_.end() && it->second.remaining_consumers == 0) {
+        size += it->second.size;
+      }
+    }
+    return size;
+  }
+
+  void Execute(const Node& node) {
+    const size_t freed_size = GetFreedSize(node);
+    live_size_ += GetAllocatedSize(node);
+    peak_size_ = std::max(peak_size_, live_size_);
+    live_size_ -= freed_size;
+    for (const auto* input : GetDistinctInputs(node)) {
+      auto it = values_.find(input);
+      if (it != values_.end()) {
+        --it->second.remaining_consumers;
+      }
+    }
+  }
+
+  size_t GetPeakSize() const { return peak_size_; }
+
+ private:
+  struct ValueInfo {
+    size_t size;
+    size_t remaining_consumers;
+  };
+
+  InlinedHashMap<const NodeArg*, ValueInfo> values_;
+  size_t live_size_ = 0;
+  size_t peak_size_ = 0;
+};
+
+}  // namespace
+
+std::vector<NodeIndex> MemoryMinimizingTopologicalOrder(const GraphViewer& graph_viewer,
+                                                        gsl::span<const NodeIndex> default_order) {
+  InlinedHashMap<NodeIndex, size_t> positions;
+  positions.reserve(default_order.size());
+  for (size_t i = 0; i < default_order.size(); ++i) {
+    positions[default_order[i]] = i;
+  }
+
+  // Count the input edges from the nodes of the view only, as a filtered view may not contain all the producers.
+  InlinedHashMap<NodeIndex, size_t> in_degrees;
+  in_degrees.reserve(default_order.size());
+  std::vector<const Node*> ready;
+  for (NodeIndex node_index : default_order) {
+    const auto* node = graph_viewer.GetNode(node_index);
+    size_t in_degree = 0;
+    for (auto it = node->InputEdgesBegin(), end = node->InputEdgesEnd(); it != end; ++it) {
+      if (positions.count(it->GetNode().Index()) > 0) {
+        ++in_degree;
+      }
+    }
+    in_degrees[node_index] = in_degree;
+    if (in_degree == 0) {
+      ready.push_back(node);
+    }
+  }
+
+  LivenessTracker tracker(graph_viewer);
+  std::vector<NodeIndex> order;
+  order.reserve(default_order.size());
+  while (!ready.empty()) {
+    size_t best = 0;
+    int64_t best_delta = std::numeric_limits<int64_t>::max();
+    for (size_t i = 0; i < ready.size(); ++i) {
+      const int64_t delta = static_cast<int64_t>(tracker.GetAllocatedSize(*ready[i])) -
+                            static_cast<int64_t>(tracker.GetFreedSize(*ready[i]));
+      if (delta < best_delta ||
+          (delta == best_delta && positions[ready[i]->Index()] < positions[ready[best]->Index()])) {
+        best = i;
+        best_delta = delta;
+      }
+    }
+
+    const Node* node = ready[best];
+    ready[best] = ready.back();
+    ready.pop_back();
+    tracker.Execute(*node);
+    order.push_back(node->Index());
+
+    for (auto it = node->OutputEdgesBegin(), end = node->OutputEdgesEnd(); it != end; ++it) {
+      auto in_degree = in_degrees.find(it->GetNode().Index());
+      if (in_degree != in_degrees.end() && --in_degree->second == 0) {
+        ready.push_back(&it->GetNode());
+      }
+    }
+  }
+
+  ORT_ENFORCE(order.size() == default_order.size(), "Memory minimizing topological sort failed. ", order.size(),
+              " != ", default_order.size());
+  return order;
+}
+
+size_t EstimatePeakActivationMemory(const GraphViewer& graph_viewer, gsl::span<const NodeIndex> order) {
+  LivenessTracker tracker(graph_viewer);
+  for (NodeIndex node_index : order) {
+    tracker.Execute(*graph_viewer.GetNode(node_index));
+  }
+  return tracker.GetPeakSize();
+}
+
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <vector>
+
+#include "core/common/gsl.h"
+#include "core/graph/basic_types.h"
+
+namespace onnxruntime {
+
+class GraphViewer;
+
+/**
+ * Topological order of the nodes of graph_viewer that greedily minimizes the peak size of the live node outputs.
+ * At each step the ready node that increases the live size the least is executed, i.e. the node for which the size
+ * of its outputs minus the size of the inputs it is the last consumer of is the smallest. Ties are broken by the
+ * position of the nodes in default_order, so graphs without memory trade-offs keep their default order.
+ */
+std::vector<NodeIndex> MemoryMinimizingTopologicalOrder(const GraphViewer& graph_viewer,
+                                                        gsl::span<const NodeIndex> default_order);
+
+/**
+ * Estimated peak size in bytes of the live node outputs when executing the nodes of graph_viewer in order.
+ * The outputs of a node are live from the node to their last consumer, and until the end for graph outputs.
+ * Graph inputs and initializers are not counted. Symbolic or unknown dimensions count as 1, and values without a
+ * tensor shape as 0, so the estimate is a lower bound for graphs with dynamic shapes.
+ */
+size_t EstimatePeakActivationMemory(const GraphViewer& graph_viewer, gsl::span<const NodeIndex> order);
+
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
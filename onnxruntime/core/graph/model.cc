@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
 #include <memory>
+#include <string_view>
+
 #include "core/common/logging/logging.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
@@ -23,6 +26,7 @@
 #include "core/common/gsl.h"
 
 #include "core/platform/env.h"
+#include "core/platform/path_lib.h"
 
 #if !defined(ORT_MINIMAL_BUILD)
 #include "core/graph/schema_registry.h"
@@ -630,6 +634,220 @@ Status Model::Load(const PathString& file_path,
   return LoadModel(file_path, model_proto);
 }
 
+namespace {
+// A minimal reader and writer of the protobuf wire format, to rewrite the initializers of a serialized ModelProto
+// without parsing their data.
+// See https://protobuf.dev/programming-guides/encoding/
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeFixed64 = 1;
+constexpr uint32_t kWireTypeLengthDelimited = 2;
+constexpr uint32_t kWireTypeFixed32 = 5;
+
+// field numbers in onnx.proto
+constexpr uint32_t kModelProtoGraph = 7;
+constexpr uint32_t kGraphProtoInitializer = 5;
+constexpr uint32_t kTensorProtoRawData = 9;
+constexpr uint32_t kTensorProtoExternalData = 13;
+constexpr uint32_t kTensorProtoDataLocation = 14;
+constexpr uint32_t kStringStringEntryProtoKey = 1;
+constexpr uint32_t kStringStringEntryProtoValue = 2;
+
+bool ReadVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; p < end && shift < 64; shift += 7) {
+    const uint8_t byte = *p++;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WriteVarint(std::string& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+void WriteLengthDelimited(std::string& out, uint32_t field_number, std::string_view bytes) {
+  WriteVarint(out, (static_cast<uint64_t>(field_number) << 3) | kWireTypeLengthDelimited);
+  WriteVarint(out, bytes.size());
+  out.append(bytes);
+}
+
+struct WireField {
+  uint32_t field_number;
+  uint32_t wire_type;
+  // the whole field including its tag
+  const uint8_t* begin;
+  const uint8_t* end;
+  // the payload of a length delimited field
+  const uint8_t* payload;
+  size_t payload_size;
+};
+
+// Reads the next field of a message, which doesn't use the deprecated groups.
+bool ReadField(const uint8_t*& p, const uint8_t* end, WireField& field) {
+  field.begin = p;
+  uint64_t tag;
+  if (!ReadVarint(p, end, tag)) {
+    return false;
+  }
+
+  field.field_number = static_cast<uint32_t>(tag >> 3);
+  field.wire_type = static_cast<uint32_t>(tag & 7);
+  field.payload = nullptr;
+  field.payload_size = 0;
+
+  uint64_t value;
+  switch (field.wire_type) {
+    case kWireTypeVarint:
+      if (!ReadVarint(p, end, value)) {
+        return false;
+      }
+      break;
+    case kWireTypeFixed64:
+      if (end - p < 8) {
+        return false;
+      }
+      p += 8;
+      break;
+    case kWireTypeLengthDelimited:
+      if (!ReadVarint(p, end, value) || value > static_cast<uint64_t>(end - p)) {
+        return false;
+      }
+      field.payload = p;
+      field.payload_size = static_cast<size_t>(value);
+      p += value;
+      break;
+    case kWireTypeFixed32:
+      if (end - p < 4) {
+        return false;
+      }
+      p += 4;
+      break;
+    default:
+      return false;
+  }
+
+  field.end = p;
+  return true;
+}
+
+struct ExternalInitializerRewriter {
+  const uint8_t* file_begin;
+  std::string location;
+  size_t min_size;
+
+  bool RewriteTensor(const uint8_t* begin, const uint8_t* end, std::string& out) const {
+    const uint8_t* raw_data = nullptr;
+    size_t raw_data_size = 0;
+    WireField field;
+    for (const uint8_t* p = begin; p < end;) {
+      if (!ReadField(p, end, field)) {
+        return false;
+      }
+      if (field.field_number == kTensorProtoRawData && field.wire_type == kWireTypeLengthDelimited) {
+        raw_data = field.payload;
+        raw_data_size = field.payload_size;
+      }
+    }
+
+    if (raw_data == nullptr || raw_data_size < min_size) {
+      out.append(reinterpret_cast<const char*>(begin), end - begin);
+      return true;
+    }
+
+    for (const uint8_t* p = begin; p < end;) {
+      ReadField(p, end, field);
+      if (field.field_number != kTensorProtoRawData && field.field_number != kTensorProtoDataLocation) {
+        out.append(reinterpret_cast<const char*>(field.begin), field.end - field.begin);
+      }
+    }
+
+    const std::pair<std::string, std::string> entries[] = {
+        {"location", location},
+        {"offset", std::to_string(raw_data - file_begin)},
+        {"length", std::to_string(raw_data_size)}};
+    for (const auto& [key, value] : entries) {
+      std::string entry;
+      WriteLengthDelimited(entry, kStringStringEntryProtoKey, key);
+      WriteLengthDelimited(entry, kStringStringEntryProtoValue, value);
+      WriteLengthDelimited(out, kTensorProtoExternalData, entry);
+    }
+
+    WriteVarint(out, (static_cast<uint64_t>(kTensorProtoDataLocation) << 3) | kWireTypeVarint);
+    WriteVarint(out, TensorProto_DataLocation_EXTERNAL);
+    return true;
+  }
+
+  // Rewrites the fields of a message with the given rewriter for the payload of the field field_number.
+  template <typename Rewrite>
+  static bool RewriteField(const uint8_t* begin, const uint8_t* end, uint32_t field_number, Rewrite rewrite,
+                           std::string& out) {
+    WireField field;
+    for (const uint8_t* p = begin; p < end;) {
+      if (!ReadField(p, end, field)) {
+        return false;
+      }
+      if (field.field_number == field_number && field.wire_type == kWireTypeLengthDelimited) {
+        std::string rewritten;
+        if (!rewrite(field.payload, field.payload + field.payload_size, rewritten)) {
+          return false;
+        }
+        WriteLengthDelimited(out, field_number, rewritten);
+      } else {
+        out.append(reinterpret_cast<const char*>(field.begin), field.end - field.begin);
+      }
+    }
+    return true;
+  }
+
+  bool RewriteModel(const uint8_t* begin, const uint8_t* end, std::string& out) const {
+    const auto rewrite_tensor = [this](const uint8_t* b, const uint8_t* e, std::string& o) {
+      return RewriteTensor(b, e, o);
+    };
+    const auto rewrite_graph = [&rewrite_tensor](const uint8_t* b, const uint8_t* e, std::string& o) {
+      return RewriteField(b, e, kGraphProtoInitializer, rewrite_tensor, o);
+    };
+    return RewriteField(begin, end, kModelProtoGraph, rewrite_graph, out);
+  }
+};
+}  // namespace
+
+Status Model::Load(const PathString& file_path, ONNX_NAMESPACE::ModelProto& model_proto,
+                   size_t external_initializer_min_size) {
+  size_t file_size = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(file_path.c_str(), file_size));
+  if (file_size == 0) {
+    return Load(file_path, model_proto);
+  }
+
+  Env::MappedMemoryPtr mapped_file;
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(file_path.c_str(), 0, file_size, mapped_file));
+  const auto* file_begin = reinterpret_cast<const uint8_t*>(mapped_file.get());
+
+  // the location is relative to the directory of the model
+  const ExternalInitializerRewriter rewriter{file_begin, ToUTF8String(GetLastComponent(file_path)),
+                                             std::max<size_t>(external_initializer_min_size, 1)};
+  std::string model_bytes;
+  if (!rewriter.RewriteModel(file_begin, file_begin + file_size, model_bytes)) {
+    // let protobuf report the error
+    return Load(file_path, model_proto);
+  }
+
+  ORT_RETURN_IF(model_bytes.size() > static_cast<size_t>(std::numeric_limits<int>::max()),
+                "The model without the data of its initializers is larger than 2GB.");
+  if (!model_proto.ParseFromArray(model_bytes.data(), static_cast<int>(model_bytes.size()))) {
+    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+  }
+
+  return Status::OK();
+}
+
 GSL_SUPPRESS(r.30)  // spurious warnings. p_model is potentially reset in the internal call to Load
 GSL_SUPPRESS(r.35)
 Status Model::Load(const PathString& file_path, std::shared_ptr<Model>& p_model,
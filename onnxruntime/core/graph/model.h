@@ -215,6 +215,15 @@ class Model {
   static common::Status Load(const PathString& file_path,
                              /*out*/ ONNX_NAMESPACE::ModelProto& model_proto);
 
+  // Loads the model proto with the initializers of the main graph whose raw data has at least
+  // external_initializer_min_size bytes referencing their data in the model file as external data, instead of
+  // copying it into the proto. The file is mapped and scanned to parse the structure of the model only, and the data
+  // of these initializers is read from the file directly into their tensors when the session state is created, so
+  // the file must not be modified before that.
+  static common::Status Load(const PathString& file_path,
+                             /*out*/ ONNX_NAMESPACE::ModelProto& model_proto,
+                             size_t external_initializer_min_size);
+
   // TODO(Task:132) Use of shared_ptr<X>* in Load/Save methods is confusing.
   static common::Status Load(const PathString& file_path,
                              /*out*/ std::shared_ptr<Model>& p_model,
@@ -80,6 +80,15 @@ Abstract:
 #define MLAS_SUPPORTS_GEMM_DOUBLE
 #endif
 
+//
+// Bfloat16 precision GEMM is implemented with the BF16 instructions of ARM64
+// on Linux and with the AVX512-BF16 instructions on x64.
+//
+
+#if (defined(__aarch64__) && defined(__linux__)) || defined(MLAS_TARGET_AMD64)
+#define MLAS_SUPPORTS_SBGEMM
+#endif
+
 #if (!defined(_MSC_VER)) || (_MSC_VER >= 1930)
 #if defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_ARM64EC)
 #if !defined(__APPLE__)
@@ -193,6 +202,46 @@ MlasActivation(
     size_t ldc
     );
 
+//
+// GEMM epilogue routines.
+// C := Activation(C + Bias) + Residual
+//
+
+/**
+ * @brief Supply the element-wise operations that follow a GEMM. The epilogue
+ *        is applied to each output tile right after it is computed, while the
+ *        tile is still in cache, instead of in separate passes over matrix C.
+ */
+struct MLAS_GEMM_EPILOGUE {
+    const float* Bias = nullptr;                 /**< Supplies the optional bias, vector size N */
+    const MLAS_ACTIVATION* Activation = nullptr; /**< Supplies the optional activation applied after the bias */
+    const float* Residual = nullptr;             /**< Supplies the optional matrix added after the activation */
+    size_t ldr = 0;                              /**< Supplies the first dimension of matrix Residual. */
+};
+
+/**
+ * @brief Apply a GEMM epilogue to a tile of matrix C
+ *
+ * @param Epilogue  Supplies the epilogue to apply.
+ * @param C         Supplies the address of matrix C, not of the tile.
+ * @param StartM    Supplies the starting row of the tile.
+ * @param StartN    Supplies the starting column of the tile.
+ * @param CountM    Supplies the number of rows of the tile.
+ * @param CountN    Supplies the number of columns of the tile.
+ * @param ldc       Supplies the first dimension of matrix C.
+ */
+void
+MLASCALL
+MlasGemmEpilogue(
+    const MLAS_GEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    );
+
 //
 // Matrix/matrix multiply routines.
 // C := alpha * op(A) * op(B) + beta * C
@@ -241,6 +290,79 @@ MlasGemmBatch(
     MLAS_THREADPOOL* ThreadPool
     );
 
+/**
+ * @brief  Batched single precision matrix/matrix multiply operation (SGEMM)
+ *         with an explicit thread partition, e.g. one selected by auto-tuning,
+ *         instead of the default complexity based heuristics.
+ *
+ * @param TransA        Supplies the transpose operation for matrix A.
+ * @param TransB        Supplies the transpose operation for matrix B.
+ * @param M             Supplies the number of rows of matrix A and matrix C.
+ * @param N             Supplies the number of columns of matrix B and matrix C.
+ * @param K             Supplies the number of columns of matrix A and the number
+                        of rows of matrix B.
+ * @param Data          A array of matrices data parameters
+ * @param BatchSize     Supplies number of multiplications in this batch
+ * @param ThreadCountM  Supplies the number of partitions of every multiplication
+                        along the M dimension. It is clamped to [1, M].
+ * @param ThreadCountN  Supplies the number of partitions of every multiplication
+                        along the N dimension. It is clamped to [1, number of
+                        16 column blocks of N].
+ * @param ThreadPool    Supplies the thread pool object to use, else nullptr if the
+                        base library threading support should be used.
+ */
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    ptrdiff_t ThreadCountM,
+    ptrdiff_t ThreadCountN,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief Supply the shape and the matrices data information of one problem
+ *        of a grouped SGEMM operation
+ */
+struct MLAS_SGEMM_GROUPED_PROBLEM {
+    size_t M = 0;               /**< Supplies the number of rows of matrix A and matrix C */
+    size_t N = 0;               /**< Supplies the number of columns of matrix B and matrix C */
+    size_t K = 0;               /**< Supplies the number of columns of matrix A and rows of matrix B */
+    MLAS_SGEMM_DATA_PARAMS Data; /**< Supplies the matrices data parameters */
+};
+
+/**
+ * @brief  Grouped single precision matrix/matrix multiply operation (SGEMM)
+ *
+ *         Unlike MlasGemmBatch, every problem of the group has its own shape,
+ *         e.g. the per expert GEMMs of a mixture of experts layer. All the
+ *         problems are executed with a single parallel schedule, the threads
+ *         are distributed across the problems according to their complexity.
+ *         Problems with M or N equal to zero are skipped.
+ *
+ * @param TransA        Supplies the transpose operation for matrix A.
+ * @param TransB        Supplies the transpose operation for matrix B.
+ * @param Problems      Supplies an array of problem shapes and data parameters
+ * @param ProblemCount  Supplies the number of problems in the group
+ * @param ThreadPool    Supplies the thread pool object to use, else nullptr if the
+                        base library threading support should be used.
+ */
+void
+MLASCALL
+MlasGemmGrouped(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    const MLAS_SGEMM_GROUPED_PROBLEM* Problems,
+    size_t ProblemCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 /**
  * @brief  Single precision matrix/matrix multiply operation (SGEMM)
  *
@@ -526,13 +648,15 @@ public:
         const float* Scale,
         const float* Bias,
         MLAS_QGEMM_OUTPUT_MODE Mode = MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
-        MLAS_QUANTIZATION_GRANULARITY QuantGran = MLAS_QUANTIZATION_GRANULARITY::PerMatrix) :
+        MLAS_QUANTIZATION_GRANULARITY QuantGran = MLAS_QUANTIZATION_GRANULARITY::PerMatrix,
+        const MLAS_GEMM_EPILOGUE* Epilogue = nullptr) :
             Output_(Output),
             LeadingDimensionOutput_(LeadingDimensionOutput),
             Scale_(Scale),
             Bias_(Bias),
             OutputMode_(Mode),
-            QuantGran_(QuantGran)
+            QuantGran_(QuantGran),
+            Epilogue_(Epilogue)
     {
     }
 
@@ -566,6 +690,7 @@ private:
     const float* Bias_;
     MLAS_QGEMM_OUTPUT_MODE OutputMode_;
     MLAS_QUANTIZATION_GRANULARITY QuantGran_;
+    const MLAS_GEMM_EPILOGUE* Epilogue_;
 };
 
 /**
@@ -696,6 +821,60 @@ MlasGemmPackB(
     void* PackedB
     );
 
+//
+// Sparse single precision matrix/matrix multiply routines for a constant B
+// with mostly zero elements. B is packed once by MlasSparseGemmPackB into
+// panels of columns holding only its nonzero elements, as blocks of
+// consecutive columns when the nonzero elements are clustered or as single
+// elements otherwise.
+//
+
+size_t
+MLASCALL
+MlasSparseGemmCountNonZeros(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    );
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasSparseGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -819,6 +998,53 @@ MlasConv(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Winograd F(2x2, 3x3) convolution routines for 2D convolutions with 3x3
+// kernels, unit stride and unit dilation. The filter is transformed once by
+// MlasWinogradConvPackFilter and the convolution parameters are prepared by
+// MlasConvPrepare.
+//
+
+bool
+MLASCALL
+MlasWinogradConvSupported(
+    size_t Dimensions,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+size_t
+MLASCALL
+MlasWinogradConvPackFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+void
+MLASCALL
+MlasWinogradConvPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    );
+
+void
+MLASCALL
+MlasWinogradConv(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    const float* Bias,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasConvDepthwise(
@@ -834,6 +1060,18 @@ MlasConvDepthwise(
     size_t KernelSize
     );
 
+void
+MLASCALL
+MlasConvDepthwise(
+    const float* const* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
 //
 // Symmetric quantized integer convolution routines.
 //
@@ -977,6 +1215,45 @@ MlasMaximumPool(
     size_t KernelSize
     );
 
+/**
+ * @brief Max Pooling for fp32 NHWC
+ * @param Input         Indirect buffer to activations, nullptr entries are skipped
+ * @param Output        Address of the result tensor
+ * @param Channels      C in NHWC
+ * @param OutputCount   Number of output pixels
+ * @param KernelSize    Size of the kernel
+ * @return
+*/
+void
+MLASCALL
+MlasNhwcMaxPool(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
+/**
+ * @brief Avg Pooling for fp32 NHWC
+ * @param Input         Indirect buffer to activations, nullptr entries are
+ *                      excluded from the average
+ * @param Output        Address of the output data
+ * @param Channels      C in NHWC
+ * @param OutputCount   Number of output pixels
+ * @param KernelSize    size of the kernel
+ * @return
+*/
+void
+MLASCALL
+MlasNhwcAvgPool(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    );
+
 //
 // Miscellaneous compute routines.
 //
@@ -1016,6 +1293,63 @@ MlasComputeSoftmax(
     MLAS_THREADPOOL* ThreadPool
     );
 
+/**
+ * @brief Computes the softmax or log softmax function along the middle dimension of a tensor of shape [N, D, S],
+ *        without transposing the softmax dimension to the innermost position.
+ *        Supports in place updates of the output buffer.
+ */
+void
+MLASCALL
+MlasComputeStridedSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    size_t S,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief Computes the softmax function of Scale * Input + Mask for N rows of D columns in a single set of passes,
+ *        as in the scores of an attention. Mask has the shape of Input, or is nullptr.
+ *        Supports in place updates of the output buffer.
+ */
+void
+MLASCALL
+MlasComputeSoftmaxWithScaleAndMask(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    float Scale,
+    const float* Mask,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+/**
+ * @brief Computes the root mean square normalization (RMSNorm) of N rows of D columns of Input + Skip + Bias, adding
+ *        the residual and bias in the pass that sums the squares. Row n of the input uses row n % SkipRows of Skip.
+ *        Skip, Bias, InputSkipBiasSum (receiving Input + Skip + Bias) and InvStdDev (receiving the inverse root mean
+ *        square of each row) are optional. Supports in place updates of the output buffer.
+ */
+void
+MLASCALL
+MlasComputeRmsNorm(
+    const float* Input,
+    const float* Skip,
+    size_t SkipRows,
+    const float* Bias,
+    const float* Scale,
+    float* Output,
+    float* InputSkipBiasSum,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasComputeTanh(
@@ -1086,6 +1420,44 @@ MlasTranspose(
     size_t N
     );
 
+//
+// Transpose routines for matrices embedded in larger buffers, with the
+// distance between rows given by the input and output strides.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    size_t M,
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t M,
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -1397,6 +1769,24 @@ MlasQLinearMul(
     bool IsScalarB
     );
 
+/**
+ * @brief Maps each byte of the input through a 256 entry table, as used by the
+ *        quantized lookup table activations.
+ *
+ * @param Input     Supplies the input buffer.
+ * @param Table     Supplies the 256 entry table.
+ * @param Output    Returns the table entries of the input bytes.
+ * @param N         Supplies the number of elements to process.
+ */
+void
+MLASCALL
+MlasLookupTable(
+    const uint8_t* Input,
+    const uint8_t* Table,
+    uint8_t* Output,
+    size_t N
+    );
+
 //
 // Half precision routines
 //
@@ -1412,6 +1802,97 @@ constexpr size_t FP16_SIZE = sizeof(uint16_t);
 bool MLASCALL
 MlasFp16AccelerationSupported();
 
+/**
+ * @brief Whether current CPU has a vectorized half precision GEMM kernel
+ *        for MlasHalfGemmBatch. On x64 this is true with F16C or AVX512-FP16,
+ *        even though MlasFp16AccelerationSupported() is false.
+*/
+bool MLASCALL
+MlasHalfGemmAccelerationSupported();
+
+/**
+ * @brief Whether current CPU converts between half and single precision
+ *        with vector instructions (NEON or F16C), so that the half precision
+ *        compute routines below do not fall back to scalar conversions.
+*/
+bool MLASCALL
+MlasFp16ConversionAccelerationSupported();
+
+/**
+ * @brief Convert a buffer of single precision values to half precision,
+ *        rounding to the nearest even value.
+*/
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    );
+
+/**
+ * @brief Convert a buffer of half precision values to single precision with
+ *        the vector conversion instructions of the platform when available.
+ *        Unlike MlasConvertHalfToFloatBuffer, this is supported on all
+ *        platforms.
+*/
+void
+MLASCALL
+MlasConvertFp16ToFloatBuffer(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    );
+
+//
+// Half precision versions of the miscellaneous compute routines. The values
+// are computed in single precision by the vectorized single precision kernels,
+// converting the buffers a block at a time.
+//
+
+void
+MLASCALL
+MlasComputeErf(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeExp(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeLogistic(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeTanh(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 /**
  * @brief Interface for half gemm post processors.
  *
@@ -1614,7 +2095,7 @@ MlasHalfGemmConvertPackB(
     void* PackedB
     );
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SUPPORTS_SBGEMM)
 /**
  * @brief Whether current CPU supports Bfloat16(bf16) acceleration.
  */
@@ -17,6 +17,8 @@ Abstract:
 
 #pragma once
 
+#include "mlas.h"
+
 template<typename T>
 class MLAS_GEMM_POSTPROCESSOR
 {
@@ -31,3 +33,26 @@ class MLAS_GEMM_POSTPROCESSOR
 
     virtual ~MLAS_GEMM_POSTPROCESSOR() {}
 };
+
+/**
+ * @brief Post processor that applies a MLAS_GEMM_EPILOGUE to each output tile.
+ */
+class MLAS_GEMM_EPILOGUE_POSTPROCESSOR : public MLAS_GEMM_POSTPROCESSOR<float>
+{
+   public:
+    explicit MLAS_GEMM_EPILOGUE_POSTPROCESSOR(const MLAS_GEMM_EPILOGUE& Epilogue) : Epilogue_(Epilogue) {}
+
+    void Process(float* C,
+                 size_t RangeStartM,
+                 size_t RangeStartN,
+                 size_t RangeCountM,
+                 size_t RangeCountN,
+                 size_t ldc
+    ) const override
+    {
+        MlasGemmEpilogue(&Epilogue_, C, RangeStartM, RangeStartN, RangeCountM, RangeCountN, ldc);
+    }
+
+   private:
+    MLAS_GEMM_EPILOGUE Epilogue_;
+};
@@ -805,6 +805,140 @@ Return Value:
     }
 }
 
+void
+MlasComputeSoftmaxRowWithMaximum(
+    const float* Input,
+    float* Output,
+    size_t D,
+    bool LogSoftmax,
+    float Maximum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function for one row
+    given the maximum value of the row.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Output - Supplies the output row.
+
+    D - Supplies the number of columns of the row.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    Maximum - Supplies the maximum value of the input row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float NegativeMaximum = -Maximum;
+
+    if (LogSoftmax) {
+
+        //
+        // Compute the sum of the exponential functions for the row.
+        //
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
+        float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#else
+        float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
+#endif
+
+        //
+        // Compute the log softmax output.
+        //
+
+        float Parameters[] = { NegativeMaximum, std::log(Accumulation)};
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64) || defined(MLAS_TARGET_ARM64)
+        GetMlasPlatform().ComputeLogSoftmaxOutputF32Kernel(Input, Output, D, Parameters);
+#else
+        MlasComputeLogSoftmaxOutputF32Kernel(Input, Output, D, Parameters);
+#endif
+
+    } else {
+
+        //
+        // Compute the exponential function for each element of the row and
+        // compute the sum of these exponential functions.
+        //
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_ARM64)
+        float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
+#else
+        float Accumulation = MlasComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
+#endif
+
+        //
+        // Normalize the softmax output.
+        //
+
+        float Parameters[] = { 1.0f / Accumulation };
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64) || defined(MLAS_TARGET_ARM64)
+        GetMlasPlatform().ComputeSoftmaxOutputF32Kernel(Output, D, Parameters);
+#else
+        MlasComputeSoftmaxOutputF32Kernel(Output, D, Parameters);
+#endif
+    }
+}
+
+void
+MlasComputeSoftmaxRow(
+    const float* Input,
+    float* Output,
+    size_t D,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function for one row.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Output - Supplies the output row.
+
+    D - Supplies the number of columns of the row.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Find the maximum value for the row.
+    //
+
+#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64) || defined(MLAS_TARGET_ARM64)
+    float Maximum = GetMlasPlatform().ReduceMaximumF32Kernel(Input, D);
+#else
+    float Maximum = MlasReduceMaximumF32Kernel(Input, D);
+#endif
+
+    MlasComputeSoftmaxRowWithMaximum(Input, Output, D, LogSoftmax, Maximum);
+}
+
 void
 MlasComputeSoftmaxThreaded(
     void* Context,
@@ -868,66 +1002,7 @@ Return Value:
         }
 #endif
 
-        //
-        // Find the maximum value for the row.
-        //
-
-#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
-        float Maximum = GetMlasPlatform().ReduceMaximumF32Kernel(Input, D);
-#else
-        float Maximum = MlasReduceMaximumF32Kernel(Input, D);
-#endif
-        float NegativeMaximum = -Maximum;
-
-        if (LogSoftmax) {
-
-            //
-            // Compute the sum of the exponential functions for the row.
-            //
-
-#if defined(MLAS_TARGET_AMD64)
-            float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
-#else
-            float Accumulation = MlasComputeSumExpF32Kernel(Input, nullptr, D, &NegativeMaximum);
-#endif
-
-            //
-            // Compute the log softmax output.
-            //
-
-            float Parameters[] = { NegativeMaximum, std::log(Accumulation)};
-
-#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
-            GetMlasPlatform().ComputeLogSoftmaxOutputF32Kernel(Input, Output, D, Parameters);
-#else
-            MlasComputeLogSoftmaxOutputF32Kernel(Input, Output, D, Parameters);
-#endif
-
-        } else {
-
-            //
-            // Compute the exponential function for each element of the row and
-            // compute the sum of these exponential functions.
-            //
-
-#if defined(MLAS_TARGET_AMD64)
-            float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
-#else
-            float Accumulation = MlasComputeSumExpF32Kernel(Input, Output, D, &NegativeMaximum);
-#endif
-
-            //
-            // Normalize the softmax output.
-            //
-
-            float Parameters[] = { 1.0f / Accumulation };
-
-#if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
-            GetMlasPlatform().ComputeSoftmaxOutputF32Kernel(Output, D, Parameters);
-#else
-            MlasComputeSoftmaxOutputF32Kernel(Output, D, Parameters);
-#endif
-        }
+        MlasComputeSoftmaxRow(Input, Output, D, LogSoftmax);
 
         Input += D;
         Output += D;
@@ -1012,3 +1087,577 @@ Return Value:
 
     MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, ThreadCountN, ThreadPool);
 }
+
+//
+// Define the number of columns of a strided softmax that a work item
+// normalizes together, and the minimum number of elements a thread processes.
+//
+
+constexpr size_t MlasStridedSoftmaxBlockSize = 64;
+constexpr size_t MlasSoftmaxMinimumElementsPerThread = 16384;
+
+void
+MlasComputeStridedSoftmaxBlock(
+    const float* Input,
+    float* Output,
+    size_t D,
+    size_t S,
+    size_t CountS,
+    bool LogSoftmax
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along the D
+    dimension for a block of up to MlasStridedSoftmaxBlockSize columns. The
+    columns are contiguous, so the rows of the block are processed with
+    vector instructions.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the first column of the input block.
+
+    Output - Supplies the first column of the output block.
+
+    D - Supplies the number of rows of the block, the softmax dimension.
+
+    S - Supplies the stride between the rows.
+
+    CountS - Supplies the number of columns of the block.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float Maximum[MlasStridedSoftmaxBlockSize];
+    float Accumulation[MlasStridedSoftmaxBlockSize];
+    float Exponent[MlasStridedSoftmaxBlockSize];
+
+    const size_t CountS4 = CountS & ~size_t{3};
+
+    //
+    // Find the maximum value of each column.
+    //
+
+    std::copy_n(Input, CountS, Maximum);
+
+    for (size_t d = 1; d < D; d++) {
+
+        const float* row = Input + d * S;
+        size_t s = 0;
+
+        for (; s < CountS4; s += 4) {
+            MlasStoreFloat32x4(&Maximum[s], MlasMaximumFloat32x4(MlasLoadFloat32x4(&Maximum[s]), MlasLoadFloat32x4(row + s)));
+        }
+
+        for (; s < CountS; s++) {
+            Maximum[s] = std::max(Maximum[s], row[s]);
+        }
+    }
+
+    //
+    // Compute the exponential function of each element and the sum of these
+    // exponential functions for each column. A log softmax keeps the input
+    // for the final pass, so the exponentials are not stored to the output.
+    //
+
+    std::fill_n(Accumulation, CountS, 0.0f);
+
+    for (size_t d = 0; d < D; d++) {
+
+        const float* row = Input + d * S;
+        float* exponent = LogSoftmax ? Exponent : Output + d * S;
+        size_t s = 0;
+
+        for (; s < CountS4; s += 4) {
+            MLAS_FLOAT32X4 Vector = MlasSubtractFloat32x4(MlasLoadFloat32x4(row + s), MlasLoadFloat32x4(&Maximum[s]));
+            Vector = MlasComputeExpVector(Vector);
+            MlasStoreFloat32x4(exponent + s, Vector);
+            MlasStoreFloat32x4(&Accumulation[s], MlasAddFloat32x4(MlasLoadFloat32x4(&Accumulation[s]), Vector));
+        }
+
+        for (; s < CountS; s++) {
+            exponent[s] = std::exp(row[s] - Maximum[s]);
+            Accumulation[s] += exponent[s];
+        }
+    }
+
+    //
+    // Produce the output: the exponentials are scaled by the inverse of the
+    // sum for a softmax, and the input is offset by the maximum and the
+    // logarithm of the sum for a log softmax.
+    //
+
+    for (size_t s = 0; s < CountS; s++) {
+        Accumulation[s] = LogSoftmax ? Maximum[s] + std::log(Accumulation[s]) : 1.0f / Accumulation[s];
+    }
+
+    for (size_t d = 0; d < D; d++) {
+
+        const float* row = Input + d * S;
+        float* output = Output + d * S;
+        size_t s = 0;
+
+        if (LogSoftmax) {
+
+            for (; s < CountS4; s += 4) {
+                MlasStoreFloat32x4(output + s, MlasSubtractFloat32x4(MlasLoadFloat32x4(row + s), MlasLoadFloat32x4(&Accumulation[s])));
+            }
+
+            for (; s < CountS; s++) {
+                output[s] = row[s] - Accumulation[s];
+            }
+
+        } else {
+
+            for (; s < CountS4; s += 4) {
+                MlasStoreFloat32x4(output + s, MlasMultiplyFloat32x4(MlasLoadFloat32x4(output + s), MlasLoadFloat32x4(&Accumulation[s])));
+            }
+
+            for (; s < CountS; s++) {
+                output[s] *= Accumulation[s];
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasComputeStridedSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    size_t S,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along the middle
+    dimension of a tensor of shape [N, D, S], such as a softmax along an axis
+    that is not the innermost axis. The tensor is not transposed: blocks of
+    contiguous columns are normalized together with vector instructions.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of outer slices to process.
+
+    D - Supplies the size of the softmax dimension.
+
+    S - Supplies the number of columns of each slice, the stride between
+        consecutive elements along the softmax dimension.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (S == 1) {
+        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, ThreadPool);
+        return;
+    }
+
+    const size_t BlockCountS = MlasDivRoundup(S, MlasStridedSoftmaxBlockSize);
+    const size_t BlockCount = N * BlockCountS;
+
+    //
+    // Limit the number of threads to the number of blocks and try to keep each
+    // thread processing a minimum number of elements before using another
+    // thread.
+    //
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > BlockCount) {
+        ThreadCount = ptrdiff_t(BlockCount);
+    }
+
+    const size_t TargetThreadCount = ((N * D * S) / MlasSoftmaxMinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > TargetThreadCount) {
+        ThreadCount = ptrdiff_t(TargetThreadCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t Block;
+        size_t CountBlocks;
+
+        MlasPartitionWork(tid, ThreadCount, BlockCount, &Block, &CountBlocks);
+
+        for (; CountBlocks > 0; CountBlocks--, Block++) {
+
+            const size_t n = Block / BlockCountS;
+            const size_t s = (Block % BlockCountS) * MlasStridedSoftmaxBlockSize;
+            const size_t Offset = n * D * S + s;
+
+            MlasComputeStridedSoftmaxBlock(Input + Offset, Output + Offset, D, S,
+                                           std::min(MlasStridedSoftmaxBlockSize, S - s), LogSoftmax);
+        }
+    });
+}
+
+float
+MlasComputeScaleAddMaximum(
+    const float* Input,
+    const float* Mask,
+    float* Output,
+    size_t D,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Scale * Input + Mask for one row and returns the
+    maximum value of the result.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Mask - Supplies the additive mask row, else nullptr.
+
+    Output - Supplies the output row.
+
+    D - Supplies the number of columns of the row.
+
+    Scale - Supplies the scale applied to the input.
+
+Return Value:
+
+    Returns the maximum value of the output row.
+
+--*/
+{
+    const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+    MLAS_FLOAT32X4 MaximumVector = MlasBroadcastFloat32x4(MlasMinimumF32Value);
+
+    size_t d = 0;
+
+    if (Mask != nullptr) {
+
+        for (; d + 4 <= D; d += 4) {
+            MLAS_FLOAT32X4 Vector = MlasMultiplyAddFloat32x4(ScaleVector, MlasLoadFloat32x4(Input + d), MlasLoadFloat32x4(Mask + d));
+            MlasStoreFloat32x4(Output + d, Vector);
+            MaximumVector = MlasMaximumFloat32x4(MaximumVector, Vector);
+        }
+
+    } else {
+
+        for (; d + 4 <= D; d += 4) {
+            MLAS_FLOAT32X4 Vector = MlasMultiplyFloat32x4(ScaleVector, MlasLoadFloat32x4(Input + d));
+            MlasStoreFloat32x4(Output + d, Vector);
+            MaximumVector = MlasMaximumFloat32x4(MaximumVector, Vector);
+        }
+    }
+
+    float Maximum = MlasReduceMaximumFloat32x4(MaximumVector);
+
+    for (; d < D; d++) {
+        Output[d] = Scale * Input[d] + (Mask != nullptr ? Mask[d] : 0.0f);
+        Maximum = std::max(Maximum, Output[d]);
+    }
+
+    return Maximum;
+}
+
+void
+MLASCALL
+MlasComputeSoftmaxWithScaleAndMask(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    float Scale,
+    const float* Mask,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax function of Scale * Input + Mask. The
+    scale and the additive mask are applied in the pass that finds the
+    maximum of each row, instead of in separate passes over the buffer.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    Scale - Supplies the scale applied to the input.
+
+    Mask - Supplies the additive mask with the shape of the input, else
+        nullptr.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > N) {
+        ThreadCount = ptrdiff_t(N);
+    }
+
+    const size_t TargetThreadCount = ((N * D) / MlasSoftmaxMinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > TargetThreadCount) {
+        ThreadCount = ptrdiff_t(TargetThreadCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t n;
+        size_t CountN;
+
+        MlasPartitionWork(tid, ThreadCount, N, &n, &CountN);
+
+        for (; CountN > 0; CountN--, n++) {
+
+            const float* Row = Input + n * D;
+            float* OutputRow = Output + n * D;
+
+            float Maximum = MlasComputeScaleAddMaximum(Row, Mask != nullptr ? Mask + n * D : nullptr, OutputRow, D, Scale);
+
+            MlasComputeSoftmaxRowWithMaximum(OutputRow, OutputRow, D, false, Maximum);
+        }
+    });
+}
+
+void
+MlasComputeRmsNormRow(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    const float* Scale,
+    float* Output,
+    float* InputSkipBiasSum,
+    float* InvStdDev,
+    size_t D,
+    float Epsilon
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the root mean square normalization of one row of
+    Input + Skip + Bias.
+
+Arguments:
+
+    See MlasComputeRmsNorm, for a single row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    //
+    // Sum the row and accumulate its sum of squares. The sum is stored to the
+    // output and normalized in place below.
+    //
+
+    float* Sum = (InputSkipBiasSum != nullptr) ? InputSkipBiasSum : Output;
+
+    MLAS_FLOAT32X4 SquareSum0 = MlasZeroFloat32x4();
+    MLAS_FLOAT32X4 SquareSum1 = MlasZeroFloat32x4();
+
+    size_t d = 0;
+
+    for (; d + 8 <= D; d += 8) {
+
+        MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input + d);
+        MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + d + 4);
+
+        if (Skip != nullptr) {
+            Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Skip + d));
+            Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(Skip + d + 4));
+        }
+
+        if (Bias != nullptr) {
+            Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Bias + d));
+            Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(Bias + d + 4));
+        }
+
+        MlasStoreFloat32x4(Sum + d, Vector0);
+        MlasStoreFloat32x4(Sum + d + 4, Vector1);
+
+        SquareSum0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SquareSum0);
+        SquareSum1 = MlasMultiplyAddFloat32x4(Vector1, Vector1, SquareSum1);
+    }
+
+    float SquareSum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SquareSum0, SquareSum1));
+
+    for (; d < D; d++) {
+
+        float Value = Input[d] + (Skip != nullptr ? Skip[d] : 0.0f) + (Bias != nullptr ? Bias[d] : 0.0f);
+
+        Sum[d] = Value;
+        SquareSum += Value * Value;
+    }
+
+    const float InvRms = 1.0f / std::sqrt(SquareSum / float(D) + Epsilon);
+
+    if (InvStdDev != nullptr) {
+        *InvStdDev = InvRms;
+    }
+
+    //
+    // Normalize the row.
+    //
+
+    const MLAS_FLOAT32X4 InvRmsVector = MlasBroadcastFloat32x4(InvRms);
+
+    d = 0;
+
+    for (; d + 4 <= D; d += 4) {
+        MLAS_FLOAT32X4 Vector = MlasMultiplyFloat32x4(MlasLoadFloat32x4(Sum + d), InvRmsVector);
+        MlasStoreFloat32x4(Output + d, MlasMultiplyFloat32x4(Vector, MlasLoadFloat32x4(Scale + d)));
+    }
+
+    for (; d < D; d++) {
+        Output[d] = Sum[d] * InvRms * Scale[d];
+    }
+}
+
+void
+MLASCALL
+MlasComputeRmsNorm(
+    const float* Input,
+    const float* Skip,
+    size_t SkipRows,
+    const float* Bias,
+    const float* Scale,
+    float* Output,
+    float* InputSkipBiasSum,
+    float* InvStdDev,
+    size_t N,
+    size_t D,
+    float Epsilon,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the root mean square normalization (RMSNorm) of the
+    rows of Input + Skip + Bias:
+
+        Output = X / sqrt(mean(X * X) + Epsilon) * Scale
+
+    The residual and bias are added in the pass that accumulates the sum of
+    squares, so each row is read from memory once and normalized while it is
+    in cache.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer of N rows of D elements.
+
+    Skip - Supplies the residual added to the input, else nullptr. Row n of
+        the input is added to row n % SkipRows of the residual.
+
+    SkipRows - Supplies the number of rows of the residual.
+
+    Bias - Supplies the bias of D elements added to every row, else nullptr.
+
+    Scale - Supplies the scale of D elements.
+
+    Output - Supplies the output buffer.
+
+    InputSkipBiasSum - Supplies the buffer receiving Input + Skip + Bias,
+        else nullptr.
+
+    InvStdDev - Supplies the buffer receiving the inverse root mean square
+        of each row, else nullptr.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    Epsilon - Supplies the value added to the mean square.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > N) {
+        ThreadCount = ptrdiff_t(N);
+    }
+
+    const size_t TargetThreadCount = ((N * D) / MlasSoftmaxMinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCount) > TargetThreadCount) {
+        ThreadCount = ptrdiff_t(TargetThreadCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t n;
+        size_t CountN;
+
+        MlasPartitionWork(tid, ThreadCount, N, &n, &CountN);
+
+        for (; CountN > 0; CountN--, n++) {
+
+            MlasComputeRmsNormRow(Input + n * D,
+                                  Skip != nullptr ? Skip + (n % SkipRows) * D : nullptr,
+                                  Bias,
+                                  Scale,
+                                  Output + n * D,
+                                  InputSkipBiasSum != nullptr ? InputSkipBiasSum + n * D : nullptr,
+                                  InvStdDev != nullptr ? InvStdDev + n : nullptr,
+                                  D,
+                                  Epsilon);
+        }
+    });
+}
@@ -0,0 +1,387 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute_fp16.cpp
+
+Abstract:
+
+    This module implements the half precision versions of the elementwise
+    transcendental functions and of the softmax operation.
+
+    The values are computed by the vectorized single precision kernels of the
+    platform. A block of the input that fits in the L1 cache is converted to
+    single precision with the vector conversion instructions (NEON or F16C),
+    computed, and converted back, so there is no scalar conversion loop and
+    the results have single precision accuracy before rounding.
+
+--*/
+
+#include "mlasi.h"
+#include "mlas_float16.h"
+
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+#include "fp16_common.h"
+#endif
+
+//
+// Define the number of elements converted to single precision at a time.
+//
+
+constexpr size_t MlasFp16ComputeBlockSize = 1024;
+
+MLAS_FORCEINLINE
+void
+MlasConvertHalfToFloatBlock(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+    const auto* Input = reinterpret_cast<const _mlas_fp16_*>(Source);
+
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+    while (Count >= 8) {
+        MLAS_FLOAT16X8 Vector = MlasLoadFloat16x8(Input);
+        vst1q_f32(Destination, vcvt_f32_f16(vget_low_f16(Vector)));
+        vst1q_f32(Destination + 4, vcvt_high_f32_f16(Vector));
+        Input += 8;
+        Destination += 8;
+        Count -= 8;
+    }
+
+    while (Count > 0) {
+        *Destination++ = MLAS_Half2Float(*Input++);
+        Count--;
+    }
+#else
+    MlasConvertHalfToFloatBuffer(Input, Destination, Count);
+#endif
+}
+
+void
+MLASCALL
+MlasConvertFloatToHalfBuffer(
+    const float* Source,
+    MLAS_FP16* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of single precision values to half
+    precision, rounding to the nearest even value.
+
+Arguments:
+
+    Source - Supplies the single precision buffer.
+
+    Destination - Supplies the half precision buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    auto* Output = reinterpret_cast<_mlas_fp16_*>(Destination);
+
+#if defined(MLAS_TARGET_AMD64)
+    if (GetMlasPlatform().ConvertFloatToHalfKernel != nullptr) {
+        GetMlasPlatform().ConvertFloatToHalfKernel(Source, Output, Count);
+        return;
+    }
+#elif defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+    while (Count >= 8) {
+        const float16x4_t Low = vcvt_f16_f32(vld1q_f32(Source));
+        MlasStoreFloat16x8(Output, vcvt_high_f16_f32(Low, vld1q_f32(Source + 4)));
+        Source += 8;
+        Output += 8;
+        Count -= 8;
+    }
+#endif
+
+    while (Count > 0) {
+        *Output++ = MLAS_Float2Half(*Source++);
+        Count--;
+    }
+}
+
+void
+MLASCALL
+MlasConvertFp16ToFloatBuffer(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+/*++
+
+Routine Description:
+
+    This routine converts a buffer of half precision values to single
+    precision.
+
+Arguments:
+
+    Source - Supplies the half precision buffer.
+
+    Destination - Supplies the single precision buffer.
+
+    Count - Supplies the number of elements to convert.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvertHalfToFloatBlock(Source, Destination, Count);
+}
+
+bool
+MLASCALL
+MlasFp16ConversionAccelerationSupported()
+{
+#if defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().ConvertFloatToHalfKernel != nullptr;
+#elif defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+    return true;
+#else
+    return false;
+#endif
+}
+
+template<void (MLASCALL* ComputeRoutine)(const float*, float*, size_t)>
+void
+MlasComputeFp16Elementwise(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a single precision elementwise function for a half
+    precision buffer, a block at a time.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_DECLSPEC_ALIGN(float Buffer[MlasFp16ComputeBlockSize], 64);
+
+    while (N > 0) {
+
+        const size_t CountN = std::min(N, MlasFp16ComputeBlockSize);
+
+        MlasConvertHalfToFloatBlock(Input, Buffer, CountN);
+        ComputeRoutine(Buffer, Buffer, CountN);
+        MlasConvertFloatToHalfBuffer(Buffer, Output, CountN);
+
+        Input += CountN;
+        Output += CountN;
+        N -= CountN;
+    }
+}
+
+void
+MLASCALL
+MlasComputeErf(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    )
+{
+    MlasComputeFp16Elementwise<MlasComputeErf>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    )
+{
+    MlasComputeFp16Elementwise<MlasComputeExp>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeLogistic(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    )
+{
+    MlasComputeFp16Elementwise<MlasComputeLogistic>(Input, Output, N);
+}
+
+void
+MLASCALL
+MlasComputeTanh(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N
+    )
+{
+    MlasComputeFp16Elementwise<MlasComputeTanh>(Input, Output, N);
+}
+
+//
+// Define the parameters to execute segments of a half precision softmax
+// operation on worker threads.
+//
+
+struct MLAS_SOFTMAX_FP16_WORK_BLOCK {
+    ptrdiff_t ThreadCountN;
+    bool LogSoftmax;
+    const MLAS_FP16* Input;
+    MLAS_FP16* Output;
+    size_t N;
+    size_t D;
+};
+
+void
+MlasComputeSoftmaxFp16Threaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    half precision softmax or log softmax operation.
+
+    Each row is converted to single precision into a per thread buffer, so
+    that the row is read from memory once.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_FP16_WORK_BLOCK*)Context;
+
+    size_t n;
+    size_t CountN;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCountN, WorkBlock->N, &n, &CountN);
+
+    const size_t D = WorkBlock->D;
+    const bool LogSoftmax = WorkBlock->LogSoftmax;
+
+    const MLAS_FP16* Input = WorkBlock->Input + n * D;
+    MLAS_FP16* Output = WorkBlock->Output + n * D;
+
+    MlasThreadedBufAlloc(UpAlignSize(D * sizeof(float)));
+    float* Buffer = reinterpret_cast<float*>(ThreadedBufHolder.get());
+
+    while (CountN > 0) {
+
+        MlasConvertHalfToFloatBlock(Input, Buffer, D);
+        MlasComputeSoftmaxRow(Buffer, Buffer, D, LogSoftmax);
+        MlasConvertFloatToHalfBuffer(Buffer, Output, D);
+
+        Input += D;
+        Output += D;
+        CountN--;
+    }
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const MLAS_FP16* Input,
+    MLAS_FP16* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the half precision softmax or log softmax function.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of columns per row to process.
+
+    LogSoftmax - Supplies true if this is a log softmax operation, else false
+        if this is a softmax operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_SOFTMAX_FP16_WORK_BLOCK WorkBlock;
+
+    WorkBlock.LogSoftmax = LogSoftmax;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+
+    //
+    // Use the thread count of the single precision operation.
+    //
+
+    ptrdiff_t ThreadCountN = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCountN) > N) {
+        ThreadCountN = ptrdiff_t(N);
+    }
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    size_t BlockCount = ((N * D) / MinimumElementsPerThread) + 1;
+
+    if (size_t(ThreadCountN) > BlockCount) {
+        ThreadCountN = ptrdiff_t(BlockCount);
+    }
+
+    WorkBlock.ThreadCountN = ThreadCountN;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxFp16Threaded, &WorkBlock, ThreadCountN, ThreadPool);
+}
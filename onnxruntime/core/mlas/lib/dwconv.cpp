@@ -10,7 +10,8 @@ Module Name:
 
 Abstract:
 
-    This module implements the half precision floating point depthwise convolution routines.
+    This module implements the half and single precision floating point
+    depthwise convolution routines for channels last tensors.
 
 --*/
 
@@ -152,3 +153,100 @@ MlasConvDepthwise(
         KernelSize,
         PostProc);
 }
+
+void
+MLASCALL
+MlasConvDepthwise(
+    const float* const* Input,
+    const float* Filter,
+    const float* Bias,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision depthwise convolution
+    operation for channels last tensors.
+
+    The input is supplied as an indirection buffer. Every pointer in the
+    indirection buffer points at a Channels length vector (either from the
+    input tensor or a vector of padding values). These are grouped in batches
+    of length KernelSize that are processed by the kernel to produce a single
+    output of length Channels. These batches are then repeated OutputCount
+    times.
+
+Arguments:
+
+    Input - Supplies an indirection buffer to the elements of the input tensor.
+
+    Filter - Supplies the filter tensor in [KernelSize][Channels] order.
+
+    Bias - Optionally supplies the per channel bias vector.
+
+    Output - Supplies the output tensor in channels last format.
+
+    Channels - Supplies the number of channels.
+
+    OutputCount - Supplies the number of channel sized output elements to
+        produce.
+
+    KernelSize - Supplies the total number of channel sized kernel elements to
+        consume.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (OutputCount > 0) {
+
+        size_t ChannelOffset = 0;
+        size_t c = Channels;
+
+        while (c >= 4) {
+
+            MLAS_FLOAT32X4 Accumulator = (Bias != nullptr) ?
+                MlasLoadFloat32x4(&Bias[ChannelOffset]) : MlasZeroFloat32x4();
+            size_t ChannelKernelOffset = ChannelOffset;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                MLAS_FLOAT32X4 InputVector = MlasLoadFloat32x4(&Input[k][ChannelOffset]);
+                MLAS_FLOAT32X4 FilterVector = MlasLoadFloat32x4(&Filter[ChannelKernelOffset]);
+
+                Accumulator = MlasMultiplyAddFloat32x4(InputVector, FilterVector, Accumulator);
+                ChannelKernelOffset += Channels;
+            }
+
+            MlasStoreFloat32x4(Output, Accumulator);
+            Output += 4;
+
+            ChannelOffset += 4;
+            c -= 4;
+        }
+
+        while (c > 0) {
+
+            float Accumulator = (Bias != nullptr) ? Bias[ChannelOffset] : 0.0f;
+            size_t ChannelKernelOffset = ChannelOffset;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+                Accumulator += Input[k][ChannelOffset] * Filter[ChannelKernelOffset];
+                ChannelKernelOffset += Channels;
+            }
+
+            *Output++ = Accumulator;
+
+            ChannelOffset += 1;
+            c -= 1;
+        }
+
+        Input += KernelSize;
+        OutputCount -= 1;
+    }
+}
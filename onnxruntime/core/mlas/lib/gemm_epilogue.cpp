@@ -0,0 +1,108 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    gemm_epilogue.cpp
+
+Abstract:
+
+    This module implements the epilogue that follows a GEMM: a bias add, an
+    activation and a residual add applied to a tile of the output matrix.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+void
+MlasGemmEpilogueAddVector(
+    float* Output,
+    const float* Input,
+    size_t CountN
+    )
+{
+    while (CountN >= 4) {
+        MlasStoreFloat32x4(Output, MlasAddFloat32x4(MlasLoadFloat32x4(Output), MlasLoadFloat32x4(Input)));
+        Output += 4;
+        Input += 4;
+        CountN -= 4;
+    }
+
+    for (size_t n = 0; n < CountN; n++) {
+        Output[n] += Input[n];
+    }
+}
+
+void
+MLASCALL
+MlasGemmEpilogue(
+    const MLAS_GEMM_EPILOGUE* Epilogue,
+    float* C,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine computes C := Activation(C + Bias) + Residual for a tile of
+    matrix C. The tile is processed one row at a time so that each row is
+    read and written once while it is still in cache.
+
+Arguments:
+
+    Epilogue - Supplies the epilogue to apply.
+
+    C - Supplies the address of matrix C.
+
+    StartM - Supplies the starting row offset of the tile.
+
+    StartN - Supplies the starting column offset of the tile.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float* Bias = (Epilogue->Bias != nullptr) ? Epilogue->Bias + StartN : nullptr;
+    const float* Residual =
+        (Epilogue->Residual != nullptr) ? Epilogue->Residual + StartM * Epilogue->ldr + StartN : nullptr;
+    const MLAS_ACTIVATION* Activation =
+        (Epilogue->Activation != nullptr && Epilogue->Activation->ActivationKind != MlasIdentityActivation)
+            ? Epilogue->Activation
+            : nullptr;
+
+    C += StartM * ldc + StartN;
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        if (Bias != nullptr) {
+            MlasGemmEpilogueAddVector(C, Bias, CountN);
+        }
+
+        if (Activation != nullptr) {
+            MlasActivation(Activation, C, nullptr, 1, CountN, CountN);
+        }
+
+        if (Residual != nullptr) {
+            MlasGemmEpilogueAddVector(C, Residual, CountN);
+            Residual += Epilogue->ldr;
+        }
+
+        C += ldc;
+    }
+}
@@ -0,0 +1,298 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements half precision GEMM kernel for AVX2.
+
+    AVX2 has no half precision arithmetic, so the kernel converts A and B to
+    single precision with F16C, accumulates in single precision with FMA3 and
+    converts the results back to half precision when storing matrix C.
+
+    This file must be compiled with AVX2, FMA3 and F16C enabled
+    (e.g. -mavx2 -mfma -mf16c), like the other AVX2 kernels.
+
+--*/
+
+#include <cstring>
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#if defined(MLAS_TARGET_AMD64)
+
+struct MLAS_HALF_GEMM_KERNEL_AVX2 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+//
+// Number of half precision values converted by a single F16C instruction.
+//
+constexpr size_t MlasHalfGemmVectorWidthAvx2 = 8;
+
+MLAS_FORCEINLINE
+__m256
+MlasHalfGemmLoadAvx2(const _mlas_fp16_* src, size_t len)
+{
+    if (len >= MlasHalfGemmVectorWidthAvx2) {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+    }
+
+    MLAS_DECLSPEC_ALIGN(_mlas_fp16_ buf[MlasHalfGemmVectorWidthAvx2], 16) = {};
+    std::memcpy(buf, src, len * FP16_SIZE);
+    return _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(buf)));
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmStoreAvx2(_mlas_fp16_* dest, __m256 value, size_t len)
+{
+    const __m128i half = _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT);
+
+    if (len >= MlasHalfGemmVectorWidthAvx2) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), half);
+        return;
+    }
+
+    MLAS_DECLSPEC_ALIGN(_mlas_fp16_ buf[MlasHalfGemmVectorWidthAvx2], 16);
+    _mm_store_si128(reinterpret_cast<__m128i*>(buf), half);
+    std::memcpy(dest, buf, len * FP16_SIZE);
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertFloatAvx2(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+)
+{
+    while (len >= MlasHalfGemmVectorWidthAvx2) {
+        MlasHalfGemmStoreAvx2(dest, _mm256_loadu_ps(src), MlasHalfGemmVectorWidthAvx2);
+        src += MlasHalfGemmVectorWidthAvx2;
+        dest += MlasHalfGemmVectorWidthAvx2;
+        len -= MlasHalfGemmVectorWidthAvx2;
+    }
+
+    if (len > 0) {
+        MLAS_DECLSPEC_ALIGN(float buf[MlasHalfGemmVectorWidthAvx2], 32) = {};
+        std::memcpy(buf, src, len * sizeof(float));
+        MlasHalfGemmStoreAvx2(dest, _mm256_load_ps(buf), len);
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertFloat2DAvx2(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        const size_t len = CntRow * CntCol;
+        MlasHalfGemmConvertFloatAvx2(dest, src, len);
+        return;
+    }
+    while (CntRow > 0) {
+        MlasHalfGemmConvertFloatAvx2(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    MlasHalfGemmConvertFloat2DAvx2(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    MlasHalfGemmConvertFloat2DAvx2(D, B, ldb, CountK, CountN);
+}
+
+/*
+    This routine computes RowCount rows of up to VectorCount * 8 columns of
+    matrix C. Each value of a row of matrix A is broadcast against the vectors
+    of a row of matrix B.
+*/
+template <size_t RowCount, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmComputeBlockAvx2(
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    bool ZeroMode
+    )
+{
+    __m256 Accumulators[RowCount][VectorCount];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            Accumulators[r][v] = _mm256_setzero_ps();
+        }
+    }
+
+    for (size_t k = 0; k < CountK; k++) {
+        __m256 BElements[VectorCount];
+        for (size_t v = 0; v < VectorCount; v++) {
+            BElements[v] = MlasHalfGemmLoadAvx2(B + v * MlasHalfGemmVectorWidthAvx2,
+                                                CountN - v * MlasHalfGemmVectorWidthAvx2);
+        }
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m256 AElement = _mm256_cvtph_ps(_mm_set1_epi16(short(A[r * lda + k])));
+            for (size_t v = 0; v < VectorCount; v++) {
+                Accumulators[r][v] = _mm256_fmadd_ps(AElement, BElements[v], Accumulators[r][v]);
+            }
+        }
+        B += ldb;
+    }
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        const size_t StartN = v * MlasHalfGemmVectorWidthAvx2;
+        const size_t len = CountN - StartN;
+        const __m256 BiasVector = (Bias != nullptr) ? MlasHalfGemmLoadAvx2(Bias + StartN, len)
+                                                    : _mm256_setzero_ps();
+        for (size_t r = 0; r < RowCount; r++) {
+            _mlas_fp16_* c = C + r * ldc + StartN;
+            __m256 Result = _mm256_add_ps(Accumulators[r][v], BiasVector);
+            if (!ZeroMode) {
+                Result = _mm256_add_ps(Result, MlasHalfGemmLoadAvx2(c, len));
+            }
+            MlasHalfGemmStoreAvx2(c, Result, len);
+        }
+    }
+}
+
+template <size_t RowCount>
+void
+MlasHalfGemmComputeRowsAvx2(
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    bool ZeroMode
+    )
+{
+    constexpr size_t WideVectorCount = 2;
+    constexpr size_t WideCountN = WideVectorCount * MlasHalfGemmVectorWidthAvx2;
+
+    size_t n = 0;
+    for (; CountN - n >= WideCountN; n += WideCountN) {
+        MlasHalfGemmComputeBlockAvx2<RowCount, WideVectorCount>(
+            A, lda, B + n, ldb, WideCountN, CountK, C + n, ldc,
+            Bias != nullptr ? Bias + n : nullptr, ZeroMode);
+    }
+    for (; n < CountN; n += MlasHalfGemmVectorWidthAvx2) {
+        MlasHalfGemmComputeBlockAvx2<RowCount, 1>(
+            A, lda, B + n, ldb, CountN - n, CountK, C + n, ldc,
+            Bias != nullptr ? Bias + n : nullptr, ZeroMode);
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM)) {
+        case 6:
+            MlasHalfGemmComputeRowsAvx2<6>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmComputeRowsAvx2<5>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmComputeRowsAvx2<4>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmComputeRowsAvx2<3>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmComputeRowsAvx2<2>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmComputeRowsAvx2<1>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    MLAS_HALF_GEMM_KERNEL_AVX2::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM,
+    0  // kernel does not read beyond buffer end
+};
+
+void
+MLASCALL
+MlasConvertFloatToHalfKernelF16C(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    )
+{
+    MlasHalfGemmConvertFloatAvx2(Destination, Source, Count);
+}
+#endif  // defined(MLAS_TARGET_AMD64)
@@ -0,0 +1,274 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx512fp16.cpp
+
+Abstract:
+
+    This module implements half precision GEMM kernel for AVX512-FP16.
+
+    Like the NEON kernel, the kernel multiplies and accumulates in half
+    precision: each value of a row of matrix A is broadcast against up to four
+    vectors of 32 half precision values of a row of matrix B.
+
+    This file must be compiled with AVX512F, AVX512BW, AVX512VL and
+    AVX512-FP16 enabled (e.g. -mavx512f -mavx512bw -mavx512vl -mavx512fp16),
+    like the other AVX512 kernels.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+#if defined(MLAS_TARGET_AMD64)
+
+struct MLAS_HALF_GEMM_KERNEL_AVX512FP16 {
+    static constexpr bool PackNeeded = false;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+//
+// Number of half precision values in a vector.
+//
+constexpr size_t MlasHalfGemmVectorWidthAvx512Fp16 = 32;
+
+MLAS_FORCEINLINE
+__mmask32
+MlasHalfGemmColumnMaskAvx512Fp16(size_t CountN)
+{
+    return CountN >= 32 ? __mmask32(0xFFFFFFFF) : __mmask32((1u << CountN) - 1);
+}
+
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertFloatAvx512Fp16(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+)
+{
+    while (len > 0) {
+        const __mmask16 Mask = len >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << len) - 1);
+        const __m512 Values = _mm512_maskz_loadu_ps(Mask, src);
+        _mm256_mask_storeu_epi16(dest, Mask, _mm512_cvtps_ph(Values, _MM_FROUND_TO_NEAREST_INT));
+        const size_t Converted = std::min(len, size_t(16));
+        src += Converted;
+        dest += Converted;
+        len -= Converted;
+    }
+}
+
+/**
+ * @brief Convert a 2D matrix from float to fp16
+*/
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertFloat2DAvx512Fp16(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t stride,
+    size_t CntRow,
+    size_t CntCol
+    )
+{
+    if (stride == CntCol) {
+        const size_t len = CntRow * CntCol;
+        MlasHalfGemmConvertFloatAvx512Fp16(dest, src, len);
+        return;
+    }
+    while (CntRow > 0) {
+        MlasHalfGemmConvertFloatAvx512Fp16(dest, src, CntCol);
+        src += stride;
+        dest += CntCol;
+        CntRow--;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    MlasHalfGemmConvertFloat2DAvx512Fp16(D, A, lda, CountM, CountK);
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    MlasHalfGemmConvertFloat2DAvx512Fp16(D, B, ldb, CountK, CountN);
+}
+
+MLAS_FORCEINLINE
+__m512h
+MlasHalfGemmLoadAvx512Fp16(const _mlas_fp16_* src, __mmask32 Mask)
+{
+    return _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Mask, src));
+}
+
+/*
+    This routine computes RowCount rows of up to VectorCount * 32 columns of
+    matrix C.
+*/
+template <size_t RowCount, size_t VectorCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmComputeBlockAvx512Fp16(
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    bool ZeroMode
+    )
+{
+    __mmask32 ColumnMasks[VectorCount];
+    __m512h Accumulators[RowCount][VectorCount];
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        ColumnMasks[v] = MlasHalfGemmColumnMaskAvx512Fp16(CountN - v * MlasHalfGemmVectorWidthAvx512Fp16);
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t v = 0; v < VectorCount; v++) {
+            Accumulators[r][v] = _mm512_setzero_ph();
+        }
+    }
+
+    for (size_t k = 0; k < CountK; k++) {
+        __m512h BElements[VectorCount];
+        for (size_t v = 0; v < VectorCount; v++) {
+            BElements[v] = MlasHalfGemmLoadAvx512Fp16(B + v * MlasHalfGemmVectorWidthAvx512Fp16, ColumnMasks[v]);
+        }
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m512h AElement = _mm512_castsi512_ph(_mm512_set1_epi16(short(A[r * lda + k])));
+            for (size_t v = 0; v < VectorCount; v++) {
+                Accumulators[r][v] = _mm512_fmadd_ph(AElement, BElements[v], Accumulators[r][v]);
+            }
+        }
+        B += ldb;
+    }
+
+    for (size_t v = 0; v < VectorCount; v++) {
+        const size_t StartN = v * MlasHalfGemmVectorWidthAvx512Fp16;
+        if (Bias != nullptr) {
+            const __m512h BiasVector = MlasHalfGemmLoadAvx512Fp16(Bias + StartN, ColumnMasks[v]);
+            for (size_t r = 0; r < RowCount; r++) {
+                Accumulators[r][v] = _mm512_add_ph(Accumulators[r][v], BiasVector);
+            }
+        }
+        for (size_t r = 0; r < RowCount; r++) {
+            _mlas_fp16_* c = C + r * ldc + StartN;
+            __m512h Result = Accumulators[r][v];
+            if (!ZeroMode) {
+                Result = _mm512_add_ph(Result, MlasHalfGemmLoadAvx512Fp16(c, ColumnMasks[v]));
+            }
+            _mm512_mask_storeu_epi16(c, ColumnMasks[v], _mm512_castph_si512(Result));
+        }
+    }
+}
+
+template <size_t RowCount>
+void
+MlasHalfGemmComputeRowsAvx512Fp16(
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    bool ZeroMode
+    )
+{
+    constexpr size_t WideVectorCount = 4;
+    constexpr size_t WideCountN = WideVectorCount * MlasHalfGemmVectorWidthAvx512Fp16;
+
+    size_t n = 0;
+    for (; CountN - n >= WideCountN; n += WideCountN) {
+        MlasHalfGemmComputeBlockAvx512Fp16<RowCount, WideVectorCount>(
+            A, lda, B + n, ldb, WideCountN, CountK, C + n, ldc,
+            Bias != nullptr ? Bias + n : nullptr, ZeroMode);
+    }
+    for (; n < CountN; n += MlasHalfGemmVectorWidthAvx512Fp16) {
+        MlasHalfGemmComputeBlockAvx512Fp16<RowCount, 1>(
+            A, lda, B + n, ldb, CountN - n, CountK, C + n, ldc,
+            Bias != nullptr ? Bias + n : nullptr, ZeroMode);
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM)) {
+        case 6:
+            MlasHalfGemmComputeRowsAvx512Fp16<6>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmComputeRowsAvx512Fp16<5>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmComputeRowsAvx512Fp16<4>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmComputeRowsAvx512Fp16<3>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmComputeRowsAvx512Fp16<2>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmComputeRowsAvx512Fp16<1>(A, lda, B, ldb, CountN, CountK, C, ldc, Bias, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    nullptr,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM,
+    0  // kernel does not read beyond buffer end
+};
+#endif  // defined(MLAS_TARGET_AMD64)
@@ -191,6 +191,8 @@ class MLASCPUIDInfo
 
     bool HasArmNeon_I8MM() const { return has_arm_neon_i8mm_; }
 
+    bool HasArmSVE() const { return has_arm_sve_; }
+
     bool HasArmSVE_I8MM() const { return has_arm_sve_i8mm_; }
 
     bool HasArmNeon_BF16() const { return has_arm_neon_bf16_; }
@@ -201,6 +203,7 @@ class MLASCPUIDInfo
     bool has_arm_neon_dot_{false};
     bool has_fp16_{false};
     bool has_arm_neon_i8mm_{false};
+    bool has_arm_sve_{false};
     bool has_arm_sve_i8mm_{false};
     bool has_arm_neon_bf16_{false};
 };
@@ -428,6 +431,31 @@ void
     float beta
     );
 
+typedef
+void
+(MLASCALL MLAS_CONVERT_FLOAT_TO_HALF_KERNEL)(
+    const float* Source,
+    unsigned short* Destination,
+    size_t Count
+    );
+
+typedef
+bool
+(MLASCALL MLAS_SGEMM_SKINNY_KERNEL_ROUTINE)(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    );
+
 typedef
 void
 (MLASCALL MLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE)(
@@ -747,6 +775,8 @@ extern "C" {
 #if defined(__aarch64__) && defined(__linux__)
     MLAS_SBGEMM_FLOAT_KERNEL MlasSbgemmKernelZero;
     MLAS_SBGEMM_FLOAT_KERNEL MlasSbgemmKernelAdd;
+    MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelZeroSve;
+    MLAS_GEMM_FLOAT_KERNEL MlasSgemmKernelAddSve;
 #endif
     MLAS_GEMM_DOUBLE_KERNEL MlasDgemmKernelZero;
     MLAS_GEMM_DOUBLE_KERNEL MlasDgemmKernelAdd;
@@ -755,6 +785,8 @@ extern "C" {
 #if defined(MLAS_TARGET_AMD64)
     MLAS_SGEMM_KERNEL_M1_ROUTINE MlasSgemmKernelM1Avx;
     MLAS_SGEMM_KERNEL_M1_ROUTINE MlasSgemmKernelM1TransposeBAvx;
+    MLAS_SGEMM_SKINNY_KERNEL_ROUTINE MlasSgemmSkinnyKernelAvx2;
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL MlasConvertFloatToHalfKernelF16C;
 #elif defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_WASM)
     MLAS_GEMV_FLOAT_KERNEL MlasGemvFloatKernel;
 #endif
@@ -849,6 +881,18 @@ extern "C" {
     MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL MlasReduceMaximumF32KernelAvx512F;
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx;
 #endif
+#if defined(MLAS_TARGET_ARM64) && defined(__linux__)
+    MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL MlasReduceMaximumF32KernelSve;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL MlasComputeSumExpF32KernelSve;
+    MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeSoftmaxOutputF32KernelSve;
+    MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL MlasComputeLogSoftmaxOutputF32KernelSve;
+
+    size_t
+    MLASCALL
+    MlasSveGetVectorLengthF32(
+        void
+        );
+#endif
 
 }
 
@@ -878,7 +922,7 @@ extern "C" {
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (size_t(64) * size_t(1024))
 #define MLAS_QGEMM_THREAD_COMPLEXITY                65536
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SUPPORTS_SBGEMM)
 #define MLAS_SBGEMM_THREAD_COMPLEXITY (size_t(64) * size_t(1024))
 #endif
 
@@ -977,6 +1021,30 @@ extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512;
 
 extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni;
 
+extern const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAmx;
+
+//
+// Bfloat16 precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_SBGEMM_DISPATCH;
+
+#if defined(MLAS_TARGET_AMD64)
+extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16;
+#endif
+
+//
+// Half precision matrix/matrix multiply dispatch structure.
+//
+
+struct MLAS_HALFGEMM_DISPATCH;
+
+#if defined(MLAS_TARGET_AMD64)
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2;
+
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16;
+#endif
+
 //
 // Quantized depthwise convolution kernels.
 //
@@ -1087,6 +1155,8 @@ struct MLAS_PLATFORM {
 #if defined(MLAS_TARGET_AMD64)
     MLAS_SGEMM_KERNEL_M1_ROUTINE* KernelM1Routine;
     MLAS_SGEMM_KERNEL_M1_ROUTINE* KernelM1TransposeBRoutine;
+    MLAS_SGEMM_SKINNY_KERNEL_ROUTINE* SgemmSkinnyKernelRoutine{nullptr};
+    MLAS_CONVERT_FLOAT_TO_HALF_KERNEL* ConvertFloatToHalfKernel{nullptr};
     MLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE* TransposePackB16x4Routine;
     MLAS_GEMM_DOUBLE_KERNEL* GemmDoubleKernel;
     MLAS_GEMM_U8S8_KERNEL* GemmU8S8Kernel;
@@ -1116,6 +1186,12 @@ struct MLAS_PLATFORM {
     uint32_t PreferredBufferAlignment;
     int32_t MaximumThreadCount;
 #elif defined(MLAS_TARGET_ARM64)
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernelZero;
+    MLAS_GEMM_FLOAT_KERNEL* GemmFloatKernelAdd;
+    MLAS_COMPUTE_SUMEXP_FLOAT_KERNEL* ComputeSumExpF32Kernel;
+    MLAS_COMPUTE_SOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeSoftmaxOutputF32Kernel;
+    MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeLogSoftmaxOutputF32Kernel;
+    MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL* ReduceMaximumF32Kernel;
     static constexpr int32_t MaximumThreadCount = MLAS_MAXIMUM_THREAD_COUNT * 4;
 #else
     static constexpr int32_t MaximumThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
@@ -1125,6 +1201,11 @@ struct MLAS_PLATFORM {
     const MLAS_Q8Q4GEMM_DISPATCH* Q8Q4GemmDispatch{nullptr};
 
     const MLAS_SQNBIT_GEMM_DISPATCH* SQNBitGemmDispatch{nullptr};
+
+#if defined(MLAS_TARGET_AMD64)
+    const MLAS_SBGEMM_DISPATCH* SBGemmDispatch{nullptr};
+    const MLAS_HALFGEMM_DISPATCH* HalfGemmDispatch{nullptr};
+#endif
 };
 
 inline
@@ -1226,6 +1307,18 @@ MlasPartitionWork(
     }
 }
 
+//
+// Softmax routines.
+//
+
+void
+MlasComputeSoftmaxRow(
+    const float* Input,
+    float* Output,
+    size_t D,
+    bool LogSoftmax
+    );
+
 //
 // Define the minimum floating point value (and its bit value equivalent) that
 // has no fractional bits. This number can be used for fast rounding of floating
@@ -52,6 +52,10 @@ MLASCPUIDInfo::MLASCPUIDInfo()
 #define HWCAP_ASIMDDP (1 << 20)
 #endif
 
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+
 #ifndef HWCAP2_I8MM
 #define HWCAP2_I8MM (1 << 13)
 #endif
@@ -73,6 +77,7 @@ MLASCPUIDInfo::MLASCPUIDInfo()
     has_fp16_ = has_arm_neon_dot_;
 
     has_arm_neon_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_I8MM) != 0);
+    has_arm_sve_ = ((getauxval(AT_HWCAP) & HWCAP_SVE) != 0);
     has_arm_sve_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_SVEI8MM) != 0);
 
     has_arm_neon_bf16_ = ((getauxval(AT_HWCAP2) & HWCAP2_BF16) != 0);
@@ -374,6 +379,16 @@ Return Value:
                 this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, uint8_t>;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
                 this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx2;
+                this->SgemmSkinnyKernelRoutine = MlasSgemmSkinnyKernelAvx2;
+
+                //
+                // Check if the processor supports F16C features.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx2;
+                    this->ConvertFloatToHalfKernel = MlasConvertFloatToHalfKernelF16C;
+                }
 
                 //
                 // Check if the processor supports Hybrid core architecture.
@@ -455,6 +470,24 @@ Return Value:
                             this->Q8Q4GemmDispatch = &MlasQ8Q4GemmDispatchAvx512vnni;
                             this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAvx512vnni;
                         }
+
+                        //
+                        // Check if the processor supports AVX512-BF16.
+                        //
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+
+                            this->SBGemmDispatch = &MlasSBGemmDispatchAvx512Bf16;
+                        }
+
+                        //
+                        // Check if the processor supports AVX512-FP16.
+                        //
+
+                        if ((Cpuid7[3] & 0x800000) != 0) {
+
+                            this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx512Fp16;
+                        }
                     }
                 }
 
@@ -469,6 +502,14 @@ Return Value:
                     if (MlasInitAMX()) {
                         this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAmx;
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
+
+                        //
+                        // The AMX SQNBitGemm dispatch extends the AVX512VNNI one.
+                        //
+
+                        if (this->SQNBitGemmDispatch == &MlasSQNBitGemmDispatchAvx512vnni) {
+                            this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAmx;
+                        }
                     }
                 }
 #endif // __APPLE__
@@ -493,6 +534,13 @@ Return Value:
     this->ConvSymU8S8Dispatch = &MlasConvSymU8DispatchNeon;
     this->ConvSymS8S8Dispatch = &MlasConvSymS8DispatchNeon;
 
+    this->GemmFloatKernelZero = MlasSgemmKernelZero;
+    this->GemmFloatKernelAdd = MlasSgemmKernelAdd;
+    this->ComputeSumExpF32Kernel = MlasComputeSumExpF32Kernel;
+    this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32Kernel;
+    this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
+    this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
+
     //
     // Check if the processor supports ASIMD dot product instructions.
     //
@@ -535,6 +583,21 @@ Return Value:
         this->GemmU8S8Dispatch = &MlasGemmU8X8DispatchUmmla;
         this->GemmS8S8Dispatch = &MlasGemmS8S8DispatchSmmla;
     }
+
+    //
+    // Check if the processor supports SVE instructions with vectors wider
+    // than the 128-bit NEON registers, e.g. Neoverse V1 (Graviton3). SVE
+    // implementations with 128-bit vectors are no faster than the NEON
+    // kernels, so keep the NEON kernels on those processors.
+    //
+    if (MLAS_CPUIDINFO::GetCPUIDInfo().HasArmSVE() && MlasSveGetVectorLengthF32() > 4) {
+        this->GemmFloatKernelZero = MlasSgemmKernelZeroSve;
+        this->GemmFloatKernelAdd = MlasSgemmKernelAddSve;
+        this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelSve;
+        this->ComputeSoftmaxOutputF32Kernel = MlasComputeSoftmaxOutputF32KernelSve;
+        this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32KernelSve;
+        this->ReduceMaximumF32Kernel = MlasReduceMaximumF32KernelSve;
+    }
 #endif
 
 #endif // MLAS_TARGET_ARM64
@@ -673,6 +736,19 @@ MlasPlatformU8S8Overflow(
 
 #endif
 
+#if defined(MLAS_TARGET_AMD64)
+
+bool
+MLASCALL
+MlasBf16AccelerationSupported(
+    void
+    )
+{
+    return GetMlasPlatform().SBGemmDispatch != nullptr;
+}
+
+#endif
+
 thread_local size_t ThreadedBufSize = 0;
 #ifdef _MSC_VER
 thread_local std::unique_ptr<uint8_t, decltype(&_aligned_free)> ThreadedBufHolder(nullptr, &_aligned_free);
@@ -1680,6 +1680,153 @@ Return Value:
     }
 }
 
+template<bool IsMaximumPool>
+MLAS_FORCEINLINE
+void
+MlasPoolFloatHWC(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision maximum or average pooling
+    operation for channels last tensors.
+
+    The input is supplied as an indirection buffer. Every pointer in the
+    indirection buffer points at a Channels length vector, either from the
+    input tensor or a vector of padding values, or is nullptr for a padding
+    element that is excluded from the computation. These are grouped in
+    batches of length KernelSize that are processed by the kernel to produce
+    a single output of length Channels. These batches are then repeated
+    OutputCount times.
+
+Arguments:
+
+    Input - Supplies an indirection buffer to the elements of the input tensor.
+
+    Output - Supplies the output tensor in channels last format.
+
+    Channels - Supplies the number of channels.
+
+    OutputCount - Supplies the number of channel sized output elements to
+        produce.
+
+    KernelSize - Supplies the total number of channel sized kernel elements to
+        consume.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float InitialValue = IsMaximumPool ? std::numeric_limits<float>::lowest() : 0.0f;
+
+    while (OutputCount > 0) {
+
+        size_t ValidCount = 0;
+
+        for (size_t k = 0; k < KernelSize; k++) {
+            if (Input[k] != nullptr) {
+                ValidCount++;
+            }
+        }
+
+        const float Scale = (IsMaximumPool || ValidCount == 0) ? 1.0f : 1.0f / float(ValidCount);
+        const MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+        size_t ChannelOffset = 0;
+        size_t c = Channels;
+
+        while (c >= 4) {
+
+            MLAS_FLOAT32X4 Accumulator = MlasBroadcastFloat32x4(InitialValue);
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                if (Input[k] == nullptr) {
+                    continue;
+                }
+
+                MLAS_FLOAT32X4 InputVector = MlasLoadFloat32x4(&Input[k][ChannelOffset]);
+
+                if (IsMaximumPool) {
+                    Accumulator = MlasMaximumFloat32x4(Accumulator, InputVector);
+                } else {
+                    Accumulator = MlasAddFloat32x4(Accumulator, InputVector);
+                }
+            }
+
+            if (!IsMaximumPool) {
+                Accumulator = MlasMultiplyFloat32x4(Accumulator, ScaleVector);
+            }
+
+            MlasStoreFloat32x4(Output, Accumulator);
+            Output += 4;
+
+            ChannelOffset += 4;
+            c -= 4;
+        }
+
+        while (c > 0) {
+
+            float Accumulator = InitialValue;
+
+            for (size_t k = 0; k < KernelSize; k++) {
+
+                if (Input[k] == nullptr) {
+                    continue;
+                }
+
+                if (IsMaximumPool) {
+                    Accumulator = std::max(Accumulator, Input[k][ChannelOffset]);
+                } else {
+                    Accumulator += Input[k][ChannelOffset];
+                }
+            }
+
+            *Output++ = IsMaximumPool ? Accumulator : Accumulator * Scale;
+
+            ChannelOffset += 1;
+            c -= 1;
+        }
+
+        Input += KernelSize;
+        OutputCount -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasNhwcMaxPool(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+{
+    MlasPoolFloatHWC<true>(Input, Output, Channels, OutputCount, KernelSize);
+}
+
+void
+MLASCALL
+MlasNhwcAvgPool(
+    const float* const* Input,
+    float* Output,
+    size_t Channels,
+    size_t OutputCount,
+    size_t KernelSize
+    )
+{
+    MlasPoolFloatHWC<false>(Input, Output, Channels, OutputCount, KernelSize);
+}
+
 template
 void
 MLASCALL
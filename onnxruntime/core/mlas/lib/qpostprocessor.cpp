@@ -98,6 +98,10 @@ void MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR::Process(
                 ldc);
         }
     }
+
+    if (Epilogue_ != nullptr) {
+        MlasGemmEpilogue(Epilogue_, Output_, StartM, StartN, CountM, CountN, LeadingDimensionOutput_);
+    }
 }
 
 template<bool HasBias, MLAS_QGEMM_OUTPUT_MODE Mode, MLAS_QUANTIZATION_GRANULARITY QuantGran>
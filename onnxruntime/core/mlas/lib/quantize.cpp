@@ -1925,3 +1925,93 @@ Return Value:
     MlasReduceMinimumMaximumF32Kernel(Input, Min, Max, N);
 #endif
 }
+
+void
+MLASCALL
+MlasLookupTable(
+    const uint8_t* Input,
+    const uint8_t* Table,
+    uint8_t* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine maps each byte of the input buffer through a 256 entry table.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Table - Supplies the 256 entry table.
+
+    Output - Returns the table entries of the input bytes.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+
+    //
+    // Each TBL instruction looks up a quarter of the table. Lanes outside the
+    // quarter are left unchanged by TBX, so rebasing the indices by 64 before
+    // each quarter selects the entry from the one quarter that holds it.
+    //
+
+    uint8x16x4_t Table0, Table1, Table2, Table3;
+    for (size_t i = 0; i < 4; i++) {
+        Table0.val[i] = vld1q_u8(Table + 16 * i);
+        Table1.val[i] = vld1q_u8(Table + 64 + 16 * i);
+        Table2.val[i] = vld1q_u8(Table + 128 + 16 * i);
+        Table3.val[i] = vld1q_u8(Table + 192 + 16 * i);
+    }
+    const uint8x16_t QuarterSize = vdupq_n_u8(64);
+
+    while (N >= 16) {
+
+        uint8x16_t Index = vld1q_u8(Input);
+        uint8x16_t Value = vqtbl4q_u8(Table0, Index);
+        Index = vsubq_u8(Index, QuarterSize);
+        Value = vqtbx4q_u8(Value, Table1, Index);
+        Index = vsubq_u8(Index, QuarterSize);
+        Value = vqtbx4q_u8(Value, Table2, Index);
+        Index = vsubq_u8(Index, QuarterSize);
+        Value = vqtbx4q_u8(Value, Table3, Index);
+        vst1q_u8(Output, Value);
+
+        Input += 16;
+        Output += 16;
+        N -= 16;
+    }
+
+#endif
+
+    //
+    // Byte shuffles only index 16 entry tables on x86 without AVX512VBMI, so
+    // a 256 entry lookup costs 16 shuffles and blends per vector. Independent
+    // scalar loads are as fast there.
+    //
+
+    for (; N >= 4; N -= 4) {
+        const uint8_t Value0 = Table[Input[0]];
+        const uint8_t Value1 = Table[Input[1]];
+        const uint8_t Value2 = Table[Input[2]];
+        const uint8_t Value3 = Table[Input[3]];
+        Output[0] = Value0;
+        Output[1] = Value1;
+        Output[2] = Value2;
+        Output[3] = Value3;
+        Input += 4;
+        Output += 4;
+    }
+
+    for (; N > 0; N--) {
+        *Output++ = Table[*Input++];
+    }
+}
@@ -30,8 +30,6 @@ Abstract:
         MLAS_SBGEMM_STRIDES Strides{128, 128, 256};
 --*/
 
-#if defined(__aarch64__) && defined(__linux__)
-
 #pragma once
 
 #include <cassert>
@@ -39,6 +37,16 @@ Abstract:
 
 #include "mlasi.h"
 
+#if defined(MLAS_SUPPORTS_SBGEMM)
+
+#if defined(MLAS_TARGET_AMD64)
+//
+// Storage type of bfloat16 values, which are produced and consumed by the
+// AVX512-BF16 instructions.
+//
+typedef uint16_t bfloat16_t;
+#endif
+
 /**
  * @brief Define the default striding parameters for
  *        the bfloat16 precision gemm operation
@@ -134,7 +142,12 @@ MlasSBGemmPackedOperation(size_t M, size_t RangeStartN, size_t RangeCountN, size
             bool ZeroMode = (k == 0);
             CountK = std::min(K - k, PackedStrideK);
 
-            const bfloat16_t* pb = (const bfloat16_t*)PackedB + AlignedN * k + CountK * SliceStartN;
+            //
+            // The columns of a slice of K are packed with their rows padded
+            // to the packed alignment on the K dim.
+            //
+            const size_t AlignedCountK = (CountK + KernelType::PackedK - 1) & ~(KernelType::PackedK - 1);
+            const bfloat16_t* pb = (const bfloat16_t*)PackedB + AlignedN * k + AlignedCountK * SliceStartN;
             float* c = C + n;
             const float* pbias = ((nullptr == Bias) ? nullptr : Bias + RangeStartN + n);
             MlasSBGemmKernel<KernelType>(M, CountN, CountK, A + k, lda, pb, c, ldc, ZeroMode ? pbias : nullptr, ZeroMode);
@@ -153,24 +166,19 @@ MlasSBGemmNonPackedOperation(size_t M, size_t N, size_t K, const float* A, size_
     //
     // Compute the strides to step through slices of the input matrices.
     //
-    // Expand the N stride if K is small or expand the K stride if N is small
-    // for better utilization of the B panel. Avoid changing the K stride if
-    // the A panel needs to be used for transposing.
+    // Expand the N stride if K is small for better utilization of the B
+    // panel. The K stride is not expanded, since MlasSBGemmConvertPackB packs
+    // B in slices of at most Strides.K rows, which the kernels consume one at
+    // a time. K is padded to the packed alignment so the panel still fits.
     //
     constexpr MLAS_SBGEMM_STRIDES Strides = KernelType::Strides;
     size_t StrideN = Strides.N;
     size_t StrideK = Strides.K;
+    const size_t AlignedK = (K + KernelType::PackedK - 1) & ~(KernelType::PackedK - 1);
 
-    if (N >= K) {
-        while (StrideK / 2 >= K) {
-            StrideN *= 2;
-            StrideK /= 2;
-        }
-    } else {
-        while (StrideN > 16 && StrideN / 2 >= N) {
-            StrideK *= 2;
-            StrideN /= 2;
-        }
+    while (StrideK / 2 >= AlignedK) {
+        StrideN *= 2;
+        StrideK /= 2;
     }
 
     constexpr size_t packBSize = UpAlignSize(Strides.N * Strides.K * sizeof(bfloat16_t));
@@ -198,8 +206,7 @@ MlasSBGemmNonPackedOperation(size_t M, size_t N, size_t K, const float* A, size_
             MlasSBGemmConvertPackB<KernelType>(PanelB, B + n + k * ldb, ldb, CountN, CountK);
 
             auto* c = C + n;
-            const float* pbias =
-                ((nullptr == Bias) ? nullptr : Bias + n);  // TODO: check the SliceNStart
+            const float* pbias = ((nullptr == Bias) ? nullptr : Bias + n);
 
             bool ZeroMode = (k == 0);
             MlasSBGemmKernel<KernelType>(M, CountN, CountK, A + k, lda, PanelB, c, ldc, ZeroMode ? pbias : nullptr, ZeroMode);
@@ -258,7 +265,8 @@ MlasSBGemmOperation(const ptrdiff_t ThreadCountM, const ptrdiff_t ThreadCountN,
     } else {
         const size_t ldb = DataParams->ldb;
         const float* B = (const float*)DataParams->B + RangeStartN;
-        MlasSBGemmNonPackedOperation<KernelType>(RangeCountM, RangeCountN, K, A, lda, B, ldb, C, ldc, bias, (void*)DataParams->OutputProcessor);
+        const float* RangeBias = (nullptr == bias) ? nullptr : bias + RangeStartN;
+        MlasSBGemmNonPackedOperation<KernelType>(RangeCountM, RangeCountN, K, A, lda, B, ldb, C, ldc, RangeBias, (void*)DataParams->OutputProcessor);
     }
 }
 
@@ -283,7 +291,9 @@ struct MLAS_SBGEMM_DISPATCH {
     size_t BufOverRead;
 };
 
+#if defined(MLAS_TARGET_ARM64)
 extern const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchNeon;
+#endif
 
 MLAS_FORCEINLINE
 const MLAS_SBGEMM_DISPATCH*
@@ -291,8 +301,10 @@ MlasSBGemmGetDispatch()
 {
 #if defined(MLAS_TARGET_ARM64)
     return &MlasSBGemmDispatchNeon;
+#elif defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().SBGemmDispatch;
 #else
-    std::cerr << "SBGemm Kernel is supported only on ARM64 platform.";
+    std::cerr << "SBGemm Kernel is supported only on ARM64 and x64 platforms.";
     exit(1);
 #endif
 }
@@ -396,4 +408,4 @@ MlasSBGemmBatch(const size_t M, const size_t N, const size_t K, const size_t Bat
         }
     );
 }
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SUPPORTS_SBGEMM)
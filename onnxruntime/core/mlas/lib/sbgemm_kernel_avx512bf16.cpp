@@ -0,0 +1,274 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sbgemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements bfloat16 precision GEMM kernel for AVX512-BF16.
+
+    The kernel is built on VDPBF16PS, which multiplies pairs of bfloat16
+    values along the K dim and accumulates them into single precision. Matrix
+    B is packed in groups of 16 columns, each holding the pairs of rows of the
+    16 columns, and each pair of values of a row of matrix A is broadcast
+    against a packed row pair of B.
+
+    This file must be compiled with AVX512F, AVX512BW and AVX512-BF16 enabled
+    (e.g. -mavx512f -mavx512bw -mavx512bf16), like the other AVX512 kernels.
+
+--*/
+
+#include "mlasi.h"
+#include "sbgemm.h"
+
+#if defined(MLAS_TARGET_AMD64)
+
+struct MLAS_SBGEMM_KERNEL_AVX512BF16 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 4;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 2;
+    static constexpr size_t PackedN = MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+    static constexpr MLAS_SBGEMM_STRIDES Strides{128, 128, 256};  // M:N:K
+};
+
+//
+// Each packed group of matrix B is 16 columns wide.
+//
+constexpr size_t MlasSBGemmGroupWidthAvx512Bf16 = 16;
+
+//
+// Permutation interleaving two rows of 16 bfloat16 values, converted into the
+// low and high halves of a vector, into 16 pairs of values.
+//
+MLAS_DECLSPEC_ALIGN(static const uint16_t MlasSBGemmInterleaveRowsAvx512Bf16[32], 64) = {
+    0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23,
+    8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31,
+};
+
+MLAS_FORCEINLINE
+__mmask16
+MlasSBGemmColumnMaskAvx512Bf16(size_t CountN)
+{
+    return CountN >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << CountN) - 1);
+}
+
+/*
+    This routine converts fp32 to bf16 and copies elements from the source
+    matrix to the destination packed buffer.
+
+    For each group of 16 columns, the rows are packed by pairs: a pair of rows
+    is stored as 16 pairs of values, one per column. The remaining columns are
+    padded to 16 and the remaining row to 2 with zeros.
+*/
+void
+MlasSBGemmConvertCopyPackBAvx512Bf16(bfloat16_t* D, const float* B, size_t ldb, size_t CountN, size_t CountK)
+{
+    const __m512i Interleave = _mm512_load_si512(MlasSBGemmInterleaveRowsAvx512Bf16);
+
+    for (size_t n = 0; n < CountN; n += MlasSBGemmGroupWidthAvx512Bf16) {
+        const __mmask16 ColumnMask = MlasSBGemmColumnMaskAvx512Bf16(CountN - n);
+        const float* b = B + n;
+
+        for (size_t k = 0; k < CountK; k += 2) {
+            const __m512 Row0 = _mm512_maskz_loadu_ps(ColumnMask, b + k * ldb);
+            const __m512 Row1 = (k + 1 < CountK) ? _mm512_maskz_loadu_ps(ColumnMask, b + (k + 1) * ldb)
+                                                 : _mm512_setzero_ps();
+            const __m512i Rows = (__m512i)_mm512_cvtne2ps_pbh(Row1, Row0);
+            _mm512_storeu_si512(D, _mm512_permutexvar_epi16(Interleave, Rows));
+            D += 2 * MlasSBGemmGroupWidthAvx512Bf16;
+        }
+    }
+}
+
+template <>
+void
+MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>(
+    bfloat16_t* PackedB, const float* B, size_t ldb, size_t CountN, size_t CountK
+)
+{
+    constexpr size_t PackedN = MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN;
+    constexpr MLAS_SBGEMM_STRIDES Strides = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides;
+
+    const size_t AlignedN = (CountN + PackedN - 1) & ~(PackedN - 1);
+
+    //
+    // Step through each slice of matrix B along the K dimension.
+    //
+    size_t K_block_size;
+
+    for (size_t k = 0; k < CountK; k += K_block_size) {
+        K_block_size = std::min(CountK - k, Strides.K);
+
+        MlasSBGemmConvertCopyPackBAvx512Bf16(PackedB, B + k * ldb, ldb, CountN, K_block_size);
+        PackedB = PackedB + AlignedN * K_block_size;
+    }
+}
+
+/*
+    This routine converts a row of matrix A to pairs of bf16 values, with the
+    remaining element padded to a pair with zero.
+*/
+MLAS_FORCEINLINE
+void
+MlasSBGemmConvertRowAAvx512Bf16(const float* A, size_t CountK, uint32_t* Pairs)
+{
+    for (size_t k = 0; k < CountK; k += 32) {
+        const size_t Remaining = CountK - k;
+        const __mmask16 LowMask = MlasSBGemmColumnMaskAvx512Bf16(Remaining);
+        const __mmask16 HighMask = Remaining > 16 ? MlasSBGemmColumnMaskAvx512Bf16(Remaining - 16) : __mmask16(0);
+        const __m512 Low = _mm512_maskz_loadu_ps(LowMask, A + k);
+        const __m512 High = _mm512_maskz_loadu_ps(HighMask, A + k + 16);
+        _mm512_storeu_si512(Pairs + k / 2, (__m512i)_mm512_cvtne2ps_pbh(High, Low));
+    }
+}
+
+/*
+    This routine computes RowCount rows of up to GroupCount groups of 16
+    columns of matrix C.
+*/
+template <size_t RowCount, size_t GroupCount>
+MLAS_FORCEINLINE void
+MlasSBGemmComputeBlockAvx512Bf16(
+    const uint32_t* APairs,
+    size_t APairsStride,
+    const bfloat16_t* B,
+    size_t GroupStride,
+    size_t CountKPairs,
+    size_t CountN,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    __m512 Accumulators[RowCount][GroupCount];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t g = 0; g < GroupCount; g++) {
+            Accumulators[r][g] = _mm512_setzero_ps();
+        }
+    }
+
+    for (size_t kp = 0; kp < CountKPairs; kp++) {
+        __m512bh BPairs[GroupCount];
+        for (size_t g = 0; g < GroupCount; g++) {
+            BPairs[g] = (__m512bh)_mm512_loadu_si512(B + g * GroupStride + kp * 2 * MlasSBGemmGroupWidthAvx512Bf16);
+        }
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m512bh APair = (__m512bh)_mm512_set1_epi32(int(APairs[r * APairsStride + kp]));
+            for (size_t g = 0; g < GroupCount; g++) {
+                Accumulators[r][g] = _mm512_dpbf16_ps(Accumulators[r][g], APair, BPairs[g]);
+            }
+        }
+    }
+
+    for (size_t g = 0; g < GroupCount; g++) {
+        const size_t StartN = g * MlasSBGemmGroupWidthAvx512Bf16;
+        if (StartN >= CountN) {
+            break;
+        }
+        const __mmask16 ColumnMask = MlasSBGemmColumnMaskAvx512Bf16(CountN - StartN);
+        const __m512 BiasVector = (Bias != nullptr) ? _mm512_maskz_loadu_ps(ColumnMask, Bias + StartN)
+                                                    : _mm512_setzero_ps();
+        for (size_t r = 0; r < RowCount; r++) {
+            float* c = C + r * ldc + StartN;
+            __m512 Result = _mm512_add_ps(Accumulators[r][g], BiasVector);
+            if (!ZeroMode) {
+                Result = _mm512_add_ps(Result, _mm512_maskz_loadu_ps(ColumnMask, c));
+            }
+            _mm512_mask_storeu_ps(c, ColumnMask, Result);
+        }
+    }
+}
+
+template <size_t RowCount>
+void
+MlasSBGemmComputeRowsAvx512Bf16(
+    const uint32_t* APairs,
+    size_t APairsStride,
+    const bfloat16_t* B,
+    size_t CountN,
+    size_t CountK,
+    float* C,
+    size_t ldc,
+    const float* Bias,
+    bool ZeroMode
+)
+{
+    const size_t CountKPairs = (CountK + 1) / 2;
+    const size_t GroupStride = CountKPairs * 2 * MlasSBGemmGroupWidthAvx512Bf16;
+    constexpr size_t WideGroupCount = 4;
+    constexpr size_t WideCountN = WideGroupCount * MlasSBGemmGroupWidthAvx512Bf16;
+
+    size_t n = 0;
+    for (; CountN - n >= WideCountN; n += WideCountN) {
+        MlasSBGemmComputeBlockAvx512Bf16<RowCount, WideGroupCount>(
+            APairs, APairsStride, B, GroupStride, CountKPairs, WideCountN, C + n, ldc,
+            Bias != nullptr ? Bias + n : nullptr, ZeroMode
+        );
+        B += WideGroupCount * GroupStride;
+    }
+    for (; n < CountN; n += MlasSBGemmGroupWidthAvx512Bf16) {
+        MlasSBGemmComputeBlockAvx512Bf16<RowCount, 1>(
+            APairs, APairsStride, B, GroupStride, CountKPairs, CountN - n, C + n, ldc,
+            Bias != nullptr ? Bias + n : nullptr, ZeroMode
+        );
+        B += GroupStride;
+    }
+}
+
+template <>
+MLAS_FORCEINLINE void
+MlasSBGemmKernel<MLAS_SBGEMM_KERNEL_AVX512BF16>(size_t CountM, size_t CountN, size_t CountK, const float* A, size_t lda, const bfloat16_t* B, float* C, size_t ldc, const float* Bias, const bool ZeroMode)
+{
+    constexpr size_t KernelMaxM = MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM;
+    constexpr size_t APairsStride = MLAS_SBGEMM_KERNEL_AVX512BF16::Strides.K / 2;
+
+    assert(CountK <= MLAS_SBGEMM_KERNEL_AVX512BF16::Strides.K);
+
+    //
+    // Rows of matrix A converted to pairs of bf16 values.
+    //
+    MLAS_DECLSPEC_ALIGN(uint32_t APairs[KernelMaxM * APairsStride], 64);
+
+    while (CountM > 0) {
+        const size_t RowCount = std::min(CountM, KernelMaxM);
+        for (size_t r = 0; r < RowCount; r++) {
+            MlasSBGemmConvertRowAAvx512Bf16(A + r * lda, CountK, APairs + r * APairsStride);
+        }
+
+        switch (RowCount) {
+            case 4:
+                MlasSBGemmComputeRowsAvx512Bf16<4>(APairs, APairsStride, B, CountN, CountK, C, ldc, Bias, ZeroMode);
+                break;
+            case 3:
+                MlasSBGemmComputeRowsAvx512Bf16<3>(APairs, APairsStride, B, CountN, CountK, C, ldc, Bias, ZeroMode);
+                break;
+            case 2:
+                MlasSBGemmComputeRowsAvx512Bf16<2>(APairs, APairsStride, B, CountN, CountK, C, ldc, Bias, ZeroMode);
+                break;
+            default:
+                MlasSBGemmComputeRowsAvx512Bf16<1>(APairs, APairsStride, B, CountN, CountK, C, ldc, Bias, ZeroMode);
+                break;
+        }
+
+        C += ldc * RowCount;
+        A += lda * RowCount;
+        CountM -= RowCount;
+    }
+}
+
+const MLAS_SBGEMM_DISPATCH MlasSBGemmDispatchAvx512Bf16 = {
+    MlasSBGemmOperation<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MlasSBGemmConvertPackB<MLAS_SBGEMM_KERNEL_AVX512BF16>,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedK,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::PackedN,
+    MLAS_SBGEMM_KERNEL_AVX512BF16::KernelMaxM,
+    0  // kernel does not read beyond buffer end
+};
+#endif  // defined(MLAS_TARGET_AMD64)
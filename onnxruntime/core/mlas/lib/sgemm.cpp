@@ -16,6 +16,9 @@ Abstract:
 --*/
 
 #include "mlasi.h"
+#include "sgemm_skinny.h"
+
+#include <vector>
 
 //
 // Define the number of rows from matrix A to transpose to a local buffer.
@@ -1063,6 +1066,12 @@ Return Value:
 
 #if defined(MLAS_TARGET_AMD64_IX86) || defined(MLAS_TARGET_POWER) || defined(MLAS_TARGET_LARCH64)
         RowsHandled = GetMlasPlatform().GemmFloatKernel(A, B, C, CountK, CountM, CountN, lda, ldc, alpha, ZeroMode);
+#elif defined(MLAS_TARGET_ARM64)
+        if (ZeroMode) {
+            RowsHandled = GetMlasPlatform().GemmFloatKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        } else {
+            RowsHandled = GetMlasPlatform().GemmFloatKernelAdd(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+        }
 #else
         if (ZeroMode) {
             RowsHandled = MlasSgemmKernelZero(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
@@ -1208,6 +1217,35 @@ Return Value:
             return;
         }
 
+#endif
+
+    }
+
+    //
+    // Handle the case of a few rows of matrix A with the skinny kernels, which
+    // stream matrix B once instead of copying it to a local packed buffer.
+    //
+    // N.B. On x64, the packed path runs the AVX or AVX512F kernels, so the
+    // skinny kernels are only used with the 256-bit vectors of AVX2.
+    //
+
+    if (TransA == CblasNoTrans) {
+
+#if defined(MLAS_TARGET_AMD64)
+
+        MLAS_SGEMM_SKINNY_KERNEL_ROUTINE* SgemmSkinnyKernelRoutine = GetMlasPlatform().SgemmSkinnyKernelRoutine;
+
+        if (SgemmSkinnyKernelRoutine != nullptr &&
+            SgemmSkinnyKernelRoutine(TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc)) {
+            return;
+        }
+
+#else
+
+        if (MlasSgemmSkinnyOperation<MLAS_SGEMM_SKINNY_FLOAT32X4>(TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc)) {
+            return;
+        }
+
 #endif
 
     }
@@ -1639,6 +1677,176 @@ MlasGemmBatch(
 #pragma warning(pop)
 #endif
 
+void
+MLASCALL
+MlasGemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_SGEMM_DATA_PARAMS* Data,
+    size_t BatchSize,
+    ptrdiff_t ThreadCountM,
+    ptrdiff_t ThreadCountN,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    if (M == 0 || N == 0 || BatchSize == 0) {
+        return;
+    }
+
+    //
+    // Clamp the requested partition to the shape of the operation. Along the
+    // N dimension, the threads are assigned blocks of columns.
+    //
+
+    const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+        MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+    ThreadCountM = std::clamp(ThreadCountM, ptrdiff_t(1), ptrdiff_t(M));
+    ThreadCountN = std::clamp(ThreadCountN, ptrdiff_t(1), ptrdiff_t(BlockedN));
+
+    const ptrdiff_t ThreadsPerGemm = ThreadCountM * ThreadCountN;
+
+    MlasTrySimpleParallel(ThreadPool,
+        ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
+        [=](ptrdiff_t tid)
+    {
+        ptrdiff_t GemmIdx = tid / ThreadsPerGemm;
+        ptrdiff_t ThreadIdx = tid % ThreadsPerGemm;
+        MlasSgemmThreaded(ThreadCountM, ThreadCountN,
+            TransA, TransB, M, N, K, &(Data[GemmIdx]), ThreadIdx);
+    });
+}
+
+//
+// Define the thread partition of one problem of a grouped SGEMM operation.
+//
+
+struct MLAS_SGEMM_GROUPED_WORK_BLOCK {
+    size_t ProblemIndex;
+    ptrdiff_t ThreadCountM;
+    ptrdiff_t ThreadCountN;
+    ptrdiff_t ThreadEnd;
+};
+
+void
+MLASCALL
+MlasGemmGrouped(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    const MLAS_SGEMM_GROUPED_PROBLEM* Problems,
+    size_t ProblemCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    //
+    // Compute the number of target threads given the total complexity of the
+    // group, like MlasGemmBatch does for a single shape.
+    //
+
+    double Complexity = 0;
+
+    for (size_t i = 0; i < ProblemCount; i++) {
+        Complexity += double(Problems[i].M) * double(Problems[i].N) * double(Problems[i].K);
+    }
+
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Distribute the threads across the problems in proportion to their
+    // complexity, so that the small problems of the group do not hold back
+    // the large ones. Every non empty problem gets at least one thread and
+    // is then segmented as a 1D partition like MlasGemmBatch.
+    //
+
+    std::vector<MLAS_SGEMM_GROUPED_WORK_BLOCK> WorkBlocks;
+    WorkBlocks.reserve(ProblemCount);
+
+    ptrdiff_t ThreadCount = 0;
+
+    for (size_t i = 0; i < ProblemCount; i++) {
+
+        const size_t M = Problems[i].M;
+        const size_t N = Problems[i].N;
+
+        if (M == 0 || N == 0) {
+            continue;
+        }
+
+        ptrdiff_t ThreadsPerGemm = 1;
+
+        if (Complexity > 0) {
+            const double ProblemComplexity = double(M) * double(N) * double(Problems[i].K);
+            ThreadsPerGemm = std::max(ptrdiff_t(double(TargetThreadCount) * ProblemComplexity / Complexity + 0.5),
+                                      ptrdiff_t(1));
+        }
+
+        MLAS_SGEMM_GROUPED_WORK_BLOCK WorkBlock;
+        WorkBlock.ProblemIndex = i;
+
+        if (N > M) {
+
+            const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+                MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+            if (size_t(ThreadsPerGemm) > BlockedN) {
+                ThreadsPerGemm = ptrdiff_t(BlockedN);
+            }
+
+            WorkBlock.ThreadCountM = 1;
+            WorkBlock.ThreadCountN = ThreadsPerGemm;
+
+        } else {
+
+            if (size_t(ThreadsPerGemm) > M) {
+                ThreadsPerGemm = ptrdiff_t(M);
+            }
+
+            WorkBlock.ThreadCountM = ThreadsPerGemm;
+            WorkBlock.ThreadCountN = 1;
+        }
+
+        ThreadCount += ThreadsPerGemm;
+        WorkBlock.ThreadEnd = ThreadCount;
+        WorkBlocks.push_back(WorkBlock);
+    }
+
+    if (ThreadCount == 0) {
+        return;
+    }
+
+    const MLAS_SGEMM_GROUPED_WORK_BLOCK* WorkBlocksData = WorkBlocks.data();
+    const size_t WorkBlockCount = WorkBlocks.size();
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [=](ptrdiff_t tid)
+    {
+        const MLAS_SGEMM_GROUPED_WORK_BLOCK* WorkBlock = std::upper_bound(
+            WorkBlocksData, WorkBlocksData + WorkBlockCount, tid,
+            [](ptrdiff_t Id, const MLAS_SGEMM_GROUPED_WORK_BLOCK& Block) { return Id < Block.ThreadEnd; });
+
+        const ptrdiff_t ThreadsPerGemm = WorkBlock->ThreadCountM * WorkBlock->ThreadCountN;
+        const MLAS_SGEMM_GROUPED_PROBLEM& Problem = Problems[WorkBlock->ProblemIndex];
+
+        MlasSgemmThreaded(WorkBlock->ThreadCountM, WorkBlock->ThreadCountN,
+            TransA, TransB, Problem.M, Problem.N, Problem.K, &Problem.Data,
+            tid - (WorkBlock->ThreadEnd - ThreadsPerGemm));
+    });
+}
+
 size_t
 MLASCALL
 MlasGemmPackBSize(
@@ -0,0 +1,381 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_kernel_sve.cpp
+
+Abstract:
+
+    This module implements the kernels for the single precision matrix/matrix
+    multiply operation (SGEMM) using the ARM Scalable Vector Extension (SVE).
+
+    The kernels consume matrix B in the 16 column panels produced by
+    MlasSgemmCopyPackB and MlasSgemmTransposePackB, so that they are drop in
+    replacements for the NEON kernels. The vector length is not known until
+    run time, so a panel is covered by predicated vectors: one vector on a
+    512-bit implementation and two vectors on a 256-bit implementation such as
+    Neoverse V1.
+
+    N.B. This module must be compiled with SVE code generation enabled, and
+    the kernels must only be called if the processor supports SVE.
+
+--*/
+
+#if defined(__aarch64__) && defined(__linux__)
+
+#include <arm_sve.h>
+
+#include "mlasi.h"
+
+//
+// Define the number of columns of a packed panel of matrix B.
+//
+
+#define MLAS_SGEMM_SVE_PANEL_WIDTH          16
+
+//
+// Define the maximum number of rows of matrix A handled by one kernel call.
+//
+
+#define MLAS_SGEMM_SVE_ROWS                 4
+
+size_t
+MLASCALL
+MlasSveGetVectorLengthF32(
+    void
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of single precision elements of a SVE
+    vector register on this processor.
+
+Arguments:
+
+    None.
+
+Return Value:
+
+    Returns the number of single precision elements of a vector.
+
+--*/
+{
+    return svcntw();
+}
+
+template<bool ZeroMode>
+MLAS_FORCEINLINE
+void
+MlasSgemmSveStoreVector(
+    svbool_t Predicate,
+    float* C,
+    svfloat32_t Accumulator,
+    float alpha
+    )
+{
+    if constexpr (ZeroMode) {
+        svst1_f32(Predicate, C, svmul_n_f32_x(Predicate, Accumulator, alpha));
+    } else {
+        svst1_f32(Predicate, C, svmla_n_f32_x(Predicate, svld1_f32(Predicate, C), Accumulator, alpha));
+    }
+}
+
+template<size_t RowCount, bool ZeroMode>
+MLAS_FORCEINLINE
+void
+MlasSgemmSveComputeBlock(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine computes RowCount rows of one panel of the output matrix.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of the packed panel of matrix B.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountN - Supplies the number of columns of the panel to store to matrix C,
+        at most MLAS_SGEMM_SVE_PANEL_WIDTH.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+
+    //
+    // Two vectors of the panel are computed per pass for independent
+    // accumulators. The second vector is inactive if one vector covers the
+    // panel.
+    //
+
+    for (size_t n = 0; n < MLAS_SGEMM_SVE_PANEL_WIDTH; n += 2 * VectorLength) {
+
+        const svbool_t Predicate0 = svwhilelt_b32(uint64_t(n), uint64_t(MLAS_SGEMM_SVE_PANEL_WIDTH));
+        const svbool_t Predicate1 = svwhilelt_b32(uint64_t(n + VectorLength), uint64_t(MLAS_SGEMM_SVE_PANEL_WIDTH));
+
+        svfloat32_t Accumulator00 = svdup_n_f32(0.0f);
+        svfloat32_t Accumulator01 = svdup_n_f32(0.0f);
+        svfloat32_t Accumulator10 = svdup_n_f32(0.0f);
+        svfloat32_t Accumulator11 = svdup_n_f32(0.0f);
+        svfloat32_t Accumulator20 = svdup_n_f32(0.0f);
+        svfloat32_t Accumulator21 = svdup_n_f32(0.0f);
+        svfloat32_t Accumulator30 = svdup_n_f32(0.0f);
+        svfloat32_t Accumulator31 = svdup_n_f32(0.0f);
+
+        const float* a = A;
+        const float* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+
+            const svfloat32_t BElements0 = svld1_f32(Predicate0, b);
+            const svfloat32_t BElements1 = svld1_f32(Predicate1, b + VectorLength);
+
+            Accumulator00 = svmla_n_f32_x(Predicate0, Accumulator00, BElements0, a[0]);
+            Accumulator01 = svmla_n_f32_x(Predicate1, Accumulator01, BElements1, a[0]);
+
+            if constexpr (RowCount > 1) {
+                Accumulator10 = svmla_n_f32_x(Predicate0, Accumulator10, BElements0, a[lda]);
+                Accumulator11 = svmla_n_f32_x(Predicate1, Accumulator11, BElements1, a[lda]);
+            }
+
+            if constexpr (RowCount > 2) {
+                Accumulator20 = svmla_n_f32_x(Predicate0, Accumulator20, BElements0, a[2 * lda]);
+                Accumulator21 = svmla_n_f32_x(Predicate1, Accumulator21, BElements1, a[2 * lda]);
+            }
+
+            if constexpr (RowCount > 3) {
+                Accumulator30 = svmla_n_f32_x(Predicate0, Accumulator30, BElements0, a[3 * lda]);
+                Accumulator31 = svmla_n_f32_x(Predicate1, Accumulator31, BElements1, a[3 * lda]);
+            }
+
+            a += 1;
+            b += MLAS_SGEMM_SVE_PANEL_WIDTH;
+        }
+
+        //
+        // Store the columns of the panel that are inside matrix C.
+        //
+
+        const svbool_t StorePredicate0 = svwhilelt_b32(uint64_t(n), uint64_t(CountN));
+        const svbool_t StorePredicate1 = svwhilelt_b32(uint64_t(n + VectorLength), uint64_t(CountN));
+
+        float* c = C + n;
+
+        MlasSgemmSveStoreVector<ZeroMode>(StorePredicate0, c, Accumulator00, alpha);
+        MlasSgemmSveStoreVector<ZeroMode>(StorePredicate1, c + VectorLength, Accumulator01, alpha);
+
+        if constexpr (RowCount > 1) {
+            c += ldc;
+            MlasSgemmSveStoreVector<ZeroMode>(StorePredicate0, c, Accumulator10, alpha);
+            MlasSgemmSveStoreVector<ZeroMode>(StorePredicate1, c + VectorLength, Accumulator11, alpha);
+        }
+
+        if constexpr (RowCount > 2) {
+            c += ldc;
+            MlasSgemmSveStoreVector<ZeroMode>(StorePredicate0, c, Accumulator20, alpha);
+            MlasSgemmSveStoreVector<ZeroMode>(StorePredicate1, c + VectorLength, Accumulator21, alpha);
+        }
+
+        if constexpr (RowCount > 3) {
+            c += ldc;
+            MlasSgemmSveStoreVector<ZeroMode>(StorePredicate0, c, Accumulator30, alpha);
+            MlasSgemmSveStoreVector<ZeroMode>(StorePredicate1, c + VectorLength, Accumulator31, alpha);
+        }
+    }
+}
+
+template<size_t RowCount, bool ZeroMode>
+void
+MlasSgemmSveComputeRows(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine steps through the packed panels of matrix B to compute
+    RowCount rows of the output matrix.
+
+Arguments:
+
+    See MlasSgemmSveComputeBlock.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    do {
+
+        const size_t CountNBlock = std::min(CountN, size_t(MLAS_SGEMM_SVE_PANEL_WIDTH));
+
+        MlasSgemmSveComputeBlock<RowCount, ZeroMode>(A, B, C, CountK, CountNBlock, lda, ldc, alpha);
+
+        B += MLAS_SGEMM_SVE_PANEL_WIDTH * CountK;
+        C += MLAS_SGEMM_SVE_PANEL_WIDTH;
+        CountN -= CountNBlock;
+
+    } while (CountN > 0);
+}
+
+template<bool ZeroMode>
+MLAS_FORCEINLINE
+size_t
+MlasSgemmKernelSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+{
+    const size_t RowsHandled = std::min(CountM, size_t(MLAS_SGEMM_SVE_ROWS));
+
+    switch (RowsHandled) {
+        case 1:
+            MlasSgemmSveComputeRows<1, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+            break;
+        case 2:
+            MlasSgemmSveComputeRows<2, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+            break;
+        case 3:
+            MlasSgemmSveComputeRows<3, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+            break;
+        default:
+            MlasSgemmSveComputeRows<4, ZeroMode>(A, B, C, CountK, CountN, lda, ldc, alpha);
+            break;
+    }
+
+    return RowsHandled;
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelZeroSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    A - Supplies the address of matrix A.
+
+    B - Supplies the address of matrix B. The matrix data has been packed using
+        MlasSgemmCopyPackB or MlasSgemmTransposePackB.
+
+    C - Supplies the address of matrix C.
+
+    CountK - Supplies the number of columns from matrix A and the number of rows
+        from matrix B to iterate over.
+
+    CountM - Supplies the maximum number of rows that can be processed for
+        matrix A and matrix C. The actual number of rows handled for this
+        invocation depends on the kernel implementation.
+
+    CountN - Supplies the number of columns from matrix B and matrix C to
+        iterate over.
+
+    lda - Supplies the first dimension of matrix A.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar multiplier (see SGEMM definition).
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    return MlasSgemmKernelSve<true>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
+
+size_t
+MLASCALL
+MlasSgemmKernelAddSve(
+    const float* A,
+    const float* B,
+    float* C,
+    size_t CountK,
+    size_t CountM,
+    size_t CountN,
+    size_t lda,
+    size_t ldc,
+    float alpha
+    )
+/*++
+
+Routine Description:
+
+    This routine is an inner kernel to compute matrix multiplication for a
+    set of rows.
+
+Arguments:
+
+    See MlasSgemmKernelZeroSve.
+
+Return Value:
+
+    Returns the number of rows handled.
+
+--*/
+{
+    return MlasSgemmKernelSve<false>(A, B, C, CountK, CountM, CountN, lda, ldc, alpha);
+}
+
+#endif
@@ -0,0 +1,412 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_skinny.h
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a matrix A with a few rows, e.g. the small batches
+    of a decoder.
+
+    These operations are bound by the memory bandwidth needed to read matrix
+    B. Every element of matrix B is loaded once and multiplied by all the
+    rows of matrix A, and matrix B is read in long contiguous runs, so it
+    streams from memory without the copy to a packed buffer of the general
+    path.
+
+    The kernels are templates over the vector type, so that one source is
+    compiled for 128-bit vectors (MLAS_FLOAT32X4) and for the wider vectors
+    of the instruction set of a platform kernel.
+
+--*/
+
+#pragma once
+
+#include <algorithm>
+
+#include "mlasi.h"
+
+//
+// Define the maximum number of rows of matrix A handled by the skinny SGEMM
+// kernels.
+//
+
+#define MLAS_SGEMM_SKINNY_ROWS              8
+
+//
+// Define the vector operations of the skinny SGEMM kernels for MLAS_FLOAT32X4.
+//
+
+struct MLAS_SGEMM_SKINNY_FLOAT32X4 {
+    using Vector = MLAS_FLOAT32X4;
+
+    static constexpr size_t Width = 4;
+
+    static MLAS_FORCEINLINE Vector Zero() { return MlasZeroFloat32x4(); }
+
+    static MLAS_FORCEINLINE Vector Broadcast(float Value) { return MlasBroadcastFloat32x4(Value); }
+
+    static MLAS_FORCEINLINE Vector Load(const float* Buffer) { return MlasLoadFloat32x4(Buffer); }
+
+    static MLAS_FORCEINLINE void Store(float* Buffer, Vector Value) { MlasStoreFloat32x4(Buffer, Value); }
+
+    // Returns Vector1 * Vector2 + Vector3.
+    static MLAS_FORCEINLINE Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return MlasMultiplyAddFloat32x4(Vector1, Vector2, Vector3);
+    }
+
+    static MLAS_FORCEINLINE float ReduceAdd(Vector Value) { return MlasReduceAddFloat32x4(Value); }
+};
+
+template<typename VectorOps, size_t RowCount, size_t ColumnCount>
+MLAS_FORCEINLINE
+void
+MlasSgemmSkinnyDotKernel(
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    size_t CountK,
+    float* C,
+    size_t ldc,
+    float alpha,
+    float beta,
+    bool FirstSlice
+    )
+/*++
+
+Routine Description:
+
+    This routine computes ColumnCount columns of the output matrix as the dot
+    products of ColumnCount rows of a transposed matrix B with RowCount rows
+    of matrix A, over a slice of the K dimension.
+
+Arguments:
+
+    A - Supplies the address of the slice of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of the slice of the first row of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    CountK - Supplies the number of elements of the slice of the K dimension.
+
+    C - Supplies the address of the first column of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    FirstSlice - Supplies true if this is the first slice of the K dimension,
+        else the dot products are accumulated into matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Vector = typename VectorOps::Vector;
+
+    constexpr size_t Width = VectorOps::Width;
+
+    Vector Accumulators[ColumnCount][RowCount];
+
+    for (size_t n = 0; n < ColumnCount; n++) {
+        for (size_t m = 0; m < RowCount; m++) {
+            Accumulators[n][m] = VectorOps::Zero();
+        }
+    }
+
+    size_t k = 0;
+
+    for (; k + Width <= CountK; k += Width) {
+
+        Vector BElements[ColumnCount];
+
+        for (size_t n = 0; n < ColumnCount; n++) {
+            BElements[n] = VectorOps::Load(B + n * ldb + k);
+        }
+
+        for (size_t m = 0; m < RowCount; m++) {
+            Vector AElements = VectorOps::Load(A + m * lda + k);
+            for (size_t n = 0; n < ColumnCount; n++) {
+                Accumulators[n][m] = VectorOps::MultiplyAdd(BElements[n], AElements, Accumulators[n][m]);
+            }
+        }
+    }
+
+    for (size_t n = 0; n < ColumnCount; n++) {
+
+        const float* b = B + n * ldb;
+
+        for (size_t m = 0; m < RowCount; m++) {
+
+            float Sum = VectorOps::ReduceAdd(Accumulators[n][m]);
+
+            for (size_t r = k; r < CountK; r++) {
+                Sum += A[m * lda + r] * b[r];
+            }
+
+            float* c = C + m * ldc + n;
+
+            if (!FirstSlice) {
+                *c += alpha * Sum;
+            } else if (beta == 0.0f) {
+                *c = alpha * Sum;
+            } else {
+                *c = alpha * Sum + beta * *c;
+            }
+        }
+    }
+}
+
+template<typename VectorOps, size_t RowCount>
+void
+MlasSgemmSkinnyKernel(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a non-transposed matrix A with RowCount rows.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for matrix B.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Vector = typename VectorOps::Vector;
+
+    constexpr size_t Width = VectorOps::Width;
+
+    //
+    // Size the slices of the output matrix (non-transposed B) or of matrix A
+    // (transposed B) that are reused for every row of matrix B to stay in the
+    // L1 cache.
+    //
+
+    constexpr size_t StrideElements = 4096 / RowCount / 16 * 16;
+
+    if (TransB == CblasNoTrans) {
+
+        //
+        // Accumulate four rows of matrix B at a time into a slice of columns
+        // of the output matrix, which is loaded and stored once per four rows.
+        //
+
+        size_t CountN;
+
+        for (size_t n = 0; n < N; n += CountN) {
+
+            CountN = std::min(N - n, StrideElements);
+
+            float* c = C + n;
+
+            for (size_t m = 0; m < RowCount; m++) {
+                float* cc = c + m * ldc;
+                if (beta == 0.0f) {
+                    std::fill_n(cc, CountN, 0.0f);
+                } else if (beta != 1.0f) {
+                    for (size_t j = 0; j < CountN; j++) {
+                        cc[j] *= beta;
+                    }
+                }
+            }
+
+            size_t k = 0;
+
+            for (; k + 4 <= K; k += 4) {
+
+                const float* b = B + k * ldb + n;
+
+                Vector AElements[RowCount][4];
+
+                for (size_t m = 0; m < RowCount; m++) {
+                    for (size_t kk = 0; kk < 4; kk++) {
+                        AElements[m][kk] = VectorOps::Broadcast(alpha * A[m * lda + k + kk]);
+                    }
+                }
+
+                size_t j = 0;
+
+                for (; j + Width <= CountN; j += Width) {
+
+                    Vector B0 = VectorOps::Load(b + j);
+                    Vector B1 = VectorOps::Load(b + ldb + j);
+                    Vector B2 = VectorOps::Load(b + 2 * ldb + j);
+                    Vector B3 = VectorOps::Load(b + 3 * ldb + j);
+
+                    for (size_t m = 0; m < RowCount; m++) {
+                        float* cc = c + m * ldc + j;
+                        Vector Accumulator = VectorOps::Load(cc);
+                        Accumulator = VectorOps::MultiplyAdd(B0, AElements[m][0], Accumulator);
+                        Accumulator = VectorOps::MultiplyAdd(B1, AElements[m][1], Accumulator);
+                        Accumulator = VectorOps::MultiplyAdd(B2, AElements[m][2], Accumulator);
+                        Accumulator = VectorOps::MultiplyAdd(B3, AElements[m][3], Accumulator);
+                        VectorOps::Store(cc, Accumulator);
+                    }
+                }
+
+                for (; j < CountN; j++) {
+                    for (size_t m = 0; m < RowCount; m++) {
+                        const float* a = A + m * lda + k;
+                        c[m * ldc + j] += alpha * (a[0] * b[j] + a[1] * b[ldb + j] +
+                            a[2] * b[2 * ldb + j] + a[3] * b[3 * ldb + j]);
+                    }
+                }
+            }
+
+            for (; k < K; k++) {
+
+                const float* b = B + k * ldb + n;
+
+                for (size_t m = 0; m < RowCount; m++) {
+                    const float AElement = alpha * A[m * lda + k];
+                    for (size_t j = 0; j < CountN; j++) {
+                        c[m * ldc + j] += AElement * b[j];
+                    }
+                }
+            }
+        }
+
+    } else {
+
+        //
+        // Each row of matrix B is a column of the output matrix, computed as
+        // the dot products of the row with all the rows of matrix A. The dot
+        // products are split along K so that the slice of matrix A stays in
+        // the L1 cache while the rows of matrix B stream through.
+        //
+        // Two rows of matrix B are multiplied at a time if there are enough
+        // registers, for more independent accumulators.
+        //
+
+        constexpr size_t ColumnCount = (RowCount <= 4) ? 2 : 1;
+
+        size_t CountK;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, StrideElements);
+
+            const bool FirstSlice = (k == 0);
+            size_t n = 0;
+
+            for (; n + ColumnCount <= N; n += ColumnCount) {
+                MlasSgemmSkinnyDotKernel<VectorOps, RowCount, ColumnCount>(
+                    A + k, lda, B + n * ldb + k, ldb, CountK, C + n, ldc, alpha, beta, FirstSlice);
+            }
+
+            for (; n < N; n++) {
+                MlasSgemmSkinnyDotKernel<VectorOps, RowCount, 1>(
+                    A + k, lda, B + n * ldb + k, ldb, CountK, C + n, ldc, alpha, beta, FirstSlice);
+            }
+        }
+    }
+}
+
+template<typename VectorOps>
+bool
+MlasSgemmSkinnyOperation(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine dispatches a SGEMM operation with a non-transposed matrix A
+    to the skinny kernel for its number of rows.
+
+Arguments:
+
+    See MlasSgemmSkinnyKernel.
+
+Return Value:
+
+    Returns true if the operation was computed, else false if matrix A has
+    too many rows for the skinny kernels.
+
+--*/
+{
+    using MLAS_SGEMM_SKINNY_KERNEL = void(
+        CBLAS_TRANSPOSE, size_t, size_t, float, const float*, size_t, const float*, size_t, float, float*, size_t);
+
+    static constexpr MLAS_SGEMM_SKINNY_KERNEL* Kernels[MLAS_SGEMM_SKINNY_ROWS] = {
+        MlasSgemmSkinnyKernel<VectorOps, 1>,
+        MlasSgemmSkinnyKernel<VectorOps, 2>,
+        MlasSgemmSkinnyKernel<VectorOps, 3>,
+        MlasSgemmSkinnyKernel<VectorOps, 4>,
+        MlasSgemmSkinnyKernel<VectorOps, 5>,
+        MlasSgemmSkinnyKernel<VectorOps, 6>,
+        MlasSgemmSkinnyKernel<VectorOps, 7>,
+        MlasSgemmSkinnyKernel<VectorOps, 8>,
+    };
+
+    if (M == 0 || M > MLAS_SGEMM_SKINNY_ROWS) {
+        return false;
+    }
+
+    Kernels[M - 1](TransB, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+    return true;
+}
@@ -0,0 +1,73 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_skinny_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the skinny single precision matrix/matrix multiply
+    kernels (see sgemm_skinny.h) with 256-bit vectors for AVX2.
+
+    This file must be compiled with AVX2 and FMA3 enabled (e.g. -mavx2 -mfma),
+    like the other AVX2 kernels.
+
+--*/
+
+#include "sgemm_skinny.h"
+
+#if defined(MLAS_TARGET_AMD64)
+
+struct MLAS_SGEMM_SKINNY_AVX2 {
+    using Vector = __m256;
+
+    static constexpr size_t Width = 8;
+
+    static MLAS_FORCEINLINE Vector Zero() { return _mm256_setzero_ps(); }
+
+    static MLAS_FORCEINLINE Vector Broadcast(float Value) { return _mm256_set1_ps(Value); }
+
+    static MLAS_FORCEINLINE Vector Load(const float* Buffer) { return _mm256_loadu_ps(Buffer); }
+
+    static MLAS_FORCEINLINE void Store(float* Buffer, Vector Value) { _mm256_storeu_ps(Buffer, Value); }
+
+    // Returns Vector1 * Vector2 + Vector3.
+    static MLAS_FORCEINLINE Vector MultiplyAdd(Vector Vector1, Vector Vector2, Vector Vector3)
+    {
+        return _mm256_fmadd_ps(Vector1, Vector2, Vector3);
+    }
+
+    static MLAS_FORCEINLINE float ReduceAdd(Vector Value)
+    {
+        __m128 Sum = _mm_add_ps(_mm256_castps256_ps128(Value), _mm256_extractf128_ps(Value, 1));
+        Sum = _mm_add_ps(Sum, _mm_movehl_ps(Sum, Sum));
+        Sum = _mm_add_ss(Sum, _mm_movehdup_ps(Sum));
+        return _mm_cvtss_f32(Sum);
+    }
+};
+
+bool
+MLASCALL
+MlasSgemmSkinnyKernelAvx2(
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+{
+    return MlasSgemmSkinnyOperation<MLAS_SGEMM_SKINNY_AVX2>(TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+#endif
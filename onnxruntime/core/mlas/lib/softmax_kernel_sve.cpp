@@ -0,0 +1,323 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    softmax_kernel_sve.cpp
+
+Abstract:
+
+    This module implements the kernels for the softmax and log softmax
+    operations using the ARM Scalable Vector Extension (SVE).
+
+    The kernels are vector length agnostic: the remainder of a row is handled
+    by a predicated vector instead of a scalar loop.
+
+    N.B. This module must be compiled with SVE code generation enabled, and
+    the kernels must only be called if the processor supports SVE.
+
+--*/
+
+#if defined(__aarch64__) && defined(__linux__)
+
+#include <arm_sve.h>
+
+#include <limits>
+
+#include "mlasi.h"
+
+//
+// Define the constants of the exponential function. These are the values of
+// MlasExpConstants in compute.cpp.
+//
+
+struct MLAS_SVE_EXP_CONSTANTS {
+    static constexpr float LowerRangeSumExp = -88.3762626647949f;
+    static constexpr float RoundingBias = MLAS_ROUNDING_BIAS_MAGIC;
+    static constexpr float Log2Reciprocal = 1.44269504088896341f;
+    static constexpr float Log2High = -6.93145752e-1f;
+    static constexpr float Log2Low = -1.42860677e-6f;
+    static constexpr float poly_0 = 0x1.694000p-10;
+    static constexpr float poly_1 = 0x1.125edcp-7;
+    static constexpr float poly_2 = 0x1.555b5ap-5;
+    static constexpr float poly_3 = 0x1.555450p-3;
+    static constexpr float poly_4 = 0x1.fffff6p-2;
+    static constexpr float poly_56 = 0x1.000000p+0;
+    static constexpr int32_t MaximumExponent = int32_t(0x3F800000);
+};
+
+MLAS_FORCEINLINE
+svfloat32_t
+MlasComputeSumExpVectorSve(
+    svbool_t Predicate,
+    svfloat32_t Vector,
+    float NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for the supplied vector
+    after adding the negative maximum value. See MlasComputeSumExpVector in
+    compute.cpp for the details of the algorithm.
+
+Arguments:
+
+    Predicate - Supplies the active elements of the vector.
+
+    Vector - Supplies the values to operate on.
+
+    NegativeMaximum - Supplies the negative maximum value that is added to
+        each element before computing the exponential function.
+
+Return Value:
+
+    Returns the exponential function of the input.
+
+--*/
+{
+    using Constants = MLAS_SVE_EXP_CONSTANTS;
+
+    Vector = svadd_n_f32_x(Predicate, Vector, NegativeMaximum);
+    Vector = svmax_n_f32_x(Predicate, Vector, Constants::LowerRangeSumExp);
+
+    //
+    // Range reduction of the input by computing "(2 ^ m) * exp(reduced)".
+    //
+
+    const svfloat32_t RoundingBias = svdup_n_f32(Constants::RoundingBias);
+
+    svfloat32_t biased = svmla_n_f32_x(Predicate, RoundingBias, Vector, Constants::Log2Reciprocal);
+    svfloat32_t m = svsub_f32_x(Predicate, biased, RoundingBias);
+
+    Vector = svmla_n_f32_x(Predicate, Vector, m, Constants::Log2High);
+    Vector = svmla_n_f32_x(Predicate, Vector, m, Constants::Log2Low);
+
+    svint32_t normal = svlsl_n_s32_x(Predicate, svreinterpret_s32_f32(biased), 23);
+    normal = svadd_n_s32_x(Predicate, normal, Constants::MaximumExponent);
+
+    //
+    // Compute the polynomial approximation of exp(reduced) and reconstruct
+    // the final result using the above scale factor.
+    //
+
+    svfloat32_t p = svdup_n_f32(Constants::poly_0);
+    p = svmad_n_f32_x(Predicate, p, Vector, Constants::poly_1);
+    p = svmad_n_f32_x(Predicate, p, Vector, Constants::poly_2);
+    p = svmad_n_f32_x(Predicate, p, Vector, Constants::poly_3);
+    p = svmad_n_f32_x(Predicate, p, Vector, Constants::poly_4);
+    p = svmad_n_f32_x(Predicate, p, Vector, Constants::poly_56);
+    p = svmad_n_f32_x(Predicate, p, Vector, Constants::poly_56);
+
+    return svmul_f32_x(Predicate, p, svreinterpret_f32_s32(normal));
+}
+
+float
+MLASCALL
+MlasReduceMaximumF32KernelSve(
+    const float* Input,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel to find the maximum value of the
+    supplied buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    Returns the maximum value of the supplied buffer.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+    const svbool_t AllTrue = svptrue_b32();
+
+    svfloat32_t MaximumVector0 = svdup_n_f32(std::numeric_limits<float>::lowest());
+    svfloat32_t MaximumVector1 = MaximumVector0;
+
+    size_t n = 0;
+
+    for (; n + 2 * VectorLength <= N; n += 2 * VectorLength) {
+        MaximumVector0 = svmax_f32_x(AllTrue, MaximumVector0, svld1_f32(AllTrue, Input + n));
+        MaximumVector1 = svmax_f32_x(AllTrue, MaximumVector1, svld1_f32(AllTrue, Input + n + VectorLength));
+    }
+
+    for (; n < N; n += VectorLength) {
+        const svbool_t Predicate = svwhilelt_b32(uint64_t(n), uint64_t(N));
+        MaximumVector0 = svmax_f32_m(Predicate, MaximumVector0, svld1_f32(Predicate, Input + n));
+    }
+
+    return svmaxv_f32(AllTrue, svmax_f32_x(AllTrue, MaximumVector0, MaximumVector1));
+}
+
+float
+MLASCALL
+MlasComputeSumExpF32KernelSve(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel for the sum of exponential
+    functions operation.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Optionally supplies the output buffer. When used for Softmax,
+        the output buffer is used to store the intermediate exp() results. When
+        used for LogSoftmax, the intermediate exp() results are not required.
+
+    N - Supplies the number of elements to process.
+
+    NegativeMaximum - Supplies the address of the negative maximum
+        value that is added to each element before computing the exponential
+        function.
+
+Return Value:
+
+    Returns the sum of the exponential functions.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+    const svbool_t AllTrue = svptrue_b32();
+    const float NegativeMaximumValue = *NegativeMaximum;
+
+    svfloat32_t AccumulatorVector0 = svdup_n_f32(0.0f);
+    svfloat32_t AccumulatorVector1 = svdup_n_f32(0.0f);
+
+    size_t n = 0;
+
+    for (; n + 2 * VectorLength <= N; n += 2 * VectorLength) {
+
+        svfloat32_t Vector0 = svld1_f32(AllTrue, Input + n);
+        svfloat32_t Vector1 = svld1_f32(AllTrue, Input + n + VectorLength);
+
+        Vector0 = MlasComputeSumExpVectorSve(AllTrue, Vector0, NegativeMaximumValue);
+        Vector1 = MlasComputeSumExpVectorSve(AllTrue, Vector1, NegativeMaximumValue);
+        AccumulatorVector0 = svadd_f32_x(AllTrue, AccumulatorVector0, Vector0);
+        AccumulatorVector1 = svadd_f32_x(AllTrue, AccumulatorVector1, Vector1);
+
+        if (Output != nullptr) {
+            svst1_f32(AllTrue, Output + n, Vector0);
+            svst1_f32(AllTrue, Output + n + VectorLength, Vector1);
+        }
+    }
+
+    for (; n < N; n += VectorLength) {
+
+        const svbool_t Predicate = svwhilelt_b32(uint64_t(n), uint64_t(N));
+
+        svfloat32_t Vector = svld1_f32(Predicate, Input + n);
+
+        Vector = MlasComputeSumExpVectorSve(Predicate, Vector, NegativeMaximumValue);
+        AccumulatorVector0 = svadd_f32_m(Predicate, AccumulatorVector0, Vector);
+
+        if (Output != nullptr) {
+            svst1_f32(Predicate, Output + n, Vector);
+        }
+    }
+
+    return svaddv_f32(AllTrue, svadd_f32_x(AllTrue, AccumulatorVector0, AccumulatorVector1));
+}
+
+void
+MLASCALL
+MlasComputeSoftmaxOutputF32KernelSve(
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel to produce the final output for
+    the softmax operation.
+
+Arguments:
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the scale value.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+    const float Scale = Parameters[0];
+
+    for (size_t n = 0; n < N; n += VectorLength) {
+        const svbool_t Predicate = svwhilelt_b32(uint64_t(n), uint64_t(N));
+        svst1_f32(Predicate, Output + n, svmul_n_f32_x(Predicate, svld1_f32(Predicate, Output + n), Scale));
+    }
+}
+
+void
+MLASCALL
+MlasComputeLogSoftmaxOutputF32KernelSve(
+    const float* Input,
+    float* Output,
+    size_t N,
+    const float* Parameters
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the SVE kernel to produce the final output for
+    the log softmax operation.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+    Parameters - Supplies an array containing the negative maximum and
+        logarithm values.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t VectorLength = svcntw();
+    const float NegativeMaximum = Parameters[0];
+    const float Logarithm = Parameters[1];
+
+    for (size_t n = 0; n < N; n += VectorLength) {
+        const svbool_t Predicate = svwhilelt_b32(uint64_t(n), uint64_t(N));
+        svfloat32_t Vector = svld1_f32(Predicate, Input + n);
+        Vector = svadd_n_f32_x(Predicate, Vector, NegativeMaximum);
+        Vector = svsub_n_f32_x(Predicate, Vector, Logarithm);
+        svst1_f32(Predicate, Output + n, Vector);
+    }
+}
+
+#endif
@@ -0,0 +1,623 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    spgemm.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a constant B matrix with mostly zero elements, as
+    found in pruned models.
+
+    B is packed once into panels of MlasSparseGemmPanelN columns. Each panel
+    stores the nonzero blocks of each row of B in compressed sparse row form.
+    A block is MlasSparseGemmBlockN consecutive columns of a row when the
+    nonzero elements are clustered (block or structured sparsity), which saves
+    the column index of each element, or a single element when they are not
+    (unstructured sparsity).
+
+    Only the nonzero elements are multiplied, so the multiplications and the
+    bytes of B read scale with the density of B.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of columns of B in a panel. A panel of C for a block of
+// rows of A stays in the L1 cache while the rows of the panel are applied.
+//
+
+constexpr size_t MlasSparseGemmPanelN = 128;
+
+//
+// Define the number of consecutive columns of a block in the block format.
+//
+
+constexpr size_t MlasSparseGemmBlockN = 8;
+
+//
+// Define the number of rows of A processed together by a thread.
+//
+
+constexpr size_t MlasSparseGemmStrideM = 16;
+
+//
+// Define the alignment of the sections of the packed buffer.
+//
+
+constexpr size_t MlasSparseGemmPackedAlignment = 64;
+
+//
+// Define the header of the packed B buffer. The header is followed by the
+// start of the blocks of each row of each panel, by the column of each block
+// and by the values of each block, each section aligned to
+// MlasSparseGemmPackedAlignment bytes.
+//
+
+struct MLAS_SPARSE_GEMM_PACKED_B_HEADER {
+    size_t N;
+    size_t K;
+    size_t BlockN;
+    size_t PanelCount;
+    size_t BlockCount;
+};
+
+//
+// Define the layout of the packed B buffer.
+//
+
+struct MLAS_SPARSE_GEMM_PACKED_B_LAYOUT {
+    size_t RowStartOffset;
+    size_t BlockColumnOffset;
+    size_t ValuesOffset;
+    size_t TotalSize;
+};
+
+//
+// Define the parameters to execute segments of a sparse GEMM on worker
+// threads.
+//
+
+struct MLAS_SPARSE_GEMM_WORK_BLOCK {
+    size_t M;
+    float alpha;
+    const float* A;
+    size_t lda;
+    const MLAS_SPARSE_GEMM_PACKED_B_HEADER* Header;
+    const size_t* RowStart;
+    const uint32_t* BlockColumn;
+    const float* Values;
+    float* C;
+    size_t ldc;
+    ptrdiff_t ThreadCount;
+};
+
+namespace {
+
+size_t
+MlasSparseGemmAlignUp(
+    size_t Size
+    )
+{
+    return (Size + MlasSparseGemmPackedAlignment - 1) & ~(MlasSparseGemmPackedAlignment - 1);
+}
+
+float
+MlasSparseGemmElement(
+    CBLAS_TRANSPOSE TransB,
+    const float* B,
+    size_t ldb,
+    size_t k,
+    size_t n
+    )
+{
+    return TransB == CblasNoTrans ? B[k * ldb + n] : B[n * ldb + k];
+}
+
+//
+// Counts the nonzero elements of B and the blocks of MlasSparseGemmBlockN
+// columns of a row of a panel with at least one nonzero element.
+//
+
+void
+MlasSparseGemmCountBlocks(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    size_t* NonZeroCount,
+    size_t* NonZeroBlockCount
+    )
+{
+    *NonZeroCount = 0;
+    *NonZeroBlockCount = 0;
+
+    for (size_t k = 0; k < K; k++) {
+        for (size_t n = 0; n < N; n += MlasSparseGemmBlockN) {
+            const size_t CountN = std::min(MlasSparseGemmBlockN, N - n);
+            size_t BlockNonZeros = 0;
+            for (size_t j = 0; j < CountN; j++) {
+                BlockNonZeros += MlasSparseGemmElement(TransB, B, ldb, k, n + j) != 0.0f;
+            }
+            *NonZeroCount += BlockNonZeros;
+            *NonZeroBlockCount += BlockNonZeros != 0;
+        }
+    }
+}
+
+//
+// Selects the block format when the nonzero blocks are at least half full, so
+// that the zeros stored in the blocks at most double the updates while a
+// single column index is read per block.
+//
+
+size_t
+MlasSparseGemmSelectBlockN(
+    size_t NonZeroCount,
+    size_t NonZeroBlockCount
+    )
+{
+    return NonZeroBlockCount * MlasSparseGemmBlockN <= 2 * NonZeroCount ? MlasSparseGemmBlockN : 1;
+}
+
+MLAS_SPARSE_GEMM_PACKED_B_LAYOUT
+MlasSparseGemmGetLayout(
+    size_t K,
+    size_t PanelCount,
+    size_t BlockN,
+    size_t BlockCount
+    )
+{
+    MLAS_SPARSE_GEMM_PACKED_B_LAYOUT Layout;
+
+    Layout.RowStartOffset = MlasSparseGemmAlignUp(sizeof(MLAS_SPARSE_GEMM_PACKED_B_HEADER));
+    Layout.BlockColumnOffset =
+        Layout.RowStartOffset + MlasSparseGemmAlignUp((PanelCount * K + 1) * sizeof(size_t));
+    Layout.ValuesOffset = Layout.BlockColumnOffset + MlasSparseGemmAlignUp(BlockCount * sizeof(uint32_t));
+    Layout.TotalSize = Layout.ValuesOffset + MlasSparseGemmAlignUp(BlockCount * BlockN * sizeof(float));
+
+    return Layout;
+}
+
+template<size_t BlockN>
+void
+MlasSparseGemmPanel(
+    const MLAS_SPARSE_GEMM_WORK_BLOCK* WorkBlock,
+    size_t m,
+    size_t CountM,
+    size_t Panel
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of up to MlasSparseGemmStrideM rows of a
+    panel of C.
+
+    The block of A and the panel of C are transposed into the thread buffer,
+    so that a nonzero element of B updates a column of the transposed C with
+    a column of the transposed A in vector registers.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    m - Supplies the first row of the block.
+
+    CountM - Supplies the number of rows of the block.
+
+    Panel - Supplies the index of the panel.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t StrideM = MlasSparseGemmStrideM;
+
+    const MLAS_SPARSE_GEMM_PACKED_B_HEADER* Header = WorkBlock->Header;
+    const size_t K = Header->K;
+    const size_t n = Panel * MlasSparseGemmPanelN;
+    const size_t CountN = std::min(MlasSparseGemmPanelN, Header->N - n);
+
+    MlasThreadedBufAlloc(UpAlignSize((K + MlasSparseGemmPanelN) * StrideM * sizeof(float)));
+    float* At = reinterpret_cast<float*>(ThreadedBufHolder.get());
+    float* Ct = At + K * StrideM;
+
+    //
+    // Transpose the block of A, scaled by alpha and padded with zero rows.
+    //
+
+    const float* A = WorkBlock->A + m * WorkBlock->lda;
+    const size_t lda = WorkBlock->lda;
+    const float alpha = WorkBlock->alpha;
+
+    for (size_t k = 0; k < K; k++) {
+        for (size_t r = 0; r < StrideM; r++) {
+            At[k * StrideM + r] = r < CountM ? alpha * A[r * lda + k] : 0.0f;
+        }
+    }
+
+    std::fill_n(Ct, MlasSparseGemmPanelN * StrideM, 0.0f);
+
+    const size_t* RowStart = WorkBlock->RowStart + Panel * K;
+
+    for (size_t k = 0; k < K; k++) {
+        const size_t BlockStart = RowStart[k];
+        const size_t BlockEnd = RowStart[k + 1];
+
+        if (BlockStart == BlockEnd) {
+            continue;
+        }
+
+        const uint32_t* BlockColumn = WorkBlock->BlockColumn;
+        const float* Values = WorkBlock->Values;
+
+        const MLAS_FLOAT32X4 a0 = MlasLoadFloat32x4(At + k * StrideM);
+        const MLAS_FLOAT32X4 a1 = MlasLoadFloat32x4(At + k * StrideM + 4);
+        const MLAS_FLOAT32X4 a2 = MlasLoadFloat32x4(At + k * StrideM + 8);
+        const MLAS_FLOAT32X4 a3 = MlasLoadFloat32x4(At + k * StrideM + 12);
+
+        for (size_t b = BlockStart; b < BlockEnd; b++) {
+            //
+            // A block never crosses the end of a panel and the values past the
+            // last column of B are zero, so the whole block is applied.
+            //
+
+            float* c = Ct + (BlockColumn[b] - n) * StrideM;
+            const float* v = Values + b * BlockN;
+
+            for (size_t j = 0; j < BlockN; j++, c += StrideM) {
+                const MLAS_FLOAT32X4 vj = MlasBroadcastFloat32x4(v[j]);
+                MlasStoreFloat32x4(c, MlasMultiplyAddFloat32x4(a0, vj, MlasLoadFloat32x4(c)));
+                MlasStoreFloat32x4(c + 4, MlasMultiplyAddFloat32x4(a1, vj, MlasLoadFloat32x4(c + 4)));
+                MlasStoreFloat32x4(c + 8, MlasMultiplyAddFloat32x4(a2, vj, MlasLoadFloat32x4(c + 8)));
+                MlasStoreFloat32x4(c + 12, MlasMultiplyAddFloat32x4(a3, vj, MlasLoadFloat32x4(c + 12)));
+            }
+        }
+    }
+
+    float* C = WorkBlock->C + m * WorkBlock->ldc + n;
+    const size_t ldc = WorkBlock->ldc;
+
+    for (size_t r = 0; r < CountM; r++) {
+        for (size_t j = 0; j < CountN; j++) {
+            C[r * ldc + j] = Ct[j * StrideM + r];
+        }
+    }
+}
+
+void
+MlasSparseGemmThreaded(
+    void* Context,
+    ptrdiff_t ThreadId
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    sparse GEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    ThreadId - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SPARSE_GEMM_WORK_BLOCK*)Context;
+    const size_t PanelCount = WorkBlock->Header->PanelCount;
+    const size_t TotalWork = MlasDivRoundup(WorkBlock->M, MlasSparseGemmStrideM) * PanelCount;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+    MlasPartitionWork(ThreadId, WorkBlock->ThreadCount, TotalWork, &WorkIndex, &WorkRemaining);
+
+    for (; WorkRemaining > 0; WorkIndex++, WorkRemaining--) {
+        const size_t m = (WorkIndex / PanelCount) * MlasSparseGemmStrideM;
+        const size_t CountM = std::min(MlasSparseGemmStrideM, WorkBlock->M - m);
+        const size_t Panel = WorkIndex % PanelCount;
+
+        if (WorkBlock->Header->BlockN == 1) {
+            MlasSparseGemmPanel<1>(WorkBlock, m, CountM, Panel);
+        } else {
+            MlasSparseGemmPanel<MlasSparseGemmBlockN>(WorkBlock, m, CountM, Panel);
+        }
+    }
+}
+
+}  // namespace
+
+size_t
+MLASCALL
+MlasSparseGemmCountNonZeros(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of nonzero elements of the B matrix, to
+    decide if the sparse GEMM is worth using.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for the B matrix.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the number of nonzero elements.
+
+--*/
+{
+    size_t NonZeroCount = 0;
+
+    for (size_t k = 0; k < K; k++) {
+        for (size_t n = 0; n < N; n++) {
+            NonZeroCount += MlasSparseGemmElement(TransB, B, ldb, k, n) != 0.0f;
+        }
+    }
+
+    return NonZeroCount;
+}
+
+size_t
+MLASCALL
+MlasSparseGemmPackBSize(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the length in bytes for the packed matrix B buffer,
+    which depends on the number and the layout of the nonzero elements of B.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for the B matrix.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+Return Value:
+
+    Returns the size in bytes for the packed matrix B buffer, or 0 if the
+    columns of B can't be indexed by the packed format.
+
+--*/
+{
+    if (N > std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    size_t NonZeroCount;
+    size_t NonZeroBlockCount;
+    MlasSparseGemmCountBlocks(TransB, N, K, B, ldb, &NonZeroCount, &NonZeroBlockCount);
+
+    const size_t BlockN = MlasSparseGemmSelectBlockN(NonZeroCount, NonZeroBlockCount);
+    const size_t BlockCount = BlockN == 1 ? NonZeroCount : NonZeroBlockCount;
+
+    return MlasSparseGemmGetLayout(K, MlasDivRoundup(N, MlasSparseGemmPanelN), BlockN, BlockCount).TotalSize;
+}
+
+void
+MLASCALL
+MlasSparseGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    )
+/*++
+
+Routine Description:
+
+    This routine packs the nonzero elements of the B matrix. The buffer must be
+    MlasSparseGemmPackBSize bytes long and aligned to 64 bytes.
+
+Arguments:
+
+    TransB - Supplies the transpose operation for the B matrix.
+
+    N - Supplies the number of columns of matrix B.
+
+    K - Supplies the number of rows of matrix B.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    PackedB - Supplies the address of packed matrix B.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    size_t NonZeroCount;
+    size_t NonZeroBlockCount;
+    MlasSparseGemmCountBlocks(TransB, N, K, B, ldb, &NonZeroCount, &NonZeroBlockCount);
+
+    const size_t BlockN = MlasSparseGemmSelectBlockN(NonZeroCount, NonZeroBlockCount);
+    const size_t BlockCount = BlockN == 1 ? NonZeroCount : NonZeroBlockCount;
+    const size_t PanelCount = MlasDivRoundup(N, MlasSparseGemmPanelN);
+    const MLAS_SPARSE_GEMM_PACKED_B_LAYOUT Layout = MlasSparseGemmGetLayout(K, PanelCount, BlockN, BlockCount);
+
+    //
+    // Clear the buffer so that the padding of the sections and of the last
+    // block of a row has a deterministic content.
+    //
+
+    uint8_t* Buffer = (uint8_t*)PackedB;
+    std::fill_n(Buffer, Layout.TotalSize, uint8_t(0));
+
+    auto* Header = (MLAS_SPARSE_GEMM_PACKED_B_HEADER*)Buffer;
+    Header->N = N;
+    Header->K = K;
+    Header->BlockN = BlockN;
+    Header->PanelCount = PanelCount;
+    Header->BlockCount = BlockCount;
+
+    size_t* RowStart = (size_t*)(Buffer + Layout.RowStartOffset);
+    uint32_t* BlockColumn = (uint32_t*)(Buffer + Layout.BlockColumnOffset);
+    float* Values = (float*)(Buffer + Layout.ValuesOffset);
+
+    size_t Block = 0;
+
+    for (size_t Panel = 0; Panel < PanelCount; Panel++) {
+        const size_t PanelStart = Panel * MlasSparseGemmPanelN;
+        const size_t PanelEnd = std::min(N, PanelStart + MlasSparseGemmPanelN);
+
+        for (size_t k = 0; k < K; k++) {
+            *RowStart++ = Block;
+
+            for (size_t n = PanelStart; n < PanelEnd; n += BlockN) {
+                const size_t CountN = std::min(BlockN, N - n);
+                bool NonZero = false;
+                for (size_t j = 0; j < CountN; j++) {
+                    NonZero |= MlasSparseGemmElement(TransB, B, ldb, k, n + j) != 0.0f;
+                }
+
+                if (NonZero) {
+                    BlockColumn[Block] = uint32_t(n);
+                    for (size_t j = 0; j < CountN; j++) {
+                        Values[Block * BlockN + j] = MlasSparseGemmElement(TransB, B, ldb, k, n + j);
+                    }
+                    Block++;
+                }
+            }
+        }
+    }
+
+    *RowStart = Block;
+}
+
+void
+MLASCALL
+MlasSparseGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the single precision matrix/matrix multiply
+    operation C = alpha * A * B with the B matrix packed by
+    MlasSparseGemmPackB.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar multiplier.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const uint8_t* Buffer = (const uint8_t*)PackedB;
+    const auto* Header = (const MLAS_SPARSE_GEMM_PACKED_B_HEADER*)Buffer;
+
+    MLAS_UNREFERENCED_PARAMETER(N);
+    MLAS_UNREFERENCED_PARAMETER(K);
+
+    if (M == 0 || Header->N == 0) {
+        return;
+    }
+
+    const MLAS_SPARSE_GEMM_PACKED_B_LAYOUT Layout =
+        MlasSparseGemmGetLayout(Header->K, Header->PanelCount, Header->BlockN, Header->BlockCount);
+
+    MLAS_SPARSE_GEMM_WORK_BLOCK WorkBlock;
+
+    WorkBlock.M = M;
+    WorkBlock.alpha = alpha;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.Header = Header;
+    WorkBlock.RowStart = (const size_t*)(Buffer + Layout.RowStartOffset);
+    WorkBlock.BlockColumn = (const uint32_t*)(Buffer + Layout.BlockColumnOffset);
+    WorkBlock.Values = (const float*)(Buffer + Layout.ValuesOffset);
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+
+    const size_t TotalWork = MlasDivRoundup(M, MlasSparseGemmStrideM) * Header->PanelCount;
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > TotalWork) {
+        ThreadCount = ptrdiff_t(TotalWork);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasSparseGemmThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
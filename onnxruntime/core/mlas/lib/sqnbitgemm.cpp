@@ -29,6 +29,8 @@ enum SQNBitGemmVariant {
 
     SQNBitGemmVariant_BitWidth4_CompFp32 = 0,
     SQNBitGemmVariant_BitWidth4_CompInt8,
+    SQNBitGemmVariant_BitWidth2_CompFp32,
+    SQNBitGemmVariant_BitWidth3_CompFp32,
 
     // End of valid variants
 
@@ -44,14 +46,23 @@ GetSQNBitGemmVariant(
     MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
 )
 {
-    if (BlkBitWidth == 4 &&
-        (BlkLen == 16 || BlkLen == 32 || BlkLen == 64 || BlkLen == 128 || BlkLen == 256)) {
-        if (ComputeType == CompFp32 ||
-            ComputeType == CompUndef) {  // treat CompUndef (undefined) as CompFp32
+    if (!(BlkLen == 16 || BlkLen == 32 || BlkLen == 64 || BlkLen == 128 || BlkLen == 256)) {
+        return SQNBitGemmVariantInvalid;
+    }
+
+    // treat CompUndef (undefined) as CompFp32
+    const bool IsCompFp32 = ComputeType == CompFp32 || ComputeType == CompUndef;
+
+    if (BlkBitWidth == 4) {
+        if (IsCompFp32) {
             return SQNBitGemmVariant_BitWidth4_CompFp32;
         } else if (ComputeType == CompInt8) {
             return SQNBitGemmVariant_BitWidth4_CompInt8;
         }
+    } else if (BlkBitWidth == 2 && IsCompFp32) {
+        return SQNBitGemmVariant_BitWidth2_CompFp32;
+    } else if (BlkBitWidth == 3 && IsCompFp32) {
+        return SQNBitGemmVariant_BitWidth3_CompFp32;
     }
 
     return SQNBitGemmVariantInvalid;
@@ -67,21 +78,25 @@ MlasIsSQNBitGemmAvailable(
 )
 {
     const auto* Dispatch = GetMlasPlatform().SQNBitGemmDispatch;
-    if (Dispatch == nullptr) {
-        return false;
-    }
 
     const auto Variant = GetSQNBitGemmVariant(BlkBitWidth, BlkLen, ComputeType);
 
     switch (Variant) {
         case SQNBitGemmVariant_BitWidth4_CompFp32: {
-            return Dispatch->SQ4BitGemmM1Kernel_CompFp32 != nullptr &&
+            return Dispatch != nullptr &&
+                   Dispatch->SQ4BitGemmM1Kernel_CompFp32 != nullptr &&
                    Dispatch->Q4BitBlkDequantBForSgemm_CompFp32 != nullptr;
         }
         case SQNBitGemmVariant_BitWidth4_CompInt8: {
-            return Dispatch->SQ4BitGemmM1Kernel_CompInt8 != nullptr &&
+            return Dispatch != nullptr &&
+                   Dispatch->SQ4BitGemmM1Kernel_CompInt8 != nullptr &&
                    Dispatch->QuantizeARow_CompInt8 != nullptr;
         }
+        case SQNBitGemmVariant_BitWidth2_CompFp32:
+        case SQNBitGemmVariant_BitWidth3_CompFp32: {
+            // hardware agnostic kernels, see sqnbitgemm_lowbit.cpp
+            return true;
+        }
         default: {
             return false;
         }
@@ -178,6 +193,14 @@ MlasSQNBitGemmPackQuantBDataSize(
     MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
 )
 {
+    if (BlkBitWidth == 2) {
+        return SQLowBitGemmPackQuantBDataSize<2>(N, K, BlkLen, ComputeType);
+    }
+
+    if (BlkBitWidth == 3) {
+        return SQLowBitGemmPackQuantBDataSize<3>(N, K, BlkLen, ComputeType);
+    }
+
     const auto* Dispatch = GetMlasPlatform().SQNBitGemmDispatch;
     if (Dispatch == nullptr) {
         return 0;
@@ -204,6 +227,21 @@ MlasSQNBitGemmPackQuantBData(
     MLAS_THREADPOOL* ThreadPool
 )
 {
+    if (BlkBitWidth == 2 || BlkBitWidth == 3) {
+        const auto PackQuantBData = (BlkBitWidth == 2) ? SQLowBitGemmPackQuantBData<2>
+                                                       : SQLowBitGemmPackQuantBData<3>;
+        PackQuantBData(
+            N,
+            K,
+            BlkLen,
+            ComputeType,
+            static_cast<const std::byte*>(QuantBData),
+            static_cast<std::byte*>(PackedQuantBData),
+            ThreadPool
+        );
+        return;
+    }
+
     const auto* Dispatch = GetMlasPlatform().SQNBitGemmDispatch;
     if (Dispatch == nullptr) {
         return;
@@ -263,8 +301,9 @@ typedef void(SQNBitGemmFn)(
     size_t RangeCountN
 );
 
+template <size_t BlkBitWidth>
 void
-SQ4BitGemm_CompFp32(
+SQNBitGemm_CompFp32(
     const size_t BlkLen,
     const size_t K,
     const MLAS_SQNBIT_GEMM_DATA_PARAMS* const DataParams,
@@ -275,10 +314,21 @@ SQ4BitGemm_CompFp32(
     const size_t RangeCountN
 )
 {
-    constexpr size_t BlkBitWidth = 4;
-
     MLAS_UNREFERENCED_PARAMETER(PerGemmWorkspace);
 
+    //
+    // 4-bit kernels come from the platform dispatch, 2-bit and 3-bit kernels are hardware agnostic.
+    //
+    MLAS_SQNBIT_GEMM_DISPATCH::SQ4BitGemmM1Kernel_CompFp32_Fn* M1Kernel;
+    MLAS_SQNBIT_GEMM_DISPATCH::Q4BitBlkDequantBForSgemm_CompFp32_Fn* DequantBForSgemm;
+    if constexpr (BlkBitWidth == 4) {
+        M1Kernel = GetMlasPlatform().SQNBitGemmDispatch->SQ4BitGemmM1Kernel_CompFp32;
+        DequantBForSgemm = GetMlasPlatform().SQNBitGemmDispatch->Q4BitBlkDequantBForSgemm_CompFp32;
+    } else {
+        M1Kernel = SQLowBitGemmM1Kernel_CompFp32<BlkBitWidth>;
+        DequantBForSgemm = QLowBitBlkDequantBForSgemm_CompFp32<BlkBitWidth>;
+    }
+
     const size_t lda = DataParams->lda;
     const size_t ldc = DataParams->ldc;
 
@@ -312,7 +362,7 @@ SQ4BitGemm_CompFp32(
             float* c_blk = C + n;
             const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
 
-            GetMlasPlatform().SQNBitGemmDispatch->SQ4BitGemmM1Kernel_CompFp32(
+            M1Kernel(
                 BlkLen,
                 a_row, b_col, b_col_scale, b_col_zp, c_blk, CountN, K, k_blks, bias
             );
@@ -350,7 +400,7 @@ SQ4BitGemm_CompFp32(
         float* c_blk = C + n;
         const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
 
-        GetMlasPlatform().SQNBitGemmDispatch->Q4BitBlkDequantBForSgemm_CompFp32(
+        DequantBForSgemm(
             BlkLen,
             dequant_b, b_col, b_col_scale, b_col_zp, CountN, K, k_blks
         );
@@ -361,6 +411,10 @@ SQ4BitGemm_CompFp32(
             auto RowsHandled = GetMlasPlatform().GemmFloatKernel(
                 a_row, dequant_b, c_blk, K, RowsRemaining, CountN, lda, ldc, 1.f, true
             );
+#elif defined(MLAS_TARGET_ARM64)
+            auto RowsHandled = GetMlasPlatform().GemmFloatKernelZero(
+                a_row, dequant_b, c_blk, K, RowsRemaining, CountN, lda, ldc, 1.f
+            );
 #else
             auto RowsHandled = MlasSgemmKernelZero(a_row, dequant_b, c_blk, K, RowsRemaining, CountN, lda, ldc, 1.f);
 #endif
@@ -370,7 +424,7 @@ SQ4BitGemm_CompFp32(
             }
             if (DataParams->PostProcessor != nullptr) {
                 DataParams->PostProcessor->Process(
-                    DataParams->C, RangeStartM + RangeCountM - RowsRemaining, RangeStartN,
+                    DataParams->C, RangeStartM + RangeCountM - RowsRemaining, RangeStartN + n,
                     RowsHandled, CountN, ldc
                 );
             }
@@ -394,11 +448,13 @@ SQ4BitGemm_CompInt8(
     const size_t RangeCountN
 )
 {
+    const auto* Dispatch = GetMlasPlatform().SQNBitGemmDispatch;
+
 #ifdef MLAS_TARGET_AMD64_IX86
-    if (RangeCountM != 1) {
+    if (RangeCountM != 1 && Dispatch->SQ4BitGemmKernel_CompInt8 == nullptr) {
         // perf experiment shows fp32 is faster than int8 in M > 1 cases.
         // route to fp32 compute before int8 compute is improved.
-        SQ4BitGemm_CompFp32(
+        SQNBitGemm_CompFp32<4>(
             BlkLen,
             K, DataParams, PerGemmWorkspace, RangeStartM, RangeCountM, RangeStartN, RangeCountN
         );
@@ -427,6 +483,21 @@ SQ4BitGemm_CompInt8(
 
     const float* Bias = (DataParams->Bias == nullptr) ? nullptr : DataParams->Bias + RangeStartN;
 
+    if (RangeCountM > 1 && Dispatch->SQ4BitGemmKernel_CompInt8 != nullptr) {
+        Dispatch->SQ4BitGemmKernel_CompInt8(
+            BlkLen,
+            QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, RangeCountM, RangeCountN, K, k_blks, ldc, Bias
+        );
+
+        if (DataParams->PostProcessor != nullptr) {
+            DataParams->PostProcessor->Process(
+                DataParams->C, RangeStartM, RangeStartN,
+                RangeCountM, RangeCountN, ldc
+            );
+        }
+        return;
+    }
+
     if (RangeCountM == 1) {
         size_t CountN;
         for (size_t n = 0; n < RangeCountN; n += CountN) {
@@ -440,7 +511,7 @@ SQ4BitGemm_CompInt8(
             float* c_blk = C + n;
             const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
 
-            GetMlasPlatform().SQNBitGemmDispatch->SQ4BitGemmM1Kernel_CompInt8(
+            Dispatch->SQ4BitGemmM1Kernel_CompInt8(
                 BlkLen,
                 a_row, b_col, b_col_scale, b_col_zp, c_blk, CountN, K, k_blks, bias
             );
@@ -470,15 +541,15 @@ SQ4BitGemm_CompInt8(
         const float* bias = (Bias == nullptr) ? nullptr : Bias + n;
 
         for (size_t m = 0; m < RangeCountM; ++m) {
-            GetMlasPlatform().SQNBitGemmDispatch->SQ4BitGemmM1Kernel_CompInt8(
+            Dispatch->SQ4BitGemmM1Kernel_CompInt8(
                 BlkLen,
                 a_row, b_col, b_col_scale, b_col_zp, c_blk, CountN, K, k_blks, bias
             );
 
             if (DataParams->PostProcessor != nullptr) {
                 DataParams->PostProcessor->Process(
-                    DataParams->C, RangeStartM, RangeStartN + n,
-                    RangeCountM, CountN, ldc
+                    DataParams->C, RangeStartM + m, RangeStartN + n,
+                    1, CountN, ldc
                 );
             }
 
@@ -543,11 +614,15 @@ struct Operations {
 constexpr auto OperationMap = []() {
     std::array<Operations, SQNBitGemmVariantCount> ops;
 
-    ops[SQNBitGemmVariant_BitWidth4_CompFp32].SQNBitGemm = SQ4BitGemm_CompFp32;
+    ops[SQNBitGemmVariant_BitWidth4_CompFp32].SQNBitGemm = SQNBitGemm_CompFp32<4>;
 
     ops[SQNBitGemmVariant_BitWidth4_CompInt8].InitializeWorkspace = InitializeWorkspace_CompInt8;
     ops[SQNBitGemmVariant_BitWidth4_CompInt8].SQNBitGemm = SQ4BitGemm_CompInt8;
 
+    ops[SQNBitGemmVariant_BitWidth2_CompFp32].SQNBitGemm = SQNBitGemm_CompFp32<2>;
+
+    ops[SQNBitGemmVariant_BitWidth3_CompFp32].SQNBitGemm = SQNBitGemm_CompFp32<3>;
+
     return ops;
 }();
 
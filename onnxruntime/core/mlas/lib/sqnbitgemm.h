@@ -38,7 +38,8 @@ constexpr MLAS_FORCEINLINE size_t
 MlasQNBitZeroPointsForBlksSizeInBytes(size_t BlkCount)
 {
     if constexpr (BlkBitWidth <= 4) {
-        return MlasDivRoundup(BlkCount, 2);  // 2 blocks per byte
+        // zero points are packed into a bit stream, e.g., 2 blocks per byte for 4-bit
+        return MlasDivRoundup(BlkCount * BlkBitWidth, 8);
     } else {
         return BlkCount;
     }
@@ -228,6 +229,44 @@ struct MLAS_SQNBIT_GEMM_DISPATCH {
 
     SQ4BitGemmM1Kernel_CompInt8_Fn* SQ4BitGemmM1Kernel_CompInt8 = nullptr;
 
+    /**
+     * @brief Multiply quantized 8-bit integer matrix A with quantized 4-bit integer matrix B.
+     *        A and B are block quantized and B is column major.
+     *        This kernel handles the general case where M, the number of rows of A and C, is greater than 1.
+     *        It is optional. If it is not available, SQ4BitGemmM1Kernel_CompInt8 is called for each row.
+     *
+     * @param       BlkLen              Number of values in a block.
+     * @param       QuantA              Supplies the quantized A matrix.
+                                        Binary data containing block quantized int8 data and scale values.
+     * @param       QuantBData          Supplies the quantized B matrix block data.
+     * @param       QuantBScale         Supplies the quantized B matrix block scale values.
+     * @param       QuantBZeroPoint     Supplies the quantized B matrix block zero point values. Optional.
+     * @param[out]  C                   Supplies the output C matrix.
+     * @param       CountM              Number of rows of A and C.
+     * @param       CountN              Number of columns of B and C.
+     * @param       CountK              Number of columns of A and rows of B.
+     * @param       BlockStrideQuantB   Number of blocks between adjacent columns of the quantized B matrix and
+     *                                  between adjacent rows of the quantized A matrix.
+     * @param       ldc                 Number of elements between adjacent rows of C.
+     * @param       Bias                Bias vector of length N.
+     */
+    typedef void(SQ4BitGemmKernel_CompInt8_Fn)(
+        size_t BlkLen,
+        const std::byte* QuantA,
+        const std::byte* QuantBData,
+        const float* QuantBScale,
+        const std::byte* QuantBZeroPoint,
+        float* C,
+        size_t CountM,
+        size_t CountN,
+        size_t CountK,
+        size_t BlockStrideQuantB,
+        size_t ldc,
+        const float* Bias
+    );
+
+    SQ4BitGemmKernel_CompInt8_Fn* SQ4BitGemmKernel_CompInt8 = nullptr;
+
     /**
      * @brief Block quantize values from one row of matrix A from floats to quantized 8-bit integers.
      *
@@ -246,3 +285,58 @@ struct MLAS_SQNBIT_GEMM_DISPATCH {
 
     QuantizeARow_CompInt8_Fn* QuantizeARow_CompInt8 = nullptr;
 };
+
+//
+// Hardware agnostic 2-bit and 3-bit kernels. These are not part of the platform dispatch.
+// They have the same semantics as the corresponding 4-bit dispatch functions above.
+// See sqnbitgemm_lowbit.cpp. They are instantiated for BlkBitWidth 2 and 3.
+//
+
+template <size_t BlkBitWidth>
+size_t
+SQLowBitGemmPackQuantBDataSize(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+);
+
+template <size_t BlkBitWidth>
+void
+SQLowBitGemmPackQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+);
+
+template <size_t BlkBitWidth>
+void
+SQLowBitGemmM1Kernel_CompFp32(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+);
+
+template <size_t BlkBitWidth>
+void
+QLowBitBlkDequantBForSgemm_CompFp32(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB
+);
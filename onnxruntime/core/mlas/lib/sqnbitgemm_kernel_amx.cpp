@@ -0,0 +1,436 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernel for the CompInt8 compute type and M > 1 with
+    AMX-INT8.
+
+    The int8 blocks of A and B are multiplied with TDPBSSD, and the int32
+    products of each block are scaled by the block scales of A and B into
+    fp32 accumulators.
+
+    B is the first operand of the tile products: a row of a B tile holds the
+    values of one column of B, so the 4-bit values of B only need to be
+    unpacked to int8. A is the second operand: its rows are interleaved by
+    groups of 4 values, which is done once per call. The tile products hold
+    the transpose of C, which is transposed back when C is stored.
+
+    This file must be compiled with AVX512F, AVX512BW and AVX512VL enabled,
+    like the other AMX kernels.
+
+--*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "amx_common.h"
+#include "sqnbitgemm.h"
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+#define TMM5 5
+#define TMM6 6
+#define TMM7 7
+
+namespace
+{
+
+constexpr size_t TileRows = 16;       // rows of a tile, i.e. columns of B or rows of A
+constexpr size_t TileMaxDepth = 64;   // maximum number of K values of a tile product
+
+constexpr size_t BlockTilesN = 2;     // tiles of B (TMM4, TMM5) per block of C
+constexpr size_t BlockTilesM = 2;     // tiles of A (TMM6, TMM7) per block of C
+
+//
+// The tile loads and stores are not visible to the compiler, so the buffers
+// they access are fenced from the surrounding code.
+//
+MLAS_FORCEINLINE void
+TileMemoryFence()
+{
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+/*
+    Configures the tiles for products of TileDepth values:
+    TMM0-TMM3 are the int32 products, TMM4-TMM5 are the tiles of B and
+    TMM6-TMM7 are the interleaved tiles of A.
+*/
+void
+ConfigureTiles(size_t TileDepth)
+{
+    static thread_local tileconfig_t tc;
+    tc.palette_id = 1;
+    for (int t = 0; t < 4; t++) {
+        tc.rows[t] = TileRows;
+        tc.colb[t] = TileRows * sizeof(int32_t);
+    }
+    for (int t = 4; t < 6; t++) {
+        tc.rows[t] = TileRows;
+        tc.colb[t] = static_cast<uint16_t>(TileDepth);
+    }
+    for (int t = 6; t < 8; t++) {
+        tc.rows[t] = static_cast<uint8_t>(TileDepth / 4);
+        tc.colb[t] = TileRows * 4;
+    }
+    TileMemoryFence();
+    tile_loadconfig(&tc);
+}
+
+/*
+    Interleaves the int8 blocks of the quantized A matrix by groups of 4 values
+    for the second operand of the tile products, and gathers the block scales.
+
+    For each tile of 16 rows and each block, the TileDepth values of each sub
+    block are stored as TileDepth / 4 rows of 16 groups of 4 values, one group
+    per row of A. The rows past CountM are padded with zeros.
+*/
+void
+PackQuantA(
+    size_t BlkLen,
+    size_t TileDepth,
+    const std::byte* QuantA,
+    size_t CountM,
+    size_t BlockCountK,
+    int8_t* PackedA,
+    float* AScale
+)
+{
+    const size_t lda = BlockCountK * Q8BlkSize(BlkLen);
+    const size_t MTileCount = MlasDivRoundup(CountM, TileRows);
+
+    for (size_t mt = 0; mt < MTileCount; mt++) {
+        for (size_t blk = 0; blk < BlockCountK; blk++) {
+            int8_t* dst = PackedA + (mt * BlockCountK + blk) * BlkLen * TileRows;
+            float* scale = AScale + (mt * BlockCountK + blk) * TileRows;
+
+            for (size_t m = 0; m < TileRows; m++) {
+                const size_t row = mt * TileRows + m;
+
+                if (row >= CountM) {
+                    scale[m] = 0.0f;
+                    for (size_t k = 0; k < BlkLen; k += 4) {
+                        std::memset(dst + (k / TileDepth) * TileDepth * TileRows + (k % TileDepth) / 4 * TileRows * 4 + m * 4, 0, 4);
+                    }
+                    continue;
+                }
+
+                const std::byte* a_blk = QuantA + row * lda + blk * Q8BlkSize(BlkLen);
+                const int8_t* a = Q8BlkData(a_blk);
+                scale[m] = Q8BlkScale(a_blk);
+
+                for (size_t k = 0; k < BlkLen; k += 4) {
+                    std::memcpy(dst + (k / TileDepth) * TileDepth * TileRows + (k % TileDepth) / 4 * TileRows * 4 + m * 4, a + k, 4);
+                }
+            }
+        }
+    }
+}
+
+/*
+    Unpacks a sub block of TileDepth 4-bit values of a column of B to int8
+    values with the zero point subtracted. The packed sub block holds the
+    values [0, TileDepth / 2) in the low nibbles and the values
+    [TileDepth / 2, TileDepth) in the high nibbles, see SQ4BitGemmPackQuantBData.
+*/
+MLAS_FORCEINLINE void
+UnpackQuantBSubBlk(const std::byte* QuantBData, size_t TileDepth, int8_t ZeroPoint, int8_t* Dst)
+{
+    const size_t HalfDepth = TileDepth / 2;
+    const __mmask32 Mask = (HalfDepth == 32) ? __mmask32(0xFFFFFFFF) : __mmask32((1u << HalfDepth) - 1);
+    const __m256i LowMask = _mm256_set1_epi8(0x0F);
+    const __m256i ZeroPointVector = _mm256_set1_epi8(ZeroPoint);
+
+    const __m256i Packed = _mm256_maskz_loadu_epi8(Mask, QuantBData);
+    const __m256i Low = _mm256_sub_epi8(_mm256_and_si256(Packed, LowMask), ZeroPointVector);
+    const __m256i High = _mm256_sub_epi8(_mm256_and_si256(_mm256_srli_epi16(Packed, 4), LowMask), ZeroPointVector);
+
+    _mm256_mask_storeu_epi8(Dst, Mask, Low);
+    _mm256_mask_storeu_epi8(Dst + HalfDepth, Mask, High);
+}
+
+/*
+    Unpacks the columns [StartN, StartN + 16 * BlockTilesN) of the quantized B
+    matrix for the first operand of the tile products, and gathers the block
+    scales.
+
+    For each tile of 16 columns and each block, the values of each sub block
+    are stored as 16 rows of TileDepth values, one row per column of B. The
+    columns past CountN are padded with zeros.
+*/
+void
+PackQuantBStrip(
+    size_t BlkLen,
+    size_t TileDepth,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t StartN,
+    size_t CountN,
+    size_t BlockCountK,
+    int8_t* PackedB,
+    float* BScale
+)
+{
+    constexpr size_t BlkBitWidth = 4;
+
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t ldb = BlockCountK * BlkDataSize;
+    const size_t ZeroPointStride = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    for (size_t nt = 0; nt < BlockTilesN; nt++) {
+        for (size_t blk = 0; blk < BlockCountK; blk++) {
+            int8_t* dst = PackedB + (nt * BlockCountK + blk) * BlkLen * TileRows;
+            float* scale = BScale + (nt * BlockCountK + blk) * TileRows;
+
+            for (size_t c = 0; c < TileRows; c++) {
+                const size_t n = StartN + nt * TileRows + c;
+
+                if (n >= CountN) {
+                    scale[c] = 0.0f;
+                    for (size_t k = 0; k < BlkLen; k += TileDepth) {
+                        std::memset(dst + k * TileRows + c * TileDepth, 0, TileDepth);
+                    }
+                    continue;
+                }
+
+                scale[c] = QuantBScale[n * BlockCountK + blk];
+
+                int8_t ZeroPoint = 8;
+                if (QuantBZeroPoint != nullptr) {
+                    const std::byte ZeroPointPacked = QuantBZeroPoint[n * ZeroPointStride + blk / 2];
+                    ZeroPoint = static_cast<int8_t>(std::to_integer<int>(
+                        (blk & 1) ? (ZeroPointPacked >> 4) : (ZeroPointPacked & std::byte{0x0F})
+                    ));
+                }
+
+                const std::byte* b = QuantBData + n * ldb + blk * BlkDataSize;
+                for (size_t k = 0; k < BlkLen; k += TileDepth) {
+                    UnpackQuantBSubBlk(b + k / 2, TileDepth, ZeroPoint, dst + k * TileRows + c * TileDepth);
+                }
+            }
+        }
+    }
+}
+
+/*
+    Computes a block of up to 16 * BlockTilesM rows and 16 * BlockTilesN
+    columns of the transpose of C into Acc, from the packed tiles of A and B.
+*/
+template <size_t TilesN, size_t TilesM>
+void
+ComputeBlockTransposed(
+    size_t BlkLen,
+    size_t TileDepth,
+    size_t BlockCountK,
+    const int8_t* PackedB,
+    const float* BScale,
+    const int8_t* PackedA,
+    const float* AScale,
+    float* Acc,
+    int32_t* Products
+)
+{
+    constexpr size_t TileSize = TileRows * TileRows;
+    const size_t TileBlkSize = BlkLen * TileRows;
+
+    std::fill_n(Acc, TilesN * TilesM * TileSize, 0.0f);
+
+    for (size_t blk = 0; blk < BlockCountK; blk++) {
+        tile_zero(TMM0);
+        if constexpr (TilesM > 1) {
+            tile_zero(TMM1);
+        }
+        if constexpr (TilesN > 1) {
+            tile_zero(TMM2);
+        }
+        if constexpr (TilesN > 1 && TilesM > 1) {
+            tile_zero(TMM3);
+        }
+
+        TileMemoryFence();
+
+        for (size_t k = 0; k < BlkLen; k += TileDepth) {
+            const int8_t* b = PackedB + blk * TileBlkSize + k * TileRows;
+            const int8_t* a = PackedA + blk * TileBlkSize + k * TileRows;
+
+            tile_loadd(TMM4, b, TileDepth);
+            tile_loadd(TMM6, a, TileRows * 4);
+            if constexpr (TilesN > 1) {
+                tile_loadd(TMM5, b + BlockCountK * TileBlkSize, TileDepth);
+            }
+            if constexpr (TilesM > 1) {
+                tile_loadd(TMM7, a + BlockCountK * TileBlkSize, TileRows * 4);
+            }
+
+            tile_dpbssd(TMM0, TMM4, TMM6);
+            if constexpr (TilesM > 1) {
+                tile_dpbssd(TMM1, TMM4, TMM7);
+            }
+            if constexpr (TilesN > 1) {
+                tile_dpbssd(TMM2, TMM5, TMM6);
+            }
+            if constexpr (TilesN > 1 && TilesM > 1) {
+                tile_dpbssd(TMM3, TMM5, TMM7);
+            }
+        }
+
+        tile_stored(TMM0, Products, TileRows * sizeof(int32_t));
+        if constexpr (TilesM > 1) {
+            tile_stored(TMM1, Products + TileSize, TileRows * sizeof(int32_t));
+        }
+        if constexpr (TilesN > 1) {
+            tile_stored(TMM2, Products + 2 * TileSize, TileRows * sizeof(int32_t));
+        }
+        if constexpr (TilesN > 1 && TilesM > 1) {
+            tile_stored(TMM3, Products + 3 * TileSize, TileRows * sizeof(int32_t));
+        }
+
+        TileMemoryFence();
+
+        for (size_t nt = 0; nt < TilesN; nt++) {
+            const float* b_scale = BScale + (nt * BlockCountK + blk) * TileRows;
+
+            for (size_t mt = 0; mt < TilesM; mt++) {
+                const __m512 a_scale = _mm512_loadu_ps(AScale + (mt * BlockCountK + blk) * TileRows);
+                const int32_t* products = Products + (nt * 2 + mt) * TileSize;
+                float* acc = Acc + (nt * TilesM + mt) * TileSize;
+
+                for (size_t n = 0; n < TileRows; n++) {
+                    const __m512 scale = _mm512_mul_ps(a_scale, _mm512_set1_ps(b_scale[n]));
+                    const __m512 product = _mm512_cvtepi32_ps(_mm512_loadu_si512(products + n * TileRows));
+                    _mm512_storeu_ps(acc + n * TileRows, _mm512_fmadd_ps(product, scale, _mm512_loadu_ps(acc + n * TileRows)));
+                }
+            }
+        }
+    }
+}
+
+/*
+    Stores a block of C computed by ComputeBlockTransposed, adding the bias.
+*/
+void
+StoreBlockTransposed(
+    const float* Acc,
+    size_t TilesN,
+    size_t TilesM,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc,
+    const float* Bias
+)
+{
+    constexpr size_t TileSize = TileRows * TileRows;
+
+    for (size_t nt = 0; nt < TilesN; nt++) {
+        for (size_t mt = 0; mt < TilesM; mt++) {
+            const float* acc = Acc + (nt * TilesM + mt) * TileSize;
+            const size_t RowCount = std::min(CountM - mt * TileRows, TileRows);
+            const size_t ColumnCount = std::min(CountN - nt * TileRows, TileRows);
+
+            for (size_t m = 0; m < RowCount; m++) {
+                float* c = C + (mt * TileRows + m) * ldc + nt * TileRows;
+                for (size_t n = 0; n < ColumnCount; n++) {
+                    c[n] = acc[n * TileRows + m] + ((Bias != nullptr) ? Bias[nt * TileRows + n] : 0.0f);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+void
+SQ4BitGemmKernel_CompInt8_amx(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    size_t ldc,
+    const float* Bias
+)
+{
+    // The quantized blocks of A are padded with zeros past CountK, so whole blocks are computed.
+    MLAS_UNREFERENCED_PARAMETER(CountK);
+
+    constexpr size_t TileSize = TileRows * TileRows;
+
+    const size_t BlockCountK = BlockStrideQuantB;
+    const size_t TileDepth = std::min(BlkLen, TileMaxDepth);
+    const size_t MTileCount = MlasDivRoundup(CountM, TileRows);
+    const size_t TileBlkSize = BlkLen * TileRows;
+
+    //
+    // Partition the thread local buffer into the packed A and B matrices, their
+    // block scales, the accumulators and the int32 products of a block.
+    //
+    const size_t PackedASize = UpAlignSize(MTileCount * BlockCountK * TileBlkSize);
+    const size_t AScaleSize = UpAlignSize(MTileCount * BlockCountK * TileRows * sizeof(float));
+    const size_t PackedBSize = UpAlignSize(BlockTilesN * BlockCountK * TileBlkSize);
+    const size_t BScaleSize = UpAlignSize(BlockTilesN * BlockCountK * TileRows * sizeof(float));
+    constexpr size_t AccSize = BlockTilesN * BlockTilesM * TileSize * sizeof(float);
+    constexpr size_t ProductsSize = BlockTilesN * BlockTilesM * TileSize * sizeof(int32_t);
+
+    MlasThreadedBufAlloc(PackedASize + AScaleSize + PackedBSize + BScaleSize + AccSize + ProductsSize);
+
+    uint8_t* Buffer = ThreadedBufHolder.get();
+    int8_t* PackedA = reinterpret_cast<int8_t*>(Buffer);
+    float* AScale = reinterpret_cast<float*>(Buffer + PackedASize);
+    int8_t* PackedB = reinterpret_cast<int8_t*>(Buffer + PackedASize + AScaleSize);
+    float* BScale = reinterpret_cast<float*>(Buffer + PackedASize + AScaleSize + PackedBSize);
+    float* Acc = reinterpret_cast<float*>(Buffer + PackedASize + AScaleSize + PackedBSize + BScaleSize);
+    int32_t* Products = reinterpret_cast<int32_t*>(Buffer + PackedASize + AScaleSize + PackedBSize + BScaleSize + AccSize);
+
+    ConfigureTiles(TileDepth);
+
+    PackQuantA(BlkLen, TileDepth, QuantA, CountM, BlockCountK, PackedA, AScale);
+
+    for (size_t n = 0; n < CountN; n += BlockTilesN * TileRows) {
+        const size_t TilesN = std::min(MlasDivRoundup(CountN - n, TileRows), BlockTilesN);
+
+        PackQuantBStrip(
+            BlkLen, TileDepth, QuantBData, QuantBScale, QuantBZeroPoint, n, CountN, BlockCountK, PackedB, BScale
+        );
+
+        for (size_t mt = 0; mt < MTileCount; mt += BlockTilesM) {
+            const size_t TilesM = std::min(MTileCount - mt, BlockTilesM);
+            const int8_t* a = PackedA + mt * BlockCountK * TileBlkSize;
+            const float* a_scale = AScale + mt * BlockCountK * TileRows;
+
+            if (TilesN == 2 && TilesM == 2) {
+                ComputeBlockTransposed<2, 2>(BlkLen, TileDepth, BlockCountK, PackedB, BScale, a, a_scale, Acc, Products);
+            } else if (TilesN == 2) {
+                ComputeBlockTransposed<2, 1>(BlkLen, TileDepth, BlockCountK, PackedB, BScale, a, a_scale, Acc, Products);
+            } else if (TilesM == 2) {
+                ComputeBlockTransposed<1, 2>(BlkLen, TileDepth, BlockCountK, PackedB, BScale, a, a_scale, Acc, Products);
+            } else {
+                ComputeBlockTransposed<1, 1>(BlkLen, TileDepth, BlockCountK, PackedB, BScale, a, a_scale, Acc, Products);
+            }
+
+            StoreBlockTransposed(
+                Acc, TilesN, TilesM, C + mt * TileRows * ldc + n, CountM - mt * TileRows, CountN - n, ldc,
+                (Bias != nullptr) ? Bias + n : nullptr
+            );
+        }
+    }
+}
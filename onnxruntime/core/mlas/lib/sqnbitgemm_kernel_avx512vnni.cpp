@@ -262,3 +262,30 @@ const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAvx512vnni = []() {
 
     return d;
 }();
+
+void
+SQ4BitGemmKernel_CompInt8_amx(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    size_t ldc,
+    const float* Bias
+);
+
+//
+// The AMX dispatch structure extends the AVX512VNNI one with the AMX-INT8 kernel for M > 1.
+//
+const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAmx = []() {
+    MLAS_SQNBIT_GEMM_DISPATCH d = MlasSQNBitGemmDispatchAvx512vnni;
+
+    d.SQ4BitGemmKernel_CompInt8 = SQ4BitGemmKernel_CompInt8_amx;
+
+    return d;
+}();
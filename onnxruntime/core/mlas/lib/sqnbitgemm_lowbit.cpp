@@ -0,0 +1,341 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_lowbit.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernels for 2-bit and 3-bit quantized B.
+
+    These kernels are hardware agnostic and only use the MLAS_FLOAT32X4
+    abstraction, so they do not depend on the platform SQNBitGemm dispatch.
+
+    The unpacked quantized B data layout matches the MatMulNBits spec: each
+    block of BlkLen values is stored in BlkLen * BlkBitWidth / 8 bytes and the
+    values are packed into a little endian bit stream, i.e., value i occupies
+    bits [i * BlkBitWidth, (i + 1) * BlkBitWidth) of the block. Zero points
+    are packed the same way, per column of B.
+
+--*/
+
+#include <algorithm>
+#include <cassert>
+
+#include "sqnbitgemm.h"
+
+namespace
+{
+
+constexpr size_t MaxBlkLen = 256;
+
+/**
+ * @brief Gets the zero point of block BlkIdx from a column of packed zero points.
+ *        Returns the default zero point, 2^(BlkBitWidth - 1), if QuantBZeroPointCol is null.
+ */
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE uint8_t
+LowBitBlkZeroPoint(const std::byte* QuantBZeroPointCol, size_t BlkIdx)
+{
+    if (QuantBZeroPointCol == nullptr) {
+        return uint8_t{1} << (BlkBitWidth - 1);
+    }
+
+    const size_t BitOffset = BlkIdx * BlkBitWidth;
+    uint32_t Bits = std::to_integer<uint32_t>(QuantBZeroPointCol[BitOffset / 8]);
+    if (BitOffset % 8 + BlkBitWidth > 8) {
+        Bits |= std::to_integer<uint32_t>(QuantBZeroPointCol[BitOffset / 8 + 1]) << 8;
+    }
+    return static_cast<uint8_t>((Bits >> (BitOffset % 8)) & ((1u << BlkBitWidth) - 1));
+}
+
+/**
+ * @brief Unpacks the BlkLen values of a block of packed quantized B data.
+ *        See SQLowBitGemmPackQuantBData() for the packed layout.
+ */
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE void
+UnpackLowBitBlk(const std::byte* PackedBlk, size_t BlkLen, uint8_t* Values)
+{
+    if constexpr (BlkBitWidth == 2) {
+        for (size_t i = 0; i < BlkLen; i += 4) {
+            const uint8_t Packed = std::to_integer<uint8_t>(PackedBlk[i / 4]);
+            Values[i + 0] = Packed & 0x3;
+            Values[i + 1] = (Packed >> 2) & 0x3;
+            Values[i + 2] = (Packed >> 4) & 0x3;
+            Values[i + 3] = (Packed >> 6) & 0x3;
+        }
+    } else {
+        static_assert(BlkBitWidth == 3, "only 2-bit and 3-bit blocks are supported");
+
+        const std::byte* LowPlane = PackedBlk;
+        const std::byte* HighPlane = PackedBlk + BlkLen / 4;
+
+        for (size_t i = 0; i < BlkLen; i += 8) {
+            const uint32_t Low = std::to_integer<uint32_t>(LowPlane[i / 4]) |
+                                 (std::to_integer<uint32_t>(LowPlane[i / 4 + 1]) << 8);
+            const uint32_t High = std::to_integer<uint32_t>(HighPlane[i / 8]);
+            for (size_t j = 0; j < 8; ++j) {
+                Values[i + j] = static_cast<uint8_t>(((Low >> (2 * j)) & 0x3) | (((High >> j) & 0x1) << 2));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Dequantizes the first CountK values of a block of packed quantized B data.
+ *        DstStride is the number of elements between adjacent values in Dst.
+ */
+template <size_t BlkBitWidth>
+MLAS_FORCEINLINE void
+DequantLowBitBlk(
+    const std::byte* PackedBlk,
+    size_t BlkLen,
+    float Scale,
+    uint8_t ZeroPoint,
+    size_t CountK,
+    float* Dst,
+    size_t DstStride
+)
+{
+    uint8_t Values[MaxBlkLen];
+    UnpackLowBitBlk<BlkBitWidth>(PackedBlk, BlkLen, Values);
+
+    const float Offset = static_cast<float>(ZeroPoint);
+    for (size_t kk = 0; kk < CountK; ++kk) {
+        Dst[kk * DstStride] = Scale * (static_cast<float>(Values[kk]) - Offset);
+    }
+}
+
+}  // namespace
+
+template <size_t BlkBitWidth>
+size_t
+SQLowBitGemmPackQuantBDataSize(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(ComputeType);  // same size regardless of ComputeType
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    const size_t PackedQuantBDataSize = N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    return PackedQuantBDataSize;
+}
+
+template <size_t BlkBitWidth>
+void
+SQLowBitGemmPackQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(ComputeType);  // same layout regardless of ComputeType
+
+    assert(BlkLen >= 16 && BlkLen % 16 == 0 && BlkLen <= MaxBlkLen);
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+
+    if constexpr (BlkBitWidth == 2) {
+        //
+        // 2-bit values already fill whole bytes and are used as is.
+        //
+        MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+        std::copy_n(QuantBDataBegin, N * BlockCountK * BlkDataSize, PackedQuantBDataBegin);
+    } else {
+        //
+        // Split each block of 3-bit values into a plane of the low 2 bits of each value (BlkLen / 4 bytes)
+        // followed by a plane of the high bit of each value (BlkLen / 8 bytes). 8 values (3 bytes) at a time:
+        //
+        // src: | v0 (3b) v1 (3b) v2 (3b) ... v7 (3b) |
+        //   =>
+        // dst low plane: | v0 v1 v2 v3 (2b each) | v4 v5 v6 v7 (2b each) |
+        // dst high plane: | v0 v1 v2 v3 v4 v5 v6 v7 (1b each) |
+        //
+        const size_t Iterations = N * BlockCountK;  // one iteration per block
+
+        MlasTrySimpleParallel(
+            ThreadPool, Iterations,
+            [&](ptrdiff_t tid) {
+                const size_t data_offset = tid * BlkDataSize;
+                const std::byte* QuantBData = QuantBDataBegin + data_offset;
+                std::byte* LowPlane = PackedQuantBDataBegin + data_offset;
+                std::byte* HighPlane = LowPlane + BlkLen / 4;
+
+                for (size_t i = 0; i < BlkLen; i += 8) {
+                    const std::byte* src = QuantBData + i * BlkBitWidth / 8;
+                    const uint32_t Values = std::to_integer<uint32_t>(src[0]) |
+                                            (std::to_integer<uint32_t>(src[1]) << 8) |
+                                            (std::to_integer<uint32_t>(src[2]) << 16);
+
+                    uint32_t Low = 0;
+                    uint32_t High = 0;
+                    for (size_t j = 0; j < 8; ++j) {
+                        const uint32_t v = (Values >> (3 * j)) & 0x7;
+                        Low |= (v & 0x3) << (2 * j);
+                        High |= (v >> 2) << j;
+                    }
+
+                    LowPlane[i / 4] = static_cast<std::byte>(Low & 0xFF);
+                    LowPlane[i / 4 + 1] = static_cast<std::byte>(Low >> 8);
+                    HighPlane[i / 8] = static_cast<std::byte>(High);
+                }
+            }
+        );
+    }
+}
+
+template <size_t BlkBitWidth>
+void
+SQLowBitGemmM1Kernel_CompFp32(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    const size_t StrideQuantBData = BlockStrideQuantB * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+
+    MLAS_DECLSPEC_ALIGN(float DequantBlk[MaxBlkLen], 16);
+
+    for (size_t n = 0; n < CountN; ++n) {
+        const std::byte* QuantBDataCol = QuantBData + n * StrideQuantBData;
+        const float* QuantBScaleCol = QuantBScale + n * BlockStrideQuantB;
+        const std::byte* QuantBZeroPointCol =
+            (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + n * StrideQuantBZeroPoint;
+
+        MLAS_FLOAT32X4 acc = MlasZeroFloat32x4();
+        float acc_tail = 0.0f;
+
+        for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, ++k_blk_idx) {
+            const size_t kklen = std::min(CountK - k, BlkLen);
+
+            DequantLowBitBlk<BlkBitWidth>(
+                QuantBDataCol + k_blk_idx * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen),
+                BlkLen,
+                QuantBScaleCol[k_blk_idx],
+                LowBitBlkZeroPoint<BlkBitWidth>(QuantBZeroPointCol, k_blk_idx),
+                kklen,
+                DequantBlk,
+                1
+            );
+
+            const float* a = A + k;
+
+            size_t kk = 0;
+            for (; kk + 4 <= kklen; kk += 4) {
+                acc = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(a + kk), MlasLoadFloat32x4(DequantBlk + kk), acc);
+            }
+            for (; kk < kklen; ++kk) {
+                acc_tail += a[kk] * DequantBlk[kk];
+            }
+        }
+
+        float sum = MlasReduceAddFloat32x4(acc) + acc_tail;
+        if (Bias != nullptr) {
+            sum += Bias[n];
+        }
+        C[n] = sum;
+    }
+}
+
+template <size_t BlkBitWidth>
+void
+QLowBitBlkDequantBForSgemm_CompFp32(
+    size_t BlkLen,
+    float* FpData,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB
+)
+{
+    const size_t StrideQuantBData = BlockStrideQuantB * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockStrideQuantB);
+
+    //
+    // Write 16 column-wide regions of B. Each region holds CountK rows of 16 values.
+    //
+
+    for (size_t n = 0; n < CountN; n += 16) {
+        const size_t nnlen = std::min(CountN - n, size_t{16});
+
+        float* Dst = FpData + n * CountK;
+
+        if (nnlen < 16) {
+            // zero out the region first to ensure zero padding
+            std::fill_n(Dst, 16 * CountK, 0.0f);
+        }
+
+        for (size_t nn = 0; nn < nnlen; ++nn) {
+            const std::byte* QuantBDataCol = QuantBData + (n + nn) * StrideQuantBData;
+            const float* QuantBScaleCol = QuantBScale + (n + nn) * BlockStrideQuantB;
+            const std::byte* QuantBZeroPointCol =
+                (QuantBZeroPoint == nullptr) ? nullptr : QuantBZeroPoint + (n + nn) * StrideQuantBZeroPoint;
+
+            for (size_t k = 0, k_blk_idx = 0; k < CountK; k += BlkLen, ++k_blk_idx) {
+                DequantLowBitBlk<BlkBitWidth>(
+                    QuantBDataCol + k_blk_idx * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen),
+                    BlkLen,
+                    QuantBScaleCol[k_blk_idx],
+                    LowBitBlkZeroPoint<BlkBitWidth>(QuantBZeroPointCol, k_blk_idx),
+                    std::min(CountK - k, BlkLen),
+                    Dst + k * 16 + nn,
+                    16
+                );
+            }
+        }
+    }
+}
+
+//
+// Explicit instantiations.
+//
+
+template size_t SQLowBitGemmPackQuantBDataSize<2>(
+    size_t, size_t, size_t, MLAS_SQNBIT_GEMM_COMPUTE_TYPE
+);
+template void SQLowBitGemmPackQuantBData<2>(
+    size_t, size_t, size_t, MLAS_SQNBIT_GEMM_COMPUTE_TYPE, const std::byte*, std::byte*, MLAS_THREADPOOL*
+);
+template void SQLowBitGemmM1Kernel_CompFp32<2>(
+    size_t, const float*, const std::byte*, const float*, const std::byte*, float*, size_t, size_t, size_t, const float*
+);
+template void QLowBitBlkDequantBForSgemm_CompFp32<2>(
+    size_t, float*, const std::byte*, const float*, const std::byte*, size_t, size_t, size_t
+);
+
+template size_t SQLowBitGemmPackQuantBDataSize<3>(
+    size_t, size_t, size_t, MLAS_SQNBIT_GEMM_COMPUTE_TYPE
+);
+template void SQLowBitGemmPackQuantBData<3>(
+    size_t, size_t, size_t, MLAS_SQNBIT_GEMM_COMPUTE_TYPE, const std::byte*, std::byte*, MLAS_THREADPOOL*
+);
+template void SQLowBitGemmM1Kernel_CompFp32<3>(
+    size_t, const float*, const std::byte*, const float*, const std::byte*, float*, size_t, size_t, size_t, const float*
+);
+template void QLowBitBlkDequantBForSgemm_CompFp32<3>(
+    size_t, float*, const std::byte*, const float*, const std::byte*, size_t, size_t, size_t
+);
@@ -547,7 +547,9 @@ MlasTranspose(
     const uint32_t* Input,
     uint32_t* Output,
     size_t M,
-    size_t N
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
     )
 /*++
 
@@ -568,6 +570,12 @@ Arguments:
     N - Supplies the number of columns for the input matrix and the number of
         rows for the output matrix.
 
+    InputStride - Supplies the number of elements between rows of the input
+        matrix.
+
+    OutputStride - Supplies the number of elements between rows of the output
+        matrix.
+
 Return Value:
 
     None.
@@ -592,9 +600,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, InputStride, d, OutputStride);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -603,15 +611,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += OutputStride * 4;
         n -= 4;
     }
 
@@ -628,9 +636,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, InputStride, d, 1);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -639,17 +647,29 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += OutputStride;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    uint32_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, Output, M, N, N, M);
+}
+
 void
 MLASCALL
 MlasTranspose(
@@ -673,7 +693,9 @@ MlasTranspose(
     const uint16_t* Input,
     uint16_t* Output,
     size_t M,
-    size_t N
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
     )
 /*++
 
@@ -694,6 +716,12 @@ Arguments:
     N - Supplies the number of columns for the input matrix and the number of
         rows for the output matrix.
 
+    InputStride - Supplies the number of elements between rows of the input
+        matrix.
+
+    OutputStride - Supplies the number of elements between rows of the output
+        matrix.
+
 Return Value:
 
     None.
@@ -717,9 +745,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4x4Block(s, N, d, M);
+            MlasTranspose4x4Block(s, InputStride, d, OutputStride);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -728,15 +756,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose4xNVector(s, 1, d, M);
+            MlasTranspose4xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 4;
-        Output += M * 4;
+        Output += OutputStride * 4;
         n -= 4;
     }
 
@@ -753,9 +781,9 @@ Return Value:
 
         while (m >= 4) {
 
-            MlasTranspose4xNVector(s, N, d, 1);
+            MlasTranspose4xNVector(s, InputStride, d, 1);
 
-            s += N * 4;
+            s += InputStride * 4;
             d += 4;
             m -= 4;
         }
@@ -764,25 +792,39 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += OutputStride;
         n -= 1;
     }
 }
 
 
+void
+MLASCALL
+MlasTranspose(
+    const uint16_t* Input,
+    uint16_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, Output, M, N, N, M);
+}
+
 void
 MLASCALL
 MlasTranspose(
     const uint8_t* Input,
     uint8_t* Output,
     size_t M,
-    size_t N
+    size_t N,
+    size_t InputStride,
+    size_t OutputStride
     )
 /*++
 
@@ -803,6 +845,12 @@ Arguments:
     N - Supplies the number of columns for the input matrix and the number of
         rows for the output matrix.
 
+    InputStride - Supplies the number of elements between rows of the input
+        matrix.
+
+    OutputStride - Supplies the number of elements between rows of the output
+        matrix.
+
 Return Value:
 
     None.
@@ -823,24 +871,24 @@ Return Value:
         size_t m = M;
         while (m >= 16) {
 
-            MlasTranspose16x16Block(s, N, d, M);
+            MlasTranspose16x16Block(s, InputStride, d, OutputStride);
 
-            s += N * 16;
+            s += InputStride * 16;
             d += 16;
             m -= 16;
         }
 
         while (m > 0) {
 
-            MlasTranspose16xNVector(s, 1, d, M);
+            MlasTranspose16xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 16;
-        Output += M * 16;
+        Output += OutputStride * 16;
         n -= 16;
     }
 #endif
@@ -854,9 +902,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8x8Block(s, N, d, M);
+            MlasTranspose8x8Block(s, InputStride, d, OutputStride);
 
-            s += N * 8;
+            s += InputStride * 8;
             d += 8;
             m -= 8;
         }
@@ -865,15 +913,15 @@ Return Value:
 
         while (m > 0) {
 
-            MlasTranspose8xNVector(s, 1, d, M);
+            MlasTranspose8xNVector(s, 1, d, OutputStride);
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 8;
-        Output += M * 8;
+        Output += OutputStride * 8;
         n -= 8;
     }
 
@@ -890,9 +938,9 @@ Return Value:
 
         while (m >= 8) {
 
-            MlasTranspose8xNVector(s, N, d, 1);
+            MlasTranspose8xNVector(s, InputStride, d, 1);
 
-            s += N * 8;
+            s += InputStride * 8;
             d += 8;
             m -= 8;
         }
@@ -901,17 +949,29 @@ Return Value:
 
             d[0] = s[0];
 
-            s += N;
+            s += InputStride;
             d += 1;
             m -= 1;
         }
 
         Input += 1;
-        Output += M;
+        Output += OutputStride;
         n -= 1;
     }
 }
 
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    uint8_t* Output,
+    size_t M,
+    size_t N
+    )
+{
+    MlasTranspose(Input, Output, M, N, N, M);
+}
+
 void
 MLASCALL
 MlasTranspose(
@@ -0,0 +1,607 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    winograd.cpp
+
+Abstract:
+
+    This module implements the single precision convolution operation for
+    3x3 kernels with unit stride and dilation using the Winograd F(2x2, 3x3)
+    minimal filtering algorithm.
+
+    The output image is split into 2x2 tiles, each computed from a 4x4 tile of
+    the input image. With the transformed filter U = G g G^T and the
+    transformed input tile V = B^T d B, the output tile is A^T (U . V) A. The
+    element wise products summed over the input channels are computed as 16
+    independent GEMMs, one per element of the 4x4 transformed tiles, which
+    take 2.25 times fewer multiplications than the direct convolution.
+
+    The filter is transformed once by the caller, see
+    MlasWinogradConvPackFilter.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Define the number of elements of a transformed tile.
+//
+
+constexpr size_t MlasWinogradTileElements = 16;
+
+//
+// Define the number of tiles transformed and multiplied together.
+//
+
+constexpr size_t MlasWinogradMaximumTileBlock = 64;
+constexpr size_t MlasWinogradMinimumTileBlock = 8;
+
+//
+// Define the size in bytes of the per thread transformed input and output
+// tiles used to select the number of tiles processed together.
+//
+
+constexpr size_t MlasWinogradWorkingBufferBytes = 4 * 1024 * 1024;
+
+//
+// Define the parameters to execute segments of a Winograd convolution on
+// worker threads.
+//
+
+struct MLAS_WINOGRAD_CONV_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* PackedFilter;
+    const float* Bias;
+    float* Output;
+    size_t TileRows;
+    size_t TileColumns;
+    size_t TileBlock;
+    ptrdiff_t ThreadCount;
+};
+
+bool
+MLASCALL
+MlasWinogradConvSupported(
+    size_t Dimensions,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether a convolution is computed with the Winograd
+    algorithm, using a filter packed by MlasWinogradConvPackFilter.
+
+Arguments:
+
+    Dimensions - Supplies the number of dimensions.
+
+    KernelShape - Supplies the shape of the kernel.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    StrideShape - Supplies the shape of the stride.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns true if the convolution can use the Winograd algorithm.
+
+--*/
+{
+    if (Dimensions != 2) {
+        return false;
+    }
+
+    for (size_t dim = 0; dim < 2; dim++) {
+        if (KernelShape[dim] != 3 || DilationShape[dim] != 1 || StrideShape[dim] != 1) {
+            return false;
+        }
+    }
+
+    //
+    // The transforms of the input and output tiles are only amortized by
+    // GEMMs large enough.
+    //
+
+    return InputChannels >= 16 && FilterCount >= 16;
+}
+
+size_t
+MLASCALL
+MlasWinogradConvPackFilterSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine returns the number of elements of a filter packed by
+    MlasWinogradConvPackFilter.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the number of elements of the packed filter.
+
+--*/
+{
+    return GroupCount * MlasWinogradTileElements * FilterCount * InputChannels;
+}
+
+void
+MLASCALL
+MlasWinogradConvPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 3x3 kernels of a filter to the 4x4 Winograd
+    domain.
+
+    For each group, the packed filter is laid out as 16 matrices of
+    FilterCount rows by InputChannels columns, one per element of the
+    transformed kernels.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter, of shape [GroupCount * FilterCount,
+        InputChannels, 3, 3].
+
+    PackedFilter - Supplies the buffer of MlasWinogradConvPackFilterSize
+        elements receiving the transformed filter.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t MatrixSize = FilterCount * InputChannels;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                const float* k = Filter + ((g * FilterCount + f) * InputChannels + c) * 9;
+
+                //
+                // Compute G g, a 4x3 matrix.
+                //
+
+                float t[4][3];
+
+                for (size_t j = 0; j < 3; j++) {
+                    t[0][j] = k[j];
+                    t[1][j] = 0.5f * (k[j] + k[3 + j] + k[6 + j]);
+                    t[2][j] = 0.5f * (k[j] - k[3 + j] + k[6 + j]);
+                    t[3][j] = k[6 + j];
+                }
+
+                //
+                // Compute (G g) G^T, a 4x4 matrix.
+                //
+
+                float* u = PackedFilter + f * InputChannels + c;
+
+                for (size_t i = 0; i < 4; i++) {
+                    u[(i * 4 + 0) * MatrixSize] = t[i][0];
+                    u[(i * 4 + 1) * MatrixSize] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+                    u[(i * 4 + 2) * MatrixSize] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+                    u[(i * 4 + 3) * MatrixSize] = t[i][2];
+                }
+            }
+        }
+
+        PackedFilter += MlasWinogradTileElements * MatrixSize;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasWinogradInputTransform(
+    const float d[4][4],
+    float* V,
+    size_t ldv
+    )
+/*++
+
+Routine Description:
+
+    This routine computes B^T d B for a 4x4 input tile and stores the 16
+    results with a stride of ldv elements.
+
+--*/
+{
+    float t[4][4];
+
+    for (size_t j = 0; j < 4; j++) {
+        t[0][j] = d[0][j] - d[2][j];
+        t[1][j] = d[1][j] + d[2][j];
+        t[2][j] = d[2][j] - d[1][j];
+        t[3][j] = d[1][j] - d[3][j];
+    }
+
+    for (size_t i = 0; i < 4; i++) {
+        V[(i * 4 + 0) * ldv] = t[i][0] - t[i][2];
+        V[(i * 4 + 1) * ldv] = t[i][1] + t[i][2];
+        V[(i * 4 + 2) * ldv] = t[i][2] - t[i][1];
+        V[(i * 4 + 3) * ldv] = t[i][1] - t[i][3];
+    }
+}
+
+void
+MlasWinogradConvTileBlock(
+    const MLAS_WINOGRAD_CONV_WORK_BLOCK* WorkBlock,
+    const float* Input,
+    const float* PackedFilter,
+    float* Output,
+    size_t StartTile,
+    size_t CountTiles,
+    float* TransformedInput,
+    float* TransformedOutput
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a block of consecutive output tiles of an image for
+    all the filters of a group.
+
+Arguments:
+
+    WorkBlock - Supplies the structure that contains the Winograd convolution
+        parameters.
+
+    Input - Supplies the input image of the group.
+
+    PackedFilter - Supplies the packed filter of the group.
+
+    Output - Supplies the output image of the group.
+
+    StartTile - Supplies the index of the first tile in the image.
+
+    CountTiles - Supplies the number of tiles to process.
+
+    TransformedInput - Supplies the buffer receiving the transformed input
+        tiles, laid out as 16 matrices of InputChannels rows by CountTiles
+        columns.
+
+    TransformedOutput - Supplies the buffer receiving the products of the
+        transformed tiles, laid out as 16 matrices of FilterCount rows by
+        CountTiles columns.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TileColumns = WorkBlock->TileColumns;
+    const float Beta = Parameters->Beta;
+
+    //
+    // Transform the input tiles.
+    //
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        const float* InputChannel = Input + c * InputSize;
+        float* V = TransformedInput + c * CountTiles;
+
+        for (size_t t = 0; t < CountTiles; t++) {
+
+            const size_t Tile = StartTile + t;
+            const ptrdiff_t ih = ptrdiff_t((Tile / TileColumns) * 2) - ptrdiff_t(PaddingTop);
+            const ptrdiff_t iw = ptrdiff_t((Tile % TileColumns) * 2) - ptrdiff_t(PaddingLeft);
+
+            float d[4][4];
+
+            if (ih >= 0 && ih + 4 <= ptrdiff_t(InputHeight) && iw >= 0 && iw + 4 <= ptrdiff_t(InputWidth)) {
+
+                const float* row = InputChannel + ih * InputWidth + iw;
+
+                for (size_t i = 0; i < 4; i++, row += InputWidth) {
+                    d[i][0] = row[0];
+                    d[i][1] = row[1];
+                    d[i][2] = row[2];
+                    d[i][3] = row[3];
+                }
+
+            } else {
+
+                for (ptrdiff_t i = 0; i < 4; i++) {
+                    for (ptrdiff_t j = 0; j < 4; j++) {
+                        const ptrdiff_t h = ih + i;
+                        const ptrdiff_t w = iw + j;
+                        d[i][j] = (h >= 0 && h < ptrdiff_t(InputHeight) && w >= 0 && w < ptrdiff_t(InputWidth))
+                            ? InputChannel[h * InputWidth + w] : 0.0f;
+                    }
+                }
+            }
+
+            MlasWinogradInputTransform(d, V + t, InputChannels * CountTiles);
+        }
+    }
+
+    //
+    // Multiply the transformed filter and input tiles and sum over the input
+    // channels.
+    //
+
+    const size_t FilterMatrixSize = FilterCount * InputChannels;
+
+    for (size_t e = 0; e < MlasWinogradTileElements; e++) {
+        MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountTiles,
+            InputChannels, 1.0f, PackedFilter + e * FilterMatrixSize, InputChannels,
+            TransformedInput + e * InputChannels * CountTiles, CountTiles, 0.0f,
+            TransformedOutput + e * FilterCount * CountTiles, CountTiles);
+    }
+
+    //
+    // Transform the products to the output tiles, A^T m A.
+    //
+
+    const size_t ldm = FilterCount * CountTiles;
+
+    for (size_t f = 0; f < FilterCount; f++) {
+
+        const float* M = TransformedOutput + f * CountTiles;
+        float* OutputChannel = Output + f * OutputSize;
+
+        for (size_t t = 0; t < CountTiles; t++, M++) {
+
+            float s[2][4];
+
+            for (size_t j = 0; j < 4; j++) {
+                const float m0 = M[(0 * 4 + j) * ldm];
+                const float m1 = M[(1 * 4 + j) * ldm];
+                const float m2 = M[(2 * 4 + j) * ldm];
+                const float m3 = M[(3 * 4 + j) * ldm];
+                s[0][j] = m0 + m1 + m2;
+                s[1][j] = m1 - m2 - m3;
+            }
+
+            const size_t Tile = StartTile + t;
+            const size_t oh = (Tile / TileColumns) * 2;
+            const size_t ow = (Tile % TileColumns) * 2;
+
+            for (size_t i = 0; i < 2 && oh + i < OutputHeight; i++) {
+
+                float y[2];
+                y[0] = s[i][0] + s[i][1] + s[i][2];
+                y[1] = s[i][1] - s[i][2] - s[i][3];
+
+                float* row = OutputChannel + (oh + i) * OutputWidth + ow;
+
+                for (size_t j = 0; j < 2 && ow + j < OutputWidth; j++) {
+                    row[j] = (Beta == 0.0f) ? y[j] : y[j] + Beta * row[j];
+                }
+            }
+        }
+    }
+}
+
+void
+MlasWinogradConvThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    Winograd convolution.
+
+    The work is split by rows of output tiles over the images and groups, so
+    that each thread applies the activation to the rows of the output images
+    it computed.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_WINOGRAD_CONV_WORK_BLOCK*)Context;
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TileRows = WorkBlock->TileRows;
+    const size_t TileColumns = WorkBlock->TileColumns;
+    const size_t TileBlock = WorkBlock->TileBlock;
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->ThreadCount,
+        Parameters->BatchCount * GroupCount * TileRows, &WorkIndex, &WorkRemaining);
+
+    const size_t TransformedInputSize = MlasWinogradTileElements * InputChannels * TileBlock;
+    const size_t TransformedOutputSize = MlasWinogradTileElements * FilterCount * TileBlock;
+
+    MlasThreadedBufAlloc((TransformedInputSize + TransformedOutputSize) * sizeof(float));
+    float* TransformedInput = reinterpret_cast<float*>(ThreadedBufHolder.get());
+    float* TransformedOutput = TransformedInput + TransformedInputSize;
+
+    while (WorkRemaining > 0) {
+
+        //
+        // Compute the rows of tiles of the current image and group.
+        //
+
+        const size_t ImageGroup = WorkIndex / TileRows;
+        const size_t StartRow = WorkIndex % TileRows;
+        const size_t CountRows = std::min(WorkRemaining, TileRows - StartRow);
+        const size_t g = ImageGroup % GroupCount;
+
+        const float* Input = WorkBlock->Input + ImageGroup * InputChannels * Parameters->InputSize;
+        const float* PackedFilter = WorkBlock->PackedFilter +
+            g * MlasWinogradTileElements * FilterCount * InputChannels;
+        float* Output = WorkBlock->Output + ImageGroup * FilterCount * OutputSize;
+
+        const size_t EndTile = (StartRow + CountRows) * TileColumns;
+
+        for (size_t Tile = StartRow * TileColumns; Tile < EndTile; Tile += TileBlock) {
+
+            const size_t CountTiles = std::min(TileBlock, EndTile - Tile);
+
+            MlasWinogradConvTileBlock(WorkBlock, Input, PackedFilter, Output, Tile,
+                CountTiles, TransformedInput, TransformedOutput);
+        }
+
+        //
+        // Apply the activation with optional bias to the rows of the output
+        // images.
+        //
+
+        const size_t StartOutputRow = StartRow * 2;
+        const size_t EndOutputRow = std::min((StartRow + CountRows) * 2, OutputHeight);
+        const float* Bias = WorkBlock->Bias != nullptr ? WorkBlock->Bias + g * FilterCount : nullptr;
+
+        MlasActivation(Parameters->Activation, Output + StartOutputRow * OutputWidth, Bias,
+            FilterCount, (EndOutputRow - StartOutputRow) * OutputWidth, OutputSize);
+
+        WorkIndex += CountRows;
+        WorkRemaining -= CountRows;
+    }
+}
+
+void
+MLASCALL
+MlasWinogradConv(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    const float* Bias,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation with the Winograd
+    algorithm.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters, prepared by MlasConvPrepare for a convolution accepted by
+        MlasWinogradConvSupported.
+
+    Input - Supplies the input tensor.
+
+    PackedFilter - Supplies the filter packed by MlasWinogradConvPackFilter.
+
+    Bias - Supplies the optional bias vector.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_WINOGRAD_CONV_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.PackedFilter = PackedFilter;
+    WorkBlock.Bias = Bias;
+    WorkBlock.Output = Output;
+    WorkBlock.TileRows = (Parameters->OutputShape[0] + 1) / 2;
+    WorkBlock.TileColumns = (Parameters->OutputShape[1] + 1) / 2;
+
+    //
+    // Process as many tiles at once as fit in the working buffer, so that the
+    // GEMMs are wide enough.
+    //
+
+    const size_t BytesPerTile =
+        MlasWinogradTileElements * (Parameters->InputChannels + Parameters->FilterCount) * sizeof(float);
+
+    size_t TileBlock = MlasWinogradWorkingBufferBytes / BytesPerTile;
+    TileBlock = std::max(MlasWinogradMinimumTileBlock, std::min(MlasWinogradMaximumTileBlock, TileBlock));
+    WorkBlock.TileBlock = TileBlock;
+
+    const size_t TotalWork = Parameters->BatchCount * Parameters->GroupCount * WorkBlock.TileRows;
+
+    if (TotalWork == 0) {
+        return;
+    }
+
+    ptrdiff_t ThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (size_t(ThreadCount) > TotalWork) {
+        ThreadCount = ptrdiff_t(TotalWork);
+    }
+
+    WorkBlock.ThreadCount = ThreadCount;
+
+    MlasExecuteThreaded(MlasWinogradConvThreaded, &WorkBlock, ThreadCount, ThreadPool);
+}
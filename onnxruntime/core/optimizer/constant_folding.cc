@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <limits>
+#include <optional>
+#include <vector>
 
 #include "core/optimizer/constant_folding.h"
 #include "core/optimizer/initializer.h"
@@ -11,6 +14,7 @@
 #include "core/optimizer/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 using namespace onnxruntime::common;
 
@@ -28,9 +32,9 @@ ConstantFolding::ConstantFolding(const IExecutionProvider& execution_provider,
       execution_provider_(execution_provider) {
 }
 
-// We need to handle a Shape node separately as the input doesn't need to be a constant initializer for
-// Shape to be able to be constant folded.
-static bool ConstantFoldShapeNode(Graph& graph, Node& node) {
+// Get the values of the dims a Shape node outputs, which are nullopt if unknown.
+// Returns false if the rank of the input is unknown.
+static bool GetShapeNodeOutputDims(const Node& node, std::vector<std::optional<int64_t>>& dims) {
   // Opset-15 Shape supports slicing using a 'start' and 'end' attribute
   const auto& shape_attributes = node.GetAttributes();
 
@@ -45,52 +49,119 @@ static bool ConstantFoldShapeNode(Graph& graph, Node& node) {
     }
   }
 
-  auto shape = node.MutableInputDefs()[0]->Shape();
-  bool is_concrete_shape = true;
+  const auto* shape = node.InputDefs()[0]->Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  const int64_t rank = shape->dim_size();
+
+  // We ascertain the "true" starts/ends (if they were provided)
+  // Deal with negatives and clamp
+  start = start < 0 ? start + rank : start;
+  start = start < 0 ? 0 : ((start > rank) ? rank : start);
+
+  end = end < 0 ? end + rank : end;
+  end = end < 0 ? 0 : ((end > rank) ? rank : end);
+
+  dims.clear();
+  for (int64_t dim_index = start; dim_index < end; ++dim_index) {
+    const auto& dim = shape->dim(static_cast<int>(dim_index));
+    dims.push_back(utils::HasDimValue(dim) ? std::optional<int64_t>{dim.dim_value()} : std::nullopt);
+  }
+
+  return true;
+}
+
+static void AddInt64Initializer(Graph& graph, NodeArg& constant_arg_out, const std::vector<int64_t>& values,
+                                const std::vector<int64_t>& dims) {
+  ONNX_NAMESPACE::TensorProto constant;
+  constant.set_name(constant_arg_out.Name());
+  constant.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  ONNX_NAMESPACE::TensorShapeProto result_shape;
+  for (int64_t dim : dims) {
+    constant.add_dims(dim);
+    result_shape.add_dim()->set_dim_value(dim);
+  }
+  constant.set_raw_data(values.data(), values.size() * sizeof(int64_t));
+  constant_arg_out.SetShape(result_shape);
+  graph.AddInitializedTensor(constant);
+}
+
+// We need to handle a Shape node separately as the input doesn't need to be a constant initializer for
+// Shape to be able to be constant folded. Only the dims selected by the slice need to be known.
+static bool ConstantFoldShapeNode(Graph& graph, Node& node) {
+  std::vector<std::optional<int64_t>> dims;
+  if (!GetShapeNodeOutputDims(node, dims) ||
+      std::any_of(dims.begin(), dims.end(), [](const std::optional<int64_t>& dim) { return !dim.has_value(); })) {
+    return false;
+  }
+
   std::vector<int64_t> dim_values;
-  if (shape != nullptr) {
-    for (int dim_index = 0; dim_index < shape->dim_size(); dim_index++) {
-      auto dim = shape->dim(dim_index);
-      if (!utils::HasDimValue(dim)) {
-        is_concrete_shape = false;
-        break;
-      }
-      dim_values.push_back(dim.dim_value());
-    }
+  dim_values.reserve(dims.size());
+  for (const auto& dim : dims) {
+    dim_values.push_back(*dim);
+  }
+
+  AddInt64Initializer(graph, *node.MutableOutputDefs()[0], dim_values, {static_cast<int64_t>(dim_values.size())});
+  return true;  // convert to constant
+}
+
+// Gather(Shape(X), indices) with constant indices is folded if the gathered dims of X are known, even if other dims
+// are symbolic. This is the usual way exported models test a dim, e.g. for the condition of an If node, which can
+// then be inlined once its condition is constant.
+static bool ConstantFoldGatherOfShapeNode(Graph& graph, Node& node) {
+  const auto& input_defs = node.InputDefs();
+  const auto* axis = graph_utils::GetNodeAttribute(node, "axis");
+  // the data is 1D so the axis is 0 or -1
+  if (input_defs.size() != 2 || (axis != nullptr && axis->i() != 0 && axis->i() != -1)) {
+    return false;
+  }
+
+  const Node* shape_node = graph.GetProducerNode(input_defs[0]->Name());
+  if (shape_node == nullptr || shape_node->OpType() != "Shape" || shape_node->Domain() != kOnnxDomain) {
+    return false;
+  }
+
+  const ONNX_NAMESPACE::TensorProto* indices_proto =
+      graph_utils::GetConstantInitializer(graph, input_defs[1]->Name(), true);
+  if (indices_proto == nullptr) {
+    return false;
+  }
+
+  std::vector<std::optional<int64_t>> dims;
+  if (!GetShapeNodeOutputDims(*shape_node, dims)) {
+    return false;
+  }
+
+  Initializer indices{*indices_proto, graph.ModelPath()};
+  std::vector<int64_t> index_values;
+  if (indices.data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT64) {
+    const auto span = indices.DataAsSpan<int64_t>();
+    index_values.assign(span.begin(), span.end());
+  } else if (indices.data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT32) {
+    const auto span = indices.DataAsSpan<int32_t>();
+    index_values.assign(span.begin(), span.end());
   } else {
-    is_concrete_shape = false;
+    return false;
   }
 
-  if (is_concrete_shape) {
-    int64_t rank = static_cast<int64_t>(dim_values.size());
-
-    // We ascertain the "true" starts/ends (if they were provided)
-    // Opset-15 Shape op supports slicing shape values
-
-    // Deal with negatives and clamp
-    start = start < 0 ? start + rank : start;
-    start = start < 0 ? 0 : ((start > rank) ? rank : start);
-
-    end = end < 0 ? end + rank : end;
-    end = end < 0 ? 0 : ((end > rank) ? rank : end);
-
-    int64_t slice_length = end - start;
-    size_t clamped_slice_length = slice_length < 0 ? 0 : static_cast<size_t>(slice_length);
-
-    ONNX_NAMESPACE::TensorProto shape_constant;
-    auto* constant_arg_out = node.MutableOutputDefs()[0];
-    shape_constant.set_name(constant_arg_out->Name());
-    shape_constant.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
-    shape_constant.add_dims(clamped_slice_length);
-    shape_constant.set_raw_data(dim_values.data() + start,
-                                clamped_slice_length * sizeof(int64_t));
-    ONNX_NAMESPACE::TensorShapeProto result_shape;
-    result_shape.add_dim()->set_dim_value(clamped_slice_length);
-    constant_arg_out->SetShape(result_shape);
-    graph.AddInitializedTensor(shape_constant);
+  const auto num_dims = static_cast<int64_t>(dims.size());
+  std::vector<int64_t> values;
+  values.reserve(index_values.size());
+  for (int64_t index : index_values) {
+    index = index < 0 ? index + num_dims : index;
+    if (index < 0 || index >= num_dims || !dims[static_cast<size_t>(index)].has_value()) {
+      return false;
+    }
+    values.push_back(*dims[static_cast<size_t>(index)]);
   }
 
-  return is_concrete_shape;  // convert to constant if this is true
+  // the output has the shape of the indices as the data is 1D
+  const auto indices_dims = indices.dims();
+  AddInt64Initializer(graph, *node.MutableOutputDefs()[0], values,
+                      std::vector<int64_t>(indices_dims.begin(), indices_dims.end()));
+  return true;
 }
 
 // This function inlines the appropriate subgraph. It does not literally fold it.
@@ -132,6 +203,174 @@ static Status ConstantFoldIfNode(Graph& graph, Node& if_node, const logging::Log
   return status;
 }
 
+// Create the kernel of a node for constant folding, or nullptr if the CPU EP has no kernel for the node.
+static std::unique_ptr<const OpKernel> CreateCpuKernel(const OptimizerExecutionFrame::Info& info, Node& node,
+                                                       const ConfigOptions& config_options) {
+  if (node.GetExecutionProviderType() == kCpuExecutionProvider) {
+    return info.CreateKernel(&node, config_options);
+  }
+
+  // We need to copy the string here instead of taking a reference to it since node.SetExecutionProviderType
+  // will change the value of the reference
+  auto ep_type = node.GetExecutionProviderType();
+
+  // override the EP assigned to the node so that it will use the CPU kernel for Compute.
+  node.SetExecutionProviderType(kCpuExecutionProvider);
+
+  auto kernel = info.CreateKernel(&node, config_options);
+
+  // undo the EP change to the value that was assigned at graph partitioning time
+  node.SetExecutionProviderType(ep_type);
+  return kernel;
+}
+
+// Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
+static void AddOutputAsInitializer(Graph& graph, NodeArg& constant_arg_out, const OrtValue& ort_value) {
+  const Tensor& out_tensor = ort_value.Get<Tensor>();
+  ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out.Name());
+
+  ONNX_NAMESPACE::TensorShapeProto result_shape;
+  for (auto& dim : out_tensor.Shape().GetDims()) {
+    result_shape.add_dim()->set_dim_value(dim);
+  }
+
+  constant_arg_out.SetShape(result_shape);
+  graph.AddInitializedTensor(out_tensorproto);
+}
+
+// Batched version of graph_utils::AllNodeInputsAreConstant: the outputs of the nodes already in the batch are
+// constant too. Only the constant initializers are added to constant_inputs.
+static bool AllNodeInputsAreConstantOrBatched(const Graph& graph, const Node& node,
+                                              const InlinedHashSet<const NodeArg*>& batched_outputs,
+                                              InitializedTensorSet& constant_inputs,
+                                              const InlinedHashSet<std::string>& excluded_initializers) {
+  constant_inputs.clear();
+
+  for (const auto* input_def : node.InputDefs()) {
+    // For optional node inputs which are missing, we can safely ignore them
+    if (input_def->Name().empty() || batched_outputs.count(input_def) > 0) {
+      continue;
+    }
+
+    const ONNX_NAMESPACE::TensorProto* initializer =
+        graph_utils::GetConstantInitializer(graph, input_def->Name(), true);
+    if (initializer && excluded_initializers.find(input_def->Name()) == excluded_initializers.cend()) {
+      constant_inputs.insert({input_def->Name(), initializer});
+    } else {
+      constant_inputs.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status ConstantFolding::FoldBatchedNodes(Graph& graph, gsl::span<const NodeIndex> node_indices,
+                                         const InitializedTensorSet& constant_inputs,
+                                         const std::function<bool(const std::string&)>& is_sparse_initializer_check,
+                                         bool& folded, const logging::Logger& logger) const {
+  folded = false;
+
+  // Folding a Shape node removes the nodes only producing its input, which may have been batched.
+  InlinedVector<Node*> nodes;
+  for (NodeIndex node_index : node_indices) {
+    auto* node = graph.GetNode(node_index);
+    if (node) {
+      nodes.push_back(node);
+    }
+  }
+
+  // Create a single execution frame for executing all the constant nodes.
+  std::vector<const Node*> frame_nodes(nodes.begin(), nodes.end());
+  OptimizerExecutionFrame::Info info(frame_nodes, constant_inputs, graph.ModelPath(), execution_provider_,
+                                     is_sparse_initializer_check);
+
+  // The nodes are in topological order. A node is evaluated if it has a CPU kernel and so do the nodes of the batch
+  // producing its inputs.
+  InlinedVector<Node*> evaluated_nodes;
+  InlinedVector<std::unique_ptr<const OpKernel>> kernels;
+  InlinedHashSet<NodeIndex> evaluated_node_indices;
+  for (Node* node : nodes) {
+    bool input_nodes_evaluated = true;
+    for (auto it = node->InputNodesBegin(), end = node->InputNodesEnd(); it != end; ++it) {
+      if (evaluated_node_indices.count(it->Index()) == 0) {
+        input_nodes_evaluated = false;
+        break;
+      }
+    }
+
+    if (!input_nodes_evaluated) {
+      continue;
+    }
+
+    auto kernel = CreateCpuKernel(info, *node, config_options_);
+    if (kernel == nullptr) {
+      LOGS(logger, WARNING) << "Could not find a CPU kernel and hence "
+                            << "can't constant fold " << node->OpType() << " node '" << node->Name() << "'";
+      continue;
+    }
+
+    evaluated_nodes.push_back(node);
+    kernels.push_back(std::move(kernel));
+    evaluated_node_indices.insert(node->Index());
+  }
+
+  if (evaluated_nodes.empty()) {
+    return Status::OK();
+  }
+
+  // Only the outputs used outside of the evaluated nodes are converted to initializers. The intermediate values
+  // stay in the execution frame.
+  InlinedVector<NodeArg*> fetch_args;
+  std::vector<int> fetch_mlvalue_idxs;
+  for (Node* node : evaluated_nodes) {
+    for (auto* node_out : node->MutableOutputDefs()) {
+      if (!node_out->Exists()) {
+        continue;
+      }
+
+      bool used_outside = graph.IsOutput(node_out);
+      for (const auto* consumer : graph.GetConsumerNodes(node_out->Name())) {
+        used_outside = used_outside || evaluated_node_indices.count(consumer->Index()) == 0;
+      }
+
+      if (used_outside) {
+        fetch_args.push_back(node_out);
+        fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
+      }
+    }
+  }
+
+  OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs);
+  for (const auto& kernel : kernels) {
+#ifdef _WIN32
+#pragma warning(push)
+#pragma warning(disable : 6387)
+#endif
+    OpKernelContext op_kernel_context(&frame, kernel.get(), /*stream*/ nullptr, nullptr, logger);
+    ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(frame.GetOutputs(fetches));
+  ORT_ENFORCE(fetches.size() == fetch_args.size());
+  for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
+    AddOutputAsInitializer(graph, *fetch_args[fetch_idx], fetches[fetch_idx]);
+  }
+
+  // Remove the output edges of the constant nodes and then remove the nodes themselves.
+  for (Node* node : evaluated_nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+  }
+
+  folded = true;
+  return Status::OK();
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
   bool have_updated_nodes = false;
   GraphViewer graph_viewer(graph);
@@ -141,8 +380,19 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
   std::function<bool(const std::string&)> is_sparse_initializer_check = [&graph](const std::string& name) -> bool {
     return graph.IsSparseInitializer(name);
   };
+#else
+  std::function<bool(const std::string&)> is_sparse_initializer_check = [](const std::string&) -> bool {
+    return false;
+  };
 #endif
 
+  // In batched mode the constant nodes are collected in topological order and evaluated together after the
+  // traversal, except for the Shape and If nodes that are folded without being executed.
+  const bool batched = config_options_.GetConfigOrDefault(kOrtSessionOptionsEnableBatchedConstantFolding, "0") == "1";
+  InlinedVector<NodeIndex> batched_nodes;
+  InlinedHashSet<const NodeArg*> batched_outputs;
+  InitializedTensorSet batched_constant_inputs;
+
   for (NodeIndex i : order) {
     auto* node = graph.GetNode(i);
     if (!node) {
@@ -175,6 +425,9 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
       }
     } else if (node->OpType().compare("Shape") == 0) {
       converted_to_constant = ConstantFoldShapeNode(graph, *node);
+    } else if (node->OpType().compare("Gather") == 0 && node->Domain() == kOnnxDomain &&
+               ConstantFoldGatherOfShapeNode(graph, *node)) {
+      converted_to_constant = true;
     } else {
       InitializedTensorSet constant_inputs;
 
@@ -187,7 +440,9 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
                // by the Recurse call above
                !n.ContainsSubgraph() &&
                (skip_inputs_constant_check ||
-                graph_utils::AllNodeInputsAreConstant(graph, n, constant_inputs, excluded_initializers_));
+                (batched ? AllNodeInputsAreConstantOrBatched(graph, n, batched_outputs, constant_inputs,
+                                                             excluded_initializers_)
+                         : graph_utils::AllNodeInputsAreConstant(graph, n, constant_inputs, excluded_initializers_)));
       };
 
       if (!can_constant_fold_node(*node)) {
@@ -225,40 +480,33 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         }
       }
 
-#if !defined(DISABLE_SPARSE_TENSORS)
+      if (batched) {
+        // XXX: Add support for SparseTensors outputs when we have sparse outputs
+        const auto& output_defs = node->OutputDefs();
+        if (std::all_of(output_defs.begin(), output_defs.end(), [](const NodeArg* output_def) {
+              return !output_def->Exists() || utils::HasTensorType(*output_def->TypeAsProto());
+            })) {
+          batched_nodes.push_back(node->Index());
+          batched_outputs.insert(output_defs.begin(), output_defs.end());
+          batched_constant_inputs.insert(constant_inputs.begin(), constant_inputs.end());
+        } else {
+          LOGS(logger, INFO) << "Unsupported output type. Can't constant fold " << node->OpType() << " node '"
+                             << node->Name() << "'";
+        }
+
+        continue;
+      }
+
       // Create execution frame for executing constant nodes.
       OptimizerExecutionFrame::Info info({node}, constant_inputs, graph.ModelPath(), execution_provider_,
                                          is_sparse_initializer_check);
-#else
-      // Create execution frame for executing constant nodes.
-      OptimizerExecutionFrame::Info info({node}, constant_inputs, graph.ModelPath(), execution_provider_,
-                                         [](std::string const&) { return false; });
-#endif
 
       std::vector<int> fetch_mlvalue_idxs;
       for (const auto* node_out : node->OutputDefs()) {
         fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
       }
 
-      const bool node_on_cpu_ep = node->GetExecutionProviderType() == kCpuExecutionProvider;
-
-      std::unique_ptr<const OpKernel> kernel;
-
-      if (!node_on_cpu_ep) {
-        // We need to copy the string here instead of taking a reference to it since node->SetExecutionProviderType
-        // will change the value of the reference
-        auto ep_type = node->GetExecutionProviderType();
-
-        // override the EP assigned to the node so that it will use the CPU kernel for Compute.
-        node->SetExecutionProviderType(kCpuExecutionProvider);
-
-        kernel = info.CreateKernel(node, config_options_);
-
-        // undo the EP change to the value that was assigned at graph partitioning time
-        node->SetExecutionProviderType(ep_type);
-      } else {
-        kernel = info.CreateKernel(node, config_options_);
-      }
+      std::unique_ptr<const OpKernel> kernel = CreateCpuKernel(info, *node, config_options_);
 
       // We currently constant fold using the CPU EP only.
       // If we can't find a CPU kernel for this node, then we can't proceed with constant folding.
@@ -304,19 +552,7 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
 
       if (converted_to_constant) {
         for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
-          OrtValue& ort_value = fetches[fetch_idx];
-          // Build the TensorProto that corresponds to the computed OrtValue and add it as initializer to the graph.
-          auto* constant_arg_out = node->MutableOutputDefs()[fetch_idx];
-          const Tensor& out_tensor = ort_value.Get<Tensor>();
-          ONNX_NAMESPACE::TensorProto out_tensorproto = utils::TensorToTensorProto(out_tensor, constant_arg_out->Name());
-
-          ONNX_NAMESPACE::TensorShapeProto result_shape;
-          for (auto& dim : out_tensor.Shape().GetDims()) {
-            result_shape.add_dim()->set_dim_value(dim);
-          }
-
-          constant_arg_out->SetShape(result_shape);
-          graph.AddInitializedTensor(out_tensorproto);
+          AddOutputAsInitializer(graph, *node->MutableOutputDefs()[fetch_idx], fetches[fetch_idx]);
         }
       }
     }
@@ -341,6 +577,13 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
     }
   }
 
+  if (!batched_nodes.empty()) {
+    bool folded = false;
+    ORT_RETURN_IF_ERROR(FoldBatchedNodes(graph, batched_nodes, batched_constant_inputs, is_sparse_initializer_check,
+                                         folded, logger));
+    modified = modified || folded;
+  }
+
   return Status::OK();
 }
 }  // namespace onnxruntime
@@ -5,7 +5,9 @@
 
 #include "core/optimizer/graph_transformer.h"
 #include "core/framework/ort_value.h"
+#include <functional>
 #include <memory>
+#include <string>
 #include "core/framework/execution_provider.h"
 
 namespace onnxruntime {
@@ -31,6 +33,13 @@ class ConstantFolding : public GraphTransformer {
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
+  // Evaluate the constant nodes collected in batched mode, given in topological order, in a single execution frame.
+  // The outputs used outside of the evaluated nodes become initializers and the evaluated nodes are removed.
+  Status FoldBatchedNodes(Graph& graph, gsl::span<const NodeIndex> node_indices,
+                          const InitializedTensorSet& constant_inputs,
+                          const std::function<bool(const std::string&)>& is_sparse_initializer_check,
+                          bool& folded, const logging::Logger& logger) const;
+
   bool skip_dequantize_linear_;
   const ConfigOptions& config_options_;
   const InlinedHashSet<std::string> excluded_initializers_;
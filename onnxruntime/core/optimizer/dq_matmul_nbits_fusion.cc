@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/dq_matmul_nbits_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+constexpr int64_t kQuantBits = 4;
+constexpr uint8_t kSymmetricZeroPoint = 8;
+
+template <typename T>
+NodeArg& AddPackedInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                              TensorProto_DataType data_type, const std::vector<T>& values) {
+  TensorProto initializer;
+  initializer.set_name(graph.GenerateNodeArgName(name));
+  initializer.set_data_type(data_type);
+  for (int64_t dim : dims) {
+    initializer.add_dims(dim);
+  }
+  initializer.set_raw_data(values.data(), values.size() * sizeof(T));
+  return graph_utils::AddInitializer(graph, initializer);
+}
+
+// Reads 8-bit quantized values as unsigned 4-bit values, int8 values being offset by 8.
+// Returns false if a value does not fit in 4 bits.
+bool ReadNibbles(const Initializer& values, bool is_signed, std::vector<uint8_t>& nibbles) {
+  nibbles.resize(values.size());
+  for (size_t i = 0; i < nibbles.size(); i++) {
+    const int value = is_signed ? values.data<int8_t>()[i] + 8 : values.data<uint8_t>()[i];
+    if (value < 0 || value > 15) {
+      return false;
+    }
+    nibbles[i] = static_cast<uint8_t>(value);
+  }
+  return true;
+}
+
+}  // namespace
+
+Status DQMatMulNBitsFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                      const logging::Logger& logger) const {
+  // MatMulNBits requires a power of 2 block size of at least 16
+  if (block_size_ < 16 || (block_size_ & (block_size_ - 1)) != 0) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13}) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // MatMulNBits broadcasts the weight over the leading dimensions of A, which must be at least a matrix
+    const NodeArg& input_a = *node.InputDefs()[0];
+    const auto* a_type = input_a.TypeAsProto();
+    if (a_type == nullptr || a_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT ||
+        input_a.Shape() == nullptr || input_a.Shape()->dim_size() < 2) {
+      continue;
+    }
+
+    const Node* dq_node = graph_utils::GetInputNode(node, 1);
+    if (dq_node == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*dq_node, "DequantizeLinear", {10, 13, 19, 21}) ||
+        dq_node->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+        !optimizer_utils::CheckOutputEdges(graph, *dq_node, 1)) {
+      continue;
+    }
+
+    const auto& dq_inputs = dq_node->InputDefs();
+    const TensorProto* weight_proto = graph_utils::GetConstantInitializer(graph, dq_inputs[0]->Name());
+    const TensorProto* scale_proto = graph_utils::GetConstantInitializer(graph, dq_inputs[1]->Name());
+    if (weight_proto == nullptr || weight_proto->dims_size() != 2 ||
+        (weight_proto->data_type() != TensorProto_DataType_UINT8 &&
+         weight_proto->data_type() != TensorProto_DataType_INT8) ||
+        scale_proto == nullptr || scale_proto->data_type() != TensorProto_DataType_FLOAT) {
+      continue;
+    }
+
+    const TensorProto* zero_point_proto = nullptr;
+    if (dq_inputs.size() > 2 && dq_inputs[2]->Exists()) {
+      zero_point_proto = graph_utils::GetConstantInitializer(graph, dq_inputs[2]->Name());
+      if (zero_point_proto == nullptr || zero_point_proto->data_type() != weight_proto->data_type()) {
+        continue;
+      }
+    }
+
+    const int64_t K = weight_proto->dims(0);
+    const int64_t N = weight_proto->dims(1);
+
+    // The scale is per tensor, or per column of the weight. A scale per row of the weight varies within the blocks
+    // along K and cannot be expressed by MatMulNBits.
+    Initializer scale{*scale_proto, graph.ModelPath()};
+    const bool per_column = scale.size() != 1;
+    if (per_column) {
+      const auto* axis_attr = graph_utils::GetNodeAttribute(*dq_node, "axis");
+      const int64_t axis = axis_attr != nullptr ? axis_attr->i() : 1;
+      if ((axis != 1 && axis != -1) || scale_proto->dims_size() != 1 || scale_proto->dims(0) != N) {
+        continue;
+      }
+    }
+
+    const bool is_signed = weight_proto->data_type() == TensorProto_DataType_INT8;
+    std::vector<uint8_t> weight_nibbles;
+    if (!ReadNibbles(Initializer{*weight_proto, graph.ModelPath()}, is_signed, weight_nibbles)) {
+      continue;
+    }
+
+    std::vector<uint8_t> zero_point_nibbles(scale.size(), is_signed ? kSymmetricZeroPoint : 0);
+    if (zero_point_proto != nullptr) {
+      Initializer zero_point{*zero_point_proto, graph.ModelPath()};
+      if (zero_point.size() != scale.size() || !ReadNibbles(zero_point, is_signed, zero_point_nibbles)) {
+        continue;
+      }
+    }
+
+    // B is laid out as [N, blocks along K, bytes per block], the K padding of the last block holds the zero point
+    // so that it dequantizes to 0. The scales are [N * blocks] and the packed zero points [N, (blocks + 1) / 2].
+    const int64_t k_blocks = (K + block_size_ - 1) / block_size_;
+    const int64_t block_bytes = block_size_ * kQuantBits / 8;
+    const int64_t zero_point_bytes = (k_blocks + 1) / 2;
+    std::vector<uint8_t> data(narrow<size_t>(N * k_blocks * block_bytes));
+    std::vector<float> scales(narrow<size_t>(N * k_blocks));
+    std::vector<uint8_t> zero_points(narrow<size_t>(N * zero_point_bytes));
+    bool symmetric = true;
+    for (int64_t n = 0; n < N; n++) {
+      const size_t quant_param = per_column ? narrow<size_t>(n) : 0;
+      const uint8_t zp = zero_point_nibbles[quant_param];
+      symmetric = symmetric && zp == kSymmetricZeroPoint;
+
+      uint8_t* column = data.data() + n * k_blocks * block_bytes;
+      for (int64_t k = 0; k < k_blocks * block_size_; k++) {
+        const uint8_t value = k < K ? weight_nibbles[narrow<size_t>(k * N + n)] : zp;
+        column[k / 2] |= (k & 1) ? static_cast<uint8_t>(value << 4) : value;
+      }
+      for (int64_t b = 0; b < k_blocks; b++) {
+        scales[narrow<size_t>(n * k_blocks + b)] = scale.data<float>()[quant_param];
+        zero_points[narrow<size_t>(n * zero_point_bytes + b / 2)] |= (b & 1) ? static_cast<uint8_t>(zp << 4) : zp;
+      }
+    }
+
+    const std::string& weight_name = dq_inputs[0]->Name();
+    InlinedVector<NodeArg*> matmul_nbits_inputs{
+        node.MutableInputDefs()[0],
+        &AddPackedInitializer(graph, weight_name + "_Q4", {N, k_blocks, block_bytes}, TensorProto_DataType_UINT8,
+                              data),
+        &AddPackedInitializer(graph, weight_name + "_scales", {N * k_blocks}, TensorProto_DataType_FLOAT, scales)};
+    // MatMulNBits defaults to the symmetric zero point 8, the zero points are only needed when they differ
+    if (!symmetric) {
+      matmul_nbits_inputs.push_back(&AddPackedInitializer(graph, weight_name + "_zero_points",
+                                                          {N * zero_point_bytes}, TensorProto_DataType_UINT8,
+                                                          zero_points));
+    }
+
+    Node& matmul_nbits_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_Q4"),
+                                            "MatMulNBits",
+                                            "fused DequantizeLinear and MatMul",
+                                            matmul_nbits_inputs,
+                                            {node.MutableOutputDefs()[0]},
+                                            nullptr,
+                                            kMSDomain);
+    matmul_nbits_node.AddAttribute("K", K);
+    matmul_nbits_node.AddAttribute("N", N);
+    matmul_nbits_node.AddAttribute("bits", kQuantBits);
+    matmul_nbits_node.AddAttribute("block_size", block_size_);
+    matmul_nbits_node.AddAttribute("accuracy_level", accuracy_level_);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    matmul_nbits_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    const NodeIndex dq_index = dq_node->Index();
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.Index());
+    graph.RemoveNode(dq_index);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
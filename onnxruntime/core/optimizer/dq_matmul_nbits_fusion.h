@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class DQMatMulNBitsFusion
+
+Fuse the weight-only QDQ pattern DequantizeLinear(W, scale, zero_point) -> MatMul(A, .) into com.microsoft.MatMulNBits,
+so that 4-bit QDQ models run on the MatMulNBits kernels instead of dequantizing the whole weight to fp32 first.
+
+W is a constant [K, N] uint8 or int8 initializer holding 4-bit values (0..15 or -8..7), quantized per tensor or per
+column (axis 1). The fusion is exact: the values are repacked to the MatMulNBits layout, with the per-column scale
+and zero point repeated for every block along K.
+*/
+class DQMatMulNBitsFusion : public GraphTransformer {
+ public:
+  DQMatMulNBitsFusion(int64_t block_size, int64_t accuracy_level,
+                      const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DQMatMulNBitsFusion", compatible_execution_providers),
+        block_size_(block_size),
+        accuracy_level_(accuracy_level) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+ private:
+  const int64_t block_size_;
+  const int64_t accuracy_level_;
+};
+
+}  // namespace onnxruntime
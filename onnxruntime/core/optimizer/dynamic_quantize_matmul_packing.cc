@@ -0,0 +1,266 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/dynamic_quantize_matmul_packing.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// A DynamicQuantizeMatMul node with constant B, b_scale and optional b_zero_point and bias.
+struct PackableNode {
+  Node* node;
+  const TensorProto* b;
+  const TensorProto* b_scale;
+  const TensorProto* b_zero_point;
+  const TensorProto* bias;
+};
+
+int64_t NumElements(const TensorProto& tensor) {
+  int64_t size = 1;
+  for (int64_t dim : tensor.dims()) {
+    size *= dim;
+  }
+  return size;
+}
+
+std::string GetActivationKey(const Node& node) {
+  std::string key;
+  const auto& attributes = node.GetAttributes();
+  if (auto it = attributes.find("activation"); it != attributes.end()) {
+    key = it->second.s();
+  }
+  if (auto it = attributes.find("activation_params"); it != attributes.end()) {
+    for (float param : it->second.floats()) {
+      key += ',';
+      key += std::to_string(param);
+    }
+  }
+  return key;
+}
+
+bool GetPackableNode(const Graph& graph, Node& node, PackableNode& packable) {
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() > 5 && input_defs[5]->Exists()) {
+    return false;  // the residual is not packed
+  }
+
+  packable = {&node, graph_utils::GetConstantInitializer(graph, input_defs[1]->Name()),
+              graph_utils::GetConstantInitializer(graph, input_defs[2]->Name()), nullptr, nullptr};
+  if (packable.b == nullptr || packable.b->dims_size() != 2 ||
+      packable.b_scale == nullptr || packable.b_scale->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  // per-tensor or per-column quantization parameters
+  const int64_t N = packable.b->dims(1);
+  auto is_supported_param = [N](const TensorProto& param) {
+    return param.dims_size() <= 1 && (NumElements(param) == 1 || NumElements(param) == N);
+  };
+  if (!is_supported_param(*packable.b_scale)) {
+    return false;
+  }
+
+  if (input_defs.size() > 3 && input_defs[3]->Exists()) {
+    packable.b_zero_point = graph_utils::GetConstantInitializer(graph, input_defs[3]->Name());
+    if (packable.b_zero_point == nullptr || !is_supported_param(*packable.b_zero_point)) {
+      return false;
+    }
+  }
+
+  if (input_defs.size() > 4 && input_defs[4]->Exists()) {
+    packable.bias = graph_utils::GetConstantInitializer(graph, input_defs[4]->Name());
+    if (packable.bias == nullptr || packable.bias->dims_size() != 1 || packable.bias->dims(0) != N) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template <typename T>
+NodeArg& AddPackedInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                              int32_t data_type, const std::vector<T>& values) {
+  TensorProto initializer;
+  initializer.set_name(graph.GenerateNodeArgName(name));
+  initializer.set_data_type(data_type);
+  for (int64_t dim : dims) {
+    initializer.add_dims(dim);
+  }
+  initializer.set_raw_data(values.data(), values.size() * sizeof(T));
+  return graph_utils::AddInitializer(graph, initializer);
+}
+
+}  // namespace
+
+Status DynamicQuantizeMatMulPacking::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                               const logging::Logger& logger) const {
+  // Split takes the sizes of the outputs as an input from opset 13
+  int onnx_opset_version = -1;
+  if (graph.DomainToVersionMap().find(kOnnxDomain) != graph.DomainToVersionMap().end()) {
+    onnx_opset_version = graph.DomainToVersionMap().at(kOnnxDomain);
+  }
+  if (onnx_opset_version < 13) return Status::OK();
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "DynamicQuantizeMatMul", {1}, kMSDomain) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // the nodes sharing A with the same type and rows of B and the same activation
+    const NodeArg* input_a = node.InputDefs()[0];
+    const std::string activation_key = GetActivationKey(node);
+    InlinedVector<PackableNode> packable_nodes;
+    for (Node* consumer : graph.GetMutableConsumerNodes(input_a->Name())) {
+      PackableNode packable;
+      if (consumer == nullptr ||
+          !graph_utils::IsSupportedOptypeVersionAndDomain(*consumer, "DynamicQuantizeMatMul", {1}, kMSDomain) ||
+          consumer->InputDefs()[0] != input_a ||
+          consumer->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+          GetActivationKey(*consumer) != activation_key ||
+          !GetPackableNode(graph, *consumer, packable)) {
+        continue;
+      }
+      if (!packable_nodes.empty() && (packable.b->data_type() != packable_nodes[0].b->data_type() ||
+                                      packable.b->dims(0) != packable_nodes[0].b->dims(0))) {
+        continue;
+      }
+      packable_nodes.push_back(packable);
+    }
+    if (packable_nodes.size() < 2) {
+      continue;
+    }
+
+    const int32_t b_data_type = packable_nodes[0].b->data_type();
+    const int64_t K = packable_nodes[0].b->dims(0);
+    const bool has_zero_point = std::any_of(packable_nodes.begin(), packable_nodes.end(),
+                                            [](const PackableNode& p) { return p.b_zero_point != nullptr; });
+    const bool has_bias = std::any_of(packable_nodes.begin(), packable_nodes.end(),
+                                      [](const PackableNode& p) { return p.bias != nullptr; });
+    int64_t total_N = 0;
+    std::vector<int64_t> split_values;
+    for (const PackableNode& packable : packable_nodes) {
+      split_values.push_back(packable.b->dims(1));
+      total_N += packable.b->dims(1);
+    }
+
+    // concatenate B along its columns, with the quantization parameters and the biases expanded per column
+    std::vector<uint8_t> packed_b(static_cast<size_t>(K * total_N));
+    std::vector<float> packed_scale;
+    std::vector<uint8_t> packed_zero_point;
+    std::vector<float> packed_bias;
+    int64_t column = 0;
+    for (const PackableNode& packable : packable_nodes) {
+      const int64_t N = packable.b->dims(1);
+      Initializer b{*packable.b, graph.ModelPath()};
+      const uint8_t* b_data = b.DataAsByteSpan().data();
+      for (int64_t k = 0; k < K; ++k) {
+        std::copy_n(b_data + k * N, N, packed_b.data() + k * total_N + column);
+      }
+
+      Initializer scale{*packable.b_scale, graph.ModelPath()};
+      const auto scale_data = scale.DataAsSpan<float>();
+      for (int64_t n = 0; n < N; ++n) {
+        packed_scale.push_back(scale_data[scale_data.size() == 1 ? 0 : n]);
+      }
+
+      if (has_zero_point) {
+        if (packable.b_zero_point != nullptr) {
+          Initializer zero_point{*packable.b_zero_point, graph.ModelPath()};
+          const auto zero_point_data = zero_point.DataAsByteSpan();
+          for (int64_t n = 0; n < N; ++n) {
+            packed_zero_point.push_back(zero_point_data[zero_point_data.size() == 1 ? 0 : n]);
+          }
+        } else {
+          packed_zero_point.insert(packed_zero_point.end(), static_cast<size_t>(N), uint8_t{0});
+        }
+      }
+
+      if (has_bias) {
+        if (packable.bias != nullptr) {
+          Initializer bias{*packable.bias, graph.ModelPath()};
+          const auto bias_data = bias.DataAsSpan<float>();
+          packed_bias.insert(packed_bias.end(), bias_data.begin(), bias_data.end());
+        } else {
+          packed_bias.insert(packed_bias.end(), static_cast<size_t>(N), 0.f);
+        }
+      }
+
+      column += N;
+    }
+
+    Node& first_node = *packable_nodes[0].node;
+    NodeArg optional_node_arg("", nullptr);
+    InlinedVector<NodeArg*> input_defs{
+        first_node.MutableInputDefs()[0],
+        &AddPackedInitializer(graph, first_node.Name() + "_packed_B", {K, total_N}, b_data_type, packed_b),
+        &AddPackedInitializer(graph, first_node.Name() + "_packed_b_scale", {total_N}, TensorProto_DataType_FLOAT,
+                              packed_scale)};
+    if (has_zero_point || has_bias) {
+      input_defs.push_back(has_zero_point
+                               ? &AddPackedInitializer(graph, first_node.Name() + "_packed_b_zero_point", {total_N},
+                                                       b_data_type, packed_zero_point)
+                               : &optional_node_arg);
+    }
+    if (has_bias) {
+      input_defs.push_back(&AddPackedInitializer(graph, first_node.Name() + "_packed_bias", {total_N},
+                                                 TensorProto_DataType_FLOAT, packed_bias));
+    }
+
+    NodeArg& packed_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(first_node.Name() + "_packed"),
+                                                      first_node.OutputDefs()[0]->TypeAsProto());
+    Node& packed_node = graph.AddNode(graph.GenerateNodeName(first_node.Name() + "_packed"),
+                                      "DynamicQuantizeMatMul",
+                                      "DynamicQuantizeMatMul nodes sharing their input",
+                                      input_defs,
+                                      {&packed_output},
+                                      &first_node.GetAttributes(),
+                                      kMSDomain);
+
+    TensorProto split_initializer_proto;
+    split_initializer_proto.set_name(graph.GenerateNodeArgName("splits"));
+    split_initializer_proto.set_data_type(TensorProto_DataType_INT64);
+    split_initializer_proto.add_dims(static_cast<int64_t>(split_values.size()));
+    split_initializer_proto.mutable_int64_data()->Add(split_values.begin(), split_values.end());
+    NodeArg* split_initializer_arg = &graph_utils::AddInitializer(graph, split_initializer_proto);
+
+    InlinedVector<NodeArg*> split_outputs;
+    for (const PackableNode& packable : packable_nodes) {
+      split_outputs.push_back(packable.node->MutableOutputDefs()[0]);
+    }
+    Node& split_node = graph.AddNode(graph.GenerateNodeName(first_node.Name() + "_split"), "Split",
+                                     "Split for packed DynamicQuantizeMatMul nodes",
+                                     {&packed_output, split_initializer_arg}, split_outputs);
+    split_node.AddAttribute("axis", static_cast<int64_t>(-1));
+
+    // Assign provider to the new nodes. Provider should be same as the provider for old nodes.
+    packed_node.SetExecutionProviderType(first_node.GetExecutionProviderType());
+    split_node.SetExecutionProviderType(first_node.GetExecutionProviderType());
+
+    for (const PackableNode& packable : packable_nodes) {
+      graph_utils::RemoveNodeOutputEdges(graph, *packable.node);
+      graph.RemoveNode(packable.node->Index());
+    }
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
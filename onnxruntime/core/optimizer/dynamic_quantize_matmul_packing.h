@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class DynamicQuantizeMatMulPacking
+
+Pack the DynamicQuantizeMatMul nodes that share their input A, e.g. the Q, K and V projections of an attention block,
+into a single DynamicQuantizeMatMul followed by a Split:
+
+           A                                   A
+     /     |     \                             |
+  DQMM   DQMM   DQMM          ---->    DQMM(B = [B0 B1 B2])
+   |       |      |                            |
+   Q       K      V                          Split
+                                            /  |  \
+                                           Q   K   V
+
+A is quantized once instead of once per node, and the GEMMs run as one larger GEMM. The weights, scales, zero points
+and biases must be constant initializers; they are concatenated along the columns of B, with per-tensor scales and
+zero points expanded to per-column ones. Nodes with a residual input or a different activation are not packed.
+*/
+class DynamicQuantizeMatMulPacking : public GraphTransformer {
+ public:
+  DynamicQuantizeMatMulPacking(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DynamicQuantizeMatMulPacking", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,147 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/dynamic_quantize_skip_layer_norm_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// The mean and inv_std_var outputs of the layer norm are not produced by the fused node.
+bool IsOutputUnused(const Graph& graph, const Node& node, int index) {
+  const auto& output_defs = node.OutputDefs();
+  if (static_cast<size_t>(index) >= output_defs.size() || !output_defs[index]->Exists()) {
+    return true;
+  }
+  return !graph_utils::IsOutputUsed(node, index) && !graph.IsOutput(output_defs[index]);
+}
+
+}  // namespace
+
+/**
+DynamicQuantizeSkipLayerNormFusion will fuse subgraph like below into DynamicQuantizeSkipLayerNormalization:
+
+   input  skip  gamma [beta] [bias]                         input  skip  gamma [beta] [bias]
+     |     |      |     |      |                              |     |      |     |      |
+     v     v      v     v      v                              v     v      v     v      v
+      SkipLayerNormalization ----> [input_skip_bias_sum]       DynamicQuantizeSkipLayerNormalization
+             |                                         ---->     |       |        |          |
+             v                                                   Y    Y_scale  Y_zero_point [input_skip_bias_sum]
+      DynamicQuantizeLinear
+       |       |        |
+       Y    Y_scale  Y_zero_point
+
+The float output of the layer norm must only be consumed by the DynamicQuantizeLinear. When several MatMulInteger
+share the quantized activations, DynamicQuantizeMatMulFusion leaves the DynamicQuantizeLinear in place and this
+fusion removes the float activations pass instead.
+ */
+Status DynamicQuantizeSkipLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedVector<std::reference_wrapper<Node>> nodes_to_remove;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& skip_layer_norm = *node_ptr;
+
+    ORT_RETURN_IF_ERROR(Recurse(skip_layer_norm, modified, graph_level, logger));
+
+    const bool simplified =
+        graph_utils::IsSupportedOptypeVersionAndDomain(skip_layer_norm, "SkipSimplifiedLayerNormalization", {1},
+                                                       kMSDomain);
+    if ((!simplified &&
+         !graph_utils::IsSupportedOptypeVersionAndDomain(skip_layer_norm, "SkipLayerNormalization", {1},
+                                                         kMSDomain)) ||
+        !graph_utils::IsSupportedProvider(skip_layer_norm, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const auto* input_type = skip_layer_norm.InputDefs()[0]->Type();
+    if (input_type == nullptr || *input_type != "tensor(float)" ||
+        graph.IsOutput(skip_layer_norm.OutputDefs()[0]) ||
+        !IsOutputUnused(graph, skip_layer_norm, 1) ||
+        !IsOutputUnused(graph, skip_layer_norm, 2)) {
+      continue;
+    }
+
+    // the normalized output must have a single consumer, a DynamicQuantizeLinear on the same provider
+    const Node* p_dynamic_quant_linear = nullptr;
+    size_t output_consumers = 0;
+    for (auto it = skip_layer_norm.OutputEdgesBegin(), end = skip_layer_norm.OutputEdgesEnd(); it != end; ++it) {
+      if (it->GetSrcArgIndex() == 0) {
+        p_dynamic_quant_linear = &it->GetNode();
+        ++output_consumers;
+      }
+    }
+    if (output_consumers != 1 ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*p_dynamic_quant_linear, "DynamicQuantizeLinear", {11}) ||
+        p_dynamic_quant_linear->GetExecutionProviderType() != skip_layer_norm.GetExecutionProviderType()) {
+      continue;
+    }
+
+    Node& dynamic_quant_linear = *graph.GetNode(p_dynamic_quant_linear->Index());
+
+    NodeArg optional_node_arg("", nullptr);
+    auto& sln_input_args = skip_layer_norm.MutableInputDefs();
+    InlinedVector<NodeArg*> input_defs{
+        sln_input_args[0],  // input
+        sln_input_args[1],  // skip
+        sln_input_args[2],  // gamma
+        &optional_node_arg,
+        &optional_node_arg};
+    if (simplified) {
+      // SkipSimplifiedLayerNormalization has no beta, its optional bias is the fourth input
+      if (sln_input_args.size() > 3) {
+        input_defs[4] = sln_input_args[3];
+      }
+    } else {
+      for (size_t i = 3; i < sln_input_args.size() && i < input_defs.size(); ++i) {
+        input_defs[i] = sln_input_args[i];
+      }
+    }
+
+    auto& dql_output_args = dynamic_quant_linear.MutableOutputDefs();
+    InlinedVector<NodeArg*> output_defs{dql_output_args[0], dql_output_args[1], dql_output_args[2]};
+    auto& sln_output_args = skip_layer_norm.MutableOutputDefs();
+    if (sln_output_args.size() > 3 && sln_output_args[3]->Exists()) {
+      output_defs.push_back(sln_output_args[3]);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(skip_layer_norm.Name() + "_DynamicQuantize"),
+                                     "DynamicQuantizeSkipLayerNormalization",
+                                     "",
+                                     input_defs,
+                                     output_defs,
+                                     nullptr,
+                                     kMSDomain);
+    if (const auto* epsilon = graph_utils::GetNodeAttribute(skip_layer_norm, "epsilon")) {
+      fused_node.AddAttributeProto(*epsilon);
+    }
+    fused_node.AddAttribute("simplified", static_cast<int64_t>(simplified ? 1 : 0));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(skip_layer_norm.GetExecutionProviderType());
+
+    nodes_to_remove.push_back(skip_layer_norm);
+    nodes_to_remove.push_back(dynamic_quant_linear);
+  }
+
+  modified = modified || !nodes_to_remove.empty();
+
+  for (const auto& node : nodes_to_remove) {
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.get().Index());
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class DynamicQuantizeSkipLayerNormFusion
+Fuse SkipLayerNormalization or SkipSimplifiedLayerNormalization and the DynamicQuantizeLinear that is the only
+consumer of its output into DynamicQuantizeSkipLayerNormalization, which quantizes the normalized rows without
+writing them to memory as float.
+*/
+class DynamicQuantizeSkipLayerNormFusion : public GraphTransformer {
+ public:
+  DynamicQuantizeSkipLayerNormFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("DynamicQuantizeSkipLayerNormFusion", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
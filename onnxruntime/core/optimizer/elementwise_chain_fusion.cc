@@ -0,0 +1,311 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_chain_fusion.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Returns the number of inputs of an elementwise node that FusedElementwise can evaluate, or 0 if the node
+// cannot be part of a chain.
+size_t ChainOpArity(const Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14})) {
+    return 2;
+  }
+  // Max and Min are variadic, only their binary form is fused
+  if ((graph_utils::IsSupportedOptypeVersionAndDomain(node, "Max", {8, 12, 13}) ||
+       graph_utils::IsSupportedOptypeVersionAndDomain(node, "Min", {8, 12, 13})) &&
+      node.InputDefs().size() == 2) {
+    return 2;
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13})) {
+    return 1;
+  }
+  return 0;
+}
+
+// The CUDA kernel passes the program to the device by value, which bounds its size.
+constexpr size_t kMaxCudaChainInputs = 8;
+constexpr size_t kMaxCudaChainLength = 16;
+
+bool IsTensorOfType(const NodeArg& arg, int32_t elem_type) {
+  const auto* type = arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() && type->tensor_type().elem_type() == elem_type;
+}
+
+// float chains are fused on every provider, float16 chains only on CUDA, where the kernel computes in float.
+bool IsSupportedChainType(const Node& node, int32_t elem_type) {
+  return elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+         (elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16 &&
+          node.GetExecutionProviderType() == kCudaExecutionProvider);
+}
+
+// Unlike optimizer_utils::CompareShape, symbolic dimensions with the same name are equal.
+bool SameDims(const TensorShapeProto& shape, const TensorShapeProto& other) {
+  if (shape.dim_size() != other.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < shape.dim_size(); ++i) {
+    const auto& dim = shape.dim(i);
+    const auto& other_dim = other.dim(i);
+    if (utils::HasDimValue(dim) && utils::HasDimValue(other_dim)) {
+      if (dim.dim_value() != other_dim.dim_value()) {
+        return false;
+      }
+    } else if (!utils::HasDimParam(dim) || !utils::HasDimParam(other_dim) ||
+               dim.dim_param() != other_dim.dim_param()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// An operand is read by FusedElementwise if it has the chain's shape, is a single element, or has the trailing
+// dimensions of the chain's shape once its leading 1s are dropped.
+bool IsCompatibleOperand(const NodeArg& arg, const TensorShapeProto& chain_shape, int32_t elem_type) {
+  const auto* shape = arg.Shape();
+  if (!IsTensorOfType(arg, elem_type) || shape == nullptr) {
+    return false;
+  }
+  if (SameDims(*shape, chain_shape)) {
+    return true;
+  }
+
+  int first = 0;
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    if (!utils::HasDimValue(shape->dim(i))) {
+      return false;
+    }
+    if (first == i && shape->dim(i).dim_value() == 1) {
+      ++first;
+    }
+  }
+
+  const int rank = shape->dim_size() - first;
+  if (rank == 0) {
+    return true;  // scalar
+  }
+  if (rank > chain_shape.dim_size()) {
+    return false;
+  }
+  const int offset = chain_shape.dim_size() - rank;
+  for (int i = 0; i < rank; ++i) {
+    const auto& chain_dim = chain_shape.dim(offset + i);
+    if (!utils::HasDimValue(chain_dim) || chain_dim.dim_value() != shape->dim(first + i).dim_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The output of a chain node keeps the chain's shape, so broadcasting never grows the intermediate values.
+bool HasChainOutput(const Node& node, const TensorShapeProto& chain_shape, int32_t elem_type) {
+  const NodeArg& output = *node.OutputDefs()[0];
+  return IsTensorOfType(output, elem_type) && output.Shape() != nullptr && SameDims(*output.Shape(), chain_shape);
+}
+
+bool IsInChain(const InlinedVector<Node*>& chain, const Node& node) {
+  return std::find(chain.begin(), chain.end(), &node) != chain.end();
+}
+
+// Only the output of the last node may be consumed outside of the chain.
+bool HasInternalIntermediates(const Graph& graph, const InlinedVector<Node*>& chain) {
+  for (size_t k = 0; k + 1 < chain.size(); ++k) {
+    const Node& node = *chain[k];
+    if (graph.NodeProducesGraphOutput(node)) {
+      return false;
+    }
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      if (!IsInChain(chain, it->GetNode())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+/*
+This transform fuses chains of elementwise nodes such as
+
+       X    B
+       |   /
+       Add     C
+        |     /
+     Sigmoid /
+        |   /
+        Mul
+
+into a single FusedElementwise node with inputs (X, B, C) and the program
+ops = [Add, Sigmoid, Mul], operands = [0, 1, 3, -1, 4, 2].
+
+The chain starts at a node with an input of the same shape as its output and follows a consumer at a time. Every
+node of the chain may read the previous values of the chain and operands from outside of it.
+*/
+Status ElementwiseChainFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedHashSet<NodeIndex> fused_nodes;
+  InlinedVector<NodeIndex> nodes_to_remove;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& head = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(head, modified, graph_level, logger));
+
+    if (fused_nodes.count(node_index) != 0 || ChainOpArity(head) == 0 ||
+        !graph_utils::IsSupportedProvider(head, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const NodeArg& head_output = *head.OutputDefs()[0];
+    const auto* head_type = head_output.TypeAsProto();
+    if (head_type == nullptr || !head_type->has_tensor_type() || head_output.Shape() == nullptr) {
+      continue;
+    }
+    const int32_t elem_type = head_type->tensor_type().elem_type();
+    if (!IsSupportedChainType(head, elem_type)) {
+      continue;
+    }
+    const TensorShapeProto& chain_shape = *head_output.Shape();
+    const bool on_cuda = head.GetExecutionProviderType() == kCudaExecutionProvider;
+
+    // the first input of the fused node gives the shape of its output
+    NodeArg* main_input = nullptr;
+    bool compatible = true;
+    for (NodeArg* input : head.MutableInputDefs()) {
+      compatible = compatible && IsCompatibleOperand(*input, chain_shape, elem_type);
+      if (main_input == nullptr && compatible && SameDims(*input->Shape(), chain_shape)) {
+        main_input = input;
+      }
+    }
+    if (!compatible || main_input == nullptr) {
+      continue;
+    }
+
+    InlinedVector<Node*> chain{&head};
+    InlinedHashMap<const NodeArg*, int64_t> chain_values{{&head_output, 0}};
+    while (!on_cuda || chain.size() < kMaxCudaChainLength) {
+      Node* next = nullptr;
+      const Node& last = *chain.back();
+      for (auto it = last.OutputEdgesBegin(), end = last.OutputEdgesEnd(); it != end && next == nullptr; ++it) {
+        Node& consumer = *graph.GetNode(it->GetNode().Index());
+        if (IsInChain(chain, consumer) || fused_nodes.count(consumer.Index()) != 0 ||
+            ChainOpArity(consumer) == 0 ||
+            consumer.GetExecutionProviderType() != head.GetExecutionProviderType() ||
+            !HasChainOutput(consumer, chain_shape, elem_type)) {
+          continue;
+        }
+
+        bool consumer_compatible = true;
+        for (const NodeArg* input : consumer.InputDefs()) {
+          consumer_compatible = consumer_compatible &&
+                                (chain_values.count(input) != 0 || IsCompatibleOperand(*input, chain_shape, elem_type));
+        }
+        if (consumer_compatible) {
+          next = &consumer;
+        }
+      }
+
+      if (next == nullptr) {
+        break;
+      }
+      chain_values.emplace(next->OutputDefs()[0], static_cast<int64_t>(chain.size()));
+      chain.push_back(next);
+    }
+
+    while (chain.size() >= 2 && !HasInternalIntermediates(graph, chain)) {
+      chain_values.erase(chain.back()->OutputDefs()[0]);
+      chain.pop_back();
+    }
+    if (chain.size() < 2) {
+      continue;
+    }
+
+    // the inputs of the fused node are the operands coming from outside of the chain
+    InlinedVector<NodeArg*> input_defs{main_input};
+    for (Node* node : chain) {
+      for (NodeArg* input : node->MutableInputDefs()) {
+        if (chain_values.count(input) == 0 &&
+            std::find(input_defs.begin(), input_defs.end(), input) == input_defs.end()) {
+          input_defs.push_back(input);
+        }
+      }
+    }
+    if (on_cuda && input_defs.size() > kMaxCudaChainInputs) {
+      continue;
+    }
+
+    const int64_t num_inputs = static_cast<int64_t>(input_defs.size());
+    std::vector<std::string> ops;
+    std::vector<int64_t> operands;
+    for (Node* node : chain) {
+      ops.push_back(node->OpType());
+      const auto& inputs = node->InputDefs();
+      for (size_t j = 0; j < 2; ++j) {
+        if (j >= inputs.size()) {
+          operands.push_back(-1);
+          continue;
+        }
+        auto value = chain_values.find(inputs[j]);
+        if (value != chain_values.end()) {
+          operands.push_back(num_inputs + value->second);
+        } else {
+          operands.push_back(std::find(input_defs.begin(), input_defs.end(), inputs[j]) - input_defs.begin());
+        }
+      }
+    }
+
+    Node& last = *chain.back();
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("FusedElementwise"),
+                                     "FusedElementwise",
+                                     "fused elementwise chain ending at " + last.Name(),
+                                     input_defs,
+                                     {last.MutableOutputDefs()[0]},
+                                     nullptr,
+                                     kMSDomain);
+    fused_node.AddAttribute("ops", ops);
+    fused_node.AddAttribute("operands", operands);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(head.GetExecutionProviderType());
+
+    for (Node* node : chain) {
+      fused_nodes.insert(node->Index());
+      nodes_to_remove.push_back(node->Index());
+    }
+  }
+
+  modified = modified || !nodes_to_remove.empty();
+
+  for (NodeIndex index : nodes_to_remove) {
+    Node& node = *graph.GetNode(index);
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(index);
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
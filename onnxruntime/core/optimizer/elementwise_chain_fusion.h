@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ElementwiseChainFusion
+
+Fuse chains of float elementwise operators (Add, Sub, Mul, Div, Max, Min, Relu, Sigmoid, Tanh, Exp, Neg, Abs, Sqrt,
+Erf) into a single com.microsoft.FusedElementwise node, which evaluates the whole chain tile by tile so the
+intermediate tensors are never written to memory. The other operands of the chain must be scalars or broadcast
+along the leading dimensions of the chain's shape. On CUDA, float16 chains are fused too, and the whole chain runs
+as a single kernel launch, which matters for small-batch decoding where the glue between the fused layers is bound by
+the launch overhead.
+
+It runs after the layout transformers and the Conv fusions so that it does not take their Add and activation nodes.
+*/
+class ElementwiseChainFusion : public GraphTransformer {
+ public:
+  ElementwiseChainFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseChainFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_bag_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Returns the axes of a ReduceSum/ReduceMean node, given as an attribute or as a constant input depending on
+// the opset.
+bool GetReduceAxes(const Graph& graph, const Node& reduce_node, InlinedVector<int64_t>& axes) {
+  const auto& attributes = reduce_node.GetAttributes();
+  auto axes_attr = attributes.find("axes");
+  if (axes_attr != attributes.end()) {
+    axes.assign(axes_attr->second.ints().begin(), axes_attr->second.ints().end());
+    return true;
+  }
+  const auto& input_defs = reduce_node.InputDefs();
+  if (input_defs.size() < 2 || !input_defs[1]->Exists()) {
+    return false;
+  }
+  return optimizer_utils::AppendTensorFromInitializer(graph, *input_defs[1], axes, true);
+}
+
+}  // namespace
+
+/*
+This transform fuses the following subgraph pattern:
+
+  weight (float)   indices (*, bag_size)
+          \           /
+        Gather (axis=0)
+              |
+   ReduceSum/ReduceMean (axes=[rank(indices) - 1], keepdims=0)
+
+into
+
+  EmbeddingBag (mode='sum' or 'mean')
+*/
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& gather_node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(gather_node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(gather_node, "Gather", {1, 11, 13}) ||
+        !graph_utils::IsSupportedProvider(gather_node, GetCompatibleExecutionProviders()) ||
+        gather_node.GetOutputEdgesCount() != 1 ||
+        graph.NodeProducesGraphOutput(gather_node)) {
+      continue;
+    }
+
+    const NodeArg& weight = *gather_node.InputDefs()[0];
+    const NodeArg& indices = *gather_node.InputDefs()[1];
+    const auto* weight_type = weight.TypeAsProto();
+    if (weight_type == nullptr ||
+        weight_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+        weight.Shape() == nullptr || indices.Shape() == nullptr) {
+      continue;
+    }
+
+    const int64_t weight_rank = weight.Shape()->dim_size();
+    const int64_t indices_rank = indices.Shape()->dim_size();
+    if (weight_rank < 1 || indices_rank < 1) {
+      continue;
+    }
+
+    const auto& gather_attributes = gather_node.GetAttributes();
+    auto axis_attr = gather_attributes.find("axis");
+    if (axis_attr != gather_attributes.end() &&
+        axis_attr->second.i() != 0 && axis_attr->second.i() != -weight_rank) {
+      continue;
+    }
+
+    Node& reduce_node = *graph.GetNode(gather_node.OutputNodesBegin()->Index());
+    const bool is_sum = graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceSum", {1, 11, 13});
+    const bool is_mean = graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceMean", {1, 11, 13, 18});
+    if ((!is_sum && !is_mean) ||
+        reduce_node.GetExecutionProviderType() != gather_node.GetExecutionProviderType() ||
+        reduce_node.InputDefs()[0] != gather_node.OutputDefs()[0]) {
+      continue;
+    }
+
+    // keepdims defaults to 1, the fused node drops the reduced axis.
+    const auto& reduce_attributes = reduce_node.GetAttributes();
+    auto keepdims_attr = reduce_attributes.find("keepdims");
+    if (keepdims_attr == reduce_attributes.end() || keepdims_attr->second.i() != 0) {
+      continue;
+    }
+
+    // the bag axis is the last axis of the indices in the gathered tensor
+    InlinedVector<int64_t> axes;
+    if (!GetReduceAxes(graph, reduce_node, axes) || axes.size() != 1) {
+      continue;
+    }
+    const int64_t gathered_rank = indices_rank + weight_rank - 1;
+    const int64_t axis = axes[0] < 0 ? axes[0] + gathered_rank : axes[0];
+    if (axis != indices_rank - 1) {
+      continue;
+    }
+
+    Node& embedding_bag_node = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                                             "EmbeddingBag",
+                                             "fused Gather and " + reduce_node.OpType(),
+                                             {gather_node.MutableInputDefs()[0], gather_node.MutableInputDefs()[1]},
+                                             {},
+                                             {},
+                                             kMSDomain);
+    embedding_bag_node.AddAttribute("mode", std::string(is_sum ? "sum" : "mean"));
+    embedding_bag_node.SetExecutionProviderType(gather_node.GetExecutionProviderType());
+
+    graph_utils::FinalizeNodeFusion(graph, {gather_node, reduce_node}, embedding_bag_node);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
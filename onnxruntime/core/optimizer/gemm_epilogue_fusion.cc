@@ -0,0 +1,283 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/gemm_epilogue_fusion.h"
+
+#include <optional>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/node_attr_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+struct EpilogueInputIndices {
+  int bias;
+  int residual;
+};
+
+// Returns the indices of the 'bias' and 'residual' inputs of the ops whose CPU kernels support an epilogue.
+std::optional<EpilogueInputIndices> GetEpilogueInputIndices(const Node& node) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMulNBits", {1}, kMSDomain)) {
+    return EpilogueInputIndices{5, 6};
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "DynamicQuantizeMatMul", {1}, kMSDomain)) {
+    return EpilogueInputIndices{4, 5};
+  }
+  return std::nullopt;
+}
+
+bool HasInput(const Node& node, int input_index) {
+  const auto& input_defs = node.InputDefs();
+  return static_cast<size_t>(input_index) < input_defs.size() && input_defs[input_index]->Exists();
+}
+
+bool IsFloatTensor(const NodeArg& node_arg) {
+  const auto* type_proto = node_arg.TypeAsProto();
+  return type_proto != nullptr && type_proto->has_tensor_type() &&
+         type_proto->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+// Both shapes must be known and equal. Symbolic dimensions are equal if they have the same name.
+bool HaveSameShape(const NodeArg& node_arg, const NodeArg& other_node_arg) {
+  const auto* shape = node_arg.Shape();
+  const auto* other_shape = other_node_arg.Shape();
+  if (shape == nullptr || other_shape == nullptr || shape->dim_size() != other_shape->dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape->dim_size(); ++i) {
+    const auto& dim = shape->dim(i);
+    const auto& other_dim = other_shape->dim(i);
+    if (utils::HasDimValue(dim) && utils::HasDimValue(other_dim)) {
+      if (dim.dim_value() != other_dim.dim_value()) {
+        return false;
+      }
+    } else if (utils::HasDimParam(dim) && utils::HasDimParam(other_dim)) {
+      if (dim.dim_param() != other_dim.dim_param()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the only consumer of the node's output, if the output is used nowhere else.
+Node* GetLoneConsumer(Graph& graph, const Node& node) {
+  if (!optimizer_utils::CheckOutputEdges(graph, node, 1)) {
+    return nullptr;
+  }
+
+  const Node& next_node = *node.OutputNodesBegin();
+  if (next_node.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+    return nullptr;
+  }
+  return graph.GetNode(next_node.Index());
+}
+
+// Returns the index of the input of an Add node that is not `input`, or -1 if the node is not such an Add.
+int GetOtherAddInputIndex(const Node& add_node, const NodeArg& input) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(add_node, "Add", {7, 13, 14})) {
+    return -1;
+  }
+
+  const auto& input_defs = add_node.InputDefs();
+  const bool is_input_0 = input_defs[0]->Name() == input.Name();
+  const bool is_input_1 = input_defs[1]->Name() == input.Name();
+  if (is_input_0 == is_input_1) {
+    return -1;
+  }
+  return is_input_0 ? 1 : 0;
+}
+
+// A constant [N] float initializer, where N is the last dimension of the GEMM output.
+bool IsBiasInitializer(const Graph& graph, const NodeArg& bias, const NodeArg& gemm_output) {
+  const auto* gemm_output_shape = gemm_output.Shape();
+  if (gemm_output_shape == nullptr || gemm_output_shape->dim_size() < 1) {
+    return false;
+  }
+
+  const auto& n_dim = gemm_output_shape->dim(gemm_output_shape->dim_size() - 1);
+  const TensorProto* bias_initializer = graph_utils::GetConstantInitializer(graph, bias.Name());
+  return utils::HasDimValue(n_dim) && bias_initializer != nullptr &&
+         bias_initializer->data_type() == TensorProto_DataType_FLOAT &&
+         bias_initializer->dims_size() == 1 && bias_initializer->dims(0) == n_dim.dim_value();
+}
+
+// Returns whether the node is an activation supported by MLAS and collects the parameters expected by
+// GetFusedActivationAttr().
+bool GetFusableActivation(const Graph& graph, const Node& node, InlinedVector<float>& activation_params) {
+  activation_params.clear();
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13})) {
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "LeakyRelu", {6, 16})) {
+    const auto* alpha_attr = graph_utils::GetNodeAttribute(node, "alpha");
+    activation_params.push_back(alpha_attr == nullptr ? 0.01f : alpha_attr->f());
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "HardSigmoid", {6})) {
+    const auto* alpha_attr = graph_utils::GetNodeAttribute(node, "alpha");
+    const auto* beta_attr = graph_utils::GetNodeAttribute(node, "beta");
+    activation_params.push_back(alpha_attr == nullptr ? 0.2f : alpha_attr->f());
+    activation_params.push_back(beta_attr == nullptr ? 0.5f : beta_attr->f());
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Clip", {6, 11, 12, 13})) {
+    float min, max;
+    if (!optimizer_utils::GetClipConstantMinMax(graph, node, min, max)) {
+      return false;
+    }
+    activation_params.push_back(min);
+    activation_params.push_back(max);
+    return true;
+  }
+
+  return false;
+}
+}  // namespace
+
+/**
+GemmEpilogueFusion will fuse subgraph like below into the epilogue of MatMulNBits or DynamicQuantizeMatMul:
+
+      MatMulNBits
+           |
+           v
+     [Add(bias[N])]
+           |                      ---->       MatMulNBits(bias, residual, activation)
+           v                                               |
+      [activation]                                         v
+           |
+           v
+  [Add(residual)] <--- residual
+
+Every step is optional, but they must appear in this order. 'bias' must be a constant initializer and 'residual'
+must have the same shape as the output, so that no broadcasting is needed.
+ */
+Status GemmEpilogueFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto index : order) {
+    auto* node_ptr = graph.GetNode(index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    const auto input_indices = GetEpilogueInputIndices(node);
+    if (!input_indices.has_value() ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !IsFloatTensor(*node.OutputDefs()[0])) {
+      continue;
+    }
+
+    // Only fuse into a node that has no epilogue yet, so the order of operations is preserved.
+    if (HasInput(node, input_indices->residual) || graph_utils::GetNodeAttribute(node, "activation") != nullptr) {
+      continue;
+    }
+
+    std::vector<std::reference_wrapper<Node>> nodes_to_fuse{node};
+    const NodeArg* output = node.OutputDefs()[0];
+    NodeArg* bias = nullptr;
+    NodeArg* residual = nullptr;
+    const Node* activation = nullptr;
+    InlinedVector<float> activation_params;
+
+    Node* next_node = GetLoneConsumer(graph, node);
+
+    if (next_node != nullptr && !HasInput(node, input_indices->bias)) {
+      const int bias_index = GetOtherAddInputIndex(*next_node, *output);
+      if (bias_index >= 0 && IsBiasInitializer(graph, *next_node->InputDefs()[bias_index], *output)) {
+        bias = next_node->MutableInputDefs()[bias_index];
+        nodes_to_fuse.push_back(*next_node);
+        output = next_node->OutputDefs()[0];
+        next_node = GetLoneConsumer(graph, *next_node);
+      }
+    }
+
+    if (next_node != nullptr && GetFusableActivation(graph, *next_node, activation_params)) {
+      activation = next_node;
+      nodes_to_fuse.push_back(*next_node);
+      output = next_node->OutputDefs()[0];
+      next_node = GetLoneConsumer(graph, *next_node);
+    }
+
+    // The edge that produces the residual has to be moved to the fused node.
+    std::optional<graph_utils::GraphEdge> residual_edge;
+    if (next_node != nullptr) {
+      const int residual_index = GetOtherAddInputIndex(*next_node, *output);
+      if (residual_index >= 0 && IsFloatTensor(*next_node->InputDefs()[residual_index]) &&
+          HaveSameShape(*next_node->InputDefs()[residual_index], *output) &&
+          HaveSameShape(*next_node->OutputDefs()[0], *output)) {
+        residual = next_node->MutableInputDefs()[residual_index];
+        for (const auto& edge : graph_utils::GraphEdge::GetNodeInputEdges(*next_node)) {
+          if (edge.dst_arg_index == residual_index) {
+            residual_edge = edge;
+          }
+        }
+        nodes_to_fuse.push_back(*next_node);
+      }
+    }
+
+    if (nodes_to_fuse.size() == 1) {
+      continue;
+    }
+
+    Node& gemm_node = node;
+
+    // Fill the skipped optional inputs with empty names so that bias and residual land at their indices.
+    std::vector<NodeArg*> input_defs = gemm_node.MutableInputDefs();
+    const size_t input_count = static_cast<size_t>(residual != nullptr ? input_indices->residual + 1
+                                                                        : input_indices->bias + 1);
+    while (input_defs.size() < input_count) {
+      input_defs.push_back(&graph.GetOrCreateNodeArg("", nullptr));
+    }
+    if (bias != nullptr) {
+      input_defs[input_indices->bias] = bias;
+    }
+    if (residual != nullptr) {
+      input_defs[input_indices->residual] = residual;
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName("fused " + gemm_node.Name()), gemm_node.OpType(),
+                                     "fused " + gemm_node.OpType() + " " + gemm_node.Name() + " with epilogue",
+                                     input_defs, {}, &gemm_node.GetAttributes(), kMSDomain);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    fused_node.SetExecutionProviderType(gemm_node.GetExecutionProviderType());
+
+    if (activation != nullptr) {
+      fused_node.AddAttribute("activation", activation->OpType());
+      if (!activation_params.empty()) {
+        fused_node.AddAttributeProto(utils::MakeAttribute("activation_params", activation_params));
+      }
+    }
+
+    // move output definitions and edges from the last node to fused_node. delete the fused nodes.
+    graph_utils::FinalizeNodeFusion(graph, nodes_to_fuse, fused_node);
+
+    if (residual_edge.has_value()) {
+      graph.AddEdge(residual_edge->src_node, fused_node.Index(), residual_edge->src_arg_index,
+                    input_indices->residual);
+    }
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GemmEpilogueFusion
+
+Fuse the element-wise ops that follow MatMulNBits or DynamicQuantizeMatMul into the epilogue of the node:
+  Y -> [Add(bias)] -> [activation] -> [Add(residual)]
+becomes a single node with optional inputs 'bias' and 'residual' and attributes 'activation' and
+'activation_params'. The CPU kernels apply the epilogue to each output tile while it is hot in cache.
+*/
+class GemmEpilogueFusion : public GraphTransformer {
+ public:
+  GemmEpilogueFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GemmEpilogueFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
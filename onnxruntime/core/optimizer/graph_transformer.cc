@@ -3,6 +3,11 @@
 
 #include "core/optimizer/graph_transformer.h"
 
+#include <memory>
+#include <vector>
+
+#include "core/platform/threadpool.h"
+
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -26,4 +31,47 @@ Status GraphTransformer::Apply(Graph& graph, bool& modified, const logging::Logg
   return status;
 }
 
+Status GraphTransformer::RecurseConcurrently(gsl::span<Node* const> nodes, bool& modified, int graph_level,
+                                             const logging::Logger& logger) const {
+  const int subgraph_level = graph_level + 1;
+  InlinedVector<Graph*> subgraphs;
+  for (Node* node : nodes) {
+    for (auto& entry : node->GetAttributeNameToMutableSubgraphMap()) {
+      subgraphs.push_back(entry.second);
+    }
+  }
+
+  // nested parallel sections are not supported by the thread pool, so only the subgraphs of the main graph are
+  // transformed concurrently
+  if (thread_pool_ == nullptr || graph_level > 0 || subgraphs.size() < 2) {
+    for (Graph* subgraph : subgraphs) {
+      ORT_RETURN_IF_ERROR(ApplyImpl(*subgraph, modified, subgraph_level, logger));
+    }
+    return Status::OK();
+  }
+
+  std::vector<Status> statuses(subgraphs.size());
+  // not a std::vector<bool> as its elements cannot be written concurrently
+  auto subgraph_modified = std::make_unique<bool[]>(subgraphs.size());
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool_, static_cast<std::ptrdiff_t>(subgraphs.size()), [&](std::ptrdiff_t i) {
+        ORT_TRY {
+          statuses[i] = ApplyImpl(*subgraphs[i], subgraph_modified[i], subgraph_level, logger);
+        }
+        ORT_CATCH(const std::exception& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "GraphTransformer ", Name(),
+                                          " failed to transform a subgraph: ", ex.what());
+          });
+        }
+      });
+
+  for (size_t i = 0; i < subgraphs.size(); ++i) {
+    ORT_RETURN_IF_ERROR(statuses[i]);
+    modified = modified || subgraph_modified[i];
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
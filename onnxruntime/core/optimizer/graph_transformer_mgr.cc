@@ -19,6 +19,15 @@ common::Status GraphTransformerManager::GetSteps(unsigned& steps) const {
   return Status::OK();
 }
 
+void GraphTransformerManager::SetThreadPool(concurrency::ThreadPool* thread_pool) {
+  thread_pool_ = thread_pool;
+  for (auto& entry : level_to_transformer_map_) {
+    for (auto& transformer : entry.second) {
+      transformer->SetThreadPool(thread_pool);
+    }
+  }
+}
+
 common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, TransformerLevel level,
                                                           const logging::Logger& logger) const {
   const auto& transformers = level_to_transformer_map_.find(level);
@@ -51,6 +60,7 @@ common::Status GraphTransformerManager::Register(std::unique_ptr<GraphTransforme
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "This transformer is already registered " + name);
   }
 
+  transformer->SetThreadPool(thread_pool_);
   transformers_info_[name] = transformer.get();
   level_to_transformer_map_[level].push_back(std::move(transformer));
   return Status::OK();
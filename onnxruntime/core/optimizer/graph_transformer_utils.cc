@@ -30,9 +30,14 @@
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/div_mul_fusion.h"
 #include "core/optimizer/double_qdq_pairs_remover.h"
+#include "core/optimizer/dq_matmul_nbits_fusion.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/dynamic_quantize_matmul_packing.h"
+#include "core/optimizer/dynamic_quantize_skip_layer_norm_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/free_dim_override_transformer.h"
@@ -40,20 +45,27 @@
 #include "core/optimizer/gelu_approximation.h"
 #include "core/optimizer/gelu_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/gemm_epilogue_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
 #include "core/optimizer/identical_children_consolidation.h"
 #include "core/optimizer/identity_elimination.h"
+#include "core/optimizer/inference_recompute.h"
 #include "core/optimizer/layer_norm_fusion.h"
 #include "core/optimizer/label_encoder_fusion.h"
 #include "core/optimizer/matmul_activation_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_integer_to_float.h"
+#include "core/optimizer/matmul_nbits_quantization.h"
+#include "core/optimizer/matmul_packing.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
 #include "core/optimizer/matmul_bn_fusion.h"
+#include "core/optimizer/matmul_float8_fusion.h"
+#include "core/optimizer/multihead_attention_fusion.h"
 #include "core/optimizer/pad_fusion.h"
 #include "core/optimizer/nchwc_transformer.h"
+#include "core/optimizer/nhwc_depthwise_pointwise_fusion.h"
 #include "core/optimizer/noop_elimination.h"
 #include "core/optimizer/not_where_fusion.h"
 #include "core/optimizer/pre_shape_node_elimination.h"
@@ -70,14 +82,18 @@
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rocm_blas_alt_impl.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
+#include "core/optimizer/shape_compute_fusion.h"
 #include "core/optimizer/shape_input_merge.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/tensor_parallel_sharding.h"
+#include "core/optimizer/token_embed_layer_norm_fusion.h"
 #include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #ifdef ENABLE_TRAINING
 #include "orttraining/core/optimizer/bias_softmax_dropout_fusion.h"
 #include "orttraining/core/optimizer/bitmask_dropout_replacement.h"
+#include "orttraining/core/optimizer/gemm_accumulator_fusion.h"
 #include "orttraining/core/optimizer/sce_loss_grad_bias_fusion.h"
 #endif
 #ifdef ENABLE_TRITON
@@ -283,6 +299,17 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
                                                                                onnxruntime::kJsExecutionProvider};
       const InlinedHashSet<std::string_view> cpu_dml_eps = {onnxruntime::kCpuExecutionProvider,
                                                             onnxruntime::kDmlExecutionProvider};
+      // the JS EP has kernels for the Gelu, FastGelu, SkipLayerNormalization and SimplifiedLayerNormalization nodes
+      // produced by these fusions. every node fused away saves a WebGPU dispatch.
+      const InlinedHashSet<std::string_view> cpu_cuda_rocm_js_eps = {onnxruntime::kCpuExecutionProvider,
+                                                                     onnxruntime::kCudaExecutionProvider,
+                                                                     onnxruntime::kRocmExecutionProvider,
+                                                                     onnxruntime::kJsExecutionProvider};
+      const InlinedHashSet<std::string_view> cpu_cuda_dml_rocm_js_eps = {onnxruntime::kCpuExecutionProvider,
+                                                                         onnxruntime::kCudaExecutionProvider,
+                                                                         onnxruntime::kRocmExecutionProvider,
+                                                                         onnxruntime::kDmlExecutionProvider,
+                                                                         onnxruntime::kJsExecutionProvider};
 #ifdef MLAS_TARGET_AMD64_IX86
       const bool avx2_precision_mode =
           session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsAvx2PrecisionMode, "0") == "1" && MlasPlatformU8S8Overflow();
@@ -302,23 +329,46 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<GemmActivationFusion>(cpu_ep));
       transformers.emplace_back(std::make_unique<MatMulIntegerToFloatFusion>(cpu_dml_eps));
       transformers.emplace_back(std::make_unique<DynamicQuantizeMatMulFusion>(cpu_ep));
+      const int64_t weight_quantization_bits = std::stoll(session_options.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsMatMulWeightQuantizationBits, "0"));
+      const int64_t block_size = std::stoll(session_options.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsMatMulWeightQuantizationBlockSize, "32"));
+      const int64_t accuracy_level = std::stoll(session_options.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsMatMulWeightQuantizationAccuracyLevel, "0"));
+      if (!disable_quant_qdq) {
+        transformers.emplace_back(std::make_unique<DQMatMulNBitsFusion>(block_size, accuracy_level, cpu_ep));
+      }
+      if (weight_quantization_bits == 4) {
+        transformers.emplace_back(std::make_unique<MatMulNBitsQuantization>(block_size, accuracy_level, cpu_ep));
+      }
+      // must run after DynamicQuantizeMatMulFusion and MatMulNBitsQuantization, which produce the nodes it fuses into
+      transformers.emplace_back(std::make_unique<GemmEpilogueFusion>(cpu_ep));
+      // must run after GemmEpilogueFusion, so that the packed nodes keep their bias and activation
+      transformers.emplace_back(std::make_unique<DynamicQuantizeMatMulPacking>(cpu_ep));
 
       transformers.emplace_back(std::make_unique<ConvActivationFusion>(cpu_cuda_rocm_acl_armnn_js_eps));
 
-      transformers.emplace_back(std::make_unique<GeluFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<GeluFusion>(cpu_cuda_dml_rocm_js_eps));
       transformers.emplace_back(std::make_unique<LayerNormFusion>(cpu_cuda_dml_rocm_eps));
-      transformers.emplace_back(std::make_unique<SimplifiedLayerNormFusion>(cpu_cuda_rocm_eps));
+      transformers.emplace_back(std::make_unique<SimplifiedLayerNormFusion>(cpu_cuda_rocm_js_eps));
       transformers.emplace_back(std::make_unique<AttentionFusion>(cpu_cuda_dml_rocm_eps));
+      // must run before MatmulTransposeFusion and MatMulScaleFusion, which take the Transpose and scaling of K
+      transformers.emplace_back(std::make_unique<MultiHeadAttentionFusion>(cpu_ep));
       transformers.emplace_back(std::make_unique<EmbedLayerNormFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<TokenEmbedLayerNormFusion>(cpu_ep));
       transformers.emplace_back(std::make_unique<GatherSliceToSplitFusion>(cpu_cuda_rocm_eps));
       transformers.emplace_back(std::make_unique<GatherToSliceFusion>(cpu_cuda_rocm_eps));
+      transformers.emplace_back(std::make_unique<EmbeddingBagFusion>(cpu_ep));
 
       transformers.emplace_back(std::make_unique<MatmulTransposeFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<BiasGeluFusion>(cpu_cuda_dml_rocm_eps));
 
-      transformers.emplace_back(std::make_unique<SkipLayerNormFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<SkipLayerNormFusion>(cpu_cuda_dml_rocm_js_eps));
+      // must run after SkipLayerNormFusion and DynamicQuantizeMatMulFusion, it fuses the DynamicQuantizeLinear nodes
+      // that the latter leaves in place
+      transformers.emplace_back(std::make_unique<DynamicQuantizeSkipLayerNormFusion>(cpu_ep));
 
-      transformers.emplace_back(std::make_unique<FastGeluFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<FastGeluFusion>(cpu_cuda_dml_rocm_js_eps));
       transformers.emplace_back(std::make_unique<QuickGeluFusion>(cpu_cuda_dml_rocm_eps));
 
       // GeluApproximation has side effects which may change results. It needs to be manually enabled,
@@ -342,10 +392,38 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<BitmaskDropoutReplacement>(cuda_rocm_eps));
       transformers.emplace_back(std::make_unique<BiasSoftmaxDropoutFusion>(cuda_rocm_eps));
       transformers.emplace_back(std::make_unique<SceLossGradBiasFusion>(cpu_cuda_rocm_eps));
+      transformers.emplace_back(std::make_unique<GemmAccumulatorFusion>(cpu_ep));
 #endif
 
       transformers.emplace_back(std::make_unique<MatMulScaleFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<MatMulActivationFusion>(dml_ep));
+#if !defined(DISABLE_FLOAT8_TYPES)
+      // changes the precision and needs float 8 tensor cores, so it is enabled manually
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableFloat8MatMulFusion, "0") == "1") {
+        transformers.emplace_back(std::make_unique<MatMulFloat8Fusion>(
+            InlinedHashSet<std::string_view>{onnxruntime::kCudaExecutionProvider}));
+      }
+#endif
+      // must run after the fusions matching single MatMul nodes, e.g. AttentionFusion and MatMulScaleFusion
+      transformers.emplace_back(std::make_unique<MatMulPacking>(cpu_ep));
+
+      // must run after AttentionFusion and BiasGeluFusion, whose nodes it shards
+      const int64_t tensor_parallel_world_size = std::stoll(session_options.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsTensorParallelWorldSize, "1"));
+#ifdef ORT_USE_NCCL
+      if (tensor_parallel_world_size > 1) {
+        const int64_t tensor_parallel_rank = std::stoll(session_options.config_options.GetConfigOrDefault(
+            kOrtSessionOptionsTensorParallelRank, "0"));
+        ORT_ENFORCE(tensor_parallel_rank >= 0 && tensor_parallel_rank < tensor_parallel_world_size,
+                    "Invalid tensor parallel rank ", tensor_parallel_rank, " for world size ",
+                    tensor_parallel_world_size);
+        transformers.emplace_back(std::make_unique<TensorParallelSharding>(
+            tensor_parallel_world_size, tensor_parallel_rank,
+            InlinedHashSet<std::string_view>{onnxruntime::kCudaExecutionProvider}));
+      }
+#else
+      ORT_ENFORCE(tensor_parallel_world_size <= 1, "Tensor parallelism requires a build with NCCL.");
+#endif
 
 #ifdef MLAS_TARGET_AMD64_IX86
       if (avx2_precision_mode) {
@@ -362,13 +440,20 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
 
     case TransformerLevel::Level3: {
 #ifndef DISABLE_CONTRIB_OPS
+      // fp32 convolutions are either kept in NHWC by the NhwcTransformer or reordered to NCHWc.
+      const bool enable_nhwc_fp32 =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsCpuNhwcFp32, "0") == "1";
+
       // Register the NCHWc layout transformer if supported by the platform.
-      if (MlasNchwcGetBlockSize() > 1) {
-        transformers.emplace_back(std::make_unique<NchwcTransformer>());
+      if (!enable_nhwc_fp32 && MlasNchwcGetBlockSize() > 1) {
+        const bool use_layout_cost_model = session_options.config_options.GetConfigOrDefault(
+                                               kOrtSessionOptionsNchwcLayoutCostModel, "0") == "1";
+        transformers.emplace_back(std::make_unique<NchwcTransformer>(use_layout_cost_model));
       }
 
       auto cpu_registry = cpu_execution_provider.GetKernelRegistry();
-      auto nhwc_transformer = std::make_unique<NhwcTransformer>(std::move(cpu_allocator), std::move(cpu_registry));
+      auto nhwc_transformer = std::make_unique<NhwcTransformer>(std::move(cpu_allocator), std::move(cpu_registry),
+                                                                enable_nhwc_fp32);
       if (nhwc_transformer->IsActive()) {
         transformers.emplace_back(std::move(nhwc_transformer));
       }
@@ -379,8 +464,26 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       // PR #6351 implemented similar fusion-pattern for CUDA only, and can only fuse conv-add-relu,
       // while we can fuse more activation.
       transformers.emplace_back(std::make_unique<ConvAddActivationFusion>(cpu_ep));
+
+      // Runs after the NHWC convolutions have absorbed their Add and activation nodes.
+      if (enable_nhwc_fp32) {
+        transformers.emplace_back(std::make_unique<NhwcDepthwisePointwiseFusion>(cpu_ep));
+      }
+
+      // Runs last so that the layout transformers and the Conv fusions keep their Add and activation nodes.
+      transformers.emplace_back(std::make_unique<ElementwiseChainFusion>(
+          InlinedHashSet<std::string_view>{onnxruntime::kCpuExecutionProvider, onnxruntime::kCudaExecutionProvider}));
+
+      // Runs after the level 2 fusions and the layout transformers, which match Shape, Gather and Concat nodes.
+      transformers.emplace_back(std::make_unique<ShapeComputeFusion>(cpu_ep));
 #endif
 
+      // Runs after the fusions, which may match the nodes it would duplicate.
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableInferenceRecompute, "0") == "1") {
+        transformers.emplace_back(std::make_unique<InferenceRecompute>(
+            InlinedHashSet<std::string_view>{onnxruntime::kCpuExecutionProvider}));
+      }
+
     } break;
 
     default:
@@ -444,7 +547,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformersForMinimalB
 #ifndef DISABLE_CONTRIB_OPS
         AllocatorPtr cpu_allocator = std::make_shared<CPUAllocator>();
         auto cpu_registry = cpu_execution_provider.GetKernelRegistry();
-        auto nhwc_transformer = std::make_unique<NhwcTransformer>(std::move(cpu_allocator), std::move(cpu_registry));
+        const bool enable_nhwc_fp32 =
+            session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsCpuNhwcFp32, "0") == "1";
+        auto nhwc_transformer = std::make_unique<NhwcTransformer>(std::move(cpu_allocator), std::move(cpu_registry),
+                                                                  enable_nhwc_fp32);
         if (nhwc_transformer->IsActive()) {
           transformers.emplace_back(std::move(nhwc_transformer));
         }
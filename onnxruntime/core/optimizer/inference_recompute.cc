@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/inference_recompute.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+bool IsRecomputableOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Expand", {8, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tile", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "ConstantOfShape", {9, 20, 21}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Range", {11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Where", {9, 16}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9, 13, 19, 21}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Not", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Equal", {7, 11, 13, 19}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Less", {7, 9, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Greater", {7, 9, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14});
+}
+
+bool SameDim(const TensorShapeProto_Dimension& dim, const TensorShapeProto_Dimension& other) {
+  if (utils::HasDimValue(dim) && utils::HasDimValue(other)) {
+    return dim.dim_value() == other.dim_value();
+  }
+  return utils::HasDimParam(dim) && utils::HasDimParam(other) && dim.dim_param() == other.dim_param();
+}
+
+// Whether the output is a strict broadcast of the input: the dimensions of the input are 1 or the same as the
+// trailing dimensions of the output, and the output has dimensions the input does not have.
+bool IsStrictBroadcast(const TensorShapeProto& input, const TensorShapeProto& output) {
+  const int offset = output.dim_size() - input.dim_size();
+  if (offset < 0) {
+    return false;
+  }
+
+  bool expands = offset > 0;
+  for (int i = 0; i < input.dim_size(); ++i) {
+    const auto& input_dim = input.dim(i);
+    const auto& output_dim = output.dim(offset + i);
+    if (utils::HasDimValue(input_dim) && input_dim.dim_value() == 1) {
+      expands = expands || !utils::HasDimValue(output_dim) || output_dim.dim_value() != 1;
+    } else if (!SameDim(input_dim, output_dim)) {
+      return false;
+    }
+  }
+  return expands;
+}
+
+// Whether keeping the inputs of the node alive is cheaper than keeping its output alive: each input is a constant,
+// a shape or a scalar, or the output is a broadcast of it.
+bool HasSmallInputs(const Graph& graph, const Node& node) {
+  const auto* output_shape = node.OutputDefs()[0]->Shape();
+  for (const NodeArg* input : node.InputDefs()) {
+    if (!input->Exists() || graph_utils::NodeArgIsConstant(graph, *input)) {
+      continue;
+    }
+    const auto* input_shape = input->Shape();
+    if (input_shape == nullptr) {
+      return false;
+    }
+    if (input_shape->dim_size() <= 1 && node.OpType() != "Cast" && node.OpType() != "Not") {
+      continue;  // shapes, scalars or positions the output is generated from
+    }
+    if (output_shape == nullptr || !IsStrictBroadcast(*input_shape, *output_shape)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Status InferenceRecompute::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // positions of the nodes in the execution order, the copies take the position of their first consumer
+  InlinedHashMap<NodeIndex, size_t> positions;
+  for (size_t i = 0; i < node_topology_list.size(); ++i) {
+    positions[node_topology_list[i]] = i;
+  }
+
+  // consumers are handled before producers, so that a chain of recomputable nodes is copied as a whole
+  for (auto it = node_topology_list.rbegin(); it != node_topology_list.rend(); ++it) {
+    auto* node_ptr = graph.GetNode(*it);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!IsRecomputableOp(node) || !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        node.OutputDefs().size() != 1 || graph.NodeProducesGraphOutput(node) || !HasSmallInputs(graph, node)) {
+      continue;
+    }
+
+    // the uses of the output by explicit inputs of the consumers, in execution order
+    struct Use {
+      size_t position;
+      NodeIndex consumer;
+      int input_index;
+    };
+    InlinedVector<Use> uses;
+    for (auto edge = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); edge != end; ++edge) {
+      const Node& consumer = edge->GetNode();
+      if (static_cast<size_t>(edge->GetDstArgIndex()) < consumer.InputDefs().size()) {
+        uses.push_back({positions[consumer.Index()], consumer.Index(), edge->GetDstArgIndex()});
+      }
+    }
+    std::sort(uses.begin(), uses.end(), [](const Use& a, const Use& b) { return a.position < b.position; });
+
+    // the first group of consumers keeps the node, each following group gets its own copy
+    Node* copy = nullptr;
+    for (size_t i = 1; i < uses.size(); ++i) {
+      if (uses[i].position - uses[i - 1].position >= min_consumer_distance_) {
+        copy = &graph.AddNode(graph.GenerateNodeName(node.Name() + "_recompute"), node.OpType(),
+                              "recomputed " + node.Name(), node.MutableInputDefs(),
+                              {&graph_utils::CreateNodeArg(graph, *node.OutputDefs()[0])},
+                              &node.GetAttributes(), node.Domain());
+        copy->SetExecutionProviderType(node.GetExecutionProviderType());
+        copy->SetSinceVersion(node.SinceVersion());
+        for (auto edge = node.InputEdgesBegin(), end = node.InputEdgesEnd(); edge != end; ++edge) {
+          graph.AddEdge(edge->GetNode().Index(), copy->Index(), edge->GetSrcArgIndex(), edge->GetDstArgIndex());
+        }
+        positions[copy->Index()] = uses[i].position;
+      }
+
+      if (copy != nullptr) {
+        Node& consumer = *graph.GetNode(uses[i].consumer);
+        graph.RemoveEdge(node.Index(), consumer.Index(), 0, uses[i].input_index);
+        graph_utils::ReplaceNodeInput(consumer, uses[i].input_index, *copy->MutableOutputDefs()[0]);
+        graph.AddEdge(copy->Index(), consumer.Index(), 0, uses[i].input_index);
+        modified = true;
+      }
+    }
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class InferenceRecompute
+
+Trade compute for memory at inference: a cheap node that broadcasts or generates a large tensor from small inputs,
+e.g. an Expand of an attention mask, a Range of positions or a ConstantOfShape, is duplicated next to each group of
+its consumers that are far apart in the execution order. Each copy is computed right before its consumers and freed
+after them, so the large tensor is not kept alive between distant consumers, which lowers the peak memory of long
+sequence models. Only the small inputs of the node stay alive across the graph.
+
+Consumers less than min_consumer_distance nodes apart in the execution order share a copy.
+*/
+class InferenceRecompute : public GraphTransformer {
+ public:
+  InferenceRecompute(const InlinedHashSet<std::string_view>& compatible_execution_providers = {},
+                     size_t min_consumer_distance = 16) noexcept
+      : GraphTransformer("InferenceRecompute", compatible_execution_providers),
+        min_consumer_distance_(min_consumer_distance) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const size_t min_consumer_distance_;
+};
+
+}  // namespace onnxruntime
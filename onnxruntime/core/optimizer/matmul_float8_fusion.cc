@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_float8_fusion.h"
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloat8(int32_t data_type) {
+  return data_type == TensorProto_DataType_FLOAT8E4M3FN || data_type == TensorProto_DataType_FLOAT8E5M2;
+}
+
+// Returns the per-tensor scale of a DequantizeLinear node from a float 8 tensor, or false if it is not one.
+bool GetFloat8DequantizeScale(const Graph& graph, const Node& node, float& scale) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "DequantizeLinear", {19, 21}) ||
+      node.GetOutputEdgesCount() != 1 || graph.NodeProducesGraphOutput(node)) {
+    return false;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  const auto* x_type = input_defs[0]->TypeAsProto();
+  if (x_type == nullptr || !x_type->tensor_type().has_elem_type() || !IsFloat8(x_type->tensor_type().elem_type())) {
+    return false;
+  }
+
+  // float 8 zero points are 0
+  if (input_defs.size() > 2 && input_defs[2]->Exists() &&
+      !graph_utils::IsConstantInitializer(graph, input_defs[2]->Name())) {
+    return false;
+  }
+
+  const TensorProto* scale_proto = graph_utils::GetConstantInitializer(graph, input_defs[1]->Name());
+  if (scale_proto == nullptr || !optimizer_utils::IsScalar(*input_defs[1])) {
+    return false;
+  }
+
+  Initializer scale_initializer{*scale_proto, graph.ModelPath()};
+  switch (scale_proto->data_type()) {
+    case TensorProto_DataType_FLOAT:
+      scale = scale_initializer.data<float>()[0];
+      return true;
+    case TensorProto_DataType_FLOAT16:
+      scale = scale_initializer.data<MLFloat16>()[0].ToFloat();
+      return true;
+    default:
+      return false;
+  }
+}
+
+NodeArg& AddScaleInitializer(Graph& graph, const std::string& name, float scale) {
+  TensorProto initializer;
+  initializer.set_name(graph.GenerateNodeArgName(name));
+  initializer.set_data_type(TensorProto_DataType_FLOAT);
+  initializer.add_float_data(scale);
+  return graph_utils::AddInitializer(graph, initializer);
+}
+
+}  // namespace
+
+Status MatMulFloat8Fusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13}) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Node* dq_a = graph_utils::GetInputNode(node, 0);
+    const Node* dq_b = graph_utils::GetInputNode(node, 1);
+    float scale_a = 0.f;
+    float scale_b = 0.f;
+    if (dq_a == nullptr || dq_b == nullptr || dq_a == dq_b ||
+        !GetFloat8DequantizeScale(graph, *dq_a, scale_a) || !GetFloat8DequantizeScale(graph, *dq_b, scale_b)) {
+      continue;
+    }
+
+    NodeArg* a = graph.GetNodeArg(dq_a->InputDefs()[0]->Name());
+    const TensorShapeProto* a_shape = a->Shape();
+    if (a_shape == nullptr || a_shape->dim_size() != 2) {
+      continue;
+    }
+
+    const TensorProto* b = graph_utils::GetConstantInitializer(graph, dq_b->InputDefs()[0]->Name());
+    if (b == nullptr || b->dims_size() != 2) {
+      continue;
+    }
+
+    const int32_t a_type = a->TypeAsProto()->tensor_type().elem_type();
+    if (a_type == TensorProto_DataType_FLOAT8E5M2 && b->data_type() == TensorProto_DataType_FLOAT8E5M2) {
+      continue;  // not supported by cublasLt
+    }
+
+    const auto* output_type = node.OutputDefs()[0]->TypeAsProto();
+    if (output_type == nullptr || !output_type->tensor_type().has_elem_type()) {
+      continue;
+    }
+    const int32_t output_elem_type = output_type->tensor_type().elem_type();
+    if (output_elem_type != TensorProto_DataType_FLOAT && output_elem_type != TensorProto_DataType_FLOAT16 &&
+        output_elem_type != TensorProto_DataType_BFLOAT16) {
+      continue;
+    }
+
+    // the float 8 GEMM takes B as (N, K)
+    std::vector<uint8_t> b_data;
+    ORT_RETURN_IF_ERROR(utils::UnpackInitializerData(*b, graph.ModelPath(), b_data));
+    const int64_t K = b->dims(0);
+    const int64_t N = b->dims(1);
+    std::vector<uint8_t> b_transposed(b_data.size());
+    for (int64_t k = 0; k < K; ++k) {
+      for (int64_t n = 0; n < N; ++n) {
+        b_transposed[n * K + k] = b_data[k * N + n];
+      }
+    }
+
+    TensorProto b_transposed_proto;
+    b_transposed_proto.set_name(graph.GenerateNodeArgName(b->name() + "_transposed"));
+    b_transposed_proto.set_data_type(b->data_type());
+    b_transposed_proto.add_dims(N);
+    b_transposed_proto.add_dims(K);
+    b_transposed_proto.set_raw_data(b_transposed.data(), b_transposed.size());
+
+    InlinedVector<NodeArg*> input_defs{
+        a,
+        &graph_utils::AddInitializer(graph, b_transposed_proto),
+        &graph.GetOrCreateNodeArg("", nullptr),
+        &AddScaleInitializer(graph, node.Name() + "_scale_a", scale_a),
+        &AddScaleInitializer(graph, node.Name() + "_scale_b", scale_b)};
+
+    Node& gemm_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_float8"),
+                                    "GemmFloat8",
+                                    "fused float 8 DequantizeLinear and MatMul",
+                                    input_defs,
+                                    node.MutableOutputDefs(),
+                                    nullptr,
+                                    kMSDomain);
+    gemm_node.AddAttribute("transA", static_cast<int64_t>(0));
+    gemm_node.AddAttribute("transB", static_cast<int64_t>(1));
+    gemm_node.AddAttribute("dtype", static_cast<int64_t>(output_elem_type));
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    gemm_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    const NodeIndex dq_a_index = dq_a->Index();
+    const NodeIndex dq_b_index = dq_b->Index();
+    for (NodeIndex index : {node.Index(), dq_a_index, dq_b_index}) {
+      Node* removed = graph.GetNode(index);
+      graph_utils::RemoveNodeOutputEdges(graph, *removed);
+      graph.RemoveNode(index);
+    }
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulFloat8Fusion
+
+Fuse a MatMul whose inputs are dequantized from float 8 tensors into a GemmFloat8 running on the float 8 tensor cores:
+
+  A (float 8)   B (float 8 initializer)
+      |               |
+  DequantizeLinear  DequantizeLinear               A (float 8)   B^T (float 8 initializer)
+        \           /                 ---->              \         /
+           MatMul                                  GemmFloat8(transB = 1, scaleA, scaleB)
+             |                                                 |
+
+The dequantization must be per tensor with constant scales, which become the scales of the GEMM. A must be a 2D
+tensor, B is transposed as the float 8 GEMM requires. E5M2 is only supported for one of the inputs.
+*/
+class MatMulFloat8Fusion : public GraphTransformer {
+ public:
+  MatMulFloat8Fusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulFloat8Fusion", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
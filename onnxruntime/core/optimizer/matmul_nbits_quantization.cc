@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_nbits_quantization.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/mlas/inc/mlas_q4.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+constexpr int kQuantBits = 4;
+
+// The initializers of a weight quantized for MatMulNBits.
+struct QuantizedWeight {
+  NodeArg* data;
+  NodeArg* scales;
+  NodeArg* zero_points;
+};
+
+template <typename T>
+NodeArg& AddQuantizedInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                                 TensorProto_DataType data_type, const std::vector<T>& values) {
+  TensorProto initializer;
+  initializer.set_name(graph.GenerateNodeArgName(name));
+  initializer.set_data_type(data_type);
+  for (int64_t dim : dims) {
+    initializer.add_dims(dim);
+  }
+  initializer.set_raw_data(values.data(), values.size() * sizeof(T));
+  return graph_utils::AddInitializer(graph, initializer);
+}
+
+}  // namespace
+
+Status MatMulNBitsQuantization::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedHashMap<std::string, QuantizedWeight> quantized_weights;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13}) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // MatMulNBits broadcasts the weight over the leading dimensions of A, which must be at least a matrix
+    const NodeArg& input_a = *node.InputDefs()[0];
+    const auto* a_type = input_a.TypeAsProto();
+    if (a_type == nullptr || a_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT ||
+        input_a.Shape() == nullptr || input_a.Shape()->dim_size() < 2) {
+      continue;
+    }
+
+    const std::string& weight_name = node.InputDefs()[1]->Name();
+    const TensorProto* weight_proto = graph_utils::GetConstantInitializer(graph, weight_name);
+    if (weight_proto == nullptr || weight_proto->data_type() != TensorProto_DataType_FLOAT ||
+        weight_proto->dims_size() != 2) {
+      continue;
+    }
+    const int64_t K = weight_proto->dims(0);
+    const int64_t N = weight_proto->dims(1);
+    if (K < block_size_ || N < min_columns_) {
+      continue;
+    }
+
+    auto it = quantized_weights.find(weight_name);
+    if (it == quantized_weights.end()) {
+      size_t data_size = 0;
+      size_t scales_size = 0;
+      size_t zero_points_size = 0;
+      MlasBlockwiseQuantizedBufferSizes(kQuantBits, static_cast<int>(block_size_), /* columnwise */ true,
+                                        static_cast<int>(K), static_cast<int>(N),
+                                        data_size, scales_size, &zero_points_size);
+      if (data_size == 0) {
+        continue;  // block size not supported by MLAS
+      }
+
+      Initializer weight{*weight_proto, graph.ModelPath()};
+      std::vector<uint8_t> data(data_size);
+      std::vector<float> scales(scales_size);
+      std::vector<uint8_t> zero_points(zero_points_size);
+      MlasQuantizeBlockwise<float, kQuantBits>(data.data(), scales.data(), zero_points.data(), weight.data<float>(),
+                                               static_cast<int>(block_size_), /* columnwise */ true,
+                                               static_cast<int>(K), static_cast<int>(N), static_cast<int>(N),
+                                               nullptr);
+
+      // B is laid out as [N, blocks along K, bytes per block]
+      const int64_t k_blocks = (K + block_size_ - 1) / block_size_;
+      const int64_t block_bytes = block_size_ * kQuantBits / 8;
+      QuantizedWeight quantized{
+          &AddQuantizedInitializer(graph, weight_name + "_Q4", {N, k_blocks, block_bytes},
+                                   TensorProto_DataType_UINT8, data),
+          &AddQuantizedInitializer(graph, weight_name + "_scales", {N * k_blocks},
+                                   TensorProto_DataType_FLOAT, scales),
+          &AddQuantizedInitializer(graph, weight_name + "_zero_points", {static_cast<int64_t>(zero_points_size)},
+                                   TensorProto_DataType_UINT8, zero_points)};
+      it = quantized_weights.emplace(weight_name, quantized).first;
+    }
+
+    const QuantizedWeight& quantized = it->second;
+    Node& matmul_nbits_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_Q4"),
+                                            "MatMulNBits",
+                                            "MatMul with weight quantized at load time",
+                                            {node.MutableInputDefs()[0], quantized.data, quantized.scales,
+                                             quantized.zero_points},
+                                            {node.MutableOutputDefs()[0]},
+                                            nullptr,
+                                            kMSDomain);
+    matmul_nbits_node.AddAttribute("K", K);
+    matmul_nbits_node.AddAttribute("N", N);
+    matmul_nbits_node.AddAttribute("bits", static_cast<int64_t>(kQuantBits));
+    matmul_nbits_node.AddAttribute("block_size", block_size_);
+    matmul_nbits_node.AddAttribute("accuracy_level", accuracy_level_);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    matmul_nbits_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.Index());
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
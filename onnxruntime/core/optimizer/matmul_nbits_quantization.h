@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulNBitsQuantization
+
+Quantize the constant fp32 weights of MatMul nodes at session load time: MatMul(A, B) with B a [K, N] initializer
+becomes com.microsoft.MatMulNBits with B quantized blockwise along K to 4 bits with MlasQuantizeBlockwise, with a
+scale and a zero point per block. Weights shared by several MatMul nodes are quantized once. The quantized model can
+be saved with the optimized model, e.g. in ORT format, so that the quantization is not repeated on each load.
+
+Weights with fewer than block_size rows or fewer than min_columns columns are left in fp32.
+*/
+class MatMulNBitsQuantization : public GraphTransformer {
+ public:
+  MatMulNBitsQuantization(int64_t block_size, int64_t accuracy_level,
+                          const InlinedHashSet<std::string_view>& compatible_execution_providers = {},
+                          int64_t min_columns = 16) noexcept
+      : GraphTransformer("MatMulNBitsQuantization", compatible_execution_providers),
+        block_size_(block_size),
+        accuracy_level_(accuracy_level),
+        min_columns_(min_columns) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+ private:
+  const int64_t block_size_;
+  const int64_t accuracy_level_;
+  const int64_t min_columns_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,298 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/matmul_packing.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/node_attr_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Inputs of MatMulNBits
+constexpr size_t kB = 1;
+constexpr size_t kScales = 2;
+constexpr size_t kZeroPoints = 3;
+constexpr size_t kGIdx = 4;
+constexpr size_t kBias = 5;
+constexpr size_t kResidual = 6;
+
+// A MatMul or MatMulNBits node that can be packed with the nodes with the same key.
+struct PackableNode {
+  Node* node;
+  int64_t N;
+  std::string key;
+};
+
+bool HasInput(const Node& node, size_t index) {
+  return node.InputDefs().size() > index && node.InputDefs()[index]->Exists();
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr ? attr->i() : 0;
+}
+
+bool GetPackableMatMul(const Graph& graph, Node& node, PackableNode& packable) {
+  const TensorProto* b = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+  if (b == nullptr || b->dims_size() != 2) {
+    return false;
+  }
+  packable = {&node, b->dims(1), "MatMul," + std::to_string(b->data_type()) + "," + std::to_string(b->dims(0))};
+  return true;
+}
+
+bool GetPackableMatMulNBits(const Graph& graph, Node& node, PackableNode& packable) {
+  if (HasInput(node, kGIdx) || HasInput(node, kResidual)) {
+    return false;
+  }
+  for (size_t index : {kB, kScales, kZeroPoints, kBias}) {
+    if (HasInput(node, index) && !graph_utils::NodeArgIsConstant(graph, *node.InputDefs()[index])) {
+      return false;
+    }
+  }
+
+  const TensorProto* b = graph_utils::GetConstantInitializer(graph, node.InputDefs()[kB]->Name());
+  const int64_t N = GetIntAttribute(node, "N");
+  const int64_t K = GetIntAttribute(node, "K");
+  const int64_t bits = GetIntAttribute(node, "bits");
+  const int64_t block_size = GetIntAttribute(node, "block_size");
+  if (b == nullptr || b->data_type() != TensorProto_DataType_UINT8 || b->dims_size() < 2 || b->dims(0) != N ||
+      block_size <= 0) {
+    return false;
+  }
+
+  // the zero points must be stored per column to be concatenated, which the packed uint8 layout is when the zero
+  // points of a column fill whole bytes, or when MLAS pads them
+  std::string zero_points_key = "none";
+  if (HasInput(node, kZeroPoints)) {
+    const TensorProto* zero_points = graph_utils::GetConstantInitializer(graph, node.InputDefs()[kZeroPoints]->Name());
+    if (zero_points == nullptr || zero_points->dims_size() == 0) {
+      return false;
+    }
+    if (zero_points->data_type() == TensorProto_DataType_UINT8) {
+      const int64_t k_blocks = (K + block_size - 1) / block_size;
+      int64_t size = 1;
+      for (int64_t dim : zero_points->dims()) {
+        size *= dim;
+      }
+      if (size != N * ((k_blocks * bits + 7) / 8)) {
+        return false;
+      }
+    }
+    zero_points_key = std::to_string(zero_points->data_type());
+  }
+
+  std::string activation_key;
+  if (const auto* activation = graph_utils::GetNodeAttribute(node, "activation"); activation != nullptr) {
+    activation_key = activation->s();
+  }
+  if (const auto* params = graph_utils::GetNodeAttribute(node, "activation_params"); params != nullptr) {
+    for (float param : params->floats()) {
+      activation_key += ',' + std::to_string(param);
+    }
+  }
+
+  packable = {&node, N,
+              "MatMulNBits," + std::to_string(K) + "," + std::to_string(bits) + "," + std::to_string(block_size) +
+                  "," + std::to_string(GetIntAttribute(node, "accuracy_level")) + "," + zero_points_key + "," +
+                  std::to_string(b->dims_size()) + "," + activation_key};
+  return true;
+}
+
+bool GetPackableNode(const Graph& graph, Node& node, PackableNode& packable) {
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13})) {
+    return GetPackableMatMul(graph, node, packable);
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMulNBits", {1}, kMSDomain)) {
+    return GetPackableMatMulNBits(graph, node, packable);
+  }
+  return false;
+}
+
+NodeArg& AddPackedInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                              int32_t data_type, const std::vector<uint8_t>& bytes) {
+  TensorProto initializer;
+  initializer.set_name(graph.GenerateNodeArgName(name));
+  initializer.set_data_type(data_type);
+  for (int64_t dim : dims) {
+    initializer.add_dims(dim);
+  }
+  initializer.set_raw_data(bytes.data(), bytes.size());
+  return graph_utils::AddInitializer(graph, initializer);
+}
+
+const TensorProto& GetInitializer(const Graph& graph, const Node& node, size_t index) {
+  return *graph_utils::GetConstantInitializer(graph, node.InputDefs()[index]->Name());
+}
+
+// Concatenates the [K, N] weights of MatMul nodes along their columns.
+NodeArg& PackMatMulWeights(Graph& graph, gsl::span<const PackableNode> packable_nodes, int64_t total_N) {
+  const TensorProto& first_b = GetInitializer(graph, *packable_nodes[0].node, 1);
+  const int64_t K = first_b.dims(0);
+  std::vector<uint8_t> packed;
+  size_t element_size = 0;
+  int64_t column = 0;
+  for (const PackableNode& packable : packable_nodes) {
+    Initializer b{GetInitializer(graph, *packable.node, 1), graph.ModelPath()};
+    const auto b_bytes = b.DataAsByteSpan();
+    if (packed.empty()) {
+      element_size = b_bytes.size() / b.size();
+      packed.resize(static_cast<size_t>(K * total_N) * element_size);
+    }
+    const size_t row_bytes = static_cast<size_t>(packable.N) * element_size;
+    for (int64_t k = 0; k < K; ++k) {
+      std::copy_n(b_bytes.data() + k * row_bytes, row_bytes,
+                  packed.data() + static_cast<size_t>(k * total_N + column) * element_size);
+    }
+    column += packable.N;
+  }
+  return AddPackedInitializer(graph, packable_nodes[0].node->Name() + "_packed_B", {K, total_N}, first_b.data_type(),
+                              packed);
+}
+
+// Concatenates an input of MatMulNBits nodes, stored per output column, along its first dimension. Only the bias may
+// be missing on some of the nodes, it is filled with zeros for them.
+NodeArg& PackMatMulNBitsInput(Graph& graph, gsl::span<const PackableNode> packable_nodes, size_t index) {
+  const auto first = std::find_if(packable_nodes.begin(), packable_nodes.end(),
+                                  [index](const PackableNode& p) { return HasInput(*p.node, index); });
+  const TensorProto& first_tensor = GetInitializer(graph, *first->node, index);
+  size_t element_size = 0;
+  {
+    Initializer tensor{first_tensor, graph.ModelPath()};
+    element_size = tensor.DataAsByteSpan().size() / tensor.size();
+  }
+
+  std::vector<uint8_t> packed;
+  int64_t total_dim0 = 0;
+  for (const PackableNode& packable : packable_nodes) {
+    if (HasInput(*packable.node, index)) {
+      const TensorProto& tensor_proto = GetInitializer(graph, *packable.node, index);
+      Initializer tensor{tensor_proto, graph.ModelPath()};
+      const auto bytes = tensor.DataAsByteSpan();
+      packed.insert(packed.end(), bytes.begin(), bytes.end());
+      total_dim0 += tensor_proto.dims(0);
+    } else {
+      packed.insert(packed.end(), static_cast<size_t>(packable.N) * element_size, uint8_t{0});
+      total_dim0 += packable.N;
+    }
+  }
+
+  std::vector<int64_t> dims(first_tensor.dims().begin(), first_tensor.dims().end());
+  dims[0] = total_dim0;
+  return AddPackedInitializer(graph, packable_nodes[0].node->Name() + "_packed_" + std::to_string(index), dims,
+                              first_tensor.data_type(), packed);
+}
+
+}  // namespace
+
+Status MatMulPacking::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  // Split takes the sizes of the outputs as an input from opset 13
+  int onnx_opset_version = -1;
+  if (graph.DomainToVersionMap().find(kOnnxDomain) != graph.DomainToVersionMap().end()) {
+    onnx_opset_version = graph.DomainToVersionMap().at(kOnnxDomain);
+  }
+  if (onnx_opset_version < 13) return Status::OK();
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    PackableNode first;
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !GetPackableNode(graph, node, first)) {
+      continue;
+    }
+
+    // the nodes sharing A that can be packed with this node
+    const NodeArg* input_a = node.InputDefs()[0];
+    InlinedVector<PackableNode> packable_nodes{first};
+    for (Node* consumer : graph.GetMutableConsumerNodes(input_a->Name())) {
+      PackableNode packable;
+      if (consumer == nullptr || consumer == &node || consumer->InputDefs()[0] != input_a ||
+          consumer->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+          !GetPackableNode(graph, *consumer, packable) || packable.key != first.key) {
+        continue;
+      }
+      packable_nodes.push_back(packable);
+    }
+    if (packable_nodes.size() < 2) {
+      continue;
+    }
+
+    int64_t total_N = 0;
+    std::vector<int64_t> split_values;
+    for (const PackableNode& packable : packable_nodes) {
+      split_values.push_back(packable.N);
+      total_N += packable.N;
+    }
+
+    InlinedVector<NodeArg*> input_defs{node.MutableInputDefs()[0]};
+    NodeAttributes attributes = node.GetAttributes();
+    NodeArg optional_node_arg("", nullptr);
+    if (node.OpType() == "MatMul") {
+      input_defs.push_back(&PackMatMulWeights(graph, packable_nodes, total_N));
+    } else {
+      const bool has_bias = std::any_of(packable_nodes.begin(), packable_nodes.end(),
+                                        [](const PackableNode& p) { return HasInput(*p.node, kBias); });
+      const size_t num_inputs = has_bias ? kBias + 1 : (HasInput(node, kZeroPoints) ? kZeroPoints + 1 : kScales + 1);
+      for (size_t index = kB; index < num_inputs; ++index) {
+        const bool present = index == kBias ? has_bias : HasInput(node, index);
+        input_defs.push_back(present ? &PackMatMulNBitsInput(graph, packable_nodes, index)
+                                     : &optional_node_arg);
+      }
+      attributes["N"] = utils::MakeAttribute("N", total_N);
+    }
+
+    NodeArg& packed_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(node.Name() + "_packed"),
+                                                      node.OutputDefs()[0]->TypeAsProto());
+    Node& packed_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_packed"),
+                                      node.OpType(),
+                                      node.OpType() + " nodes sharing their input",
+                                      input_defs,
+                                      {&packed_output},
+                                      &attributes,
+                                      node.Domain());
+
+    TensorProto split_initializer_proto;
+    split_initializer_proto.set_name(graph.GenerateNodeArgName("splits"));
+    split_initializer_proto.set_data_type(TensorProto_DataType_INT64);
+    split_initializer_proto.add_dims(static_cast<int64_t>(split_values.size()));
+    split_initializer_proto.mutable_int64_data()->Add(split_values.begin(), split_values.end());
+    NodeArg* split_initializer_arg = &graph_utils::AddInitializer(graph, split_initializer_proto);
+
+    InlinedVector<NodeArg*> split_outputs;
+    for (const PackableNode& packable : packable_nodes) {
+      split_outputs.push_back(packable.node->MutableOutputDefs()[0]);
+    }
+    Node& split_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_split"), "Split",
+                                     "Split for packed " + node.OpType() + " nodes",
+                                     {&packed_output, split_initializer_arg}, split_outputs);
+    split_node.AddAttribute("axis", static_cast<int64_t>(-1));
+
+    // Assign provider to the new nodes. Provider should be same as the provider for old nodes.
+    packed_node.SetExecutionProviderType(node.GetExecutionProviderType());
+    split_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    for (const PackableNode& packable : packable_nodes) {
+      graph_utils::RemoveNodeOutputEdges(graph, *packable.node);
+      graph.RemoveNode(packable.node->Index());
+    }
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,38 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MatMulPacking
+
+Pack the MatMul or MatMulNBits nodes with constant weights that share their input A, e.g. the Q, K and V projections
+of an attention block or the gate and up projections of a gated MLP, into a single node followed by a Split on the
+last axis:
+
+      A                           A
+    /   \                         |
+  MatMul MatMul     ---->   MatMul(B = [B0 B1])
+    |      |                      |
+  gate    up                    Split
+                                /   \
+                              gate   up
+
+A is read once and the GEMM runs with a larger N. The weights of MatMul are concatenated along their columns. The
+weights, scales, zero points and biases of MatMulNBits, stored per output column, are concatenated along their first
+dimension; the nodes must have the same K, bits, block_size, accuracy_level and activation, and no g_idx or residual.
+*/
+class MatMulPacking : public GraphTransformer {
+ public:
+  MatMulPacking(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MatMulPacking", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
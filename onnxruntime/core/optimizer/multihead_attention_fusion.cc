@@ -0,0 +1,436 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/multihead_attention_fusion.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloatTensorOfRank(const NodeArg* arg, int rank) {
+  if (arg == nullptr || !arg->Exists()) {
+    return false;
+  }
+  const auto* type = arg->TypeAsProto();
+  const auto* shape = arg->Shape();
+  return type != nullptr && type->tensor_type().elem_type() == TensorProto_DataType_FLOAT &&
+         shape != nullptr && shape->dim_size() == rank;
+}
+
+// Returns the value of a dimension of arg, or -1 when it is symbolic or unknown.
+int64_t DimValue(const NodeArg& arg, int index) {
+  const auto& dim = arg.Shape()->dim(index);
+  return utils::HasDimValue(dim) ? dim.dim_value() : -1;
+}
+
+bool SameDim(const TensorShapeProto_Dimension& dim, const TensorShapeProto_Dimension& other) {
+  if (utils::HasDimValue(dim) && utils::HasDimValue(other)) {
+    return dim.dim_value() == other.dim_value();
+  }
+  return utils::HasDimParam(dim) && utils::HasDimParam(other) && dim.dim_param() == other.dim_param();
+}
+
+bool IsTranspose(const Node& node, const std::vector<int64_t>& perm) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1, 13, 21}) &&
+         optimizer_utils::IsAttributeWithExpectedValues(node, "perm", perm);
+}
+
+// Returns the index of the input of a Mul or Div that is a constant float scalar, or -1.
+int GetScalarConstantInput(const Graph& graph, const Node& node, float& value) {
+  const bool is_div = node.OpType() == "Div";
+  for (int i = is_div ? 1 : 0; i < 2; ++i) {
+    if (optimizer_utils::GetScalarInitializerValue<float>(graph, *node.InputDefs()[i], value, true)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Returns the (batch, sequence, hidden) input of a Reshape to (batch, sequence, heads, head_size), or nullptr.
+NodeArg* GetHiddenInputOfBsnh(Graph& graph, const NodeArg& bsnh, InlinedVector<NodeIndex>& input_nodes) {
+  Node* reshape = graph.GetMutableProducerNode(bsnh.Name());
+  if (reshape == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*reshape, "Reshape", {5, 13, 14, 19, 21}) ||
+      !IsFloatTensorOfRank(reshape->InputDefs()[0], 3) ||
+      !IsFloatTensorOfRank(reshape->OutputDefs()[0], 4)) {
+    return nullptr;
+  }
+
+  NodeArg* hidden = reshape->MutableInputDefs()[0];
+  const int64_t num_heads = DimValue(*reshape->OutputDefs()[0], 2);
+  const int64_t head_size = DimValue(*reshape->OutputDefs()[0], 3);
+  if (num_heads <= 0 || head_size <= 0 || DimValue(*hidden, 2) != num_heads * head_size) {
+    return nullptr;
+  }
+
+  input_nodes.push_back(reshape->Index());
+  return hidden;
+}
+
+// Returns the (batch, sequence, hidden) tensor that a tensor in (batch, heads, sequence, head_size) layout is
+// reshaped and transposed from, or nullptr.
+NodeArg* GetHiddenInputOfBnsh(Graph& graph, const NodeArg& bnsh, InlinedVector<NodeIndex>& input_nodes) {
+  Node* transpose = graph.GetMutableProducerNode(bnsh.Name());
+  if (transpose == nullptr || !IsTranspose(*transpose, {0, 2, 1, 3})) {
+    return nullptr;
+  }
+
+  InlinedVector<NodeIndex> nodes{transpose->Index()};
+  NodeArg* hidden = GetHiddenInputOfBsnh(graph, *transpose->InputDefs()[0], nodes);
+  if (hidden != nullptr) {
+    input_nodes.insert(input_nodes.end(), nodes.begin(), nodes.end());
+  }
+  return hidden;
+}
+
+// Returns the Concat of the past state and the new key or value along the sequence axis, or nullptr.
+Node* GetCacheConcat(Graph& graph, const NodeArg& bnsh) {
+  Node* concat = graph.GetMutableProducerNode(bnsh.Name());
+  if (concat == nullptr ||
+      !graph_utils::IsSupportedOptypeVersionAndDomain(*concat, "Concat", {4, 11, 13}) ||
+      concat->InputDefs().size() != 2 ||
+      !IsFloatTensorOfRank(concat->InputDefs()[0], 4) ||
+      !(optimizer_utils::IsAttributeWithExpectedValue(*concat, "axis", static_cast<int64_t>(2)) ||
+        optimizer_utils::IsAttributeWithExpectedValue(*concat, "axis", static_cast<int64_t>(-2)))) {
+    return nullptr;
+  }
+  return concat;
+}
+
+NodeArg& AddInt64Initializer(Graph& graph, const std::string& name, const InlinedVector<int64_t>& values) {
+  TensorProto initializer;
+  initializer.set_name(graph.GenerateNodeArgName(name));
+  initializer.set_data_type(TensorProto_DataType_INT64);
+  initializer.add_dims(static_cast<int64_t>(values.size()));
+  for (int64_t value : values) {
+    initializer.add_int64_data(value);
+  }
+  return graph_utils::AddInitializer(graph, initializer);
+}
+
+NodeArg& AddFloatNodeArg(Graph& graph, const std::string& name) {
+  TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(name), &float_type);
+}
+
+bool FuseAttention(Graph& graph, Node& softmax) {
+  const auto& provider = softmax.GetExecutionProviderType();
+  // nodes replaced by the MultiHeadAttention node
+  InlinedVector<NodeIndex> fused_nodes{softmax.Index()};
+  // nodes producing Q, K and V that are removed if nothing else reads their outputs
+  InlinedVector<NodeIndex> input_nodes;
+
+  auto is_fusable = [&](const Node* node) {
+    return node != nullptr && node->GetExecutionProviderType() == provider &&
+           optimizer_utils::CheckOutputEdges(graph, *node, 1);
+  };
+  auto next_node = [&](const Node& node) {
+    return graph.GetNode(node.OutputEdgesBegin()->GetNode().Index());
+  };
+
+  // Softmax -> MatMul with V -> Transpose to (B, S, N, H_v) -> Reshape to (B, S, N * H_v)
+  Node* pv_matmul = next_node(softmax);
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(*pv_matmul, "MatMul", {1, 9, 13}) ||
+      pv_matmul->InputDefs()[0] != softmax.OutputDefs()[0] || !is_fusable(pv_matmul)) {
+    return false;
+  }
+  Node* out_transpose = next_node(*pv_matmul);
+  if (!IsTranspose(*out_transpose, {0, 2, 1, 3}) || !is_fusable(out_transpose)) {
+    return false;
+  }
+  Node* out_reshape = next_node(*out_transpose);
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(*out_reshape, "Reshape", {5, 13, 14, 19, 21}) ||
+      out_reshape->GetExecutionProviderType() != provider ||
+      !IsFloatTensorOfRank(out_reshape->OutputDefs()[0], 3)) {
+    return false;
+  }
+  fused_nodes.insert(fused_nodes.end(), {pv_matmul->Index(), out_transpose->Index(), out_reshape->Index()});
+
+  // MatMul of Q and K' -> optional Mul or Div by a scalar -> optional Add of the mask -> Softmax
+  float scale = 1.0f;
+  NodeArg* mask = nullptr;
+  Node* node = graph.GetMutableProducerNode(softmax.InputDefs()[0]->Name());
+  if (node != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Add", {7, 13, 14}) &&
+      is_fusable(node)) {
+    Node* scores = nullptr;
+    for (int i = 0; i < 2 && scores == nullptr; ++i) {
+      Node* producer = graph.GetMutableProducerNode(node->InputDefs()[i]->Name());
+      if (producer != nullptr &&
+          (graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "MatMul", {1, 9, 13}) ||
+           graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Mul", {7, 13, 14}) ||
+           graph_utils::IsSupportedOptypeVersionAndDomain(*producer, "Div", {7, 13, 14}))) {
+        scores = producer;
+        mask = node->MutableInputDefs()[1 - i];
+      }
+    }
+    fused_nodes.push_back(node->Index());
+    node = scores;
+  }
+  if (node != nullptr &&
+      (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Mul", {7, 13, 14}) ||
+       graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Div", {7, 13, 14})) &&
+      is_fusable(node)) {
+    float value = 0.0f;
+    const int index = GetScalarConstantInput(graph, *node, value);
+    if (index < 0 || value == 0.0f) {
+      return false;
+    }
+    scale = node->OpType() == "Div" ? scale / value : scale * value;
+    fused_nodes.push_back(node->Index());
+    node = graph.GetMutableProducerNode(node->InputDefs()[1 - index]->Name());
+  }
+  if (node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "MatMul", {1, 9, 13}) ||
+      !is_fusable(node)) {
+    return false;
+  }
+  Node& qk_matmul = *node;
+  fused_nodes.push_back(qk_matmul.Index());
+
+  // The scale may also be split between Q and K', as in the export of scaled_dot_product_attention.
+  NodeArg* q_heads = qk_matmul.MutableInputDefs()[0];
+  NodeArg* k_transposed = qk_matmul.MutableInputDefs()[1];
+  for (NodeArg** arg : {&q_heads, &k_transposed}) {
+    Node* mul = graph.GetMutableProducerNode((*arg)->Name());
+    float value = 0.0f;
+    int index = -1;
+    if (mul != nullptr && graph_utils::IsSupportedOptypeVersionAndDomain(*mul, "Mul", {7, 13, 14}) &&
+        is_fusable(mul) && (index = GetScalarConstantInput(graph, *mul, value)) >= 0) {
+      scale *= value;
+      fused_nodes.push_back(mul->Index());
+      *arg = mul->MutableInputDefs()[1 - index];
+    }
+  }
+
+  if (!IsFloatTensorOfRank(q_heads, 4)) {
+    return false;
+  }
+  const int64_t num_heads = DimValue(*q_heads, 1);
+  const int64_t head_size = DimValue(*q_heads, 3);
+  if (num_heads <= 0 || head_size <= 0) {
+    return false;
+  }
+
+  // K' is (B, N, H, L): K in (B, N, L, H) transposed, or the (B, L, N, H) projection transposed
+  Node* k_transpose = graph.GetMutableProducerNode(k_transposed->Name());
+  if (!is_fusable(k_transpose)) {
+    return false;
+  }
+  NodeArg* k_heads = nullptr;
+  NodeArg* k_hidden = nullptr;
+  if (IsTranspose(*k_transpose, {0, 1, 3, 2})) {
+    k_heads = k_transpose->MutableInputDefs()[0];
+  } else if (IsTranspose(*k_transpose, {0, 2, 3, 1})) {
+    k_hidden = GetHiddenInputOfBsnh(graph, *k_transpose->InputDefs()[0], input_nodes);
+    if (k_hidden == nullptr) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  fused_nodes.push_back(k_transpose->Index());
+  NodeArg* v_heads = pv_matmul->MutableInputDefs()[1];
+
+  // K and V appended to the cache become the past and present of the fused node.
+  NodeArg* past_key = nullptr;
+  NodeArg* past_value = nullptr;
+  NodeArg* present_key = nullptr;
+  NodeArg* present_value = nullptr;
+  Node* k_concat = k_heads != nullptr ? GetCacheConcat(graph, *k_heads) : nullptr;
+  Node* v_concat = GetCacheConcat(graph, *v_heads);
+  if (k_concat != nullptr || v_concat != nullptr) {
+    if (k_concat == nullptr || v_concat == nullptr || k_concat->GetExecutionProviderType() != provider ||
+        v_concat->GetExecutionProviderType() != provider) {
+      return false;
+    }
+    past_key = k_concat->MutableInputDefs()[0];
+    past_value = v_concat->MutableInputDefs()[0];
+    present_key = k_heads;
+    present_value = v_heads;
+    k_heads = k_concat->MutableInputDefs()[1];
+    v_heads = v_concat->MutableInputDefs()[1];
+    fused_nodes.insert(fused_nodes.end(), {k_concat->Index(), v_concat->Index()});
+  }
+
+  if (k_hidden == nullptr) {
+    k_hidden = GetHiddenInputOfBnsh(graph, *k_heads, input_nodes);
+  }
+  NodeArg* v_hidden = GetHiddenInputOfBnsh(graph, *v_heads, input_nodes);
+
+  NodeArg* key = nullptr;
+  NodeArg* value = nullptr;
+  int64_t v_hidden_size = -1;
+  if (k_hidden != nullptr && v_hidden != nullptr) {
+    if (DimValue(*k_hidden, 2) != num_heads * head_size) {
+      return false;
+    }
+    key = k_hidden;
+    value = v_hidden;
+    v_hidden_size = DimValue(*v_hidden, 2);
+  } else if (past_key == nullptr && IsFloatTensorOfRank(k_heads, 4) && IsFloatTensorOfRank(v_heads, 4) &&
+             DimValue(*k_heads, 1) == num_heads && DimValue(*k_heads, 3) == head_size &&
+             DimValue(*v_heads, 1) == num_heads && DimValue(*v_heads, 3) > 0) {
+    // MultiHeadAttention reads K and V in (B, N, L, H) layout when there is no cache
+    input_nodes.clear();
+    key = k_heads;
+    value = v_heads;
+    v_hidden_size = num_heads * DimValue(*v_heads, 3);
+  } else {
+    return false;
+  }
+  if (DimValue(*out_reshape->OutputDefs()[0], 2) != v_hidden_size) {
+    return false;
+  }
+
+  // The mask is added to the scores of every head: it must be (B or 1, N or 1, S, T).
+  if (mask != nullptr) {
+    const NodeArg& scores = *qk_matmul.OutputDefs()[0];
+    if (!IsFloatTensorOfRank(mask, 4) || !IsFloatTensorOfRank(&scores, 4)) {
+      return false;
+    }
+    const auto& mask_shape = *mask->Shape();
+    const auto& scores_shape = *scores.Shape();
+    if ((DimValue(*mask, 0) != 1 && !SameDim(mask_shape.dim(0), scores_shape.dim(0))) ||
+        (DimValue(*mask, 1) != 1 && DimValue(*mask, 1) != num_heads) ||
+        !SameDim(mask_shape.dim(2), scores_shape.dim(2)) ||
+        !SameDim(mask_shape.dim(3), scores_shape.dim(3))) {
+      return false;
+    }
+  }
+
+  // The pattern matches, the graph is modified from here on.
+  const std::string& name = softmax.Name();
+  NodeArg* query = GetHiddenInputOfBnsh(graph, *q_heads, input_nodes);
+  if (query == nullptr) {
+    // Q is only available in (B, N, S, H) layout, e.g. after a rotary embedding
+    NodeArg& q_bsnh = AddFloatNodeArg(graph, name + "_query_bsnh");
+    query = &AddFloatNodeArg(graph, name + "_query");
+    Node& transpose = graph.AddNode(graph.GenerateNodeName(name + "_QueryTranspose"), "Transpose", "",
+                                    {q_heads}, {&q_bsnh});
+    transpose.AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    transpose.SetExecutionProviderType(provider);
+    NodeArg& shape = AddInt64Initializer(graph, name + "_query_shape", {0, 0, num_heads * head_size});
+    Node& reshape = graph.AddNode(graph.GenerateNodeName(name + "_QueryReshape"), "Reshape", "",
+                                  {&q_bsnh, &shape}, {query});
+    reshape.SetExecutionProviderType(provider);
+  }
+
+  if (mask != nullptr && DimValue(*mask, 1) != num_heads) {
+    // MultiHeadAttention takes a bias per head
+    NodeArg& shape = AddInt64Initializer(graph, name + "_mask_shape", {1, num_heads, 1, 1});
+    NodeArg* expanded_mask = &AddFloatNodeArg(graph, name + "_mask_expanded");
+    Node& expand = graph.AddNode(graph.GenerateNodeName(name + "_MaskExpand"), "Expand", "",
+                                 {mask, &shape}, {expanded_mask});
+    expand.SetExecutionProviderType(provider);
+    mask = expanded_mask;
+  }
+
+  NodeArg& empty = graph.GetOrCreateNodeArg("", nullptr);
+  InlinedVector<NodeArg*> mha_inputs{query, key, value, &empty, &empty, mask != nullptr ? mask : &empty};
+  InlinedVector<NodeArg*> mha_outputs{out_reshape->MutableOutputDefs()[0]};
+  if (past_key != nullptr) {
+    mha_inputs.insert(mha_inputs.end(), {past_key, past_value});
+    mha_outputs.insert(mha_outputs.end(), {present_key, present_value});
+  }
+
+  Node& mha_node = graph.AddNode(graph.GenerateNodeName(name + "_MultiHeadAttention"),
+                                 "MultiHeadAttention",
+                                 "fused scaled dot product attention",
+                                 mha_inputs,
+                                 mha_outputs,
+                                 nullptr,
+                                 kMSDomain);
+  mha_node.AddAttribute("num_heads", num_heads);
+  mha_node.AddAttribute("scale", scale);
+
+  // Assign provider to this new node. Provider should be same as the provider for old node.
+  mha_node.SetExecutionProviderType(provider);
+
+  for (NodeIndex index : fused_nodes) {
+    Node& fused_node = *graph.GetNode(index);
+    graph_utils::RemoveNodeOutputEdges(graph, fused_node);
+    graph.RemoveNode(index);
+  }
+
+  // the projections are reshaped and transposed only for the fused nodes
+  for (NodeIndex index : input_nodes) {
+    Node* input_node = graph.GetNode(index);
+    if (input_node != nullptr && input_node->GetOutputEdgesCount() == 0 &&
+        !graph.NodeProducesGraphOutput(*input_node) &&
+        std::find(mha_inputs.begin(), mha_inputs.end(), input_node->OutputDefs()[0]) == mha_inputs.end()) {
+      graph.RemoveNode(index);
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
+
+/**
+MultiHeadAttentionFusion fuses the attention of a layer exported from PyTorch:
+
+      Q (B, N, S, H)       K (B, N, L, H)
+          |                    |
+      [Mul(scale)]    Transpose(0, 1, 3, 2)        [past_key] and [past_value] may be concatenated
+           \              [Mul(scale)]             to K and V along the sequence axis
+            \              /
+               MatMul
+                 |
+          [Mul/Div(scale)]
+                 |
+           [Add(mask)]
+                 |
+              Softmax         V (B, N, L, H_v)
+                   \           /
+                      MatMul
+                        |
+               Transpose(0, 2, 1, 3)
+                        |
+               Reshape (B, S, N * H_v)
+
+into MultiHeadAttention(query, key, value, relative_position_bias=mask, past_key, past_value).
+When Q, K and V are reshaped and transposed from (B, S, D) projections, the projections are the inputs.
+*/
+Status MultiHeadAttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                           const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& softmax = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(softmax, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax, "Softmax", {1, 11, 13}) ||
+        !graph_utils::IsSupportedProvider(softmax, GetCompatibleExecutionProviders()) ||
+        !optimizer_utils::CheckOutputEdges(graph, softmax, 1) ||
+        !IsFloatTensorOfRank(softmax.InputDefs()[0], 4)) {
+      continue;
+    }
+
+    // before opset 13 the default axis is 1, and any axis flattens the trailing dimensions
+    const auto& attributes = softmax.GetAttributes();
+    const auto axis_attr = attributes.find("axis");
+    const int64_t axis = axis_attr != attributes.end() ? axis_attr->second.i() : (softmax.SinceVersion() >= 13 ? -1 : 1);
+    if (axis != -1 && axis != 3) {
+      continue;
+    }
+
+    if (FuseAttention(graph, softmax)) {
+      modified = true;
+    }
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
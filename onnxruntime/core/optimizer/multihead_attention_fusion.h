@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MultiHeadAttentionFusion
+
+Fuse the scaled dot product attention subgraph exported by recent PyTorch versions (MatMul of Q and transposed K,
+optional scaling and additive mask, Softmax, MatMul with V, then back to (batch, sequence, hidden)) into a
+com.microsoft.MultiHeadAttention node. Q, K and V may come from the (batch, sequence, hidden) projections or be
+given in (batch, heads, sequence, head_size) layout, e.g. after a rotary embedding. K and V concatenated to
+past_key/past_value along the sequence axis become the past and present inputs and outputs of the fused node.
+*/
+class MultiHeadAttentionFusion : public GraphTransformer {
+ public:
+  MultiHeadAttentionFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MultiHeadAttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
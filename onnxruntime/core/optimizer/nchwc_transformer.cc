@@ -11,9 +11,181 @@ using namespace ONNX_NAMESPACE;
 using namespace ::onnxruntime::common;
 namespace onnxruntime {
 
+namespace {
+
+// Relative costs of the layout cost model, in units of the time of a multiply-add of a NCHW convolution. The NCHWc
+// kernels save a fraction of this time, while reordering a tensor between layouts is bound by memory bandwidth.
+constexpr double kNchwcConvGainPerMac = 0.25;
+constexpr double kNchwcPoolGainPerElement = 1.0;
+constexpr double kReorderCostPerElement = 16.0;
+
+bool IsNchwcAnchor(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "MaxPool", {1, 8, 10, 11, 12}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "AveragePool", {1, 7, 10, 11});
+}
+
+// Nodes that are converted to NCHWc only when their inputs are produced in NCHWc format.
+bool IsNchwcFollower(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sum", {6, 8, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "BatchNormalization", {7, 9, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Upsample", {9, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Resize", {10, 11, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalMaxPool", {1}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "GlobalAveragePool", {1});
+}
+
+// Returns the number of elements of a tensor with a static shape, or -1.
+int64_t NumElements(const NodeArg& arg) {
+  const auto* shape = arg.Shape();
+  if (shape == nullptr) {
+    return -1;
+  }
+  int64_t size = 1;
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return -1;
+    }
+    size *= dim.dim_value();
+  }
+  return size;
+}
+
+/*
+Estimates, for each region of connected nodes that the NCHWc transformer may convert, the time saved by the NCHWc
+kernels against the time spent reordering the tensors entering and leaving the region, and returns the Conv and
+pooling nodes of the regions where the reorders cost more than they save. Regions with tensors of unknown size are
+always converted, as the transformer does without the cost model.
+*/
+InlinedHashSet<NodeIndex> GetUnprofitableNchwcNodes(const Graph& graph) {
+  InlinedHashMap<NodeIndex, NodeIndex> parents;
+  for (const auto& node : graph.Nodes()) {
+    if (node.GetExecutionProviderType() == kCpuExecutionProvider && (IsNchwcAnchor(node) || IsNchwcFollower(node))) {
+      parents.emplace(node.Index(), node.Index());
+    }
+  }
+
+  auto find_region = [&parents](NodeIndex index) {
+    while (parents[index] != index) {
+      parents[index] = parents[parents[index]];
+      index = parents[index];
+    }
+    return index;
+  };
+  auto in_region = [&](const Node* node, NodeIndex region) {
+    return node != nullptr && parents.count(node->Index()) != 0 && find_region(node->Index()) == region;
+  };
+
+  for (const auto& node : graph.Nodes()) {
+    if (parents.count(node.Index()) == 0) {
+      continue;
+    }
+    for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+      if (parents.count(it->Index()) != 0) {
+        parents[find_region(it->Index())] = find_region(node.Index());
+      }
+    }
+  }
+
+  struct Region {
+    double gain = 0.0;
+    double cost = 0.0;
+    bool unknown_size = false;
+    InlinedVector<NodeIndex> anchors;
+  };
+  InlinedHashMap<NodeIndex, Region> regions;
+  InlinedHashSet<const NodeArg*> reordered_args;
+  const int64_t nchwc_block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+
+  auto add_reorder = [&](Region& region, const NodeArg& arg) {
+    const auto* shape = arg.Shape();
+    if (shape != nullptr && shape->dim_size() != 4) {
+      return;  // only 4D tensors are reordered, other operands are broadcast as is
+    }
+    if (reordered_args.insert(&arg).second) {
+      const int64_t size = NumElements(arg);
+      region.unknown_size = region.unknown_size || size < 0;
+      region.cost += static_cast<double>(size) * kReorderCostPerElement;
+    }
+  };
+
+  for (const auto& node : graph.Nodes()) {
+    if (parents.count(node.Index()) == 0) {
+      continue;
+    }
+    const NodeIndex region_index = find_region(node.Index());
+    Region& region = regions[region_index];
+    const bool is_conv = node.OpType() == "Conv" || node.OpType() == "FusedConv";
+    bool reorders_input = true;
+
+    if (IsNchwcAnchor(node)) {
+      region.anchors.push_back(node.Index());
+      const int64_t output_size = NumElements(*node.OutputDefs()[0]);
+      const ONNX_NAMESPACE::TensorProto* weights = nullptr;
+      if (is_conv) {
+        if (output_size < 0 || !graph.GetInitializedTensor(node.InputDefs()[1]->Name(), weights) ||
+            weights->dims_size() != 4) {
+          region.unknown_size = true;
+        } else {
+          region.gain += static_cast<double>(output_size * weights->dims(1) * weights->dims(2) * weights->dims(3)) *
+                         kNchwcConvGainPerMac;
+          // the first convolution of a network with few input channels reads the NCHW input directly
+          const auto* group_attr = graph_utils::GetNodeAttribute(node, "group");
+          const bool grouped = group_attr != nullptr && utils::HasInt(*group_attr) && group_attr->i() > 1;
+          reorders_input = grouped || weights->dims(1) >= nchwc_block_size;
+        }
+      } else {
+        region.unknown_size = region.unknown_size || output_size < 0;
+        region.gain += static_cast<double>(output_size) * kNchwcPoolGainPerElement;
+      }
+    }
+
+    const auto& input_defs = node.InputDefs();
+    const size_t activation_inputs = is_conv ? 1 : input_defs.size();
+    for (size_t i = 0; i < activation_inputs && reorders_input; ++i) {
+      const NodeArg& input = *input_defs[i];
+      if (!input.Exists() || graph_utils::NodeArgIsConstant(graph, input)) {
+        continue;
+      }
+      if (!in_region(graph.GetProducerNode(input.Name()), region_index)) {
+        add_reorder(region, input);
+      }
+    }
+
+    for (const NodeArg* output : node.OutputDefs()) {
+      bool leaves_region = graph.IsOutput(output);
+      for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end && !leaves_region; ++it) {
+        leaves_region = node.OutputDefs()[it->GetSrcArgIndex()] == output && !in_region(&it->GetNode(), region_index);
+      }
+      if (leaves_region) {
+        add_reorder(region, *output);
+      }
+    }
+  }
+
+  InlinedHashSet<NodeIndex> unprofitable_nodes;
+  for (const auto& entry : regions) {
+    const Region& region = entry.second;
+    if (!region.unknown_size && region.cost > region.gain) {
+      unprofitable_nodes.insert(region.anchors.begin(), region.anchors.end());
+    }
+  }
+  return unprofitable_nodes;
+}
+
+}  // namespace
+
 class NchwcTransformerImpl {
  public:
-  NchwcTransformerImpl(Graph& graph) noexcept : graph_(graph) {}
+  NchwcTransformerImpl(Graph& graph, InlinedHashSet<NodeIndex> excluded_nodes) noexcept
+      : graph_(graph), excluded_nodes_(std::move(excluded_nodes)) {}
 
   void Transform(Node& node);
   void Finalize(bool& modified);
@@ -131,6 +303,9 @@ class NchwcTransformerImpl {
 
   Graph& graph_;
 
+  // Stores the Conv and pooling nodes that the layout cost model keeps in NCHW format.
+  const InlinedHashSet<NodeIndex> excluded_nodes_;
+
   // Stores a queue of nodes to be removed after walking through the graph.
   std::deque<NodeIndex> removed_nodes_;
 
@@ -1145,6 +1320,10 @@ void NchwcTransformerImpl::Transform(Node& node) {
     TrackTransposeFromNhwc(node);
   }
 
+  if (excluded_nodes_.count(node.Index()) != 0) {
+    return;
+  }
+
   if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Conv", {1, 11}) ||
       graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedConv", {1}, kMSDomain)) {
     TransformConv(node);
@@ -1219,7 +1398,8 @@ void NchwcTransformerImpl::Finalize(bool& modified) {
 }
 
 Status NchwcTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
-  NchwcTransformerImpl impl(graph);
+  NchwcTransformerImpl impl(graph, use_layout_cost_model_ ? GetUnprofitableNchwcNodes(graph)
+                                                         : InlinedHashSet<NodeIndex>{});
   GraphViewer graph_viewer(graph);
 
   for (auto index : graph_viewer.GetNodesInTopologicalOrder()) {
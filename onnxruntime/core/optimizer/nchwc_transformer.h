@@ -13,13 +13,21 @@ namespace onnxruntime {
 
 Transformer that optimizes the graph by using NCHWc nodes instead of NCHW nodes
 and inserts nodes to reorder tensors as needed.
+
+If use_layout_cost_model is set, the Conv and pooling nodes of a region of nodes
+that would be converted together are kept in NCHW format when the estimated cost
+of the reorders at the boundaries of the region exceeds the estimated speedup of
+the NCHWc kernels.
 */
 class NchwcTransformer : public GraphTransformer {
  public:
-  NchwcTransformer() noexcept : GraphTransformer("NchwcTransformer") {}
+  NchwcTransformer(bool use_layout_cost_model = false) noexcept
+      : GraphTransformer("NchwcTransformer"), use_layout_cost_model_(use_layout_cost_model) {}
 
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const bool use_layout_cost_model_;
 };
 
 }  // namespace onnxruntime
@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/nhwc_depthwise_pointwise_fusion.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloatNhwcFusedConv(const Node& node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "NhwcFusedConv", {1}, kMSDomain)) {
+    return false;
+  }
+
+  const auto* type = node.InputDefs()[0]->TypeAsProto();
+  return type != nullptr && type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool HasInput(const Node& node, size_t index) {
+  const auto& input_defs = node.InputDefs();
+  return index < input_defs.size() && input_defs[index]->Exists();
+}
+
+// Returns the constant filter shape of a convolution, or nullptr if the filter isn't a constant
+// with a fully known shape.
+const TensorShapeProto* GetConstantFilterShape(const Graph& graph, const Node& node) {
+  const NodeArg* W = node.InputDefs()[1];
+  if (!graph_utils::NodeArgIsConstant(graph, *W)) {
+    return nullptr;
+  }
+
+  const auto* shape = W->Shape();
+  if (shape == nullptr || shape->dim_size() <= 2) {
+    return nullptr;
+  }
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim)) {
+      return nullptr;
+    }
+  }
+  return shape;
+}
+
+bool AllAttributeValuesEqual(const Node& node, const std::string& name, int64_t value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  if (attr == nullptr) {
+    return true;
+  }
+  for (int64_t v : attr->ints()) {
+    if (v != value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int64_t GetGroup(const Node& node) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, "group");
+  return attr != nullptr ? attr->i() : 1;
+}
+
+// Depthwise convolution with a channel multiplier of 1, whose output isn't added to another tensor.
+bool IsDepthwiseConv(const Graph& graph, const Node& node) {
+  if (!IsFloatNhwcFusedConv(node) || HasInput(node, 3)) {
+    return false;
+  }
+
+  const auto* shape = GetConstantFilterShape(graph, node);
+  return shape != nullptr && shape->dim(1).dim_value() == 1 && GetGroup(node) == shape->dim(0).dim_value();
+}
+
+// Pointwise convolution over the channels of the depthwise convolution.
+bool IsPointwiseConv(const Graph& graph, const Node& node, int64_t input_channels, int rank) {
+  if (!IsFloatNhwcFusedConv(node) || GetGroup(node) != 1) {
+    return false;
+  }
+
+  const auto* shape = GetConstantFilterShape(graph, node);
+  if (shape == nullptr || shape->dim_size() != rank || shape->dim(1).dim_value() != input_channels) {
+    return false;
+  }
+  for (int i = 2; i < rank; i++) {
+    if (shape->dim(i).dim_value() != 1) {
+      return false;
+    }
+  }
+
+  return AllAttributeValuesEqual(node, "strides", 1) && AllAttributeValuesEqual(node, "pads", 0);
+}
+
+}  // namespace
+
+Status NhwcDepthwisePointwiseFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                               const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto index : order) {
+    auto* node_ptr = graph.GetNode(index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& dw_node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(dw_node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedProvider(dw_node, GetCompatibleExecutionProviders()) ||
+        !IsDepthwiseConv(graph, dw_node) ||
+        dw_node.GetOutputEdgesCount() != 1 ||
+        graph.NodeProducesGraphOutput(dw_node)) {
+      continue;
+    }
+
+    const Node& next_node = *(dw_node.OutputNodesBegin());
+    const auto* dw_shape = dw_node.InputDefs()[1]->Shape();
+    if (next_node.GetExecutionProviderType() != dw_node.GetExecutionProviderType() ||
+        next_node.InputDefs()[0] != dw_node.OutputDefs()[0] ||
+        !IsPointwiseConv(graph, next_node, dw_shape->dim(0).dim_value(), dw_shape->dim_size())) {
+      continue;
+    }
+
+    Node& pw_node = *graph.GetNode(next_node.Index());  // get mutable reference
+
+    auto& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+    auto& dw_inputs = dw_node.MutableInputDefs();
+    auto& pw_inputs = pw_node.MutableInputDefs();
+    std::vector<NodeArg*> fused_inputs{
+        dw_inputs[0],
+        dw_inputs[1],
+        HasInput(dw_node, 2) ? dw_inputs[2] : &empty_arg,
+        pw_inputs[1],
+        HasInput(pw_node, 2) ? pw_inputs[2] : &empty_arg,
+    };
+    if (HasInput(pw_node, 3)) {
+      fused_inputs.push_back(pw_inputs[3]);
+    }
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(dw_node.Name() + "_" + pw_node.Name()),
+                                     "NhwcFusedDepthwisePointwiseConv",
+                                     "fused depthwise " + dw_node.Name() + " and pointwise " + pw_node.Name(),
+                                     fused_inputs, {}, nullptr, kMSDomain);
+    fused_node.SetExecutionProviderType(dw_node.GetExecutionProviderType());
+
+    // The convolution attributes are the ones of the depthwise convolution, its activation is
+    // renamed, and the activation of the pointwise convolution is kept as is.
+    for (const auto& attr : dw_node.GetAttributes()) {
+      AttributeProto fused_attr(attr.second);
+      if (attr.first == "activation" || attr.first == "activation_params") {
+        fused_attr.set_name("dw_" + attr.first);
+      }
+      fused_node.AddAttributeProto(std::move(fused_attr));
+    }
+    for (const auto& attr : pw_node.GetAttributes()) {
+      if (attr.first == "activation" || attr.first == "activation_params") {
+        fused_node.AddAttributeProto(AttributeProto(attr.second));
+      }
+    }
+
+    // Z may be produced by another node. Its edge to pw_node isn't moved by FinalizeNodeFusion.
+    if (HasInput(pw_node, 3)) {
+      for (auto it = pw_node.InputEdgesBegin(), end = pw_node.InputEdgesEnd(); it != end; ++it) {
+        if (it->GetDstArgIndex() == 3) {
+          graph.AddEdge(it->GetNode().Index(), fused_node.Index(), it->GetSrcArgIndex(), 5);
+          break;
+        }
+      }
+    }
+
+    // move input edges of dw_node and output definitions and edges of pw_node to fused_node.
+    // delete dw_node and pw_node.
+    graph_utils::FinalizeNodeFusion(graph, {dw_node, pw_node}, fused_node, fused_node);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
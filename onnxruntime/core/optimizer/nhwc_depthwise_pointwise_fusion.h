@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class NhwcDepthwisePointwiseFusion
+
+Fuses a depthwise fp32 NhwcFusedConv with the pointwise (1x1) NhwcFusedConv consuming its output
+into a NhwcFusedDepthwisePointwiseConv, which computes the pointwise convolution on tiles of the
+depthwise output without materializing the intermediate tensor.
+
+It runs after the NhwcTransformer, which produces the NhwcFusedConv nodes.
+*/
+class NhwcDepthwisePointwiseFusion : public GraphTransformer {
+ public:
+  NhwcDepthwisePointwiseFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("NhwcDepthwisePointwiseFusion", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
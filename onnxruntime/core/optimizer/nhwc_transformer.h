@@ -75,7 +75,12 @@ and inserts nodes to transpose tensors as needed.
 class NhwcTransformer : public GraphTransformer {
  private:
  public:
-  explicit NhwcTransformer(AllocatorPtr cpu_allocator, std::shared_ptr<KernelRegistry> cpu_kernel_registry) noexcept;
+  /**
+   * @param enable_fp32 Also transform fp32 Conv, FusedConv and pooling operators. The NCHWc
+   *        transformer is expected to be disabled in that case, as it would claim them first.
+   */
+  explicit NhwcTransformer(AllocatorPtr cpu_allocator, std::shared_ptr<KernelRegistry> cpu_kernel_registry,
+                           bool enable_fp32 = false) noexcept;
 
   /**
    * @brief Usually called right after constructor, it shows whether
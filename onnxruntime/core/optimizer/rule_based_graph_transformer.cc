@@ -43,6 +43,10 @@ Status RuleBasedGraphTransformer::ApplyImpl(Graph& graph, bool& modified, int gr
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
 
+  // the rules only modify the graph of the node they are applied to, so the subgraphs are transformed together once
+  // the rules have been applied to the nodes of this graph
+  InlinedVector<NodeIndex> nodes_with_subgraphs;
+
   for (NodeIndex i : order) {
     auto* node = graph.GetNode(i);
     // A node might not be found as it might have already been deleted from one of the rules.
@@ -80,12 +84,21 @@ Status RuleBasedGraphTransformer::ApplyImpl(Graph& graph, bool& modified, int gr
       modified = true;
     }
 
-    if (rule_effect != RuleEffect::kRemovedCurrentNode) {
-      ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+    if (rule_effect != RuleEffect::kRemovedCurrentNode && node->ContainsSubgraph()) {
+      nodes_with_subgraphs.push_back(i);
     }
   }
 
-  return Status::OK();
+  // a node may have been removed by the rules applied to a later node
+  InlinedVector<Node*> nodes;
+  nodes.reserve(nodes_with_subgraphs.size());
+  for (NodeIndex i : nodes_with_subgraphs) {
+    if (auto* node = graph.GetNode(i)) {
+      nodes.push_back(node);
+    }
+  }
+
+  return RecurseConcurrently(nodes, modified, graph_level, logger);
 }
 
 size_t RuleBasedGraphTransformer::RulesCount() const {
@@ -0,0 +1,454 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/shape_compute_fusion.h"
+
+#include <algorithm>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Largest number of elements of the int64 tensors evaluated symbolically.
+constexpr int64_t kMaxShapeValueSize = 16;
+
+// An instruction of ShapeCompute. The instructions of all the values of the graph are kept in a single list, in which
+// the operands of an instruction always come before it.
+struct Instruction {
+  std::string op;
+  int64_t a;
+  int64_t b;
+  const NodeArg* input;  // for Dim
+};
+
+class ShapeExpressions {
+ public:
+  int Dim(const NodeArg& input, int64_t axis) {
+    const auto* shape = input.Shape();
+    if (shape != nullptr && axis < shape->dim_size() && utils::HasDimValue(shape->dim(static_cast<int>(axis)))) {
+      return Const(shape->dim(static_cast<int>(axis)).dim_value());
+    }
+    return Add("Dim," + input.Name() + "," + std::to_string(axis), {"Dim", -1, axis, &input});
+  }
+
+  int Const(int64_t value) {
+    return Add("Const," + std::to_string(value), {"Const", value, -1, nullptr});
+  }
+
+  int Binary(const std::string& op, int a, int b) {
+    const bool a_const = IsConst(a);
+    const bool b_const = IsConst(b);
+    if (a_const && b_const) {
+      const int64_t x = instructions_[a].a;
+      const int64_t y = instructions_[b].a;
+      if (op == "Add") return Const(x + y);
+      if (op == "Sub") return Const(x - y);
+      if (op == "Mul") return Const(x * y);
+      if (op == "Div" && y != 0) return Const(x / y);
+    }
+    if ((op == "Add" || op == "Sub") && b_const && instructions_[b].a == 0) return a;
+    if ((op == "Mul" || op == "Div") && b_const && instructions_[b].a == 1) return a;
+    if (op == "Add" && a_const && instructions_[a].a == 0) return b;
+    if (op == "Mul" && a_const && instructions_[a].a == 1) return b;
+    return Add(op + "," + std::to_string(a) + "," + std::to_string(b), {op, a, b, nullptr});
+  }
+
+  bool IsConst(int index) const { return instructions_[index].op == "Const"; }
+
+  int64_t ConstValue(int index) const { return instructions_[index].a; }
+
+  const Instruction& operator[](int index) const { return instructions_[index]; }
+
+ private:
+  int Add(const std::string& key, Instruction instruction) {
+    auto it = indices_.find(key);
+    if (it != indices_.end()) {
+      return it->second;
+    }
+    instructions_.push_back(std::move(instruction));
+    const int index = static_cast<int>(instructions_.size() - 1);
+    indices_.emplace(key, index);
+    return index;
+  }
+
+  InlinedVector<Instruction> instructions_;
+  InlinedHashMap<std::string, int> indices_;
+};
+
+// A small int64 tensor whose elements are expressions of the dimensions of other tensors.
+struct ShapeValue {
+  InlinedVector<int> elements;
+  bool scalar = false;
+};
+
+// Node based, so that the values of the inputs of a node stay in place while the others are added.
+using ShapeValues = NodeHashMap<const NodeArg*, ShapeValue>;
+
+// The shape value of an input of a node: the result of a node evaluated before, or a small constant.
+const ShapeValue* GetShapeValue(const Graph& graph, const NodeArg* arg, ShapeExpressions& expressions,
+                                ShapeValues& values) {
+  if (arg == nullptr || !arg->Exists()) {
+    return nullptr;
+  }
+  auto it = values.find(arg);
+  if (it != values.end()) {
+    return &it->second;
+  }
+
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg->Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_INT64 ||
+      tensor_proto->dims_size() > 1 || (tensor_proto->dims_size() == 1 && tensor_proto->dims(0) > kMaxShapeValueSize)) {
+    return nullptr;
+  }
+  Initializer initializer{*tensor_proto, graph.ModelPath()};
+  ShapeValue value;
+  value.scalar = tensor_proto->dims_size() == 0;
+  for (int64_t element : initializer.DataAsSpan<int64_t>()) {
+    value.elements.push_back(expressions.Const(element));
+  }
+  return &values.emplace(arg, std::move(value)).first->second;
+}
+
+// The values of a shape value whose elements are all constants.
+bool GetConstants(const ShapeValue* value, const ShapeExpressions& expressions, InlinedVector<int64_t>& constants) {
+  if (value == nullptr) {
+    return false;
+  }
+  constants.clear();
+  for (int element : value->elements) {
+    if (!expressions.IsConst(element)) {
+      return false;
+    }
+    constants.push_back(expressions.ConstValue(element));
+  }
+  return true;
+}
+
+// Whether the axes of Unsqueeze or Squeeze, from the attribute or the input depending on the opset, are absent or
+// the single axis of a 1D tensor.
+bool HasFirstAxisOnly(const Graph& graph, const Node& node, ShapeExpressions& expressions, ShapeValues& values) {
+  InlinedVector<int64_t> axes;
+  if (node.SinceVersion() < 13) {
+    if (const auto* attr = graph_utils::GetNodeAttribute(node, "axes"); attr != nullptr) {
+      axes.assign(attr->ints().begin(), attr->ints().end());
+    }
+  } else if (node.InputDefs().size() > 1 && node.InputDefs()[1]->Exists() &&
+             !GetConstants(GetShapeValue(graph, node.InputDefs()[1], expressions, values), expressions, axes)) {
+    return false;
+  }
+  return axes.empty() || (axes.size() == 1 && (axes[0] == 0 || axes[0] == -1));
+}
+
+// Evaluates the output of a node as a shape value. Returns false if the node is not part of a shape computation.
+bool EvaluateNode(const Graph& graph, const Node& node, ShapeExpressions& expressions, ShapeValues& values,
+                  ShapeValue& result) {
+  if (node.OutputDefs().size() != 1) {
+    return false;
+  }
+  const auto* output_type = node.OutputDefs()[0]->TypeAsProto();
+  if (output_type == nullptr || output_type->tensor_type().elem_type() != TensorProto_DataType_INT64) {
+    return false;
+  }
+
+  const auto& inputs = node.InputDefs();
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Shape", {1, 13, 15, 19, 21})) {
+    const auto* shape = inputs[0]->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+    const int64_t rank = shape->dim_size();
+    auto get_bound = [&](const char* name, int64_t default_value) {
+      const auto* attr = graph_utils::GetNodeAttribute(node, name);
+      int64_t bound = attr != nullptr ? attr->i() : default_value;
+      bound = bound < 0 ? bound + rank : bound;
+      return std::clamp<int64_t>(bound, 0, rank);
+    };
+    for (int64_t axis = get_bound("start", 0), end = get_bound("end", rank); axis < end; ++axis) {
+      result.elements.push_back(expressions.Dim(*inputs[0], axis));
+    }
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11, 13})) {
+    const ShapeValue* data = GetShapeValue(graph, inputs[0], expressions, values);
+    InlinedVector<int64_t> indices;
+    const auto* axis = graph_utils::GetNodeAttribute(node, "axis");
+    if (data == nullptr || data->scalar || (axis != nullptr && axis->i() != 0 && axis->i() != -1) ||
+        !GetConstants(GetShapeValue(graph, inputs[1], expressions, values), expressions, indices)) {
+      return false;
+    }
+    const int64_t size = static_cast<int64_t>(data->elements.size());
+    for (int64_t index : indices) {
+      index = index < 0 ? index + size : index;
+      if (index < 0 || index >= size) {
+        return false;
+      }
+      result.elements.push_back(data->elements[static_cast<size_t>(index)]);
+    }
+    result.scalar = values.at(inputs[1]).scalar;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Slice", {10, 11, 13})) {
+    const ShapeValue* data = GetShapeValue(graph, inputs[0], expressions, values);
+    InlinedVector<int64_t> starts, ends, axes{0}, steps{1};
+    auto get_optional = [&](size_t index, InlinedVector<int64_t>& constants) {
+      return inputs.size() <= index || !inputs[index]->Exists() ||
+             GetConstants(GetShapeValue(graph, inputs[index], expressions, values), expressions, constants);
+    };
+    if (data == nullptr || data->scalar ||
+        !GetConstants(GetShapeValue(graph, inputs[1], expressions, values), expressions, starts) ||
+        !GetConstants(GetShapeValue(graph, inputs[2], expressions, values), expressions, ends) ||
+        !get_optional(3, axes) || !get_optional(4, steps) || starts.size() != 1 || ends.size() != 1 ||
+        axes.size() != 1 || (axes[0] != 0 && axes[0] != -1) || steps.size() != 1 || steps[0] == 0) {
+      return false;
+    }
+    const int64_t size = static_cast<int64_t>(data->elements.size());
+    int64_t start = starts[0] < 0 ? starts[0] + size : starts[0];
+    int64_t end = ends[0] < 0 ? ends[0] + size : ends[0];
+    if (steps[0] > 0) {
+      start = std::clamp<int64_t>(start, 0, size);
+      end = std::clamp<int64_t>(end, 0, size);
+      for (int64_t i = start; i < end; i += steps[0]) {
+        result.elements.push_back(data->elements[static_cast<size_t>(i)]);
+      }
+    } else {
+      start = std::clamp<int64_t>(start, 0, size - 1);
+      end = std::clamp<int64_t>(end, -1, size - 1);
+      for (int64_t i = start; i > end; i += steps[0]) {
+        result.elements.push_back(data->elements[static_cast<size_t>(i)]);
+      }
+    }
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Concat", {4, 11, 13})) {
+    const auto* axis = graph_utils::GetNodeAttribute(node, "axis");
+    if (axis == nullptr || (axis->i() != 0 && axis->i() != -1)) {
+      return false;
+    }
+    for (const NodeArg* input : inputs) {
+      const ShapeValue* value = GetShapeValue(graph, input, expressions, values);
+      if (value == nullptr || value->scalar) {
+        return false;
+      }
+      result.elements.insert(result.elements.end(), value->elements.begin(), value->elements.end());
+    }
+    return static_cast<int64_t>(result.elements.size()) <= kMaxShapeValueSize;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Unsqueeze", {1, 11, 13, 21})) {
+    const ShapeValue* value = GetShapeValue(graph, inputs[0], expressions, values);
+    if (value == nullptr || !value->scalar || !HasFirstAxisOnly(graph, node, expressions, values)) {
+      return false;
+    }
+    result.elements = value->elements;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Squeeze", {1, 11, 13, 21})) {
+    const ShapeValue* value = GetShapeValue(graph, inputs[0], expressions, values);
+    if (value == nullptr || value->scalar || value->elements.size() != 1 ||
+        !HasFirstAxisOnly(graph, node, expressions, values)) {
+      return false;
+    }
+    result.elements = value->elements;
+    result.scalar = true;
+    return true;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9, 13, 19, 21}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Identity", {1, 13, 14, 16, 19, 21})) {
+    const ShapeValue* value = GetShapeValue(graph, inputs[0], expressions, values);
+    if (value == nullptr) {
+      return false;
+    }
+    result = *value;
+    return true;
+  }
+
+  for (const char* op : {"Add", "Sub", "Mul", "Div"}) {
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, op, {7, 13, 14})) {
+      const ShapeValue* a = GetShapeValue(graph, inputs[0], expressions, values);
+      const ShapeValue* b = GetShapeValue(graph, inputs[1], expressions, values);
+      if (a == nullptr || b == nullptr) {
+        return false;
+      }
+      const size_t a_size = a->elements.size();
+      const size_t b_size = b->elements.size();
+      if (a_size != b_size && a_size != 1 && b_size != 1) {
+        return false;
+      }
+      for (size_t i = 0, size = std::max(a_size, b_size); i < size; ++i) {
+        result.elements.push_back(expressions.Binary(op, a->elements[a_size == 1 ? 0 : i],
+                                                     b->elements[b_size == 1 ? 0 : i]));
+      }
+      result.scalar = a->scalar && b->scalar;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // namespace
+
+Status ShapeComputeFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  ShapeExpressions expressions;
+  ShapeValues values;
+  InlinedVector<NodeIndex> shape_nodes;  // nodes evaluated as shape values, in topological order
+  InlinedHashSet<NodeIndex> shape_node_set;
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    ShapeValue value;
+    if (graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) &&
+        EvaluateNode(graph, node, expressions, values, value)) {
+      values[node.OutputDefs()[0]] = std::move(value);
+      shape_nodes.push_back(node_index);
+      shape_node_set.insert(node_index);
+    }
+  }
+
+  bool fused = false;
+  for (NodeIndex node_index : shape_nodes) {
+    Node& node = *graph.GetNode(node_index);
+    const NodeArg* output = node.OutputDefs()[0];
+    if (node.OpType() == "Shape" || graph.NodeProducesGraphOutput(node)) {
+      continue;  // nothing to gain, or the value must stay
+    }
+
+    // the consumers outside of the shape computations, which must read the value as an explicit input
+    InlinedVector<Node*> consumers;
+    bool has_implicit_use = false;
+    for (Node* consumer : graph.GetMutableConsumerNodes(output->Name())) {
+      if (shape_node_set.count(consumer->Index()) == 0) {
+        consumers.push_back(consumer);
+        const auto& input_defs = consumer->InputDefs();
+        has_implicit_use = has_implicit_use || std::find(input_defs.begin(), input_defs.end(), output) ==
+                                                   input_defs.end();
+      }
+    }
+    if (consumers.empty() || has_implicit_use) {
+      continue;
+    }
+
+    // the instructions the value depends on, in evaluation order
+    const ShapeValue& value = values.at(output);
+    InlinedVector<int> used;
+    InlinedVector<int> stack(value.elements.begin(), value.elements.end());
+    while (!stack.empty()) {
+      const int index = stack.back();
+      stack.pop_back();
+      if (std::find(used.begin(), used.end(), index) != used.end()) {
+        continue;
+      }
+      used.push_back(index);
+      const Instruction& instruction = expressions[index];
+      if (instruction.op != "Dim" && instruction.op != "Const") {
+        stack.push_back(static_cast<int>(instruction.a));
+        stack.push_back(static_cast<int>(instruction.b));
+      }
+    }
+    std::sort(used.begin(), used.end());
+
+    InlinedVector<NodeArg*> input_defs;
+    std::vector<std::string> ops;
+    std::vector<int64_t> operands;
+    InlinedHashMap<int, int64_t> renumbered;
+    for (int index : used) {
+      const Instruction& instruction = expressions[index];
+      int64_t a = instruction.a;
+      int64_t b = instruction.b;
+      if (instruction.op == "Dim") {
+        auto it = std::find(input_defs.begin(), input_defs.end(), instruction.input);
+        a = it - input_defs.begin();
+        if (it == input_defs.end()) {
+          input_defs.push_back(graph.GetNodeArg(instruction.input->Name()));
+        }
+      } else if (instruction.op != "Const") {
+        a = renumbered.at(static_cast<int>(a));
+        b = renumbered.at(static_cast<int>(b));
+      }
+      renumbered[index] = static_cast<int64_t>(ops.size());
+      ops.push_back(instruction.op);
+      operands.push_back(a);
+      operands.push_back(b);
+    }
+    if (input_defs.empty()) {
+      continue;  // a constant, left to constant folding
+    }
+    std::vector<int64_t> outputs;
+    for (int element : value.elements) {
+      outputs.push_back(renumbered.at(element));
+    }
+
+    NodeArg& computed_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output->Name() + "_computed"),
+                                                        output->TypeAsProto());
+    Node& shape_compute_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_ShapeCompute"),
+                                             "ShapeCompute",
+                                             "fused shape computation",
+                                             input_defs,
+                                             {&computed_output},
+                                             nullptr,
+                                             kMSDomain);
+    shape_compute_node.AddAttribute("ops", ops);
+    shape_compute_node.AddAttribute("operands", operands);
+    shape_compute_node.AddAttribute("outputs", outputs);
+    if (value.scalar) {
+      shape_compute_node.AddAttribute("scalar", static_cast<int64_t>(1));
+    }
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    shape_compute_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    for (int i = 0; i < static_cast<int>(input_defs.size()); ++i) {
+      const Node* producer = graph.GetProducerNode(input_defs[i]->Name());
+      if (producer != nullptr) {
+        const auto& producer_outputs = producer->OutputDefs();
+        const auto it = std::find(producer_outputs.begin(), producer_outputs.end(), input_defs[i]);
+        graph.AddEdge(producer->Index(), shape_compute_node.Index(),
+                      static_cast<int>(it - producer_outputs.begin()), i);
+      }
+    }
+
+    for (Node* consumer : consumers) {
+      const auto& consumer_inputs = consumer->InputDefs();
+      for (int i = 0; i < static_cast<int>(consumer_inputs.size()); ++i) {
+        if (consumer_inputs[i] == output) {
+          graph.RemoveEdge(node.Index(), consumer->Index(), 0, i);
+          graph_utils::ReplaceNodeInput(*consumer, i, computed_output);
+          graph.AddEdge(shape_compute_node.Index(), consumer->Index(), 0, i);
+        }
+      }
+    }
+    fused = true;
+  }
+
+  if (fused) {
+    // remove the nodes of the shape computations left without consumers, consumers first
+    for (auto it = shape_nodes.rbegin(); it != shape_nodes.rend(); ++it) {
+      Node* node = graph.GetNode(*it);
+      if (node != nullptr && node->GetOutputEdgesCount() == 0 && !graph.NodeProducesGraphOutput(*node)) {
+        graph.RemoveNode(node->Index());
+      }
+    }
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ShapeComputeFusion
+
+Replace the chains of nodes computing a shape from the dimensions of other tensors with a single
+com.microsoft.ShapeCompute node. The chains made of Shape, Gather, Slice, Concat, Unsqueeze, Squeeze, Cast, Identity,
+Add, Sub, Mul and Div on small int64 tensors are evaluated symbolically: each element of their result is an expression
+of the input dimensions and of constants. For example
+
+  X -> Shape -> Gather(0) -> Unsqueeze --\
+  X -> Shape -> Gather(1) -> Unsqueeze --> Concat -> Reshape(X, .)
+                            Const[-1, 64] --/
+
+becomes ShapeCompute(X) -> Reshape(X, .), which evaluates the expressions in a single kernel instead of running each
+node of the chains on every run. Known dimensions are folded into constants. A value is replaced where it leaves the
+chain, i.e. where it is consumed by another kind of node; the nodes of the chain left without consumers are removed.
+*/
+class ShapeComputeFusion : public GraphTransformer {
+ public:
+  ShapeComputeFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ShapeComputeFusion", compatible_execution_providers) {
+  }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,259 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/tensor_parallel_sharding.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Ranges [begin, end) of the last dimension of a weight kept by a rank.
+using ColumnRanges = InlinedVector<std::pair<int64_t, int64_t>>;
+
+// A constant float or float16 initializer with num_dims dimensions, none of them empty.
+const TensorProto* GetShardableWeight(const Graph& graph, const NodeArg& arg, int num_dims) {
+  const TensorProto* weight = graph_utils::GetConstantInitializer(graph, arg.Name());
+  if (weight == nullptr || weight->dims_size() != num_dims ||
+      (weight->data_type() != TensorProto_DataType_FLOAT && weight->data_type() != TensorProto_DataType_FLOAT16)) {
+    return nullptr;
+  }
+  for (int64_t dim : weight->dims()) {
+    if (dim <= 0) {
+      return nullptr;
+    }
+  }
+  return weight;
+}
+
+// Checks that an elementwise node applies independently to every column of path_arg, and sets bias_index to the
+// index of its per-column bias input, or -1 if it has none.
+bool GetElementwiseBiasIndex(const Node& node, const NodeArg& path_arg, int& bias_index) {
+  const auto& inputs = node.InputDefs();
+  bias_index = -1;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {20}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gelu", {1}, kMSDomain) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "QuickGelu", {1}, kMSDomain)) {
+    return inputs[0] == &path_arg;
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "FastGelu", {1}, kMSDomain) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "BiasGelu", {1}, kMSDomain)) {
+    if (inputs.size() > 1 && inputs[1]->Exists()) {
+      bias_index = 1;
+    }
+    return inputs[0] == &path_arg;
+  }
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14})) {
+    bias_index = inputs[0] == &path_arg ? 1 : 0;
+    return inputs[1 - bias_index] == &path_arg && inputs[bias_index] != &path_arg;
+  }
+  return false;
+}
+
+// Copies the rows [row_begin, row_end) and the column ranges of a 1D or 2D weight to a new initializer.
+NodeArg& AddShardInitializer(Graph& graph, const TensorProto& weight, int64_t row_begin, int64_t row_end,
+                             const ColumnRanges& columns) {
+  Initializer initializer{weight, graph.ModelPath()};
+  const auto bytes = initializer.DataAsByteSpan();
+  const size_t element_size = bytes.size() / initializer.size();
+  const int64_t row_size = weight.dims(weight.dims_size() - 1);
+
+  int64_t shard_columns = 0;
+  for (const auto& range : columns) {
+    shard_columns += range.second - range.first;
+  }
+
+  std::vector<uint8_t> data;
+  data.reserve(static_cast<size_t>((row_end - row_begin) * shard_columns) * element_size);
+  for (int64_t row = row_begin; row < row_end; ++row) {
+    for (const auto& range : columns) {
+      const uint8_t* first = bytes.data() + static_cast<size_t>(row * row_size + range.first) * element_size;
+      data.insert(data.end(), first, first + static_cast<size_t>(range.second - range.first) * element_size);
+    }
+  }
+
+  TensorProto shard;
+  shard.set_name(graph.GenerateNodeArgName(weight.name() + "_shard"));
+  shard.set_data_type(weight.data_type());
+  if (weight.dims_size() == 2) {
+    shard.add_dims(row_end - row_begin);
+  }
+  shard.add_dims(shard_columns);
+  shard.set_raw_data(data.data(), data.size());
+  return graph_utils::AddInitializer(graph, shard);
+}
+
+}  // namespace
+
+Status TensorParallelSharding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedHashSet<NodeIndex> sharded_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (nullptr == node_ptr)
+      continue;  // node was removed
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (sharded_nodes.count(node_index) != 0 ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // The column-parallel node: num_columns is the width of its output before sharding, column_ranges the columns
+    // of its weight and bias kept by the rank.
+    const TensorProto* column_weight = nullptr;
+    const TensorProto* column_bias = nullptr;
+    int64_t num_columns = 0;
+    int64_t num_heads = 0;
+    ColumnRanges column_ranges;
+    if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13})) {
+      column_weight = GetShardableWeight(graph, *node.InputDefs()[1], 2);
+      if (column_weight == nullptr || column_weight->dims(1) % world_size_ != 0) {
+        continue;
+      }
+      num_columns = column_weight->dims(1);
+      const int64_t shard_size = num_columns / world_size_;
+      column_ranges.push_back({rank_ * shard_size, (rank_ + 1) * shard_size});
+    } else if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Attention", {1}, kMSDomain)) {
+      // The past state and the attention bias hold all the heads, and qkv_hidden_sizes changes the packing of the
+      // QKV weights.
+      const auto& inputs = node.InputDefs();
+      const auto& outputs = node.OutputDefs();
+      const auto* num_heads_attr = graph_utils::GetNodeAttribute(node, "num_heads");
+      if ((inputs.size() > 4 && inputs[4]->Exists()) || (inputs.size() > 5 && inputs[5]->Exists()) ||
+          (outputs.size() > 1 && outputs[1]->Exists()) || num_heads_attr == nullptr ||
+          graph_utils::GetNodeAttribute(node, "qkv_hidden_sizes") != nullptr) {
+        continue;
+      }
+      column_weight = GetShardableWeight(graph, *inputs[1], 2);
+      num_heads = num_heads_attr->i();
+      if (column_weight == nullptr || column_weight->dims(1) % 3 != 0 || num_heads % world_size_ != 0) {
+        continue;
+      }
+      if (inputs.size() > 2 && inputs[2]->Exists()) {
+        column_bias = GetShardableWeight(graph, *inputs[2], 1);
+        if (column_bias == nullptr || column_bias->dims(0) != column_weight->dims(1)) {
+          continue;
+        }
+      }
+
+      // Q, K and V are packed along the columns, each keeps the heads of the rank.
+      num_columns = column_weight->dims(1) / 3;
+      const int64_t shard_size = num_columns / world_size_;
+      for (int64_t qkv = 0; qkv < 3; ++qkv) {
+        const int64_t begin = qkv * num_columns + rank_ * shard_size;
+        column_ranges.push_back({begin, begin + shard_size});
+      }
+    } else {
+      continue;
+    }
+
+    // Follow the output of the node through the elementwise nodes to the row-parallel MatMul. The values on the path
+    // only hold the columns of the rank, so they must not be used by any other node.
+    InlinedVector<std::pair<Node*, int>> elementwise_nodes;
+    Node* row_node = nullptr;
+    const Node* current = &node;
+    while (current->GetOutputEdgesCount() == 1 && !graph.NodeProducesGraphOutput(*current)) {
+      const NodeArg& path_arg = *current->OutputDefs()[0];
+      Node& next = *graph.GetNode(current->OutputNodesBegin()->Index());
+      if (sharded_nodes.count(next.Index()) != 0 ||
+          next.GetExecutionProviderType() != node.GetExecutionProviderType()) {
+        break;
+      }
+
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(next, "MatMul", {1, 9, 13})) {
+        const TensorProto* row_weight = GetShardableWeight(graph, *next.InputDefs()[1], 2);
+        if (next.InputDefs()[0] == &path_arg && row_weight != nullptr && row_weight->dims(0) == num_columns) {
+          row_node = &next;
+        }
+        break;
+      }
+
+      int bias_index = -1;
+      if (!GetElementwiseBiasIndex(next, path_arg, bias_index)) {
+        break;
+      }
+      if (bias_index >= 0) {
+        const TensorProto* bias = GetShardableWeight(graph, *next.InputDefs()[bias_index], 1);
+        if (bias == nullptr || bias->dims(0) != num_columns) {
+          break;
+        }
+      }
+      elementwise_nodes.push_back({&next, bias_index});
+      current = &next;
+    }
+
+    if (row_node == nullptr) {
+      continue;
+    }
+
+    const int64_t shard_size = num_columns / world_size_;
+    const ColumnRanges path_ranges{{rank_ * shard_size, (rank_ + 1) * shard_size}};
+
+    graph_utils::ReplaceNodeInput(node, 1, AddShardInitializer(graph, *column_weight, 0, column_weight->dims(0),
+                                                               column_ranges));
+    if (column_bias != nullptr) {
+      graph_utils::ReplaceNodeInput(node, 2, AddShardInitializer(graph, *column_bias, 0, 1, column_ranges));
+    }
+    if (num_heads > 0) {
+      node.AddAttribute("num_heads", num_heads / world_size_);
+    }
+    // The shapes on the path are inferred again with the sharded width when the graph is resolved.
+    node.MutableOutputDefs()[0]->ClearShape();
+    sharded_nodes.insert(node.Index());
+
+    for (const auto& [elementwise_node, bias_index] : elementwise_nodes) {
+      if (bias_index >= 0) {
+        const TensorProto* bias =
+            graph_utils::GetConstantInitializer(graph, elementwise_node->InputDefs()[bias_index]->Name());
+        graph_utils::ReplaceNodeInput(*elementwise_node, bias_index,
+                                      AddShardInitializer(graph, *bias, 0, 1, path_ranges));
+      }
+      elementwise_node->MutableOutputDefs()[0]->ClearShape();
+      sharded_nodes.insert(elementwise_node->Index());
+    }
+
+    // The row-parallel MatMul produces a partial sum with the full output shape, which the AllReduce completes.
+    const TensorProto* row_weight = graph_utils::GetConstantInitializer(graph, row_node->InputDefs()[1]->Name());
+    NodeArg& row_weight_shard = AddShardInitializer(graph, *row_weight, rank_ * shard_size, (rank_ + 1) * shard_size,
+                                                    {{0, row_weight->dims(1)}});
+    NodeArg& partial_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(row_node->Name() + "_partial"),
+                                                       row_node->OutputDefs()[0]->TypeAsProto());
+    Node& sharded_node = graph.AddNode(graph.GenerateNodeName(row_node->Name() + "_shard"),
+                                       "MatMul",
+                                       "Row-parallel MatMul",
+                                       {row_node->MutableInputDefs()[0], &row_weight_shard},
+                                       {&partial_output});
+    Node& all_reduce_node = graph.AddNode(graph.GenerateNodeName(row_node->Name() + "_all_reduce"),
+                                          "AllReduce",
+                                          "Sum of the partial results of the ranks",
+                                          {&partial_output},
+                                          {row_node->MutableOutputDefs()[0]},
+                                          nullptr,
+                                          kMSDomain);
+
+    // Assign provider to the new nodes. Provider should be same as the provider for old node.
+    sharded_node.SetExecutionProviderType(row_node->GetExecutionProviderType());
+    all_reduce_node.SetExecutionProviderType(row_node->GetExecutionProviderType());
+    sharded_nodes.insert(sharded_node.Index());
+    sharded_nodes.insert(all_reduce_node.Index());
+
+    graph_utils::RemoveNodeOutputEdges(graph, *row_node);
+    graph.RemoveNode(row_node->Index());
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TensorParallelSharding
+
+Shard the weights of a model across world_size devices with tensor (Megatron-style) parallelism, keeping the part
+of the weights used by the given rank, and insert the com.microsoft.AllReduce nodes combining the partial results.
+
+A column-parallel node followed by a row-parallel MatMul is sharded as a pair:
+  - MatMul(X, W1) with W1 a [K, N] initializer keeps the columns of W1 of the rank, or
+    com.microsoft.Attention with packed QKV weights keeps the heads of the rank, and its num_heads is divided.
+  - The elementwise nodes between the two, e.g. Add of a bias, Gelu or Relu, keep the columns of their bias.
+  - MatMul(H, W2) with W2 a [N, M] initializer keeps the rows of W2 of the rank, and its output is summed over the
+    ranks by an AllReduce node before any bias is added to it.
+
+Every rank runs a session on the same model with its own rank. The rank must be the rank of the process in the
+NCCL communicator used by the AllReduce kernel.
+*/
+class TensorParallelSharding : public GraphTransformer {
+ public:
+  TensorParallelSharding(int64_t world_size, int64_t rank,
+                         const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TensorParallelSharding", compatible_execution_providers),
+        world_size_(world_size),
+        rank_(rank) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+ private:
+  const int64_t world_size_;
+  const int64_t rank_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/token_embed_layer_norm_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+
+namespace {
+
+// Returns the scalar float constant multiplying input in a Mul node, if the other input of the node is one.
+bool GetScalarMultiplier(const Graph& graph, const Node& mul_node, const NodeArg& input, float& multiplier) {
+  const auto& inputs = mul_node.InputDefs();
+  const NodeArg* other = inputs[0] == &input ? inputs[1] : inputs[0];
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, other->Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+  Initializer value{*tensor_proto, graph.ModelPath()};
+  if (value.size() != 1) {
+    return false;
+  }
+  multiplier = value.data<float>()[0];
+  return true;
+}
+
+// Returns true if no node and no graph output uses the output of a node, which is optional.
+bool IsOutputUnused(const Graph& graph, const Node& node, size_t output_index) {
+  const auto& outputs = node.OutputDefs();
+  return output_index >= outputs.size() || !outputs[output_index]->Exists() ||
+         (graph.GetConsumerNodes(outputs[output_index]->Name()).empty() && !graph.IsOutput(outputs[output_index]));
+}
+
+}  // namespace
+
+/*
+This transform fuses the following subgraph pattern:
+
+  embedding (float)   input_ids
+           \            /
+         Gather (axis=0)
+               |
+       [Mul (scalar constant)]
+               |        \
+               |         (other consumers, e.g. the first residual Add)
+               |
+  LayerNormalization/SimplifiedLayerNormalization (axis=-1)
+
+into
+
+  TokenEmbedLayerNormalization (scale, simplified), whose embedding_sum output feeds the other consumers if any
+*/
+Status TokenEmbedLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& gather_node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(gather_node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(gather_node, "Gather", {1, 11, 13}) ||
+        !graph_utils::IsSupportedProvider(gather_node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const NodeArg& embedding = *gather_node.InputDefs()[0];
+    const auto* embedding_type = embedding.TypeAsProto();
+    if (embedding_type == nullptr || embedding_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT ||
+        embedding.Shape() == nullptr || embedding.Shape()->dim_size() != 2) {
+      continue;
+    }
+
+    const auto& gather_attributes = gather_node.GetAttributes();
+    auto axis_attr = gather_attributes.find("axis");
+    if (axis_attr != gather_attributes.end() && axis_attr->second.i() != 0 && axis_attr->second.i() != -2) {
+      continue;
+    }
+
+    // the optional scaling of the embeddings, the only consumer of the Gather
+    Node* mul_node = nullptr;
+    float scale = 1.0f;
+    if (optimizer_utils::CheckOutputEdges(graph, gather_node, 1)) {
+      Node& next_node = *graph.GetNode(gather_node.OutputNodesBegin()->Index());
+      if (graph_utils::IsSupportedOptypeVersionAndDomain(next_node, "Mul", {7, 13, 14}) &&
+          next_node.GetExecutionProviderType() == gather_node.GetExecutionProviderType() &&
+          GetScalarMultiplier(graph, next_node, *gather_node.OutputDefs()[0], scale)) {
+        mul_node = &next_node;
+      }
+    }
+
+    Node& embedding_node = mul_node != nullptr ? *mul_node : gather_node;
+    NodeArg* embedding_sum = embedding_node.MutableOutputDefs()[0];
+
+    Node* norm_node = nullptr;
+    size_t num_other_consumers = 0;
+    for (auto it = embedding_node.OutputNodesBegin(); it != embedding_node.OutputNodesEnd(); ++it) {
+      Node& consumer = *graph.GetNode(it->Index());
+      const bool is_norm = graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "LayerNormalization", {1, 17}) ||
+                           graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "SimplifiedLayerNormalization",
+                                                                          {1});
+      if (norm_node == nullptr && is_norm && consumer.InputDefs()[0] == embedding_sum) {
+        norm_node = &consumer;
+      } else {
+        ++num_other_consumers;
+      }
+    }
+    if (norm_node == nullptr ||
+        norm_node->GetExecutionProviderType() != gather_node.GetExecutionProviderType() ||
+        !IsOutputUnused(graph, *norm_node, 1) || !IsOutputUnused(graph, *norm_node, 2)) {
+      continue;
+    }
+
+    const auto& norm_attributes = norm_node->GetAttributes();
+    auto norm_axis_attr = norm_attributes.find("axis");
+    if (norm_axis_attr != norm_attributes.end() && norm_axis_attr->second.i() != -1 &&
+        (embedding_sum->Shape() == nullptr || norm_axis_attr->second.i() != embedding_sum->Shape()->dim_size() - 1)) {
+      continue;
+    }
+
+    const bool simplified = norm_node->OpType() == "SimplifiedLayerNormalization";
+    auto& norm_inputs = norm_node->MutableInputDefs();
+    NodeArg& empty_arg = graph.GetOrCreateNodeArg("", nullptr);
+    const bool keep_embedding_sum = num_other_consumers > 0 || graph.IsOutput(embedding_sum);
+
+    InlinedVector<NodeArg*> outputs{norm_node->MutableOutputDefs()[0]};
+    if (keep_embedding_sum) {
+      outputs.push_back(embedding_sum);
+    }
+
+    Node& fused_node = graph.AddNode(
+        graph.GenerateNodeName("TokenEmbedLayerNormalization"),
+        "TokenEmbedLayerNormalization",
+        "fused token embedding and " + norm_node->OpType(),
+        {gather_node.MutableInputDefs()[1], gather_node.MutableInputDefs()[0], norm_inputs[1],
+         !simplified && norm_inputs.size() > 2 ? norm_inputs[2] : &empty_arg},
+        outputs,
+        nullptr,
+        kMSDomain);
+    auto epsilon_attr = norm_attributes.find("epsilon");
+    fused_node.AddAttribute("epsilon", epsilon_attr != norm_attributes.end() ? epsilon_attr->second.f() : 1e-5f);
+    fused_node.AddAttribute("scale", scale);
+    fused_node.AddAttribute("simplified", static_cast<int64_t>(simplified ? 1 : 0));
+    fused_node.SetExecutionProviderType(gather_node.GetExecutionProviderType());
+
+    // the consumers of embedding_sum are connected to the fused node when the graph is resolved
+    InlinedVector<Node*> nodes_to_remove{&gather_node};
+    if (mul_node != nullptr) {
+      nodes_to_remove.push_back(mul_node);
+    }
+    nodes_to_remove.push_back(norm_node);
+    for (Node* node : nodes_to_remove) {
+      graph_utils::RemoveNodeOutputEdges(graph, *node);
+      graph.RemoveNode(node->Index());
+    }
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
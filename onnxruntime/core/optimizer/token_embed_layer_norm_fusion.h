@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TokenEmbedLayerNormFusion
+
+Fuse the embedding layer of decoder-only models, Gather of a float token embedding table optionally followed by a Mul
+by a scalar constant, then LayerNormalization or SimplifiedLayerNormalization over the last axis, into a
+com.microsoft.TokenEmbedLayerNormalization node. When the embeddings also feed other nodes, e.g. the first residual
+Add, they are produced by the embedding_sum output of the fused node.
+*/
+class TokenEmbedLayerNormFusion : public GraphTransformer {
+ public:
+  TokenEmbedLayerNormFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TokenEmbedLayerNormFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -87,6 +87,10 @@ struct ThreadOptions {
   // Set or unset denormal as zero.
   bool set_denormal_as_zero = false;
 
+  // If it is true, each thread tunes how long it spins before blocking from the idle gaps it observed, instead of
+  // always spinning the same number of times. It has no effect if spinning is not allowed.
+  bool adaptive_spinning = false;
+
   OrtCustomCreateThreadFn custom_create_thread_fn = nullptr;
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
@@ -147,6 +151,33 @@ class Env {
 
   virtual std::vector<LogicalProcessors> GetDefaultThreadAffinities() const = 0;
 
+  /// <summary>
+  /// Returns the affinities of the physical cores on the given NUMA node, in the same format as
+  /// GetDefaultThreadAffinities(). Returns an empty vector if the node does not exist or
+  /// NUMA information is not available on the platform.
+  /// </summary>
+  virtual std::vector<LogicalProcessors> GetNumaNodeThreadAffinities(int /*numa_node*/) const {
+    return {};
+  }
+
+  /// <summary>
+  /// Returns the affinities of the physical cores that are not of the lowest performance class on a hybrid CPU,
+  /// e.g. the P-cores of Intel Alder Lake or the big cores of ARM big.LITTLE, in the same format as
+  /// GetDefaultThreadAffinities(). Returns an empty vector if all cores are of the same class or the core classes
+  /// are not known.
+  /// </summary>
+  virtual std::vector<LogicalProcessors> GetPerformanceCoreThreadAffinities() const {
+    return {};
+  }
+
+  /// <summary>
+  /// Asks the OS to place the pages of [p, p + size) on the given NUMA node when they are first touched.
+  /// Only the whole pages inside the range are affected, so that neighbouring allocations keep their policy.
+  /// </summary>
+  virtual common::Status SetPreferredNumaNode(void* /*p*/, size_t /*size*/, int /*numa_node*/) const {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "NUMA memory policy is not supported on this platform");
+  }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
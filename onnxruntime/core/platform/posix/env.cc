@@ -29,8 +29,11 @@ limitations under the License.
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <optional>
+#include <string>
 #include <thread>
 #include <utility>  // for std::forward
 #include <vector>
@@ -45,8 +48,10 @@ limitations under the License.
 
 #include "core/common/common.h"
 #include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
+#include "core/platform/posix/telemetry.h"
 #include "core/platform/scoped_resource.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 
@@ -118,6 +123,37 @@ struct Freer {
 
 using MallocdStringPtr = std::unique_ptr<char, Freer<char> >;
 
+#if defined(__linux__)
+// Parse a Linux cpu list such as "0-3,8,10-11", as in /sys/devices/system/node/node<n>/cpulist.
+bool ParseCpuList(const std::string& cpu_list, std::vector<int>& cpus) {
+  const char* p = cpu_list.c_str();
+  while (*p != '\0' && *p != '\n') {
+    char* end = nullptr;
+    const long from = strtol(p, &end, 10);
+    if (end == p || from < 0) {
+      return false;
+    }
+    long to = from;
+    p = end;
+    if (*p == '-') {
+      ++p;
+      to = strtol(p, &end, 10);
+      if (end == p || to < from) {
+        return false;
+      }
+      p = end;
+    }
+    for (long cpu = from; cpu <= to; ++cpu) {
+      cpus.push_back(static_cast<int>(cpu));
+    }
+    if (*p == ',') {
+      ++p;
+    }
+  }
+  return true;
+}
+#endif
+
 class PosixThread : public EnvThread {
  private:
   struct Param {
@@ -302,6 +338,115 @@ class PosixEnv : public Env {
     return ret;
   }
 
+  std::vector<LogicalProcessors> GetNumaNodeThreadAffinities(int numa_node) const override {
+    std::vector<LogicalProcessors> ret;
+#if defined(__linux__)
+    if (numa_node < 0) {
+      return ret;
+    }
+    std::ifstream cpu_list_file("/sys/devices/system/node/node" + std::to_string(numa_node) + "/cpulist");
+    std::string cpu_list;
+    std::vector<int> node_cpus;
+    if (!std::getline(cpu_list_file, cpu_list) || !ParseCpuList(cpu_list, node_cpus)) {
+      return ret;
+    }
+    const InlinedHashSet<int> node_cpu_set(node_cpus.begin(), node_cpus.end());
+    auto default_affinities = GetDefaultThreadAffinities();
+    if (std::any_of(default_affinities.begin(), default_affinities.end(),
+                    [](const LogicalProcessors& core) { return core.empty(); })) {
+      // No information about physical cores, use one entry per logical processor
+      for (int cpu : node_cpus) {
+        ret.push_back(LogicalProcessors{cpu});
+      }
+      return ret;
+    }
+    for (auto& core : default_affinities) {
+      if (std::all_of(core.begin(), core.end(), [&node_cpu_set](int cpu) { return node_cpu_set.count(cpu) > 0; })) {
+        ret.push_back(std::move(core));
+      }
+    }
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+#endif
+    return ret;
+  }
+
+  std::vector<LogicalProcessors> GetPerformanceCoreThreadAffinities() const override {
+    std::vector<LogicalProcessors> ret;
+#if defined(__linux__)
+    auto default_affinities = GetDefaultThreadAffinities();
+    if (std::any_of(default_affinities.begin(), default_affinities.end(),
+                    [](const LogicalProcessors& core) { return core.empty(); })) {
+      // No information about physical cores
+      return ret;
+    }
+
+    // Intel hybrid CPUs list their P-cores in the cpu_core PMU.
+    std::ifstream p_core_list_file("/sys/devices/cpu_core/cpus");
+    std::string cpu_list;
+    std::vector<int> p_cores;
+    if (std::getline(p_core_list_file, cpu_list) && ParseCpuList(cpu_list, p_cores) && !p_cores.empty()) {
+      const InlinedHashSet<int> p_core_set(p_cores.begin(), p_cores.end());
+      for (auto& core : default_affinities) {
+        if (p_core_set.count(core.front()) > 0) {
+          ret.push_back(std::move(core));
+        }
+      }
+      return ret.size() < default_affinities.size() ? ret : std::vector<LogicalProcessors>{};
+    }
+
+    // Otherwise use the capacity the scheduler gives to each core, which ARM big.LITTLE systems expose.
+    // The maximum frequency is not used as it also differs between the favored cores of non-hybrid CPUs.
+    std::vector<uint64_t> capacities;
+    capacities.reserve(default_affinities.size());
+    for (const auto& core : default_affinities) {
+      std::ifstream capacity_file("/sys/devices/system/cpu/cpu" + std::to_string(core.front()) + "/cpu_capacity");
+      uint64_t capacity = 0;
+      if (!(capacity_file >> capacity)) {
+        return ret;
+      }
+      capacities.push_back(capacity);
+    }
+    const uint64_t min_capacity = *std::min_element(capacities.begin(), capacities.end());
+    for (size_t i = 0; i < default_affinities.size(); ++i) {
+      if (capacities[i] > min_capacity) {
+        ret.push_back(std::move(default_affinities[i]));
+      }
+    }
+#endif
+    return ret;
+  }
+
+  common::Status SetPreferredNumaNode(void* p, size_t size, int numa_node) const override {
+#if defined(__linux__) && defined(SYS_mbind)
+    // Use the syscall directly to avoid depending on libnuma. Values are from <numaif.h>.
+    constexpr int kMpolPreferred = 1;
+    constexpr size_t kBitsPerMask = sizeof(unsigned long) * 8;
+    if (numa_node < 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid NUMA node: ", numa_node);
+    }
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(p) + page_size - 1) / page_size * page_size;
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(p) + size) / page_size * page_size;
+    if (end <= begin) {
+      return Status::OK();
+    }
+    std::vector<unsigned long> node_mask(static_cast<size_t>(numa_node) / kBitsPerMask + 1, 0);
+    node_mask.back() |= 1UL << (static_cast<size_t>(numa_node) % kBitsPerMask);
+    // The kernel ignores the last bit of maxnode.
+    const unsigned long max_node = static_cast<unsigned long>(node_mask.size() * kBitsPerMask + 1);
+    if (syscall(SYS_mbind, reinterpret_cast<void*>(begin), end - begin, kMpolPreferred,
+                node_mask.data(), max_node, 0) != 0) {
+      auto [err_no, err_msg] = GetErrnoInfo();
+      return common::Status(common::SYSTEM, err_no, "mbind to NUMA node " + std::to_string(numa_node) +
+                                                        " failed: " + err_msg);
+    }
+    return Status::OK();
+#else
+    return Env::SetPreferredNumaNode(p, size, numa_node);
+#endif
+  }
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -570,7 +715,7 @@ class PosixEnv : public Env {
   }
 
  private:
-  Telemetry telemetry_provider_;
+  PosixTelemetry telemetry_provider_;
 #ifdef ORT_USE_CPUINFO
   PosixEnv() {
     cpuinfo_available_ = cpuinfo_initialize();
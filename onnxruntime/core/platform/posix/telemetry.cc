@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/posix/telemetry.h"
+
+#ifdef ORT_ENABLE_USDT
+#include <sys/sdt.h>
+#define ORT_USDT_PROBE(...) STAP_PROBEV(onnxruntime, __VA_ARGS__)
+#else
+#define ORT_USDT_PROBE(...)
+#endif
+
+namespace onnxruntime {
+
+void PosixTelemetry::EnableTelemetryEvents() const {
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void PosixTelemetry::DisableTelemetryEvents() const {
+  enabled_.store(false, std::memory_order_relaxed);
+}
+
+bool PosixTelemetry::IsEnabled() const {
+  return enabled_.load(std::memory_order_relaxed);
+}
+
+void PosixTelemetry::LogSessionCreationStart() const {
+  if (!IsEnabled())
+    return;
+
+  ORT_USDT_PROBE(session_creation_start);
+}
+
+void PosixTelemetry::LogEvaluationStop() const {
+  if (!IsEnabled())
+    return;
+
+  ORT_USDT_PROBE(evaluation_stop);
+}
+
+void PosixTelemetry::LogEvaluationStart() const {
+  if (!IsEnabled())
+    return;
+
+  ORT_USDT_PROBE(evaluation_start);
+}
+
+void PosixTelemetry::LogSessionCreation(uint32_t session_id, int64_t ir_version,
+                                        const std::string& model_producer_name,
+                                        const std::string& /*model_producer_version*/,
+                                        const std::string& model_domain,
+                                        const std::unordered_map<std::string, int>& /*domain_to_version_map*/,
+                                        const std::string& model_graph_name,
+                                        const std::unordered_map<std::string, std::string>& /*model_metadata*/,
+                                        const std::string& loaded_from,
+                                        const std::vector<std::string>& /*execution_provider_ids*/,
+                                        bool use_fp16) const {
+  if (!IsEnabled())
+    return;
+
+  // only the fields which need no formatting, so that the event builds no string
+  ORT_USDT_PROBE(session_creation, session_id, ir_version, model_producer_name.c_str(), model_domain.c_str(),
+                 model_graph_name.c_str(), loaded_from.c_str(), static_cast<int>(use_fp16));
+  ORT_UNUSED_PARAMETER(session_id);
+  ORT_UNUSED_PARAMETER(ir_version);
+  ORT_UNUSED_PARAMETER(model_producer_name);
+  ORT_UNUSED_PARAMETER(model_domain);
+  ORT_UNUSED_PARAMETER(model_graph_name);
+  ORT_UNUSED_PARAMETER(loaded_from);
+  ORT_UNUSED_PARAMETER(use_fp16);
+}
+
+void PosixTelemetry::LogRuntimeError(uint32_t session_id, const common::Status& status, const char* file,
+                                     const char* function, uint32_t line) const {
+  if (!IsEnabled())
+    return;
+
+  ORT_USDT_PROBE(runtime_error, session_id, static_cast<int>(status.Code()), static_cast<int>(status.Category()),
+                 status.ErrorMessage().c_str(), file, function, line);
+  ORT_UNUSED_PARAMETER(session_id);
+  ORT_UNUSED_PARAMETER(status);
+  ORT_UNUSED_PARAMETER(file);
+  ORT_UNUSED_PARAMETER(function);
+  ORT_UNUSED_PARAMETER(line);
+}
+
+void PosixTelemetry::LogRuntimePerf(uint32_t session_id, uint32_t total_runs_since_last,
+                                    int64_t total_run_duration_since_last) const {
+  if (!IsEnabled())
+    return;
+
+  ORT_USDT_PROBE(runtime_perf, session_id, total_runs_since_last, total_run_duration_since_last);
+  ORT_UNUSED_PARAMETER(session_id);
+  ORT_UNUSED_PARAMETER(total_runs_since_last);
+  ORT_UNUSED_PARAMETER(total_run_duration_since_last);
+}
+
+}  // namespace onnxruntime
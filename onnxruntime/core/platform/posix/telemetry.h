@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <atomic>
+
+#include "core/platform/telemetry.h"
+
+namespace onnxruntime {
+
+/**
+ * Telemetry provider of the POSIX platforms. When built with ORT_ENABLE_USDT (onnxruntime_ENABLE_USDT, Linux
+ * only), the session and run events are USDT probes of the "onnxruntime" provider, which tools such as bpftrace,
+ * perf and LTTng can attach to. A probe is a single nop until a tracer attaches to it, and its arguments are scalars
+ * or existing strings, so the events cost next to nothing while nobody listens. Without ORT_ENABLE_USDT, the events
+ * are compiled out.
+ */
+class PosixTelemetry : public Telemetry {
+ public:
+  PosixTelemetry() = default;
+
+  void EnableTelemetryEvents() const override;
+  void DisableTelemetryEvents() const override;
+
+  bool IsEnabled() const override;
+
+  void LogSessionCreationStart() const override;
+
+  void LogEvaluationStop() const override;
+
+  void LogEvaluationStart() const override;
+
+  void LogSessionCreation(uint32_t session_id, int64_t ir_version, const std::string& model_producer_name,
+                          const std::string& model_producer_version, const std::string& model_domain,
+                          const std::unordered_map<std::string, int>& domain_to_version_map,
+                          const std::string& model_graph_name,
+                          const std::unordered_map<std::string, std::string>& model_metadata,
+                          const std::string& loaded_from, const std::vector<std::string>& execution_provider_ids,
+                          bool use_fp16) const override;
+
+  void LogRuntimeError(uint32_t session_id, const common::Status& status, const char* file,
+                       const char* function, uint32_t line) const override;
+
+  void LogRuntimePerf(uint32_t session_id, uint32_t total_runs_since_last,
+                      int64_t total_run_duration_since_last) const override;
+
+ private:
+  mutable std::atomic<bool> enabled_{true};
+};
+
+}  // namespace onnxruntime
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "core/platform/windows/env.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <optional>
@@ -303,6 +304,21 @@ std::vector<LogicalProcessors> WindowsEnv::GetDefaultThreadAffinities() const {
   return cores_.empty() ? std::vector<LogicalProcessors>(DefaultNumCores(), LogicalProcessors{}) : cores_;
 }
 
+std::vector<LogicalProcessors> WindowsEnv::GetPerformanceCoreThreadAffinities() const {
+  std::vector<LogicalProcessors> ret;
+  if (core_efficiency_classes_.empty()) {
+    return ret;
+  }
+  const BYTE min_efficiency_class = *std::min_element(core_efficiency_classes_.begin(),
+                                                      core_efficiency_classes_.end());
+  for (size_t i = 0; i < cores_.size(); ++i) {
+    if (core_efficiency_classes_[i] > min_efficiency_class) {
+      ret.push_back(cores_[i]);
+    }
+  }
+  return ret;
+}
+
 WindowsEnv& WindowsEnv::Instance() {
   static WindowsEnv default_env;
   return default_env;
@@ -920,6 +936,7 @@ void WindowsEnv::InitializeCpuInfo() {
         }
       }
       cores_.push_back(std::move(core_global_proc_ids));
+      core_efficiency_classes_.push_back(processor_info->Processor.EfficiencyClass);
       core_id++;
     }
     iter += size;
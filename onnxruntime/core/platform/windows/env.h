@@ -55,6 +55,7 @@ class WindowsEnv : public Env {
   static int DefaultNumCores();
   int GetNumPhysicalCpuCores() const override;
   std::vector<LogicalProcessors> GetDefaultThreadAffinities() const override;
+  std::vector<LogicalProcessors> GetPerformanceCoreThreadAffinities() const override;
   static WindowsEnv& Instance();
   PIDType GetSelfPid() const override;
   Status GetFileLength(_In_z_ const ORTCHAR_T* file_path, size_t& length) const override;
@@ -113,6 +114,8 @@ class WindowsEnv : public Env {
    * }
    */
   std::vector<LogicalProcessors> cores_;
+  // The efficiency class of each core of "cores_", higher classes are faster and only differ on hybrid CPUs.
+  std::vector<BYTE> core_efficiency_classes_;
   /*
    * "global_processor_info_map_" is a map of:
    * global_processor_id <--> (group_id, local_processor_id)
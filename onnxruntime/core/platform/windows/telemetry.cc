@@ -51,6 +51,11 @@ TRACELOGGING_DEFINE_PROVIDER(telemetry_provider_handle, "Microsoft.ML.ONNXRuntim
                              // {3a26b1ff-7484-7484-7484-15261f42614d}
                              (0x3a26b1ff, 0x7484, 0x7484, 0x74, 0x84, 0x15, 0x26, 0x1f, 0x42, 0x61, 0x4d),
                              TraceLoggingOptionMicrosoftTelemetry());
+
+// Whether a trace session listens to the provider. An event is not built, nor its strings, when none does.
+bool IsProviderListened() {
+  return TraceLoggingProviderEnabled(telemetry_provider_handle, 0, 0);
+}
 }  // namespace
 
 #ifdef _MSC_VER
@@ -177,7 +182,7 @@ void WindowsTelemetry::LogProcessInfo() const {
 }
 
 void WindowsTelemetry::LogSessionCreationStart() const {
-  if (global_register_count_ == 0 || enabled_ == false)
+  if (global_register_count_ == 0 || enabled_ == false || !IsProviderListened())
     return;
 
   TraceLoggingWrite(telemetry_provider_handle,
@@ -189,7 +194,7 @@ void WindowsTelemetry::LogSessionCreationStart() const {
 }
 
 void WindowsTelemetry::LogEvaluationStop() const {
-  if (global_register_count_ == 0 || enabled_ == false)
+  if (global_register_count_ == 0 || enabled_ == false || !IsProviderListened())
     return;
 
   TraceLoggingWrite(telemetry_provider_handle,
@@ -197,7 +202,7 @@ void WindowsTelemetry::LogEvaluationStop() const {
 }
 
 void WindowsTelemetry::LogEvaluationStart() const {
-  if (global_register_count_ == 0 || enabled_ == false)
+  if (global_register_count_ == 0 || enabled_ == false || !IsProviderListened())
     return;
 
   TraceLoggingWrite(telemetry_provider_handle,
@@ -211,7 +216,7 @@ void WindowsTelemetry::LogSessionCreation(uint32_t session_id, int64_t ir_versio
                                           const std::unordered_map<std::string, std::string>& model_metadata,
                                           const std::string& loaded_from, const std::vector<std::string>& execution_provider_ids,
                                           bool use_fp16) const {
-  if (global_register_count_ == 0 || enabled_ == false)
+  if (global_register_count_ == 0 || enabled_ == false || !IsProviderListened())
     return;
 
   // build the strings we need
@@ -278,7 +283,7 @@ void WindowsTelemetry::LogSessionCreation(uint32_t session_id, int64_t ir_versio
 
 void WindowsTelemetry::LogRuntimeError(uint32_t session_id, const common::Status& status, const char* file,
                                        const char* function, uint32_t line) const {
-  if (global_register_count_ == 0 || enabled_ == false)
+  if (global_register_count_ == 0 || enabled_ == false || !IsProviderListened())
     return;
 
 #ifdef _WIN32
@@ -319,7 +324,7 @@ void WindowsTelemetry::LogRuntimeError(uint32_t session_id, const common::Status
 }
 
 void WindowsTelemetry::LogRuntimePerf(uint32_t session_id, uint32_t total_runs_since_last, int64_t total_run_duration_since_last) const {
-  if (global_register_count_ == 0 || enabled_ == false)
+  if (global_register_count_ == 0 || enabled_ == false || !IsProviderListened())
     return;
 
   TraceLoggingWrite(telemetry_provider_handle,
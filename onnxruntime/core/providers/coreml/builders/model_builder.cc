@@ -1,9 +1,17 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 
 #include "core/common/safeint.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/platform/env.h"
 #include "core/providers/common.h"
@@ -400,7 +408,7 @@ std::string GetModelOutputPath(bool create_ml_program) {
 }  // namespace
 
 ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logger& logger,
-                           int32_t coreml_version, uint32_t coreml_flags,
+                           int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                            std::vector<std::string>&& onnx_input_names,
                            std::vector<std::string>&& onnx_output_names)
     : graph_viewer_(graph_viewer),
@@ -409,6 +417,7 @@ ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logge
       coreml_flags_(coreml_flags),
       create_ml_program_((coreml_flags_ & COREML_FLAG_CREATE_MLPROGRAM) != 0),
       model_output_path_(GetModelOutputPath(create_ml_program_)),
+      model_cache_dir_(model_cache_dir),
       onnx_input_names_(std::move(onnx_input_names)),
       onnx_output_names_(std::move(onnx_output_names)),
       coreml_model_(std::make_unique<CoreML::Specification::Model>()) {
@@ -436,7 +445,8 @@ ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logge
     std::string weights_id = mlpackage_->addItem(tmp_dir, "weights", "com.microsoft.OnnxRuntime",
                                                  "CoreML Model Weights");
     auto weights_info = mlpackage_->findItem(weights_id);
-    weights_file_writer_ = std::make_unique<StorageWriter>(weights_info->path() + "/weight.bin");
+    weights_file_path_ = weights_info->path() + "/weight.bin";
+    weights_file_writer_ = std::make_unique<StorageWriter>(weights_file_path_);
 #else
     // should never happen due to handling in coreml_execution_provider.cc
     // throw here so all other code in this class can assume create_ml_program_ is only ever true in a build
@@ -939,7 +949,56 @@ Status ModelBuilder::SaveModel() {
   return Status::OK();
 }
 
+std::string ModelBuilder::GetCompiledModelCachePath() const {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  auto hash_bytes = [&hash](const char* data, size_t size) {
+    // MurmurHash3 takes an int32_t length
+    constexpr size_t kMaxChunkSize = size_t{1} << 30;
+    for (size_t offset = 0; offset < size; offset += kMaxChunkSize) {
+      const size_t chunk_size = std::min(kMaxChunkSize, size - offset);
+      MurmurHash3::x86_128(data + offset, gsl::narrow_cast<int32_t>(chunk_size), hash[0], &hash);
+    }
+  };
+
+  const std::string os_version = util::GetOperatingSystemVersion();
+  hash_bytes(os_version.data(), os_version.size());
+
+  // the serialization of the protobuf maps in the ML Program is only stable if deterministic
+  std::string model_bytes;
+  {
+    google::protobuf::io::StringOutputStream string_stream(&model_bytes);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    coreml_model_->SerializeToCodedStream(&coded_stream);
+  }
+  hash_bytes(model_bytes.data(), model_bytes.size());
+
+#if defined(COREML_ENABLE_MLPROGRAM)
+  if (create_ml_program_) {
+    // the ML Program references the weights in the weights file
+    std::ifstream weights_file(weights_file_path_, std::ifstream::in | std::ifstream::binary);
+    std::vector<char> buffer(size_t{1} << 20);
+    while (weights_file) {
+      weights_file.read(buffer.data(), buffer.size());
+      hash_bytes(buffer.data(), static_cast<size_t>(weights_file.gcount()));
+    }
+  }
+#endif
+
+  std::ostringstream file_name;
+  file_name << std::hex << std::setfill('0');
+  for (const uint32_t value : hash) {
+    file_name << std::setw(8) << value;
+  }
+  file_name << ".mlmodelc";
+
+  return (std::filesystem::path(model_cache_dir_) / file_name.str()).string();
+}
+
 Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
+  const std::string compiled_model_cache_path = model_cache_dir_.empty() ? std::string{}
+                                                                         : GetCompiledModelCachePath();
+
 #if defined(COREML_ENABLE_MLPROGRAM)
   if (create_ml_program_) {
     // we need to provide the sanitized names for model inputs/outputs so that info is captured.
@@ -967,7 +1026,7 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
       return output;
     };
 
-    model = std::make_unique<Model>(model_output_path_,
+    model = std::make_unique<Model>(model_output_path_, compiled_model_cache_path,
                                     get_sanitized_names(std::move(onnx_input_names_)),
                                     get_sanitized_names(std::move(onnx_output_names_)),
                                     get_sanitized_io_info(std::move(input_output_info_)),
@@ -977,7 +1036,7 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
   } else
 #endif
   {
-    model = std::make_unique<Model>(model_output_path_,
+    model = std::make_unique<Model>(model_output_path_, compiled_model_cache_path,
                                     std::move(onnx_input_names_),
                                     std::move(onnx_output_names_),
                                     std::move(input_output_info_),
@@ -991,11 +1050,11 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
 
 // static
 Status ModelBuilder::Build(const GraphViewer& graph_viewer, const logging::Logger& logger,
-                           int32_t coreml_version, uint32_t coreml_flags,
+                           int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                            std::vector<std::string>&& onnx_input_names,
                            std::vector<std::string>&& onnx_output_names,
                            std::unique_ptr<Model>& model) {
-  ModelBuilder builder(graph_viewer, logger, coreml_version, coreml_flags,
+  ModelBuilder builder(graph_viewer, logger, coreml_version, coreml_flags, model_cache_dir,
                        std::move(onnx_input_names), std::move(onnx_output_names));
 
   ORT_RETURN_IF_ERROR(builder.CreateModel());
@@ -29,14 +29,16 @@ class IOpBuilder;
 class ModelBuilder {
  private:
   ModelBuilder(const GraphViewer& graph_viewer, const logging::Logger& logger,
-               int32_t coreml_version, uint32_t coreml_flags,
+               int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                std::vector<std::string>&& onnx_input_names,
                std::vector<std::string>&& onnx_output_names);
 
  public:
-  // Create the CoreML model, serialize to disk, load and compile using the CoreML API and return in `model`
+  // Create the CoreML model, serialize to disk, load and compile using the CoreML API and return in `model`.
+  // If `model_cache_dir` is not empty the compiled model is loaded from the cache in it if there, and added to the
+  // cache otherwise.
   static Status Build(const GraphViewer& graph_viewer, const logging::Logger& logger,
-                      int32_t coreml_version, uint32_t coreml_flags,
+                      int32_t coreml_version, uint32_t coreml_flags, const std::string& model_cache_dir,
                       std::vector<std::string>&& onnx_input_names,
                       std::vector<std::string>&& onnx_output_names,
                       std::unique_ptr<Model>& model);
@@ -190,12 +192,17 @@ class ModelBuilder {
   // Record the onnx int64 type output names
   void AddInt64Output(const std::string& output_name);
 
+  // Path of the compiled model in the model cache. The name of the compiled model is the hash of the saved CoreML
+  // model and of the OS version, as the compiled model is specific to the OS it was compiled on.
+  std::string GetCompiledModelCachePath() const;
+
   const GraphViewer& graph_viewer_;
   const logging::Logger& logger_;
   const int32_t coreml_version_;
   const uint32_t coreml_flags_;
   const bool create_ml_program_;         // ML Program (CoreML5, iOS 15+, macOS 12+) or NeuralNetwork (old)
   const std::string model_output_path_;  // create_ml_program_ ? dir for mlpackage : filename for mlmodel
+  const std::string model_cache_dir_;    // directory of the compiled model cache, empty if not caching
 
   std::vector<std::string> onnx_input_names_;
   std::vector<std::string> onnx_output_names_;
@@ -219,6 +226,7 @@ class ModelBuilder {
   COREML_SPEC::MILSpec::Block* mlprogram_main_block_{nullptr};  // Block that all the operations are added to
   std::unique_ptr<MPL::ModelPackage> mlpackage_;
   std::unique_ptr<MILBlob::Blob::StorageWriter> weights_file_writer_;
+  std::string weights_file_path_;
 
   // Values must start with [a-zA-A_]
   // Additionally they can't be in a list of reserved words.
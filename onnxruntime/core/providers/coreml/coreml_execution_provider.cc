@@ -23,10 +23,11 @@ namespace onnxruntime {
 
 constexpr const char* COREML = "CoreML";
 
-CoreMLExecutionProvider::CoreMLExecutionProvider(uint32_t coreml_flags)
+CoreMLExecutionProvider::CoreMLExecutionProvider(uint32_t coreml_flags, const std::string& model_cache_dir)
     : IExecutionProvider{onnxruntime::kCoreMLExecutionProvider},
       coreml_flags_(coreml_flags),
-      coreml_version_(coreml::util::CoreMLVersion()) {
+      coreml_version_(coreml::util::CoreMLVersion()),
+      model_cache_dir_(model_cache_dir) {
   if (coreml_version_ < MINIMUM_COREML_VERSION) {
     LOGS_DEFAULT(ERROR) << "CoreML EP is not supported on this platform.";
   }
@@ -133,6 +134,7 @@ common::Status CoreMLExecutionProvider::Compile(const std::vector<FusedNodeAndGr
 
       const onnxruntime::GraphViewer& graph_viewer(fused_node_and_graph.filtered_graph);
       ORT_RETURN_IF_ERROR(coreml::ModelBuilder::Build(graph_viewer, *GetLogger(), coreml_version_, coreml_flags_,
+                                                      model_cache_dir_,
                                                       std::move(onnx_input_names), std::move(onnx_output_names),
                                                       coreml_model));
     }
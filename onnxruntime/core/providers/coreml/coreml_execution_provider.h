@@ -14,7 +14,7 @@ class Model;
 
 class CoreMLExecutionProvider : public IExecutionProvider {
  public:
-  CoreMLExecutionProvider(uint32_t coreml_flags);
+  CoreMLExecutionProvider(uint32_t coreml_flags, const std::string& model_cache_dir = {});
   virtual ~CoreMLExecutionProvider();
 
   std::vector<std::unique_ptr<ComputeCapability>>
@@ -31,6 +31,8 @@ class CoreMLExecutionProvider : public IExecutionProvider {
   // COREMLFlags in include/onnxruntime/core/providers/coreml/coreml_provider_factory.h
   uint32_t coreml_flags_;
   const int32_t coreml_version_;
+  // directory of the compiled model cache, empty if the compiled models are not cached
+  const std::string model_cache_dir_;
   ModelMetadefIdGenerator metadef_id_generator_;
 
   // map of fused_node_name to compiled_coreml_model
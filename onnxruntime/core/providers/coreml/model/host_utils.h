@@ -67,6 +67,9 @@ int CoreMLVersion();
 // Get a temporary macOS/iOS temp file path
 std::string GetTemporaryFilePath();
 
+// Get the version of the OS, including its build, e.g. "Version 17.4 (Build 21E213)"
+std::string GetOperatingSystemVersion();
+
 #if !defined(NDEBUG) && defined(__APPLE__)
 // Override location the model is written to so that a) it's easily found and b) it is not automatically deleted
 // when the EP exits. Use to debug the model that is generated.
@@ -54,6 +54,10 @@ std::string GetTemporaryFilePath() {
   return std::string([[temporary_file_url path] UTF8String]);
 }
 
+std::string GetOperatingSystemVersion() {
+  return std::string([[[NSProcessInfo processInfo] operatingSystemVersionString] UTF8String]);
+}
+
 }  // namespace util
 }  // namespace coreml
 }  // namespace onnxruntime
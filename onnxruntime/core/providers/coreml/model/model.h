@@ -34,7 +34,10 @@ using GetOutputTensorMutableRawDataFn = std::function<void*(const std::string& n
 
 class Model {
  public:
+  // `compiled_model_cache_path` is the path of the compiled model in the model cache, or empty if the compiled model
+  // is not cached.
   Model(const std::string& path,
+        const std::string& compiled_model_cache_path,
         std::vector<std::string>&& model_input_names,
         std::vector<std::string>&& model_output_names,
         std::unordered_map<std::string, OnnxTensorInfo>&& input_output_info,
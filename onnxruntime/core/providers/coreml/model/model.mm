@@ -232,21 +232,24 @@ Status CopyMLMultiArrayBuffer(const void* mlmultiarray_buffer, void* tensor_buff
 NS_ASSUME_NONNULL_BEGIN
 
 // Execution for a CoreML model, it performs
-// 1. Compile the model by given path for execution
+// 1. Compile the model by given path for execution, or load the compiled model from the model cache
 // 2. Predict using given OnnxTensorFeatureProvider input and copy the output data back ORT
-// 3. The compiled model will be removed in dealloc or removed using cleanup function
+// 3. The compiled model will be removed in dealloc or removed using cleanup function, unless it is in the model cache
 @interface CoreMLExecution : NSObject {
   NSString* coreml_model_path_;
   NSString* compiled_model_path_;
+  NSString* _Nullable compiled_model_cache_path_;
   const logging::Logger* logger_;
   uint32_t coreml_flags_;
 }
 
 - (instancetype)initWithPath:(const std::string&)path
+      compiledModelCachePath:(const std::string&)compiled_model_cache_path
                       logger:(const logging::Logger&)logger
                 coreml_flags:(uint32_t)coreml_flags;
 - (void)cleanup;
 - (void)dealloc;
+- (NSURL*)addToModelCache:(NSURL*)compileUrl;
 - (Status)loadModel API_AVAILABLE_COREML3;
 - (Status)predict:(const std::unordered_map<std::string, OnnxTensorData>&)inputs
                   outputs:(const std::unordered_map<std::string, OnnxTensorInfo>&)outputs
@@ -261,10 +264,14 @@ NS_ASSUME_NONNULL_BEGIN
 @implementation CoreMLExecution
 
 - (instancetype)initWithPath:(const std::string&)path
+      compiledModelCachePath:(const std::string&)compiled_model_cache_path
                       logger:(const logging::Logger&)logger
                 coreml_flags:(uint32_t)coreml_flags {
   if (self = [super init]) {
     coreml_model_path_ = util::Utf8StringToNSString(path.c_str());
+    compiled_model_cache_path_ = compiled_model_cache_path.empty()
+                                     ? nil
+                                     : util::Utf8StringToNSString(compiled_model_cache_path.c_str());
     logger_ = &logger;
     coreml_flags_ = coreml_flags;
   }
@@ -305,25 +312,79 @@ NS_ASSUME_NONNULL_BEGIN
   [self cleanup];
 }
 
-- (Status)loadModel {
-  NSURL* modelUrl = [NSURL URLWithString:coreml_model_path_];
-  if (modelUrl == nil) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create model URL from path");
+// Move the compiled model at compileUrl to the model cache.
+// Returns the URL to load the compiled model from, which is compileUrl if it could not be moved.
+- (NSURL*)addToModelCache:(NSURL*)compileUrl {
+  NSFileManager* file_manager = [NSFileManager defaultManager];
+  NSError* error = nil;
+
+  NSString* cache_dir = [compiled_model_cache_path_ stringByDeletingLastPathComponent];
+  if (![file_manager createDirectoryAtPath:cache_dir withIntermediateDirectories:YES attributes:nil error:&error]) {
+    LOGS(*logger_, WARNING) << "Failed to create the model cache directory: " << [cache_dir UTF8String]
+                            << ", error message: " << [[error localizedDescription] UTF8String];
+    return compileUrl;
   }
 
-  // TODO: Update this to version with callback handler as the API used here is deprecated.
-  // https://developer.apple.com/documentation/coreml/mlmodel/3929553-compilemodelaturl
-  // As we call loadModel during EP Compile there shouldn't be an issue letting the actual compile run in the
-  // background. We will have to check for completion in `predict` and block until it is done.
-  NSError* error = nil;
-  NSURL* compileUrl = [MLModel compileModelAtURL:modelUrl error:&error];
+  // Move the compiled model to a unique name in the cache directory first and then rename it, so that other
+  // sessions never load a partially written compiled model.
+  NSString* tmp_path = [compiled_model_cache_path_
+      stringByAppendingFormat:@".%@.tmp", [[NSProcessInfo processInfo] globallyUniqueString]];
+  if (![file_manager moveItemAtPath:compiled_model_path_ toPath:tmp_path error:&error]) {
+    LOGS(*logger_, WARNING) << "Failed to add the compiled model to the model cache: "
+                            << [compiled_model_cache_path_ UTF8String]
+                            << ", error message: " << [[error localizedDescription] UTF8String];
+    return compileUrl;
+  }
 
-  if (error != nil) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Error compiling model: ",
-                           [[error localizedDescription] UTF8String]);
+  compiled_model_path_ = tmp_path;
+  if (![file_manager moveItemAtPath:tmp_path toPath:compiled_model_cache_path_ error:&error]) {
+    // another session may have added the same compiled model in the meantime. cleanup removes tmp_path.
+    if (![file_manager fileExistsAtPath:compiled_model_cache_path_]) {
+      LOGS(*logger_, WARNING) << "Failed to add the compiled model to the model cache: "
+                              << [compiled_model_cache_path_ UTF8String]
+                              << ", error message: " << [[error localizedDescription] UTF8String];
+      return [NSURL fileURLWithPath:tmp_path isDirectory:YES];
+    }
+  } else {
+    compiled_model_path_ = nil;
   }
 
-  compiled_model_path_ = [compileUrl path];
+  LOGS(*logger_, INFO) << "Added the compiled model to the model cache: " << [compiled_model_cache_path_ UTF8String];
+  return [NSURL fileURLWithPath:compiled_model_cache_path_ isDirectory:YES];
+}
+
+- (Status)loadModel {
+  NSError* error = nil;
+  NSURL* compileUrl = nil;
+
+  if (compiled_model_cache_path_ != nil &&
+      [[NSFileManager defaultManager] fileExistsAtPath:compiled_model_cache_path_]) {
+    LOGS(*logger_, INFO) << "Loading the compiled model from the model cache: "
+                         << [compiled_model_cache_path_ UTF8String];
+    compileUrl = [NSURL fileURLWithPath:compiled_model_cache_path_ isDirectory:YES];
+  } else {
+    NSURL* modelUrl = [NSURL URLWithString:coreml_model_path_];
+    if (modelUrl == nil) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create model URL from path");
+    }
+
+    // TODO: Update this to version with callback handler as the API used here is deprecated.
+    // https://developer.apple.com/documentation/coreml/mlmodel/3929553-compilemodelaturl
+    // As we call loadModel during EP Compile there shouldn't be an issue letting the actual compile run in the
+    // background. We will have to check for completion in `predict` and block until it is done.
+    compileUrl = [MLModel compileModelAtURL:modelUrl error:&error];
+
+    if (error != nil) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Error compiling model: ",
+                             [[error localizedDescription] UTF8String]);
+    }
+
+    compiled_model_path_ = [compileUrl path];
+
+    if (compiled_model_cache_path_ != nil) {
+      compileUrl = [self addToModelCache:compileUrl];
+    }
+  }
 
   MLModelConfiguration* config = [MLModelConfiguration alloc];
   config.computeUnits = (coreml_flags_ & COREML_FLAG_USE_CPU_ONLY)
@@ -435,7 +496,8 @@ namespace coreml {
 // This class will bridge Model (c++) with CoreMLExecution (objective c++)
 class Execution {
  public:
-  Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags);
+  Execution(const std::string& path, const std::string& compiled_model_cache_path,
+            const logging::Logger& logger, uint32_t coreml_flags);
   ~Execution(){};
 
   Status LoadModel();
@@ -448,9 +510,11 @@ class Execution {
   CoreMLExecution* execution_;
 };
 
-Execution::Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags) {
+Execution::Execution(const std::string& path, const std::string& compiled_model_cache_path,
+                     const logging::Logger& logger, uint32_t coreml_flags) {
   @autoreleasepool {
     execution_ = [[CoreMLExecution alloc] initWithPath:path
+                                compiledModelCachePath:compiled_model_cache_path
                                                 logger:logger
                                           coreml_flags:coreml_flags];
   }
@@ -490,6 +554,7 @@ Status Execution::Predict(const std::unordered_map<std::string, OnnxTensorData>&
 }
 
 Model::Model(const std::string& path,
+             const std::string& compiled_model_cache_path,
              std::vector<std::string>&& model_input_names,
              std::vector<std::string>&& model_output_names,
              std::unordered_map<std::string, OnnxTensorInfo>&& input_output_info,
@@ -497,7 +562,7 @@ Model::Model(const std::string& path,
              std::unordered_set<std::string>&& int64_outputs,
              const logging::Logger& logger,
              uint32_t coreml_flags)
-    : execution_(std::make_unique<Execution>(path, logger, coreml_flags)),
+    : execution_(std::make_unique<Execution>(path, compiled_model_cache_path, logger, coreml_flags)),
       model_input_names_(std::move(model_input_names)),
       model_output_names_(std::move(model_output_names)),
       input_output_info_(std::move(input_output_info)),
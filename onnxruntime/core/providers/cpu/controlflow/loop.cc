@@ -12,8 +12,10 @@
 #include "core/providers/cpu/controlflow/loop.h"
 #include "core/providers/cpu/controlflow/utils.h"
 
+#include "core/common/safeint.h"
 #include "core/framework/allocator.h"
 #include "core/framework/framework_common.h"
+#include "core/framework/mldata_type_utils.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tensorprotoutils.h"
@@ -25,6 +27,8 @@
 
 #include "core/common/gsl.h"
 
+#include <algorithm>
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
@@ -210,11 +214,28 @@ class LoopImpl {
   Status Execute(const FeedsFetchesManager& cached_ffm);
 
  private:
+  // A Loop scan output on CPU is written by the subgraph directly into a slice of a single buffer for all of the
+  // iterations, rather than each iteration allocating its own tensor that is kept until the final concatenation.
+  struct ScanOutputBuffer {
+    // the element type if the output can be written into the buffer, nullptr to keep the per-iteration values
+    MLDataType element_type = nullptr;
+    TensorShape per_iteration_shape;
+    int64_t num_iterations = 0;
+    // flat tensor with room for at least num_iterations slices, grown geometrically
+    OrtValue buffer;
+  };
+
   void CreateInitialFeeds(std::vector<OrtValue>& feeds);
-  void SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+  std::unordered_map<size_t, IExecutor::CustomAllocator> CreateScanOutputAllocators();
+  Status SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs, std::vector<OrtValue>& next_inputs);
+  Status SaveScanOutputs(const std::vector<OrtValue>& last_outputs);
+
+  // returns a tensor over the slice of the buffer for the next iteration, growing the buffer if needed
+  Status GetNextScanOutputSlice(ScanOutputBuffer& scan_output, const TensorShape& shape, OrtValue& slice);
 
   // create the single Loop output from a collection of per-iteration outputs
   Status ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index);
+  Status CopyScanOutputBuffer(const ScanOutputBuffer& scan_output, int output_index);
 
   OpKernelContextInternal& context_;
   const SessionState& session_state_;
@@ -228,9 +249,12 @@ class LoopImpl {
   OrtValue iter_num_mlvalue_;
   OrtValue condition_mlvalue_;
 
-  // collection of OrtValue outputs from each loop iteration for the loop outputs.
-  // the order from the subgraph matches the order from the loop output
+  AllocatorPtr cpu_allocator_;
+
+  // collection of OrtValue outputs from each loop iteration for the loop outputs that are not written into
+  // scan_output_buffers_. the order from the subgraph matches the order from the loop output
   std::vector<std::vector<OrtValue>> loop_output_tensors_;
+  std::vector<ScanOutputBuffer> scan_output_buffers_;
 
   const Loop::ConcatOutput& concat_output_func_;
 };
@@ -428,11 +452,25 @@ Status LoopImpl::Initialize() {
   auto condition_rank = subgraph_inputs[1]->Shape()->dim_size();
 
   // these need to be on CPU
-  auto cpu_allocator = session_state_.GetAllocator(session_state_.GetExecutionProviders().Get(onnxruntime::kCpuExecutionProvider)->GetOrtDeviceByMemType(OrtMemTypeDefault));
-  iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(cpu_allocator, 0, iter_num_rank != 0);
-  condition_mlvalue_ = MakeScalarMLValue<bool>(cpu_allocator, condition_, condition_rank != 0);
-
-  loop_output_tensors_.resize(static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars);
+  cpu_allocator_ = session_state_.GetAllocator(session_state_.GetExecutionProviders().Get(onnxruntime::kCpuExecutionProvider)->GetOrtDeviceByMemType(OrtMemTypeDefault));
+  iter_num_mlvalue_ = MakeScalarMLValue<int64_t>(cpu_allocator_, 0, iter_num_rank != 0);
+  condition_mlvalue_ = MakeScalarMLValue<bool>(cpu_allocator_, condition_, condition_rank != 0);
+
+  const size_t num_scan_outputs = static_cast<size_t>(info_.num_outputs) - info_.num_loop_carried_vars;
+  loop_output_tensors_.resize(num_scan_outputs);
+  scan_output_buffers_.resize(num_scan_outputs);
+
+  // strings can't be copied as raw bytes, so their per-iteration values are kept
+  auto& subgraph_outputs = info_.subgraph.GetOutputs();
+  for (size_t i = 0; i < num_scan_outputs; ++i) {
+    // + 1 to skip the condition, which is the first subgraph output
+    const auto* output = subgraph_outputs[i + info_.num_loop_carried_vars + 1];
+    MLDataType type = output->TypeAsProto() ? utils::GetMLDataType(*output) : nullptr;
+    if (type && type->IsTensorType() &&
+        type->AsTensorType()->GetElementType() != DataTypeImpl::GetType<std::string>()) {
+      scan_output_buffers_[i].element_type = type->AsTensorType()->GetElementType();
+    }
+  }
 
   return status;
 }
@@ -455,8 +493,103 @@ void LoopImpl::CreateInitialFeeds(std::vector<OrtValue>& feeds) {
   }
 }
 
-void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
-                                         std::vector<OrtValue>& next_inputs) {
+std::unordered_map<size_t, IExecutor::CustomAllocator> LoopImpl::CreateScanOutputAllocators() {
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  for (size_t i = 0, end = scan_output_buffers_.size(); i < end; ++i) {
+    if (scan_output_buffers_[i].element_type == nullptr) {
+      continue;
+    }
+
+    // + 1 to skip 'cond' in the subgraph outputs
+    fetch_allocators[i + info_.num_loop_carried_vars + 1] = [this, i](const TensorShape& shape,
+                                                                      const OrtDevice& location,
+                                                                      OrtValue& ort_value, bool& allocated) {
+      auto& scan_output = scan_output_buffers_[i];
+      // outputs on other devices or with a different shape are allocated as usual, and handled by SaveScanOutputs
+      if (location != cpu_allocator_->Info().device ||
+          (scan_output.num_iterations > 0 && shape != scan_output.per_iteration_shape)) {
+        return Status::OK();
+      }
+
+      ORT_RETURN_IF_ERROR(GetNextScanOutputSlice(scan_output, shape, ort_value));
+      allocated = true;
+      return Status::OK();
+    };
+  }
+  return fetch_allocators;
+}
+
+Status LoopImpl::GetNextScanOutputSlice(ScanOutputBuffer& scan_output, const TensorShape& shape, OrtValue& slice) {
+  if (scan_output.num_iterations == 0) {
+    scan_output.per_iteration_shape = shape;
+  }
+
+  const int64_t elements_per_iteration = scan_output.per_iteration_shape.Size();
+  const size_t element_size = scan_output.element_type->Size();
+  const int64_t capacity = scan_output.buffer.IsAllocated() ? scan_output.buffer.Get<Tensor>().Shape().Size() : 0;
+  const int64_t required = (scan_output.num_iterations + 1) * elements_per_iteration;
+  if (!scan_output.buffer.IsAllocated() || required > capacity) {
+    // start with room for a few iterations, bounded by the trip count, and double from there
+    const int64_t initial = std::clamp<int64_t>(max_trip_count_, 1, 16) * elements_per_iteration;
+    OrtValue grown;
+    Tensor::InitOrtValue(scan_output.element_type, TensorShape({std::max({required, 2 * capacity, initial})}),
+                         cpu_allocator_, grown);
+    if (scan_output.num_iterations > 0) {
+      memcpy(grown.GetMutable<Tensor>()->MutableDataRaw(), scan_output.buffer.Get<Tensor>().DataRaw(),
+             SafeInt<size_t>(scan_output.num_iterations) * elements_per_iteration * element_size);
+    }
+    scan_output.buffer = std::move(grown);
+  }
+
+  Tensor& buffer = *scan_output.buffer.GetMutable<Tensor>();
+  void* data = static_cast<uint8_t*>(buffer.MutableDataRaw()) +
+               SafeInt<size_t>(scan_output.num_iterations) * elements_per_iteration * element_size;
+  auto tensor = std::make_unique<Tensor>(scan_output.element_type, shape, data, buffer.Location());
+  // the slice keeps the buffer alive if it is grown while the slice is still used, e.g. as a loop carried var
+  OrtValue owner = scan_output.buffer;
+  slice.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(),
+             [owner](void* p) { delete static_cast<Tensor*>(p); });
+  return Status::OK();
+}
+
+Status LoopImpl::SaveScanOutputs(const std::vector<OrtValue>& last_outputs) {
+  for (size_t i = 0, end = scan_output_buffers_.size(); i < end; ++i) {
+    const auto& value = last_outputs[i + info_.num_loop_carried_vars + 1];  // skip 'cond' in output
+    ORT_RETURN_IF_NOT(value.IsTensor(), "All scan outputs MUST be tensors");
+
+    auto& scan_output = scan_output_buffers_[i];
+    const auto& tensor = value.Get<Tensor>();
+    if (scan_output.element_type == nullptr || tensor.Location().device != cpu_allocator_->Info().device) {
+      // save loop outputs as we have to concatenate at the end
+      loop_output_tensors_[i].push_back(value);
+      continue;
+    }
+
+    if (scan_output.num_iterations > 0 && tensor.Shape() != scan_output.per_iteration_shape) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Inconsistent shape in loop output for output. ",
+                             " Expected:", scan_output.per_iteration_shape, " Got:", tensor.Shape());
+    }
+
+    // the output was not written into the buffer if the subgraph did not allocate it, e.g. if it is an
+    // outer scope value or an input of the subgraph, so copy it there.
+    const auto* expected_data = scan_output.buffer.IsAllocated()
+                                    ? static_cast<const uint8_t*>(scan_output.buffer.Get<Tensor>().DataRaw()) +
+                                          SafeInt<size_t>(scan_output.num_iterations) * tensor.SizeInBytes()
+                                    : nullptr;
+    if (tensor.DataRaw() != expected_data || expected_data == nullptr) {
+      OrtValue slice;
+      ORT_RETURN_IF_ERROR(GetNextScanOutputSlice(scan_output, tensor.Shape(), slice));
+      memcpy(slice.GetMutable<Tensor>()->MutableDataRaw(), tensor.DataRaw(), tensor.SizeInBytes());
+    }
+
+    ++scan_output.num_iterations;
+  }
+
+  return Status::OK();
+}
+
+Status LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outputs,
+                                           std::vector<OrtValue>& next_inputs) {
   // last_output: cond, loop vars..., loop output...
   // next_input: iter_num, cond, loop_vars. iter_num is re-used
 
@@ -465,11 +598,7 @@ void LoopImpl::SaveOutputsAndUpdateFeeds(const std::vector<OrtValue>& last_outpu
     next_inputs[i] = last_outputs[i - 1];
   }
 
-  // save loop outputs as we have to concatenate at the end
-  for (ptrdiff_t j = info_.num_loop_carried_vars; j < info_.num_outputs; ++j) {
-    ORT_ENFORCE(last_outputs[j + 1].IsTensor(), "All scan outputs MUST be tensors");
-    loop_output_tensors_[j - info_.num_loop_carried_vars].push_back(last_outputs[j + 1]);  // skip 'cond' in output
-  }
+  return SaveScanOutputs(last_outputs);
 }
 
 Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_output, int output_index) {
@@ -492,6 +621,34 @@ Status LoopImpl::ConcatenateLoopOutput(std::vector<OrtValue>& per_iteration_outp
   return Status::OK();
 }
 
+Status LoopImpl::CopyScanOutputBuffer(const ScanOutputBuffer& scan_output, int output_index) {
+  const auto per_iteration_dims = scan_output.per_iteration_shape.GetDims();
+
+  std::vector<int64_t> dims;
+  dims.reserve(1 + per_iteration_dims.size());
+
+  // first dimension is number of iterations
+  dims.push_back(scan_output.num_iterations);
+  std::copy(per_iteration_dims.begin(), per_iteration_dims.end(), std::back_inserter(dims));
+
+  TensorShape output_shape{dims};
+  Tensor* output = context_.Output(output_index, output_shape);
+
+  // the used part of the buffer, which is already laid out as the output
+  const Tensor& buffer = scan_output.buffer.Get<Tensor>();
+  const Tensor used(scan_output.element_type, output_shape, const_cast<void*>(buffer.DataRaw()), buffer.Location());
+
+  // Safely use the IDataTransfer abstraction as we only allow using
+  // Loop on CUDA if the copy stream is the same as the compute stream.
+  auto* data_transfer = session_state_.GetDataTransferMgr().GetDataTransfer(used.Location().device,
+                                                                            output->Location().device);
+  ORT_RETURN_IF(data_transfer == nullptr, "No data transfer registered for the Loop output ", output_index);
+  if (context_.GetComputeStream()) {
+    return data_transfer->CopyTensorAsync(used, *output, *context_.GetComputeStream());
+  }
+  return data_transfer->CopyTensor(used, *output);
+}
+
 Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   auto status = Status::OK();
 
@@ -499,16 +656,17 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
   std::vector<OrtValue> fetches;
 
   CreateInitialFeeds(feeds);
+  const auto fetch_allocators = CreateScanOutputAllocators();
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
     if (iter_num_value != 0) {
-      SaveOutputsAndUpdateFeeds(fetches, feeds);
+      ORT_RETURN_IF_ERROR(SaveOutputsAndUpdateFeeds(fetches, feeds));
       fetches.clear();
     }
 
-    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
+    status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger(),
                                     context_.GetComputeStream(),
                                     // because the fetch[0] is the loop condition which we need to access on CPU,
@@ -559,7 +717,9 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
         *output = std::move(*input.GetMutable<TensorSeq>());
       } else {
         // We can't move the Loop's inputs directly into the Loop's outputs
-        // as operator inputs are read-only. Hence, we need to make a copy.
+        // as operator inputs are read-only. Hence, we need to make a new sequence.
+        // The tensors of a sequence are never modified, so those already on
+        // the output device are shared instead of copied.
         auto& data = input.Get<TensorSeq>();
         output->SetType(data.DataType());
         output->Reserve(data.Size());
@@ -567,6 +727,11 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
         AllocatorPtr alloc;
         ORT_RETURN_IF_ERROR(context_.GetTempSpaceAllocator(&alloc));
         for (auto it = data.begin(), end = data.end(); it != end; ++it) {
+          if (it->Get<Tensor>().Location().device == alloc->Info().device) {
+            output->Add(*it);
+            continue;
+          }
+
           Tensor tmp(it->Get<Tensor>().DataType(), it->Get<Tensor>().Shape(), alloc);
           // Safely use the IDataTransfer abstraction as we only allow using
           // Loop on CUDA if the copy stream is the same as the compute stream.
@@ -593,12 +758,17 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
       ORT_RETURN_IF_ERROR(copy_mlvalue_to_output(fetches[static_cast<ptrdiff_t>(i) + 1], i, iter_num_value, *info_.loop_carried_vars_types[static_cast<ptrdiff_t>(i)]));  // skip cond
     }
 
-    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
-      // add last output
-      auto& per_iteration_outputs = loop_output_tensors_[static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars];
-      per_iteration_outputs.push_back(fetches[static_cast<ptrdiff_t>(i) + 1]);  // skip cond
+    // add last output
+    ORT_RETURN_IF_ERROR(SaveScanOutputs(fetches));
 
-      ORT_RETURN_IF_ERROR(ConcatenateLoopOutput(per_iteration_outputs, i));
+    for (int i = info_.num_loop_carried_vars; i < info_.num_outputs; ++i) {
+      const auto scan_output_index = static_cast<ptrdiff_t>(i) - info_.num_loop_carried_vars;
+      auto& per_iteration_outputs = loop_output_tensors_[scan_output_index];
+      if (per_iteration_outputs.empty()) {
+        ORT_RETURN_IF_ERROR(CopyScanOutputBuffer(scan_output_buffers_[scan_output_index], i));
+      } else {
+        ORT_RETURN_IF_ERROR(ConcatenateLoopOutput(per_iteration_outputs, i));
+      }
     }
   } else {
     // no iterations.
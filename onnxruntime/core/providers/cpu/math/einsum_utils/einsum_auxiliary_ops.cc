@@ -3,6 +3,10 @@
 
 #include "einsum_auxiliary_ops.h"
 
+#include <type_traits>
+
+#include "core/mlas/inc/mlas.h"
+
 using namespace onnxruntime::common;
 
 namespace onnxruntime {
@@ -34,6 +38,24 @@ Status MatMul(const T* input_1_data, const T* input_2_data, T* output_data,
               size_t left_stride, size_t right_stride, size_t output_stride,
               size_t num_batches, size_t M, size_t K, size_t N, concurrency::ThreadPool* tp,
               void* /*einsum_cuda_assets*/) {
+  if constexpr (std::is_same_v<T, float>) {
+    // Hand every batch to MLAS in a single call so that the batches and the tiles of each GEMM
+    // are partitioned across the thread pool together, instead of one GEMM at a time
+    std::vector<MLAS_SGEMM_DATA_PARAMS> data(num_batches);
+    for (size_t i = 0; i < num_batches; ++i) {
+      data[i].A = input_1_data + i * left_stride;
+      data[i].lda = K;
+      data[i].B = input_2_data + i * right_stride;
+      data[i].ldb = N;
+      data[i].C = output_data + i * output_stride;
+      data[i].ldc = N;
+      data[i].alpha = 1.0f;
+      data[i].beta = 0.0f;
+    }
+    MlasGemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, data.data(), num_batches, tp);
+    return Status::OK();
+  }
+
   for (size_t i = 0; i < num_batches; ++i) {
     math::MatMul<T>(
         static_cast<int>(M),
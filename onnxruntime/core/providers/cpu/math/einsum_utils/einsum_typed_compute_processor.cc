@@ -5,8 +5,154 @@
 #include "core/common/narrow.h"
 #include "core/common/span_utils.h"
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+
 namespace onnxruntime {
 
+namespace {
+
+// Operands with up to this many inputs have every pairwise contraction order evaluated,
+// beyond that the order is picked greedily
+constexpr size_t kEinsumExhaustivePathSearchMaxOperands = 6;
+
+// A step of a contraction path: the positions of the two operands (in the list of remaining operands) to contract.
+// Both operands are removed from the list and their result is appended to its end.
+using EinsumContractionPath = std::vector<std::pair<size_t, size_t>>;
+
+struct EinsumContractionPlanner {
+  // Homogenized dims of each operand (rank == num subscript labels, 1 for labels the operand doesn't have)
+  std::vector<TensorShapeVector> operands;
+  // Whether each subscript label shows up in the op's output
+  std::vector<bool> label_in_output;
+
+  // Dims of the operand obtained by contracting operands `a` and `b`: labels that neither the output
+  // nor any of the other remaining operands need are summed away
+  TensorShapeVector ContractedDims(size_t a, size_t b) const {
+    const auto num_labels = label_in_output.size();
+    TensorShapeVector dims(num_labels, 1);
+    for (size_t label = 0; label < num_labels; ++label) {
+      const int64_t dim = std::max(operands[a][label], operands[b][label]);
+      if (dim != 1 && IsLabelNeeded(label, a, b)) {
+        dims[label] = dim;
+      }
+    }
+    return dims;
+  }
+
+  bool IsLabelNeeded(size_t label, size_t a, size_t b) const {
+    if (label_in_output[label]) {
+      return true;
+    }
+    for (size_t k = 0; k < operands.size(); ++k) {
+      if (k != a && k != b && operands[k][label] != 1) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Number of multiply-adds of contracting operands `a` and `b`
+  double ContractionCost(size_t a, size_t b) const {
+    double cost = 1.0;
+    for (size_t label = 0; label < label_in_output.size(); ++label) {
+      cost *= static_cast<double>(std::max(operands[a][label], operands[b][label]));
+    }
+    return cost;
+  }
+
+  void Contract(size_t a, size_t b) {
+    auto dims = ContractedDims(a, b);
+    operands.erase(operands.begin() + b);
+    operands.erase(operands.begin() + a);
+    operands.push_back(std::move(dims));
+  }
+
+  void Search(double cost_so_far, EinsumContractionPath& path, double& best_cost, EinsumContractionPath& best_path) {
+    if (cost_so_far >= best_cost) {
+      return;
+    }
+    if (operands.size() == 1) {
+      best_cost = cost_so_far;
+      best_path = path;
+      return;
+    }
+    for (size_t a = 0; a < operands.size(); ++a) {
+      for (size_t b = a + 1; b < operands.size(); ++b) {
+        const double cost = ContractionCost(a, b);
+        auto saved = operands;
+        Contract(a, b);
+        path.emplace_back(a, b);
+        Search(cost_so_far + cost, path, best_cost, best_path);
+        path.pop_back();
+        operands = std::move(saved);
+      }
+    }
+  }
+
+  double PathCost(const EinsumContractionPath& path) {
+    auto saved = operands;
+    double cost = 0.0;
+    for (const auto& step : path) {
+      cost += ContractionCost(step.first, step.second);
+      Contract(step.first, step.second);
+    }
+    operands = std::move(saved);
+    return cost;
+  }
+};
+
+// Picks the order in which to contract the operands of the op, minimizing the total number of multiply-adds.
+// The left-to-right order the op has always used is kept unless another order is strictly cheaper.
+EinsumContractionPath ComputeEinsumContractionPath(EinsumContractionPlanner planner) {
+  const size_t num_operands = planner.operands.size();
+
+  EinsumContractionPath path;
+  path.emplace_back(0, 1);
+  for (size_t remaining = num_operands - 1; remaining > 1; --remaining) {
+    // The running result sits at the end of the list and is contracted with the next input at its front
+    path.emplace_back(0, remaining - 1);
+  }
+
+  if (num_operands <= 2) {
+    return path;
+  }
+
+  const double path_cost = planner.PathCost(path);
+  EinsumContractionPath best_path;
+  double best_cost = path_cost;
+
+  if (num_operands <= kEinsumExhaustivePathSearchMaxOperands) {
+    // Only records paths that are strictly cheaper than the left-to-right one
+    EinsumContractionPath current;
+    current.reserve(num_operands - 1);
+    planner.Search(0.0, current, best_cost, best_path);
+  } else {
+    best_cost = 0.0;
+    while (planner.operands.size() > 1) {
+      std::pair<size_t, size_t> best_step{0, 1};
+      double best_step_cost = std::numeric_limits<double>::max();
+      for (size_t a = 0; a < planner.operands.size(); ++a) {
+        for (size_t b = a + 1; b < planner.operands.size(); ++b) {
+          const double cost = planner.ContractionCost(a, b);
+          if (cost < best_step_cost) {
+            best_step_cost = cost;
+            best_step = {a, b};
+          }
+        }
+      }
+      best_cost += best_step_cost;
+      planner.Contract(best_step.first, best_step.second);
+      best_path.push_back(best_step);
+    }
+  }
+
+  return !best_path.empty() && best_cost < path_cost ? best_path : path;
+}
+
+}  // namespace
+
 template <typename T>
 void EinsumTypedComputeProcessor<T>::FinalizeOutput(const Tensor& candidate_output,
                                                     const gsl::span<const int64_t>& ordered_subscript_indices_in_candidate) {
@@ -398,28 +544,110 @@ Status EinsumTypedComputeProcessor<T>::Run() {
     }
   }
 
-  // Process the operands in a pair-wise fashion
+  // Process the operands in a pair-wise fashion, in the order that needs the least compute
   {
-    bool is_final_pair = false;
-    // Keep processing each input pair-wise
+    const auto& subscript_indices_to_output_indices = einsum_compute_preprocessor_.GetMappedSubscriptIndicesToOutputindices();
+    const size_t num_labels = onnxruntime::narrow<size_t>(num_subscript_labels);
+
+    // The operands still to be contracted, along with their (homogenized) shapes
+    std::vector<std::unique_ptr<const Tensor>> owned_operands;
+    std::vector<const Tensor*> operands;
+    std::vector<TensorShape> operand_shapes;
+    // Whether the operand is the result of an earlier contraction
+    std::vector<bool> is_intermediate;
+    owned_operands.reserve(onnxruntime::narrow<size_t>(num_inputs));
+    operands.reserve(onnxruntime::narrow<size_t>(num_inputs));
+    operand_shapes.reserve(onnxruntime::narrow<size_t>(num_inputs));
+
+    operands.push_back(result ? result.get() : raw_inputs[0]);
+    operand_shapes.push_back(result ? result->Shape() : homogenized_input_dims[0]);
+    owned_operands.push_back(std::move(result));
     for (int input = 1; input < num_inputs; ++input) {
+      operands.push_back(preprocessed_inputs[input] ? preprocessed_inputs[input].get() : raw_inputs[input]);
+      operand_shapes.push_back(homogenized_input_dims[input]);
+      owned_operands.emplace_back();
+    }
+    is_intermediate.resize(operands.size(), false);
+
+    EinsumContractionPlanner planner;
+    planner.label_in_output.resize(num_labels);
+    for (size_t label = 0; label < num_labels; ++label) {
+      planner.label_in_output[label] = subscript_indices_to_output_indices[label] != -1;
+    }
+
+    // Sum away the dims that only one of the other inputs has before contracting anything,
+    // so that the contraction costs below only account for dims shared between operands
+    for (size_t k = 1; k < operands.size(); ++k) {
+      TensorShapeVector reduced_dims;
+      for (size_t label = 0; label < num_labels; ++label) {
+        if (planner.label_in_output[label] || operand_shapes[k][label] == 1) {
+          continue;
+        }
+        bool is_unique = true;
+        for (size_t other = 0; other < operands.size() && is_unique; ++other) {
+          is_unique = other == k || operand_shapes[other][label] == 1;
+        }
+        if (is_unique) {
+          reduced_dims.push_back(static_cast<int64_t>(label));
+        }
+      }
+      if (!reduced_dims.empty()) {
+        owned_operands[k] = EinsumOp::ReduceSum<T>(*operands[k], operand_shapes[k].GetDims(), reduced_dims, allocator_, tp_,
+                                                   einsum_ep_assets_, device_reduce_sum_func_);
+        operands[k] = owned_operands[k].get();
+        operand_shapes[k] = operands[k]->Shape();
+      }
+    }
+
+    for (const auto& shape : operand_shapes) {
+      planner.operands.emplace_back(shape.AsShapeVector());
+    }
+    const auto path = ComputeEinsumContractionPath(planner);
+
+    for (const auto& step : path) {
+      const size_t a = step.first;
+      const size_t b = step.second;
+
       TensorShapeVector reduced_dims;
-      reduced_dims.reserve(onnxruntime::narrow<size_t>(num_subscript_labels));  // num_subscript_labels is the upper bound. No harm in over-reserving by a small margin.
-      for (int64_t dim = 0; dim < num_subscript_labels; ++dim) {
-        if (mapped_indices_to_last_input_index[onnxruntime::narrow<size_t>(dim)] == input) {
-          // This is the last input we are seeing this dimension (and it doesn't occur in the output), so reduce along the dimension
-          reduced_dims.push_back(dim);
+      reduced_dims.reserve(num_labels);
+      for (size_t label = 0; label < num_labels; ++label) {
+        if (planner.label_in_output[label] ||
+            (operand_shapes[a][label] == 1 && operand_shapes[b][label] == 1)) {
+          continue;
+        }
+        bool is_needed = false;
+        for (size_t other = 0; other < operands.size() && !is_needed; ++other) {
+          is_needed = other != a && other != b && operand_shapes[other][label] != 1;
+        }
+        if (!is_needed) {
+          // No remaining operand has this dimension (and it doesn't occur in the output), so reduce along the dimension
+          reduced_dims.push_back(static_cast<int64_t>(label));
         }
       }
-      if (input == num_inputs - 1) {
-        is_final_pair = true;
+
+      // Intermediate results are appended at the end of the list and stay the left operand,
+      // which is the layout the left-to-right order has always produced
+      const size_t left = is_intermediate[b] ? b : a;
+      const size_t right = is_intermediate[b] ? a : b;
+      const bool is_final_pair = operands.size() == 2;
+
+      auto contracted = PairwiseOperandProcess(*operands[left], operand_shapes[left],
+                                               *operands[right], operand_shapes[right],
+                                               reduced_dims, is_final_pair);
+      if (is_final_pair) {
+        break;
+      }
+
+      for (size_t index : {b, a}) {
+        owned_operands.erase(owned_operands.begin() + index);
+        operands.erase(operands.begin() + index);
+        operand_shapes.erase(operand_shapes.begin() + index);
+        is_intermediate.erase(is_intermediate.begin() + index);
       }
-      // Use either the preprocessed inputs (if it is available) or the corresponding raw inputs
-      result = PairwiseOperandProcess(result ? *result : *raw_inputs[0],
-                                      result ? result->Shape() : homogenized_input_dims[0],
-                                      preprocessed_inputs[input] ? *preprocessed_inputs[input] : *raw_inputs[input],
-                                      homogenized_input_dims[input],
-                                      reduced_dims, is_final_pair);
+      operands.push_back(contracted.get());
+      operand_shapes.push_back(contracted->Shape());
+      owned_operands.push_back(std::move(contracted));
+      is_intermediate.push_back(true);
     }
   }
 
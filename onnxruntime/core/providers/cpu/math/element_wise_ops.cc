@@ -12,7 +12,9 @@
 #include "core/util/math.h"
 #include "core/mlas/inc/mlas.h"
 
+#include <algorithm>
 #include <cmath>
+#include <functional>
 
 namespace onnxruntime {
 // Supported types for operators that have type reduction enabled
@@ -153,6 +155,17 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
           .TypeConstraint("T1", T2_CONSTRAINTS),                                                 \
       KERNEL_CLASS);
 
+// Half precision Add, Sub, Mul and Div are computed in float a block at a time, and only registered when MLAS
+// converts half precision with vector instructions, see RegisterFp16ComputeKernels().
+template <>
+Status Add<MLFloat16>::Compute(OpKernelContext* context) const;
+template <>
+Status Sub<MLFloat16>::Compute(OpKernelContext* context) const;
+template <>
+Status Mul<MLFloat16>::Compute(OpKernelContext* context) const;
+template <>
+Status Div<MLFloat16>::Compute(OpKernelContext* context) const;
+
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, float, Add);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, double, Add);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, int32_t, Add);
@@ -165,6 +178,9 @@ REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, float, Add);
 REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, double, Add);
 REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, int32_t, Add);
 REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, int64_t, Add);
+REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, MLFloat16, Add);
+REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 13, 13, MLFloat16, Add);
+REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, MLFloat16, Add);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, float, Sub);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, double, Sub);
@@ -178,6 +194,9 @@ REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, float, Sub);
 REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, double, Sub);
 REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, int32_t, Sub);
 REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, int64_t, Sub);
+REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, MLFloat16, Sub);
+REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, MLFloat16, Sub);
+REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, MLFloat16, Sub);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, float, Mul);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, double, Mul);
@@ -191,6 +210,9 @@ REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, float, Mul);
 REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, double, Mul);
 REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, int32_t, Mul);
 REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, int64_t, Mul);
+REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, MLFloat16, Mul);
+REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, MLFloat16, Mul);
+REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, MLFloat16, Mul);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, float, Div);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, double, Div);
@@ -204,6 +226,9 @@ REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, float, Div);
 REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, double, Div);
 REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, int32_t, Div);
 REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, int64_t, Div);
+REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, MLFloat16, Div);
+REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 13, 13, MLFloat16, Div);
+REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, MLFloat16, Div);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, float, Abs);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, double, Abs);
@@ -533,6 +558,84 @@ Status Div<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+namespace {
+constexpr size_t kFp16BlockSize = 1024;
+
+// Computes op over a span of half precision values a block at a time. A scalar input has a count of 1.
+template <typename Op>
+void ComputeFp16BinarySpan(gsl::span<const MLFloat16> input0, gsl::span<const MLFloat16> input1,
+                           gsl::span<MLFloat16> output) {
+  float block0[kFp16BlockSize];
+  float block1[kFp16BlockSize];
+  float result[kFp16BlockSize];
+  if (input0.size() == 1) {
+    std::fill_n(block0, kFp16BlockSize, input0[0].ToFloat());
+  }
+  if (input1.size() == 1) {
+    std::fill_n(block1, kFp16BlockSize, input1[0].ToFloat());
+  }
+
+  const Op op;
+  for (size_t start = 0; start < output.size(); start += kFp16BlockSize) {
+    const size_t count = std::min(kFp16BlockSize, output.size() - start);
+    if (input0.size() != 1) {
+      MlasConvertFp16ToFloatBuffer(input0.data() + start, block0, count);
+    }
+    if (input1.size() != 1) {
+      MlasConvertFp16ToFloatBuffer(input1.data() + start, block1, count);
+    }
+    for (size_t i = 0; i < count; i++) {
+      result[i] = op(block0[i], block1[i]);
+    }
+    MlasConvertFloatToHalfBuffer(result, output.data() + start, count);
+  }
+}
+
+template <typename Op>
+void ComputeFp16Binary(OpKernelContext& context) {
+  ProcessBroadcastSpanFuncs funcs{
+      [](BroadcastHelper& per_iter_bh) {
+        ComputeFp16BinarySpan<Op>(gsl::make_span(&per_iter_bh.ScalarInput0<MLFloat16>(), 1),
+                                  per_iter_bh.SpanInput1<MLFloat16>(), per_iter_bh.OutputSpan<MLFloat16>());
+      },
+      [](BroadcastHelper& per_iter_bh) {
+        ComputeFp16BinarySpan<Op>(per_iter_bh.SpanInput0<MLFloat16>(),
+                                  gsl::make_span(&per_iter_bh.ScalarInput1<MLFloat16>(), 1),
+                                  per_iter_bh.OutputSpan<MLFloat16>());
+      },
+      [](BroadcastHelper& per_iter_bh) {
+        ComputeFp16BinarySpan<Op>(per_iter_bh.SpanInput0<MLFloat16>(), per_iter_bh.SpanInput1<MLFloat16>(),
+                                  per_iter_bh.OutputSpan<MLFloat16>());
+      }};
+
+  UntypedBroadcastTwo(context, funcs, 1.0);
+}
+}  // namespace
+
+template <>
+Status Add<MLFloat16>::Compute(OpKernelContext* context) const {
+  ComputeFp16Binary<std::plus<float>>(*context);
+  return Status::OK();
+}
+
+template <>
+Status Sub<MLFloat16>::Compute(OpKernelContext* context) const {
+  ComputeFp16Binary<std::minus<float>>(*context);
+  return Status::OK();
+}
+
+template <>
+Status Mul<MLFloat16>::Compute(OpKernelContext* context) const {
+  ComputeFp16Binary<std::multiplies<float>>(*context);
+  return Status::OK();
+}
+
+template <>
+Status Div<MLFloat16>::Compute(OpKernelContext* context) const {
+  ComputeFp16Binary<std::divides<float>>(*context);
+  return Status::OK();
+}
+
 namespace pow_internal {
 
 template <typename T, typename E>
@@ -189,7 +189,7 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
 #if defined(__GNUC__) && defined(HAS_CLASS_MEMACCESS)
 #pragma GCC diagnostic pop
 #endif
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) || defined(MLAS_TARGET_AMD64)
   bool support_mlas = false;
   if (c_shape == nullptr) {
     support_mlas = true;
@@ -198,7 +198,14 @@ void Gemm<MLFloat16>::ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans
   } else if (c_shape->NumDimensions() == 2 && (((*c_shape)[0] == 1 && (*c_shape)[1] == N) || ((*c_shape)[0] == N && (*c_shape)[1] == 1))) {
     support_mlas = true;
   }
-  if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 && beta.ToFloat() == 1.0) {
+#if !defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
+  // On x64 the default MLAS half gemm kernel is slower than Eigen, only use
+  // MLAS with the F16C or AVX512-FP16 kernels.
+  support_mlas = support_mlas && MlasHalfGemmAccelerationSupported();
+#endif
+  // beta has been cleared above when there is no bias.
+  if (trans_a == CblasNoTrans && trans_b == CblasNoTrans && support_mlas && alpha.ToFloat() == 1.0 &&
+      (c_data == nullptr || beta.ToFloat() == 1.0)) {
     MLAS_HALF_GEMM_DATA_PARAMS data;
     data.A = a_data;
     data.lda = K;
@@ -4,6 +4,7 @@
 #include "core/providers/cpu/math/matmul.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/cpu/math/sgemm_tunable.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -88,6 +89,30 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("T", BuildKernelDefConstraints<int64_t, uint64_t>()),
     MatMul<int64_t>);
 
+// Half precision is computed by the MLAS half gemm, and only registered when MLAS has a vectorized kernel for it,
+// see RegisterFp16GemmKernels().
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1, 8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    9,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
@@ -124,7 +149,48 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
-#if defined(__aarch64__) && defined(__linux__)
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* a = ctx->Input<Tensor>(0);
+  const auto* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  auto* y_data = y->MutableData<MLFloat16>();
+  if (helper.K() == 0) {
+    // the bits of a half precision 0 are all 0
+    memset(y_data, 0, y->SizeInBytes());
+    return Status::OK();
+  }
+
+  const auto* a_data = a->Data<MLFloat16>();
+  const auto* b_data = b->Data<MLFloat16>();
+
+  const size_t max_len = helper.OutputOffsets().size();
+  InlinedVector<MLAS_HALF_GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = static_cast<size_t>(helper.K());
+    data[i].B = b_data + helper.RightOffsets()[i];
+    data[i].ldb = static_cast<size_t>(helper.N());
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = static_cast<size_t>(helper.N());
+  }
+  MlasHalfGemmBatch(static_cast<size_t>(helper.M()), static_cast<size_t>(helper.N()), static_cast<size_t>(helper.K()),
+                    max_len, data.data(), thread_pool);
+
+  return Status::OK();
+}
+
+#if defined(MLAS_SUPPORTS_SBGEMM)
 bool GemmPackBBfloat16(AllocatorPtr& alloc,
                        const Tensor& tensor_b,
                        bool trans_b,
@@ -163,6 +229,40 @@ bool GemmPackBBfloat16(AllocatorPtr& alloc,
 }
 #endif
 
+// Packs B into the sparse format of MlasSparseGemm if at least min_sparsity of its elements are zero.
+bool GemmPackBSparse(AllocatorPtr& alloc,
+                     const Tensor& tensor_b,
+                     bool trans_b,
+                     float min_sparsity,
+                     IAllocatorUniquePtr<void>& packed_b,
+                     size_t& packed_b_size,
+                     TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2 || tensor_b.Shape().Size() == 0) {
+    return false;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(tensor_b.Shape()[1]) : static_cast<size_t>(tensor_b.Shape()[0]);
+  const size_t N = trans_b ? static_cast<size_t>(tensor_b.Shape()[0]) : static_cast<size_t>(tensor_b.Shape()[1]);
+  const CBLAS_TRANSPOSE trans = trans_b ? CblasTrans : CblasNoTrans;
+  const size_t ldb = trans_b ? K : N;
+  const float* b_data = tensor_b.Data<float>();
+
+  const size_t num_zeros = K * N - MlasSparseGemmCountNonZeros(trans, N, K, b_data, ldb);
+  if (static_cast<double>(num_zeros) < static_cast<double>(min_sparsity) * static_cast<double>(K * N)) {
+    return false;
+  }
+
+  packed_b_size = MlasSparseGemmPackBSize(trans, N, K, b_data, ldb);
+  if (packed_b_size == 0) {
+    return false;
+  }
+
+  packed_b = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size, true);
+  MlasSparseGemmPackB(trans, N, K, b_data, ldb, packed_b.get());
+  b_shape = tensor_b.Shape();
+  return true;
+}
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -171,22 +271,31 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   // only pack Matrix B
   if (input_idx == 1) {
     size_t packed_b_size;
-#if defined(__aarch64__) && defined(__linux__)
-    size_t dim1 = 0;
-    size_t dim2 = 0;
-    TensorShape b_shape = tensor.Shape();
-
-    if (b_shape.NumDimensions() == 2) {
-      dim1 = static_cast<size_t>(b_shape[0]);
-      dim2 = static_cast<size_t>(b_shape[1]);
+    // the sparse kernel doesn't transpose A, and the dense B is not kept for the nodes that would
+    if (sparse_min_sparsity_ >= 0.0f && trans_a_attr_ == 0 && !trans_batch_a_ && !trans_batch_b_) {
+      packed_b_is_sparse_ = GemmPackBSparse(alloc, tensor, trans_b_attr_ != 0, sparse_min_sparsity_, packed_b_,
+                                            packed_b_size, b_shape_);
+      is_packed = packed_b_is_sparse_;
     }
 
-    if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kFastMathModeKernelsizeThreshold)) {
-      is_packed = GemmPackBBfloat16(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
-    } else
+    if (!is_packed) {
+#if defined(MLAS_SUPPORTS_SBGEMM)
+      size_t dim1 = 0;
+      size_t dim2 = 0;
+      TensorShape b_shape = tensor.Shape();
+
+      if (b_shape.NumDimensions() == 2) {
+        dim1 = static_cast<size_t>(b_shape[0]);
+        dim2 = static_cast<size_t>(b_shape[1]);
+      }
+
+      if (use_fastmath_mode_ && (trans_b_attr_ == 0) && ((dim1 * dim2) >= kFastMathModeKernelsizeThreshold)) {
+        is_packed = GemmPackBBfloat16(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      } else
 #endif
-    {
-      is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      {
+        is_packed = GemmPackBFp32(alloc, tensor, trans_b_attr_ != 0, packed_b_, packed_b_size, b_shape_);
+      }
     }
 
     bool share_prepacked_weights = (prepacked_weights != nullptr);
@@ -206,11 +315,31 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   if (input_idx == 1) {
     used_shared_buffers = true;
     packed_b_ = std::move(prepacked_buffers[0]);
+
+    // PrePack() may have been skipped, so restore the shape of B from the constant input
+    const Tensor* b = nullptr;
+    if (Info().TryGetConstantInput(1, &b)) {
+      b_shape_ = b->Shape();
+    }
   }
 
   return Status::OK();
 }
 
+bool MatMul<float>::CanSkipPrePackWithPersistedBuffers(int input_idx) const {
+  // the packing format of B depends on its sparsity
+  if (sparse_min_sparsity_ >= 0.0f) {
+    return false;
+  }
+#if defined(MLAS_SUPPORTS_SBGEMM)
+  // the packing format of B depends on a session option in fastmath mode
+  if (use_fastmath_mode_) {
+    return false;
+  }
+#endif
+  return input_idx == 1;
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -240,7 +369,13 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
-#if defined(__aarch64__) && defined(__linux__)
+  if (packed_b_is_sparse_) {
+    for (size_t i = 0; i < max_len; i++) {
+      MlasSparseGemm(M, N, K, alpha_attr_, a_data + helper.LeftOffsets()[i], lda, packed_b_.get(),
+                     y_data + helper.OutputOffsets()[i], N, thread_pool);
+    }
+  } else
+#if defined(MLAS_SUPPORTS_SBGEMM)
   if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
     for (size_t i = 0; i < max_len; i++) {
@@ -271,8 +406,15 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
       data[i].alpha = alpha_attr_;
       data[i].beta = 0.0f;
     }
-    MlasGemmBatch(trans_a ? CblasTrans : CblasNoTrans, trans_b ? CblasTrans : CblasNoTrans,
-                  M, N, K, data.data(), max_len, thread_pool);
+    // The kernel may also be registered by other execution providers, whose tuning context is not a CPU one.
+    cpu::tunable::CpuTuningContext* tuning_ctx = nullptr;
+    if (Info().GetExecutionProvider()->Type() == kCpuExecutionProvider) {
+      tuning_ctx = static_cast<cpu::tunable::CpuTuningContext*>(Info().GetExecutionProvider()->GetTuningContext());
+    }
+    cpu::tunable::SgemmBatchParams params(tuning_ctx, trans_a ? CblasTrans : CblasNoTrans,
+                                          trans_b ? CblasTrans : CblasNoTrans, M, N, K, data.data(), max_len,
+                                          thread_pool);
+    ORT_RETURN_IF_ERROR(cpu::tunable::SgemmBatch(&params));
   }
   return Status::OK();
 }
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/common/parse_string.h"
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -17,6 +18,9 @@ class MatMul final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* context) const;
+
 template <>
 class MatMul<float> final : public OpKernel {
  public:
@@ -30,9 +34,19 @@ class MatMul<float> final : public OpKernel {
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
 
-#if defined(__aarch64__) && defined(__linux__)
-    auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
-    use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
+    const auto& config_options = info.GetConfigOptions();
+    const std::string sparse_min_sparsity =
+        config_options.GetConfigOrDefault(kOrtSessionOptionsMlasSparseGemmMinSparsity, "");
+    if (!sparse_min_sparsity.empty()) {
+      ORT_ENFORCE(TryParseStringWithClassicLocale(sparse_min_sparsity, sparse_min_sparsity_) &&
+                      sparse_min_sparsity_ >= 0.0f && sparse_min_sparsity_ <= 1.0f,
+                  "Invalid value of ", kOrtSessionOptionsMlasSparseGemmMinSparsity, ": ", sparse_min_sparsity);
+    }
+
+#if defined(MLAS_SUPPORTS_SBGEMM)
+    use_fastmath_mode_ = (config_options.GetConfigOrDefault(kOrtSessionOptionsMlasGemmFastMathBfloat16, "0") == "1" ||
+                          config_options.GetConfigOrDefault(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16, "0") == "1") &&
+                         MlasBf16AccelerationSupported();
 #endif
   }
 
@@ -43,12 +57,18 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  bool CanSkipPrePackWithPersistedBuffers(int input_idx) const override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
 
+  // minimum fraction of zeros of B for it to be packed by MlasSparseGemmPackB, or a negative value if disabled
+  float sparse_min_sparsity_ = -1.0f;
+  bool packed_b_is_sparse_ = false;
+
   // For FusedMatMul contrib ops
   float alpha_attr_;
   int64_t trans_a_attr_;
@@ -56,10 +76,10 @@ class MatMul<float> final : public OpKernel {
   bool trans_batch_a_;
   bool trans_batch_b_;
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SUPPORTS_SBGEMM)
   // fastmath mode state
   bool use_fastmath_mode_;
-  // sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
+  // the arm64 sbgemm kernel is implemented as 8x8 blocks with weights pre-packed to 4 blocks of 4x2
   // so a minimum of 32 elements is defined to outweigh the additional prepacking overhead
   const size_t kFastMathModeKernelsizeThreshold = 32;
 #endif
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/math/sgemm_tunable.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+namespace {
+
+// Column blocks of N assigned to the threads, see MLAS_SGEMM_STRIDEN_THREAD_ALIGN in MLAS.
+constexpr size_t kSgemmStrideNThreadAlign = 16;
+
+ptrdiff_t ThreadsPerGemm(const SgemmBatchParams* params) {
+  const ptrdiff_t thread_count = concurrency::ThreadPool::DegreeOfParallelism(params->thread_pool);
+  const ptrdiff_t batch_size = static_cast<ptrdiff_t>(params->batch_size);
+  return std::max<ptrdiff_t>(1, (thread_count + batch_size - 1) / batch_size);
+}
+
+Status DefaultPartition(const SgemmBatchParams* params) {
+  MlasGemmBatch(params->trans_a, params->trans_b, params->m, params->n, params->k,
+                params->data, params->batch_size, params->thread_pool);
+  return Status::OK();
+}
+
+Status Partition(const SgemmBatchParams* params, ptrdiff_t thread_count_m, ptrdiff_t thread_count_n) {
+  MlasGemmBatch(params->trans_a, params->trans_b, params->m, params->n, params->k,
+                params->data, params->batch_size, thread_count_m, thread_count_n, params->thread_pool);
+  return Status::OK();
+}
+
+enum class PartitionKind {
+  M,
+  N,
+  MN,
+};
+
+// Splits the threads of a GEMM along M, along N or both, the latter in proportion to the number of rows and
+// column blocks so that the threads compute tiles close to square. ThreadDivisor > 1 uses fewer threads than the
+// pool has, which is faster when the GEMM is too small to amortize the synchronization of all the threads.
+template <PartitionKind Kind, int ThreadDivisor>
+Status PartitionOp(const SgemmBatchParams* params) {
+  const ptrdiff_t threads = ThreadsPerGemm(params) / ThreadDivisor;
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(threads < 2, "Not enough threads to partition the GEMM");
+
+  if constexpr (Kind == PartitionKind::M) {
+    return Partition(params, threads, 1);
+  } else if constexpr (Kind == PartitionKind::N) {
+    return Partition(params, 1, threads);
+  } else {
+    const double blocked_n = static_cast<double>((params->n + kSgemmStrideNThreadAlign - 1) /
+                                                 kSgemmStrideNThreadAlign);
+    const double ratio = static_cast<double>(params->m) / blocked_n;
+    const ptrdiff_t thread_count_m = std::clamp<ptrdiff_t>(
+        static_cast<ptrdiff_t>(std::lround(std::sqrt(static_cast<double>(threads) * ratio))), 1, threads);
+    const ptrdiff_t thread_count_n = threads / thread_count_m;
+    TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(thread_count_m == 1 || thread_count_n == 1,
+                                              "The GEMM is a 1D partition, which is covered by another candidate");
+    return Partition(params, thread_count_m, thread_count_n);
+  }
+}
+
+Status SingleThreaded(const SgemmBatchParams* params) {
+  return Partition(params, 1, 1);
+}
+
+class SgemmBatchTunableOp : public TunableOp<SgemmBatchParams> {
+ public:
+  SgemmBatchTunableOp() {
+    RegisterOp(DefaultPartition);
+    RegisterOp(PartitionOp<PartitionKind::M, 1>);
+    RegisterOp(PartitionOp<PartitionKind::N, 1>);
+    RegisterOp(PartitionOp<PartitionKind::MN, 1>);
+    RegisterOp(PartitionOp<PartitionKind::M, 2>);
+    RegisterOp(PartitionOp<PartitionKind::N, 2>);
+    RegisterOp(PartitionOp<PartitionKind::MN, 2>);
+    RegisterOp(SingleThreaded);
+  }
+};
+
+}  // namespace
+
+std::string SgemmBatchParams::Signature() const {
+  return MakeString(trans_a == CblasTrans ? "T" : "N", trans_b == CblasTrans ? "T" : "N",
+                    "_", m, "_", n, "_", k, "_", batch_size,
+                    "_", concurrency::ThreadPool::DegreeOfParallelism(thread_pool));
+}
+
+Status SgemmBatch(const SgemmBatchParams* params) {
+  for (size_t i = 0; i < params->batch_size; i++) {
+    ORT_RETURN_IF_NOT(params->data[i].beta == 0.0f, "Tunable SGEMM requires beta == 0");
+  }
+
+  if (params->TuningContext() == nullptr || params->m == 0 || params->n == 0 || params->batch_size == 0) {
+    return DefaultPartition(params);
+  }
+
+  static SgemmBatchTunableOp op;
+  return op(params);
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
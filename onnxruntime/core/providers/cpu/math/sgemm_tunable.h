@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// A batch of single precision GEMMs that share their shape, as computed by MlasGemmBatch.
+struct SgemmBatchParams : OpParams {
+  SgemmBatchParams(CpuTuningContext* tuning_ctx, CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
+                   size_t m, size_t n, size_t k, const MLAS_SGEMM_DATA_PARAMS* data, size_t batch_size,
+                   concurrency::ThreadPool* thread_pool)
+      : OpParams(tuning_ctx, nullptr),
+        trans_a(trans_a),
+        trans_b(trans_b),
+        m(m),
+        n(n),
+        k(k),
+        data(data),
+        batch_size(batch_size),
+        thread_pool(thread_pool) {}
+
+  std::string Signature() const override;
+
+  CBLAS_TRANSPOSE trans_a;
+  CBLAS_TRANSPOSE trans_b;
+  size_t m;
+  size_t n;
+  size_t k;
+  const MLAS_SGEMM_DATA_PARAMS* data;
+  size_t batch_size;
+  concurrency::ThreadPool* thread_pool;
+};
+
+// Computes the batch of GEMMs with the thread partition found by tuning, if TunableOp is enabled in the tuning
+// context of the parameters, else with the default heuristics of MlasGemmBatch.
+// The MLAS kernels and their tile sizes are selected at build time, so what is tuned is how the GEMMs are split
+// across the threads of the thread pool. Every candidate overwrites C, so the parameters must have beta == 0.
+Status SgemmBatch(const SgemmBatchParams* params);
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
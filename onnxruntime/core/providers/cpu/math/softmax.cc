@@ -2,7 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/softmax.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/tensor/transpose.h"
+#include <type_traits>
 #include <vector>
 #include <numeric>
 
@@ -108,6 +110,22 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Softmax<double>);
 
+// Half precision is computed in float a row at a time by MLAS, and only registered when MLAS converts
+// with vector instructions, see RegisterFp16ComputeKernels().
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Softmax,
+    13,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    LogSoftmax,
+    13,
+    MLFloat16,
+    KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Softmax<MLFloat16>);
+
 // opset-12 and below
 template <typename T>
 Status Softmax<T>::ComputeImpl(const Tensor& input, Tensor& output, size_t axis,
@@ -126,6 +144,19 @@ Status Softmax<T>::ComputeImplOpset13(const Tensor& input, Tensor& output, size_
   const auto& X_shape = input.Shape();
   size_t rank = X_shape.NumDimensions();
 
+  // MLAS normalizes float along an inner axis in place: the elements along the axis are strided, and the
+  // contiguous elements of the inner axes are processed together with vector instructions.
+  if constexpr (std::is_same<T, float>::value) {
+    if (axis != (rank - 1)) {
+      MlasComputeStridedSoftmax(input.Data<float>(), output.MutableData<float>(),
+                                onnxruntime::narrow<size_t>(X_shape.SizeToDimension(axis)),
+                                onnxruntime::narrow<size_t>(X_shape[axis]),
+                                onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(axis + 1)),
+                                log_softmax_, thread_pool);
+      return Status::OK();
+    }
+  }
+
   bool is_transpose_required = false;
   Tensor transposed_input;
   std::vector<int64_t> transposed_input_dims;
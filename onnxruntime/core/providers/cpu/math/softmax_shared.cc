@@ -103,4 +103,15 @@ common::Status SoftmaxCPU<float>(size_t N,
   return Status::OK();
 }
 
+template <>
+common::Status SoftmaxCPU<MLFloat16>(size_t N,
+                                     size_t D,
+                                     const MLFloat16* Xdata,
+                                     MLFloat16* Ydata,
+                                     bool logarithmic,
+                                     onnxruntime::concurrency::ThreadPool* thread_pool) {
+  MlasComputeSoftmax(Xdata, Ydata, N, D, logarithmic, thread_pool);
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
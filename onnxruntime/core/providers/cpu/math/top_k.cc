@@ -24,7 +24,10 @@
 #include "core/util/math_cpuonly.h"
 #include <queue>
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
+#include <type_traits>
 #include <core/common/safeint.h>
 
 namespace onnxruntime {
@@ -140,6 +143,77 @@ static void SelectTopK(const Comparator& comparer,
   // the data_holder now contains the indices of the top k elements in the first k elements
 }
 
+// Rows with at least this many elements along the axis select their top k with a radix select instead of
+// std::nth_element when k is large.
+constexpr int64_t kTopKRadixSelectMinAxisSize = 4096;
+
+template <typename T>
+using TopKRadixKeyType = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+
+// Maps a value to an unsigned key whose order is the order of the values for the largest top k, and the reverse
+// order for the smallest top k, so that the top k values have the k largest keys.
+template <typename T, bool Largest>
+static inline TopKRadixKeyType<T> TopKRadixKey(T value) {
+  using KeyType = TopKRadixKeyType<T>;
+  constexpr KeyType sign_bit = KeyType{1} << (sizeof(KeyType) * 8 - 1);
+
+  KeyType key;
+  if constexpr (std::is_floating_point_v<T>) {
+    if (value == T(0)) {
+      value = T(0);  // -0 and +0 compare equal
+    }
+    std::memcpy(&key, &value, sizeof(key));
+    key = (key & sign_bit) ? ~key : (key | sign_bit);
+  } else {
+    std::memcpy(&key, &value, sizeof(key));
+    key ^= sign_bit;
+  }
+
+  return Largest ? key : static_cast<KeyType>(~key);
+}
+
+// Selects the indices of the k largest of the num_blocks keys, preferring lower indices for equal keys, with a most
+// significant digit first radix select: each pass histograms one byte of the remaining candidate keys to find the
+// byte of the k-th largest key. The selected indices are written in increasing order to selected.
+template <typename KeyType>
+static void RadixSelectTopK(const KeyType* keys, int64_t num_blocks, const unsigned k,
+                            std::vector<KeyType>& candidates, int64_t* selected) {
+  candidates.assign(keys, keys + num_blocks);
+
+  KeyType prefix = 0;
+  KeyType prefix_mask = 0;
+  size_t remaining = k;  // number of keys equal to the k-th largest key that are selected
+  for (int shift = static_cast<int>(sizeof(KeyType) * 8) - 8; shift >= 0; shift -= 8) {
+    std::array<size_t, 256> histogram{};
+    for (KeyType key : candidates) {
+      ++histogram[(key >> shift) & 0xff];
+    }
+
+    size_t digit = 255;
+    for (; digit > 0 && histogram[digit] < remaining; --digit) {
+      remaining -= histogram[digit];
+    }
+
+    prefix |= static_cast<KeyType>(digit) << shift;
+    prefix_mask |= static_cast<KeyType>(0xff) << shift;
+    if (shift > 0) {
+      candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                      [prefix, prefix_mask](KeyType key) { return (key & prefix_mask) != prefix; }),
+                       candidates.end());
+    }
+  }
+
+  // prefix is now the k-th largest key
+  for (int64_t l = 0; l < num_blocks; ++l) {
+    if (keys[l] > prefix) {
+      *selected++ = l;
+    } else if (keys[l] == prefix && remaining > 0) {
+      *selected++ = l;
+      --remaining;
+    }
+  }
+}
+
 // Given an input tensor 'input' and metadata values - 'k' and 'axis_parsed',
 // this method will extract the sorted top k largest/smallest elements and place them in the output tensor 'values'
 // along with the metadata output 'indices'
@@ -296,10 +370,36 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
           // the call to SelectTopK overwrites any existing data so we don't need to clear on each iteration.
           std::vector<int64_t> data_holder(onnxruntime::narrow<size_t>(num_blocks));
 
+          using DataType = typename Comparator::DataType;
+          using KeyType = TopKRadixKeyType<DataType>;
+          constexpr bool largest = std::is_same_v<Comparator, GreaterValueCmp<DataType>>;
+          const bool use_radix_select = num_blocks >= kTopKRadixSelectMinAxisSize;
+          std::vector<KeyType> keys;
+          std::vector<KeyType> candidates;
+          if (use_radix_select) {
+            keys.resize(onnxruntime::narrow<size_t>(num_blocks));
+          }
+
           for (auto i = work.start; i < work.end; ++i) {
             auto row_offset = i * cols;
             for (int64_t j = 0; j < block_slice; ++j) {
-              SelectTopK<Comparator>(comparer, row_offset, num_blocks, block_slice, j, k, sorted, data_holder);
+              if (use_radix_select) {
+                const auto* row_data = input_data + row_offset + j;
+                for (int64_t l = 0; l < num_blocks; ++l) {
+                  keys[onnxruntime::narrow<size_t>(l)] = TopKRadixKey<DataType, largest>(row_data[l * block_slice]);
+                }
+
+                RadixSelectTopK(keys.data(), num_blocks, k, candidates, data_holder.data());
+                for (unsigned l = 0; l < k; ++l) {
+                  data_holder[l] = row_offset + data_holder[l] * block_slice + j;
+                }
+
+                if (sorted) {
+                  std::sort(data_holder.begin(), data_holder.begin() + k, comparer);
+                }
+              } else {
+                SelectTopK<Comparator>(comparer, row_offset, num_blocks, block_slice, j, k, sorted, data_holder);
+              }
 
               // Insert the top 'k' (largest or smallest) elements into the final output buffers
               for (int64_t l = 0; l < k; ++l) {
@@ -524,5 +524,26 @@ void batched_update_scores_inplace(gsl::span<T> scores, int64_t num_batches_in,
     }
   }
 }
+
+// Cost of a hash lookup per element, used to decide when mapping an input tensor is worth splitting across the
+// thread pool.
+constexpr double kMapLookupCost = 64.0;
+
+// Replaces each element of input with its value in map, or default_value if it is not a key.
+// The map is only read, so blocks of elements are looked up concurrently on the thread pool.
+template <typename TKey, typename TValue, typename Map>
+void MapInputToOutput(const Map& map, gsl::span<const TKey> input, gsl::span<TValue> output,
+                      const TValue& default_value, concurrency::ThreadPool* tp) {
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(input.size()),
+      TensorOpCost{static_cast<double>(sizeof(TKey)), static_cast<double>(sizeof(TValue)), kMapLookupCost},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const auto found = map.find(input[i]);
+          output[i] = found == map.end() ? default_value : found->second;
+        }
+      });
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
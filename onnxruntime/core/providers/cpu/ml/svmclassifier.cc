@@ -63,6 +63,7 @@ SVMClassifier::SVMClassifier(const OpKernelInfo& info)
   if (vector_count_ > 0) {
     feature_count_ = support_vectors_.size() / vector_count_;  // length of each support vector
     mode_ = SVM_TYPE::SVM_SVC;
+    set_support_vectors(support_vectors_, vector_count_, feature_count_);
   } else {
     feature_count_ = coefficients_.size() / class_count_;  // liblinear mode
     mode_ = SVM_TYPE::SVM_LINEAR;
@@ -74,6 +75,33 @@ SVMClassifier::SVMClassifier(const OpKernelInfo& info)
   ORT_ENFORCE(coefficients_.size() > 0);
   weights_are_all_positive_ = std::all_of(coefficients_.cbegin(), coefficients_.cend(),
                                           [](float value) { return value >= 0.f; });
+
+  // The score of the pair of classes i and j combines the kernels of the support vectors of class i with the
+  // coefficients of row j - 1, and the kernels of the support vectors of class j with the coefficients of row i.
+  // With a few classes, these coefficients are laid out in a [vector_count_, num_classifiers] matrix, zero for the
+  // support vectors of the other classes, so that the scores of all pairs are computed with a single GEMM.
+  // The matrix has 2 / class_count_ non zero values, so this is only worth it for a few classes.
+  constexpr ptrdiff_t max_class_count_for_gemm = 8;
+  if (mode_ == SVM_TYPE::SVM_SVC && class_count_ > 1 && class_count_ <= max_class_count_for_gemm &&
+      vectors_per_class_.size() >= static_cast<size_t>(class_count_) &&
+      coefficients_.size() >= SafeInt<size_t>(vector_count_) * (class_count_ - 1)) {
+    const ptrdiff_t num_classifiers = class_count_ * (class_count_ - 1) / 2;
+    pair_coefficients_.resize(SafeInt<size_t>(vector_count_) * num_classifiers, 0.f);
+
+    ptrdiff_t classifier_idx = 0;
+    for (ptrdiff_t i = 0; i < class_count_ - 1; i++) {
+      for (ptrdiff_t j = i + 1; j < class_count_; j++, classifier_idx++) {
+        for (ptrdiff_t c : {i, j}) {
+          const ptrdiff_t coeff_row_offset = vector_count_ * (c == i ? j - 1 : i);
+          const ptrdiff_t start_index = narrow<ptrdiff_t>(starting_vector_[narrow<size_t>(c)]);
+          for (ptrdiff_t m = 0; m < vectors_per_class_[narrow<size_t>(c)]; ++m) {
+            pair_coefficients_[(start_index + m) * num_classifiers + classifier_idx] =
+                coefficients_[coeff_row_offset + start_index + m];
+          }
+        }
+      }
+    }
+  }
 }
 
 template <typename LabelType>
@@ -247,61 +275,85 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
     batched_kernel_dot<float>(x_data, support_vectors_, num_batches, vector_count_, feature_count_, 0.f, kernels_span,
                               threadpool);
 
-    for (int64_t n = 0; n < num_batches; n++) {
-      // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
-      // per class.
-      // coefficients: [num_classes - 1, vector_count_]
-      //
-      // e.g. say you have 3 classes, with 3 x 3 coefficients
-      //
-      // AA AB AC
-      // BA BB BC
-      // CA CB CC
-      //
-      // you can remove the diagonal line of items comparing a class with itself leaving one less row.
-      //
-      // BA AB AC
-      // CA CB BC
-      //
-      // for each class there is a coefficient per support vector, and a class has one or more support vectors.
-      //
-      // Combine the scores for the two combinations for two classes with their coefficient.
-      // e.g. AB combines with BA.
-      // If A has 3 support vectors and B has 2, there's a 3x2 block for AB and a 2x3 block for BA to combine
-
-      auto cur_kernels = kernels_span.subspan(n * SafeInt<size_t>(vector_count_), onnxruntime::narrow<size_t>(vector_count_));
-      auto cur_scores = classifier_scores.subspan(n * SafeInt<size_t>(num_slots_per_iteration), onnxruntime::narrow<size_t>(num_classifiers));
-      auto cur_votes = votes_span.subspan(n * SafeInt<size_t>(class_count_), onnxruntime::narrow<size_t>(class_count_));
-      auto scores_iter = cur_scores.begin();
-
-      size_t classifier_idx = 0;
-      for (int64_t i = 0; i < class_count_ - 1; i++) {
-        int64_t start_index_i = starting_vector_[onnxruntime::narrow<size_t>(i)];  // start of support vectors for class i
-        int64_t class_i_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(i)];
-        int64_t i_coeff_row_offset = vector_count_ * i;
-
-        for (int64_t j = i + 1; j < class_count_; j++) {
-          int64_t start_index_j = starting_vector_[onnxruntime::narrow<size_t>(j)];  // start of support vectors for class j
-          int64_t class_j_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(j)];
-          int64_t j_coeff_row_offset = vector_count_ * (j - 1);
-
-          double sum = 0;
-
-          const float* val1 = &(coefficients_[j_coeff_row_offset + SafeInt<size_t>(start_index_i)]);
-          const float* val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_i)]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[i_coeff_row_offset + SafeInt<size_t>(start_index_j)]);
-          val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_j)]);
-
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[classifier_idx++];
-
-          *scores_iter++ = static_cast<float>(sum);
-          ++(cur_votes[onnxruntime::narrow<size_t>(sum > 0 ? i : j)]);
+    if (!pair_coefficients_.empty()) {
+      // scores of all the pairs: kernels * pair_coefficients_ + rho
+      for (int64_t n = 0; n < num_batches; n++) {
+        std::copy_n(rho_.data(), num_classifiers, classifier_scores.data() + n * num_slots_per_iteration);
+      }
+
+      math::GemmEx<float, concurrency::ThreadPool>(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasNoTrans,
+                                                   num_batches, num_classifiers, vector_count_,
+                                                   1.f, kernels_data.data(), narrow<int>(vector_count_),
+                                                   pair_coefficients_.data(), narrow<int>(num_classifiers),
+                                                   1.f, classifier_scores.data(), narrow<int>(num_slots_per_iteration),
+                                                   threadpool);
+
+      for (int64_t n = 0; n < num_batches; n++) {
+        const float* cur_scores = classifier_scores.data() + n * num_slots_per_iteration;
+        auto cur_votes = votes_span.subspan(n * SafeInt<size_t>(class_count_), onnxruntime::narrow<size_t>(class_count_));
+        for (int64_t i = 0; i < class_count_ - 1; i++) {
+          for (int64_t j = i + 1; j < class_count_; j++) {
+            ++(cur_votes[onnxruntime::narrow<size_t>(*cur_scores++ > 0 ? i : j)]);
+          }
+        }
+      }
+    } else {
+      for (int64_t n = 0; n < num_batches; n++) {
+        // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
+        // per class.
+        // coefficients: [num_classes - 1, vector_count_]
+        //
+        // e.g. say you have 3 classes, with 3 x 3 coefficients
+        //
+        // AA AB AC
+        // BA BB BC
+        // CA CB CC
+        //
+        // you can remove the diagonal line of items comparing a class with itself leaving one less row.
+        //
+        // BA AB AC
+        // CA CB BC
+        //
+        // for each class there is a coefficient per support vector, and a class has one or more support vectors.
+        //
+        // Combine the scores for the two combinations for two classes with their coefficient.
+        // e.g. AB combines with BA.
+        // If A has 3 support vectors and B has 2, there's a 3x2 block for AB and a 2x3 block for BA to combine
+
+        auto cur_kernels = kernels_span.subspan(n * SafeInt<size_t>(vector_count_), onnxruntime::narrow<size_t>(vector_count_));
+        auto cur_scores = classifier_scores.subspan(n * SafeInt<size_t>(num_slots_per_iteration), onnxruntime::narrow<size_t>(num_classifiers));
+        auto cur_votes = votes_span.subspan(n * SafeInt<size_t>(class_count_), onnxruntime::narrow<size_t>(class_count_));
+        auto scores_iter = cur_scores.begin();
+
+        size_t classifier_idx = 0;
+        for (int64_t i = 0; i < class_count_ - 1; i++) {
+          int64_t start_index_i = starting_vector_[onnxruntime::narrow<size_t>(i)];  // start of support vectors for class i
+          int64_t class_i_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(i)];
+          int64_t i_coeff_row_offset = vector_count_ * i;
+
+          for (int64_t j = i + 1; j < class_count_; j++) {
+            int64_t start_index_j = starting_vector_[onnxruntime::narrow<size_t>(j)];  // start of support vectors for class j
+            int64_t class_j_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(j)];
+            int64_t j_coeff_row_offset = vector_count_ * (j - 1);
+
+            double sum = 0;
+
+            const float* val1 = &(coefficients_[j_coeff_row_offset + SafeInt<size_t>(start_index_i)]);
+            const float* val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_i)]);
+            for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
+              sum += *val1 * *val2;
+
+            val1 = &(coefficients_[i_coeff_row_offset + SafeInt<size_t>(start_index_j)]);
+            val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_j)]);
+
+            for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
+              sum += *val1 * *val2;
+
+            sum += rho_[classifier_idx++];
+
+            *scores_iter++ = static_cast<float>(sum);
+            ++(cur_votes[onnxruntime::narrow<size_t>(sum > 0 ? i : j)]);
+          }
         }
       }
     }
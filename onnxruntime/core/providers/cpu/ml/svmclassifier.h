@@ -7,6 +7,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/math/gemm.h"
 
 namespace onnxruntime {
@@ -28,6 +29,23 @@ class SVMCommon {
   }
 
   void set_kernel_type(KERNEL new_kernel_type) { kernel_type_ = new_kernel_type; }
+
+  // Computes the squared norms of the support vectors used by the RBF kernel.
+  void set_support_vectors(const std::vector<float>& support_vectors, ptrdiff_t vector_count, ptrdiff_t feature_count) {
+    support_vector_norms_.clear();
+    if (kernel_type_ != KERNEL::RBF) {
+      return;
+    }
+
+    support_vector_norms_.resize(onnxruntime::narrow<size_t>(vector_count));
+    const float* cur_support_vector = support_vectors.data();
+    for (auto& norm : support_vector_norms_) {
+      norm = 0.f;
+      for (ptrdiff_t feature = 0; feature < feature_count; ++feature, ++cur_support_vector) {
+        norm += *cur_support_vector * *cur_support_vector;
+      }
+    }
+  }
   KERNEL get_kernel_type() const { return kernel_type_; }
 
   template <typename T>
@@ -39,28 +57,49 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
-
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
-
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
-
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
-
-          *cur_out++ = std::exp(-gamma_ * sum);
-        }
+      // |a - b|^2 = |a|^2 + |b|^2 - 2 a.b, so the distances between the rows and the support vectors come from
+      // a GEMM, with the squared norms of the support vectors computed once as its bias.
+      ORT_ENFORCE(support_vector_norms_.size() == size_t(n), "The support vector norms were not computed.");
+      const TensorShape shape_norms({n});
+      onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
+                                        m, n, k,
+                                        -2.f, a.data(), b.data(), 1.f,
+                                        support_vector_norms_.data(), &shape_norms,
+                                        out.data(),
+                                        threadpool);
 
-        cur_batch += k;  // move to start of next batch
-      }
+      const T gamma = gamma_;
+      const float* norms = support_vector_norms_.data();
+      concurrency::ThreadPool::TryParallelFor(
+          threadpool, m, TensorOpCost{static_cast<double>(k + n) * sizeof(T), static_cast<double>(n) * sizeof(T), static_cast<double>(k + 4 * n)},
+          [&a, &b, &out, norms, n, k, gamma](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t batch = first; batch < last; ++batch) {
+              const T* cur_batch = a.data() + batch * k;
+              T norm = 0.f;
+              for (ptrdiff_t feature = 0; feature < k; ++feature) {
+                norm += cur_batch[feature] * cur_batch[feature];
+              }
+
+              T* cur_out = out.data() + batch * n;
+              for (ptrdiff_t support_vector = 0; support_vector < n; ++support_vector) {
+                T sum = cur_out[support_vector] + norm;
+                if (sum * 64 < norm + norms[support_vector]) {
+                  // the input is close to the support vector compared to their norms, the expansion loses too much
+                  // precision so compute the distance directly.
+                  const T* cur_support_vector = b.data() + support_vector * k;
+                  sum = 0.f;
+                  for (ptrdiff_t feature = 0; feature < k; ++feature) {
+                    T val = cur_batch[feature] - cur_support_vector[feature];
+                    sum += val * val;
+                  }
+                }
+
+                cur_out[support_vector] = -gamma * sum;
+              }
+
+              MlasComputeExp(cur_out, cur_out, onnxruntime::narrow<size_t>(n));
+            }
+          });
     } else {
       float alpha = 1.f;
       float beta = 1.f;
@@ -100,12 +139,14 @@ class SVMCommon {
   float gamma_{0.f};
   float coef0_{0.f};
   float degree_{0.f};
+  std::vector<float> support_vector_norms_;
 };
 
 class SVMClassifier final : public OpKernel, private SVMCommon {
   using SVMCommon::batched_kernel_dot;
   using SVMCommon::get_kernel_type;
   using SVMCommon::set_kernel_type;
+  using SVMCommon::set_support_vectors;
 
  public:
   SVMClassifier(const OpKernelInfo& info);
@@ -126,6 +167,9 @@ class SVMClassifier final : public OpKernel, private SVMCommon {
   std::vector<float> probb_;
   std::vector<float> coefficients_;
   std::vector<float> support_vectors_;
+  // [vector_count_, num_classifiers] coefficients of the pairs of classes, see the constructor. Empty if the scores
+  // of the pairs are computed one by one.
+  std::vector<float> pair_coefficients_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
   POST_EVAL_TRANSFORM post_transform_;
@@ -103,6 +103,18 @@ struct TreeNodeElement {
   inline bool is_missing_track_true() const { return flags & MissingTrack::kTrue; }
 };
 
+// Node of the breadth-first copy of the trees built by TreeEnsembleCommon::BuildFlatTrees().
+// Both children of a node are stored next to each other, the false child first, so the next node is
+// `child + condition` and a block of rows can walk a tree in lockstep without branches.
+// A leaf points to itself and has a NaN threshold, so that the condition is always false there.
+template <typename T>
+struct TreeNodeFlat {
+  T threshold;
+  int32_t feature_id;
+  uint32_t child;
+  uint8_t missing_track_true;
+};
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 class TreeAggregator {
  protected:
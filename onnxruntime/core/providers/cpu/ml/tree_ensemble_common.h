@@ -3,9 +3,14 @@
 
 #pragma once
 
+#include <functional>
+#include <limits>
+
 #include "tree_ensemble_aggregator.h"
+#include "core/common/parse_string.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "tree_ensemble_helper.h"
 
 namespace onnxruntime {
@@ -32,8 +37,18 @@ class TreeEnsembleCommonAttributes {
   int parallel_tree_;    // starts parallelizing the computing by trees if n_tree >= parallel_tree_
   int parallel_tree_N_;  // batch size if parallelizing by trees
   int parallel_N_;       // starts parallelizing the computing by rows if n_rows <= parallel_N_
+  size_t n_trees_per_chunk_;  // number of trees evaluated together on a tile of rows, see ComputeAgg
 };
 
+// Reads one of the parallelization thresholds from the session configuration.
+inline int GetTreeEnsembleParallelOption(const OpKernelInfo& info, const char* key, int default_value) {
+  const std::string value = info.GetConfigOptions().GetConfigOrDefault(key, std::to_string(default_value));
+  int parsed = 0;
+  ORT_ENFORCE(TryParseStringWithClassicLocale(value, parsed) && parsed >= 0,
+              "Invalid value of ", key, ": ", value);
+  return parsed;
+}
+
 // TI: input type
 // TH: tree type (types of the node values and targets)
 // TO: output type, usually float
@@ -48,6 +63,13 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
 
+  // Breadth-first copy of the trees used to evaluate blocks of rows, empty if the trees cannot be flattened.
+  // See BuildFlatTrees(). flat_leaves_ maps a leaf of flat_nodes_ to the leaf in nodes_ holding its weights.
+  std::vector<TreeNodeFlat<ThresholdType>> flat_nodes_;
+  std::vector<const TreeNodeElement<ThresholdType>*> flat_leaves_;
+  std::vector<uint32_t> flat_roots_;
+  NODE_MODE flat_mode_;
+
  public:
   TreeEnsembleCommon() {}
 
@@ -83,10 +105,31 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   TreeNodeElement<ThresholdType>* ProcessTreeNodeLeave(TreeNodeElement<ThresholdType>* root,
                                                        const InputType* x_data) const;
 
+  // Calls fct(i, leaf) with the leaf reached by every row i in [begin, end) in tree j.
+  template <typename FCT>
+  void ProcessTreeNodeLeaves(size_t j, const InputType* x_data, int64_t stride, int64_t begin, int64_t end,
+                             FCT&& fct) const;
+
+  // Split of a batch of rows into blocks of rows distributed across the threads. A thread evaluates
+  // its blocks by tiles of up to blocks_per_tile blocks.
+  struct RowTiling {
+    int32_t num_threads;
+    int64_t block_size;
+    int64_t n_blocks;
+    int64_t blocks_per_tile;
+  };
+  RowTiling GetRowTiling(int64_t N, int64_t stride, int32_t max_num_threads) const;
+
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
 
  private:
+  void BuildFlatTrees();
+
+  template <typename CMP, bool has_missing_tracks, typename FCT>
+  void ProcessFlatTreeLeaves(size_t j, const InputType* x_data, int64_t stride, int64_t begin, int64_t end,
+                             FCT&& fct) const;
+
   size_t AddNodes(const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
                   const InlinedVector<size_t>& falsenode_ids, const std::vector<int64_t>& nodes_featureids,
                   const std::vector<ThresholdType>& nodes_values_as_tensor, const std::vector<float>& node_values,
@@ -106,9 +149,9 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(const OpKe
 #endif
 
   return Init(
-      80,
-      128,
-      50,
+      GetTreeEnsembleParallelOption(info, kOrtSessionOptionsTreeEnsembleParallelTree, 80),
+      GetTreeEnsembleParallelOption(info, kOrtSessionOptionsTreeEnsembleParallelTreeN, 128),
+      GetTreeEnsembleParallelOption(info, kOrtSessionOptionsTreeEnsembleParallelN, 50),
       info.GetAttrOrDefault<std::string>("aggregate_function", "SUM"),
       info.GetAttrsOrDefault<float>("base_values"),
       base_values_as_tensor,
@@ -162,6 +205,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
   parallel_tree_N_ = parallel_tree_N;
   parallel_N_ = parallel_N;
 
+  ORT_ENFORCE(parallel_tree_N > 0, "parallel_tree_N must be positive.");
   ORT_ENFORCE(n_targets_or_classes > 0);
   ORT_ENFORCE(nodes_falsenodeids.size() == nodes_featureids.size());
   ORT_ENFORCE(nodes_falsenodeids.size() == nodes_modes.size());
@@ -338,9 +382,94 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     }
   }
 
+  BuildFlatTrees();
+
+  // Chunks of trees evaluated together on a tile of rows should stay in the L2 cache.
+  constexpr size_t chunk_bytes = 256 * 1024;
+  const size_t node_bytes = flat_roots_.empty() ? sizeof(TreeNodeElement<ThresholdType>)
+                                                : sizeof(TreeNodeFlat<ThresholdType>);
+  const size_t tree_bytes = std::max<size_t>(1, (flat_roots_.empty() ? nodes_.size() : flat_nodes_.size()) *
+                                                    node_bytes / std::max<size_t>(1, roots_.size()));
+  n_trees_per_chunk_ = std::max<size_t>(1, chunk_bytes / tree_bytes);
+
   return Status::OK();
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::BuildFlatTrees() {
+  flat_nodes_.clear();
+  flat_leaves_.clear();
+  flat_roots_.clear();
+
+  // All nodes must use the same comparison, and it must be false with the NaN threshold of the leaves.
+  if (!same_mode_) {
+    return;
+  }
+  flat_mode_ = NODE_MODE::LEAF;
+  for (const auto& node : nodes_) {
+    if (node.is_not_leaf()) {
+      flat_mode_ = node.mode();
+      break;
+    }
+  }
+  if (flat_mode_ == NODE_MODE::BRANCH_NEQ) {
+    return;
+  }
+
+  // Nodes shared by several parents are duplicated since both children of a node must be adjacent.
+  // Give up on the flat copy if this makes it much larger than the trees.
+  const size_t max_flat_nodes = std::min<size_t>(nodes_.size() * 4, std::numeric_limits<uint32_t>::max());
+
+  struct PendingNode {
+    const TreeNodeElement<ThresholdType>* node;
+    uint32_t position;
+    int64_t depth;
+  };
+  std::vector<PendingNode> pending;
+  flat_nodes_.reserve(nodes_.size());
+  flat_leaves_.reserve(nodes_.size());
+  flat_roots_.reserve(roots_.size());
+
+  for (const TreeNodeElement<ThresholdType>* root : roots_) {
+    const auto root_position = static_cast<uint32_t>(flat_nodes_.size());
+    flat_roots_.push_back(root_position);
+    flat_nodes_.emplace_back();
+    flat_leaves_.push_back(nullptr);
+
+    pending.clear();
+    pending.push_back({root, root_position, 0});
+    for (size_t k = 0; k < pending.size(); ++k) {
+      const PendingNode current = pending[k];
+      TreeNodeFlat<ThresholdType> flat;
+      if (current.node->is_not_leaf()) {
+        if (current.depth >= max_tree_depth_ || flat_nodes_.size() + 2 > max_flat_nodes) {
+          flat_nodes_.clear();
+          flat_leaves_.clear();
+          flat_roots_.clear();
+          return;
+        }
+        flat.threshold = current.node->value_or_unique_weight;
+        flat.feature_id = current.node->feature_id;
+        flat.child = static_cast<uint32_t>(flat_nodes_.size());
+        flat.missing_track_true = current.node->is_missing_track_true() ? 1 : 0;
+        flat_nodes_.emplace_back();
+        flat_nodes_.emplace_back();
+        flat_leaves_.push_back(nullptr);
+        flat_leaves_.push_back(nullptr);
+        pending.push_back({current.node + 1, flat.child, current.depth + 1});
+        pending.push_back({current.node->truenode_or_weight.ptr, flat.child + 1, current.depth + 1});
+      } else {
+        flat.threshold = std::numeric_limits<ThresholdType>::quiet_NaN();
+        flat.feature_id = 0;
+        flat.child = current.position;
+        flat.missing_track_true = 0;
+        flat_leaves_[current.position] = current.node;
+      }
+      flat_nodes_[current.position] = flat;
+    }
+  }
+}
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 size_t TreeEnsembleCommon<InputType, ThresholdType, OutputType>::AddNodes(
     const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
@@ -435,6 +564,23 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::compute(OpKerne
   }
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+typename TreeEnsembleCommon<InputType, ThresholdType, OutputType>::RowTiling
+TreeEnsembleCommon<InputType, ThresholdType, OutputType>::GetRowTiling(int64_t N, int64_t stride,
+                                                                      int32_t max_num_threads) const {
+  RowTiling tiling;
+  // Blocks have parallel_tree_N_ rows at most, smaller ones if there are not enough rows for every thread.
+  tiling.block_size = std::max<int64_t>(1, std::min<int64_t>(parallel_tree_N_, (N + max_num_threads - 1) / max_num_threads));
+  tiling.n_blocks = (N + tiling.block_size - 1) / tiling.block_size;
+  tiling.num_threads = static_cast<int32_t>(std::min<int64_t>(max_num_threads, tiling.n_blocks));
+  // A chunk of trees is evaluated on every block of a tile before moving to the next chunk,
+  // the rows of a tile should stay in cache as well.
+  constexpr int64_t tile_bytes = 256 * 1024;
+  const int64_t block_bytes = std::max<int64_t>(1, tiling.block_size * stride * static_cast<int64_t>(sizeof(InputType)));
+  tiling.blocks_per_tile = std::max<int64_t>(1, std::min<int64_t>(8, tile_bytes / block_bytes));
+  return tiling;
+}
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 template <typename AGG>
 void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concurrency::ThreadPool* ttp,
@@ -498,38 +644,37 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           scores[SafeInt<ptrdiff_t>(i - batch)] = {0, 0};
         }
         for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-          for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-          }
+          ProcessTreeNodeLeaves(j, x_data, stride, batch, batch_end,
+                                [&agg, &scores, batch](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                  agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], leaf);
+                                });
         }
         for (i = batch; i < batch_end; ++i) {
           agg.FinalizeScores1(z_data + i, scores[SafeInt<ptrdiff_t>(i - batch)],
                               label_data == nullptr ? nullptr : (label_data + i));
         }
       }
-    } else if (n_trees_ > max_num_threads) { /* section D: 1 output, 2+ rows and enough trees to parallelize */
+    } else if (n_trees_ > max_num_threads &&
+               N < SafeInt<int64_t>(parallel_tree_N_) * max_num_threads) { /* section D: 1 output, 2+ rows, not enough blocks of rows for every thread but enough trees to parallelize */
+      // Every thread evaluates its trees on all rows and keeps its own partial scores, merged at the end.
       auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_trees_));
-      std::vector<ScoreValue<ThresholdType>> scores(SafeInt<size_t>(num_threads) * N);
-      int64_t end_n, begin_n = 0;
-      while (begin_n < N) {
-        end_n = std::min(N, begin_n + parallel_tree_N_);
-        concurrency::ThreadPool::TrySimpleParallelFor(
-            ttp,
-            num_threads,
-            [this, &agg, &scores, num_threads, x_data, N, begin_n, end_n, stride](ptrdiff_t batch_num) {
-              auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(this->n_trees_));
-              for (int64_t i = begin_n; i < end_n; ++i) {
-                scores[batch_num * SafeInt<ptrdiff_t>(N) + i] = {0, 0};
-              }
+      std::vector<ScoreValue<ThresholdType>> scores(SafeInt<size_t>(num_threads) * N, {0, 0});
+      concurrency::ThreadPool::TrySimpleParallelFor(
+          ttp,
+          num_threads,
+          [this, &agg, &scores, num_threads, x_data, N, stride](ptrdiff_t batch_num) {
+            auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(this->n_trees_));
+            ScoreValue<ThresholdType>* thread_scores = scores.data() + batch_num * SafeInt<ptrdiff_t>(N);
+            for (int64_t begin_n = 0; begin_n < N; begin_n += parallel_tree_N_) {
+              int64_t end_n = std::min(N, begin_n + parallel_tree_N_);
               for (auto j = work.start; j < work.end; ++j) {
-                for (int64_t i = begin_n; i < end_n; ++i) {
-                  agg.ProcessTreeNodePrediction1(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                 *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
-                }
+                ProcessTreeNodeLeaves(j, x_data, stride, begin_n, end_n,
+                                      [&agg, thread_scores](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                        agg.ProcessTreeNodePrediction1(thread_scores[i], leaf);
+                                      });
               }
-            });
-        begin_n = end_n;
-      }
+            }
+          });
       concurrency::ThreadPool::TrySimpleParallelFor(
           ttp,
           num_threads,
@@ -543,20 +688,40 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
                                   label_data == nullptr ? nullptr : (label_data + i));
             }
           });
-    } else { /* section E: 1 output, 2+ rows, parallelization by rows */
-      concurrency::ThreadPool::TryBatchParallelFor(
+    } else { /* section E: 1 output, 2+ rows, parallelization by blocks of rows */
+      // Every thread evaluates all trees on its own tiles of rows, so there is nothing to merge.
+      // Inside a tile, the trees are walked by chunks small enough to stay in cache while they are
+      // evaluated on every block of rows of the tile.
+      RowTiling tiling = GetRowTiling(N, stride, max_num_threads);
+      concurrency::ThreadPool::TrySimpleParallelFor(
           ttp,
-          SafeInt<int32_t>(N),
-          [this, &agg, x_data, z_data, stride, label_data](ptrdiff_t i) {
-            ScoreValue<ThresholdType> score = {0, 0};
-            for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-              agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+          tiling.num_threads,
+          [this, &agg, &tiling, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+            auto work = concurrency::ThreadPool::PartitionWork(batch_num, tiling.num_threads,
+                                                               onnxruntime::narrow<size_t>(tiling.n_blocks));
+            std::vector<ScoreValue<ThresholdType>> scores(SafeInt<size_t>(tiling.block_size) * tiling.blocks_per_tile);
+            for (auto tile = work.start; tile < work.end; tile += tiling.blocks_per_tile) {
+              int64_t begin_t = tile * tiling.block_size;
+              int64_t end_t = std::min(N, std::min<int64_t>(tile + tiling.blocks_per_tile, work.end) * tiling.block_size);
+              std::fill(scores.begin(), scores.begin() + (end_t - begin_t), ScoreValue<ThresholdType>({0, 0}));
+              for (size_t chunk = 0; chunk < static_cast<size_t>(n_trees_); chunk += n_trees_per_chunk_) {
+                size_t chunk_end = std::min(static_cast<size_t>(n_trees_), chunk + n_trees_per_chunk_);
+                for (int64_t begin = begin_t; begin < end_t; begin += tiling.block_size) {
+                  int64_t end = std::min(end_t, begin + tiling.block_size);
+                  for (size_t j = chunk; j < chunk_end; ++j) {
+                    ProcessTreeNodeLeaves(j, x_data, stride, begin, end,
+                                          [&agg, &scores, begin_t](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                            agg.ProcessTreeNodePrediction1(scores[i - begin_t], leaf);
+                                          });
+                  }
+                }
+              }
+              for (int64_t i = begin_t; i < end_t; ++i) {
+                agg.FinalizeScores1(z_data + i, scores[i - begin_t],
+                                    label_data == nullptr ? nullptr : (label_data + i));
+              }
             }
-
-            agg.FinalizeScores1(z_data + i, score,
-                                label_data == nullptr ? nullptr : (label_data + i));
-          },
-          max_num_threads);
+          });
     }
   } else {
     if (N == 1) {                                               /* section A2: 2+ outputs, 1 row, not enough trees to parallelize */
@@ -598,9 +763,10 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           std::fill(scores[SafeInt<ptrdiff_t>(i - batch)].begin(), scores[SafeInt<ptrdiff_t>(i - batch)].end(), ScoreValue<ThresholdType>({0, 0}));
         }
         for (j = 0, limit = roots_.size(); j < limit; ++j) {
-          for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
-          }
+          ProcessTreeNodeLeaves(j, x_data, stride, batch, batch_end,
+                                [this, &agg, &scores, batch](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                  agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], leaf, weights_);
+                                });
         }
         for (i = batch; i < batch_end; ++i) {
           agg.FinalizeScores(scores[SafeInt<ptrdiff_t>(i - batch)], z_data + i * n_targets_or_classes_, -1,
@@ -608,29 +774,29 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
         }
       }
 
-    } else if (n_trees_ >= max_num_threads) { /* section: D2: 2+ outputs, 2+ rows, enough trees to parallelize*/
+    } else if (n_trees_ > max_num_threads &&
+               N < SafeInt<int64_t>(parallel_tree_N_) * max_num_threads) { /* section D2: 2+ outputs, 2+ rows, not enough blocks of rows for every thread but enough trees to parallelize */
       auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_trees_));
       std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(SafeInt<size_t>(num_threads) * N);
-      int64_t end_n, begin_n = 0;
-      while (begin_n < N) {
-        end_n = std::min(N, begin_n + parallel_tree_N_);
-        concurrency::ThreadPool::TrySimpleParallelFor(
-            ttp,
-            num_threads,
-            [this, &agg, &scores, num_threads, x_data, N, stride, begin_n, end_n](ptrdiff_t batch_num) {
-              auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(this->n_trees_));
-              for (int64_t i = begin_n; i < end_n; ++i) {
-                scores[batch_num * SafeInt<ptrdiff_t>(N) + i].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
-              }
+      concurrency::ThreadPool::TrySimpleParallelFor(
+          ttp,
+          num_threads,
+          [this, &agg, &scores, num_threads, x_data, N, stride](ptrdiff_t batch_num) {
+            auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(this->n_trees_));
+            InlinedVector<ScoreValue<ThresholdType>>* thread_scores = scores.data() + batch_num * SafeInt<ptrdiff_t>(N);
+            for (int64_t i = 0; i < N; ++i) {
+              thread_scores[i].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
+            }
+            for (int64_t begin_n = 0; begin_n < N; begin_n += parallel_tree_N_) {
+              int64_t end_n = std::min(N, begin_n + parallel_tree_N_);
               for (auto j = work.start; j < work.end; ++j) {
-                for (int64_t i = begin_n; i < end_n; ++i) {
-                  agg.ProcessTreeNodePrediction(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
-                }
+                ProcessTreeNodeLeaves(j, x_data, stride, begin_n, end_n,
+                                      [this, &agg, thread_scores](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                        agg.ProcessTreeNodePrediction(thread_scores[i], leaf, weights_);
+                                      });
               }
-            });
-        begin_n = end_n;
-      }
+            }
+          });
       concurrency::ThreadPool::TrySimpleParallelFor(
           ttp,
           num_threads,
@@ -644,25 +810,39 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
                                  label_data == nullptr ? nullptr : (label_data + i));
             }
           });
-    } else { /* section E2: 2+ outputs, 2+ rows, parallelization by rows */
-      auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(N));
+    } else { /* section E2: 2+ outputs, 2+ rows, parallelization by blocks of rows */
+      RowTiling tiling = GetRowTiling(N, stride, max_num_threads);
       concurrency::ThreadPool::TrySimpleParallelFor(
           ttp,
-          num_threads,
-          [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
-            size_t j, limit;
-            InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_targets_or_classes_));
-            auto work = concurrency::ThreadPool::PartitionWork(batch_num, onnxruntime::narrow<ptrdiff_t>(num_threads), onnxruntime::narrow<ptrdiff_t>(N));
-
-            for (auto i = work.start; i < work.end; ++i) {
-              std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
-              for (j = 0, limit = roots_.size(); j < limit; ++j) {
-                agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+          tiling.num_threads,
+          [this, &agg, &tiling, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+            auto work = concurrency::ThreadPool::PartitionWork(batch_num, tiling.num_threads,
+                                                               onnxruntime::narrow<size_t>(tiling.n_blocks));
+            std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(
+                SafeInt<size_t>(tiling.block_size) * tiling.blocks_per_tile,
+                InlinedVector<ScoreValue<ThresholdType>>(onnxruntime::narrow<size_t>(n_targets_or_classes_)));
+            for (auto tile = work.start; tile < work.end; tile += tiling.blocks_per_tile) {
+              int64_t begin_t = tile * tiling.block_size;
+              int64_t end_t = std::min(N, std::min<int64_t>(tile + tiling.blocks_per_tile, work.end) * tiling.block_size);
+              for (int64_t i = begin_t; i < end_t; ++i) {
+                std::fill(scores[i - begin_t].begin(), scores[i - begin_t].end(), ScoreValue<ThresholdType>({0, 0}));
+              }
+              for (size_t chunk = 0; chunk < static_cast<size_t>(n_trees_); chunk += n_trees_per_chunk_) {
+                size_t chunk_end = std::min(static_cast<size_t>(n_trees_), chunk + n_trees_per_chunk_);
+                for (int64_t begin = begin_t; begin < end_t; begin += tiling.block_size) {
+                  int64_t end = std::min(end_t, begin + tiling.block_size);
+                  for (size_t j = chunk; j < chunk_end; ++j) {
+                    ProcessTreeNodeLeaves(j, x_data, stride, begin, end,
+                                          [this, &agg, &scores, begin_t](int64_t i, const TreeNodeElement<ThresholdType>& leaf) {
+                                            agg.ProcessTreeNodePrediction(scores[i - begin_t], leaf, weights_);
+                                          });
+                  }
+                }
+              }
+              for (int64_t i = begin_t; i < end_t; ++i) {
+                agg.FinalizeScores(scores[i - begin_t], z_data + i * n_targets_or_classes_, -1,
+                                   label_data == nullptr ? nullptr : (label_data + i));
               }
-
-              agg.FinalizeScores(scores,
-                                 z_data + i * n_targets_or_classes_, -1,
-                                 label_data == nullptr ? nullptr : (label_data + i));
             }
           });
     }
@@ -767,6 +947,90 @@ TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(
   return root;
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename CMP, bool has_missing_tracks, typename FCT>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessFlatTreeLeaves(
+    size_t j, const InputType* x_data, int64_t stride, int64_t begin, int64_t end, FCT&& fct) const {
+  // The rows of a block walk the tree in lockstep. Every row only depends on its own position,
+  // so the loads for all the rows of the block are in flight at the same time instead of one
+  // dependent load per node, and there is no branch to mispredict.
+  constexpr int64_t block_size = 16;
+  const TreeNodeFlat<ThresholdType>* nodes = flat_nodes_.data();
+  const uint32_t root = flat_roots_[j];
+  const CMP cmp;
+  uint32_t positions[block_size];
+
+  for (int64_t batch = begin; batch < end; batch += block_size) {
+    const int64_t n_rows = std::min(block_size, end - batch);
+    const InputType* x_batch = x_data + batch * stride;
+    for (int64_t r = 0; r < n_rows; ++r) {
+      positions[r] = root;
+    }
+
+    // Leaves point to themselves, all rows reached a leaf when no row moves.
+    bool moved = true;
+    while (moved) {
+      moved = false;
+      for (int64_t r = 0; r < n_rows; ++r) {
+        const TreeNodeFlat<ThresholdType>& node = nodes[positions[r]];
+        const InputType val = x_batch[r * stride + node.feature_id];
+        bool condition = cmp(val, node.threshold);
+        if constexpr (has_missing_tracks) {
+          condition = condition || (node.missing_track_true && _isnan_(val));
+        }
+        const uint32_t next = node.child + static_cast<uint32_t>(condition);
+        moved |= next != positions[r];
+        positions[r] = next;
+      }
+    }
+
+    for (int64_t r = 0; r < n_rows; ++r) {
+      fct(batch + r, *flat_leaves_[positions[r]]);
+    }
+  }
+}
+
+#define TREE_FLAT_LEAVES(CMP)                                                 \
+  if (has_missing_tracks_) {                                                  \
+    ProcessFlatTreeLeaves<CMP, true>(j, x_data, stride, begin, end, fct);     \
+  } else {                                                                    \
+    ProcessFlatTreeLeaves<CMP, false>(j, x_data, stride, begin, end, fct);    \
+  }
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename FCT>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeaves(
+    size_t j, const InputType* x_data, int64_t stride, int64_t begin, int64_t end, FCT&& fct) const {
+  if (flat_roots_.empty()) {
+    // The trees could not be flattened, see BuildFlatTrees().
+    for (int64_t i = begin; i < end; ++i) {
+      fct(i, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+    }
+    return;
+  }
+
+  switch (flat_mode_) {
+    case NODE_MODE::LEAF:
+    case NODE_MODE::BRANCH_LEQ:
+      TREE_FLAT_LEAVES(std::less_equal<>)
+      break;
+    case NODE_MODE::BRANCH_LT:
+      TREE_FLAT_LEAVES(std::less<>)
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      TREE_FLAT_LEAVES(std::greater_equal<>)
+      break;
+    case NODE_MODE::BRANCH_GT:
+      TREE_FLAT_LEAVES(std::greater<>)
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      TREE_FLAT_LEAVES(std::equal_to<>)
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      ORT_THROW("BRANCH_NEQ trees are never flattened.");
+  }
+}
+
 // TI: input type
 // TH: threshold type, double if T==double, float otherwise
 // TO: output type
@@ -822,9 +1086,9 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
 #endif
 
   return Init(
-      80,
-      128,
-      50,
+      GetTreeEnsembleParallelOption(info, kOrtSessionOptionsTreeEnsembleParallelTree, 80),
+      GetTreeEnsembleParallelOption(info, kOrtSessionOptionsTreeEnsembleParallelTreeN, 128),
+      GetTreeEnsembleParallelOption(info, kOrtSessionOptionsTreeEnsembleParallelN, 50),
       info.GetAttrOrDefault<std::string>("aggregate_function", "SUM"),
       info.GetAttrsOrDefault<float>("base_values"),
       base_values_as_tensor,
@@ -153,20 +153,90 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // Only the filter of the 2D convolutions computed with the Winograd algorithm is packed.
+  const auto& W_shape = tensor.Shape();
+  if (input_idx != 1 || W_shape.NumDimensions() != 4 || conv_attrs_.group <= 0 || W_shape[0] % conv_attrs_.group != 0) {
+    return Status::OK();
+  }
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+
+  const size_t group_count = narrow<size_t>(conv_attrs_.group);
+  const size_t filter_count = narrow<size_t>(W_shape[0]) / group_count;
+  const size_t input_channels = narrow<size_t>(W_shape[1]);
+  if (!MlasWinogradConvSupported(kernel_shape.size(), kernel_shape.data(), dilations.data(), strides.data(),
+                                 input_channels, filter_count)) {
+    return Status::OK();
+  }
+
+  const size_t packed_W_size =
+      SafeInt<size_t>(MlasWinogradConvPackFilterSize(group_count, input_channels, filter_count)) * sizeof(float);
+  packed_W_buffer_ = IAllocator::MakeUniquePtr<void>(alloc, packed_W_size, true);
+  MlasWinogradConvPackFilter(group_count, input_channels, filter_count, tensor.Data<float>(),
+                             static_cast<float*>(packed_W_buffer_.get()));
+  W_shape_ = W_shape;
+  is_packed = true;
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_W_buffer_));
+    prepacked_weights->buffer_sizes_.push_back(packed_W_size);
+  }
+
+  return Status::OK();
+}
+
+Status Conv<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_W_buffer_ = std::move(prepacked_buffers[0]);
+
+    // PrePack() may have been skipped, so restore the shape of W from the constant input
+    const Tensor* W = nullptr;
+    if (Info().TryGetConstantInput(1, &W)) {
+      W_shape_ = W->Shape();
+    }
+  }
+
+  return Status::OK();
+}
+
+bool Conv<float>::CanSkipPrePackWithPersistedBuffers(int input_idx) const {
+  return input_idx == 1;
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
-  const Tensor* W = context->Input<Tensor>(1);
+  const Tensor* W = packed_W_buffer_ ? nullptr : context->Input<Tensor>(1);
+  const TensorShape& W_shape = W ? W->Shape() : W_shape_;
   const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
   const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   // kernel_shape is an optional attribute and has to be inferred from W if not provided
   TensorShapeVector kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   ConvPadVector pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -233,6 +303,16 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     Beta,
                     thread_pool);
 
+    if (packed_W_buffer_) {
+      MlasWinogradConv(&Parameters,
+                       Xdata.data(),
+                       static_cast<const float*>(packed_W_buffer_.get()),
+                       Bdata,
+                       Ydata.data(),
+                       thread_pool);
+      return Status::OK();
+    }
+
     auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
                                                : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
@@ -30,10 +30,25 @@ class Conv<float> : public OpKernel {
 
   Status Compute(OpKernelContext* context) const override;
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                   int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  bool CanSkipPrePackWithPersistedBuffers(int input_idx) const override;
+
  protected:
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+ private:
+  // Filter transformed for the Winograd algorithm, see MlasWinogradConvPackFilter.
+  IAllocatorUniquePtr<void> packed_W_buffer_;
+  TensorShape W_shape_;
 };
 
 }  // namespace onnxruntime
@@ -3,8 +3,11 @@
 
 #include "layer_norm_impl.h"
 
+#include <type_traits>
+
 #include "core/common/safeint.h"
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/util/math_cpuonly.h"
@@ -18,6 +21,35 @@ LayerNormImpl::LayerNormImpl(const OpKernelInfo& op_kernel_info, bool simplified
 }
 
 namespace {
+template <typename T>
+void ComputeRow(const T* p_input, T* p_output, const T* scale_data, const T* bias_data, int64_t norm_size,
+                float epsilon, bool simplified, T& mean, T& mean_square) {
+  mean = 0;
+  mean_square = 0;
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    mean += p_input[h];
+    mean_square += p_input[h] * p_input[h];
+  }
+
+  mean = mean / norm_size;
+  if (simplified) {
+    mean_square = sqrt(mean_square / norm_size + epsilon);
+  } else {
+    mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+  }
+
+  for (int64_t h = 0; h < norm_size; h++) {
+    if (simplified) {
+      p_output[h] = p_input[h] / mean_square * scale_data[h];
+    } else if (nullptr == bias_data) {
+      p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+    } else {
+      p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+    }
+  }
+}
+
 template <typename T, typename U>
 Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, bool simplified) {
   // Inputs
@@ -74,35 +106,63 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
     inv_std_dev_data = inv_std_dev->MutableData<U>();
   }
 
+  // RMSNorm of float rows is computed by MLAS, which vectorizes the sum of squares and parallelizes over the rows.
+  if constexpr (std::is_same_v<T, float> && std::is_same_v<U, float>) {
+    if (simplified) {
+      MlasComputeRmsNorm(X_data, nullptr, 0, nullptr, scale_data, Y_data, nullptr, inv_std_dev_data,
+                         onnxruntime::narrow<size_t>(norm_count), onnxruntime::narrow<size_t>(norm_size), epsilon,
+                         p_ctx->GetOperatorThreadPool());
+      return Status::OK();
+    }
+  }
+
+  // Half precision is computed in float. The scale and bias are converted once and each row is converted with
+  // MLAS into its slice of a float copy of X, so there is no scalar conversion in the loops.
+  constexpr bool is_fp16 = std::is_same_v<T, MLFloat16>;
+  using ComputeT = std::conditional_t<is_fp16, float, T>;
+
+  IAllocatorUniquePtr<float> float_buffer;
+  float* X_float = nullptr;
+  float* scale_float = nullptr;
+  float* bias_float = nullptr;
+  if constexpr (is_fp16) {
+    float_buffer = IAllocator::MakeUniquePtr<float>(alloc, SafeInt<size_t>(norm_count + 2) * norm_size);
+    scale_float = float_buffer.get();
+    X_float = scale_float + norm_size;
+    MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(scale_data), scale_float,
+                                 onnxruntime::narrow<size_t>(norm_size));
+    if (bias_data != nullptr) {
+      bias_float = X_float + norm_count * norm_size;
+      MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(bias_data), bias_float,
+                                   onnxruntime::narrow<size_t>(norm_size));
+    }
+  }
+
   concurrency::ThreadPool::TryBatchParallelFor(
       p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
       [&](ptrdiff_t task_idx) {
         const T* p_input = X_data + task_idx * norm_size;
         T* p_output = Y_data + task_idx * norm_size;
 
-        T mean = 0;
-        T mean_square = 0;
+        ComputeT mean;
+        ComputeT mean_square;
 
-        for (int64_t h = 0; h < norm_size; h++) {
-          mean += p_input[h];
-          mean_square += p_input[h] * p_input[h];
-        }
-
-        mean = mean / norm_size;
-        if (simplified) {
-          mean_square = sqrt(mean_square / norm_size + epsilon);
-        } else {
-          mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
-        }
-
-        for (int64_t h = 0; h < norm_size; h++) {
+        if constexpr (is_fp16) {
+          float* p_row = X_float + task_idx * norm_size;
+          MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(p_input), p_row,
+                                       onnxruntime::narrow<size_t>(norm_size));
           if (simplified) {
-            p_output[h] = p_input[h] / mean_square * scale_data[h];
-          } else if (nullptr == bias) {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
+            float inv_rms;
+            MlasComputeRmsNorm(p_row, nullptr, 0, nullptr, scale_float, p_row, nullptr, &inv_rms, 1,
+                               onnxruntime::narrow<size_t>(norm_size), epsilon, nullptr);
+            mean = 0.0f;
+            mean_square = 1.0f / inv_rms;
           } else {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
+            ComputeRow(p_row, p_row, scale_float, bias_float, norm_size, epsilon, simplified, mean, mean_square);
           }
+          MlasConvertFloatToHalfBuffer(p_row, p_output, onnxruntime::narrow<size_t>(norm_size));
+        } else {
+          ComputeRow(p_input, p_output, scale_data, bias_data, norm_size, epsilon, simplified, mean, mean_square);
         }
 
         if (mean_data != nullptr) {
@@ -141,7 +201,7 @@ struct SrcDispatcher {
 Status LayerNormImpl::Compute(OpKernelContext* p_ctx) const {
   const auto elem_type = p_ctx->Input<Tensor>(0)->GetElementType();
 
-  using SupportedTypeList = boost::mp11::mp_list<float, double>;
+  using SupportedTypeList = boost::mp11::mp_list<float, double, MLFloat16>;
 
   utils::MLTypeCallDispatcherFromTypeList<SupportedTypeList> t_disp(elem_type);
   return t_disp.InvokeRet<Status, SrcDispatcher>(p_ctx, axis_, epsilon_, simplified_, contrib_op_);
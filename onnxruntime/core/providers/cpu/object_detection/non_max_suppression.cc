@@ -13,10 +13,12 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 
-#include <queue>
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
 #include "non_max_suppression_helper.h"
 
 // TODO:fix the warnings
@@ -118,6 +120,95 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+
+// Boxes as [x_min, y_min, x_max, y_max] corners in separate arrays, so that the IOU of a box with all the boxes of a
+// set is computed by a loop that vectorizes. The corners and areas are computed as in nms_helpers::SuppressByIOU.
+struct NmsBoxes {
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+
+  void Init(const float* boxes_data, size_t num_boxes, int64_t center_point_box) {
+    Reserve(num_boxes);
+    for (size_t i = 0; i < num_boxes; ++i) {
+      const float* box = boxes_data + 4 * i;
+      float box_x_min, box_y_min, box_x_max, box_y_max;
+      if (0 == center_point_box) {
+        // boxes data format [y1, x1, y2, x2]
+        MaxMin(box[1], box[3], box_x_min, box_x_max);
+        MaxMin(box[0], box[2], box_y_min, box_y_max);
+      } else {
+        // boxes data format [x_center, y_center, width, height]
+        const float width_half = box[2] / 2;
+        const float height_half = box[3] / 2;
+        box_x_min = box[0] - width_half;
+        box_x_max = box[0] + width_half;
+        box_y_min = box[1] - height_half;
+        box_y_max = box[1] + height_half;
+      }
+      x_min.push_back(box_x_min);
+      y_min.push_back(box_y_min);
+      x_max.push_back(box_x_max);
+      y_max.push_back(box_y_max);
+      area.push_back((box_x_max - box_x_min) * (box_y_max - box_y_min));
+    }
+  }
+
+  void Reserve(size_t count) {
+    x_min.reserve(count);
+    y_min.reserve(count);
+    x_max.reserve(count);
+    y_max.reserve(count);
+    area.reserve(count);
+  }
+
+  void PushBack(const NmsBoxes& boxes, size_t i) {
+    x_min.push_back(boxes.x_min[i]);
+    y_min.push_back(boxes.y_min[i]);
+    x_max.push_back(boxes.x_max[i]);
+    y_max.push_back(boxes.y_max[i]);
+    area.push_back(boxes.area[i]);
+  }
+
+  // Returns true if the IOU of box i of boxes with any of these boxes exceeds iou_threshold.
+  bool SuppressByIOU(const NmsBoxes& boxes, size_t i, float iou_threshold) const {
+    const float box_x_min = boxes.x_min[i];
+    const float box_y_min = boxes.y_min[i];
+    const float box_x_max = boxes.x_max[i];
+    const float box_y_max = boxes.y_max[i];
+    const float box_area = boxes.area[i];
+
+    // The boxes are checked in blocks without branches, the first boxes have the highest scores and are the most
+    // likely to suppress the box.
+    constexpr size_t kBlockSize = 16;
+    const size_t count = x_min.size();
+    for (size_t block_start = 0; block_start < count; block_start += kBlockSize) {
+      const size_t block_end = std::min(count, block_start + kBlockSize);
+      bool suppressed = false;
+      for (size_t j = block_start; j < block_end; ++j) {
+        const float intersection_width = std::min(box_x_max, x_max[j]) - std::max(box_x_min, x_min[j]);
+        const float intersection_height = std::min(box_y_max, y_max[j]) - std::max(box_y_min, y_min[j]);
+        const float intersection_area = intersection_width * intersection_height;
+        const float union_area = box_area + area[j] - intersection_area;
+        const bool valid = (intersection_width > 0.f) & (intersection_height > 0.f) & (intersection_area > 0.f) &
+                           (box_area > 0.f) & (area[j] > 0.f) & (union_area > 0.f);
+        // union_area may be zero for the invalid pairs, whose quotient is ignored.
+        suppressed |= valid & (intersection_area / (valid ? union_area : 1.f) > iou_threshold);
+      }
+      if (suppressed) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+};
+
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
@@ -135,68 +226,67 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
 
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
-
-  struct BoxInfoPtr {
-    float score_{};
-    int64_t index_{};
-
-    BoxInfoPtr() = default;
-    explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
-    inline bool operator<(const BoxInfoPtr& rhs) const {
-      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
-    }
-  };
-
   const auto center_point_box = GetCenterPointBox();
-
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfoPtr> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_));
-
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfoPtr> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
-
-      // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
-      if (pc.score_threshold_ != nullptr) {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          if (*class_scores > score_threshold) {
-            candidate_boxes.emplace_back(*class_scores, box_index);
+  const bool has_score_threshold = pc.score_threshold_ != nullptr;
+  const size_t num_boxes = static_cast<size_t>(pc.num_boxes_);
+
+  // The corners and areas of the boxes of each batch, computed once for all the classes.
+  std::vector<NmsBoxes> batch_boxes(narrow<size_t>(pc.num_batches_));
+
+  // Each (batch, class) pair is processed independently and selects its boxes in score order.
+  const int64_t num_tasks = pc.num_batches_ * pc.num_classes_;
+  std::vector<std::vector<int64_t>> selected_boxes_of_task(narrow<size_t>(num_tasks));
+
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      tp, narrow<std::ptrdiff_t>(pc.num_batches_),
+      [&](std::ptrdiff_t batch_index) {
+        batch_boxes[batch_index].Init(boxes_data + batch_index * num_boxes * 4, num_boxes, center_point_box);
+      });
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      tp, narrow<std::ptrdiff_t>(num_tasks),
+      [&](std::ptrdiff_t task) {
+        const int64_t batch_index = task / pc.num_classes_;
+        const NmsBoxes& boxes = batch_boxes[narrow<size_t>(batch_index)];
+
+        // Filter by score_threshold_ and sort by decreasing score, then increasing box index.
+        const float* class_scores = scores_data + task * num_boxes;
+        std::vector<std::pair<float, int64_t>> candidate_boxes;
+        candidate_boxes.reserve(num_boxes);
+        for (size_t box_index = 0; box_index < num_boxes; ++box_index) {
+          if (!has_score_threshold || class_scores[box_index] > score_threshold) {
+            candidate_boxes.emplace_back(class_scores[box_index], static_cast<int64_t>(box_index));
           }
         }
-      } else {
-        for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
-          candidate_boxes.emplace_back(*class_scores, box_index);
-        }
-      }
-      std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
-
-      selected_boxes_inside_class.clear();
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfoPtr& next_top_score = sorted_boxes.top();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (SuppressByIOU(batch_boxes, next_top_score.index_, selected_index.index_, center_point_box, iou_threshold)) {
-            selected = false;
+        std::sort(candidate_boxes.begin(), candidate_boxes.end(),
+                  [](const std::pair<float, int64_t>& lhs, const std::pair<float, int64_t>& rhs) {
+                    return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+                  });
+
+        // Get the next box with top score, filter by iou_threshold against the boxes selected so far.
+        std::vector<int64_t>& selected_boxes = selected_boxes_of_task[task];
+        NmsBoxes selected;
+        selected.Reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), candidate_boxes.size()));
+        for (const auto& candidate : candidate_boxes) {
+          if (static_cast<int64_t>(selected_boxes.size()) >= max_output_boxes_per_class) {
             break;
           }
-        }
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+          const size_t box_index = static_cast<size_t>(candidate.second);
+          if (!selected.SuppressByIOU(boxes, box_index, iou_threshold)) {
+            selected.PushBack(boxes, box_index);
+            selected_boxes.push_back(candidate.second);
+          }
         }
-        sorted_boxes.pop();
-      }  // while
-    }    // for class_index
-  }      // for batch_index
+      });
+
+  std::vector<SelectedIndex> selected_indices;
+  for (int64_t task = 0; task < num_tasks; ++task) {
+    for (int64_t box_index : selected_boxes_of_task[narrow<size_t>(task)]) {
+      selected_indices.emplace_back(task / pc.num_classes_, task % pc.num_classes_, box_index);
+    }
+  }
 
   constexpr auto last_dim = 3;
   const auto num_selected = selected_indices.size();
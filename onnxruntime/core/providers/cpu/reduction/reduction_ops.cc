@@ -685,11 +685,19 @@ FastReduceKind OptimizeShapeForFastReduce(gsl::span<const int64_t> input_shape,
   fast_shape.reserve(onnxruntime::narrow<size_t>(input_shape_size));
   fast_axes.reserve(reduced_axes.size());
 
-  fast_shape.push_back(input_shape[0]);
-  if (reduce[0])
-    fast_axes.push_back(0);
-  for (int64_t i = 1; i < input_shape_size; ++i) {
-    if (reduce[onnxruntime::narrow<size_t>(i)] == reduce[onnxruntime::narrow<size_t>(i - 1)]) {
+  // Axes of dimension 1 don't change the memory layout and are skipped, so that the adjacent axes can be
+  // merged, unless all the reduced axes have a dimension of 1.
+  bool skip_unit_axes = false;
+  for (int64_t i = 0; i < input_shape_size; ++i) {
+    skip_unit_axes |= reduce[onnxruntime::narrow<size_t>(i)] && input_shape[onnxruntime::narrow<size_t>(i)] != 1;
+  }
+
+  bool last_reduce = false;
+  for (int64_t i = 0; i < input_shape_size; ++i) {
+    if (skip_unit_axes && input_shape[onnxruntime::narrow<size_t>(i)] == 1) {
+      continue;
+    }
+    if (!fast_shape.empty() && reduce[onnxruntime::narrow<size_t>(i)] == last_reduce) {
       fast_shape[onnxruntime::narrow<size_t>(fast_shape.size() - 1)] *= input_shape[onnxruntime::narrow<size_t>(i)];
     } else {
       if (reduce[onnxruntime::narrow<size_t>(i)]) {
@@ -697,15 +705,18 @@ FastReduceKind OptimizeShapeForFastReduce(gsl::span<const int64_t> input_shape,
       }
       fast_shape.push_back(input_shape[onnxruntime::narrow<size_t>(i)]);
     }
+    last_reduce = reduce[onnxruntime::narrow<size_t>(i)];
   }
+
+  const bool first_reduced = !fast_axes.empty() && fast_axes[0] == 0;
   if (fast_shape.size() == 1) {
-    return reduce[0] ? FastReduceKind::kR : FastReduceKind::kK;
+    return first_reduced ? FastReduceKind::kR : FastReduceKind::kK;
   }
   if (fast_shape.size() == 2) {
-    return reduce[0] ? FastReduceKind::kRK : FastReduceKind::kKR;
+    return first_reduced ? FastReduceKind::kRK : FastReduceKind::kKR;
   }
   if (fast_shape.size() == 3) {
-    return reduce[0] ? FastReduceKind::kRKR : FastReduceKind::kKRK;
+    return first_reduced ? FastReduceKind::kRKR : FastReduceKind::kKRK;
   }
   return FastReduceKind::kNone;
 }
@@ -778,26 +789,15 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
           return true;
         }
         case FastReduceKind::kRK: {
+          // CommonFastReduceColumns parallelizes over the kept or the reduced dimensions, whichever is large enough.
           ValidateFastReduceRK(fast_shape, *output);
-          if ((fast_shape[0] > concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 16) &&
-              (std::max(fast_shape[0], fast_shape[1]) >
-               concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 256)) {
-            // See benchmarks in PR #7719.
-            case_rk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
-            return true;
-          } else {
-            break;
-          }
+          case_rk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
+          return true;
         }
         case FastReduceKind::kKRK:
           ValidateFastReduceKRK(fast_shape, *output);
-          if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
-            // See benchmarks in PR #7719.
-            case_krk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
-            return true;
-          } else {
-            break;
-          }
+          case_krk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
+          return true;
         case FastReduceKind::kRKR:
           ValidateFastReduceRKR(fast_shape, *output);
           if (fast_shape[1] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
@@ -1051,23 +1051,12 @@ std::unique_ptr<Tensor> ReduceSum<T>::Impl(const Tensor& input, gsl::span<const
       }
       case FastReduceKind::kRK:
         ValidateFastReduceRK(fast_shape, *output);
-        if (std::max(fast_shape[0], fast_shape[1]) >
-            concurrency::ThreadPool::DegreeOfParallelism(tp) * 256) {
-          // See benchmarks in PR #7719.
-          ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, *output, tp);
-          return output;
-        } else {
-          break;
-        }
+        ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, *output, tp);
+        return output;
       case FastReduceKind::kKRK:
         ValidateFastReduceKRK(fast_shape, *output);
-        if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
-          // See benchmarks in PR #7719.
-          ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, *output, tp);
-          return output;
-        } else {
-          break;
-        }
+        ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, *output, tp);
+        return output;
       case FastReduceKind::kRKR:
         ValidateFastReduceRKR(fast_shape, *output);
         if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
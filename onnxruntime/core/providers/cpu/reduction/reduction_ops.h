@@ -16,7 +16,9 @@
 #include "core/platform/threadpool.h"
 #include "core/providers/cpu/reduction/reduction_kernel_base.h"
 #include "core/common/safeint.h"
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace onnxruntime {
 
@@ -161,6 +163,98 @@ class ReduceAggregatorBase {
   static void FastReduceRKR(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
 };
 
+/**
+  Reduces a tensor of shape [d0, d1, d2] on its middle axis, the kKRK case (kRK is d0 == 1).
+  The kept dimension d2 is contiguous: each output row is computed by accumulating the input
+  rows one after the other, with loops over contiguous elements which the compiler vectorizes.
+
+  The work is split in blocks of output columns, small enough to stay in the cache, over d0 and
+  d2. If that does not produce enough blocks to keep all threads busy, the reduced rows are split
+  in segments as well and the partial results of the segments are combined at the end.
+
+  AGG must implement the static methods:
+  *  ColumnsInit(out, row, n): out = f(row)
+  *  ColumnsUpdate(out, row, n): out = out (+) f(row)
+  *  ColumnsCombine(out, partial, n): out = out (+) partial
+  *  ColumnsFinalize(out, n, reduced_size): post processing of the result (mean, sqrt, log...)
+*/
+template <typename AGG>
+void CommonFastReduceColumns(const Tensor& input, int64_t d0, int64_t d1, int64_t d2,
+                             Tensor& output, concurrency::ThreadPool* tp) {
+  using T = typename AGG::input_type;
+  using TVAL = typename AGG::value_type;
+
+  constexpr int64_t kMinBlockSize = 64;
+  constexpr int64_t kMaxBlockSize = 4096;
+  constexpr int64_t kMinSegmentRows = 16;
+  constexpr int64_t kMinParallelSize = 16384;
+
+  const T* data = input.Data<T>();
+  TVAL* out = output.MutableData<TVAL>();
+
+  // Small reductions are not worth dispatching to the thread pool.
+  if (d0 * d1 * d2 < kMinParallelSize) {
+    tp = nullptr;
+  }
+  const int64_t dop = concurrency::ThreadPool::DegreeOfParallelism(tp);
+
+  // Blocks of columns: aim for a few blocks per thread.
+  int64_t blocks_per_row = std::clamp<int64_t>((4 * dop + d0 - 1) / d0, 1, std::max<int64_t>(1, d2 / kMinBlockSize));
+  blocks_per_row = std::max(blocks_per_row, (d2 + kMaxBlockSize - 1) / kMaxBlockSize);
+  const int64_t block_size = (d2 + blocks_per_row - 1) / blocks_per_row;
+  blocks_per_row = (d2 + block_size - 1) / block_size;
+  const int64_t block_count = d0 * blocks_per_row;
+
+  // Segments of reduced rows, when there are not enough blocks.
+  int64_t segment_count = 1;
+  if (block_count < dop) {
+    segment_count = std::clamp<int64_t>(dop / block_count, 1, std::max<int64_t>(1, d1 / kMinSegmentRows));
+  }
+  const int64_t segment_rows = (d1 + segment_count - 1) / segment_count;
+  segment_count = (d1 + segment_rows - 1) / segment_rows;
+
+  // The first segment is accumulated in the output, the following ones in a temporary buffer.
+  std::vector<TVAL> partials(onnxruntime::narrow<size_t>((segment_count - 1) * d0 * d2));
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(block_count * segment_count),
+      [&](std::ptrdiff_t task) {
+        const int64_t segment = task / block_count;
+        const int64_t block = task % block_count;
+        const int64_t row_start = segment * segment_rows;
+        const int64_t row_end = std::min(d1, row_start + segment_rows);
+        const int64_t d = block / blocks_per_row;
+        const int64_t column = (block % blocks_per_row) * block_size;
+        const int64_t n = std::min(block_size, d2 - column);
+
+        const T* p = data + (d * d1 + row_start) * d2 + column;
+        TVAL* dst = (segment == 0 ? out : partials.data() + (segment - 1) * d0 * d2) + d * d2 + column;
+        AGG::ColumnsInit(dst, p, n);
+        for (int64_t row = row_start + 1; row < row_end; ++row) {
+          p += d2;
+          AGG::ColumnsUpdate(dst, p, n);
+        }
+        if (segment_count == 1) {
+          AGG::ColumnsFinalize(dst, n, d1);
+        }
+      });
+
+  if (segment_count > 1) {
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(block_count),
+        [&](std::ptrdiff_t block) {
+          const int64_t d = block / blocks_per_row;
+          const int64_t column = (block % blocks_per_row) * block_size;
+          const int64_t n = std::min(block_size, d2 - column);
+          TVAL* dst = out + d * d2 + column;
+          for (int64_t segment = 1; segment < segment_count; ++segment) {
+            AGG::ColumnsCombine(dst, partials.data() + (segment - 1) * d0 * d2 + d * d2 + column, n);
+          }
+          AGG::ColumnsFinalize(dst, n, d1);
+        });
+  }
+}
+
 template <typename T, typename TVAL = T>
 class ReduceAggregator : public ReduceAggregatorBase {
  public:
@@ -182,6 +276,9 @@ class ReduceAggregator : public ReduceAggregatorBase {
   inline TVAL get_value() { return accumulator_; }
   static void fill_for_empty_set(Tensor&) { ORT_NOT_IMPLEMENTED(); }
 
+  // Column reduction, see CommonFastReduceColumns.
+  static inline void ColumnsFinalize(TVAL*, int64_t, int64_t) {}
+
  protected:
   static void CommonFastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                                   Tensor& output, concurrency::ThreadPool* tp,
@@ -224,6 +321,17 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
 
+  // Column reduction
+  static inline void ColumnsInit(T* out, const T* row, int64_t n) {
+    memcpy(out, row, SafeInt<size_t>(n) * sizeof(T));
+  }
+  static inline void ColumnsUpdate(T* out, const T* row, int64_t n) {
+    EigenVectorArrayMap<T>(out, n) += ConstEigenVectorArrayMap<T>(row, n);
+  }
+  static inline void ColumnsCombine(T* out, const T* partial, int64_t n) {
+    ColumnsUpdate(out, partial, n);
+  }
+
   // Fast reduction
   static inline FastReduceKind WhichFastReduce() {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
@@ -245,37 +353,12 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t N = fast_shape[1];
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-
-    int64_t n_rows = fast_shape[0];
-    memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
-        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
-          for (int64_t row = 1; row < n_rows; ++row) {
-            EigenVectorArrayMap<T>(out + begin, end - begin) += ConstEigenVectorArrayMap<T>(
-                data + row * N + begin, end - begin);
-          }
-        });
+    CommonFastReduceColumns<ReduceAggregatorSum<T>>(input, 1, fast_shape[0], fast_shape[1], output, tp);
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t N = fast_shape[2];
-    const T* data = input.Data<T>();
-    int64_t stridei = fast_shape[1] * fast_shape[2];
-    int64_t strideo = fast_shape[2];
-    T* out = output.MutableData<T>();
-    std::vector<T> one(onnxruntime::narrow<size_t>(fast_shape[1]), 1);
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
-        [one, data, fast_shape, stridei, strideo, out, N](ptrdiff_t begin, ptrdiff_t last) {
-          for (ptrdiff_t d = begin; d < last; ++d) {
-            math::MatMul<T>(1, onnxruntime::narrow<ptrdiff_t>(N), onnxruntime::narrow<ptrdiff_t>(fast_shape[1]), one.data(), data + stridei * d, out + strideo * d, nullptr);
-          }
-        });
+    CommonFastReduceColumns<ReduceAggregatorSum<T>>(input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
@@ -300,6 +383,32 @@ class ReduceAggregatorSumSquare : public ReduceAggregator<T, TVAL> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Column reduction
+  static inline void ColumnsInit(TVAL* out, const T* row, int64_t n) {
+    EigenVectorArrayMap<TVAL>(out, n) = ConstEigenVectorArrayMap<T>(row, n).square().template cast<TVAL>();
+  }
+  static inline void ColumnsUpdate(TVAL* out, const T* row, int64_t n) {
+    EigenVectorArrayMap<TVAL>(out, n) += ConstEigenVectorArrayMap<T>(row, n).square().template cast<TVAL>();
+  }
+  static inline void ColumnsCombine(TVAL* out, const TVAL* partial, int64_t n) {
+    EigenVectorArrayMap<TVAL>(out, n) += ConstEigenVectorArrayMap<TVAL>(partial, n);
+  }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kRK | FastReduceKind::kKRK;
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorSumSquare<T, TVAL>>(input, 1, fast_shape[0], fast_shape[1], output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorSumSquare<T, TVAL>>(input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+  }
 };
 
 template <typename T>
@@ -384,6 +493,24 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
   }
   inline void update(const T& v) { this->accumulator_ = v > this->accumulator_ ? v : this->accumulator_; }
 
+  // Column reduction
+  static inline void ColumnsInit(T* out, const T* row, int64_t n) {
+    memcpy(out, row, SafeInt<size_t>(n) * sizeof(T));
+  }
+  static inline void ColumnsUpdate(T* out, const T* row, int64_t n) {
+    for (int64_t j = 0; j < n; ++j) {
+      if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
+        out[j] = out[j] || row[j];
+      } else {
+        if (out[j] < row[j])
+          out[j] = row[j];
+      }
+    }
+  }
+  static inline void ColumnsCombine(T* out, const T* partial, int64_t n) {
+    ColumnsUpdate(out, partial, n);
+  }
+
   // Fast reduction
   static inline FastReduceKind WhichFastReduce() {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
@@ -415,57 +542,12 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t n_rows = fast_shape[0];
-    int64_t N = fast_shape[1];
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
-
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
-        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
-          const T* p;
-          for (int64_t row = 1; row < n_rows; ++row) {
-            p = data + row * N;
-            for (int64_t j = begin; j < end; ++j) {
-              if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-                out[j] = out[j] || p[j];
-              } else {
-                if (out[j] < p[j])
-                  out[j] = p[j];
-              }
-            }
-          }
-        });
+    CommonFastReduceColumns<ReduceAggregatorMax<T>>(input, 1, fast_shape[0], fast_shape[1], output, tp);
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1] * fast_shape[2];
-    int64_t strideo = fast_shape[2];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
-        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
-          for (ptrdiff_t j = begin; j < end; ++j) {
-            if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-              EigenVectorMap<bool>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                  ConstEigenMatrixMap<bool>(
-                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                      .cast<unsigned char>()
-                      .rowwise()
-                      .maxCoeff()
-                      .cast<bool>();
-            } else {
-              EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                  ConstEigenMatrixMap<T>(
-                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                      .rowwise()
-                      .maxCoeff();
-            }
-          }
-        });
+    CommonFastReduceColumns<ReduceAggregatorMax<T>>(input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
@@ -594,6 +676,24 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
     }
   }
 
+  // Column reduction
+  static inline void ColumnsInit(T* out, const T* row, int64_t n) {
+    memcpy(out, row, SafeInt<size_t>(n) * sizeof(T));
+  }
+  static inline void ColumnsUpdate(T* out, const T* row, int64_t n) {
+    for (int64_t j = 0; j < n; ++j) {
+      if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
+        out[j] = out[j] && row[j];
+      } else {
+        if (out[j] > row[j])
+          out[j] = row[j];
+      }
+    }
+  }
+  static inline void ColumnsCombine(T* out, const T* partial, int64_t n) {
+    ColumnsUpdate(out, partial, n);
+  }
+
   // Fast reduction
   static inline FastReduceKind WhichFastReduce() {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
@@ -625,57 +725,12 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t n_rows = fast_shape[0];
-    int64_t N = fast_shape[1];
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
-
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
-        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
-          const T* p;
-          for (int64_t row = 1; row < n_rows; ++row) {
-            p = data + row * N;
-            for (int64_t j = begin; j < end; ++j) {
-              if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-                out[j] = out[j] && p[j];
-              } else {
-                if (out[j] > p[j])
-                  out[j] = p[j];
-              }
-            }
-          }
-        });
+    CommonFastReduceColumns<ReduceAggregatorMin<T>>(input, 1, fast_shape[0], fast_shape[1], output, tp);
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1] * fast_shape[2];
-    int64_t strideo = fast_shape[2];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
-        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
-          for (ptrdiff_t j = begin; j < end; ++j) {
-            if constexpr (std::is_same_v<bool, T>) { /* bool specific impl */
-              EigenVectorMap<bool>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                  ConstEigenMatrixMap<bool>(
-                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                      .cast<unsigned char>()
-                      .rowwise()
-                      .minCoeff()
-                      .cast<bool>();
-            } else {
-              EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                  ConstEigenMatrixMap<T>(
-                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                      .rowwise()
-                      .minCoeff();
-            }
-          }
-        });
+    CommonFastReduceColumns<ReduceAggregatorMin<T>>(input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
@@ -706,6 +761,32 @@ class ReduceAggregatorProd : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(1);
   }
+
+  // Column reduction
+  static inline void ColumnsInit(T* out, const T* row, int64_t n) {
+    memcpy(out, row, SafeInt<size_t>(n) * sizeof(T));
+  }
+  static inline void ColumnsUpdate(T* out, const T* row, int64_t n) {
+    EigenVectorArrayMap<T>(out, n) *= ConstEigenVectorArrayMap<T>(row, n);
+  }
+  static inline void ColumnsCombine(T* out, const T* partial, int64_t n) {
+    ColumnsUpdate(out, partial, n);
+  }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kRK | FastReduceKind::kKRK;
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorProd<T>>(input, 1, fast_shape[0], fast_shape[1], output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorProd<T>>(input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+  }
 };
 
 template <typename T>
@@ -720,6 +801,32 @@ class ReduceAggregatorL1 : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Column reduction
+  static inline void ColumnsInit(T* out, const T* row, int64_t n) {
+    EigenVectorArrayMap<T>(out, n) = ConstEigenVectorArrayMap<T>(row, n).abs();
+  }
+  static inline void ColumnsUpdate(T* out, const T* row, int64_t n) {
+    EigenVectorArrayMap<T>(out, n) += ConstEigenVectorArrayMap<T>(row, n).abs();
+  }
+  static inline void ColumnsCombine(T* out, const T* partial, int64_t n) {
+    EigenVectorArrayMap<T>(out, n) += ConstEigenVectorArrayMap<T>(partial, n);
+  }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kRK | FastReduceKind::kKRK;
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorL1<T>>(input, 1, fast_shape[0], fast_shape[1], output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorL1<T>>(input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+  }
 };
 
 template <typename T>
@@ -734,6 +841,37 @@ class ReduceAggregatorL2 : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = static_cast<T>(0);
   }
+
+  // Column reduction
+  static inline void ColumnsInit(T* out, const T* row, int64_t n) {
+    EigenVectorArrayMap<T>(out, n) = ConstEigenVectorArrayMap<T>(row, n).square();
+  }
+  static inline void ColumnsUpdate(T* out, const T* row, int64_t n) {
+    EigenVectorArrayMap<T>(out, n) += ConstEigenVectorArrayMap<T>(row, n).square();
+  }
+  static inline void ColumnsCombine(T* out, const T* partial, int64_t n) {
+    EigenVectorArrayMap<T>(out, n) += ConstEigenVectorArrayMap<T>(partial, n);
+  }
+  static inline void ColumnsFinalize(T* out, int64_t n, int64_t) {
+    for (int64_t j = 0; j < n; ++j) {
+      out[j] = reduce_sqrt<T>(out[j]);
+    }
+  }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kRK | FastReduceKind::kKRK;
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorL2<T>>(input, 1, fast_shape[0], fast_shape[1], output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorL2<T>>(input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+  }
 };
 
 template <typename T>
@@ -748,6 +886,37 @@ class ReduceAggregatorLogSum : public ReduceAggregator<T, T> {
   static void fill_for_empty_set(Tensor& output) {
     EigenMap<T>(output).array() = -std::numeric_limits<T>::infinity();
   }
+
+  // Column reduction
+  static inline void ColumnsInit(T* out, const T* row, int64_t n) {
+    memcpy(out, row, SafeInt<size_t>(n) * sizeof(T));
+  }
+  static inline void ColumnsUpdate(T* out, const T* row, int64_t n) {
+    EigenVectorArrayMap<T>(out, n) += ConstEigenVectorArrayMap<T>(row, n);
+  }
+  static inline void ColumnsCombine(T* out, const T* partial, int64_t n) {
+    ColumnsUpdate(out, partial, n);
+  }
+  static inline void ColumnsFinalize(T* out, int64_t n, int64_t) {
+    for (int64_t j = 0; j < n; ++j) {
+      out[j] = reduce_log<T>(out[j]);
+    }
+  }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return FastReduceKind::kRK | FastReduceKind::kKRK;
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorLogSum<T>>(input, 1, fast_shape[0], fast_shape[1], output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    CommonFastReduceColumns<ReduceAggregatorLogSum<T>>(input, fast_shape[0], fast_shape[1], fast_shape[2], output, tp);
+  }
 };
 
 template <typename T>
@@ -348,8 +348,6 @@ Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
 
 template <typename T>
 Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
-  concurrency::ThreadPool* thread_pool = context.GetOperatorThreadPool();
-
   const Tensor& X = *context.Input<Tensor>(0);                                                 // inputs. [seq_length, batch_size, input_size]
   const Tensor* W = (pre_packed_input_weights_.buffer_) ? nullptr : context.Input<Tensor>(1);  // weights. [num_directions, 3*hidden_size, input_size]
   const Tensor* R = (pre_packed_recurrent_ZR_.buffer_) ? nullptr : context.Input<Tensor>(2);   // recurrence weights. [num_directions, 3*hidden_size, hidden_size]
@@ -359,51 +357,21 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   const auto* sequence_lens = context.Input<Tensor>(4);  // [batch_size]
   const auto* initial_h = context.Input<Tensor>(5);      // initial hidden. [num_directions, batch_size, hidden_size]
 
-  auto& X_shape = X.Shape();
-
-  int seq_length = narrow<int>(X_shape[0]);
-  int batch_size = narrow<int>(X_shape[1]);
-  int input_size = narrow<int>(X_shape[2]);
-
-  // #ifdef _DEBUG
-  //   std::cout << "GRU: seq_len: " << seq_length << " batch_size: " << batch_size << " input_size: " << input_size << std::endl;
-  // #endif
+  int input_size = narrow<int>(X.Shape()[2]);
 
   const auto& W_shape = (W != nullptr) ? W->Shape() : pre_packed_input_weights_.shape_;
   const auto& R_shape = (R != nullptr) ? R->Shape() : pre_packed_recurrent_ZR_.shape_;  // original shape saved
   auto status = ValidateCommonRnnInputs(X, W_shape, R_shape, B, 3, sequence_lens, initial_h, num_directions_, hidden_size_);
   ORT_RETURN_IF_ERROR(status);
 
-  // GRU outputs are optional but must be in the same order
-  TensorShape Y_dims{seq_length, num_directions_, batch_size, hidden_size_};
-  Tensor* Y = context.Output(/*index*/ 0, Y_dims);
-
-  TensorShape Y_h_dims{num_directions_, batch_size, hidden_size_};
-  Tensor* Y_h = context.Output(/*index*/ 1, Y_h_dims);
-
-  // Reset output and return if max sequence length is 0
-  if (sequence_lens != nullptr) {
-    int32_t max_sequence_length = *std::max_element(sequence_lens->Data<int32_t>(), sequence_lens->Data<int32_t>() + sequence_lens->Shape().Size());
-    if (max_sequence_length == 0) {
-      if (Y != nullptr) std::fill_n(Y->MutableData<T>(), Y_dims.Size(), T{});
-      if (Y_h != nullptr) std::fill_n(Y_h->MutableData<T>(), Y_h_dims.Size(), T{});
-      return Status::OK();
-    }
-  }
-
-  AllocatorPtr alloc;
-  status = context.GetTempSpaceAllocator(&alloc);
-  ORT_RETURN_IF_ERROR(status);
   const auto* input_weights = (W != nullptr) ? W->Data<T>() : nullptr;
   const auto recurrent_weights = (R != nullptr) ? R->DataAsSpan<T>() : gsl::span<const T>();
-  gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
 
   // spans for first direction
   const size_t input_weights_size_per_direction = 3 * hidden_size_ * input_size;
   const size_t recurrent_weights_size_per_direction_ZR = 2 * hidden_size_ * hidden_size_;
   const size_t recurrent_weights_size_per_direction_H = hidden_size_ * hidden_size_;
   const size_t recurrent_weights_size_per_direction = recurrent_weights_size_per_direction_ZR + recurrent_weights_size_per_direction_H;
-  const size_t bias_size_per_direction = 6 * hidden_size_;
 
   GemmWeights<T> input_weights_1(0, input_weights, input_weights_size_per_direction, pre_packed_input_weights_);
 
@@ -420,6 +388,79 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
     recurrent_weights_H_1.Init(0, nullptr, 0, pre_packed_recurrent_H_, nullptr);
   }
 
+  GemmWeights<T> input_weights_2;
+  GemmWeights<T> recurrent_weights_ZR_2;
+  GemmWeights<T> recurrent_weights_H_2;
+  if (direction_ == Direction::kBidirectional) {
+    input_weights_2.Init(1, input_weights, input_weights_size_per_direction, pre_packed_input_weights_, nullptr);
+
+    if (R != nullptr) {
+      auto recurrent_ZR_span = recurrent_weights.subspan(recurrent_weights_size_per_direction, recurrent_weights_size_per_direction_ZR);
+      auto recurrent_H_span = recurrent_weights.subspan(recurrent_weights_size_per_direction + recurrent_weights_size_per_direction_ZR,
+                                                        recurrent_weights_size_per_direction_H);
+      // Indices are zero since the span already provides the correct view even though we are taking the second direction weights
+      recurrent_weights_ZR_2.Init(0, recurrent_ZR_span.data(), recurrent_ZR_span.size(), pre_packed_recurrent_ZR_, nullptr);
+      recurrent_weights_H_2.Init(0, recurrent_H_span.data(), recurrent_H_span.size(), pre_packed_recurrent_H_, nullptr);
+    } else {
+      // The data ptr and the size are taken from pre-packed buffer
+      recurrent_weights_ZR_2.Init(1, nullptr, 0, pre_packed_recurrent_ZR_, nullptr);
+      recurrent_weights_H_2.Init(1, nullptr, 0, pre_packed_recurrent_H_, nullptr);
+    }
+  }
+
+  return GRUBase::ComputeImpl<T, T>(context, input_weights_1, input_weights_2,
+                                    recurrent_weights_ZR_1, recurrent_weights_ZR_2,
+                                    recurrent_weights_H_1, recurrent_weights_H_2);
+}
+
+template <typename InputT, typename WeightT>
+Status GRUBase::ComputeImpl(OpKernelContext& context,
+                            const GemmWeights<WeightT>& W_1,
+                            const GemmWeights<WeightT>& W_2,
+                            const GemmWeights<WeightT>& R_ZR_1,
+                            const GemmWeights<WeightT>& R_ZR_2,
+                            const GemmWeights<WeightT>& R_H_1,
+                            const GemmWeights<WeightT>& R_H_2) const {
+  using T = InputT;
+  concurrency::ThreadPool* thread_pool = context.GetOperatorThreadPool();
+
+  const Tensor& X = *context.Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
+
+  // optional
+  const auto* B = context.Input<Tensor>(3);              // bias. [num_directions, 6*hidden_size]
+  const auto* sequence_lens = context.Input<Tensor>(4);  // [batch_size]
+  const auto* initial_h = context.Input<Tensor>(5);      // initial hidden. [num_directions, batch_size, hidden_size]
+
+  auto& X_shape = X.Shape();
+
+  int seq_length = narrow<int>(X_shape[0]);
+  int batch_size = narrow<int>(X_shape[1]);
+  int input_size = narrow<int>(X_shape[2]);
+
+  // GRU outputs are optional but must be in the same order
+  TensorShape Y_dims{seq_length, num_directions_, batch_size, hidden_size_};
+  Tensor* Y = context.Output(/*index*/ 0, Y_dims);
+
+  TensorShape Y_h_dims{num_directions_, batch_size, hidden_size_};
+  Tensor* Y_h = context.Output(/*index*/ 1, Y_h_dims);
+
+  // Reset output and return if max sequence length is 0
+  if (sequence_lens != nullptr) {
+    int32_t max_sequence_length = *std::max_element(sequence_lens->Data<int32_t>(), sequence_lens->Data<int32_t>() + sequence_lens->Shape().Size());
+    if (max_sequence_length == 0) {
+      if (Y != nullptr) std::fill_n(Y->MutableData<T>(), Y_dims.Size(), T{});
+      if (Y_h != nullptr) std::fill_n(Y_h->MutableData<T>(), Y_h_dims.Size(), T{});
+      return Status::OK();
+    }
+  }
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context.GetTempSpaceAllocator(&alloc));
+  gsl::span<const T> bias = B != nullptr ? B->DataAsSpan<T>() : gsl::span<const T>();
+
+  // spans for first direction
+  const size_t bias_size_per_direction = 6 * hidden_size_;
+
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
   gsl::span<const T> input = X.DataAsSpan<T>();
@@ -453,23 +494,6 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   gsl::span<T> hidden_output_1 = hidden_output.subspan(0, hidden_output_size_per_direction);
 
   if (direction_ == Direction::kBidirectional) {
-    GemmWeights<T> input_weights_2(1, input_weights, input_weights_size_per_direction, pre_packed_input_weights_);
-
-    GemmWeights<T> recurrent_weights_ZR_2;
-    GemmWeights<T> recurrent_weights_H_2;
-    if (R != nullptr) {
-      auto recurrent_ZR_span = recurrent_weights.subspan(recurrent_weights_size_per_direction, recurrent_weights_size_per_direction_ZR);
-      auto recurrent_H_span = recurrent_weights.subspan(recurrent_weights_size_per_direction + recurrent_weights_size_per_direction_ZR,
-                                                        recurrent_weights_size_per_direction_H);
-      // Indices are zero since the span already provides the correct view even though we are taking the second direction weights
-      recurrent_weights_ZR_2.Init(0, recurrent_ZR_span.data(), recurrent_ZR_span.size(), pre_packed_recurrent_ZR_, nullptr);
-      recurrent_weights_H_2.Init(0, recurrent_H_span.data(), recurrent_H_span.size(), pre_packed_recurrent_H_, nullptr);
-    } else {
-      // The data ptr and the size are taken from pre-packed buffer
-      recurrent_weights_ZR_2.Init(1, nullptr, 0, pre_packed_recurrent_ZR_, nullptr);
-      recurrent_weights_H_2.Init(1, nullptr, 0, pre_packed_recurrent_H_, nullptr);
-    }
-
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
 
     gsl::span<const T> initial_hidden_2 = initial_hidden.empty()
@@ -488,23 +512,24 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_ZR_1, recurrent_weights_H_1,
-               output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_ != 0, Direction::kReverse, bias_2, initial_hidden_2,
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_ZR_2, recurrent_weights_H_2,
-               output_2, hidden_output_2);
+
+    ComputeBidirectional(
+        thread_pool,
+        [&]() { fw.Compute(input, sequence_lens_span, num_directions_, W_1, R_ZR_1, R_H_1, output_1, hidden_output_1); },
+        [&]() { bw.Compute(input, sequence_lens_span, num_directions_, W_2, R_ZR_2, R_H_2, output_2, hidden_output_2); });
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_ != 0, direction_, bias_1, initial_hidden_1,
                                        activation_funcs_.Entries()[0],
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
-    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_ZR_1, recurrent_weights_H_1,
+    gru_p.Compute(input, sequence_lens_span, num_directions_, W_1, R_ZR_1, R_H_1,
                   output_1, hidden_output_1);
   }
 
@@ -603,12 +628,13 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
 }
 
 template <typename T>
+template <typename WeightT>
 void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
                                    gsl::span<const int> sequence_lengths_arg,
                                    const int num_directions,
-                                   const GemmWeights<T>& input_weights_s,
-                                   const GemmWeights<T>& recurrent_weightsZR_s,
-                                   const GemmWeights<T>& recurrent_weightsH_s,
+                                   const GemmWeights<WeightT>& input_weights_s,
+                                   const GemmWeights<WeightT>& recurrent_weightsZR_s,
+                                   const GemmWeights<WeightT>& recurrent_weightsH_s,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   ComputeImpl(inputs_arg, sequence_lengths_arg, num_directions,
@@ -617,12 +643,13 @@ void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
 }
 
 template <typename T>
+template <typename WeightT>
 void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
                                    gsl::span<const int> sequence_lengths_arg,
                                    const int num_directions,
-                                   const GemmWeights<T>& input_weights_s,
-                                   const GemmWeights<T>& recurrent_weightsZR_s,
-                                   const GemmWeights<T>& recurrent_weightsH_s,
+                                   const GemmWeights<WeightT>& input_weights_s,
+                                   const GemmWeights<WeightT>& recurrent_weightsZR_s,
+                                   const GemmWeights<WeightT>& recurrent_weightsH_s,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state,
                                    gsl::span<T>& zrh) {
@@ -632,12 +659,13 @@ void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
 }
 
 template <typename T>
+template <typename WeightT>
 void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
                                        gsl::span<const int> sequence_lengths_arg,
                                        const int num_directions,
-                                       const GemmWeights<T>& input_weights_s,
-                                       const GemmWeights<T>& recurrent_weightsZR_s,
-                                       const GemmWeights<T>& recurrent_weightsH_s,
+                                       const GemmWeights<WeightT>& input_weights_s,
+                                       const GemmWeights<WeightT>& recurrent_weightsZR_s,
+                                       const GemmWeights<WeightT>& recurrent_weightsH_s,
                                        gsl::span<T>& outputs,
                                        gsl::span<T>& final_hidden_state,
                                        gsl::span<T>& zrh) {
@@ -654,21 +682,7 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
     sequence_lengths = sequence_lengths_;
   }
 
-  gsl::span<const T> input_weights;
-  if (!input_weights_s.is_prepacked_) {
-    input_weights = input_weights_s.GetUnpackedSpan();
-    DumpMatrix("Inputs", inputs.data(), seq_length_ * batch_size_, input_size_);
-    DumpMatrix("input_weights", input_weights.data(), 3 * hidden_size_, input_size_);
-    DumpMatrix("recurrent_weights", recurrent_weights.data(), 3 * hidden_size_, hidden_size_);
-  }
-
-  gsl::span<const T> recurrent_weightsZR;
-  if (!recurrent_weightsZR_s.is_prepacked_)
-    recurrent_weightsZR = recurrent_weightsZR_s.GetUnpackedSpan();
-
-  gsl::span<const T> recurrent_weightsH;
-  if (!recurrent_weightsH_s.is_prepacked_)
-    recurrent_weightsH = recurrent_weightsH_s.GetUnpackedSpan();
+  DumpMatrix("Inputs", inputs.data(), seq_length_ * batch_size_, input_size_);
 
   gsl::span<T> original_outputs = outputs;
   const bool output_sequence = !outputs.empty();
@@ -695,29 +709,17 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
 
   float alpha = 1.0f;
 
+  AllocateQuantizeBuffers<WeightT>(max_sequence_length);
+
   // apply weights to all the inputs
-  if (!input_weights_s.is_prepacked_) {
-    ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
-                inputs.begin(), inputs.end(),
-                input_size_,
-                input_weights.begin(), input_weights.end(),
-                input_size_, 0.f,
-                zrh.begin(), zrh.end(),
-                hidden_size_x3, ttp_);
-  } else {
-    MlasGemm(
-        CblasNoTrans,
-        static_cast<size_t>(total_rows),
-        static_cast<size_t>(hidden_size_x3),
-        static_cast<size_t>(input_size_),
-        alpha,
-        inputs.data(),
-        static_cast<size_t>(input_size_),
-        input_weights_s.buffer_,
-        0.0f,
-        &*zrh.begin(),
-        static_cast<size_t>(hidden_size_x3), ttp_);
-  }
+  ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
+              inputs.data(), inputs.data() + inputs.size(),
+              input_weights_s, 0.f,
+              zrh.data(), zrh.data() + zrh.size(),
+              hidden_size_x3,
+              quantized_input_or_a_.data(),
+              nullptr,
+              ttp_);
 
   DumpMatrix("inputs with weights applied", zrh.data(), seq_length_ * batch_size_ * 3, hidden_size_);
 
@@ -781,25 +783,14 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
 
       // calculate Ht-1*R[zr], and add to the weighted inputs that are in zrh
       // Ht-1 * R[zr] + Xt*(W[zr]^T)
-      if (!recurrent_weightsZR_s.is_prepacked_) {
-        ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
-                    prev_Ht, prev_Ht_end,
-                    hidden_size_,
-                    recurrent_weightsZR.begin(), recurrent_weightsZR.end(),
-                    hidden_size_, 1.f,  // beta == 1 so we add existing values in zrh
-                    zrh.begin() + out_added_offset, zrh.end(),
-                    hidden_size_x3, ttp_);
-      } else {
-        MlasGemm(
-            CblasNoTrans,
-            static_cast<size_t>(batch_size_), static_cast<size_t>(hidden_size_x2), static_cast<size_t>(hidden_size_), alpha,
-            &*prev_Ht,
-            static_cast<size_t>(hidden_size_),
-            recurrent_weightsZR_s.buffer_,
-            1.f,
-            &*(zrh.begin() + out_added_offset),
-            static_cast<size_t>(hidden_size_x3), ttp_);
-      }
+      ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
+                  &*prev_Ht, &*prev_Ht + (prev_Ht_end - prev_Ht),
+                  recurrent_weightsZR_s, 1.f,  // beta == 1 so we add existing values in zrh
+                  zrh.data() + out_added_offset, zrh.data() + zrh.size(),
+                  hidden_size_x3,
+                  quantized_input_or_a_.data(),
+                  quantized_C_buffer_.data(),
+                  ttp_);
 
       DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
                  zrh.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
@@ -813,27 +804,15 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
         }
 
         // compute Ht-1 * (Rh^T) + Rbh
-        if (!recurrent_weightsH_s.is_prepacked_) {
-          ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                      prev_Ht, prev_Ht_end,  // Ht-1
-                      hidden_size_,
-                      recurrent_weightsH.begin(), recurrent_weightsH.end(),  // Rh^T
-                      hidden_size_,
-                      use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
-                      linear_output_.begin(),
-                      linear_output_.end(),  // pre: Rbh if use_bias_, post:output
-                      hidden_size_, ttp_);
-        } else {
-          MlasGemm(
-              CblasNoTrans,
-              static_cast<size_t>(batch_size_), static_cast<size_t>(hidden_size_), static_cast<size_t>(hidden_size_), alpha,
-              &*prev_Ht,
-              static_cast<size_t>(hidden_size_),
-              recurrent_weightsH_s.buffer_,
-              use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
-              &*linear_output_.begin(),
-              static_cast<size_t>(hidden_size_), ttp_);
-        }
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    &*prev_Ht, &*prev_Ht + (prev_Ht_end - prev_Ht),  // Ht-1
+                    recurrent_weightsH_s,                            // Rh^T
+                    use_bias_ ? 1.f : 0.f,                           // don't add values in linear_output_ if no bias input
+                    linear_output_.data(), linear_output_.data() + linear_output_.size(),  // pre: Rbh if use_bias_, post:output
+                    hidden_size_,
+                    quantized_input_or_a_.data(),
+                    quantized_C_buffer_.data(),
+                    ttp_);
 
         DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
       }
@@ -898,25 +877,15 @@ void UniDirectionalGru<T>::ComputeImpl(gsl::span<const T> inputs_arg,
         auto out_H = zrh.begin() + out_added_offset + hidden_size_x2;
 
         // Calculate Xt*(Wh^T) + rt (.) Ht-1 * Rh
-        if (!recurrent_weightsH_s.is_prepacked_) {
-          ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                      cur_h_local, cur_h_local_end,  // rt (.) Ht-1
-                      hidden_size_,
-                      recurrent_weightsH.begin(), recurrent_weightsH.end(),  // Rh^T
-                      hidden_size_, 1.f,                                     // beta == 1 to add Xt*(Wh^T) from out_H
-                      out_H, zrh.end(),
-                      hidden_size_x3, ttp_);
-        } else {
-          MlasGemm(
-              CblasNoTrans,
-              static_cast<size_t>(batch_size_), static_cast<size_t>(hidden_size_), static_cast<size_t>(hidden_size_), alpha,
-              &*cur_h_local,
-              static_cast<size_t>(hidden_size_),
-              recurrent_weightsH_s.buffer_,
-              1.f,  // beta == 1 to add Xt*(Wh^T) from out_H
-              &*out_H,
-              static_cast<size_t>(hidden_size_x3), ttp_);
-        }
+        ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
+                    &*cur_h_local, &*cur_h_local + (cur_h_local_end - cur_h_local),  // rt (.) Ht-1
+                    recurrent_weightsH_s,                                            // Rh^T
+                    1.f,                                                             // beta == 1 to add Xt*(Wh^T) from out_H
+                    &*out_H, zrh.data() + zrh.size(),
+                    hidden_size_x3,
+                    quantized_input_or_a_.data(),
+                    quantized_C_buffer_.data(),
+                    ttp_);
       }
 
       DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, zrh.data() + out_added_offset,
@@ -1070,7 +1039,57 @@ void UniDirectionalGru<T>::AllocateBuffers() {
   }
 }
 
+template <typename T>
+template <typename WeightT>
+void UniDirectionalGru<T>::AllocateQuantizeBuffers(int max_sequence_length) {
+  // Can not specialize on WeightT without specify T explicitly, so use sizeof
+  if constexpr (sizeof(WeightT) == 1) {
+    const int total_rows = max_sequence_length * batch_size_;
+
+    int input_or_a_size = std::max(total_rows * input_size_, batch_size_ * hidden_size_);
+    quantized_input_or_a_ = Allocate(allocator_, input_or_a_size, quantized_input_or_a_ptr_, false);
+    // the widest GEMM accumulating into existing values is Ht-1 * R[zr]
+    quantized_C_buffer_ = Allocate(allocator_, batch_size_ * 2 * hidden_size_, quantized_C_buffer_ptr_, false);
+  }
+}
+
 template class UniDirectionalGru<float>;
 
+template void UniDirectionalGru<float>::Compute<float>(gsl::span<const float> inputs,
+                                                       gsl::span<const int> sequence_lengths,
+                                                       int num_directions,
+                                                       const GemmWeights<float>& input_weights,
+                                                       const GemmWeights<float>& recurrent_weights_ZR,
+                                                       const GemmWeights<float>& recurrent_weights_H,
+                                                       gsl::span<float>& outputs,
+                                                       gsl::span<float>& final_hidden_state);
+
+template void UniDirectionalGru<float>::Compute<float>(gsl::span<const float> inputs,
+                                                       gsl::span<const int> sequence_lengths,
+                                                       int num_directions,
+                                                       const GemmWeights<float>& input_weights,
+                                                       const GemmWeights<float>& recurrent_weights_ZR,
+                                                       const GemmWeights<float>& recurrent_weights_H,
+                                                       gsl::span<float>& outputs,
+                                                       gsl::span<float>& final_hidden_state,
+                                                       gsl::span<float>& zrh);
+
 }  // namespace detail
+
+template Status GRUBase::ComputeImpl<float, float>(OpKernelContext& context,
+                                                   const GemmWeights<float>& W_1,
+                                                   const GemmWeights<float>& W_2,
+                                                   const GemmWeights<float>& R_ZR_1,
+                                                   const GemmWeights<float>& R_ZR_2,
+                                                   const GemmWeights<float>& R_H_1,
+                                                   const GemmWeights<float>& R_H_2) const;
+
+template Status GRUBase::ComputeImpl<float, uint8_t>(OpKernelContext& context,
+                                                     const GemmWeights<uint8_t>& W_1,
+                                                     const GemmWeights<uint8_t>& W_2,
+                                                     const GemmWeights<uint8_t>& R_ZR_1,
+                                                     const GemmWeights<uint8_t>& R_ZR_2,
+                                                     const GemmWeights<uint8_t>& R_H_1,
+                                                     const GemmWeights<uint8_t>& R_H_2) const;
+
 }  // namespace onnxruntime
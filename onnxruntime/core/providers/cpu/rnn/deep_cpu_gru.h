@@ -11,11 +11,10 @@
 
 namespace onnxruntime {
 
-/// The class represents GRU operator using DeepCPU implementation for
-/// fast inference computation on CPU machines.
-class DeepCpuGruOp final : public OpKernel {
- public:
-  DeepCpuGruOp(const OpKernelInfo& info) : OpKernel(info) {
+/// Attributes and direction handling shared by the GRU kernels, which differ in the type of their weights.
+class GRUBase {
+ protected:
+  GRUBase(const OpKernelInfo& info) {
     // required attributes
     std::string direction;
     ORT_ENFORCE(info.GetAttr("direction", &direction).IsOK());
@@ -56,6 +55,36 @@ class DeepCpuGruOp final : public OpKernel {
                 "Batchwise recurrent operations (layout == 1) are not supported. If you need support create a github issue with justification.");
   }
 
+  ~GRUBase() = default;
+
+  // Runs the GRU over the inputs of `context` (X, B, sequence_lens and initial_h at inputs 0, 3, 4 and 5).
+  // The weights of each direction are split into W[zrh], R[zr] and R[h]. The caller has validated the inputs.
+  template <typename InputT, typename WeightT>
+  Status ComputeImpl(OpKernelContext& context,
+                     const rnn::detail::GemmWeights<WeightT>& W_1,
+                     const rnn::detail::GemmWeights<WeightT>& W_2,
+                     const rnn::detail::GemmWeights<WeightT>& R_ZR_1,
+                     const rnn::detail::GemmWeights<WeightT>& R_ZR_2,
+                     const rnn::detail::GemmWeights<WeightT>& R_H_1,
+                     const rnn::detail::GemmWeights<WeightT>& R_H_2) const;
+
+  rnn::detail::Direction direction_;
+  int num_directions_;
+
+  int hidden_size_{};
+  float clip_;
+  int linear_before_reset_{};
+  int64_t layout_;
+
+  rnn::detail::ActivationFuncs activation_funcs_;
+};
+
+/// The class represents GRU operator using DeepCPU implementation for
+/// fast inference computation on CPU machines.
+class DeepCpuGruOp final : public OpKernel, public GRUBase {
+ public:
+  DeepCpuGruOp(const OpKernelInfo& info) : OpKernel(info), GRUBase(info) {}
+
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuGruOp() override = default;
@@ -73,16 +102,6 @@ class DeepCpuGruOp final : public OpKernel {
 
   bool TryPackRecurrentWeights(const Tensor& weights, AllocatorPtr& alloc);
 
-  rnn::detail::Direction direction_;
-  int num_directions_;
-
-  int hidden_size_{};
-  float clip_;
-  int linear_before_reset_{};
-  int64_t layout_;
-
-  rnn::detail::ActivationFuncs activation_funcs_;
-
   // This kernel supports either forward or bidirectional
   // This is split in half for bidirectional, but we prepack it in the same buffer
   rnn::detail::PackedWeights pre_packed_input_weights_;
@@ -107,32 +126,39 @@ class UniDirectionalGru {
                     onnxruntime::concurrency::ThreadPool* ttp,
                     const bool training_mode = false);
 
+  template <typename WeightT>
   void Compute(gsl::span<const T> inputs, gsl::span<const int> sequence_lengths, int num_directions,
-               const rnn::detail::GemmWeights<T>& input_weights,
-               const rnn::detail::GemmWeights<T>& recurrent_weights_ZR,
-               const rnn::detail::GemmWeights<T>& recurrent_weights_H,
+               const rnn::detail::GemmWeights<WeightT>& input_weights,
+               const rnn::detail::GemmWeights<WeightT>& recurrent_weights_ZR,
+               const rnn::detail::GemmWeights<WeightT>& recurrent_weights_H,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   // This function overloads the above one by adding two additional reference inputs that are computed in this kernel:
   //   - zrh: intermediate gate computations
   // This extra output is needed for training for gradient computation.
+  template <typename WeightT>
   void Compute(gsl::span<const T> inputs, gsl::span<const int> sequence_lengths, int num_directions,
-               const rnn::detail::GemmWeights<T>& input_weights,
-               const rnn::detail::GemmWeights<T>& recurrent_weights_ZR,
-               const rnn::detail::GemmWeights<T>& recurrent_weights_H,
+               const rnn::detail::GemmWeights<WeightT>& input_weights,
+               const rnn::detail::GemmWeights<WeightT>& recurrent_weights_ZR,
+               const rnn::detail::GemmWeights<WeightT>& recurrent_weights_H,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state,
                gsl::span<T>& zrh);
 
   ~UniDirectionalGru() = default;
 
  private:
+  template <typename WeightT>
   void ComputeImpl(gsl::span<const T> inputs, gsl::span<const int> sequence_lengths, int num_directions,
-                   const rnn::detail::GemmWeights<T>& input_weights,
-                   const rnn::detail::GemmWeights<T>& recurrent_weights_ZR,
-                   const rnn::detail::GemmWeights<T>& recurrent_weights_H,
+                   const rnn::detail::GemmWeights<WeightT>& input_weights,
+                   const rnn::detail::GemmWeights<WeightT>& recurrent_weights_ZR,
+                   const rnn::detail::GemmWeights<WeightT>& recurrent_weights_H,
                    gsl::span<T>& outputs, gsl::span<T>& final_hidden_state,
                    gsl::span<T>& zrh);
 
+  // Buffers for the dynamically quantized inputs and int32 accumulators of the GEMMs with 8-bit weights
+  template <typename WeightT>
+  void AllocateQuantizeBuffers(int max_sequence_length);
+
   AllocatorPtr allocator_;
 
   int seq_length_;
@@ -173,6 +199,11 @@ class UniDirectionalGru {
   IAllocatorUniquePtr<T> linear_output_ptr_;
   gsl::span<T> linear_output_;
 
+  IAllocatorUniquePtr<uint8_t> quantized_input_or_a_ptr_;
+  gsl::span<uint8_t> quantized_input_or_a_;
+  IAllocatorUniquePtr<int32_t> quantized_C_buffer_ptr_;
+  gsl::span<int32_t> quantized_C_buffer_;
+
   IAllocatorUniquePtr<T> inputs_reverse_ptr_;
   IAllocatorUniquePtr<T> outputs_reverse_ptr_;
   gsl::span<T> inputs_reverse_;
@@ -286,6 +286,27 @@ inline void ComputeGemm(const int M,
               thread_pool);
 }
 
+// Runs the forward and backward directions of a bidirectional RNN. The two recurrences are independent,
+// so they run concurrently when the thread pool has a thread to spare: with a small batch the recurrent
+// GEMM of a single step is too small to keep the pool busy on its own. Both directions keep using the
+// pool for their own parallel loops.
+template <typename TForward, typename TBackward>
+void ComputeBidirectional(concurrency::ThreadPool* thread_pool, TForward&& forward, TBackward&& backward) {
+  if (concurrency::ThreadPool::DegreeOfParallelism(thread_pool) < 2) {
+    forward();
+    backward();
+    return;
+  }
+
+  concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, 2, [&](std::ptrdiff_t direction) {
+    if (direction == 0) {
+      forward();
+    } else {
+      backward();
+    }
+  });
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
@@ -275,13 +275,29 @@ void UniDirectionalLstm<T>::ComputeImpl(const gsl::span<const T>& inputs_arg,
 
   ///**************************LSTM Calculations****************************/
   float alpha = 1.0f;
-  float beta = 0.0f;  // first call to ComputeGemm zeros out any existing data
+  float beta = 0.0f;  // first call to ComputeGemm zeros out any existing data, unless it holds the biases
 
   const int hidden_size_x4 = 4 * hidden_size_;
   const int total_rows = max_sequence_length * batch_size_;
 
   AllocateQuantizeBuffers<WeightT>(max_sequence_length);
 
+  // With float weights the input GEMM accumulates onto the gate biases, which keeps the bias adds out of
+  // the per-step gate computations. The quantized GEMM can only accumulate into a single step of output_iofc.
+  if constexpr (sizeof(WeightT) != 1) {
+    if (use_bias_) {
+      for (int row = 0; row < total_rows; ++row) {
+        auto row_iofc = output_iofc.begin() + row * hidden_size_x4;
+        row_iofc = std::copy(bias_WRi_.begin(), bias_WRi_.end(), row_iofc);
+        row_iofc = std::copy(bias_WRo_.begin(), bias_WRo_.end(), row_iofc);
+        row_iofc = std::copy(bias_WRf_.begin(), bias_WRf_.end(), row_iofc);
+        std::copy(bias_WRc_.begin(), bias_WRc_.end(), row_iofc);
+      }
+      beta = 1.0f;
+      clip_with_bias_ptr_ = deepcpu::clip_ignore_bias;
+    }
+  }
+
   // apply the weights to all the inputs and save to output_IOFC
   ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha, inputs,
               input_weights,
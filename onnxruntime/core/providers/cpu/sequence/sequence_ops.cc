@@ -17,8 +17,10 @@ using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
-// TODO: The current implementation of sequence ops relies on tensor copies. Ideally we should try to avoid
-// these copies. This has been postponed due to lack of time.
+// The tensors of a sequence are never modified once added, so the sequence ops share them between their input and
+// output sequences. The tensor inputs are still copied, as their buffers belong to the allocation plan.
+// SequenceInsert and SequenceErase update their input sequence in place when the allocation planner reuses it for
+// the output, i.e. at its last use, which keeps a chain of them linear in the number of tensors.
 
 // SequenceLength
 ONNX_CPU_OPERATOR_KERNEL(
@@ -192,6 +194,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     SequenceInsert,
     11,
     KernelDefBuilder()
+        .MayInplace(0, 0)
         .TypeConstraint("S", DataTypeImpl::AllSequenceTensorTypes())
         .TypeConstraint("I", std::vector<MLDataType>{
                                  DataTypeImpl::GetTensorType<int32_t>(),
@@ -234,6 +237,12 @@ Status SequenceInsert::Compute(OpKernelContext* context) const {
   }
 
   auto* Y = context->Output<TensorSeq>(0);
+  if (Y == S) {
+    // the input sequence is reused for the output
+    Y->InsertAt(narrow<size_t>(input_seq_idx), CloneTensor(*X, context, Info().GetDataTransferManager()));
+    return Status::OK();
+  }
+
   Y->SetType(S->DataType());
   Y->Reserve(SafeInt<size_t>(num_tensors_input_seq) + 1);
 
@@ -259,6 +268,7 @@ ONNX_CPU_OPERATOR_KERNEL(
     SequenceErase,
     11,
     KernelDefBuilder()
+        .MayInplace(0, 0)
         .TypeConstraint("S", DataTypeImpl::AllSequenceTensorTypes())
         .TypeConstraint("I", std::vector<MLDataType>{
                                  DataTypeImpl::GetTensorType<int32_t>(),
@@ -284,6 +294,12 @@ Status SequenceErase::Compute(OpKernelContext* context) const {
   }
 
   auto* Y = context->Output<TensorSeq>(0);
+  if (Y == S) {
+    // the input sequence is reused for the output
+    Y->EraseAt(narrow<size_t>(input_seq_idx));
+    return Status::OK();
+  }
+
   Y->SetType(S->DataType());
   Y->Reserve(SafeInt<size_t>(num_tensors_input_seq) - 1);
 
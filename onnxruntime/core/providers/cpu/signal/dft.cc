@@ -7,6 +7,8 @@
 #include <complex>
 #include <functional>
 #include <limits>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 #include <core/common/safeint.h>
 
@@ -100,11 +102,116 @@ static std::complex<T> compute_exponential(size_t index, const T angular_velocit
   return std::complex<T>(cos(angle), sin(angle));
 }
 
+// Fills V with the twiddle factors of a dft_length FFT ordered with the bit-reversed permutation.
+// The first 2^k entries are also the twiddle factors of a 2^k FFT, so V serves every smaller power of 2.
+template <typename T>
+static void create_radix2_twiddle_factors(size_t dft_length, bool inverse, InlinedVector<std::complex<T>>& V) {
+  if (V.size() == dft_length) {
+    return;
+  }
+
+  unsigned significant_bits = static_cast<unsigned>(log2(dft_length));
+  auto angular_velocity = compute_angular_velocity<T>(dft_length, inverse);
+
+  // Create vandermonde matrix V ordered with the bit-reversed permutation
+  V.resize(dft_length);
+  for (size_t i = 0; i < dft_length; i++) {
+    size_t bit_reversed_index = bit_reverse(i, significant_bits);
+    V[bit_reversed_index] = compute_exponential(i, angular_velocity);
+  }
+}
+
+// In-place butterflies of a radix-2 FFT of Y_data, whose elements are in bit-reversed order.
+template <typename T>
+static void radix2_butterflies(std::complex<T>* Y_data, size_t Y_data_stride, size_t length,
+                               const InlinedVector<std::complex<T>>& V) {
+  unsigned current_significant_bits = 0;
+  for (size_t i = 2; i <= length; i <<= 1) {
+    size_t midpoint = i >> 1;
+    current_significant_bits++;
+
+    for (size_t k = 0; k < midpoint; k++) {
+      auto first_idx = bit_reverse(k, current_significant_bits);
+      auto second_idx = bit_reverse(midpoint + k, current_significant_bits);
+      for (size_t j = 0; j < length; j += i) {
+        auto even_index = k + j;
+        auto odd_index = k + j + midpoint;
+        std::complex<T>* even = (Y_data + even_index * Y_data_stride);
+        std::complex<T>* odd = (Y_data + odd_index * Y_data_stride);
+        std::complex<T> first = *even + (V[first_idx] * *odd);
+        std::complex<T> second = *even + (V[second_idx] * *odd);
+        *even = first;
+        *odd = second;
+      }
+    }
+  }
+}
+
+// DFT of a real signal with a complex FFT of half the length: the even samples are packed in the real parts and the
+// odd samples in the imaginary parts, and the spectra of both halves are separated with the conjugate symmetry.
+template <typename T>
+static Status fft_radix2_real(const Tensor* X, Tensor* Y, size_t X_offset, size_t X_stride, size_t Y_offset,
+                              size_t Y_stride, int64_t axis, size_t dft_length, const Tensor* window,
+                              bool is_onesided, bool inverse, InlinedVector<std::complex<T>>& V,
+                              InlinedVector<std::complex<T>>& temp_output) {
+  const auto& X_shape = X->Shape();
+  size_t number_of_samples = static_cast<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
+  unsigned significant_bits = static_cast<unsigned>(log2(dft_length));
+  const size_t half_length = dft_length >> 1;
+
+  const T* X_data = reinterpret_cast<const T*>(X->DataRaw()) + X_offset;
+  const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
+  auto sample = [&](size_t n) -> T {
+    if (n >= number_of_samples) {
+      return 0;
+    }
+    return window_data ? X_data[n * X_stride] * window_data[n] : X_data[n * X_stride];
+  };
+
+  create_radix2_twiddle_factors(dft_length, inverse, V);
+
+  if (temp_output.size() != half_length) {
+    temp_output.resize(half_length);
+  }
+  std::complex<T>* Z = temp_output.data();
+  for (size_t i = 0; i < half_length; i++) {
+    size_t bit_reversed_index = bit_reverse(i, significant_bits - 1);
+    Z[i] = std::complex<T>(sample(2 * bit_reversed_index), sample(2 * bit_reversed_index + 1));
+  }
+
+  radix2_butterflies(Z, 1, half_length, V);
+
+  const T scale = inverse ? static_cast<T>(1) / static_cast<T>(dft_length) : static_cast<T>(1);
+  const std::complex<T> minus_half_i(0, static_cast<T>(-0.5));
+  auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw()) + Y_offset;
+  for (size_t k = 0; k <= half_length; k++) {
+    const std::complex<T> z = Z[k % half_length];
+    const std::complex<T> z_mirror = std::conj(Z[(half_length - k) % half_length]);
+    const std::complex<T> even = static_cast<T>(0.5) * (z + z_mirror);
+    const std::complex<T> odd = minus_half_i * (z - z_mirror);
+    const std::complex<T> twiddle = k < half_length ? V[bit_reverse(k, significant_bits)] : std::complex<T>(-1, 0);
+    const std::complex<T> y = (even + twiddle * odd) * scale;
+    *(Y_data + k * Y_stride) = y;
+    if (!is_onesided && k > 0 && k < half_length) {
+      *(Y_data + (dft_length - k) * Y_stride) = std::conj(y);
+    }
+  }
+
+  return Status::OK();
+}
+
 template <typename T, typename U>
 static Status fft_radix2(OpKernelContext* /*ctx*/, const Tensor* X, Tensor* Y, size_t X_offset, size_t X_stride,
                          size_t Y_offset, size_t Y_stride, int64_t axis, size_t dft_length, const Tensor* window,
                          bool is_onesided, bool inverse, InlinedVector<std::complex<T>>& V,
                          InlinedVector<std::complex<T>>& temp_output) {
+  if constexpr (std::is_same_v<T, U>) {
+    if (dft_length >= 4) {
+      return fft_radix2_real<T>(X, Y, X_offset, X_stride, Y_offset, Y_stride, axis, dft_length, window,
+                                is_onesided, inverse, V, temp_output);
+    }
+  }
+
   // Get shape and significant bits
   const auto& X_shape = X->Shape();
   size_t number_of_samples = static_cast<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
@@ -130,16 +237,7 @@ static Status fft_radix2(OpKernelContext* /*ctx*/, const Tensor* X, Tensor* Y, s
     Y_data_stride = Y_stride;
   }
 
-  auto angular_velocity = compute_angular_velocity<T>(dft_length, inverse);
-
-  // Create vandermonde matrix V ordered with the bit-reversed permutation
-  if (V.size() != dft_length) {
-    V.resize(dft_length);
-    for (size_t i = 0; i < dft_length; i++) {
-      size_t bit_reversed_index = bit_reverse(i, significant_bits);
-      V[bit_reversed_index] = compute_exponential(i, angular_velocity);
-    }
-  }
+  create_radix2_twiddle_factors(dft_length, inverse, V);
 
   for (size_t i = 0; i < dft_length; i++) {
     size_t bit_reversed_index = bit_reverse(i, significant_bits);
@@ -149,26 +247,7 @@ static Status fft_radix2(OpKernelContext* /*ctx*/, const Tensor* X, Tensor* Y, s
   }
 
   // Run fft_radix2
-  unsigned current_significant_bits = 0;
-  for (size_t i = 2; i <= dft_length; i <<= 1) {
-    size_t midpoint = i >> 1;
-    current_significant_bits++;
-
-    for (size_t k = 0; k < midpoint; k++) {
-      auto first_idx = bit_reverse(k, current_significant_bits);
-      auto second_idx = bit_reverse(midpoint + k, current_significant_bits);
-      for (size_t j = 0; j < dft_length; j += i) {
-        auto even_index = k + j;
-        auto odd_index = k + j + midpoint;
-        std::complex<T>* even = (Y_data + even_index * Y_data_stride);
-        std::complex<T>* odd = (Y_data + odd_index * Y_data_stride);
-        std::complex<T> first = *even + (V[first_idx] * *odd);
-        std::complex<T> second = *even + (V[second_idx] * *odd);
-        *even = first;
-        *odd = second;
-      }
-    }
-  }
+  radix2_butterflies(Y_data, Y_data_stride, dft_length, V);
 
   // Scale the output if inverse
   if (inverse) {
@@ -333,7 +412,7 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
   }
 
   // Calculate x/y offsets/strides
-  for (size_t i = 0; i < total_dfts; i++) {
+  auto run_dft = [&](size_t i, InlinedVector<std::complex<T>>& dft_temp_output) -> Status {
     size_t X_offset = 0;
     size_t X_stride = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
     size_t cumulative_packed_stride = total_dfts;
@@ -363,12 +442,38 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
     }
 
     if (is_power_of_2(onnxruntime::narrow<size_t>(dft_length))) {
-      ORT_RETURN_IF_ERROR((fft_radix2<T, U>(ctx, X, Y, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window,
-                                            is_onesided, inverse, V, temp_output)));
-    } else {
-      ORT_RETURN_IF_ERROR(
-          (dft_bluestein_z_chirp<T, U>(ctx, X, Y, b_fft, chirp, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window, inverse, V, temp_output)));
+      return fft_radix2<T, U>(ctx, X, Y, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window,
+                              is_onesided, inverse, V, dft_temp_output);
     }
+    return dft_bluestein_z_chirp<T, U>(ctx, X, Y, b_fft, chirp, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window, inverse, V, dft_temp_output);
+  };
+
+  if (total_dfts == 0) {
+    return Status::OK();
+  }
+
+  // The first transform creates the twiddle factors and the chirp, which the other transforms only read,
+  // so they can run in parallel with their own scratch buffers.
+  ORT_RETURN_IF_ERROR(run_dft(0, temp_output));
+  if (total_dfts > 1) {
+    std::mutex status_mutex;
+    Status status;
+    const double samples = static_cast<double>(dft_length);
+    const TensorOpCost cost{samples * sizeof(U), samples * 2 * sizeof(T), 5.0 * samples * std::log2(samples)};
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(total_dfts - 1), cost,
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          InlinedVector<std::complex<T>> dft_temp_output;
+          for (std::ptrdiff_t i = begin; i < end; i++) {
+            Status dft_status = run_dft(static_cast<size_t>(i) + 1, dft_temp_output);
+            if (!dft_status.IsOK()) {
+              std::lock_guard<std::mutex> lock(status_mutex);
+              status = dft_status;
+              return;
+            }
+          }
+        });
+    ORT_RETURN_IF_ERROR(status);
   }
 
   return Status::OK();
@@ -534,23 +639,50 @@ static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_oneside
   InlinedVector<std::complex<T>> temp_output;
 
   // Run each dft of each batch as if it was a real-valued batch size 1 dft operation
-  for (int64_t batch_idx = 0; batch_idx < batch_size; batch_idx++) {
-    for (int64_t i = 0; i < n_dfts; i++) {
-      auto input_frame_begin =
-          signal_data + (batch_idx * signal_size * signal_components) + (i * frame_step * signal_components);
+  auto run_frame_dft = [&](int64_t frame, InlinedVector<std::complex<T>>& dft_temp_output) -> Status {
+    const int64_t batch_idx = frame / n_dfts;
+    const int64_t i = frame % n_dfts;
+    auto input_frame_begin =
+        signal_data + (batch_idx * signal_size * signal_components) + (i * frame_step * signal_components);
 
-      auto output_frame_begin = Y_data + (batch_idx * n_dfts * dft_output_size * output_components) +
-                                (i * dft_output_size * output_components);
+    auto output_frame_begin = Y_data + (batch_idx * n_dfts * dft_output_size * output_components) +
+                              (i * dft_output_size * output_components);
 
-      // Tensors do not own the backing memory, so no worries on destruction
-      auto input = onnxruntime::Tensor(signal->DataType(), dft_input_shape, input_frame_begin, signal->Location(), 0);
+    // Tensors do not own the backing memory, so no worries on destruction
+    auto input = onnxruntime::Tensor(signal->DataType(), dft_input_shape, input_frame_begin, signal->Location(), 0);
 
-      auto output = onnxruntime::Tensor(Y->DataType(), dft_output_shape, output_frame_begin, Y->Location(), 0);
+    auto output = onnxruntime::Tensor(Y->DataType(), dft_output_shape, output_frame_begin, Y->Location(), 0);
 
-      // Run individual dft
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<T, U>(ctx, &input, &output, b_fft, chirp, 1, window_size, window, is_onesided,
-                                                            false, V, temp_output)));
-    }
+    // Run individual dft
+    return discrete_fourier_transform<T, U>(ctx, &input, &output, b_fft, chirp, 1, window_size, window, is_onesided,
+                                            false, V, dft_temp_output);
+  };
+
+  // The first frame creates the twiddle factors and the chirp shared by all frames, the others run in parallel.
+  const int64_t total_frames = batch_size * n_dfts;
+  if (total_frames > 0) {
+    ORT_RETURN_IF_ERROR(run_frame_dft(0, temp_output));
+  }
+  if (total_frames > 1) {
+    std::mutex status_mutex;
+    Status status;
+    const double samples = static_cast<double>(window_size);
+    const TensorOpCost cost{samples * sizeof(U), static_cast<double>(dft_output_size) * 2 * sizeof(T),
+                            5.0 * samples * std::log2(samples)};
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(total_frames - 1), cost,
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          InlinedVector<std::complex<T>> dft_temp_output;
+          for (std::ptrdiff_t frame = begin; frame < end; frame++) {
+            Status frame_status = run_frame_dft(static_cast<int64_t>(frame) + 1, dft_temp_output);
+            if (!frame_status.IsOK()) {
+              std::lock_guard<std::mutex> lock(status_mutex);
+              status = frame_status;
+              return;
+            }
+          }
+        });
+    ORT_RETURN_IF_ERROR(status);
   }
 
   return Status::OK();
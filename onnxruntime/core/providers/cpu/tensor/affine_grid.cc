@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
+#include <algorithm>
 #include <iostream>
 #include "Eigen/src/Core/Map.h"
 #include <Eigen/Dense>
@@ -70,22 +71,28 @@ void generate_base_grid_3d(int64_t D, int64_t H, int64_t W, bool align_corners,
   }
 }
 
+// Generates the grid points [first_point, first_point + num_points) of a batch.
 template <typename T>
-void affine_grid_generator_2d(const Tensor* theta, const Eigen::Matrix<T, 2, Eigen::Dynamic>& base_grid_transposed, int64_t batch_num, int64_t H, int64_t W, Tensor* grid) {
+void affine_grid_generator_2d(const Tensor* theta, const Eigen::Matrix<T, 2, Eigen::Dynamic>& base_grid_transposed, int64_t batch_num, int64_t H, int64_t W,
+                              int64_t first_point, int64_t num_points, Tensor* grid) {
   const Eigen::StorageOptions option = Eigen::RowMajor;
   auto theta_batch_offset = batch_num * 2 * 3;
   const T* theta_data = theta->Data<T>() + theta_batch_offset;
   const Eigen::Matrix<T, 2, 2, option> theta_R{{theta_data[0], theta_data[1]}, {theta_data[3], theta_data[4]}};
   const Eigen::Array<T, 2, 1> theta_T(theta_data[2], theta_data[5]);
 
-  auto grid_batch_offset = batch_num * H * W * 2;
-  T* grid_data = grid->MutableData<T>() + grid_batch_offset;
-  Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 2, option>> grid_matrix(grid_data, narrow<size_t>(H * W), 2);
-  grid_matrix = ((theta_R * base_grid_transposed).array().colwise() + theta_T).matrix().transpose();
+  auto grid_offset = (batch_num * H * W + first_point) * 2;
+  T* grid_data = grid->MutableData<T>() + grid_offset;
+  Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 2, option>> grid_matrix(grid_data, narrow<size_t>(num_points), 2);
+  const auto base_points = base_grid_transposed.middleCols(static_cast<Eigen::Index>(first_point),
+                                                          static_cast<Eigen::Index>(num_points));
+  grid_matrix = ((theta_R * base_points).array().colwise() + theta_T).matrix().transpose();
 }
 
+// Generates the grid points [first_point, first_point + num_points) of a batch.
 template <typename T>
-void affine_grid_generator_3d(const Tensor* theta, const Eigen::Matrix<T, 3, Eigen::Dynamic>& base_grid_transposed, int64_t batch_num, int64_t D, int64_t H, int64_t W, Tensor* grid) {
+void affine_grid_generator_3d(const Tensor* theta, const Eigen::Matrix<T, 3, Eigen::Dynamic>& base_grid_transposed, int64_t batch_num, int64_t D, int64_t H, int64_t W,
+                              int64_t first_point, int64_t num_points, Tensor* grid) {
   const Eigen::StorageOptions option = Eigen::RowMajor;
   auto theta_batch_offset = batch_num * 3 * 4;
   const T* theta_data = theta->Data<T>() + theta_batch_offset;
@@ -95,10 +102,38 @@ void affine_grid_generator_3d(const Tensor* theta, const Eigen::Matrix<T, 3, Eig
       {theta_data[8], theta_data[9], theta_data[10]}};
   const Eigen::Array<T, 3, 1> theta_T(theta_data[3], theta_data[7], theta_data[11]);
 
-  auto grid_batch_offset = batch_num * D * H * W * 3;
-  T* grid_data = grid->MutableData<T>() + grid_batch_offset;
-  Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 3, option>> grid_matrix(grid_data, narrow<size_t>(D * H * W), 3);
-  grid_matrix = ((theta_R * base_grid_transposed).array().colwise() + theta_T).matrix().transpose();
+  auto grid_offset = (batch_num * D * H * W + first_point) * 3;
+  T* grid_data = grid->MutableData<T>() + grid_offset;
+  Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 3, option>> grid_matrix(grid_data, narrow<size_t>(num_points), 3);
+  const auto base_points = base_grid_transposed.middleCols(static_cast<Eigen::Index>(first_point),
+                                                          static_cast<Eigen::Index>(num_points));
+  grid_matrix = ((theta_R * base_points).array().colwise() + theta_T).matrix().transpose();
+}
+
+// Generates the grid points of all the batches, parallelized over the points rather than only over the batches.
+// generator(batch_num, first_point, num_points) generates a range of points of a batch.
+template <typename Generator>
+void ParallelizeOverGridPoints(concurrency::ThreadPool* tp, int64_t N, int64_t num_points, int64_t point_size,
+                               const Generator& generator) {
+  if (N * num_points == 0) {
+    return;
+  }
+
+  const TensorOpCost cost{static_cast<double>(point_size * sizeof(float)),
+                          static_cast<double>(point_size * sizeof(float)),
+                          static_cast<double>(point_size * point_size * 2)};
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(N * num_points), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // a range may span several batches
+        for (int64_t i = first; i < last;) {
+          const int64_t batch_num = i / num_points;
+          const int64_t first_point = i % num_points;
+          const int64_t count = std::min<int64_t>(last - i, num_points - first_point);
+          generator(batch_num, first_point, count);
+          i += count;
+        }
+      });
 }
 
 template <typename T>
@@ -123,11 +158,11 @@ Status AffineGrid<T>::Compute(OpKernelContext* context) const {
     generate_base_grid_2d(H, W, align_corners_, base_grid);
     Eigen::Matrix<T, 2, Eigen::Dynamic> base_grid_transposed = base_grid.transpose();
 
-    std::function<void(ptrdiff_t)> fn = [theta, base_grid_transposed, H, W, grid](ptrdiff_t batch_num) {
-      affine_grid_generator_2d(theta, base_grid_transposed, batch_num, H, W, grid);
-    };
-
-    concurrency::ThreadPool::TryBatchParallelFor(context->GetOperatorThreadPool(), narrow<size_t>(N), std::move(fn), 0);
+    ParallelizeOverGridPoints(context->GetOperatorThreadPool(), N, H * W, 2,
+                              [&](int64_t batch_num, int64_t first_point, int64_t num_points) {
+                                affine_grid_generator_2d(theta, base_grid_transposed, batch_num, H, W,
+                                                         first_point, num_points, grid);
+                              });
   } else if (size_shape.GetDims()[0] == 5 /*&& get_check_2d_grid_sample_consistency(theta_shape, size_shape, N, C, H, W)*/) {
     int64_t N = size_data[0], D = size_data[2], H = size_data[3], W = size_data[4];
 
@@ -138,11 +173,11 @@ Status AffineGrid<T>::Compute(OpKernelContext* context) const {
     generate_base_grid_3d(D, H, W, align_corners_, base_grid);
     Eigen::Matrix<T, 3, Eigen::Dynamic> base_grid_transposed = base_grid.transpose();
 
-    std::function<void(ptrdiff_t)> fn = [theta, base_grid_transposed, D, H, W, grid](ptrdiff_t batch_num) {
-      affine_grid_generator_3d(theta, base_grid_transposed, batch_num, D, H, W, grid);
-    };
-
-    concurrency::ThreadPool::TryBatchParallelFor(context->GetOperatorThreadPool(), narrow<size_t>(N), std::move(fn), 0);
+    ParallelizeOverGridPoints(context->GetOperatorThreadPool(), N, D * H * W, 3,
+                              [&](int64_t batch_num, int64_t first_point, int64_t num_points) {
+                                affine_grid_generator_3d(theta, base_grid_transposed, batch_num, D, H, W,
+                                                         first_point, num_points, grid);
+                              });
   } else {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "AffineGrid : Invalidate size - length of size should be 4 or 5.");
   }
@@ -15,6 +15,8 @@
 #include "core/framework/data_types.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
@@ -22,10 +24,6 @@
 #include "Eigen/src/Core/arch/Default/BFloat16.h"
 #include "Eigen/src/Core/arch/Default/Half.h"
 
-#if defined(_M_AMD64) && !defined(_M_ARM64EC)
-#include "core/mlas/inc/mlas.h"
-#endif
-
 namespace onnxruntime {
 
 namespace op_kernel_type_control {
@@ -178,19 +176,32 @@ template <>
 struct EigenCastType<BFloat16> {
   using type = Eigen::bfloat16;
 };
+
+// Converts the elements of a tensor in blocks on the intra-op thread pool of the kernel.
+// convert(first, last) converts the elements in [first, last). The output may alias the input.
+template <typename SrcType, typename DstType, typename Converter>
+void ParallelCast(const OpKernelContext& context, std::ptrdiff_t shape_size, const Converter& convert) {
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), shape_size,
+      TensorOpCost{static_cast<double>(sizeof(SrcType)), static_cast<double>(sizeof(DstType)), 1.0},
+      convert);
+}
+
 // generic tensor X -> Y
 template <typename SrcType, typename DstType, typename Enable = void>
 struct TensorCaster {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     using SrcEigenCastType = typename EigenCastType<SrcType>::type;
     using DstEigenCastType = typename EigenCastType<DstType>::type;
 
     const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
-    const auto in_vector =
-        ConstEigenVectorMap<SrcEigenCastType>(reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>()), shape_size);
-    auto out_vector =
-        EigenVectorMap<DstEigenCastType>(reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>()), shape_size);
-    out_vector = in_vector.template cast<DstEigenCastType>();
+    const auto* in_data = reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>());
+    auto* out_data = reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>());
+    ParallelCast<SrcType, DstType>(context, shape_size, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      const auto in_vector = ConstEigenVectorMap<SrcEigenCastType>(in_data + first, last - first);
+      auto out_vector = EigenVectorMap<DstEigenCastType>(out_data + first, last - first);
+      out_vector = in_vector.template cast<DstEigenCastType>();
+    });
   }
 };
 
@@ -252,18 +263,66 @@ struct TensorCasterNoSat<std::string, DstType> {
 
 #endif
 
-#if defined(_M_AMD64) && !defined(_M_ARM64EC)
-// specializations to use optimized and Windows x64-specific
-// MlasConvertHalfToFloatBuffer() routine for MLFloat16 -> float conversion
+// tensor float -> MLFloat16, with the vector conversion instructions of the platform when available
+template <>
+struct TensorCaster<float, MLFloat16> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    const auto* in_data = in.Data<float>();
+    auto* out_data = reinterpret_cast<MLAS_FP16*>(out.MutableData<MLFloat16>());
+    ParallelCast<float, MLFloat16>(context, narrow<std::ptrdiff_t>(shape.Size()),
+                                   [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                     MlasConvertFloatToHalfBuffer(in_data + first, out_data + first,
+                                                                  static_cast<size_t>(last - first));
+                                   });
+  }
+};
 
-// tensor MLFloat16 -> float
+// tensor MLFloat16 -> float, with the vector conversion instructions of the platform when available
 template <>
 struct TensorCaster<MLFloat16, float> {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
-    auto out_data = out.MutableData<float>();
-    auto in_data = in.Data<MLFloat16>();
-    const size_t shape_size = narrow<size_t>(shape.Size());
-    MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    const auto* in_data = reinterpret_cast<const MLAS_FP16*>(in.Data<MLFloat16>());
+    auto* out_data = out.MutableData<float>();
+    ParallelCast<MLFloat16, float>(context, narrow<std::ptrdiff_t>(shape.Size()),
+                                   [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                     MlasConvertFp16ToFloatBuffer(in_data + first, out_data + first,
+                                                                  static_cast<size_t>(last - first));
+                                   });
+  }
+};
+
+// tensor float -> BFloat16, rounding to the nearest even value as Eigen::bfloat16 does. The loop has no branches
+// so that it vectorizes.
+template <>
+struct TensorCaster<float, BFloat16> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    const auto* in_data = reinterpret_cast<const uint32_t*>(in.Data<float>());
+    auto* out_data = reinterpret_cast<uint16_t*>(out.MutableData<BFloat16>());
+    ParallelCast<float, BFloat16>(context, narrow<std::ptrdiff_t>(shape.Size()),
+                                  [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                    for (std::ptrdiff_t i = first; i < last; ++i) {
+                                      const uint32_t bits = in_data[i];
+                                      const uint32_t rounded = (bits + UINT32_C(0x7FFF) + ((bits >> 16) & 1)) >> 16;
+                                      const uint32_t nan = ((bits >> 16) & UINT32_C(0x8000)) | UINT32_C(0x7FC0);
+                                      const bool is_nan = (bits & UINT32_C(0x7FFFFFFF)) > UINT32_C(0x7F800000);
+                                      out_data[i] = static_cast<uint16_t>(is_nan ? nan : rounded);
+                                    }
+                                  });
+  }
+};
+
+// tensor BFloat16 -> float
+template <>
+struct TensorCaster<BFloat16, float> {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+    const auto* in_data = reinterpret_cast<const uint16_t*>(in.Data<BFloat16>());
+    auto* out_data = reinterpret_cast<uint32_t*>(out.MutableData<float>());
+    ParallelCast<BFloat16, float>(context, narrow<std::ptrdiff_t>(shape.Size()),
+                                  [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                    for (std::ptrdiff_t i = first; i < last; ++i) {
+                                      out_data[i] = static_cast<uint32_t>(in_data[i]) << 16;
+                                    }
+                                  });
   }
 };
 
@@ -299,7 +358,6 @@ struct TensorCaster<MLFloat16, std::string> {
     CastMLFloat16ThroughFloatTensor<std::string>(context, shape, in, out);
   }
 };
-#endif
 
 class Cast final : public OpKernel {
  public:
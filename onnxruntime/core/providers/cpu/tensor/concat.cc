@@ -263,16 +263,23 @@ Status ConcatBase::ComputeImpl(Prepare& p, OpKernelContext* ctx) const {
     if (prep.num_elements == 0)
       continue;
 
+    // the allocation planner may have had the producer of the input write it in place in the output
+    const bool is_in_place = !is_stack_ && !p.is_string_type &&
+                             prep.tensor->DataRaw() == static_cast<const char*>(p.output_tensor->DataRaw()) +
+                                                           initial_output_offset * p.output_tensor->DataType()->Size();
+
     // parallel copy the data across
-    auto status = DispatchStridedCopy<EnabledDataTypes>(ctx->GetOperatorThreadPool(),
-                                                        *p.output_tensor,
-                                                        onnxruntime::narrow<ptrdiff_t>(initial_output_offset),
-                                                        output_strides_for_copy,
-                                                        prep.tensor->Shape(),
-                                                        *prep.tensor,
-                                                        0,  // src_offset
-                                                        StridesForTensor(*prep.tensor));
-    ORT_RETURN_IF_ERROR(status);
+    if (!is_in_place) {
+      auto status = DispatchStridedCopy<EnabledDataTypes>(ctx->GetOperatorThreadPool(),
+                                                          *p.output_tensor,
+                                                          onnxruntime::narrow<ptrdiff_t>(initial_output_offset),
+                                                          output_strides_for_copy,
+                                                          prep.tensor->Shape(),
+                                                          *prep.tensor,
+                                                          0,  // src_offset
+                                                          StridesForTensor(*prep.tensor));
+      ORT_RETURN_IF_ERROR(status);
+    }
 
     // advance along the axis that we are concatenating on (by the size of the axis of the tensor that we just copied)
     if (is_stack_) {
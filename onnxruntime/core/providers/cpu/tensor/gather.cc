@@ -3,6 +3,10 @@
 
 // https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
+
+#include <algorithm>
+#include <functional>
+
 #include "core/common/common.h"
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
@@ -83,6 +87,51 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   return Status::OK();
 }
 
+namespace {
+
+// Rows of an embedding table are usually read at random, so the row of an index a few iterations ahead is
+// prefetched while the current one is copied.
+constexpr int64_t kGatherPrefetchDistance = 8;
+constexpr int64_t kGatherPrefetchMinBytes = 64;
+constexpr int64_t kGatherPrefetchMaxBytes = 1024;
+
+inline void GatherPrefetch(const uint8_t* address, int64_t bytes) {
+#if defined(__GNUC__) || defined(__clang__)
+  for (int64_t offset = 0; offset < std::min(bytes, kGatherPrefetchMaxBytes); offset += 64) {
+    __builtin_prefetch(address + offset);
+  }
+#else
+  ORT_UNUSED_PARAMETER(address);
+  ORT_UNUSED_PARAMETER(bytes);
+#endif
+}
+
+// Gathers single elements, i.e. the gathered axis is the innermost one. The typed loop lets the compiler use
+// gather instructions when the target supports them instead of calling memcpy per element.
+template <typename T, typename Tin>
+void GatherElements(const Tin* indices_data, const uint8_t* src_base, uint8_t* dst_base,
+                    const int64_t N, const int64_t axis_dim_limit, ptrdiff_t first, ptrdiff_t last) {
+  const T* src = reinterpret_cast<const T*>(src_base);
+  T* dst = reinterpret_cast<T*>(dst_base);
+  int64_t batch = first / N;
+  int64_t i = first % N;
+  for (ptrdiff_t index = first; index < last;) {
+    const T* src_batch = src + batch * axis_dim_limit;
+    T* dst_batch = dst + batch * N;
+    const int64_t end = std::min<int64_t>(N, i + (last - index));
+    for (int64_t j = i; j < end; ++j) {
+      int64_t idx = static_cast<int64_t>(indices_data[j]);
+      idx = idx < 0 ? idx + axis_dim_limit : idx;
+      dst_batch[j] = src_batch[idx];
+    }
+    index += onnxruntime::narrow<ptrdiff_t>(end - i);
+    i = 0;
+    ++batch;
+  }
+}
+
+}  // namespace
+
 template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
                       const size_t element_bytes, const int64_t block_size, const int64_t M,
@@ -102,30 +151,84 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-  auto lambda = [&](int64_t index) {
-    int64_t batch = index / N;
-    int64_t i = index % N;
+  const TensorOpCost cost{static_cast<double>(block_size), static_cast<double>(block_size), 1.0};
 
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
-    idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
+  if (is_string_type) {
+    auto lambda = [&](int64_t index) {
+      int64_t batch = index / N;
+      int64_t i = index % N;
+
+      const int64_t src_offset_batch = batch * data_batch_bytes;
+      const int64_t dst_offset_batch = batch * gathered_batch_bytes;
+      Tin idx = indices_data[i];
+      idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
+      const int64_t src_offset = src_offset_batch + idx * block_size;
+      const int64_t dst_offset = dst_offset_batch + i * block_size;
 
-    if (is_string_type) {
       reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
           reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
-    } else {
-      memcpy(dst_base + dst_offset, src_base + src_offset, narrow<size_t>(block_size));
+    };
+    concurrency::ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(M) * N, cost,
+                                            [&lambda](ptrdiff_t first, ptrdiff_t last) {
+                                              for (ptrdiff_t index = first; index < last; ++index) {
+                                                lambda(index);
+                                              }
+                                            });
+    return Status::OK();
+  }
+
+  if (block_size == static_cast<int64_t>(element_bytes)) {
+    std::function<void(ptrdiff_t, ptrdiff_t)> fn;
+    switch (element_bytes) {
+      case sizeof(uint8_t):
+        fn = [&](ptrdiff_t first, ptrdiff_t last) {
+          GatherElements<uint8_t>(indices_data, src_base, dst_base, N, axis_dim_limit, first, last);
+        };
+        break;
+      case sizeof(uint16_t):
+        fn = [&](ptrdiff_t first, ptrdiff_t last) {
+          GatherElements<uint16_t>(indices_data, src_base, dst_base, N, axis_dim_limit, first, last);
+        };
+        break;
+      case sizeof(uint32_t):
+        fn = [&](ptrdiff_t first, ptrdiff_t last) {
+          GatherElements<uint32_t>(indices_data, src_base, dst_base, N, axis_dim_limit, first, last);
+        };
+        break;
+      case sizeof(uint64_t):
+        fn = [&](ptrdiff_t first, ptrdiff_t last) {
+          GatherElements<uint64_t>(indices_data, src_base, dst_base, N, axis_dim_limit, first, last);
+        };
+        break;
+      default:
+        break;
+    }
+    if (fn) {
+      concurrency::ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(M) * N, cost, fn);
+      return Status::OK();
     }
-  };
-  concurrency::ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(M) * N, static_cast<double>(block_size),
-                                          [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int index = static_cast<int>(first), end = static_cast<int>(last); index < end; ++index) {
-                                              lambda(index);
-                                            }
-                                          });
+  }
+
+  const bool prefetch = block_size >= kGatherPrefetchMinBytes;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, SafeInt<ptrdiff_t>(M) * N, cost,
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t index = first; index < last; ++index) {
+          const int64_t batch = index / N;
+          const int64_t i = index % N;
+
+          if (prefetch && i + kGatherPrefetchDistance < N && index + kGatherPrefetchDistance < last) {
+            Tin next_idx = indices_data[i + kGatherPrefetchDistance];
+            next_idx = next_idx < 0 ? next_idx + static_cast<Tin>(axis_dim_limit) : next_idx;
+            GatherPrefetch(src_base + batch * data_batch_bytes + next_idx * block_size, block_size);
+          }
+
+          Tin idx = indices_data[i];
+          idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
+          memcpy(dst_base + batch * gathered_batch_bytes + i * block_size,
+                 src_base + batch * data_batch_bytes + idx * block_size, narrow<size_t>(block_size));
+        }
+      });
 
   return Status::OK();
 }
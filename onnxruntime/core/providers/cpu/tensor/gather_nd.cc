@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 #include <core/common/safeint.h>
 #include "gather_nd.h"
+
+#include <algorithm>
+#include <functional>
+
 #include "core/platform/threadpool.h"
 
 namespace onnxruntime {
@@ -176,16 +180,78 @@ Status GatherND::Compute(OpKernelContext* context) const {
   return nullptr == p.input_str_base ? GatherNumber(p, tp) : GatherString(p, tp);
 }
 
+namespace {
+
+// Slices of a large table are usually read at random, so the slice a few iterations ahead is prefetched
+// while the current one is copied.
+constexpr ptrdiff_t kGatherNDPrefetchDistance = 8;
+constexpr uint64_t kGatherNDPrefetchMinBytes = 64;
+constexpr uint64_t kGatherNDPrefetchMaxBytes = 1024;
+
+inline void GatherNDPrefetch(const uint8_t* address, uint64_t bytes) {
+#if defined(__GNUC__) || defined(__clang__)
+  for (uint64_t offset = 0; offset < std::min(bytes, kGatherNDPrefetchMaxBytes); offset += 64) {
+    __builtin_prefetch(address + offset);
+  }
+#else
+  ORT_UNUSED_PARAMETER(address);
+  ORT_UNUSED_PARAMETER(bytes);
+#endif
+}
+
+// Slices of a single element: a typed loop instead of a memcpy call per element.
+template <typename T>
+void GatherNDElements(const GatherNDBase::Prepare& p, ptrdiff_t first, ptrdiff_t last) {
+  const T* src = reinterpret_cast<const T*>(p.input_base);
+  T* dst = reinterpret_cast<T*>(p.output_base);
+  const uint64_t* offsets = p.slice_offsets.data();
+  for (ptrdiff_t slice_idx = first; slice_idx < last; ++slice_idx) {
+    dst[slice_idx] = src[offsets[slice_idx]];
+  }
+}
+
+}  // namespace
+
 Status GatherND::GatherNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
-  auto lambda = [&](int64_t slice_idx) {
-    memcpy(p.output_base + slice_idx * p.bytes_per_slice, p.input_base + p.slice_offsets[onnxruntime::narrow<size_t>(slice_idx)] * p.element_bytes,
-           onnxruntime::narrow<size_t>(p.bytes_per_slice));
-  };
+  const TensorOpCost cost{static_cast<double>(p.bytes_per_slice), static_cast<double>(p.bytes_per_slice), 1.0};
+  const auto num_slices = onnxruntime::narrow<std::ptrdiff_t>(p.slice_offsets.size());
+
+  if (p.element_count_per_slice == 1) {
+    std::function<void(ptrdiff_t, ptrdiff_t)> fn;
+    switch (p.element_bytes) {
+      case sizeof(uint8_t):
+        fn = [&p](ptrdiff_t first, ptrdiff_t last) { GatherNDElements<uint8_t>(p, first, last); };
+        break;
+      case sizeof(uint16_t):
+        fn = [&p](ptrdiff_t first, ptrdiff_t last) { GatherNDElements<uint16_t>(p, first, last); };
+        break;
+      case sizeof(uint32_t):
+        fn = [&p](ptrdiff_t first, ptrdiff_t last) { GatherNDElements<uint32_t>(p, first, last); };
+        break;
+      case sizeof(uint64_t):
+        fn = [&p](ptrdiff_t first, ptrdiff_t last) { GatherNDElements<uint64_t>(p, first, last); };
+        break;
+      default:
+        break;
+    }
+    if (fn) {
+      concurrency::ThreadPool::TryParallelFor(tp, num_slices, cost, fn);
+      return Status::OK();
+    }
+  }
+
+  const bool prefetch = p.bytes_per_slice >= kGatherNDPrefetchMinBytes;
   concurrency::ThreadPool::TryParallelFor(
-      tp, p.slice_offsets.size(), static_cast<double>(p.bytes_per_slice),
-      [&lambda](ptrdiff_t first, ptrdiff_t last) {
-        for (int slice_idx = static_cast<int>(first), end = static_cast<int>(last); slice_idx < end; ++slice_idx) {
-          lambda(slice_idx);
+      tp, num_slices, cost,
+      [&p, prefetch](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t slice_idx = first; slice_idx < last; ++slice_idx) {
+          if (prefetch && slice_idx + kGatherNDPrefetchDistance < last) {
+            GatherNDPrefetch(p.input_base + p.slice_offsets[onnxruntime::narrow<size_t>(slice_idx + kGatherNDPrefetchDistance)] * p.element_bytes,
+                             p.bytes_per_slice);
+          }
+          memcpy(p.output_base + slice_idx * p.bytes_per_slice,
+                 p.input_base + p.slice_offsets[onnxruntime::narrow<size_t>(slice_idx)] * p.element_bytes,
+                 onnxruntime::narrow<size_t>(p.bytes_per_slice));
         }
       });
   return Status::OK();
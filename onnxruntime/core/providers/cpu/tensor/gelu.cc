@@ -3,6 +3,7 @@
 
 #include "core/common/common.h"
 #include "core/common/narrow.h"
+#include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 #include "core/mlas/inc/mlas.h"
@@ -19,12 +20,23 @@ namespace onnxruntime {
 
 // May revisit the implementations to support inplace computation, if needed.
 
+template <>
+Status Gelu<MLFloat16>::Compute(OpKernelContext* context) const;
+
 ONNX_CPU_OPERATOR_KERNEL(
     Gelu,
     20,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gelu<float>);
 
+// Registered only when MLAS converts half precision with vector instructions, see RegisterFp16ComputeKernels().
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Gelu,
+    20,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gelu<MLFloat16>);
+
 #ifndef DISABLE_CONTRIB_OPS
 namespace contrib {
 ONNX_OPERATOR_KERNEL_EX(
@@ -34,6 +46,15 @@ ONNX_OPERATOR_KERNEL_EX(
     kCpuExecutionProvider,
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Gelu<float>);
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    Gelu,
+    kMSDomain,
+    1,
+    MLFloat16,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    Gelu<MLFloat16>);
 }
 #endif
 
@@ -105,4 +126,71 @@ Status Gelu<T>::Compute(OpKernelContext* context) const {
   return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported approximation_algorithm: ", approximation_algorithm_);
 }
 
+// The half precision input is converted to float a chunk at a time by MLAS and computed by the float kernels
+// above, so there is no scalar conversion in the loops.
+template <>
+Status Gelu<MLFloat16>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const MLFloat16* input_data = input->Data<MLFloat16>();
+
+  Tensor* output = context->Output(0, input->Shape());
+  MLFloat16* output_data = output->MutableData<MLFloat16>();
+
+  const bool use_tanh = approximation_algorithm_ == "tanh";
+  if (!use_tanh && approximation_algorithm_ != "none") {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Unsupported approximation_algorithm: ",
+                           approximation_algorithm_);
+  }
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  int64_t elem_count = input->Shape().Size();
+  constexpr int64_t length_per_task = 4096;
+  int64_t task_count = (elem_count + length_per_task - 1) / length_per_task;
+
+  // Each task converts its chunk of the input into one half of the buffer and computes into the other half.
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  auto buffer = IAllocator::MakeUniquePtr<float>(alloc, SafeInt<size_t>(elem_count) * 2);
+  float* x_buffer = buffer.get();
+  float* y_buffer = x_buffer + elem_count;
+
+  concurrency::ThreadPool::TryBatchParallelFor(
+      tp, static_cast<int32_t>(task_count),
+      [&](ptrdiff_t task_idx) {
+        const auto start = task_idx * length_per_task;
+        const float* p_input = x_buffer + start;
+        float* p_output = y_buffer + start;
+        size_t count = narrow<size_t>(std::min(length_per_task, elem_count - start));
+
+        MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(input_data + start),
+                                     x_buffer + start, count);
+
+        if (use_tanh) {
+          static constexpr float B = 0.7978845608028654f;    // sqrt(2.0 / M_PI)
+          static constexpr float C = 0.035677408136300125f;  // 0.044715 * sqrt(2.0 / M_PI)
+
+          for (size_t i = 0; i < count; i++) {
+            float value = p_input[i];
+            p_output[i] = value * (C * value * value + B);
+          }
+
+          MlasComputeTanh(p_output, p_output, count);
+        } else {
+          for (size_t i = 0; i < count; i++) {
+            p_output[i] = p_input[i] * static_cast<float>(M_SQRT1_2);
+          }
+
+          MlasComputeErf(p_output, p_output, count);
+        }
+
+        for (size_t i = 0; i < count; i++) {
+          p_output[i] = 0.5f * p_input[i] * (p_output[i] + 1.0f);
+        }
+
+        MlasConvertFloatToHalfBuffer(p_output, output_data + start, count);
+      },
+      0);
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
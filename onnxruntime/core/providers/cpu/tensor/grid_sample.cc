@@ -102,44 +102,18 @@ T GsBicubicInterpolate(T p[4][4], T x, T y) {
   return static_cast<T>(coeffs[0] * v[0] + coeffs[1] * v[1] + coeffs[2] * v[2] + coeffs[3] * v[3]);
 }
 
+// The offset of the coordinate i along a dimension of the image after padding, i.e. the padded coordinate times the
+// stride of the dimension, or -1 for zeros padding when i is out of the image. The padding of a pixel is applied to
+// each of its coordinates independently, so the offsets along each dimension are enough to gather the pixel.
 template <typename T>
-T GridSample<T>::PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const {
-  T pixel = {};  // default 0
+int64_t GridSample<T>::PaddedOffset(int64_t i, int64_t length, int64_t stride, T border_min, T border_max) const {
   if (padding_mode_ == Zeros) {
-    if (c >= 0 && c < W && r >= 0 && r < H) {
-      pixel = image[r * W + c];
-    }
-  } else if (padding_mode_ == Border) {
-    c = std::clamp<int64_t>(c, 0, W - 1);
-    r = std::clamp<int64_t>(r, 0, H - 1);
-    pixel = image[r * W + c];
-  } else {  // (padding_mode_ == Reflection)
-    c = static_cast<int64_t>(GsReflect(static_cast<T>(c), border[0], border[2]));
-    r = static_cast<int64_t>(GsReflect(static_cast<T>(r), border[1], border[3]));
-    pixel = image[r * W + c];
+    return i >= 0 && i < length ? i * stride : -1;
   }
-  return pixel;
-}
-
-template <typename T>
-T GridSample<T>::PixelAtGrid3D(const T* image, int64_t d, int64_t h, int64_t w, int64_t D, int64_t H, int64_t W, T border[/* 6 */]) const {
-  T pixel = {};  // default 0
-  if (padding_mode_ == Zeros) {
-    if (w >= 0 && w < W && h >= 0 && h < H && d >= 0 && d < D) {
-      pixel = image[d * H * W + h * W + w];
-    }
-  } else if (padding_mode_ == Border) {
-    w = std::clamp<int64_t>(w, 0, W - 1);
-    h = std::clamp<int64_t>(h, 0, H - 1);
-    d = std::clamp<int64_t>(d, 0, D - 1);
-    pixel = image[d * H * W + h * W + w];
-  } else {  // (padding_mode_ == Reflection)
-    w = static_cast<int64_t>(GsReflect(static_cast<T>(w), border[0], border[3]));
-    h = static_cast<int64_t>(GsReflect(static_cast<T>(h), border[1], border[4]));
-    d = static_cast<int64_t>(GsReflect(static_cast<T>(d), border[2], border[5]));
-    pixel = image[d * H * W + h * W + w];
+  if (padding_mode_ == Border) {
+    return std::clamp<int64_t>(i, 0, length - 1) * stride;
   }
-  return pixel;
+  return static_cast<int64_t>(GsReflect(static_cast<T>(i), border_min, border_max)) * stride;
 }
 
 // When grid sampling, padding is applied before interpolation.
@@ -203,58 +177,98 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
     }
     T border[] = {x_min, y_min, x_max, y_max};  // l-t-r-b
 
-    concurrency::ThreadPool* tp = H_out * W_out > 64 ? context->GetOperatorThreadPool() : nullptr;
+    // The offsets of the rows and columns of the pixels interpolated for an output point, and the weights of the
+    // interpolation, are the same for all the channels. They are computed once per batch, and the channels only
+    // gather and interpolate the pixels.
+    const int64_t taps = mode_ == Nearest ? 1 : (mode_ == Linear ? 2 : 4);
+    const int64_t num_weights = mode_ == Nearest ? 0 : (mode_ == Linear ? 4 : 2);
+    const int64_t num_points = H_out * W_out;
+    std::vector<int64_t> offsets(onnxruntime::narrow<size_t>(num_points * taps * 2));
+    std::vector<T> weights(onnxruntime::narrow<size_t>(num_points * num_weights));
+
+    concurrency::ThreadPool* tp = num_points > 64 ? context->GetOperatorThreadPool() : nullptr;
+    const TensorOpCost point_cost{2.0 * sizeof(T), static_cast<double>(taps * 2 * sizeof(int64_t)), 40.0};
+    const TensorOpCost row_cost{static_cast<double>(W_out * taps * taps * sizeof(T)),
+                                static_cast<double>(W_out * sizeof(T)),
+                                static_cast<double>(W_out * taps * taps * 3)};
     for (int64_t n = 0; n < N; n++) {
-      const T* grid_data = grid->Data<T>() + n * (H_out * W_out) * 2;
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          tp, onnxruntime::narrow<std::ptrdiff_t>(C),
-          [&](std::ptrdiff_t c) {
-            const T* X_data = input->Data<T>() + (n * C + c) * (H_in * W_in);
-            T* Y_data = Y.MutableData<T>() + (n * C + c) * (H_out * W_out);
-
-            for (int64_t oy = 0; oy < H_out; oy++) {
+      const T* grid_data = grid->Data<T>() + n * num_points * 2;
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(num_points), point_cost,
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t point = first; point < last; point++) {
+              const T* gridpoint = grid_data + point * 2;
+              auto x = GsDenormalize<T>(gridpoint[0], W_in, align_corners_);  // actual location
+              auto y = GsDenormalize<T>(gridpoint[1], H_in, align_corners_);
+              int64_t* rows = offsets.data() + point * taps * 2;
+              int64_t* cols = rows + taps;
+              T* point_weights = weights.data() + point * num_weights;
+
+              int64_t x0 = 0;
+              int64_t y0 = 0;
+              if (mode_ == Nearest) {
+                // x, y are integers in all padding modes
+                x0 = static_cast<int64_t>(std::nearbyint(x));
+                y0 = static_cast<int64_t>(std::nearbyint(y));
+              } else if (mode_ == Linear) {
+                x0 = static_cast<int64_t>(std::floor(x));
+                y0 = static_cast<int64_t>(std::floor(y));
+                point_weights[0] = static_cast<T>(x0 + 1) - x;  // dx2
+                point_weights[1] = x - static_cast<T>(x0);      // dx1
+                point_weights[2] = static_cast<T>(y0 + 1) - y;  // dy2
+                point_weights[3] = y - static_cast<T>(y0);      // dy1
+              } else {
+                x0 = static_cast<int64_t>(std::floor(x)) - 1;  // top-left corner of the bbox
+                y0 = static_cast<int64_t>(std::floor(y)) - 1;
+                point_weights[0] = static_cast<T>(x - x0 - 1);
+                point_weights[1] = static_cast<T>(y - y0 - 1);
+              }
+
+              for (int64_t t = 0; t < taps; t++) {
+                rows[t] = PaddedOffset(y0 + t, H_in, W_in, border[1], border[3]);
+                cols[t] = PaddedOffset(x0 + t, W_in, 1, border[0], border[2]);
+              }
+            }
+          });
+
+      // parallelized over the rows of all the channels, as the number of channels is often small
+      const T* X_batch = input->Data<T>() + n * C * (H_in * W_in);
+      T* Y_batch = Y.MutableData<T>() + n * C * num_points;
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(C * H_out), row_cost,
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t channel_row = first; channel_row < last; channel_row++) {
+              const int64_t c = channel_row / H_out;
+              const int64_t oy = channel_row % H_out;
+              const T* X_data = X_batch + c * (H_in * W_in);
+              T* Y_row = Y_batch + c * num_points + oy * W_out;
+              const int64_t* row_offsets = offsets.data() + oy * W_out * taps * 2;
+              const T* row_weights = weights.data() + oy * W_out * num_weights;
+
               for (int64_t ox = 0; ox < W_out; ox++) {
-                const T* gridpoint = grid_data + (oy * W_out + ox) * 2;
-                T* Y_gridpoint = Y_data + oy * W_out + ox;
-                auto nx = gridpoint[0];  // normalized location
-                auto ny = gridpoint[1];
-                auto x = GsDenormalize<T>(nx, W_in, align_corners_);  // actual location
-                auto y = GsDenormalize<T>(ny, H_in, align_corners_);
+                const int64_t* rows = row_offsets + ox * taps * 2;
+                const int64_t* cols = rows + taps;
+                const T* point_weights = row_weights + ox * num_weights;
+                const auto pixel = [X_data, rows, cols](int64_t h, int64_t w) {
+                  return rows[h] >= 0 && cols[w] >= 0 ? X_data[rows[h] + cols[w]] : T{};
+                };
 
                 if (mode_ == Nearest) {
-                  x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
-                  y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
-                  // x, y are integers in all padding modes
-                  *Y_gridpoint = PixelAtGrid(X_data, static_cast<int64_t>(y), static_cast<int64_t>(x), H_in, W_in, border);
+                  Y_row[ox] = pixel(0, 0);
                 } else if (mode_ == Linear) {
-                  int64_t x1 = static_cast<int64_t>(std::floor(x));
-                  int64_t y1 = static_cast<int64_t>(std::floor(y));
-                  int64_t x2 = x1 + 1;
-                  int64_t y2 = y1 + 1;
-
-                  T p11 = PixelAtGrid(X_data, y1, x1, H_in, W_in, border);
-                  T p12 = PixelAtGrid(X_data, y1, x2, H_in, W_in, border);
-                  T p21 = PixelAtGrid(X_data, y2, x1, H_in, W_in, border);
-                  T p22 = PixelAtGrid(X_data, y2, x2, H_in, W_in, border);
-
-                  T dx2 = static_cast<T>(x2) - x;
-                  T dx1 = x - static_cast<T>(x1);
-                  T dy2 = static_cast<T>(y2) - y;
-                  T dy1 = y - static_cast<T>(y1);
-                  *Y_gridpoint = dy2 * (dx2 * p11 + dx1 * p12) + dy1 * (dx2 * p21 + dx1 * p22);
-                } else if (mode_ == Cubic) {
-                  int64_t x0 = static_cast<int64_t>(std::floor(x)) - 1;  // top-left corner of the bbox
-                  int64_t y0 = static_cast<int64_t>(std::floor(y)) - 1;
-
+                  const T dx2 = point_weights[0];
+                  const T dx1 = point_weights[1];
+                  const T dy2 = point_weights[2];
+                  const T dy1 = point_weights[3];
+                  Y_row[ox] = dy2 * (dx2 * pixel(0, 0) + dx1 * pixel(0, 1)) + dy1 * (dx2 * pixel(1, 0) + dx1 * pixel(1, 1));
+                } else {
                   T p[4][4] = {};  // [H][W]
                   for (int64_t h = 0; h < 4; h++) {
                     for (int64_t w = 0; w < 4; w++) {
-                      p[h][w] = PixelAtGrid(X_data, h + y0, w + x0, H_in, W_in, border);
+                      p[h][w] = pixel(h, w);
                     }
                   }
-                  T dx = static_cast<T>(x - x0 - 1);
-                  T dy = static_cast<T>(y - y0 - 1);
-                  *Y_gridpoint = GsBicubicInterpolate(p, dx, dy);
+                  Y_row[ox] = GsBicubicInterpolate(p, point_weights[0], point_weights[1]);
                 }
               }
             }
@@ -292,63 +306,98 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
     }
     T border[] = {x_min, y_min, z_min, x_max, y_max, z_max};
 
-    concurrency::ThreadPool* tp = D_out * H_out * W_out > 64 ? context->GetOperatorThreadPool() : nullptr;
+    // As in 2D, the offsets along each dimension and the weights are computed once per batch for all the channels.
+    const int64_t taps = mode_ == Nearest ? 1 : 2;
+    const int64_t num_weights = mode_ == Nearest ? 0 : 6;
+    const int64_t num_points = D_out * H_out * W_out;
+    std::vector<int64_t> offsets(onnxruntime::narrow<size_t>(num_points * taps * 3));
+    std::vector<T> weights(onnxruntime::narrow<size_t>(num_points * num_weights));
+
+    concurrency::ThreadPool* tp = num_points > 64 ? context->GetOperatorThreadPool() : nullptr;
+    const TensorOpCost point_cost{3.0 * sizeof(T), static_cast<double>(taps * 3 * sizeof(int64_t)), 60.0};
+    const TensorOpCost row_cost{static_cast<double>(W_out * taps * taps * taps * sizeof(T)),
+                                static_cast<double>(W_out * sizeof(T)),
+                                static_cast<double>(W_out * taps * taps * taps * 3)};
     for (int64_t n = 0; n < N; n++) {
-      const T* grid_data = grid->Data<T>() + n * (D_out * H_out * W_out) * 3;
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          tp, onnxruntime::narrow<std::ptrdiff_t>(C),
-          [&](std::ptrdiff_t c) {
-            const T* X_data = input->Data<T>() + (n * C + c) * (D_in * H_in * W_in);
-            T* Y_data = Y.MutableData<T>() + (n * C + c) * (D_out * H_out * W_out);
-
-            for (int64_t oz = 0; oz < D_out; oz++) {
-              for (int64_t oy = 0; oy < H_out; oy++) {
-                for (int64_t ox = 0; ox < W_out; ox++) {
-                  const T* gridpoint = grid_data + (oz * H_out * W_out + oy * W_out + ox) * 3;
-                  T* Y_gridpoint = Y_data + oz * H_out * W_out + oy * W_out + ox;
-                  auto nx = gridpoint[0];  // normalized location
-                  auto ny = gridpoint[1];
-                  auto nz = gridpoint[2];
-                  auto x = GsDenormalize<T>(nx, W_in, align_corners_);  // actual location
-                  auto y = GsDenormalize<T>(ny, H_in, align_corners_);
-                  auto z = GsDenormalize<T>(nz, D_in, align_corners_);
-
-                  if (mode_ == Nearest) {
-                    x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
-                    y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
-                    z = static_cast<T>(std::nearbyint(static_cast<T>(z)));
-
-                    // x, y are integers in all padding modes
-                    *Y_gridpoint = PixelAtGrid3D(X_data, static_cast<int64_t>(z), static_cast<int64_t>(y), static_cast<int64_t>(x),
-                                                 D_in, H_in, W_in, border);
-                  } else if (mode_ == Linear) {
-                    int64_t x1 = static_cast<int64_t>(std::floor(x));
-                    int64_t y1 = static_cast<int64_t>(std::floor(y));
-                    int64_t z1 = static_cast<int64_t>(std::floor(z));
-                    int64_t x2 = x1 + 1;
-                    int64_t y2 = y1 + 1;
-                    int64_t z2 = z1 + 1;
-
-                    T dx2 = static_cast<T>(x2) - x;
-                    T dx1 = x - static_cast<T>(x1);
-                    T dy2 = static_cast<T>(y2) - y;
-                    T dy1 = y - static_cast<T>(y1);
-                    T dz2 = static_cast<T>(z2) - z;
-                    T dz1 = z - static_cast<T>(z1);
-
-                    T p111 = PixelAtGrid3D(X_data, z1, y1, x1, D_in, H_in, W_in, border);
-                    T p112 = PixelAtGrid3D(X_data, z1, y1, x2, D_in, H_in, W_in, border);
-                    T p121 = PixelAtGrid3D(X_data, z1, y2, x1, D_in, H_in, W_in, border);
-                    T p122 = PixelAtGrid3D(X_data, z1, y2, x2, D_in, H_in, W_in, border);
-                    T Y_gridpoint_z1 = dy2 * (dx2 * p111 + dx1 * p112) + dy1 * (dx2 * p121 + dx1 * p122);
-
-                    T p211 = PixelAtGrid3D(X_data, z2, y1, x1, D_in, H_in, W_in, border);
-                    T p212 = PixelAtGrid3D(X_data, z2, y1, x2, D_in, H_in, W_in, border);
-                    T p221 = PixelAtGrid3D(X_data, z2, y2, x1, D_in, H_in, W_in, border);
-                    T p222 = PixelAtGrid3D(X_data, z2, y2, x2, D_in, H_in, W_in, border);
-                    T Y_gridpoint_z2 = dy2 * (dx2 * p211 + dx1 * p212) + dy1 * (dx2 * p221 + dx1 * p222);
-                    *Y_gridpoint = dz2 * Y_gridpoint_z1 + dz1 * Y_gridpoint_z2;
-                  }
+      const T* grid_data = grid->Data<T>() + n * num_points * 3;
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(num_points), point_cost,
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t point = first; point < last; point++) {
+              const T* gridpoint = grid_data + point * 3;
+              auto x = GsDenormalize<T>(gridpoint[0], W_in, align_corners_);  // actual location
+              auto y = GsDenormalize<T>(gridpoint[1], H_in, align_corners_);
+              auto z = GsDenormalize<T>(gridpoint[2], D_in, align_corners_);
+              int64_t* slices = offsets.data() + point * taps * 3;
+              int64_t* rows = slices + taps;
+              int64_t* cols = rows + taps;
+              T* point_weights = weights.data() + point * num_weights;
+
+              int64_t x1 = 0;
+              int64_t y1 = 0;
+              int64_t z1 = 0;
+              if (mode_ == Nearest) {
+                // x, y, z are integers in all padding modes
+                x1 = static_cast<int64_t>(std::nearbyint(x));
+                y1 = static_cast<int64_t>(std::nearbyint(y));
+                z1 = static_cast<int64_t>(std::nearbyint(z));
+              } else {
+                x1 = static_cast<int64_t>(std::floor(x));
+                y1 = static_cast<int64_t>(std::floor(y));
+                z1 = static_cast<int64_t>(std::floor(z));
+                point_weights[0] = static_cast<T>(x1 + 1) - x;  // dx2
+                point_weights[1] = x - static_cast<T>(x1);      // dx1
+                point_weights[2] = static_cast<T>(y1 + 1) - y;  // dy2
+                point_weights[3] = y - static_cast<T>(y1);      // dy1
+                point_weights[4] = static_cast<T>(z1 + 1) - z;  // dz2
+                point_weights[5] = z - static_cast<T>(z1);      // dz1
+              }
+
+              for (int64_t t = 0; t < taps; t++) {
+                slices[t] = PaddedOffset(z1 + t, D_in, H_in * W_in, border[2], border[5]);
+                rows[t] = PaddedOffset(y1 + t, H_in, W_in, border[1], border[4]);
+                cols[t] = PaddedOffset(x1 + t, W_in, 1, border[0], border[3]);
+              }
+            }
+          });
+
+      const T* X_batch = input->Data<T>() + n * C * (D_in * H_in * W_in);
+      T* Y_batch = Y.MutableData<T>() + n * C * num_points;
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(C * D_out * H_out), row_cost,
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t channel_row = first; channel_row < last; channel_row++) {
+              const int64_t c = channel_row / (D_out * H_out);
+              const int64_t row = channel_row % (D_out * H_out);
+              const T* X_data = X_batch + c * (D_in * H_in * W_in);
+              T* Y_row = Y_batch + c * num_points + row * W_out;
+              const int64_t* row_offsets = offsets.data() + row * W_out * taps * 3;
+              const T* row_weights = weights.data() + row * W_out * num_weights;
+
+              for (int64_t ox = 0; ox < W_out; ox++) {
+                const int64_t* slices = row_offsets + ox * taps * 3;
+                const int64_t* rows = slices + taps;
+                const int64_t* cols = rows + taps;
+                const T* point_weights = row_weights + ox * num_weights;
+                const auto pixel = [X_data, slices, rows, cols](int64_t d, int64_t h, int64_t w) {
+                  return slices[d] >= 0 && rows[h] >= 0 && cols[w] >= 0 ? X_data[slices[d] + rows[h] + cols[w]]
+                                                                        : T{};
+                };
+
+                if (mode_ == Nearest) {
+                  Y_row[ox] = pixel(0, 0, 0);
+                } else {
+                  const T dx2 = point_weights[0];
+                  const T dx1 = point_weights[1];
+                  const T dy2 = point_weights[2];
+                  const T dy1 = point_weights[3];
+                  const T dz2 = point_weights[4];
+                  const T dz1 = point_weights[5];
+                  T Y_gridpoint_z1 = dy2 * (dx2 * pixel(0, 0, 0) + dx1 * pixel(0, 0, 1)) +
+                                     dy1 * (dx2 * pixel(0, 1, 0) + dx1 * pixel(0, 1, 1));
+                  T Y_gridpoint_z2 = dy2 * (dx2 * pixel(1, 0, 0) + dx1 * pixel(1, 0, 1)) +
+                                     dy1 * (dx2 * pixel(1, 1, 0) + dx1 * pixel(1, 1, 1));
+                  Y_row[ox] = dz2 * Y_gridpoint_z1 + dz1 * Y_gridpoint_z2;
                 }
               }
             }
@@ -68,8 +68,7 @@ class GridSample final : public OpKernel {
     Reflection
   };
 
-  T PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const;
-  T PixelAtGrid3D(const T* image, int64_t d, int64_t h, int64_t w, int64_t D, int64_t H, int64_t W, T border[/* 6 */]) const;
+  int64_t PaddedOffset(int64_t i, int64_t length, int64_t stride, T border_min, T border_max) const;
 
   GridSampleInterpolationMode mode_{Linear};
   GridSamplePaddingMode padding_mode_{Zeros};
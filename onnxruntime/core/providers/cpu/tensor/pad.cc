@@ -464,36 +464,47 @@ static Status PadImpl(OpKernelContext* ctx,
   ExtentAxisCounters input_counters(input_extents);
 
   switch (mode) {
-    case Mode::Constant:
-      // Loop over the output tensor, writing out padding between the blocks of copied data
-      // On loop entry, 'pad' is already set to the first continuous block of padding, and
-      // after every pass through the inner loop it gets set to the next continuous pad size.
-      while (input_counters) {
-        output += alignSkip;
-        {
-          T* axisStart = output;
-          output = input.CopyInnermostAxisSolitaryInnerStep(output);
-
-          int64_t prePad = reshaped_pad[inner_axis];
-          int64_t postPad = reshaped_pad[inner_axis + new_dims_count];
-          PadAxisConstant(axisStart - prePad, value, onnxruntime::narrow<size_t>(prePad));
-          PadAxisConstant(output, value, onnxruntime::narrow<size_t>(postPad));
-          output += postPad;
-          alignSkip = onnxruntime::narrow<size_t>(prePad);
-        }
-        // Calculate the size of the next block of padding (skipping over the innermost axis since that's already done)
-        while (input_counters.Increment()) {
-          ptrdiff_t inner_pitch = onnxruntime::narrow<std::ptrdiff_t>(output_pitches[input_counters.Axis()]);
-          T* axisStart = output - inner_pitch * input_extents[input_counters.Axis()];
-          int64_t prePad = reshaped_pad[input_counters.Axis()];
-          int64_t postPad = reshaped_pad[input_counters.Axis() + new_dims_count];
-          PadAxisConstant(axisStart - prePad * inner_pitch, value, SafeInt<std::ptrdiff_t>(prePad) * inner_pitch);
-          PadAxisConstant(output, value, SafeInt<ptrdiff_t>(postPad) * inner_pitch);
-          output += inner_pitch * postPad;
-          alignSkip += inner_pitch * SafeInt<size_t>(prePad);
-        }
-      }
+    case Mode::Constant: {
+      // The rows of the output along the innermost axis are independent, so they are written in parallel. A row is
+      // either in the padding of an outer axis, or made of the padding before the input row, the input row and the
+      // padding after it.
+      const auto* input_data = reinterpret_cast<const T*>(input_tensor.DataRaw());
+      TensorPitches input_pitches(reshaped_input_dims);
+      const size_t row_size = onnxruntime::narrow<size_t>(reshaped_output_dims[inner_axis]);
+      const size_t pre_pad = onnxruntime::narrow<size_t>(reshaped_pad[inner_axis]);
+      const size_t post_pad = onnxruntime::narrow<size_t>(reshaped_pad[inner_axis + new_dims_count]);
+      const size_t row_extent = onnxruntime::narrow<size_t>(input_extents[inner_axis]);
+      const int64_t num_rows = TensorShape(reshaped_output_dims).SizeToDimension(inner_axis);
+      concurrency::ThreadPool::TryParallelFor(
+          ctx->GetOperatorThreadPool(), onnxruntime::narrow<std::ptrdiff_t>(num_rows),
+          TensorOpCost{static_cast<double>(row_extent * sizeof(T)), static_cast<double>(row_size * sizeof(T)), 0.0},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t row = first; row < last; ++row) {
+              T* output_row = output + row * row_size;
+              const T* input_row = input_data + input_starts[inner_axis];
+              bool is_padding = false;
+              int64_t remaining = row;
+              for (size_t axis = inner_axis; axis-- > 0;) {
+                const int64_t index = remaining % reshaped_output_dims[axis] - reshaped_pad[axis];
+                remaining /= reshaped_output_dims[axis];
+                if (index < 0 || index >= input_extents[axis]) {
+                  is_padding = true;
+                  break;
+                }
+                input_row += (input_starts[axis] + index) * input_pitches[axis];
+              }
+
+              if (is_padding) {
+                PadAxisConstant(output_row, value, row_size);
+              } else {
+                PadAxisConstant(output_row, value, pre_pad);
+                std::copy_n(input_row, row_extent, output_row + pre_pad);
+                PadAxisConstant(output_row + pre_pad + row_extent, value, post_pad);
+              }
+            }
+          });
       break;
+    }
 
     case Mode::Edge:
       // Loop over the output tensor, writing out padding between the blocks of copied data
@@ -3,6 +3,9 @@
 
 #include "core/providers/cpu/tensor/scatter_nd.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/platform/threadpool.h"
@@ -122,7 +125,7 @@ struct Prepare {
 };  // struct Prepare
 
 template <typename TData>
-Status PrepareForCompute(OpKernelContext* context, Prepare<TData>& p) {
+Status PrepareForCompute(OpKernelContext* context, Prepare<TData>& p, concurrency::ThreadPool* tp) {
   const auto* input_tensor = context->Input<Tensor>(0);
   const auto* indice_tensor = context->Input<Tensor>(1);
   const auto* update_tensor = context->Input<Tensor>(2);
@@ -168,24 +171,38 @@ Status PrepareForCompute(OpKernelContext* context, Prepare<TData>& p) {
   p.input_base = update_tensor->Data<TData>();
   p.output_base = output_tensor->MutableData<TData>();
 
-  for (int64_t i = 0; i < offset_count; ++i) {
-    for (int64_t j = 0; j < last_indice_dimension; ++j) {
-      auto indice = *(indice_offset + i * last_indice_dimension + j);
-
-      if (indice >= 0) {
-        if (indice >= input_shape[onnxruntime::narrow<size_t>(j)]) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid indice found, indice = ", indice);
-        }
-      } else {
-        if (indice < -input_shape[onnxruntime::narrow<size_t>(j)]) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid indice found, indice = ", indice);
-        } else {
-          indice += input_shape[onnxruntime::narrow<size_t>(j)];
+  // Compute the element offsets of the updates, the indices are validated at the same time.
+  std::atomic<bool> invalid_indice{false};
+  int64_t invalid_indice_value = 0;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(offset_count),
+      TensorOpCost{static_cast<double>(last_indice_dimension * sizeof(int64_t)), static_cast<double>(sizeof(uint64_t)),
+                   static_cast<double>(last_indice_dimension * 2)},
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t i = first; i < last; ++i) {
+          uint64_t element_offset = 0;
+          for (int64_t j = 0; j < last_indice_dimension; ++j) {
+            auto indice = *(indice_offset + i * last_indice_dimension + j);
+            const auto dim = input_shape[onnxruntime::narrow<size_t>(j)];
+
+            if (indice < -dim || indice >= dim) {
+              if (!invalid_indice.exchange(true)) {
+                invalid_indice_value = indice;
+              }
+              return;
+            }
+            if (indice < 0) {
+              indice += dim;
+            }
+
+            element_offset += indice * element_counts[onnxruntime::narrow<size_t>(j)];
+          }
+          p.element_offsets[onnxruntime::narrow<size_t>(i)] = element_offset;
         }
-      }
+      });
 
-      p.element_offsets[onnxruntime::narrow<size_t>(i)] += indice * element_counts[onnxruntime::narrow<size_t>(j)];
-    }
+  if (invalid_indice) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid indice found, indice = ", invalid_indice_value);
   }
   return Status::OK();
 }
@@ -350,59 +367,79 @@ struct Func_Max_ND<BFloat16> {
   }
 };
 
+template <typename TData, typename TFunc>
+void ScatterNDApply(const Prepare<TData>& prepare, bool has_duplicates, concurrency::ThreadPool* tp) {
+  const auto func = TFunc();
+  const auto offset_count = onnxruntime::narrow<std::ptrdiff_t>(prepare.element_offsets.size());
+  const uint64_t element_to_copy = prepare.element_to_copy;
+
+  if (!has_duplicates) {
+    // Every update targets its own slice of the output, the updates are split between the threads.
+    concurrency::ThreadPool::TryParallelFor(
+        tp, offset_count,
+        TensorOpCost{static_cast<double>(element_to_copy * sizeof(TData)) * 2,
+                     static_cast<double>(element_to_copy * sizeof(TData)),
+                     static_cast<double>(element_to_copy)},
+        [&prepare, &func, element_to_copy](ptrdiff_t first, ptrdiff_t last) {
+          for (ptrdiff_t i = first; i < last; ++i) {
+            func(prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
+                 prepare.input_base + i * element_to_copy,
+                 element_to_copy);
+          }
+        });
+    return;
+  }
+
+  // Several updates target the same slice: they are applied in order, and the threads split the elements of
+  // the slices instead so that no two threads update the same output element.
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(element_to_copy),
+      TensorOpCost{static_cast<double>(offset_count * sizeof(TData)) * 2,
+                   static_cast<double>(offset_count * sizeof(TData)),
+                   static_cast<double>(offset_count)},
+      [&prepare, &func, offset_count, element_to_copy](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t i = 0; i < offset_count; ++i) {
+          func(prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)] + first,
+               prepare.input_base + i * element_to_copy + first,
+               static_cast<uint64_t>(last - first));
+        }
+      });
+}
+
 template <typename TData>
 struct ScatterNDDispatchTarget {
   Status operator()(OpKernelContext* context, concurrency::ThreadPool* tp, ScatterND::Reduction reduction) const {
     Prepare<TData> prepare;
-    ORT_RETURN_IF_ERROR(PrepareForCompute(context, prepare));
-
-    auto lambda = [&](int64_t i) {
-      switch (reduction) {
-        case ScatterND::Reduction::Add: {
-          auto func = Func_Add_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        case ScatterND::Reduction::Mul: {
-          auto func = Func_Mul_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        case ScatterND::Reduction::Min: {
-          auto func = Func_Min_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        case ScatterND::Reduction::Max: {
-          auto func = Func_Max_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-        default:
-        case ScatterND::Reduction::None: {
-          auto func = Func_Copy_ND<TData>();
-          func(
-              prepare.output_base + prepare.element_offsets[onnxruntime::narrow<size_t>(i)],
-              prepare.input_base + i * prepare.element_to_copy,
-              prepare.element_to_copy);
-        } break;
-      }
-    };
-    concurrency::ThreadPool::TryParallelFor(
-        tp, prepare.element_offsets.size(), static_cast<double>(prepare.element_to_copy),
-        [&lambda](ptrdiff_t first, ptrdiff_t last) {
-          for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
-            lambda(i);
-          }
-        });
+    ORT_RETURN_IF_ERROR(PrepareForCompute(context, prepare, tp));
+
+    // Duplicated indices only matter for a reduction, which must then accumulate every update. The spec
+    // leaves the result undefined for 'none'.
+    bool has_duplicates = false;
+    if (reduction != ScatterND::Reduction::None && prepare.element_offsets.size() > 1 &&
+        concurrency::ThreadPool::DegreeOfParallelism(tp) > 1) {
+      std::vector<uint64_t> sorted_offsets(prepare.element_offsets);
+      std::sort(sorted_offsets.begin(), sorted_offsets.end());
+      has_duplicates = std::adjacent_find(sorted_offsets.begin(), sorted_offsets.end()) != sorted_offsets.end();
+    }
+
+    switch (reduction) {
+      case ScatterND::Reduction::Add:
+        ScatterNDApply<TData, Func_Add_ND<TData>>(prepare, has_duplicates, tp);
+        break;
+      case ScatterND::Reduction::Mul:
+        ScatterNDApply<TData, Func_Mul_ND<TData>>(prepare, has_duplicates, tp);
+        break;
+      case ScatterND::Reduction::Min:
+        ScatterNDApply<TData, Func_Min_ND<TData>>(prepare, has_duplicates, tp);
+        break;
+      case ScatterND::Reduction::Max:
+        ScatterNDApply<TData, Func_Max_ND<TData>>(prepare, has_duplicates, tp);
+        break;
+      default:
+      case ScatterND::Reduction::None:
+        ScatterNDApply<TData, Func_Copy_ND<TData>>(prepare, has_duplicates, tp);
+        break;
+    }
     return Status::OK();
   }
 };
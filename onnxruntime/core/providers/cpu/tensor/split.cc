@@ -28,12 +28,32 @@ ORT_SPECIFY_OP_KERNEL_ARG_REQUIRED_TYPES_ALL_OPSETS(
 using EnabledSplitDataTypes = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST_ALL_OPSETS(
     kCpuExecutionProvider, kOnnxDomain, Split, Input, 0);
 
+namespace {
+#ifdef ENABLE_STRIDED_TENSORS
+// The number of outputs declared as possible views of the input. The number of outputs is only known from the node,
+// this covers the usual splits (e.g. of fused QKV projections, or of heads).
+constexpr int kMaxStridedOutputs = 16;
+#endif
+
+KernelDefBuilder SplitKernelDefBuilder() {
+  KernelDefBuilder builder;
+  builder.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>());
+#ifdef ENABLE_STRIDED_TENSORS
+  // the outputs are views of the input when all their consumers support strided inputs
+  builder.MayStridedInput(0);
+  for (int i = 0; i < kMaxStridedOutputs; ++i) {
+    builder.MayStridedOutput(0, i);
+  }
+#endif
+  return builder;
+}
+}  // namespace
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Split,
     2,
     10,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    SplitKernelDefBuilder(),
     Split_1_13);
 
 // Opset 11 starts to support Neg Axis.
@@ -41,8 +61,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Split,
     11,
     12,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    SplitKernelDefBuilder(),
     Split_1_13);
 
 // Opset 13 starts to supports 'split' as optional input.
@@ -50,16 +69,14 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Split,
     13,
     17,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    SplitKernelDefBuilder(),
     Split_1_13);
 
 // TODO: support unequal split and num_outputs
 ONNX_CPU_OPERATOR_KERNEL(
     Split,
     18,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    SplitKernelDefBuilder(),
     Split_18);
 
 Status SplitBase::PrepareForCompute(const TensorShape& input_shape, int num_outputs, int64_t& axis, int& before_dims,
@@ -146,7 +163,11 @@ Status SplitImpl::Compute(OpKernelContext* context) const {
                                         after_dims_excluding_split,
                                         split_sizes));
 
+#ifdef ENABLE_STRIDED_TENSORS
+  const auto input_strides = ToShapeVector(input.Strides());
+#else
   const auto input_strides = StridesForTensor(input);
+#endif
 
   // copy dimensions so we can update the selected axis in place
   auto output_dimensions = input_shape.AsShapeVector();
@@ -159,6 +180,18 @@ Status SplitImpl::Compute(OpKernelContext* context) const {
     output_dimensions[narrow<size_t>(axis)] = split_size;
 
     Tensor* output = context->Output(i, TensorShape{output_dimensions});
+
+#ifdef ENABLE_STRIDED_TENSORS
+    // the output shares the buffer of the input: make it a view of the split part
+    if (output->DataRaw() == input.DataRaw()) {
+      output->SetShapeAndStrides(output->Shape(), input_strides);
+      output->SetByteOffset(output->ByteOffset() +
+                            input_offset * static_cast<ptrdiff_t>(input.DataType()->Size()));
+      input_offset += SafeInt<ptrdiff_t>(split_size) * input_strides[narrow<size_t>(axis)];
+      continue;
+    }
+#endif
+
     const auto output_strides = StridesForTensor(*output);
 
     ORT_RETURN_IF_ERROR(DispatchStridedCopy<EnabledSplitDataTypes>(context->GetOperatorThreadPool(),
@@ -166,7 +199,7 @@ Status SplitImpl::Compute(OpKernelContext* context) const {
                                                                    output->Shape(),
                                                                    input, input_offset, input_strides));
 
-    input_offset += SafeInt<ptrdiff_t>(split_size) * after_dims_excluding_split;  // offset by the data we used in this iteration
+    input_offset += SafeInt<ptrdiff_t>(split_size) * input_strides[narrow<size_t>(axis)];  // offset by the data we used in this iteration
   }
 
   return Status::OK();
@@ -10,6 +10,9 @@
 #endif
 
 #include "core/providers/cpu/tensor/tile.h"
+
+#include <algorithm>
+
 #include "core/providers/cpu/tensor/utils.h"
 
 #ifdef _MSC_VER
@@ -57,46 +60,83 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>()),
     Tile);
 
-Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tensor, const int64_t* repeats, TensorAxisCounters& input_counters, const TensorPitches& output_pitches, size_t element_size) {
-  const auto& input_shape = input_tensor.Shape().GetDims();
-  const size_t dimension_count = input_shape.size();
+namespace {
+// Fills the count - 1 blocks of block_bytes following the block at dst with copies of it. The copies are made from
+// the part already filled, so the number of memcpy calls is logarithmic in count.
+void ReplicateBlock(uint8_t* dst, size_t block_bytes, size_t count) {
+  const size_t total_bytes = block_bytes * count;
+  for (size_t filled = block_bytes; filled < total_bytes;) {
+    const size_t bytes = std::min(filled, total_bytes - filled);
+    memcpy(dst + filled, dst, bytes);
+    filled += bytes;
+  }
+}
+
+// The offset in the output, in elements, of the block of an axis at the input indices of the axes before it, given as
+// a linear index. That is where the input values at these indices are written before the axis is tiled.
+size_t BlockOffset(size_t block, size_t axis, gsl::span<const int64_t> input_dims, const TensorPitches& output_pitches) {
+  size_t offset = 0;
+  for (size_t i = axis; i-- > 0;) {
+    const size_t dim = onnxruntime::narrow<size_t>(input_dims[i]);
+    offset += (block % dim) * onnxruntime::narrow<size_t>(output_pitches[i]);
+    block /= dim;
+  }
+  return offset;
+}
+}  // namespace
+
+// The rows of the input are copied to the output first, then the blocks of each axis are repeated, from the innermost
+// axis to the outermost one. Each step is parallelized over the copies it makes.
+Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tensor, const int64_t* repeats,
+                                 const TensorPitches& output_pitches, size_t element_size,
+                                 concurrency::ThreadPool* tp) {
+  const auto& input_shape = input_tensor.Shape();
+  const auto input_dims = input_shape.GetDims();
+  const size_t dimension_count = input_dims.size();
 
   const auto* input = reinterpret_cast<const uint8_t*>(input_tensor.DataRaw());
   auto* output = reinterpret_cast<uint8_t*>(output_tensor.MutableDataRaw());
 
-  // some helper variables that will be used along the way
-  size_t block_size = 0;
-  int64_t num_repeats = 0;
-  const uint8_t* copy = nullptr;
-  const int64_t innermost_dim = input_shape[dimension_count - 1];
-
-  while (input_counters) {
-    // Copy the input data over
-    block_size = SafeInt<size_t>(innermost_dim) * element_size;
-    memcpy(output, input, block_size);
-    output += block_size;
-    input += block_size;
+  const size_t row_bytes = SafeInt<size_t>(input_dims[dimension_count - 1]) * element_size;
+  const size_t num_rows = onnxruntime::narrow<size_t>(input_shape.SizeToDimension(dimension_count - 1));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(num_rows),
+      TensorOpCost{static_cast<double>(row_bytes), static_cast<double>(row_bytes), 0.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const size_t output_offset = BlockOffset(static_cast<size_t>(row), dimension_count - 1, input_dims,
+                                                   output_pitches);
+          memcpy(output + output_offset * element_size, input + row * row_bytes, row_bytes);
+        }
+      });
 
-    // Tile data for the innermost axis
-    copy = output - block_size;
-    num_repeats = repeats[dimension_count - 1] - 1;
-    for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-      memcpy(output, copy, block_size);
-      output += block_size;
+  for (size_t axis = dimension_count; axis-- > 0;) {
+    const size_t num_copies = onnxruntime::narrow<size_t>(repeats[axis]) - 1;
+    if (num_copies == 0) {
+      continue;
     }
 
-    // Tile data for other axes
-    while (input_counters.Increment()) {
-      ptrdiff_t pitch = onnxruntime::narrow<size_t>(output_pitches[input_counters.Axis()] * input_shape[input_counters.Axis()]);
-      block_size = pitch * element_size;
-      copy = output - block_size;
-      num_repeats = repeats[input_counters.Axis()] - 1;
-      for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-        memcpy(output, copy, block_size);
-        output += block_size;
-      }
-    }
+    // a block of the axis holds the tiled blocks of the next axis for each of its input indices
+    const size_t block_bytes = SafeInt<size_t>(input_dims[axis]) * output_pitches[axis] * element_size;
+    const size_t num_blocks = onnxruntime::narrow<size_t>(input_shape.SizeToDimension(axis));
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(num_blocks * num_copies),
+        TensorOpCost{static_cast<double>(block_bytes), static_cast<double>(block_bytes), 0.0},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          // the copies of a block are consecutive in the output, so a range makes them from the first one it writes
+          for (size_t i = static_cast<size_t>(first), end = static_cast<size_t>(last); i < end;) {
+            const size_t block = i / num_copies;
+            const size_t copy = i % num_copies;
+            const size_t count = std::min(end - i, num_copies - copy);
+            uint8_t* src = output + BlockOffset(block, axis, input_dims, output_pitches) * element_size;
+            uint8_t* dst = src + (copy + 1) * block_bytes;
+            memcpy(dst, src, block_bytes);
+            ReplicateBlock(dst, block_bytes, count);
+            i += count;
+          }
+        });
   }
+
   return Status::OK();
 }
 
@@ -218,86 +258,36 @@ Status Tile::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
-  bool is_batched_memcpy = false;
-  size_t num_of_elements_per_batch = 1;
-  size_t num_of_copies_per_batch = 1;
-  size_t num_of_batch_copies = 1;
-  if (TileOp::IsTileMemcpy(input_shape,
-                           repeats,
-                           input_rank,
-                           is_batched_memcpy,
-                           num_of_elements_per_batch,
-                           num_of_copies_per_batch,
-                           num_of_batch_copies) &&
-      !input_tensor.IsDataType<std::string>()) {
-    int8_t* output_data_casted = reinterpret_cast<int8_t*>(output_tensor.MutableDataRaw());
-    const int8_t* input_data_casted = reinterpret_cast<const int8_t*>(input_tensor.DataRaw());
-    const void* input_data_raw = input_tensor.DataRaw();
-
-    if (!is_batched_memcpy) {
-      size_t copy_bytes = input_tensor.SizeInBytes();
-      // TODO: Add multi-threading logic if num_of_copies_per_batch is large enough
-      for (size_t i = 0; i < num_of_copies_per_batch; ++i) {
-        memcpy(static_cast<void*>(output_data_casted), input_data_raw, copy_bytes);
-        output_data_casted += copy_bytes;
-      }
-    } else {
-      size_t copy_bytes = num_of_elements_per_batch * input_tensor.DataType()->Size();
-      size_t batch_count = static_cast<size_t>(input_tensor.Shape()[0]);  // The tensor is atleast 1-D- this is safe
-
-      // TODO: Multi-thread if needed
-      for (size_t batch = 0; batch < batch_count; ++batch) {
-        for (size_t i = 0; i < num_of_copies_per_batch; ++i) {
-          memcpy(static_cast<void*>(output_data_casted), static_cast<const void*>(input_data_casted), copy_bytes);
-          output_data_casted += copy_bytes;
-        }
-        input_data_casted += copy_bytes;
-      }
-
-      // Now account for batch dim repeat
-      if (num_of_batch_copies > 1) {
-        // reset some values
-        output_data_casted = reinterpret_cast<int8_t*>(output_tensor.MutableDataRaw());
-        copy_bytes *= num_of_copies_per_batch * batch_count;
-        int8_t* copy_ptr = output_data_casted + copy_bytes;
-
-        for (size_t i = 1; i < num_of_batch_copies; ++i) {
-          memcpy(static_cast<void*>(copy_ptr), static_cast<const void*>(output_data_casted), copy_bytes);
-          copy_ptr += copy_bytes;
-        }
-      }
-    }
-
-    return Status::OK();
-  }
-
-  TensorAxisCounters input_counters(input_tensor);
   TensorPitches output_pitches(output_tensor);
 
   static_assert(sizeof(float) == sizeof(int32_t), "Float and Int32 are of different sizes");
   static_assert(sizeof(double) == sizeof(int64_t), "Double and Int64 are of different sizes");
 
-  if (input_tensor.IsDataType<std::string>())
+  if (input_tensor.IsDataType<std::string>()) {
+    TensorAxisCounters input_counters(input_tensor);
     return TileCoreForStringType(input_tensor, output_tensor, repeats, input_counters, output_pitches);
+  }
+
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
 
   if (input_tensor.IsDataType<float>() ||
       input_tensor.IsDataType<int32_t>() ||
       input_tensor.IsDataType<uint32_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(float));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, output_pitches, sizeof(float), tp);
 
   if (input_tensor.IsDataType<double>() || input_tensor.IsDataType<int64_t>() ||
       input_tensor.IsDataType<uint64_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(double));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, output_pitches, sizeof(double), tp);
 
   else if (input_tensor.IsDataType<int8_t>() ||
            input_tensor.IsDataType<uint8_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int8_t));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, output_pitches, sizeof(int8_t), tp);
 
   if (input_tensor.IsDataType<int16_t>() || input_tensor.IsDataType<uint16_t>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(int16_t));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, output_pitches, sizeof(int16_t), tp);
 
   else if (input_tensor.IsDataType<bool>())
-    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, input_counters, output_pitches, sizeof(bool));
+    return TileCoreForFixedSizeTypes(input_tensor, output_tensor, repeats, output_pitches, sizeof(bool), tp);
 
   // TODO: Support 'string' and 'float16' types for completeness
   else
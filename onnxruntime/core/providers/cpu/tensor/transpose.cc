@@ -3,11 +3,16 @@
 
 #include "core/providers/cpu/tensor/transpose.h"
 
+#include <algorithm>
+#include <numeric>
+
+#include "core/framework/copy.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/utils.h"
 #include "core/framework/transpose_helper.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "utils.h"
 
@@ -322,6 +327,237 @@ static Status DoUntypedTranspose(const gsl::span<const size_t>& permutations, co
   return status;
 }
 
+// Nested loops over a subset of the axes of a transpose, tracking the source and target offsets
+// (in elements) of the current position.
+struct TransposeLoop {
+  InlinedVector<size_t> dims;
+  InlinedVector<size_t> source_strides;
+  InlinedVector<size_t> target_strides;
+
+  void AddAxis(size_t dim, size_t source_stride, size_t target_stride) {
+    dims.push_back(dim);
+    source_strides.push_back(source_stride);
+    target_strides.push_back(target_stride);
+  }
+
+  size_t Count() const {
+    size_t count = 1;
+    for (size_t dim : dims) {
+      count *= dim;
+    }
+    return count;
+  }
+
+  // Sets `counters` to the position with the linear index `index` and returns its offsets.
+  void Seek(size_t index, InlinedVector<size_t>& counters, size_t& source_offset, size_t& target_offset) const {
+    counters.resize(dims.size());
+    source_offset = 0;
+    target_offset = 0;
+    for (size_t i = dims.size(); i-- > 0;) {
+      counters[i] = index % dims[i];
+      index /= dims[i];
+      source_offset += counters[i] * source_strides[i];
+      target_offset += counters[i] * target_strides[i];
+    }
+  }
+
+  // Moves `counters` to the next position and updates its offsets.
+  void Next(InlinedVector<size_t>& counters, size_t& source_offset, size_t& target_offset) const {
+    for (size_t i = dims.size(); i-- > 0;) {
+      source_offset += source_strides[i];
+      target_offset += target_strides[i];
+      if (++counters[i] < dims[i]) {
+        return;
+      }
+      source_offset -= counters[i] * source_strides[i];
+      target_offset -= counters[i] * target_strides[i];
+      counters[i] = 0;
+    }
+  }
+};
+
+/* Simplifies a permutation by removing the axes of size 1 and by merging the runs of input axes
+ * which stay adjacent and in order in the output. e.g. a [2,3,4,5] tensor with perm=(0,2,3,1)
+ * becomes a [2,3,20] tensor with perm=(0,2,1). The result describes the same data movement.
+ */
+static void SimplifyTransposePermutation(const gsl::span<const size_t>& permutations,
+                                         gsl::span<const int64_t> input_dims,
+                                         InlinedVector<size_t>& dims, InlinedVector<size_t>& perm) {
+  // Runs of input axes in output order, as (first input axis, product of the dimensions).
+  InlinedVector<std::pair<size_t, size_t>> runs;
+  size_t last_axis = 0;
+  for (size_t axis : permutations) {
+    const auto dim = static_cast<size_t>(input_dims[axis]);
+    if (dim == 1) {
+      continue;
+    }
+
+    // The input axes between the last one and this one all have a dimension of 1.
+    bool adjacent = !runs.empty() && axis > last_axis;
+    for (size_t i = last_axis + 1; adjacent && i < axis; ++i) {
+      adjacent = input_dims[i] == 1;
+    }
+
+    if (adjacent) {
+      runs.back().second *= dim;
+    } else {
+      runs.emplace_back(axis, dim);
+    }
+    last_axis = axis;
+  }
+
+  // Number the runs by the position of their first axis in the input.
+  InlinedVector<size_t> order(runs.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(), [&runs](size_t a, size_t b) { return runs[a].first < runs[b].first; });
+
+  dims.resize(runs.size());
+  perm.resize(runs.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    dims[i] = runs[order[i]].second;
+    perm[order[i]] = i;
+  }
+}
+
+template <typename T>
+static void TransposeTile(const T* source, T* target, size_t rows, size_t cols,
+                          size_t source_stride, size_t target_stride) {
+  MlasTranspose(source, target, rows, cols, source_stride, target_stride);
+}
+
+static void TransposeTile(const uint64_t* source, uint64_t* target, size_t rows, size_t cols,
+                          size_t source_stride, size_t target_stride) {
+  for (size_t c = 0; c < cols; ++c) {
+    for (size_t r = 0; r < rows; ++r) {
+      target[c * target_stride + r] = source[r * source_stride + c];
+    }
+  }
+}
+
+/* Transposes a tensor of elements of type T, for any permutation.
+ *
+ * After simplifying the permutation, either the innermost axis is preserved and the output is a
+ * sequence of contiguous blocks copied from the input, or the innermost axes of the input and of
+ * the output form 2D transposes, which are split in tiles small enough to stay in the cache. In
+ * both cases, the blocks or tiles are distributed over the thread pool.
+ */
+template <typename T>
+static bool TypedDoBlockedTranspose(const gsl::span<const size_t>& permutations, gsl::span<const int64_t> input_dims,
+                                    const uint8_t* source, uint8_t* target, concurrency::ThreadPool* tp) {
+  constexpr bool enabled = utils::HasTypeWithSameSize<EnabledDataTypes, T>();
+
+  if (enabled) {
+    InlinedVector<size_t> dims;
+    InlinedVector<size_t> perm;
+    SimplifyTransposePermutation(permutations, input_dims, dims, perm);
+
+    const size_t rank = dims.size();
+    const T* source_data = reinterpret_cast<const T*>(source);
+    T* target_data = reinterpret_cast<T*>(target);
+
+    InlinedVector<size_t> source_strides(rank);
+    InlinedVector<size_t> target_strides(rank);
+    size_t total_size = 1;
+    for (size_t i = rank; i-- > 0;) {
+      source_strides[i] = total_size;
+      total_size *= dims[i];
+    }
+    total_size = 1;
+    for (size_t i = rank; i-- > 0;) {
+      target_strides[i] = total_size;
+      total_size *= dims[perm[i]];
+    }
+
+    if (rank <= 1 || perm[rank - 1] == rank - 1) {
+      // Copy the contiguous blocks of the innermost axis.
+      const size_t block_size = rank == 0 ? 1 : dims[rank - 1];
+      TransposeLoop loop;
+      for (size_t i = 0; i + 1 < rank; ++i) {
+        loop.AddAxis(dims[perm[i]], source_strides[perm[i]], target_strides[i]);
+      }
+
+      const double block_bytes = static_cast<double>(block_size * sizeof(T));
+      concurrency::ThreadPool::TryParallelFor(
+          tp, static_cast<std::ptrdiff_t>(loop.Count()), TensorOpCost{block_bytes, block_bytes, block_bytes / 16},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            InlinedVector<size_t> counters;
+            size_t source_offset;
+            size_t target_offset;
+            loop.Seek(static_cast<size_t>(first), counters, source_offset, target_offset);
+            for (std::ptrdiff_t i = first; i < last; ++i) {
+              memcpy(target_data + target_offset, source_data + source_offset, block_size * sizeof(T));
+              loop.Next(counters, source_offset, target_offset);
+            }
+          });
+    } else {
+      // The innermost output axis is the input axis `row_axis`, and the innermost input axis is
+      // the output axis `col_axis`: each position of the other axes is a 2D transpose.
+      constexpr size_t kTileSize = 64;
+      const size_t row_axis = perm[rank - 1];
+      const size_t col_axis = static_cast<size_t>(std::find(perm.begin(), perm.end(), rank - 1) - perm.begin());
+      const size_t rows = dims[row_axis];
+      const size_t cols = dims[rank - 1];
+      const size_t row_tiles = (rows + kTileSize - 1) / kTileSize;
+      const size_t col_tiles = (cols + kTileSize - 1) / kTileSize;
+
+      TransposeLoop loop;
+      for (size_t i = 0; i + 1 < rank; ++i) {
+        if (i != col_axis) {
+          loop.AddAxis(dims[perm[i]], source_strides[perm[i]], target_strides[i]);
+        }
+      }
+      loop.AddAxis(col_tiles, kTileSize, kTileSize * target_strides[col_axis]);
+      loop.AddAxis(row_tiles, kTileSize * source_strides[row_axis], kTileSize);
+
+      const double tile_bytes = static_cast<double>(kTileSize * kTileSize * sizeof(T));
+      concurrency::ThreadPool::TryParallelFor(
+          tp, static_cast<std::ptrdiff_t>(loop.Count()), TensorOpCost{tile_bytes, tile_bytes, tile_bytes / 4},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            InlinedVector<size_t> counters;
+            size_t source_offset;
+            size_t target_offset;
+            loop.Seek(static_cast<size_t>(first), counters, source_offset, target_offset);
+            for (std::ptrdiff_t i = first; i < last; ++i) {
+              const size_t row_start = counters[counters.size() - 1] * kTileSize;
+              const size_t col_start = counters[counters.size() - 2] * kTileSize;
+              TransposeTile(source_data + source_offset, target_data + target_offset,
+                            std::min(kTileSize, rows - row_start), std::min(kTileSize, cols - col_start),
+                            source_strides[row_axis], target_strides[col_axis]);
+              loop.Next(counters, source_offset, target_offset);
+            }
+          });
+    }
+  }
+
+  return enabled;
+}
+
+//  `input_shape_override` overrides the shape of `input` for compute purposes.
+//  Returns false if the element type isn't handled, in which case the output is untouched.
+static bool TryDoBlockedTranspose(const gsl::span<const size_t>& permutations, const Tensor& input, Tensor& output,
+                                  const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
+  if (input.IsDataTypeString()) {
+    return false;
+  }
+
+  const auto& input_dims = (input_shape_override ? *input_shape_override : input.Shape()).GetDims();
+  const auto* source = reinterpret_cast<const uint8_t*>(input.DataRaw());
+  auto* target = reinterpret_cast<uint8_t*>(output.MutableDataRaw());
+
+  switch (input.DataType()->Size()) {
+    case sizeof(uint64_t):
+      return TypedDoBlockedTranspose<uint64_t>(permutations, input_dims, source, target, tp);
+    case sizeof(uint32_t):
+      return TypedDoBlockedTranspose<uint32_t>(permutations, input_dims, source, target, tp);
+    case sizeof(uint16_t):
+      return TypedDoBlockedTranspose<uint16_t>(permutations, input_dims, source, target, tp);
+    case sizeof(uint8_t):
+      return TypedDoBlockedTranspose<uint8_t>(permutations, input_dims, source, target, tp);
+    default:
+      return false;
+  }
+}
+
 bool IsTransposeReshape(const gsl::span<const size_t>& perm, gsl::span<const int64_t> input_dims) {
   // As long as the dims with values > 1 stay in the same order, it's a reshape.
   // Example: Shape=(1,1,1024,4096) -> perm=(2,0,3,1).
@@ -338,7 +574,7 @@ bool IsTransposeReshape(const gsl::span<const size_t>& perm, gsl::span<const int
 
 //`input_shape_override` overrides the shape of `input` for compute purposes.
 Status TransposeBase::DoTranspose(const gsl::span<const size_t>& permutations, const Tensor& input, Tensor& output,
-                                  const TensorShape* input_shape_override) {
+                                  const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
   Status status = Status::OK();
 
   auto input_type = input.DataType();
@@ -360,8 +596,8 @@ Status TransposeBase::DoTranspose(const gsl::span<const size_t>& permutations, c
     bool moving_single_axis = IsTransposeMovingSingleAxis(permutations, from, to);
 
     if (moving_single_axis && !input.IsDataTypeString()) {
-      SingleAxisTranspose(permutations, input, output, from, to, input_shape_override);
-    } else {
+      SingleAxisTranspose(permutations, input, output, from, to, input_shape_override, tp);
+    } else if (!TryDoBlockedTranspose(permutations, input, output, input_shape_override, tp)) {
       // fall back to default implementation
       status = DoUntypedTranspose(permutations, input, output, input_shape_override);
     }
@@ -391,6 +627,26 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
   if (output_shape.Size() == 0)
     return Status::OK();
 
+#ifdef ENABLE_STRIDED_TENSORS
+  // The output is a view of the input with permuted strides if it shares the buffer of the input. Otherwise a
+  // strided input is copied with these strides.
+  if (Y.DataRaw() == X.DataRaw() || !X.IsContiguous()) {
+    const auto input_strides = X.Strides();
+    TensorShapeVector permuted_strides(rank);
+    for (size_t i = 0; i < rank; ++i) {
+      permuted_strides[i] = input_strides[(*p_perm)[i]];
+    }
+
+    if (Y.DataRaw() == X.DataRaw()) {
+      Y.SetShapeAndStrides(output_shape, permuted_strides);
+      return Status::OK();
+    }
+
+    return DispatchStridedCopy<EnabledDataTypes>(ctx->GetOperatorThreadPool(), Y, 0, StridesForTensor(Y),
+                                                 output_shape, X, 0, permuted_strides);
+  }
+#endif
+
   if (IsTransposeReshape(*p_perm, input_dims)) {
     // As long as the dims with values > 1 stay in the same order, it's a reshape.
     // Example: Shape=(1,1,1024,4096) -> perm=(2,0,3,1).
@@ -403,7 +659,7 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
 
   if (moving_single_axis && !X.IsDataTypeString()) {
     SingleAxisTranspose(*p_perm, X, Y, from, to, nullptr, ctx->GetOperatorThreadPool());
-  } else {
+  } else if (!TryDoBlockedTranspose(*p_perm, X, Y, nullptr, ctx->GetOperatorThreadPool())) {
     // fall back to default implementation
     status = DoUntypedTranspose(*p_perm, X, Y);
   }
@@ -411,18 +667,30 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
   return status;
 }
 
+namespace {
+KernelDefBuilder TransposeKernelDefBuilder() {
+  KernelDefBuilder builder;
+  builder.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>());
+#ifdef ENABLE_STRIDED_TENSORS
+  // the output is a view of the input when all its consumers support strided inputs
+  builder.MayStridedInput(0).MayStridedOutput(0, 0);
+#endif
+  return builder;
+}
+}  // namespace
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Transpose,
     1,
     12,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
+    TransposeKernelDefBuilder(),
     Transpose);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Transpose,
     13,
     20,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
+    TransposeKernelDefBuilder(),
     Transpose);
 
 // Opset 21 added support for float8e4m3fnuz, float8e5m2, float8e5m2fnuz, int4 and uint4.
@@ -430,7 +698,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
 ONNX_CPU_OPERATOR_KERNEL(
     Transpose,
     21,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
+    TransposeKernelDefBuilder(),
     Transpose);
 
 }  // namespace onnxruntime
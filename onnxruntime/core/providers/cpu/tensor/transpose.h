@@ -31,9 +31,11 @@ class TransposeBase {
   /**
   Transpose the input Tensor into the output Tensor using the provided permutations.
   Both Tensors must have the same data type. `input_shape_override` overrides the shape of `input` for compute purposes.
+  The work is distributed over `tp` when provided.
   */
   static Status DoTranspose(const gsl::span<const size_t>& permutations, const Tensor& input, Tensor& output,
-                            const TensorShape* input_shape_override = nullptr);
+                            const TensorShape* input_shape_override = nullptr,
+                            concurrency::ThreadPool* tp = nullptr);
 
  protected:
   TransposeBase(const OpKernelInfo& info) {
@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/tensor/upsample.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "core/common/inlined_containers.h"
@@ -75,31 +76,62 @@ void UpsampleBase::AdjustOutputSizeAsPolicy(TensorShapeVector& output_dims, gsl:
   }
 }
 
+// Nearest upsampling of the two spatial axes of an NCHW or NHWC tensor by integer factors, where output pixel
+// (y, x) is input pixel (y / height_factor, x / width_factor). Each input row is expanded once into the first of its
+// output rows, which is then copied to the others.
 template <typename T>
-void UpsampleNearest2x(int64_t batch_size,
-                       int64_t num_channels,
-                       int64_t input_height,
-                       int64_t input_width,
-                       const T* input,
-                       T* output) {
-  const int64_t output_height = input_height * 2;
-  const int64_t output_width = input_width * 2;
-  for (int64_t n = 0; n < batch_size; ++n) {
-    for (int64_t c = 0; c < num_channels; ++c) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        const int64_t in_y = y / 2;
-        for (int64_t x = 0; x < input_width; ++x) {
-          const T v = input[in_y * input_width + x];
-          const int64_t oidx = output_width * y + x * 2;
-          output[oidx + 0] = v;
-          output[oidx + 1] = v;
-        }
-      }
+static void UpsampleNearestIntegerFactor(bool is_nchw,
+                                         int64_t batch_size,
+                                         int64_t num_channels,
+                                         int64_t input_height,
+                                         int64_t input_width,
+                                         int64_t height_factor,
+                                         int64_t width_factor,
+                                         const T* input,
+                                         T* output,
+                                         concurrency::ThreadPool* tp) {
+  const int64_t output_width = input_width * width_factor;
+  // NCHW rows hold the pixels of a channel, NHWC rows hold the pixels of all the channels.
+  const int64_t pixel_size = is_nchw ? 1 : num_channels;
+  const int64_t input_row_size = input_width * pixel_size;
+  const int64_t output_row_size = output_width * pixel_size;
+  const int64_t row_count = (is_nchw ? batch_size * num_channels : batch_size) * input_height;
+
+  const double input_row_bytes = static_cast<double>(input_row_size * sizeof(T));
+  const double output_rows_bytes = static_cast<double>(output_row_size * height_factor * sizeof(T));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(row_count),
+      TensorOpCost{input_row_bytes, output_rows_bytes, static_cast<double>(output_row_size * height_factor)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const T* input_row = input + row * input_row_size;
+          T* output_row = output + row * output_row_size * height_factor;
+
+          if (pixel_size == 1) {
+            if (width_factor == 2) {
+              for (int64_t x = 0; x < input_width; ++x) {
+                output_row[2 * x] = input_row[x];
+                output_row[2 * x + 1] = input_row[x];
+              }
+            } else {
+              for (int64_t x = 0; x < input_width; ++x) {
+                std::fill_n(output_row + x * width_factor, width_factor, input_row[x]);
+              }
+            }
+          } else {
+            T* output_pixel = output_row;
+            for (int64_t x = 0; x < input_width; ++x) {
+              for (int64_t i = 0; i < width_factor; ++i) {
+                output_pixel = std::copy_n(input_row + x * pixel_size, pixel_size, output_pixel);
+              }
+            }
+          }
 
-      input += input_height * input_width;
-      output += output_height * output_width;
-    }
-  }
+          for (int64_t i = 1; i < height_factor; ++i) {
+            std::copy_n(output_row, output_row_size, output_row + i * output_row_size);
+          }
+        }
+      });
 }
 
 static std::vector<int64_t> UpsampleNearestSetupRank1InputMapping(
@@ -301,6 +333,34 @@ static Status UpsampleNearestImpl(const T* input,
   return Status::OK();
 }
 
+// Returns true and sets factor if the nearest pixel of each output index along an axis is output index / factor,
+// e.g. for integer scales with the asymmetric coordinate transformation and the floor nearest mode, or the
+// half_pixel coordinate transformation and a round nearest mode.
+static bool IsIntegerFactorNearestMapping(int64_t length_original,
+                                          int64_t length_resized,
+                                          float x_scale,
+                                          float roi_start,
+                                          float roi_end,
+                                          const GetOriginalCoordinateFunc& get_original_coordinate,
+                                          const GetNearestPixelFunc& get_nearest_pixel,
+                                          int64_t& factor) {
+  if (length_original <= 0 || length_resized % length_original != 0) {
+    return false;
+  }
+
+  factor = length_resized / length_original;
+  const std::vector<int64_t> input_mapping = UpsampleNearestSetupRank1InputMapping(
+      length_original, length_resized, x_scale, roi_start, roi_end, false, get_original_coordinate,
+      get_nearest_pixel);
+  for (int64_t i = 0; i < length_resized; ++i) {
+    if (input_mapping[narrow<size_t>(i)] != i / factor) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 static Status ValidateUpsampleInput(const void* input, const void* output,
                                     const TensorShape& input_shape, const TensorShape& output_shape,
                                     bool is_resize) {
@@ -337,14 +397,39 @@ static Status UpsampleNearest(const T* input,
                               T extrapolation_value,
                               bool use_nearest2x_optimization,
                               const GetOriginalCoordinateFunc& get_original_coordinate,
-                              const GetNearestPixelFunc& get_nearest_pixel) {
+                              const GetNearestPixelFunc& get_nearest_pixel,
+                              concurrency::ThreadPool* tp) {
   ORT_RETURN_IF_ERROR(ValidateUpsampleInput(input, output, input_shape, output_shape, is_resize));
 
-  // special case with fast path
-  if (use_nearest2x_optimization && input_shape.NumDimensions() == 4 &&
-      scales[0] == 1 && scales[1] == 1 && scales[2] == 2 && scales[3] == 2) {
-    UpsampleNearest2x<T>(input_shape[0], input_shape[1], input_shape[2], input_shape[3], input, output);
-    return Status::OK();
+  // special case with fast path: integer factors on the spatial axes of an NCHW or NHWC tensor
+  if (input_shape.NumDimensions() == 4 && !extrapolation_enabled && scales[0] == 1 &&
+      (scales[1] == 1 || scales[3] == 1)) {
+    const bool is_nchw = scales[1] == 1;
+    const size_t height_axis = is_nchw ? 2 : 1;
+    const size_t width_axis = height_axis + 1;
+    const size_t rank = input_shape.NumDimensions();
+    int64_t height_factor = 0;
+    int64_t width_factor = 0;
+    bool is_integer_factor = false;
+    if (use_nearest2x_optimization && scales[height_axis] == 2 && scales[width_axis] == 2) {
+      height_factor = width_factor = 2;
+      is_integer_factor = true;
+    } else {
+      is_integer_factor =
+          IsIntegerFactorNearestMapping(input_shape[height_axis], output_shape[height_axis], scales[height_axis],
+                                        roi[height_axis], roi[rank + height_axis],
+                                        get_original_coordinate, get_nearest_pixel, height_factor) &&
+          IsIntegerFactorNearestMapping(input_shape[width_axis], output_shape[width_axis], scales[width_axis],
+                                        roi[width_axis], roi[rank + width_axis],
+                                        get_original_coordinate, get_nearest_pixel, width_factor);
+    }
+
+    if (is_integer_factor) {
+      UpsampleNearestIntegerFactor<T>(is_nchw, input_shape[0], is_nchw ? input_shape[1] : input_shape[3],
+                                      input_shape[height_axis], input_shape[width_axis],
+                                      height_factor, width_factor, input, output, tp);
+      return Status::OK();
+    }
   }
 
   return UpsampleNearestImpl(input, output, input_shape, output_shape, scales, roi,
@@ -1150,7 +1235,8 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
     case UpsampleMode::NN:
       return UpsampleNearest<T>(X->Data<T>(), Y->MutableData<T>(), X->Shape(), Y->Shape(),
                                 scales, roi, is_resize_, use_extrapolation_, static_cast<T>(extrapolation_value_),
-                                use_nearest2x_optimization_, get_original_coordinate_, get_nearest_pixel_);
+                                use_nearest2x_optimization_, get_original_coordinate_, get_nearest_pixel_,
+                                context->GetOperatorThreadPool());
     case UpsampleMode::LINEAR: {
       // Supports 'bilinear' and 'trilinear' sampling only
 
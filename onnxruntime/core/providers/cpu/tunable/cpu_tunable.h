@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+
+#include "core/framework/tunable.h"
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+// The CPU kernels run synchronously on the calling thread, so there is no native stream.
+using OpParams = OpParams<CpuTuningContext, void*>;
+
+template <typename ParamsT>
+using Op = Op<ParamsT>;
+
+class Timer : public ITimer<void*> {
+ public:
+  using TimerBase = ITimer<void*>;
+
+  explicit Timer(void* stream) : TimerBase(stream) {}
+
+  void Start() override { start_ = std::chrono::steady_clock::now(); }
+  void End() override { end_ = std::chrono::steady_clock::now(); }
+  float Duration() override {
+    return std::chrono::duration<float, std::milli>(end_ - start_).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point end_;
+};
+
+template <typename ParamsT>
+using TunableOp = TunableOp<ParamsT, Timer>;
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -3,7 +3,9 @@
 
 #include "cuda_allocator.h"
 #include "cuda_common.h"
+#include "cuda_weight_offload.h"
 #include "gpu_data_transfer.h"
+#include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
 
@@ -52,7 +54,88 @@ void* CUDAAllocator::Alloc(size_t size) {
 void CUDAAllocator::Free(void* p) {
   SetDevice(false);
   CheckDevice(false);  // ignore CUDA failure when free
-  cudaFree(p);         // do not throw error since it's OK for cudaFree to fail during shutdown
+  if (weight_offload_ && weight_offload_->Free(p)) {
+    return;
+  }
+  cudaFree(p);  // do not throw error since it's OK for cudaFree to fail during shutdown
+}
+
+void* CUDAAllocator::Reserve(size_t size) {
+  if (weight_offload_) {
+    void* p = weight_offload_->ReserveManaged(size);
+    if (p != nullptr) {
+      return p;
+    }
+  }
+  return Alloc(size);
+}
+
+CUDAMemPoolAllocator::CUDAMemPoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold)
+    : CUDAAllocator(device_id, name) {
+  CUDA_CALL_THROW(cudaDeviceGetDefaultMemPool(&pool_, device_id));
+  uint64_t threshold = release_threshold;
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool_, cudaMemPoolAttrReleaseThreshold, &threshold));
+}
+
+void* CUDAMemPoolAllocator::Alloc(size_t size) {
+  SetDevice(true);
+  CheckDevice(true);
+  void* p = nullptr;
+  if (size > 0) {
+    // not tied to a stream, so wait for the allocation to be usable on any stream
+    CUDA_CALL_THROW(cudaMallocFromPoolAsync(&p, size, pool_, nullptr));
+    CUDA_CALL_THROW(cudaStreamSynchronize(nullptr));
+  }
+  return p;
+}
+
+void* CUDAMemPoolAllocator::AllocStreamOrdered(size_t size, Stream* stream) {
+  SetDevice(true);
+  CheckDevice(true);
+  void* p = nullptr;
+  if (size > 0) {
+    CUDA_CALL_THROW(cudaMallocFromPoolAsync(&p, size, pool_, static_cast<cudaStream_t>(stream->GetHandle())));
+    std::lock_guard<OrtMutex> lock(lock_);
+    stream_allocations_[p] = stream;
+  }
+  return p;
+}
+
+void CUDAMemPoolAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  SetDevice(false);
+  CheckDevice(false);  // ignore CUDA failure when free
+  bool stream_ordered = false;
+  Stream* stream = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = stream_allocations_.find(p);
+    if (it != stream_allocations_.end()) {
+      stream_ordered = true;
+      stream = it->second;
+      stream_allocations_.erase(it);
+    }
+  }
+
+  if (stream_ordered) {
+    // the work using p is on `stream`, or done when the stream was released
+    cudaFreeAsync(p, stream ? static_cast<cudaStream_t>(stream->GetHandle()) : nullptr);
+  } else {
+    // p may be used by any stream, cudaFree waits for the device
+    cudaFree(p);
+  }
+}
+
+void CUDAMemPoolAllocator::ReleaseStreamOrderedBuffers(Stream* stream) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (auto& allocation : stream_allocations_) {
+    if (allocation.second == stream) {
+      allocation.second = nullptr;
+    }
+  }
 }
 
 void* CUDAExternalAllocator::Alloc(size_t size) {
@@ -3,25 +3,58 @@
 
 #pragma once
 
+#include <memory>
+
 #include "core/common/inlined_containers.h"
 #include "core/framework/allocator.h"
 #include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_pch.h"
 
 namespace onnxruntime {
 
+class CudaWeightOffload;
+
 class CUDAAllocator : public IAllocator {
  public:
-  CUDAAllocator(OrtDevice::DeviceId device_id, const char* name)
+  // With weight_offload, the buffers reserved for the weights that are large enough to be offloaded are allocated
+  // by it in managed memory.
+  CUDAAllocator(OrtDevice::DeviceId device_id, const char* name,
+                std::shared_ptr<CudaWeightOffload> weight_offload = nullptr)
       : IAllocator(
             OrtMemoryInfo(name, OrtAllocatorType::OrtDeviceAllocator,
                           OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, device_id),
-                          device_id, OrtMemTypeDefault)) {}
+                          device_id, OrtMemTypeDefault)),
+        weight_offload_(std::move(weight_offload)) {}
   void* Alloc(size_t size) override;
   void Free(void* p) override;
+  void* Reserve(size_t size) override;
 
  private:
   void CheckDevice(bool throw_when_fail) const;
   void SetDevice(bool throw_when_fail) const;
+
+  std::shared_ptr<CudaWeightOffload> weight_offload_;
+};
+
+// Allocates from the default CUDA memory pool of the device with cudaMallocFromPoolAsync. Memory allocated for a stream
+// is freed in the order of the work on it, so the driver reuses it across streams and across the sessions on the
+// device, and returns it to the system above the release threshold. Used in place of the arena.
+class CUDAMemPoolAllocator : public CUDAAllocator {
+ public:
+  CUDAMemPoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold);
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  bool IsStreamOrdered() const override { return true; }
+  void* AllocStreamOrdered(size_t size, Stream* stream) override;
+  void ReleaseStreamOrderedBuffers(Stream* stream) override;
+
+ private:
+  cudaMemPool_t pool_{nullptr};
+  mutable OrtMutex lock_;
+  // the stream each allocation is freed on, nullptr once the work of the stream is done
+  InlinedHashMap<void*, Stream*> stream_allocations_;
 };
 
 class CUDAExternalAllocator : public CUDAAllocator {
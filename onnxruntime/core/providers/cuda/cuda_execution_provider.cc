@@ -12,6 +12,7 @@
 #include "core/providers/cuda/cuda_fwd.h"
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "core/providers/cuda/cuda_profiler.h"
+#include "core/providers/cuda/cuda_weight_offload.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
 
 #ifndef USE_CUDA_MINIMAL
@@ -310,6 +311,14 @@ CUDAExecutionProvider::CUDAExecutionProvider(const CUDAExecutionProviderInfo& in
 
   OverrideTunableOpInfoByEnv(info_);
 
+  if (info_.weight_offload_min_bytes > 0) {
+    ORT_ENFORCE(!info_.enable_cuda_graph, "Weight offload cannot be used with CUDA graph");
+    ORT_ENFORCE(!info_.use_mem_pool && !info_.external_allocator_info.UseExternalAllocator(),
+                "Weight offload requires the default CUDA allocator");
+    weight_offload_ = std::make_shared<CudaWeightOffload>(info_.device_id, info_.weight_offload_min_bytes,
+                                                          info_.weight_offload_device_budget);
+  }
+
 #ifdef USE_TRITON_KERNEL
   onnxruntime::cuda::LoadOrtTritonKernel();
 #endif
@@ -2608,6 +2617,42 @@ std::vector<AllocatorPtr> CUDAExecutionProvider::CreatePreferredAllocators() {
       // correct to use the GPU device id, unless we wanted to share the pinned memory allocator across devices,
       // at the risk the lifetime isn't managed correctly if one of those devices go away.
       0);
+  if (info_.use_mem_pool && !info_.external_allocator_info.UseExternalAllocator()) {
+    const size_t release_threshold = info_.mem_pool_release_threshold;
+    AllocatorCreationInfo mem_pool_info(
+        [release_threshold](OrtDevice::DeviceId id) {
+          return std::make_unique<CUDAMemPoolAllocator>(id, CUDA, release_threshold);
+        },
+        info_.device_id,
+        false);
+    return std::vector<AllocatorPtr>{
+        CreateAllocator(mem_pool_info),
+        CreateAllocator(pinned_memory_info),
+    };
+  }
+
+  if (weight_offload_) {
+    // same arena as CreateCudaAllocator, with the weights reserved by the device allocator kept in host memory
+    auto weight_offload = weight_offload_;
+    AllocatorCreationInfo default_memory_info(
+        [weight_offload](OrtDevice::DeviceId id) {
+          return std::make_unique<CUDAAllocator>(id, CUDA, weight_offload);
+        },
+        info_.device_id,
+        true,
+        {info_.default_memory_arena_cfg ? *info_.default_memory_arena_cfg
+                                        : OrtArenaCfg(info_.gpu_mem_limit, static_cast<int>(info_.arena_extend_strategy),
+                                                      -1, -1, -1, -1L)},
+        // make it stream aware
+        true,
+        // enable cross stream sharing?
+        false);
+    return std::vector<AllocatorPtr>{
+        CreateAllocator(default_memory_info),
+        CreateAllocator(pinned_memory_info),
+    };
+  }
+
   return std::vector<AllocatorPtr>{
       CreateCudaAllocator(info_.device_id, info_.gpu_mem_limit, info_.arena_extend_strategy,
                           info_.external_allocator_info, info_.default_memory_arena_cfg),
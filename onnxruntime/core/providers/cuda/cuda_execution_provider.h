@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <vector>
 
@@ -21,6 +22,8 @@ namespace onnxruntime {
 
 void RunOnUnload(std::function<void()> function);
 
+class CudaWeightOffload;
+
 // Logical device representation.
 class CUDAExecutionProvider : public IExecutionProvider {
  public:
@@ -79,6 +82,7 @@ class CUDAExecutionProvider : public IExecutionProvider {
   bool IsSkipLayerNormInStrictMode() const { return info_.enable_skip_layer_norm_strict_mode; }
   bool IsNHWCPreferred() const { return info_.prefer_nhwc; }
   bool UseTF32() const { return info_.use_tf32; }
+  CudaWeightOffload* GetWeightOffload() const { return weight_offload_.get(); }
 
   ProviderOptions GetProviderOptions() const override {
     return CUDAExecutionProviderInfo::ToProviderOptions(info_);
@@ -107,6 +111,9 @@ class CUDAExecutionProvider : public IExecutionProvider {
 
   bool use_ep_level_unified_stream_ = false;
 
+  // set when the weights of at least weight_offload_min_bytes are kept in host memory
+  std::shared_ptr<CudaWeightOffload> weight_offload_;
+
   // the tuning context might be altered when calling into a TunableOp
   mutable cuda::tunable::CudaTuningContext tuning_context_;
 
@@ -34,6 +34,10 @@ constexpr const char* kEnableSkipLayerNormStrictMode = "enable_skip_layer_norm_s
 constexpr const char* kPreferNHWCMode = "prefer_nhwc";
 constexpr const char* kUseEPLevelUnifiedStream = "use_ep_level_unified_stream";
 constexpr const char* kUseTF32 = "use_tf32";
+constexpr const char* kUseMemPool = "use_mem_pool";
+constexpr const char* kMemPoolReleaseThreshold = "mem_pool_release_threshold";
+constexpr const char* kWeightOffloadMinBytes = "weight_offload_min_bytes";
+constexpr const char* kWeightOffloadDeviceBudget = "weight_offload_device_budget";
 
 }  // namespace provider_option_names
 }  // namespace cuda
@@ -117,6 +121,12 @@ CUDAExecutionProviderInfo CUDAExecutionProviderInfo::FromProviderOptions(const P
           .AddAssignmentToReference(cuda::provider_option_names::kPreferNHWCMode, info.prefer_nhwc)
           .AddAssignmentToReference(cuda::provider_option_names::kUseEPLevelUnifiedStream, info.use_ep_level_unified_stream)
           .AddAssignmentToReference(cuda::provider_option_names::kUseTF32, info.use_tf32)
+          .AddAssignmentToReference(cuda::provider_option_names::kUseMemPool, info.use_mem_pool)
+          .AddAssignmentToReference(cuda::provider_option_names::kMemPoolReleaseThreshold,
+                                    info.mem_pool_release_threshold)
+          .AddAssignmentToReference(cuda::provider_option_names::kWeightOffloadMinBytes, info.weight_offload_min_bytes)
+          .AddAssignmentToReference(cuda::provider_option_names::kWeightOffloadDeviceBudget,
+                                    info.weight_offload_device_budget)
           .AddValueParser(
               cuda::provider_option_names::kTunableOpEnable,
               [&info](const std::string& value_str) -> Status {
@@ -170,6 +180,10 @@ ProviderOptions CUDAExecutionProviderInfo::ToProviderOptions(const CUDAExecution
       {cuda::provider_option_names::kPreferNHWCMode, MakeStringWithClassicLocale(info.prefer_nhwc)},
       {cuda::provider_option_names::kUseEPLevelUnifiedStream, MakeStringWithClassicLocale(info.use_ep_level_unified_stream)},
       {cuda::provider_option_names::kUseTF32, MakeStringWithClassicLocale(info.use_tf32)},
+      {cuda::provider_option_names::kUseMemPool, MakeStringWithClassicLocale(info.use_mem_pool)},
+      {cuda::provider_option_names::kMemPoolReleaseThreshold, MakeStringWithClassicLocale(info.mem_pool_release_threshold)},
+      {cuda::provider_option_names::kWeightOffloadMinBytes, MakeStringWithClassicLocale(info.weight_offload_min_bytes)},
+      {cuda::provider_option_names::kWeightOffloadDeviceBudget, MakeStringWithClassicLocale(info.weight_offload_device_budget)},
   };
 
   return options;
@@ -192,6 +206,10 @@ ProviderOptions CUDAExecutionProviderInfo::ToProviderOptions(const OrtCUDAProvid
       {cuda::provider_option_names::kPreferNHWCMode, MakeStringWithClassicLocale(info.prefer_nhwc)},
       {cuda::provider_option_names::kUseEPLevelUnifiedStream, MakeStringWithClassicLocale(info.use_ep_level_unified_stream)},
       {cuda::provider_option_names::kUseTF32, MakeStringWithClassicLocale(info.use_tf32)},
+      {cuda::provider_option_names::kUseMemPool, MakeStringWithClassicLocale(info.use_mem_pool)},
+      {cuda::provider_option_names::kMemPoolReleaseThreshold, MakeStringWithClassicLocale(info.mem_pool_release_threshold)},
+      {cuda::provider_option_names::kWeightOffloadMinBytes, MakeStringWithClassicLocale(info.weight_offload_min_bytes)},
+      {cuda::provider_option_names::kWeightOffloadDeviceBudget, MakeStringWithClassicLocale(info.weight_offload_device_budget)},
   };
 
   return options;
@@ -79,6 +79,18 @@ struct CUDAExecutionProviderInfo {
   // By default, enable TF32 to speed up float GEMM/MatMul or cuDNN convolution of float matrices.
   bool use_tf32{true};
 
+  // Allocate device memory from the default CUDA memory pool of the device (cudaMallocFromPoolAsync) instead of the
+  // BFC arena. The pool is shared with the other sessions on the device, and memory above the release threshold is
+  // returned to the system when the streams synchronize.
+  bool use_mem_pool{false};
+  size_t mem_pool_release_threshold{std::numeric_limits<size_t>::max()};
+
+  // Keep the weights of at least weight_offload_min_bytes in CUDA managed memory resident on the host, and prefetch
+  // them to the device on a side stream ahead of the kernels using them. At most weight_offload_device_budget bytes of
+  // them are kept on the device, the least recently used ones are moved back to the host. 0 disables the offload.
+  size_t weight_offload_min_bytes{0};
+  size_t weight_offload_device_budget{std::numeric_limits<size_t>::max()};
+
   static CUDAExecutionProviderInfo FromProviderOptions(const ProviderOptions& options);
   static ProviderOptions ToProviderOptions(const CUDAExecutionProviderInfo& info);
   static ProviderOptions ToProviderOptions(const OrtCUDAProviderOptionsV2& info);
@@ -104,11 +116,15 @@ struct std::hash<::onnxruntime::CUDAExecutionProviderInfo> {
                   (static_cast<size_t>(info.enable_skip_layer_norm_strict_mode) << 27) ^
                   (static_cast<size_t>(info.prefer_nhwc) << 28) ^
                   (static_cast<size_t>(info.use_ep_level_unified_stream) << 29) ^
-                  (static_cast<size_t>(info.use_tf32) << 30);
+                  (static_cast<size_t>(info.use_tf32) << 30) ^
+                  (static_cast<size_t>(info.use_mem_pool) << 31);
     onnxruntime::HashCombine(data, value);
 
     onnxruntime::HashCombine(info.gpu_mem_limit, value);
     onnxruntime::HashCombine(info.tunable_op.max_tuning_duration_ms, value);
+    onnxruntime::HashCombine(info.mem_pool_release_threshold, value);
+    onnxruntime::HashCombine(info.weight_offload_min_bytes, value);
+    onnxruntime::HashCombine(info.weight_offload_device_budget, value);
 
     // Memory pointers
     onnxruntime::HashCombine(reinterpret_cast<size_t>(info.user_compute_stream), value);
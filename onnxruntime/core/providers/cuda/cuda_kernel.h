@@ -8,6 +8,7 @@
 #include "core/providers/cuda/cuda_fwd.h"
 #include "core/platform/ort_mutex.h"
 #include "core/providers/cuda/cuda_stream_handle.h"
+#include "core/providers/cuda/cuda_weight_offload.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -24,6 +25,9 @@ class CudaKernel : public OpKernel {
   }
 
   Status Compute(OpKernelContext* p_op_kernel_context) const override {
+    if (auto* weight_offload = provider_->GetWeightOffload()) {
+      weight_offload->PrepareInputs(*p_op_kernel_context, Stream(p_op_kernel_context));
+    }
     auto s = ComputeInternal(p_op_kernel_context);
     // use this to precisely locate the node where CUDA failure comes from
     //  if (cudaSuccess != cudaDeviceSynchronize())
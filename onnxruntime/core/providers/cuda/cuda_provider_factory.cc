@@ -226,6 +226,10 @@ struct CUDA_Provider : Provider {
     info.enable_skip_layer_norm_strict_mode = params->enable_skip_layer_norm_strict_mode != 0;
     info.use_ep_level_unified_stream = params->use_ep_level_unified_stream != 0;
     info.use_tf32 = params->use_tf32 != 0;
+    info.use_mem_pool = params->use_mem_pool != 0;
+    info.mem_pool_release_threshold = params->mem_pool_release_threshold;
+    info.weight_offload_min_bytes = params->weight_offload_min_bytes;
+    info.weight_offload_device_budget = params->weight_offload_device_budget;
 
     return std::make_shared<CUDAProviderFactory>(info);
   }
@@ -260,6 +264,10 @@ struct CUDA_Provider : Provider {
     cuda_options.prefer_nhwc = internal_options.prefer_nhwc;
     cuda_options.use_ep_level_unified_stream = internal_options.use_ep_level_unified_stream;
     cuda_options.use_tf32 = internal_options.use_tf32;
+    cuda_options.use_mem_pool = internal_options.use_mem_pool;
+    cuda_options.mem_pool_release_threshold = internal_options.mem_pool_release_threshold;
+    cuda_options.weight_offload_min_bytes = internal_options.weight_offload_min_bytes;
+    cuda_options.weight_offload_device_budget = internal_options.weight_offload_device_budget;
   }
 
   ProviderOptions GetProviderOptions(const void* provider_options) override {
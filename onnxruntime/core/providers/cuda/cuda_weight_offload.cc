@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/cuda_weight_offload.h"
+
+#include <algorithm>
+
+#include "core/providers/cuda/cuda_common.h"
+
+namespace onnxruntime {
+
+CudaWeightOffload::CudaWeightOffload(int device_id, size_t min_bytes, size_t device_budget)
+    : device_id_(device_id), min_bytes_(min_bytes), device_budget_(device_budget) {
+  ORT_ENFORCE(min_bytes_ > 0, "The minimum size of the offloaded weights must be greater than 0");
+  int managed_memory = 0;
+  CUDA_CALL_THROW(cudaDeviceGetAttribute(&managed_memory, cudaDevAttrConcurrentManagedAccess, device_id_));
+  ORT_ENFORCE(managed_memory != 0, "Weight offload requires a device with concurrent managed memory access");
+  CUDA_CALL_THROW(cudaSetDevice(device_id_));
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&prefetch_stream_, cudaStreamNonBlocking));
+}
+
+CudaWeightOffload::~CudaWeightOffload() {
+  // do not throw errors since it's OK for the calls to fail during shutdown
+  for (auto& it : weights_) {
+    if (it.second.ready) {
+      cudaEventDestroy(it.second.ready);
+    }
+  }
+  if (prefetch_stream_) {
+    cudaStreamDestroy(prefetch_stream_);
+  }
+}
+
+void* CudaWeightOffload::ReserveManaged(size_t size) {
+  if (size < min_bytes_) {
+    return nullptr;
+  }
+
+  CUDA_CALL_THROW(cudaSetDevice(device_id_));
+  void* p = nullptr;
+  CUDA_CALL_THROW(cudaMallocManaged(&p, size, cudaMemAttachGlobal));
+  // the pages stay on the host unless they are prefetched, and the device maps them instead of faulting them in
+  CUDA_CALL_THROW(cudaMemAdvise(p, size, cudaMemAdviseSetPreferredLocation, cudaCpuDeviceId));
+  CUDA_CALL_THROW(cudaMemAdvise(p, size, cudaMemAdviseSetAccessedBy, device_id_));
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  blocks_.emplace(static_cast<const char*>(p), size);
+  return p;
+}
+
+bool CudaWeightOffload::Free(void* p) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto block = blocks_.find(static_cast<const char*>(p));
+    if (block == blocks_.end()) {
+      return false;
+    }
+    const char* end = block->first + block->second;
+    for (auto it = weights_.begin(); it != weights_.end();) {
+      if (it->first >= block->first && it->first < end) {
+        if (it->second.resident) {
+          lru_.erase(it->second.lru_it);
+          resident_bytes_ -= it->second.size;
+        }
+        cudaEventDestroy(it->second.ready);
+        it = weights_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    use_order_.erase(std::remove_if(use_order_.begin(), use_order_.end(),
+                                    [&](const char* data) { return data >= block->first && data < end; }),
+                     use_order_.end());
+    use_index_.clear();
+    for (size_t i = 0; i < use_order_.size(); ++i) {
+      use_index_[use_order_[i]] = i;
+    }
+    blocks_.erase(block);
+  }
+
+  cudaFree(p);  // do not throw error since it's OK for cudaFree to fail during shutdown
+  return true;
+}
+
+bool CudaWeightOffload::IsManaged(const void* p) const {
+  const char* data = static_cast<const char*>(p);
+  auto it = blocks_.upper_bound(data);
+  if (it == blocks_.begin()) {
+    return false;
+  }
+  --it;
+  return data < it->first + it->second;
+}
+
+void CudaWeightOffload::PrepareInputs(const OpKernelContext& context, cudaStream_t stream) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (blocks_.empty()) {
+    return;
+  }
+
+  const int input_count = context.InputCount();
+  for (int i = 0; i < input_count; ++i) {
+    auto type = context.InputType(i);
+    if (type == nullptr || !type->IsTensorType()) {
+      continue;
+    }
+    const Tensor* tensor = context.Input<Tensor>(i);
+    if (tensor == nullptr || tensor->SizeInBytes() == 0 || !IsManaged(tensor->DataRaw())) {
+      continue;
+    }
+    Use(static_cast<const char*>(tensor->DataRaw()), tensor->SizeInBytes(), stream);
+  }
+}
+
+void CudaWeightOffload::Use(const char* data, size_t size, cudaStream_t stream) {
+  auto it = weights_.find(data);
+  if (it == weights_.end()) {
+    it = weights_.emplace(data, Weight{size}).first;
+    CUDA_CALL_THROW(cudaEventCreateWithFlags(&it->second.ready, cudaEventDisableTiming));
+    use_index_[data] = use_order_.size();
+    use_order_.push_back(data);
+  }
+  Weight& weight = it->second;
+
+  if (weight.resident) {
+    lru_.splice(lru_.begin(), lru_, weight.lru_it);
+  } else {
+    Prefetch(data, weight, true);
+  }
+  if (weight.resident) {
+    CUDA_CALL_THROW(cudaStreamWaitEvent(stream, weight.ready, 0));
+  }
+  weight.last_stream = stream;
+
+  // prefetch the weights used next while this kernel and the ones before it run
+  const size_t index = use_index_[data];
+  const size_t lookahead = std::min(kLookahead, use_order_.size() - 1);
+  for (size_t k = 1; k <= lookahead; ++k) {
+    const char* next = use_order_[(index + k) % use_order_.size()];
+    Weight& next_weight = weights_.at(next);
+    if (!next_weight.resident) {
+      Prefetch(next, next_weight, false);
+    }
+  }
+}
+
+void CudaWeightOffload::Prefetch(const char* data, Weight& weight, bool current) {
+  // a weight larger than the budget is read from the host by the kernels
+  if (weight.size > device_budget_) {
+    return;
+  }
+  // the weight of the current kernel is at the front of lru_ and the weights prefetched ahead are right after it,
+  // so that making room for them never evicts the weight of the current kernel
+  Evict(weight.size, current ? 0 : 1);
+
+  CUDA_CALL_THROW(cudaMemPrefetchAsync(data, weight.size, device_id_, prefetch_stream_));
+  CUDA_CALL_THROW(cudaEventRecord(weight.ready, prefetch_stream_));
+  weight.resident = true;
+  resident_bytes_ += weight.size;
+  weight.lru_it = lru_.insert(current || lru_.empty() ? lru_.begin() : std::next(lru_.begin()), data);
+}
+
+void CudaWeightOffload::Evict(size_t required_bytes, size_t num_kept) {
+  while (resident_bytes_ + required_bytes > device_budget_ && lru_.size() > num_kept) {
+    const char* data = lru_.back();
+    Weight& weight = weights_.at(data);
+    // move the weight back to the host once the kernels that used it are done
+    if (weight.last_stream != nullptr) {
+      CUDA_CALL_THROW(cudaEventRecord(weight.ready, weight.last_stream));
+      CUDA_CALL_THROW(cudaStreamWaitEvent(prefetch_stream_, weight.ready, 0));
+    }
+    CUDA_CALL_THROW(cudaMemPrefetchAsync(data, weight.size, cudaCpuDeviceId, prefetch_stream_));
+    weight.resident = false;
+    resident_bytes_ -= weight.size;
+    lru_.pop_back();
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "core/providers/shared_library/provider_api.h"
+#include "core/common/inlined_containers.h"
+#include "core/platform/ort_mutex.h"
+#include "core/providers/cuda/cuda_pch.h"
+
+namespace onnxruntime {
+
+// Keeps the weights of a CUDA EP that are too large for the device in CUDA managed memory resident on the host.
+//
+// The buffers reserved for the weights (initializers) of at least min_bytes are allocated with cudaMallocManaged and
+// advised to stay on the host, so that the device only accesses them over the interconnect. When a kernel gets one
+// of the weights as an input, the weight is prefetched to the device on a side stream and the compute stream waits
+// for the prefetch. The weights used next, in the order of their first use, are prefetched ahead of the kernels
+// using them, so that copying the weights of the next layers overlaps with the compute of the current one.
+// At most device_budget bytes of weights are kept on the device, the least recently used ones are moved back to
+// the host once the kernels using them are done.
+//
+// Prefetching only changes where the pages of the weights are, the weights stay valid on both the host and the
+// device, so the offload does not change the results of the kernels.
+class CudaWeightOffload {
+ public:
+  CudaWeightOffload(int device_id, size_t min_bytes, size_t device_budget);
+  ~CudaWeightOffload();
+
+  // Allocate a buffer of managed memory resident on the host, nullptr if size is below the offload threshold.
+  void* ReserveManaged(size_t size);
+
+  // Free p if it was allocated by ReserveManaged. Returns false otherwise.
+  bool Free(void* p);
+
+  // Make the weights among the inputs of the kernel resident on the device before the work enqueued on stream.
+  void PrepareInputs(const OpKernelContext& context, cudaStream_t stream);
+
+ private:
+  struct Weight {
+    size_t size;
+    bool resident{false};
+    cudaEvent_t ready{nullptr};
+    cudaStream_t last_stream{nullptr};
+    // position in lru_ when resident
+    std::list<const char*>::iterator lru_it;
+  };
+
+  // number of weights prefetched ahead in the order of first use
+  static constexpr size_t kLookahead = 2;
+
+  bool IsManaged(const void* p) const;
+  void Use(const char* data, size_t size, cudaStream_t stream);
+  // current is true for the weight of the kernel being prepared, false for a weight prefetched ahead
+  void Prefetch(const char* data, Weight& weight, bool current);
+  // move the least recently used weights to the host, keeping the num_kept most recently used ones
+  void Evict(size_t required_bytes, size_t num_kept);
+
+  const int device_id_;
+  const size_t min_bytes_;
+  const size_t device_budget_;
+  cudaStream_t prefetch_stream_{nullptr};
+
+  mutable OrtMutex mutex_;
+  // managed buffers by address, with their sizes
+  std::map<const char*, size_t> blocks_;
+  InlinedHashMap<const char*, Weight> weights_;
+  std::vector<const char*> use_order_;
+  InlinedHashMap<const char*, size_t> use_index_;
+  // resident weights, most recently used first
+  std::list<const char*> lru_;
+  size_t resident_bytes_{0};
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CudaWeightOffload);
+};
+
+}  // namespace onnxruntime
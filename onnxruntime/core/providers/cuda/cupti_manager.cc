@@ -92,6 +92,35 @@ uint64_t CUPTIManager::GetGPUTimestampInNanoseconds() {
 void CUPTIManager::ProcessActivityBuffers(const std::vector<ProfilerActivityBuffer>& buffers,
                                           const TimePoint& start_time) {
   auto start_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start_time.time_since_epoch()).count();
+  auto to_profiler_us = [this, start_time_ns](uint64_t gpu_timestamp) {
+    return (static_cast<int64_t>(NormalizeGPUTimestampToCPUEpoch(gpu_timestamp)) - start_time_ns) / 1000;
+  };
+
+  // The runtime API calls which launched the kernels and copies, keyed on their correlation id, to report the launch
+  // overhead of each kernel. The API record of a launch precedes its kernel record but may be in another buffer.
+  InlinedHashMap<uint32_t, std::pair<uint64_t, uint64_t>> api_calls;
+  for (auto const& buffer : buffers) {
+    CUpti_Activity* record = nullptr;
+    auto* data = reinterpret_cast<uint8_t*>(const_cast<char*>(buffer.GetData()));
+    while (buffer.GetSize() != 0 && cuptiActivityGetNextRecord(data, buffer.GetSize(), &record) == CUPTI_SUCCESS) {
+      if (CUPTI_ACTIVITY_KIND_RUNTIME == record->kind) {
+        auto api = reinterpret_cast<const CUpti_ActivityAPI*>(record);
+        api_calls[api->correlationId] = std::make_pair(api->start, api->end);
+      }
+    }
+  }
+
+  auto add_launch_args = [&api_calls](uint32_t correlation_id, uint64_t start,
+                                      std::unordered_map<std::string, std::string>& args) {
+    auto it = api_calls.find(correlation_id);
+    if (it != api_calls.end()) {
+      // the duration of the API call on the host, and the delay from the call to the start on the device
+      args["launch_dur"] = std::to_string((it->second.second - it->second.first) / 1000);
+      args["launch_delay"] = std::to_string((static_cast<int64_t>(start) - static_cast<int64_t>(it->second.first)) /
+                                            1000);
+    }
+  };
+
   for (auto const& buffer : buffers) {
     auto size = buffer.GetSize();
     if (size == 0) {
@@ -107,6 +136,7 @@ void CUPTIManager::ProcessActivityBuffers(const std::vector<ProfilerActivityBuff
             CUPTI_ACTIVITY_KIND_KERNEL == record->kind) {
           CUpti_ActivityKernel3* kernel = (CUpti_ActivityKernel3*)record;
           std::unordered_map<std::string, std::string> args{
+              {"kind", kGPUKernelEventKind},
               {"stream", std::to_string(kernel->streamId)},
               {"grid_x", std::to_string(kernel->gridX)},
               {"grid_y", std::to_string(kernel->gridY)},
@@ -115,6 +145,7 @@ void CUPTIManager::ProcessActivityBuffers(const std::vector<ProfilerActivityBuff
               {"block_y", std::to_string(kernel->blockY)},
               {"block_z", std::to_string(kernel->blockZ)},
           };
+          add_launch_args(kernel->correlationId, kernel->start, args);
 
           std::string name{demangle(kernel->name)};
 
@@ -123,7 +154,7 @@ void CUPTIManager::ProcessActivityBuffers(const std::vector<ProfilerActivityBuff
               /* pid = */ -1,
               /* tid = */ -1,
               /* name = */ std::move(name),
-              /* ts = */ (int64_t)(kernel->start - start_time_ns) / 1000,
+              /* ts = */ to_profiler_us(kernel->start),
               /* dur = */ (int64_t)(kernel->end - kernel->start) / 1000,
               /* args = */ std::move(args)};
           MapEventToClient(kernel->correlationId, std::move(event));
@@ -131,7 +162,9 @@ void CUPTIManager::ProcessActivityBuffers(const std::vector<ProfilerActivityBuff
           CUpti_ActivityMemcpy* mmcpy = (CUpti_ActivityMemcpy*)record;
           std::string name{GetMemcpyKindString((CUpti_ActivityMemcpyKind)mmcpy->copyKind)};
           std::unordered_map<std::string, std::string> args{
+              {"kind", kGPUMemcpyEventKind},
               {"stream", std::to_string(mmcpy->streamId)},
+              {"bytes", std::to_string(mmcpy->bytes)},
               {"grid_x", "-1"},
               {"grid_y", "-1"},
               {"grid_z", "-1"},
@@ -139,12 +172,13 @@ void CUPTIManager::ProcessActivityBuffers(const std::vector<ProfilerActivityBuff
               {"block_y", "-1"},
               {"block_z", "-1"},
           };
+          add_launch_args(mmcpy->correlationId, mmcpy->start, args);
           new (&event) EventRecord{
               /* cat = */ EventCategory::KERNEL_EVENT,
               /* pid = */ -1,
               /* tid = */ -1,
               /* name = */ std::move(name),
-              /* ts = */ (int64_t)(this->NormalizeGPUTimestampToCPUEpoch(mmcpy->start) - start_time_ns) / 1000,
+              /* ts = */ to_profiler_us(mmcpy->start),
               /* dur = */ (int64_t)(mmcpy->end - mmcpy->start) / 1000,
               /* args = */ std::move(args)};
           MapEventToClient(mmcpy->correlationId, std::move(event));
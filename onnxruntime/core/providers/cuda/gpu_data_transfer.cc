@@ -6,10 +6,25 @@
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "cuda_common.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace onnxruntime {
+namespace {
+// Copies from pageable memory below this size are left to the driver.
+constexpr size_t kMinStagedCopyBytes = 256 * 1024;
+constexpr size_t kStagingBufferBytes = 4 * 1024 * 1024;
+constexpr size_t kMaxStagingBuffers = 8;
+}  // namespace
+
 GPUDataTransfer::GPUDataTransfer() {}
 
-GPUDataTransfer::~GPUDataTransfer() {}
+GPUDataTransfer::~GPUDataTransfer() {
+  for (const auto& buffer : staging_buffers_) {
+    ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaEventDestroy(buffer.event)));
+    ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaFreeHost(buffer.data)));
+  }
+}
 
 bool GPUDataTransfer::CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const {
   return src_device.Type() == OrtDevice::GPU || src_device.MemType() == OrtDevice::MemType::CUDA_PINNED ||
@@ -59,8 +74,14 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
 
   if (dst_device.Type() == OrtDevice::GPU) {
     if (src_device.Type() == OrtDevice::CPU) {
-      // copy from pinned memory to GPU, this is non-blocking
-      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, static_cast<cudaStream_t>(stream.GetHandle())));
+      if (src_device.MemType() == OrtDevice::MemType::DEFAULT && bytes >= kMinStagedCopyBytes) {
+        // copy from pageable memory to GPU through pinned staging buffers, this is non-blocking
+        ORT_RETURN_IF_ERROR(CopyPageableToDeviceAsync(src_data, dst_data, bytes,
+                                                      static_cast<cudaStream_t>(stream.GetHandle())));
+      } else {
+        // copy from pinned memory to GPU, this is non-blocking
+        CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_data, src_data, bytes, cudaMemcpyHostToDevice, static_cast<cudaStream_t>(stream.GetHandle())));
+      }
     } else if (src_device.Type() == OrtDevice::GPU) {
       // copying between GPU, this is non-blocking
       if (dst_data != src_data) {
@@ -83,4 +104,97 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
   return Status::OK();
 }
 
+common::Status GPUDataTransfer::CopyPageableToDeviceAsync(const void* src, void* dst, size_t bytes,
+                                                          cudaStream_t stream) const {
+  const auto* src_bytes = static_cast<const uint8_t*>(src);
+  auto* dst_bytes = static_cast<uint8_t*>(dst);
+  for (size_t offset = 0; offset < bytes; offset += kStagingBufferBytes) {
+    const size_t chunk_bytes = std::min(kStagingBufferBytes, bytes - offset);
+    StagingBuffer buffer;
+    ORT_RETURN_IF_ERROR(AcquireStagingBuffer(buffer));
+    if (buffer.data == nullptr) {
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(dst_bytes + offset, src_bytes + offset, bytes - offset,
+                                           cudaMemcpyHostToDevice, stream));
+      break;
+    }
+
+    memcpy(buffer.data, src_bytes + offset, chunk_bytes);
+    auto status = CUDA_CALL(cudaMemcpyAsync(dst_bytes + offset, buffer.data, chunk_bytes, cudaMemcpyHostToDevice,
+                                            stream));
+    if (status.IsOK()) {
+      status = CUDA_CALL(cudaEventRecord(buffer.event, stream));
+    }
+    if (!status.IsOK()) {
+      // the buffer may still be read by the failed transfer, so it is dropped rather than reused
+      std::lock_guard<std::mutex> lock(staging_mutex_);
+      --num_staging_buffers_;
+      return status;
+    }
+    ReleaseStagingBuffer(buffer);
+  }
+
+  return Status::OK();
+}
+
+common::Status GPUDataTransfer::AcquireStagingBuffer(StagingBuffer& buffer) const {
+  int device_id = 0;
+  CUDA_RETURN_IF_ERROR(cudaGetDevice(&device_id));
+
+  std::unique_lock<std::mutex> lock(staging_mutex_);
+  auto oldest = staging_buffers_.end();
+  for (auto it = staging_buffers_.begin(); it != staging_buffers_.end(); ++it) {
+    if (it->device_id != device_id) {
+      continue;
+    }
+    if (cudaEventQuery(it->event) == cudaSuccess) {
+      buffer = *it;
+      staging_buffers_.erase(it);
+      return Status::OK();
+    }
+    if (oldest == staging_buffers_.end()) {
+      oldest = it;
+    }
+  }
+
+  if (num_staging_buffers_ < kMaxStagingBuffers) {
+    ++num_staging_buffers_;
+    lock.unlock();
+    buffer.device_id = device_id;
+    if (cudaHostAlloc(&buffer.data, kStagingBufferBytes, cudaHostAllocPortable) == cudaSuccess &&
+        cudaEventCreateWithFlags(&buffer.event, cudaEventDisableTiming) == cudaSuccess) {
+      return Status::OK();
+    }
+
+    // out of pinned memory, copy without staging
+    if (buffer.data != nullptr) {
+      ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaFreeHost(buffer.data)));
+    }
+    buffer = StagingBuffer{};
+    static_cast<void>(cudaGetLastError());
+    lock.lock();
+    --num_staging_buffers_;
+    return Status::OK();
+  }
+
+  if (oldest == staging_buffers_.end()) {
+    // all the buffers belong to other devices
+    return Status::OK();
+  }
+
+  // wait for the oldest transfer of this device
+  buffer = *oldest;
+  staging_buffers_.erase(oldest);
+  lock.unlock();
+  auto status = CUDA_CALL(cudaEventSynchronize(buffer.event));
+  if (!status.IsOK()) {
+    ReleaseStagingBuffer(buffer);
+  }
+  return status;
+}
+
+void GPUDataTransfer::ReleaseStagingBuffer(const StagingBuffer& buffer) const {
+  std::lock_guard<std::mutex> lock(staging_mutex_);
+  staging_buffers_.push_back(buffer);
+}
+
 }  // namespace onnxruntime
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 #include "cuda_pch.h"
 #include "core/framework/data_transfer.h"
 
@@ -19,6 +22,28 @@ class GPUDataTransfer : public IDataTransfer {
   using IDataTransfer::CopyTensor;
   common::Status CopyTensor(const Tensor& src, Tensor& dst) const override;
   common::Status CopyTensorAsync(const Tensor& src, Tensor& dst, Stream& stream) const override;
+
+ private:
+  // A pinned host buffer used to stage copies from pageable memory. The event is recorded after the transfer that
+  // reads the buffer, so the buffer can be reused once the event completes.
+  struct StagingBuffer {
+    void* data{nullptr};
+    cudaEvent_t event{nullptr};
+    int device_id{-1};
+  };
+
+  // Copies pageable host memory to the GPU chunk by chunk through the staging buffers. The host copy of a chunk
+  // overlaps the transfer of the previous one, and the call returns without waiting for the last transfer.
+  common::Status CopyPageableToDeviceAsync(const void* src, void* dst, size_t bytes, cudaStream_t stream) const;
+
+  // Returns a staging buffer of the current device that is not read by a pending transfer, or a buffer with a null
+  // data pointer when none can be allocated.
+  common::Status AcquireStagingBuffer(StagingBuffer& buffer) const;
+  void ReleaseStagingBuffer(const StagingBuffer& buffer) const;
+
+  mutable std::mutex staging_mutex_;
+  mutable std::vector<StagingBuffer> staging_buffers_;  // the buffers not held by a copy, oldest first
+  mutable size_t num_staging_buffers_{0};
 };
 
 }  // namespace onnxruntime
@@ -62,27 +62,45 @@ namespace Dml
             }
         }
 
+        // A graph compiled for a set of input shapes (and CPU input values), with the command lists recorded for it.
+        struct CompiledGraph
+        {
+            ComPtr<IDMLCompiledOperator> compiledExecutionPlanOperator;
+            std::optional<DML_BUFFER_BINDING> persistentResourceBinding;
+            ComPtr<ID3D12Resource> persistentResource;
+            ComPtr<IUnknown> persistentResourceAllocatorUnknown; // Controls when the persistent resource is returned to the allocator
+            Windows::AI::MachineLearning::Adapter::EdgeShapes outputShapes;
+            std::vector<bool> inputsUsed;
+            std::vector<uint8_t> isInputsUploadedByDmlEP;
+            std::vector<ComPtr<ID3D12Resource>> nonOwnedGraphInputsFromInitializers;
+            std::deque<std::unique_ptr<DmlReusedCommandListState>> reusedCommandLists;
+        };
+
+        // Number of compiled graphs kept, so that alternating between a few shapes (e.g. the sequence lengths of a
+        // decoder) doesn't recompile the graph every time the shapes change.
+        static constexpr size_t c_maxCompiledGraphs = 8;
+
         void TranslateAndCompileGraph(
-            const onnxruntime::OpKernelInfo& kernelInfo,
+            CompiledGraph& compiledGraph,
             std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>>& initializeResourceRefs,
             std::vector<DML_BUFFER_BINDING> initInputBindings) const
         {
             // Allocate a persistent resource and initialize the operator
-            UINT64 persistentResourceSize = m_compiledExecutionPlanOperator->GetBindingProperties().PersistentResourceSize;
+            UINT64 persistentResourceSize = compiledGraph.compiledExecutionPlanOperator->GetBindingProperties().PersistentResourceSize;
             if (persistentResourceSize > 0)
             {
                 ORT_THROW_IF_FAILED(m_provider->AllocatePooledResource(
                     static_cast<size_t>(persistentResourceSize),
                     AllocatorRoundingMode::Disabled,
-                    m_persistentResource.ReleaseAndGetAddressOf(),
-                    m_persistentResourceAllocatorUnknown.ReleaseAndGetAddressOf()));
+                    compiledGraph.persistentResource.ReleaseAndGetAddressOf(),
+                    compiledGraph.persistentResourceAllocatorUnknown.ReleaseAndGetAddressOf()));
 
-                m_persistentResourceBinding = DML_BUFFER_BINDING { m_persistentResource.Get(), 0, persistentResourceSize };
+                compiledGraph.persistentResourceBinding = DML_BUFFER_BINDING { compiledGraph.persistentResource.Get(), 0, persistentResourceSize };
             }
 
             ORT_THROW_IF_FAILED(m_provider->InitializeOperator(
-                m_compiledExecutionPlanOperator.Get(),
-                m_persistentResourceBinding ? &*m_persistentResourceBinding : nullptr,
+                compiledGraph.compiledExecutionPlanOperator.Get(),
+                compiledGraph.persistentResourceBinding ? &*compiledGraph.persistentResourceBinding : nullptr,
                 gsl::make_span(initInputBindings)));
 
             std::for_each(
@@ -92,158 +110,159 @@ namespace Dml
             );
         }
 
-        onnxruntime::Status Compute(onnxruntime::OpKernelContext* kernelContext) const override
+        std::unique_ptr<CompiledGraph> CompileGraph(onnxruntime::OpKernelContext* kernelContext) const
         {
-            ORT_THROW_HR_IF(E_UNEXPECTED, static_cast<ptrdiff_t>(m_subgraphInputs.size()) != kernelContext->InputCount());
-
-            bool recompileNeeded = m_compiledExecutionPlanOperator == nullptr;
-
             for (int inputIndex = 0; inputIndex < kernelContext->InputCount(); ++inputIndex)
             {
                 const auto& input = kernelContext->RequiredInput<onnxruntime::Tensor>(inputIndex);
                 const std::string& inputName = m_subgraphInputs[inputIndex]->Name();
-                auto shapeIter = m_inferredInputShapes.find(inputName);
-
-                if (shapeIter == m_inferredInputShapes.end())
-                {
-                    m_inferredInputShapes[inputName] = input.Shape();
-                    recompileNeeded = true;
-                }
-                else if (shapeIter->second != input.Shape())
-                {
-                    shapeIter->second = input.Shape();
-                    recompileNeeded = true;
-                }
-
-                // If we have CPU inputs that are not initializers (i.e. they were computed at runtime), add them to the initializer list
-                if (input.Location().device.Type() == OrtDevice::CPU)
-                {
-                    auto inputProto = onnxruntime::utils::TensorToTensorProto(input, inputName);
 
-                    // We can only avoid recompiling the graph when all CPU inputs are identical
-                    auto initializerIter = m_isInitializerTransferable.find(inputName);
-
-                    if (initializerIter != m_isInitializerTransferable.end())
-                    {
-                        if (initializerIter->second.first->raw_data().length() == inputProto.raw_data().length())
-                        {
-                            for (int i = 0; i < inputProto.raw_data().length(); ++i)
-                            {
-                                if (initializerIter->second.first->raw_data()[i] != inputProto.raw_data()[i])
-                                {
-                                    recompileNeeded = true;
-                                    break;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            recompileNeeded = true;
-                        }
-                    }
-                    else
-                    {
-                        recompileNeeded = true;
-                    }
-
-                    m_ownedCpuInputs.push_back(std::make_unique<ONNX_NAMESPACE::TensorProto>(std::move(inputProto)));
-                    m_isInitializerTransferable[inputName] = std::make_pair(m_ownedCpuInputs.back().get(), false);
-                }
-            }
-
-            if (recompileNeeded)
-            {
                 // Go through all the node args and replace their shapes with the real ones
                 for (auto& nodeArg : m_intermediateNodeArgs)
                 {
-                    auto iter = m_inferredInputShapes.find(nodeArg->Name());
-                    if (iter != m_inferredInputShapes.end())
+                    if (nodeArg->Name() == inputName)
                     {
                         auto tensorShape = *nodeArg->Shape();
-                        ORT_THROW_HR_IF(E_UNEXPECTED, tensorShape.dim_size() != static_cast<ptrdiff_t>(iter->second.NumDimensions()));
+                        ORT_THROW_HR_IF(E_UNEXPECTED, tensorShape.dim_size() != static_cast<ptrdiff_t>(input.Shape().NumDimensions()));
 
                         for (int i = 0; i < tensorShape.dim_size(); ++i)
                         {
-                            tensorShape.mutable_dim(i)->set_dim_value(iter->second.GetDims()[i]);
+                            tensorShape.mutable_dim(i)->set_dim_value(input.Shape().GetDims()[i]);
                         }
 
                         nodeArg->SetShape(tensorShape);
                     }
                 }
 
-                // Populate input bindings for operator initialization
-                const uint32_t fusedNodeInputCount = gsl::narrow_cast<uint32_t>(m_indexedSubGraph->GetMetaDef()->inputs.size());
-                std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> initializeResourceRefs; // For lifetime control
-                std::vector<DML_BUFFER_BINDING> initInputBindings(fusedNodeInputCount);
-                std::vector<uint8_t> isInputsUploadedByDmlEP(fusedNodeInputCount);
-                auto providerImpl = static_cast<const ExecutionProvider*>(Info().GetExecutionProvider())->GetImpl();
-
-                // Convert partitionONNXGraph into DML EP GraphDesc
-                ComPtr<IDMLDevice> device;
-                ORT_THROW_IF_FAILED(providerImpl->GetDmlDevice(device.GetAddressOf()));
-                // This map will be used to transfer the initializer to D3D12 system heap memory.
-                // 'serializedDmlGraphDesc' will have constant input as intermediate edges, that's why
-                // we need a mapping between intermediateEdgeIndex and indexedSubGraph's (a given partition)
-                // input arg index.
-                //   For ex: Let's say intermediate edge index = idx, then
-                //           indexedSubGraphInputArgIdx = constantEdgeIdxToSubgraphInputArgIdxMap[idx];
-                //           corresponding constant tensor = initializerNameToInitializerMap[indexedSubGraph.GetMetaDef()->inputs[indexedSubGraphInputArgIdx]]
-                // We are using intermediate edge index as a key because same constant tensor can be used by
-                // multiple nodes.
-                std::unordered_map<uint32_t, uint32_t> serializedGraphInputIndexToSubgraphInputIndex;
-                std::unordered_map<std::string_view, uint32_t> serializedGraphLargeConstantNameToSubgraphInputIndex;
-                std::vector<std::unique_ptr<std::byte[]>> smallConstantData;
-                GraphDescBuilder::GraphDesc graphDesc = GraphDescBuilder::BuildGraphDesc(
-                    isInputsUploadedByDmlEP.data(),
-                    isInputsUploadedByDmlEP.size(),
-                    m_isInitializerTransferable,
-                    m_partitionNodePropsMap,
-                    providerImpl,
-                    m_modelPath,
-                    m_subgraphNodePointers,
-                    m_subgraphInputs,
-                    m_subgraphOutputs,
-                    serializedGraphInputIndexToSubgraphInputIndex,
-                    serializedGraphLargeConstantNameToSubgraphInputIndex,
-                    smallConstantData);
-
-                m_outputShapes = graphDesc.outputShapes;
-
-                // Walk through each graph edge and mark used inputs
-                m_inputsUsed = std::vector<bool>(fusedNodeInputCount);
-                for (auto it = serializedGraphInputIndexToSubgraphInputIndex.begin(); it != serializedGraphInputIndexToSubgraphInputIndex.end(); it++) {
-                    m_inputsUsed[it->second] = true;
-                }
-                for (auto it = serializedGraphLargeConstantNameToSubgraphInputIndex.begin(); it != serializedGraphLargeConstantNameToSubgraphInputIndex.end(); it++) {
-                    m_inputsUsed[it->second] = true;
+                // If we have CPU inputs that are not initializers (i.e. they were computed at runtime), add them to the initializer list
+                if (input.Location().device.Type() == OrtDevice::CPU)
+                {
+                    auto& ownedCpuInput = m_ownedCpuInputs[inputName];
+                    ownedCpuInput = std::make_unique<ONNX_NAMESPACE::TensorProto>(onnxruntime::utils::TensorToTensorProto(input, inputName));
+                    m_isInitializerTransferable[inputName] = std::make_pair(ownedCpuInput.get(), false);
                 }
+            }
 
-                m_isInputsUploadedByDmlEP.resize(fusedNodeInputCount, 0);
-                m_nonOwnedGraphInputsFromInitializers.resize(fusedNodeInputCount);
-                graphDesc.reuseCommandList = true;
+            auto compiledGraph = std::make_unique<CompiledGraph>();
+
+            // Populate input bindings for operator initialization
+            const uint32_t fusedNodeInputCount = gsl::narrow_cast<uint32_t>(m_indexedSubGraph->GetMetaDef()->inputs.size());
+            std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> initializeResourceRefs; // For lifetime control
+            std::vector<DML_BUFFER_BINDING> initInputBindings(fusedNodeInputCount);
+            std::vector<uint8_t> isInputsUploadedByDmlEP(fusedNodeInputCount);
+            auto providerImpl = static_cast<const ExecutionProvider*>(Info().GetExecutionProvider())->GetImpl();
+
+            // Convert partitionONNXGraph into DML EP GraphDesc
+            ComPtr<IDMLDevice> device;
+            ORT_THROW_IF_FAILED(providerImpl->GetDmlDevice(device.GetAddressOf()));
+            // This map will be used to transfer the initializer to D3D12 system heap memory.
+            // 'serializedDmlGraphDesc' will have constant input as intermediate edges, that's why
+            // we need a mapping between intermediateEdgeIndex and indexedSubGraph's (a given partition)
+            // input arg index.
+            //   For ex: Let's say intermediate edge index = idx, then
+            //           indexedSubGraphInputArgIdx = constantEdgeIdxToSubgraphInputArgIdxMap[idx];
+            //           corresponding constant tensor = initializerNameToInitializerMap[indexedSubGraph.GetMetaDef()->inputs[indexedSubGraphInputArgIdx]]
+            // We are using intermediate edge index as a key because same constant tensor can be used by
+            // multiple nodes.
+            std::unordered_map<uint32_t, uint32_t> serializedGraphInputIndexToSubgraphInputIndex;
+            std::unordered_map<std::string_view, uint32_t> serializedGraphLargeConstantNameToSubgraphInputIndex;
+            std::vector<std::unique_ptr<std::byte[]>> smallConstantData;
+            GraphDescBuilder::GraphDesc graphDesc = GraphDescBuilder::BuildGraphDesc(
+                isInputsUploadedByDmlEP.data(),
+                isInputsUploadedByDmlEP.size(),
+                m_isInitializerTransferable,
+                m_partitionNodePropsMap,
+                providerImpl,
+                m_modelPath,
+                m_subgraphNodePointers,
+                m_subgraphInputs,
+                m_subgraphOutputs,
+                serializedGraphInputIndexToSubgraphInputIndex,
+                serializedGraphLargeConstantNameToSubgraphInputIndex,
+                smallConstantData);
+
+            compiledGraph->outputShapes = graphDesc.outputShapes;
+
+            // Walk through each graph edge and mark used inputs
+            compiledGraph->inputsUsed = std::vector<bool>(fusedNodeInputCount);
+            for (auto it = serializedGraphInputIndexToSubgraphInputIndex.begin(); it != serializedGraphInputIndexToSubgraphInputIndex.end(); it++) {
+                compiledGraph->inputsUsed[it->second] = true;
+            }
+            for (auto it = serializedGraphLargeConstantNameToSubgraphInputIndex.begin(); it != serializedGraphLargeConstantNameToSubgraphInputIndex.end(); it++) {
+                compiledGraph->inputsUsed[it->second] = true;
+            }
 
-                // Compile the operator
-                m_compiledExecutionPlanOperator = DmlGraphFusionHelper::TryCreateCompiledOperator(
-                    graphDesc,
-                    *m_indexedSubGraph,
-                    providerImpl,
-                    &serializedGraphInputIndexToSubgraphInputIndex,
-                    &serializedGraphLargeConstantNameToSubgraphInputIndex);
+            compiledGraph->isInputsUploadedByDmlEP.resize(fusedNodeInputCount, 0);
+            compiledGraph->nonOwnedGraphInputsFromInitializers.resize(fusedNodeInputCount);
+            graphDesc.reuseCommandList = true;
 
-                // Queue references to objects which must be kept alive until resulting GPU work completes
-                m_winmlProvider->QueueReference(m_compiledExecutionPlanOperator.Get());
+            // Compile the operator
+            compiledGraph->compiledExecutionPlanOperator = DmlGraphFusionHelper::TryCreateCompiledOperator(
+                graphDesc,
+                *m_indexedSubGraph,
+                providerImpl,
+                &serializedGraphInputIndexToSubgraphInputIndex,
+                &serializedGraphLargeConstantNameToSubgraphInputIndex);
 
-                TranslateAndCompileGraph(
-                    Info(),
-                    initializeResourceRefs,
-                    initInputBindings);
+            // Queue references to objects which must be kept alive until resulting GPU work completes
+            m_winmlProvider->QueueReference(compiledGraph->compiledExecutionPlanOperator.Get());
+
+            TranslateAndCompileGraph(
+                *compiledGraph,
+                initializeResourceRefs,
+                initInputBindings);
 
-                std::vector<DML_BUFFER_BINDING> inputBindings(kernelContext->InputCount());
-                std::vector<DML_BINDING_DESC> inputBindingDescs(kernelContext->InputCount());
+            return compiledGraph;
+        }
+
+        // The key of the compiled graphs: the shapes of the inputs, and the values of the CPU inputs which are
+        // constants of the compiled graph.
+        std::string GetCompiledGraphKey(onnxruntime::OpKernelContext* kernelContext) const
+        {
+            std::string key;
+            for (int inputIndex = 0; inputIndex < kernelContext->InputCount(); ++inputIndex)
+            {
+                const auto& input = kernelContext->RequiredInput<onnxruntime::Tensor>(inputIndex);
+                const auto dims = input.Shape().GetDims();
+                const int64_t rank = static_cast<int64_t>(dims.size());
+                key.append(reinterpret_cast<const char*>(&rank), sizeof(rank));
+                key.append(reinterpret_cast<const char*>(dims.data()), dims.size_bytes());
 
-                m_reusedCommandLists.clear();
+                if (input.Location().device.Type() == OrtDevice::CPU)
+                {
+                    key.append(static_cast<const char*>(input.DataRaw()), input.SizeInBytes());
+                }
             }
+            return key;
+        }
+
+        onnxruntime::Status Compute(onnxruntime::OpKernelContext* kernelContext) const override
+        {
+            ORT_THROW_HR_IF(E_UNEXPECTED, static_cast<ptrdiff_t>(m_subgraphInputs.size()) != kernelContext->InputCount());
 
+            // Look up the graph compiled for these inputs, most recently used first, and compile it if it isn't
+            // cached, evicting the least recently used graph. The resources of an evicted graph which are still in
+            // use by the GPU are kept alive by the references queued when it executed.
+            std::string key = GetCompiledGraphKey(kernelContext);
+            auto compiledGraphIter = std::find_if(
+                m_compiledGraphs.begin(),
+                m_compiledGraphs.end(),
+                [&key](const auto& compiledGraph) { return compiledGraph.first == key; });
+
+            if (compiledGraphIter == m_compiledGraphs.end())
+            {
+                m_compiledGraphs.emplace_front(std::move(key), CompileGraph(kernelContext));
+                if (m_compiledGraphs.size() > c_maxCompiledGraphs)
+                {
+                    m_compiledGraphs.pop_back();
+                }
+            }
+            else if (compiledGraphIter != m_compiledGraphs.begin())
+            {
+                m_compiledGraphs.splice(m_compiledGraphs.begin(), m_compiledGraphs, compiledGraphIter);
+            }
+
+            CompiledGraph& compiledGraph = *m_compiledGraphs.front().second;
             auto providerImpl = static_cast<ExecutionProviderImpl*>(m_provider.Get());
 
             // When we are capturing a graph, we don't pool the command list and instead transfer it to the execution provider. Captured graph
@@ -252,57 +271,58 @@ namespace Dml
             {
                 auto reusableCommandList = DmlGraphFusionHelper::BuildReusableCommandList(
                     m_provider.Get(),
-                    m_compiledExecutionPlanOperator.Get(),
-                    m_persistentResource.Get(),
-                    m_persistentResourceBinding);
+                    compiledGraph.compiledExecutionPlanOperator.Get(),
+                    compiledGraph.persistentResource.Get(),
+                    compiledGraph.persistentResourceBinding);
 
-                reusableCommandList->persistentResource = m_persistentResource;
-                reusableCommandList->persistentResourceAllocatorUnknown = m_persistentResourceAllocatorUnknown;
+                reusableCommandList->persistentResource = compiledGraph.persistentResource;
+                reusableCommandList->persistentResourceAllocatorUnknown = compiledGraph.persistentResourceAllocatorUnknown;
 
                 DmlGraphFusionHelper::ExecuteReusableCommandList(
                     kernelContext,
                     *reusableCommandList,
-                    m_compiledExecutionPlanOperator.Get(),
+                    compiledGraph.compiledExecutionPlanOperator.Get(),
                     Info(),
-                    m_isInputsUploadedByDmlEP,
-                    m_inputsUsed,
-                    m_nonOwnedGraphInputsFromInitializers,
-                    m_outputShapes,
+                    compiledGraph.isInputsUploadedByDmlEP,
+                    compiledGraph.inputsUsed,
+                    compiledGraph.nonOwnedGraphInputsFromInitializers,
+                    compiledGraph.outputShapes,
                     m_winmlProvider.Get(),
                     m_provider.Get(),
-                    m_persistentResourceAllocatorUnknown.Get());
+                    compiledGraph.persistentResourceAllocatorUnknown.Get());
 
                 providerImpl->AppendCapturedGraph(providerImpl->GetCurrentGraphAnnotationId(), std::move(reusableCommandList));
             }
             else
             {
-                if (m_reusedCommandLists.empty() ||
-                    m_reusedCommandLists.front()->fence && m_reusedCommandLists.front()->fence->GetCompletedValue() < m_reusedCommandLists.front()->completionValue)
+                auto& reusedCommandLists = compiledGraph.reusedCommandLists;
+                if (reusedCommandLists.empty() ||
+                    reusedCommandLists.front()->fence && reusedCommandLists.front()->fence->GetCompletedValue() < reusedCommandLists.front()->completionValue)
                 {
                     auto reusableCommandList = DmlGraphFusionHelper::BuildReusableCommandList(
                         m_provider.Get(),
-                        m_compiledExecutionPlanOperator.Get(),
-                        m_persistentResource.Get(),
-                        m_persistentResourceBinding);
+                        compiledGraph.compiledExecutionPlanOperator.Get(),
+                        compiledGraph.persistentResource.Get(),
+                        compiledGraph.persistentResourceBinding);
 
-                    m_reusedCommandLists.push_front(std::move(reusableCommandList));
+                    reusedCommandLists.push_front(std::move(reusableCommandList));
                 }
 
                 DmlGraphFusionHelper::ExecuteReusableCommandList(
                     kernelContext,
-                    *m_reusedCommandLists.front(),
-                    m_compiledExecutionPlanOperator.Get(),
+                    *reusedCommandLists.front(),
+                    compiledGraph.compiledExecutionPlanOperator.Get(),
                     Info(),
-                    m_isInputsUploadedByDmlEP,
-                    m_inputsUsed,
-                    m_nonOwnedGraphInputsFromInitializers,
-                    m_outputShapes,
+                    compiledGraph.isInputsUploadedByDmlEP,
+                    compiledGraph.inputsUsed,
+                    compiledGraph.nonOwnedGraphInputsFromInitializers,
+                    compiledGraph.outputShapes,
                     m_winmlProvider.Get(),
                     m_provider.Get(),
-                    m_persistentResourceAllocatorUnknown.Get());
+                    compiledGraph.persistentResourceAllocatorUnknown.Get());
 
-                m_reusedCommandLists.push_back(std::move(m_reusedCommandLists.front()));
-                m_reusedCommandLists.pop_front();
+                reusedCommandLists.push_back(std::move(reusedCommandLists.front()));
+                reusedCommandLists.pop_front();
             }
 
             return onnxruntime::Status::OK();
@@ -312,7 +332,6 @@ namespace Dml
         ComPtr<IWinmlExecutionProvider> m_winmlProvider;
         ComPtr<Dml::IExecutionProvider> m_provider;
 
-        mutable std::optional<DML_BUFFER_BINDING> m_persistentResourceBinding;
         std::shared_ptr<const onnxruntime::IndexedSubGraph> m_indexedSubGraph;
         const onnxruntime::Path& m_modelPath;
 
@@ -325,17 +344,11 @@ namespace Dml
         mutable std::unordered_map<std::string, std::pair<const ONNX_NAMESPACE::TensorProto*, bool>> m_isInitializerTransferable;
         std::vector<const onnxruntime::Node*> m_subgraphNodePointers;
 
-        // Bindings from previous executions of a re-used command list
-        mutable std::vector<std::unique_ptr<ONNX_NAMESPACE::TensorProto>> m_ownedCpuInputs;
-        mutable ComPtr<IDMLCompiledOperator> m_compiledExecutionPlanOperator;
-        mutable std::vector<bool> m_inputsUsed;
-        mutable ComPtr<ID3D12Resource> m_persistentResource;
-        mutable ComPtr<IUnknown> m_persistentResourceAllocatorUnknown; // Controls when the persistent resource is returned to the allocator
-        mutable Windows::AI::MachineLearning::Adapter::EdgeShapes m_outputShapes;
-        mutable std::unordered_map<std::string, onnxruntime::TensorShape> m_inferredInputShapes;
-        mutable std::deque<std::unique_ptr<DmlReusedCommandListState>> m_reusedCommandLists;
-        mutable std::vector<uint8_t> m_isInputsUploadedByDmlEP;
-        mutable std::vector<ComPtr<ID3D12Resource>> m_nonOwnedGraphInputsFromInitializers;
+        // Values of the CPU inputs the last graph was compiled with
+        mutable std::unordered_map<std::string, std::unique_ptr<ONNX_NAMESPACE::TensorProto>> m_ownedCpuInputs;
+
+        // Compiled graphs by key, most recently used first
+        mutable std::list<std::pair<std::string, std::unique_ptr<CompiledGraph>>> m_compiledGraphs;
     };
 
     onnxruntime::OpKernel* CreateRuntimeFusedGraphKernel(
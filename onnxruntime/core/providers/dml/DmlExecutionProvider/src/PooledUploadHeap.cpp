@@ -107,7 +107,12 @@ namespace Dml
             nullptr,
             IID_GRAPHICS_PPV_ARGS(uploadBuffer.ReleaseAndGetAddressOf())));
 
-        return Chunk{ sizeInBytes, std::move(uploadBuffer) };
+        // The CPU doesn't read from the chunk
+        void* mappedData = nullptr;
+        CD3DX12_RANGE readRange(0, 0);
+        ORT_THROW_IF_FAILED(uploadBuffer->Map(0, &readRange, &mappedData));
+
+        return Chunk{ sizeInBytes, std::move(uploadBuffer), mappedData };
     }
 
     std::pair<PooledUploadHeap::Chunk*, size_t> PooledUploadHeap::Reserve(size_t sizeInBytes)
@@ -171,11 +176,8 @@ namespace Dml
         assert(chunk != nullptr);
         assert(offsetInChunk + src.size() <= chunk->capacityInBytes);
 
-        // Map the upload heap and copy the source data into it at the specified offset
-        void* uploadHeapData = nullptr;
-        ORT_THROW_IF_FAILED(chunk->resource->Map(0, nullptr, &uploadHeapData));
-        memcpy(static_cast<byte*>(uploadHeapData) + offsetInChunk, src.data(), src.size());
-        chunk->resource->Unmap(0, nullptr);
+        // Copy the source data into the upload heap at the specified offset
+        memcpy(static_cast<byte*>(chunk->mappedData) + offsetInChunk, src.data(), src.size());
 
         // Copy from the upload heap into the destination resource
         m_executionContext->CopyBufferRegion(
@@ -239,6 +241,7 @@ namespace Dml
         for (const auto& chunk : m_chunks)
         {
             assert(chunk.resource != nullptr);
+            assert(chunk.mappedData != nullptr);
             assert(chunk.capacityInBytes == chunk.resource->GetDesc().Width);
         }
 
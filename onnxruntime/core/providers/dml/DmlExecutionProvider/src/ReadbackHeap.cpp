@@ -69,6 +69,23 @@ namespace Dml
         assert(m_readbackHeap->GetDesc().Width >= size);
     }
 
+    void* ReadbackHeap::MapReadbackHeap(size_t size)
+    {
+        // Only the range which has been copied to is read, so that the CPU caches are invalidated for that range
+        // rather than for the whole heap
+        void* readbackHeapData = nullptr;
+        CD3DX12_RANGE readRange(0, size);
+        ORT_THROW_IF_FAILED(m_readbackHeap->Map(0, &readRange, &readbackHeapData));
+        return readbackHeapData;
+    }
+
+    void ReadbackHeap::UnmapReadbackHeap()
+    {
+        // The CPU hasn't written anything
+        CD3DX12_RANGE writtenRange(0, 0);
+        m_readbackHeap->Unmap(0, &writtenRange);
+    }
+
     void ReadbackHeap::ReadbackFromGpu(
         gsl::span<std::byte> dst,
         ID3D12Resource* src,
@@ -95,10 +112,9 @@ namespace Dml
         m_executionContext->ReleaseCompletedReferences();
 
         // Map the readback heap and copy it into the destination
-        void* readbackHeapData = nullptr;
-        ORT_THROW_IF_FAILED(m_readbackHeap->Map(0, nullptr, &readbackHeapData));
+        void* readbackHeapData = MapReadbackHeap(dst.size());
         memcpy(dst.data(), readbackHeapData, dst.size());
-        m_readbackHeap->Unmap(0, nullptr);
+        UnmapReadbackHeap();
     }
 
     void ReadbackHeap::ReadbackFromGpu(
@@ -145,8 +161,7 @@ namespace Dml
         m_executionContext->ReleaseCompletedReferences();
 
         // Map the readback heap and copy it into the destination
-        void* readbackHeapData = nullptr;
-        ORT_THROW_IF_FAILED(m_readbackHeap->Map(0, nullptr, &readbackHeapData));
+        void* readbackHeapData = MapReadbackHeap(totalSize);
 
         // Copy from the source resource into the readback heap
         offset = 0;
@@ -156,6 +171,6 @@ namespace Dml
             offset += dstSizes[i];
         }
 
-        m_readbackHeap->Unmap(0, nullptr);
+        UnmapReadbackHeap();
     }
 } // namespace Dml
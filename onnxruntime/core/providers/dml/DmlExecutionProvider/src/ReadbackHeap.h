@@ -32,6 +32,10 @@ namespace Dml
     private:
         void EnsureReadbackHeap(size_t size);
 
+        // Maps the first size bytes of the readback heap for reading
+        void* MapReadbackHeap(size_t size);
+        void UnmapReadbackHeap();
+
         static constexpr size_t c_initialCapacity = 1024 * 1024; // 1MB
 
         ComPtr<ID3D12Device> m_device;
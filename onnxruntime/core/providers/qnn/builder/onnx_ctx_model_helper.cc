@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/qnn/builder/onnx_ctx_model_helper.h"
+#include "core/framework/ep_context_utils.h"
 #include "core/graph/constants.h"
 #include "core/providers/qnn/builder/qnn_model.h"
 
@@ -14,22 +15,7 @@ namespace qnn {
 
 bool GraphHasEpContextNode(const onnxruntime::GraphViewer& graph_viewer) {
   // It's an Onnx model with Qnn context cache binary if it has a node with EPContext type and the source is QNN or QNNExecutionProvider.
-  for (const auto& node : graph_viewer.Nodes()) {
-    if (EPCONTEXT_OP == node.OpType()) {
-      NodeAttrHelper node_helper(node);
-      std::string cache_source = node_helper.Get(SOURCE, "");
-
-      std::transform(cache_source.begin(),
-                     cache_source.end(),
-                     cache_source.begin(),
-                     [](unsigned char c) { return static_cast<unsigned char>(std::tolower(c)); });
-
-      if (cache_source == "qnnexecutionprovider" || cache_source == "qnn") {
-        return true;
-      }
-    }
-  }
-  return false;
+  return ep_context_utils::GraphHasEpContextNode(graph_viewer, kQnnExecutionProvider);
 }
 
 bool IsFusedGraphHasCtxNode(const std::vector<IExecutionProvider::FusedNodeAndGraph>& fused_nodes_and_graphs) {
@@ -89,71 +75,27 @@ Status CreateNodeArgs(const std::vector<std::string>& names,
 Status GetEpContextFromMainNode(const onnxruntime::Node& main_context_node,
                                 const onnxruntime::PathString& ctx_onnx_model_path,
                                 QnnBackendManager* qnn_backend_manager,
-                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models) {
+                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                bool share_ep_contexts) {
   ORT_RETURN_IF_NOT(EPCONTEXT_OP == main_context_node.OpType(), "Should only filter in the EPContext node.");
-  NodeAttrHelper node_helper(main_context_node);
-  bool is_embed_mode = node_helper.Get(EMBED_MODE, true);
-  if (is_embed_mode) {
-    const std::string& context_binary = node_helper.Get(EP_CACHE_CONTEXT, "");
-    return qnn_backend_manager->LoadCachedQnnContextFromBuffer(const_cast<char*>(context_binary.c_str()),
-                                                               static_cast<uint64_t>(context_binary.length()),
-                                                               qnn_models);
-  }
-
-  std::filesystem::path folder_path = std::filesystem::path(ctx_onnx_model_path).parent_path();
-  std::string external_qnn_ctx_binary_file_name = node_helper.Get(EP_CACHE_CONTEXT, "");
-  ORT_RETURN_IF(external_qnn_ctx_binary_file_name.empty(), "The file path in ep_cache_context should not be empty.");
-#ifdef _WIN32
-  onnxruntime::PathString external_qnn_context_binary_path = onnxruntime::ToPathString(external_qnn_ctx_binary_file_name);
-  auto ctx_file_path = std::filesystem::path(external_qnn_context_binary_path.c_str());
-  ORT_RETURN_IF(ctx_file_path.is_absolute(), "External mode should set ep_cache_context field with a relative path, but it is an absolute path: ",
-                external_qnn_ctx_binary_file_name);
-  auto relative_path = ctx_file_path.lexically_normal().make_preferred().wstring();
-  if (relative_path.find(L"..", 0) != std::string::npos) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ep_cache_context field has '..'. It's not allowed to point outside the directory.");
-  }
-
-  std::filesystem::path context_binary_path = folder_path.append(relative_path);
-#else
-  ORT_RETURN_IF(external_qnn_ctx_binary_file_name[0] == '/',
-                "External mode should set ep_cache_context field with a relative path, but it is an absolute path: ",
-                external_qnn_ctx_binary_file_name);
-  if (external_qnn_ctx_binary_file_name.find("..", 0) != std::string::npos) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ep_cache_context field has '..'. It's not allowed to point outside the directory.");
-  }
-  std::filesystem::path context_binary_path = folder_path.append(external_qnn_ctx_binary_file_name);
-  std::string file_full_path = context_binary_path.string();
-#endif
-  if (!std::filesystem::is_regular_file(context_binary_path)) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ep_cache_context does not exist or is not accessible.");
-  }
-
-  size_t buffer_size{0};
-  std::ifstream cache_file(context_binary_path.string().c_str(), std::ifstream::binary);
-  ORT_RETURN_IF(!cache_file || !cache_file.good(), "Failed to open cache file.");
-
-  cache_file.seekg(0, cache_file.end);
-  buffer_size = static_cast<size_t>(cache_file.tellg());
-  ORT_RETURN_IF(0 == buffer_size, "Empty cache file encountered.");
-
-  cache_file.seekg(0, cache_file.beg);
-  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(buffer_size);
-  ORT_RETURN_IF(nullptr == buffer, "Failed to allocate memory for cache file.");
-  // Load file into buffer
-  const auto& read_result = cache_file.read(buffer.get(), buffer_size);
-  ORT_RETURN_IF(!read_result, "Failed to read contents from cached context file.");
-  cache_file.close();
-  return qnn_backend_manager->LoadCachedQnnContextFromBuffer(buffer.get(),
-                                                             static_cast<uint64_t>(buffer_size),
-                                                             qnn_models);
+  std::string file_buffer;
+  std::string_view context_binary;
+  ORT_RETURN_IF_ERROR(ep_context_utils::GetEpContextArtifact(main_context_node, ctx_onnx_model_path,
+                                                             file_buffer, context_binary));
+  return qnn_backend_manager->LoadCachedQnnContextFromBuffer(const_cast<char*>(context_binary.data()),
+                                                             static_cast<uint64_t>(context_binary.size()),
+                                                             qnn_models,
+                                                             share_ep_contexts);
 }
 
 Status LoadQnnCtxFromOnnxGraph(const onnxruntime::GraphViewer& graph_viewer,
                                const onnxruntime::PathString& ctx_onnx_model_path,
                                QnnBackendManager* qnn_backend_manager,
                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                               bool share_ep_contexts,
                                const logging::Logger& logger) {
-  Status status = GetEpContextFromMainNode(*graph_viewer.Nodes().begin(), ctx_onnx_model_path, qnn_backend_manager, qnn_models);
+  Status status = GetEpContextFromMainNode(*graph_viewer.Nodes().begin(), ctx_onnx_model_path, qnn_backend_manager, qnn_models,
+                                           share_ep_contexts);
 
   // This is the protocol with customer that status with INVALID_GRAPH will be generated if failed to load context model
   if (!status.IsOK()) {
@@ -524,7 +524,12 @@ std::unique_ptr<unsigned char[]> QnnBackendManager::GetContextBinaryBuffer(uint6
 }
 
 Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t buffer_length,
-                                                         std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models) {
+                                                         std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                                         bool share_ep_contexts) {
+  // The backend holds a single context, a shared backend cannot load a second one
+  ORT_RETURN_IF(context_created_, "QNN context already created, cannot load another context binary. "
+                "A graph of a shared context binary is used by one session at a time.");
+
   bool result = nullptr == qnn_sys_interface_.systemContextCreate ||
                 nullptr == qnn_sys_interface_.systemContextGetBinaryInfo ||
                 nullptr == qnn_sys_interface_.systemContextFree;
@@ -559,7 +564,11 @@ Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t
 
   ORT_RETURN_IF(graph_count < 1 || graphs_info == nullptr, "Failed to get graph info from Qnn cached context.");
   LOGS(*logger_, VERBOSE) << "Graph count from QNN context: " << graph_count << ", EPContext node count: " << qnn_models.size();
-  ORT_RETURN_IF(graph_count != qnn_models.size(), "Graph count from QNN context not equal to EPContext node count.");
+  if (share_ep_contexts) {
+    ORT_RETURN_IF(graph_count < qnn_models.size(), "Graph count from QNN context less than EPContext node count.");
+  } else {
+    ORT_RETURN_IF(graph_count != qnn_models.size(), "Graph count from QNN context not equal to EPContext node count.");
+  }
 
   ORT_RETURN_IF(nullptr == qnn_interface_.contextCreateFromBinary,
                 "Invalid function pointer for contextCreateFromBinary.");
@@ -586,6 +595,12 @@ Status QnnBackendManager::LoadCachedQnnContextFromBuffer(char* buffer, uint64_t
     for (uint32_t i = 0; i < graph_count; ++i) {
       std::string graph_name(graphs_info[i].graphInfoV1.graphName);
       auto qnn_model_pos = qnn_models.find(graph_name);
+      if (qnn_model_pos == qnn_models.end() && share_ep_contexts) {
+        // Graph of another session, it outlives the logger of this session
+        qnn_model_pos = qnn_models.emplace(graph_name,
+                                           std::make_unique<qnn::QnnModel>(logging::LoggingManager::DefaultLogger(), this))
+                            .first;
+      }
       ORT_RETURN_IF(qnn_model_pos == qnn_models.end(), graph_name + " does not match any EPContext node names.");
       ORT_RETURN_IF_ERROR(qnn_model_pos->second->DeserializeGraphInfoFromBinaryInfo(graphs_info[i]));
     }
@@ -87,8 +87,11 @@ class QnnBackendManager {
 
   std::unique_ptr<unsigned char[]> GetContextBinaryBuffer(uint64_t& written_buffer_size);
 
+  // If share_ep_contexts is true, the binary may hold more graphs than qnn_models, e.g. the graphs of the other
+  // sessions sharing the context. A QnnModel is added to qnn_models for each of them.
   Status LoadCachedQnnContextFromBuffer(char* buffer, uint64_t buffer_length,
-                                        std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models);
+                                        std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                        bool share_ep_contexts = false);
 
   Status SetupBackend(const logging::Logger& logger, bool load_from_cached_context);
 
@@ -180,6 +180,10 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
 
     context_cache_path_cfg_ = session_options->config_options.GetConfigOrDefault(kOrtSessionOptionEpContextFilePath, "");
     LOGS_DEFAULT(VERBOSE) << "User specified context cache path: " << context_cache_path_cfg_;
+
+    share_ep_contexts_ = session_options->config_options.GetConfigOrDefault(
+                             kOrtSessionOptionShareEpContexts, "0") == "1";
+    LOGS_DEFAULT(VERBOSE) << "User specified option - share EP contexts across sessions: " << share_ep_contexts_;
   }
 
   static const std::string BACKEND_PATH = "backend_path";
@@ -326,7 +330,15 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
     LOGS_DEFAULT(VERBOSE) << "User specified enable_htp_fp16_precision: " << enable_HTP_FP16_precision_;
   }
 
-  qnn_backend_manager_ = std::make_unique<qnn::QnnBackendManager>(
+  if (share_ep_contexts_) {
+    qnn_backend_manager_ = SharedContext::GetInstance().GetSharedQnnBackendManager();
+    if (qnn_backend_manager_) {
+      LOGS_DEFAULT(VERBOSE) << "Use the QNN backend shared with other sessions.";
+      return;
+    }
+  }
+
+  qnn_backend_manager_ = std::make_shared<qnn::QnnBackendManager>(
       std::move(backend_path),
       profiling_level_etw,
       profiling_level,
@@ -336,6 +348,10 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
       device_id_,
       htp_arch,
       soc_model);
+
+  if (share_ep_contexts_) {
+    SharedContext::GetInstance().SetSharedQnnBackendManager(qnn_backend_manager_);
+  }
 }
 
 QNNExecutionProvider::~QNNExecutionProvider() {
@@ -508,7 +524,9 @@ QNNExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph_viewer
 
   // It will load the QnnSystem lib if is_qnn_ctx_model=true, and
   // delay the Qnn context creation to Compile() using the cached context binary
-  auto rt = qnn_backend_manager_->SetupBackend(logger, is_qnn_ctx_model);
+  // A shared backend outlives the session, so it logs to the default logger
+  auto rt = qnn_backend_manager_->SetupBackend(share_ep_contexts_ ? logging::LoggingManager::DefaultLogger() : logger,
+                                               is_qnn_ctx_model);
   if (Status::OK() != rt) {
     LOGS(logger, ERROR) << "QNN SetupBackend failed " << rt.ErrorMessage();
     return result;
@@ -732,13 +750,18 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
     ORT_RETURN_IF_ERROR(qnn::GetMainContextNode(fused_nodes_and_graphs, qnn_backend_manager_.get(),
                                                 logger, main_context_pos, qnn_models));
 
-    const onnxruntime::GraphViewer& main_ctx_graph_viewer(fused_nodes_and_graphs[main_context_pos].filtered_graph);
-    // Create QNN context from the cached binary, deserialize the QNN graph from the binary
-    ORT_RETURN_IF_ERROR(qnn::LoadQnnCtxFromOnnxGraph(main_ctx_graph_viewer,
-                                                     context_cache_path,
-                                                     qnn_backend_manager_.get(),
-                                                     qnn_models,
-                                                     logger));
+    if (share_ep_contexts_ && SharedContext::GetInstance().TakeSharedQnnModels(qnn_models)) {
+      LOGS(logger, VERBOSE) << "Use the QNN graphs loaded by another session.";
+    } else {
+      const onnxruntime::GraphViewer& main_ctx_graph_viewer(fused_nodes_and_graphs[main_context_pos].filtered_graph);
+      // Create QNN context from the cached binary, deserialize the QNN graph from the binary
+      ORT_RETURN_IF_ERROR(qnn::LoadQnnCtxFromOnnxGraph(main_ctx_graph_viewer,
+                                                       context_cache_path,
+                                                       qnn_backend_manager_.get(),
+                                                       qnn_models,
+                                                       share_ep_contexts_,
+                                                       logger));
+    }
 
     for (auto fused_node_and_graph : fused_nodes_and_graphs) {
       const onnxruntime::GraphViewer& graph_viewer(fused_node_and_graph.filtered_graph);
@@ -758,6 +781,17 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
       ORT_RETURN_IF_ERROR(CreateComputeFunc(node_compute_funcs, logger));
     }
 
+    if (share_ep_contexts_) {
+      // keep the graphs of the other sessions in the context binary
+      std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> shared_qnn_models;
+      for (auto& qnn_model : qnn_models) {
+        if (qnn_model.second) {
+          shared_qnn_models.emplace(qnn_model.first, std::move(qnn_model.second));
+        }
+      }
+      SharedContext::GetInstance().AddSharedQnnModels(std::move(shared_qnn_models));
+    }
+
     return Status::OK();
   }
 
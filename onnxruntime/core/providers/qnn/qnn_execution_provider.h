@@ -7,6 +7,7 @@
 #include "core/framework/session_options.h"
 #include "core/framework/model_metadef_id_generator.h"
 #include "core/graph/model.h"
+#include "core/platform/ort_mutex.h"
 #include <string>
 #include "core/providers/qnn/builder/qnn_backend_manager.h"
 #include "core/providers/qnn/builder/qnn_model.h"
@@ -20,6 +21,64 @@ namespace onnxruntime {
 
 void RunOnUnload(std::function<void()> function);
 
+// QNN backend and graphs shared by the sessions created with ep.share_ep_contexts=1.
+// The first session loading an EP context model keeps the graphs of the context binary it does not use here, the
+// sessions created later take their graphs from here instead of loading the binary again.
+class SharedContext {
+ public:
+  static SharedContext& GetInstance() {
+    static SharedContext instance;
+    return instance;
+  }
+
+  // Returns the backend of the sessions sharing the context, or nullptr if there is none alive.
+  std::shared_ptr<qnn::QnnBackendManager> GetSharedQnnBackendManager() {
+    std::lock_guard<OrtMutex> lock(mtx_);
+    auto qnn_backend_manager = qnn_backend_manager_.lock();
+    if (!qnn_backend_manager) {
+      // the graphs belong to the released backend
+      shared_qnn_models_.clear();
+    }
+    return qnn_backend_manager;
+  }
+
+  void SetSharedQnnBackendManager(const std::shared_ptr<qnn::QnnBackendManager>& qnn_backend_manager) {
+    std::lock_guard<OrtMutex> lock(mtx_);
+    qnn_backend_manager_ = qnn_backend_manager;
+  }
+
+  void AddSharedQnnModels(std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>&& qnn_models) {
+    std::lock_guard<OrtMutex> lock(mtx_);
+    for (auto& qnn_model : qnn_models) {
+      shared_qnn_models_.emplace(qnn_model.first, std::move(qnn_model.second));
+    }
+  }
+
+  // Takes the graphs named after the keys of qnn_models. Returns false and takes none if any of them is missing.
+  bool TakeSharedQnnModels(std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models) {
+    std::lock_guard<OrtMutex> lock(mtx_);
+    for (const auto& qnn_model : qnn_models) {
+      if (shared_qnn_models_.find(qnn_model.first) == shared_qnn_models_.end()) {
+        return false;
+      }
+    }
+    for (auto& qnn_model : qnn_models) {
+      auto pos = shared_qnn_models_.find(qnn_model.first);
+      qnn_model.second = std::move(pos->second);
+      shared_qnn_models_.erase(pos);
+    }
+    return true;
+  }
+
+ private:
+  SharedContext() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedContext);
+
+  std::weak_ptr<qnn::QnnBackendManager> qnn_backend_manager_;
+  std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> shared_qnn_models_;
+  OrtMutex mtx_;
+};
+
 // Logical device representation.
 class QNNExecutionProvider : public IExecutionProvider {
  public:
@@ -72,9 +131,10 @@ class QNNExecutionProvider : public IExecutionProvider {
 
  private:
   qnn::HtpGraphFinalizationOptimizationMode htp_graph_finalization_opt_mode_ = qnn::HtpGraphFinalizationOptimizationMode::kDefault;
-  std::unique_ptr<qnn::QnnBackendManager> qnn_backend_manager_;
+  std::shared_ptr<qnn::QnnBackendManager> qnn_backend_manager_;
   std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> qnn_models_;
   bool context_cache_enabled_ = false;
+  bool share_ep_contexts_ = false;
   std::string context_cache_path_cfg_ = "";
   bool disable_cpu_ep_fallback_ = false;  // True if CPU EP fallback has been disabled for this session.
   bool qnn_context_embed_mode_ = true;
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace onnxruntime {
+
+/*
+ * Write a cache file of the TensorRT EP. The data is written to a temporary file in the same directory, which is then
+ * renamed to file_path, so that other processes sharing the cache directory see either no file, the previous file or
+ * the whole new one, never a partially written file.
+ *
+ * Returns false if the file cannot be written.
+ */
+inline bool WriteTensorrtCacheFile(const std::string& file_path, const void* data, size_t size) {
+  // the temporary file name is unique among the threads and processes writing the same cache file
+  const auto unique_id = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+                         static_cast<size_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+  const std::string temp_path = file_path + ".tmp" + std::to_string(unique_id);
+  std::error_code error;
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::out);
+    if (!file) {
+      return false;
+    }
+    file.write(static_cast<const char*>(data), size);
+    if (!file) {
+      file.close();
+      std::filesystem::remove(temp_path, error);
+      return false;
+    }
+  }
+
+  std::filesystem::rename(temp_path, file_path, error);
+  if (error) {
+    std::filesystem::remove(temp_path, error);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace onnxruntime
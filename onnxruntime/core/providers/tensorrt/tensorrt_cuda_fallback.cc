@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "tensorrt_cuda_fallback.h"
+
+#include <memory>
+
+#include "core/providers/cuda/shared_inc/cuda_call.h"
+
+#define CUDA_RETURN_IF_ERROR(expr) ORT_RETURN_IF_ERROR(CUDA_CALL(expr))
+
+namespace onnxruntime {
+
+namespace {
+
+size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
+TensorrtCudaFallback::TensorrtCudaFallback(std::string model, int device_id,
+                                           std::unordered_map<std::string, size_t> input_indexes,
+                                           std::unordered_map<std::string, size_t> output_indexes)
+    : model_(std::move(model)),
+      device_id_(device_id),
+      input_indexes_(std::move(input_indexes)),
+      output_indexes_(std::move(output_indexes)) {}
+
+bool TensorrtCudaFallback::IsAvailable() {
+  if (available_.has_value()) {
+    return *available_;
+  }
+
+  available_ = false;
+  try {
+    const OrtApi& api = Ort::GetApi();
+    OrtCUDAProviderOptionsV2* cuda_options = nullptr;
+    Ort::ThrowOnError(api.CreateCUDAProviderOptions(&cuda_options));
+    std::unique_ptr<OrtCUDAProviderOptionsV2, decltype(api.ReleaseCUDAProviderOptions)> release_cuda_options(
+        cuda_options, api.ReleaseCUDAProviderOptions);
+    const std::string device_id = std::to_string(device_id_);
+    const char* keys[] = {"device_id"};
+    const char* values[] = {device_id.c_str()};
+    Ort::ThrowOnError(api.UpdateCUDAProviderOptions(cuda_options, keys, values, 1));
+
+    Ort::SessionOptions session_options;
+    // the session only runs one subgraph on the device
+    session_options.SetIntraOpNumThreads(1);
+    session_options.AppendExecutionProvider_CUDA_V2(*cuda_options);
+
+    env_ = Ort::Env(ORT_LOGGING_LEVEL_WARNING, "TensorrtCudaFallback");
+    session_ = Ort::Session(env_, model_.data(), model_.size(), session_options);
+    device_memory_info_ = Ort::MemoryInfo("Cuda", OrtDeviceAllocator, device_id_, OrtMemTypeDefault);
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    for (size_t i = 0, end = session_.GetInputCount(); i < end; ++i) {
+      input_names_.emplace_back(session_.GetInputNameAllocated(i, allocator).get());
+      if (input_indexes_.find(input_names_.back()) == input_indexes_.end()) {
+        LOGS_DEFAULT(WARNING) << "[TensorRT EP] Subgraph input " << input_names_.back()
+                              << " is not an input of the fused node, the subgraph cannot run on the CUDA EP";
+        return false;
+      }
+    }
+    for (size_t i = 0, end = session_.GetOutputCount(); i < end; ++i) {
+      output_names_.emplace_back(session_.GetOutputNameAllocated(i, allocator).get());
+      if (output_indexes_.find(output_names_.back()) == output_indexes_.end()) {
+        LOGS_DEFAULT(WARNING) << "[TensorRT EP] Subgraph output " << output_names_.back()
+                              << " is not an output of the fused node, the subgraph cannot run on the CUDA EP";
+        return false;
+      }
+    }
+  } catch (const Ort::Exception& ex) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] The subgraph cannot run on the CUDA EP while its engine is built: "
+                          << ex.what();
+    return false;
+  }
+
+  available_ = true;
+  return true;
+}
+
+Status TensorrtCudaFallback::Run(Ort::KernelContext& ctx, cudaStream_t stream) {
+  // The session runs on streams of its own, so wait for the inputs to be ready.
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream));
+
+  Ort::IoBinding binding(session_);
+  for (const auto& name : input_names_) {
+    const OrtValue* input = ctx.GetInput(input_indexes_.at(name));
+    Ort::ThrowOnError(Ort::GetApi().BindInput(binding, name.c_str(), input));
+  }
+  for (const auto& name : output_names_) {
+    binding.BindOutput(name.c_str(), device_memory_info_);
+  }
+  session_.Run(Ort::RunOptions{}, binding);
+  binding.SynchronizeOutputs();
+
+  std::vector<Ort::Value> values = binding.GetOutputValues();
+  for (size_t i = 0; i < output_names_.size(); ++i) {
+    auto tensor_info = values[i].GetTensorTypeAndShapeInfo();
+    const size_t element_size = ElementSize(tensor_info.GetElementType());
+    if (element_size == 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP output tensor data type: " +
+                                                       std::to_string(tensor_info.GetElementType()) +
+                                                       " not supported by the CUDA EP fallback.");
+    }
+    auto output_tensor = ctx.GetOutput(output_indexes_.at(output_names_[i]), tensor_info.GetShape());
+    const size_t num_bytes = tensor_info.GetElementCount() * element_size;
+    if (num_bytes > 0) {
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(output_tensor.GetTensorMutableRawData(), values[i].GetTensorRawData(),
+                                           num_bytes, cudaMemcpyDeviceToDevice, stream));
+    }
+  }
+
+  // The outputs of the session are released when returning.
+  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream));
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
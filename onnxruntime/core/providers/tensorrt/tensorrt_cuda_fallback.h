@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/providers/shared_library/provider_api.h"
+#include "core/session/onnxruntime_cxx_api.h"
+#include "cuda_runtime_api.h"
+
+namespace onnxruntime {
+
+/**
+ * Runs the subgraph of a TensorRT fused node on the CUDA EP, in an inference session of its own created from the
+ * ONNX model of the subgraph. Used while the TensorRT engine of the subgraph is built in the background.
+ *
+ * The session is created on first use. If it cannot be created, e.g. when the subgraph has TensorRT plugin nodes
+ * or the CUDA EP is not available, IsAvailable() returns false and the caller waits for the engine instead.
+ */
+class TensorrtCudaFallback {
+ public:
+  // input_indexes and output_indexes map the names of the subgraph inputs and outputs to their indexes in the
+  // fused node.
+  TensorrtCudaFallback(std::string model, int device_id,
+                       std::unordered_map<std::string, size_t> input_indexes,
+                       std::unordered_map<std::string, size_t> output_indexes);
+
+  bool IsAvailable();
+
+  // Run the subgraph with the inputs of ctx and write its outputs to ctx. stream is the compute stream of the
+  // fused node, the inputs are read and the outputs written in its order.
+  Status Run(Ort::KernelContext& ctx, cudaStream_t stream);
+
+ private:
+  const std::string model_;
+  const int device_id_;
+  const std::unordered_map<std::string, size_t> input_indexes_;
+  const std::unordered_map<std::string, size_t> output_indexes_;
+
+  std::optional<bool> available_;
+  Ort::Env env_{nullptr};
+  Ort::Session session_{nullptr};
+  Ort::MemoryInfo device_memory_info_{nullptr};
+  std::vector<std::string> input_names_;
+  std::vector<std::string> output_names_;
+};
+
+}  // namespace onnxruntime
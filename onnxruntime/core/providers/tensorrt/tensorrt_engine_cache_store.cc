@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "tensorrt_engine_cache_store.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "tensorrt_cache_file.h"
+
+namespace onnxruntime {
+
+TensorrtEngineCacheStore::TensorrtEngineCacheStore(LoadFunc load_func, StoreFunc store_func, std::string key_prefix)
+    : load_func_(load_func), store_func_(store_func), key_prefix_(std::move(key_prefix)) {}
+
+std::string TensorrtEngineCacheStore::GetKey(const std::string& file_path) const {
+  return key_prefix_ + "/" + std::filesystem::path(file_path).filename().string();
+}
+
+bool TensorrtEngineCacheStore::Fetch(const std::string& file_path) const {
+  if (std::filesystem::exists(file_path)) {
+    return true;
+  }
+
+  const std::string key = GetKey(file_path);
+  size_t size = 0;
+  if (!load_func_(key.c_str(), nullptr, &size) || size == 0) {
+    return false;
+  }
+  std::vector<char> data(size);
+  if (!load_func_(key.c_str(), data.data(), &size)) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not load " << key << " from the engine cache store";
+    return false;
+  }
+  if (!WriteTensorrtCacheFile(file_path, data.data(), size)) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write " << file_path << " fetched from the engine cache store";
+    return false;
+  }
+  LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Fetched " << file_path << " from the engine cache store";
+  return true;
+}
+
+void TensorrtEngineCacheStore::Publish(const std::string& file_path) const {
+  std::ifstream file(file_path, std::ios::binary | std::ios::in);
+  if (!file) {
+    return;
+  }
+  std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  const std::string key = GetKey(file_path);
+  if (!store_func_(key.c_str(), data.data(), data.size())) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not store " << key << " in the engine cache store";
+    return;
+  }
+  LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Published " << file_path << " to the engine cache store";
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include "core/providers/shared_library/provider_api.h"
+
+namespace onnxruntime {
+
+/*
+ * Store of engine, profile and timing cache files shared by the processes and hosts using the same models, e.g. an
+ * object store, implemented by a shared library loaded from trt_engine_cache_store_lib_path.
+ *
+ * The library exports:
+ *   int load_engine_cache(const char* key, char* data, size_t* size);
+ *     If data is nullptr, sets size to the size of the entry of key. Otherwise copies the entry to data.
+ *     Returns 0 if there is no entry of key or it cannot be read.
+ *   int store_engine_cache(const char* key, const char* data, size_t size);
+ *     Returns 0 if the entry cannot be written.
+ *
+ * The local cache directory stays the working copy: a missing cache file is fetched from the store before it is
+ * read, and a written cache file is published to the store. The key of a file is its name prefixed by the TensorRT
+ * version and the GPU name. The file names already contain the model hash, the precision, the compute capability and,
+ * for the profile files, the name of the engine whose profiles they hold.
+ */
+class TensorrtEngineCacheStore {
+ public:
+  using LoadFunc = int (*)(const char* key, char* data, size_t* size);
+  using StoreFunc = int (*)(const char* key, const char* data, size_t size);
+
+  TensorrtEngineCacheStore(LoadFunc load_func, StoreFunc store_func, std::string key_prefix);
+
+  // Fetch the file from the store if it does not exist locally. Returns true if the file exists afterwards.
+  bool Fetch(const std::string& file_path) const;
+
+  // Publish the local file to the store.
+  void Publish(const std::string& file_path) const;
+
+ private:
+  std::string GetKey(const std::string& file_path) const;
+
+  const LoadFunc load_func_;
+  const StoreFunc store_func_;
+  const std::string key_prefix_;
+};
+
+}  // namespace onnxruntime
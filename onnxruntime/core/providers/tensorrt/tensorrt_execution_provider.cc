@@ -1,6 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <list>
 #include <unordered_set>
 #include "core/providers/shared_library/provider_api.h"
@@ -210,13 +214,10 @@ inline std::vector<char> loadTimingCacheFile(const std::string inFileName) {
 }
 
 inline void saveTimingCacheFile(const std::string outFileName, const nvinfer1::IHostMemory* blob) {
-  std::ofstream oFile(outFileName, std::ios::out | std::ios::binary);
-  if (!oFile) {
+  // The timing cache is shared by all the engines, so it is replaced as a whole.
+  if (!WriteTensorrtCacheFile(outFileName, blob->data(), blob->size())) {
     LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write timing cache to: " << outFileName;
-    return;
   }
-  oFile.write((char*)blob->data(), blob->size());
-  oFile.close();
 }
 }  // namespace
 
@@ -405,6 +406,39 @@ std::unique_lock<OrtMutex> TensorrtExecutionProvider::GetApiLock() const {
   return std::unique_lock<OrtMutex>(singleton);
 }
 
+void TensorrtExecutionProvider::FetchCacheFile(const std::string& file_path) const {
+  if (engine_cache_store_) {
+    engine_cache_store_->Fetch(file_path);
+  }
+}
+
+void TensorrtExecutionProvider::PublishCacheFile(const std::string& file_path) const {
+  if (engine_cache_store_) {
+    engine_cache_store_->Publish(file_path);
+  }
+}
+
+Status TensorrtExecutionProvider::BuildSerializedEngine(nvinfer1::IBuilder& builder,
+                                                        nvinfer1::INetworkDefinition& network,
+                                                        nvinfer1::IBuilderConfig& config,
+                                                        const std::string& engine_name,
+                                                        std::unique_ptr<nvinfer1::IHostMemory>& serialized_engine) const {
+  auto lock = GetApiLock();
+  std::chrono::steady_clock::time_point engine_build_start;
+  if (detailed_build_log_) {
+    engine_build_start = std::chrono::steady_clock::now();
+  }
+  serialized_engine = std::unique_ptr<nvinfer1::IHostMemory>(builder.buildSerializedNetwork(network, config));
+  if (!serialized_engine) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to create engine from network.");
+  }
+  if (detailed_build_log_) {
+    auto engine_build_stop = std::chrono::steady_clock::now();
+    LOGS_DEFAULT(INFO) << "TensorRT engine build for " << engine_name << " took: " << std::chrono::duration_cast<std::chrono::milliseconds>(engine_build_stop - engine_build_start).count() << "ms" << std::endl;
+  }
+  return Status::OK();
+}
+
 /*
  * Get the shape of "shape tensor" input
  */
@@ -720,6 +754,56 @@ Status ApplyProfileShapesFromInputTensorValue(std::vector<nvinfer1::IOptimizatio
   return Status::OK();
 }
 
+/*
+ * Get the shapes of the inputs with dynamic shape ranges. (The inputs are execution tensors)
+ */
+InputShapesMap GetDynamicInputShapes(Ort::KernelContext& ctx,
+                                     const ShapeRangesMap& shape_ranges,
+                                     const std::unordered_map<std::string, size_t>& input_indexes) {
+  InputShapesMap input_shapes;
+  for (const auto& input : shape_ranges) {
+    const auto& iter = input_indexes.find(input.first);
+    if (iter != input_indexes.end()) {
+      input_shapes[input.first] = ctx.GetInput(iter->second).GetTensorTypeAndShapeInfo().GetShape();
+    }
+  }
+  return input_shapes;
+}
+
+/*
+ * Create an optimization profile for each of the profiles in shape ranges of the dynamic shape inputs.
+ * (The inputs are execution tensors)
+ */
+std::vector<nvinfer1::IOptimizationProfile*> CreateProfilesFromShapeRanges(nvinfer1::IBuilder& builder,
+                                                                           nvinfer1::INetworkDefinition& network,
+                                                                           const ShapeRangesMap& shape_ranges) {
+  std::vector<nvinfer1::IOptimizationProfile*> trt_profiles;
+  const size_t num_profiles = GetNumProfiles(shape_ranges);
+  for (size_t i = 0; i < num_profiles; i++) {
+    auto trt_profile = builder.createOptimizationProfile();
+    for (int j = 0, end = network.getNbInputs(); j < end; ++j) {
+      auto input = network.getInput(j);
+      const auto& ranges_iter = shape_ranges.find(input->getName());
+      if (ranges_iter == shape_ranges.end()) {
+        continue;
+      }
+      nvinfer1::Dims dims = input->getDimensions();
+      nvinfer1::Dims dims_min(dims), dims_opt(dims), dims_max(dims);
+      for (const auto& dim : ranges_iter->second) {
+        const auto& shape_range = dim.second[i];
+        dims_min.d[dim.first] = static_cast<int32_t>(shape_range[0]);
+        dims_max.d[dim.first] = static_cast<int32_t>(shape_range[1]);
+        dims_opt.d[dim.first] = static_cast<int32_t>(shape_range[2]);
+      }
+      trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMIN, dims_min);
+      trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kMAX, dims_max);
+      trt_profile->setDimensions(input->getName(), nvinfer1::OptProfileSelector::kOPT, dims_opt);
+    }
+    trt_profiles.push_back(trt_profile);
+  }
+  return trt_profiles;
+}
+
 #define CASE_GET_INPUT_TENSOR(DATA_TYPE, SrcT)                                              \
   case DATA_TYPE: {                                                                         \
     auto input_tensor_ptr = input_tensor.GetTensorData<SrcT>();                             \
@@ -1311,6 +1395,9 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     profile_opt_shapes = info.profile_opt_shapes;
     cuda_graph_enable_ = info.cuda_graph_enable;
     engine_hw_compatible_ = info.engine_hw_compatible;
+    async_engine_build_enable_ = info.async_engine_build_enable;
+    engine_cache_store_lib_path_ = info.engine_cache_store_lib_path;
+    profile_observation_runs_ = info.profile_observation_runs;
   } else {
     try {
       const std::string max_partition_iterations_env = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kMaxPartitionIterations);
@@ -1592,6 +1679,26 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     }
   }
 
+  if (!engine_cache_store_lib_path_.empty() && (engine_cache_enable_ || timing_cache_enable_)) {
+    LIBTYPE handle = OPENLIB(engine_cache_store_lib_path_.c_str());
+    if (handle == nullptr) {
+      ORT_THROW_IF_ERROR(ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                                         "TensorRT EP could not open shared library from " + engine_cache_store_lib_path_));
+    }
+    auto load_func = (TensorrtEngineCacheStore::LoadFunc)LIBFUNC(handle, "load_engine_cache");
+    auto store_func = (TensorrtEngineCacheStore::StoreFunc)LIBFUNC(handle, "store_engine_cache");
+    if (load_func == nullptr || store_func == nullptr) {
+      ORT_THROW_IF_ERROR(ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                                         "TensorRT EP could not find engine cache store functions in shared library from " + engine_cache_store_lib_path_));
+    }
+    // Engines are only compatible with the TensorRT version and the GPU they are built with.
+    std::string gpu_name = prop.name;
+    std::replace_if(
+        gpu_name.begin(), gpu_name.end(), [](char c) { return !std::isalnum(static_cast<unsigned char>(c)); }, '_');
+    engine_cache_store_ = std::make_unique<TensorrtEngineCacheStore>(
+        load_func, store_func, "trt" + std::to_string(getInferLibVersion()) + "/" + gpu_name);
+  }
+
   if (int8_enable_) {
     int8_calibration_cache_available_ = !int8_calibration_cache_name_.empty();
   }
@@ -1652,6 +1759,13 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     sync_stream_after_enqueue_ = false;
   }
 
+  // The subgraph runs on the CUDA EP while an engine is built in the background, which cannot be captured in a
+  // single cuda graph.
+  if (async_engine_build_enable_ && cuda_graph_enable_) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] trt_async_engine_build_enable is ignored when trt_cuda_graph_enable is set";
+    async_engine_build_enable_ = false;
+  }
+
   {
     auto lock = GetApiLock();
     runtime_ = std::unique_ptr<nvinfer1::IRuntime>(nvinfer1::createInferRuntime(GetTensorrtLogger(detailed_build_log_)));
@@ -1693,7 +1807,10 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
                         << ", trt_ep_context_file_path: " << ep_context_file_path_
                         << ", trt_ep_context_embed_mode: " << ep_context_embed_mode_
                         << ", trt_cache_prefix: " << cache_prefix_
-                        << ", trt_engine_hw_compatible: " << engine_hw_compatible_;
+                        << ", trt_engine_hw_compatible: " << engine_hw_compatible_
+                        << ", trt_async_engine_build_enable: " << async_engine_build_enable_
+                        << ", trt_engine_cache_store_lib_path: " << engine_cache_store_lib_path_
+                        << ", trt_profile_observation_runs: " << profile_observation_runs_;
 }
 
 TensorrtExecutionProvider::~TensorrtExecutionProvider() {
@@ -2690,6 +2807,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
    *      and all the profiles won't be applied and engine won't be built until EP compute time.
    */
   bool has_dynamic_shape = false;  // True if input tensor has dynamic shape and no explicit profile is specified, otherwise false.
+  bool has_dynamic_shape_tensor = false;
   bool has_explicit_profile = false;
   bool apply_explicit_profile = false;
   int num_profiles = 0;
@@ -2753,6 +2871,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
         profile_vector.push_back(shape_vector);  // only one profile needed
         input_implicit_shape_ranges[input_name][0] = profile_vector;
         has_dynamic_shape = true;
+        has_dynamic_shape_tensor = true;
       } else {
         // Execution tensor
         for (int j = 0, end = nb_dims; j < end; ++j) {
@@ -2984,6 +3103,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       // If explicit profile flag is on and engine cache enable flag is on,
       // we need to compare explicit profiles and profiles used to build the engine in order to decide whether to rebuild the engine.
       if (has_explicit_profile && engine_cache_enable_) {
+        FetchCacheFile(profile_cache_path);
         engine_update = CompareProfiles(profile_cache_path, profile_min_shapes_, profile_max_shapes_, profile_opt_shapes_);
         if (engine_update) {
           LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Engine will be built";
@@ -2992,6 +3112,9 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
         }
       }
 
+      if (engine_cache_enable_ && !engine_update) {
+        FetchCacheFile(engine_decryption_enable_ ? encrypted_engine_cache_path : engine_cache_path);
+      }
       std::ifstream engine_file(engine_cache_path, std::ios::binary | std::ios::in);
       if (engine_cache_enable_ && !engine_decryption_enable_ && engine_file && !engine_update) {
         engine_file.seekg(0, std::ios::end);
@@ -3038,6 +3161,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
         // Load timing cache from file. Create a fresh cache if the file doesn't exist
         std::unique_ptr<nvinfer1::ITimingCache> timing_cache = nullptr;
         if (timing_cache_enable_) {
+          FetchCacheFile(timing_cache_path);
           std::vector<char> loaded_timing_cache = loadTimingCacheFile(timing_cache_path);
           timing_cache.reset(trt_config->createTimingCache(static_cast<const void*>(loaded_timing_cache.data()), loaded_timing_cache.size()));
           if (timing_cache == nullptr) {
@@ -3073,6 +3197,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
           // Serialize engine profile if it has explicit profiles
           if (has_explicit_profile) {
             SerializeProfileV2(profile_cache_path, input_explicit_shape_ranges);
+            PublishCacheFile(profile_cache_path);
             LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + profile_cache_path;
           }
 
@@ -3083,13 +3208,16 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
                 return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
                                        "TensorRT EP call to engine encryption library failed");
               }
+              PublishCacheFile(encrypted_engine_cache_path);
               LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized and encrypted engine " + encrypted_engine_cache_path;
             } else {
               LOGS_DEFAULT(WARNING) << "[TensorRT EP] Engine cache encryption function is not found. No cache is written to disk";
             }
           } else {
-            std::ofstream file(engine_cache_path, std::ios::binary | std::ios::out);
-            file.write(reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
+            if (!WriteTensorrtCacheFile(engine_cache_path, serialized_engine->data(), serialized_engine->size())) {
+              return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP could not write engine cache " + engine_cache_path);
+            }
+            PublishCacheFile(engine_cache_path);
             LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized engine " + engine_cache_path;
           }
         }
@@ -3102,6 +3230,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
                                    "TensorRT EP could not serialize timing cache: " + timing_cache_path);
           }
           saveTimingCacheFile(timing_cache_path, timingCacheHostData.get());
+          PublishCacheFile(timing_cache_path);
           if (detailed_build_log_) {
             LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized timing cache " + timing_cache_path;
           }
@@ -3220,6 +3349,21 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
     }
   }
 
+  // The engines of dynamic shape subgraphs are built at inference time, in the background when enabled,
+  // and the subgraph runs on the CUDA EP until its engine is ready.
+  std::shared_ptr<TensorrtCudaFallback> cuda_fallback;
+  if (async_engine_build_enable_ && has_dynamic_shape) {
+    cuda_fallback = std::make_shared<TensorrtCudaFallback>(string_buf, device_id_, input_map, output_map);
+  }
+
+  // The profiles are derived from the input shapes of the first runs. The values of shape tensors are not observed.
+  bool observe_profiles = profile_observation_runs_ > 0 && has_dynamic_shape;
+  if (observe_profiles && has_dynamic_shape_tensor) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] trt_profile_observation_runs is ignored for " << fused_node.Name()
+                          << " since it has dynamic shape tensor inputs";
+    observe_profiles = false;
+  }
+
   // Create function state
   // TODO: remove default capture
   NodeComputeInfo compute_info;
@@ -3240,6 +3384,10 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
           engine_decryption_, engine_encryption_, timing_cache_enable_, global_cache_path_, force_timing_cache_match_,
           detailed_build_log_, build_heuristics_enable_, sparsity_enable_, builder_optimization_level_,
           auxiliary_streams_, !tactic_sources_.empty(), tactics, cuda_graph_enable_, cache_prefix_, cache_suffix, engine_hw_compatible_};
+    p->cuda_fallback = cuda_fallback;
+    if (observe_profiles) {
+      p->profile_observer = std::make_unique<TensorrtProfileObserver>(profile_observation_runs_, kMaxObservedProfiles);
+    }
     *state = p.release();
     return 0;
   };
@@ -3329,8 +3477,99 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       weight_stripped_engine_refit_ = true;
     }
 
+    // Deserialize an engine built for the current profiles, save it to the caches and update the execution context.
+    auto install_engine = [&](std::unique_ptr<nvinfer1::IHostMemory> serialized_engine,
+                              nvinfer1::IBuilderConfig& trt_config) -> Status {
+      // Destroy the IExecutionContext objects before destroying an engine object, otherwise it will lead to undefined behavior.
+      trt_state->context->reset();
+      trt_state->engine->reset();
+      *(trt_state->engine) = std::unique_ptr<nvinfer1::ICudaEngine>(
+          trt_state->runtime->deserializeCudaEngine(serialized_engine->data(), serialized_engine->size()));
+      if (!(*(trt_state->engine))) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to deserialize engine.");
+      }
+      trt_engine = trt_state->engine->get();
+      if (trt_state->engine_cache_enable) {
+        // Serialize engine profile
+        SerializeProfileV2(profile_cache_path, shape_ranges);
+        PublishCacheFile(profile_cache_path);
+        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + profile_cache_path;
+
+        // Serialize engine
+        if (trt_state->engine_decryption_enable) {
+          // Encrypt engine. The library is not always deployed with the encrypt function, so check if it is available first.
+          if (trt_state->engine_encryption != nullptr) {
+            if (!trt_state->engine_encryption(encrypted_engine_cache_path.c_str(), reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size())) {
+              return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                                     "TensorRT EP could not call engine encryption function encrypt");
+            }
+            PublishCacheFile(encrypted_engine_cache_path);
+            LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized and encrypted engine " + encrypted_engine_cache_path;
+          } else {
+            LOGS_DEFAULT(WARNING) << "[TensorRT EP] Engine cache encryption function is not found. No cache is written to disk";
+          }
+        } else {
+          if (!WriteTensorrtCacheFile(engine_cache_path, serialized_engine->data(), serialized_engine->size())) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP could not write engine cache " + engine_cache_path);
+          }
+          PublishCacheFile(engine_cache_path);
+          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + engine_cache_path;
+        }
+      }
+
+      // serialize and save timing cache
+      if (trt_state->timing_cache_enable) {
+        auto timing_cache = trt_config.getTimingCache();
+        std::unique_ptr<nvinfer1::IHostMemory> timingCacheHostData{timing_cache->serialize()};
+        if (timingCacheHostData == nullptr) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
+                                 "TensorRT EP could not serialize timing cache: " + timing_cache_path);
+        }
+        saveTimingCacheFile(timing_cache_path, timingCacheHostData.get());
+        PublishCacheFile(timing_cache_path);
+        if (detailed_build_log_) {
+          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized timing cache " + timing_cache_path;
+        }
+      }
+
+      // dump ep context model
+      if (dump_ep_context_model_ && ep_context_embed_mode_) {
+        UpdateCtxNodeModelEngineContext(model_proto_.get(), reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
+        DumpCtxModel(model_proto_.get(), ctx_model_path_);
+      }
+      context_update = true;
+
+      if (weight_stripped_engine_refit_) {
+        auto status = RefitEngine(model_path_,
+                                  onnx_model_folder_path_,
+                                  engine_cache_path,
+                                  false /* path check for security */,
+                                  trt_engine,
+                                  true /* serialize refitted engine to disk */,
+                                  detailed_build_log_);
+        if (status != Status::OK()) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, status.ErrorMessage());
+        }
+      }
+      return Status::OK();
+    };
+
+    // While an engine is built in the background, the subgraph runs on the CUDA EP. The profiles are not updated
+    // until the engine is ready, so they stay the ones the engine is built for.
+    if (trt_state->engine_build.valid()) {
+      if (trt_state->engine_build.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return trt_state->cuda_fallback->Run(ctx, stream);
+      }
+      TensorrtEngineBuild engine_build = trt_state->engine_build.get();
+      ORT_RETURN_IF_ERROR(engine_build.status);
+      ORT_RETURN_IF_ERROR(install_engine(std::move(engine_build.serialized_engine), *engine_build.config));
+      LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Engine built in the background is used for " << fused_node_name;
+    }
+
     // Load serialized engine
     if (trt_state->engine_cache_enable && trt_engine == nullptr) {
+      FetchCacheFile(trt_state->engine_decryption_enable ? encrypted_engine_cache_path : engine_cache_path);
+      FetchCacheFile(profile_cache_path);
       std::ifstream engine_file(engine_cache_path, std::ios::binary | std::ios::in);
       std::ifstream profile_file(profile_cache_path, std::ios::binary | std::ios::in);
       if (engine_file && !trt_state->engine_decryption_enable && profile_file) {
@@ -3388,20 +3627,56 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
     }
 
     // Check and update shape ranges for dynamic shape inputs.
-    for (int i = 0, end = num_inputs; i < end; ++i) {
-      auto input = trt_state->network->get()->getInput(i);
-      const std::string& input_name = input->getName();
-      input_names.insert(input_name);
-
-      // If there is any input tensor in shape_ranges, it means this input tensor has dynamic shape and its profile shape values have not yet resolved.
-      // TRT EP will help determine the min/max/opt profile values based on current input tensor value.
-      if (shape_ranges.find(input_name) != shape_ranges.end()) {
-        auto status = ApplyProfileShapesFromInputTensorValue(trt_profiles, ctx, input, shape_ranges, input_indexes, shape_tensor_values, shape_tensor_values_int64, stream, &engine_update);
-        if (status != Status::OK()) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to parse input tensor and generate optimization profiles.");
+    int profile_index = 0;
+    if (GetNumProfiles(shape_ranges) > 1) {
+      // The profiles are derived from the observed input shapes. Use the first profile covering the input shapes,
+      // or extend the closest one.
+      for (int i = 0, end = num_inputs; i < end; ++i) {
+        input_names.insert(trt_state->network->get()->getInput(i)->getName());
+      }
+      auto input_shapes = GetDynamicInputShapes(ctx, shape_ranges, input_indexes);
+      profile_index = FindProfile(shape_ranges, input_shapes);
+      if (profile_index < 0) {
+        profile_index = ExtendProfile(shape_ranges, input_shapes);
+        engine_update = true;
+      }
+    } else {
+      for (int i = 0, end = num_inputs; i < end; ++i) {
+        auto input = trt_state->network->get()->getInput(i);
+        const std::string& input_name = input->getName();
+        input_names.insert(input_name);
+
+        // If there is any input tensor in shape_ranges, it means this input tensor has dynamic shape and its profile shape values have not yet resolved.
+        // TRT EP will help determine the min/max/opt profile values based on current input tensor value.
+        if (shape_ranges.find(input_name) != shape_ranges.end()) {
+          auto status = ApplyProfileShapesFromInputTensorValue(trt_profiles, ctx, input, shape_ranges, input_indexes, shape_tensor_values, shape_tensor_values_int64, stream, &engine_update);
+          if (status != Status::OK()) {
+            return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to parse input tensor and generate optimization profiles.");
+          }
+        }
+      }
+
+      // Once enough runs are observed, rebuild the engine with the profiles derived from their input shapes.
+      auto& profile_observer = trt_state->profile_observer;
+      if (profile_observer && !profile_observer->IsComplete()) {
+        auto input_shapes = GetDynamicInputShapes(ctx, shape_ranges, input_indexes);
+        profile_observer->Record(shape_ranges, input_shapes);
+        if (profile_observer->IsComplete()) {
+          profile_observer->DeriveProfiles(shape_ranges);
+          profile_index = FindProfile(shape_ranges, input_shapes);
+          if (profile_index < 0) {
+            profile_index = ExtendProfile(shape_ranges, input_shapes);
+          }
+          engine_update = true;
+          LOGS_DEFAULT(INFO) << "[TensorRT EP] Rebuilding engine for " << fused_node_name << " with "
+                             << GetNumProfiles(shape_ranges) << " profiles derived from the observed input shapes";
         }
       }
     }
+    if (engine_update && GetNumProfiles(shape_ranges) > 1) {
+      trt_profiles = CreateProfilesFromShapeRanges(*trt_builder, *trt_state->network->get(), shape_ranges);
+      trt_state->profiles = trt_profiles;
+    }
 
     // Regenerate engine
     if (engine_update) {
@@ -3491,6 +3766,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       // Load timing cache from file. Create a fresh cache if the file doesn't exist
       std::unique_ptr<nvinfer1::ITimingCache> timing_cache = nullptr;
       if (trt_state->timing_cache_enable) {
+        FetchCacheFile(timing_cache_path);
         std::vector<char> loaded_timing_cache = loadTimingCacheFile(timing_cache_path);
         timing_cache.reset(trt_config->createTimingCache(static_cast<const void*>(loaded_timing_cache.data()), loaded_timing_cache.size()));
         if (timing_cache == nullptr) {
@@ -3510,89 +3786,27 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       }
 
       // Build engine
-      std::unique_ptr<nvinfer1::IHostMemory> serialized_engine;
-      {
-        auto lock = GetApiLock();
-        std::chrono::steady_clock::time_point engine_build_start;
-        if (detailed_build_log_) {
-          engine_build_start = std::chrono::steady_clock::now();
-        }
-        serialized_engine = std::unique_ptr<nvinfer1::IHostMemory>(
-            trt_builder->buildSerializedNetwork(*trt_state->network->get(), *trt_config));
-        if (!serialized_engine) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to create engine from network.");
-        }
-        *(trt_state->engine) = std::unique_ptr<nvinfer1::ICudaEngine>(
-            trt_state->runtime->deserializeCudaEngine(serialized_engine->data(), serialized_engine->size()));
-        if (!(*(trt_state->engine))) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to deserialize engine.");
-        }
-        if (detailed_build_log_) {
-          auto engine_build_stop = std::chrono::steady_clock::now();
-          LOGS_DEFAULT(INFO) << "TensorRT engine build for " << trt_state->trt_node_name_with_precision << " took: " << std::chrono::duration_cast<std::chrono::milliseconds>(engine_build_stop - engine_build_start).count() << "ms" << std::endl;
-        }
-      }
-      if (!(*(trt_state->engine))) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP Failed to Build Engine.");
-      }
-      trt_engine = trt_state->engine->get();
-      if (trt_state->engine_cache_enable) {
-        // Serialize engine profile
-        SerializeProfileV2(profile_cache_path, shape_ranges);
-        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + profile_cache_path;
-
-        // Serialize engine
-        if (trt_state->engine_decryption_enable) {
-          // Encrypt engine. The library is not always deployed with the encrypt function, so check if it is available first.
-          if (trt_state->engine_encryption != nullptr) {
-            if (!trt_state->engine_encryption(encrypted_engine_cache_path.c_str(), reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size())) {
-              return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
-                                     "TensorRT EP could not call engine encryption function encrypt");
-            }
-            LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized and encrypted engine " + encrypted_engine_cache_path;
-          } else {
-            LOGS_DEFAULT(WARNING) << "[TensorRT EP] Engine cache encryption function is not found. No cache is written to disk";
-          }
-        } else {
-          std::ofstream file(engine_cache_path, std::ios::binary | std::ios::out);
-          file.write(reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
-          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + engine_cache_path;
-        }
-      }
-
-      // serialize and save timing cache
-      if (trt_state->timing_cache_enable) {
-        auto timing_cache = trt_config->getTimingCache();
-        std::unique_ptr<nvinfer1::IHostMemory> timingCacheHostData{timing_cache->serialize()};
-        if (timingCacheHostData == nullptr) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
-                                 "TensorRT EP could not serialize timing cache: " + timing_cache_path);
-        }
-        saveTimingCacheFile(timing_cache_path, timingCacheHostData.get());
-        if (detailed_build_log_) {
-          LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized timing cache " + timing_cache_path;
-        }
-      }
-
-      // dump ep context model
-      if (dump_ep_context_model_ && ep_context_embed_mode_) {
-        UpdateCtxNodeModelEngineContext(model_proto_.get(), reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
-        DumpCtxModel(model_proto_.get(), ctx_model_path_);
-      }
-      context_update = true;
-
-      if (weight_stripped_engine_refit_) {
-        auto status = RefitEngine(model_path_,
-                                  onnx_model_folder_path_,
-                                  engine_cache_path,
-                                  false /* path check for security */,
-                                  trt_engine,
-                                  true /* serialize refitted engine to disk */,
-                                  detailed_build_log_);
-        if (status != Status::OK()) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, status.ErrorMessage());
-        }
+      if (trt_state->cuda_fallback && trt_state->cuda_fallback->IsAvailable()) {
+        auto trt_network = trt_state->network->get();
+        auto engine_name = trt_state->trt_node_name_with_precision;
+        trt_state->engine_build = std::async(
+            std::launch::async,
+            [this, trt_builder, trt_network, engine_name, trt_config = std::move(trt_config),
+             timing_cache = std::move(timing_cache)]() mutable {
+              TensorrtEngineBuild engine_build;
+              engine_build.status = BuildSerializedEngine(*trt_builder, *trt_network, *trt_config, engine_name,
+                                                          engine_build.serialized_engine);
+              engine_build.config = std::move(trt_config);
+              engine_build.timing_cache = std::move(timing_cache);
+              return engine_build;
+            });
+        LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Building engine for " << fused_node_name << " in the background";
+        return trt_state->cuda_fallback->Run(ctx, stream);
       }
+      std::unique_ptr<nvinfer1::IHostMemory> serialized_engine;
+      ORT_RETURN_IF_ERROR(BuildSerializedEngine(*trt_builder, *trt_state->network->get(), *trt_config,
+                                                trt_state->trt_node_name_with_precision, serialized_engine));
+      ORT_RETURN_IF_ERROR(install_engine(std::move(serialized_engine), *trt_config));
     }
 
     if (context_update) {
@@ -3609,6 +3823,13 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       trt_context = trt_state->context->get();
     }
 
+    // Select the profile covering the input shapes
+    if (trt_engine->getNbOptimizationProfiles() > 1 && trt_context->getOptimizationProfile() != profile_index) {
+      if (!trt_context->setOptimizationProfileAsync(profile_index, stream)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to set optimization profile " + std::to_string(profile_index));
+      }
+    }
+
     // Get input and output binding names
     int total_bindings = trt_engine->getNbIOTensors();
     std::vector<char const*> input_binding_names, output_binding_names;
@@ -3,6 +3,8 @@
 
 #pragma once
 #include <ctime>
+#include <future>
+#include <memory>
 #include <cudnn.h>
 #include <cublas_v2.h>
 
@@ -10,6 +12,9 @@
 
 #include "core/platform/ort_mutex.h"
 #include "core/providers/cuda/cuda_graph.h"
+#include "tensorrt_cuda_fallback.h"
+#include "tensorrt_engine_cache_store.h"
+#include "tensorrt_profile_observer.h"
 #include "tensorrt_execution_provider_info.h"
 
 namespace onnxruntime {
@@ -142,11 +147,13 @@ class OutputAllocator : public nvinfer1::IOutputAllocator {
   std::vector<int64_t> output_shapes;
 };
 
-/*
- * This map saves the dimension range of the shape of the shape tensor or execution tensor:
- * tensor name -> ( dimension -> [min, max, opt] )
- */
-using ShapeRangesMap = std::unordered_map<std::string, std::unordered_map<size_t, std::vector<std::vector<int64_t>>>>;
+// Engine built in the background, with the builder config and timing cache used to build it.
+struct TensorrtEngineBuild {
+  Status status;
+  std::unique_ptr<nvinfer1::IBuilderConfig> config;
+  std::unique_ptr<nvinfer1::ITimingCache> timing_cache;
+  std::unique_ptr<nvinfer1::IHostMemory> serialized_engine;
+};
 
 // Information to construct kernel function state.
 struct TensorrtFuncState {
@@ -194,6 +201,11 @@ struct TensorrtFuncState {
   std::string cache_prefix;
   std::string cache_suffix;
   bool engine_hw_compatible = false;
+  // Set when engines are built in the background, the subgraph runs on the CUDA EP until the build is done.
+  std::shared_ptr<TensorrtCudaFallback> cuda_fallback;
+  std::future<TensorrtEngineBuild> engine_build;
+  // Set when the profiles are derived from the input shapes of the first runs.
+  std::unique_ptr<TensorrtProfileObserver> profile_observer;
 };
 
 // Minimum information to construct kernel function state for direct engine load code path
@@ -322,6 +334,10 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   bool cuda_graph_enable_ = false;
   std::string cache_prefix_;
   bool engine_hw_compatible_ = false;
+  bool async_engine_build_enable_ = false;
+  std::string engine_cache_store_lib_path_;
+  std::unique_ptr<TensorrtEngineCacheStore> engine_cache_store_;
+  int profile_observation_runs_ = 0;
 
   // The OrtAllocator object will be get during ep compute time
   // and should be kept for the lifetime of TRT EP object.
@@ -504,6 +520,17 @@ class TensorrtExecutionProvider : public IExecutionProvider {
   */
   std::unique_lock<OrtMutex> GetApiLock() const;
 
+  /**Build the serialized engine of the network with the api lock held*/
+  Status BuildSerializedEngine(nvinfer1::IBuilder& builder, nvinfer1::INetworkDefinition& network,
+                               nvinfer1::IBuilderConfig& config, const std::string& engine_name,
+                               std::unique_ptr<nvinfer1::IHostMemory>& serialized_engine) const;
+
+  /**Fetch the cache file from the engine cache store if it is not in the local cache directory*/
+  void FetchCacheFile(const std::string& file_path) const;
+
+  /**Publish the cache file in the local cache directory to the engine cache store*/
+  void PublishCacheFile(const std::string& file_path) const;
+
   /**Check the graph is the subgraph of control flow op*/
   bool IsSubGraphOfControlFlowOp(const GraphViewer& graph) const;
 
@@ -54,6 +54,9 @@ constexpr const char* kEpContextEmbedMode = "trt_ep_context_embed_mode";
 constexpr const char* kEpContextFilePath = "trt_ep_context_file_path";
 constexpr const char* kDumpEpContextModel = "trt_dump_ep_context_model";
 constexpr const char* kEngineHwCompatible = "trt_engine_hw_compatible";
+constexpr const char* kAsyncEngineBuildEnable = "trt_async_engine_build_enable";
+constexpr const char* kEngineCacheStoreLibPath = "trt_engine_cache_store_lib_path";
+constexpr const char* kProfileObservationRuns = "trt_profile_observation_runs";
 
 }  // namespace provider_option_names
 }  // namespace tensorrt
@@ -122,6 +125,9 @@ TensorrtExecutionProviderInfo TensorrtExecutionProviderInfo::FromProviderOptions
           .AddAssignmentToReference(tensorrt::provider_option_names::kEpContextFilePath, info.ep_context_file_path)
           .AddAssignmentToReference(tensorrt::provider_option_names::kEpContextEmbedMode, info.ep_context_embed_mode)
           .AddAssignmentToReference(tensorrt::provider_option_names::kEngineHwCompatible, info.engine_hw_compatible)
+          .AddAssignmentToReference(tensorrt::provider_option_names::kAsyncEngineBuildEnable, info.async_engine_build_enable)
+          .AddAssignmentToReference(tensorrt::provider_option_names::kEngineCacheStoreLibPath, info.engine_cache_store_lib_path)
+          .AddAssignmentToReference(tensorrt::provider_option_names::kProfileObservationRuns, info.profile_observation_runs)
           .Parse(options));  // add new provider option here.
 
   info.user_compute_stream = user_compute_stream;
@@ -173,6 +179,9 @@ ProviderOptions TensorrtExecutionProviderInfo::ToProviderOptions(const TensorrtE
       {tensorrt::provider_option_names::kEpContextFilePath, MakeStringWithClassicLocale(info.ep_context_file_path)},
       {tensorrt::provider_option_names::kEpContextEmbedMode, MakeStringWithClassicLocale(info.ep_context_embed_mode)},
       {tensorrt::provider_option_names::kEngineHwCompatible, MakeStringWithClassicLocale(info.engine_hw_compatible)},
+      {tensorrt::provider_option_names::kAsyncEngineBuildEnable, MakeStringWithClassicLocale(info.async_engine_build_enable)},
+      {tensorrt::provider_option_names::kEngineCacheStoreLibPath, MakeStringWithClassicLocale(info.engine_cache_store_lib_path)},
+      {tensorrt::provider_option_names::kProfileObservationRuns, MakeStringWithClassicLocale(info.profile_observation_runs)},
   };
   return options;
 }
@@ -191,6 +200,7 @@ ProviderOptions TensorrtExecutionProviderInfo::ToProviderOptions(const OrtTensor
   const std::string kProfilesOptShapes_ = empty_if_null(info.trt_profile_opt_shapes);
   const std::string kEpContextFilePath_ = empty_if_null(info.trt_ep_context_file_path);
   const std::string kOnnxModelFolderPath_ = empty_if_null(info.trt_onnx_model_folder_path);
+  const std::string kEngineCacheStoreLibPath_ = empty_if_null(info.trt_engine_cache_store_lib_path);
 
   const ProviderOptions options{
       {tensorrt::provider_option_names::kDeviceId, MakeStringWithClassicLocale(info.device_id)},
@@ -234,6 +244,9 @@ ProviderOptions TensorrtExecutionProviderInfo::ToProviderOptions(const OrtTensor
       {tensorrt::provider_option_names::kDumpEpContextModel, MakeStringWithClassicLocale(info.trt_dump_ep_context_model)},
       {tensorrt::provider_option_names::kEpContextEmbedMode, MakeStringWithClassicLocale(info.trt_ep_context_embed_mode)},
       {tensorrt::provider_option_names::kEngineHwCompatible, MakeStringWithClassicLocale(info.trt_engine_hw_compatible)},
+      {tensorrt::provider_option_names::kAsyncEngineBuildEnable, MakeStringWithClassicLocale(info.trt_async_engine_build_enable)},
+      {tensorrt::provider_option_names::kEngineCacheStoreLibPath, kEngineCacheStoreLibPath_},
+      {tensorrt::provider_option_names::kProfileObservationRuns, MakeStringWithClassicLocale(info.trt_profile_observation_runs)},
   };
   return options;
 }
@@ -336,5 +349,8 @@ void TensorrtExecutionProviderInfo::UpdateProviderOptions(void* provider_options
   trt_provider_options_v2.trt_ep_context_embed_mode = internal_options.ep_context_embed_mode;
   trt_provider_options_v2.trt_ep_context_file_path = copy_string_if_needed(internal_options.ep_context_file_path);
   trt_provider_options_v2.trt_engine_hw_compatible = internal_options.engine_hw_compatible;
+  trt_provider_options_v2.trt_async_engine_build_enable = internal_options.async_engine_build_enable;
+  trt_provider_options_v2.trt_engine_cache_store_lib_path = copy_string_if_needed(internal_options.engine_cache_store_lib_path);
+  trt_provider_options_v2.trt_profile_observation_runs = internal_options.profile_observation_runs;
 }
 }  // namespace onnxruntime
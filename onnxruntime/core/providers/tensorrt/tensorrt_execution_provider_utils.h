@@ -14,6 +14,7 @@
 #include "core/providers/cuda/cuda_pch.h"
 #include "core/common/path_string.h"
 #include "core/framework/murmurhash3.h"
+#include "tensorrt_cache_file.h"
 
 namespace fs = std::filesystem;
 
@@ -256,11 +257,11 @@ void SerializeProfileV2(const std::string& file_name, std::unordered_map<std::st
   builder.Finish();
 
   // Save flexbuffer
-  std::ofstream file(file_name, std::ios::binary | std::ios::out);
   auto buf = builder.GetBuffer();
   size_t size = builder.GetSize();
-  file.write(reinterpret_cast<const char*>(&buf[0]), size);
-  file.close();
+  if (!WriteTensorrtCacheFile(file_name, &buf[0], size)) {
+    LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write profile cache to: " << file_name;
+  }
 }
 
 /*
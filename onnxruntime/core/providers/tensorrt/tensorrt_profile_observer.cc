@@ -0,0 +1,173 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "tensorrt_profile_observer.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+namespace onnxruntime {
+
+TensorrtProfileObserver::TensorrtProfileObserver(size_t num_observations, size_t max_profiles)
+    : num_observations_(num_observations), max_profiles_(std::max<size_t>(max_profiles, 1)) {}
+
+void TensorrtProfileObserver::Record(const ShapeRangesMap& shape_ranges, const InputShapesMap& input_shapes) {
+  if (dims_.empty()) {
+    for (const auto& input : shape_ranges) {
+      for (const auto& dim : input.second) {
+        dims_.emplace_back(input.first, dim.first);
+      }
+    }
+    std::sort(dims_.begin(), dims_.end());
+  }
+
+  std::vector<int64_t> observation;
+  observation.reserve(dims_.size());
+  for (const auto& dim : dims_) {
+    auto it = input_shapes.find(dim.first);
+    if (it == input_shapes.end() || dim.second >= it->second.size()) {
+      return;
+    }
+    observation.push_back(it->second[dim.second]);
+  }
+  observations_.push_back(std::move(observation));
+}
+
+void TensorrtProfileObserver::DeriveProfiles(ShapeRangesMap& shape_ranges) const {
+  if (observations_.empty()) {
+    return;
+  }
+
+  auto num_elements = [](const std::vector<int64_t>& observation) {
+    int64_t size = 1;
+    for (auto value : observation) {
+      size *= std::max<int64_t>(value, 1);
+    }
+    return size;
+  };
+  std::vector<std::vector<int64_t>> observations = observations_;
+  std::stable_sort(observations.begin(), observations.end(),
+                   [&](const std::vector<int64_t>& a, const std::vector<int64_t>& b) {
+                     return num_elements(a) < num_elements(b);
+                   });
+
+  const size_t num_profiles = std::min(max_profiles_, observations.size());
+  const size_t num_dims = dims_.size();
+  // [profile][dim] -> [min, max, opt]
+  std::vector<std::vector<std::vector<int64_t>>> profiles(num_profiles);
+  for (size_t p = 0; p < num_profiles; ++p) {
+    const size_t begin = p * observations.size() / num_profiles;
+    const size_t end = (p + 1) * observations.size() / num_profiles;
+
+    std::map<std::vector<int64_t>, size_t> counts;
+    for (size_t i = begin; i < end; ++i) {
+      ++counts[observations[i]];
+    }
+    const std::vector<int64_t>* opt = &observations[begin];
+    size_t opt_count = 0;
+    for (const auto& count : counts) {
+      if (count.second >= opt_count) {
+        opt = &count.first;
+        opt_count = count.second;
+      }
+    }
+
+    profiles[p].resize(num_dims);
+    for (size_t d = 0; d < num_dims; ++d) {
+      int64_t min_value = std::numeric_limits<int64_t>::max();
+      int64_t max_value = std::numeric_limits<int64_t>::min();
+      for (size_t i = begin; i < end; ++i) {
+        min_value = std::min(min_value, observations[i][d]);
+        max_value = std::max(max_value, observations[i][d]);
+      }
+      profiles[p][d] = {min_value, max_value, (*opt)[d]};
+    }
+  }
+
+  for (size_t d = 0; d < num_dims; ++d) {
+    auto& ranges = shape_ranges[dims_[d].first][dims_[d].second];
+    ranges.clear();
+    for (size_t p = 0; p < num_profiles; ++p) {
+      ranges.push_back(profiles[p][d]);
+    }
+  }
+}
+
+size_t GetNumProfiles(const ShapeRangesMap& shape_ranges) {
+  for (const auto& input : shape_ranges) {
+    for (const auto& dim : input.second) {
+      return dim.second.size();
+    }
+  }
+  return 0;
+}
+
+namespace {
+
+// Sum of the distances of the dynamic dimensions of input_shapes to the range of the profile.
+int64_t GetProfileDistance(const ShapeRangesMap& shape_ranges, const InputShapesMap& input_shapes, size_t profile) {
+  int64_t distance = 0;
+  for (const auto& input : shape_ranges) {
+    auto shape = input_shapes.find(input.first);
+    if (shape == input_shapes.end()) {
+      continue;
+    }
+    for (const auto& dim : input.second) {
+      if (dim.first >= shape->second.size() || profile >= dim.second.size()) {
+        continue;
+      }
+      const int64_t value = shape->second[dim.first];
+      const auto& range = dim.second[profile];
+      if (value < range[0]) {
+        distance += range[0] - value;
+      } else if (value > range[1]) {
+        distance += value - range[1];
+      }
+    }
+  }
+  return distance;
+}
+
+}  // namespace
+
+int FindProfile(const ShapeRangesMap& shape_ranges, const InputShapesMap& input_shapes) {
+  const size_t num_profiles = GetNumProfiles(shape_ranges);
+  for (size_t p = 0; p < num_profiles; ++p) {
+    if (GetProfileDistance(shape_ranges, input_shapes, p) == 0) {
+      return static_cast<int>(p);
+    }
+  }
+  return -1;
+}
+
+int ExtendProfile(ShapeRangesMap& shape_ranges, const InputShapesMap& input_shapes) {
+  const size_t num_profiles = GetNumProfiles(shape_ranges);
+  size_t closest = 0;
+  int64_t closest_distance = std::numeric_limits<int64_t>::max();
+  for (size_t p = 0; p < num_profiles; ++p) {
+    const int64_t distance = GetProfileDistance(shape_ranges, input_shapes, p);
+    if (distance < closest_distance) {
+      closest = p;
+      closest_distance = distance;
+    }
+  }
+
+  for (auto& input : shape_ranges) {
+    auto shape = input_shapes.find(input.first);
+    if (shape == input_shapes.end()) {
+      continue;
+    }
+    for (auto& dim : input.second) {
+      if (dim.first >= shape->second.size() || closest >= dim.second.size()) {
+        continue;
+      }
+      auto& range = dim.second[closest];
+      range[0] = std::min(range[0], shape->second[dim.first]);
+      range[1] = std::max(range[1], shape->second[dim.first]);
+    }
+  }
+  return static_cast<int>(closest);
+}
+
+}  // namespace onnxruntime
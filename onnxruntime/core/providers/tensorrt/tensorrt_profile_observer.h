@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace onnxruntime {
+
+/*
+ * This map saves the dimension range of the shape of the shape tensor or execution tensor:
+ * tensor name -> ( dimension -> [min, max, opt] )
+ */
+using ShapeRangesMap = std::unordered_map<std::string, std::unordered_map<size_t, std::vector<std::vector<int64_t>>>>;
+
+// Input name -> shape of the input tensor of the current run
+using InputShapesMap = std::unordered_map<std::string, std::vector<int64_t>>;
+
+// Maximum number of optimization profiles derived from the observed input shapes
+constexpr size_t kMaxObservedProfiles = 4;
+
+/*
+ * Records the input shapes of the first runs of a dynamic shape subgraph and derives a set of optimization profiles
+ * covering them, so that the engine is rebuilt once for the observed traffic instead of every time an input shape is
+ * outside of the single profile.
+ *
+ * The observed shapes are ordered by their number of elements and split into groups of the same number of runs, one
+ * profile per group. The min/max shapes of a profile are the bounds of the shapes of its group and the opt shape is
+ * the most frequent one.
+ *
+ * Only execution tensor inputs are observed, the values of shape tensor inputs are not.
+ */
+class TensorrtProfileObserver {
+ public:
+  TensorrtProfileObserver(size_t num_observations, size_t max_profiles);
+
+  // Record the dynamic dimensions of shape_ranges in input_shapes.
+  void Record(const ShapeRangesMap& shape_ranges, const InputShapesMap& input_shapes);
+
+  bool IsComplete() const { return observations_.size() >= num_observations_; }
+
+  // Replace the profiles of shape_ranges with the profiles derived from the observed shapes.
+  void DeriveProfiles(ShapeRangesMap& shape_ranges) const;
+
+ private:
+  const size_t num_observations_;
+  const size_t max_profiles_;
+  // dynamic dimensions, in the order of the values of the observations
+  std::vector<std::pair<std::string, size_t>> dims_;
+  std::vector<std::vector<int64_t>> observations_;
+};
+
+// Number of profiles of shape_ranges.
+size_t GetNumProfiles(const ShapeRangesMap& shape_ranges);
+
+// Index of the first profile of shape_ranges covering input_shapes, -1 if there is none.
+int FindProfile(const ShapeRangesMap& shape_ranges, const InputShapesMap& input_shapes);
+
+// Extend the profile of shape_ranges that is the closest to input_shapes to cover them. Returns its index.
+int ExtendProfile(ShapeRangesMap& shape_ranges, const InputShapesMap& input_shapes);
+
+}  // namespace onnxruntime
@@ -116,6 +116,9 @@ struct Tensorrt_Provider : Provider {
     info.ep_context_embed_mode = options.trt_ep_context_embed_mode;
     info.engine_cache_prefix = options.trt_engine_cache_prefix == nullptr ? "" : options.trt_engine_cache_prefix;
     info.engine_hw_compatible = options.trt_engine_hw_compatible != 0;
+    info.async_engine_build_enable = options.trt_async_engine_build_enable != 0;
+    info.engine_cache_store_lib_path = options.trt_engine_cache_store_lib_path == nullptr ? "" : options.trt_engine_cache_store_lib_path;
+    info.profile_observation_runs = options.trt_profile_observation_runs;
 
     return std::make_shared<TensorrtProviderFactory>(info);
   }
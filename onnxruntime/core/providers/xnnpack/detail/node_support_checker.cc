@@ -15,6 +15,7 @@
 #include "core/providers/xnnpack/detail/utils.h"
 
 // each operator provides a helper to check if supported
+#include "core/providers/xnnpack/math/elementwise.h"
 #include "core/providers/xnnpack/math/gemm.h"
 #include "core/providers/xnnpack/math/matmul.h"
 #include "core/providers/xnnpack/math/softmax.h"
@@ -22,7 +23,9 @@
 #include "core/providers/xnnpack/nn/conv.h"
 #include "core/providers/xnnpack/nn/conv_transpose.h"
 #include "core/providers/xnnpack/nn/max_pool.h"
+#include "core/providers/xnnpack/tensor/concat.h"
 #include "core/providers/xnnpack/tensor/resize.h"
+#include "core/providers/xnnpack/tensor/transpose.h"
 
 namespace onnxruntime {
 namespace xnnpack {
@@ -100,6 +103,12 @@ bool NodeSupportChecker::IsNodeSupported(const NodeUnit& nodeunit) {
       {"Resize", Resize::IsOnnxNodeSupported},
       {"Gemm", Gemm::IsOnnxNodeSupported},
       {"MatMul", MatMul::IsOnnxNodeSupported},
+      {"Add", BinaryElementwise::IsOnnxNodeSupported},
+      {"Sub", BinaryElementwise::IsOnnxNodeSupported},
+      {"Mul", BinaryElementwise::IsOnnxNodeSupported},
+      {"Div", BinaryElementwise::IsOnnxNodeSupported},
+      {"Transpose", Transpose::IsOnnxNodeSupported},
+      {"Concat", Concat::IsOnnxNodeSupported},
   };
 
   bool supported = false;
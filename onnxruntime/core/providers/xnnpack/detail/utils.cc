@@ -111,6 +111,48 @@ bool IsPaddingTypeSupported(AutoPadType auto_pad) {
          auto_pad == AutoPadType::SAME_UPPER;
 }
 
+bool IsFp16Supported() {
+  // XNNPACK reports missing fp16 arithmetic when creating an fp16 operator. The EP has initialized XNNPACK
+  // when creating its allocator, before partitioning, so the result can be cached.
+  static const bool supported = []() {
+    struct xnn_operator* p = nullptr;
+    const xnn_status status = xnn_create_add_nd_f16(-std::numeric_limits<float>::infinity(),
+                                                    std::numeric_limits<float>::infinity(), 0, &p);
+    XnnpackOperator op(p);
+    return status == xnn_status_success;
+  }();
+  return supported;
+}
+
+OpComputeType GetFloatComputeType(int32_t elem_type) {
+  if (elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    return op_compute_type_fp32;
+  }
+  if (elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16 && IsFp16Supported()) {
+    return op_compute_type_fp16;
+  }
+  return op_compute_type_invalid;
+}
+
+size_t GetDataMovementElementSize(int32_t elem_type) {
+  switch (elem_type) {
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+      return 1;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+      return 2;
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT32:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
 typedef std::string ONNXOpType;
 
 static const std::unordered_map<QuantizedOpType, ONNXOpType> qdq_to_onnx_type_map = {
@@ -77,6 +77,17 @@ struct XnnpackOperatorDeleter {
 
 bool IsPaddingTypeSupported(AutoPadType auto_pad);
 
+// Returns true if XNNPACK has fp16 arithmetic kernels for the current hardware.
+bool IsFp16Supported();
+
+// Returns the compute type of a float or (if supported by the hardware) float16 tensor of elem_type,
+// op_compute_type_invalid otherwise.
+OpComputeType GetFloatComputeType(int32_t elem_type);
+
+// Returns the size in bytes of the elements of a tensor of elem_type if the XNNPACK data movement operators
+// (transpose, copy) support it, 0 otherwise.
+size_t GetDataMovementElementSize(int32_t elem_type);
+
 using XnnpackOperator = std::unique_ptr<struct xnn_operator, XnnpackOperatorDeleter>;
 
 std::unique_ptr<IndexedSubGraph::MetaDef> FuseActivation(const NodeUnit& conv_unit, const NodeUnit& activation,
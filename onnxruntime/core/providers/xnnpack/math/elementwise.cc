@@ -0,0 +1,227 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/xnnpack/math/elementwise.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/framework/op_kernel.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+namespace xnnpack {
+
+namespace {
+using CreateFn = xnn_status (*)(float output_min, float output_max, uint32_t flags, xnn_operator_t* op_out);
+using ReshapeFn = xnn_status (*)(xnn_operator_t op, size_t num_input1_dims, const size_t* input1_shape,
+                                 size_t num_input2_dims, const size_t* input2_shape, pthreadpool_t threadpool);
+
+// the rank is limited by XNNPACK. inputs with unknown rank are left to the CPU EP as the limit can't be checked.
+bool IsInputSupported(const NodeArg& arg, int32_t& elem_type) {
+  const auto* shape = arg.Shape();
+  return GetType(arg, elem_type) && shape != nullptr && shape->dim_size() <= XNN_MAX_TENSOR_DIMS;
+}
+
+Status ComputeBroadcastShape(const TensorShape& a, const TensorShape& b, TensorShapeVector& output_dims) {
+  const size_t rank = std::max(a.NumDimensions(), b.NumDimensions());
+  output_dims.assign(rank, 1);
+  for (size_t i = 0; i < rank; ++i) {
+    const int64_t a_dim = i < a.NumDimensions() ? a[a.NumDimensions() - 1 - i] : 1;
+    const int64_t b_dim = i < b.NumDimensions() ? b[b.NumDimensions() - 1 - i] : 1;
+    ORT_RETURN_IF_NOT(a_dim == b_dim || a_dim == 1 || b_dim == 1,
+                      "Can't broadcast ", a, " and ", b);
+    output_dims[rank - 1 - i] = a_dim == 1 ? b_dim : a_dim;
+  }
+  return Status::OK();
+}
+}  // namespace
+
+bool BinaryElementwise::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& /*graph*/) {
+  bool supported = false;
+
+  // use do {} while(false) so it's easier to set a breakpoint on the return
+  do {
+    // QDQ groups of the binary ops are handled by the CPU EP
+    if (node_unit.UnitType() != NodeUnit::Type::SingleNode) {
+      break;
+    }
+
+    const auto& inputs = node_unit.Inputs();
+    int32_t a_type = 0;
+    int32_t b_type = 0;
+    if (inputs.size() != 2 ||
+        !IsInputSupported(inputs[0].node_arg, a_type) ||
+        !IsInputSupported(inputs[1].node_arg, b_type) ||
+        a_type != b_type) {
+      break;
+    }
+
+    if (GetFloatComputeType(a_type) == OpComputeType::op_compute_type_invalid) {
+      break;
+    }
+
+    supported = true;
+  } while (false);
+
+  return supported;
+}
+
+BinaryElementwise::BinaryElementwise(const OpKernelInfo& info) : XnnpackKernel(info) {
+  const auto& node = info.node();
+  const auto& op_type = node.OpType();
+  if (op_type == "Add") {
+    op_kind_ = OpKind::kAdd;
+  } else if (op_type == "Sub") {
+    op_kind_ = OpKind::kSub;
+  } else if (op_type == "Mul") {
+    op_kind_ = OpKind::kMul;
+  } else {
+    ORT_ENFORCE(op_type == "Div", "unexpected op type ", op_type);
+    op_kind_ = OpKind::kDiv;
+  }
+
+  int x_dtype = 0;
+  ORT_ENFORCE(GetType(*node.InputDefs()[0], x_dtype));
+  op_type_ = GetFloatComputeType(x_dtype);
+  ORT_ENFORCE(op_type_ != OpComputeType::op_compute_type_invalid,
+              "unsupported ", op_type, " in XnnpackExecutionProvider, we have FLOAT|FLOAT16, but got ", x_dtype);
+
+  const bool fp16 = op_type_ == OpComputeType::op_compute_type_fp16;
+  CreateFn create = nullptr;
+  switch (op_kind_) {
+    case OpKind::kAdd:
+      create = fp16 ? xnn_create_add_nd_f16 : xnn_create_add_nd_f32;
+      break;
+    case OpKind::kSub:
+      create = fp16 ? xnn_create_subtract_nd_f16 : xnn_create_subtract_nd_f32;
+      break;
+    case OpKind::kMul:
+      create = fp16 ? xnn_create_multiply_nd_f16 : xnn_create_multiply_nd_f32;
+      break;
+    case OpKind::kDiv:
+      create = fp16 ? xnn_create_divide_nd_f16 : xnn_create_divide_nd_f32;
+      break;
+  }
+
+  struct xnn_operator* p = nullptr;
+  const xnn_status xstatus = create(-std::numeric_limits<float>::infinity(),
+                                    std::numeric_limits<float>::infinity(),
+                                    0,  // flags
+                                    &p);
+  ORT_ENFORCE(xstatus == xnn_status_success, "xnn_create_", op_type, "_nd_",
+              OpTypeToString(op_type_), " failed. Status:", xstatus);
+  op0_.reset(p);
+}
+
+Status BinaryElementwise::Compute(OpKernelContext* ctx) const {
+  const auto* A = ctx->Input<Tensor>(0);
+  const auto* B = ctx->Input<Tensor>(1);
+  TensorShapeVector output_dims;
+  ORT_RETURN_IF_ERROR(ComputeBroadcastShape(A->Shape(), B->Shape(), output_dims));
+  auto* Y = ctx->Output(0, output_dims);
+
+  // edge case. one or more dims with value of 0. nothing to do
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  const bool fp16 = op_type_ == OpComputeType::op_compute_type_fp16;
+  ReshapeFn reshape = nullptr;
+  switch (op_kind_) {
+    case OpKind::kAdd:
+      reshape = fp16 ? xnn_reshape_add_nd_f16 : xnn_reshape_add_nd_f32;
+      break;
+    case OpKind::kSub:
+      reshape = fp16 ? xnn_reshape_subtract_nd_f16 : xnn_reshape_subtract_nd_f32;
+      break;
+    case OpKind::kMul:
+      reshape = fp16 ? xnn_reshape_multiply_nd_f16 : xnn_reshape_multiply_nd_f32;
+      break;
+    case OpKind::kDiv:
+      reshape = fp16 ? xnn_reshape_divide_nd_f16 : xnn_reshape_divide_nd_f32;
+      break;
+  }
+
+  pthreadpool_t threadpool = GetThreadPool();
+  auto a_shape = A->Shape().AsShapeVector();
+  auto b_shape = B->Shape().AsShapeVector();
+  const InlinedVector<size_t> a_dims(a_shape.begin(), a_shape.end());
+  const InlinedVector<size_t> b_dims(b_shape.begin(), b_shape.end());
+  xnn_status status = reshape(op0_.get(), a_dims.size(), a_dims.data(), b_dims.size(), b_dims.data(), threadpool);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_", Node().OpType(), "_nd_", OpTypeToString(op_type_),
+                           " returned ", status);
+  }
+
+  if (fp16) {
+    const void* a = A->DataRaw();
+    const void* b = B->DataRaw();
+    void* y = Y->MutableDataRaw();
+    switch (op_kind_) {
+      case OpKind::kAdd:
+        status = xnn_setup_add_nd_f16(op0_.get(), a, b, y);
+        break;
+      case OpKind::kSub:
+        status = xnn_setup_subtract_nd_f16(op0_.get(), a, b, y);
+        break;
+      case OpKind::kMul:
+        status = xnn_setup_multiply_nd_f16(op0_.get(), a, b, y);
+        break;
+      case OpKind::kDiv:
+        status = xnn_setup_divide_nd_f16(op0_.get(), a, b, y);
+        break;
+    }
+  } else {
+    const float* a = A->Data<float>();
+    const float* b = B->Data<float>();
+    float* y = Y->MutableData<float>();
+    switch (op_kind_) {
+      case OpKind::kAdd:
+        status = xnn_setup_add_nd_f32(op0_.get(), a, b, y);
+        break;
+      case OpKind::kSub:
+        status = xnn_setup_subtract_nd_f32(op0_.get(), a, b, y);
+        break;
+      case OpKind::kMul:
+        status = xnn_setup_multiply_nd_f32(op0_.get(), a, b, y);
+        break;
+      case OpKind::kDiv:
+        status = xnn_setup_divide_nd_f32(op0_.get(), a, b, y);
+        break;
+    }
+  }
+
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_", Node().OpType(), "_nd_", OpTypeToString(op_type_),
+                           " returned ", status);
+  }
+
+  status = RunOperator(op0_.get(), *ctx);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
+  }
+
+  return Status::OK();
+}
+
+#define REGISTER_BINARY_ELEMENTWISE_KERNELS(op)                                                              \
+  ONNX_OPERATOR_VERSIONED_KERNEL_EX(op, kOnnxDomain, 7, 12, kXnnpackExecutionProvider,                       \
+                                    KernelDefBuilder().TypeConstraint(                                       \
+                                        "T", BuildKernelDefConstraints<float, MLFloat16>()),                 \
+                                    BinaryElementwise);                                                      \
+  ONNX_OPERATOR_VERSIONED_KERNEL_EX(op, kOnnxDomain, 13, 13, kXnnpackExecutionProvider,                      \
+                                    KernelDefBuilder().TypeConstraint(                                       \
+                                        "T", BuildKernelDefConstraints<float, MLFloat16>()),                 \
+                                    BinaryElementwise);                                                      \
+  ONNX_OPERATOR_KERNEL_EX(op, kOnnxDomain, 14, kXnnpackExecutionProvider,                                    \
+                          KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraints<float, MLFloat16>()), \
+                          BinaryElementwise);
+
+REGISTER_BINARY_ELEMENTWISE_KERNELS(Add)
+REGISTER_BINARY_ELEMENTWISE_KERNELS(Sub)
+REGISTER_BINARY_ELEMENTWISE_KERNELS(Mul)
+REGISTER_BINARY_ELEMENTWISE_KERNELS(Div)
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/xnnpack/xnnpack_kernel.h"
+#include "core/providers/xnnpack/detail/utils.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class Node;
+namespace xnnpack {
+
+// Add, Sub, Mul and Div with multidirectional broadcasting
+class BinaryElementwise : public XnnpackKernel {
+ public:
+  BinaryElementwise(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+  static bool IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& graph);
+
+ private:
+  enum class OpKind : uint8_t {
+    kAdd,
+    kSub,
+    kMul,
+    kDiv,
+  };
+
+  OpKind op_kind_;
+  OpComputeType op_type_ = OpComputeType::op_compute_type_invalid;
+  XnnpackOperator op0_ = nullptr;
+};
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
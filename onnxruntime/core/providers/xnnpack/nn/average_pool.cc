@@ -273,7 +273,7 @@ Status AveragePool::Compute(OpKernelContext* context) const {
                            " returned ", status);
   }
 
-  status = xnn_run_operator(op0_.get(), threadpool);
+  status = RunOperator(op0_.get(), *context);
   if (status != xnn_status_success) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
   }
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/xnnpack/tensor/concat.h"
+
+#include <numeric>
+
+#include "core/framework/op_kernel.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+namespace xnnpack {
+
+bool Concat::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& /*graph*/) {
+  bool supported = false;
+
+  // use do {} while(false) so it's easier to set a breakpoint on the return
+  do {
+    if (node_unit.UnitType() != NodeUnit::Type::SingleNode) {
+      break;
+    }
+
+    const auto& inputs = node_unit.Inputs();
+    int32_t x_type = 0;
+    if (inputs.empty() || !GetType(inputs[0].node_arg, x_type) || GetDataMovementElementSize(x_type) == 0) {
+      break;
+    }
+
+    const auto* x_shape = inputs[0].node_arg.Shape();
+    if (!x_shape || x_shape->dim_size() == 0) {
+      break;
+    }
+
+    ProtoHelperNodeContext nc(node_unit.GetNode());
+    OpNodeProtoHelper info(&nc);
+    int64_t axis = 0;
+    if (!info.GetAttr<int64_t>("axis", &axis).IsOK()) {
+      break;
+    }
+    const int rank = x_shape->dim_size();
+    if (axis < -rank || axis >= rank) {
+      break;
+    }
+    axis = HandleNegativeAxis(axis, rank);
+
+    // require the dims from the axis on to be known so we can construct the xnnpack kernel prior to Compute
+    bool static_inner_dims = true;
+    for (const auto& input : inputs) {
+      const auto* shape = input.node_arg.Shape();
+      if (!shape || shape->dim_size() != rank) {
+        static_inner_dims = false;
+        break;
+      }
+      for (int i = gsl::narrow_cast<int>(axis); i < rank; ++i) {
+        if (!shape->dim(i).has_dim_value()) {
+          static_inner_dims = false;
+          break;
+        }
+      }
+    }
+    if (!static_inner_dims) {
+      break;
+    }
+
+    supported = true;
+  } while (false);
+
+  return supported;
+}
+
+Concat::Concat(const OpKernelInfo& info) : XnnpackKernel(info) {
+  const auto& input_defs = info.node().InputDefs();
+  int x_dtype = 0;
+  ORT_ENFORCE(GetType(*input_defs[0], x_dtype));
+  element_size_ = GetDataMovementElementSize(x_dtype);
+  ORT_ENFORCE(element_size_ != 0, "unsupported Concat in XnnpackExecutionProvider, element type ", x_dtype);
+
+  // we have checked the axis and the shapes in GetCapability
+  ORT_ENFORCE(info.GetAttr<int64_t>("axis", &axis_).IsOK());
+  const auto rank = input_defs[0]->Shape()->dim_size();
+  axis_ = HandleNegativeAxis(axis_, rank);
+
+  for (const auto* input_def : input_defs) {
+    auto input_shape = utils::GetTensorShapeFromTensorShapeProto(*input_def->Shape());
+    input_channels_.push_back(gsl::narrow<size_t>(input_shape.SizeFromDimension(gsl::narrow<size_t>(axis_))));
+  }
+  const size_t output_channels = std::accumulate(input_channels_.begin(), input_channels_.end(), size_t{0});
+
+  for (const size_t channels : input_channels_) {
+    xnn_status xstatus = xnn_status_invalid_state;
+    struct xnn_operator* p = nullptr;
+    switch (element_size_) {
+      case 1:
+        xstatus = xnn_create_copy_nc_x8(channels, channels, output_channels, 0, &p);
+        break;
+      case 2:
+        xstatus = xnn_create_copy_nc_x16(channels, channels, output_channels, 0, &p);
+        break;
+      default:
+        xstatus = xnn_create_copy_nc_x32(channels, channels, output_channels, 0, &p);
+        break;
+    }
+    ORT_ENFORCE(xstatus == xnn_status_success, "xnn_create_copy_nc_x", element_size_ * 8,
+                " failed. Status:", xstatus);
+    ops_.emplace_back(p);
+  }
+}
+
+Status Concat::Compute(OpKernelContext* ctx) const {
+  const int input_count = ctx->InputCount();
+  const auto& X_shape = ctx->Input<Tensor>(0)->Shape();
+
+  const size_t axis = gsl::narrow<size_t>(axis_);
+  TensorShapeVector output_dims = X_shape.AsShapeVector();
+  output_dims[axis] = 0;
+  for (int i = 0; i < input_count; ++i) {
+    const auto& shape = ctx->Input<Tensor>(i)->Shape();
+    ORT_RETURN_IF_NOT(shape.NumDimensions() == X_shape.NumDimensions(), "Concat inputs must have the same rank");
+    for (size_t d = 0; d < shape.NumDimensions(); ++d) {
+      ORT_RETURN_IF_NOT(d == axis || shape[d] == X_shape[d],
+                        "Concat inputs must have the same shape except for the dimension of the axis");
+    }
+    output_dims[axis] += shape[axis];
+  }
+  auto* Y = ctx->Output(0, output_dims);
+
+  // edge case. one or more dims with value of 0. nothing to do
+  const size_t batch_size = gsl::narrow<size_t>(X_shape.SizeToDimension(axis));
+  if (Y->Shape().Size() == 0 || batch_size == 0) {
+    return Status::OK();
+  }
+
+  pthreadpool_t threadpool = GetThreadPool();
+  auto reshape_fn = element_size_ == 1   ? xnn_reshape_copy_nc_x8
+                    : element_size_ == 2 ? xnn_reshape_copy_nc_x16
+                                         : xnn_reshape_copy_nc_x32;
+  auto setup_fn = element_size_ == 1   ? xnn_setup_copy_nc_x8
+                  : element_size_ == 2 ? xnn_setup_copy_nc_x16
+                                       : xnn_setup_copy_nc_x32;
+
+  // each input is copied to its columns of the output rows
+  auto* output = static_cast<uint8_t*>(Y->MutableDataRaw());
+  for (int i = 0; i < input_count; ++i) {
+    const auto* X = ctx->Input<Tensor>(i);
+    if (input_channels_[i] != 0) {
+      auto* op = ops_[i].get();
+      xnn_status status = reshape_fn(op, batch_size, threadpool);
+      if (status != xnn_status_success) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_copy_nc_x", element_size_ * 8, " returned ", status);
+      }
+
+      status = setup_fn(op, X->DataRaw(), output);
+      if (status != xnn_status_success) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_copy_nc_x", element_size_ * 8, " returned ", status);
+      }
+
+      status = RunOperator(op, *ctx);
+      if (status != xnn_status_success) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
+      }
+    }
+    output += input_channels_[i] * element_size_;
+  }
+
+  return Status::OK();
+}
+
+#define CONCAT_TYPES BuildKernelDefConstraints<float, MLFloat16, int8_t, uint8_t, bool, int16_t, uint16_t, \
+                                               int32_t, uint32_t>()
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(Concat, kOnnxDomain, 4, 10, kXnnpackExecutionProvider,
+                                  KernelDefBuilder().TypeConstraint("T", CONCAT_TYPES),
+                                  Concat);
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(Concat, kOnnxDomain, 11, 12, kXnnpackExecutionProvider,
+                                  KernelDefBuilder().TypeConstraint("T", CONCAT_TYPES),
+                                  Concat);
+
+ONNX_OPERATOR_KERNEL_EX(Concat, kOnnxDomain, 13, kXnnpackExecutionProvider,
+                        KernelDefBuilder().TypeConstraint("T", CONCAT_TYPES),
+                        Concat);
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
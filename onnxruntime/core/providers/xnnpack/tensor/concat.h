@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <vector>
+
+#include "core/providers/xnnpack/xnnpack_kernel.h"
+#include "core/providers/xnnpack/detail/utils.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class NodeUnit;
+namespace xnnpack {
+
+// Concat as one strided copy per input. The dims from the axis on must be known so the copy operators can be
+// created prior to Compute.
+class Concat : public XnnpackKernel {
+ public:
+  Concat(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+  static bool IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& graph);
+
+ private:
+  int64_t axis_ = 0;
+  // size in bytes of the elements. XNNPACK copies 1, 2 and 4 byte elements.
+  size_t element_size_ = 0;
+  // number of elements from the axis on of each input, i.e. its offset in a row of the output
+  std::vector<size_t> input_channels_;
+  std::vector<XnnpackOperator> ops_;
+};
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
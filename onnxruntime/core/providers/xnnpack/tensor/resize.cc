@@ -272,7 +272,7 @@ Status Resize::ComputeInternal(OpKernelContext* ctx, const Tensor* input,
                            OpTypeToString(op_type_), " returned ", status);
   }
 
-  status = xnn_run_operator(op0_.get(), threadpool);
+  status = RunOperator(op0_.get(), *ctx);
   if (status != xnn_status_success) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
   }
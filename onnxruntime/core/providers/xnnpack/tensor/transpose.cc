@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/xnnpack/tensor/transpose.h"
+
+#include "core/framework/op_kernel.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+namespace xnnpack {
+
+bool Transpose::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& /*graph*/) {
+  bool supported = false;
+
+  // use do {} while(false) so it's easier to set a breakpoint on the return
+  do {
+    if (node_unit.UnitType() != NodeUnit::Type::SingleNode) {
+      break;
+    }
+
+    const auto& x_arg = node_unit.Inputs()[0].node_arg;
+    int32_t x_type = 0;
+    if (!GetType(x_arg, x_type) || GetDataMovementElementSize(x_type) == 0) {
+      break;
+    }
+
+    // the rank is limited by XNNPACK
+    const auto* x_shape = x_arg.Shape();
+    if (!x_shape || x_shape->dim_size() == 0 || x_shape->dim_size() > XNN_MAX_TENSOR_DIMS) {
+      break;
+    }
+
+    supported = true;
+  } while (false);
+
+  return supported;
+}
+
+Transpose::Transpose(const OpKernelInfo& info) : XnnpackKernel(info), TransposeBase(info) {
+  int x_dtype = 0;
+  ORT_ENFORCE(GetType(*info.node().InputDefs()[0], x_dtype));
+  element_size_ = GetDataMovementElementSize(x_dtype);
+
+  xnn_status xstatus = xnn_status_invalid_state;
+  struct xnn_operator* p = nullptr;
+  switch (element_size_) {
+    case 1:
+      xstatus = xnn_create_transpose_nd_x8(0, &p);
+      break;
+    case 2:
+      xstatus = xnn_create_transpose_nd_x16(0, &p);
+      break;
+    case 4:
+      xstatus = xnn_create_transpose_nd_x32(0, &p);
+      break;
+    default:
+      ORT_THROW("unsupported Transpose in XnnpackExecutionProvider, element type ", x_dtype);
+  }
+
+  ORT_ENFORCE(xstatus == xnn_status_success, "xnn_create_transpose_nd_x", element_size_ * 8,
+              " failed. Status:", xstatus);
+  op0_.reset(p);
+}
+
+Status Transpose::Compute(OpKernelContext* ctx) const {
+  const auto* X = ctx->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+
+  TensorShapeVector output_dims;
+  InlinedVector<size_t> default_perm;
+  const InlinedVector<size_t>* p_perm = nullptr;
+  ORT_RETURN_IF_ERROR(ComputeOutputShape(*X, output_dims, default_perm, p_perm));
+  auto* Y = ctx->Output(0, output_dims);
+
+  // edge case. one or more dims with value of 0. nothing to do
+  if (X_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  pthreadpool_t threadpool = GetThreadPool();
+  const auto x_dims = X_shape.AsShapeVector();
+  const InlinedVector<size_t> input_shape(x_dims.begin(), x_dims.end());
+
+  auto reshape_fn = element_size_ == 1   ? xnn_reshape_transpose_nd_x8
+                    : element_size_ == 2 ? xnn_reshape_transpose_nd_x16
+                                         : xnn_reshape_transpose_nd_x32;
+  xnn_status status = reshape_fn(op0_.get(), input_shape.size(), input_shape.data(), p_perm->data(), threadpool);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_transpose_nd_x", element_size_ * 8,
+                           " returned ", status);
+  }
+
+  auto setup_fn = element_size_ == 1   ? xnn_setup_transpose_nd_x8
+                  : element_size_ == 2 ? xnn_setup_transpose_nd_x16
+                                       : xnn_setup_transpose_nd_x32;
+  status = setup_fn(op0_.get(), X->DataRaw(), Y->MutableDataRaw());
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_transpose_nd_x", element_size_ * 8,
+                           " returned ", status);
+  }
+
+  status = RunOperator(op0_.get(), *ctx);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
+  }
+
+  return Status::OK();
+}
+
+#define TRANSPOSE_TYPES BuildKernelDefConstraints<float, MLFloat16, int8_t, uint8_t, bool, int16_t, uint16_t, \
+                                                  int32_t, uint32_t>()
+
+ONNX_OPERATOR_VERSIONED_KERNEL_EX(Transpose, kOnnxDomain, 1, 12, kXnnpackExecutionProvider,
+                                  KernelDefBuilder().TypeConstraint("T", TRANSPOSE_TYPES),
+                                  Transpose);
+
+ONNX_OPERATOR_KERNEL_EX(Transpose, kOnnxDomain, 13, kXnnpackExecutionProvider,
+                        KernelDefBuilder().TypeConstraint("T", TRANSPOSE_TYPES),
+                        Transpose);
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
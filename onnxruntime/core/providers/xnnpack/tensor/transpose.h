@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/xnnpack/xnnpack_kernel.h"
+#include "core/providers/cpu/tensor/transpose.h"
+#include "core/providers/xnnpack/detail/utils.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class NodeUnit;
+namespace xnnpack {
+
+class Transpose : public XnnpackKernel, public TransposeBase {
+ public:
+  Transpose(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+  static bool IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& graph);
+
+ private:
+  // size in bytes of the elements. XNNPACK transposes 1, 2 and 4 byte elements.
+  size_t element_size_ = 0;
+  XnnpackOperator op0_ = nullptr;
+};
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
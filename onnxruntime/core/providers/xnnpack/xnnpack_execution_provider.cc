@@ -83,6 +83,29 @@ class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnx
 class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 11, 12, Softmax);
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, Softmax);
 
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 7, 12, Add);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, 13, Add);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 14, Add);
+
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 7, 12, Sub);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, 13, Sub);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 14, Sub);
+
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 7, 12, Mul);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, 13, Mul);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 14, Mul);
+
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 7, 12, Div);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, 13, Div);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 14, Div);
+
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 1, 12, Transpose);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, Transpose);
+
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 4, 10, Concat);
+class ONNX_OPERATOR_VERSIONED_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 11, 12, Concat);
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13, Concat);
+
 // Internal domain
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kDynamicDomainByCreate, 1, QLinearSoftmax);
 
@@ -131,6 +154,29 @@ std::unique_ptr<KernelRegistry> RegisterKernels() {
       KERNEL_CREATE_INFO_VERSIONED(9, 12, MatMul, kOnnxDomain),
       KERNEL_CREATE_INFO(13, MatMul, kOnnxDomain),
 
+      KERNEL_CREATE_INFO_VERSIONED(7, 12, Add, kOnnxDomain),
+      KERNEL_CREATE_INFO_VERSIONED(13, 13, Add, kOnnxDomain),
+      KERNEL_CREATE_INFO(14, Add, kOnnxDomain),
+
+      KERNEL_CREATE_INFO_VERSIONED(7, 12, Sub, kOnnxDomain),
+      KERNEL_CREATE_INFO_VERSIONED(13, 13, Sub, kOnnxDomain),
+      KERNEL_CREATE_INFO(14, Sub, kOnnxDomain),
+
+      KERNEL_CREATE_INFO_VERSIONED(7, 12, Mul, kOnnxDomain),
+      KERNEL_CREATE_INFO_VERSIONED(13, 13, Mul, kOnnxDomain),
+      KERNEL_CREATE_INFO(14, Mul, kOnnxDomain),
+
+      KERNEL_CREATE_INFO_VERSIONED(7, 12, Div, kOnnxDomain),
+      KERNEL_CREATE_INFO_VERSIONED(13, 13, Div, kOnnxDomain),
+      KERNEL_CREATE_INFO(14, Div, kOnnxDomain),
+
+      KERNEL_CREATE_INFO_VERSIONED(1, 12, Transpose, kOnnxDomain),
+      KERNEL_CREATE_INFO(13, Transpose, kOnnxDomain),
+
+      KERNEL_CREATE_INFO_VERSIONED(4, 10, Concat, kOnnxDomain),
+      KERNEL_CREATE_INFO_VERSIONED(11, 12, Concat, kOnnxDomain),
+      KERNEL_CREATE_INFO(13, Concat, kOnnxDomain),
+
       //  quantization op
       KERNEL_CREATE_INFO(1, QLinearAveragePool, kMSInternalNHWCDomain),
 
@@ -164,11 +210,11 @@ XnnpackExecutionProvider::XnnpackExecutionProvider(const XnnpackExecutionProvide
                                       kOrtSessionOptionsConfigAllowIntraOpSpinning, "1") == "1");
   if (xnn_thread_pool_size > 1 && allow_intra_op_spinning && ort_thread_pool_size > 1) {
     LOGS_DEFAULT(WARNING)
-        << "The XNNPACK EP utilizes an internal pthread-based thread pool for multi-threading."
-           "If ORT's thread pool size is > 1 and spinning is enabled, "
-           "there will be contention between the two thread pools, and performance will suffer."
-           "Please set either intra_op_param.allow_spinning to 0 in the SessionOption config params,"
-           "or the ORT intra-op threadpool size to 1.";
+        << "The XNNPACK EP utilizes an internal pthread-based thread pool for multi-threading. "
+           "The ORT thread pool stops spinning while XNNPACK kernels run, but if its size is > 1 and spinning is "
+           "enabled, its workers spin after the other kernels and contend with the XNNPACK workers. "
+           "If most of the model runs on the XNNPACK EP, please set either intra_op_param.allow_spinning to 0 in "
+           "the SessionOption config params, or the ORT intra-op threadpool size to 1.";
   }
 
   if (xnn_thread_pool_size == 0) {
@@ -176,7 +222,8 @@ XnnpackExecutionProvider::XnnpackExecutionProvider(const XnnpackExecutionProvide
   }
 
   if (xnn_thread_pool_size > 1) {
-    // pthreadpool is independent of ort-threadpoool, so we had better disable cpu spinning for ort-threadpool.
+    // pthreadpool is independent of ort-threadpool. the ORT pool is idled while XNNPACK kernels run, so with the
+    // default size the two pools together keep the configured number of threads busy.
     xnnpack_thread_pool_ = pthreadpool_create(static_cast<size_t>(xnn_thread_pool_size));
   }
 }
@@ -3,6 +3,7 @@
 
 #pragma once
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/xnnpack/xnnpack_execution_provider.h"
 #include "xnnpack.h"
 
@@ -23,6 +24,22 @@ class XnnpackKernel : public OpKernel {
     return xnnpack_threadpool_;
   }
 
+  // Run op on the XNNPACK thread pool. The ORT intra-op thread pool is idle while an XNNPACK kernel runs, so its
+  // workers are told to stop spinning and block rather than compete with the XNNPACK workers for the cores.
+  [[nodiscard]] xnn_status RunOperator(xnn_operator_t op, OpKernelContext& context) const {
+    concurrency::ThreadPool* ort_threadpool = xnnpack_threadpool_ ? context.GetOperatorThreadPool() : nullptr;
+    if (ort_threadpool) {
+      ort_threadpool->DisableSpinning();
+    }
+    xnn_status status = xnn_run_operator(op, xnnpack_threadpool_);
+    if (ort_threadpool) {
+      // spinning is always on during a Run. workers which blocked meanwhile stay blocked until the next parallel
+      // section of the ORT pool.
+      ort_threadpool->EnableSpinning();
+    }
+    return status;
+  }
+
   // see comment below about enabling code cache
   // xnn_code_cache_t GetCodeCache() { return caches_.auto_code_cache.get();}
   xnn_code_cache_t GetCodeCache() { return nullptr; }
@@ -2,8 +2,12 @@
 // Licensed under the MIT License.
 
 #include "core/session/IOBinding.h"
+
+#include <algorithm>
+
 #include "core/common/logging/logging.h"
 #include "core/framework/session_state.h"
+#include "core/framework/mldata_type_utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/utils.h"
 
@@ -12,6 +16,13 @@ IOBinding::IOBinding(const SessionState& session_state) : session_state_(session
 }
 
 common::Status IOBinding::BindInput(const std::string& name, const OrtValue& ml_value) {
+  ORT_RETURN_IF_ERROR(BindInputImpl(name, ml_value));
+  user_bound_inputs_.insert(name);
+  carried_over_inputs_.erase(name);
+  return Status::OK();
+}
+
+common::Status IOBinding::BindInputImpl(const std::string& name, const OrtValue& ml_value) {
   auto it = mapped_feed_names_.emplace(name, feed_names_.size());
 
   auto add_or_replace = [&](const OrtValue& value) {
@@ -45,6 +56,66 @@ void IOBinding::ClearInputs() {
   mapped_feed_names_.clear();
   feed_names_.clear();
   feeds_.clear();
+  user_bound_inputs_.clear();
+  carried_over_inputs_.clear();
+}
+
+common::Status IOBinding::CarryOverState(gsl::span<const std::pair<std::string, std::string>> state_pairs) {
+  if (!state_produced_) {
+    user_bound_inputs_.clear();
+    user_bound_outputs_.clear();
+    return Status::OK();
+  }
+
+  for (const auto& [output_name, input_name] : state_pairs) {
+    auto output_it = mapped_output_names_.find(output_name);
+    if (output_it == mapped_output_names_.end() || user_bound_outputs_.count(output_name) > 0 ||
+        user_bound_inputs_.count(input_name) > 0) {
+      continue;
+    }
+
+    OrtValue& output = outputs_[output_it->second];
+    if (!output.IsAllocated()) {
+      continue;
+    }
+
+    // The previous value of the input can be overwritten if no one but this binding refers to it.
+    OrtValue reusable;
+    auto input_it = mapped_feed_names_.find(input_name);
+    if (input_it != mapped_feed_names_.end() && carried_over_inputs_.count(input_name) > 0) {
+      const OrtValue& previous = feeds_[input_it->second];
+      if (previous.IsTensor() && output.IsTensor()) {
+        const Tensor& previous_tensor = previous.Get<Tensor>();
+        const Tensor& output_tensor = output.Get<Tensor>();
+        if (previous_tensor.DataType() == output_tensor.DataType() &&
+            previous_tensor.Shape() == output_tensor.Shape() &&
+            previous_tensor.Location().device == output_tensor.Location().device) {
+          reusable = previous;
+        }
+      }
+    }
+
+    ORT_RETURN_IF_ERROR(BindInputImpl(input_name, output));
+    carried_over_inputs_.insert(input_name);
+
+    // The next Run() reads the input while writing the output, so they can't share a growable buffer.
+    auto growable_it = growable_outputs_.find(output_name);
+    if (growable_it != growable_outputs_.end()) {
+      growable_it->second.buffer = OrtValue();
+      growable_it->second.produced = false;
+    }
+
+    // An empty value makes Run() allocate the output on the device it is bound to.
+    if (!reusable.IsAllocated() && output.IsTensor()) {
+      outputs_device_info_[output_it->second] = output.Get<Tensor>().Location().device;
+    }
+    output = reusable;
+  }
+
+  state_produced_ = false;
+  user_bound_inputs_.clear();
+  user_bound_outputs_.clear();
+  return Status::OK();
 }
 
 static common::Status SyncProviders(const SessionState::NameNodeInfoMapType& node_info_map,
@@ -87,7 +158,74 @@ common::Status IOBinding::BindOutput(const std::string& name, OrtDevice device)
   return BindOutputImpl(name, {}, device);
 }
 
+common::Status IOBinding::BindGrowableOutput(const std::string& name, OrtDevice device) {
+  const auto& graph_outputs = session_state_.GetGraphViewer().GetOutputs();
+  auto output_it = std::find_if(graph_outputs.begin(), graph_outputs.end(),
+                                [&name](const NodeArg* output) { return output->Name() == name; });
+  if (output_it == graph_outputs.end()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid output name: ", name);
+  }
+  MLDataType type = utils::GetMLDataType(**output_it);
+  if (!type->IsTensorType() || type->AsTensorType()->GetElementType() == DataTypeImpl::GetType<std::string>()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output ", name,
+                           " can't be bound to a growable buffer, it is not a numeric tensor.");
+  }
+
+  ORT_RETURN_IF_ERROR(BindOutputImpl(name, {}, device));
+  growable_outputs_.insert_or_assign(name, GrowableOutput{type->AsTensorType()->GetElementType(), {}, false});
+  return Status::OK();
+}
+
+std::unordered_map<size_t, IExecutor::CustomAllocator> IOBinding::PrepareGrowableOutputs() {
+  std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  for (auto& [name, growable_output] : growable_outputs_) {
+    const size_t index = mapped_output_names_.at(name);
+    if (growable_output.produced) {
+      outputs_[index] = OrtValue();
+      growable_output.produced = false;
+    }
+
+    fetch_allocators[index] = [this, index, &growable_output](const TensorShape& shape, const OrtDevice& device,
+                                                              OrtValue& ort_value, bool& allocated) {
+      allocated = false;
+      // an output produced on another device is copied to the bound one by the default allocation
+      if (device != outputs_device_info_[index]) {
+        return Status::OK();
+      }
+
+      const int64_t num_elements = shape.Size();
+      const int64_t capacity = growable_output.buffer.IsAllocated()
+                                   ? growable_output.buffer.Get<Tensor>().Shape().Size()
+                                   : 0;
+      if (!growable_output.buffer.IsAllocated() || num_elements > capacity) {
+        AllocatorPtr allocator = session_state_.GetAllocator(device);
+        if (!allocator) {
+          return Status::OK();
+        }
+        // release the previous buffer before allocating its replacement
+        growable_output.buffer = OrtValue();
+        Tensor::InitOrtValue(growable_output.element_type,
+                             TensorShape({std::max<int64_t>({num_elements, 2 * capacity, 1})}),
+                             std::move(allocator), growable_output.buffer);
+      }
+
+      Tensor& buffer = *growable_output.buffer.GetMutable<Tensor>();
+      auto tensor = std::make_unique<Tensor>(growable_output.element_type, shape, buffer.MutableDataRaw(),
+                                             buffer.Location());
+      // the output keeps the buffer alive if the binding grows it or is destroyed
+      OrtValue owner = growable_output.buffer;
+      ort_value.Init(tensor.release(), DataTypeImpl::GetType<Tensor>(),
+                     [owner](void* p) { delete static_cast<Tensor*>(p); });
+      growable_output.produced = true;
+      allocated = true;
+      return Status::OK();
+    };
+  }
+  return fetch_allocators;
+}
+
 common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue& ml_value, OrtDevice device) {
+  growable_outputs_.erase(name);
   auto it = mapped_output_names_.emplace(name, output_names_.size());
   size_t index = it.first->second;
   if (it.second) {
@@ -99,6 +237,7 @@ common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue
     outputs_device_info_[index] = device;
   }
   ORT_ENFORCE(mapped_output_names_.size() == output_names_.size(), "Size mismatch", mapped_output_names_.size(), "!=", output_names_.size());
+  user_bound_outputs_.insert(name);
 
   return Status::OK();
 }
@@ -108,6 +247,8 @@ void IOBinding::ClearOutputs() {
   output_names_.clear();
   outputs_.clear();
   outputs_device_info_.clear();
+  user_bound_outputs_.clear();
+  growable_outputs_.clear();
 }
 
 const std::vector<std::string>& IOBinding::GetOutputNames() const { return output_names_; }
@@ -5,8 +5,11 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include "core/framework/execution_provider.h"
+#include "core/common/gsl.h"
 #include "core/common/status.h"
 #include "core/graph/basic_types.h"
 #include "core/framework/ort_value.h"
@@ -71,6 +74,19 @@ class IOBinding {
    */
   common::Status BindOutput(const std::string& name, OrtDevice device = {});
 
+  /**
+   * Bind an output name to a growable buffer on a device, for tensor outputs whose shape changes between runs,
+   * e.g. when decoding token by token.
+   * The output is written to a buffer kept by this binding, which is reused by the next Run() if the output fits in
+   * its capacity and grown to at least twice its capacity otherwise, instead of allocating the output on each Run().
+   * The output value is only valid until the next Run(), copy it to keep it.
+   * The output is allocated as with BindOutput(name, device) if it is produced on another device or shares the
+   * buffer of another value of the graph.
+   *
+   * @param device Device of the buffer. Default is CPU.
+   */
+  common::Status BindGrowableOutput(const std::string& name, OrtDevice device = {});
+
   /**
    * This simply collects the outputs obtained after calling Run() inside the @param outputs.
    */
@@ -95,6 +111,16 @@ class IOBinding {
   void ClearInputs();
   IOBinding(const SessionState& session_state);
 
+  /**
+   * Binds the outputs produced by the last successful Run() to the inputs of the given (output name, input name)
+   * pairs, see kOrtSessionOptionsConfigStatefulIOPairs. Inputs bound with BindInput() since the last Run() are kept, and
+   * outputs bound with BindOutput() since the last Run() are not carried over.
+   * The previous value of an input is reused as the buffer of its output if it was itself carried over and has the
+   * same type and shape as the produced output.
+   * This is a no-op if the last Run() failed or if there was no Run() yet.
+   */
+  common::Status CarryOverState(gsl::span<const std::pair<std::string, std::string>> state_pairs);
+
  private:
   friend InferenceSession;
 
@@ -107,12 +133,36 @@ class IOBinding {
   std::vector<OrtValue> outputs_;
   std::vector<OrtDevice> outputs_device_info_;
 
+  // State carried over between Run() calls by CarryOverState().
+  bool state_produced_ = false;
+  // Inputs and outputs bound by the user since the last Run().
+  std::unordered_set<std::string> user_bound_inputs_;
+  std::unordered_set<std::string> user_bound_outputs_;
+  // Inputs currently bound to a value produced by a previous Run(), which can be reused as an output buffer.
+  std::unordered_set<std::string> carried_over_inputs_;
+
+  struct GrowableOutput {
+    MLDataType element_type;
+    // a 1-D tensor whose size is the capacity in elements, empty until the first Run()
+    OrtValue buffer;
+    // whether the bound output is a view of the buffer written by the last Run()
+    bool produced = false;
+  };
+  std::unordered_map<std::string, GrowableOutput> growable_outputs_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 
   // device info for all outputs. only used by InferenceSession if the output is not pre-allocated.
   const std::vector<OrtDevice>& GetOutputsDeviceInfo() const;
 
+  // Unbinds the outputs of the growable buffers written by the last Run() so that the next Run() produces them again,
+  // and returns the allocators of these outputs keyed by output index for InferenceSession::Run().
+  std::unordered_map<size_t, IExecutor::CustomAllocator> PrepareGrowableOutputs();
+
   // The implementation for the BindOutput() overloads
   common::Status BindOutputImpl(const std::string& name, const OrtValue& ml_value, OrtDevice device);
+
+  // The implementation for BindInput(), without the bookkeeping of the inputs bound by the user
+  common::Status BindInputImpl(const std::string& name, const OrtValue& ml_value);
 };
 }  // namespace onnxruntime
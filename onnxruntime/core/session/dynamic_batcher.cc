@@ -0,0 +1,240 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/dynamic_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace batching {
+
+bool IsCpuTensor(const OrtValue& value) {
+  return value.IsTensor() && value.Get<Tensor>().Location().device.Type() == OrtDevice::CPU;
+}
+
+void CopyRows(const Tensor& src, int64_t src_row, Tensor& dst, int64_t dst_row, int64_t num_rows) {
+  const int64_t row_elements = src.Shape().SizeFromDimension(1);
+  if (src.IsDataTypeString()) {
+    const std::string* src_data = src.Data<std::string>() + src_row * row_elements;
+    std::string* dst_data = dst.MutableData<std::string>() + dst_row * row_elements;
+    std::copy(src_data, src_data + num_rows * row_elements, dst_data);
+  } else {
+    const size_t row_bytes = static_cast<size_t>(row_elements) * src.DataType()->Size();
+    std::memcpy(static_cast<char*>(dst.MutableDataRaw()) + dst_row * row_bytes,
+                static_cast<const char*>(src.DataRaw()) + src_row * row_bytes,
+                static_cast<size_t>(num_rows) * row_bytes);
+  }
+}
+
+TensorShape WithBatchSize(const TensorShape& src, int64_t batch_size) {
+  TensorShapeVector dims = src.AsShapeVector();
+  dims[0] = batch_size;
+  return TensorShape(dims);
+}
+
+}  // namespace batching
+
+using batching::CopyRows;
+using batching::IsCpuTensor;
+using batching::WithBatchSize;
+
+DynamicBatcher::DynamicBatcher(int64_t max_batch_size, std::chrono::microseconds max_queue_delay,
+                               AllocatorPtr allocator, RunFn run_fn)
+    : max_batch_size_(max_batch_size),
+      max_queue_delay_(max_queue_delay),
+      allocator_(std::move(allocator)),
+      run_fn_(std::move(run_fn)) {
+  ORT_ENFORCE(max_batch_size_ > 1, "Max batch size of dynamic batching must be greater than 1");
+}
+
+bool DynamicBatcher::CanBatch(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                              const std::vector<OrtValue>& fetches) const {
+  // Run options apply to the whole batched run, so only calls with default behavior are batched.
+  if (run_options.terminate || run_options.only_execute_path_to_fetches ||
+      !run_options.config_options.configurations.empty()) {
+    return false;
+  }
+
+  // Preallocated fetches cannot be shared between calls.
+  if (!fetches.empty() || feeds.empty()) {
+    return false;
+  }
+
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!IsCpuTensor(feed)) {
+      return false;
+    }
+    const auto& shape = feed.Get<Tensor>().Shape();
+    if (shape.NumDimensions() == 0 || shape[0] < 1 || (batch_size != -1 && shape[0] != batch_size)) {
+      return false;
+    }
+    batch_size = shape[0];
+  }
+  return batch_size < max_batch_size_;
+}
+
+bool DynamicBatcher::IsCompatible(const Request& a, const Request& b) {
+  if (!std::equal(a.feed_names.begin(), a.feed_names.end(), b.feed_names.begin(), b.feed_names.end()) ||
+      !std::equal(a.output_names.begin(), a.output_names.end(), b.output_names.begin(), b.output_names.end())) {
+    return false;
+  }
+  for (size_t i = 0; i < a.feeds.size(); ++i) {
+    const auto& a_tensor = a.feeds[i].Get<Tensor>();
+    const auto& b_tensor = b.feeds[i].Get<Tensor>();
+    if (a_tensor.DataType() != b_tensor.DataType() ||
+        a_tensor.Shape().Slice(1) != b_tensor.Shape().Slice(1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status DynamicBatcher::Run(const RunOptions& run_options,
+                           gsl::span<const std::string> feed_names,
+                           gsl::span<const OrtValue> feeds,
+                           gsl::span<const std::string> output_names,
+                           std::vector<OrtValue>& fetches) {
+  Request request{feed_names, feeds, output_names, &fetches, feeds[0].Get<Tensor>().Shape()[0]};
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+  if (pending_batch_ != nullptr) {
+    Batch& batch = *pending_batch_;
+    if (!IsCompatible(*batch.requests.front(), request) ||
+        batch.batch_size + request.batch_size > max_batch_size_) {
+      // Run by itself instead of waiting for the pending batch to be executed.
+      lock.unlock();
+      return run_fn_(run_options, feed_names, feeds, output_names, fetches);
+    }
+
+    batch.requests.push_back(&request);
+    batch.batch_size += request.batch_size;
+    if (batch.batch_size >= max_batch_size_) {
+      batch_full_cv_.notify_one();
+    }
+    while (!request.done) {
+      done_cv_.wait(lock);
+    }
+    lock.unlock();
+    if (request.run_individually) {
+      return run_fn_(run_options, feed_names, feeds, output_names, fetches);
+    }
+    return request.status;
+  }
+
+  // Start a new batch, and execute it once it is full or the queue delay has passed.
+  auto batch = std::make_shared<Batch>();
+  batch->requests.push_back(&request);
+  batch->batch_size = request.batch_size;
+  pending_batch_ = batch;
+  const auto deadline = std::chrono::steady_clock::now() + max_queue_delay_;
+  while (batch->batch_size < max_batch_size_) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      break;
+    }
+    batch_full_cv_.wait_for(lock, deadline - now);
+  }
+  pending_batch_.reset();
+  lock.unlock();
+
+  ORT_TRY {
+    ExecuteBatch(run_options, *batch);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      for (auto* batch_request : batch->requests) {
+        batch_request->status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      }
+    });
+  }
+
+  lock.lock();
+  for (auto* batch_request : batch->requests) {
+    batch_request->done = true;
+  }
+  lock.unlock();
+  done_cv_.notify_all();
+
+  if (request.run_individually) {
+    return run_fn_(run_options, feed_names, feeds, output_names, fetches);
+  }
+  return request.status;
+}
+
+void DynamicBatcher::ExecuteBatch(const RunOptions& run_options, Batch& batch) {
+  if (batch.requests.size() == 1) {
+    Request& request = *batch.requests.front();
+    request.status = run_fn_(run_options, request.feed_names, request.feeds, request.output_names, *request.fetches);
+    return;
+  }
+
+  const Request& first = *batch.requests.front();
+  std::vector<OrtValue> batched_feeds;
+  std::vector<OrtValue> batched_fetches;
+  Status status = ConcatFeeds(batch, batched_feeds);
+  if (status.IsOK()) {
+    status = run_fn_(run_options, first.feed_names, batched_feeds, first.output_names, batched_fetches);
+  }
+  if (status.IsOK()) {
+    status = SplitFetches(batched_fetches, batch);
+  }
+
+  if (!status.IsOK()) {
+    // Let each caller run its own request, so that it gets the same result as without batching.
+    LOGS_DEFAULT(VERBOSE) << "Batched run of " << batch.requests.size() << " requests failed, running them one by one: "
+                          << status.ErrorMessage();
+    for (auto* request : batch.requests) {
+      request->run_individually = true;
+    }
+  }
+}
+
+Status DynamicBatcher::ConcatFeeds(const Batch& batch, std::vector<OrtValue>& batched_feeds) const {
+  const Request& first = *batch.requests.front();
+  batched_feeds.resize(first.feeds.size());
+  for (size_t i = 0; i < first.feeds.size(); ++i) {
+    const auto& first_tensor = first.feeds[i].Get<Tensor>();
+    Tensor::InitOrtValue(first_tensor.DataType(), WithBatchSize(first_tensor.Shape(), batch.batch_size),
+                         allocator_, batched_feeds[i]);
+    auto& batched_tensor = *batched_feeds[i].GetMutable<Tensor>();
+    int64_t row = 0;
+    for (const auto* request : batch.requests) {
+      CopyRows(request->feeds[i].Get<Tensor>(), 0, batched_tensor, row, request->batch_size);
+      row += request->batch_size;
+    }
+  }
+  return Status::OK();
+}
+
+Status DynamicBatcher::SplitFetches(const std::vector<OrtValue>& batched_fetches, Batch& batch) const {
+  for (const auto& fetch : batched_fetches) {
+    ORT_RETURN_IF_NOT(IsCpuTensor(fetch), "Only CPU tensor outputs can be split");
+    const auto& shape = fetch.Get<Tensor>().Shape();
+    ORT_RETURN_IF_NOT(shape.NumDimensions() > 0 && shape[0] == batch.batch_size,
+                      "Output shape ", shape, " does not have the batch size ", batch.batch_size,
+                      " as the first dimension");
+  }
+
+  int64_t row = 0;
+  for (auto* request : batch.requests) {
+    request->fetches->resize(batched_fetches.size());
+    for (size_t i = 0; i < batched_fetches.size(); ++i) {
+      const auto& batched_tensor = batched_fetches[i].Get<Tensor>();
+      OrtValue& fetch = (*request->fetches)[i];
+      Tensor::InitOrtValue(batched_tensor.DataType(), WithBatchSize(batched_tensor.Shape(), request->batch_size),
+                           allocator_, fetch);
+      CopyRows(batched_tensor, row, *fetch.GetMutable<Tensor>(), 0, request->batch_size);
+    }
+    row += request->batch_size;
+    request->status = Status::OK();
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/framework/tensor.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+namespace batching {
+
+bool IsCpuTensor(const OrtValue& value);
+
+// Copy num_rows rows along the first dimension from src, starting at src_row, to dst starting at dst_row.
+void CopyRows(const Tensor& src, int64_t src_row, Tensor& dst, int64_t dst_row, int64_t num_rows);
+
+// Shape of src with the first dimension replaced by batch_size.
+TensorShape WithBatchSize(const TensorShape& src, int64_t batch_size);
+
+}  // namespace batching
+
+/**
+ * Coalesces concurrent Run calls of a session into one batched run, by concatenating the feeds along
+ * the first dimension, and splitting the fetches back to the callers.
+ *
+ * The first caller of a batch waits up to max_queue_delay, or until max_batch_size rows have been queued, and then
+ * runs the batch on behalf of all callers. Calls are only batched together if they have the same feed names and
+ * output names, and the same element types and shapes except for the first dimension.
+ * If the batched run fails, or the fetches cannot be split along the first dimension, each call is run by itself,
+ * so that batching never changes the result of a call for models whose rows are independent.
+ * It is the user's responsibility to only enable batching for such models.
+ */
+class DynamicBatcher {
+ public:
+  using RunFn = std::function<Status(const RunOptions& run_options,
+                                     gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds,
+                                     gsl::span<const std::string> output_names,
+                                     std::vector<OrtValue>& fetches)>;
+
+  // run_fn runs the session without batching. allocator is used for the batched feeds and the split fetches.
+  DynamicBatcher(int64_t max_batch_size, std::chrono::microseconds max_queue_delay,
+                 AllocatorPtr allocator, RunFn run_fn);
+
+  // Whether a Run call with these arguments can be batched.
+  bool CanBatch(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                const std::vector<OrtValue>& fetches) const;
+
+  // Run a call that CanBatch accepted, possibly batched with other concurrent calls.
+  Status Run(const RunOptions& run_options,
+             gsl::span<const std::string> feed_names,
+             gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names,
+             std::vector<OrtValue>& fetches);
+
+ private:
+  struct Request {
+    gsl::span<const std::string> feed_names;
+    gsl::span<const OrtValue> feeds;
+    gsl::span<const std::string> output_names;
+    std::vector<OrtValue>* fetches;
+    int64_t batch_size;
+    Status status;
+    bool done = false;
+    // Set if the batched run failed, and the caller shall run the request by itself.
+    bool run_individually = false;
+  };
+
+  struct Batch {
+    std::vector<Request*> requests;
+    int64_t batch_size = 0;
+  };
+
+  static bool IsCompatible(const Request& a, const Request& b);
+
+  // Run the requests of the batch and set their status.
+  void ExecuteBatch(const RunOptions& run_options, Batch& batch);
+  Status ConcatFeeds(const Batch& batch, std::vector<OrtValue>& batched_feeds) const;
+  Status SplitFetches(const std::vector<OrtValue>& batched_fetches, Batch& batch) const;
+
+  const int64_t max_batch_size_;
+  const std::chrono::microseconds max_queue_delay_;
+  AllocatorPtr allocator_;
+  RunFn run_fn_;
+
+  OrtMutex mutex_;
+  // Signals the leader of the pending batch when it is full.
+  OrtCondVar batch_full_cv_;
+  // Signals the followers when their requests are done.
+  OrtCondVar done_cv_;
+  // The batch waiting for requests, if any.
+  std::shared_ptr<Batch> pending_batch_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DynamicBatcher);
+};
+
+}  // namespace onnxruntime
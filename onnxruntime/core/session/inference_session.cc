@@ -4,6 +4,10 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <list>
@@ -12,13 +16,16 @@
 #include <queue>
 
 #include "core/common/denormal.h"
+#include "core/common/hardware_counters.h"
 #include "core/common/logging/logging.h"
 #include "core/common/parse_string.h"
 #include "core/common/path_string.h"
 #include "core/common/string_utils.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/flatbuffers/ort_format_version.h"
+#include "core/framework/accounting_allocator.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/captured_graph.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/feeds_fetches_manager.h"
@@ -28,11 +35,13 @@
 #include "core/framework/kernel_type_str_resolver.h"
 #include "core/framework/kernel_type_str_resolver_utils.h"
 #include "core/framework/mldata_type_utils.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/tensor_type_and_shape.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/session_state_utils.h"
 #include "core/framework/transform_layout_functions.h"
 #include "core/framework/utils.h"
 #include "core/graph/graph_viewer.h"
@@ -47,6 +56,7 @@
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/optimizer/transpose_optimization/ort_optimizer_utils.h"
 #include "core/platform/Barrier.h"
+#include "core/platform/path_lib.h"
 #include "core/platform/threadpool.h"
 #ifdef _WIN32
 #include "core/platform/tracing.h"
@@ -69,6 +79,11 @@
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
+#include "core/session/dynamic_batcher.h"
+#include "core/session/micro_batch_pipeline.h"
+#include "core/session/prepared_run.h"
+#include "core/session/run_completion_queue.h"
+#include "core/session/shape_specializer.h"
 #include "core/util/protobuf_parsing_utils.h"
 #include "core/util/thread_utils.h"
 
@@ -240,6 +255,21 @@ Status GetMinimalBuildOptimizationHandling(
                          "Invalid value for ", kOrtSessionOptionsConfigMinimalBuildOptimizations, ": ", config_value);
 };
 
+// Loads the ModelProto of a model file, leaving the data of the large initializers in the file if requested by
+// kOrtSessionOptionsConfigLazyInitializerMinSize.
+Status LoadModelProtoFromFile(const PathString& model_uri, const SessionOptions& session_options,
+                              ONNX_NAMESPACE::ModelProto& model_proto) {
+  const std::string config_value =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigLazyInitializerMinSize, "0");
+  size_t min_size = 0;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(config_value, min_size),
+                    "Invalid value for ", kOrtSessionOptionsConfigLazyInitializerMinSize, ": ", config_value);
+  if (min_size == 0) {
+    return Model::Load(model_uri, model_proto);
+  }
+  return Model::Load(model_uri, model_proto, min_size);
+}
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 }  // namespace
@@ -437,6 +467,15 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
   use_per_session_threads_ = session_options.use_per_session_threads;
   force_spinning_stop_between_runs_ = session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigForceSpinningStop, "0") == "1";
 
+  max_degree_of_parallelism_ = std::stoi(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism, "0"));
+  ORT_ENFORCE(max_degree_of_parallelism_ >= 0, "Maximum degree of parallelism must be non-negative, got ",
+              max_degree_of_parallelism_);
+
+  use_unified_thread_pool_ =
+      session_options_.execution_mode == ExecutionMode::ORT_PARALLEL &&
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseUnifiedThreadPool, "0") == "1";
+
   if (use_per_session_threads_) {
     LOGS(*session_logger_, INFO) << "Creating and using per session threadpools since use_per_session_threads_ is true";
     {
@@ -455,6 +494,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         // If the thread pool can use all the processors, then
         // we set affinity of each thread to each processor.
         to.allow_spinning = allow_intra_op_spinning;
+        to.adaptive_spinning =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpAdaptiveSpinning, "0") == "1";
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
 
@@ -465,9 +506,12 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
         }
+        to.numa_node = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaNode, "-1"));
+        to.performance_cores_only =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpPerformanceCoresOnly, "0") == "1";
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
-                               to.affinity_str.empty();
+                               to.affinity_str.empty() && to.numa_node < 0 && !to.performance_cores_only;
 
         if (to.custom_create_thread_fn) {
           ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set for intra op thread pool");
@@ -477,7 +521,16 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
             concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
       }
     }
-    if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
+    if (use_unified_thread_pool_ && thread_pool_ == nullptr && external_intra_op_thread_pool_ == nullptr) {
+      // The intra-op thread pool has no threads, so there are no threads to share with the parallel executor.
+      LOGS(*session_logger_, INFO) << "No intra-op thread pool to share with the parallel executor, "
+                                   << "using a separate inter-op thread pool";
+      use_unified_thread_pool_ = false;
+    }
+    if (use_unified_thread_pool_) {
+      LOGS(*session_logger_, INFO) << "Using the intra-op thread pool for the parallel executor since "
+                                   << kOrtSessionOptionsConfigUseUnifiedThreadPool << " is set";
+    } else if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
       if (!external_inter_op_thread_pool_) {
         bool allow_inter_op_spinning =
             session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowInterOpSpinning, "1") == "1";
@@ -517,9 +570,19 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     ORT_ENFORCE(session_env.EnvCreatedWithGlobalThreadPools(),
                 "When the session is not configured to use per session"
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
+    if (use_unified_thread_pool_ && intra_op_thread_pool_from_env_ == nullptr) {
+      use_unified_thread_pool_ = false;
+    }
   }
 
   session_profiler_.Initialize(session_logger_);
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfileHardwareCounters, "0") == "1") {
+    session_profiler_.EnableHardwareCounters(true);
+    if (!profiling::HardwareCounters::IsAvailable()) {
+      LOGS(*session_logger_, WARNING) << "Hardware counters are not available on this host, "
+                                      << "they will not be added to the profiling output.";
+    }
+  }
   if (session_options_.enable_profiling) {
     StartProfiling(session_options_.profile_file_prefix);
   }
@@ -613,7 +676,7 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
     : model_location_(model_uri),
       graph_transformer_mgr_(session_options.max_num_graph_transformation_steps),
       environment_(session_env) {
-  auto status = Model::Load(model_location_, model_proto_);
+  auto status = LoadModelProtoFromFile(model_location_, session_options, model_proto_);
   ORT_ENFORCE(status.IsOK(), "Given model could not be parsed while creating inference session. Error message: ",
               status.ErrorMessage());
   is_model_proto_parsed_ = true;
@@ -654,6 +717,10 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  if (session_state_ != nullptr && session_state_->GetNodeOverheadStats() != nullptr) {
+    LOGS(*session_logger_, INFO) << "Node overhead per op type:\n" << session_state_->GetNodeOverheadStats()->ToString();
+  }
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -673,6 +740,25 @@ InferenceSession::~InferenceSession() {
     }
   }
 
+#if !defined(ORT_MINIMAL_BUILD)
+  const std::string tuning_results_file =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigTuningResultsFile, "");
+  if (is_inited_ && !tuning_results_file.empty()) {
+    ORT_TRY {
+      auto status = inference_session_utils::SaveTuningResultsToFile(ToPathString(tuning_results_file),
+                                                                     GetTuningResults());
+      if (!status.IsOK()) {
+        LOGS(*session_logger_, WARNING) << "Failed to save the tuning results: " << status.ErrorMessage();
+      }
+    }
+    ORT_CATCH(const std::exception& e) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS(*session_logger_, WARNING) << "Failed to save the tuning results: " << e.what();
+      });
+    }
+  }
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
   // Unregister the session
 #ifdef _WIN32
   std::lock_guard<OrtMutex> lock(active_sessions_mutex_);
@@ -932,6 +1018,13 @@ common::Status InferenceSession::LoadOnnxModel(const PathString& model_uri) {
 #endif
     const bool strict_shape_type_inference = session_options_.config_options.GetConfigOrDefault(
                                                  kOrtSessionOptionsConfigStrictShapeTypeInference, "0") == "1";
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigLazyInitializerMinSize, "0") != "0") {
+      ModelProto model_proto;
+      ORT_RETURN_IF_ERROR(LoadModelProtoFromFile(model_location_, session_options_, model_proto));
+      return onnxruntime::Model::Load(std::move(model_proto), model_location_, model,
+                                      HasLocalSchema() ? &custom_schema_registries_ : nullptr, *session_logger_,
+                                      ModelOptions(true, strict_shape_type_inference));
+    }
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
                                     *session_logger_,
                                     ModelOptions(true, strict_shape_type_inference));
@@ -971,7 +1064,26 @@ common::Status InferenceSession::Load(const PathString& model_uri) {
                            "Invoke Load().");
   }
 
-  return LoadOnnxModel(model_uri);
+  ORT_RETURN_IF_ERROR(LoadOnnxModel(model_uri));
+
+  if (!session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "").empty()) {
+    size_t num_bytes = 0;
+    Env::MappedMemoryPtr mapped_bytes;
+    auto status = Env::Default().GetFileLength(model_uri.c_str(), num_bytes);
+    if (status.IsOK()) {
+      status = Env::Default().MapFileIntoMemory(model_uri.c_str(), 0, num_bytes, mapped_bytes);
+    }
+
+    if (status.IsOK()) {
+      HashModelForOptimizedModelCache(
+          gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes));
+    } else {
+      LOGS(*session_logger_, WARNING) << "Failed to read the model file to hash it for the optimized model cache. "
+                                      << status.ErrorMessage();
+    }
+  }
+
+  return Status::OK();
 #else
   return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "ONNX format model is not supported in this build.");
 #endif
@@ -1023,7 +1135,14 @@ common::Status InferenceSession::Load(const void* model_data, int model_data_len
                                     ModelOptions(true, strict_shape_type_inference));
   };
 
-  return LoadWithLoader(loader, "model_loading_array");
+  ORT_RETURN_IF_ERROR(LoadWithLoader(loader, "model_loading_array"));
+
+  if (!session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "").empty()) {
+    HashModelForOptimizedModelCache(
+        gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(model_data), static_cast<size_t>(model_data_len)));
+  }
+
+  return Status::OK();
 #else
   return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "ONNX format model is not supported in this build.");
 #endif
@@ -1302,10 +1421,38 @@ static Status LoadOrtModelBytes(const PathString& model_uri,
   return Status::OK();
 }
 
+static Status MapOrtModelBytes(const PathString& model_uri,
+                               gsl::span<const uint8_t>& bytes,
+                               Env::MappedMemoryPtr& mapped_bytes) {
+  size_t num_bytes = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_uri.c_str(), num_bytes));
+  ORT_RETURN_IF(num_bytes == 0, "Load model from ", ToUTF8String(model_uri), " failed. The file is empty.");
+
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(model_uri.c_str(), 0, num_bytes, mapped_bytes));
+
+  bytes = gsl::span<const uint8_t>(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes);
+
+  return Status::OK();
+}
+
 Status InferenceSession::LoadOrtModel(const PathString& model_uri) {
   return LoadOrtModelWithLoader(
       [&]() {
         model_location_ = model_uri;
+
+        const auto& config_options = GetSessionOptions().config_options;
+        if (config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMapORTModelFile, "0") == "1") {
+          const auto status = MapOrtModelBytes(model_location_, ort_format_model_bytes_,
+                                               ort_format_model_mapped_bytes_);
+          if (status.IsOK()) {
+            return Status::OK();
+          }
+
+          LOGS(*session_logger_, WARNING) << "Failed to memory map the ORT format model file. "
+                                          << "Reading it into memory instead. " << status.ErrorMessage();
+          ort_format_model_mapped_bytes_.reset();
+        }
+
         ORT_RETURN_IF_ERROR(
             LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
         return Status::OK();
@@ -1352,6 +1499,10 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
 
   ORT_RETURN_IF_ERROR(load_ort_format_model_bytes());
 
+  return LoadOrtModelFromBytes();
+}
+
+Status InferenceSession::LoadOrtModelFromBytes() {
   // Verify the ort_format_model_bytes_ is a valid InferenceSessionBuffer before we access the data
   flatbuffers::Verifier verifier(ort_format_model_bytes_.data(), ort_format_model_bytes_.size());
   ORT_RETURN_IF_NOT(fbs::VerifyInferenceSessionBuffer(verifier), "ORT model verification failed.");
@@ -1412,8 +1563,8 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   ORT_RETURN_IF(nullptr == fbs_model, "Missing Model. Invalid ORT format model.");
 
   // if we're using the bytes directly because kOrtSessionOptionsConfigUseORTModelBytesDirectly was set and the user
-  // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
-  // will be empty.
+  // provided an existing buffer of bytes when creating the InferenceSession, or because the model file was memory
+  // mapped as kOrtSessionOptionsConfigMapORTModelFile was set, ort_format_model_bytes_data_holder_ will be empty.
   // if that is the case we also allow creating initializers that directly use those bytes.
   const auto& config_options = session_options_.config_options;
   using_ort_model_bytes_for_initializers_ =
@@ -1459,6 +1610,183 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   return Status::OK();
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+namespace {
+// MurmurHash3 of the bytes, combined with the previous value of hash.
+void UpdateOptimizedModelCacheHash(const void* data, size_t size, uint32_t (&hash)[4]) {
+  // MurmurHash3 takes an int length, so hash large buffers in chunks
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  constexpr size_t kMaxChunkSize = static_cast<size_t>(std::numeric_limits<int>::max());
+  do {
+    const size_t chunk_size = std::min(size, kMaxChunkSize);
+    MurmurHash3::x86_128(bytes, static_cast<int>(chunk_size), hash[0], &hash);
+    bytes += chunk_size;
+    size -= chunk_size;
+  } while (size > 0);
+}
+
+void UpdateOptimizedModelCacheHash(std::string_view value, uint32_t (&hash)[4]) {
+  // hash the size too so that consecutive values cannot be confused
+  const uint64_t size = value.size();
+  UpdateOptimizedModelCacheHash(&size, sizeof(size), hash);
+  UpdateOptimizedModelCacheHash(value.data(), value.size(), hash);
+}
+
+std::string OptimizedModelCacheHashToString(const uint32_t (&hash)[4]) {
+  std::ostringstream ss;
+  ss << std::hex << std::setfill('0');
+  for (uint32_t hash_part : hash) {
+    ss << std::setw(8) << hash_part;
+  }
+  return ss.str();
+}
+}  // namespace
+
+void InferenceSession::HashModelForOptimizedModelCache(gsl::span<const uint8_t> model_bytes) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  UpdateOptimizedModelCacheHash(model_bytes.data(), model_bytes.size(), hash);
+  optimized_model_cache_model_hash_ = OptimizedModelCacheHashToString(hash);
+}
+
+void InferenceSession::LoadOptimizedModelFromCache(PathString& cache_path) {
+  cache_path.clear();
+  if (optimized_model_cache_model_hash_.empty()) {
+    return;
+  }
+
+  // the cached model must be optimized for the same execution providers. other execution providers may compile or
+  // claim nodes at runtime in ways the ORT format cannot persist, so only sessions using the CPU EP are cached.
+  // initializers injected at runtime are not part of the model bytes so they disable the cache too.
+  const std::string reason = [this]() -> std::string {
+    if (session_options_.graph_optimization_level == TransformerLevel::Default) {
+      return "graph optimizations are disabled";
+    }
+    if (!session_options_.optimized_model_filepath.empty()) {
+      return "the session saves the optimized model";
+    }
+    if (execution_providers_.NumProviders() != 1 || execution_providers_.Get(kCpuExecutionProvider) == nullptr) {
+      return "the session uses execution providers other than the CPU execution provider";
+    }
+    if (!session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMinimalBuildOptimizations,
+                                                            "").empty()) {
+      return "minimal build optimizations are configured";
+    }
+#if !defined(DISABLE_EXTERNAL_INITIALIZERS)
+    if (!session_options_.external_initializers.empty() ||
+        !session_options_.external_initializer_files_mmap.empty()) {
+      return "the session has external initializers";
+    }
+#endif
+    return std::string();
+  }();
+  if (!reason.empty()) {
+    LOGS(*session_logger_, INFO) << "Not using the optimized model cache as " << reason << ".";
+    return;
+  }
+
+  // the key covers everything the optimized graph depends on
+  uint32_t hash[4] = {0, 0, 0, 0};
+  UpdateOptimizedModelCacheHash(optimized_model_cache_model_hash_, hash);
+  UpdateOptimizedModelCacheHash(session_state_utils::GetBuildAndCpuSignature(), hash);
+  UpdateOptimizedModelCacheHash(std::to_string(static_cast<int>(session_options_.graph_optimization_level)), hash);
+  for (const auto& ep_id : execution_providers_.GetIds()) {
+    UpdateOptimizedModelCacheHash(ep_id, hash);
+  }
+
+  std::vector<std::string_view> optimizers_to_disable(optimizers_to_disable_.begin(), optimizers_to_disable_.end());
+  std::sort(optimizers_to_disable.begin(), optimizers_to_disable.end());
+  for (const auto& name : optimizers_to_disable) {
+    UpdateOptimizedModelCacheHash(name, hash);
+  }
+
+  std::vector<std::pair<std::string_view, std::string_view>> config_entries;
+  for (const auto& [key, value] : session_options_.config_options.configurations) {
+    config_entries.emplace_back(key, value);
+  }
+  std::sort(config_entries.begin(), config_entries.end());
+  for (const auto& [key, value] : config_entries) {
+    UpdateOptimizedModelCacheHash(key, hash);
+    UpdateOptimizedModelCacheHash(value, hash);
+  }
+
+  for (const auto& free_dimension_override : session_options_.free_dimension_overrides) {
+    UpdateOptimizedModelCacheHash(free_dimension_override.dim_identifier, hash);
+    UpdateOptimizedModelCacheHash(std::to_string(static_cast<int>(free_dimension_override.dim_identifer_type)), hash);
+    UpdateOptimizedModelCacheHash(std::to_string(free_dimension_override.dim_value), hash);
+  }
+
+  const PathString cache_dir =
+      ToPathString(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                                      ""));
+  const PathString path =
+      ConcatPathComponent(cache_dir, ToPathString(OptimizedModelCacheHashToString(hash)) + ORT_TSTR(".ort"));
+
+  size_t file_length = 0;
+  if (!Env::Default().GetFileLength(path.c_str(), file_length).IsOK()) {
+    cache_path = path;
+    return;
+  }
+
+  auto onnx_model = model_;
+  auto status = LoadOrtModelBytes(path, ort_format_model_bytes_, ort_format_model_bytes_data_holder_);
+  if (status.IsOK()) {
+    status = LoadOrtModelFromBytes();
+  }
+
+  if (status.IsOK()) {
+    LOGS(*session_logger_, INFO) << "Loaded the optimized model from the cache: " << ToUTF8String(path);
+    return;
+  }
+
+  // overwrite the invalid file with the optimized model of this session
+  LOGS(*session_logger_, WARNING) << "Failed to load the optimized model from the cache: " << ToUTF8String(path)
+                                  << ". The model will be optimized again. " << status.ErrorMessage();
+  model_ = std::move(onnx_model);
+  ort_format_model_bytes_ = gsl::span<const uint8_t>();
+  std::vector<uint8_t>{}.swap(ort_format_model_bytes_data_holder_);
+  using_ort_model_bytes_for_initializers_ = false;
+  cache_path = path;
+}
+
+void InferenceSession::SaveOptimizedModelToCache(const PathString& cache_path) const {
+  // write a temporary file that is renamed once complete, so that a concurrent session never loads a partial file
+  const PathString temp_path =
+      cache_path + ORT_TSTR(".") + ToPathString(std::to_string(Env::Default().GetSelfPid())) + ORT_TSTR(".tmp");
+
+  const auto status = [&]() -> Status {
+    const PathString cache_dir =
+        ToPathString(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                                        ""));
+    if (!Env::Default().FolderExists(cache_dir)) {
+      ORT_RETURN_IF_ERROR(Env::Default().CreateFolder(cache_dir));
+    }
+
+    ORT_RETURN_IF_ERROR(SaveToOrtFormat(temp_path));
+
+#ifdef _WIN32
+    const int rename_result = _wrename(temp_path.c_str(), cache_path.c_str());
+#else
+    const int rename_result = std::rename(temp_path.c_str(), cache_path.c_str());
+#endif
+    ORT_RETURN_IF(rename_result != 0, "Failed to rename ", ToUTF8String(temp_path), " to ",
+                  ToUTF8String(cache_path), ".");
+    return Status::OK();
+  }();
+
+  if (status.IsOK()) {
+    LOGS(*session_logger_, INFO) << "Saved the optimized model to the cache: " << ToUTF8String(cache_path);
+  } else {
+#ifdef _WIN32
+    _wremove(temp_path.c_str());
+#else
+    std::remove(temp_path.c_str());
+#endif
+    LOGS(*session_logger_, WARNING) << "Failed to save the optimized model to the cache: "
+                                    << ToUTF8String(cache_path) << ". " << status.ErrorMessage();
+  }
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 bool InferenceSession::IsInitialized() const {
   std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
   return is_inited_;
@@ -1520,6 +1848,72 @@ common::Status InferenceSession::AddPrePackedWeightsContainer(PrepackedWeightsCo
   return Status::OK();
 }
 
+common::Status InferenceSession::ShareInitializersFromSession(const InferenceSession& source_session,
+                                                              size_t& num_shared_initializers) {
+  num_shared_initializers = 0;
+#if !defined(ORT_MINIMAL_BUILD)
+  std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+  if (!is_model_loaded_ || is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "Initializers can only be shared after the model is loaded and before the session is "
+                           "initialized.");
+  }
+  if (&source_session == this || source_session.session_state_ == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "The session to share the initializers of must be another initialized session.");
+  }
+
+  const SessionState& source_state = *source_session.session_state_;
+  const auto& source_initializers = source_state.GetInitializedTensors();
+  const Graph& graph = model_->MainGraph();
+  std::vector<uint8_t> unpacked_data;
+  for (const auto& [name, tensor_proto] : graph.GetAllInitializedTensors()) {
+    int ort_value_idx;
+    if (session_options_.initializers_to_share_map.count(name) > 0 ||
+        !source_state.GetOrtValueNameIdxMap().GetIdx(name, ort_value_idx).IsOK()) {
+      continue;
+    }
+
+    const auto source_value = source_initializers.find(ort_value_idx);
+    if (source_value == source_initializers.end() || !source_value->second.IsTensor()) {
+      continue;
+    }
+
+    // the data of the initializers on other devices would have to be copied to be compared
+    const Tensor& source_tensor = source_value->second.Get<Tensor>();
+    if (source_tensor.Location().device.Type() != OrtDevice::CPU ||
+        source_tensor.IsDataTypeString() ||
+        source_tensor.GetElementType() != tensor_proto->data_type() ||
+        source_tensor.Shape() != utils::GetTensorShapeFromTensorProto(*tensor_proto)) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(utils::UnpackInitializerData(*tensor_proto, graph.ModelPath(), unpacked_data));
+    if (unpacked_data.size() != source_tensor.SizeInBytes() ||
+        (!unpacked_data.empty() &&
+         memcmp(unpacked_data.data(), source_tensor.DataRaw(), unpacked_data.size()) != 0)) {
+      continue;
+    }
+
+    const auto& shared_value = initializers_shared_from_session_[name] = source_value->second;
+    session_options_.initializers_to_share_map[name] = &shared_value;
+    ++num_shared_initializers;
+  }
+
+  // share the pre-packed weights of the shared initializers too. a container owned by the source session does not
+  // outlive it.
+  if (prepacked_weights_container_ == nullptr && source_session.owned_prepacked_weights_container_ == nullptr) {
+    prepacked_weights_container_ = source_session.prepacked_weights_container_;
+  }
+
+  LOGS(*session_logger_, INFO) << "Sharing " << num_shared_initializers << " initializers from another session";
+  return Status::OK();
+#else
+  ORT_UNUSED_PARAMETER(source_session);
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Sharing initializers is not supported in this build.");
+#endif
+}
+
 namespace {
 Status PartitionOrtFormatModel(onnxruntime::Graph& graph,
                                const ExecutionProviders& providers,
@@ -1622,9 +2016,8 @@ common::Status InferenceSession::Initialize() {
     }
 
     // Verify that there are no external initializers in the graph if external data is disabled.
-    onnxruntime::Graph& graph = model_->MainGraph();
 #ifdef DISABLE_EXTERNAL_INITIALIZERS
-    const InitializedTensorSet& initializers = graph.GetAllInitializedTensors();
+    const InitializedTensorSet& initializers = model_->MainGraph().GetAllInitializedTensors();
     for (const auto& it : initializers) {
       if (utils::HasExternalData(*it.second)) {
         return common::Status(common::ONNXRUNTIME, common::FAIL,
@@ -1638,6 +2031,10 @@ common::Status InferenceSession::Initialize() {
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      if (use_per_session_threads_) {
+        epi.numa_node = std::stoi(
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaNode, "-1"));
+      }
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
       execution_providers_.SetCpuProviderWasImplicitlyAdded(true);
@@ -1646,6 +2043,14 @@ common::Status InferenceSession::Initialize() {
     // re-acquire mutex
     std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
 
+#if !defined(ORT_MINIMAL_BUILD)
+    // replace the ONNX model with its optimized form if a previous session cached it
+    PathString optimized_model_cache_path;
+    LoadOptimizedModelFromCache(optimized_model_cache_path);
+#endif
+
+    onnxruntime::Graph& graph = model_->MainGraph();
+
 #if !defined(DISABLE_EXTERNAL_INITIALIZERS) && !defined(ORT_MINIMAL_BUILD)
     if (!session_options_.external_initializers.empty()) {
       ORT_RETURN_IF_ERROR_SESSIONID_(graph.InjectExternalInitializedTensors(session_options_.external_initializers));
@@ -1665,6 +2070,32 @@ common::Status InferenceSession::Initialize() {
     session_activity_started_ = true;
 #endif
 
+    // share the pre-packed weights with other processes through a file if requested. the weights in an existing
+    // file are mapped into the container before the kernels are pre-packed, otherwise the file is written once the
+    // session state is finalized.
+    const std::string prepacked_weights_file =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrepackedWeightsFile, "");
+    bool save_prepacked_weights_file = false;
+    if (!prepacked_weights_file.empty()) {
+      if (prepacked_weights_container_ == nullptr) {
+        owned_prepacked_weights_container_ = std::make_unique<PrepackedWeightsContainer>();
+        prepacked_weights_container_ = owned_prepacked_weights_container_.get();
+      }
+
+      const PathString prepacked_weights_file_path = ToPathString(prepacked_weights_file);
+      std::lock_guard<onnxruntime::OrtMutex> container_lock(prepacked_weights_container_->mutex_);
+      size_t file_length = 0;
+      if (Env::Default().GetFileLength(prepacked_weights_file_path.c_str(), file_length).IsOK()) {
+        const auto status = prepacked_weights_container_->LoadFromFile(prepacked_weights_file_path);
+        if (!status.IsOK()) {
+          LOGS(*session_logger_, WARNING) << "Failed to load pre-packed weights from " << prepacked_weights_file
+                                          << ". Weights will be pre-packed by this session. " << status.ErrorMessage();
+        }
+      } else {
+        save_prepacked_weights_file = true;
+      }
+    }
+
     // now that we have all the execution providers, create the session state
     session_state_ = std::make_unique<SessionState>(
         model_->MainGraph(),
@@ -1681,7 +2112,24 @@ common::Status InferenceSession::Initialize() {
         session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseEnvAllocators, "0") == "1";
     if (use_env_allocators) {
       LOGS(*session_logger_, INFO) << "This session will use the allocator registered with the environment.";
-      session_state_->UpdateAllocatorsWithEnvAllocators(environment_.GetRegisteredSharedAllocators());
+      const auto env_allocator_memory_limit = std::stoull(session_options_.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsConfigEnvAllocatorMemoryLimit, "0"));
+      const bool enable_env_allocator_accounting =
+          env_allocator_memory_limit > 0 ||
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableEnvAllocatorAccounting,
+                                                             "0") == "1";
+      if (enable_env_allocator_accounting) {
+        LOGS(*session_logger_, INFO) << "Tracking the usage of the environment allocators by this session with a "
+                                     << "limit of " << env_allocator_memory_limit << " bytes (0 for no limit).";
+        std::vector<AllocatorPtr> accounting_allocators;
+        for (const auto& env_alloc : environment_.GetRegisteredSharedAllocators()) {
+          accounting_allocators.push_back(
+              std::make_shared<AccountingAllocator>(env_alloc, static_cast<size_t>(env_allocator_memory_limit)));
+        }
+        session_state_->UpdateAllocatorsWithEnvAllocators(accounting_allocators);
+      } else {
+        session_state_->UpdateAllocatorsWithEnvAllocators(environment_.GetRegisteredSharedAllocators());
+      }
     }
 
     for (auto& ep : execution_providers_) {
@@ -1691,6 +2139,26 @@ common::Status InferenceSession::Initialize() {
       }
     }
 
+    if (auto* cpu_tuning_ctx = execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetTuningContext();
+        cpu_tuning_ctx != nullptr) {
+      const auto& config_options = session_options_.config_options;
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTunableOp();
+      }
+      if (config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpTuningEnable, "0") == "1") {
+        cpu_tuning_ctx->EnableTuning();
+      }
+      const std::string max_tuning_duration_ms_str =
+          config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "");
+      if (!max_tuning_duration_ms_str.empty()) {
+        int max_tuning_duration_ms = 0;
+        ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale<int>(max_tuning_duration_ms_str, max_tuning_duration_ms),
+                          "Invalid value for ", kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, ": ",
+                          max_tuning_duration_ms_str);
+        cpu_tuning_ctx->SetMaxTuningDurationMs(max_tuning_duration_ms);
+      }
+    }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
     // Don't want to pollute SessionState constructor since memory profile is enabled optionally.
     session_state_->SetMemoryProfiler(&memory_profiler_);
@@ -1733,6 +2201,12 @@ common::Status InferenceSession::Initialize() {
         return Status::OK();
       };
 
+      // transform independent subgraphs concurrently if the session initializes in parallel
+      if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableParallelInitialization,
+                                                             "0") == "1") {
+        graph_transformer_mgr_.SetThreadPool(GetIntraOpThreadPoolToUse());
+      }
+
       // add predefined transformers
       ORT_RETURN_IF_ERROR_SESSIONID_(AddPredefinedTransformers(graph_transformer_mgr_,
                                                                session_options_.graph_optimization_level,
@@ -1794,12 +2268,21 @@ common::Status InferenceSession::Initialize() {
       }
 #endif
 
+      // keep the original model to create the shape specialized sessions from, if it cannot be loaded again
+      if (CanSpecializeShapes() && model_location_.empty()) {
+        shape_specialization_model_data_ = model_->ToProto().SerializeAsString();
+      }
+
       // apply any transformations to the main graph and any subgraphs
       ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, saving_ort_format));
 
       // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
       ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
 
+      if (!optimized_model_cache_path.empty()) {
+        SaveOptimizedModelToCache(optimized_model_cache_path);
+      }
+
       // Currently graph capture is only considered by CUDA EP, TRT EP, ROCM EP and JS EP.
       //
       // Check for CUDA EP:
@@ -1963,6 +2446,18 @@ common::Status InferenceSession::Initialize() {
                                              !saving_model,
                                              saving_ort_format));
 
+    if (save_prepacked_weights_file) {
+      std::lock_guard<onnxruntime::OrtMutex> container_lock(prepacked_weights_container_->mutex_);
+      const auto status = prepacked_weights_container_->SaveToFile(ToPathString(prepacked_weights_file));
+      if (status.IsOK()) {
+        LOGS(*session_logger_, INFO) << "Saved " << prepacked_weights_container_->GetNumberOfElements()
+                                     << " pre-packed weights to " << prepacked_weights_file;
+      } else {
+        LOGS(*session_logger_, WARNING) << "Failed to save pre-packed weights to " << prepacked_weights_file << ". "
+                                        << status.ErrorMessage();
+      }
+    }
+
 #if !defined(ORT_MINIMAL_BUILD)
     if (saving_model) {
       if (session_state_->GetFuncMgr().NumFuncs() > 0) {
@@ -2008,16 +2503,152 @@ common::Status InferenceSession::Initialize() {
     if (found_tuning_results) {
       ORT_RETURN_IF_ERROR_SESSIONID_(SetTuningResults(tuning_results, /*error_on_invalid*/ false, /*auto_enable*/ true));
     }
+
+    const std::string tuning_results_file =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigTuningResultsFile, "");
+    if (!tuning_results_file.empty()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(inference_session_utils::ParseTuningResultsFromFile(
+          ToPathString(tuning_results_file), tuning_results, found_tuning_results));
+      if (found_tuning_results) {
+        LOGS(*session_logger_, INFO) << "Loading tuning results from " << tuning_results_file;
+        ORT_RETURN_IF_ERROR_SESSIONID_(SetTuningResults(tuning_results, /*error_on_invalid*/ false,
+                                                        /*auto_enable*/ true));
+      }
+    }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    const int64_t dynamic_batching_max_batch_size = std::stoll(session_options_.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "0"));
+    if (dynamic_batching_max_batch_size > 1) {
+      const auto max_queue_delay = std::chrono::microseconds(std::stoll(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs,
+                                                             "100")));
+      LOGS(*session_logger_, INFO) << "Dynamic batching enabled with max batch size " << dynamic_batching_max_batch_size
+                                   << " and max queue delay of " << max_queue_delay.count() << " us";
+      dynamic_batcher_ = std::make_unique<DynamicBatcher>(
+          dynamic_batching_max_batch_size, max_queue_delay, session_state_->GetAllocator(OrtDevice()),
+          [this](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                 gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                 std::vector<OrtValue>& fetches) {
+            return RunImpl(run_options, feed_names, feeds, output_names, &fetches, nullptr);
+          });
+    }
+
+    const int64_t pipeline_micro_batch_size = std::stoll(session_options_.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsConfigPipelineMicroBatchSize, "0"));
+    if (pipeline_micro_batch_size > 0) {
+      const int max_in_flight = std::stoi(session_options_.config_options.GetConfigOrDefault(
+          kOrtSessionOptionsConfigPipelineMaxMicroBatchesInFlight, "2"));
+      LOGS(*session_logger_, INFO) << "Pipelining enabled with micro-batches of " << pipeline_micro_batch_size
+                                   << " rows and up to " << max_in_flight << " micro-batches in flight";
+      micro_batch_pipeline_ = std::make_unique<MicroBatchPipeline>(
+          pipeline_micro_batch_size, max_in_flight, GetIntraOpThreadPoolToUse(),
+          session_state_->GetAllocator(OrtDevice()),
+          [this](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                 gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                 std::vector<OrtValue>& fetches) {
+            return RunImpl(run_options, feed_names, feeds, output_names, &fetches, nullptr);
+          });
+    }
+
+    if (!loading_ort_format && CanSpecializeShapes()) {
+      std::vector<ShapeSpecializer::FreeDim> free_dims;
+      for (const NodeArg* input : model_->MainGraph().GetInputs()) {
+        const auto* shape = input->Shape();
+        for (int i = 0; shape != nullptr && i < shape->dim_size(); ++i) {
+          if (utils::HasDimParam(shape->dim(i))) {
+            free_dims.push_back({input->Name(), static_cast<size_t>(i), shape->dim(i).dim_param()});
+          }
+        }
+      }
+
+      if (!free_dims.empty()) {
+        const auto max_variants = static_cast<size_t>(std::stoll(session_options_.config_options.GetConfigOrDefault(
+            kOrtSessionOptionsConfigShapeSpecializationMaxVariants, "0")));
+        const auto min_runs = static_cast<size_t>(std::max<int64_t>(1, std::stoll(
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigShapeSpecializationMinRuns,
+                                                               "8"))));
+        LOGS(*session_logger_, INFO) << "Shape specialization enabled for " << free_dims.size()
+                                     << " free dimensions with up to " << max_variants << " variants";
+        shape_specializer_ = std::make_unique<ShapeSpecializer>(
+            std::move(free_dims), min_runs, max_variants,
+            [this](const std::vector<FreeDimensionOverride>& overrides, std::unique_ptr<InferenceSession>& session) {
+              return CreateShapeSpecializedSession(overrides, session);
+            },
+            *session_logger_);
+      }
+    }
+
+    graph_capture_auto_annotation_ = cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled() &&
+                                     session_options_.config_options.GetConfigOrDefault(
+                                         kOrtSessionOptionsConfigGraphCaptureAutoAnnotation, "0") == "1";
+    if (graph_capture_auto_annotation_) {
+      graph_capture_max_graphs_ = static_cast<size_t>(std::max<int64_t>(0, std::stoll(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigGraphCaptureMaxGraphs, "8"))));
+      LOGS(*session_logger_, INFO) << "Graphs are captured per run signature, up to " << graph_capture_max_graphs_
+                                   << " graphs";
+    }
+
+    enable_cpu_graph_capture_ = session_options_.config_options.GetConfigOrDefault(
+                                    kOrtSessionOptionsConfigEnableCpuGraphCapture, "0") == "1";
+    if (enable_cpu_graph_capture_) {
+      const auto status = CapturedGraph::CanCapture(*session_state_);
+      if (!status.IsOK()) {
+        LOGS(*session_logger_, ERROR) << "This session cannot use the CPU graph capture feature as requested by the "
+                                      << "user: " << status.ErrorMessage();
+        ORT_RETURN_IF_ERROR_SESSIONID_(
+            ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                            "This session cannot use the CPU graph capture feature as requested by the user: ",
+                            status.ErrorMessage()));
+      }
+      LOGS(*session_logger_, INFO) << "This session will use the CPU graph capture feature as requested by the user.";
+    }
+
+    const std::string arena_compaction_free_ratio = session_options_.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsConfigArenaCompactionFreeRatio, "0");
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale<double>(arena_compaction_free_ratio,
+                                                              arena_compaction_free_ratio_) &&
+                          arena_compaction_free_ratio_ >= 0.0 && arena_compaction_free_ratio_ <= 1.0,
+                      "Invalid value for ", kOrtSessionOptionsConfigArenaCompactionFreeRatio, ": ",
+                      arena_compaction_free_ratio, ". It must be a number in [0, 1].");
+    if (arena_compaction_free_ratio_ > 0.0) {
+      for (const auto& [device, alloc] : session_state_->GetAllocators()) {
+        if (alloc->Info().alloc_type == OrtAllocatorType::OrtArenaAllocator &&
+            std::find(arenas_to_compact_.begin(), arenas_to_compact_.end(), alloc) == arenas_to_compact_.end()) {
+          arenas_to_compact_.push_back(alloc);
+        }
+      }
+    }
+
+    const std::string stateful_io_pairs = session_options_.config_options.GetConfigOrDefault(
+        kOrtSessionOptionsConfigStatefulIOPairs, "");
+    if (!stateful_io_pairs.empty()) {
+      InlinedHashSet<std::string> state_inputs;
+      for (const auto& pair : utils::SplitString(stateful_io_pairs, ";")) {
+        const auto names = utils::SplitString(pair, ":");
+        ORT_RETURN_IF_NOT(names.size() == 2, "Invalid value for ", kOrtSessionOptionsConfigStatefulIOPairs, ": '",
+                          pair, "' is not an '<output name>:<input name>' pair.");
+        std::string output_name{names[0]};
+        std::string input_name{names[1]};
+        ORT_RETURN_IF_NOT(output_def_map_.count(output_name) > 0, "Invalid value for ",
+                          kOrtSessionOptionsConfigStatefulIOPairs, ": ", output_name, " is not a graph output.");
+        ORT_RETURN_IF_NOT(input_def_map_.count(input_name) > 0, "Invalid value for ",
+                          kOrtSessionOptionsConfigStatefulIOPairs, ": ", input_name, " is not a graph input.");
+        ORT_RETURN_IF_NOT(state_inputs.insert(input_name).second, "Invalid value for ",
+                          kOrtSessionOptionsConfigStatefulIOPairs, ": ", input_name, " is the input of several pairs.");
+        stateful_io_pairs_.emplace_back(std::move(output_name), std::move(input_name));
+      }
+    }
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
       ort_format_model_bytes_ = gsl::span<const uint8_t>();
       std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+      ort_format_model_mapped_bytes_.reset();
     }
 
     // once the model is saved, we may remove unnecessary attributes for inference
@@ -2401,7 +3032,119 @@ struct ThreadPoolSpinningSwitch {
 Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
-                             const std::vector<OrtDevice>* p_fetches_device_info) {
+                             const std::vector<OrtDevice>* p_fetches_device_info,
+                             const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators) {
+  if (shape_specializer_ != nullptr) {
+    if (InferenceSession* specialized = shape_specializer_->GetSession(feed_names, feeds)) {
+      return specialized->Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                              p_fetch_allocators);
+    }
+  }
+  if (micro_batch_pipeline_ != nullptr && p_fetches != nullptr && p_fetches_device_info == nullptr &&
+      micro_batch_pipeline_->CanSplit(run_options, feeds, *p_fetches)) {
+    return micro_batch_pipeline_->Run(run_options, feed_names, feeds, output_names, *p_fetches);
+  }
+  if (dynamic_batcher_ != nullptr && p_fetches != nullptr && p_fetches_device_info == nullptr &&
+      dynamic_batcher_->CanBatch(run_options, feeds, *p_fetches)) {
+    return dynamic_batcher_->Run(run_options, feed_names, feeds, output_names, *p_fetches);
+  }
+  if (graph_capture_auto_annotation_ &&
+      !run_options.config_options.GetConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation).has_value()) {
+    RunOptions annotated_run_options = run_options;
+    const std::string graph_annotation_id =
+        std::to_string(GetGraphAnnotationId(feed_names, feeds, output_names, p_fetches));
+    ORT_RETURN_IF_ERROR(annotated_run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation,
+                                                                            graph_annotation_id.c_str()));
+    return RunImpl(annotated_run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                   p_fetch_allocators);
+  }
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info, p_fetch_allocators);
+}
+
+// A captured graph reads and writes the buffers of the run that captured it, so the buffers are part of the signature.
+int InferenceSession::GetGraphAnnotationId(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                           gsl::span<const std::string> output_names,
+                                           const std::vector<OrtValue>* p_fetches) {
+  std::ostringstream signature;
+  auto add_value = [&signature](const OrtValue& value) {
+    if (value.IsTensor()) {
+      const Tensor& tensor = value.Get<Tensor>();
+      signature << tensor.Shape() << '@' << tensor.DataRaw();
+    }
+    signature << ';';
+  };
+  for (size_t i = 0; i < feed_names.size(); ++i) {
+    signature << feed_names[i] << ':';
+    add_value(feeds[i]);
+  }
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    signature << output_names[i] << ':';
+    if (p_fetches != nullptr && i < p_fetches->size() && (*p_fetches)[i].IsAllocated()) {
+      add_value((*p_fetches)[i]);
+    } else {
+      signature << ';';
+    }
+  }
+
+  std::lock_guard<OrtMutex> lock(graph_annotation_ids_mutex_);
+  auto it = graph_annotation_ids_.find(signature.str());
+  if (it != graph_annotation_ids_.end()) {
+    return it->second;
+  }
+  if (graph_annotation_ids_.size() >= graph_capture_max_graphs_) {
+    return CachedExecutionProviderForGraphReplay::kGraphAnnotationSkip;
+  }
+
+  // 0 is the annotation id of the runs that do not set one
+  const int graph_annotation_id = static_cast<int>(graph_annotation_ids_.size()) + 1;
+  graph_annotation_ids_.emplace(signature.str(), graph_annotation_id);
+  LOGS(*session_logger_, INFO) << "Assigned graph annotation id " << graph_annotation_id
+                               << " to the run signature " << signature.str();
+  return graph_annotation_id;
+}
+
+bool InferenceSession::CanSpecializeShapes() const {
+#if !defined(ORT_MINIMAL_BUILD)
+  return session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigShapeSpecializationMaxVariants,
+                                                            "0") != "0" &&
+         session_options_.graph_optimization_level > TransformerLevel::Default &&
+         !HasLocalSchema() &&
+         execution_providers_.NumProviders() == 1 && execution_providers_.Get(kCpuExecutionProvider) != nullptr;
+#else
+  return false;
+#endif
+}
+
+Status InferenceSession::CreateShapeSpecializedSession(const std::vector<FreeDimensionOverride>& overrides,
+                                                       std::unique_ptr<InferenceSession>& session) const {
+  SessionOptions options = session_options_;
+  options.free_dimension_overrides.insert(options.free_dimension_overrides.end(), overrides.begin(), overrides.end());
+  options.config_options.configurations[kOrtSessionOptionsConfigShapeSpecializationMaxVariants] = "0";
+  options.optimized_model_filepath.clear();
+  options.enable_profiling = false;
+  options.session_logid += "_specialized";
+
+  auto specialized = std::make_unique<InferenceSession>(options, environment_);
+  ORT_RETURN_IF_ERROR(specialized->RegisterExecutionProvider(
+      std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(session_options_.enable_cpu_mem_arena))));
+  if (shape_specialization_model_data_.empty()) {
+    ORT_RETURN_IF_ERROR(specialized->Load(model_location_));
+  } else {
+    ORT_RETURN_IF_ERROR(specialized->Load(shape_specialization_model_data_.data(),
+                                          static_cast<int>(shape_specialization_model_data_.size())));
+  }
+  ORT_RETURN_IF_ERROR(specialized->Initialize());
+
+  session = std::move(specialized);
+  return Status::OK();
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info,
+                                 const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators,
+                                 PreparedRun* prepared_run) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -2415,9 +3158,14 @@ Status InferenceSession::Run(const RunOptions& run_options,
   Status retval = Status::OK();
   const Env& env = Env::Default();
 
+  // Most runs have no config entry, their lookups are skipped then as each of them builds strings.
+  const bool has_run_config_entries = !run_options.config_options.configurations.empty();
+
   int graph_annotation_id = 0;
-  const std::string& graph_annotation_str =
-      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigCudaGraphAnnotation, "");
+  const std::string graph_annotation_str =
+      has_run_config_entries
+          ? run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigCudaGraphAnnotation, "")
+          : std::string{};
   if (!graph_annotation_str.empty()) {
     if (!TryParseStringWithClassicLocale<int>(graph_annotation_str, graph_annotation_id)) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Failed to parse the cuda graph annotation id: ",
@@ -2433,6 +3181,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
   auto* intra_tp = (control_spinning) ? thread_pool_.get() : nullptr;
   auto* inter_tp = (control_spinning) ? inter_op_thread_pool_.get() : nullptr;
   ThreadPoolSpinningSwitch runs_refcounter_and_tp_spin_control(intra_tp, inter_tp, current_num_runs_);
+  concurrency::ThreadPool::ScopedDegreeOfParallelismLimit degree_of_parallelism_limit(max_degree_of_parallelism_);
 
   // Check if this Run() is simply going to be a CUDA Graph replay.
   if (cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation_id)) {
@@ -2456,19 +3205,35 @@ Status InferenceSession::Run(const RunOptions& run_options,
       // log evaluation start to trace logging provider
       env.GetTelemetryProvider().LogEvaluationStart();
 
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      if (prepared_run != nullptr) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidatePreparedFeeds(*prepared_run, feeds));
+        // the names are known to be valid, only pre-allocated fetches need to be checked
+        if (std::any_of(p_fetches->begin(), p_fetches->end(),
+                        [](const OrtValue& fetch) { return fetch.IsAllocated(); })) {
+          ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+        }
+      } else {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      }
 
       // shrink certain default memory arenas if the user has requested for it
-      const std::string& shrink_memory_arenas =
-          run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigEnableMemoryArenaShrinkage, "");
+      if (has_run_config_entries) {
+        const std::string& shrink_memory_arenas =
+            run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigEnableMemoryArenaShrinkage, "");
 
-      if (!shrink_memory_arenas.empty()) {
-        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
+        if (!shrink_memory_arenas.empty()) {
+          ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
+        }
       }
 
-      FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-      FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+      std::optional<FeedsFetchesManager> owned_feeds_fetches_manager;
+      if (prepared_run == nullptr) {
+        owned_feeds_fetches_manager.emplace(
+            FeedsFetchesInfo(feed_names, output_names, session_state_->GetOrtValueNameIdxMap()));
+      }
+      FeedsFetchesManager& feeds_fetches_manager =
+          prepared_run != nullptr ? prepared_run->feeds_fetches_manager_ : *owned_feeds_fetches_manager;
 
       if (p_fetches_device_info) {
         // populate the target device info. ignored if pre-allocated fetches are provided
@@ -2527,19 +3292,30 @@ Status InferenceSession::Run(const RunOptions& run_options,
       DeviceStreamCollectionHolder device_stream_collection_holder(session_state_.get());
 #endif
 
-      if (retval.IsOK()) {
+      bool replayed_cpu_graph = false;
+      if (enable_cpu_graph_capture_ && p_fetches_device_info == nullptr && !run_options.only_execute_path_to_fetches) {
+        ORT_CHECK_AND_SET_RETVAL(ReplayCapturedCpuGraph(run_options, feeds_fetches_manager.GetFeedsFetchesInfo(), feeds,
+                                                        *p_fetches, run_logger, replayed_cpu_graph));
+      }
+
+      if (retval.IsOK() && !replayed_cpu_graph) {
+        const std::unordered_map<size_t, IExecutor::CustomAllocator> no_fetch_allocators;
         retval = utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
                                      session_options_.execution_mode,
                                      run_options,
 #ifdef ORT_ENABLE_STREAM
                                      device_stream_collection_holder,
 #endif
-                                     run_logger);
+                                     run_logger,
+                                     p_fetch_allocators ? *p_fetch_allocators : no_fetch_allocators);
       }
 
       // info all execution providers InferenceSession:Run ended
+      const bool synchronize_execution_providers =
+          !has_run_config_entries ||
+          run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigDisableSynchronizeExecutionProviders,
+                                                        "0") == "0";
       for (auto* xp : exec_providers_to_stop) {
-        bool synchronize_execution_providers = run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigDisableSynchronizeExecutionProviders, "0") == "0";
         auto status = xp->OnRunEnd(synchronize_execution_providers, run_options);
         ORT_CHECK_AND_SET_RETVAL(status);
       }
@@ -2550,8 +3326,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
 #ifdef ORT_ENABLE_STREAM
       DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
       if (device_stream_collection) {
-        bool sync_execution_provider = run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigDisableSynchronizeExecutionProviders, "0") == "0";
-        ORT_CHECK_AND_SET_RETVAL(device_stream_collection->CleanUp(sync_execution_provider));
+        ORT_CHECK_AND_SET_RETVAL(device_stream_collection->CleanUp(synchronize_execution_providers));
       }
 #endif
     }
@@ -2567,6 +3342,10 @@ Status InferenceSession::Run(const RunOptions& run_options,
     if (!arenas_to_shrink.empty()) {
       ShrinkMemoryArenas(arenas_to_shrink);
     }
+
+    if (!arenas_to_compact_.empty()) {
+      CompactMemoryArenas();
+    }
   }
 
   // keep track of telemetry
@@ -2610,6 +3389,53 @@ Status InferenceSession::Run(const RunOptions& run_options,
   return retval;
 }
 
+Status InferenceSession::ReplayCapturedCpuGraph(const RunOptions& run_options, const FeedsFetchesInfo& info,
+                                                gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                                const logging::Logger& run_logger, bool& replayed) {
+  replayed = false;
+
+  // Concurrent runs execute the graph as usual while the captured graph is in use.
+  std::unique_lock<OrtMutex> lock(captured_cpu_graph_mutex_, std::try_to_lock);
+  if (!lock.owns_lock() || !cpu_graph_capture_allowed_) {
+    return Status::OK();
+  }
+
+  if (captured_cpu_graph_ == nullptr) {
+    const auto status = CapturedGraph::Create(*session_state_, info.feeds_mlvalue_idxs, feeds,
+                                              info.fetches_mlvalue_idxs, captured_cpu_graph_);
+    if (!status.IsOK()) {
+      LOGS(run_logger, VERBOSE) << "Not capturing the CPU graph for this run: " << status.ErrorMessage();
+      return Status::OK();
+    }
+    LOGS(run_logger, INFO) << "Capturing the CPU graph for this model.";
+  }
+
+  if (!captured_cpu_graph_->Matches(info.feeds_mlvalue_idxs, feeds, info.fetches_mlvalue_idxs)) {
+    return Status::OK();
+  }
+
+  const bool preallocated_fetches = !fetches.empty();
+  const auto status = captured_cpu_graph_->Replay(feeds, fetches, run_options.terminate, run_logger);
+  if (!status.IsOK()) {
+    if (run_options.terminate) {
+      return status;
+    }
+    // The shapes of the values of the model may depend on more than the input shapes,
+    // so it is executed as usual from now on.
+    LOGS(run_logger, WARNING) << "Failed to replay the captured CPU graph, disabling the CPU graph capture: "
+                              << status.ErrorMessage();
+    captured_cpu_graph_.reset();
+    cpu_graph_capture_allowed_ = false;
+    if (!preallocated_fetches) {
+      fetches.clear();
+    }
+    return Status::OK();
+  }
+
+  replayed = true;
+  return Status::OK();
+}
+
 Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const char* const> feed_names,
                              gsl::span<const OrtValue* const> feeds,
@@ -2681,6 +3507,308 @@ Status InferenceSession::Run(const RunOptions& run_options,
   return Status::OK();
 }
 
+Status InferenceSession::NewPreparedRun(gsl::span<const std::string> feed_names,
+                                        gsl::span<const std::string> output_names,
+                                        std::unique_ptr<PreparedRun>& prepared_run) const {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, nullptr));
+
+  std::vector<PreparedRun::ExpectedFeed> expected_feeds;
+  expected_feeds.reserve(feed_names.size());
+  for (const auto& name : feed_names) {
+    auto iter = input_def_map_.find(name);
+    if (iter == input_def_map_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid input name: ", name);
+    }
+    const MLDataType type = iter->second.ml_data_type;
+    expected_feeds.push_back({type->IsTensorType() ? type->AsTensorType()->GetElementType() : nullptr,
+                              iter->second.tensor_shape});
+  }
+
+  FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+  prepared_run.reset(new PreparedRun(*this, std::move(info), std::move(expected_feeds)));
+  return Status::OK();
+}
+
+Status InferenceSession::ValidatePreparedFeeds(const PreparedRun& prepared_run,
+                                               gsl::span<const OrtValue> feeds) const {
+  const auto& feed_names = prepared_run.GetFeedNames();
+  if (feeds.size() != feed_names.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "feed names has ", feed_names.size(),
+                           " elements, but feed has ", feeds.size(), " elements.");
+  }
+
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    const auto& expected = prepared_run.expected_feeds_[i];
+    if (expected.element_type != nullptr && feeds[i].IsTensor()) {
+      const Tensor& tensor = feeds[i].Get<Tensor>();
+      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(tensor.DataType(), expected.element_type, "tensor", "input"));
+      if (expected.shape.has_value() && !expected.shape->GetDims().empty()) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_names[i], tensor.Shape(), *expected.shape, "input"));
+      }
+    } else {
+      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(gsl::make_span(&feed_names[i], 1), feeds.subspan(i, 1)));
+    }
+  }
+  return Status::OK();
+}
+
+Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches) {
+  if (&prepared_run.session_ != this) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The prepared run was created by another session.");
+  }
+  const auto& feed_names = prepared_run.GetFeedNames();
+  const auto& output_names = prepared_run.GetOutputNames();
+  if (fetches.empty()) {
+    fetches.resize(output_names.size());
+  } else if (fetches.size() != output_names.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected ", output_names.size(), " fetches but got ",
+                           fetches.size());
+  }
+
+  // The features that route or rewrite a run depend on its feeds, they need the full Run().
+  if (shape_specializer_ != nullptr || micro_batch_pipeline_ != nullptr || dynamic_batcher_ != nullptr ||
+      graph_capture_auto_annotation_) {
+    return Run(run_options, feed_names, feeds, output_names, &fetches);
+  }
+  return RunImpl(run_options, feed_names, feeds, output_names, &fetches, nullptr, nullptr, &prepared_run);
+}
+
+Status InferenceSession::RunBatch(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                  gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                  size_t batch_size, std::vector<OrtValue>& fetches) {
+  const size_t num_feeds = feed_names.size();
+  const size_t num_outputs = output_names.size();
+  if (feeds.size() != batch_size * num_feeds) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected ", batch_size * num_feeds, " feeds for ",
+                           batch_size, " requests of ", num_feeds, " inputs but got ", feeds.size());
+  }
+  if (fetches.empty()) {
+    fetches.resize(batch_size * num_outputs);
+  } else if (fetches.size() != batch_size * num_outputs) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected ", batch_size * num_outputs, " fetches for ",
+                           batch_size, " requests of ", num_outputs, " outputs but got ", fetches.size());
+  }
+
+  // The features that route or rewrite a run need the full Run() of each request.
+  if (shape_specializer_ != nullptr || micro_batch_pipeline_ != nullptr || dynamic_batcher_ != nullptr ||
+      graph_capture_auto_annotation_ || enable_cpu_graph_capture_ ||
+      cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled()) {
+    for (size_t i = 0; i < batch_size; ++i) {
+      auto request_fetches_begin = fetches.begin() + i * num_outputs;
+      std::vector<OrtValue> request_fetches(request_fetches_begin, request_fetches_begin + num_outputs);
+      ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds.subspan(i * num_feeds, num_feeds), output_names,
+                              &request_fetches));
+      std::move(request_fetches.begin(), request_fetches.end(), request_fetches_begin);
+    }
+    return Status::OK();
+  }
+
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  TimePoint tp;
+  if (session_profiler_.IsEnabled()) {
+    tp = session_profiler_.Start();
+  }
+
+  Status retval = Status::OK();
+  const Env& env = Env::Default();
+
+  auto* intra_tp = (use_per_session_threads_ && force_spinning_stop_between_runs_) ? thread_pool_.get() : nullptr;
+  auto* inter_tp = (use_per_session_threads_ && force_spinning_stop_between_runs_) ? inter_op_thread_pool_.get()
+                                                                                    : nullptr;
+  ThreadPoolSpinningSwitch runs_refcounter_and_tp_spin_control(intra_tp, inter_tp, current_num_runs_);
+  concurrency::ThreadPool::ScopedDegreeOfParallelismLimit degree_of_parallelism_limit(max_degree_of_parallelism_);
+
+  InlinedVector<IExecutionProvider*> exec_providers_to_stop;
+  exec_providers_to_stop.reserve(execution_providers_.NumProviders());
+
+  ORT_TRY {
+    env.GetTelemetryProvider().LogEvaluationStart();
+
+    ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, nullptr));
+
+    FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+    FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+
+    if (!run_options.run_tag.empty()) {
+      LOGS(*session_logger_, INFO) << "Running a batch of " << batch_size << " requests with tag: "
+                                   << run_options.run_tag;
+    }
+
+    std::unique_ptr<logging::Logger> owned_run_logger;
+    const auto& run_logger = CreateLoggerForRun(run_options, owned_run_logger);
+
+    std::optional<std::lock_guard<OrtMutex>> sequential_run_lock;
+    if (is_concurrent_run_supported_ == false) {
+      sequential_run_lock.emplace(session_mutex_);
+    }
+
+    for (auto& xp : execution_providers_) {
+      auto start_func = [&xp, &exec_providers_to_stop, &run_options]() {
+        auto status = xp->OnRunStart(run_options);
+        if (status.IsOK())
+          exec_providers_to_stop.push_back(xp.get());
+
+        return status;
+      };
+
+      ORT_CHECK_AND_SET_RETVAL(start_func());
+    }
+
+    const bool sync_execution_provider =
+        run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigDisableSynchronizeExecutionProviders, "0") ==
+        "0";
+    std::vector<OrtValue> request_fetches;
+    for (size_t i = 0; i < batch_size && retval.IsOK(); ++i) {
+      const auto request_feeds = feeds.subspan(i * num_feeds, num_feeds);
+      auto request_fetches_begin = fetches.begin() + i * num_outputs;
+      retval = ValidateInputs(feed_names, request_feeds);
+      if (!retval.IsOK()) {
+        break;
+      }
+      request_fetches.assign(request_fetches_begin, request_fetches_begin + num_outputs);
+      if (std::any_of(request_fetches.begin(), request_fetches.end(),
+                      [](const OrtValue& fetch) { return fetch.IsAllocated(); })) {
+        retval = ValidateOutputs(output_names, &request_fetches);
+        if (!retval.IsOK()) {
+          break;
+        }
+      }
+
+#ifdef DEBUG_NODE_INPUTS_OUTPUTS
+      session_state_->IncrementGraphExecutionCounter();
+#endif
+
+#ifdef ORT_ENABLE_STREAM
+      DeviceStreamCollectionHolder device_stream_collection_holder(session_state_.get());
+#endif
+      retval = utils::ExecuteGraph(*session_state_, feeds_fetches_manager, request_feeds, request_fetches,
+                                   session_options_.execution_mode,
+                                   run_options,
+#ifdef ORT_ENABLE_STREAM
+                                   device_stream_collection_holder,
+#endif
+                                   run_logger);
+#ifdef ORT_ENABLE_STREAM
+      DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
+      if (device_stream_collection) {
+        ORT_CHECK_AND_SET_RETVAL(device_stream_collection->CleanUp(sync_execution_provider));
+      }
+#endif
+      if (retval.IsOK()) {
+        std::move(request_fetches.begin(), request_fetches.end(), request_fetches_begin);
+      }
+    }
+
+    for (auto* xp : exec_providers_to_stop) {
+      auto status = xp->OnRunEnd(sync_execution_provider, run_options);
+      ORT_CHECK_AND_SET_RETVAL(status);
+    }
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      retval = Status(common::ONNXRUNTIME, common::FAIL, e.what());
+    });
+  }
+  ORT_CATCH(...) {
+    retval = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in RunBatch()");
+  }
+
+  if (!arenas_to_compact_.empty()) {
+    CompactMemoryArenas();
+  }
+
+  telemetry_.total_runs_since_last_ += batch_size;
+  telemetry_.total_run_duration_since_last_ += TimeDiffMicroSeconds(tp);
+  env.GetTelemetryProvider().LogEvaluationStop();
+
+  if (session_profiler_.IsEnabled()) {
+    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "model_run_batch", tp,
+                                            {{"batch_size", std::to_string(batch_size)}});
+  }
+  return retval;
+}
+
+Status InferenceSession::RunBatch(const RunOptions& run_options,
+                                  gsl::span<const char* const> feed_names,
+                                  gsl::span<const OrtValue* const> feeds,
+                                  gsl::span<const char* const> fetch_names,
+                                  size_t batch_size,
+                                  gsl::span<OrtValue*> fetches) {
+  const size_t num_feeds = feed_names.size();
+  const size_t num_fetches = fetch_names.size();
+  if (feeds.size() != batch_size * num_feeds || fetches.size() != batch_size * num_fetches) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Expected ", batch_size * num_feeds, " feeds and ",
+                           batch_size * num_fetches, " fetches for ", batch_size, " requests");
+  }
+
+  InlinedVector<std::string> feed_name_vec;
+  feed_name_vec.reserve(num_feeds);
+  for (size_t i = 0; i != num_feeds; ++i) {
+    if (feed_names[i] == nullptr || feed_names[i][0] == '\0') {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_name_vec.emplace_back(feed_names[i]);
+  }
+
+  std::vector<OrtValue> feed_vec;
+  feed_vec.reserve(feeds.size());
+  for (size_t i = 0; i != feeds.size(); ++i) {
+    if (!feeds[i]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NULL input supplied for input ",
+                             feed_names[i % num_feeds], " of request ", i / num_feeds);
+    }
+    feed_vec.emplace_back(*feeds[i]);
+  }
+
+  InlinedVector<std::string> fetch_name_vec;
+  fetch_name_vec.reserve(num_fetches);
+  for (size_t i = 0; i != num_fetches; ++i) {
+    if (fetch_names[i] == nullptr || fetch_names[i][0] == '\0') {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    fetch_name_vec.emplace_back(fetch_names[i]);
+  }
+
+  std::vector<OrtValue> fetch_vec;
+  fetch_vec.reserve(fetches.size());
+  for (size_t i = 0; i != fetches.size(); ++i) {
+    if (fetches[i] != nullptr) {
+      fetch_vec.emplace_back(*fetches[i]);
+    } else {
+      fetch_vec.emplace_back();
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(RunBatch(run_options, feed_name_vec, feed_vec, fetch_name_vec, batch_size, fetch_vec));
+
+  // We do it in two loops to make sure copy __ctors does not throw
+  std::vector<std::unique_ptr<OrtValue>> fetch_unique_ptrs;
+  fetch_unique_ptrs.reserve(fetches.size());
+  for (size_t i = 0; i != fetches.size(); ++i) {
+    if (fetches[i] == nullptr) {
+      fetch_unique_ptrs.emplace_back(std::make_unique<OrtValue>(fetch_vec[i]));
+    } else {
+      fetch_unique_ptrs.emplace_back();
+    }
+  }
+
+  for (size_t i = 0; i != fetches.size(); ++i) {
+    if (fetches[i] == nullptr) {
+      fetches[i] = fetch_unique_ptrs[i].release();
+    }
+  }
+  return Status::OK();
+}
+
 common::Status InferenceSession::RunAsync(const RunOptions* run_options,
                                           gsl::span<const char* const> feed_names,
                                           gsl::span<const OrtValue* const> feeds,
@@ -2717,6 +3845,43 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
   return Status::OK();
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions& run_options,
+                                          gsl::span<const std::string> feed_names,
+                                          gsl::span<const OrtValue> feeds,
+                                          gsl::span<const std::string> output_names,
+                                          RunCompletionQueue& completion_queue,
+                                          void* user_data) {
+  auto* tp = GetIntraOpThreadPoolToUse();
+  if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "intra op thread pool must have at least one thread for RunAsync");
+  }
+  std::function<void()> run_fn = [this, run_options,
+                                  feed_names = std::vector<std::string>(feed_names.begin(), feed_names.end()),
+                                  feeds = std::vector<OrtValue>(feeds.begin(), feeds.end()),
+                                  output_names = std::vector<std::string>(output_names.begin(), output_names.end()),
+                                  &completion_queue, user_data]() {
+    RunCompletionQueue::Completion completion;
+    completion.user_data = user_data;
+    ORT_TRY {
+      completion.status = Run(run_options, feed_names, feeds, output_names, &completion.fetches);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        completion.status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+    ORT_CATCH(...) {
+      completion.status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "unknown exception");
+    }
+    if (!completion.status.IsOK()) {
+      completion.fetches.clear();
+    }
+    completion_queue.Push(std::move(completion));
+  };  // run_fn
+  concurrency::ThreadPool::Schedule(tp, std::move(run_fn));
+  return Status::OK();
+}
+
 common::Status InferenceSession::Run(const NameMLValMap& feeds, gsl::span<const std::string> output_names,
                                      std::vector<OrtValue>* p_fetches) {
   return Run(RunOptions(), feeds, output_names, p_fetches);
@@ -2805,8 +3970,19 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
-  return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
-             &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo());
+  if (stateful_io_pairs_.empty()) {
+    const auto fetch_allocators = io_binding.PrepareGrowableOutputs();
+    return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
+               &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo(), &fetch_allocators);
+  }
+
+  // Feed the state produced by the previous Run() on this binding back to the graph.
+  ORT_RETURN_IF_ERROR(io_binding.CarryOverState(stateful_io_pairs_));
+  const auto fetch_allocators = io_binding.PrepareGrowableOutputs();
+  auto status = Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
+                    &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo(), &fetch_allocators);
+  io_binding.state_produced_ = status.IsOK();
+  return status;
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -2838,6 +4014,7 @@ void InferenceSession::StartProfiling(const logging::Logger* logger_ptr) {
 std::string InferenceSession::EndProfiling() {
   if (is_model_loaded_) {
     if (session_profiler_.IsEnabled()) {
+      RecordNodeOverheadStats();
       return session_profiler_.EndProfiling();
     } else {
       LOGS(*session_logger_, VERBOSE) << "Profiler is disabled.";
@@ -2848,6 +4025,47 @@ std::string InferenceSession::EndProfiling() {
   return std::string();
 }
 
+Status InferenceSession::GetSampledProfile(std::string& json) const {
+  ORT_RETURN_IF(session_state_ == nullptr, "The session is not initialized.");
+  const auto* sampled_profiler = session_state_->GetSampledProfiler();
+  ORT_RETURN_IF(sampled_profiler == nullptr, "Sampled profiling is not enabled, set the ",
+                kOrtSessionOptionsConfigProfilingSampleRate, " session option.");
+  json = sampled_profiler->ToJson();
+  return Status::OK();
+}
+
+Status InferenceSession::GetTensorStatistics(std::string& json) const {
+  ORT_RETURN_IF(session_state_ == nullptr, "The session is not initialized.");
+  const auto* tensor_statistics = session_state_->GetTensorStatistics();
+  ORT_RETURN_IF(tensor_statistics == nullptr, "Tensor statistics are not collected, set the ",
+                kOrtSessionOptionsConfigCollectTensorStatistics, " session option.");
+  json = tensor_statistics->ToJson();
+  return Status::OK();
+}
+
+void InferenceSession::RecordNodeOverheadStats() {
+  const auto* overhead_stats = session_state_ != nullptr ? session_state_->GetNodeOverheadStats() : nullptr;
+  if (overhead_stats == nullptr) {
+    return;
+  }
+
+  for (const auto& [op_type, summary] : overhead_stats->GetSummaries()) {
+    auto to_us = [](std::chrono::nanoseconds duration) {
+      return std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    };
+    // The durations are aggregated over all runs, so they are only recorded in the event args.
+    session_profiler_.EndTimeAndRecordEvent(
+        profiling::NODE_EVENT, op_type + "_node_overhead", session_profiler_.Start(),
+        {{"op_name", op_type},
+         {"count", std::to_string(summary.count)},
+         {"prepare_us", to_us(summary.durations[NodeOverheadStats::kPrepare])},
+         {"allocate_us", to_us(summary.durations[NodeOverheadStats::kAllocate])},
+         {"compute_us", to_us(summary.durations[NodeOverheadStats::kCompute])},
+         {"release_us", to_us(summary.durations[NodeOverheadStats::kRelease])},
+         {"stream_sync_us", to_us(summary.durations[NodeOverheadStats::kStreamSync])}});
+  }
+}
+
 const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
@@ -2978,6 +4196,20 @@ void InferenceSession::ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_t
   }
 }
 
+void InferenceSession::CompactMemoryArenas() {
+  for (auto& alloc : arenas_to_compact_) {
+    bool compacted = false;
+    auto status = static_cast<BFCArena*>(alloc.get())->Compact(arena_compaction_free_ratio_, compacted);
+
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Unable to compact arena: " << alloc->Info().ToString()
+                                      << " error message: " << status.ErrorMessage();
+    } else if (compacted) {
+      LOGS(*session_logger_, VERBOSE) << "Compacted arena: " << alloc->Info().ToString();
+    }
+  }
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
@@ -3070,6 +4302,14 @@ const logging::Logger& InferenceSession::CreateLoggerForRun(const RunOptions& ru
       severity = static_cast<logging::Severity>(run_options.run_log_severity_level);
     }
 
+    // Without a run tag, a run logger with the severity and verbosity of the session logger is the session logger.
+    // Use it directly so that the run does not create a logger.
+    if (run_options.run_tag.empty() && severity == session_logger_->GetSeverity() &&
+        (severity > logging::Severity::kVERBOSE ||
+         run_options.run_log_verbosity_level == session_options_.session_log_verbosity_level)) {
+      return *session_logger_;
+    }
+
     new_run_logger = logging_manager_->CreateLogger(run_log_id, severity, false, run_options.run_log_verbosity_level);
 
     run_logger = new_run_logger.get();
@@ -27,6 +27,7 @@
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
@@ -41,11 +42,17 @@ class ModelProto;
 }  // namespace ONNX_NAMESPACE
 
 namespace onnxruntime {  // forward declarations
+class CapturedGraph;
 class CustomRegistry;
+class DynamicBatcher;
 class Environment;
 class GraphTransformer;
 class IExecutionProvider;
+class MicroBatchPipeline;
 class IOBinding;
+class PreparedRun;
+class RunCompletionQueue;
+class ShapeSpecializer;
 struct Notification;
 
 #ifdef ENABLE_TRAINING
@@ -323,10 +330,17 @@ class InferenceSession {
    */
   [[nodiscard]] common::Status Initialize();
 
+  /**
+   * @param p_fetches_device_info Optional device of each fetch that is not pre-allocated.
+   * @param p_fetch_allocators Optional allocators of the fetches that are not pre-allocated, keyed by index in
+   * p_fetches. They are tried first when a fetch is produced, see IExecutor::CustomAllocator.
+   */
   [[nodiscard]] common::Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
                                    gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
                                    std::vector<OrtValue>* p_fetches,
-                                   const std::vector<OrtDevice>* p_fetches_device_info = nullptr);
+                                   const std::vector<OrtDevice>* p_fetches_device_info = nullptr,
+                                   const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators =
+                                       nullptr);
 
   [[nodiscard]] common::Status Run(const RunOptions& run_options,
                                    gsl::span<const char* const> feed_names,
@@ -334,6 +348,27 @@ class InferenceSession {
                                    gsl::span<const char* const> fetch_names,
                                    gsl::span<OrtValue*> fetches);
 
+  /**
+   * Runs a batch of requests with the same feed and output names back to back, with the per call setup of Run()
+   * done once for the batch: the names are resolved, the run logger is created and the execution providers are
+   * notified once. It amortizes the overhead of Run() for many inferences of a small model.
+   * @param feeds The feed_names.size() values of each request, one request after the other.
+   * @param batch_size The number of requests.
+   * @param fetches The output_names.size() values of each request in the same layout, pre-allocated as in Run(), or
+   * empty to allocate all of them.
+   * @return The status of the first request that failed, the following requests are not run.
+   */
+  [[nodiscard]] common::Status RunBatch(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                        gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                        size_t batch_size, std::vector<OrtValue>& fetches);
+
+  [[nodiscard]] common::Status RunBatch(const RunOptions& run_options,
+                                        gsl::span<const char* const> feed_names,
+                                        gsl::span<const OrtValue* const> feeds,
+                                        gsl::span<const char* const> fetch_names,
+                                        size_t batch_size,
+                                        gsl::span<OrtValue*> fetches);
+
   [[nodiscard]] common::Status RunAsync(const RunOptions* run_options,
                                         gsl::span<const char* const> feed_names,
                                         gsl::span<const OrtValue* const> feeds,
@@ -342,6 +377,20 @@ class InferenceSession {
                                         RunAsyncCallbackFn callback,
                                         void* user_data = nullptr);
 
+  /**
+   * Run the model asynchronously on the intra-op thread pool, and push the result to completion_queue.
+   * The feeds and names are copied, so they don't need to be kept alive by the caller.
+   * @param completion_queue Queue receiving the completion with user_data, the status and the fetches.
+   *        It must outlive the run.
+   * @return Error if the run could not be started, in which case nothing is pushed to completion_queue.
+   */
+  [[nodiscard]] common::Status RunAsync(const RunOptions& run_options,
+                                        gsl::span<const std::string> feed_names,
+                                        gsl::span<const OrtValue> feeds,
+                                        gsl::span<const std::string> output_names,
+                                        RunCompletionQueue& completion_queue,
+                                        void* user_data = nullptr);
+
   /**
    * Run a pre-loaded and pre-intialized model.
    * Multiple threads are allowed to run this function; hence its thread-safe.
@@ -374,6 +423,23 @@ class InferenceSession {
   [[nodiscard]] virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   [[nodiscard]] common::Status Run(IOBinding& io_binding);
 
+  /**
+   * Resolves the given input and output names for runs with Run(const RunOptions&, PreparedRun&, ...), which skip
+   * the name lookups of Run(). See PreparedRun class for more info.
+   */
+  [[nodiscard]] common::Status NewPreparedRun(gsl::span<const std::string> feed_names,
+                                              gsl::span<const std::string> output_names,
+                                              std::unique_ptr<PreparedRun>& prepared_run) const;
+
+  /**
+   * Runs with the names resolved by NewPreparedRun().
+   * @param feeds The values of the feed names of prepared_run, in the same order.
+   * @param fetches The values of the output names of prepared_run, pre-allocated as in Run(), or empty to allocate
+   * all of them.
+   */
+  [[nodiscard]] common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                   gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches);
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -480,6 +546,20 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+   * Get the aggregate of the runs sampled with the session.profiling_sample_rate session option.
+   * @param json is set to the aggregate per op type and per node in JSON format.
+   * @return an error if sampled profiling is not enabled or the session is not initialized.
+   */
+  Status GetSampledProfile(std::string& json) const;
+
+  /**
+   * Get the statistics of the tensors collected with the session.collect_tensor_statistics session option.
+   * @param json is set to the minimum, maximum and histogram of each tensor in JSON format.
+   * @return an error if the collection is not enabled or the session is not initialized.
+   */
+  Status GetTensorStatistics(std::string& json) const;
+
 #if !defined(ORT_MINIMAL_BUILD)
   /**
    * Get the TuningResults of TunableOp for every execution providers.
@@ -530,6 +610,20 @@ class InferenceSession {
    */
   Status AddPrePackedWeightsContainer(PrepackedWeightsContainer* prepacked_weights_container);
 
+  /**
+   * Share the initializers of an initialized session with this session, e.g. a session of the previous version of
+   * the model, so that only the initializers that changed are loaded by this session.
+   * The CPU initializers of the main graph of source_session with the same name, type, shape and data as an
+   * initializer of the main graph of the model of this session are used by this session instead of its own, as if
+   * they were added with SessionOptions::AddInitializer. This session keeps a reference to them, so source_session
+   * can be released before this session. If source_session uses a PrepackedWeightsContainer provided by the user,
+   * it is used by this session too, so that the pre-packed weights of the shared initializers are shared as well.
+   * Must be called after Load() and before Initialize().
+   * @param source_session the initialized session to share the initializers of.
+   * @param num_shared_initializers the number of initializers shared.
+   */
+  Status ShareInitializersFromSession(const InferenceSession& source_session, size_t& num_shared_initializers);
+
  protected:
 #if !defined(ORT_MINIMAL_BUILD)
 
@@ -572,6 +666,9 @@ class InferenceSession {
   }
 
   onnxruntime::concurrency::ThreadPool* GetInterOpThreadPoolToUse() const {
+    if (use_unified_thread_pool_) {
+      return GetIntraOpThreadPoolToUse();
+    }
     if (session_options_.use_per_session_threads) {
       if (external_inter_op_thread_pool_) {
         return external_inter_op_thread_pool_;
@@ -608,6 +705,41 @@ class InferenceSession {
 
   [[nodiscard]] common::Status SaveModelMetadata(const onnxruntime::Model& model);
 
+  // Run without dynamic batching.
+  [[nodiscard]] common::Status RunImpl(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                       gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                       std::vector<OrtValue>* p_fetches,
+                                       const std::vector<OrtDevice>* p_fetches_device_info,
+                                       const std::unordered_map<size_t, IExecutor::CustomAllocator>* p_fetch_allocators =
+                                           nullptr,
+                                       PreparedRun* prepared_run = nullptr);
+
+  // Validates the feeds of a run against the types and shapes resolved by NewPreparedRun().
+  [[nodiscard]] common::Status ValidatePreparedFeeds(const PreparedRun& prepared_run,
+                                                     gsl::span<const OrtValue> feeds) const;
+
+  // Add the summaries of the node overhead stats, if enabled, to the profiler as events.
+  void RecordNodeOverheadStats();
+
+  // Whether kOrtSessionOptionsConfigShapeSpecializationMaxVariants applies to this session: it is set, the model is
+  // an ONNX model without custom schemas, and the CPU execution provider is the only one.
+  bool CanSpecializeShapes() const;
+
+  // Create a session for the original model with the free dimensions overridden, for the ShapeSpecializer.
+  [[nodiscard]] common::Status CreateShapeSpecializedSession(const std::vector<FreeDimensionOverride>& overrides,
+                                                             std::unique_ptr<InferenceSession>& session) const;
+
+  // The graph annotation id of a run with these inputs and outputs, for
+  // kOrtSessionOptionsConfigGraphCaptureAutoAnnotation.
+  int GetGraphAnnotationId(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                           gsl::span<const std::string> output_names, const std::vector<OrtValue>* p_fetches);
+
+  // Replay the captured CPU graph if the run matches it, capturing it on the first run.
+  // replayed is false if the run must execute the graph as usual.
+  [[nodiscard]] common::Status ReplayCapturedCpuGraph(const RunOptions& run_options, const FeedsFetchesInfo& info,
+                                                      gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                                      const logging::Logger& run_logger, bool& replayed);
+
 #if !defined(ORT_MINIMAL_BUILD)
 
   [[nodiscard]] common::Status LoadOnnxModel(const PathString& model_uri);
@@ -617,6 +749,18 @@ class InferenceSession {
   }
 
   common::Status SaveToOrtFormat(const PathString& filepath) const;
+
+  // Hash the bytes of the ONNX model if its optimized form is cached in "session.optimized_model_cache_dir".
+  void HashModelForOptimizedModelCache(gsl::span<const uint8_t> model_bytes);
+
+  // If the optimized form of the loaded ONNX model is cached, replace the model with it. Otherwise set cache_path
+  // to the file the optimized model should be saved to, or leave it empty if the session does not use the cache.
+  // Must be called with session_mutex_ held, before the graph is transformed.
+  void LoadOptimizedModelFromCache(PathString& cache_path);
+
+  // Save the optimized model to the cache. Must be called after the graph is transformed and before the
+  // initializers are removed from it.
+  void SaveOptimizedModelToCache(const PathString& cache_path) const;
 #endif
 
   /**
@@ -638,6 +782,9 @@ class InferenceSession {
 
   [[nodiscard]] common::Status LoadOrtModelWithLoader(std::function<Status()> load_ort_format_model_bytes);
 
+  // Create the model from the ORT format model in ort_format_model_bytes_. Must be called with session_mutex_ held.
+  [[nodiscard]] common::Status LoadOrtModelFromBytes();
+
   // Create a Logger for a single execution if possible. Otherwise use the default logger.
   // If a new logger is created, it will also be stored in new_run_logger,
   // which must remain valid for the duration of the execution.
@@ -684,6 +831,10 @@ class InferenceSession {
    */
   void ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_to_shrink);
 
+  // Shrinks the arenas in arenas_to_compact_ that hold enough free bytes, see
+  // kOrtSessionOptionsConfigArenaCompactionFreeRatio.
+  void CompactMemoryArenas();
+
 #ifdef _WIN32
   void LogAllSessions();
 #endif
@@ -727,6 +878,11 @@ class InferenceSession {
 
   // Immutable state for each op in the model. Shared by all executors.
   // It has a dependency on execution_providers_.
+  // Container for the pre-packed weights of this session if they are shared through the file set with
+  // "session.prepacked_weights_file" and the user did not provide a container.
+  // It needs to outlive session_state_, whose kernels use the pre-packed weights it contains.
+  std::unique_ptr<PrepackedWeightsContainer> owned_prepacked_weights_container_;
+
   std::unique_ptr<SessionState> session_state_;
 
   // Threadpools per session. These are initialized and used for the entire duration of the session
@@ -740,6 +896,50 @@ class InferenceSession {
   // Spinning is restarted on the next Run()
   bool force_spinning_stop_between_runs_ = false;
 
+  // Set from kOrtSessionOptionsConfigUseUnifiedThreadPool for ORT_PARALLEL execution.
+  // If true, the parallel executor schedules nodes on the intra-op thread pool and no inter-op thread pool is created.
+  bool use_unified_thread_pool_ = false;
+
+  // Set from kOrtSessionOptionsConfigIntraOpMaxDegreeOfParallelism. 0 means no limit.
+  int max_degree_of_parallelism_ = 0;
+
+  // Coalesces concurrent Run calls if kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize is set.
+  std::unique_ptr<DynamicBatcher> dynamic_batcher_;
+
+  // Splits large batches in micro-batches run concurrently if kOrtSessionOptionsConfigPipelineMicroBatchSize is set.
+  std::unique_ptr<MicroBatchPipeline> micro_batch_pipeline_;
+
+  // Runs calls on sessions specialized for the observed values of the free dimensions of the inputs if
+  // kOrtSessionOptionsConfigShapeSpecializationMaxVariants is set.
+  std::unique_ptr<ShapeSpecializer> shape_specializer_;
+  // The serialized original model to create the specialized sessions from, when it was not loaded from a file.
+  std::string shape_specialization_model_data_;
+
+  // Set from kOrtSessionOptionsConfigEnableCpuGraphCapture.
+  bool enable_cpu_graph_capture_ = false;
+  // The graph captured by the first run on CPU tensors, if enable_cpu_graph_capture_ is set.
+  // Set to false if a replay failed, so that the following runs do not attempt to capture the graph again.
+  bool cpu_graph_capture_allowed_ = true;
+  std::unique_ptr<CapturedGraph> captured_cpu_graph_;
+  OrtMutex captured_cpu_graph_mutex_;
+
+  // Set from kOrtSessionOptionsConfigGraphCaptureAutoAnnotation if graph capture is enabled in the execution provider.
+  bool graph_capture_auto_annotation_ = false;
+  // Set from kOrtSessionOptionsConfigGraphCaptureMaxGraphs.
+  size_t graph_capture_max_graphs_ = 8;
+  // The graph annotation ids assigned to the run signatures.
+  InlinedHashMap<std::string, int> graph_annotation_ids_;
+  OrtMutex graph_annotation_ids_mutex_;
+
+  // (output name, input name) pairs set from kOrtSessionOptionsConfigStatefulIOPairs, whose state is carried over
+  // between Run() calls with an IOBinding.
+  std::vector<std::pair<std::string, std::string>> stateful_io_pairs_;
+
+  // Set from kOrtSessionOptionsConfigArenaCompactionFreeRatio. 0 disables the compaction.
+  double arena_compaction_free_ratio_ = 0.0;
+  // The arena based allocators of the session, if the compaction is enabled.
+  InlinedVector<AllocatorPtr> arenas_to_compact_;
+
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
@@ -842,13 +1042,29 @@ class InferenceSession {
   // "session.use_ort_model_bytes_directly" to "1", this will be empty
   std::vector<uint8_t> ort_format_model_bytes_data_holder_;
 
+  // This holds the memory mapped model file if the session is started with a model_uri and the session config
+  // option "session.use_mmap_for_ort_model_file" is set to "1". ort_format_model_bytes_ then points to this mapping,
+  // and ort_format_model_bytes_data_holder_ is empty.
+  Env::MappedMemoryPtr ort_format_model_mapped_bytes_;
+
   bool using_ort_model_bytes_for_initializers_{false};
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // Hash of the bytes of the loaded ONNX model if "session.optimized_model_cache_dir" is set. Empty otherwise.
+  std::string optimized_model_cache_model_hash_;
+#endif
+
   // Container to store pre-packed weights to share between sessions.
   // The life-cycle of the cache itself is maintained by the user and the user will ensure
   // the cache is valid until any session reliant on it is still in scope.
   PrepackedWeightsContainer* prepacked_weights_container_ = nullptr;
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // Initializers shared from another session by ShareInitializersFromSession, referenced by
+  // session_options_.initializers_to_share_map.
+  NodeHashMap<std::string, OrtValue> initializers_shared_from_session_;
+#endif
+
   // Cache the EP instance if the user has configured the EP to capture a graph
   // for the model and all the necessary criteria for graph capture has been met.
   // At Run() time, if this member is not nullptr and the captured graph is ready
@@ -5,6 +5,12 @@
 
 #include "core/session/inference_session_utils.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#include "core/platform/env.h"
+
 namespace onnxruntime {
 
 //---------------------
@@ -110,6 +116,11 @@ void from_json(const json& j, TuningResults& trs) {
   j.at("validators").get_to(trs.validators);
 }
 
+// This function is called by nlohmann/json
+void to_json(json& j, const TuningResults& trs) {
+  j = json{{"ep", trs.ep}, {"results", trs.results}, {"validators", trs.validators}};
+}
+
 //---------------------------------------------------
 //--- end of session options related helpers ---
 //---------------------------------------------------
@@ -264,6 +275,94 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
   return Status::OK();
 }
 
+Status ParseTuningResultsFromFile(const PathString& file_path,
+                                  std::vector<TuningResults>& results,
+                                  bool& file_found) {
+  results.clear();
+  file_found = false;
+  std::ifstream stream(file_path);
+  if (!stream) {
+    return Status::OK();
+  }
+
+  file_found = true;
+  Status status;
+  ORT_TRY {
+    results = json::parse(stream).get<std::vector<TuningResults>>();
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Tuning results file ", ToUTF8String(file_path),
+                               " cannot be parsed. Error message: ", e.what());
+    });
+  }
+  return status;
+}
+
+Status SaveTuningResultsToFile(const PathString& file_path, const std::vector<TuningResults>& results) {
+  std::vector<TuningResults> merged;
+  bool file_found = false;
+  ORT_RETURN_IF_ERROR(ParseTuningResultsFromFile(file_path, merged, file_found));
+
+  bool modified = false;
+  for (const auto& trs : results) {
+    if (trs.results.empty()) {
+      continue;
+    }
+
+    auto it = std::find_if(merged.begin(), merged.end(), [&trs](const TuningResults& entry) {
+      return entry.ep == trs.ep && entry.validators == trs.validators;
+    });
+    if (it == merged.end()) {
+      merged.push_back(trs);
+      modified = true;
+      continue;
+    }
+
+    for (const auto& [op_signature, kernel_map] : trs.results) {
+      auto& merged_kernel_map = it->results[op_signature];
+      for (const auto& [params_signature, kernel_id] : kernel_map) {
+        auto [kernel_it, inserted] = merged_kernel_map.try_emplace(params_signature, kernel_id);
+        if (inserted || kernel_it->second != kernel_id) {
+          kernel_it->second = kernel_id;
+          modified = true;
+        }
+      }
+    }
+  }
+
+  if (!modified) {
+    return Status::OK();
+  }
+
+  // write to a temporary file that replaces the file at once, so that concurrent readers never see a partial file
+  const PathString temp_file_path = file_path + ORT_TSTR(".") +
+                                    ToPathString(std::to_string(Env::Default().GetSelfPid())) + ORT_TSTR(".tmp");
+  {
+    std::ofstream stream(temp_file_path, std::ios::trunc);
+    ORT_RETURN_IF(!stream, "Failed to open ", ToUTF8String(temp_file_path), " for writing.");
+    stream << json(merged).dump();
+    ORT_RETURN_IF(!stream.flush(), "Failed to write tuning results to ", ToUTF8String(temp_file_path), ".");
+  }
+
+#ifdef _WIN32
+  const int rename_result = _wrename(temp_file_path.c_str(), file_path.c_str());
+#else
+  const int rename_result = std::rename(temp_file_path.c_str(), file_path.c_str());
+#endif
+  if (rename_result != 0) {
+#ifdef _WIN32
+    _wremove(temp_file_path.c_str());
+#else
+    std::remove(temp_file_path.c_str());
+#endif
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to rename ", ToUTF8String(temp_file_path), " to ",
+                           ToUTF8String(file_path), ".");
+  }
+
+  return Status::OK();
+}
+
 }  // namespace inference_session_utils
 }  // namespace onnxruntime
 
@@ -62,6 +62,16 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
                                            /*out*/ std::vector<TuningResults>& results,
                                            /*out*/ bool& key_found);
 
+// Reads the tuning results of a file written by SaveTuningResultsToFile. file_found is false if the file does not
+// exist, in which case results is empty.
+Status ParseTuningResultsFromFile(const PathString& file_path,
+                                  /*out*/ std::vector<TuningResults>& results,
+                                  /*out*/ bool& file_found);
+
+// Merges results into the tuning results of a file, creating it if needed. The results of an entry of the file with
+// the same execution provider and validators are replaced op by op, the other entries of the file are kept.
+Status SaveTuningResultsToFile(const PathString& file_path, const std::vector<TuningResults>& results);
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 }  // namespace inference_session_utils
@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/micro_batch_pipeline.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "core/common/logging/logging.h"
+#include "core/framework/tensor.h"
+#include "core/platform/ort_mutex.h"
+#include "core/platform/threadpool.h"
+#include "core/session/dynamic_batcher.h"
+
+namespace onnxruntime {
+
+using batching::CopyRows;
+using batching::IsCpuTensor;
+using batching::WithBatchSize;
+
+MicroBatchPipeline::MicroBatchPipeline(int64_t micro_batch_size, int max_in_flight,
+                                       concurrency::ThreadPool* thread_pool, AllocatorPtr allocator, RunFn run_fn)
+    : micro_batch_size_(micro_batch_size),
+      max_in_flight_(max_in_flight),
+      thread_pool_(thread_pool),
+      allocator_(std::move(allocator)),
+      run_fn_(std::move(run_fn)) {
+  ORT_ENFORCE(micro_batch_size_ > 0, "Micro-batch size of pipelining must be greater than 0");
+  ORT_ENFORCE(max_in_flight_ > 0, "Number of micro-batches in flight must be greater than 0");
+}
+
+bool MicroBatchPipeline::CanSplit(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                                  const std::vector<OrtValue>& fetches) const {
+  // Run options apply to every micro-batch, so only calls with default behavior are split.
+  if (run_options.terminate || run_options.only_execute_path_to_fetches ||
+      !run_options.config_options.configurations.empty()) {
+    return false;
+  }
+
+  // Preallocated fetches would have to be written by all the micro-batches.
+  if (!fetches.empty() || feeds.empty()) {
+    return false;
+  }
+
+  int64_t batch_size = -1;
+  for (const auto& feed : feeds) {
+    if (!IsCpuTensor(feed)) {
+      return false;
+    }
+    const auto& shape = feed.Get<Tensor>().Shape();
+    if (shape.NumDimensions() == 0 || (batch_size != -1 && shape[0] != batch_size)) {
+      return false;
+    }
+    batch_size = shape[0];
+  }
+  return batch_size > micro_batch_size_;
+}
+
+Status MicroBatchPipeline::Run(const RunOptions& run_options,
+                               gsl::span<const std::string> feed_names,
+                               gsl::span<const OrtValue> feeds,
+                               gsl::span<const std::string> output_names,
+                               std::vector<OrtValue>& fetches) {
+  const int64_t batch_size = feeds[0].Get<Tensor>().Shape()[0];
+  const int64_t num_micro_batches = (batch_size + micro_batch_size_ - 1) / micro_batch_size_;
+  std::vector<std::vector<OrtValue>> micro_batch_fetches(static_cast<size_t>(num_micro_batches));
+  std::vector<Status> statuses(static_cast<size_t>(num_micro_batches));
+
+  // Every worker takes the next micro-batch when it is done with one, so micro-batches enter the first stage in
+  // order and at most max_in_flight of them are in the pipeline.
+  std::atomic<int64_t> next_micro_batch{0};
+  auto run_micro_batches = [&]() {
+    for (int64_t i = next_micro_batch++; i < num_micro_batches; i = next_micro_batch++) {
+      const int64_t begin_row = i * micro_batch_size_;
+      const int64_t num_rows = std::min(micro_batch_size_, batch_size - begin_row);
+      statuses[i] = RunMicroBatch(run_options, feed_names, feeds, output_names, begin_row, num_rows,
+                                  micro_batch_fetches[i]);
+    }
+  };
+
+  const int num_workers = static_cast<int>(std::min<int64_t>(max_in_flight_, num_micro_batches));
+  OrtMutex mutex;
+  OrtCondVar workers_done_cv;
+  int pending_workers = num_workers - 1;
+  for (int worker = 1; worker < num_workers; ++worker) {
+    concurrency::ThreadPool::Schedule(thread_pool_, [&]() {
+      run_micro_batches();
+      std::lock_guard<OrtMutex> lock(mutex);
+      --pending_workers;
+      workers_done_cv.notify_one();
+    });
+  }
+  run_micro_batches();
+  {
+    std::unique_lock<OrtMutex> lock(mutex);
+    while (pending_workers > 0) {
+      workers_done_cv.wait(lock);
+    }
+  }
+
+  Status status = Status::OK();
+  for (const auto& micro_batch_status : statuses) {
+    if (!micro_batch_status.IsOK()) {
+      status = micro_batch_status;
+      break;
+    }
+  }
+  if (status.IsOK()) {
+    status = ConcatFetches(micro_batch_fetches, batch_size, fetches);
+  }
+
+  if (!status.IsOK()) {
+    // Run the call as a whole, so that it gets the same result as without pipelining.
+    LOGS_DEFAULT(VERBOSE) << "Pipelined run of " << num_micro_batches << " micro-batches failed, running the batch "
+                          << "as a whole: " << status.ErrorMessage();
+    fetches.clear();
+    return run_fn_(run_options, feed_names, feeds, output_names, fetches);
+  }
+  return Status::OK();
+}
+
+Status MicroBatchPipeline::RunMicroBatch(const RunOptions& run_options,
+                                         gsl::span<const std::string> feed_names,
+                                         gsl::span<const OrtValue> feeds,
+                                         gsl::span<const std::string> output_names,
+                                         int64_t begin_row, int64_t num_rows,
+                                         std::vector<OrtValue>& fetches) const {
+  std::vector<OrtValue> micro_batch_feeds(feeds.size());
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    const auto& tensor = feeds[i].Get<Tensor>();
+    const size_t row_bytes = static_cast<size_t>(tensor.Shape().SizeFromDimension(1)) * tensor.DataType()->Size();
+    // The feeds are only read by the run.
+    void* data = const_cast<void*>(tensor.DataRaw());
+    Tensor::InitOrtValue(tensor.DataType(), WithBatchSize(tensor.Shape(), num_rows),
+                         static_cast<char*>(data) + static_cast<size_t>(begin_row) * row_bytes, tensor.Location(),
+                         micro_batch_feeds[i]);
+  }
+  return run_fn_(run_options, feed_names, micro_batch_feeds, output_names, fetches);
+}
+
+Status MicroBatchPipeline::ConcatFetches(const std::vector<std::vector<OrtValue>>& micro_batch_fetches,
+                                         int64_t batch_size, std::vector<OrtValue>& fetches) const {
+  const auto& first = micro_batch_fetches.front();
+  for (size_t k = 0; k < micro_batch_fetches.size(); ++k) {
+    const auto& micro_batch = micro_batch_fetches[k];
+    const int64_t num_rows = std::min(micro_batch_size_, batch_size - static_cast<int64_t>(k) * micro_batch_size_);
+    ORT_RETURN_IF_NOT(micro_batch.size() == first.size(), "Micro-batches have different numbers of outputs");
+    for (size_t i = 0; i < micro_batch.size(); ++i) {
+      ORT_RETURN_IF_NOT(IsCpuTensor(micro_batch[i]), "Only CPU tensor outputs can be concatenated");
+      const auto& shape = micro_batch[i].Get<Tensor>().Shape();
+      const auto& first_tensor = first[i].Get<Tensor>();
+      ORT_RETURN_IF_NOT(shape.NumDimensions() > 0 && shape[0] == num_rows &&
+                            micro_batch[i].Get<Tensor>().DataType() == first_tensor.DataType() &&
+                            shape.Slice(1) == first_tensor.Shape().Slice(1),
+                        "Output ", i, " of shape ", shape, " does not have the ", num_rows,
+                        " rows of the micro-batch as the first dimension");
+    }
+  }
+
+  fetches.resize(first.size());
+  for (size_t i = 0; i < first.size(); ++i) {
+    const auto& first_tensor = first[i].Get<Tensor>();
+    Tensor::InitOrtValue(first_tensor.DataType(), WithBatchSize(first_tensor.Shape(), batch_size), allocator_,
+                         fetches[i]);
+    auto& tensor = *fetches[i].GetMutable<Tensor>();
+    int64_t row = 0;
+    for (const auto& micro_batch : micro_batch_fetches) {
+      const auto& micro_batch_tensor = micro_batch[i].Get<Tensor>();
+      CopyRows(micro_batch_tensor, 0, tensor, row, micro_batch_tensor.Shape()[0]);
+      row += micro_batch_tensor.Shape()[0];
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+
+namespace onnxruntime {
+
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+ * Runs a large batch as a pipeline of micro-batches: the feeds are split along the first dimension into micro-batches
+ * of micro_batch_size rows, up to max_in_flight micro-batches are run concurrently, and the fetches are concatenated
+ * back along the first dimension.
+ *
+ * Each micro-batch is a run of its own with its own device streams. When the graph is partitioned across execution
+ * providers, e.g. a CPU stage followed by a CUDA stage, a micro-batch runs on one device while the next micro-batch
+ * runs on another, instead of each device waiting for the whole batch to go through the previous stages.
+ * If a micro-batch fails, or the fetches cannot be concatenated along the first dimension, the call is run as a
+ * whole, so that pipelining never changes the result of a call for models whose rows are independent.
+ * It is the user's responsibility to only enable pipelining for such models.
+ */
+class MicroBatchPipeline {
+ public:
+  using RunFn = std::function<Status(const RunOptions& run_options,
+                                     gsl::span<const std::string> feed_names,
+                                     gsl::span<const OrtValue> feeds,
+                                     gsl::span<const std::string> output_names,
+                                     std::vector<OrtValue>& fetches)>;
+
+  // run_fn runs the session without pipelining. The micro-batches beyond the first one are run on thread_pool, which
+  // may be nullptr to run them one after the other. allocator is used for the concatenated fetches.
+  MicroBatchPipeline(int64_t micro_batch_size, int max_in_flight, concurrency::ThreadPool* thread_pool,
+                     AllocatorPtr allocator, RunFn run_fn);
+
+  // Whether a Run call with these arguments can be split in micro-batches.
+  bool CanSplit(const RunOptions& run_options, gsl::span<const OrtValue> feeds,
+                const std::vector<OrtValue>& fetches) const;
+
+  // Run a call that CanSplit accepted.
+  Status Run(const RunOptions& run_options,
+             gsl::span<const std::string> feed_names,
+             gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names,
+             std::vector<OrtValue>& fetches);
+
+ private:
+  // Run the rows [begin_row, begin_row + num_rows) of the feeds. The micro-batch feeds are views of the feeds.
+  Status RunMicroBatch(const RunOptions& run_options,
+                       gsl::span<const std::string> feed_names,
+                       gsl::span<const OrtValue> feeds,
+                       gsl::span<const std::string> output_names,
+                       int64_t begin_row, int64_t num_rows,
+                       std::vector<OrtValue>& fetches) const;
+  Status ConcatFetches(const std::vector<std::vector<OrtValue>>& micro_batch_fetches, int64_t batch_size,
+                       std::vector<OrtValue>& fetches) const;
+
+  const int64_t micro_batch_size_;
+  const int max_in_flight_;
+  concurrency::ThreadPool* const thread_pool_;
+  AllocatorPtr allocator_;
+  RunFn run_fn_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MicroBatchPipeline);
+};
+
+}  // namespace onnxruntime
@@ -33,6 +33,7 @@
 #include "core/session/inference_session.h"
 #include "core/session/ort_apis.h"
 #include "core/session/ort_env.h"
+#include "core/session/prepared_run.h"
 #include "core/framework/data_types.h"
 #include "abi_session_options_impl.h"
 #include "core/framework/TensorSeq.h"
@@ -845,6 +846,105 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::RunBatch, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    size_t batch_size, _In_reads_(batch_size* input_len) const OrtValue* const* inputs,
+                    _Inout_updates_all_(batch_size* output_names_len) OrtValue** outputs) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  gsl::span<const char* const> input_names_span(input_names, input_len);
+  gsl::span<const OrtValue* const> input_span(inputs, batch_size * input_len);
+  gsl::span<const char* const> output_name_span(output_names, output_names_len);
+  gsl::span<OrtValue*> output_span(outputs, batch_size * output_names_len);
+
+  Status status;
+  if (run_options) {
+    status = session->RunBatch(*run_options, input_names_span, input_span, output_name_span, batch_size,
+                               output_span);
+  } else {
+    const RunOptions default_run_options;
+    status = session->RunBatch(default_run_options, input_names_span, input_span, output_name_span, batch_size,
+                               output_span);
+  }
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+
+  InlinedVector<std::string> input_name_vec;
+  input_name_vec.reserve(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    input_name_vec.emplace_back(input_names[i]);
+  }
+
+  InlinedVector<std::string> output_name_vec;
+  output_name_vec.reserve(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names[i] == nullptr || output_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_name_vec.emplace_back(output_names[i]);
+  }
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->NewPreparedRun(input_name_vec, output_name_vec, prepared_run));
+  *out = reinterpret_cast<OrtPreparedRun*>(prepared_run.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run_ptr, _In_reads_(input_len) const OrtValue* const* inputs,
+                    size_t input_len, _Inout_updates_all_(output_len) OrtValue** outputs, size_t output_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto& prepared_run = *reinterpret_cast<::onnxruntime::PreparedRun*>(prepared_run_ptr);
+
+  InlinedVector<OrtValue> feeds;
+  feeds.reserve(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (inputs[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "NULL input supplied");
+    }
+    feeds.push_back(*inputs[i]);
+  }
+
+  std::vector<OrtValue> fetches;
+  fetches.reserve(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    fetches.push_back(outputs[i] != nullptr ? *outputs[i] : OrtValue());
+  }
+
+  const RunOptions default_run_options;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->Run(run_options ? *run_options : default_run_options, prepared_run,
+                                               feeds, fetches));
+
+  // We do it in two loops to make sure copy __ctors does not throw
+  InlinedVector<std::unique_ptr<OrtValue>> fetch_unique_ptrs;
+  fetch_unique_ptrs.reserve(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    fetch_unique_ptrs.emplace_back(outputs[i] == nullptr ? std::make_unique<OrtValue>(fetches[i]) : nullptr);
+  }
+  for (size_t i = 0; i != output_len; ++i) {
+    if (outputs[i] == nullptr) {
+      outputs[i] = fetch_unique_ptrs[i].release();
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
                     _In_reads_(input_len) const char* const* input_names,
                     _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
@@ -941,6 +1041,17 @@ ORT_API_STATUS_IMPL(OrtApis::BindOutputToDevice, _Inout_ OrtIoBinding* binding_p
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::BindGrowableOutputToDevice, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* mem_info_ptr) {
+  API_IMPL_BEGIN
+  auto st = binding_ptr->binding_->BindGrowableOutput(name, mem_info_ptr->device);
+  if (!st.IsOK()) {
+    return ToOrtStatus(st);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputNames, _In_ const OrtIoBinding* binding_ptr, _In_ OrtAllocator* allocator,
                     _Out_ char** buffer, _Outptr_result_maybenull_ size_t** lengths, _Out_ size_t* count) {
   API_IMPL_BEGIN
@@ -2195,6 +2306,45 @@ ORT_API_STATUS_IMPL(OrtApis::SessionGetProfilingStartTimeNs, _In_ const OrtSessi
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetAllocatorStats, _In_ const OrtSession* sess, _In_ const OrtMemoryInfo* mem_info,
+                    _Out_ int64_t* bytes_in_use, _Out_ int64_t* max_bytes_in_use, _Out_ int64_t* bytes_limit) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  auto allocator = session->GetAllocator(*mem_info);
+  if (!allocator) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "No allocator found for the given memory info.");
+  }
+  onnxruntime::AllocatorStats stats;
+  allocator->GetStats(&stats);
+  *bytes_in_use = stats.bytes_in_use;
+  *max_bytes_in_use = stats.max_bytes_in_use;
+  *bytes_limit = stats.bytes_limit;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetSampledProfile, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string json;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetSampledProfile(json));
+  *out = StrDup(json, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetTensorStatistics, _In_ const OrtSession* sess, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string json;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetTensorStatistics(json));
+  *out = StrDup(json, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
 // End support for non-tensor types
 
 ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfg, _In_ size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
@@ -2229,6 +2379,8 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "max_power_of_two_extend_bytes") == 0) {
       cfg->max_power_of_two_extend_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_max_chunk_size_bytes") == 0) {
+      cfg->thread_cache_max_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2728,8 +2880,17 @@ static constexpr OrtApi ort_api_1_to_18 = {
     &OrtApis::SessionOptionsAppendExecutionProvider_VitisAI,
     &OrtApis::KernelContext_GetScratchBuffer,
     &OrtApis::KernelInfoGetAllocator,
-    &OrtApis::AddExternalInitializersFromFilesInMemory
+    &OrtApis::AddExternalInitializersFromFilesInMemory,
     // End of Version 18 - DO NOT MODIFY ABOVE (see above text for more information)
+
+    &OrtApis::SessionGetAllocatorStats,
+    &OrtApis::SessionGetSampledProfile,
+    &OrtApis::BindGrowableOutputToDevice,
+    &OrtApis::RunBatch,
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::RunPrepared,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::SessionGetTensorStatistics,
 };
 
 // OrtApiBase can never change as there is no way to know what version of OrtApiBase is returned by OrtGetApiBase.
@@ -2802,3 +2963,4 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, OrtValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(ModelMetadata, ::onnxruntime::ModelMetadata)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, ::onnxruntime::PreparedRun)
@@ -523,4 +523,33 @@ ORT_API_STATUS_IMPL(SessionOptionsAppendExecutionProvider_VitisAI, _In_ OrtSessi
 ORT_API_STATUS_IMPL(KernelContext_GetScratchBuffer, _In_ const OrtKernelContext* context, _In_ const OrtMemoryInfo* mem_info, _In_ size_t count_or_bytes, _Outptr_ void** out);
 
 ORT_API_STATUS_IMPL(KernelInfoGetAllocator, _In_ const OrtKernelInfo* info, _In_ OrtMemType mem_type, _Outptr_ OrtAllocator** out);
+
+ORT_API_STATUS_IMPL(SessionGetAllocatorStats, _In_ const OrtSession* session, _In_ const OrtMemoryInfo* mem_info,
+                    _Out_ int64_t* bytes_in_use, _Out_ int64_t* max_bytes_in_use, _Out_ int64_t* bytes_limit);
+
+ORT_API_STATUS_IMPL(SessionGetSampledProfile, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
+
+ORT_API_STATUS_IMPL(BindGrowableOutputToDevice, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name,
+                    _In_ const OrtMemoryInfo* mem_info_ptr);
+
+ORT_API_STATUS_IMPL(RunBatch, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    size_t batch_size, _In_reads_(batch_size* input_len) const OrtValue* const* inputs,
+                    _Inout_updates_all_(batch_size* output_names_len) OrtValue** outputs);
+
+ORT_API_STATUS_IMPL(CreatePreparedRun, _In_ const OrtSession* session,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out);
+
+ORT_API_STATUS_IMPL(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run, _In_reads_(input_len) const OrtValue* const* inputs,
+                    size_t input_len, _Inout_updates_all_(output_len) OrtValue** outputs, size_t output_len);
+
+ORT_API(void, ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun*);
+
+ORT_API_STATUS_IMPL(SessionGetTensorStatistics, _In_ const OrtSession* session, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ char** out);
 }  // namespace OrtApis
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/data_types.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+/**
+ * The input and output names of runs resolved once.
+ * Usage is as follows:
+ *
+ * std::unique_ptr<PreparedRun> prepared_run;
+ * session.NewPreparedRun({"X"}, {"Y"}, prepared_run);
+ * ...
+ * std::vector<OrtValue> fetches;
+ * session.Run(run_options, *prepared_run, feeds, fetches);
+ *
+ * A run with a PreparedRun skips the lookups of the names and the creation of the FeedsFetchesManager of Run(),
+ * the feeds are only checked against the types and shapes resolved here.
+ * It can only be used with the session that created it, and not by concurrent runs as each run updates the device
+ * copy info of its FeedsFetchesManager. Concurrent callers create one per thread.
+ */
+class PreparedRun {
+ public:
+  const InlinedVector<std::string>& GetFeedNames() const {
+    return feeds_fetches_manager_.GetFeedsFetchesInfo().feed_names;
+  }
+
+  const InlinedVector<std::string>& GetOutputNames() const {
+    return feeds_fetches_manager_.GetFeedsFetchesInfo().output_names;
+  }
+
+ private:
+  friend class InferenceSession;
+
+  struct ExpectedFeed {
+    // the element type if the input is a tensor, nullptr for other types which are validated by name
+    MLDataType element_type;
+    std::optional<TensorShape> shape;
+  };
+
+  PreparedRun(const InferenceSession& session, FeedsFetchesInfo&& info, std::vector<ExpectedFeed>&& expected_feeds)
+      : session_(session), feeds_fetches_manager_(std::move(info)), expected_feeds_(std::move(expected_feeds)) {
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+
+  const InferenceSession& session_;
+  FeedsFetchesManager feeds_fetches_manager_;
+  std::vector<ExpectedFeed> expected_feeds_;
+};
+
+}  // namespace onnxruntime
@@ -1570,6 +1570,10 @@ OrtCUDAProviderOptionsV2 OrtCUDAProviderOptionsToOrtCUDAProviderOptionsV2(const
   cuda_options_converted.enable_skip_layer_norm_strict_mode = 0;
   cuda_options_converted.use_ep_level_unified_stream = 0;
   cuda_options_converted.use_tf32 = 1;
+  cuda_options_converted.use_mem_pool = 0;
+  cuda_options_converted.mem_pool_release_threshold = std::numeric_limits<size_t>::max();
+  cuda_options_converted.weight_offload_min_bytes = 0;
+  cuda_options_converted.weight_offload_device_budget = std::numeric_limits<size_t>::max();
 
   return cuda_options_converted;
 }
@@ -1644,6 +1648,9 @@ OrtTensorRTProviderOptionsV2 OrtTensorRTProviderOptionsToOrtTensorRTProviderOpti
   trt_options_converted.trt_ep_context_embed_mode = 0;
   trt_options_converted.trt_engine_cache_prefix = "";
   trt_options_converted.trt_engine_hw_compatible = 0;
+  trt_options_converted.trt_async_engine_build_enable = 0;
+  trt_options_converted.trt_engine_cache_store_lib_path = "";
+  trt_options_converted.trt_profile_observation_runs = 0;
 
   return trt_options_converted;
 }
@@ -2258,6 +2265,7 @@ ORT_API(void, OrtApis::ReleaseTensorRTProviderOptions, _Frees_ptr_opt_ OrtTensor
     delete[] ptr->trt_profile_opt_shapes;
     delete[] ptr->trt_ep_context_file_path;
     delete[] ptr->trt_onnx_model_folder_path;
+    delete[] ptr->trt_engine_cache_store_lib_path;
   }
 
   std::unique_ptr<OrtTensorRTProviderOptionsV2> p(ptr);
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/run_completion_queue.h"
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cstdint>
+#endif
+
+#include "core/common/logging/logging.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+RunCompletionQueue::RunCompletionQueue() {
+#if defined(__linux__)
+  // EFD_SEMAPHORE so that each read consumes one completion.
+  notification_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+  if (notification_fd_ == -1) {
+    auto [err_no, err_msg] = GetErrnoInfo();
+    LOGS_DEFAULT(WARNING) << "Failed to create eventfd for the run completion queue. error code: " << err_no
+                          << " error msg: " << err_msg;
+  }
+#endif
+}
+
+RunCompletionQueue::~RunCompletionQueue() {
+#if defined(__linux__)
+  if (notification_fd_ != -1) {
+    close(notification_fd_);
+  }
+#endif
+}
+
+void RunCompletionQueue::Push(Completion&& completion) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    completions_.push_back(std::move(completion));
+#if defined(__linux__)
+    if (notification_fd_ != -1) {
+      const uint64_t one = 1;
+      ORT_IGNORE_RETURN_VALUE(write(notification_fd_, &one, sizeof(one)));
+    }
+#endif
+  }
+  cv_.notify_one();
+}
+
+void RunCompletionQueue::PopFront(Completion& completion) {
+  completion = std::move(completions_.front());
+  completions_.pop_front();
+#if defined(__linux__)
+  if (notification_fd_ != -1) {
+    uint64_t count = 0;
+    ORT_IGNORE_RETURN_VALUE(read(notification_fd_, &count, sizeof(count)));
+  }
+#endif
+}
+
+bool RunCompletionQueue::TryPop(Completion& completion) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (completions_.empty()) {
+    return false;
+  }
+  PopFront(completion);
+  return true;
+}
+
+bool RunCompletionQueue::Pop(Completion& completion, std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  std::unique_lock<OrtMutex> lock(mutex_);
+  while (completions_.empty()) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      return false;
+    }
+    cv_.wait_for(lock, deadline - now);
+  }
+  PopFront(completion);
+  return true;
+}
+
+size_t RunCompletionQueue::Size() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return completions_.size();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Queue of completed InferenceSession::RunAsync calls, in the order they finished.
+ * A single queue can be shared by many sessions, so that a few threads can handle the completions
+ * of many outstanding runs.
+ *
+ * On Linux, GetNotificationFd() returns an eventfd that is readable while there are completions in the queue,
+ * so that the queue can be waited on via epoll/poll along with other file descriptors, e.g. sockets of a server.
+ * Each completion popped from the queue consumes one count of the eventfd, so it must not be read directly.
+ *
+ * The queue must outlive all runs that deliver completions to it.
+ */
+class RunCompletionQueue {
+ public:
+  struct Completion {
+    // user_data passed to RunAsync.
+    void* user_data = nullptr;
+    // Result of the run. fetches is empty if it is not OK.
+    Status status;
+    std::vector<OrtValue> fetches;
+  };
+
+  RunCompletionQueue();
+  ~RunCompletionQueue();
+
+  void Push(Completion&& completion);
+
+  // Pop a completion if there is one. Returns false if the queue is empty.
+  bool TryPop(Completion& completion);
+
+  // Wait up to timeout for a completion. Returns false if there is none after timeout.
+  bool Pop(Completion& completion, std::chrono::milliseconds timeout);
+
+  // File descriptor readable while the queue is not empty, or -1 if it is not supported on the platform.
+  int GetNotificationFd() const { return notification_fd_; }
+
+  size_t Size() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunCompletionQueue);
+
+  // Remove the front completion. mutex_ must be held.
+  void PopFront(Completion& completion);
+
+  mutable OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::deque<Completion> completions_;
+  int notification_fd_ = -1;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,118 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/shape_specializer.h"
+
+#include <algorithm>
+
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Number of distinct values of the free dimensions tracked before they are seen min_runs times, so that models with
+// e.g. a free sequence length do not grow the map with every new length.
+constexpr size_t kMaxPendingVariants = 64;
+
+}  // namespace
+
+ShapeSpecializer::ShapeSpecializer(std::vector<FreeDim> free_dims, size_t min_runs, size_t max_variants,
+                                   CreateSessionFn create_session_fn, const logging::Logger& logger)
+    : free_dims_(std::move(free_dims)),
+      min_runs_(min_runs),
+      max_variants_(max_variants),
+      create_session_fn_(std::move(create_session_fn)),
+      logger_(logger) {
+  ORT_ENFORCE(!free_dims_.empty(), "Shape specialization requires inputs with free dimensions");
+  ORT_ENFORCE(max_variants_ > 0, "Shape specialization requires at least one variant");
+}
+
+ShapeSpecializer::~ShapeSpecializer() = default;
+
+bool ShapeSpecializer::GetDimValues(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                    InlinedVector<int64_t>& values) const {
+  values.clear();
+  for (size_t i = 0; i < free_dims_.size(); ++i) {
+    const FreeDim& free_dim = free_dims_[i];
+    auto it = std::find(feed_names.begin(), feed_names.end(), free_dim.input_name);
+    if (it == feed_names.end()) {
+      return false;
+    }
+    const OrtValue& feed = feeds[static_cast<size_t>(it - feed_names.begin())];
+    if (!feed.IsTensor() || feed.Get<Tensor>().Shape().NumDimensions() <= free_dim.axis) {
+      return false;
+    }
+    const int64_t value = feed.Get<Tensor>().Shape()[free_dim.axis];
+    for (size_t j = 0; j < i; ++j) {
+      if (free_dims_[j].dim_param == free_dim.dim_param && values[j] != value) {
+        return false;
+      }
+    }
+    values.push_back(value);
+  }
+  return true;
+}
+
+InferenceSession* ShapeSpecializer::GetSession(gsl::span<const std::string> feed_names,
+                                               gsl::span<const OrtValue> feeds) {
+  InlinedVector<int64_t> values;
+  if (!GetDimValues(feed_names, feeds, values)) {
+    return nullptr;
+  }
+
+  std::string key;
+  for (int64_t value : values) {
+    key += std::to_string(value);
+    key += ',';
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = variants_.find(key);
+    if (it == variants_.end()) {
+      if (num_created_ >= max_variants_ || variants_.size() >= num_created_ + kMaxPendingVariants) {
+        return nullptr;
+      }
+      it = variants_.emplace(key, Variant{}).first;
+    }
+
+    Variant& variant = it->second;
+    if (variant.created) {
+      return variant.session.get();
+    }
+    if (++variant.num_runs != min_runs_ || num_created_ >= max_variants_) {
+      return nullptr;
+    }
+    // this call creates the session, the calls seen meanwhile run on the original session
+    ++num_created_;
+  }
+
+  std::vector<FreeDimensionOverride> overrides;
+  for (size_t i = 0; i < free_dims_.size(); ++i) {
+    const std::string& dim_param = free_dims_[i].dim_param;
+    if (std::none_of(overrides.begin(), overrides.end(),
+                     [&dim_param](const FreeDimensionOverride& o) { return o.dim_identifier == dim_param; })) {
+      overrides.push_back(FreeDimensionOverride{dim_param, FreeDimensionOverrideType::Name, values[i]});
+    }
+  }
+
+  std::unique_ptr<InferenceSession> session;
+  const Status status = create_session_fn_(overrides, session);
+  if (status.IsOK()) {
+    LOGS(logger_, INFO) << "Created a session specialized for the free dimension values " << key;
+  } else {
+    LOGS(logger_, WARNING) << "Failed to create a session specialized for the free dimension values " << key
+                           << ", the original session is used for them: " << status.ErrorMessage();
+    session.reset();
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Variant& variant = variants_[key];
+  variant.session = std::move(session);
+  variant.created = true;
+  return variant.session.get();
+}
+
+}  // namespace onnxruntime
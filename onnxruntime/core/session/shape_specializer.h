@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/session_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class InferenceSession;
+
+/**
+ * Routes the Run calls of a session whose inputs have free dimensions to sessions specialized for the values of
+ * these dimensions, e.g. a batch size of 1.
+ *
+ * Once min_runs calls have been seen with the same values, a session is created from the original model with a
+ * FreeDimensionOverride for each free dimension, so that its graph is optimized for the concrete shapes: shape
+ * subgraphs are constant folded, Reshape and Expand nodes are eliminated, and the kernels see static shapes. The
+ * following calls with these values run on the specialized session. At most max_variants specialized sessions are
+ * created; calls with other values, and calls seen while a specialized session is created, run on the original
+ * session. If a specialized session cannot be created, its values keep running on the original session.
+ */
+class ShapeSpecializer {
+ public:
+  // A free dimension of a graph input.
+  struct FreeDim {
+    std::string input_name;
+    size_t axis;
+    std::string dim_param;
+  };
+
+  // Creates a session for the original model with the given overrides of the free dimensions.
+  using CreateSessionFn = std::function<Status(const std::vector<FreeDimensionOverride>& overrides,
+                                               std::unique_ptr<InferenceSession>& session)>;
+
+  ShapeSpecializer(std::vector<FreeDim> free_dims, size_t min_runs, size_t max_variants,
+                   CreateSessionFn create_session_fn, const logging::Logger& logger);
+  ~ShapeSpecializer();
+
+  // Returns the session specialized for the shapes of the feeds, or nullptr if the call runs on the original session.
+  InferenceSession* GetSession(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds);
+
+ private:
+  struct Variant {
+    size_t num_runs = 0;
+    // Set once the session is created. Stays null if the creation failed.
+    std::unique_ptr<InferenceSession> session;
+    bool created = false;
+  };
+
+  // Values of the free dimensions for the feeds, in the order of free_dims_. False if a feed is missing, is not a
+  // tensor, or the same dim_param has different values.
+  bool GetDimValues(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                    InlinedVector<int64_t>& values) const;
+
+  const std::vector<FreeDim> free_dims_;
+  const size_t min_runs_;
+  const size_t max_variants_;
+  CreateSessionFn create_session_fn_;
+  const logging::Logger& logger_;
+
+  OrtMutex mutex_;
+  // Variants by the values of the free dimensions, including the values not seen min_runs times yet.
+  InlinedHashMap<std::string, Variant> variants_;
+  size_t num_created_ = 0;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ShapeSpecializer);
+};
+
+}  // namespace onnxruntime
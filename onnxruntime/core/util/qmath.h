@@ -39,6 +39,39 @@ struct FloatMinMax {
   float max;
 };
 
+// Computes the scale and zero point that quantize the range [min, max], widened to include zero.
+// ReduceRange and Symmetric is for test only
+template <typename QType,
+          bool ReduceRange = false,
+          bool Symmetric = false,
+          typename std::enable_if<is_quant_type<QType>::value, int>::type = 0>
+void GetQuantizationParameterFromMinMax(float min, float max, float& scale, QType& zp) {
+  // ensure the input range includes zero
+  min = std::min(min, 0.0f);
+  max = std::max(max, 0.0f);
+
+  // find scale and zero point
+  QType qmin = std::numeric_limits<QType>::min();
+  QType qmax = std::numeric_limits<QType>::max();
+  if (std::is_same<QType, int8_t>::value) {
+    if (ReduceRange) {
+      qmin = static_cast<QType>(-64);
+      qmax = static_cast<QType>(64);
+    }
+
+    if (Symmetric) {
+      zp = 0;
+      float max_value = std::max(max, -min);
+      scale = max_value > 0 ? max_value / qmax : 1.f;
+      return;
+    }
+  }
+  scale = max == min ? 1.0f : (max - min) / float(qmax - qmin);
+
+  float initial_zero_point = qmin - min / scale;
+  zp = static_cast<QType>(RoundHalfToEven(std::max(float(qmin), std::min(float(qmax), initial_zero_point))));
+}
+
 // ReduceRange and Symmetric is for test only
 template <typename QType,
           bool ReduceRange = false,
@@ -74,36 +107,14 @@ void GetQuantizationParameter(const float* data, int64_t num_of_elements, float&
     MlasFindMinMaxElement(&(data[begin_idx]), &aggregate[agg_idx].min, &aggregate[agg_idx].max, end_idx - begin_idx);
   });
 
-  float& min = aggregate[0].min;
-  float& max = aggregate[0].max;
+  float min = aggregate[0].min;
+  float max = aggregate[0].max;
   for (int i = 1; i < num_blocks; i++) {
     min = std::min(min, aggregate[i].min);
     max = std::max(max, aggregate[i].max);
   }
-  // ensure the input range includes zero
-  min = std::min(min, 0.0f);
-  max = std::max(max, 0.0f);
 
-  // find scale and zero point
-  QType qmin = std::numeric_limits<QType>::min();
-  QType qmax = std::numeric_limits<QType>::max();
-  if (std::is_same<QType, int8_t>::value) {
-    if (ReduceRange) {
-      qmin = static_cast<QType>(-64);
-      qmax = static_cast<QType>(64);
-    }
-
-    if (Symmetric) {
-      zp = 0;
-      float max_value = std::max(max, -min);
-      scale = max_value > 0 ? max_value / qmax : 1.f;
-      return;
-    }
-  }
-  scale = max == min ? 1.0f : (max - min) / float(qmax - qmin);
-
-  float initial_zero_point = qmin - min / scale;
-  zp = static_cast<QType>(RoundHalfToEven(std::max(float(qmin), std::min(float(qmax), initial_zero_point))));
+  GetQuantizationParameterFromMinMax<QType, ReduceRange, Symmetric>(min, max, scale, zp);
 }
 
 /**
@@ -11,6 +11,7 @@
 #endif
 #include <thread>
 #include "core/session/ort_apis.h"
+#include "core/common/inlined_containers.h"
 #include "core/common/string_utils.h"
 #include "core/common/logging/logging.h"
 
@@ -19,9 +20,12 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " thread_pool_size: " << params.thread_pool_size;
   os << " auto_set_affinity: " << params.auto_set_affinity;
   os << " allow_spinning: " << params.allow_spinning;
+  os << " adaptive_spinning: " << params.adaptive_spinning;
   os << " dynamic_block_base_: " << params.dynamic_block_base_;
   os << " stack_size: " << params.stack_size;
   os << " affinity_str: " << params.affinity_str;
+  os << " numa_node: " << params.numa_node;
+  os << " performance_cores_only: " << params.performance_cores_only;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
@@ -89,10 +93,59 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
 }
 #endif
 
+// Keep the performance cores of a hybrid CPU among the given cores, or among all cores if none is given.
+// The cores are kept as they are if the CPU is not hybrid or they are all efficiency cores.
+static std::vector<LogicalProcessors> SelectPerformanceCores(Env* env, std::vector<LogicalProcessors> cores) {
+  auto performance_cores = env->GetPerformanceCoreThreadAffinities();
+  if (performance_cores.empty()) {
+    return cores;
+  }
+  if (cores.empty()) {
+    return performance_cores;
+  }
+  InlinedHashSet<int> performance_processors;
+  for (const auto& core : performance_cores) {
+    performance_processors.insert(core.begin(), core.end());
+  }
+  std::vector<LogicalProcessors> selected;
+  for (const auto& core : cores) {
+    if (std::all_of(core.begin(), core.end(),
+                    [&performance_processors](int cpu) { return performance_processors.count(cpu) > 0; })) {
+      selected.push_back(core);
+    }
+  }
+  return selected.empty() ? cores : selected;
+}
+
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
-  if (options.thread_pool_size <= 0) {  // default
+  // the cores the threads are restricted to, if any
+  std::vector<LogicalProcessors> core_affinities;
+  if (options.affinity_str.empty()) {
+    if (options.numa_node >= 0) {
+      core_affinities = env->GetNumaNodeThreadAffinities(options.numa_node);
+      ORT_ENFORCE(!core_affinities.empty(), "Failed to get the processors of NUMA node ", options.numa_node);
+    }
+    if (options.performance_cores_only) {
+      core_affinities = SelectPerformanceCores(env, std::move(core_affinities));
+    }
+  }
+  if (!core_affinities.empty()) {
+    if (options.thread_pool_size <= 0) {
+      options.thread_pool_size = static_cast<int>(core_affinities.size());
+    }
+    if (options.thread_pool_size <= 1) {
+      return nullptr;
+    }
+    // The first affinity is a placeholder for the main thread, which onnxruntime has no control.
+    // Other threads are spread over the selected cores.
+    to.affinities.reserve(options.thread_pool_size);
+    to.affinities.push_back(LogicalProcessors{});
+    for (int i = 1; i < options.thread_pool_size; ++i) {
+      to.affinities.push_back(core_affinities[i % core_affinities.size()]);
+    }
+  } else if (options.thread_pool_size <= 0) {  // default
     if (options.auto_set_affinity) {
 #ifdef _WIN32
       // Only set thread affinity on Server with auto affinity.
@@ -146,6 +199,7 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   }
 
   to.set_denormal_as_zero = options.set_denormal_as_zero;
+  to.adaptive_spinning = options.adaptive_spinning;
   // set custom thread management members
   to.custom_create_thread_fn = options.custom_create_thread_fn;
   to.custom_thread_creation_options = options.custom_thread_creation_options;
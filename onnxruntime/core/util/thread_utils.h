@@ -37,11 +37,22 @@ struct OrtThreadPoolParams {
   // meaning ith thread will be attached to first 8 logical processors
   std::string affinity_str;
 
+  // If it is non-negative, attach the threads to the physical cores of this NUMA node.
+  // It is ignored if affinity_str is set.
+  int numa_node = -1;
+
+  // If it is true, attach the threads to the performance cores of a hybrid CPU only, so that the slower efficiency
+  // cores do not hold back the parallel loops. It is ignored if affinity_str is set or the CPU is not hybrid.
+  bool performance_cores_only = false;
+
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
   bool set_denormal_as_zero = false;
 
+  // If it is true, threads tune how long they spin before blocking from the idle gaps they observed.
+  bool adaptive_spinning = false;
+
   // members to manage custom threads
   OrtCustomCreateThreadFn custom_create_thread_fn = nullptr;
   void* custom_thread_creation_options = nullptr;
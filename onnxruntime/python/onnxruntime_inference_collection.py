@@ -6,6 +6,7 @@ from __future__ import annotations
 
 import collections
 import collections.abc
+import concurrent.futures
 import os
 import typing
 import warnings
@@ -204,10 +205,13 @@ class Session:
         Compute the predictions.
 
         :param output_names: name of the outputs
-        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param input_feed: dictionary ``{ input_name: input_value }``. Contiguous numpy arrays, objects supporting
+            the ``__dlpack__`` protocol (e.g. torch or cupy tensors) and objects supporting the buffer protocol are
+            used without a copy.
         :param run_options: See :class:`onnxruntime.RunOptions`.
         :return: list of results, every result is either a numpy array,
-            a sparse tensor, a list or a dictionary.
+            a sparse tensor, a list or a dictionary. Numeric outputs on CPU are numpy arrays using the memory
+            allocated by the run, without a copy.
 
         ::
 
@@ -228,7 +232,42 @@ class Session:
                 return self._sess.run(output_names, input_feed, run_options)
             raise
 
-    def run_async(self, output_names, input_feed, callback, user_data, run_options=None):
+    def run_batch(self, output_names, input_feeds, run_options=None, max_concurrency=1):
+        """
+        Compute the predictions of a batch of requests.
+
+        The GIL is released once for the whole batch and the requests run on up to ``max_concurrency`` threads,
+        so other python threads are not serialized on the conversion of each request. Inputs and outputs are
+        converted without a copy as in :meth:`run`.
+
+        :param output_names: name of the outputs
+        :param input_feeds: list of dictionaries ``{ input_name: input_value }``, one per request
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :param max_concurrency: number of requests run at the same time, each request still uses the intra-op
+            thread pool of the session
+        :return: list of the results of each request, see :meth:`run`
+
+        ::
+
+            sess.run_batch([output_name], [{input_name: x} for x in xs], max_concurrency=4)
+        """
+        for input_feed in input_feeds:
+            self._validate_input(list(input_feed.keys()))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        try:
+            return self._sess.run_batch(output_names, input_feeds, run_options, max_concurrency)
+        except C.EPFail as err:
+            if self._enable_fallback:
+                print(f"EP Error: {err!s} using {self._providers}")
+                print(f"Falling back to {self._fallback_providers} and retrying.")
+                self.set_providers(self._fallback_providers)
+                # Fallback only once.
+                self.disable_fallback()
+                return self._sess.run_batch(output_names, input_feeds, run_options, max_concurrency)
+            raise
+
+    def run_async(self, output_names, input_feed, callback=None, user_data=None, run_options=None):
         """
         Compute the predictions asynchronously in a separate cxx thread from ort intra-op threadpool.
 
@@ -236,7 +275,10 @@ class Session:
         :param input_feed: dictionary ``{ input_name: input_value }``
         :param callback: python function that accept array of results, and a status string on error.
             The callback will be invoked by a cxx thread from ort intra-op threadpool.
+            Without a callback, a :class:`concurrent.futures.Future` of the results is returned.
         :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: None with a callback, otherwise a :class:`concurrent.futures.Future` set to the list of results,
+            see :meth:`run`, or to the exception of the run.
 
         ::
             class MyData:
@@ -252,11 +294,27 @@ class Session:
                 # save results to user_data
 
             sess.run_async([output_name], {input_name: x}, callback)
+
+            futures = [sess.run_async([output_name], {input_name: x}) for x in xs]
+            results = [future.result() for future in futures]
         """
         self._validate_input(list(input_feed.keys()))
         if not output_names:
             output_names = [output.name for output in self._outputs_meta]
-        return self._sess.run_async(output_names, input_feed, callback, user_data, run_options)
+        if callback is not None:
+            return self._sess.run_async(output_names, input_feed, callback, user_data, run_options)
+
+        future = concurrent.futures.Future()
+        future.set_running_or_notify_cancel()
+
+        def set_result(results, _, err):
+            if err:
+                future.set_exception(RuntimeError(err))
+            else:
+                future.set_result(results)
+
+        self._sess.run_async(output_names, input_feed, set_result, None, run_options)
+        return future
 
     def run_with_ort_values(self, output_names, input_dict_ort_values, run_options=None):
         """
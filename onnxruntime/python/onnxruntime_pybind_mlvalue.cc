@@ -733,6 +733,27 @@ static void CreateTensorMLValueOwned(const OrtPybindSingleUseAllocatorPtr& pybin
                   ml_tensor->GetDeleteFunc());
 }
 
+#ifdef ENABLE_DLPACK
+// Creates an OrtValue using the memory of an object supporting the __dlpack__ protocol, without a copy.
+// DLPack has no boolean type before version 0.8, so booleans come as uint8 and the model input tells them apart.
+static void CreateTensorMLValueFromDlpack(const InputDefList* input_def_list, const std::string& name_input,
+                                          const py::object& value, OrtValue* p_mlvalue) {
+  bool is_bool_tensor = false;
+  if (input_def_list != nullptr) {
+    auto it = std::find_if(input_def_list->begin(), input_def_list->end(),
+                           [&name_input](const NodeArg* node_arg) { return node_arg->Name() == name_input; });
+    if (it != input_def_list->end()) {
+      const auto* type_proto = (*it)->TypeAsProto();
+      is_bool_tensor = type_proto != nullptr && type_proto->has_tensor_type() &&
+                       type_proto->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_BOOL;
+    }
+  }
+
+  py::object capsule = value.attr("__dlpack__")();
+  *p_mlvalue = FromDlpack(capsule.ptr(), is_bool_tensor);
+}
+#endif
+
 std::string _get_type_name(int64_t&) {
   return std::string("int64_t");
 }
@@ -994,6 +1015,21 @@ void CreateGenericMLValue(const onnxruntime::InputDefList* input_def_list, const
     // This should just increase the ref counts of the underlying shared_ptrs in the native OrtValue
     // and the ref count will be decreased when the OrtValue used for Run() is destroyed upon exit.
     *p_mlvalue = *value.attr(PYTHON_ORTVALUE_NATIVE_OBJECT_ATTR).cast<OrtValue*>();
+#ifdef ENABLE_DLPACK
+  } else if (!accept_only_numpy_array && use_numpy_data_memory && py::hasattr(value, "__dlpack__")) {
+    // A tensor of another framework, e.g. torch or cupy, possibly on a device. The OrtValue uses its memory and
+    // keeps it alive through the DLPack structure.
+    CreateTensorMLValueFromDlpack(input_def_list, name_input, value, p_mlvalue);
+#endif
+  } else if (!accept_only_numpy_array && use_numpy_data_memory && PyObject_CheckBuffer(value.ptr())) {
+    // Any other object exposing the buffer protocol, e.g. a memoryview or an array.array. The numpy array is a view
+    // of the buffer, which the allocator keeps alive, so a contiguous buffer is not copied.
+    PyArrayObject* arr = reinterpret_cast<PyArrayObject*>(PyArray_FromAny(value.ptr(), nullptr, 0, 0, 0, nullptr));
+    if (!arr) {
+      throw std::runtime_error("Could not create tensor from the buffer of input '" + name_input + "'");
+    }
+    auto pybind_alloc = std::make_shared<OrtPybindSingleUseAllocator>(arr, name_input, alloc->Info());
+    CreateTensorMLValueOwned(pybind_alloc, alloc, p_mlvalue);
   } else if (!accept_only_numpy_array) {
     auto iterator = PyObject_GetIter(value.ptr());
     if (iterator == NULL) {
@@ -54,6 +54,8 @@ namespace onnxruntime {
 
 #include <iterator>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 namespace onnxruntime {
 namespace python {
@@ -75,7 +77,12 @@ static Env& platform_env = Env::Default();
 
 using PyCallback = std::function<void(std::vector<py::object>, py::object user_data, std::string)>;
 
+static py::object AddRunOutputAsPyObj(const InferenceSession& session, const std::string& output_name,
+                                      const OrtValue& val);
+
 struct AsyncResource {
+  const InferenceSession* session{};
+
   std::vector<OrtValue> feeds;
   std::vector<const OrtValue*> feeds_raw;
 
@@ -134,7 +141,7 @@ void AsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtS
       const auto& fet = *outputs[ith];
       if (fet.IsAllocated()) {
         if (fet.IsTensor()) {
-          rfetch.push_back(AddTensorAsPyObj(fet, nullptr, nullptr));
+          rfetch.push_back(AddRunOutputAsPyObj(*async_resource->session, async_resource->fetch_names[ith], fet));
         } else if (fet.IsSparseTensor()) {
           rfetch.push_back(GetPyObjectFromSparseTensor(pos, fet, nullptr));
         } else {
@@ -345,6 +352,40 @@ py::object AddNonTensorAsPyObj(const OrtValue& val,
   ORT_THROW("Non-tensor type is not supported in this build: ", val_type);
 }
 
+// Returns a numpy array using the memory of a CPU tensor, which the array keeps alive through a copy of the OrtValue.
+// The caller makes sure nothing else writes to the tensor, e.g. it is an output allocated by a run.
+static py::object GetPyObjFromTensorNoCopy(const OrtValue& val) {
+  const Tensor& rtensor = val.Get<Tensor>();
+  const TensorShape& shape = rtensor.Shape();
+  std::vector<npy_intp> npy_dims(shape.GetDims().begin(), shape.GetDims().end());
+  const int numpy_type = OnnxRuntimeTensorToNumpyType(rtensor.DataType());
+
+  py::capsule owner(new OrtValue(val), [](void* ort_value) { delete static_cast<OrtValue*>(ort_value); });
+  py::object obj = py::reinterpret_steal<py::object>(PyArray_New(
+      &PyArray_Type, narrow<int>(shape.NumDimensions()), npy_dims.data(), numpy_type, nullptr,
+      const_cast<void*>(rtensor.DataRaw()), 0, NPY_ARRAY_CARRAY, nullptr));
+  if (!obj) {
+    throw py::error_already_set();
+  }
+  // steals the reference to the capsule
+  if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(obj.ptr()), owner.release().ptr()) != 0) {
+    throw py::error_already_set();
+  }
+  return obj;
+}
+
+// The outputs of a run are returned without a copy when they are CPU tensors allocated by the run. Outputs that are
+// initializers, or use the memory of a feed, share their memory with the session or the caller and are copied.
+static py::object AddRunOutputAsPyObj(const InferenceSession& session, const std::string& output_name,
+                                      const OrtValue& val) {
+  const Tensor& rtensor = val.Get<Tensor>();
+  if (rtensor.Location().device.Type() == OrtDevice::CPU && !rtensor.IsDataTypeString() && rtensor.OwnsBuffer() &&
+      !session.GetSessionState().GetGraphViewer().IsInitializedTensor(output_name)) {
+    return GetPyObjFromTensorNoCopy(val);
+  }
+  return AddTensorAsPyObj(val, nullptr, nullptr);
+}
+
 py::object AddTensorAsPyObj(const OrtValue& val, const DataTransferManager* data_transfer_manager,
                             const std::unordered_map<OrtDevice::DeviceType, MemCpyFunc>* mem_cpy_to_host_functions) {
   const Tensor& rtensor = val.Get<Tensor>();
@@ -353,6 +394,51 @@ py::object AddTensorAsPyObj(const OrtValue& val, const DataTransferManager* data
   return obj;
 }
 
+// Converts the python feeds of a run, which needs the GIL. Nones are skipped, the graph handles the missing optional
+// inputs.
+static NameMLValMap CreateRunFeeds(const InferenceSession& session, const std::map<std::string, py::object>& pyfeeds) {
+  auto px = session.GetModelInputs();
+  if (!px.first.IsOK() || !px.second) {
+    throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+  }
+  NameMLValMap feeds;
+  for (const auto& feed : pyfeeds) {
+    if (!feed.second.is(py::none())) {
+      OrtValue ml_value;
+      CreateGenericMLValue(px.second, GetAllocator(), feed.first, feed.second, &ml_value);
+      ThrowIfPyErrOccured();
+      feeds.insert(std::make_pair(feed.first, ml_value));
+    }
+  }
+  return feeds;
+}
+
+// Converts the fetches of a run to python objects, which needs the GIL.
+static std::vector<py::object> CreateRunOutputs(const InferenceSession& session,
+                                                const std::vector<std::string>& output_names,
+                                                const std::vector<OrtValue>& fetches) {
+  std::vector<py::object> rfetch;
+  rfetch.reserve(fetches.size());
+  size_t pos = 0;
+  for (const auto& fet : fetches) {
+    if (fet.IsAllocated()) {
+      if (fet.IsTensor() && pos < output_names.size()) {
+        rfetch.push_back(AddRunOutputAsPyObj(session, output_names[pos], fet));
+      } else if (fet.IsTensor()) {
+        rfetch.push_back(AddTensorAsPyObj(fet, nullptr, nullptr));
+      } else if (fet.IsSparseTensor()) {
+        rfetch.push_back(GetPyObjectFromSparseTensor(pos, fet, nullptr));
+      } else {
+        rfetch.push_back(AddNonTensorAsPyObj(fet, nullptr, nullptr));
+      }
+    } else {  // Send back None because the corresponding OrtValue was empty
+      rfetch.push_back(py::none());
+    }
+    ++pos;
+  }
+  return rfetch;
+}
+
 static std::unique_ptr<onnxruntime::IExecutionProvider> LoadExecutionProvider(
     const std::string& ep_shared_lib_path,
     const ProviderOptions& provider_options = {},
@@ -477,7 +563,7 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
       // and TRT EP instance, so it won't be released.)
       std::string calibration_table, cache_path, cache_prefix, timing_cache_path, lib_path, trt_tactic_sources,
           trt_extra_plugin_lib_paths, min_profile, max_profile, opt_profile, ep_context_file_path,
-          onnx_model_folder_path;
+          onnx_model_folder_path, engine_cache_store_lib_path;
       auto it = provider_options_map.find(type);
       if (it != provider_options_map.end()) {
         OrtTensorRTProviderOptionsV2 params;
@@ -775,6 +861,27 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
             } else {
               ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_engine_hw_compatible' should be 'True' or 'False'. Default value is 'False'.\n");
             }
+          } else if (option.first == "trt_async_engine_build_enable") {
+            if (option.second == "True" || option.second == "true") {
+              params.trt_async_engine_build_enable = true;
+            } else if (option.second == "False" || option.second == "false") {
+              params.trt_async_engine_build_enable = false;
+            } else {
+              ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_async_engine_build_enable' should be 'True' or 'False'. Default value is 'False'.\n");
+            }
+          } else if (option.first == "trt_engine_cache_store_lib_path") {
+            if (!option.second.empty()) {
+              engine_cache_store_lib_path = option.second;
+              params.trt_engine_cache_store_lib_path = engine_cache_store_lib_path.c_str();
+            } else {
+              ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_engine_cache_store_lib_path' should be a path string i.e. 'engine_cache_store_lib'.\n");
+            }
+          } else if (option.first == "trt_profile_observation_runs") {
+            if (!option.second.empty()) {
+              params.trt_profile_observation_runs = std::stoi(option.second);
+            } else {
+              ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_profile_observation_runs' should be a number i.e. '100'.\n");
+            }
           } else {
             ORT_THROW("Invalid TensorRT EP option: ", option.first);
           }
@@ -1407,7 +1514,8 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
   py::enum_<ExecutionOrder>(m, "ExecutionOrder")
       .value("DEFAULT", ExecutionOrder::DEFAULT)
       .value("PRIORITY_BASED", ExecutionOrder::PRIORITY_BASED)
-      .value("MEMORY_EFFICIENT", ExecutionOrder::MEMORY_EFFICIENT);
+      .value("MEMORY_EFFICIENT", ExecutionOrder::MEMORY_EFFICIENT)
+      .value("MEMORY_MINIMIZING", ExecutionOrder::MEMORY_MINIMIZING);
 
   py::enum_<OrtAllocatorType>(m, "OrtAllocatorType")
       .value("INVALID", OrtInvalidAllocator)
@@ -1462,6 +1570,8 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
             ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
           } else if (key == "max_power_of_two_extend_bytes") {
             ort_arena_cfg->max_power_of_two_extend_bytes = kvp.second.cast<int>();
+          } else if (key == "thread_cache_max_chunk_size_bytes") {
+            ort_arena_cfg->thread_cache_max_chunk_size_bytes = kvp.second.cast<int>();
           } else {
             ORT_THROW("Invalid OrtArenaCfg option: ", key);
           }
@@ -1473,7 +1583,8 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
       .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
-      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes);
+      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes)
+      .def_readwrite("thread_cache_max_chunk_size_bytes", &OrtArenaCfg::thread_cache_max_chunk_size_bytes);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
@@ -1891,23 +2002,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
            [](PyInferenceSession* sess, std::vector<std::string> output_names,
               std::map<std::string, py::object> pyfeeds, RunOptions* run_options = nullptr)
                -> std::vector<py::object> {
-             NameMLValMap feeds;
-             for (auto feed : pyfeeds) {
-               // No need to process 'None's sent in by the user
-               // to feed Optional inputs in the graph.
-               // We just won't include anything in the feed and ORT
-               // will handle such implicit 'None's internally.
-               if (!feed.second.is(py::none())) {
-                 OrtValue ml_value;
-                 auto px = sess->GetSessionHandle()->GetModelInputs();
-                 if (!px.first.IsOK() || !px.second) {
-                   throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
-                 }
-                 CreateGenericMLValue(px.second, GetAllocator(), feed.first, feed.second, &ml_value);
-                 ThrowIfPyErrOccured();
-                 feeds.insert(std::make_pair(feed.first, ml_value));
-               }
-             }
+             NameMLValMap feeds = CreateRunFeeds(*sess->GetSessionHandle(), pyfeeds);
 
              std::vector<OrtValue> fetches;
              common::Status status;
@@ -1922,25 +2017,58 @@ including arg name, arg type (contains both type and shape).)pbdoc")
                }
              }
 
-             std::vector<py::object> rfetch;
-             rfetch.reserve(fetches.size());
-             size_t pos = 0;
-             for (auto fet : fetches) {
-               if (fet.IsAllocated()) {
-                 if (fet.IsTensor()) {
-                   rfetch.push_back(AddTensorAsPyObj(fet, nullptr, nullptr));
-                 } else if (fet.IsSparseTensor()) {
-                   rfetch.push_back(GetPyObjectFromSparseTensor(pos, fet, nullptr));
-                 } else {
-                   rfetch.push_back(AddNonTensorAsPyObj(fet, nullptr, nullptr));
-                 }
-               } else {  // Send back None because the corresponding OrtValue was empty
-                 rfetch.push_back(py::none());
-               }
-               ++pos;
-             }
-             return rfetch;
+             return CreateRunOutputs(*sess->GetSessionHandle(), output_names, fetches);
            })
+      /// Runs a batch of requests with the GIL released once for all of them, on up to max_concurrency threads.
+      /// The feeds are converted before and the outputs after, which is cheap for numpy arrays, DLPack and buffer
+      /// protocol inputs and CPU outputs as they are not copied.
+      .def(
+          "run_batch",
+          [](PyInferenceSession* sess, std::vector<std::string> output_names,
+             std::vector<std::map<std::string, py::object>> batch_pyfeeds, RunOptions* run_options = nullptr,
+             size_t max_concurrency = 1) -> std::vector<std::vector<py::object>> {
+            InferenceSession& session = *sess->GetSessionHandle();
+            std::vector<NameMLValMap> batch_feeds;
+            batch_feeds.reserve(batch_pyfeeds.size());
+            for (const auto& pyfeeds : batch_pyfeeds) {
+              batch_feeds.push_back(CreateRunFeeds(session, pyfeeds));
+            }
+
+            std::vector<std::vector<OrtValue>> batch_fetches(batch_feeds.size());
+            std::vector<common::Status> statuses(batch_feeds.size());
+            {
+              py::gil_scoped_release release;
+              RunOptions default_run_options;
+              const RunOptions& options = run_options != nullptr ? *run_options : default_run_options;
+              std::atomic<size_t> next{0};
+              auto run_requests = [&]() {
+                for (size_t i = next++; i < batch_feeds.size(); i = next++) {
+                  try {
+                    statuses[i] = session.Run(options, batch_feeds[i], output_names, &batch_fetches[i]);
+                  } catch (const std::exception& e) {
+                    statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, e.what());
+                  }
+                }
+              };
+              const size_t num_threads = std::min(std::max<size_t>(max_concurrency, 1), batch_feeds.size());
+              std::vector<std::thread> threads;
+              for (size_t i = 1; i < num_threads; ++i) {
+                threads.emplace_back(run_requests);
+              }
+              run_requests();
+              for (auto& thread : threads) {
+                thread.join();
+              }
+            }
+
+            std::vector<std::vector<py::object>> results;
+            results.reserve(batch_fetches.size());
+            for (size_t i = 0; i < batch_fetches.size(); ++i) {
+              OrtPybindThrowIfError(statuses[i]);
+              results.push_back(CreateRunOutputs(session, output_names, batch_fetches[i]));
+            }
+            return results;
+          })
       .def("run_async",
            [](PyInferenceSession* sess,
               std::vector<std::string> output_names,
@@ -1949,6 +2077,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
               RunOptions* run_options = nullptr)
                -> void {
              std::unique_ptr<AsyncResource> async_resource = std::make_unique<AsyncResource>();
+             async_resource->session = sess->GetSessionHandle();
              async_resource->callback = callback;
              async_resource->user_data = user_data;
              // prepare feeds
@@ -9,13 +9,15 @@
 #include "test/util/include/scoped_env_vars.h"
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "test/contrib_ops/attention_op_test_helper.h"
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 namespace onnxruntime {
 
 namespace test {
 
-// This op is currently only supported on CUDA- so test it only for CUDA
+// DecoderMaskedSelfAttention is currently only supported on CUDA- so test it only for CUDA
 #ifdef USE_CUDA
 
 template <typename T>
@@ -923,5 +925,196 @@ TEST(DecoderMaskedSelfAttentionTest, Test_fp16) {
 
 #endif
 
+// Deterministic values in [-0.5, 0.5] for the CPU tests.
+static std::vector<float> CreateSineValues(size_t size, float step) {
+  std::vector<float> values(size);
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = 0.5f * std::sin(step * static_cast<float>(i + 1));
+  }
+  return values;
+}
+
+// Softmax of the scores of one query, then the weighted sum of the value rows.
+static void SoftmaxAndApplyToValues(std::vector<float>& scores, const std::vector<const float*>& value_rows,
+                                    int head_size, float* output) {
+  const float max_score = *std::max_element(scores.begin(), scores.end());
+  float sum = 0.0f;
+  for (float& score : scores) {
+    score = std::exp(score - max_score);
+    sum += score;
+  }
+  for (int h = 0; h < head_size; h++) {
+    float acc = 0.0f;
+    for (size_t t = 0; t < scores.size(); t++) {
+      acc += scores[t] / sum * value_rows[t][h];
+    }
+    output[h] = acc;
+  }
+}
+
+TEST(DecoderMaskedMultiHeadAttentionTest, CrossAttentionCpu) {
+  // Two batch entries of two beams. The beams of an entry share the key and value computed from the encoder output.
+  constexpr int num_entries = 2;
+  constexpr int beam_width = 2;
+  constexpr int batch_size = num_entries * beam_width;
+  constexpr int num_heads = 2;
+  constexpr int head_size = 8;
+  constexpr int hidden_size = num_heads * head_size;
+  constexpr int kv_sequence_length = 5;
+  constexpr float mask_filter_value = -10000.0f;
+  const float scale = 1.0f / std::sqrt(static_cast<float>(head_size));
+
+  const auto query = CreateSineValues(batch_size * hidden_size, 0.37f);
+  const auto entry_key = CreateSineValues(num_entries * num_heads * kv_sequence_length * head_size, 0.21f);
+  const auto entry_value = CreateSineValues(num_entries * num_heads * kv_sequence_length * head_size, 0.53f);
+  const size_t entry_kv_size = static_cast<size_t>(num_heads) * kv_sequence_length * head_size;
+
+  std::vector<float> key;
+  std::vector<float> value;
+  for (int b = 0; b < batch_size; b++) {
+    const size_t entry_offset = (b / beam_width) * entry_kv_size;
+    key.insert(key.end(), entry_key.begin() + entry_offset, entry_key.begin() + entry_offset + entry_kv_size);
+    value.insert(value.end(), entry_value.begin() + entry_offset, entry_value.begin() + entry_offset + entry_kv_size);
+  }
+
+  // The second entry has two padded positions.
+  std::vector<int32_t> mask(batch_size * kv_sequence_length, 1);
+  for (int b = beam_width; b < batch_size; b++) {
+    mask[b * kv_sequence_length + 3] = 0;
+    mask[b * kv_sequence_length + 4] = 0;
+  }
+
+  std::vector<float> expected_output(batch_size * hidden_size);
+  std::vector<float> expected_qk(batch_size * num_heads * kv_sequence_length);
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < num_heads; n++) {
+      const float* q = query.data() + b * hidden_size + n * head_size;
+      std::vector<float> scores(kv_sequence_length);
+      std::vector<const float*> value_rows(kv_sequence_length);
+      for (int t = 0; t < kv_sequence_length; t++) {
+        const size_t row_offset = ((b * num_heads + n) * kv_sequence_length + t) * head_size;
+        float dot = 0.0f;
+        for (int h = 0; h < head_size; h++) {
+          dot += q[h] * key[row_offset + h];
+        }
+        scores[t] = dot * scale + (mask[b * kv_sequence_length + t] == 0 ? mask_filter_value : 0.0f);
+        expected_qk[(b * num_heads + n) * kv_sequence_length + t] = scores[t];
+        value_rows[t] = value.data() + row_offset;
+      }
+      SoftmaxAndApplyToValues(scores, value_rows, head_size, expected_output.data() + b * hidden_size + n * head_size);
+    }
+  }
+
+  OpTester tester("DecoderMaskedMultiHeadAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(num_heads));
+  tester.AddAttribute<int64_t>("output_qk", static_cast<int64_t>(1));
+
+  tester.AddInput<float>("query", {batch_size, 1, hidden_size}, query);
+  tester.AddInput<float>("key", {batch_size, num_heads, kv_sequence_length, head_size}, key);
+  tester.AddInput<float>("value", {batch_size, num_heads, kv_sequence_length, head_size}, value);
+  tester.AddInput<int32_t>("mask_index", {batch_size, kv_sequence_length}, mask);
+  tester.AddOptionalInputEdge<float>();    // relative_position_bias
+  tester.AddOptionalInputEdge<float>();    // past_key
+  tester.AddOptionalInputEdge<float>();    // past_value
+  tester.AddOptionalInputEdge<int32_t>();  // past_sequence_length
+  tester.AddInput<int32_t>("beam_width", {1}, {beam_width});
+
+  tester.AddOutput<float>("output", {batch_size, 1, hidden_size}, expected_output);
+  tester.AddOptionalOutputEdge<float>();  // present_key
+  tester.AddOptionalOutputEdge<float>();  // present_value
+  tester.AddOutput<float>("qk", {batch_size, num_heads, 1, kv_sequence_length}, expected_qk);
+  tester.SetOutputTolerance(0.0001f, 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(DecoderMaskedMultiHeadAttentionTest, SelfAttentionWithCacheIndirectionCpu) {
+  // One batch entry of two beams, reading the past through the cache indirection of beam search.
+  constexpr int beam_width = 2;
+  constexpr int batch_size = beam_width;
+  constexpr int num_heads = 2;
+  constexpr int head_size = 4;
+  constexpr int hidden_size = num_heads * head_size;
+  constexpr int max_sequence_length = 6;
+  constexpr int past_sequence_length = 3;
+  constexpr int total_sequence_length = past_sequence_length + 1;
+  const float scale = 1.0f / std::sqrt(static_cast<float>(head_size));
+
+  const auto query = CreateSineValues(batch_size * hidden_size, 0.41f);
+  const auto key = CreateSineValues(batch_size * hidden_size, 0.29f);
+  const auto value = CreateSineValues(batch_size * hidden_size, 0.61f);
+  const auto bias = CreateSineValues(3 * hidden_size, 0.17f);
+  const size_t cache_size = static_cast<size_t>(batch_size) * num_heads * max_sequence_length * head_size;
+  const auto past_key = CreateSineValues(cache_size, 0.13f);
+  const auto past_value = CreateSineValues(cache_size, 0.47f);
+  const std::vector<int32_t> cache_indirection = {0, 1, 1, 0, 0, 0,
+                                                  0, 0, 1, 1, 0, 0};
+
+  // The key and value of the new token, with their bias, are appended at past_sequence_length.
+  std::vector<float> present_key = past_key;
+  std::vector<float> present_value = past_value;
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < num_heads; n++) {
+      const size_t offset = ((b * num_heads + n) * max_sequence_length + past_sequence_length) * head_size;
+      for (int h = 0; h < head_size; h++) {
+        const int d = n * head_size + h;
+        present_key[offset + h] = key[b * hidden_size + d] + bias[hidden_size + d];
+        present_value[offset + h] = value[b * hidden_size + d] + bias[2 * hidden_size + d];
+      }
+    }
+  }
+
+  std::vector<float> expected_output(batch_size * hidden_size);
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < num_heads; n++) {
+      std::vector<float> q(head_size);
+      for (int h = 0; h < head_size; h++) {
+        q[h] = query[b * hidden_size + n * head_size + h] + bias[n * head_size + h];
+      }
+      std::vector<float> scores(total_sequence_length);
+      std::vector<const float*> value_rows(total_sequence_length);
+      for (int t = 0; t < total_sequence_length; t++) {
+        const int source = t < past_sequence_length ? cache_indirection[b * max_sequence_length + t] : b;
+        const size_t row_offset = ((source * num_heads + n) * max_sequence_length + t) * head_size;
+        float dot = 0.0f;
+        for (int h = 0; h < head_size; h++) {
+          dot += q[h] * present_key[row_offset + h];
+        }
+        scores[t] = dot * scale;
+        value_rows[t] = present_value.data() + row_offset;
+      }
+      SoftmaxAndApplyToValues(scores, value_rows, head_size, expected_output.data() + b * hidden_size + n * head_size);
+    }
+  }
+
+  OpTester tester("DecoderMaskedMultiHeadAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(num_heads));
+  tester.AddAttribute<int64_t>("past_present_share_buffer", static_cast<int64_t>(1));
+
+  std::vector<int64_t> cache_dims = {batch_size, num_heads, max_sequence_length, head_size};
+  tester.AddInput<float>("query", {batch_size, 1, hidden_size}, query);
+  tester.AddInput<float>("key", {batch_size, 1, hidden_size}, key);
+  tester.AddInput<float>("value", {batch_size, 1, hidden_size}, value);
+  tester.AddOptionalInputEdge<int32_t>();  // mask_index
+  tester.AddOptionalInputEdge<float>();    // relative_position_bias
+  tester.AddInput<float>("past_key", cache_dims, past_key);
+  tester.AddInput<float>("past_value", cache_dims, past_value);
+  tester.AddInput<int32_t>("past_sequence_length", {1}, {past_sequence_length});
+  tester.AddInput<int32_t>("beam_width", {1}, {beam_width});
+  tester.AddInput<int32_t>("cache_indirection", {1, beam_width, max_sequence_length}, cache_indirection);
+  tester.AddInput<float>("bias", {3 * hidden_size}, bias);
+
+  tester.AddOutput<float>("output", {batch_size, 1, hidden_size}, expected_output);
+  tester.AddOutput<float>("present_key", cache_dims, present_key);
+  tester.AddOutput<float>("present_value", cache_dims, present_value);
+  tester.SetOutputTolerance(0.0001f, 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
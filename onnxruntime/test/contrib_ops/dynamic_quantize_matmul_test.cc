@@ -203,6 +203,42 @@ TEST(DynamicQuantizeMatMul, HasZeroPoint_HasBias_test_U8) {
   RunDynamicQuantizeMatMulTest<uint8_t, true, true>();
 }
 
+TEST(DynamicQuantizeMatMul, Epilogue_Relu_Residual) {
+  RandomValueGenerator random{1668426375};
+
+  constexpr int64_t M = 4, N = 128, K = 128;
+  std::vector<float> A_data = random.Uniform<float>(AsSpan({M, K}), -1.0f, 1.0f);
+  std::vector<uint8_t> B_data = random.Uniform<uint8_t>(AsSpan({K, N}), 0, std::numeric_limits<uint8_t>::max() / 2);
+  std::vector<float> B_scale = random.Uniform<float>(AsSpan({N}), -0.1f, 0.1f);
+  std::vector<uint8_t> B_zero_point = random.Uniform<uint8_t>(AsSpan({N}), 0, std::numeric_limits<uint8_t>::max() / 2);
+  std::vector<float> Bias = random.Uniform<float>(AsSpan({N}), -0.1f, 0.1f);
+  std::vector<float> Residual = random.Uniform<float>(AsSpan({M, N}), -1.0f, 1.0f);
+
+  // Y = Relu(A * B + bias) + residual
+  std::vector<float> Y_data(M * N);
+  CalculateDynamicQuantizeMatMul<uint8_t>(M, N, K, A_data, B_data, B_scale, B_zero_point, Bias, Y_data,
+                                          true /*per_column*/, true /*has_zp*/, true /*has_bias*/);
+  for (size_t i = 0; i < Y_data.size(); ++i) {
+    Y_data[i] = std::max(Y_data[i], 0.0f) + Residual[i];
+  }
+
+  for (bool is_matrix_b_constant : {false, true}) {
+    OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+    test.AddAttribute<std::string>("activation", "Relu");
+    test.AddInput<float>("A", {M, K}, A_data);
+    test.AddInput<uint8_t>("B", {K, N}, B_data, is_matrix_b_constant);
+    test.AddInput<float>("b_scale", {N}, B_scale);
+    test.AddInput<uint8_t>("b_zero_point", {N}, B_zero_point);
+    test.AddInput<float>("bias", {N}, Bias);
+    test.AddInput<float>("residual", {M, N}, Residual);
+    test.AddOutput<float>("Y", {M, N}, Y_data);
+    test.SetOutputRelErr("Y", 0.02f);
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
 TEST(DynamicQuantizeMatMul, UInt8_test_with_empty_input) {
   std::vector<int64_t> A_dims{0, 2};
   std::vector<int64_t> B_dims{2, 2};
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+template <typename Tind>
+static void RunEmbeddingBagTest(const std::string& mode, const std::vector<int64_t>& weight_dims,
+                                const std::vector<int64_t>& indices_dims, const std::vector<Tind>& indices) {
+  const int64_t num_rows = weight_dims[0];
+  int64_t row_size = 1;
+  for (size_t i = 1; i < weight_dims.size(); ++i) {
+    row_size *= weight_dims[i];
+  }
+  std::vector<float> weight(num_rows * row_size);
+  for (size_t i = 0; i < weight.size(); ++i) {
+    weight[i] = static_cast<float>(i % 29) * 0.25f - 3.0f;
+  }
+
+  const int64_t bag_size = indices_dims.back();
+  const int64_t num_bags = bag_size == 0 ? 0 : static_cast<int64_t>(indices.size()) / bag_size;
+  std::vector<int64_t> output_dims(indices_dims.begin(), indices_dims.end() - 1);
+  output_dims.insert(output_dims.end(), weight_dims.begin() + 1, weight_dims.end());
+
+  int64_t output_size = 1;
+  for (auto dim : output_dims) {
+    output_size *= dim;
+  }
+  std::vector<float> expected(output_size, 0.0f);
+  for (int64_t bag = 0; bag < num_bags; ++bag) {
+    for (int64_t l = 0; l < bag_size; ++l) {
+      int64_t idx = static_cast<int64_t>(indices[bag * bag_size + l]);
+      idx = idx < 0 ? idx + num_rows : idx;
+      for (int64_t j = 0; j < row_size; ++j) {
+        expected[bag * row_size + j] += weight[idx * row_size + j];
+      }
+    }
+    if (mode == "mean" && bag_size > 0) {
+      for (int64_t j = 0; j < row_size; ++j) {
+        expected[bag * row_size + j] /= static_cast<float>(bag_size);
+      }
+    }
+  }
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("mode", mode);
+  test.AddInput<float>("weight", weight_dims, weight);
+  test.AddInput<Tind>("indices", indices_dims, indices);
+  test.AddOutput<float>("Y", output_dims, expected);
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, Sum) {
+  RunEmbeddingBagTest<int64_t>("sum", {10, 4}, {3, 2}, {0, 9, -1, 3, 5, 5});
+}
+
+TEST(EmbeddingBagTest, Mean) {
+  RunEmbeddingBagTest<int32_t>("mean", {10, 4}, {3, 2}, {0, 9, -1, 3, 5, 5});
+}
+
+TEST(EmbeddingBagTest, BatchedBags) {
+  std::vector<int64_t> indices(4 * 5 * 12);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    indices[i] = static_cast<int64_t>((i * 37) % 200) - 100;
+  }
+  RunEmbeddingBagTest<int64_t>("mean", {100, 2, 48}, {4, 5, 12}, indices);
+}
+
+TEST(EmbeddingBagTest, EmptyBags) {
+  RunEmbeddingBagTest<int64_t>("sum", {10, 4}, {3, 0}, {});
+}
+
+TEST(EmbeddingBagTest, InvalidIndex) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("weight", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<int64_t>("indices", {1, 2}, {0, 2});
+  test.AddOutput<float>("Y", {1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
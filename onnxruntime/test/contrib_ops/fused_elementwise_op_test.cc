@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+static std::vector<float> MakeValues(size_t size, float scale) {
+  std::vector<float> values(size);
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = static_cast<float>(static_cast<int>(i % 23) - 11) * scale;
+  }
+  return values;
+}
+
+// (X + B) * Sigmoid(X + B) * C, with B broadcast along the rows and C a scalar.
+// The output spans several tiles and ends with a partial one.
+TEST(FusedElementwiseTest, AddSigmoidMulMul) {
+  const std::vector<int64_t> x_dims{3, 67, 40};
+  const std::vector<float> x = MakeValues(3 * 67 * 40, 0.25f);
+  const std::vector<float> b = MakeValues(40, 0.1f);
+  const std::vector<float> c{1.5f};
+
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    const float sum = x[i] + b[i % b.size()];
+    expected[i] = sum * (1.0f / (1.0f + std::exp(-sum))) * c[0];
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Sigmoid", "Mul", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 3, -1, 3, 4, 5, 2});
+  test.AddInput<float>("X", x_dims, x);
+  test.AddInput<float>("B", {1, 40}, b);
+  test.AddInput<float>("C", {}, c);
+  test.AddOutput<float>("Y", x_dims, expected);
+  test.SetOutputAbsErr("Y", 1e-5f);
+  test.Run();
+}
+
+TEST(FusedElementwiseTest, SubReluSqrtDiv) {
+  const std::vector<int64_t> dims{2, 5};
+  const std::vector<float> x = MakeValues(10, 1.0f);
+  const std::vector<float> y = MakeValues(10, -0.5f);
+  const std::vector<float> d{2.0f, 4.0f, 8.0f, 16.0f, 32.0f};
+
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    expected[i] = std::sqrt(std::max(y[i] - x[i], 0.0f)) / d[i % d.size()];
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Sub", "Relu", "Sqrt", "Div"});
+  test.AddAttribute("operands", std::vector<int64_t>{1, 0, 3, -1, 4, -1, 5, 2});
+  test.AddInput<float>("X", dims, x);
+  test.AddInput<float>("Y", dims, y);
+  test.AddInput<float>("D", {5}, d);
+  test.AddOutput<float>("Z", dims, expected);
+  test.Run();
+}
+
+// float16 is computed in float by the CUDA kernel
+TEST(FusedElementwiseTest, Float16AddTanhMul) {
+  auto cuda_ep = DefaultCudaExecutionProvider();
+  if (cuda_ep == nullptr) {
+    GTEST_SKIP() << "FusedElementwise supports float16 on CUDA only";
+  }
+
+  const std::vector<int64_t> x_dims{4, 33, 16};
+  const std::vector<float> x = MakeValues(4 * 33 * 16, 0.125f);
+  const std::vector<float> b = MakeValues(16, 0.25f);
+
+  std::vector<float> expected(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    const float sum = x[i] + b[i % b.size()];
+    expected[i] = std::tanh(sum) * x[i];
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Tanh", "Mul"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1, 3, 0});
+  test.AddInput<MLFloat16>("X", x_dims, ToFloat16(x));
+  test.AddInput<MLFloat16>("B", {16}, ToFloat16(b));
+  test.AddOutput<MLFloat16>("Y", x_dims, ToFloat16(expected));
+  test.SetOutputAbsErr("Y", 0.005f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(std::move(cuda_ep));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(FusedElementwiseTest, InvalidBroadcast) {
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Add", "Relu"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 2, -1});
+  test.AddInput<float>("X", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("B", {2}, {1.f, 2.f});
+  test.AddOutput<float>("Y", {2, 3}, {0.f, 0.f, 0.f, 0.f, 0.f, 0.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "does not broadcast to the output shape");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <vector>
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "contrib_ops/cpu/transformers/generation_prefix_cache.h"
+
+using onnxruntime::contrib::transformers::GenerationPrefixCache;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Past state of one layer with shape (2, 1, 1, sequence_length, 2) filled with the given value.
+std::vector<OrtValue> MakePastState(int64_t sequence_length, float value) {
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  OrtValue past;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({2, 1, 1, sequence_length, 2}), allocator, past);
+  for (float& v : past.GetMutable<Tensor>()->MutableDataAsSpan<float>()) {
+    v = value;
+  }
+  return {past};
+}
+}  // namespace
+
+TEST(GenerationPrefixCacheTest, LookupLongestPrefix) {
+  GenerationPrefixCache cache(1 << 20);
+  const std::vector<int32_t> short_prompt = {1, 2};
+  const std::vector<int32_t> long_prompt = {1, 2, 3, 4};
+  cache.Insert(short_prompt, MakePastState(2, 1.0f));
+  cache.Insert(long_prompt, MakePastState(4, 2.0f));
+  cache.Insert(long_prompt, MakePastState(4, 3.0f));  // duplicated prompt is not added again
+  EXPECT_EQ(cache.NumEntries(), 2u);
+
+  std::vector<OrtValue> past_state;
+  EXPECT_EQ(cache.Lookup(std::vector<int32_t>{1, 2, 3, 4, 5}, past_state), 4);
+  ASSERT_EQ(past_state.size(), 1u);
+  EXPECT_EQ(past_state[0].Get<Tensor>().Data<float>()[0], 2.0f);
+
+  // Only a proper prefix is returned, so that at least one token is left to compute logits.
+  EXPECT_EQ(cache.Lookup(long_prompt, past_state), 2);
+  EXPECT_EQ(past_state[0].Get<Tensor>().Data<float>()[0], 1.0f);
+
+  EXPECT_EQ(cache.Lookup(std::vector<int32_t>{1, 3, 4}, past_state), 0);
+  EXPECT_EQ(cache.Lookup(std::vector<int32_t>{2, 2, 3}, past_state), 0);
+}
+
+TEST(GenerationPrefixCacheTest, EvictLeastRecentlyUsed) {
+  const std::vector<int32_t> prompt_a = {1, 2};
+  const std::vector<int32_t> prompt_b = {3, 4};
+  const std::vector<int32_t> prompt_c = {5, 6};
+  const size_t entry_size = 2 * sizeof(int32_t) + 8 * sizeof(float);
+  GenerationPrefixCache cache(2 * entry_size);
+
+  cache.Insert(prompt_a, MakePastState(2, 1.0f));
+  cache.Insert(prompt_b, MakePastState(2, 2.0f));
+  EXPECT_EQ(cache.SizeInBytes(), 2 * entry_size);
+
+  // Use prompt_a so that prompt_b becomes the least recently used one.
+  std::vector<OrtValue> past_state;
+  EXPECT_EQ(cache.Lookup(std::vector<int32_t>{1, 2, 7}, past_state), 2);
+
+  cache.Insert(prompt_c, MakePastState(2, 3.0f));
+  EXPECT_EQ(cache.NumEntries(), 2u);
+  EXPECT_EQ(cache.SizeInBytes(), 2 * entry_size);
+  EXPECT_EQ(cache.Lookup(std::vector<int32_t>{1, 2, 7}, past_state), 2);
+  EXPECT_EQ(cache.Lookup(std::vector<int32_t>{3, 4, 7}, past_state), 0);
+  EXPECT_EQ(cache.Lookup(std::vector<int32_t>{5, 6, 7}, past_state), 2);
+
+  // Past state larger than the whole budget is not cached.
+  cache.Insert(std::vector<int32_t>{8, 9, 10}, MakePastState(8, 4.0f));
+  EXPECT_EQ(cache.Lookup(std::vector<int32_t>{8, 9, 10, 11}, past_state), 0);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,513 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test/common/cuda_op_test_utils.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+std::vector<float> MakeData(size_t count, int seed) {
+  std::vector<float> data(count);
+  for (size_t i = 0; i < count; i++) {
+    data[i] = static_cast<float>((static_cast<int>(i) * 37 + seed * 11) % 23) / 23.0f - 0.5f;
+  }
+  return data;
+}
+
+// Reference causal attention for one new token per sequence.
+//   query : (B, 1, N * H)
+//   keys  : logical key of each sequence with shape (B, N_kv, T_b, H), where T_b = seqlens_k[b] + 1
+//   values: same layout as keys
+std::vector<float> ReferenceDecodeAttention(const std::vector<float>& query,
+                                            const std::vector<std::vector<float>>& keys,
+                                            const std::vector<std::vector<float>>& values,
+                                            const std::vector<int32_t>& seqlens_k,
+                                            int num_heads, int kv_num_heads, int head_size) {
+  const int batch_size = static_cast<int>(seqlens_k.size());
+  const int group = num_heads / kv_num_heads;
+  std::vector<float> output(static_cast<size_t>(batch_size) * num_heads * head_size, 0.0f);
+  for (int b = 0; b < batch_size; b++) {
+    const int total = seqlens_k[b] + 1;
+    for (int n = 0; n < num_heads; n++) {
+      const float* q = query.data() + (static_cast<size_t>(b) * num_heads + n) * head_size;
+      const float* k = keys[b].data() + static_cast<size_t>(n / group) * total * head_size;
+      const float* v = values[b].data() + static_cast<size_t>(n / group) * total * head_size;
+      std::vector<float> scores(total);
+      float max_score = -INFINITY;
+      for (int t = 0; t < total; t++) {
+        float dot = 0.0f;
+        for (int h = 0; h < head_size; h++) {
+          dot += q[h] * k[t * head_size + h];
+        }
+        scores[t] = dot / std::sqrt(static_cast<float>(head_size));
+        max_score = std::max(max_score, scores[t]);
+      }
+      float sum = 0.0f;
+      for (int t = 0; t < total; t++) {
+        scores[t] = std::exp(scores[t] - max_score);
+        sum += scores[t];
+      }
+      float* out = output.data() + (static_cast<size_t>(b) * num_heads + n) * head_size;
+      for (int t = 0; t < total; t++) {
+        for (int h = 0; h < head_size; h++) {
+          out[h] += scores[t] / sum * v[t * head_size + h];
+        }
+      }
+    }
+  }
+  return output;
+}
+
+// Reference rotary embedding of one token of one head, with rotary dimension head_size and the non interleaved
+// layout. The caches have shape (max_sequence_length, head_size / 2).
+void ReferenceRotateToken(const float* input, float* output, int position, const std::vector<float>& cos_cache,
+                          const std::vector<float>& sin_cache, int head_size) {
+  const int half = head_size / 2;
+  for (int i = 0; i < half; i++) {
+    const float cos = cos_cache[static_cast<size_t>(position) * half + i];
+    const float sin = sin_cache[static_cast<size_t>(position) * half + i];
+    output[i] = input[i] * cos - input[i + half] * sin;
+    output[i + half] = input[i + half] * cos + input[i] * sin;
+  }
+}
+
+// Appends the new token of each sequence to a paged kv cache with shape (num_blocks, N_kv, block_size, H), and
+// gathers the logical kv of each sequence with shape (N_kv, T_b, H), where T_b = seqlens_k[b] + 1.
+//   new_kv: (B, 1, N_kv * H)
+void AppendToPagedKVCache(const std::vector<float>& new_kv, const std::vector<int32_t>& seqlens_k,
+                          const std::vector<int32_t>& block_table, int max_blocks_per_sequence, int block_size,
+                          int kv_num_heads, int head_size, std::vector<float>& pool,
+                          std::vector<std::vector<float>>& logical_kv) {
+  const int batch_size = static_cast<int>(seqlens_k.size());
+  const size_t block_chunk = static_cast<size_t>(block_size) * head_size;
+  logical_kv.resize(batch_size);
+  for (int b = 0; b < batch_size; b++) {
+    const int total = seqlens_k[b] + 1;
+    logical_kv[b].resize(static_cast<size_t>(kv_num_heads) * total * head_size);
+    for (int n = 0; n < kv_num_heads; n++) {
+      for (int t = 0; t < total; t++) {
+        const int block = block_table[b * max_blocks_per_sequence + t / block_size];
+        const size_t pool_offset = (static_cast<size_t>(block) * kv_num_heads + n) * block_chunk +
+                                   static_cast<size_t>(t % block_size) * head_size;
+        const size_t logical_offset = (static_cast<size_t>(n) * total + t) * head_size;
+        for (int h = 0; h < head_size; h++) {
+          if (t == seqlens_k[b]) {
+            pool[pool_offset + h] = new_kv[(static_cast<size_t>(b) * kv_num_heads + n) * head_size + h];
+          }
+          logical_kv[b][logical_offset + h] = pool[pool_offset + h];
+        }
+      }
+    }
+  }
+}
+
+int8_t QuantizeKVCacheValue(float value, float scale) {
+  const float quantized = std::nearbyint(value * (1.0f / scale));
+  return static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, quantized)));
+}
+
+}  // namespace
+
+// Token generation with a paged kv cache whose blocks are scattered in the pool.
+TEST(GroupQueryAttentionTest, PagedKVCacheDecode) {
+  constexpr int batch_size = 2;
+  constexpr int num_heads = 4;
+  constexpr int kv_num_heads = 2;
+  constexpr int head_size = 8;
+  constexpr int block_size = 4;
+  constexpr int num_blocks = 6;
+  constexpr int max_blocks_per_sequence = 3;
+  const std::vector<int32_t> seqlens_k = {5, 2};  // past sequence lengths
+  const std::vector<int32_t> block_table = {4, 1, 3,
+                                            0, 5, 2};
+  const int32_t total_sequence_length = 6;
+
+  const size_t pool_size = static_cast<size_t>(num_blocks) * kv_num_heads * block_size * head_size;
+  std::vector<float> past_key = MakeData(pool_size, 1);
+  std::vector<float> past_value = MakeData(pool_size, 2);
+  std::vector<float> query = MakeData(static_cast<size_t>(batch_size) * num_heads * head_size, 3);
+  std::vector<float> key = MakeData(static_cast<size_t>(batch_size) * kv_num_heads * head_size, 4);
+  std::vector<float> value = MakeData(static_cast<size_t>(batch_size) * kv_num_heads * head_size, 5);
+
+  // Expected pool after appending the new token of each sequence, and the logical kv of each sequence.
+  std::vector<float> present_key = past_key;
+  std::vector<float> present_value = past_value;
+  std::vector<std::vector<float>> keys;
+  std::vector<std::vector<float>> values;
+  AppendToPagedKVCache(key, seqlens_k, block_table, max_blocks_per_sequence, block_size, kv_num_heads, head_size,
+                       present_key, keys);
+  AppendToPagedKVCache(value, seqlens_k, block_table, max_blocks_per_sequence, block_size, kv_num_heads, head_size,
+                       present_value, values);
+  std::vector<float> output = ReferenceDecodeAttention(query, keys, values, seqlens_k,
+                                                       num_heads, kv_num_heads, head_size);
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddAttribute<int64_t>("kv_num_heads", kv_num_heads);
+  test.AddInput<float>("query", {batch_size, 1, num_heads * head_size}, query);
+  test.AddInput<float>("key", {batch_size, 1, kv_num_heads * head_size}, key);
+  test.AddInput<float>("value", {batch_size, 1, kv_num_heads * head_size}, value);
+  test.AddInput<float>("past_key", {num_blocks, kv_num_heads, block_size, head_size}, past_key);
+  test.AddInput<float>("past_value", {num_blocks, kv_num_heads, block_size, head_size}, past_value);
+  test.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  test.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<int32_t>("block_table", {batch_size, max_blocks_per_sequence}, block_table);
+  test.AddOutput<float>("output", {batch_size, 1, num_heads * head_size}, output);
+  test.AddOutput<float>("present_key", {num_blocks, kv_num_heads, block_size, head_size}, present_key);
+  test.AddOutput<float>("present_value", {num_blocks, kv_num_heads, block_size, head_size}, present_value);
+  test.SetOutputAbsErr("output", 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Token generation with a paged kv cache on CUDA, where flash attention reads the pages through the block table.
+// The sequences span two pages and the pages are scattered in the pool.
+TEST(GroupQueryAttentionTest, PagedKVCacheDecodeCuda) {
+  if (!HasCudaEnvironment(800)) {
+    GTEST_SKIP() << "Flash attention requires CUDA with sm80 or later";
+  }
+
+  constexpr int batch_size = 2;
+  constexpr int num_heads = 4;
+  constexpr int kv_num_heads = 2;
+  constexpr int head_size = 64;
+  constexpr int block_size = 256;
+  constexpr int num_blocks = 4;
+  constexpr int max_blocks_per_sequence = 2;
+  const std::vector<int32_t> seqlens_k = {300, 10};  // past sequence lengths
+  const std::vector<int32_t> block_table = {3, 1,
+                                            0, 2};
+  const int32_t total_sequence_length = 301;
+
+  // Round the data to float16 so that the reference sees the same inputs as the kernel.
+  auto make_half_data = [](size_t count, int seed) {
+    std::vector<float> data = MakeData(count, seed);
+    for (float& v : data) {
+      v = MLFloat16(v).ToFloat();
+    }
+    return data;
+  };
+  const size_t pool_size = static_cast<size_t>(num_blocks) * kv_num_heads * block_size * head_size;
+  std::vector<float> past_key = make_half_data(pool_size, 1);
+  std::vector<float> past_value = make_half_data(pool_size, 2);
+  std::vector<float> query = make_half_data(static_cast<size_t>(batch_size) * num_heads * head_size, 3);
+  std::vector<float> key = make_half_data(static_cast<size_t>(batch_size) * kv_num_heads * head_size, 4);
+  std::vector<float> value = make_half_data(static_cast<size_t>(batch_size) * kv_num_heads * head_size, 5);
+
+  std::vector<float> present_key = past_key;
+  std::vector<float> present_value = past_value;
+  std::vector<std::vector<float>> keys;
+  std::vector<std::vector<float>> values;
+  AppendToPagedKVCache(key, seqlens_k, block_table, max_blocks_per_sequence, block_size, kv_num_heads, head_size,
+                       present_key, keys);
+  AppendToPagedKVCache(value, seqlens_k, block_table, max_blocks_per_sequence, block_size, kv_num_heads, head_size,
+                       present_value, values);
+  std::vector<float> output = ReferenceDecodeAttention(query, keys, values, seqlens_k,
+                                                       num_heads, kv_num_heads, head_size);
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddAttribute<int64_t>("kv_num_heads", kv_num_heads);
+  test.AddInput<MLFloat16>("query", {batch_size, 1, num_heads * head_size}, ToFloat16(query));
+  test.AddInput<MLFloat16>("key", {batch_size, 1, kv_num_heads * head_size}, ToFloat16(key));
+  test.AddInput<MLFloat16>("value", {batch_size, 1, kv_num_heads * head_size}, ToFloat16(value));
+  test.AddInput<MLFloat16>("past_key", {num_blocks, kv_num_heads, block_size, head_size}, ToFloat16(past_key));
+  test.AddInput<MLFloat16>("past_value", {num_blocks, kv_num_heads, block_size, head_size}, ToFloat16(past_value));
+  test.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  test.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  test.AddOptionalInputEdge<MLFloat16>();
+  test.AddOptionalInputEdge<MLFloat16>();
+  test.AddInput<int32_t>("block_table", {batch_size, max_blocks_per_sequence}, block_table);
+  test.AddOutput<MLFloat16>("output", {batch_size, 1, num_heads * head_size}, ToFloat16(output));
+  test.AddOutput<MLFloat16>("present_key", {num_blocks, kv_num_heads, block_size, head_size}, ToFloat16(present_key));
+  test.AddOutput<MLFloat16>("present_value", {num_blocks, kv_num_heads, block_size, head_size},
+                            ToFloat16(present_value));
+  test.SetOutputAbsErr("output", 0.005f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCudaExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Token generation with rotary embedding, which is applied to the query and the new key within the attention.
+TEST(GroupQueryAttentionTest, RotaryDecode) {
+  constexpr int batch_size = 2;
+  constexpr int num_heads = 4;
+  constexpr int kv_num_heads = 2;
+  constexpr int head_size = 16;
+  constexpr int past_buffer_length = 4;
+  constexpr int max_sequence_length = 8;
+  const std::vector<int32_t> seqlens_k = {3, 1};  // past sequence lengths
+  const int32_t total_sequence_length = 4;
+
+  const size_t past_size = static_cast<size_t>(batch_size) * kv_num_heads * past_buffer_length * head_size;
+  std::vector<float> past_key = MakeData(past_size, 1);
+  std::vector<float> past_value = MakeData(past_size, 2);
+  std::vector<float> query = MakeData(static_cast<size_t>(batch_size) * num_heads * head_size, 3);
+  std::vector<float> key = MakeData(static_cast<size_t>(batch_size) * kv_num_heads * head_size, 4);
+  std::vector<float> value = MakeData(static_cast<size_t>(batch_size) * kv_num_heads * head_size, 5);
+
+  std::vector<float> cos_cache(static_cast<size_t>(max_sequence_length) * head_size / 2);
+  std::vector<float> sin_cache(cos_cache.size());
+  for (int position = 0; position < max_sequence_length; position++) {
+    for (int i = 0; i < head_size / 2; i++) {
+      const float angle = position * std::pow(10000.0f, -2.0f * i / head_size);
+      cos_cache[static_cast<size_t>(position) * head_size / 2 + i] = std::cos(angle);
+      sin_cache[static_cast<size_t>(position) * head_size / 2 + i] = std::sin(angle);
+    }
+  }
+
+  // The query and the new key are rotated at the position of the new token, the past key is already rotated.
+  std::vector<float> rotated_query(query.size());
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < num_heads; n++) {
+      const size_t offset = (static_cast<size_t>(b) * num_heads + n) * head_size;
+      ReferenceRotateToken(query.data() + offset, rotated_query.data() + offset, seqlens_k[b], cos_cache, sin_cache,
+                           head_size);
+    }
+  }
+
+  std::vector<float> present_key(past_size, 0.0f);
+  std::vector<float> present_value(past_size, 0.0f);
+  std::vector<std::vector<float>> keys(batch_size);
+  std::vector<std::vector<float>> values(batch_size);
+  for (int b = 0; b < batch_size; b++) {
+    const int total = seqlens_k[b] + 1;
+    keys[b].resize(static_cast<size_t>(kv_num_heads) * total * head_size);
+    values[b].resize(keys[b].size());
+    for (int n = 0; n < kv_num_heads; n++) {
+      const size_t chunk_offset = (static_cast<size_t>(b) * kv_num_heads + n) * past_buffer_length * head_size;
+      const size_t new_offset = (static_cast<size_t>(b) * kv_num_heads + n) * head_size;
+      std::copy_n(past_key.begin() + chunk_offset, seqlens_k[b] * head_size, present_key.begin() + chunk_offset);
+      std::copy_n(past_value.begin() + chunk_offset, seqlens_k[b] * head_size, present_value.begin() + chunk_offset);
+      const size_t token_offset = chunk_offset + static_cast<size_t>(seqlens_k[b]) * head_size;
+      ReferenceRotateToken(key.data() + new_offset, present_key.data() + token_offset, seqlens_k[b], cos_cache,
+                           sin_cache, head_size);
+      std::copy_n(value.begin() + new_offset, head_size, present_value.begin() + token_offset);
+
+      std::copy_n(present_key.begin() + chunk_offset, total * head_size,
+                  keys[b].begin() + static_cast<size_t>(n) * total * head_size);
+      std::copy_n(present_value.begin() + chunk_offset, total * head_size,
+                  values[b].begin() + static_cast<size_t>(n) * total * head_size);
+    }
+  }
+  std::vector<float> output = ReferenceDecodeAttention(rotated_query, keys, values, seqlens_k,
+                                                       num_heads, kv_num_heads, head_size);
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddAttribute<int64_t>("kv_num_heads", kv_num_heads);
+  test.AddAttribute<int64_t>("do_rotary", 1);
+  test.AddInput<float>("query", {batch_size, 1, num_heads * head_size}, query);
+  test.AddInput<float>("key", {batch_size, 1, kv_num_heads * head_size}, key);
+  test.AddInput<float>("value", {batch_size, 1, kv_num_heads * head_size}, value);
+  test.AddInput<float>("past_key", {batch_size, kv_num_heads, past_buffer_length, head_size}, past_key);
+  test.AddInput<float>("past_value", {batch_size, kv_num_heads, past_buffer_length, head_size}, past_value);
+  test.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  test.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  test.AddInput<float>("cos_cache", {max_sequence_length, head_size / 2}, cos_cache);
+  test.AddInput<float>("sin_cache", {max_sequence_length, head_size / 2}, sin_cache);
+  test.AddOutput<float>("output", {batch_size, 1, num_heads * head_size}, output);
+  test.AddOutput<float>("present_key", {batch_size, kv_num_heads, past_buffer_length, head_size}, present_key);
+  test.AddOutput<float>("present_value", {batch_size, kv_num_heads, past_buffer_length, head_size}, present_value);
+  test.SetOutputAbsErr("output", 0.0001f);
+  test.SetOutputAbsErr("present_key", 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Prompt with a local window, longer than a block of the rows computed over the band of keys they attend to.
+TEST(GroupQueryAttentionTest, LocalWindowPrompt) {
+  constexpr int num_heads = 2;
+  constexpr int kv_num_heads = 1;
+  constexpr int head_size = 8;
+  constexpr int sequence_length = 80;
+  constexpr int local_window_size = 16;
+
+  std::vector<float> query = MakeData(static_cast<size_t>(sequence_length) * num_heads * head_size, 1);
+  std::vector<float> key = MakeData(static_cast<size_t>(sequence_length) * kv_num_heads * head_size, 2);
+  std::vector<float> value = MakeData(static_cast<size_t>(sequence_length) * kv_num_heads * head_size, 3);
+
+  // Each token attends to itself and to the local_window_size tokens before it.
+  std::vector<float> output(query.size(), 0.0f);
+  for (int s = 0; s < sequence_length; s++) {
+    for (int n = 0; n < num_heads; n++) {
+      const float* q = query.data() + (static_cast<size_t>(s) * num_heads + n) * head_size;
+      const int first = std::max(0, s - local_window_size);
+      std::vector<float> scores(s + 1 - first);
+      float max_score = -INFINITY;
+      for (int t = first; t <= s; t++) {
+        float dot = 0.0f;
+        for (int h = 0; h < head_size; h++) {
+          dot += q[h] * key[static_cast<size_t>(t) * head_size + h];
+        }
+        scores[t - first] = dot / std::sqrt(static_cast<float>(head_size));
+        max_score = std::max(max_score, scores[t - first]);
+      }
+      float sum = 0.0f;
+      for (float& score : scores) {
+        score = std::exp(score - max_score);
+        sum += score;
+      }
+      float* out = output.data() + (static_cast<size_t>(s) * num_heads + n) * head_size;
+      for (int t = first; t <= s; t++) {
+        for (int h = 0; h < head_size; h++) {
+          out[h] += scores[t - first] / sum * value[static_cast<size_t>(t) * head_size + h];
+        }
+      }
+    }
+  }
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddAttribute<int64_t>("kv_num_heads", kv_num_heads);
+  test.AddAttribute<int64_t>("local_window_size", local_window_size);
+  test.AddInput<float>("query", {1, sequence_length, num_heads * head_size}, query);
+  test.AddInput<float>("key", {1, sequence_length, kv_num_heads * head_size}, key);
+  test.AddInput<float>("value", {1, sequence_length, kv_num_heads * head_size}, value);
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<int32_t>("seqlens_k", {1}, {sequence_length - 1});
+  test.AddInput<int32_t>("total_sequence_length", {1}, {sequence_length});
+  test.AddOutput<float>("output", {1, sequence_length, num_heads * head_size}, output);
+  // with a single kv head, the present kv in BNSH layout is the input kv
+  test.AddOutput<float>("present_key", {1, kv_num_heads, sequence_length, head_size}, key);
+  test.AddOutput<float>("present_value", {1, kv_num_heads, sequence_length, head_size}, value);
+  test.SetOutputAbsErr("output", 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Token generation with an int8 kv cache, with a scale per kv head for the key and a shared scale for the value.
+TEST(GroupQueryAttentionTest, Int8KVCacheDecode) {
+  constexpr int batch_size = 2;
+  constexpr int num_heads = 4;
+  constexpr int kv_num_heads = 2;
+  constexpr int head_size = 16;
+  constexpr int past_buffer_length = 4;
+  const std::vector<int32_t> seqlens_k = {3, 1};  // past sequence lengths
+  const int32_t total_sequence_length = 4;
+  const std::vector<float> k_scale = {0.004f, 0.005f};
+  const std::vector<float> v_scale = {0.0045f};
+
+  const size_t past_size = static_cast<size_t>(batch_size) * kv_num_heads * past_buffer_length * head_size;
+  const size_t chunk_length = static_cast<size_t>(past_buffer_length) * head_size;
+  std::vector<float> past_key_float = MakeData(past_size, 1);
+  std::vector<float> past_value_float = MakeData(past_size, 2);
+  std::vector<int8_t> past_key(past_size);
+  std::vector<int8_t> past_value(past_size);
+  for (size_t i = 0; i < past_size; i++) {
+    const int kv_head_index = static_cast<int>(i / chunk_length) % kv_num_heads;
+    past_key[i] = QuantizeKVCacheValue(past_key_float[i], k_scale[kv_head_index]);
+    past_value[i] = QuantizeKVCacheValue(past_value_float[i], v_scale[0]);
+  }
+  std::vector<float> query = MakeData(static_cast<size_t>(batch_size) * num_heads * head_size, 3);
+  std::vector<float> key = MakeData(static_cast<size_t>(batch_size) * kv_num_heads * head_size, 4);
+  std::vector<float> value = MakeData(static_cast<size_t>(batch_size) * kv_num_heads * head_size, 5);
+
+  // The new key and value are quantized into the present buffers, and the attention uses the dequantized cache.
+  std::vector<int8_t> present_key(past_size, 0);
+  std::vector<int8_t> present_value(past_size, 0);
+  std::vector<std::vector<float>> keys(batch_size);
+  std::vector<std::vector<float>> values(batch_size);
+  for (int b = 0; b < batch_size; b++) {
+    const int total = seqlens_k[b] + 1;
+    keys[b].resize(static_cast<size_t>(kv_num_heads) * total * head_size);
+    values[b].resize(keys[b].size());
+    for (int n = 0; n < kv_num_heads; n++) {
+      const size_t chunk_offset = (static_cast<size_t>(b) * kv_num_heads + n) * chunk_length;
+      const size_t new_offset = (static_cast<size_t>(b) * kv_num_heads + n) * head_size;
+      std::copy_n(past_key.begin() + chunk_offset, seqlens_k[b] * head_size, present_key.begin() + chunk_offset);
+      std::copy_n(past_value.begin() + chunk_offset, seqlens_k[b] * head_size, present_value.begin() + chunk_offset);
+      const size_t token_offset = chunk_offset + static_cast<size_t>(seqlens_k[b]) * head_size;
+      for (int h = 0; h < head_size; h++) {
+        present_key[token_offset + h] = QuantizeKVCacheValue(key[new_offset + h], k_scale[n]);
+        present_value[token_offset + h] = QuantizeKVCacheValue(value[new_offset + h], v_scale[0]);
+      }
+
+      for (int j = 0; j < total * head_size; j++) {
+        const size_t index = static_cast<size_t>(n) * total * head_size + j;
+        keys[b][index] = k_scale[n] * present_key[chunk_offset + j];
+        values[b][index] = v_scale[0] * present_value[chunk_offset + j];
+      }
+    }
+  }
+  std::vector<float> output = ReferenceDecodeAttention(query, keys, values, seqlens_k,
+                                                       num_heads, kv_num_heads, head_size);
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddAttribute<int64_t>("kv_num_heads", kv_num_heads);
+  test.AddInput<float>("query", {batch_size, 1, num_heads * head_size}, query);
+  test.AddInput<float>("key", {batch_size, 1, kv_num_heads * head_size}, key);
+  test.AddInput<float>("value", {batch_size, 1, kv_num_heads * head_size}, value);
+  test.AddInput<int8_t>("past_key", {batch_size, kv_num_heads, past_buffer_length, head_size}, past_key);
+  test.AddInput<int8_t>("past_value", {batch_size, kv_num_heads, past_buffer_length, head_size}, past_value);
+  test.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  test.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<int32_t>();
+  test.AddInput<float>("k_scale", {kv_num_heads}, k_scale);
+  test.AddInput<float>("v_scale", {1}, v_scale);
+  test.AddOutput<float>("output", {batch_size, 1, num_heads * head_size}, output);
+  test.AddOutput<int8_t>("present_key", {batch_size, kv_num_heads, past_buffer_length, head_size}, present_key);
+  test.AddOutput<int8_t>("present_value", {batch_size, kv_num_heads, past_buffer_length, head_size}, present_value);
+  test.SetOutputAbsErr("output", 0.0001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(GroupQueryAttentionTest, PagedKVCacheBlockOutOfRange) {
+  constexpr int num_heads = 2;
+  constexpr int kv_num_heads = 1;
+  constexpr int head_size = 8;
+  constexpr int block_size = 2;
+  constexpr int num_blocks = 2;
+
+  OpTester test("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<int64_t>("num_heads", num_heads);
+  test.AddAttribute<int64_t>("kv_num_heads", kv_num_heads);
+  test.AddInput<float>("query", {1, 1, num_heads * head_size}, MakeData(num_heads * head_size, 1));
+  test.AddInput<float>("key", {1, 1, kv_num_heads * head_size}, MakeData(kv_num_heads * head_size, 2));
+  test.AddInput<float>("value", {1, 1, kv_num_heads * head_size}, MakeData(kv_num_heads * head_size, 3));
+  test.AddInput<float>("past_key", {num_blocks, kv_num_heads, block_size, head_size},
+                       MakeData(num_blocks * kv_num_heads * block_size * head_size, 4));
+  test.AddInput<float>("past_value", {num_blocks, kv_num_heads, block_size, head_size},
+                       MakeData(num_blocks * kv_num_heads * block_size * head_size, 5));
+  test.AddInput<int32_t>("seqlens_k", {1}, {2});
+  test.AddInput<int32_t>("total_sequence_length", {1}, {3});
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<int32_t>("block_table", {1, 2}, {1, 7});
+  test.AddOutput<float>("output", {1, 1, num_heads * head_size}, std::vector<float>(num_heads * head_size));
+  test.AddOutput<float>("present_key", {num_blocks, kv_num_heads, block_size, head_size},
+                        std::vector<float>(num_blocks * kv_num_heads * block_size * head_size));
+  test.AddOutput<float>("present_value", {num_blocks, kv_num_heads, block_size, head_size},
+                        std::vector<float>(num_blocks * kv_num_heads * block_size * head_size));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectFailure, "is out of range", {}, nullptr, &execution_providers);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -241,6 +241,182 @@ TEST(MatMulNBits, Float32) {
   }
 }
 
+#if !defined(ORT_NEURAL_SPEED)
+// 2b, 3b and 4b quantization. B, scales and zero points are generated directly in the packed layout described by the
+// MatMulNBits spec: values are packed into a little endian bit stream per block, zero points per column of B.
+// With has_epilogue, the bias, activation and residual inputs of MatMulNBits are tested as well.
+// With num_lora_adapters > 0, the rows of A use LoRA adapters of rank 4 selected by lora_index, or none.
+void RunLowBitsTest(int64_t M, int64_t N, int64_t K, int64_t block_size, int64_t bits,
+                    bool has_zeropoint, bool b_is_initializer, bool has_epilogue = false,
+                    int64_t num_lora_adapters = 0) {
+  RandomValueGenerator random{1234};
+  const int64_t k_blocks = (K + block_size - 1) / block_size;
+  const int64_t blob_size = block_size * bits / 8;
+  const int64_t zp_bytes_per_column = (k_blocks * bits + 7) / 8;
+
+  auto pack_bits = [bits](std::vector<uint8_t>& dst, size_t offset, size_t idx, int value) {
+    const size_t bit = idx * static_cast<size_t>(bits);
+    const uint32_t shifted = static_cast<uint32_t>(value) << (bit % 8);
+    dst[offset + bit / 8] |= static_cast<uint8_t>(shifted & 0xFF);
+    if ((shifted >> 8) != 0) {
+      dst[offset + bit / 8 + 1] |= static_cast<uint8_t>(shifted >> 8);
+    }
+  };
+
+  const int max_q = (1 << bits) - 1;
+  std::vector<float> a = random.Uniform<float>(std::vector<int64_t>{M, K}, -1.0f, 1.0f);
+  std::vector<float> scales = random.Uniform<float>(std::vector<int64_t>{N, k_blocks}, 0.01f, 0.1f);
+  std::vector<int> q_vals = random.Uniform<int>(std::vector<int64_t>{N, k_blocks * block_size}, 0, max_q + 1);
+  std::vector<int> zp_vals = has_zeropoint ? random.Uniform<int>(std::vector<int64_t>{N, k_blocks}, 0, max_q + 1)
+                                           : std::vector<int>(N * k_blocks, 1 << (bits - 1));
+
+  std::vector<uint8_t> b(N * k_blocks * blob_size, 0);
+  std::vector<uint8_t> zp(N * zp_bytes_per_column, 0);
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t i = 0; i < k_blocks * block_size; i++) {
+      pack_bits(b, 0, n * k_blocks * block_size + i, q_vals[n * k_blocks * block_size + i]);
+    }
+    for (int64_t kb = 0; kb < k_blocks; kb++) {
+      pack_bits(zp, n * zp_bytes_per_column, kb, zp_vals[n * k_blocks + kb]);
+    }
+  }
+
+  std::vector<float> expected_vals(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        const int64_t kb = k / block_size;
+        const float b_val = scales[n * k_blocks + kb] *
+                            static_cast<float>(q_vals[n * k_blocks * block_size + k] - zp_vals[n * k_blocks + kb]);
+        sum += a[m * K + k] * b_val;
+      }
+      expected_vals[m * N + n] = sum;
+    }
+  }
+
+  // LoRA: Y += (A * lora_a[i]) * lora_b[i]
+  constexpr int64_t lora_rank = 4;
+  std::vector<float> lora_a, lora_b;
+  std::vector<int32_t> lora_index;
+  if (num_lora_adapters > 0) {
+    lora_a = random.Uniform<float>(std::vector<int64_t>{num_lora_adapters, K, lora_rank}, -1.0f, 1.0f);
+    lora_b = random.Uniform<float>(std::vector<int64_t>{num_lora_adapters, lora_rank, N}, -1.0f, 1.0f);
+    for (int64_t m = 0; m < M; m++) {
+      const int32_t adapter = static_cast<int32_t>(m % (num_lora_adapters + 1)) - 1;
+      lora_index.push_back(adapter);
+      if (adapter < 0) {
+        continue;
+      }
+      for (int64_t r = 0; r < lora_rank; r++) {
+        float a_lora_a = 0.0f;
+        for (int64_t k = 0; k < K; k++) {
+          a_lora_a += a[m * K + k] * lora_a[(adapter * K + k) * lora_rank + r];
+        }
+        for (int64_t n = 0; n < N; n++) {
+          expected_vals[m * N + n] += a_lora_a * lora_b[(adapter * lora_rank + r) * N + n];
+        }
+      }
+    }
+  }
+
+  // epilogue: Y = LeakyRelu(A * B + bias) + residual
+  constexpr float leaky_relu_alpha = 0.1f;
+  std::vector<float> bias, residual;
+  if (has_epilogue) {
+    bias = random.Uniform<float>(std::vector<int64_t>{N}, -1.0f, 1.0f);
+    residual = random.Uniform<float>(std::vector<int64_t>{M, N}, -1.0f, 1.0f);
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        float& y = expected_vals[m * N + n];
+        y += bias[n];
+        y = (y >= 0.0f ? y : y * leaky_relu_alpha) + residual[m * N + n];
+      }
+    }
+  }
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", bits);
+  test.AddAttribute<int64_t>("accuracy_level", int64_t{0});
+  test.AddInput<float>("A", {M, K}, a, false);
+  test.AddInput<uint8_t>("B", {N, k_blocks, blob_size}, b, b_is_initializer);
+  test.AddInput<float>("scales", {N * k_blocks}, scales, true);
+  if (has_zeropoint) {
+    test.AddInput<uint8_t>("zero_points", {N * zp_bytes_per_column}, zp, true);
+  } else if (has_epilogue || num_lora_adapters > 0) {
+    test.AddOptionalInputEdge<uint8_t>();
+  }
+  if (has_epilogue) {
+    test.AddAttribute<std::string>("activation", "LeakyRelu");
+    test.AddAttribute<std::vector<float>>("activation_params", {leaky_relu_alpha});
+    test.AddOptionalInputEdge<int32_t>();
+    test.AddInput<float>("bias", {N}, bias, true);
+    test.AddInput<float>("residual", {M, N}, residual, false);
+  } else if (num_lora_adapters > 0) {
+    test.AddOptionalInputEdge<int32_t>();
+    test.AddOptionalInputEdge<float>();
+    test.AddOptionalInputEdge<float>();
+  }
+  if (num_lora_adapters > 0) {
+    test.AddInput<float>("lora_a", {num_lora_adapters, K, lora_rank}, lora_a, false);
+    test.AddInput<float>("lora_b", {num_lora_adapters, lora_rank, N}, lora_b, false);
+    test.AddInput<int32_t>("lora_index", {M}, lora_index, false);
+  }
+  test.AddOutput<float>("Y", {M, N}, expected_vals);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MatMulNBits, Float32LowBits) {
+  for (auto bits : {2, 3}) {
+    for (auto M : {1, 2, 100}) {
+      for (auto N : {1, 32, 288}) {
+        for (auto K : {16, 93, 256}) {
+          for (auto block_size : {16, 32, 64, 128}) {
+            RunLowBitsTest(M, N, K, block_size, bits, false, true);
+            RunLowBitsTest(M, N, K, block_size, bits, true, true);
+            RunLowBitsTest(M, N, K, block_size, bits, true, false);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(MatMulNBits, Float32Epilogue) {
+  for (auto bits : {2, 4}) {
+    for (auto M : {1, 2, 100}) {
+      for (auto N : {1, 32, 288}) {
+        for (auto K : {16, 93}) {
+          for (auto block_size : {16, 32}) {
+            RunLowBitsTest(M, N, K, block_size, bits, false, true, true);
+            RunLowBitsTest(M, N, K, block_size, bits, true, false, true);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(MatMulNBits, Float32LoraAdapters) {
+  for (auto bits : {2, 4}) {
+    for (auto M : {1, 3, 100}) {
+      for (auto N : {1, 32, 288}) {
+        for (auto K : {16, 93}) {
+          RunLowBitsTest(M, N, K, 16, bits, false, true, false, 2);
+          RunLowBitsTest(M, N, K, 32, bits, true, false, true, 3);
+        }
+      }
+    }
+  }
+}
+#endif  // !defined(ORT_NEURAL_SPEED)
+
 #if defined(USE_CUDA) || defined(USE_DML)
 TEST(MatMulNBits, Float16) {
 #ifdef USE_CUDA
@@ -19,7 +19,9 @@ static void RunMoETest(const std::vector<float>& input, const std::vector<float>
   int min_cuda_architecture = use_float16 ? 700 : 0;
 
   bool enable_cuda = HasCudaEnvironment(min_cuda_architecture);
-  if (enable_cuda) {
+  // The CPU kernel only supports float.
+  bool enable_cpu = !use_float16;
+  if (enable_cuda || enable_cpu) {
     OpTester tester("MoE", 1, onnxruntime::kMSDomain);
     tester.AddAttribute<int64_t>("k", static_cast<int64_t>(top_k));
     tester.AddAttribute<std::string>("activation_type", activation_type);
@@ -77,7 +79,12 @@ static void RunMoETest(const std::vector<float>& input, const std::vector<float>
     }
 
     std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
-    execution_providers.push_back(DefaultCudaExecutionProvider());
+    if (enable_cuda) {
+      execution_providers.push_back(DefaultCudaExecutionProvider());
+    }
+    if (enable_cpu) {
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+    }
     tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   }
 }
@@ -1266,6 +1273,47 @@ TEST(MoETest, QMoETest_Mixtral_Int4) {
               1, /*normalize_routing_weights*/
               2 /*top_k*/);
 }
+
+// The CPU kernel takes float inputs and 4-bit weights stored row by row, two columns per byte with the even column in
+// the low nibble, with an implicit zero point of 8.
+TEST(MoETest, QMoETest_CPU_Int4) {
+  const int num_rows = 3;
+  const int num_experts = 2;
+  const int hidden_size = 2;
+  const int inter_size = 2;
+
+  // expert 0 computes the identity. The FC1 weights of expert 1 are [[0, -1], [1, 0]] and its FC2 weights are 2 * I.
+  const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f, 1.0f, 1.0f};
+  const std::vector<float> router_probs = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+  const std::vector<uint8_t> fc1_experts_weights = {0x89, 0x98, 0x78, 0x89};
+  const std::vector<float> fc1_scales = {1.0f, 1.0f, 1.0f, 1.0f};
+  const std::vector<uint8_t> fc2_experts_weights = {0x89, 0x98, 0x89, 0x98};
+  const std::vector<float> fc2_scales = {1.0f, 1.0f, 2.0f, 2.0f};
+  const std::vector<float> fc2_experts_bias = {0.0f, 0.0f, 0.5f, 0.5f};
+  const std::vector<float> output = {1.94129f, 1.59659f, 7.02082f, 1.44129f, 1.75f, 0.75f};
+
+  OpTester tester("QMoE", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("k", 2);
+  tester.AddAttribute<std::string>("activation_type", "relu");
+  tester.AddAttribute<int64_t>("normalize_routing_weights", 1);
+
+  tester.AddInput<float>("input", {num_rows, hidden_size}, input);
+  tester.AddInput<float>("router_probs", {num_rows, num_experts}, router_probs);
+  tester.AddInput<uint8_t>("fc1_experts_weights", {num_experts, hidden_size, inter_size / 2}, fc1_experts_weights,
+                           true);
+  tester.AddInput<float>("fc1_scales", {num_experts, inter_size}, fc1_scales, true);
+  tester.AddOptionalInputEdge<float>();  // fc1_experts_bias
+  tester.AddInput<uint8_t>("fc2_experts_weights", {num_experts, inter_size, hidden_size / 2}, fc2_experts_weights,
+                           true);
+  tester.AddInput<float>("fc2_scales", {num_experts, hidden_size}, fc2_scales, true);
+  tester.AddInput<float>("fc2_experts_bias", {num_experts, hidden_size}, fc2_experts_bias);
+  tester.AddOutput<float>("output", {num_rows, hidden_size}, output);
+  tester.SetOutputTolerance(0.001f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
 #endif
 
 }  // namespace test
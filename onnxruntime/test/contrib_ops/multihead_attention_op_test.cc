@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
+
 #include "core/platform/env_var_utils.h"
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
@@ -582,6 +585,87 @@ TEST(MultiHeadAttentionTest, SelfAttention_WithPastAndPresent_NoMask_NoRelPosBia
   RunMultiHeadAttentionTests(data, /*disable_cpu=*/false, /*disable_cuda=*/true);
 }
 
+// The CPU kernel processes the attention of sequences longer than its block size in blocks, with an online softmax.
+// Compare it with a reference computed from the full attention probs, with and without the tiled kernel.
+TEST(MultiHeadAttentionTest, SelfAttention_LongSequence_Mask2D_CPU) {
+  constexpr int batch_size = 2;
+  constexpr int sequence_length = 300;
+  constexpr int num_heads = 2;
+  constexpr int head_size = 8;
+  constexpr int hidden_size = num_heads * head_size;
+  constexpr float mask_filter_value = -10000.0f;
+
+  RandomValueGenerator random{123};
+  std::vector<int64_t> input_dims = {batch_size, sequence_length, hidden_size};
+  std::vector<float> query_data = random.Uniform<float>(input_dims, -1.0f, 1.0f);
+  std::vector<float> key_data = random.Uniform<float>(input_dims, -1.0f, 1.0f);
+  std::vector<float> value_data = random.Uniform<float>(input_dims, -1.0f, 1.0f);
+
+  // The second sequence is right side padded.
+  std::vector<int64_t> mask_dims = {batch_size, sequence_length};
+  std::vector<int32_t> mask_data(batch_size * sequence_length, 1);
+  std::fill(mask_data.begin() + sequence_length + 250, mask_data.end(), 0);
+
+  for (bool unidirectional : {false, true}) {
+    std::vector<float> output_data(batch_size * sequence_length * hidden_size);
+    for (int b = 0; b < batch_size; b++) {
+      for (int n = 0; n < num_heads; n++) {
+        for (int s = 0; s < sequence_length; s++) {
+          const float* q = query_data.data() + (b * sequence_length + s) * hidden_size + n * head_size;
+          std::vector<float> probs(sequence_length);
+          for (int t = 0; t < sequence_length; t++) {
+            const float* k = key_data.data() + (b * sequence_length + t) * hidden_size + n * head_size;
+            float score = 0.0f;
+            for (int h = 0; h < head_size; h++) {
+              score += q[h] * k[h];
+            }
+            const bool masked = mask_data[b * sequence_length + t] == 0 || (unidirectional && t > s);
+            probs[t] = score / std::sqrt(static_cast<float>(head_size)) + (masked ? mask_filter_value : 0.0f);
+          }
+
+          const float max = *std::max_element(probs.begin(), probs.end());
+          float sum = 0.0f;
+          for (auto& p : probs) {
+            p = std::exp(p - max);
+            sum += p;
+          }
+
+          float* out = output_data.data() + (b * sequence_length + s) * hidden_size + n * head_size;
+          for (int t = 0; t < sequence_length; t++) {
+            const float* v = value_data.data() + (b * sequence_length + t) * hidden_size + n * head_size;
+            for (int h = 0; h < head_size; h++) {
+              out[h] += probs[t] / sum * v[h];
+            }
+          }
+        }
+      }
+    }
+
+    for (const char* disable_flash_attention : {"0", "1"}) {
+      ScopedEnvironmentVariables scoped_env_vars{
+          EnvVarMap{{onnxruntime::contrib::attention::kDisableFlashAttention, disable_flash_attention}}};
+
+      OpTester tester("MultiHeadAttention", 1, onnxruntime::kMSDomain);
+      tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(num_heads));
+      tester.AddAttribute<float>("mask_filter_value", mask_filter_value);
+      tester.AddAttribute<int64_t>("unidirectional", unidirectional ? 1 : 0);
+      tester.AddInput<float>("query", input_dims, query_data);
+      tester.AddInput<float>("key", input_dims, key_data);
+      tester.AddInput<float>("value", input_dims, value_data);
+      tester.AddOptionalInputEdge<float>();
+      tester.AddInput<int32_t>("key_padding_mask", mask_dims, mask_data);
+
+      constexpr float rel_error = 0.0f;
+      constexpr float abs_error = 0.001f;
+      tester.AddOutput<float>("output", input_dims, output_data, /*sort*/ false, rel_error, abs_error);
+
+      std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+      tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+    }
+  }
+}
+
 // This test is disabled since it is not used in Whisper anymore, and it fails in ROCm.
 TEST(MultiHeadAttentionTest, DISABLED_CrossAttention_WithPastPassedInDirectly_NoMask) {
   // Whisper decoder cross attention with past_kv in place of current KV and no present_kv
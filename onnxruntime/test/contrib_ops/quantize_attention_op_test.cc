@@ -389,6 +389,57 @@ TEST(QAttentionTest, QAttentionBatch1) {
                    batch_size, sequence_length, hidden_size, number_of_heads);
 }
 
+// The attention core computed in int8 from the calibrated scales of Q, K and V is close to the float one.
+TEST(QAttentionTest, QAttentionQuantizedCore) {
+  int batch_size = 1;
+  int sequence_length = 2;
+  int hidden_size = 4;
+  int number_of_heads = 2;
+
+  std::vector<float> input_data = {
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f};
+
+  std::vector<float> weight_data = {
+      0.1f, -0.2f, 0.3f, 1.0f, 1.1f, 0.3f, 0.5f, 0.2f, 0.3f, -0.6f, 1.5f, 2.0f,
+      0.5f, 0.1f, 0.4f, 1.6f, 1.0f, 2.0f, 0.4f, 0.8f, 0.9f, 0.1f, -1.3f, 0.7f,
+      0.3f, 0.2f, 4.0f, 2.2f, 1.6f, 1.1f, 0.7f, 0.2f, 0.4f, 1.0f, 1.2f, 0.5f,
+      0.2f, 0.1f, 0.4f, 1.6f, 2.4f, 3.3f, 2.1f, 4.2f, 8.4f, 0.0f, 2.1f, 3.2f};
+
+  std::vector<float> bias_data = {
+      -0.5f, 0.6f, 1.2f, 2.1f, 0.5f, 0.7f, 0.2f, 1.2f, 0.5f, 0.4f, 0.3f, 1.2f};
+
+  // Q, K and V are quantized to their absolute maximums.
+  std::vector<float> qkv_scale_data = {3.7f / 127, 5.16f / 127, 8.69f / 127};
+
+  std::vector<float> output_data = {
+      3.1495983600616455f, 0.10843668878078461f, 4.25f, 5.6499996185302734f,
+      3.9696791172027588f, 0.073143675923347473f, 4.2499995231628418f, 5.6499991416931152f};
+
+  quantization::Params<uint8_t> quant_params(/*scale=*/0.1f, /*zero_point=*/128);
+
+  OpTester tester("QAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(number_of_heads));
+  tester.AddInput<uint8_t>("input", {batch_size, sequence_length, hidden_size},
+                           QuantizeTestVector<uint8_t>(input_data, quant_params));
+  tester.AddInput<uint8_t>("weight", {hidden_size, 3 * hidden_size},
+                           QuantizeTestVector<uint8_t>(weight_data, quant_params));
+  tester.AddInput<float>("bias", {3 * hidden_size}, bias_data);
+  tester.AddInput<float>("input_scale", {1}, {quant_params.scale});
+  tester.AddInput<float>("weight_scale", {1}, {quant_params.scale});
+  tester.AddInput<int32_t>("mask_index", {batch_size}, {2});
+  tester.AddInput<uint8_t>("input_zero_point", {1}, {quant_params.zero_point});
+  tester.AddInput<uint8_t>("weight_zero_point", {1}, {quant_params.zero_point});
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<float>("qkv_scale", {3}, qkv_scale_data);
+  tester.AddOutput<float>("output", {batch_size, sequence_length, hidden_size}, output_data);
+  tester.SetOutputTolerance(0.1f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 TEST(QAttentionTest, QAttentionBatch1_Float16) {
   int batch_size = 1;
   int sequence_length = 2;
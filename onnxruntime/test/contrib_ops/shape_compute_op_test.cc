@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+// [X.dim0 * X.dim1, Y.dim1 / 2, -1] from a float and an int64 input.
+TEST(ShapeComputeTest, Dims) {
+  OpTester test("ShapeCompute", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Dim", "Dim", "Mul", "Dim", "Const", "Div", "Const"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 0, 0, 1, 0, 1, 1, 1, 2, -1, 3, 4, -1, -1});
+  test.AddAttribute("outputs", std::vector<int64_t>{2, 5, 6});
+  test.AddInput<float>("X", {2, 3, 4}, std::vector<float>(24, 1.f));
+  test.AddInput<int64_t>("Y", {1, 6}, std::vector<int64_t>(6, 0));
+  test.AddOutput<int64_t>("Z", {3}, {6, 3, -1});
+  test.Run();
+}
+
+TEST(ShapeComputeTest, Scalar) {
+  OpTester test("ShapeCompute", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Dim", "Const", "Sub"});
+  test.AddAttribute("operands", std::vector<int64_t>{0, 1, 1, -1, 0, 1});
+  test.AddAttribute("outputs", std::vector<int64_t>{2});
+  test.AddAttribute("scalar", static_cast<int64_t>(1));
+  test.AddInput<float>("X", {2, 5}, std::vector<float>(10, 1.f));
+  test.AddOutput<int64_t>("Z", {}, {4});
+  test.Run();
+}
+
+TEST(ShapeComputeTest, DivisionByZero) {
+  OpTester test("ShapeCompute", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("ops", std::vector<std::string>{"Const", "Dim", "Div"});
+  test.AddAttribute("operands", std::vector<int64_t>{4, -1, 0, 0, 0, 1});
+  test.AddAttribute("outputs", std::vector<int64_t>{2});
+  test.AddInput<float>("X", {0, 5}, {});
+  test.AddOutput<int64_t>("Z", {1}, {0});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "division by zero");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
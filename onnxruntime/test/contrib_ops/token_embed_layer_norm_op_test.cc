@@ -0,0 +1,159 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+constexpr float kEpsilon = 1e-5f;
+
+// The rows of embeddings normalized with LayerNormalization, or RMSNorm if simplified.
+std::vector<float> Normalize(const std::vector<float>& embeddings, const std::vector<float>& gamma,
+                             const std::vector<float>& beta, bool simplified) {
+  const size_t hidden_size = gamma.size();
+  std::vector<float> output(embeddings.size());
+  for (size_t row = 0; row < embeddings.size() / hidden_size; ++row) {
+    const float* x = embeddings.data() + row * hidden_size;
+    double mean = 0.0;
+    double mean_square = 0.0;
+    for (size_t h = 0; h < hidden_size; ++h) {
+      mean += x[h];
+      mean_square += x[h] * x[h];
+    }
+    mean = simplified ? 0.0 : mean / hidden_size;
+    const double std_dev = std::sqrt(mean_square / hidden_size - mean * mean + kEpsilon);
+    for (size_t h = 0; h < hidden_size; ++h) {
+      output[row * hidden_size + h] =
+          static_cast<float>((x[h] - mean) / std_dev * gamma[h] + (simplified ? 0.0f : beta[h]));
+    }
+  }
+  return output;
+}
+
+std::vector<float> MakeValues(size_t size, int seed) {
+  std::vector<float> values(size);
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = static_cast<float>((i * 7 + seed) % 23) * 0.125f - 1.25f;
+  }
+  return values;
+}
+
+}  // namespace
+
+static void RunFloatTableTest(bool simplified, bool with_positions) {
+  const int64_t vocab_size = 11;
+  const int64_t hidden_size = 8;
+  const float scale = 2.0f;
+  const std::vector<int64_t> input_ids{3, 0, 10, 3, 7, 1};
+  const std::vector<int64_t> position_ids{0, 1, 2, 0, 1, 2};
+  const std::vector<float> embedding = MakeValues(vocab_size * hidden_size, 1);
+  const std::vector<float> position_embedding = MakeValues(3 * hidden_size, 5);
+  const std::vector<float> gamma = MakeValues(hidden_size, 3);
+  const std::vector<float> beta = MakeValues(hidden_size, 4);
+
+  std::vector<float> embedding_sum;
+  for (size_t t = 0; t < input_ids.size(); ++t) {
+    for (int64_t h = 0; h < hidden_size; ++h) {
+      float value = embedding[input_ids[t] * hidden_size + h] * scale;
+      if (with_positions) {
+        value += position_embedding[position_ids[t] * hidden_size + h];
+      }
+      embedding_sum.push_back(value);
+    }
+  }
+
+  OpTester test("TokenEmbedLayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("epsilon", kEpsilon);
+  test.AddAttribute("scale", scale);
+  test.AddAttribute("simplified", static_cast<int64_t>(simplified ? 1 : 0));
+  test.AddInput<int64_t>("input_ids", {2, 3}, input_ids);
+  test.AddInput<float>("embedding", {vocab_size, hidden_size}, embedding);
+  test.AddInput<float>("gamma", {hidden_size}, gamma);
+  if (simplified) {
+    test.AddOptionalInputEdge<float>();
+  } else {
+    test.AddInput<float>("beta", {hidden_size}, beta);
+  }
+  test.AddOptionalInputEdge<float>();
+  test.AddOptionalInputEdge<uint8_t>();
+  if (with_positions) {
+    test.AddInput<int64_t>("position_ids", {2, 3}, position_ids);
+    test.AddInput<float>("position_embedding", {3, hidden_size}, position_embedding);
+  }
+  test.AddOutput<float>("output", {2, 3, hidden_size}, Normalize(embedding_sum, gamma, beta, simplified), false,
+                        1e-5f, 1e-4f);
+  test.AddOutput<float>("embedding_sum", {2, 3, hidden_size}, embedding_sum);
+  test.Run();
+}
+
+TEST(TokenEmbedLayerNormTest, LayerNorm) {
+  RunFloatTableTest(false, false);
+}
+
+TEST(TokenEmbedLayerNormTest, SimplifiedWithPositions) {
+  RunFloatTableTest(true, true);
+}
+
+TEST(TokenEmbedLayerNormTest, QuantizedTable) {
+  // 2 blocks of 16 values per row, the second one padded, in the layout of the weight of MatMulNBits
+  const int64_t vocab_size = 5;
+  const int64_t hidden_size = 24;
+  const int64_t block_size = 16;
+  const int64_t num_blocks = 2;
+  std::vector<uint8_t> values(vocab_size * num_blocks * block_size);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<uint8_t>((i * 5 + 3) % 16);
+  }
+  std::vector<uint8_t> packed(values.size() / 2);
+  for (size_t i = 0; i < packed.size(); ++i) {
+    packed[i] = static_cast<uint8_t>(values[2 * i] | (values[2 * i + 1] << 4));
+  }
+  const std::vector<float> scales = MakeValues(vocab_size * num_blocks, 2);
+  // one byte of two zero points per row
+  const std::vector<uint8_t> zero_points{0x87, 0x39, 0x08, 0xF0, 0x44};
+  const std::vector<float> gamma = MakeValues(hidden_size, 3);
+
+  const std::vector<int32_t> input_ids{4, 1, 1, 0};
+  std::vector<float> embedding_sum;
+  for (int32_t id : input_ids) {
+    for (int64_t h = 0; h < hidden_size; ++h) {
+      const int64_t block = h / block_size;
+      const int zero_point = (zero_points[id] >> (block * 4)) & 0xF;
+      const int value = values[(id * num_blocks + block) * block_size + h % block_size];
+      embedding_sum.push_back(static_cast<float>(value - zero_point) * scales[id * num_blocks + block]);
+    }
+  }
+
+  OpTester test("TokenEmbedLayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("epsilon", kEpsilon);
+  test.AddAttribute("simplified", static_cast<int64_t>(1));
+  test.AddAttribute("block_size", block_size);
+  test.AddInput<int32_t>("input_ids", {4}, input_ids);
+  test.AddInput<uint8_t>("embedding", {vocab_size, num_blocks, block_size / 2}, packed);
+  test.AddInput<float>("gamma", {hidden_size}, gamma);
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<float>("scales", {vocab_size * num_blocks}, scales);
+  test.AddInput<uint8_t>("zero_points", {vocab_size}, zero_points);
+  test.AddOutput<float>("output", {4, hidden_size}, Normalize(embedding_sum, gamma, {}, true), false, 1e-5f, 1e-4f);
+  test.AddOutput<float>("embedding_sum", {4, hidden_size}, embedding_sum);
+  test.Run();
+}
+
+TEST(TokenEmbedLayerNormTest, InvalidId) {
+  OpTester test("TokenEmbedLayerNormalization", 1, onnxruntime::kMSDomain);
+  test.AddInput<int64_t>("input_ids", {2}, {0, 2});
+  test.AddInput<float>("embedding", {2, 2}, {1.0f, 2.0f, 3.0f, 4.0f});
+  test.AddInput<float>("gamma", {2}, {1.0f, 1.0f});
+  test.AddInput<float>("beta", {2}, {0.0f, 0.0f});
+  test.AddOutput<float>("output", {2, 2}, {0.0f, 0.0f, 0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "input_ids element out of range");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace wordpiece_tokenizer_test {
+const std::vector<std::string> vocab{"[PAD]", "[UNK]", "un", "##aff", "##able", "want", "##ed", "runn", "##ing",
+                                     ",", "!", "the", "##s", "é", "##té"};
+}  // namespace wordpiece_tokenizer_test
+
+using namespace wordpiece_tokenizer_test;
+
+TEST(ContribOpTest, WordPieceTokenizer) {
+  OpTester test("WordPieceTokenizer", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("vocab", vocab);
+
+  test.AddInput<std::string>("X", {3}, {"unaffable running, wanted!", "the thes", "été unknown"});
+  test.AddOutput<int64_t>("Y", {3, 9},
+                          {2, 3, 4, 7, 8, 9, 5, 6, 10,
+                           11, 11, 12, 0, 0, 0, 0, 0, 0,
+                           13, 14, 1, 0, 0, 0, 0, 0, 0});
+  test.AddOutput<int64_t>("lengths", {3}, {9, 3, 3});
+  test.Run();
+}
+
+TEST(ContribOpTest, WordPieceTokenizerLowerCaseAndLongWords) {
+  OpTester test("WordPieceTokenizer", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("vocab", vocab);
+  test.AddAttribute("lower_case", int64_t{1});
+  test.AddAttribute("max_input_chars_per_word", int64_t{5});
+  test.AddAttribute("pad_token_id", int64_t{-1});
+
+  test.AddInput<std::string>("X", {2}, {"The RUNNING", "\tun  "});
+  test.AddOutput<int64_t>("Y", {2, 2}, {11, 1, 2, -1});
+  test.Run();
+}
+
+TEST(ContribOpTest, WordPieceTokenizerEmptyInput) {
+  OpTester test("WordPieceTokenizer", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("vocab", vocab);
+
+  test.AddInput<std::string>("X", {2}, {"", " "});
+  test.AddOutput<int64_t>("Y", {2, 0}, {});
+  test.Run();
+}
+
+}  // namespace test
+}  // namespace onnxruntime
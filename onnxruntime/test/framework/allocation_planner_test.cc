@@ -113,15 +113,19 @@ typedef std::unordered_map<const onnxruntime::NodeArg*, TensorShapeProto*> Shape
 
 class SequentialPlannerTestContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerTestContext(ShapeMap* shape_map) : shape_map_(shape_map) {}
+  SequentialPlannerTestContext(ShapeMap* shape_map, bool enable_elementwise_inplace = false)
+      : shape_map_(shape_map), enable_elementwise_inplace_(enable_elementwise_inplace) {}
 
   TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
     auto iter = shape_map_->find(&arg);
     return (shape_map_->end() != iter) ? iter->second : nullptr;
   }
 
+  bool GetEnableElementwiseInplace() const override { return enable_elementwise_inplace_; }
+
  private:
   ShapeMap* shape_map_;
+  bool enable_elementwise_inplace_;
 };
 
 class ParallelPlannerTestContext : public SequentialPlannerTestContext {
@@ -148,6 +152,7 @@ class PlannerTest : public ::testing::Test {
   std::unique_ptr<::onnxruntime::KernelDef> std_kernel_;               // a unary kernel with no-aliasing and no-in-place
   std::unique_ptr<::onnxruntime::KernelDef> in_place_kernel_;          // a unary kernel with in-place
   std::unique_ptr<::onnxruntime::KernelDef> external_outputs_kernel_;  // an unary kernel with external outputs
+  std::unique_ptr<::onnxruntime::KernelDef> elementwise_kernel_;       // an elementwise unary kernel with no in-place
 #ifdef ENABLE_STRIDED_TENSORS
   std::unique_ptr<::onnxruntime::KernelDef> may_strided_input_kernel_;   // an uinary kernel with may_strided_input
   std::unique_ptr<::onnxruntime::KernelDef> may_strided_output_kernel_;  // an unary kernel with may_strided_output
@@ -164,6 +169,7 @@ class PlannerTest : public ::testing::Test {
   std::unique_ptr<SessionOptions> sess_options_;
   std::unique_ptr<SessionState> state_;
   ShapeMap shape_map_;
+  bool enable_elementwise_inplace_ = false;
   std::optional<SequentialExecutionPlan> plan_;
 
  public:
@@ -177,6 +183,7 @@ class PlannerTest : public ::testing::Test {
         KernelDefBuilder().SetName("Relu").Provider(kCpuExecutionProvider).SinceVersion(1, 10).MayInplace(0, 0).Build();
     external_outputs_kernel_ =
         KernelDefBuilder().SetName("Tanh").Provider(kCpuExecutionProvider).SinceVersion(1, 10).ExternalOutputs().Build();
+    elementwise_kernel_ = KernelDefBuilder().SetName("Exp").Provider(kCpuExecutionProvider).SinceVersion(1, 10).Build();
 #ifdef ENABLE_STRIDED_TENSORS
     may_strided_input_kernel_ = KernelDefBuilder()
                                     .SetName("Abs")
@@ -238,6 +245,10 @@ class PlannerTest : public ::testing::Test {
     return AddNode(*external_outputs_kernel_, input, output);
   }
 
+  onnxruntime::Node* AddElementwiseNode(std::string& input, std::string& output) {
+    return AddNode(*elementwise_kernel_, input, output);
+  }
+
 #ifdef ENABLE_STRIDED_TENSORS
   onnxruntime::Node* AddMayStridedInputNode(std::string& input, std::string& output) {
     return AddNode(*may_strided_input_kernel_, input, output);
@@ -305,7 +316,7 @@ class PlannerTest : public ::testing::Test {
     status = state_->FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager, {}, remove_initializers);
 
     EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
-    SequentialPlannerTestContext test_context(&shape_map_);
+    SequentialPlannerTestContext test_context(&shape_map_, enable_elementwise_inplace_);
     plan_.emplace();
 
     class MockStreamHandleRegsitry : public IStreamCommandHandleRegistry {
@@ -385,6 +396,7 @@ class PlannerTest : public ::testing::Test {
     ORT_THROW_IF_ERROR(sess_options_->config_options.AddConfigEntry(kNodePartitionConfigFile, config_file_path));
   }
   std::unique_ptr<::onnxruntime::KernelDef>& GetStdKernel() { return std_kernel_; }
+  void EnableElementwiseInplace() { enable_elementwise_inplace_ = true; }
 #ifdef USE_CUDA
   void MemcpyToHostInCuda_TransposeInCudaAndCpu(const char* partitionConfigFile = nullptr) {
     std::unique_ptr<::onnxruntime::KernelDef> cudaKernel = KernelDefBuilder().SetName("MemcpyToHost").Provider(kCudaExecutionProvider).SetDefaultOutputMemoryType(OrtMemTypeCPUOutput).Build();
@@ -513,6 +525,53 @@ TEST_F(PlannerTest, InPlaceTest) {
   CheckFreed(2, {X1});
 }
 
+TEST_F(PlannerTest, ElementwiseInplaceTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
+
+  // graph structure:
+  AddNormalNode(X1, X2);       // no in-place operator; X1: input; X2: temporary
+  AddElementwiseNode(X2, X3);  // elementwise operator without in-place declaration; X3: temporary
+  AddNormalNode(X3, X4);       // no in-place operator; X4: output
+
+  // simulate shape-inference results:
+  Shape shape1{"M", "N"};
+  auto shape = &shape1.value;
+  SetShape({{X1, shape}, {X2, shape}, {X3, shape}, {X4, shape}});
+
+  EnableElementwiseInplace();
+  CreatePlan();
+
+  // check allocation kind:
+  CheckAllocKind(X1, AllocKind::kPreExisting);
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kReuse);
+  CheckAllocKind(X4, AllocKind::kAllocateOutput);
+}
+
+TEST_F(PlannerTest, ElementwiseInplaceShapeMismatchTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
+
+  // graph structure:
+  AddNormalNode(X1, X2);       // no in-place operator; X1: input; X2: temporary
+  AddElementwiseNode(X2, X3);  // elementwise operator without in-place declaration; X3: temporary
+  AddNormalNode(X3, X4);       // no in-place operator; X4: output
+
+  // simulate shape-inference results:
+  Shape shape1w{"M", "N"};
+  auto shape1 = &shape1w.value;
+  Shape shape2w{"M", "K"};
+  auto shape2 = &shape2w.value;
+  SetShape({{X1, shape1}, {X2, shape1}, {X3, shape2}, {X4, shape1}});
+
+  EnableElementwiseInplace();
+  CreatePlan();
+
+  // X2 may be of a different size than X3, so it is not reused.
+  CheckAllocKind(X3, AllocKind::kAllocate);
+}
+
 TEST_F(PlannerTest, ExternalOutputsTest) {
   // tensor variables:
   std::string X1("X1"), X2("X2"), X3("X3"), X4("X4");
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include <absl/base/config.h>
 
+#include "core/framework/accounting_allocator.h"
 #include "core/framework/allocator.h"
 
 #include "test_utils.h"
@@ -32,6 +33,37 @@ TEST(AllocatorTest, CPUAllocatorTest) {
   cpu_arena->Free(bytes);
   // todo: test the used / max api.
 }
+
+TEST(AllocatorTest, AccountingAllocatorTest) {
+  auto shared_allocator = std::make_shared<CPUAllocator>();
+  AccountingAllocator allocator(shared_allocator, 4096);
+  EXPECT_STREQ(allocator.Info().name, CPU);
+  EXPECT_EQ(allocator.Info().alloc_type, OrtAllocatorType::OrtDeviceAllocator);
+
+  void* p1 = allocator.Alloc(1024);
+  void* p2 = allocator.Reserve(2048);
+  AllocatorStats stats;
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 3072);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(stats.num_reserves, 1);
+  EXPECT_EQ(stats.bytes_limit, 4096);
+
+  // the allocation would exceed the limit of the session
+  EXPECT_THROW(allocator.Alloc(2048), OnnxRuntimeException);
+
+  allocator.Free(p1);
+  void* p3 = allocator.Alloc(2048);
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 4096);
+  EXPECT_EQ(stats.max_bytes_in_use, 4096);
+
+  allocator.Free(p2);
+  allocator.Free(p3);
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(disable : 26400)
 #endif
@@ -7,6 +7,7 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -307,6 +308,155 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, FragmentationStats) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+  void* p1 = a.Alloc(1024);
+  void* p2 = a.Alloc(4096);
+  void* p3 = a.Alloc(1024);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 3);
+  EXPECT_EQ(stats.num_idle_regions, 0);
+  EXPECT_EQ(stats.bytes_free, 0);
+  EXPECT_EQ(stats.largest_free_chunk_size, 0);
+
+  a.Free(p1);
+  a.Free(p2);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_idle_regions, 2);
+  EXPECT_EQ(stats.bytes_free, 1024 + 4096);
+  EXPECT_EQ(stats.largest_free_chunk_size, 4096);
+
+  const auto free_bytes_by_bin = a.GetFreeBytesByBin();
+  ASSERT_GT(free_bytes_by_bin.size(), 4u);
+  EXPECT_EQ(free_bytes_by_bin[2], 1024);  // [1024, 2048)
+  EXPECT_EQ(free_bytes_by_bin[4], 4096);  // [4096, 8192)
+  a.Free(p3);
+}
+
+TEST(BFCArenaTest, Compact) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+  void* p1 = a.Alloc(1024);
+  void* p2 = a.Alloc(3 * 1024);
+  a.Free(p1);
+
+  // a quarter of the allocated bytes are free
+  bool compacted = false;
+  ASSERT_EQ(a.Compact(0.5, compacted), Status::OK());
+  EXPECT_FALSE(compacted);
+  ASSERT_EQ(a.Compact(0.25, compacted), Status::OK());
+  EXPECT_TRUE(compacted);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_regions, 1);
+  EXPECT_EQ(stats.bytes_free, 0);
+
+  // nothing to release while all regions are in use
+  ASSERT_EQ(a.Compact(0.0, compacted), Status::OK());
+  EXPECT_FALSE(compacted);
+  a.Free(p2);
+}
+
+TEST(BFCArenaTest, ThreadCache) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             4096);
+  void* p1 = a.Alloc(1000);
+  a.Free(p1);
+  // a freed small chunk is kept in the thread cache and handed out again for the same rounded size
+  void* p2 = a.Alloc(1024);
+  EXPECT_EQ(p1, p2);
+  // a chunk of another size class is not
+  void* p3 = a.Alloc(2048);
+  EXPECT_NE(p2, p3);
+  // allocations larger than the threshold bypass the thread caches
+  void* p4 = a.Alloc(8192);
+  a.Free(p2);
+  a.Free(p3);
+  a.Free(p4);
+
+  // the cached chunks are still in use from the point of view of the arena
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_allocs, 4);
+  EXPECT_EQ(stats.bytes_in_use, 1024 + 2048);
+
+  // Shrink returns the cached chunks to the arena before freeing the unused regions
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheBatchedReturn) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             256);
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 100; ++i) {
+    ptrs.push_back(a.Alloc(256));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  // a thread cache holds a bounded number of chunks of a size class, the others went back to the bins
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_GT(stats.bytes_in_use, 0);
+  EXPECT_LT(stats.bytes_in_use, 100 * 256);
+}
+
+TEST(BFCArenaTest, ThreadCacheConcurrentAllocations) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             4096);
+  constexpr int kNumThreads = 8;
+  constexpr int kNumIterations = 1000;
+  // every thread frees half of its allocations on another thread, so that chunks move between the caches
+  std::vector<std::vector<void*>> handed_over(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&a, &handed_over, t]() {
+      for (int i = 0; i < kNumIterations; ++i) {
+        const size_t size = 1 + (i * 37 + t * 101) % 4096;
+        auto* p = static_cast<char*>(a.Alloc(size));
+        p[0] = static_cast<char>(t);
+        p[size - 1] = static_cast<char>(t);
+        if (i % 2 == 0) {
+          a.Free(p);
+        } else {
+          handed_over[t].push_back(p);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  threads.clear();
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&a, &handed_over, t]() {
+      for (void* p : handed_over[(t + 1) % kNumThreads]) {
+        a.Free(p);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_allocs, kNumThreads * kNumIterations);
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+#include <filesystem>
+
+#include "core/framework/ep_context_utils.h"
+#include "core/graph/constants.h"
+#include "core/graph/graph_viewer.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Adds a node named "fused_node" to `graph` with an input and an output, to add an EPContext node for.
+Node& AddFusedNode(Graph& graph) {
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  return graph.AddNode("fused_node", "Relu", "", {&input}, {&output});
+}
+
+}  // namespace
+
+TEST(EpContextUtilsTest, EmbedMode) {
+  Model model("ep_context_utils_test", false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  const Node& fused_node = AddFusedNode(graph);
+
+  Model ep_context_model("ep_context_utils_test_ctx", false, DefaultLoggingManager().DefaultLogger());
+  Node* ep_context_node = nullptr;
+  ASSERT_STATUS_OK(ep_context_utils::AddEpContextNode(ep_context_model.MainGraph(), fused_node,
+                                                      kQnnExecutionProvider, true, "compiled", true,
+                                                      ORT_TSTR(""), "1.0", ep_context_node));
+  ASSERT_NE(ep_context_node, nullptr);
+  EXPECT_EQ(ep_context_node->Name(), fused_node.Name());
+  EXPECT_EQ(ep_context_node->InputDefs()[0]->Name(), "X");
+  EXPECT_EQ(ep_context_node->OutputDefs()[0]->Name(), "Y");
+
+  EXPECT_TRUE(ep_context_utils::IsEpContextNode(*ep_context_node, kQnnExecutionProvider));
+  EXPECT_FALSE(ep_context_utils::IsEpContextNode(*ep_context_node, kTensorrtExecutionProvider));
+  EXPECT_FALSE(ep_context_utils::IsEpContextNode(fused_node, kQnnExecutionProvider));
+
+  // the short name of the EP also matches
+  ep_context_node->AddAttribute(ep_context_utils::kSourceAttr, "qnn");
+  EXPECT_TRUE(ep_context_utils::IsEpContextNode(*ep_context_node, kQnnExecutionProvider));
+
+  std::string file_buffer;
+  std::string_view artifact;
+  ASSERT_STATUS_OK(ep_context_utils::GetEpContextArtifact(*ep_context_node, ORT_TSTR(""), file_buffer, artifact));
+  EXPECT_EQ(artifact, "compiled");
+  EXPECT_TRUE(file_buffer.empty());
+}
+
+TEST(EpContextUtilsTest, ExternalFile) {
+  Model model("ep_context_utils_test", false, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  const Node& fused_node = AddFusedNode(graph);
+
+  const PathString ep_context_model_path = ORT_TSTR("ep_context_utils_test_ctx.onnx");
+  Model ep_context_model("ep_context_utils_test_ctx", false, DefaultLoggingManager().DefaultLogger());
+  Node* ep_context_node = nullptr;
+  ASSERT_STATUS_OK(ep_context_utils::AddEpContextNode(ep_context_model.MainGraph(), fused_node,
+                                                      kQnnExecutionProvider, true, "compiled", false,
+                                                      ep_context_model_path, "", ep_context_node));
+
+  const std::string file_name = ep_context_node->GetAttributes().at(ep_context_utils::kEpCacheContextAttr).s();
+  EXPECT_TRUE(std::filesystem::exists(file_name));
+
+  std::string file_buffer;
+  std::string_view artifact;
+  ASSERT_STATUS_OK(ep_context_utils::GetEpContextArtifact(*ep_context_node, ep_context_model_path,
+                                                          file_buffer, artifact));
+  EXPECT_EQ(artifact, "compiled");
+
+  // the file must not be outside of the directory of the EP context model
+  ep_context_node->AddAttribute(ep_context_utils::kEpCacheContextAttr, "../" + file_name);
+  EXPECT_EQ(ep_context_utils::GetEpContextArtifact(*ep_context_node, ep_context_model_path, file_buffer, artifact)
+                .Code(),
+            common::StatusCode::INVALID_GRAPH);
+
+  std::filesystem::remove(file_name);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
@@ -8,6 +8,7 @@
 #include "core/graph/model.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test_utils.h"
 #include "test/test_environment.h"
 #include "test/framework/TestAllocatorManager.h"
@@ -366,6 +367,177 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   ASSERT_EQ(p->GetBlock(4)->offset_, kAllocAlignment);
 }
 
+TEST_F(ExecutionFrameTest, MemPatternCacheTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), output_def("Y", &tensor_float);
+  graph.AddNode("node1", "Relu", "relu", ArgMap{&input_def}, ArgMap{&output_def})
+      .SetExecutionProviderType(xp_type);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigMemoryPatternCacheSize, "2"));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+
+  int x_idx = -1;
+  ASSERT_STATUS_OK(state.GetOrtValueNameIdxMap().GetIdx("X", x_idx));
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+
+  // [2, 3] and [3, 2] have the same dims in a different order, so they must not share a pattern.
+  std::vector<OrtValue> feeds(3);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &feeds[0]);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{3, 2}, std::vector<float>(6, 1.0f), &feeds[1]);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{4, 4}, std::vector<float>(16, 1.0f), &feeds[2]);
+
+  // Tell the patterns apart by their number of locations.
+  auto update_cache = [&](size_t i) {
+    MemoryPatternGroup mem_patterns;
+    mem_patterns.locations.resize(i + 1);
+    mem_patterns.patterns.resize(i + 1);
+    ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(AsSpan({feeds[i]}), std::move(mem_patterns)));
+  };
+  auto get_cached = [&](size_t i) {
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes;
+    return state.GetMemoryPatternGroup(AsSpan({feeds[i]}), AsSpan({x_idx}), inferred_shapes);
+  };
+
+  update_cache(0);
+  update_cache(1);
+  auto pattern0 = get_cached(0);
+  auto pattern1 = get_cached(1);
+  ASSERT_NE(pattern0, nullptr);
+  ASSERT_NE(pattern1, nullptr);
+  EXPECT_EQ(pattern0->locations.size(), 1u);
+  EXPECT_EQ(pattern1->locations.size(), 2u);
+
+  // Use the first pattern again, so that the second one is the least recently used when the cache is full.
+  ASSERT_EQ(get_cached(0), pattern0);
+  update_cache(2);
+  ASSERT_EQ(get_cached(0), pattern0);
+  auto pattern2 = get_cached(2);
+  ASSERT_NE(pattern2, nullptr);
+  EXPECT_EQ(pattern2->locations.size(), 3u);
+#if !defined(ENABLE_TRAINING)
+  // In training builds a missing pattern may be generated from the inferred shapes.
+  EXPECT_EQ(get_cached(1), nullptr);
+#endif
+  // A pattern in use stays valid after it was evicted.
+  EXPECT_EQ(pattern1->locations.size(), 2u);
+}
+
+TEST_F(ExecutionFrameTest, SymbolicMemPatternTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto* shape = tensor_float.mutable_tensor_type()->mutable_shape();
+  shape->add_dim()->set_dim_param("batch");
+  shape->add_dim()->set_dim_value(4);
+  onnxruntime::NodeArg input_def("X", &tensor_float), relu_out_def("T", nullptr), output_def("Y", nullptr);
+  graph.AddNode("node1", "Relu", "relu1", ArgMap{&input_def}, ArgMap{&relu_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "Relu", "relu2", ArgMap{&relu_out_def}, ArgMap{&output_def})
+      .SetExecutionProviderType(xp_type);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  ASSERT_STATUS_OK(
+      sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableSymbolicMemoryPatterns, "1"));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+
+  int x_idx = -1, t_idx = -1, y_idx = -1;
+  ASSERT_STATUS_OK(state.GetOrtValueNameIdxMap().GetIdx("X", x_idx));
+  ASSERT_STATUS_OK(state.GetOrtValueNameIdxMap().GetIdx("T", t_idx));
+  ASSERT_STATUS_OK(state.GetOrtValueNameIdxMap().GetIdx("Y", y_idx));
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+
+  OrtValue x2, x5;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 4}, std::vector<float>(8, 1.0f), &x2);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{5, 4}, std::vector<float>(20, 1.0f), &x5);
+
+  ASSERT_TRUE(state.NeedsSymbolicMemoryPattern());
+  {
+    // Trace the allocation of T with a batch of 2.
+    std::vector<OrtValue> outputs;
+    ExecutionFrame frame(AsSpan({x_idx}), AsSpan({x2}), AsSpan({y_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                         {},
+#endif
+                         state);
+    ASSERT_TRUE(frame.HasMemoryPatternPlanner());
+    OrtValue& t = *frame.GetMutableNodeInputOrOutputMLValue(t_idx);
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t, t_idx, DataTypeImpl::GetType<float>(),
+                                                              cpu_allocator->Info().device,
+                                                              TensorShape(std::vector<int64_t>{2, 4})));
+    ASSERT_EQ(frame.GetMemoryPatternTrace().size(), 1u);
+
+    MemoryPatternGroup mem_patterns;
+    ASSERT_STATUS_OK(frame.GeneratePatterns(mem_patterns));
+    ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(AsSpan({x2}), std::move(mem_patterns)));
+    ASSERT_STATUS_OK(state.UpdateSymbolicMemoryPattern(AsSpan({x2}), AsSpan({x_idx}),
+                                                       frame.GetMemoryPatternTrace()));
+  }
+  ASSERT_FALSE(state.NeedsSymbolicMemoryPattern());
+
+  // A batch of 5 gets a pattern without tracing, with T sized for the new batch.
+  std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes;
+  auto patterns = state.GetMemoryPatternGroup(AsSpan({x5}), AsSpan({x_idx}), inferred_shapes);
+  ASSERT_NE(patterns, nullptr);
+  const auto* pattern = patterns->GetPatterns(cpu_allocator->Info().device);
+  ASSERT_NE(pattern, nullptr);
+  const auto* block = pattern->GetBlock(t_idx);
+  ASSERT_NE(block, nullptr);
+  size_t expected_size = 0;
+  ASSERT_TRUE(IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(20, sizeof(float), &expected_size));
+  EXPECT_EQ(block->size_, expected_size);
+
+  std::vector<OrtValue> outputs;
+  ExecutionFrame frame(AsSpan({x_idx}), AsSpan({x5}), AsSpan({y_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                       {},
+#endif
+                       state);
+  EXPECT_FALSE(frame.HasMemoryPatternPlanner());
+}
+
 #ifdef ENABLE_TRAINING
 TEST_F(ExecutionFrameTest, MemPatternWithExternalOutputsTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
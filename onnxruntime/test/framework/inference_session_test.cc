@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <cmath>
 #include <functional>
 #include <iterator>
 #include <thread>
@@ -13,9 +14,11 @@
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include "core/common/denormal.h"
+#include "core/common/hardware_counters.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/profiler.h"
+#include "core/framework/accounting_allocator.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_provider.h"
@@ -29,6 +32,7 @@
 #include "core/graph/op.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/platform/env.h"
+#include "core/platform/path_lib.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #ifdef USE_CUDA
@@ -44,8 +48,10 @@
 #endif
 #include "core/session/environment.h"
 #include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/session/run_completion_queue.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
 #include "dummy_provider.h"
 #include "test_utils.h"
@@ -55,6 +61,7 @@
 #include "test/optimizer/dummy_graph_transformer.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/inference_session_wrapper.h"
+#include "test/util/include/temp_dir.h"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -830,6 +837,507 @@ TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   thread2.join();
 }
 
+TEST(InferenceSessionTests, RunAsyncWithCompletionQueue) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunAsyncWithCompletionQueue";
+  so.intra_op_param.thread_pool_size = 2;
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_mul_x, values_mul_x,
+                       &ml_value);
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<OrtValue> feeds{ml_value};
+  const std::vector<std::string> output_names{"Y"};
+  const std::vector<std::string> invalid_output_names{"NotAnOutput"};
+
+  RunCompletionQueue completion_queue;
+  constexpr int num_runs = 8;
+  int tags[num_runs];
+  for (int i = 0; i < num_runs; ++i) {
+    tags[i] = i;
+    ASSERT_STATUS_OK(session_object.RunAsync(RunOptions{}, feed_names, feeds, output_names, completion_queue, &tags[i]));
+  }
+
+  std::vector<bool> completed(num_runs, false);
+  for (int i = 0; i < num_runs; ++i) {
+    RunCompletionQueue::Completion completion;
+    ASSERT_TRUE(completion_queue.Pop(completion, std::chrono::seconds(60)));
+    ASSERT_STATUS_OK(completion.status);
+    const int tag = *static_cast<int*>(completion.user_data);
+    ASSERT_FALSE(completed[tag]);
+    completed[tag] = true;
+    VerifyOutputs(completion.fetches, expected_dims_mul_y, expected_values_mul_y);
+  }
+  RunCompletionQueue::Completion completion;
+  ASSERT_FALSE(completion_queue.TryPop(completion));
+
+  // A failed run is delivered to the queue as well
+  ASSERT_STATUS_OK(session_object.RunAsync(RunOptions{}, feed_names, feeds, invalid_output_names, completion_queue,
+                                           nullptr));
+  ASSERT_TRUE(completion_queue.Pop(completion, std::chrono::seconds(60)));
+  ASSERT_FALSE(completion.status.IsOK());
+  ASSERT_TRUE(completion.fetches.empty());
+}
+
+// Model computing Y = X * X. The first dimension of X is symbolic if batch_size is 0.
+static void CreateSquareModel(const std::string& model_file_name, int64_t batch_size) {
+  onnxruntime::Model model("graph_1", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  if (batch_size > 0) {
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(batch_size);
+  } else {
+    float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  }
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& input_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& output_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("node_1", "Mul", "node 1.", {&input_arg, &input_arg}, {&output_arg});
+
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+}
+
+static void RunDynamicBatchingTest(const std::string& model_uri, int64_t rows_per_run) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.DynamicBatching";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "8"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDynamicBatchingMaxQueueDelayUs, "10000"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_uri));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // Each thread runs with its own values, so that mixing up rows of different calls is detected.
+  constexpr int num_threads = 6;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&session_object, rows_per_run, t]() {
+      std::vector<int64_t> dims = {rows_per_run, 2};
+      std::vector<float> values(static_cast<size_t>(rows_per_run * 2));
+      std::vector<float> expected_values(values.size());
+      for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<float>(t * 100 + i);
+        expected_values[i] = values[i] * values[i];
+      }
+      OrtValue ml_value;
+      CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+      const std::vector<std::string> feed_names{"X"};
+      const std::vector<OrtValue> feeds{ml_value};
+      const std::vector<std::string> output_names{"Y"};
+      for (int i = 0; i < 10; ++i) {
+        std::vector<OrtValue> fetches;
+        ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+        VerifyOutputs(fetches, dims, expected_values);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(InferenceSessionTests, DynamicBatching) {
+  const std::string model_file_name = "dynamic_batching_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+  RunDynamicBatchingTest(model_file_name, 1);
+  RunDynamicBatchingTest(model_file_name, 3);
+}
+
+TEST(InferenceSessionTests, DynamicBatchingFallbackForFixedBatchSize) {
+  // The model has a fixed first dimension of 3, so batched runs fail and each call is run by itself.
+  const std::string model_file_name = "dynamic_batching_fixed_batch_test_graph.onnx";
+  CreateSquareModel(model_file_name, 3);
+  RunDynamicBatchingTest(model_file_name, 3);
+}
+
+static void RunPipelineTest(const std::string& model_uri, int64_t rows) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.Pipeline";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigPipelineMicroBatchSize, "2"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigPipelineMaxMicroBatchesInFlight, "3"));
+  so.intra_op_param.thread_pool_size = 4;
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_uri));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // The last micro-batch is partial when rows is odd.
+  std::vector<int64_t> dims = {rows, 2};
+  std::vector<float> values(static_cast<size_t>(rows * 2));
+  std::vector<float> expected_values(values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<float>(i);
+    expected_values[i] = values[i] * values[i];
+  }
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<OrtValue> feeds{ml_value};
+  const std::vector<std::string> output_names{"Y"};
+  for (int i = 0; i < 3; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, dims, expected_values);
+  }
+}
+
+TEST(InferenceSessionTests, PipelinedMicroBatches) {
+  const std::string model_file_name = "pipeline_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+  RunPipelineTest(model_file_name, 2);
+  RunPipelineTest(model_file_name, 9);
+}
+
+TEST(InferenceSessionTests, PipelineFallbackForFixedBatchSize) {
+  // The model has a fixed first dimension of 7, so the micro-batches fail and the call is run as a whole.
+  const std::string model_file_name = "pipeline_fixed_batch_test_graph.onnx";
+  CreateSquareModel(model_file_name, 7);
+  RunPipelineTest(model_file_name, 7);
+}
+
+TEST(InferenceSessionTests, CpuGraphCapture) {
+  const std::string model_file_name = "cpu_graph_capture_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.CpuGraphCapture";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableCpuGraphCapture, "1"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  auto run = [&](int64_t rows, float offset, std::vector<OrtValue>& fetches) {
+    std::vector<int64_t> dims = {rows, 2};
+    std::vector<float> values(static_cast<size_t>(rows * 2));
+    std::vector<float> expected_values(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = offset + static_cast<float>(i);
+      expected_values[i] = values[i] * values[i];
+    }
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+    const std::vector<OrtValue> feeds{ml_value};
+    fetches.clear();
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, dims, expected_values);
+  };
+
+  // The first run captures the graph, and the following runs with the same shape replay it with new values.
+  std::vector<OrtValue> first_fetches;
+  std::vector<OrtValue> fetches;
+  run(2, 1.f, first_fetches);
+  run(2, 10.f, fetches);
+  run(2, 20.f, fetches);
+  // The fetches of a replay are not overwritten by the following replays.
+  VerifyOutputs(first_fetches, {2, 2}, {1.f, 4.f, 9.f, 16.f});
+
+  // Runs with a different shape are executed as usual.
+  run(3, 5.f, fetches);
+  run(2, 30.f, fetches);
+}
+
+TEST(InferenceSessionTests, ShapeSpecialization) {
+  const std::string model_file_name = "shape_specialization_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ShapeSpecialization";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigShapeSpecializationMaxVariants, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigShapeSpecializationMinRuns, "2"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  auto run = [&](int64_t rows, float offset) {
+    std::vector<int64_t> dims = {rows, 2};
+    std::vector<float> values(static_cast<size_t>(rows * 2));
+    std::vector<float> expected_values(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = offset + static_cast<float>(i);
+      expected_values[i] = values[i] * values[i];
+    }
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+    const std::vector<OrtValue> feeds{ml_value};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, dims, expected_values);
+  };
+
+  // The second run with a batch of 1 creates the specialized session, which runs the following batches of 1.
+  // Other batch sizes keep running on the original session once the single variant is used.
+  for (int i = 0; i < 4; ++i) {
+    run(1, static_cast<float>(i));
+    run(3, static_cast<float>(i));
+  }
+}
+
+TEST(InferenceSessionTests, NodeOverheadStats) {
+  const std::string model_file_name = "node_overhead_stats_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.NodeOverheadStats";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableNodeOverheadStats, "1"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims = {2, 2};
+  std::vector<float> values = {1.f, 2.f, 3.f, 4.f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<OrtValue> feeds{ml_value};
+  const std::vector<std::string> output_names{"Y"};
+  constexpr int num_runs = 3;
+  for (int i = 0; i < num_runs; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, dims, {1.f, 4.f, 9.f, 16.f});
+  }
+
+  const auto* overhead_stats = session_object.GetSessionState().GetNodeOverheadStats();
+  ASSERT_NE(overhead_stats, nullptr);
+  const auto summaries = overhead_stats->GetSummaries();
+  ASSERT_EQ(summaries.size(), 1u);
+  const auto& mul_summary = summaries.at("Mul");
+  EXPECT_EQ(mul_summary.count, static_cast<uint64_t>(num_runs));
+  EXPECT_GT(mul_summary.durations[NodeOverheadStats::kCompute].count(), 0);
+  EXPECT_GT(mul_summary.durations[NodeOverheadStats::kAllocate].count(), 0);
+  EXPECT_THAT(overhead_stats->ToString(), testing::HasSubstr("Mul"));
+}
+
+TEST(InferenceSessionTests, SampledProfiling) {
+  const std::string model_file_name = "sampled_profiling_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SampledProfiling";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigProfilingSampleRate, "2"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigProfilingSampleWindow, "2"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims = {2, 2};
+  std::vector<float> values = {1.f, 2.f, 3.f, 4.f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<OrtValue> feeds{ml_value};
+  const std::vector<std::string> output_names{"Y"};
+  // runs 0, 2, 4 and 6 are sampled, only the last two are in the window
+  constexpr int num_runs = 7;
+  for (int i = 0; i < num_runs; ++i) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+    VerifyOutputs(fetches, dims, {1.f, 4.f, 9.f, 16.f});
+  }
+
+  std::string json;
+  ASSERT_STATUS_OK(session_object.GetSampledProfile(json));
+  EXPECT_THAT(json, testing::HasSubstr("\"runs\":7"));
+  EXPECT_THAT(json, testing::HasSubstr("\"sampled_runs\":4"));
+  EXPECT_THAT(json, testing::HasSubstr("\"window_runs\":2"));
+  EXPECT_THAT(json, testing::HasSubstr("\"op_type\":\"Mul\""));
+  EXPECT_THAT(json, testing::HasSubstr("\"count\":2"));
+}
+
+TEST(InferenceSessionTests, SampledProfilingDisabled) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.SampledProfilingDisabled";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::string json;
+  EXPECT_FALSE(session_object.GetSampledProfile(json).IsOK());
+}
+
+TEST(InferenceSessionTests, TensorStatistics) {
+  const std::string model_file_name = "tensor_statistics_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TensorStatistics";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigCollectTensorStatistics, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigTensorStatisticsHistogramBins, "3"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims = {2, 2};
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  // Y is {1, 4, 9, 16} in bins over [1, 16], then the second run widens the range to [1, 25] and the bins of the
+  // first run are moved to the bins of their centers
+  for (const auto& values : {std::vector<float>{1.f, 2.f, 3.f, 4.f}, std::vector<float>{5.f, 5.f, 5.f, 5.f}}) {
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feed_names, {ml_value}, output_names, &fetches));
+  }
+
+  std::string json;
+  ASSERT_STATUS_OK(session_object.GetTensorStatistics(json));
+  EXPECT_THAT(json, testing::HasSubstr("\"Y\":{"));
+  EXPECT_THAT(json, testing::HasSubstr("\"count\":8"));
+  EXPECT_THAT(json, testing::HasSubstr("\"min\":1.0"));
+  EXPECT_THAT(json, testing::HasSubstr("\"max\":25.0"));
+  EXPECT_THAT(json, testing::HasSubstr("\"histogram\":[2,0,6]"));
+}
+
+TEST(InferenceSessionTests, TensorStatisticsDisabled) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TensorStatisticsDisabled";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::string json;
+  EXPECT_FALSE(session_object.GetTensorStatistics(json).IsOK());
+}
+
+TEST(InferenceSessionTests, RunBatch) {
+  const std::string model_file_name = "run_batch_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunBatch";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // requests of different shapes, the second one with a pre-allocated output
+  constexpr size_t batch_size = 3;
+  std::vector<OrtValue> feeds(batch_size);
+  std::vector<OrtValue> fetches(batch_size);
+  std::vector<std::vector<float>> expected_values(batch_size);
+  for (size_t i = 0; i < batch_size; ++i) {
+    const int64_t rows = static_cast<int64_t>(i) + 1;
+    std::vector<float> values(static_cast<size_t>(rows * 2));
+    for (size_t j = 0; j < values.size(); ++j) {
+      values[j] = static_cast<float>(i * 10 + j);
+      expected_values[i].push_back(values[j] * values[j]);
+    }
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {rows, 2}, values, &feeds[i]);
+  }
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {2, 2},
+                       std::vector<float>(4, 0.f), &fetches[1]);
+  const void* preallocated_output = fetches[1].Get<Tensor>().DataRaw();
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  ASSERT_STATUS_OK(session_object.RunBatch(RunOptions{}, feed_names, feeds, output_names, batch_size, fetches));
+  for (size_t i = 0; i < batch_size; ++i) {
+    VerifyOutputs({fetches[i]}, {static_cast<int64_t>(i) + 1, 2}, expected_values[i]);
+  }
+  EXPECT_EQ(fetches[1].Get<Tensor>().DataRaw(), preallocated_output);
+
+  // the number of feeds must match the batch size
+  std::vector<OrtValue> invalid_fetches;
+  EXPECT_FALSE(session_object.RunBatch(RunOptions{}, feed_names, feeds, output_names, batch_size + 1,
+                                       invalid_fetches)
+                   .IsOK());
+}
+
+TEST(InferenceSessionTests, PreparedRun) {
+  const std::string model_file_name = "prepared_run_test_graph.onnx";
+  CreateSquareModel(model_file_name, 2);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PreparedRun";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::unique_ptr<PreparedRun> prepared_run;
+  EXPECT_FALSE(session_object.NewPreparedRun(std::vector<std::string>{"Z"}, std::vector<std::string>{"Y"},
+                                             prepared_run)
+                   .IsOK());
+  EXPECT_FALSE(session_object.NewPreparedRun(std::vector<std::string>{"X"}, std::vector<std::string>{"Z"},
+                                             prepared_run)
+                   .IsOK());
+  ASSERT_STATUS_OK(session_object.NewPreparedRun(std::vector<std::string>{"X"}, std::vector<std::string>{"Y"},
+                                                 prepared_run));
+
+  for (float offset : {0.f, 10.f}) {
+    OrtValue x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {2, 2},
+                         {offset + 1.f, offset + 2.f, offset + 3.f, offset + 4.f}, &x);
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(RunOptions{}, *prepared_run, std::vector<OrtValue>{x}, fetches));
+    VerifyOutputs(fetches, {2, 2},
+                  {(offset + 1.f) * (offset + 1.f), (offset + 2.f) * (offset + 2.f), (offset + 3.f) * (offset + 3.f),
+                   (offset + 4.f) * (offset + 4.f)});
+  }
+
+  // the feeds are still validated against the model
+  OrtValue invalid_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2},
+                       std::vector<float>(6, 1.f), &invalid_x);
+  std::vector<OrtValue> fetches;
+  EXPECT_FALSE(session_object.Run(RunOptions{}, *prepared_run, std::vector<OrtValue>{invalid_x}, fetches).IsOK());
+}
+
+TEST(InferenceSessionTests, ProfileHardwareCounters) {
+  if (!profiling::HardwareCounters::IsAvailable()) {
+    GTEST_SKIP() << "Hardware counters are not available on this host";
+  }
+
+  const std::string model_file_name = "profile_hardware_counters_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ProfileHardwareCounters";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_hardware_counters_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigProfileHardwareCounters, "1"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims = {2, 2};
+  std::vector<float> values = {1.f, 2.f, 3.f, 4.f};
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, values, &ml_value);
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<OrtValue> feeds{ml_value};
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, dims, {1.f, 4.f, 9.f, 16.f});
+
+  std::ifstream profile(session_object.EndProfiling());
+  ASSERT_TRUE(profile);
+  bool has_hardware_counters = false;
+  std::string line;
+  while (std::getline(profile, line)) {
+    if (line.find("_kernel_time") != std::string::npos) {
+      EXPECT_THAT(line, testing::HasSubstr("\"hardware_counters\" : {\"cycles\":"));
+      EXPECT_THAT(line, testing::HasSubstr("\"estimated_dram_gbps\":"));
+      has_hardware_counters = true;
+    }
+  }
+  EXPECT_TRUE(has_hardware_counters);
+}
+
 TEST(InferenceSessionTests, PreAllocateOutputVector) {
   SessionOptions so;
 
@@ -902,6 +1410,178 @@ TEST(InferenceSessionTests, ConfigureVerbosityLevel) {
 #endif
 }
 
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  if constexpr (!SessionOptions::DEFAULT_USE_PER_SESSION_THREADS) {
+    GTEST_SKIP() << "Skipping the test";
+  }
+  TemporaryDirectory cache_dir(ORT_TSTR("optimized_model_cache_test_dir"));
+
+  SessionOptions so;
+  so.session_logid = "OptimizedModelCache";
+  so.session_log_severity_level = static_cast<int>(Severity::kINFO);
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir.Path()).c_str()));
+
+  // the first session saves the optimized model, the second one loads it
+  for (const auto* expected_msg : {"Saved the optimized model to the cache", "Loaded the optimized model from the cache"}) {
+    auto capturing_sink = new CapturingSink();
+    auto logging_manager = std::make_unique<logging::LoggingManager>(
+        std::unique_ptr<ISink>(capturing_sink), logging::Severity::kINFO, false,
+        LoggingManager::InstanceType::Temporal);
+
+    std::unique_ptr<Environment> env;
+    ASSERT_STATUS_OK(Environment::Create(std::move(logging_manager), env));
+    InferenceSession session_object{so, *env.get()};
+    ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+    ASSERT_STATUS_OK(session_object.Initialize());
+
+    RunOptions run_options;
+    RunModel(session_object, run_options);
+
+    const auto& msgs = capturing_sink->Messages();
+    ASSERT_TRUE(std::any_of(msgs.begin(), msgs.end(), [&](const std::string& msg) {
+      return msg.find(expected_msg) != std::string::npos;
+    })) << expected_msg;
+  }
+
+  // a different optimization level does not use the cached model
+  so.graph_optimization_level = TransformerLevel::Level1;
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  size_t num_cached_models = 0;
+  LoopDir(cache_dir.Path(), [&num_cached_models](const ORTCHAR_T*, OrtFileType file_type) {
+    if (file_type == OrtFileType::TYPE_REG) {
+      ++num_cached_models;
+    }
+    return true;
+  });
+  ASSERT_EQ(num_cached_models, static_cast<size_t>(2));
+}
+
+// Model computing Y = X * W + B, with W of the given size filled with 0, 1, 2...
+static void CreateMulAddModel(const std::string& model_file_name, int64_t size, float b) {
+  onnxruntime::Model model("graph_1", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(size);
+
+  std::vector<float> w(size);
+  for (int64_t i = 0; i < size; ++i) {
+    w[i] = static_cast<float>(i);
+  }
+  ONNX_NAMESPACE::TensorProto w_tensor;
+  w_tensor.set_name("W");
+  w_tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  w_tensor.add_dims(size);
+  w_tensor.set_raw_data(w.data(), w.size() * sizeof(float));
+  graph.AddInitializedTensor(w_tensor);
+
+  ONNX_NAMESPACE::TensorProto b_tensor;
+  b_tensor.set_name("B");
+  b_tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  b_tensor.add_dims(1);
+  b_tensor.set_raw_data(&b, sizeof(b));
+  graph.AddInitializedTensor(b_tensor);
+
+  auto& x_arg = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& w_arg = graph.GetOrCreateNodeArg("W", &float_tensor);
+  auto& b_arg = graph.GetOrCreateNodeArg("B", nullptr);
+  auto& xw_arg = graph.GetOrCreateNodeArg("XW", &float_tensor);
+  auto& y_arg = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("mul", "Mul", "", {&x_arg, &w_arg}, {&xw_arg});
+  graph.AddNode("add", "Add", "", {&xw_arg, &b_arg}, {&y_arg});
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_STATUS_OK(onnxruntime::Model::Save(model, model_file_name));
+}
+
+static void RunMulAddModel(InferenceSession& session_object, int64_t size, float b) {
+  std::vector<int64_t> dims = {size};
+  std::vector<float> x(size, 2.0f);
+  std::vector<float> expected_y(size);
+  for (int64_t i = 0; i < size; ++i) {
+    expected_y[i] = 2.0f * static_cast<float>(i) + b;
+  }
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims, x, &ml_value);
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<OrtValue> feeds{ml_value};
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feed_names, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, dims, expected_y);
+}
+
+TEST(InferenceSessionTests, LazyInitializers) {
+  // W is large enough to be read from the model file when the session is initialized
+  const std::string model_file_name = "lazy_initializers_test.onnx";
+  constexpr int64_t size = 256;
+  CreateMulAddModel(model_file_name, size, 0.5f);
+
+  // only the data of W is left in the file
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ASSERT_STATUS_OK(Model::Load(ToPathString(model_file_name), model_proto, 64));
+  for (const auto& initializer : model_proto.graph().initializer()) {
+    ASSERT_EQ(initializer.data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL,
+              initializer.name() == "W");
+    ASSERT_EQ(initializer.has_raw_data(), initializer.name() == "B");
+  }
+
+  SessionOptions so;
+  so.session_logid = "LazyInitializers";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigLazyInitializerMinSize, "64"));
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  RunMulAddModel(session_object, size, 0.5f);
+
+  std::remove(model_file_name.c_str());
+}
+
+TEST(InferenceSessionTests, ShareInitializersFromSession) {
+  // the second version of the model only changes B
+  const std::string model_file_name_v1 = "share_initializers_test_v1.onnx";
+  const std::string model_file_name_v2 = "share_initializers_test_v2.onnx";
+  constexpr int64_t size = 64;
+  CreateMulAddModel(model_file_name_v1, size, 0.5f);
+  CreateMulAddModel(model_file_name_v2, size, 1.5f);
+
+  SessionOptions so;
+  so.session_logid = "ShareInitializersFromSession";
+  auto session_v1 = std::make_unique<InferenceSession>(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_v1->Load(model_file_name_v1));
+  size_t num_shared_initializers = 0;
+  ASSERT_FALSE(session_v1->ShareInitializersFromSession(*session_v1, num_shared_initializers).IsOK());
+  ASSERT_STATUS_OK(session_v1->Initialize());
+  RunMulAddModel(*session_v1, size, 0.5f);
+
+  InferenceSession session_v2{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_v2.Load(model_file_name_v2));
+  ASSERT_STATUS_OK(session_v2.ShareInitializersFromSession(*session_v1, num_shared_initializers));
+  ASSERT_EQ(num_shared_initializers, static_cast<size_t>(1));
+
+  int w_idx;
+  ASSERT_STATUS_OK(session_v1->GetSessionState().GetOrtValueNameIdxMap().GetIdx("W", w_idx));
+  const void* shared_w_data = session_v1->GetSessionState().GetInitializedTensors().at(w_idx).Get<Tensor>().DataRaw();
+
+  // the shared initializer outlives the session it comes from
+  session_v1.reset();
+  ASSERT_STATUS_OK(session_v2.Initialize());
+  RunMulAddModel(session_v2, size, 1.5f);
+
+  ASSERT_STATUS_OK(session_v2.GetSessionState().GetOrtValueNameIdxMap().GetIdx("W", w_idx));
+  ASSERT_EQ(session_v2.GetSessionState().GetInitializedTensors().at(w_idx).Get<Tensor>().DataRaw(), shared_w_data);
+
+  std::remove(model_file_name_v1.c_str());
+  std::remove(model_file_name_v2.c_str());
+}
+
 TEST(InferenceSessionTests, UseUserSpecifiedLoggingFunctionInSession) {
   SessionOptions so;
   /*
@@ -1073,6 +1753,121 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+TEST(InferenceSessionTests, TestIOBindingStatefulIOPairs) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestIOBindingStatefulIOPairs";
+  // Y = X * X is fed back to X
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStatefulIOPairs, "Y:X"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+
+  auto bind_x = [&]() {
+    OrtValue x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2},
+                         {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &x);
+    ASSERT_STATUS_OK(io_binding->BindInput("X", x));
+  };
+  auto check_y = [&](int power) {
+    const auto& y = io_binding->GetOutputs()[0].Get<Tensor>();
+    ASSERT_EQ(y.Shape(), TensorShape({3, 2}));
+    auto y_data = y.DataAsSpan<float>();
+    for (size_t i = 0; i < y_data.size(); ++i) {
+      EXPECT_EQ(y_data[i], std::pow(static_cast<float>(i + 1), static_cast<float>(power)));
+    }
+  };
+  auto y_data = [&]() { return io_binding->GetOutputs()[0].Get<Tensor>().DataRaw(); };
+  auto x_data = [&]() { return io_binding->GetInputs()[0].Get<Tensor>().DataRaw(); };
+
+  bind_x();
+  ASSERT_STATUS_OK(io_binding->BindOutput("Y", OrtDevice()));
+
+  ASSERT_STATUS_OK(session_object.Run(*io_binding));
+  check_y(2);
+  const void* first_buffer = y_data();
+
+  // the output of the first run is the input of the second one
+  ASSERT_STATUS_OK(session_object.Run(*io_binding));
+  check_y(4);
+  EXPECT_EQ(x_data(), first_buffer);
+  const void* second_buffer = y_data();
+  EXPECT_NE(second_buffer, first_buffer);
+
+  // the carried over input of the second run is reused for the output of the third one
+  ASSERT_STATUS_OK(session_object.Run(*io_binding));
+  check_y(8);
+  EXPECT_EQ(x_data(), second_buffer);
+  EXPECT_EQ(y_data(), first_buffer);
+
+  // binding the input again resets the state
+  bind_x();
+  ASSERT_STATUS_OK(session_object.Run(*io_binding));
+  check_y(2);
+}
+
+TEST(InferenceSessionTests, TestIOBindingGrowableOutput) {
+  const std::string model_file_name = "growable_output_test_graph.onnx";
+  CreateSquareModel(model_file_name, 0);
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestIOBindingGrowableOutput";
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(model_file_name));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+  ASSERT_STATUS_OK(io_binding->BindGrowableOutput("Y"));
+  EXPECT_FALSE(io_binding->BindGrowableOutput("X").IsOK());
+
+  auto run = [&](int64_t batch) {
+    std::vector<float> values(static_cast<size_t>(batch * 2));
+    std::vector<float> expected_values(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = static_cast<float>(i);
+      expected_values[i] = values[i] * values[i];
+    }
+    OrtValue x;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {batch, 2}, values, &x);
+    ASSERT_STATUS_OK(io_binding->BindInput("X", x));
+    ASSERT_STATUS_OK(session_object.Run(*io_binding));
+    VerifyOutputs(io_binding->GetOutputs(), {batch, 2}, expected_values);
+  };
+  auto y_data = [&]() { return io_binding->GetOutputs()[0].Get<Tensor>().DataRaw(); };
+
+  run(3);
+  const void* first_buffer = y_data();
+
+  // a smaller output reuses the buffer
+  run(1);
+  EXPECT_EQ(y_data(), first_buffer);
+  run(3);
+  EXPECT_EQ(y_data(), first_buffer);
+
+  // a larger output grows it, and the grown buffer is reused
+  run(4);
+  const void* grown_buffer = y_data();
+  run(2);
+  EXPECT_EQ(y_data(), grown_buffer);
+}
+
+TEST(InferenceSessionTests, InvalidStatefulIOPairs) {
+  for (const char* pairs : {"Y", "Z:X", "Y:Z", "Y:X;Y:X"}) {
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStatefulIOPairs, pairs));
+
+    InferenceSession session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+    auto status = session_object.Initialize();
+    ASSERT_FALSE(status.IsOK()) << pairs;
+    EXPECT_NE(status.ErrorMessage().find(kOrtSessionOptionsConfigStatefulIOPairs), std::string::npos);
+  }
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -2644,6 +3439,40 @@ TEST(InferenceSessionTests, InvalidSessionEnvCombination) {
   }
 }
 
+// The parallel executor schedules nodes on the intra-op thread pool when the unified thread pool is configured
+TEST(InferenceSessionTests, CheckIfUnifiedThreadPoolIsBeingUsed) {
+  SessionOptions so;
+  so.use_per_session_threads = true;
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.intra_op_param.thread_pool_size = 2;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseUnifiedThreadPool, "1"));
+
+  so.session_logid = "CheckIfUnifiedThreadPoolIsBeingUsed";
+  auto logging_manager = std::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(new CLogSink()), logging::Severity::kVERBOSE, false,
+      LoggingManager::InstanceType::Temporal);
+
+  std::unique_ptr<Environment> env;
+  auto st = Environment::Create(std::move(logging_manager), env);
+  ASSERT_TRUE(st.IsOK());
+
+  InferenceSessionTestGlobalThreadPools session_object{so, *env.get()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  auto intra_tp_from_session = session_object.GetIntraOpThreadPoolToUse();
+  auto inter_tp_from_session = session_object.GetInterOpThreadPoolToUse();
+  ASSERT_TRUE(intra_tp_from_session != nullptr);
+  ASSERT_TRUE(inter_tp_from_session == intra_tp_from_session);
+  ASSERT_TRUE(session_object.GetSessionState().GetInterOpThreadPool() == intra_tp_from_session);
+  ASSERT_TRUE(session_object.GetSessionOptions().execution_mode == ExecutionMode::ORT_PARALLEL);
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+  run_options.run_log_severity_level = static_cast<int>(Severity::kVERBOSE);
+  RunModel(session_object, run_options);
+}
+
 // Tests for sharing allocators between sessions
 class InferenceSessionTestSharingAllocator : public InferenceSessionWrapper {
  public:
@@ -2749,6 +3578,63 @@ TEST(InferenceSessionTests, AllocatorSharing_EnsureSessionsDontUseSameOrtCreated
             sess2.GetSessionState().GetAllocator(mem_info).get());
 }
 
+// Ensure sessions sharing an allocator track their own usage of it.
+TEST(InferenceSessionTests, AllocatorSharing_PerSessionAccounting) {
+  if constexpr (!SessionOptions::DEFAULT_USE_PER_SESSION_THREADS) {
+    GTEST_SKIP() << "Skipping the test";
+  }
+  auto logging_manager = std::make_unique<logging::LoggingManager>(
+      std::unique_ptr<ISink>(new CLogSink()), logging::Severity::kVERBOSE, false,
+      LoggingManager::InstanceType::Temporal);
+
+  std::unique_ptr<Environment> env;
+  auto st = Environment::Create(std::move(logging_manager), env);
+  ASSERT_TRUE(st.IsOK());
+  OrtMemoryInfo mem_info{onnxruntime::CPU, OrtArenaAllocator};
+  AllocatorCreationInfo device_info{
+      [mem_info](int) { return std::make_unique<CPUAllocator>(mem_info); },
+      0, true};
+
+  AllocatorPtr allocator_ptr = CreateAllocator(device_info);
+  st = env->RegisterAllocator(allocator_ptr);
+  ASSERT_STATUS_OK(st);
+
+  SessionOptions so1;
+  ASSERT_STATUS_OK(so1.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseEnvAllocators, "1"));
+  ASSERT_STATUS_OK(so1.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnvAllocatorMemoryLimit, "1048576"));
+  InferenceSessionTestSharingAllocator sess1(so1, *env);
+  ASSERT_STATUS_OK(sess1.Load(MODEL_URI));
+  ASSERT_STATUS_OK(sess1.Initialize());
+
+  SessionOptions so2;
+  ASSERT_STATUS_OK(so2.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseEnvAllocators, "1"));
+  ASSERT_STATUS_OK(so2.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableEnvAllocatorAccounting, "1"));
+  InferenceSessionTestSharingAllocator sess2(so2, *env);
+  ASSERT_STATUS_OK(sess2.Load(MODEL_URI));
+  ASSERT_STATUS_OK(sess2.Initialize());
+
+  // each session accounts for its own allocations from the env allocator
+  auto alloc1 = sess1.GetSessionState().GetAllocator(mem_info);
+  auto alloc2 = sess2.GetSessionState().GetAllocator(mem_info);
+  ASSERT_NE(alloc1.get(), allocator_ptr.get());
+  ASSERT_NE(alloc1.get(), alloc2.get());
+  ASSERT_EQ(static_cast<AccountingAllocator*>(alloc1.get())->GetWrappedAllocator().get(), allocator_ptr.get());
+  ASSERT_EQ(static_cast<AccountingAllocator*>(alloc2.get())->GetWrappedAllocator().get(), allocator_ptr.get());
+
+  RunOptions run_options;
+  RunModel(sess1, run_options);
+
+  AllocatorStats stats1;
+  alloc1->GetStats(&stats1);
+  EXPECT_GT(stats1.max_bytes_in_use, 0);
+  EXPECT_EQ(stats1.bytes_limit, 1048576);
+
+  AllocatorStats stats2;
+  alloc2->GetStats(&stats2);
+  EXPECT_EQ(stats2.bytes_limit, 0);
+  EXPECT_LT(stats2.max_bytes_in_use, stats1.max_bytes_in_use);
+}
+
 class InferenceSessionTestSharingInitializer : public InferenceSessionWrapper {
  public:
   InferenceSessionTestSharingInitializer(const SessionOptions& session_options,
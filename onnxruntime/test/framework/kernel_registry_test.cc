@@ -6,7 +6,10 @@
 #include <gtest/gtest.h>
 
 #include "asserts.h"
+#include "core/framework/kernel_type_str_resolver.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
 
 namespace onnxruntime::test {
 
@@ -101,4 +104,53 @@ TEST(KernelRegistryTests, two_versions4) {
   ASSERT_STATUS_NOT_OK(RegKernels(r, function_table, CreateFakeKernel));
 }
 
+#if !defined(ORT_MINIMAL_BUILD)
+// Nodes with the same signature share the lookup, which is redone after a kernel is registered.
+TEST(KernelRegistryTests, cached_lookups) {
+  KernelRegistry r;
+  std::vector<std::unique_ptr<KernelDef>> function_table;
+  function_table.emplace_back(KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).SetName("Elu").SetDomain("").SinceVersion(6).Provider(kCpuExecutionProvider).Build());
+  ASSERT_STATUS_OK(RegKernels(r, function_table, CreateFakeKernel));
+
+  Model model("cached_lookups", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  ONNX_NAMESPACE::TypeProto double_tensor;
+  double_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_DOUBLE);
+  auto& x = graph.GetOrCreateNodeArg("x", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("y", &float_tensor);
+  auto& z = graph.GetOrCreateNodeArg("z", &float_tensor);
+  auto& d = graph.GetOrCreateNodeArg("d", &double_tensor);
+  auto& e = graph.GetOrCreateNodeArg("e", &double_tensor);
+  Node& node_1 = graph.AddNode("elu_1", "Elu", "", {&x}, {&y});
+  Node& node_2 = graph.AddNode("elu_2", "Elu", "", {&y}, {&z});
+  Node& node_3 = graph.AddNode("elu_3", "Elu", "", {&d}, {&e});
+  for (Node* node : {&node_1, &node_2, &node_3}) {
+    node->SetExecutionProviderType(kCpuExecutionProvider);
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  OpSchemaKernelTypeStrResolver resolver;
+  const KernelCreateInfo* kci_1 = nullptr;
+  const KernelCreateInfo* kci_2 = nullptr;
+  ASSERT_STATUS_OK(r.TryFindKernel(node_1, kCpuExecutionProvider, resolver, &kci_1));
+  ASSERT_STATUS_OK(r.TryFindKernel(node_2, kCpuExecutionProvider, resolver, &kci_2));
+  ASSERT_NE(kci_1, nullptr);
+  ASSERT_EQ(kci_1, kci_2);
+
+  const KernelCreateInfo* kci_3 = nullptr;
+  ASSERT_STATUS_NOT_OK(r.TryFindKernel(node_3, kCpuExecutionProvider, resolver, &kci_3));
+  ASSERT_EQ(kci_3, nullptr);
+
+  function_table.clear();
+  function_table.emplace_back(KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()).SetName("Elu").SetDomain("").SinceVersion(6).Provider(kCpuExecutionProvider).Build());
+  ASSERT_STATUS_OK(RegKernels(r, function_table, CreateFakeKernel));
+  ASSERT_STATUS_OK(r.TryFindKernel(node_3, kCpuExecutionProvider, resolver, &kci_3));
+  ASSERT_NE(kci_3, nullptr);
+  ASSERT_NE(kci_3, kci_1);
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
 }  // namespace onnxruntime::test
@@ -557,6 +557,21 @@ TEST(OrtModelOnlyTests, LoadOrtFormatModelFromBufferNoCopyInitializersUseBuffer)
   RunOrtModel(test_info);
 }
 
+// Load the model from a memory mapped file instead of reading it into a buffer
+TEST(OrtModelOnlyTests, LoadOrtFormatModelMemoryMapped) {
+  OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigMapORTModelFile, "1"));
+  RunOrtModel(test_info);
+}
+
+// Load the model from a memory mapped file and use the mapped bytes for initializers
+TEST(OrtModelOnlyTests, LoadOrtFormatModelMemoryMappedInitializersUseMappedFile) {
+  OrtModelTestInfo test_info = GetTestInfoForLoadOrtFormatModel();
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigMapORTModelFile, "1"));
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "1"));
+  RunOrtModel(test_info);
+}
+
 // regression test for 2 issues covered by PR #17000 (internally reported issue).
 // 1) allocation planner broke in minimal build when subgraph had no nodes.
 // 2) usage of a sequence data type caused an exception due to IsSparseTensor() throwing
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cstdio>
 #include <iostream>
 #include <absl/base/config.h>
 
@@ -9,6 +10,7 @@
 #include "core/framework/graph_partitioner.h"
 #include "core/framework/kernel_registry.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/prepacked_weights_container.h"
 #include "core/framework/bfc_arena.h"
 #include "core/framework/session_state.h"
 #include "core/graph/graph_utils.h"
@@ -389,6 +391,11 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
+  bool CanSkipPrePackWithPersistedBuffers(int input_idx) const override {
+    ORT_UNUSED_PARAMETER(input_idx);
+    return true;
+  }
+
   int prepack_calls_count = 0;
   int store_pre_packed_weight_calls_count = 0;
   IAllocatorUniquePtr<void> weight_packed_;
@@ -983,6 +990,190 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test4) {
   ASSERT_EQ(if_node_branches_shared_prepack_counter_2, static_cast<size_t>(2));
 }
 
+// Pre-packing enabled + pre-packed weights file = pre-packed weights of all constant initializers are cached, and
+// a container loaded from the file provides them to the kernels of another session without calling PrePack()
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test5) {
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  // Enable pre-packing
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+
+  const PathString prepacked_weights_file = ORT_TSTR("session_state_test_prepacked_weights.bin");
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigPrepackedWeightsFile] =
+      ToUTF8String(prepacked_weights_file);
+
+  // First session/model, writing its pre-packed weights to the file
+  PrepackedWeightsContainer prepacked_weights_container_1;
+  Model model_1("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+  CreateSimpleGraph(model_1.MainGraph());
+  PlaceAllNodesToCPUEP(model_1.MainGraph());
+  SessionState session_state_1(model_1.MainGraph(),
+                               execution_providers,
+                               tp.get(),
+                               nullptr, /*inter_op_thread_pool*/
+                               dtm,
+                               DefaultLoggingManager().DefaultLogger(),
+                               profiler,
+                               sess_options,
+                               &prepacked_weights_container_1);
+
+  ASSERT_STATUS_OK(session_state_1.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                        kernel_registry_manager));
+
+  // The initializer is not shared, but its pre-packed weight is cached as a pre-packed weights file is used
+  const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_1.GetKernel(0));
+  ASSERT_EQ(kernel->store_pre_packed_weight_calls_count, 1);
+  ASSERT_EQ(prepacked_weights_container_1.GetNumberOfElements(), static_cast<size_t>(1));
+  ASSERT_STATUS_OK(prepacked_weights_container_1.SaveToFile(prepacked_weights_file));
+
+  // Second session/model, using the pre-packed weights mapped from the file
+  PrepackedWeightsContainer prepacked_weights_container_2;
+  ASSERT_STATUS_OK(prepacked_weights_container_2.LoadFromFile(prepacked_weights_file));
+  ASSERT_TRUE(prepacked_weights_container_2.IsFileLoaded(prepacked_weights_file));
+  ASSERT_EQ(prepacked_weights_container_2.GetNumberOfElements(), static_cast<size_t>(1));
+
+  Model model_2("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+  CreateSimpleGraph(model_2.MainGraph());
+  PlaceAllNodesToCPUEP(model_2.MainGraph());
+  SessionState session_state_2(model_2.MainGraph(),
+                               execution_providers,
+                               tp.get(),
+                               nullptr, /*inter_op_thread_pool*/
+                               dtm,
+                               DefaultLoggingManager().DefaultLogger(),
+                               profiler,
+                               sess_options,
+                               &prepacked_weights_container_2);
+
+  ASSERT_STATUS_OK(session_state_2.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                        kernel_registry_manager));
+
+  // The kernel uses the weight from the file, which has the contents of the weight pre-packed by the first session
+  kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state_2.GetKernel(0));
+  ASSERT_EQ(kernel->prepack_calls_count, 0);
+  ASSERT_EQ(kernel->store_pre_packed_weight_calls_count, 1);
+  ASSERT_EQ(session_state_2.GetSkippedPrePacksCounter(), static_cast<size_t>(1));
+  ASSERT_EQ(session_state_2.GetUsedSharedPrePackedWeightCounter(), static_cast<size_t>(1));
+  ASSERT_EQ(prepacked_weights_container_2.GetNumberOfElements(), static_cast<size_t>(1));
+  const float* weight_packed = reinterpret_cast<const float*>(kernel->weight_packed_.get());
+  ASSERT_EQ(weight_packed[0], 1.2345f);
+  ASSERT_EQ(weight_packed[1], 1.2345f * 2.f);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(weight_packed) % 64, static_cast<uintptr_t>(0));
+
+  std::remove(ToUTF8String(prepacked_weights_file).c_str());
+}
+
+// Pre-packing enabled + parallel initialization = kernels are created and pre-packed on the thread pool
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test6) {
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  // Enable pre-packing
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  // Enable parallel initialization
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigEnableParallelInitialization] = "1";
+
+  Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+
+  CreateGraphWithSubgraph(model.MainGraph());
+  PlaceAllNodesToCPUEP(model.MainGraph());
+  SessionState session_state(model.MainGraph(),
+                             execution_providers,
+                             tp.get(),
+                             nullptr, /*inter_op_thread_pool*/
+                             dtm,
+                             DefaultLoggingManager().DefaultLogger(),
+                             profiler,
+                             sess_options);
+
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                      kernel_registry_manager));
+
+  // All the kernels were created
+  ASSERT_NE(session_state.GetKernel(0), nullptr);
+  ASSERT_NE(session_state.GetKernel(1), nullptr);
+
+  auto if_index = 1;
+  if (session_state.GetKernel(0)->Node().OpType() == "If") {
+    if_index = 0;
+  }
+
+  // Each branch pre-packed its weight, without any caching
+  const auto& if_node_session_states = session_state.GetSubgraphSessionStateMap().at(if_index);
+  for (const auto* branch : {"then_branch", "else_branch"}) {
+    const auto& branch_session_state = *if_node_session_states.at(branch);
+    ASSERT_EQ(branch_session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+    ASSERT_EQ(branch_session_state.GetUsedSharedPrePackedWeightCounter(), static_cast<size_t>(0));
+  }
+}
+
+// Lazy subgraph initialization: the subgraph session states are finalized on the first execution of their node
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test7) {
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  // Enable pre-packing
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  // Enable lazy subgraph initialization
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigEnableLazySubgraphInitialization] = "1";
+
+  Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+
+  CreateGraphWithSubgraph(model.MainGraph());
+  PlaceAllNodesToCPUEP(model.MainGraph());
+  SessionState session_state(model.MainGraph(),
+                             execution_providers,
+                             tp.get(),
+                             nullptr, /*inter_op_thread_pool*/
+                             dtm,
+                             DefaultLoggingManager().DefaultLogger(),
+                             profiler,
+                             sess_options);
+
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                      kernel_registry_manager));
+
+  auto if_index = 1;
+  if (session_state.GetKernel(0)->Node().OpType() == "If") {
+    if_index = 0;
+  }
+
+  // The branches are not finalized yet
+  const auto& if_node_session_states = session_state.GetSubgraphSessionStateMap().at(if_index);
+  for (const auto* branch : {"then_branch", "else_branch"}) {
+    const auto& branch_session_state = *if_node_session_states.at(branch);
+    ASSERT_EQ(branch_session_state.GetExecutionPlan(), nullptr);
+    ASSERT_EQ(branch_session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(0));
+  }
+
+  // Finalizing them more than once is a no-op
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_STATUS_OK(session_state.EnsureSubgraphSessionStatesFinalized(if_index));
+    for (const auto* branch : {"then_branch", "else_branch"}) {
+      const auto& branch_session_state = *if_node_session_states.at(branch);
+      ASSERT_NE(branch_session_state.GetExecutionPlan(), nullptr);
+      ASSERT_EQ(branch_session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+    }
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          SessionStatePrepackingTest,
                          testing::Values(PrepackingTestParam{false, false},
@@ -6,6 +6,7 @@
 #include "core/common/span_utils.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
+#include "core/graph/memory_minimizing_order.h"
 #include "core/graph/model.h"
 #include "core/graph/op.h"
 #include "test/providers/provider_test_utils.h"
@@ -391,6 +392,40 @@ TEST_F(GraphTest, UnusedValueInfoSerializes) {
   EXPECT_TRUE(Model::Save(*model, "graph_with_unused_value_info.onnx").IsOK());
 }
 
+// The NodeProtos of a loaded model are released and the GraphProto is regenerated from the graph when requested.
+TEST_F(GraphTest, LoadedNodeProtosAreRegenerated) {
+  ModelProto m;
+  m.set_ir_version(4);
+  ImportOpset(m, "", 11);
+  GraphProto& g = *m.mutable_graph();
+  NodeProto* node = g.add_node();
+  node->set_name("unique");
+  *node->add_input() = "x";
+  *node->add_output() = "y";
+  node->set_op_type("Unique");
+  node->set_domain("");
+  ValueInfoProto* input1 = g.add_input();
+  input1->set_name("x");
+  SetTypeAndShape(input1->mutable_type()->mutable_tensor_type(), 1, {3, 4, 5});
+  ValueInfoProto* output = g.add_output();
+  output->set_name("y");
+  SetTypeAndShape(output->mutable_type()->mutable_tensor_type(), 1, {60});
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(std::move(m), model, nullptr, *logger_));
+
+  Graph& graph = model->MainGraph();
+  EXPECT_TRUE(graph.GraphProtoSyncNeeded());
+  const GraphProto& graph_proto = graph.ToGraphProto();
+  ASSERT_EQ(graph_proto.node_size(), 1);
+  EXPECT_EQ(graph_proto.node(0).name(), "unique");
+  EXPECT_EQ(graph_proto.node(0).op_type(), "Unique");
+  ASSERT_EQ(graph_proto.input_size(), 1);
+  EXPECT_EQ(graph_proto.input(0).name(), "x");
+  ASSERT_EQ(graph_proto.output_size(), 1);
+  EXPECT_EQ(graph_proto.output(0).name(), "y");
+  EXPECT_FALSE(graph.GraphProtoSyncNeeded());
+}
+
 TEST_F(GraphTest, WrongOpset) {
   ModelProto m;
   m.set_ir_version(3);
@@ -1154,6 +1189,67 @@ TEST_F(GraphTest, GraphConstruction_PriorityBasedTopologicalSort_MultiLayerRecom
   }
 }
 
+TEST_F(GraphTest, GraphConstruction_MemoryMinimizingTopologicalSort) {
+  Model model("graph_1", false, *logger_);
+  auto& graph = model.MainGraph();
+
+  /*
+                          |
+                  node_0 (Identity)
+                      /      \
+        node_1 (Identity)   node_3 (Identity)    node_1 and node_3 have large outputs
+                    |         |
+        node_2 (Identity)   node_4 (Identity)
+                      \       /
+                      node_5 (Merge)
+                          |
+  */
+
+  TypeProto small_tensor;
+  small_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  small_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  TypeProto large_tensor;
+  large_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+  large_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1000);
+
+  auto& input_arg0 = graph.GetOrCreateNodeArg("node_0_in_1", &small_tensor);
+  auto& output_arg0 = graph.GetOrCreateNodeArg("node_0_out_1", &small_tensor);
+  auto& output_arg1 = graph.GetOrCreateNodeArg("node_1_out_1", &large_tensor);
+  auto& output_arg2 = graph.GetOrCreateNodeArg("node_2_out_1", &small_tensor);
+  auto& output_arg3 = graph.GetOrCreateNodeArg("node_3_out_1", &large_tensor);
+  auto& output_arg4 = graph.GetOrCreateNodeArg("node_4_out_1", &small_tensor);
+  auto& output_arg5 = graph.GetOrCreateNodeArg("node_5_out_1", &small_tensor);
+
+  graph.AddNode("node_0", "Identity_Fake", "node 0", {&input_arg0}, {&output_arg0});
+  graph.AddNode("node_1", "Identity_Fake", "node 1", {&output_arg0}, {&output_arg1});
+  graph.AddNode("node_2", "Identity_Fake", "node 2", {&output_arg1}, {&output_arg2});
+  graph.AddNode("node_3", "Identity_Fake", "node 3", {&output_arg0}, {&output_arg3});
+  graph.AddNode("node_4", "Identity_Fake", "node 4", {&output_arg3}, {&output_arg4});
+  graph.AddNode("node_5", "Merge_Fake", "node 5", {&output_arg2, &output_arg4}, {&output_arg5});
+
+  auto status = graph.Resolve();
+  EXPECT_TRUE(status.IsOK()) << status.ErrorMessage();
+  GraphViewer graph_viewer(graph);
+
+  auto& order = graph_viewer.GetNodesInTopologicalOrder(ExecutionOrder::MEMORY_MINIMIZING);
+  ASSERT_EQ(order.size(), 6u);
+  // Each large output is consumed before the other one is produced.
+  constexpr size_t small_size = sizeof(int32_t);
+  constexpr size_t large_size = 1000 * sizeof(int32_t);
+  EXPECT_EQ(EstimatePeakActivationMemory(graph_viewer, order), 2 * small_size + large_size);
+
+  // Both large outputs are live if node_3 runs before node_2.
+  std::vector<NodeIndex> breadth_first_order;
+  for (const auto* name : {"node_0", "node_1", "node_3", "node_2", "node_4", "node_5"}) {
+    for (auto node_index : order) {
+      if (graph.GetNode(node_index)->Name() == name) {
+        breadth_first_order.push_back(node_index);
+      }
+    }
+  }
+  EXPECT_EQ(EstimatePeakActivationMemory(graph_viewer, breadth_first_order), small_size + 2 * large_size);
+}
+
 TEST_F(GraphTest, GraphConstruction_CheckGraphInputOutputOrderMaintained) {
   Model model("graph_1", false, *logger_);
   auto& graph = model.MainGraph();
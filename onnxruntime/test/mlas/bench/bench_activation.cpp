@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+using ComputeFunction = void(MLASCALL*)(const float* Input, float* Output, size_t N);
+
+void COMPUTE(benchmark::State& state, ComputeFunction compute) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  auto input = RandomVectorUniform(N, -4.0f, 4.0f);
+  std::vector<float> output(N);
+
+  for (auto _ : state) {
+    compute(input.data(), output.data(), N);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * N));
+}
+
+static void ComputeModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N"});
+  // odd sizes, which use the remainder loops
+  b->Arg(15);
+  b->Arg(1023);
+  // BERT base GELU (Erf) of sequence length 128, LSTM gates (Logistic, Tanh), MobileNet activations
+  b->Arg(128 * 3072);
+  b->Arg(4 * 512);
+  b->Arg(112 * 112 * 32);
+}
+
+BENCHMARK_CAPTURE(COMPUTE, Erf, static_cast<ComputeFunction>(MlasComputeErf))->Apply(ComputeModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(COMPUTE, Exp, static_cast<ComputeFunction>(MlasComputeExp))->Apply(ComputeModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(COMPUTE, Logistic, static_cast<ComputeFunction>(MlasComputeLogistic))
+    ->Apply(ComputeModelSizes)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(COMPUTE, Tanh, static_cast<ComputeFunction>(MlasComputeTanh))->Apply(ComputeModelSizes)->UseRealTime();
+
+// the activations applied to the output of a GEMM or convolution, with a bias per row
+void ACTIVATION(benchmark::State& state, MLAS_ACTIVATION_KIND kind) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = kind;
+  switch (kind) {
+    case MlasLeakyReluActivation:
+      activation.Parameters.LeakyRelu.alpha = 0.01f;
+      break;
+    case MlasClipActivation:
+      activation.Parameters.Clip.minimum = 0.0f;
+      activation.Parameters.Clip.maximum = 6.0f;
+      break;
+    case MlasHardSigmoidActivation:
+      activation.Parameters.HardSigmoid.alpha = 0.2f;
+      activation.Parameters.HardSigmoid.beta = 0.5f;
+      break;
+    default:
+      break;
+  }
+
+  auto buffer = RandomVectorUniform(M * N, -4.0f, 4.0f);
+  auto bias = RandomVectorUniform(M, -1.0f, 1.0f);
+
+  for (auto _ : state) {
+    MlasActivation(&activation, buffer.data(), bias.data(), M, N, N);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * M * N));
+}
+
+static void ActivationModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N"});
+  // output channels by output image size of convolutions in ResNet-50 and MobileNetV2
+  b->Args({64, 112 * 112});
+  b->Args({256, 56 * 56});
+  b->Args({2048, 7 * 7});
+  b->Args({144, 56 * 56});
+  b->Args({15, 1023});
+}
+
+BENCHMARK_CAPTURE(ACTIVATION, Relu, MlasReluActivation)->Apply(ActivationModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, LeakyRelu, MlasLeakyReluActivation)->Apply(ActivationModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Tanh, MlasTanhActivation)->Apply(ActivationModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Logistic, MlasLogisticActivation)->Apply(ActivationModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, Clip, MlasClipActivation)->Apply(ActivationModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(ACTIVATION, HardSigmoid, MlasHardSigmoidActivation)->Apply(ActivationModelSizes)->UseRealTime();
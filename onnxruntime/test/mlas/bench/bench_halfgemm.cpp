@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+#include <memory>
+#include <numeric>
+
+static const std::vector<std::string> halfgemm_bench_arg_names = {"M", "N", "K", "Threads"};
+
+void HALFGEMM(benchmark::State& state, bool pack_b) {
+  if (!MlasHalfGemmAccelerationSupported()) {
+    state.SkipWithError("half precision GEMM is not accelerated on this CPU");
+    return;
+  }
+
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  if (state.range(3) <= 0) throw std::invalid_argument("Threads must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  const size_t threads = static_cast<size_t>(state.range(3));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = int(threads);
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  auto A_float = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B_float = RandomVectorUniform(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<MLAS_FP16> A(A_float.size());
+  std::vector<MLAS_FP16> B(B_float.size());
+  MlasConvertFloatToHalfBuffer(A_float.data(), A.data(), A.size());
+  MlasConvertFloatToHalfBuffer(B_float.data(), B.data(), B.size());
+  std::vector<MLAS_FP16> C(static_cast<size_t>(M * N));
+
+  MLAS_HALF_GEMM_DATA_PARAMS params;
+  params.A = A.data();
+  params.lda = K;
+  params.B = B.data();
+  params.ldb = N;
+  params.C = C.data();
+  params.ldc = N;
+
+  std::vector<uint8_t> B_packed;
+  if (pack_b) {
+    B_packed.resize(MlasHalfGemmPackBSize(N, K, false));
+    MlasHalfGemmPackB(N, K, B.data(), N, B_packed.data());
+    params.B = B_packed.data();
+    params.ldb = 0;
+  }
+
+  // warming up run
+  MlasHalfGemmBatch(M, N, K, 1, &params, tp.get());
+
+  for (auto _ : state) {
+    MlasHalfGemmBatch(M, N, K, 1, &params, tp.get());
+  }
+}
+
+static void HalfGemmModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(halfgemm_bench_arg_names);
+  for (int threads : {1, 8}) {
+    // BERT base, sequence length 128: QKV and attention output, FFN up and down projections
+    b->Args({128, 768, 768, threads});
+    b->Args({128, 3072, 768, threads});
+    b->Args({128, 768, 3072, threads});
+    // LLaMA 7B token generation and prompt processing: attention and MLP projections
+    b->Args({1, 4096, 4096, threads});
+    b->Args({1, 11008, 4096, threads});
+    b->Args({1, 4096, 11008, threads});
+    b->Args({512, 4096, 4096, threads});
+  }
+}
+
+BENCHMARK_CAPTURE(HALFGEMM, NoPackB, false)->Apply(HalfGemmModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, PackB, true)->Apply(HalfGemmModelSizes)->UseRealTime();
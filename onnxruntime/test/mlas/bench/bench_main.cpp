@@ -3,4 +3,58 @@
 
 #include <benchmark/benchmark.h>
 
-BENCHMARK_MAIN();
+#include <string>
+
+#include "mlas.h"
+
+static const char* MlasTargetName() {
+#if defined(MLAS_TARGET_AMD64)
+  return "amd64";
+#elif defined(MLAS_TARGET_IX86)
+  return "ix86";
+#elif defined(MLAS_TARGET_ARM64EC)
+  return "arm64ec";
+#elif defined(MLAS_TARGET_ARM64)
+  return "arm64";
+#elif defined(MLAS_TARGET_ARM)
+  return "arm";
+#elif defined(MLAS_TARGET_POWER)
+  return "power";
+#elif defined(MLAS_TARGET_WASM_SIMD)
+  return "wasm_simd";
+#elif defined(MLAS_TARGET_WASM)
+  return "wasm";
+#elif defined(MLAS_TARGET_LARCH64)
+  return "larch64";
+#else
+  return "unknown";
+#endif
+}
+
+// Adds the kernels MLAS dispatches to on this CPU to the context of the results, which is written to the JSON output
+// of --benchmark_out=<file> --benchmark_out_format=json. compare_bench_results.py warns when the results of a baseline
+// and a new build come from different kernels, e.g. AVX2 and AVX512 (NCHWc block size 8 and 16).
+static void AddMlasContext() {
+  benchmark::AddCustomContext("mlas_target", MlasTargetName());
+  benchmark::AddCustomContext("mlas_preferred_buffer_alignment", std::to_string(MlasGetPreferredBufferAlignment()));
+  benchmark::AddCustomContext("mlas_nchwc_block_size", std::to_string(MlasNchwcGetBlockSize()));
+#if defined(MLAS_TARGET_AMD64_IX86)
+  benchmark::AddCustomContext("mlas_u8s8_overflow", MlasPlatformU8S8Overflow() ? "1" : "0");
+#endif
+  benchmark::AddCustomContext("mlas_fp16_acceleration", MlasFp16AccelerationSupported() ? "1" : "0");
+  benchmark::AddCustomContext("mlas_half_gemm_acceleration", MlasHalfGemmAccelerationSupported() ? "1" : "0");
+#if defined(MLAS_SUPPORTS_SBGEMM)
+  benchmark::AddCustomContext("mlas_bf16_acceleration", MlasBf16AccelerationSupported() ? "1" : "0");
+#endif
+}
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  AddMlasContext();
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
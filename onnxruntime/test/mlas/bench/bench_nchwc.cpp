@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+#include <memory>
+
+static const std::vector<std::string> nchwc_conv_bench_arg_names = {"N", "G", "Cpg", "Fpg", "H", "W", "K", "P", "S",
+                                                                    "Threads"};
+
+static std::unique_ptr<onnxruntime::concurrency::ThreadPool> CreateNchwcThreadPool(int64_t threads) {
+  if (threads <= 0) throw std::invalid_argument("Threads must greater than 0!");
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = int(threads);
+  tpo.auto_set_affinity = true;
+  return std::unique_ptr<onnxruntime::concurrency::ThreadPool>(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+}
+
+static int64_t AlignToBlockSize(int64_t channels, int64_t block_size) {
+  return (channels + block_size - 1) / block_size * block_size;
+}
+
+// The filter and the input are in the layouts MlasNchwcConv expects for the kind of convolution, their values don't
+// matter for the performance so they are not reordered from NCHW.
+void NCHWC_CONV(benchmark::State& state) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (block_size <= 1) {
+    state.SkipWithError("NCHWc is not supported on this CPU");
+    return;
+  }
+
+  for (int i = 0; i < 10; i++) {
+    if (state.range(i) <= 0 && i != 7) throw std::invalid_argument("all args except P must greater than 0!");
+  }
+  if (state.range(7) < 0) throw std::invalid_argument("P must not be negative!");
+
+  const int64_t batch_size = state.range(0);
+  const int64_t groups = state.range(1);
+  const int64_t input_channels_per_group = state.range(2);
+  const int64_t output_channels_per_group = state.range(3);
+  const int64_t H = state.range(4);
+  const int64_t W = state.range(5);
+  const int64_t K = state.range(6);
+  const int64_t P = state.range(7);
+  const int64_t S = state.range(8);
+  auto tp = CreateNchwcThreadPool(state.range(9));
+
+  const int64_t OH = (H + 2 * P - K) / S + 1;
+  const int64_t OW = (W + 2 * P - K) / S + 1;
+  if (OH <= 0 || OW <= 0) throw std::invalid_argument("kernel must not be larger than the padded input!");
+
+  const int64_t input_channels = groups * input_channels_per_group;
+  const int64_t output_channels = AlignToBlockSize(groups * output_channels_per_group, block_size);
+
+  // the same selection of the kind of convolution as the NCHWc transformer: depthwise and NCHWc convolutions use the
+  // blocked input, while the input of a convolution with few input channels, e.g. the stem of a CNN, stays NCHW.
+  const bool is_depthwise = groups > 1 && input_channels_per_group == 1 && output_channels_per_group == 1;
+  const bool reorder_input = is_depthwise || input_channels_per_group >= block_size;
+  const int64_t conv_input_channels = reorder_input ? AlignToBlockSize(input_channels, block_size) : input_channels;
+  const int64_t filter_input_channels =
+      (is_depthwise || !reorder_input) ? input_channels_per_group : AlignToBlockSize(input_channels, block_size);
+
+  const int64_t input_shape[] = {batch_size, conv_input_channels, H, W};
+  const int64_t kernel_shape[] = {K, K};
+  const int64_t dilation_shape[] = {1, 1};
+  const int64_t padding[] = {P, P, P, P};
+  const int64_t stride_shape[] = {S, S};
+  const int64_t output_shape[] = {batch_size, output_channels, OH, OW};
+
+  auto input = RandomVectorUniform(std::vector<int64_t>(input_shape, input_shape + 4), -1.0f, 1.0f);
+  auto filter = RandomVectorUniform(std::vector<int64_t>{output_channels, filter_input_channels, K, K}, -1.0f, 1.0f);
+  auto bias = RandomVectorUniform(std::vector<int64_t>{output_channels}, -1.0f, 1.0f);
+  std::vector<float> output(static_cast<size_t>(batch_size * output_channels * OH * OW));
+
+  MLAS_ACTIVATION activation;
+  activation.ActivationKind = MlasReluActivation;
+
+  MlasNchwcConv(input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape,
+                static_cast<size_t>(groups), input.data(), filter.data(), bias.data(), output.data(),
+                &activation, true, tp.get());
+
+  for (auto _ : state) {
+    MlasNchwcConv(input_shape, kernel_shape, dilation_shape, padding, stride_shape, output_shape,
+                  static_cast<size_t>(groups), input.data(), filter.data(), bias.data(), output.data(),
+                  &activation, true, tp.get());
+  }
+}
+
+static void NchwcConvModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(nchwc_conv_bench_arg_names);
+  for (int threads : {1, 8}) {
+    // ResNet-50: stem, bottleneck 1x1 reduce, 3x3 and 1x1 expand, strided 3x3
+    b->Args({1, 1, 3, 64, 224, 224, 7, 3, 2, threads});
+    b->Args({1, 1, 256, 64, 56, 56, 1, 0, 1, threads});
+    b->Args({1, 1, 64, 64, 56, 56, 3, 1, 1, threads});
+    b->Args({1, 1, 64, 256, 56, 56, 1, 0, 1, threads});
+    b->Args({1, 1, 128, 128, 56, 56, 3, 1, 2, threads});
+    b->Args({1, 1, 512, 2048, 7, 7, 1, 0, 1, threads});
+    // MobileNetV2: depthwise 3x3 and pointwise projections
+    b->Args({1, 144, 1, 1, 56, 56, 3, 1, 1, threads});
+    b->Args({1, 384, 1, 1, 14, 14, 3, 1, 1, threads});
+    b->Args({1, 1, 144, 24, 56, 56, 1, 0, 1, threads});
+  }
+}
+
+BENCHMARK(NCHWC_CONV)->Apply(NchwcConvModelSizes)->UseRealTime();
+
+void REORDER_INPUT_NCHW(benchmark::State& state) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (block_size <= 1) {
+    state.SkipWithError("NCHWc is not supported on this CPU");
+    return;
+  }
+  if (state.range(0) <= 0) throw std::invalid_argument("C must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("HW must greater than 0!");
+  const int64_t C = state.range(0);
+  const int64_t HW = state.range(1);
+
+  auto input = RandomVectorUniform(std::vector<int64_t>{C, HW}, -1.0f, 1.0f);
+  std::vector<float> output(static_cast<size_t>(AlignToBlockSize(C, block_size) * HW));
+
+  for (auto _ : state) {
+    MlasReorderInputNchw(input.data(), output.data(), static_cast<size_t>(C), static_cast<size_t>(HW));
+  }
+}
+
+void REORDER_OUTPUT_NCHW(benchmark::State& state) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (block_size <= 1) {
+    state.SkipWithError("NCHWc is not supported on this CPU");
+    return;
+  }
+  if (state.range(0) <= 0) throw std::invalid_argument("C must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("HW must greater than 0!");
+  const int64_t C = state.range(0);
+  const int64_t HW = state.range(1);
+  auto tp = CreateNchwcThreadPool(8);
+
+  const int64_t output_shape[] = {1, C, 1, HW};
+  auto input = RandomVectorUniform(std::vector<int64_t>{AlignToBlockSize(C, block_size), HW}, -1.0f, 1.0f);
+  std::vector<float> output(static_cast<size_t>(C * HW));
+
+  for (auto _ : state) {
+    MlasReorderOutputNchw(output_shape, input.data(), output.data(), tp.get());
+  }
+}
+
+static void ReorderModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"C", "HW"});
+  // the input of ResNet-50 and the outputs of its stages
+  b->Args({3, 224 * 224});
+  b->Args({64, 112 * 112});
+  b->Args({256, 56 * 56});
+  b->Args({1024, 14 * 14});
+  b->Args({2048, 7 * 7});
+}
+
+BENCHMARK(REORDER_INPUT_NCHW)->Apply(ReorderModelSizes)->UseRealTime();
+BENCHMARK(REORDER_OUTPUT_NCHW)->Apply(ReorderModelSizes)->UseRealTime();
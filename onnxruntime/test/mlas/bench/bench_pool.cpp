@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+#include <memory>
+
+static const std::vector<std::string> pool_bench_arg_names = {"N", "C", "H", "W", "KH", "KW", "P", "S", "Threads"};
+
+struct PoolShape {
+  int64_t input_shape[4];
+  int64_t kernel_shape[2];
+  int64_t padding[4];
+  int64_t stride_shape[2];
+  int64_t output_shape[4];
+};
+
+static PoolShape GetPoolShape(benchmark::State& state, int64_t channels) {
+  for (int i = 0; i < 8; i++) {
+    if (state.range(i) <= 0 && i != 6) throw std::invalid_argument("N, C, H, W, KH, KW and S must greater than 0!");
+  }
+  if (state.range(6) < 0) throw std::invalid_argument("P must not be negative!");
+
+  const int64_t N = state.range(0);
+  const int64_t H = state.range(2);
+  const int64_t W = state.range(3);
+  const int64_t KH = state.range(4);
+  const int64_t KW = state.range(5);
+  const int64_t P = state.range(6);
+  const int64_t S = state.range(7);
+
+  PoolShape shape{{N, channels, H, W},
+                  {KH, KW},
+                  {P, P, P, P},
+                  {S, S},
+                  {N, channels, (H + 2 * P - KH) / S + 1, (W + 2 * P - KW) / S + 1}};
+  if (shape.output_shape[2] <= 0 || shape.output_shape[3] <= 0) {
+    throw std::invalid_argument("kernel must not be larger than the padded input!");
+  }
+  return shape;
+}
+
+static std::unique_ptr<onnxruntime::concurrency::ThreadPool> CreatePoolThreadPool(benchmark::State& state) {
+  if (state.range(8) <= 0) throw std::invalid_argument("Threads must greater than 0!");
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = int(state.range(8));
+  tpo.auto_set_affinity = true;
+  return std::unique_ptr<onnxruntime::concurrency::ThreadPool>(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+}
+
+void POOL(benchmark::State& state, MLAS_POOLING_KIND kind) {
+  const PoolShape shape = GetPoolShape(state, state.range(1));
+  auto tp = CreatePoolThreadPool(state);
+
+  auto input = RandomVectorUniform(std::vector<int64_t>(shape.input_shape, shape.input_shape + 4), -1.0f, 1.0f);
+  std::vector<float> output(static_cast<size_t>(
+      shape.output_shape[0] * shape.output_shape[1] * shape.output_shape[2] * shape.output_shape[3]));
+
+  MlasPool(kind, 2, shape.input_shape, shape.kernel_shape, shape.padding, shape.stride_shape, shape.output_shape,
+           input.data(), output.data(), tp.get());
+
+  for (auto _ : state) {
+    MlasPool(kind, 2, shape.input_shape, shape.kernel_shape, shape.padding, shape.stride_shape, shape.output_shape,
+             input.data(), output.data(), tp.get());
+  }
+}
+
+void NCHWC_POOL(benchmark::State& state, MLAS_POOLING_KIND kind) {
+  const int64_t block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  if (block_size <= 1) {
+    state.SkipWithError("NCHWc is not supported on this CPU");
+    return;
+  }
+
+  // the channels are padded to the block size
+  const int64_t channels = (state.range(1) + block_size - 1) / block_size * block_size;
+  const PoolShape shape = GetPoolShape(state, channels);
+  auto tp = CreatePoolThreadPool(state);
+
+  auto input = RandomVectorUniform(std::vector<int64_t>(shape.input_shape, shape.input_shape + 4), -1.0f, 1.0f);
+  std::vector<float> output(static_cast<size_t>(
+      shape.output_shape[0] * shape.output_shape[1] * shape.output_shape[2] * shape.output_shape[3]));
+
+  MlasNchwcPool(kind, shape.input_shape, shape.kernel_shape, nullptr, shape.padding, shape.stride_shape,
+                shape.output_shape, input.data(), output.data(), tp.get());
+
+  for (auto _ : state) {
+    MlasNchwcPool(kind, shape.input_shape, shape.kernel_shape, nullptr, shape.padding, shape.stride_shape,
+                  shape.output_shape, input.data(), output.data(), tp.get());
+  }
+}
+
+static void PoolModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(pool_bench_arg_names);
+  for (int threads : {1, 8}) {
+    // ResNet-50 stem max pool
+    b->Args({1, 64, 112, 112, 3, 3, 1, 2, threads});
+    // ResNet-50 and MobileNet global average pool
+    b->Args({1, 2048, 7, 7, 7, 7, 0, 1, threads});
+    b->Args({1, 1280, 7, 7, 7, 7, 0, 1, threads});
+    // GoogLeNet / Inception 3x3 stride 1 pool
+    b->Args({1, 192, 28, 28, 3, 3, 1, 1, threads});
+    // VGG 2x2 stride 2 pool
+    b->Args({1, 128, 112, 112, 2, 2, 0, 2, threads});
+  }
+}
+
+BENCHMARK_CAPTURE(POOL, Maximum, MlasMaximumPooling)->Apply(PoolModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(POOL, AverageExcludePad, MlasAveragePoolingExcludePad)->Apply(PoolModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(NCHWC_POOL, Maximum, MlasMaximumPooling)->Apply(PoolModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(NCHWC_POOL, AverageExcludePad, MlasAveragePoolingExcludePad)->Apply(PoolModelSizes)->UseRealTime();
@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+#include <type_traits>
+
+template <typename QuantType>
+void QUANTIZELINEAR(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+
+  auto input = RandomVectorUniform(N, -8.0f, 8.0f);
+  std::vector<QuantType> output(N);
+  const float scale = 16.0f / 255.0f;
+  const QuantType zero_point = std::is_signed<QuantType>::value ? QuantType(0) : QuantType(128);
+
+  for (auto _ : state) {
+    MlasQuantizeLinear(input.data(), output.data(), N, scale, zero_point);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * N));
+}
+
+static void QuantizeModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N"});
+  // odd size, which uses the remainder loop
+  b->Arg(1023);
+  // activations of BERT base with sequence length 128, and of ResNet-50 stages
+  b->Arg(128 * 768);
+  b->Arg(128 * 3072);
+  b->Arg(64 * 112 * 112);
+  b->Arg(256 * 56 * 56);
+}
+
+BENCHMARK_TEMPLATE(QUANTIZELINEAR, int8_t)->Apply(QuantizeModelSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(QUANTIZELINEAR, uint8_t)->Apply(QuantizeModelSizes)->UseRealTime();
+
+// requantizes the int32 accumulators of a quantized GEMM or convolution, with bias, to 8 bits
+template <typename QuantType>
+void REQUANTIZEOUTPUT(benchmark::State& state, bool per_column_scale) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+
+  auto input = RandomVectorUniform<int32_t>(M * N, -65536, 65536);
+  auto bias = RandomVectorUniform<int32_t>(N, -1024, 1024);
+  auto scale = RandomVectorUniform(per_column_scale ? N : 1, 0.0001f, 0.001f);
+  std::vector<QuantType> output(M * N);
+  const QuantType zero_point = std::is_signed<QuantType>::value ? QuantType(0) : QuantType(128);
+
+  for (auto _ : state) {
+    MlasRequantizeOutput(input.data(), N, output.data(), N, bias.data(), scale.data(), per_column_scale, zero_point,
+                         0, 0, M, N);
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * M * N));
+}
+
+static void RequantizeModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N"});
+  // outputs of BERT base GEMMs with sequence length 128 and of ResNet-50 convolutions (NHWC)
+  b->Args({128, 768});
+  b->Args({128, 3072});
+  b->Args({56 * 56, 256});
+  b->Args({7 * 7, 2048});
+  b->Args({15, 1023});
+}
+
+BENCHMARK_CAPTURE(REQUANTIZEOUTPUT<int8_t>, PerTensor, false)->Apply(RequantizeModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(REQUANTIZEOUTPUT<int8_t>, PerColumn, true)->Apply(RequantizeModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(REQUANTIZEOUTPUT<uint8_t>, PerTensor, false)->Apply(RequantizeModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(REQUANTIZEOUTPUT<uint8_t>, PerColumn, true)->Apply(RequantizeModelSizes)->UseRealTime();
@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <stdexcept>
+#include <memory>
+#include <numeric>
+
+#if defined(MLAS_SUPPORTS_SBGEMM)
+
+static const std::vector<std::string> sbgemm_bench_arg_names = {"M", "N", "K", "Threads"};
+
+void SBGEMM(benchmark::State& state, bool pack_b) {
+  if (!MlasBf16AccelerationSupported()) {
+    state.SkipWithError("bfloat16 GEMM is not accelerated on this CPU");
+    return;
+  }
+
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  if (state.range(3) <= 0) throw std::invalid_argument("Threads must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  const size_t threads = static_cast<size_t>(state.range(3));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = int(threads);
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  auto A = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniform(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(M * N));
+
+  // A is always converted to bfloat16 by the kernel, B either on each call or once when packed
+  MLAS_SBGEMM_DATA_PARAMS params;
+  params.A = A.data();
+  params.lda = K;
+  params.AIsfp32 = true;
+  params.B = B.data();
+  params.ldb = N;
+  params.BIsfp32 = true;
+  params.C = C.data();
+  params.ldc = N;
+
+  std::vector<uint8_t> B_packed;
+  if (pack_b) {
+    B_packed.resize(MlasSBGemmPackBSize(N, K));
+    MlasSBGemmConvertPackB(N, K, B.data(), N, B_packed.data());
+    params.B = B_packed.data();
+    params.ldb = 0;
+    params.BIsfp32 = false;
+  }
+
+  // warming up run
+  MlasSBGemmBatch(M, N, K, 1, &params, tp.get());
+
+  for (auto _ : state) {
+    MlasSBGemmBatch(M, N, K, 1, &params, tp.get());
+  }
+}
+
+static void SBGemmModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sbgemm_bench_arg_names);
+  for (int threads : {1, 8}) {
+    // BERT base, sequence length 128: QKV and attention output, FFN up and down projections
+    b->Args({128, 768, 768, threads});
+    b->Args({128, 3072, 768, threads});
+    b->Args({128, 768, 3072, threads});
+    // LLaMA 7B token generation and prompt processing: attention and MLP projections
+    b->Args({1, 4096, 4096, threads});
+    b->Args({1, 11008, 4096, threads});
+    b->Args({512, 4096, 4096, threads});
+  }
+}
+
+BENCHMARK_CAPTURE(SBGEMM, NoPackB, false)->Apply(SBGemmModelSizes)->UseRealTime();
+BENCHMARK_CAPTURE(SBGEMM, PackB, true)->Apply(SBGemmModelSizes)->UseRealTime();
+
+#endif  // defined(MLAS_SUPPORTS_SBGEMM)
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <stdexcept>
+
+template <typename ElementType>
+void TRANSPOSE(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+
+  std::vector<ElementType> input(M * N);
+  for (size_t i = 0; i < input.size(); i++) {
+    input[i] = static_cast<ElementType>(i);
+  }
+  std::vector<ElementType> output(M * N);
+
+  for (auto _ : state) {
+    MlasTranspose(input.data(), output.data(), M, N);
+  }
+
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * M * N * sizeof(ElementType) * 2));
+}
+
+static void TransposeModelSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N"});
+  // NCHW <-> NHWC of ResNet-50 activations: HxW by C
+  b->Args({112 * 112, 64});
+  b->Args({56 * 56, 256});
+  b->Args({28 * 28, 512});
+  b->Args({7 * 7, 2048});
+  b->Args({64, 112 * 112});
+  b->Args({2048, 7 * 7});
+  // BERT base attention heads, sequence length 128 and 512: (S, H x D) <-> (H x D, S)
+  b->Args({128, 768});
+  b->Args({512, 768});
+  b->Args({768, 512});
+  // odd sizes, which use the scalar remainder loops
+  b->Args({63, 255});
+  b->Args({1023, 3});
+}
+
+BENCHMARK_TEMPLATE(TRANSPOSE, float)->Apply(TransposeModelSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(TRANSPOSE, uint16_t)->Apply(TransposeModelSizes)->UseRealTime();
+BENCHMARK_TEMPLATE(TRANSPOSE, uint8_t)->Apply(TransposeModelSizes)->UseRealTime();
@@ -0,0 +1,83 @@
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+
+"""
+Compares the results of onnxruntime_mlas_benchmark of a baseline and a new build.
+
+The results are the JSON written by the benchmark with --benchmark_out=<file> --benchmark_out_format=json.
+With --benchmark_repetitions=<n> the median of the repetitions is compared, otherwise the mean of the runs.
+
+    onnxruntime_mlas_benchmark --benchmark_out=baseline.json --benchmark_out_format=json --benchmark_repetitions=5
+    onnxruntime_mlas_benchmark --benchmark_out=new.json --benchmark_out_format=json --benchmark_repetitions=5
+    python compare_bench_results.py baseline.json new.json --threshold 0.05
+
+Exits with 1 if a benchmark is slower than in the baseline by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_times(path):
+    with open(path) as f:
+        results = json.load(f)
+
+    iteration_times = {}
+    median_times = {}
+    for benchmark in results["benchmarks"]:
+        if benchmark.get("error_occurred") or benchmark.get("skipped"):
+            continue
+        name = benchmark.get("run_name", benchmark["name"])
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") == "median":
+                median_times[name] = benchmark["real_time"]
+        else:
+            iteration_times.setdefault(name, []).append(benchmark["real_time"])
+
+    times = {name: sum(values) / len(values) for name, values in iteration_times.items()}
+    times.update(median_times)
+    return results.get("context", {}), times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="JSON results of the baseline build")
+    parser.add_argument("new", help="JSON results of the new build")
+    parser.add_argument(
+        "--threshold", type=float, default=0.05, help="relative slowdown reported as a regression, default 0.05"
+    )
+    args = parser.parse_args()
+
+    baseline_context, baseline_times = load_times(args.baseline)
+    new_context, new_times = load_times(args.new)
+
+    # the results are only comparable if MLAS ran the same kernels
+    for key in sorted(set(baseline_context) | set(new_context)):
+        if key.startswith("mlas_") and baseline_context.get(key) != new_context.get(key):
+            print(
+                f"WARNING: {key} is {baseline_context.get(key)} in the baseline and {new_context.get(key)} in the new "
+                "results, they ran different kernels."
+            )
+
+    regressions = 0
+    print(f"{'Benchmark':<80} {'Baseline':>12} {'New':>12} {'Change':>8}")
+    for name in sorted(set(baseline_times) & set(new_times)):
+        change = new_times[name] / baseline_times[name] - 1
+        marker = ""
+        if change > args.threshold:
+            marker = "  REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            marker = "  improvement"
+        print(f"{name:<80} {baseline_times[name]:>12.3f} {new_times[name]:>12.3f} {change:>+8.1%}{marker}")
+
+    for name in sorted(set(baseline_times) ^ set(new_times)):
+        print(f"{name:<80} only in the {'baseline' if name in baseline_times else 'new'} results")
+
+    print(f"\n{regressions} regressions above {args.threshold:.1%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_fp16.h"
+
+class MlasFp16ComputeTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<MLFp16> BufferInput;
+  MatrixGuardBuffer<MLFp16> BufferOutput;
+  MatrixGuardBuffer<float> BufferFloat;
+  MLAS_THREADPOOL* threadpool_;
+
+  using Fp16Routine = void(MLASCALL*)(const MLAS_FP16*, MLAS_FP16*, size_t);
+  using FloatRoutine = void(MLASCALL*)(const float*, float*, size_t);
+
+  MLFp16* FillInput(size_t N, float MinimumValue, float MaximumValue) {
+    MLFp16* Input = BufferInput.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+    for (size_t n = 0; n < N; n++) {
+      Input[n] = MLFp16(distribution(generator));
+    }
+
+    return Input;
+  }
+
+  void TestConvert(size_t N) {
+    float* Input = BufferFloat.GetBuffer(N);
+    MLFp16* Output = BufferOutput.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(-70000.0f, 70000.0f);
+
+    for (size_t n = 0; n < N; n++) {
+      // Cover the subnormal, normal and overflow ranges of half precision.
+      Input[n] = distribution(generator) / float(1 << (n % 32));
+    }
+
+    MlasConvertFloatToHalfBuffer(Input, reinterpret_cast<MLAS_FP16*>(Output), N);
+
+    for (size_t n = 0; n < N; n++) {
+      ASSERT_EQ(Output[n].val, MLAS_Float2Half(Input[n]))
+          << "@" << n << " of " << N << ", input: " << Input[n];
+    }
+  }
+
+  // The half precision routines compute in single precision, so the results must be the single
+  // precision results rounded to half precision.
+  void TestElementwise(Fp16Routine Routine, FloatRoutine Reference, const char* Name, size_t N,
+                       float MinimumValue, float MaximumValue) {
+    const MLFp16* Input = FillInput(N, MinimumValue, MaximumValue);
+    MLFp16* Output = BufferOutput.GetBuffer(N);
+    float* Expected = BufferFloat.GetBuffer(N);
+
+    for (size_t n = 0; n < N; n++) {
+      Expected[n] = Input[n].ToFloat();
+    }
+    Reference(Expected, Expected, N);
+
+    Routine(reinterpret_cast<const MLAS_FP16*>(Input), reinterpret_cast<MLAS_FP16*>(Output), N);
+
+    for (size_t n = 0; n < N; n++) {
+      ASSERT_EQ(Output[n].val, MLAS_Float2Half(Expected[n]))
+          << Name << " @" << n << " of " << N << ", input: " << Input[n].ToFloat()
+          << ", got: " << Output[n].ToFloat() << ", expecting: " << Expected[n];
+    }
+  }
+
+  void TestSoftmax(size_t N, size_t D, bool LogSoftmax, float MinimumValue, float MaximumValue) {
+    const MLFp16* Input = FillInput(N * D, MinimumValue, MaximumValue);
+    MLFp16* Output = BufferOutput.GetBuffer(N * D);
+    float* Expected = BufferFloat.GetBuffer(N * D);
+
+    for (size_t nd = 0; nd < N * D; nd++) {
+      Expected[nd] = Input[nd].ToFloat();
+    }
+    MlasComputeSoftmax(Expected, Expected, N, D, LogSoftmax, nullptr);
+
+    MlasComputeSoftmax(reinterpret_cast<const MLAS_FP16*>(Input), reinterpret_cast<MLAS_FP16*>(Output),
+                       N, D, LogSoftmax, threadpool_);
+
+    for (size_t nd = 0; nd < N * D; nd++) {
+      ASSERT_EQ(Output[nd].val, MLAS_Float2Half(Expected[nd]))
+          << "LogSoftmax:" << LogSoftmax << " @" << nd << " of " << N << "x" << D
+          << ", got: " << Output[nd].ToFloat() << ", expecting: " << Expected[nd];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Fp16Compute");
+    return suite_name.c_str();
+  }
+
+  MlasFp16ComputeTest() : threadpool_(GetMlasThreadPool()) {}
+
+  void ExecuteShort(void) override {
+    for (size_t n : {1, 7, 8, 15, 16, 17, 1023, 1024, 1025, 4099}) {
+      TestConvert(n);
+      TestElementwise(MlasComputeErf, MlasComputeErf, "Erf", n, -4.0f, 4.0f);
+      TestElementwise(MlasComputeExp, MlasComputeExp, "Exp", n, -20.0f, 11.0f);
+      TestElementwise(MlasComputeLogistic, MlasComputeLogistic, "Logistic", n, -20.0f, 20.0f);
+      TestElementwise(MlasComputeTanh, MlasComputeTanh, "Tanh", n, -10.0f, 10.0f);
+    }
+
+    for (bool LogSoftmax : {false, true}) {
+      TestSoftmax(1, 1, LogSoftmax, -10.0f, 10.0f);
+      TestSoftmax(3, 17, LogSoftmax, -10.0f, 10.0f);
+      TestSoftmax(63, 95, LogSoftmax, -60.0f, 60.0f);
+      TestSoftmax(16, 4099, LogSoftmax, 20.0f, 30.0f);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasFp16ComputeTest>::RegisterShortExecute() : 0;
+});
@@ -32,6 +32,7 @@ class MlasHalfGemmTest : public MlasTestBase {
   MatrixGuardBuffer<MLFp16> BufferBias;
   MatrixGuardBuffer<MLFp16> BufferC;
   MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<float> BufferCReferenceFp32;
   MatrixGuardBuffer<float> BufferFloatC;
   MLAS_THREADPOOL* threadpool_;
 
@@ -153,6 +154,40 @@ class MlasHalfGemmTest : public MlasTestBase {
     }
   }
 
+  /**
+   * @brief Reference for kernels that convert fp16 to fp32 and accumulate
+   *        in single precision, e.g. the x64 F16C kernel.
+   */
+  void ReferenceQgemmFp32(size_t M,
+                          size_t N,
+                          size_t K,
+                          size_t BatchSize,
+                          const AType* A,
+                          const BType* B,
+                          const MLFp16* Bias,
+                          float* C) {
+    for (size_t batch = 0; batch < BatchSize; batch++) {
+      for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+          const AType* a = A + M * K * batch + m * K;
+          const BType* b = B + K * N * batch + n;
+          float* c = C + (M * N * batch) + (m * N) + n;
+
+          float sum = (Bias != nullptr) ? float(Bias[n]) : 0.0f;
+          for (size_t k = 0; k < K; k++) {
+            sum += float(*b) * float(*a);
+            b += N;
+            a += 1;
+          }
+          *c = float(MLFp16(sum));
+        }
+      }
+      if (Bias) {
+        Bias += N;
+      }
+    }
+  }
+
  public:
   MlasHalfGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
 
@@ -182,14 +217,18 @@ class MlasHalfGemmTest : public MlasTestBase {
 
     this->CallGemm(M, N, K, BatchSize, A, K, B, N, Bias, C, N, Cfloat);
     ReferenceQgemm(M, N, K, BatchSize, A, B, Bias, CReference);
+    float* CReferenceFp32 = BufferCReferenceFp32.GetBuffer(N * M * BatchSize, true);
+    ReferenceQgemmFp32(M, N, K, BatchSize, A, B, Bias, CReferenceFp32);
 
     for (size_t batch = 0, f = 0; batch < BatchSize; batch++) {
       for (size_t m = 0; m < M; m++) {
         for (size_t n = 0; n < N; n++, f++) {
-          ASSERT_TRUE(CloseEnough(float(C[f]), CReference[f])) << "@[" << batch << "x" << m << "x" << n << "], "
-                                                               << "Batch=" << BatchSize << "M=" << M << ", N=" << N << ", K=" << K;
-          ASSERT_TRUE(CloseEnough(Cfloat[f], CReference[f])) << "Converted@[" << batch << "x" << m << "x" << n << "], "
-                                                             << "Batch=" << BatchSize << "M=" << M << ", N=" << N << ", K=" << K;
+          ASSERT_TRUE(CloseEnough(float(C[f]), CReference[f]) || CloseEnough(float(C[f]), CReferenceFp32[f]))
+              << "@[" << batch << "x" << m << "x" << n << "], "
+              << "Batch=" << BatchSize << "M=" << M << ", N=" << N << ", K=" << K;
+          ASSERT_TRUE(CloseEnough(Cfloat[f], CReference[f]) || CloseEnough(Cfloat[f], CReferenceFp32[f]))
+              << "Converted@[" << batch << "x" << m << "x" << n << "], "
+              << "Batch=" << BatchSize << "M=" << M << ", N=" << N << ", K=" << K;
         }
       }
     }
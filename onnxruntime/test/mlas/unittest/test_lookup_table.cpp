@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasLookupTableTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<uint8_t> BufferInput;
+  MatrixGuardBuffer<uint8_t> BufferOutput;
+  uint8_t Table[256];
+
+  void Test(size_t N) {
+    uint8_t* Input = BufferInput.GetBuffer(N);
+    uint8_t* Output = BufferOutput.GetBuffer(N);
+
+    for (size_t n = 0; n < N; n++) {
+      Input[n] = static_cast<uint8_t>((n * 37 + 11) & 0xFF);
+    }
+
+    MlasLookupTable(Input, Table, Output, N);
+
+    for (size_t n = 0; n < N; n++) {
+      ASSERT_EQ(Output[n], Table[Input[n]]) << ", size=" << N << ", index=" << n;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("LookupTable");
+    return suite_name.c_str();
+  }
+
+  MlasLookupTableTest() {
+    for (size_t i = 0; i < 256; i++) {
+      Table[i] = static_cast<uint8_t>((i * 173 + 29) & 0xFF);
+    }
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t n = 1; n <= 512; n++) {
+      Test(n);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasLookupTableTest>::RegisterShortExecute() : 0;
+});
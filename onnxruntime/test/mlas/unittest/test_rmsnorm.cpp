@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasRmsNormTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferSkip;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferSum;
+  MatrixGuardBuffer<float> BufferInvStdDev;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferSumReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t N, size_t D, size_t SkipRows, bool WithBias) {
+    const float Epsilon = 1e-6f;
+    float* Input = BufferInput.GetBuffer(N * D);
+    float* Skip = SkipRows > 0 ? BufferSkip.GetBuffer(SkipRows * D) : nullptr;
+    float* Bias = WithBias ? BufferBias.GetBuffer(D) : nullptr;
+    float* Scale = BufferScale.GetBuffer(D);
+    float* Output = BufferOutput.GetBuffer(N * D);
+    float* Sum = BufferSum.GetBuffer(N * D);
+    float* InvStdDev = BufferInvStdDev.GetBuffer(N);
+    float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+    float* SumReference = BufferSumReference.GetBuffer(N * D);
+
+    std::default_random_engine generator(static_cast<unsigned>(N * D + SkipRows));
+    std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+    for (size_t i = 0; i < N * D; i++) {
+      Input[i] = distribution(generator);
+    }
+    for (size_t i = 0; Skip != nullptr && i < SkipRows * D; i++) {
+      Skip[i] = distribution(generator);
+    }
+    for (size_t d = 0; d < D; d++) {
+      Scale[d] = distribution(generator);
+      if (Bias != nullptr) {
+        Bias[d] = distribution(generator);
+      }
+    }
+
+    for (size_t n = 0; n < N; n++) {
+      double SquareSum = 0.0;
+      for (size_t d = 0; d < D; d++) {
+        float Value = Input[n * D + d];
+        if (Skip != nullptr) {
+          Value += Skip[(n % SkipRows) * D + d];
+        }
+        if (Bias != nullptr) {
+          Value += Bias[d];
+        }
+        SumReference[n * D + d] = Value;
+        SquareSum += double(Value) * Value;
+      }
+      const double InvRms = 1.0 / std::sqrt(SquareSum / D + Epsilon);
+      for (size_t d = 0; d < D; d++) {
+        OutputReference[n * D + d] = float(SumReference[n * D + d] * InvRms * Scale[d]);
+      }
+    }
+
+    MlasComputeRmsNorm(Input, Skip, SkipRows, Bias, Scale, Output, Sum, InvStdDev, N, D, Epsilon, threadpool_);
+
+    for (size_t i = 0; i < N * D; i++) {
+      ASSERT_NEAR(Output[i], OutputReference[i], 1e-4f + std::abs(OutputReference[i]) * 1e-4f)
+          << ", N=" << N << ", D=" << D << ", index=" << i;
+      ASSERT_EQ(Sum[i], SumReference[i]) << ", N=" << N << ", D=" << D << ", index=" << i;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("RmsNorm");
+    return suite_name.c_str();
+  }
+
+  MlasRmsNormTest() : threadpool_(GetMlasThreadPool()) {}
+
+  void ExecuteShort(void) override {
+    for (size_t D : {1, 3, 8, 15, 64, 129}) {
+      Test(5, D, 0, false);
+      Test(6, D, 6, true);
+      Test(6, D, 2, false);
+    }
+    Test(128, 4096, 64, false);
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasRmsNormTest>::RegisterShortExecute() : 0;
+});
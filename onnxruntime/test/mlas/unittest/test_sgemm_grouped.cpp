@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasSgemmGroupedTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCRef;
+
+  void ReferenceSgemm(bool TransB, size_t M, size_t N, size_t K, const float* A, const float* B, float* C) {
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float sum = 0.0f;
+        for (size_t k = 0; k < K; k++) {
+          sum += A[m * K + k] * (TransB ? B[n * K + k] : B[k * N + n]);
+        }
+        C[m * N + n] = sum;
+      }
+    }
+  }
+
+  // Every problem shares N and K, like the experts of a mixture of experts layer, but has its own M.
+  void Test(bool TransB, const std::vector<size_t>& Ms, size_t N, size_t K, MLAS_THREADPOOL* threadpool) {
+    const size_t ProblemCount = Ms.size();
+    size_t TotalM = 0;
+    for (size_t M : Ms) {
+      TotalM += M;
+    }
+
+    const float* A = BufferA.GetBuffer(TotalM * K + 1);
+    const float* B = BufferB.GetBuffer(ProblemCount * K * N);
+    float* C = BufferC.GetBuffer(TotalM * N + 1, true);
+    float* CRef = BufferCRef.GetBuffer(TotalM * N + 1, true);
+
+    std::vector<MLAS_SGEMM_GROUPED_PROBLEM> Problems(ProblemCount);
+    size_t RowOffset = 0;
+    for (size_t i = 0; i < ProblemCount; i++) {
+      Problems[i].M = Ms[i];
+      Problems[i].N = N;
+      Problems[i].K = K;
+      Problems[i].Data.A = A + RowOffset * K;
+      Problems[i].Data.lda = K;
+      Problems[i].Data.B = B + i * K * N;
+      Problems[i].Data.ldb = TransB ? K : N;
+      Problems[i].Data.C = C + RowOffset * N;
+      Problems[i].Data.ldc = N;
+
+      ReferenceSgemm(TransB, Ms[i], N, K, A + RowOffset * K, B + i * K * N, CRef + RowOffset * N);
+      RowOffset += Ms[i];
+    }
+
+    MlasGemmGrouped(CblasNoTrans, TransB ? CblasTrans : CblasNoTrans, Problems.data(), ProblemCount, threadpool);
+
+    for (size_t i = 0; i < TotalM * N; i++) {
+      ASSERT_TRUE(CloseEnough(C[i], CRef[i]))
+          << "@[" << i / N << "," << i % N << "], "
+          << "TransB=" << TransB << ", N=" << N << ", K=" << K << ", got: " << C[i] << ", expecting: " << CRef[i];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SgemmGrouped");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    MLAS_THREADPOOL* threadpool = GetMlasThreadPool();
+
+    for (bool TransB : {false, true}) {
+      Test(TransB, {1}, 1, 1, threadpool);
+      Test(TransB, {3, 0, 17, 1}, 16, 31, nullptr);
+      Test(TransB, {3, 0, 17, 1}, 16, 31, threadpool);
+      Test(TransB, {0, 0}, 64, 64, threadpool);
+      Test(TransB, {64, 1, 2, 0, 33, 128, 5, 7}, 96, 48, threadpool);
+      Test(TransB, {200, 1, 1, 1}, 257, 63, threadpool);
+      Test(TransB, {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, 1024, 128, threadpool);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasSgemmGroupedTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasSparseGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferPackedB;
+  MatrixGuardBuffer<float> BufferC;
+  MLAS_THREADPOOL* threadpool_;
+
+  // Keeps one in Density elements of B, in runs of Run columns so that blocks are selected for runs of 8.
+  void Test(size_t M, size_t N, size_t K, bool TransB, size_t Density, size_t Run) {
+    const float* A = BufferA.GetBuffer(M * K);
+    float* B = BufferB.GetBuffer(K * N);
+    float* C = BufferC.GetBuffer(M * N);
+
+    for (size_t k = 0; k < K; k++) {
+      for (size_t n = 0; n < N; n++) {
+        const bool NonZero = ((n / Run) * 7 + k * 3) % Density == 0;
+        const float Value = NonZero ? float(int((k * N + n) % 9) - 4) / 4.0f : 0.0f;
+        B[TransB ? n * K + k : k * N + n] = Value;
+      }
+    }
+
+    const CBLAS_TRANSPOSE Trans = TransB ? CblasTrans : CblasNoTrans;
+    const size_t ldb = TransB ? K : N;
+    uint8_t* PackedB = BufferPackedB.GetBuffer(MlasSparseGemmPackBSize(Trans, N, K, B, ldb), true);
+    MlasSparseGemmPackB(Trans, N, K, B, ldb, PackedB);
+
+    for (size_t i = 0; i < M * N; i++) {
+      C[i] = -1.0f;
+    }
+
+    constexpr float alpha = 0.5f;
+    MlasSparseGemm(M, N, K, alpha, A, K, PackedB, C, N, threadpool_);
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float Reference = 0.0f;
+        for (size_t k = 0; k < K; k++) {
+          Reference += A[m * K + k] * B[TransB ? n * K + k : k * N + n];
+        }
+        Reference *= alpha;
+        ASSERT_LE(std::abs(C[m * N + n] - Reference), 1e-4f * (1.0f + std::abs(Reference)))
+            << "@[" << m << "," << n << "], got: " << C[m * N + n] << ", expecting: " << Reference
+            << " M" << M << "/N" << N << "/K" << K << "/TransB" << TransB << "/Density" << Density << "/Run" << Run;
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("SparseGemm");
+    return suite_name.c_str();
+  }
+
+  MlasSparseGemmTest() : threadpool_(GetMlasThreadPool()) {}
+
+  void ExecuteShort(void) override {
+    for (bool TransB : {false, true}) {
+      for (size_t Run : {1, 8}) {
+        Test(1, 1, 1, TransB, 1, Run);
+        Test(1, 64, 32, TransB, 3, Run);
+        Test(5, 130, 17, TransB, 4, Run);
+        Test(16, 128, 64, TransB, 2, Run);
+        Test(33, 300, 96, TransB, 5, Run);
+        Test(64, 257, 128, TransB, 10, Run);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasSparseGemmTest>::RegisterShortExecute() : 0;
+});
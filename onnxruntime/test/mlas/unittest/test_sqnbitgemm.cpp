@@ -79,6 +79,78 @@ class MlasSQNBitGemmTest : public MlasTestBase {
     MlasSQNBitGemmBatch(M, N, K, 1, BlkBitWidth, BlkLen, ComputeType, &params, Workspace, Threadpool);
   }
 
+  // Quantized B data and zero points are little endian bit streams of BlkBitWidth-bit values.
+  // Each column of B is stored separately. The zero points of a column are padded to a whole number of bytes.
+  static size_t QuantBZeroPointBytesPerColumn(size_t BlockCountK) {
+    return (BlockCountK * BlkBitWidth + 7) / 8;
+  }
+
+  static uint8_t GetBitStreamValue(const uint8_t* Data, size_t Idx) {
+    const size_t BitOffset = Idx * BlkBitWidth;
+    uint32_t Bits = Data[BitOffset / 8];
+    if (BitOffset % 8 + BlkBitWidth > 8) {
+      Bits |= static_cast<uint32_t>(Data[BitOffset / 8 + 1]) << 8;
+    }
+    return static_cast<uint8_t>((Bits >> (BitOffset % 8)) & ((1u << BlkBitWidth) - 1));
+  }
+
+  static void SetBitStreamValue(uint8_t* Data, size_t Idx, uint8_t Value) {
+    const size_t BitOffset = Idx * BlkBitWidth;
+    const uint32_t Bits = static_cast<uint32_t>(Value) << (BitOffset % 8);
+    Data[BitOffset / 8] |= static_cast<uint8_t>(Bits & 0xFF);
+    if ((Bits >> 8) != 0) {
+      Data[BitOffset / 8 + 1] |= static_cast<uint8_t>(Bits >> 8);
+    }
+  }
+
+  // Reference block quantization of the row major K x N matrix B for bit widths that
+  // MlasQuantizeBlockwise() does not support.
+  void QuantizeB(size_t N, size_t K, const float* B,
+                 uint8_t* QuantBData, float* QuantBScale, uint8_t* QuantBZeroPoint) {
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t QuantBDataSize = N * BlockCountK * BlkLen * BlkBitWidth / 8;
+    constexpr int QMax = (1 << BlkBitWidth) - 1;
+    constexpr int QMid = 1 << (BlkBitWidth - 1);
+
+    std::fill_n(QuantBData, QuantBDataSize, uint8_t{0});
+    if (QuantBZeroPoint != nullptr) {
+      std::fill_n(QuantBZeroPoint, N * QuantBZeroPointBytesPerColumn(BlockCountK), uint8_t{0});
+    }
+
+    for (size_t n = 0; n < N; ++n) {
+      for (size_t k = 0, k_blk = 0; k < K; k += BlkLen, ++k_blk) {
+        const size_t local_blk_len = std::min(K - k, BlkLen);
+
+        float min = 0.0f, max = 0.0f;
+        for (size_t kk = 0; kk < local_blk_len; ++kk) {
+          min = std::min(min, B[(k + kk) * N + n]);
+          max = std::max(max, B[(k + kk) * N + n]);
+        }
+
+        float scale;
+        int zp;
+        if (QuantBZeroPoint != nullptr) {
+          scale = (max - min) / QMax;
+          zp = scale != 0.0f ? std::clamp(static_cast<int>(roundf(-min / scale)), 0, QMax) : QMid;
+          SetBitStreamValue(QuantBZeroPoint + n * QuantBZeroPointBytesPerColumn(BlockCountK), k_blk,
+                            static_cast<uint8_t>(zp));
+        } else {
+          scale = std::max(-min, max) / QMid;
+          zp = QMid;
+        }
+        const float scale_reciprocal = scale != 0.0f ? 1.0f / scale : 0.0f;
+
+        QuantBScale[n * BlockCountK + k_blk] = scale;
+
+        for (size_t kk = 0; kk < local_blk_len; ++kk) {
+          const int q = static_cast<int>(roundf(B[(k + kk) * N + n] * scale_reciprocal)) + zp;
+          SetBitStreamValue(QuantBData, n * BlockCountK * BlkLen + k + kk,
+                            static_cast<uint8_t>(std::clamp(q, 0, QMax)));
+        }
+      }
+    }
+  }
+
   void QuantizeA(size_t M, size_t K, const float* A, int8_t* QuantAData, float* QuantAScale) {
     const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
     const size_t lda = K;
@@ -137,20 +209,16 @@ class MlasSQNBitGemmTest : public MlasTestBase {
 
           const float b_scale = QuantBScale[n * BlockCountK + k_blk];
 
-          static_assert(BlkBitWidth == 4, "only implemented for 4-bit quantized B");
-
-          uint8_t b_zp = 8;
+          uint8_t b_zp = 1 << (BlkBitWidth - 1);
           if (QuantBZeroPoint != nullptr) {
-            const uint8_t b_zp_byte = QuantBZeroPoint[n * ((BlockCountK + 1) / 2) + k_blk / 2];
-            b_zp = (k_blk & 1) ? (b_zp_byte >> 4) : (b_zp_byte & 0x0F);
+            b_zp = GetBitStreamValue(QuantBZeroPoint + n * QuantBZeroPointBytesPerColumn(BlockCountK), k_blk);
           }
 
           int32_t qsum = 0;
 
           for (size_t kk = 0; kk < k_blk_len; ++kk) {
             const int8_t qa = QuantAData[m * BlockCountK * BlkLen + k + kk];
-            const uint8_t qb_byte = QuantBData[(n * BlockCountK * BlkLen + k + kk) / 2];
-            const int8_t qb = ((kk & 1) == 1 ? (qb_byte >> 4) : (qb_byte & 0x0F)) - b_zp;
+            const int8_t qb = GetBitStreamValue(QuantBData, n * BlockCountK * BlkLen + k + kk) - b_zp;
             qsum += qa * qb;
           }
 
@@ -172,9 +240,24 @@ class MlasSQNBitGemmTest : public MlasTestBase {
                                   const float* Bias,
                                   float* C) {
     float* DequantizedBData = BufferDequantizedB.GetBuffer(K * N);
-    MlasDequantizeBlockwise<float, BlkBitWidth>(
-        DequantizedBData, QuantBData, QuantBScale, QuantBZeroPoint, BlkLen, /* columnwise */ true,
-        static_cast<int>(K), static_cast<int>(N), GetMlasThreadPool());
+    if constexpr (BlkBitWidth == 4) {
+      MlasDequantizeBlockwise<float, BlkBitWidth>(
+          DequantizedBData, QuantBData, QuantBScale, QuantBZeroPoint, BlkLen, /* columnwise */ true,
+          static_cast<int>(K), static_cast<int>(N), GetMlasThreadPool());
+    } else {
+      const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+      for (size_t n = 0; n < N; ++n) {
+        for (size_t k = 0; k < K; ++k) {
+          const size_t k_blk = k / BlkLen;
+          uint8_t b_zp = 1 << (BlkBitWidth - 1);
+          if (QuantBZeroPoint != nullptr) {
+            b_zp = GetBitStreamValue(QuantBZeroPoint + n * QuantBZeroPointBytesPerColumn(BlockCountK), k_blk);
+          }
+          const int qb = GetBitStreamValue(QuantBData, n * BlockCountK * BlkLen + k) - b_zp;
+          DequantizedBData[n * K + k] = QuantBScale[n * BlockCountK + k_blk] * static_cast<float>(qb);
+        }
+      }
+    }
     // Note: DequantizedBData is in column major layout.
 
     for (size_t m = 0; m < M; m++) {
@@ -232,7 +315,17 @@ class MlasSQNBitGemmTest : public MlasTestBase {
     uint8_t* QuantBData = nullptr;
     float* QuantBScale = nullptr;
     uint8_t* QuantBZeroPoint = nullptr;
-    {
+    if constexpr (BlkBitWidth != 4) {
+      const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+
+      QuantBData = BufferQuantBData.GetBuffer(N * BlockCountK * BlkLen * BlkBitWidth / 8);
+      QuantBScale = BufferQuantBScale.GetBuffer(N * BlockCountK);
+      if (!Symmetric) {
+        QuantBZeroPoint = BufferQuantBZeroPoint.GetBuffer(N * QuantBZeroPointBytesPerColumn(BlockCountK));
+      }
+
+      QuantizeB(N, K, B, QuantBData, QuantBScale, QuantBZeroPoint);
+    } else {
       size_t QuantBDataSizeInBytes, QuantBScaleSize, QuantBZeroPointSizeInBytes;
       MlasBlockwiseQuantizedBufferSizes(BlkBitWidth, BlkLen, /* columnwise */ true,
                                         static_cast<int>(K), static_cast<int>(N),
@@ -382,6 +475,7 @@ class SQNBitGemmShortExecuteTest : public MlasTestFixture<MlasSQNBitGemmTest<Blk
             tests_registered += RegisterSingleTest(1, b, b, ComputeType, WithThreadpool, Symmetric, false);
           }
           tests_registered += RegisterSingleTest(43, 500, 401, ComputeType, WithThreadpool, Symmetric, true);
+          tests_registered += RegisterSingleTest(161, 97, 300, ComputeType, WithThreadpool, Symmetric, true);
 
           tests_registered += RegisterSingleTest(1, 2, 16, ComputeType, WithThreadpool, Symmetric, true);
           tests_registered += RegisterSingleTest(1, 2, 16, ComputeType, WithThreadpool, Symmetric, false);
@@ -416,6 +510,18 @@ static size_t SQNBitGemmRegisterAllShortExecuteTests() {
   count += SQNBitGemmShortExecuteTest<4, 128>::RegisterShortExecuteTests();
   count += SQNBitGemmShortExecuteTest<4, 256>::RegisterShortExecuteTests();
 
+  count += SQNBitGemmShortExecuteTest<2, 16>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 32>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 64>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 128>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<2, 256>::RegisterShortExecuteTests();
+
+  count += SQNBitGemmShortExecuteTest<3, 16>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 32>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 64>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 128>::RegisterShortExecuteTests();
+  count += SQNBitGemmShortExecuteTest<3, 256>::RegisterShortExecuteTests();
+
   return count;
 }
 
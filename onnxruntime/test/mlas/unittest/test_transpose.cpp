@@ -22,10 +22,38 @@ class MlasTransposeTest : public MlasTestBase {
     ASSERT_EQ(memcmp(Output, OutputReference, M * N * sizeof(ElementType)), 0) << " [" << M << "," << N << "]";
   }
 
+  void
+  TestStrided(size_t M, size_t N, size_t InputStride, size_t OutputStride) {
+    const size_t InputSize = (M - 1) * InputStride + N;
+    const size_t OutputSize = N * OutputStride;
+    ElementType* Input = BufferInput.GetBuffer(InputSize);
+    ElementType* Output = BufferOutput.GetBuffer(OutputSize);
+    ElementType* OutputReference = BufferOutputReference.GetBuffer(OutputSize);
+
+    for (size_t i = 0; i < InputSize; i++) {
+      Input[i] = static_cast<ElementType>(i * 7 + 3);
+    }
+
+    // Elements outside of the output rows must be left untouched.
+    std::fill_n(Output, OutputSize, ElementType(0x5A));
+    std::fill_n(OutputReference, OutputSize, ElementType(0x5A));
+
+    MlasTranspose(Input, Output, M, N, InputStride, OutputStride);
+    ReferenceTranspose(Input, OutputReference, M, N, InputStride, OutputStride);
+
+    ASSERT_EQ(memcmp(Output, OutputReference, OutputSize * sizeof(ElementType)), 0)
+        << " [" << M << "," << N << "] strides [" << InputStride << "," << OutputStride << "]";
+  }
+
   void ReferenceTranspose(const ElementType* Input, ElementType* Output, size_t M, size_t N) {
+    ReferenceTranspose(Input, Output, M, N, N, M);
+  }
+
+  void ReferenceTranspose(const ElementType* Input, ElementType* Output, size_t M, size_t N,
+                          size_t InputStride, size_t OutputStride) {
     for (size_t m = 0; m < M; m++) {
       for (size_t n = 0; n < N; n++) {
-        Output[n * M + m] = Input[m * N + n];
+        Output[n * OutputStride + m] = Input[m * InputStride + n];
       }
     }
   }
@@ -42,6 +70,12 @@ class MlasTransposeTest : public MlasTestBase {
         Test(m, n);
       }
     }
+    for (size_t m = 1; m <= 19; m += 3) {
+      for (size_t n = 1; n <= 19; n += 2) {
+        TestStrided(m, n, n + 3, m + 5);
+        TestStrided(m, n, n + 16, m);
+      }
+    }
   }
 };
 
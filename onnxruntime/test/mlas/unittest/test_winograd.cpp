@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasWinogradConvTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferFilter;
+  MatrixGuardBuffer<float> BufferPackedFilter;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MatrixGuardBuffer<float> BufferWorking;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t BatchCount,
+            size_t GroupCount,
+            size_t InputChannels,
+            size_t InputHeight,
+            size_t InputWidth,
+            size_t FilterCount,
+            size_t Padding,
+            float Beta) {
+    const int64_t InputShape[] = {int64_t(InputHeight), int64_t(InputWidth)};
+    const int64_t KernelShape[] = {3, 3};
+    const int64_t DilationShape[] = {1, 1};
+    const int64_t PaddingShape[] = {int64_t(Padding), int64_t(Padding), int64_t(Padding), int64_t(Padding)};
+    const int64_t StrideShape[] = {1, 1};
+
+    const size_t OutputHeight = InputHeight + 2 * Padding - 2;
+    const size_t OutputWidth = InputWidth + 2 * Padding - 2;
+    const int64_t OutputShape[] = {int64_t(OutputHeight), int64_t(OutputWidth)};
+
+    ASSERT_TRUE(MlasWinogradConvSupported(2, KernelShape, DilationShape, StrideShape, InputChannels, FilterCount));
+
+    const size_t InputElements = BatchCount * GroupCount * InputChannels * InputHeight * InputWidth;
+    const size_t FilterElements = GroupCount * FilterCount * InputChannels * 9;
+    const size_t BiasElements = GroupCount * FilterCount;
+    const size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputHeight * OutputWidth;
+
+    const float* Input = BufferInput.GetBuffer(InputElements);
+    const float* Filter = BufferFilter.GetBuffer(FilterElements);
+    const float* Bias = BufferBias.GetBuffer(BiasElements);
+    float* PackedFilter = BufferPackedFilter.GetBuffer(
+        MlasWinogradConvPackFilterSize(GroupCount, InputChannels, FilterCount));
+    float* Output = BufferOutput.GetBuffer(OutputElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(OutputElements);
+
+    for (size_t i = 0; i < OutputElements; i++) {
+      Output[i] = OutputReference[i] = float((i % 13) - 6) / 8.0f;
+    }
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasReluActivation;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters, 2, BatchCount, GroupCount, InputChannels, InputShape, KernelShape,
+                    DilationShape, PaddingShape, StrideShape, OutputShape, FilterCount, &Activation,
+                    &WorkingBufferSize, Beta, threadpool_);
+
+    MlasConv(&Parameters, Input, Filter, Bias, BufferWorking.GetBuffer(WorkingBufferSize),
+             OutputReference, threadpool_);
+
+    MlasWinogradConvPackFilter(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+    MlasWinogradConv(&Parameters, Input, PackedFilter, Bias, Output, threadpool_);
+
+    for (size_t i = 0; i < OutputElements; i++) {
+      // The transforms reassociate the sums, so allow for rounding differences
+      // relative to the magnitude of the result.
+      ASSERT_LE(std::abs(Output[i] - OutputReference[i]), 1e-4f * (1.0f + std::abs(OutputReference[i])))
+          << "@" << i << " of " << OutputElements << ", got: " << Output[i]
+          << ", expecting: " << OutputReference[i] << " B" << BatchCount << "/G" << GroupCount
+          << "/C" << InputChannels << "/M" << FilterCount << "/H" << InputHeight << "/W" << InputWidth
+          << "/P" << Padding << "/Beta" << Beta;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("WinogradConv");
+    return suite_name.c_str();
+  }
+
+  MlasWinogradConvTest() : threadpool_(GetMlasThreadPool()) {}
+
+  void ExecuteShort(void) override {
+    for (size_t Padding : {0, 1}) {
+      for (float Beta : {0.0f, 1.0f}) {
+        Test(1, 1, 16, 8, 8, 16, Padding, Beta);
+        Test(1, 1, 17, 9, 11, 23, Padding, Beta);
+        Test(2, 2, 16, 15, 14, 16, Padding, Beta);
+        Test(1, 1, 32, 57, 33, 48, Padding, Beta);
+        Test(3, 1, 64, 5, 3, 32, Padding, Beta);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasWinogradConvTest>::RegisterShortExecute() : 0;
+});
@@ -21,6 +21,8 @@
 #include <iostream>
 #include <unordered_map>
 
+#include "model_kernels.h"
+
 const OrtApi* g_ort = OrtGetApiBase()->GetApi(ORT_API_VERSION);
 OrtEnv* env = nullptr;
 
@@ -75,11 +77,24 @@ BENCHMARK(BM_ResolveGraph);
   } while (0);
 
 int main(int argc, char** argv) {
+  ModelKernelBenchmarkOptions model_kernel_options;
+  if (!ParseModelKernelBenchmarkOptions(argc, argv, model_kernel_options))
+    return -1;
   ::benchmark::Initialize(&argc, argv);
   if (::benchmark::ReportUnrecognizedArguments(argc, argv))
     return -1;
   ORT_ABORT_ON_ERROR(g_ort->CreateEnv(ORT_LOGGING_LEVEL_ERROR, "test", &env));
-  ::benchmark::RunSpecifiedBenchmarks();
+  if (model_kernel_options.model_path.empty()) {
+    ::benchmark::RunSpecifiedBenchmarks();
+  } else {
+    if (!RegisterModelKernelBenchmarks(model_kernel_options)) {
+      g_ort->ReleaseEnv(env);
+      return -1;
+    }
+    ModelKernelReporter reporter;
+    ::benchmark::RunSpecifiedBenchmarks(&reporter);
+    reporter.PrintRankedReport();
+  }
   g_ort->ReleaseEnv(env);
   return 0;
 }
@@ -0,0 +1,437 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "model_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+#include <core/common/path_string.h>
+#include <core/framework/data_types.h>
+#include <core/framework/tensorprotoutils.h>
+#include <core/graph/model.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include <core/session/onnxruntime_session_options_config_keys.h>
+#include <core/session/ort_env.h>
+
+extern OrtEnv* env;
+
+using namespace onnxruntime;
+
+namespace {
+
+struct KernelInput {
+  std::string name;
+  ONNXTensorElementDataType type;
+  std::vector<int64_t> shape;
+};
+
+// a single node model for a set of nodes of the model with the same kernel
+struct KernelCase {
+  std::string name;
+  std::string model_data;
+  std::vector<KernelInput> inputs;
+  std::vector<std::string> output_names;
+  size_t nodes{0};
+};
+
+struct RegisteredBenchmark {
+  std::string config;  // EP and thread count
+  const KernelCase* kernel_case;
+};
+
+std::vector<std::unique_ptr<KernelCase>> kernel_cases;
+std::unordered_map<std::string, RegisteredBenchmark> registered_benchmarks;
+
+std::vector<std::string> SplitList(const std::string& list) {
+  std::vector<std::string> items;
+  std::istringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+std::string ShapeToString(const std::vector<int64_t>& shape) {
+  std::ostringstream ss;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    ss << (i == 0 ? "" : "x") << shape[i];
+  }
+  return shape.empty() ? "scalar" : ss.str();
+}
+
+bool IsFloatingPoint(int32_t elem_type) {
+  return elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+         elem_type == ONNX_NAMESPACE::TensorProto_DataType_DOUBLE ||
+         elem_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16 ||
+         elem_type == ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16;
+}
+
+// Creates the single node model for `node`. Returns false if the node cannot be benchmarked in isolation, i.e. it has
+// a subgraph or an input whose type or shape is not known. `key` identifies the kernel case of the node.
+bool CreateKernelCase(const Graph& graph, const Node& node, int64_t free_dim_value, KernelCase& kernel_case,
+                      std::string& key) {
+  if (node.ContainsSubgraph()) {
+    return false;
+  }
+
+  ONNX_NAMESPACE::ModelProto model_proto;
+  model_proto.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  for (const auto& [domain, version] : graph.DomainToVersionMap()) {
+    auto* opset_import = model_proto.add_opset_import();
+    opset_import->set_domain(domain);
+    opset_import->set_version(version);
+  }
+
+  auto* graph_proto = model_proto.mutable_graph();
+  graph_proto->set_name("kernel");
+  auto* node_proto = graph_proto->add_node();
+  node.ToProto(*node_proto);
+  node_proto->set_name("node");
+
+  // the key is the model with the values of the floating point initializers removed
+  ONNX_NAMESPACE::GraphProto key_initializers;
+  std::ostringstream input_shapes;
+
+  const auto& input_defs = node.InputDefs();
+  for (size_t i = 0; i < input_defs.size(); ++i) {
+    if (!input_defs[i]->Exists()) {
+      continue;
+    }
+
+    const std::string input_name = "input_" + std::to_string(i);
+    node_proto->set_input(static_cast<int>(i), input_name);
+
+    const auto* type = input_defs[i]->TypeAsProto();
+    if (type == nullptr || !type->has_tensor_type()) {
+      return false;
+    }
+    const int32_t elem_type = type->tensor_type().elem_type();
+
+    const auto* initializer = graph.GetConstantInitializer(input_defs[i]->Name(), true);
+    if (initializer != nullptr && !utils::HasExternalData(*initializer)) {
+      auto* tensor = graph_proto->add_initializer();
+      *tensor = *initializer;
+      tensor->set_name(input_name);
+      input_shapes << (input_shapes.tellp() > 0 ? "," : "") << "const:"
+                   << ShapeToString({initializer->dims().begin(), initializer->dims().end()});
+
+      auto* key_tensor = key_initializers.add_initializer();
+      if (IsFloatingPoint(elem_type)) {
+        key_tensor->set_data_type(elem_type);
+        *key_tensor->mutable_dims() = initializer->dims();
+      } else {
+        *key_tensor = *tensor;
+      }
+      continue;
+    }
+
+    const auto* shape = input_defs[i]->Shape();
+    if (shape == nullptr) {
+      return false;
+    }
+
+    KernelInput input{input_name, static_cast<ONNXTensorElementDataType>(elem_type), {}};
+    auto* value_info = graph_proto->add_input();
+    value_info->set_name(input_name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(elem_type);
+    auto* value_info_shape = tensor_type->mutable_shape();
+    for (const auto& dim : shape->dim()) {
+      const int64_t dim_value = dim.has_dim_value() ? dim.dim_value() : free_dim_value;
+      value_info_shape->add_dim()->set_dim_value(dim_value);
+      input.shape.push_back(dim_value);
+    }
+    input_shapes << (input_shapes.tellp() > 0 ? "," : "") << ShapeToString(input.shape);
+    kernel_case.inputs.push_back(std::move(input));
+  }
+
+  const auto& output_defs = node.OutputDefs();
+  for (size_t i = 0; i < output_defs.size(); ++i) {
+    if (!output_defs[i]->Exists()) {
+      continue;
+    }
+
+    const std::string output_name = "output_" + std::to_string(i);
+    node_proto->set_output(static_cast<int>(i), output_name);
+
+    const auto* type = output_defs[i]->TypeAsProto();
+    if (type == nullptr) {
+      return false;
+    }
+    auto* value_info = graph_proto->add_output();
+    value_info->set_name(output_name);
+    *value_info->mutable_type() = *type;
+    if (value_info->type().has_tensor_type()) {
+      value_info->mutable_type()->mutable_tensor_type()->clear_shape();
+    }
+    kernel_case.output_names.push_back(output_name);
+  }
+
+  kernel_case.name = (node.Domain().empty() ? "" : node.Domain() + ":") + node.OpType() + "/" + input_shapes.str();
+  if (!model_proto.SerializeToString(&kernel_case.model_data)) {
+    return false;
+  }
+
+  auto* key_graph = model_proto.mutable_graph();
+  key_graph->clear_initializer();
+  *key_graph->mutable_initializer() = key_initializers.initializer();
+  model_proto.SerializeToString(&key);
+  return true;
+}
+
+void FillRandom(Ort::Value& value, const KernelInput& input, std::mt19937& engine) {
+  const size_t count = value.GetTensorTypeAndShapeInfo().GetElementCount();
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  switch (input.type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT: {
+      float* data = value.GetTensorMutableData<float>();
+      std::generate(data, data + count, [&]() { return dist(engine); });
+      break;
+    }
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE: {
+      double* data = value.GetTensorMutableData<double>();
+      std::generate(data, data + count, [&]() { return static_cast<double>(dist(engine)); });
+      break;
+    }
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16: {
+      Ort::Float16_t* data = value.GetTensorMutableData<Ort::Float16_t>();
+      std::generate(data, data + count, [&]() { return Ort::Float16_t(dist(engine)); });
+      break;
+    }
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16: {
+      Ort::BFloat16_t* data = value.GetTensorMutableData<Ort::BFloat16_t>();
+      std::generate(data, data + count, [&]() { return Ort::BFloat16_t(dist(engine)); });
+      break;
+    }
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING:
+      // the strings are empty
+      break;
+    default:
+      // integer inputs are mostly indices, zeros are valid for any of them
+      std::memset(value.GetTensorMutableRawData(), 0,
+                  count * DataTypeImpl::TensorTypeFromONNXEnum(input.type)->GetElementType()->Size());
+      break;
+  }
+}
+
+void AppendExecutionProvider(Ort::SessionOptions& session_options, const std::string& ep) {
+  if (ep == "cpu") {
+    return;
+  }
+
+  // measure the kernel of the EP, not the CPU EP fallback
+  session_options.AddConfigEntry(kOrtSessionOptionsDisableCPUEPFallback, "1");
+  if (ep == "cuda") {
+#ifdef USE_CUDA
+    OrtCUDAProviderOptions cuda_options;
+    session_options.AppendExecutionProvider_CUDA(cuda_options);
+    return;
+#else
+    ORT_CXX_API_THROW("CUDA is not enabled in this build", ORT_FAIL);
+#endif
+  }
+
+  // QNN, SNPE and XNNPACK
+  session_options.AppendExecutionProvider(ep);
+}
+
+void BM_ModelKernel(benchmark::State& state, const KernelCase& kernel_case, const std::string& ep, int threads) {
+  ORT_TRY {
+    Ort::Env ort_env{ORT_LOGGING_LEVEL_ERROR, "model_kernels"};
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(threads);
+    AppendExecutionProvider(session_options, ep);
+    Ort::Session session(ort_env, kernel_case.model_data.data(), kernel_case.model_data.size(), session_options);
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    std::mt19937 engine(0);
+    std::vector<const char*> input_names;
+    std::vector<Ort::Value> inputs;
+    for (const auto& input : kernel_case.inputs) {
+      inputs.push_back(Ort::Value::CreateTensor(allocator, input.shape.data(), input.shape.size(), input.type));
+      FillRandom(inputs.back(), input, engine);
+      input_names.push_back(input.name.c_str());
+    }
+    std::vector<const char*> output_names;
+    for (const auto& output_name : kernel_case.output_names) {
+      output_names.push_back(output_name.c_str());
+    }
+
+    Ort::RunOptions run_options;
+    for (auto _ : state) {
+      auto outputs = session.Run(run_options, input_names.data(), inputs.data(), inputs.size(),
+                                 output_names.data(), output_names.size());
+      benchmark::DoNotOptimize(outputs);
+    }
+
+    // the reporter only ranks the kernels with this counter, i.e. the ones that ran
+    state.counters["nodes"] = static_cast<double>(kernel_case.nodes);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      state.SkipWithError(ex.what());
+    });
+  }
+}
+
+}  // namespace
+
+bool ParseModelKernelBenchmarkOptions(int& argc, char** argv, ModelKernelBenchmarkOptions& options) {
+  auto get_value = [](const char* arg, const char* flag, std::string& value) {
+    const size_t flag_length = strlen(flag);
+    if (strncmp(arg, flag, flag_length) != 0 || arg[flag_length] != '=') {
+      return false;
+    }
+    value = arg + flag_length + 1;
+    return true;
+  };
+
+  int remaining = 1;
+  for (int i = 1; i < argc; ++i) {
+    std::string value;
+    ORT_TRY {
+      if (get_value(argv[i], "--model", value)) {
+        options.model_path = value;
+      } else if (get_value(argv[i], "--model_eps", value)) {
+        options.eps = SplitList(value);
+      } else if (get_value(argv[i], "--model_threads", value)) {
+        options.thread_counts.clear();
+        for (const auto& thread_count : SplitList(value)) {
+          options.thread_counts.push_back(std::stoi(thread_count));
+        }
+      } else if (get_value(argv[i], "--model_free_dim_value", value)) {
+        options.free_dim_value = std::stoll(value);
+      } else {
+        argv[remaining++] = argv[i];
+      }
+    }
+    ORT_CATCH(const std::exception&) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        std::cerr << "Invalid value of " << argv[i] << std::endl;
+      });
+      return false;
+    }
+  }
+  argc = remaining;
+
+  return options.model_path.empty() ||
+         (!options.eps.empty() && !options.thread_counts.empty() && options.free_dim_value > 0 &&
+          std::all_of(options.thread_counts.begin(), options.thread_counts.end(), [](int n) { return n > 0; }));
+}
+
+bool RegisterModelKernelBenchmarks(const ModelKernelBenchmarkOptions& options) {
+  auto logger = env->GetLoggingManager()->CreateLogger("model_kernels");
+  std::shared_ptr<Model> model;
+  auto status = Model::Load(ToPathString(options.model_path), model, nullptr, *logger);
+  if (!status.IsOK()) {
+    std::cerr << "Failed to load " << options.model_path << ": " << status.ErrorMessage() << std::endl;
+    return false;
+  }
+
+  const Graph& graph = model->MainGraph();
+  std::unordered_map<std::string, KernelCase*> cases_by_key;
+  std::unordered_map<std::string, size_t> cases_by_name;
+  size_t skipped_nodes = 0;
+  for (const auto& node : graph.Nodes()) {
+    auto kernel_case = std::make_unique<KernelCase>();
+    std::string key;
+    if (!CreateKernelCase(graph, node, options.free_dim_value, *kernel_case, key)) {
+      ++skipped_nodes;
+      continue;
+    }
+
+    auto entry = cases_by_key.find(key);
+    if (entry != cases_by_key.end()) {
+      ++entry->second->nodes;
+      continue;
+    }
+
+    // kernels of the same op and input shapes differ by their attributes or constant inputs
+    const size_t same_name_count = cases_by_name[kernel_case->name]++;
+    if (same_name_count != 0) {
+      kernel_case->name += "#" + std::to_string(same_name_count);
+    }
+    kernel_case->nodes = 1;
+    cases_by_key.emplace(std::move(key), kernel_case.get());
+    kernel_cases.push_back(std::move(kernel_case));
+  }
+
+  if (skipped_nodes != 0) {
+    std::cerr << skipped_nodes << " nodes of " << options.model_path
+              << " are not benchmarked as they have a subgraph or an input of unknown type or shape." << std::endl;
+  }
+
+  for (const auto& ep : options.eps) {
+    for (int threads : options.thread_counts) {
+      const std::string config = ep + "/threads:" + std::to_string(threads);
+      for (const auto& kernel_case : kernel_cases) {
+        const std::string name = "ModelKernel/" + config + "/" + kernel_case->name;
+        benchmark::RegisterBenchmark(name.c_str(), BM_ModelKernel, std::cref(*kernel_case), ep, threads)
+            ->Unit(benchmark::kMicrosecond)
+            ->UseRealTime();
+        registered_benchmarks[name] = {config, kernel_case.get()};
+      }
+    }
+  }
+  return true;
+}
+
+void ModelKernelReporter::ReportRuns(const std::vector<Run>& reports) {
+  for (const auto& run : reports) {
+    if (run.run_type != Run::RT_Iteration || run.counters.find("nodes") == run.counters.end()) {
+      continue;
+    }
+    auto& kernel_time = kernel_times_[run.benchmark_name()];
+    kernel_time.seconds_per_run += run.GetAdjustedRealTime() / benchmark::GetTimeUnitMultiplier(run.time_unit);
+    ++kernel_time.runs;
+  }
+  ConsoleReporter::ReportRuns(reports);
+}
+
+void ModelKernelReporter::PrintRankedReport() const {
+  struct RankedKernel {
+    const KernelCase* kernel_case;
+    double seconds_per_run;
+  };
+  std::map<std::string, std::vector<RankedKernel>> kernels_by_config;
+  for (const auto& [name, kernel_time] : kernel_times_) {
+    auto entry = registered_benchmarks.find(name);
+    if (entry != registered_benchmarks.end()) {
+      kernels_by_config[entry->second.config].push_back(
+          {entry->second.kernel_case, kernel_time.seconds_per_run / kernel_time.runs});
+    }
+  }
+
+  for (auto& [config, kernels] : kernels_by_config) {
+    auto total_seconds = [](const RankedKernel& kernel) { return kernel.seconds_per_run * kernel.kernel_case->nodes; };
+    std::sort(kernels.begin(), kernels.end(), [&](const RankedKernel& a, const RankedKernel& b) {
+      return total_seconds(a) > total_seconds(b);
+    });
+    double model_seconds = 0;
+    for (const auto& kernel : kernels) {
+      model_seconds += total_seconds(kernel);
+    }
+
+    std::cout << "\nKernels ranked by time per model run (" << config << "), total "
+              << std::fixed << std::setprecision(3) << model_seconds * 1e3 << " ms\n"
+              << std::setw(5) << "Rank" << std::setw(12) << "Total(ms)" << std::setw(8) << "Share"
+              << std::setw(14) << "Per node(us)" << std::setw(7) << "Nodes" << "  Kernel\n";
+    for (size_t i = 0; i < kernels.size(); ++i) {
+      const auto& kernel = kernels[i];
+      std::cout << std::setw(5) << i + 1 << std::setw(12) << total_seconds(kernel) * 1e3
+                << std::setw(7) << std::setprecision(1) << 100 * total_seconds(kernel) / model_seconds << "%"
+                << std::setw(14) << std::setprecision(3) << kernel.seconds_per_run * 1e6
+                << std::setw(7) << kernel.kernel_case->nodes << "  " << kernel.kernel_case->name << "\n";
+    }
+  }
+  std::cout << std::defaultfloat << std::flush;
+}
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// Benchmarks of the kernels of a model, each run in isolation with the shapes, attributes and constant inputs its
+// nodes have in the model:
+//
+//   onnxruntime_benchmark --model=<model.onnx> [--model_eps=cpu,cuda] [--model_threads=1,4]
+//                         [--model_free_dim_value=1] [--benchmark_filter=ModelKernel]
+//
+// Nodes with the same op, input types and shapes, attributes and constant inputs are benchmarked once, as a single
+// node model, with every EP and intra op thread count. Floating point constant inputs are compared by type and shape
+// only as their values don't change the work of a kernel. The inputs that are not constant are filled with random
+// values. A symbolic dimension is set to the free dimension value.
+//
+// After the benchmarks ran, the kernels are ranked for every EP and thread count by their time per run multiplied
+// by their number of nodes in the model, to find the kernels that take the largest part of a run of the model.
+
+struct ModelKernelBenchmarkOptions {
+  std::string model_path;
+  std::vector<std::string> eps{"cpu"};
+  std::vector<int> thread_counts{1};
+  int64_t free_dim_value{1};
+};
+
+// Parses and removes the --model* arguments from argv, as google benchmark rejects unknown arguments.
+bool ParseModelKernelBenchmarkOptions(int& argc, char** argv, ModelKernelBenchmarkOptions& options);
+
+// Registers the benchmarks of the kernels of options.model_path. Returns false if the model cannot be loaded.
+bool RegisterModelKernelBenchmarks(const ModelKernelBenchmarkOptions& options);
+
+// Reports the runs on the console like the default reporter and ranks the kernels of the model afterwards.
+class ModelKernelReporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRuns(const std::vector<Run>& reports) override;
+
+  void PrintRankedReport() const;
+
+ private:
+  struct KernelTime {
+    double seconds_per_run{0};
+    size_t runs{0};
+  };
+
+  // benchmark name to the time of the kernel
+  std::map<std::string, KernelTime> kernel_times_;
+};
@@ -34,17 +34,25 @@
 #include "core/optimizer/conv_add_fusion.h"
 #include "core/optimizer/conv_bn_fusion.h"
 #include "core/optimizer/matmul_bn_fusion.h"
+#include "core/optimizer/matmul_float8_fusion.h"
+#include "core/optimizer/multihead_attention_fusion.h"
 #include "core/optimizer/pad_fusion.h"
 #include "core/optimizer/conv_mul_fusion.h"
 #include "core/optimizer/div_mul_fusion.h"
+#include "core/optimizer/dq_matmul_nbits_fusion.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/dynamic_quantize_matmul_packing.h"
+#include "core/optimizer/dynamic_quantize_skip_layer_norm_fusion.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/gather_fusion.h"
 #include "core/optimizer/gelu_approximation.h"
 #include "core/optimizer/gelu_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
+#include "core/optimizer/gemm_epilogue_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
 #include "core/optimizer/graph_transformer.h"
@@ -52,10 +60,13 @@
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/optimizer/identity_elimination.h"
+#include "core/optimizer/inference_recompute.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/isinf_reducesum_fusion.h"
 #include "core/optimizer/matmul_add_fusion.h"
 #include "core/optimizer/matmul_integer_to_float.h"
+#include "core/optimizer/matmul_nbits_quantization.h"
+#include "core/optimizer/matmul_packing.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
 #include "core/optimizer/noop_elimination.h"
@@ -65,8 +76,11 @@
 #include "core/optimizer/relu_clip_fusion.h"
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
+#include "core/optimizer/shape_compute_fusion.h"
 #include "core/optimizer/shape_input_merge.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/tensor_parallel_sharding.h"
+#include "core/optimizer/token_embed_layer_norm_fusion.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/utils.h"
 #include "core/optimizer/label_encoder_fusion.h"
@@ -74,6 +88,7 @@
 #include "core/session/inference_session.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/math.h"
+#include "core/util/thread_utils.h"
 #include "test/capturing_sink.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/compare_ortvalue.h"
@@ -733,6 +748,74 @@ TEST_F(GraphTransformationTests, ConstantFoldingSubgraph) {
       << "Constant folding should have been able to remove the Add node in both subgraphs";
 }
 
+// The rule-based transformer transforms the branches of an If node concurrently when given a thread pool
+TEST_F(GraphTransformationTests, RuleBasedTransformerSubgraphsConcurrently) {
+  TypeProto float_tensor_type;
+  float_tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  auto create_subgraph = [&](GraphProto& graph_proto) {
+    Model model("RuleBasedTransformerSubgraphsConcurrently_subgraph", false, ModelMetaData(), PathString(),
+                IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+    auto& graph = model.MainGraph();
+
+    auto& parent_input_arg = graph.GetOrCreateNodeArg("parent_input", &float_tensor_type);
+    graph.AddOuterScopeNodeArg("parent_input");
+
+    auto& add_out = graph.GetOrCreateNodeArg("add_out", &float_tensor_type);
+    graph.AddNode("add", "Add", "Add the input to itself.", {&parent_input_arg, &parent_input_arg}, {&add_out});
+
+    // the first Identity can be eliminated, the second one provides the subgraph output
+    auto& identity_out = graph.GetOrCreateNodeArg("identity_out", &float_tensor_type);
+    graph.AddNode("identity_0", "Identity", "Eliminated.", {&add_out}, {&identity_out});
+    auto& subgraph_out = graph.GetOrCreateNodeArg("subgraph_out", &float_tensor_type);
+    graph.AddNode("identity_1", "Identity", "Provides the subgraph output.", {&identity_out}, {&subgraph_out});
+
+    ASSERT_STATUS_OK(graph.Resolve());
+    graph_proto = graph.ToGraphProto();
+  };
+
+  Model model("RuleBasedTransformerSubgraphsConcurrently_main_graph", false, ModelMetaData(), PathString(),
+              IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {}, *logger_);
+  auto& graph = model.MainGraph();
+
+  TypeProto if_cond_type;
+  if_cond_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  if_cond_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto& if_cond_input = graph.GetOrCreateNodeArg("if_in", &if_cond_type);
+  // the value of the main graph used by the branches
+  TensorProto parent_value_tensor;
+  parent_value_tensor.add_dims(1);
+  parent_value_tensor.add_float_data(1.f);
+  parent_value_tensor.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  parent_value_tensor.set_name("parent_input");
+  graph.AddInitializedTensor(parent_value_tensor);
+  auto& if_output = graph.GetOrCreateNodeArg("if_out", &float_tensor_type);
+  auto& if_node = graph.AddNode("if", "If", "If node", {&if_cond_input}, {&if_output});
+
+  GraphProto subgraph;
+  create_subgraph(subgraph);
+  if_node.AddAttribute("then_branch", subgraph);
+  if_node.AddAttribute("else_branch", subgraph);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_EQ(CountOpsInGraph(graph)["Identity"], 4);
+
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 2;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.SetThreadPool(tp.get());
+  auto rule_transformer_L1 = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer1");
+  ASSERT_STATUS_OK(rule_transformer_L1->Register(std::make_unique<EliminateIdentity>()));
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1));
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  // the first Identity of each branch is eliminated
+  ASSERT_EQ(CountOpsInGraph(graph)["Identity"], 2);
+}
+
 TEST_F(GraphTransformationTests, ConstantFoldingWithShapeToInitializer) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/constant_folding_with_shape_to_initializer.onnx";
   std::shared_ptr<Model> model;
@@ -1026,6 +1109,78 @@ TEST_F(GraphTransformationTests, ConstantFoldingAShapeNodeDeepInTheGraph) {
   ASSERT_TRUE(op_to_count.size() == 0U);
 }
 
+// Gather(Shape(X)) is folded when the gathered dim is known even if other dims of X are symbolic, so a condition
+// testing that dim, e.g. for an If node, becomes constant. Gathering a symbolic dim is left as is.
+TEST_F(GraphTransformationTests, ConstantFoldingGatherOfPartiallyKnownShape) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeSymbolicInput<float>({"batch", "seq", 8});
+    auto* shape_out = builder.MakeIntermediate();
+    auto* hidden_out = builder.MakeIntermediate();
+    auto* batch_out = builder.MakeOutput();
+    auto* cond_out = builder.MakeOutput();
+
+    builder.AddNode("Shape", {input_arg}, {shape_out});
+    builder.AddNode("Gather", {shape_out, builder.MakeScalarInitializer<int64_t>(-1)}, {hidden_out});
+    builder.AddNode("Equal", {hidden_out, builder.MakeScalarInitializer<int64_t>(8)}, {cond_out});
+    builder.AddNode("Gather", {shape_out, builder.MakeScalarInitializer<int64_t>(0)}, {batch_out});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 2);
+    return Status::OK();
+  };
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["Shape"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["Gather"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["Equal"] == 0);
+    return Status::OK();
+  };
+
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  const ConfigOptions empty_config_options;
+  std::unique_ptr<GraphTransformer> transformer =
+      std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/, empty_config_options);
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                        TransformerLevel::Level1, 1, pre_graph_checker, post_graph_checker));
+}
+
+// Batched constant folding evaluates all the constant nodes of a graph in a single execution frame,
+// and should fold the same nodes as constant folding a node at a time.
+TEST_F(GraphTransformationTests, ConstantFoldingBatched) {
+  auto fold = [this](const ORTCHAR_T* model_uri, bool batched, std::map<std::string, int>& op_to_count) {
+    std::shared_ptr<Model> model;
+    ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, *logger_));
+    Graph& graph = model->MainGraph();
+
+    std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+    onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+    ConfigOptions config_options;
+    ASSERT_STATUS_OK(config_options.AddConfigEntry(kOrtSessionOptionsEnableBatchedConstantFolding,
+                                                   batched ? "1" : "0"));
+    ASSERT_STATUS_OK(graph_transformation_mgr.Register(
+        std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/, config_options),
+        TransformerLevel::Level1));
+
+    ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+    op_to_count = CountOpsInGraph(graph);
+  };
+
+  for (const ORTCHAR_T* model_uri : {MODEL_FOLDER "fusion/fuse-conv-bn-mul-add-unsqueeze.onnx",
+                                     MODEL_FOLDER "shape-add.onnx",
+                                     MODEL_FOLDER "fusion/constant_folding_remove_dangling_inputs.onnx"}) {
+    std::map<std::string, int> expected_op_to_count;
+    std::map<std::string, int> op_to_count;
+    fold(model_uri, false, expected_op_to_count);
+    fold(model_uri, true, op_to_count);
+    ASSERT_EQ(op_to_count, expected_op_to_count);
+  }
+
+  std::map<std::string, int> op_to_count;
+  fold(MODEL_FOLDER "fusion/fuse-conv-bn-mul-add-unsqueeze.onnx", true, op_to_count);
+  ASSERT_EQ(op_to_count["Unsqueeze"], 0);
+}
+
 // Test we don't fail when constant folding hits a string initializer
 TEST_F(GraphTransformationTests, ConstantFoldingStringInitializer) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "gh_issue_17392.onnx";
@@ -4495,6 +4650,28 @@ TEST_F(GraphTransformationTests, GeluFusionTest) {
   ASSERT_TRUE(op_to_count["com.microsoft.Gelu"] == 1);
 }
 
+TEST_F(GraphTransformationTests, GeluFusionTest_JsEp) {
+  constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/gelu.onnx";
+  std::shared_ptr<Model> p_model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, p_model, nullptr, *logger_));
+  Graph& graph = p_model->MainGraph();
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kJsExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  const InlinedHashSet<std::string_view> js_ep = {kJsExecutionProvider};
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::make_unique<GeluFusion>(js_ep), TransformerLevel::Level2));
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2, *logger_));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Erf"] == 0);
+  ASSERT_TRUE(op_to_count["com.microsoft.Gelu"] == 1);
+  for (const auto& node : graph.Nodes()) {
+    EXPECT_EQ(node.GetExecutionProviderType(), kJsExecutionProvider);
+  }
+}
+
 TEST_F(GraphTransformationTests, GeluFusionTestSwitchOrderFormat2) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/gelu_format2_0.onnx";
   std::shared_ptr<Model> p_model;
@@ -5817,6 +5994,283 @@ TEST_F(GraphTransformationTests, MatMulIntegerToFloat16Test) {
 }
 #endif  // USE_DML
 
+// MatMulNBits -> Add(bias) -> Relu -> Add(residual) is fused into a single MatMulNBits with an epilogue.
+TEST_F(GraphTransformationTests, GemmEpilogueFusion_MatMulNBits) {
+  constexpr int64_t K = 16, N = 8, block_size = 16;
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({{2, 3, K}});
+    auto* residual_arg = builder.MakeInput<float>({{2, 3, N}});
+    auto* b_arg = builder.MakeInitializer<uint8_t>({N, 1, block_size / 2}, 0, 255);
+    auto* scales_arg = builder.MakeInitializer<float>({N}, 0.5f, 1.0f);
+    auto* bias_arg = builder.MakeInitializer<float>({N}, -1.0f, 1.0f);
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* bias_out = builder.MakeIntermediate();
+    auto* relu_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    Node& matmul = builder.AddNode("MatMulNBits", {input_arg, b_arg, scales_arg}, {matmul_out}, kMSDomain);
+    matmul.AddAttribute("K", K);
+    matmul.AddAttribute("N", N);
+    matmul.AddAttribute("bits", static_cast<int64_t>(4));
+    matmul.AddAttribute("block_size", block_size);
+    builder.AddNode("Add", {matmul_out, bias_arg}, {bias_out});
+    builder.AddNode("Relu", {bias_out}, {relu_out});
+    builder.AddNode("Add", {residual_arg, relu_out}, {output_arg});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.MatMulNBits"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 2);
+    TEST_RETURN_IF_NOT(op_to_count["Relu"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.MatMulNBits"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Relu"] == 0);
+    for (const Node& node : graph.Nodes()) {
+      TEST_RETURN_IF_NOT(node.InputDefs().size() == 7);
+      TEST_RETURN_IF_NOT(!node.InputDefs()[4]->Exists());
+      TEST_RETURN_IF_NOT(node.InputDefs()[5]->Exists() && node.InputDefs()[6]->Exists());
+      TEST_RETURN_IF_NOT(node.GetInputEdgesCount() == 0);
+      const auto* activation = graph_utils::GetNodeAttribute(node, "activation");
+      TEST_RETURN_IF_NOT(activation != nullptr && activation->s() == "Relu");
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::make_unique<GemmEpilogueFusion>(),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+// The activation output is also used elsewhere, so only the bias can be fused.
+TEST_F(GraphTransformationTests, GemmEpilogueFusion_DynamicQuantizeMatMul_IntermediateOutputUsed) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({{4, 16}});
+    auto* residual_arg = builder.MakeInput<float>({{4, 8}});
+    auto* b_arg = builder.MakeInitializer<uint8_t>({16, 8}, 0, 255);
+    auto* b_scale_arg = builder.MakeInitializer<float>({}, {0.1f});
+    auto* bias_arg = builder.MakeInitializer<float>({8}, -1.0f, 1.0f);
+    auto* matmul_out = builder.MakeIntermediate();
+    auto* bias_out = builder.MakeIntermediate();
+    auto* relu_out = builder.MakeOutput();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("DynamicQuantizeMatMul", {input_arg, b_arg, b_scale_arg}, {matmul_out}, kMSDomain);
+    builder.AddNode("Add", {matmul_out, bias_arg}, {bias_out});
+    builder.AddNode("Relu", {bias_out}, {relu_out});
+    builder.AddNode("Add", {relu_out, residual_arg}, {output_arg});
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.DynamicQuantizeMatMul"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Relu"] == 1);
+    for (const Node& node : graph.Nodes()) {
+      if (node.OpType() == "DynamicQuantizeMatMul") {
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 5 && node.InputDefs()[4]->Exists());
+        TEST_RETURN_IF_NOT(graph_utils::GetNodeAttribute(node, "activation") == nullptr);
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::make_unique<GemmEpilogueFusion>(),
+                                        TransformerLevel::Level2, 1, nullptr, post_graph_checker));
+}
+
+// The projections sharing their input are packed into one DynamicQuantizeMatMul, with per-tensor and per-column
+// parameters and optional zero points and biases. The projection with a residual is kept.
+TEST_F(GraphTransformationTests, DynamicQuantizeMatMulPacking) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({{2, 4, 32}});
+    auto* residual_arg = builder.MakeInput<float>({{2, 4, 8}});
+    auto* q_out = builder.MakeOutput();
+    auto* k_out = builder.MakeOutput();
+    auto* v_out = builder.MakeOutput();
+    auto* residual_out = builder.MakeOutput();
+
+    builder.AddNode("DynamicQuantizeMatMul",
+                    {input_arg, builder.MakeInitializer<uint8_t>({32, 16}, 0, 255),
+                     builder.MakeInitializer<float>({}, {0.02f})},
+                    {q_out}, kMSDomain);
+    builder.AddNode("DynamicQuantizeMatMul",
+                    {input_arg, builder.MakeInitializer<uint8_t>({32, 16}, 0, 255),
+                     builder.MakeInitializer<float>({16}, 0.01f, 0.03f),
+                     builder.MakeInitializer<uint8_t>({16}, 100, 150)},
+                    {k_out}, kMSDomain);
+    builder.AddNode("DynamicQuantizeMatMul",
+                    {input_arg, builder.MakeInitializer<uint8_t>({32, 8}, 0, 255),
+                     builder.MakeInitializer<float>({}, {0.03f}),
+                     builder.MakeInitializer<uint8_t>({}, {128}),
+                     builder.MakeInitializer<float>({8}, -1.0f, 1.0f)},
+                    {v_out}, kMSDomain);
+    builder.AddNode("DynamicQuantizeMatMul",
+                    {input_arg, builder.MakeInitializer<uint8_t>({32, 8}, 0, 255),
+                     builder.MakeInitializer<float>({}, {0.03f}), builder.MakeEmptyInput(),
+                     builder.MakeEmptyInput(), residual_arg},
+                    {residual_out}, kMSDomain);
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.DynamicQuantizeMatMul"], 2);
+    EXPECT_EQ(op_to_count["Split"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-5, 1e-5, std::make_unique<DynamicQuantizeMatMulPacking>());
+}
+
+// The gate and up projections sharing their input are packed, the MatMul with a computed B is kept.
+TEST_F(GraphTransformationTests, MatMulPacking_MatMul) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({{2, 4, 32}});
+    auto* other_arg = builder.MakeInput<float>({{32, 8}});
+    auto* gate_out = builder.MakeOutput();
+    auto* up_out = builder.MakeOutput();
+    auto* other_out = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, builder.MakeInitializer<float>({32, 24}, -1.0f, 1.0f)}, {gate_out});
+    builder.AddNode("MatMul", {input_arg, builder.MakeInitializer<float>({32, 16}, -1.0f, 1.0f)}, {up_out});
+    builder.AddNode("MatMul", {input_arg, other_arg}, {other_out});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["MatMul"], 2);
+    EXPECT_EQ(op_to_count["Split"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-5, 1e-5, std::make_unique<MatMulPacking>());
+}
+
+// The MatMulNBits nodes with the same quantization are packed, a missing bias is filled with zeros.
+TEST_F(GraphTransformationTests, MatMulPacking_MatMulNBits) {
+  constexpr int64_t K = 32, block_size = 16;
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({{2, 3, K}});
+    auto add_matmul_nbits = [&](int64_t N, int64_t node_block_size, bool with_bias) {
+      const int64_t k_blocks = K / node_block_size;
+      std::vector<NodeArg*> inputs{input_arg,
+                                   builder.MakeInitializer<uint8_t>({N, k_blocks, node_block_size / 2}, 0, 255),
+                                   builder.MakeInitializer<float>({N * k_blocks}, 0.5f, 1.0f),
+                                   builder.MakeInitializer<uint8_t>({N * ((k_blocks + 1) / 2)}, 0, 255)};
+      if (with_bias) {
+        inputs.push_back(builder.MakeEmptyInput());
+        inputs.push_back(builder.MakeInitializer<float>({N}, -1.0f, 1.0f));
+      }
+      Node& matmul = builder.AddNode("MatMulNBits", inputs, {builder.MakeOutput()}, kMSDomain);
+      matmul.AddAttribute("K", K);
+      matmul.AddAttribute("N", N);
+      matmul.AddAttribute("bits", static_cast<int64_t>(4));
+      matmul.AddAttribute("block_size", node_block_size);
+    };
+
+    add_matmul_nbits(16, block_size, true);
+    add_matmul_nbits(8, block_size, false);
+    add_matmul_nbits(8, block_size * 2, false);
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 2);
+    EXPECT_EQ(op_to_count["Split"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-5, 1e-5, std::make_unique<MatMulPacking>());
+}
+
+#if !defined(DISABLE_FLOAT8_TYPES)
+// The MatMul of dequantized float 8 tensors becomes a GemmFloat8 with B transposed. A DequantizeLinear shared by
+// several MatMul nodes is not fused.
+TEST_F(GraphTransformationTests, MatMulFloat8Fusion) {
+  auto make_float8 = [](const std::vector<float>& values) {
+    std::vector<Float8E4M3FN> result;
+    for (float value : values) {
+      result.push_back(Float8E4M3FN(value));
+    }
+    return result;
+  };
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<Float8E4M3FN>({{4, 2}});
+    auto* dq_a_out = builder.MakeIntermediate();
+    auto* dq_b_out = builder.MakeIntermediate();
+    auto* dq_c_out = builder.MakeIntermediate();
+    builder.AddNode("DequantizeLinear", {input_arg, builder.MakeInitializer<float>({}, {0.5f})}, {dq_a_out});
+    builder.AddNode("DequantizeLinear",
+                    {builder.MakeInitializer<Float8E4M3FN>({2, 3}, make_float8({1, 2, 3, 4, 5, 6})),
+                     builder.MakeInitializer<float>({}, {0.25f})},
+                    {dq_b_out});
+    builder.AddNode("DequantizeLinear",
+                    {builder.MakeInitializer<Float8E4M3FN>({2, 3}, make_float8({1, 2, 3, 4, 5, 6})),
+                     builder.MakeInitializer<float>({3}, {0.25f, 0.5f, 1.0f})},
+                    {dq_c_out})
+        .AddAttribute("axis", static_cast<int64_t>(1));
+    builder.AddNode("MatMul", {dq_a_out, dq_b_out}, {builder.MakeOutput()});
+    builder.AddNode("MatMul", {dq_a_out, dq_c_out}, {builder.MakeOutput()});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["MatMul"] == 2);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    // dq_a feeds both MatMul nodes, so neither is fused
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GemmFloat8"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 2);
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 19, *logger_, std::make_unique<MatMulFloat8Fusion>(),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+
+  auto build_single_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<Float8E4M3FN>({{4, 2}});
+    auto* dq_a_out = builder.MakeIntermediate();
+    auto* dq_b_out = builder.MakeIntermediate();
+    builder.AddNode("DequantizeLinear", {input_arg, builder.MakeInitializer<float>({}, {0.5f})}, {dq_a_out});
+    builder.AddNode("DequantizeLinear",
+                    {builder.MakeInitializer<Float8E4M3FN>({2, 3}, make_float8({1, 2, 3, 4, 5, 6})),
+                     builder.MakeInitializer<float>({}, {0.25f})},
+                    {dq_b_out});
+    builder.AddNode("MatMul", {dq_a_out, dq_b_out}, {builder.MakeOutput()});
+  };
+
+  auto pre_graph_checker_single = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["MatMul"] == 1);
+    return Status::OK();
+  };
+
+  auto fused_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["com.microsoft.GemmFloat8"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["MatMul"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["DequantizeLinear"] == 0);
+    for (const Node& node : graph.Nodes()) {
+      const TensorProto* b = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+      TEST_RETURN_IF_NOT(b != nullptr && b->dims(0) == 3 && b->dims(1) == 2);
+      // B^T = [[1, 4], [2, 5], [3, 6]]
+      TEST_RETURN_IF_NOT(Float8E4M3FN(static_cast<uint8_t>(b->raw_data()[1]), Float8E4M3FN::FromBits()).ToFloat() ==
+                         4.0f);
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_single_test_case, 19, *logger_, std::make_unique<MatMulFloat8Fusion>(),
+                                        TransformerLevel::Level2, 1, pre_graph_checker_single, fused_graph_checker));
+}
+#endif
+
 #endif
 
 #ifndef DISABLE_CONTRIB_OPS
@@ -7690,6 +8144,668 @@ TEST_F(GraphTransformationTests, GatherToSliceFusion) {
   }
 }
 
+#ifndef DISABLE_CONTRIB_OPS
+TEST_F(GraphTransformationTests, EmbeddingBagFusion) {
+  // ReduceMean with the axes in an attribute (opset 12), ReduceSum with the axes in an input (opset 13)
+  for (int opset : {12, 13}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* weight_arg = builder.MakeInitializer<float>({50, 16}, -1.f, 1.f);
+      auto* indices_arg = builder.MakeInput<int64_t>({4, 3, 7}, static_cast<int64_t>(-50), static_cast<int64_t>(49));
+      auto* gather_out = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Gather", {weight_arg, indices_arg}, {gather_out});
+      if (opset == 12) {
+        auto& reduce = builder.AddNode("ReduceMean", {gather_out}, {output_arg});
+        reduce.AddAttribute("axes", std::vector<int64_t>{-2});
+        reduce.AddAttribute("keepdims", static_cast<int64_t>(0));
+      } else {
+        auto* axes_arg = builder.MakeInitializer<int64_t>({1}, {static_cast<int64_t>(2)});
+        auto& reduce = builder.AddNode("ReduceSum", {gather_out, axes_arg}, {output_arg});
+        reduce.AddAttribute("keepdims", static_cast<int64_t>(0));
+      }
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["Gather"], 0);
+      EXPECT_EQ(op_to_count["ReduceMean"] + op_to_count["ReduceSum"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.EmbeddingBag"], 1);
+    };
+
+    TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, opset,
+                      1e-5, 1e-5);
+  }
+}
+
+TEST_F(GraphTransformationTests, EmbeddingBagFusion_Invalid) {
+  // the bag axis is kept, or the reduced axis is not the bag axis
+  for (bool keep_dims : {true, false}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* weight_arg = builder.MakeInitializer<float>({50, 16}, -1.f, 1.f);
+      auto* indices_arg = builder.MakeInput<int64_t>({4, 7}, static_cast<int64_t>(0), static_cast<int64_t>(49));
+      auto* gather_out = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Gather", {weight_arg, indices_arg}, {gather_out});
+      auto& reduce = builder.AddNode("ReduceSum", {gather_out}, {output_arg});
+      reduce.AddAttribute("axes", std::vector<int64_t>{keep_dims ? 1 : 2});
+      reduce.AddAttribute("keepdims", static_cast<int64_t>(keep_dims ? 1 : 0));
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 1);
+      return Status::OK();
+    };
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_count_map = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_count_map["Gather"] == 1);
+      TEST_RETURN_IF_NOT(op_count_map["com.microsoft.EmbeddingBag"] == 0);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<EmbeddingBagFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 12, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+}
+
+TEST_F(GraphTransformationTests, TokenEmbedLayerNormFusion) {
+  // LayerNormalization, and SimplifiedLayerNormalization of scaled embeddings which also feed a residual Add
+  for (bool simplified : {false, true}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* embedding_arg = builder.MakeInitializer<float>({50, 16}, -1.f, 1.f);
+      auto* ids_arg = builder.MakeInput<int64_t>({2, 5}, static_cast<int64_t>(0), static_cast<int64_t>(49));
+      auto* gamma_arg = builder.MakeInitializer<float>({16}, -1.f, 1.f);
+      auto* gather_out = builder.MakeIntermediate();
+      auto* norm_out = builder.MakeOutput();
+
+      builder.AddNode("Gather", {embedding_arg, ids_arg}, {gather_out});
+      if (simplified) {
+        auto* scale_arg = builder.MakeInitializer<float>({}, {4.0f});
+        auto* mul_out = builder.MakeIntermediate();
+        auto* residual_arg = builder.MakeInput<float>({2, 5, 16}, -1.f, 1.f);
+        auto* add_out = builder.MakeOutput();
+        builder.AddNode("Mul", {gather_out, scale_arg}, {mul_out});
+        builder.AddNode("SimplifiedLayerNormalization", {mul_out, gamma_arg}, {norm_out})
+            .AddAttribute("epsilon", 1e-6f);
+        builder.AddNode("Add", {mul_out, residual_arg}, {add_out});
+      } else {
+        auto* beta_arg = builder.MakeInitializer<float>({16}, -1.f, 1.f);
+        builder.AddNode("LayerNormalization", {gather_out, gamma_arg, beta_arg}, {norm_out});
+      }
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["Gather"], 0);
+      EXPECT_EQ(op_to_count["Mul"], 0);
+      EXPECT_EQ(op_to_count["LayerNormalization"] + op_to_count["SimplifiedLayerNormalization"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.TokenEmbedLayerNormalization"], 1);
+    };
+
+    TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 17,
+                      1e-5, 1e-5);
+  }
+}
+
+TEST_F(GraphTransformationTests, TokenEmbedLayerNormFusion_Invalid) {
+  // the embeddings are scaled per channel
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* embedding_arg = builder.MakeInitializer<float>({50, 16}, -1.f, 1.f);
+    auto* ids_arg = builder.MakeInput<int64_t>({2, 5}, static_cast<int64_t>(0), static_cast<int64_t>(49));
+    auto* scale_arg = builder.MakeInitializer<float>({16}, -1.f, 1.f);
+    auto* gamma_arg = builder.MakeInitializer<float>({16}, -1.f, 1.f);
+    auto* gather_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* norm_out = builder.MakeOutput();
+
+    builder.AddNode("Gather", {embedding_arg, ids_arg}, {gather_out});
+    builder.AddNode("Mul", {gather_out, scale_arg}, {mul_out});
+    builder.AddNode("SimplifiedLayerNormalization", {mul_out, gamma_arg}, {norm_out});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 1);
+    return Status::OK();
+  };
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["Gather"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["com.microsoft.TokenEmbedLayerNormalization"] == 0);
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<TokenEmbedLayerNormFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 17, *logger_, std::move(transformer),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, DynamicQuantizeSkipLayerNormFusion) {
+  // SkipLayerNormalization with beta and bias, SkipSimplifiedLayerNormalization, with and without the
+  // input_skip_bias_sum output
+  for (bool simplified : {false, true}) {
+    for (bool with_sum : {false, true}) {
+      auto build_test_case = [&](ModelTestBuilder& builder) {
+        auto* input_arg = builder.MakeInput<float>({2, 5, 32}, -2.f, 2.f);
+        auto* skip_arg = builder.MakeInput<float>({2, 5, 32}, -2.f, 2.f);
+        auto* gamma_arg = builder.MakeInitializer<float>({32}, 0.5f, 1.5f);
+        auto* norm_out = builder.MakeIntermediate();
+        auto* y_arg = builder.MakeOutput();
+        auto* y_scale_arg = builder.MakeOutput();
+        auto* y_zero_point_arg = builder.MakeOutput();
+
+        std::vector<NodeArg*> norm_inputs{input_arg, skip_arg, gamma_arg};
+        if (!simplified) {
+          norm_inputs.push_back(builder.MakeInitializer<float>({32}, -0.5f, 0.5f));  // beta
+          norm_inputs.push_back(builder.MakeInitializer<float>({32}, -0.5f, 0.5f));  // bias
+        }
+        std::vector<NodeArg*> norm_outputs{norm_out};
+        if (with_sum) {
+          norm_outputs.push_back(builder.MakeEmptyInput());
+          norm_outputs.push_back(builder.MakeEmptyInput());
+          norm_outputs.push_back(builder.MakeOutput());
+        }
+
+        auto& norm = builder.AddNode(simplified ? "SkipSimplifiedLayerNormalization" : "SkipLayerNormalization",
+                                     norm_inputs, norm_outputs, kMSDomain);
+        norm.AddAttribute("epsilon", 1e-5f);
+        builder.AddNode("DynamicQuantizeLinear", {norm_out}, {y_arg, y_scale_arg, y_zero_point_arg});
+      };
+
+      auto check_graph = [&](InferenceSessionWrapper& session) {
+        auto op_to_count = CountOpsInGraph(session.GetGraph());
+        EXPECT_EQ(op_to_count["com.microsoft.SkipLayerNormalization"], 0);
+        EXPECT_EQ(op_to_count["com.microsoft.SkipSimplifiedLayerNormalization"], 0);
+        EXPECT_EQ(op_to_count["DynamicQuantizeLinear"], 0);
+        EXPECT_EQ(op_to_count["com.microsoft.DynamicQuantizeSkipLayerNormalization"], 1);
+      };
+
+      TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                        1e-5, 1e-5);
+    }
+  }
+}
+
+TEST_F(GraphTransformationTests, DynamicQuantizeSkipLayerNormFusion_Invalid) {
+  // the normalized output is also consumed by another node
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 5, 32}, -2.f, 2.f);
+    auto* skip_arg = builder.MakeInput<float>({2, 5, 32}, -2.f, 2.f);
+    auto* gamma_arg = builder.MakeInitializer<float>({32}, 0.5f, 1.5f);
+    auto* norm_out = builder.MakeIntermediate();
+    auto* y_arg = builder.MakeOutput();
+    auto* y_scale_arg = builder.MakeOutput();
+    auto* y_zero_point_arg = builder.MakeOutput();
+    auto* identity_out = builder.MakeOutput();
+
+    builder.AddNode("SkipLayerNormalization", {input_arg, skip_arg, gamma_arg}, {norm_out}, kMSDomain);
+    builder.AddNode("DynamicQuantizeLinear", {norm_out}, {y_arg, y_scale_arg, y_zero_point_arg});
+    builder.AddNode("Identity", {norm_out}, {identity_out});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.SkipLayerNormalization"] == 1);
+    return Status::OK();
+  };
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["com.microsoft.SkipLayerNormalization"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["DynamicQuantizeLinear"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["com.microsoft.DynamicQuantizeSkipLayerNormalization"] == 0);
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<DynamicQuantizeSkipLayerNormFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, ElementwiseChainFusion) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8, 16}, -2.f, 2.f);
+    auto* bias_arg = builder.MakeInitializer<float>({16}, -1.f, 1.f);
+    auto* scale_arg = builder.MakeScalarInitializer<float>(0.5f);
+    auto* add_out = builder.MakeIntermediate();
+    auto* tanh_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* sub_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Add", {input_arg, bias_arg}, {add_out});
+    builder.AddNode("Tanh", {add_out}, {tanh_out});
+    builder.AddNode("Mul", {tanh_out, input_arg}, {mul_out});
+    builder.AddNode("Sub", {scale_arg, mul_out}, {sub_out});
+    builder.AddNode("Relu", {sub_out}, {output_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["Add"] + op_to_count["Tanh"] + op_to_count["Mul"] + op_to_count["Sub"] +
+                  op_to_count["Relu"],
+              0);
+    EXPECT_EQ(op_to_count["com.microsoft.FusedElementwise"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level2, TransformerLevel::Level3, 13,
+                    1e-5, 1e-5);
+}
+
+TEST_F(GraphTransformationTests, ElementwiseChainFusion_Invalid) {
+  // the first intermediate value is a graph output, or the bias does not broadcast along the leading dimensions
+  for (bool broadcast_inner : {false, true}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({2, 8, 16}, -2.f, 2.f);
+      auto* bias_arg = broadcast_inner ? builder.MakeInitializer<float>({8, 1}, -1.f, 1.f)
+                                       : builder.MakeInitializer<float>({16}, -1.f, 1.f);
+      auto* add_out = broadcast_inner ? builder.MakeIntermediate() : builder.MakeOutput();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Add", {input_arg, bias_arg}, {add_out});
+      builder.AddNode("Relu", {add_out}, {output_arg});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Add"] == 1);
+      return Status::OK();
+    };
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_count_map = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_count_map["Add"] == 1);
+      TEST_RETURN_IF_NOT(op_count_map["Relu"] == 1);
+      TEST_RETURN_IF_NOT(op_count_map["com.microsoft.FusedElementwise"] == 0);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseChainFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                          TransformerLevel::Level3, 1, pre_graph_checker, post_graph_checker));
+  }
+}
+
+// float16 chains are only fused on CUDA, where the FusedElementwise kernel supports them
+TEST_F(GraphTransformationTests, ElementwiseChainFusion_Float16) {
+  for (const char* provider : {kCpuExecutionProvider, kCudaExecutionProvider}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<MLFloat16>({{2, 8, 16}});
+      auto* bias_arg = builder.MakeInitializer<MLFloat16>({16}, std::vector<MLFloat16>(16, MLFloat16(0.5f)));
+      auto* add_out = builder.MakeIntermediate();
+      auto* sigmoid_out = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Add", {input_arg, bias_arg}, {add_out});
+      builder.AddNode("Sigmoid", {add_out}, {sigmoid_out});
+      builder.AddNode("Mul", {sigmoid_out, add_out}, {output_arg});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      for (auto& node : graph.Nodes()) {
+        node.SetExecutionProviderType(provider);
+      }
+      return Status::OK();
+    };
+    const bool fused = std::string(provider) == kCudaExecutionProvider;
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_count_map = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_count_map["com.microsoft.FusedElementwise"] == (fused ? 1 : 0));
+      TEST_RETURN_IF_NOT(op_count_map["Mul"] == (fused ? 0 : 1));
+      for (auto& node : graph.Nodes()) {
+        TEST_RETURN_IF_NOT(node.GetExecutionProviderType() == provider);
+      }
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<ElementwiseChainFusion>(
+        InlinedHashSet<std::string_view>{kCpuExecutionProvider, kCudaExecutionProvider});
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                          TransformerLevel::Level3, 1, pre_graph_checker, post_graph_checker));
+  }
+}
+
+// Q, K and V projections of (2, 8, 32) split into 4 heads of 8, as exported from a decoder layer
+static void BuildScaledDotProductAttention(ModelTestBuilder& builder, bool with_cache) {
+  auto* query_arg = builder.MakeInput<float>({2, 8, 32}, -1.f, 1.f);
+  auto* key_arg = builder.MakeInput<float>({2, 8, 32}, -1.f, 1.f);
+  auto* value_arg = builder.MakeInput<float>({2, 8, 32}, -1.f, 1.f);
+  auto* past_key_arg = with_cache ? builder.MakeInput<float>({2, 4, 3, 8}, -1.f, 1.f) : nullptr;
+  auto* past_value_arg = with_cache ? builder.MakeInput<float>({2, 4, 3, 8}, -1.f, 1.f) : nullptr;
+  auto* mask_arg = with_cache ? builder.MakeInput<float>({1, 1, 8, 11}, -1.f, 0.f)
+                              : builder.MakeInput<float>({2, 1, 8, 8}, -1.f, 0.f);
+  auto* heads_shape_arg = builder.MakeInitializer<int64_t>({4}, {0, 0, 4, 8});
+  auto* hidden_shape_arg = builder.MakeInitializer<int64_t>({3}, {0, 0, 32});
+  auto* scale_arg = builder.MakeScalarInitializer<float>(2.8284271f);  // sqrt(head_size)
+
+  NodeArg* heads[3];
+  NodeArg* inputs[3] = {query_arg, key_arg, value_arg};
+  for (int i = 0; i < 3; ++i) {
+    auto* bsnh_arg = builder.MakeIntermediate();
+    heads[i] = builder.MakeIntermediate();
+    builder.AddNode("Reshape", {inputs[i], heads_shape_arg}, {bsnh_arg});
+    builder.AddNode("Transpose", {bsnh_arg}, {heads[i]}).AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+  }
+
+  NodeArg* key_heads = heads[1];
+  NodeArg* value_heads = heads[2];
+  if (with_cache) {
+    key_heads = builder.MakeOutput();
+    value_heads = builder.MakeOutput();
+    builder.AddNode("Concat", {past_key_arg, heads[1]}, {key_heads}).AddAttribute("axis", static_cast<int64_t>(2));
+    builder.AddNode("Concat", {past_value_arg, heads[2]}, {value_heads}).AddAttribute("axis", static_cast<int64_t>(-2));
+  }
+
+  auto* key_transposed = builder.MakeIntermediate();
+  auto* scores = builder.MakeIntermediate();
+  auto* scaled_scores = builder.MakeIntermediate();
+  auto* masked_scores = builder.MakeIntermediate();
+  auto* probs = builder.MakeIntermediate();
+  auto* context = builder.MakeIntermediate();
+  auto* context_bsnh = builder.MakeIntermediate();
+  auto* output_arg = builder.MakeOutput();
+
+  builder.AddNode("Transpose", {key_heads}, {key_transposed}).AddAttribute("perm", std::vector<int64_t>{0, 1, 3, 2});
+  builder.AddNode("MatMul", {heads[0], key_transposed}, {scores});
+  builder.AddNode("Div", {scores, scale_arg}, {scaled_scores});
+  builder.AddNode("Add", {scaled_scores, mask_arg}, {masked_scores});
+  builder.AddNode("Softmax", {masked_scores}, {probs}).AddAttribute("axis", static_cast<int64_t>(-1));
+  builder.AddNode("MatMul", {probs, value_heads}, {context});
+  builder.AddNode("Transpose", {context}, {context_bsnh}).AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+  builder.AddNode("Reshape", {context_bsnh, hidden_shape_arg}, {output_arg});
+}
+
+TEST_F(GraphTransformationTests, MultiHeadAttentionFusion) {
+  for (bool with_cache : {false, true}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      BuildScaledDotProductAttention(builder, with_cache);
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.MultiHeadAttention"], 1);
+      EXPECT_EQ(op_to_count["Softmax"], 0);
+      EXPECT_EQ(op_to_count["MatMul"], 0);
+      EXPECT_EQ(op_to_count["Transpose"], 0);
+      EXPECT_EQ(op_to_count["Concat"], 0);
+      EXPECT_EQ(op_to_count["Expand"], 1);
+    };
+
+    TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                      1e-5, 1e-5);
+  }
+}
+
+TEST_F(GraphTransformationTests, MultiHeadAttentionFusion_Invalid) {
+  // the mask is broadcast along the query sequence, MultiHeadAttention needs it per query position
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* query_arg = builder.MakeInput<float>({2, 4, 8, 8}, -1.f, 1.f);
+    auto* key_arg = builder.MakeInput<float>({2, 4, 8, 8}, -1.f, 1.f);
+    auto* value_arg = builder.MakeInput<float>({2, 4, 8, 8}, -1.f, 1.f);
+    auto* mask_arg = builder.MakeInput<float>({2, 4, 1, 8}, -1.f, 0.f);
+    auto* hidden_shape_arg = builder.MakeInitializer<int64_t>({3}, {0, 0, 32});
+    auto* key_transposed = builder.MakeIntermediate();
+    auto* scores = builder.MakeIntermediate();
+    auto* masked_scores = builder.MakeIntermediate();
+    auto* probs = builder.MakeIntermediate();
+    auto* context = builder.MakeIntermediate();
+    auto* context_bsnh = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Transpose", {key_arg}, {key_transposed}).AddAttribute("perm", std::vector<int64_t>{0, 1, 3, 2});
+    builder.AddNode("MatMul", {query_arg, key_transposed}, {scores});
+    builder.AddNode("Add", {scores, mask_arg}, {masked_scores});
+    builder.AddNode("Softmax", {masked_scores}, {probs}).AddAttribute("axis", static_cast<int64_t>(-1));
+    builder.AddNode("MatMul", {probs, value_arg}, {context});
+    builder.AddNode("Transpose", {context}, {context_bsnh}).AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    builder.AddNode("Reshape", {context_bsnh, hidden_shape_arg}, {output_arg});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Softmax"] == 1);
+    return Status::OK();
+  };
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["Softmax"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["com.microsoft.MultiHeadAttention"] == 0);
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<MultiHeadAttentionFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, MatMulNBitsQuantization) {
+  // The weight shared by the first two MatMul nodes is quantized once, the MatMul with a computed B is kept.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8, 64}, -1.f, 1.f);
+    auto* other_arg = builder.MakeInput<float>({2, 32, 16}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<float>({64, 32}, -1.f, 1.f);
+    auto* matmul1_out = builder.MakeIntermediate();
+    auto* matmul2_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, weight_arg}, {matmul1_out});
+    builder.AddNode("MatMul", {input_arg, weight_arg}, {matmul2_out});
+    builder.AddNode("Add", {matmul1_out, matmul2_out}, {add_out});
+    builder.AddNode("MatMul", {add_out, other_arg}, {output_arg});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["MatMul"] == 3);
+    return Status::OK();
+  };
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["MatMul"] == 1);
+    TEST_RETURN_IF_NOT(op_count_map["com.microsoft.MatMulNBits"] == 2);
+    std::set<std::string> quantized_weights;
+    for (const Node& node : graph.Nodes()) {
+      if (node.OpType() == "MatMulNBits") {
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("K").i() == 64);
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("N").i() == 32);
+        TEST_RETURN_IF_NOT(node.GetAttributes().at("block_size").i() == 32);
+        quantized_weights.insert(node.InputDefs()[1]->Name());
+      }
+    }
+    TEST_RETURN_IF_NOT(quantized_weights.size() == 1);
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<MatMulNBitsQuantization>(32, 0);
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+// The 4-bit uint8 weight with a zero point per column and the 4-bit int8 weight with a scale per tensor are fused,
+// the uint8 weight with values beyond 4 bits is kept. K is not a multiple of the block size.
+TEST_F(GraphTransformationTests, DQMatMulNBitsFusion) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 4, 40}, -1.f, 1.f);
+    auto* dq1_out = builder.MakeIntermediate();
+    auto* dq2_out = builder.MakeIntermediate();
+    auto* dq3_out = builder.MakeIntermediate();
+    auto* output1_arg = builder.MakeOutput();
+    auto* output2_arg = builder.MakeOutput();
+    auto* output3_arg = builder.MakeOutput();
+
+    builder.AddDequantizeLinearNode<uint8_t>(builder.MakeInitializer<uint8_t>({40, 24}, 0, 15),
+                                             std::vector<float>(24, 0.05f), std::vector<uint8_t>(24, 3),
+                                             dq1_out);
+    builder.AddNode("MatMul", {input_arg, dq1_out}, {output1_arg});
+
+    builder.AddDequantizeLinearNode(builder.MakeInitializer<int8_t>({40, 16}, -8, 7), 0.1f, dq2_out);
+    builder.AddNode("MatMul", {input_arg, dq2_out}, {output2_arg});
+
+    builder.AddDequantizeLinearNode<uint8_t>(builder.MakeInitializer<uint8_t>({40, 16}, 0, 255), 0.01f,
+                                             uint8_t{128}, dq3_out);
+    builder.AddNode("MatMul", {input_arg, dq3_out}, {output3_arg});
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.MatMulNBits"], 2);
+    EXPECT_EQ(op_to_count["DequantizeLinear"], 1);
+    EXPECT_EQ(op_to_count["MatMul"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 13,
+                    1e-5, 1e-5, std::make_unique<DQMatMulNBitsFusion>(32, 0));
+}
+
+#ifdef ORT_USE_NCCL
+TEST_F(GraphTransformationTests, TensorParallelSharding) {
+  // MatMul -> Add -> Gelu -> MatMul is sharded for rank 1 of 2, the AllReduce comes before the second bias.
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 8, 16}, -1.f, 1.f);
+    auto* weight1_arg = builder.MakeInitializer<float>({16, 64}, -1.f, 1.f);
+    auto* bias1_arg = builder.MakeInitializer<float>({64}, -1.f, 1.f);
+    auto* weight2_arg = builder.MakeInitializer<float>({64, 16}, -1.f, 1.f);
+    auto* bias2_arg = builder.MakeInitializer<float>({16}, -1.f, 1.f);
+    auto* matmul1_out = builder.MakeIntermediate();
+    auto* add1_out = builder.MakeIntermediate();
+    auto* gelu_out = builder.MakeIntermediate();
+    auto* matmul2_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, weight1_arg}, {matmul1_out});
+    builder.AddNode("Add", {matmul1_out, bias1_arg}, {add1_out});
+    builder.AddNode("Gelu", {add1_out}, {gelu_out}, kMSDomain);
+    builder.AddNode("MatMul", {gelu_out, weight2_arg}, {matmul2_out});
+    builder.AddNode("Add", {matmul2_out, bias2_arg}, {output_arg});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["MatMul"] == 2);
+    return Status::OK();
+  };
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["MatMul"] == 2);
+    TEST_RETURN_IF_NOT(op_count_map["com.microsoft.AllReduce"] == 1);
+    for (const Node& node : graph.Nodes()) {
+      const auto& inputs = node.InputDefs();
+      if (node.OpType() == "MatMul") {
+        const auto* weight = graph_utils::GetConstantInitializer(graph, inputs[1]->Name());
+        TEST_RETURN_IF_NOT(weight != nullptr && weight->dims_size() == 2);
+        const bool column_parallel = weight->dims(0) == 16;
+        TEST_RETURN_IF_NOT(weight->dims(column_parallel ? 1 : 0) == 32);
+        TEST_RETURN_IF_NOT(column_parallel ||
+                           graph.GetConsumerNodes(node.OutputDefs()[0]->Name())[0]->OpType() == "AllReduce");
+      } else if (node.OpType() == "Add") {
+        // the first bias is sharded, the second one is added once to the sum
+        const auto* bias = graph_utils::GetConstantInitializer(graph, inputs[1]->Name());
+        const bool after_all_reduce = graph.GetProducerNode(inputs[0]->Name())->OpType() == "AllReduce";
+        TEST_RETURN_IF_NOT(bias != nullptr && bias->dims(0) == (after_all_reduce ? 16 : 32));
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<TensorParallelSharding>(2, 1);
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+#endif  // ORT_USE_NCCL
+
+// Reshape(X, Concat(Unsqueeze(Gather(Shape(X), 0)), Unsqueeze(Gather(Shape(X), 1) * 2), [-1])) gets its shape from a
+// single ShapeCompute node. The Gather also consumed by Range gets its own scalar ShapeCompute node.
+TEST_F(GraphTransformationTests, ShapeComputeFusion) {
+  std::string input_name;
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeSymbolicInput<float>({"batch", "seq", 8});
+    input_name = input_arg->Name();
+    auto* shape_out = builder.MakeIntermediate();
+    auto* batch_out = builder.MakeIntermediate();
+    auto* seq_out = builder.MakeIntermediate();
+    auto* seq2_out = builder.MakeIntermediate();
+    auto* batch_1d_out = builder.MakeIntermediate();
+    auto* seq2_1d_out = builder.MakeIntermediate();
+    auto* concat_out = builder.MakeIntermediate();
+    auto* reshape_out = builder.MakeOutput();
+    auto* range_out = builder.MakeOutput();
+    auto* axes = builder.MakeInitializer<int64_t>({1}, {0});
+
+    builder.AddNode("Shape", {input_arg}, {shape_out});
+    builder.AddNode("Gather", {shape_out, builder.MakeScalarInitializer<int64_t>(0)}, {batch_out});
+    builder.AddNode("Gather", {shape_out, builder.MakeScalarInitializer<int64_t>(1)}, {seq_out});
+    builder.AddNode("Mul", {seq_out, builder.MakeScalarInitializer<int64_t>(2)}, {seq2_out});
+    builder.AddNode("Unsqueeze", {batch_out, axes}, {batch_1d_out});
+    builder.AddNode("Unsqueeze", {seq2_out, axes}, {seq2_1d_out});
+    builder.AddNode("Concat", {batch_1d_out, seq2_1d_out, builder.MakeInitializer<int64_t>({1}, {-1})},
+                    {concat_out})
+        .AddAttribute("axis", static_cast<int64_t>(0));
+    builder.AddNode("Reshape", {input_arg, concat_out}, {reshape_out});
+    builder.AddNode("Range", {builder.MakeScalarInitializer<int64_t>(0), seq_out,
+                              builder.MakeScalarInitializer<int64_t>(1)},
+                    {range_out});
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 2);
+    return Status::OK();
+  };
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["com.microsoft.ShapeCompute"] == 2);
+    TEST_RETURN_IF_NOT(op_count_map["Shape"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Gather"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Mul"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Unsqueeze"] == 0);
+    TEST_RETURN_IF_NOT(op_count_map["Concat"] == 0);
+    for (const Node& node : graph.Nodes()) {
+      if (node.OpType() == "ShapeCompute") {
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 1 && node.InputDefs()[0]->Name() == input_name);
+      }
+    }
+    return Status::OK();
+  };
+
+  std::unique_ptr<GraphTransformer> transformer = std::make_unique<ShapeComputeFusion>();
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                        TransformerLevel::Level3, 1, pre_graph_checker, post_graph_checker));
+}
+#endif  // DISABLE_CONTRIB_OPS
+
+TEST_F(GraphTransformationTests, InferenceRecompute) {
+  // The expanded mask is used at the start and at the end of a chain of nodes, the copy is only made when the
+  // consumers are far apart.
+  for (int chain_length : {2, 20}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({2, 4, 8, 8}, -1.f, 1.f);
+      auto* mask_arg = builder.MakeInput<float>({2, 1, 1, 8}, -1.f, 0.f);
+      auto* shape_arg = builder.MakeInitializer<int64_t>({4}, {2, 4, 8, 8});
+      auto* expanded_mask_arg = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+
+      builder.AddNode("Expand", {mask_arg, shape_arg}, {expanded_mask_arg});
+      NodeArg* chain_arg = builder.MakeIntermediate();
+      builder.AddNode("Add", {input_arg, expanded_mask_arg}, {chain_arg});
+      for (int i = 0; i < chain_length; ++i) {
+        auto* relu_out = builder.MakeIntermediate();
+        builder.AddNode("Relu", {chain_arg}, {relu_out});
+        chain_arg = relu_out;
+      }
+      builder.AddNode("Add", {chain_arg, expanded_mask_arg}, {output_arg});
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Expand"] == 1);
+      return Status::OK();
+    };
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_count_map = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_count_map["Expand"] == (chain_length == 2 ? 1 : 2));
+      TEST_RETURN_IF_NOT(op_count_map["Add"] == 2);
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<InferenceRecompute>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                          TransformerLevel::Level3, 1, pre_graph_checker, post_graph_checker));
+  }
+}
+
 TEST_F(GraphTransformationTests, ShapeInputMerge) {
   auto build_test_case = [&](ModelTestBuilder& builder) {
     std::vector<std::variant<int64_t, std::string>> input_shape;
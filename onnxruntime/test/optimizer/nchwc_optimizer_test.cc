@@ -6,6 +6,7 @@
 #include "core/mlas/inc/mlas.h"
 #include "core/session/environment.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/compare_ortvalue.h"
 #include "test/test_environment.h"
 #include "test/framework/test_utils.h"
@@ -167,7 +168,8 @@ struct NchwcTestHelper {
 
 void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& build_test_case,
                           const std::function<void(InferenceSessionWrapper& session)>& check_nchwc_graph,
-                          int opset_version = 13) {
+                          int opset_version = 13,
+                          bool use_layout_cost_model = false) {
   // Ignore the test if NCHWc is not supported by the platform.
   if (MlasNchwcGetBlockSize() <= 1) {
     return;
@@ -190,6 +192,9 @@ void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& bu
     SessionOptions session_options;
     session_options.graph_optimization_level = level;
     session_options.session_logid = "NchwcOptimizerTests";
+    if (use_layout_cost_model) {
+      ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(kOrtSessionOptionsNchwcLayoutCostModel, "1"));
+    }
     InferenceSessionWrapper session{session_options, GetEnvironment()};
     ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
     ASSERT_STATUS_OK(session.Initialize());
@@ -1375,6 +1380,36 @@ TEST(NchwcOptimizerTests, Activation) {
   }
 }
 
+TEST(NchwcOptimizerTests, LayoutCostModel) {
+  // A small pointwise convolution between two nodes without NCHWc implementation does not save the time of
+  // reordering its input and output, while a large convolution does.
+  auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape,
+                       int expected_nchwc_convs) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>(input_shape);
+      auto* softmax_output_arg = helper.MakeIntermediate();
+      auto* conv_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      helper.AddNode("Softmax", {input_arg}, {softmax_output_arg});
+      helper.AddConvNode(softmax_output_arg, conv_output_arg, weights_shape);
+      helper.AddNode("Softmax", {conv_output_arg}, {output_arg});
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], expected_nchwc_convs);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], expected_nchwc_convs);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], expected_nchwc_convs);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, 13, true);
+  };
+
+  test_case({1, 16, 4, 4}, {16, 16, 1, 1}, 0);
+  test_case({4, 64, 28, 28}, {64, 64, 3, 3}, 1);
+}
+
 TEST(NchwcOptimizerTests, MaxPoolTypeCheck) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto add_pool_node = [&](NchwcTestHelper& helper, NodeArg* input_arg) {
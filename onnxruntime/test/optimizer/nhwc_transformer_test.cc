@@ -8,6 +8,8 @@
 #include "graph_transform_test_builder.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/graph/graph.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/util/include/asserts.h"
 
 namespace onnxruntime {
 namespace test {
@@ -516,6 +518,144 @@ TEST(NhwcTransformerTests, ConvMixTensorRanks) {
                     TransformerLevel::Level3);
 }
 
+static void AddNhwcFp32SessionOptions(SessionOptions& so) {
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCpuNhwcFp32, "1"));
+}
+
+TEST(NhwcTransformerTests, ConvMaxPoolFp32) {
+  auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>(input_shape, -1.5f, 1.5f);
+      auto* conv_output_arg = builder.MakeIntermediate();
+      auto* relu_output_arg = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+      auto* conv_weight_arg = builder.MakeInitializer<float>(weights_shape, -1.5f, 1.5f);
+      auto* conv_bias_arg = builder.MakeInitializer<float>({weights_shape[0]}, -1.5f, 1.5f);
+
+      Node& conv_node = builder.AddNode("Conv", {input_arg, conv_weight_arg, conv_bias_arg}, {conv_output_arg});
+      conv_node.AddAttribute("pads", std::vector<int64_t>((weights_shape.size() - 2) * 2, 1));
+      builder.AddNode("Relu", {conv_output_arg}, {relu_output_arg});
+      Node& pool_node = builder.AddNode("MaxPool", {relu_output_arg}, {output_arg});
+      std::vector<int64_t> pads((weights_shape.size() - 2) * 2, 1);
+      pool_node.AddAttribute("pads", pads);
+      std::vector<int64_t> kernel_shape(weights_shape.size() - 2, 3);
+      pool_node.AddAttribute("kernel_shape", kernel_shape);
+    };
+
+    auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 1);
+      EXPECT_EQ(op_to_count["com.ms.internal.nhwc.MaxPool"], 1);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    TransformerTester(build_test_case,
+                      check_nhwc_graph,
+                      TransformerLevel::Level2,
+                      TransformerLevel::Level3,
+                      12 /*opset_version*/,
+                      1e-4 /*per_sample_tolerance*/,
+                      1e-4 /*relative_per_sample_tolerance*/,
+                      nullptr, AddNhwcFp32SessionOptions);
+  };
+
+  test_case({5, 12, 37}, {32, 12, 5});
+  test_case({3, 14, 13, 13}, {20, 14, 3, 3});
+  test_case({1, 15, 11, 13, 15}, {31, 15, 5, 3, 3});
+}
+
+TEST(NhwcTransformerTests, ConvDepthwiseAveragePoolFp32) {
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 23, 13, 13}, -1.5f, 1.5f);
+    auto* conv1_output_arg = builder.MakeIntermediate();
+    auto* conv2_output_arg = builder.MakeIntermediate();
+    auto* conv3_output_arg = builder.MakeIntermediate();
+    auto* avgpool_output_arg = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+    auto* conv1_weight_arg = builder.MakeInitializer<float>({30, 23, 3, 3}, -1.5f, 1.5f);
+    auto* conv2_weight_arg = builder.MakeInitializer<float>({30, 1, 3, 3}, -1.5f, 1.5f);
+    auto* conv3_weight_arg = builder.MakeInitializer<float>({16, 15, 1, 1}, -1.5f, 1.5f);
+
+    Node& conv1_node = builder.AddConvNode(input_arg, conv1_weight_arg, conv1_output_arg);
+    conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    Node& conv2_node = builder.AddConvNode(conv1_output_arg, conv2_weight_arg, conv2_output_arg);
+    conv2_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    conv2_node.AddAttribute("strides", std::vector<int64_t>{2, 2});
+    conv2_node.AddAttribute("group", static_cast<int64_t>(30));
+    Node& conv3_node = builder.AddConvNode(conv2_output_arg, conv3_weight_arg, conv3_output_arg);
+    conv3_node.AddAttribute("group", static_cast<int64_t>(2));
+    Node& avgpool_node = builder.AddNode("AveragePool", {conv3_output_arg}, {avgpool_output_arg});
+    avgpool_node.AddAttribute("kernel_shape", std::vector<int64_t>{3, 3});
+    avgpool_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+    builder.AddNode("GlobalAveragePool", {avgpool_output_arg}, {output_arg});
+  };
+
+  auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], 3);
+    EXPECT_EQ(op_to_count["com.ms.internal.nhwc.AveragePool"], 1);
+    EXPECT_EQ(op_to_count["com.ms.internal.nhwc.GlobalAveragePool"], 1);
+    EXPECT_EQ(op_to_count["Transpose"], 2);
+  };
+
+  TransformerTester(build_test_case,
+                    check_nhwc_graph,
+                    TransformerLevel::Level2,
+                    TransformerLevel::Level3,
+                    12 /*opset_version*/,
+                    1e-4 /*per_sample_tolerance*/,
+                    1e-4 /*relative_per_sample_tolerance*/,
+                    nullptr, AddNhwcFp32SessionOptions);
+}
+
+TEST(NhwcTransformerTests, ConvDepthwisePointwiseFp32) {
+  auto test_case = [&](int64_t channels, int64_t stride, bool add_residual) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({2, channels, 17, 15}, -1.5f, 1.5f);
+      auto* dw_output_arg = builder.MakeIntermediate();
+      auto* relu_output_arg = builder.MakeIntermediate();
+      auto* pw_output_arg = builder.MakeIntermediate();
+      auto* output_arg = builder.MakeOutput();
+      auto* dw_weight_arg = builder.MakeInitializer<float>({channels, 1, 3, 3}, -1.5f, 1.5f);
+      auto* dw_bias_arg = builder.MakeInitializer<float>({channels}, -1.5f, 1.5f);
+      auto* pw_weight_arg = builder.MakeInitializer<float>({channels, channels, 1, 1}, -1.5f, 1.5f);
+
+      Node& dw_node = builder.AddNode("Conv", {input_arg, dw_weight_arg, dw_bias_arg}, {dw_output_arg});
+      dw_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      dw_node.AddAttribute("strides", std::vector<int64_t>{stride, stride});
+      dw_node.AddAttribute("group", channels);
+      builder.AddNode("Relu", {dw_output_arg}, {relu_output_arg});
+      builder.AddConvNode(relu_output_arg, pw_weight_arg, pw_output_arg);
+      if (add_residual) {
+        builder.AddNode("Add", {pw_output_arg, relu_output_arg}, {output_arg});
+      } else {
+        builder.AddNode("Relu", {pw_output_arg}, {output_arg});
+      }
+    };
+
+    auto check_nhwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      // The residual Add consumes the depthwise output too, which prevents the fusion.
+      EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedDepthwisePointwiseConv"], add_residual ? 0 : 1);
+      EXPECT_EQ(op_to_count["com.microsoft.NhwcFusedConv"], add_residual ? 2 : 0);
+      EXPECT_EQ(op_to_count["Transpose"], 2);
+    };
+
+    TransformerTester(build_test_case,
+                      check_nhwc_graph,
+                      TransformerLevel::Level2,
+                      TransformerLevel::Level3,
+                      12 /*opset_version*/,
+                      1e-4 /*per_sample_tolerance*/,
+                      1e-4 /*relative_per_sample_tolerance*/,
+                      nullptr, AddNhwcFp32SessionOptions);
+  };
+
+  test_case(32, 1, false);
+  test_case(67, 2, false);
+  test_case(16, 1, true);
+}
+
 #ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
 
 static std::vector<MLFloat16> ARangeOfFP16Values(const std::vector<int64_t>& shape, MLFloat16 min, MLFloat16 max) {
@@ -37,6 +37,14 @@ namespace perftest {
       "\t-A: Disable memory arena\n"
       "\t-I: Generate tensor input binding (Free dimensions are treated as 1.)\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
+      "\t-Q [target_qps]: Issue requests open loop with Poisson arrivals at the given rate per second, run by -c threads.\n"
+      "\t\tThe latency of a request is measured from its arrival, so it includes the time queued for a thread.\n"
+      "\t-N [num_sessions]: Specifies the number of sessions to create and distribute the runs over. Default:1.\n"
+      "\t-W [warmup_times]: Specifies the number of runs per session before measuring. Default:1.\n"
+      "\t-G [prompt_length:generation_length]: Benchmarks the token generation of a decoder model with past key/values.\n"
+      "\t\tEach request runs the prompt, then generates the tokens one at a time. Reports the time to first token, the inter-token\n"
+      "\t\tlatency, the tokens per second and the peak size of the key/value cache. -c sets the number of concurrent sequences.\n"
+      "\t-j [json_result_file]: Writes the latency histogram, percentiles and throughput per second as JSON to the file.\n"
       "\t-e [cpu|cuda|dnnl|tensorrt|openvino|dml|acl|nnapi|coreml|qnn|snpe|rocm|migraphx|xnnpack|vitisai]: Specifies the provider 'cpu','cuda','dnnl','tensorrt', "
       "'openvino', 'dml', 'acl', 'nnapi', 'coreml', 'qnn', 'snpe', 'rocm', 'migraphx', 'xnnpack' or 'vitisai'. "
       "Default:'cpu'.\n"
@@ -116,6 +124,9 @@ namespace perftest {
       "\t    [TensorRT only] [trt_weight_stripped_engine_enable]: Enable weight-stripped engine build.\n"
       "\t    [TensorRT only] [trt_onnx_model_folder_path]: Folder path for the ONNX model with weights.\n"
       "\t    [TensorRT only] [trt_force_sequential_engine_build]: Force TensorRT engines to be built sequentially.\n"
+      "\t    [TensorRT only] [trt_async_engine_build_enable]: Build engines for new input shapes in the background and run the subgraph on the CUDA EP meanwhile.\n"
+      "\t    [TensorRT only] [trt_engine_cache_store_lib_path]: Library of the store sharing engine and timing caches across processes and hosts.\n"
+      "\t    [TensorRT only] [trt_profile_observation_runs]: Number of runs whose input shapes the optimization profiles are derived from when no profile is specified.\n"
       "\t    [TensorRT only] [trt_context_memory_sharing_enable]: Enable TensorRT context memory sharing between subgraphs.\n"
       "\t    [TensorRT only] [trt_layer_norm_fp32_fallback]: Force Pow + Reduce ops in layer norm to run in FP32 to avoid overflow.\n"
       "\t    [Example] [For TensorRT EP] -e tensorrt -i 'trt_fp16_enable|true trt_int8_enable|true trt_int8_calibration_table_name|calibration.flatbuffers trt_int8_use_native_calibration_table|false trt_force_sequential_engine_build|false'\n"
@@ -205,7 +216,7 @@ static bool ParseSessionConfigs(const std::string& configs_string,
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqzn"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:Q:N:W:G:j:AMPIDZvhsqzn"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -327,6 +338,54 @@ static bool ParseSessionConfigs(const std::string& configs_string,
           return false;
         }
         break;
+      case 'Q':
+        ORT_TRY {
+          test_config.run_config.target_qps = std::stod(ToUTF8String(optarg));
+        }
+        ORT_CATCH(...) {
+          return false;
+        }
+        if (!(test_config.run_config.target_qps > 0)) {
+          return false;
+        }
+        break;
+      case 'N':
+        test_config.run_config.num_sessions = static_cast<size_t>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
+        if (test_config.run_config.num_sessions <= 0) {
+          return false;
+        }
+        break;
+      case 'W': {
+        const auto warmup_times = OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (warmup_times < 0) {
+          return false;
+        }
+        test_config.run_config.warmup_times = static_cast<size_t>(warmup_times);
+        break;
+      }
+      case 'G': {
+        const std::string lengths = ToUTF8String(optarg);
+        const size_t delimiter_location = lengths.find(':');
+        if (delimiter_location == std::string::npos) {
+          return false;
+        }
+        ORT_TRY {
+          const long long prompt_length = std::stoll(lengths.substr(0, delimiter_location));
+          const long long generation_length = std::stoll(lengths.substr(delimiter_location + 1));
+          if (prompt_length <= 0 || generation_length <= 0) {
+            return false;
+          }
+          test_config.run_config.generation_prompt_length = static_cast<size_t>(prompt_length);
+          test_config.run_config.generation_length = static_cast<size_t>(generation_length);
+        }
+        ORT_CATCH(...) {
+          return false;
+        }
+        break;
+      }
+      case 'j':
+        test_config.model_info.json_result_file_path = optarg;
+        break;
       case 'o': {
         int tmp = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
         switch (tmp) {
@@ -0,0 +1,465 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "generation_runner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <type_traits>
+
+#include "TestCase.h"
+#include "utils.h"
+#include "ort_test_session.h"
+#include "performance_runner.h"
+
+namespace onnxruntime {
+namespace perftest {
+
+namespace {
+
+size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+bool IsIdType(ONNXTensorElementDataType type) {
+  return type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64 || type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32;
+}
+
+// Creates a [1, count] int64 or int32 tensor holding first, first + step, ..., or `values` if not empty.
+Ort::Value CreateIdsTensor(ONNXTensorElementDataType type, int64_t count, int64_t first, int64_t step,
+                           const std::vector<int64_t>& values = {}) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  const int64_t shape[] = {1, count};
+  Ort::Value tensor = Ort::Value::CreateTensor(allocator, shape, 2, type);
+  for (int64_t i = 0; i < count; ++i) {
+    const int64_t value = values.empty() ? first + i * step : values[static_cast<size_t>(i)];
+    if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64) {
+      tensor.GetTensorMutableData<int64_t>()[i] = value;
+    } else {
+      tensor.GetTensorMutableData<int32_t>()[i] = static_cast<int32_t>(value);
+    }
+  }
+  return tensor;
+}
+
+// Returns the index of the highest of the last `vocab_size` logits, i.e. the greedy next token of the last position.
+template <typename T>
+int64_t ArgMaxOfLastRow(const Ort::Value& logits, size_t count, size_t vocab_size) {
+  const T* row = logits.GetTensorData<T>() + count - vocab_size;
+  int64_t best = 0;
+  float best_value = 0.0f;
+  for (size_t i = 0; i < vocab_size; ++i) {
+    float value;
+    if constexpr (std::is_same<T, float>::value) {
+      value = row[i];
+    } else {
+      value = row[i].ToFloat();
+    }
+    if (i == 0 || value > best_value) {
+      best = static_cast<int64_t>(i);
+      best_value = value;
+    }
+  }
+  return best;
+}
+
+int64_t NextToken(const Ort::Value& logits) {
+  const auto type_and_shape = logits.GetTensorTypeAndShapeInfo();
+  const auto shape = type_and_shape.GetShape();
+  const size_t count = type_and_shape.GetElementCount();
+  const size_t vocab_size = shape.empty() ? 0 : static_cast<size_t>(shape.back());
+  if (vocab_size == 0 || count < vocab_size) {
+    return 0;
+  }
+
+  switch (type_and_shape.GetElementType()) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      return ArgMaxOfLastRow<float>(logits, count, vocab_size);
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+      return ArgMaxOfLastRow<Ort::Float16_t>(logits, count, vocab_size);
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return ArgMaxOfLastRow<Ort::BFloat16_t>(logits, count, vocab_size);
+    default:
+      ORT_THROW("Unsupported logits data type: ", type_and_shape.GetElementType());
+  }
+}
+
+}  // namespace
+
+void GenerationResult::Dump(std::ostream& ostream) const {
+  auto to_ms = [](std::chrono::nanoseconds value) {
+    return std::chrono::duration<double, std::milli>(value).count();
+  };
+  auto output_latency = [&](const char* name, const LatencyHistogram& histogram) {
+    ostream << name << " (mean/P50/P90/P99/max): " << to_ms(histogram.Mean()) << " / "
+            << to_ms(histogram.ValueAtPercentile(50)) << " / " << to_ms(histogram.ValueAtPercentile(90)) << " / "
+            << to_ms(histogram.ValueAtPercentile(99)) << " / " << to_ms(histogram.Max()) << " ms\n";
+  };
+  const std::chrono::duration<double> run_time = end - start;
+
+  ostream << "Generated sequences: " << sequence_latency.Count() << "\n"
+          << "Generated tokens: " << generated_tokens << "\n"
+          << "Total generation run time: " << run_time.count() << " s\n"
+          << "Tokens per second: " << generated_tokens / run_time.count() << "\n";
+  output_latency("Time to first token", time_to_first_token);
+  output_latency("Inter-token latency", inter_token_latency);
+  output_latency("Sequence latency", sequence_latency);
+  ostream << "Peak KV cache size: " << peak_kv_cache_bytes << " bytes\n"
+          << "Peak working set size: " << peak_workingset_size << " bytes" << std::endl;
+}
+
+void GenerationResult::DumpToJson(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const {
+  std::ofstream outfile(path, std::ofstream::out);
+  if (!outfile.good()) {
+    std::cerr << "failed to open JSON result file '" << ToUTF8String(path.c_str()) << "'.\n";
+    return;
+  }
+
+  auto to_ms = [](std::chrono::nanoseconds value) {
+    return std::chrono::duration<double, std::milli>(value).count();
+  };
+  // the latency percentiles, then the highest latency of each non-empty bucket and the number of values in it
+  auto output_latency = [&](const char* name, const LatencyHistogram& histogram) {
+    outfile << "  \"" << name << "\": {"
+            << "\"count\": " << histogram.Count()
+            << ", \"min\": " << to_ms(histogram.Min())
+            << ", \"mean\": " << to_ms(histogram.Mean())
+            << ", \"p50\": " << to_ms(histogram.ValueAtPercentile(50))
+            << ", \"p90\": " << to_ms(histogram.ValueAtPercentile(90))
+            << ", \"p95\": " << to_ms(histogram.ValueAtPercentile(95))
+            << ", \"p99\": " << to_ms(histogram.ValueAtPercentile(99))
+            << ", \"p999\": " << to_ms(histogram.ValueAtPercentile(99.9))
+            << ", \"max\": " << to_ms(histogram.Max())
+            << ", \"histogram\": [";
+    const auto buckets = histogram.NonEmptyBuckets();
+    for (size_t i = 0; i < buckets.size(); ++i) {
+      outfile << (i == 0 ? "" : ", ") << "{\"latency_ms\": " << to_ms(buckets[i].highest_value)
+              << ", \"count\": " << buckets[i].count << "}";
+    }
+    outfile << "]},\n";
+  };
+  std::string escaped_model_name;
+  for (char c : model_name) {
+    if (c == '"' || c == '\\') {
+      escaped_model_name += '\\';
+    }
+    escaped_model_name += c;
+  }
+  const std::chrono::duration<double> run_time = end - start;
+
+  outfile << "{\n"
+          << "  \"model_name\": \"" << escaped_model_name << "\",\n"
+          << "  \"prompt_length\": " << run_config.generation_prompt_length << ",\n"
+          << "  \"generation_length\": " << run_config.generation_length << ",\n"
+          << "  \"num_sessions\": " << run_config.num_sessions << ",\n"
+          << "  \"concurrent_session_runs\": " << run_config.concurrent_session_runs << ",\n"
+          << "  \"sequences\": " << sequence_latency.Count() << ",\n"
+          << "  \"generated_tokens\": " << generated_tokens << ",\n"
+          << "  \"run_time_s\": " << run_time.count() << ",\n"
+          << "  \"tokens_per_second\": " << generated_tokens / run_time.count() << ",\n";
+  output_latency("time_to_first_token_ms", time_to_first_token);
+  output_latency("inter_token_latency_ms", inter_token_latency);
+  output_latency("sequence_latency_ms", sequence_latency);
+  outfile << "  \"peak_kv_cache_bytes\": " << peak_kv_cache_bytes << ",\n"
+          << "  \"peak_workingset_size\": " << peak_workingset_size << "\n"
+          << "}" << std::endl;
+}
+
+GenerationRunner::GenerationRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
+    : performance_test_config_(test_config),
+      test_model_info_(CreateModelInfo(test_config)),
+      seed_engine_(test_config.run_config.random_seed_for_input_data >= 0
+                       ? static_cast<std::mt19937::result_type>(test_config.run_config.random_seed_for_input_data)
+                       : rd()) {
+  const auto session_create_start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i != performance_test_config_.run_config.num_sessions; ++i) {
+    sessions_.push_back(
+        std::make_unique<OnnxRuntimeTestSession>(env, rd, performance_test_config_, *test_model_info_));
+  }
+  const std::chrono::duration<double> session_create_duration =
+      std::chrono::high_resolution_clock::now() - session_create_start;
+  std::cout << "Session creation time cost: " << session_create_duration.count() << " s\n";
+}
+
+GenerationRunner::~GenerationRunner() = default;
+
+Status GenerationRunner::Initialize() {
+  Ort::Session& session = sessions_[0]->GetSession();
+  Ort::AllocatorWithDefaultOptions allocator;
+  generation_result_.model_name = ToUTF8String(performance_test_config_.model_info.model_file_path);
+
+  std::vector<size_t> output_indices_by_position;
+  const size_t output_count = session.GetOutputCount();
+  bool has_logits = false;
+  for (size_t i = 0; i != output_count; ++i) {
+    output_names_.push_back(session.GetOutputNameAllocated(i, allocator).get());
+    if (output_names_[i] == "logits") {
+      logits_index_ = i;
+      has_logits = true;
+      const auto shape = session.GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape();
+      vocab_size_ = !shape.empty() && shape.back() > 0 ? shape.back() : 1;
+    } else if (output_names_[i].rfind("present", 0) == 0) {
+      output_indices_by_position.push_back(i);
+    }
+  }
+  ORT_RETURN_IF_NOT(has_logits, "The decoder model has no 'logits' output.");
+
+  bool has_input_ids = false;
+  const size_t input_count = session.GetInputCount();
+  for (size_t i = 0; i != input_count; ++i) {
+    input_names_.push_back(session.GetInputNameAllocated(i, allocator).get());
+    const auto& name = input_names_[i];
+    const auto type_info = session.GetInputTypeInfo(i);
+    ORT_RETURN_IF_NOT(type_info.GetONNXType() == ONNX_TYPE_TENSOR, "Input ", name, " is not a tensor.");
+    const auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
+    const auto element_type = tensor_info.GetElementType();
+
+    if (name == "input_ids") {
+      ORT_RETURN_IF_NOT(IsIdType(element_type), "input_ids must be int64 or int32.");
+      input_ids_index_ = i;
+      input_ids_type_ = element_type;
+      has_input_ids = true;
+    } else if (name == "attention_mask") {
+      ORT_RETURN_IF_NOT(IsIdType(element_type), "attention_mask must be int64 or int32.");
+      attention_mask_index_ = static_cast<int64_t>(i);
+      attention_mask_type_ = element_type;
+    } else if (name == "position_ids") {
+      ORT_RETURN_IF_NOT(IsIdType(element_type), "position_ids must be int64 or int32.");
+      position_ids_index_ = static_cast<int64_t>(i);
+      position_ids_type_ = element_type;
+    } else if (name == "use_cache_branch") {
+      ORT_RETURN_IF_NOT(element_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL, "use_cache_branch must be bool.");
+      use_cache_branch_index_ = static_cast<int64_t>(i);
+    } else if (name.rfind("past", 0) == 0) {
+      KVCacheInput kv_cache_input{i, 0, element_type, tensor_info.GetShape(), 0};
+      ORT_RETURN_IF_NOT(ElementSize(element_type) != 0, "Unsupported data type of ", name, ": ", element_type);
+      ORT_RETURN_IF_NOT(kv_cache_input.shape.size() >= 2, name, " must have a batch and a sequence dimension.");
+      kv_cache_input.shape[0] = 1;
+      for (size_t axis = 1; axis < kv_cache_input.shape.size(); ++axis) {
+        if (kv_cache_input.shape[axis] < 0) {
+          ORT_RETURN_IF_NOT(kv_cache_input.sequence_axis == 0, name,
+                            " has several free dimensions besides the batch, the past sequence one is ambiguous.");
+          kv_cache_input.sequence_axis = axis;
+        }
+      }
+      ORT_RETURN_IF_NOT(kv_cache_input.sequence_axis != 0, name, " has no free past sequence dimension.");
+      kv_cache_inputs_.push_back(std::move(kv_cache_input));
+    } else {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", name,
+                             " of the decoder model is not one of input_ids, attention_mask, position_ids, "
+                             "use_cache_branch or past key/values.");
+    }
+  }
+  ORT_RETURN_IF_NOT(has_input_ids, "The decoder model has no 'input_ids' input.");
+  ORT_RETURN_IF_NOT(kv_cache_inputs_.size() == output_indices_by_position.size(), "The decoder model has ",
+                    kv_cache_inputs_.size(), " past inputs but ", output_indices_by_position.size(),
+                    " present outputs.");
+  for (size_t i = 0; i < kv_cache_inputs_.size(); ++i) {
+    kv_cache_inputs_[i].present_output_index = output_indices_by_position[i];
+  }
+
+  for (const auto& name : input_names_) {
+    input_names_raw_ptr_.push_back(name.c_str());
+  }
+  for (const auto& name : output_names_) {
+    output_names_raw_ptr_.push_back(name.c_str());
+  }
+  return Status::OK();
+}
+
+void GenerationRunner::UpdateKVCacheBytes(size_t previous, size_t current) {
+  std::lock_guard<OrtMutex> guard(results_mutex_);
+  kv_cache_bytes_ = kv_cache_bytes_ - previous + current;
+  generation_result_.peak_kv_cache_bytes = std::max(generation_result_.peak_kv_cache_bytes, kv_cache_bytes_);
+}
+
+template <bool isWarmup>
+Status GenerationRunner::GenerateSequence(Ort::Session& session, std::mt19937& engine) {
+  const auto& run_config = performance_test_config_.run_config;
+  const int64_t prompt_length = static_cast<int64_t>(run_config.generation_prompt_length);
+  const int64_t generation_length = static_cast<int64_t>(run_config.generation_length);
+
+  std::vector<Ort::Value> inputs;
+  for (size_t i = 0; i < input_names_.size(); ++i) {
+    inputs.emplace_back(nullptr);
+  }
+  Ort::AllocatorWithDefaultOptions allocator;
+  size_t past_bytes = 0;
+  for (const auto& kv_cache_input : kv_cache_inputs_) {
+    // an empty past for the prompt
+    auto shape = kv_cache_input.shape;
+    shape[kv_cache_input.sequence_axis] = 0;
+    inputs[kv_cache_input.input_index] =
+        Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), kv_cache_input.element_type);
+  }
+
+  std::uniform_int_distribution<int64_t> token_dist(0, vocab_size_ - 1);
+  std::vector<int64_t> prompt(static_cast<size_t>(prompt_length));
+  for (auto& token : prompt) {
+    token = token_dist(engine);
+  }
+
+  std::vector<std::chrono::nanoseconds> token_latencies;
+  const auto start = std::chrono::high_resolution_clock::now();
+  auto previous = start;
+  int64_t token = 0;
+  auto status = Status::OK();
+  ORT_TRY {
+    for (int64_t step = 0; step < generation_length; ++step) {
+      const int64_t past_length = step == 0 ? 0 : prompt_length + step - 1;
+      const int64_t sequence_length = step == 0 ? prompt_length : 1;
+      inputs[input_ids_index_] = step == 0 ? CreateIdsTensor(input_ids_type_, prompt_length, 0, 0, prompt)
+                                           : CreateIdsTensor(input_ids_type_, 1, token, 0);
+      if (attention_mask_index_ >= 0) {
+        inputs[static_cast<size_t>(attention_mask_index_)] =
+            CreateIdsTensor(attention_mask_type_, past_length + sequence_length, 1, 0);
+      }
+      if (position_ids_index_ >= 0) {
+        inputs[static_cast<size_t>(position_ids_index_)] =
+            CreateIdsTensor(position_ids_type_, sequence_length, past_length, 1);
+      }
+      if (use_cache_branch_index_ >= 0) {
+        const int64_t shape[] = {1};
+        auto& use_cache_branch = inputs[static_cast<size_t>(use_cache_branch_index_)];
+        use_cache_branch = Ort::Value::CreateTensor(allocator, shape, 1, ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL);
+        *use_cache_branch.GetTensorMutableData<bool>() = step != 0;
+      }
+
+      auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names_raw_ptr_.data(), inputs.data(), inputs.size(),
+                                 output_names_raw_ptr_.data(), output_names_raw_ptr_.size());
+      token = NextToken(outputs[logits_index_]);
+      const auto now = std::chrono::high_resolution_clock::now();
+      token_latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous));
+      previous = now;
+
+      // the past and the present key/values are both held until the present replaces the past
+      size_t present_bytes = 0;
+      for (const auto& kv_cache_input : kv_cache_inputs_) {
+        auto& present = outputs[kv_cache_input.present_output_index];
+        present_bytes += present.GetTensorTypeAndShapeInfo().GetElementCount() *
+                         ElementSize(kv_cache_input.element_type);
+        inputs[kv_cache_input.input_index] = std::move(present);
+      }
+      if (!isWarmup) {
+        UpdateKVCacheBytes(past_bytes, past_bytes + present_bytes);
+        UpdateKVCacheBytes(past_bytes + present_bytes, present_bytes);
+      }
+      past_bytes = present_bytes;
+    }
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "GenerationRunner::GenerateSequence caught exception: ", ex.what());
+    });
+  }
+
+  if (!isWarmup) {
+    UpdateKVCacheBytes(past_bytes, 0);
+  }
+  ORT_RETURN_IF_ERROR(status);
+
+  if (!isWarmup) {
+    std::lock_guard<OrtMutex> guard(results_mutex_);
+    generation_result_.time_to_first_token.Record(token_latencies[0]);
+    for (size_t i = 1; i < token_latencies.size(); ++i) {
+      generation_result_.inter_token_latency.Record(token_latencies[i]);
+    }
+    generation_result_.sequence_latency.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(previous - start));
+    generation_result_.generated_tokens += token_latencies.size();
+    if (run_config.f_verbose) {
+      std::cout << "sequence:" << generation_result_.sequence_latency.Count() << ","
+                << "time_to_first_token:" << std::chrono::duration<double>(token_latencies[0]).count() << ","
+                << "time_cost:" << std::chrono::duration<double>(previous - start).count() << std::endl;
+    }
+  }
+  return Status::OK();
+}
+
+Status GenerationRunner::Run() {
+  const auto& run_config = performance_test_config_.run_config;
+  ORT_RETURN_IF(run_config.target_qps > 0, "Open loop requests (-Q) are not supported in generation mode (-G).");
+  ORT_RETURN_IF_ERROR(Initialize());
+
+  // warm up, generating warmup_times sequences per session
+  std::mt19937 warmup_engine(seed_engine_());
+  for (auto& session : sessions_) {
+    for (size_t ite = 0; ite != run_config.warmup_times; ++ite) {
+      ORT_RETURN_IF_ERROR(GenerateSequence<true>(session->GetSession(), warmup_engine));
+    }
+  }
+
+  // each of the concurrent_session_runs threads generates a sequence after the other, on the sessions round robin,
+  // until repeated_times sequences are started or the duration is over
+  std::atomic<size_t> sequences{0};
+  std::atomic<bool> failed{false};
+  Status first_error;
+  std::vector<std::thread> threads;
+  generation_result_.start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    threads.emplace_back([this, &run_config, &sequences, &failed, &first_error, seed = seed_engine_()]() {
+      std::mt19937 engine(seed);
+      while (!failed) {
+        const size_t sequence = sequences++;
+        const bool done = run_config.test_mode == TestMode::KFixRepeatedTimesMode
+                              ? sequence >= run_config.repeated_times
+                              : std::chrono::high_resolution_clock::now() - generation_result_.start >=
+                                    std::chrono::seconds(run_config.duration_in_seconds);
+        if (done) {
+          break;
+        }
+
+        auto status = GenerateSequence<false>(sessions_[sequence % sessions_.size()]->GetSession(), engine);
+        if (!status.IsOK()) {
+          std::lock_guard<OrtMutex> guard(results_mutex_);
+          if (!failed.exchange(true)) {
+            first_error = status;
+          }
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  generation_result_.end = std::chrono::high_resolution_clock::now();
+  ORT_RETURN_IF_ERROR(first_error);
+
+  generation_result_.peak_workingset_size = utils::GetPeakWorkingSetSize();
+  std::cout << "Prompt length: " << run_config.generation_prompt_length << "\n"
+            << "Generation length: " << run_config.generation_length << "\n";
+  generation_result_.Dump(std::cout);
+  return Status::OK();
+}
+
+void GenerationRunner::SerializeResult() const {
+  if (!performance_test_config_.model_info.json_result_file_path.empty()) {
+    generation_result_.DumpToJson(performance_test_config_.model_info.json_result_file_path,
+                                  performance_test_config_.run_config);
+  }
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+// onnxruntime dependencies
+#include <core/common/common.h>
+#include <core/common/status.h>
+#include <core/platform/ort_mutex.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include "test_configuration.h"
+#include "latency_histogram.h"
+
+class TestModelInfo;
+
+namespace onnxruntime {
+namespace perftest {
+
+class OnnxRuntimeTestSession;
+
+struct GenerationResult {
+  std::chrono::time_point<std::chrono::high_resolution_clock> start;
+  std::chrono::time_point<std::chrono::high_resolution_clock> end;
+  std::string model_name;
+  // Latency from the start of a sequence to its first token, i.e. the prompt (prefill) run.
+  LatencyHistogram time_to_first_token;
+  // Latency between consecutive tokens of a sequence, i.e. the decoding runs.
+  LatencyHistogram inter_token_latency;
+  // Latency from the start of a sequence to its last token.
+  LatencyHistogram sequence_latency;
+  uint64_t generated_tokens{0};
+  // Highest number of bytes held by the past and present key/value tensors of all the concurrent sequences.
+  size_t peak_kv_cache_bytes{0};
+  size_t peak_workingset_size{0};
+
+  void Dump(std::ostream& ostream) const;
+  void DumpToJson(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const;
+};
+
+/*
+Benchmarks the token generation of a decoder model, as a serving stack drives it. Each sequence runs the model once
+on a prompt of generation_prompt_length random tokens, then generation_length - 1 more times on the token greedily
+picked from the logits of the previous run, feeding the present key/value outputs back as the past key/value inputs.
+The model follows the layout of the exported decoders with past state: an input_ids input, optional attention_mask,
+position_ids and use_cache_branch inputs, past key/value inputs whose names start with "past" matched in order to the
+outputs whose names start with "present", and a logits output. The past inputs are [batch, ..., past_sequence, ...]
+with past_sequence the only free dimension besides the batch.
+concurrent_session_runs sequences are generated at a time, over num_sessions sessions.
+*/
+class GenerationRunner {
+ public:
+  GenerationRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd);
+
+  ~GenerationRunner();
+  Status Run();
+
+  inline const GenerationResult& GetResult() const { return generation_result_; }
+
+  void SerializeResult() const;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(GenerationRunner);
+
+ private:
+  struct KVCacheInput {
+    size_t input_index;
+    size_t present_output_index;
+    ONNXTensorElementDataType element_type;
+    std::vector<int64_t> shape;
+    // index of the past sequence dimension in shape
+    size_t sequence_axis;
+  };
+
+  Status Initialize();
+
+  // Generates one sequence on `session`. Records the latencies unless it is a warmup.
+  template <bool isWarmup>
+  Status GenerateSequence(Ort::Session& session, std::mt19937& engine);
+
+  // Sets the number of bytes of key/value tensors held by a sequence from `previous` to `current`.
+  void UpdateKVCacheBytes(size_t previous, size_t current);
+
+  PerformanceTestConfig performance_test_config_;
+  std::unique_ptr<TestModelInfo> test_model_info_;
+  std::vector<std::unique_ptr<OnnxRuntimeTestSession>> sessions_;
+  std::mt19937 seed_engine_;
+
+  std::vector<std::string> input_names_;
+  std::vector<std::string> output_names_;
+  std::vector<const char*> input_names_raw_ptr_;
+  std::vector<const char*> output_names_raw_ptr_;
+  size_t input_ids_index_{0};
+  ONNXTensorElementDataType input_ids_type_{ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64};
+  int64_t attention_mask_index_{-1};
+  ONNXTensorElementDataType attention_mask_type_{ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64};
+  int64_t position_ids_index_{-1};
+  ONNXTensorElementDataType position_ids_type_{ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64};
+  int64_t use_cache_branch_index_{-1};
+  size_t logits_index_{0};
+  int64_t vocab_size_{1};
+  std::vector<KVCacheInput> kv_cache_inputs_;
+
+  GenerationResult generation_result_;
+  size_t kv_cache_bytes_{0};
+  OrtMutex results_mutex_;
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+namespace perftest {
+
+size_t LatencyHistogram::GetBucketIndex(uint64_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<size_t>(value);
+  }
+
+  // shift the value so it falls into the upper half of the sub buckets, [kSubBucketHalfCount, kSubBucketCount)
+  size_t shift = 0;
+  while ((value >> shift) >= kSubBucketCount) {
+    ++shift;
+  }
+  return static_cast<size_t>(shift * kSubBucketHalfCount + (value >> shift));
+}
+
+uint64_t LatencyHistogram::GetHighestValue(size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+
+  const size_t shift = index / kSubBucketHalfCount - 1;
+  const uint64_t lowest_value = (index % kSubBucketHalfCount + kSubBucketHalfCount) << shift;
+  return lowest_value + (uint64_t{1} << shift) - 1;
+}
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  const uint64_t value = static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(latency.count(), 0));
+  const size_t index = GetBucketIndex(value);
+  if (index >= counts_.size()) {
+    counts_.resize(index + 1, 0);
+  }
+
+  ++counts_[index];
+  ++count_;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+  sum_ += static_cast<double>(value);
+}
+
+std::chrono::nanoseconds LatencyHistogram::Mean() const {
+  if (count_ == 0) {
+    return std::chrono::nanoseconds(0);
+  }
+  return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(sum_ / static_cast<double>(count_)));
+}
+
+std::chrono::nanoseconds LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (count_ == 0) {
+    return std::chrono::nanoseconds(0);
+  }
+
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const uint64_t rank = std::max<uint64_t>(
+      static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count_))), 1);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return std::chrono::nanoseconds(std::min(GetHighestValue(i), max_));
+    }
+  }
+  return Max();
+}
+
+std::vector<LatencyHistogram::Bucket> LatencyHistogram::NonEmptyBuckets() const {
+  std::vector<Bucket> buckets;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    if (counts_[i] != 0) {
+      buckets.push_back({std::chrono::nanoseconds(GetHighestValue(i)), counts_[i]});
+    }
+  }
+  return buckets;
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
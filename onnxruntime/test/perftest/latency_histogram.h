@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace onnxruntime {
+namespace perftest {
+
+// Histogram of latencies in nanoseconds with a bounded relative error, in the style of HdrHistogram.
+// Values below 2^kSubBucketBits have a bucket each. Above that every power of two range is split into
+// 2^(kSubBucketBits - 1) buckets of equal width, so a value is off by less than 2^-(kSubBucketBits - 1) (~1.6%)
+// from the bucket it is counted in, regardless of its magnitude.
+class LatencyHistogram {
+ public:
+  void Record(std::chrono::nanoseconds latency);
+
+  uint64_t Count() const { return count_; }
+  std::chrono::nanoseconds Min() const { return std::chrono::nanoseconds(count_ == 0 ? 0 : min_); }
+  std::chrono::nanoseconds Max() const { return std::chrono::nanoseconds(max_); }
+  std::chrono::nanoseconds Mean() const;
+
+  // Returns the highest value of the bucket holding the value at `percentile` (in [0, 100]), clamped to Max().
+  std::chrono::nanoseconds ValueAtPercentile(double percentile) const;
+
+  struct Bucket {
+    std::chrono::nanoseconds highest_value;
+    uint64_t count;
+  };
+
+  // Returns the non-empty buckets in increasing order of value.
+  std::vector<Bucket> NonEmptyBuckets() const;
+
+ private:
+  static constexpr int kSubBucketBits = 7;
+  static constexpr uint64_t kSubBucketCount = uint64_t{1} << kSubBucketBits;
+  static constexpr uint64_t kSubBucketHalfCount = kSubBucketCount / 2;
+
+  static size_t GetBucketIndex(uint64_t value);
+  static uint64_t GetHighestValue(size_t index);
+
+  std::vector<uint64_t> counts_;
+  uint64_t count_{0};
+  uint64_t min_{std::numeric_limits<uint64_t>::max()};
+  uint64_t max_{0};
+  double sum_{0};
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -5,6 +5,7 @@
 #include <core/session/onnxruntime_c_api.h>
 #include <random>
 #include "command_args_parser.h"
+#include "generation_runner.h"
 #include "performance_runner.h"
 #include <google/protobuf/stubs/common.h>
 
@@ -42,6 +43,22 @@ int real_main(int argc, char* argv[]) {
       return -1;
   }
   std::random_device rd;
+  if (test_config.run_config.generation_length > 0) {
+    perftest::GenerationRunner generation_runner(env, test_config, rd);
+    if (test_config.run_config.exit_after_session_creation) {
+      return 0;
+    }
+
+    auto status = generation_runner.Run();
+    if (!status.IsOK()) {
+      printf("Run failed:%s\n", status.ErrorMessage().c_str());
+      return -1;
+    }
+
+    generation_runner.SerializeResult();
+    return 0;
+  }
+
   perftest::PerformanceRunner perf_runner(env, test_config, rd);
 
   // Exit if user enabled -n option so that user can measure session creation time
@@ -31,6 +31,9 @@ class OnnxRuntimeTestSession : public TestSession {
 
   std::chrono::duration<double> Run() override;
 
+  // The session, to run it on inputs other than the test data.
+  Ort::Session& GetSession() { return session_; }
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxRuntimeTestSession);
 
  private:
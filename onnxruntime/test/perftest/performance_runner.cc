@@ -8,6 +8,7 @@
 
 #include "performance_runner.h"
 #include <iostream>
+#include <thread>
 
 #include "TestCase.h"
 #include "utils.h"
@@ -111,6 +112,60 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 }
 
+void PerformanceResult::DumpToJson(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const {
+  std::ofstream outfile(path, std::ofstream::out);
+  if (!outfile.good()) {
+    std::cerr << "failed to open JSON result file '" << ToUTF8String(path.c_str()) << "'.\n";
+    return;
+  }
+
+  auto to_ms = [](std::chrono::nanoseconds value) {
+    return std::chrono::duration<double, std::milli>(value).count();
+  };
+  std::string escaped_model_name;
+  for (char c : model_name) {
+    if (c == '"' || c == '\\') {
+      escaped_model_name += '\\';
+    }
+    escaped_model_name += c;
+  }
+  const std::chrono::duration<double> run_time = end - start;
+
+  outfile << "{\n"
+          << "  \"model_name\": \"" << escaped_model_name << "\",\n"
+          << "  \"target_qps\": " << run_config.target_qps << ",\n"
+          << "  \"num_sessions\": " << run_config.num_sessions << ",\n"
+          << "  \"concurrent_session_runs\": " << run_config.concurrent_session_runs << ",\n"
+          << "  \"requests\": " << latency_histogram.Count() << ",\n"
+          << "  \"run_time_s\": " << run_time.count() << ",\n"
+          << "  \"throughput_qps\": " << latency_histogram.Count() / run_time.count() << ",\n"
+          << "  \"latency_ms\": {"
+          << "\"min\": " << to_ms(latency_histogram.Min())
+          << ", \"mean\": " << to_ms(latency_histogram.Mean())
+          << ", \"p50\": " << to_ms(latency_histogram.ValueAtPercentile(50))
+          << ", \"p90\": " << to_ms(latency_histogram.ValueAtPercentile(90))
+          << ", \"p95\": " << to_ms(latency_histogram.ValueAtPercentile(95))
+          << ", \"p99\": " << to_ms(latency_histogram.ValueAtPercentile(99))
+          << ", \"p999\": " << to_ms(latency_histogram.ValueAtPercentile(99.9))
+          << ", \"max\": " << to_ms(latency_histogram.Max()) << "},\n";
+
+  // the highest latency of each non-empty bucket and the number of requests in it
+  outfile << "  \"histogram\": [";
+  const auto buckets = latency_histogram.NonEmptyBuckets();
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    outfile << (i == 0 ? "" : ", ") << "{\"latency_ms\": " << to_ms(buckets[i].highest_value)
+            << ", \"count\": " << buckets[i].count << "}";
+  }
+  outfile << "],\n";
+
+  outfile << "  \"completions_per_second\": [";
+  for (size_t i = 0; i < completions_per_second.size(); ++i) {
+    outfile << (i == 0 ? "" : ", ") << completions_per_second[i];
+  }
+  outfile << "]\n"
+          << "}" << std::endl;
+}
+
 void PerformanceRunner::LogSessionCreationTime() {
   std::chrono::duration<double> session_create_duration = session_create_end_ - session_create_start_;
   std::cout << "\nSession creation time cost: " << session_create_duration.count() << " s\n";
@@ -121,25 +176,36 @@ Status PerformanceRunner::Run() {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
   }
 
-  // warm up
-  initial_inference_result_.start = std::chrono::high_resolution_clock::now();
-  ORT_RETURN_IF_ERROR(RunOneIteration<true>());
-  initial_inference_result_.end = std::chrono::high_resolution_clock::now();
+  // warm up. the first run of the first session is the first inference.
+  for (size_t i = 0; i != sessions_.size(); ++i) {
+    for (size_t ite = 0; ite != performance_test_config_.run_config.warmup_times; ++ite) {
+      const auto start = std::chrono::high_resolution_clock::now();
+      ORT_RETURN_IF_ERROR(RunOneIteration<true>(*sessions_[i], start));
+      if (i == 0 && ite == 0) {
+        initial_inference_result_.start = start;
+        initial_inference_result_.end = std::chrono::high_resolution_clock::now();
+      }
+    }
+  }
 
   // TODO: start profiling
   // if (!performance_test_config_.run_config.profile_file.empty())
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -165,6 +231,19 @@ Status PerformanceRunner::Run() {
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
 
+  if (performance_test_config_.run_config.target_qps > 0) {
+    const auto& histogram = performance_result_.latency_histogram;
+    auto to_ms = [](std::chrono::nanoseconds value) {
+      return std::chrono::duration<double, std::milli>(value).count();
+    };
+    // unlike the time costs above these include the time a request waited for a thread after its arrival
+    std::cout << "Target inferences per second: " << performance_test_config_.run_config.target_qps << "\n"
+              << "P50 request latency: " << to_ms(histogram.ValueAtPercentile(50)) << " ms\n"
+              << "P99 request latency: " << to_ms(histogram.ValueAtPercentile(99)) << " ms\n"
+              << "P999 request latency: " << to_ms(histogram.ValueAtPercentile(99.9)) << " ms\n"
+              << "Max request latency: " << to_ms(histogram.Max()) << " ms" << std::endl;
+  }
+
   return Status::OK();
 }
 
@@ -255,7 +334,52 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
-static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
+Status PerformanceRunner::RunOpenLoop() {
+  const auto& run_config = performance_test_config_.run_config;
+
+  // requests are queued for a threadpool with one thread per concurrent request, so a request arriving while all
+  // the threads are busy waits for one, as it would in a server.
+  auto tpool = std::make_unique<DefaultThreadPoolType>(run_config.concurrent_session_runs);
+  std::exponential_distribution<double> inter_arrival_seconds(run_config.target_qps);
+  std::atomic<int> counter{0};
+  OrtMutex m;
+  OrtCondVar cv;
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  auto arrival = start;
+  for (size_t requests = 0;; ++requests) {
+    arrival += std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+        std::chrono::duration<double>(inter_arrival_seconds(arrival_engine_)));
+    const bool done = run_config.test_mode == TestMode::KFixRepeatedTimesMode
+                          ? requests >= run_config.repeated_times
+                          : arrival - start >= std::chrono::seconds(run_config.duration_in_seconds);
+    if (done) {
+      break;
+    }
+
+    // the arrivals don't depend on the completion of earlier requests. if this thread falls behind, the late
+    // requests are issued immediately and their latency is still measured from their arrival.
+    std::this_thread::sleep_until(arrival);
+    counter++;
+    tpool->Schedule([this, arrival, &session = NextSession(), &counter, &m, &cv]() {
+      auto status = RunOneIteration<false>(session, arrival);
+      if (!status.IsOK())
+        std::cerr << status.ErrorMessage();
+      // Simplified version of Eigen::Barrier
+      std::lock_guard<OrtMutex> lg(m);
+      counter--;
+      cv.notify_all();
+    });
+  }
+
+  // Join
+  std::unique_lock<OrtMutex> lock(m);
+  cv.wait(lock, [&counter]() { return counter == 0; });
+
+  return Status::OK();
+}
+
+std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   const auto& file_path = performance_test_config_.model_info.model_file_path;
 #if !defined(ORT_MINIMAL_BUILD)
   if (HasExtensionOf(file_path, ORT_TSTR("onnx"))) {
@@ -272,9 +396,13 @@ static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfi
 
 PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd)
     : performance_test_config_(test_config),
-      test_model_info_(CreateModelInfo(test_config)) {
+      test_model_info_(CreateModelInfo(test_config)),
+      arrival_engine_(rd()) {
   session_create_start_ = std::chrono::high_resolution_clock::now();
-  session_ = std::make_unique<OnnxRuntimeTestSession>(env, rd, performance_test_config_, *test_model_info_);
+  for (size_t i = 0; i != performance_test_config_.run_config.num_sessions; ++i) {
+    sessions_.push_back(
+        std::make_unique<OnnxRuntimeTestSession>(env, rd, performance_test_config_, *test_model_info_));
+  }
   session_create_end_ = std::chrono::high_resolution_clock::now();
 }
 
@@ -300,9 +428,13 @@ bool PerformanceRunner::Initialize() {
   test_case_ = CreateOnnxTestCase(narrow_model_name, std::move(test_model_info_), 0.0, 0.0);
 
   if (performance_test_config_.run_config.generate_model_input_binding) {
-    return static_cast<OnnxRuntimeTestSession*>(
-               session_.get())
-        ->PopulateGeneratedInputTestData(performance_test_config_.run_config.random_seed_for_input_data);
+    for (auto& session : sessions_) {
+      if (!static_cast<OnnxRuntimeTestSession*>(session.get())
+               ->PopulateGeneratedInputTestData(performance_test_config_.run_config.random_seed_for_input_data)) {
+        return false;
+      }
+    }
+    return true;
   }
 
   // TODO: Place input tensor on cpu memory if dnnl provider type to avoid CopyTensor logic in CopyInputAcrossDevices
@@ -311,19 +443,22 @@ bool PerformanceRunner::Initialize() {
     std::cout << "there is no test data for model " << test_case_->GetTestCaseName() << std::endl;
     return false;
   }
-  for (size_t test_data_id = 0; test_data_id != test_data_count; ++test_data_id) {
-    std::unordered_map<std::string, Ort::Value> feeds;
-    test_case_->LoadTestData(test_data_id /* id */, b_, feeds, true);
-    // Discard the names in feeds
-    int input_count = test_model_info->GetInputCount();
-    for (int i = 0; i != input_count; ++i) {
-      auto iter = feeds.find(test_model_info->GetInputName(i));
-      if (iter == feeds.end()) {
-        std::cout << "there is no test input data for input " << test_model_info->GetInputName(i) << " and model "
-                  << test_case_->GetTestCaseName() << std::endl;
-        return false;
+  // each session owns its inputs, so the test data is loaded for each of them
+  for (auto& session : sessions_) {
+    for (size_t test_data_id = 0; test_data_id != test_data_count; ++test_data_id) {
+      std::unordered_map<std::string, Ort::Value> feeds;
+      test_case_->LoadTestData(test_data_id /* id */, b_, feeds, true);
+      // Discard the names in feeds
+      int input_count = test_model_info->GetInputCount();
+      for (int i = 0; i != input_count; ++i) {
+        auto iter = feeds.find(test_model_info->GetInputName(i));
+        if (iter == feeds.end()) {
+          std::cout << "there is no test input data for input " << test_model_info->GetInputName(i) << " and model "
+                    << test_case_->GetTestCaseName() << std::endl;
+          return false;
+        }
+        session->PreLoadTestData(test_data_id, static_cast<size_t>(i), std::move(iter->second));
       }
-      session_->PreLoadTestData(test_data_id, static_cast<size_t>(i), std::move(iter->second));
     }
   }
 
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <fstream>
 #include <string>
 #include <vector>
@@ -18,6 +19,7 @@
 #include <core/session/onnxruntime_cxx_api.h>
 #include "test_configuration.h"
 #include "heap_buffer.h"
+#include "latency_histogram.h"
 #include "test_session.h"
 #include "OrtValueList.h"
 
@@ -35,10 +37,18 @@ struct PerformanceResult {
   double total_time_cost{0};
   std::vector<double> time_costs;
   std::string model_name;
+  // Latencies of the requests. In open loop mode they include the time a request waited after its arrival.
+  LatencyHistogram latency_histogram;
+  // Number of requests completed in each second since start.
+  std::vector<size_t> completions_per_second;
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
+  void DumpToJson(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const;
 };
 
+// Loads the inputs and outputs of the .onnx or .ort model of the test.
+std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config);
+
 class PerformanceRunner {
  public:
   PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd);
@@ -53,19 +63,34 @@ class PerformanceRunner {
   inline void SerializeResult() const {
     performance_result_.DumpToFile(performance_test_config_.model_info.result_file_path,
                                    performance_test_config_.run_config.f_dump_statistics);
+    if (!performance_test_config_.model_info.json_result_file_path.empty()) {
+      performance_result_.DumpToJson(performance_test_config_.model_info.json_result_file_path,
+                                     performance_test_config_.run_config);
+    }
   }
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PerformanceRunner);
 
  private:
   bool Initialize();
 
+  // Returns the session to run the next request on, round robin.
+  TestSession& NextSession() {
+    return *sessions_[next_session_++ % sessions_.size()];
+  }
+
   template <bool isWarmup>
   Status RunOneIteration() {
+    return RunOneIteration<isWarmup>(NextSession(), std::chrono::high_resolution_clock::now());
+  }
+
+  // Runs a request which arrived at `arrival` on `session`.
+  template <bool isWarmup>
+  Status RunOneIteration(TestSession& session, std::chrono::high_resolution_clock::time_point arrival) {
     std::chrono::duration<double> duration_seconds(std::chrono::seconds(0));
 
     auto status = Status::OK();
     ORT_TRY {
-      duration_seconds = session_->Run();
+      duration_seconds = session.Run();
     }
     ORT_CATCH(const std::exception& ex) {
       ORT_HANDLE_EXCEPTION([&]() {
@@ -75,9 +100,18 @@ class PerformanceRunner {
     ORT_RETURN_IF_ERROR(status);
 
     if (!isWarmup) {
+      const auto end = std::chrono::high_resolution_clock::now();
       std::lock_guard<OrtMutex> guard(results_mutex_);
       performance_result_.time_costs.emplace_back(duration_seconds.count());
       performance_result_.total_time_cost += duration_seconds.count();
+      performance_result_.latency_histogram.Record(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - arrival));
+      const auto second = static_cast<size_t>(
+          std::chrono::duration_cast<std::chrono::seconds>(end - performance_result_.start).count());
+      if (performance_result_.completions_per_second.size() <= second) {
+        performance_result_.completions_per_second.resize(second + 1, 0);
+      }
+      ++performance_result_.completions_per_second[second];
       if (performance_test_config_.run_config.f_verbose) {
         std::cout << "iteration:" << performance_result_.time_costs.size() << ","
                   << "time_cost:" << performance_result_.time_costs.back() << std::endl;
@@ -90,6 +124,7 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunOpenLoop();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -112,7 +147,9 @@ class PerformanceRunner {
   PerformanceResult performance_result_;
   PerformanceTestConfig performance_test_config_;
   std::unique_ptr<TestModelInfo> test_model_info_;
-  std::unique_ptr<TestSession> session_;
+  std::vector<std::unique_ptr<TestSession>> sessions_;
+  std::atomic<size_t> next_session_{0};
+  std::mt19937 arrival_engine_;
   onnxruntime::test::HeapBuffer b_;
   std::unique_ptr<ITestCase> test_case_;
 
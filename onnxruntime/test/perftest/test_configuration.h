@@ -29,6 +29,7 @@ struct ModelInfo {
   std::basic_string<ORTCHAR_T> model_file_path;
   std::basic_string<ORTCHAR_T> input_file_path;
   std::basic_string<ORTCHAR_T> result_file_path;
+  std::basic_string<ORTCHAR_T> json_result_file_path;
 };
 
 struct MachineConfig {
@@ -42,6 +43,18 @@ struct RunConfig {
   size_t repeated_times{1000};
   size_t duration_in_seconds{600};
   size_t concurrent_session_runs{1};
+  // Number of sessions created for the model. Runs are distributed over the sessions round robin.
+  size_t num_sessions{1};
+  // Number of runs per session before the measurement starts.
+  size_t warmup_times{1};
+  // If > 0, requests arrive open loop as a Poisson process with this rate, instead of a new request being issued
+  // when one completes. The latency of a request includes the time it waits for one of the
+  // concurrent_session_runs threads.
+  double target_qps{0};
+  // If generation_length > 0, the model is a decoder with past key/values and each request generates a sequence of
+  // generation_length tokens after a prompt of generation_prompt_length tokens. See GenerationRunner.
+  size_t generation_prompt_length{0};
+  size_t generation_length{0};
   bool f_dump_statistics{false};
   int random_seed_for_input_data{-1};
   bool f_verbose{false};
@@ -12,8 +12,11 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <functional>
+#include <set>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -85,6 +88,22 @@ void TestBatchParallelFor(const std::string& name, int num_threads, int num_task
   ValidateTestData(*test_data);
 }
 
+void TestGuidedParallelFor(const std::string& name, int num_threads, int num_tasks, double cost_per_unit) {
+  auto test_data = CreateTestData(num_tasks);
+  CreateThreadPoolAndTest(name, num_threads, [&](ThreadPool* tp) {
+    ThreadPool::TryGuidedParallelFor(tp, num_tasks, cost_per_unit, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        // skewed iterations, the first ones being the most expensive
+        if (i < num_tasks / 8) {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        IncrementElement(*test_data, i);
+      }
+    });
+  });
+  ValidateTestData(*test_data);
+}
+
 void TestConcurrentParallelFor(const std::string& name, int num_threads, int num_concurrent, int num_tasks, int dynamic_block_base = 0, bool mock_hybrid = false) {
   // Test running multiple concurrent loops over the same thread pool.  This aims to provoke a
   // more diverse mix of interleavings than with a single loop running at a time.
@@ -157,6 +176,26 @@ void TestBurstScheduling(const std::string& name, int num_tasks) {
   }
 }
 
+void TestScheduleWithLocality(const std::string& name, int num_tasks) {
+  // Test scheduling chains of tasks where each task schedules its successor with locality, as the
+  // parallel executor does for downstream streams.  Scheduling from outside the pool falls back to
+  // Schedule, and the queues of the workers may become full.
+  for (int rep = 0; rep < 5; rep++) {
+    std::atomic<int> ctr{0};
+    std::function<void(ThreadPool*, int)> run_chain = [&](ThreadPool* tp, int remaining) {
+      ctr++;
+      if (remaining > 1) {
+        ThreadPool::ScheduleWithLocality(tp, [&, tp, remaining]() { run_chain(tp, remaining - 1); });
+        ThreadPool::ScheduleWithLocality(tp, [&]() { ctr++; });
+      }
+    };
+    CreateThreadPoolAndTest(name, 4, [&](ThreadPool* tp) {
+      ThreadPool::ScheduleWithLocality(tp, [&, tp]() { run_chain(tp, num_tasks); });
+    });
+    ASSERT_TRUE(ctr == 2 * num_tasks - 1);
+  }
+}
+
 void TestPoolCreation(const std::string&, int iter) {
   // Test creating and destroying thread pools.  This can be used with Valgrind to help
   // check for memory leaks related to the initialization and clean-up code.  For instance
@@ -276,6 +315,23 @@ TEST(ThreadPoolTest, TestBatchParallelFor_2_Thread_81_Task_20_Batch) {
   TestBatchParallelFor("TestBatchParallelFor_2_Thread_81_Task_20_Batch", 2, 81, 20);
 }
 
+TEST(ThreadPoolTest, TestGuidedParallelFor_0_Thread_100_Task) {
+  TestGuidedParallelFor("TestGuidedParallelFor_0_Thread_100_Task", 0, 100, 1e6);
+}
+
+TEST(ThreadPoolTest, TestGuidedParallelFor_4_Thread_NoTask) {
+  TestGuidedParallelFor("TestGuidedParallelFor_4_Thread_NoTask", 4, 0, 1e6);
+}
+
+TEST(ThreadPoolTest, TestGuidedParallelFor_4_Thread_1000_Task) {
+  TestGuidedParallelFor("TestGuidedParallelFor_4_Thread_1000_Task", 4, 1000, 1e6);
+}
+
+TEST(ThreadPoolTest, TestGuidedParallelFor_4_Thread_1000_Cheap_Task) {
+  // The minimum chunk covers many iterations.
+  TestGuidedParallelFor("TestGuidedParallelFor_4_Thread_1000_Cheap_Task", 4, 1000, 10.0);
+}
+
 TEST(ThreadPoolTest, TestConcurrentParallelFor_0Thread_1Conc_0Tasks) {
   TestConcurrentParallelFor("TestConcurrentParallelFor_0Thread_1Conc_0Tasks", 0, 1, 0);
 }
@@ -434,6 +490,42 @@ TEST(ThreadPoolTest, TestBurstScheduling_65536Task) {
   TestBurstScheduling("TestBurstScheduling_65536Tasks", 65536);
 }
 
+TEST(ThreadPoolTest, TestScheduleWithLocality_1Task) {
+  TestScheduleWithLocality("TestScheduleWithLocality_1Task", 1);
+}
+
+TEST(ThreadPoolTest, TestScheduleWithLocality_4096Tasks) {
+  TestScheduleWithLocality("TestScheduleWithLocality_4096Tasks", 4096);
+}
+
+TEST(ThreadPoolTest, TestDegreeOfParallelismLimit) {
+  CreateThreadPoolAndTest("TestDegreeOfParallelismLimit", 8, [](ThreadPool* tp) {
+    const int full_dop = ThreadPool::DegreeOfParallelism(tp);
+    {
+      ThreadPool::ScopedDegreeOfParallelismLimit limit(2);
+      ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp) * 4, full_dop);
+
+      // Loops use at most 2 threads, including the calling thread
+      onnxruntime::OrtMutex mutex;
+      std::set<std::thread::id> thread_ids;
+      ThreadPool::TrySimpleParallelFor(tp, 1000, [&](std::ptrdiff_t) {
+        std::lock_guard<onnxruntime::OrtMutex> lock(mutex);
+        thread_ids.insert(std::this_thread::get_id());
+      });
+      ASSERT_LE(thread_ids.size(), 2u);
+
+      // Scheduled work inherits the limit
+      std::atomic<int> scheduled_dop{-1};
+      ThreadPool::Schedule(tp, [&]() { scheduled_dop = ThreadPool::DegreeOfParallelism(tp); });
+      while (scheduled_dop == -1) {
+        std::this_thread::yield();
+      }
+      ASSERT_EQ(scheduled_dop * 4, full_dop);
+    }
+    ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp), full_dop);
+  });
+}
+
 TEST(ThreadPoolTest, TestPoolCreation_1Iter) {
   TestPoolCreation("TestPoolCreation_1Iter", 1);
 }
@@ -613,6 +705,110 @@ TEST(ThreadPoolTest, TestAffinityStringWellShaped) {
   }
 }
 
+TEST(ThreadPoolTest, TestNumaNodeAffinity) {
+  auto node_affinities = onnxruntime::Env::Default().GetNumaNodeThreadAffinities(0);
+  if (node_affinities.size() < 2) {
+    return;  // NUMA information not available, or not enough cores
+  }
+  for (const auto& core : node_affinities) {
+    ASSERT_FALSE(core.empty());
+  }
+  OrtThreadPoolParams tp_params;
+  tp_params.numa_node = 0;
+  auto numa_tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                               tp_params,
+                                               concurrency::ThreadPoolType::INTRA_OP);
+  ASSERT_NE(numa_tp, nullptr);
+  ASSERT_GE(concurrency::ThreadPool::DegreeOfParallelism(numa_tp.get()), static_cast<int>(node_affinities.size()));
+
+  // more threads than cores of the node
+  tp_params.thread_pool_size = static_cast<int>(node_affinities.size()) * 2;
+  numa_tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                          tp_params,
+                                          concurrency::ThreadPoolType::INTRA_OP);
+  ASSERT_NE(numa_tp, nullptr);
+  std::atomic<int> count{0};
+  concurrency::ThreadPool::TryParallelFor(numa_tp.get(), 1000, 1000.0,
+                                          [&count](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                            count += static_cast<int>(last - first);
+                                          });
+  ASSERT_EQ(count, 1000);
+
+#ifndef ORT_NO_EXCEPTIONS
+  tp_params.numa_node = 1 << 20;
+  ASSERT_THROW(concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                             tp_params,
+                                             concurrency::ThreadPoolType::INTRA_OP),
+               std::exception);
+#endif
+}
+
+TEST(ThreadPoolTest, TestPerformanceCoresOnly) {
+  auto performance_cores = onnxruntime::Env::Default().GetPerformanceCoreThreadAffinities();
+  const auto default_affinities = onnxruntime::Env::Default().GetDefaultThreadAffinities();
+  // the performance cores are a strict subset of the cores when the CPU is hybrid, and empty otherwise
+  if (!performance_cores.empty()) {
+    ASSERT_LT(performance_cores.size(), default_affinities.size());
+  }
+  for (const auto& core : performance_cores) {
+    ASSERT_FALSE(core.empty());
+  }
+
+  OrtThreadPoolParams tp_params;
+  tp_params.performance_cores_only = true;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                          tp_params,
+                                          concurrency::ThreadPoolType::INTRA_OP);
+  if (performance_cores.size() > 1) {
+    ASSERT_NE(tp, nullptr);
+    ASSERT_GE(concurrency::ThreadPool::DegreeOfParallelism(tp.get()), static_cast<int>(performance_cores.size()));
+  }
+
+  // the loops run as usual, whether or not the CPU is hybrid
+  tp_params.thread_pool_size = 4;
+  tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                     tp_params,
+                                     concurrency::ThreadPoolType::INTRA_OP);
+  ASSERT_NE(tp, nullptr);
+  std::atomic<int> count{0};
+  concurrency::ThreadPool::TryParallelFor(tp.get(), 1000, 1000.0,
+                                          [&count](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                            count += static_cast<int>(last - first);
+                                          });
+  ASSERT_EQ(count, 1000);
+}
+
+#ifndef ORT_MINIMAL_BUILD
+TEST(ThreadPoolTest, TestAdaptiveSpinning) {
+  OrtThreadPoolParams tp_params;
+  tp_params.thread_pool_size = 4;
+  tp_params.adaptive_spinning = true;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                          tp_params,
+                                          concurrency::ThreadPoolType::INTRA_OP);
+  ASSERT_NE(tp, nullptr);
+  concurrency::ThreadPool::StartProfiling(tp.get());
+
+  // bursts of loops separated by long gaps, as between requests
+  for (int burst = 0; burst < 4; ++burst) {
+    for (int loop = 0; loop < 10; ++loop) {
+      std::atomic<int> count{0};
+      concurrency::ThreadPool::TryParallelFor(tp.get(), 1000, 1000.0,
+                                              [&count](std::ptrdiff_t first, std::ptrdiff_t last) {
+                                                count += static_cast<int>(last - first);
+                                              });
+      ASSERT_EQ(count, 1000);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  // the workers report the time spent spinning and running tasks
+  const std::string profile = concurrency::ThreadPool::StopProfiling(tp.get());
+  EXPECT_NE(profile.find("\"spin_us\""), std::string::npos);
+  EXPECT_NE(profile.find("\"run_us\""), std::string::npos);
+}
+#endif
+
 #ifdef _WIN32
 TEST(ThreadPoolTest, TestDefaultAffinity) {
   test::CpuGroup cpu_group = {{0, 1},
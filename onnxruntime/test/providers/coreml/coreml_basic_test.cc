@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+
 #include "core/common/logging/logging.h"
 #include "core/providers/coreml/coreml_execution_provider.h"
 #include "core/providers/coreml/coreml_provider_factory.h"
@@ -167,6 +169,37 @@ TEST(CoreMLExecutionProviderTest, ShapeThenSliceAndGather) {
 #endif
 }
 
+TEST(CoreMLExecutionProviderTest, ModelCache) {
+  const auto model_file_name = ORT_TSTR("testdata/shape_then_slice_and_gather.onnx");
+  const std::filesystem::path model_cache_dir = "coreml_ep_model_cache_test";
+  std::filesystem::remove_all(model_cache_dir);
+
+  auto make_ep = [&model_cache_dir]() {
+    return std::make_unique<CoreMLExecutionProvider>(s_coreml_flags, model_cache_dir.string());
+  };
+
+#if defined(__APPLE__)
+  RandomValueGenerator gen{1234};
+  std::vector<int64_t> X_shape = {5, 3, 4, 1, 2};
+  std::vector<float> X_data = gen.Uniform<float>(X_shape, 0.0f, 1.0f);
+  OrtValue X = CreateInputOrtValueOnCPU<float>(X_shape, X_data);
+
+  // the 1st session compiles the model and adds it to the cache, the 2nd one loads it from the cache
+  for (int i = 0; i < 2; ++i) {
+    RunAndVerifyOutputsWithEP(model_file_name, CurrentTestName(), make_ep(), {{"X", X}},
+                              EPVerificationParams{ExpectedEPNodeAssignment::All});
+
+    const auto num_cached_models = std::distance(std::filesystem::directory_iterator(model_cache_dir),
+                                                 std::filesystem::directory_iterator{});
+    EXPECT_EQ(num_cached_models, 1);
+  }
+#else
+  TestModelLoad(model_file_name, make_ep(), ExpectedEPNodeAssignment::All);
+#endif
+
+  std::filesystem::remove_all(model_cache_dir);
+}
+
 #endif  // !(ORT_MINIMAL_BUILD)
 
 TEST(CoreMLExecutionProviderTest, TestOrtFormatModel) {
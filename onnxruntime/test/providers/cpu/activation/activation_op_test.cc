@@ -723,6 +723,28 @@ TEST_F(ActivationOpTest, ONNX_Gelu) {
       {},
       {{"approximate", "tanh"}}, true, 20);
 }
+
+TEST_F(ActivationOpTest, ONNX_Gelu_fp16) {
+  std::vector<float> x = {-4.0f, -1.5f, -0.25f, 0.0f, 0.5f, 1.0f, 2.75f, 6.0f};
+  std::vector<int64_t> dims{static_cast<int64_t>(x.size())};
+
+  for (const char* approximate : {"none", "tanh"}) {
+    std::vector<float> y;
+    for (float v : x) {
+      if (strcmp(approximate, "tanh") == 0) {
+        y.push_back(static_cast<float>(0.5 * v * (1 + tanh(sqrt(2 / M_PI) * (v + 0.044715 * v * v * v)))));
+      } else {
+        y.push_back(static_cast<float>(0.5 * v * (1 + erf(v * M_SQRT1_2))));
+      }
+    }
+
+    OpTester test("Gelu", 20);
+    test.AddAttribute<std::string>("approximate", approximate);
+    test.AddInput<MLFloat16>("X", dims, ToFloat16(x));
+    test.AddOutput<MLFloat16>("Y", dims, ToFloat16(y));
+    test.Run();
+  }
+}
 #endif
 
 }  // namespace test
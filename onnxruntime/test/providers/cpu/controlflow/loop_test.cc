@@ -1042,6 +1042,64 @@ TEST(Loop, IterationCountAsOutput) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
 
+// the scan outputs are written into a buffer that starts with room for 16 iterations and is grown as needed.
+// check the values of the earlier iterations are preserved when it grows.
+TEST(Loop, ScanOutputBufferGrowth) {
+  auto create_subgraph = []() {
+    Model model("Scan output per iteration", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    /* Inputs: iter_num, cond_in
+
+         iter_num_in    cond_in
+             |             |
+           [Add]      [Identity]
+             |             |
+       loop_out_0      cond_out
+    */
+    TypeProto int64_scalar;
+    int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+    int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    TypeProto bool_scalar;
+    bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+    bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& loop_out_0 = graph.GetOrCreateNodeArg("loop_out_0", &int64_scalar);
+
+    graph.AddNode("add", "Add", "Double iter_num", {&iter_num_in, &iter_num_in}, {&loop_out_0});
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+
+    graph.SetInputs({&iter_num_in, &cond_in});
+    graph.SetOutputs({&cond_out, &loop_out_0});
+
+    auto status = graph.Resolve();
+    EXPECT_EQ(status, Status::OK());
+
+    return graph.ToGraphProto();
+  };
+
+  constexpr int64_t num_iterations = 40;
+  std::vector<int64_t> expected;
+  for (int64_t i = 0; i < num_iterations; ++i) {
+    expected.push_back(i * 2);
+  }
+
+  OpTester test("Loop", 11);
+  auto body = create_subgraph();
+  test.AddAttribute<GraphProto>("body", body);
+  test.AddInput<int64_t>("M", {1}, {num_iterations});
+  test.AddInput<bool>("cond", {1}, {true});
+
+  test.AddOutput<int64_t>("loop_out_0_final", {num_iterations, 1}, expected);
+
+  // Disable TensorRT on unsupported data type BOOL
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM)
 // test that when part of the subgraph run on CUDA/ROCm it executes successfully
 TEST(Loop, MixedExecutionProviders) {
@@ -2077,6 +2077,70 @@ TEST(Einsum, EinsumTransposeMatMulTwoInputsTestSuite) {
   }
 }
 
+// Matrix chains whose cheapest contraction order is not left-to-right
+TEST(Einsum, ExplicitEinsumMatrixChainContractionOrder) {
+  const int64_t n = 16;
+  const int64_t k = 2;
+  std::vector<float> x(n * n), y(n * n), z(n * k), w(k);
+  for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<float>(i % 7) - 3.f;
+  for (size_t i = 0; i < y.size(); ++i) y[i] = static_cast<float>(i % 5) - 2.f;
+  for (size_t i = 0; i < z.size(); ++i) z[i] = static_cast<float>(i % 3) - 1.f;
+  for (size_t i = 0; i < w.size(); ++i) w[i] = static_cast<float>(i) + 1.f;
+
+  // a = ((x * y) * z) * w computed naively
+  std::vector<float> expected(n, 0.f);
+  for (int64_t a = 0; a < n; ++a) {
+    for (int64_t b = 0; b < n; ++b) {
+      for (int64_t c = 0; c < n; ++c) {
+        for (int64_t d = 0; d < k; ++d) {
+          expected[a] += x[a * n + b] * y[b * n + c] * z[c * k + d] * w[d];
+        }
+      }
+    }
+  }
+
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ab,bc,cd,d->a");
+  test.AddInput<float>("x", {n, n}, x);
+  test.AddInput<float>("y", {n, n}, y);
+  test.AddInput<float>("z", {n, k}, z);
+  test.AddInput<float>("w", {k}, w);
+  test.AddOutput<float>("o", {n}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
+TEST(Einsum, ExplicitEinsumLongMatrixChainContractionOrder) {
+  // More operands than the exhaustive search handles, so the order is picked greedily
+  const int64_t n = 3;
+  std::vector<std::vector<float>> m(6, std::vector<float>(n * n));
+  for (size_t i = 0; i < m.size(); ++i) {
+    for (size_t j = 0; j < m[i].size(); ++j) {
+      m[i][j] = static_cast<float>((i + j) % 4) - 1.5f;
+    }
+  }
+  std::vector<float> v{1.f, -1.f, 2.f};
+
+  std::vector<float> expected(v);
+  for (size_t i = m.size(); i-- > 0;) {
+    std::vector<float> next(n, 0.f);
+    for (int64_t r = 0; r < n; ++r) {
+      for (int64_t c = 0; c < n; ++c) {
+        next[r] += m[i][r * n + c] * expected[c];
+      }
+    }
+    expected = next;
+  }
+
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ab,bc,cd,de,ef,fg,g->a");
+  for (size_t i = 0; i < m.size(); ++i) {
+    test.AddInput<float>(("m" + std::to_string(i)).c_str(), {n, n}, m[i]);
+  }
+  test.AddInput<float>("v", {n}, v);
+  test.AddOutput<float>("o", {n}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
 class EinsumTransposeMatMulThreeInputsTest : public testing::TestWithParam<EinsumTestCase> {
 };
 
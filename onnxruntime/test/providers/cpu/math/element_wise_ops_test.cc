@@ -446,6 +446,46 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
 #endif
 }
 
+// Half precision on the CPU EP, in float a block at a time when MLAS converts with vector instructions and with
+// inserted Casts otherwise. The inputs are longer than a block.
+TEST(MathOpTest, Add_float16_CPU) {
+  std::vector<float> lhs_values(2 * 1500);
+  std::vector<float> rhs_values(1500);
+  std::vector<float> out_values(2 * 1500);
+  for (size_t i = 0; i < lhs_values.size(); i++) {
+    lhs_values[i] = static_cast<float>(i % 100) * 0.25f;
+    rhs_values[i % rhs_values.size()] = static_cast<float>(i % 7) - 3.0f;
+  }
+  for (size_t i = 0; i < out_values.size(); i++) {
+    out_values[i] = lhs_values[i] + rhs_values[i % rhs_values.size()];
+  }
+
+  std::vector<MLFloat16> lhs(lhs_values.size());
+  std::vector<MLFloat16> rhs(rhs_values.size());
+  std::vector<MLFloat16> out(out_values.size());
+  ConvertFloatToMLFloat16(lhs_values.data(), lhs.data(), lhs.size());
+  ConvertFloatToMLFloat16(rhs_values.data(), rhs.data(), rhs.size());
+  ConvertFloatToMLFloat16(out_values.data(), out.data(), out.size());
+
+  OpTester test("Add", 14);
+  test.AddInput<MLFloat16>("A", {2, 1500}, lhs);
+  test.AddInput<MLFloat16>("B", {1500}, rhs);
+  test.AddOutput<MLFloat16>("C", {2, 1500}, out);
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(MathOpTest, Div_float16_Scalar_CPU) {
+  OpTester test("Div", 14);
+  test.AddInput<MLFloat16>("A", {}, MakeMLFloat16({12.0f}));
+  test.AddInput<MLFloat16>("B", {2, 3}, MakeMLFloat16({1.0f, 2.0f, 3.0f, -4.0f, 6.0f, 0.5f}));
+  test.AddOutput<MLFloat16>("C", {2, 3}, MakeMLFloat16({12.0f, 6.0f, 4.0f, -3.0f, 2.0f, 24.0f}));
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 // Validate runtime failure has useful error message when ORT_ENFORCE is used
 TEST(MathOpTest, Add_Invalid_Broadcast) {
   OpTester test("Add");
@@ -25,7 +25,7 @@ const constexpr auto run_with_tunable_op = &run_options;
 
 }  // namespace
 
-// Only CUDA and ROCM kernel has float 16 support
+// The CPU EP only registers float 16 Gemm when MLAS has a half gemm kernel for the platform.
 TEST(GemmOpTest, GemmNoTrans_f16) {
 #ifdef USE_CUDA
   int min_cuda_architecture = 530;
@@ -66,6 +66,59 @@ TEST(GemmOpTest, GemmNoTrans_f16) {
       .RunWithConfig();
 }
 
+// The row and missing bias cases take the MLAS half gemm path of the CPU kernel.
+TEST(GemmOpTest, GemmNoTrans_f16_RowBias) {
+#ifdef USE_CUDA
+  int min_cuda_architecture = 530;
+  if (!HasCudaEnvironment(min_cuda_architecture)) {
+    LOGS_DEFAULT(WARNING) << "Hardware NOT support FP16";
+    return;
+  }
+#endif
+  auto run_test = [](bool has_bias) {
+    OpTester test("Gemm", 13);
+
+    test.AddAttribute("transA", (int64_t)0);
+    test.AddAttribute("transB", (int64_t)0);
+    test.AddAttribute("alpha", 1.0f);
+    test.AddAttribute("beta", 1.0f);
+
+    constexpr int64_t M = 7, N = 37, K = 19;
+    std::vector<float> A(M * K), B(K * N), C(N), Y(M * N);
+    for (int64_t i = 0; i < M * K; i++) {
+      A[i] = static_cast<float>(i % 5) - 2.0f;
+    }
+    for (int64_t i = 0; i < K * N; i++) {
+      B[i] = static_cast<float>(i % 3) - 1.0f;
+    }
+    for (int64_t n = 0; n < N; n++) {
+      C[n] = static_cast<float>(n % 4);
+    }
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        float sum = has_bias ? C[n] : 0.0f;
+        for (int64_t k = 0; k < K; k++) {
+          sum += A[m * K + k] * B[k * N + n];
+        }
+        Y[m * N + n] = sum;
+      }
+    }
+
+    test.AddInput<MLFloat16>("A", {M, K}, FloatsToMLFloat16s(A));
+    test.AddInput<MLFloat16>("B", {K, N}, FloatsToMLFloat16s(B));
+    if (has_bias) {
+      test.AddInput<MLFloat16>("C", {N}, FloatsToMLFloat16s(C));
+    }
+    test.AddOutput<MLFloat16>("Y", {M, N}, FloatsToMLFloat16s(Y));
+    test.ConfigExcludeEps({kTensorrtExecutionProvider})  // TensorRT: fp16 is not supported
+        .Config(run_with_tunable_op)
+        .RunWithConfig();
+  };
+
+  run_test(true);
+  run_test(false);
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(GemmOpTest, GemmNoTrans_bfloat16) {
 #ifdef USE_CUDA
@@ -291,5 +291,37 @@ TEST(LogSoftmaxOperator, 2DInputReduceOnAxis1WithLargeDim) {
   RunTest(x_vals, expected_vals, dimensions);
 }
 
+// The softmax axis is not the innermost axis, and the inner dimensions span several blocks of columns.
+TEST(LogSoftmaxOperator, InnerAxisWithLargeStride_opset13) {
+  const std::vector<int64_t> dimensions = {3, 5, 70};
+  const int64_t outer = 3, axis_dim = 5, inner = 70;
+
+  std::vector<float> x_vals(static_cast<size_t>(outer * axis_dim * inner));
+  for (size_t i = 0; i < x_vals.size(); ++i) {
+    x_vals[i] = static_cast<float>((i * 37) % 101) * 0.1f - 5.0f;
+  }
+
+  std::vector<float> expected_vals(x_vals.size());
+  for (int64_t n = 0; n < outer; ++n) {
+    for (int64_t s = 0; s < inner; ++s) {
+      auto at = [&](int64_t d) { return static_cast<size_t>((n * axis_dim + d) * inner + s); };
+      float max = x_vals[at(0)];
+      for (int64_t d = 1; d < axis_dim; ++d) {
+        max = std::max(max, x_vals[at(d)]);
+      }
+      float sum = 0.0f;
+      for (int64_t d = 0; d < axis_dim; ++d) {
+        sum += std::exp(x_vals[at(d)] - max);
+      }
+      for (int64_t d = 0; d < axis_dim; ++d) {
+        expected_vals[at(d)] = x_vals[at(d)] - max - std::log(sum);
+      }
+    }
+  }
+
+  RunTest(x_vals, expected_vals, dimensions, /*opset*/ 13, /*axis*/ 1, false,
+          OpTester::ExpectResult::kExpectSuccess, "", 1e-5f);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -2,6 +2,7 @@
 // Copyright 2023 Amazon.com, Inc. or its affiliates. All Rights Reserved.
 // Licensed under the MIT License.
 
+#include "core/mlas/inc/mlas.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
@@ -11,7 +12,7 @@
 #include "test/common/tensor_op_test_utils.h"
 #include "default_providers.h"
 
-#if defined(__aarch64__) && defined(__linux__)
+#if defined(MLAS_SUPPORTS_SBGEMM)
 
 namespace onnxruntime {
 namespace test {
@@ -185,6 +186,41 @@ TEST(MathOpTest, MatMulFloatTypeInitializer_FastMath) {
   RunMatMulTest<float>(7, false, true, false);
 }
 
+TEST(MathOpTest, MatMulFloatTypeInitializer_FastMathBfloat16) {
+  // Small integers are exact in bfloat16, so the bfloat16 kernel matches the fp32 result exactly.
+  constexpr int64_t M = 5, K = 37, N = 70;
+  std::vector<float> a_vals(M * K);
+  std::vector<float> b_vals(K * N);
+  for (size_t i = 0; i < a_vals.size(); ++i) {
+    a_vals[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+  for (size_t i = 0; i < b_vals.size(); ++i) {
+    b_vals[i] = static_cast<float>(static_cast<int>(i % 5) - 2);
+  }
+  std::vector<float> y_vals(M * N, 0.0f);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      for (int64_t k = 0; k < K; ++k) {
+        y_vals[m * N + n] += a_vals[m * K + k] * b_vals[k * N + n];
+      }
+    }
+  }
+
+  OpTester test("MatMul", 13);
+  test.AddInput<float>("A", {M, K}, a_vals);
+  test.AddInput<float>("B", {K, N}, b_vals, true);
+  test.AddOutput<float>("Y", {M, N}, y_vals);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasGemmFastMathBfloat16, "1"));
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Config(so)
+      .ConfigEps(std::move(execution_providers))
+      .RunWithConfig();
+}
+
 TEST(MathOpTest, MatMulInt32Type_FastMath) {
   RunMatMulTest<int32_t>(9);
 }
@@ -302,4 +338,4 @@ TEST(MathOpTest, MatMulUint64Type_DisableFastMath) {
 
 }  // namespace test
 }  // namespace onnxruntime
-#endif  // defined(__aarch64__) && defined(__linux__)
+#endif  // defined(MLAS_SUPPORTS_SBGEMM)
@@ -7,6 +7,7 @@
 #include "test/common/dnnl_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "default_providers.h"
 
 namespace onnxruntime {
@@ -198,6 +199,89 @@ TEST(MathOpTest, MatMulFloatType) {
   RunMatMulTest<float>(7, false, false);
 }
 
+// The shapes are large enough for every thread partition of the GEMM to be a tuning candidate.
+TEST(MathOpTest, MatMulFloatTypeCpuTunableOp) {
+  constexpr int64_t batch = 2, M = 37, K = 64, N = 80;
+  std::vector<float> a_vals(batch * M * K);
+  std::vector<float> b_vals(K * N);
+  for (size_t i = 0; i < a_vals.size(); i++) {
+    a_vals[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+  for (size_t i = 0; i < b_vals.size(); i++) {
+    b_vals[i] = static_cast<float>(static_cast<int>(i % 5) - 2) * 0.5f;
+  }
+
+  std::vector<float> expected_vals(batch * M * N);
+  for (int64_t bm = 0; bm < batch * M; bm++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        sum += a_vals[bm * K + k] * b_vals[k * N + n];
+      }
+      expected_vals[bm * N + n] = sum;
+    }
+  }
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCpuTunableOpEnable, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCpuTunableOpTuningEnable, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "5"));
+
+  for (bool is_b_constant : {false, true}) {
+    OpTester test("MatMul", 13);
+    test.AddInput<float>("A", {batch, M, K}, a_vals);
+    test.AddInput<float>("B", {K, N}, b_vals, is_b_constant);
+    test.AddOutput<float>("Y", {batch, M, N}, expected_vals);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Config(so)
+        .ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  }
+}
+
+// B is packed into the sparse format when at least 70% of its elements are zero, and into the dense one otherwise.
+TEST(MathOpTest, MatMulFloatTypeSparseWeight) {
+  constexpr int64_t batch = 2, M = 19, K = 48, N = 136;
+  std::vector<float> a_vals(batch * M * K);
+  for (size_t i = 0; i < a_vals.size(); i++) {
+    a_vals[i] = static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasSparseGemmMinSparsity, "0.7"));
+
+  for (int64_t density : {4, 1}) {
+    std::vector<float> b_vals(K * N);
+    for (size_t i = 0; i < b_vals.size(); i++) {
+      b_vals[i] = i % density == 0 ? static_cast<float>(static_cast<int>(i % 5) - 2) * 0.5f : 0.0f;
+    }
+
+    std::vector<float> expected_vals(batch * M * N);
+    for (int64_t bm = 0; bm < batch * M; bm++) {
+      for (int64_t n = 0; n < N; n++) {
+        float sum = 0.0f;
+        for (int64_t k = 0; k < K; k++) {
+          sum += a_vals[bm * K + k] * b_vals[k * N + n];
+        }
+        expected_vals[bm * N + n] = sum;
+      }
+    }
+
+    OpTester test("MatMul", 13);
+    test.AddInput<float>("A", {batch, M, K}, a_vals);
+    test.AddInput<float>("B", {K, N}, b_vals, true);
+    test.AddOutput<float>("Y", {batch, M, N}, expected_vals);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Config(so)
+        .ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  }
+}
+
 TEST(MathOpTest, MatMulDoubleType) {
   RunMatMulTest<double>(7);
 }
@@ -259,6 +343,40 @@ TEST(MathOpTest, MatMul_Float16) {
 }
 #endif
 
+// Half precision on the CPU EP, by the MLAS half gemm when it has a vectorized kernel and with inserted Casts
+// otherwise. A is batched and B is broadcast.
+TEST(MathOpTest, MatMul_Float16_CPU) {
+  std::vector<float> A{1.0f, 2.0f, 3.0f, 4.0f,
+                       -1.0f, -2.0f, -3.0f, -4.0f,
+
+                       0.5f, 0.5f, 0.5f, 0.5f,
+                       2.0f, 0.0f, -2.0f, 1.0f};
+  std::vector<float> B{1.0f, 0.0f, 2.0f,
+                       1.0f, 1.0f, 0.0f,
+                       1.0f, 0.0f, 1.0f,
+                       1.0f, -1.0f, 0.0f};
+  std::vector<float> Y{10.0f, -2.0f, 5.0f,
+                       -10.0f, 2.0f, -5.0f,
+
+                       2.0f, 0.0f, 1.5f,
+                       1.0f, -1.0f, 2.0f};
+
+  std::vector<MLFloat16> f_A(A.size());
+  std::vector<MLFloat16> f_B(B.size());
+  std::vector<MLFloat16> f_Y(Y.size());
+  ConvertFloatToMLFloat16(A.data(), f_A.data(), f_A.size());
+  ConvertFloatToMLFloat16(B.data(), f_B.data(), f_B.size());
+  ConvertFloatToMLFloat16(Y.data(), f_Y.data(), f_Y.size());
+
+  OpTester test("MatMul", 13);
+  test.AddInput<MLFloat16>("A", {2, 2, 4}, f_A);
+  test.AddInput<MLFloat16>("B", {4, 3}, f_B);
+  test.AddOutput<MLFloat16>("Y", {2, 2, 3}, f_Y);
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(MathOpTest, MatMul_bfloat16) {
 #ifdef USE_CUDA
@@ -49,7 +49,6 @@ TEST(SoftmaxOperator, Simple) {
   RunTest(x_vals, expected_vals, dimensions);
 }
 
-#if defined(USE_CUDA) || defined(USE_ROCM)
 TEST(SoftmaxOperator, Simple_fp16) {
 #ifdef USE_CUDA
   int min_cuda_architecture = 530;
@@ -76,7 +75,6 @@ TEST(SoftmaxOperator, Simple_fp16) {
   test.AddOutput<MLFloat16>("Y", dimensions, f_Y);
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
 }
-#endif
 
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(SoftmaxOperator, Simple_bfloat16) {
@@ -405,6 +403,38 @@ TEST(SoftmaxOperator, 2DInputReduceOnAxis1WithLargeDim) {
   RunTest(x_vals, expected_vals, dimensions);
 }
 
+// The inner dimensions span several blocks of columns of the strided softmax, and are not a multiple of 4.
+TEST(SoftmaxOperator, InnerAxisWithLargeStride_opset13) {
+  const std::vector<int64_t> dimensions = {2, 7, 3, 45};
+  const int64_t outer = 2, axis_dim = 7, inner = 3 * 45;
+
+  std::vector<float> x_vals(static_cast<size_t>(outer * axis_dim * inner));
+  for (size_t i = 0; i < x_vals.size(); ++i) {
+    x_vals[i] = static_cast<float>((i * 37) % 101) * 0.1f - 5.0f;
+  }
+
+  std::vector<float> expected_vals(x_vals.size());
+  for (int64_t n = 0; n < outer; ++n) {
+    for (int64_t s = 0; s < inner; ++s) {
+      auto at = [&](int64_t d) { return static_cast<size_t>((n * axis_dim + d) * inner + s); };
+      float max = x_vals[at(0)];
+      for (int64_t d = 1; d < axis_dim; ++d) {
+        max = std::max(max, x_vals[at(d)]);
+      }
+      float sum = 0.0f;
+      for (int64_t d = 0; d < axis_dim; ++d) {
+        sum += std::exp(x_vals[at(d)] - max);
+      }
+      for (int64_t d = 0; d < axis_dim; ++d) {
+        expected_vals[at(d)] = std::exp(x_vals[at(d)] - max) / sum;
+      }
+    }
+  }
+
+  RunTest(x_vals, expected_vals, dimensions, /*opset*/ 13, /*axis*/ 1,
+          {kTensorrtExecutionProvider});
+}
+
 // Regression test for NNAPI handling of a Softmax with opset < 13 where the input has been converted to NHWC.
 // The NNAPI handling of the axis is different so we need to manually coerce the input to 2D, which will negate the
 // layout change. Test model has a GlobalAveragePool -> Softmax which will trigger the layout change due to
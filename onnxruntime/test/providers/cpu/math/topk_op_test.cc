@@ -792,6 +792,38 @@ TEST(TopKOperator, BigArrayBigTopKSorted_double) {
   RunTest(11, 9000, input_vals, input_dimensions, expected_vals, expected_indices, expected_dimensions, false, 0, 1, 1);
 }
 
+// Large axis with negative values and duplicates, so the top k is selected with a radix select.
+template <typename T>
+static void BigArrayTopKWithDuplicates(int64_t largest) {
+  constexpr int64_t n = 8192;
+  constexpr int64_t k = 3000;
+  std::vector<T> input_vals(n);
+  for (int64_t i = 0; i < n; ++i) {
+    input_vals[i] = static_cast<T>((i * 7919) % 2001 - 1000);
+  }
+
+  std::vector<int64_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int64_t lhs, int64_t rhs) {
+    return largest ? input_vals[lhs] > input_vals[rhs] : input_vals[lhs] < input_vals[rhs];
+  });
+  std::vector<int64_t> expected_indices(order.begin(), order.begin() + k);
+  std::vector<T> expected_vals;
+  for (int64_t idx : expected_indices) {
+    expected_vals.push_back(input_vals[idx]);
+  }
+
+  RunTest(11, k, input_vals, {n}, expected_vals, expected_indices, {k}, false, 0, largest, 1);
+}
+
+TEST(TopKOperator, BigArrayTopKWithDuplicates) {
+  BigArrayTopKWithDuplicates<float>(1);
+  BigArrayTopKWithDuplicates<float>(0);
+  BigArrayTopKWithDuplicates<double>(1);
+  BigArrayTopKWithDuplicates<int32_t>(0);
+  BigArrayTopKWithDuplicates<int64_t>(1);
+}
+
 template <typename T>
 static void top_3_all_same(int opset_version, int64_t largest = 1) {
   // whether it's largest or smallest we should pick the first instance/s of a number if there are multiple
@@ -43,5 +43,21 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+// large enough for the lookups to be split across the thread pool
+TEST(CategoryMapper, LargeStringToInt) {
+  static const std::vector<std::string> words = {"One", "Two", "Three", "Four"};
+  static const std::vector<int64_t> mapped = {1, 2, 3, 99};
+
+  std::vector<int64_t> dims{64, 257};
+  std::vector<std::string> input;
+  std::vector<int64_t> output;
+  for (int64_t i = 0; i < dims[0] * dims[1]; ++i) {
+    input.push_back(words[i % 4]);
+    output.push_back(mapped[i % 4]);
+  }
+
+  RunTest(dims, input, output);
+}
 }  // namespace test
 }  // namespace onnxruntime
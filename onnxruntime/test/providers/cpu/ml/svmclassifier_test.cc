@@ -50,6 +50,64 @@ TEST(MLOpTest, SVMClassifierMulticlassSVC) {
   test.Run();
 }
 
+TEST(MLOpTest, SVMClassifierMulticlassSVCManyClasses) {
+  // Enough classes for the scores of the pairs of classes to be computed one pair at a time.
+  OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
+
+  // 8 rows of 9 coefficients
+  std::vector<float> coefficients = {
+      -1.25f, -0.5f, 0.25f, 1.f, -1.f, -0.25f, 0.5f, 1.25f, -0.75f,
+      0.5f, 1.25f, -0.75f, 0.f, 0.75f, -1.25f, -0.5f, 0.25f, 1.f,
+      -0.5f, 0.25f, 1.f, -1.f, -0.25f, 0.5f, 1.25f, -0.75f, 0.f,
+      1.25f, -0.75f, 0.f, 0.75f, -1.25f, -0.5f, 0.25f, 1.f, -1.f,
+      0.25f, 1.f, -1.f, -0.25f, 0.5f, 1.25f, -0.75f, 0.f, 0.75f,
+      -0.75f, 0.f, 0.75f, -1.25f, -0.5f, 0.25f, 1.f, -1.f, -0.25f,
+      1.f, -1.f, -0.25f, 0.5f, 1.25f, -0.75f, 0.f, 0.75f, -1.25f,
+      0.f, 0.75f, -1.25f, -0.5f, 0.25f, 1.f, -1.f, -0.25f, 0.5f};
+  std::vector<float> support_vectors = {0.f, 0.f, 1.f, 3.f, 2.f, 1.f, 3.f, 4.f, 4.f, 2.f, 5.f, 0.f, 6.f, 3.f, 7.f, 1.f,
+                                        8.f, 4.f};
+  std::vector<int64_t> classes = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<int64_t> vectors_per_class = {1, 1, 1, 1, 1, 1, 1, 1, 1};
+  std::vector<float> rho = {-0.375f, 0.25f, 0.f, -0.25f, 0.375f, 0.125f, -0.125f, -0.375f, 0.25f, 0.f, -0.25f, 0.375f,
+                            0.125f, -0.125f, -0.375f, 0.25f, 0.f, -0.25f, 0.375f, 0.125f, -0.125f, -0.375f, 0.25f, 0.f,
+                            -0.25f, 0.375f, 0.125f, -0.125f, -0.375f, 0.25f, 0.f, -0.25f, 0.375f, 0.125f, -0.125f,
+                            -0.375f};
+  std::vector<float> kernel_params = {0.1f, 0.f, 3.f};  // gamma, coef0, degree
+
+  std::vector<float> X = {1.f, 2.f, 4.f, 0.5f, 7.5f, 3.f};
+  std::vector<int64_t> predictions = {1, 4, 1};
+  std::vector<float> scores = {
+      -1.585582f, 0.75794802f, 0.14606363f, 0.10159366f, 0.49279884f, -0.29276121f, 0.51243507f, -0.3787437f,
+      0.76699871f, 0.22620935f, -0.62370082f, 1.1106683f, 0.087863211f, -1.0236565f, 0.30861966f, 0.61940179f,
+      -0.10164241f, -1.0010631f, 1.08189f, -0.098225333f, -1.1484134f, -0.54621535f, 0.070000117f, -0.54309281f,
+      -0.00061199147f, 0.14534392f, 0.49745393f, -0.38399001f, 0.13321207f, 0.35538611f, 0.1081074f, -0.37622499f,
+      0.50908738f, 0.14354264f, -0.20551307f, -0.37868508f,
+      -0.72995012f, 0.51189828f, 0.16734712f, -0.80237662f, 0.20360369f, 0.15671448f, 0.56757595f, -0.41948149f,
+      0.031698982f, 0.054405264f, 0.18567137f, -0.51050007f, -0.054398233f, -0.2434882f, -0.15247555f, 0.63796683f,
+      -0.19962905f, -0.46252133f, 1.3138229f, -0.33584101f, -0.94221223f, -1.1737931f, -0.25769919f, -0.24255458f,
+      0.2794329f, 0.18278986f, 1.6273792f, -0.79335546f, 0.62314527f, 0.49411055f, 0.57942069f, -1.3084041f,
+      1.2426697f, 0.42239856f, -0.55793229f, -0.44447853f,
+      -0.38414557f, 0.25887048f, 0.11869981f, -0.51397006f, 0.32096132f, 0.52315837f, 0.69367855f, -1.0368727f,
+      0.24386971f, 0.0036563337f, -0.061616782f, 0.11759901f, -0.27425811f, 0.023817112f, 0.5184659f, 0.16311631f,
+      -0.06645074f, -0.17373875f, 1.3975572f, -0.37346466f, -0.1656866f, -0.61767897f, 0.11133123f, 0.050337844f,
+      0.46348627f, -0.56721339f, 0.5299278f, -0.85678864f, -0.042746301f, 0.97832342f, 0.85292148f, -1.0669856f,
+      0.37199683f, 0.61532734f, -2.0266373f, -0.097193995f};
+
+  test.AddAttribute("kernel_type", std::string("RBF"));
+  test.AddAttribute("coefficients", coefficients);
+  test.AddAttribute("support_vectors", support_vectors);
+  test.AddAttribute("vectors_per_class", vectors_per_class);
+  test.AddAttribute("rho", rho);
+  test.AddAttribute("kernel_params", kernel_params);
+  test.AddAttribute("classlabels_ints", classes);
+
+  test.AddInput<float>("X", {3, 2}, X);
+  test.AddOutput<int64_t>("Y", {3}, predictions);
+  test.AddOutput<float>("Z", {3, 36}, scores);
+
+  test.Run();
+}
+
 TEST(MLOpTest, SVMClassifierMulticlassLinearSVC) {
   OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
 
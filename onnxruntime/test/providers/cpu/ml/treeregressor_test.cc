@@ -1,7 +1,10 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
+
 #include "gtest/gtest.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
 
 namespace onnxruntime {
@@ -760,5 +763,93 @@ TEST(MLOpTest, TreeRegressorTrueNodeBeforeNode) {
   test.Run();
 }
 
+TEST(MLOpTest, TreeRegressorMissingTrackSharedNodeBatch) {
+  OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+
+  // The true branch of node 1 in tree 0 is shared with the false branch of node 0.
+  std::vector<int64_t> nodes_treeids = {0, 0, 0, 0, 1, 1, 1};
+  std::vector<int64_t> nodes_nodeids = {0, 1, 2, 3, 0, 1, 2};
+  std::vector<int64_t> nodes_featureids = {0, 1, 0, 0, 1, 0, 0};
+  std::vector<float> nodes_values = {1.0f, 0.5f, 0.f, 0.f, 2.0f, 0.f, 0.f};
+  std::vector<std::string> nodes_modes = {"BRANCH_LT", "BRANCH_LT", "LEAF", "LEAF", "BRANCH_LT", "LEAF", "LEAF"};
+  std::vector<int64_t> nodes_truenodeids = {1, 2, 0, 0, 1, 0, 0};
+  std::vector<int64_t> nodes_falsenodeids = {2, 3, 0, 0, 2, 0, 0};
+  std::vector<int64_t> nodes_missing_value_tracks_true = {1, 0, 0, 0, 0, 0, 0};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1};
+  std::vector<int64_t> target_nodeids = {2, 3, 1, 2};
+  std::vector<int64_t> target_ids = {0, 0, 0, 0};
+  std::vector<float> target_weights = {10.f, 1.f, 100.f, 1000.f};
+
+  test.AddAttribute("nodes_treeids", nodes_treeids);
+  test.AddAttribute("nodes_nodeids", nodes_nodeids);
+  test.AddAttribute("nodes_featureids", nodes_featureids);
+  test.AddAttribute("nodes_values", nodes_values);
+  test.AddAttribute("nodes_modes", nodes_modes);
+  test.AddAttribute("nodes_truenodeids", nodes_truenodeids);
+  test.AddAttribute("nodes_falsenodeids", nodes_falsenodeids);
+  test.AddAttribute("nodes_missing_value_tracks_true", nodes_missing_value_tracks_true);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_ids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  // More rows than a block of the flattened trees.
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> X = {0.f, 0.f, 0.f, 1.f, 2.f, 0.f, nan, 3.f, nan, nan};
+  std::vector<float> Y = {110.f, 101.f, 110.f, 1001.f, 1001.f};
+  _multiply_update_array(X, 4);
+  _multiply_update_array(Y, 4);
+
+  test.AddInput<float>("X", {20, 2}, X);
+  test.AddOutput<float>("Y", {20, 1}, Y);
+  test.Run();
+}
+
+TEST(MLOpTest, TreeRegressorSmallRowBlocks) {
+  // Small blocks of rows, so that the rows are split by tiles of several blocks, the last one being partial.
+  std::vector<int64_t> nodes_treeids = {0, 0, 0, 1, 1, 1};
+  std::vector<int64_t> nodes_nodeids = {0, 1, 2, 0, 1, 2};
+  std::vector<int64_t> nodes_featureids = {0, 0, 0, 1, 0, 0};
+  std::vector<float> nodes_values = {1.0f, 0.f, 0.f, 2.0f, 0.f, 0.f};
+  std::vector<std::string> nodes_modes = {"BRANCH_LEQ", "LEAF", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF"};
+  std::vector<int64_t> nodes_truenodeids = {1, 0, 0, 1, 0, 0};
+  std::vector<int64_t> nodes_falsenodeids = {2, 0, 0, 2, 0, 0};
+
+  std::vector<int64_t> target_treeids = {0, 0, 1, 1};
+  std::vector<int64_t> target_nodeids = {1, 2, 1, 2};
+  std::vector<int64_t> target_ids = {0, 0, 0, 0};
+  std::vector<float> target_weights = {1.f, 10.f, 100.f, 1000.f};
+
+  std::vector<float> X = {0.f, 0.f, 2.f, 0.f, 0.f, 3.f, 2.f, 3.f, 1.f, 2.f};
+  std::vector<float> Y = {101.f, 110.f, 1001.f, 1010.f, 101.f};
+  _multiply_update_array(X, 11);
+  _multiply_update_array(Y, 11);
+
+  for (const char* parallel_n : {"0", "50"}) {
+    OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+    test.AddAttribute("nodes_treeids", nodes_treeids);
+    test.AddAttribute("nodes_nodeids", nodes_nodeids);
+    test.AddAttribute("nodes_featureids", nodes_featureids);
+    test.AddAttribute("nodes_values", nodes_values);
+    test.AddAttribute("nodes_modes", nodes_modes);
+    test.AddAttribute("nodes_truenodeids", nodes_truenodeids);
+    test.AddAttribute("nodes_falsenodeids", nodes_falsenodeids);
+    test.AddAttribute("target_treeids", target_treeids);
+    test.AddAttribute("target_nodeids", target_nodeids);
+    test.AddAttribute("target_ids", target_ids);
+    test.AddAttribute("target_weights", target_weights);
+    test.AddAttribute("n_targets", (int64_t)1);
+    test.AddInput<float>("X", {55, 2}, X);
+    test.AddOutput<float>("Y", {55, 1}, Y);
+
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsTreeEnsembleParallelTreeN, "3"));
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsTreeEnsembleParallelN, parallel_n));
+    test.Config(so).RunWithConfig();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
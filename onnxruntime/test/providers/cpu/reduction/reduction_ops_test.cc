@@ -5637,6 +5637,98 @@ TEST(ReductionOpTest, ReduceSum_RKR_parallel_bigger) {
   test.Run();
 }
 
+TEST(ReductionOpTest, OptimizeShapeForFastReduce_UnitDims) {
+  FastReduceKind fast_kind;
+  TensorShapeVector fast_shape, fast_output_shape, fast_axes;
+  TensorShapeVector expected_fast_shape, expected_fast_output_shape, expected_fast_axes;
+
+  // unit dimensions are skipped so that KRK becomes RK
+  fast_kind = OptimizeShapeForFastReduce(
+      TensorShapeVector{1, 80, 1, 3000}, TensorShapeVector{1},
+      fast_shape, fast_output_shape, fast_axes, true);
+  expected_fast_shape = {80, 3000};
+  expected_fast_output_shape = {1, 1, 1, 3000};
+  expected_fast_axes = {0};
+  ASSERT_EQ(fast_kind, FastReduceKind::kRK);
+  ASSERT_EQ(fast_shape, expected_fast_shape);
+  ASSERT_EQ(fast_output_shape, expected_fast_output_shape);
+  ASSERT_EQ(fast_axes, expected_fast_axes);
+
+  // unit dimensions are kept when they are the only reduced ones
+  fast_kind = OptimizeShapeForFastReduce(
+      TensorShapeVector{4, 1, 5}, TensorShapeVector{1},
+      fast_shape, fast_output_shape, fast_axes, false);
+  expected_fast_shape = {4, 1, 5};
+  expected_fast_output_shape = {4, 5};
+  expected_fast_axes = {1};
+  ASSERT_EQ(fast_kind, FastReduceKind::kKRK);
+  ASSERT_EQ(fast_shape, expected_fast_shape);
+  ASSERT_EQ(fast_output_shape, expected_fast_output_shape);
+  ASSERT_EQ(fast_axes, expected_fast_axes);
+}
+
+TEST(ReductionOpTest, ReduceMean_KRK_unit_dims_parallel) {
+  OpTester test("ReduceMean");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)1);
+  std::vector<float> in_data(80 * 3000);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)(i % 23) / 23.f - 0.5f;
+  test.AddInput<float>("data", {1, 80, 3000}, in_data);
+  std::vector<float> expected(3000);
+  for (size_t j = 0; j < 3000; ++j) {
+    expected[j] = 0;
+    for (size_t i = 0; i < 80; ++i) {
+      expected[j] += in_data[i * 3000 + j];
+    }
+    expected[j] /= 80.f;
+  }
+  test.AddOutput<float>("reduced", {1, 1, 3000}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceL2_KRK_parallel) {
+  OpTester test("ReduceL2");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)0);
+  std::vector<float> in_data(4 * 300 * 70);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)(i % 13) / 13.f - 0.25f;
+  test.AddInput<float>("data", {4, 300, 70}, in_data);
+  std::vector<float> expected(4 * 70);
+  for (size_t i = 0; i < 4; ++i) {
+    for (size_t k = 0; k < 70; ++k) {
+      float sum = 0;
+      for (size_t j = 0; j < 300; ++j) {
+        float v = in_data[(i * 300 + j) * 70 + k];
+        sum += v * v;
+      }
+      expected[i * 70 + k] = std::sqrt(sum);
+    }
+  }
+  test.AddOutput<float>("reduced", {4, 70}, expected);
+  test.Run();
+}
+
+TEST(ReductionOpTest, ReduceMax_RK_tall_parallel) {
+  // few output columns, the reduced rows are split across the threads
+  OpTester test("ReduceMax");
+  test.AddAttribute("axes", std::vector<int64_t>{0});
+  test.AddAttribute("keepdims", (int64_t)0);
+  std::vector<float> in_data(8192 * 8);
+  for (size_t i = 0; i < in_data.size(); ++i)
+    in_data[i] = (float)((i * 7919) % 65521);
+  test.AddInput<float>("data", {8192, 8}, in_data);
+  std::vector<float> expected(8, std::numeric_limits<float>::lowest());
+  for (size_t i = 0; i < 8192; ++i) {
+    for (size_t j = 0; j < 8; ++j) {
+      expected[j] = std::max(expected[j], in_data[i * 8 + j]);
+    }
+  }
+  test.AddOutput<float>("reduced", {8}, expected);
+  test.Run();
+}
+
 TEST(ReductionOpTest, ReduceSum_RKR_keepdims) {
   OpTester test("ReduceSum");
   test.AddAttribute("axes", std::vector<int64_t>{0, 2});
@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 #include <numeric>
 
 namespace onnxruntime {
@@ -313,6 +314,50 @@ TEST(SequenceOpsTest, SequenceEraseInvalidNegativeIdx) {
   test.Run(OpTester::ExpectResult::kExpectFailure, "Invalid sequence index");
 }
 
+// SequenceInsert -> SequenceInsert -> SequenceErase, the intermediate sequences being updated in place
+class SequenceChainTester : public OpTester {
+ public:
+  SequenceChainTester() : OpTester("SequenceInsert", 11) {}
+
+ protected:
+  void AddNodes(onnxruntime::Graph& graph,
+                std::vector<onnxruntime::NodeArg*>& graph_input_defs,
+                std::vector<onnxruntime::NodeArg*>& graph_output_defs,
+                std::vector<std::function<void(onnxruntime::Node& node)>>& /*add_attribute_funcs*/) override {
+    ASSERT_EQ(graph_input_defs.size(), 4u);
+    ASSERT_EQ(graph_output_defs.size(), 1u);
+
+    NodeArg* S = graph_input_defs[0];
+    NodeArg* X = graph_input_defs[1];
+    NodeArg* Y = graph_input_defs[2];
+    NodeArg* I = graph_input_defs[3];
+    auto& S1 = graph.GetOrCreateNodeArg("S1", S->TypeAsProto());
+    auto& S2 = graph.GetOrCreateNodeArg("S2", S->TypeAsProto());
+
+    graph.AddNode("insert_x", "SequenceInsert", "", {S, X}, {&S1});
+    graph.AddNode("insert_y", "SequenceInsert", "", {&S1, Y, I}, {&S2});
+    graph.AddNode("erase_last", "SequenceErase", "", {&S2}, {graph_output_defs[0]});
+  }
+};
+
+TEST(SequenceOpsTest, SequenceInsertEraseInPlace) {
+  SequenceChainTester test;
+  SeqTensors<int64_t> input;
+  input.AddTensor({3, 2}, {1, 2, 3, 4, 5, 6});
+  test.AddSeqInput("S", input);
+  test.AddInput<int64_t>("X", {2, 2}, {2, 4, 6, 8});
+  test.AddInput<int64_t>("Y", {1, 3}, {10, 20, 30});
+  test.AddInput<int64_t>("I", {}, {0});
+
+  SeqTensors<int64_t> output;
+  output.AddTensor({1, 3}, {10, 20, 30});
+  output.AddTensor({3, 2}, {1, 2, 3, 4, 5, 6});
+  test.AddSeqOutput("S3", output);
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 // SequenceConstruct
 TEST(SequenceOpsTest, SequenceConstructPositive) {
   OpTester test("SequenceConstruct", 11);
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -58,6 +59,42 @@ static void TestRadix2DFTFloat(bool onesided, int since_version) {
   test.Run();
 }
 
+// Batched real signals longer than the fixed radix-2 test, compared with a direct evaluation of the DFT.
+static void TestRadix2DFTBatchedRealFloat(bool onesided, bool inverse, int since_version) {
+  OpTester test("DFT", since_version);
+
+  constexpr int64_t batch_size = 3;
+  constexpr int64_t length = 64;
+  const int64_t output_length = onesided ? (length >> 1) + 1 : length;
+
+  RandomValueGenerator random(GetTestRandomSeed());
+  vector<float> input = random.Uniform<float>({batch_size, length}, -1.f, 1.f);
+  vector<float> expected_output;
+  constexpr double pi = 3.14159265358979323846;
+  const double direction = inverse ? 1.0 : -1.0;
+  const double scale = inverse ? 1.0 / length : 1.0;
+  for (int64_t b = 0; b < batch_size; b++) {
+    for (int64_t k = 0; k < output_length; k++) {
+      double real = 0.0;
+      double imaginary = 0.0;
+      for (int64_t n = 0; n < length; n++) {
+        const double angle = direction * 2.0 * pi * static_cast<double>(k * n) / length;
+        real += input[b * length + n] * std::cos(angle);
+        imaginary += input[b * length + n] * std::sin(angle);
+      }
+      expected_output.push_back(static_cast<float>(real * scale));
+      expected_output.push_back(static_cast<float>(imaginary * scale));
+    }
+  }
+
+  test.AddInput<float>("input", {batch_size, length, 1}, input);
+  test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+  test.AddAttribute<int64_t>("inverse", static_cast<int64_t>(inverse));
+  test.AddOutput<float>("output", {batch_size, output_length, 2}, expected_output);
+  test.SetOutputAbsErr("output", 0.0002f);
+  test.Run();
+}
+
 static void TestInverseFloat(int since_version) {
   OpTester test("DFT", since_version);
 
@@ -96,6 +133,18 @@ TEST(SignalOpsTest, DFT17_Float_radix2_onesided) { TestRadix2DFTFloat(true, kMin
 
 TEST(SignalOpsTest, DFT20_Float_radix2_onesided) { TestRadix2DFTFloat(true, kOpsetVersion20); }
 
+TEST(SignalOpsTest, DFT17_Float_radix2_batched_real) {
+  TestRadix2DFTBatchedRealFloat(false, false, kMinOpsetVersion);
+  TestRadix2DFTBatchedRealFloat(true, false, kMinOpsetVersion);
+  TestRadix2DFTBatchedRealFloat(false, true, kMinOpsetVersion);
+}
+
+TEST(SignalOpsTest, DFT20_Float_radix2_batched_real) {
+  TestRadix2DFTBatchedRealFloat(false, false, kOpsetVersion20);
+  TestRadix2DFTBatchedRealFloat(true, false, kOpsetVersion20);
+  TestRadix2DFTBatchedRealFloat(false, true, kOpsetVersion20);
+}
+
 TEST(SignalOpsTest, DFT17_Float_inverse) {
   TestInverseFloat(kMinOpsetVersion);
 }
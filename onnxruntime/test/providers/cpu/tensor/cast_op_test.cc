@@ -158,6 +158,28 @@ TEST(CastOpTest, NonStringTypes) {
       CastNonStringTester{});
 }
 
+TEST(CastOpTest, LargeFloatToFromFloat16Types) {
+  // large enough to be split over the thread pool and to use the vectorized conversion loops
+  const std::vector<int64_t> shape{3, 1001};
+  std::vector<float> float_data(3 * 1001);
+  for (size_t i = 0; i < float_data.size(); ++i) {
+    float_data[i] = static_cast<float>(static_cast<int>(i % 256) - 128) * 0.5f;
+  }
+  float_data[7] = -std::numeric_limits<float>::infinity();
+  float_data[11] = std::numeric_limits<float>::infinity();
+
+  const auto float16_data = CastedValues<float, MLFloat16>(gsl::make_span(float_data));
+  TestCastOp(gsl::make_span(float_data), gsl::make_span(float16_data), shape);
+  TestCastOp(gsl::make_span(float16_data), gsl::make_span(float_data), shape);
+
+  const auto bfloat16_data = CastedValues<float, BFloat16>(gsl::make_span(float_data));
+  TestCastOp(gsl::make_span(float_data), gsl::make_span(bfloat16_data), shape);
+  TestCastOp(gsl::make_span(bfloat16_data), gsl::make_span(float_data), shape);
+
+  const auto double_data = CastedValues<float, double>(gsl::make_span(float_data));
+  TestCastOp(gsl::make_span(float16_data), gsl::make_span(double_data), shape);
+}
+
 TEST(CastOpTest, FromString) {
   const std::vector<int64_t> shape{2, 2, 2};
   const std::vector<std::string> string_data = {"-inf", "+INF", "0.9767611", "0.28280696",
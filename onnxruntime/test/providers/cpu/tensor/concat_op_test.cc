@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 
 namespace onnxruntime {
 namespace test {
@@ -426,5 +427,39 @@ TEST(ConcatOpTest, Concat4D_2) {
   test.Run();
 }
 
+// Abs and Neg -> Concat. The allocation planner has Abs and Neg write their outputs in place in the output of Concat,
+// which then has nothing to copy.
+class ConcatOfNodeOutputsTester : public OpTester {
+ public:
+  ConcatOfNodeOutputsTester() : OpTester("Concat", 13) {}
+
+ protected:
+  void AddNodes(onnxruntime::Graph& graph,
+                std::vector<onnxruntime::NodeArg*>& graph_input_defs,
+                std::vector<onnxruntime::NodeArg*>& graph_output_defs,
+                std::vector<std::function<void(onnxruntime::Node& node)>>& /*add_attribute_funcs*/) override {
+    ASSERT_EQ(graph_input_defs.size(), 2u);
+    ASSERT_EQ(graph_output_defs.size(), 1u);
+
+    auto& abs_out = graph.GetOrCreateNodeArg("abs_out", graph_input_defs[0]->TypeAsProto());
+    auto& neg_out = graph.GetOrCreateNodeArg("neg_out", graph_input_defs[1]->TypeAsProto());
+
+    graph.AddNode("abs", "Abs", "", {graph_input_defs[0]}, {&abs_out});
+    graph.AddNode("neg", "Neg", "", {graph_input_defs[1]}, {&neg_out});
+    auto& concat = graph.AddNode("concat", "Concat", "", {&abs_out, &neg_out}, {graph_output_defs[0]});
+    concat.AddAttribute("axis", static_cast<int64_t>(1));
+  }
+};
+
+TEST(ConcatOpTest, ConcatOfNodeOutputsInPlace) {
+  ConcatOfNodeOutputsTester test;
+  test.AddInput<float>("input1", {1, 2, 2}, {-1.f, 2.f, -3.f, 4.f});
+  test.AddInput<float>("input2", {1, 1, 2}, {5.f, -6.f});
+  test.AddOutput<float>("concat_result", {1, 3, 2}, {1.f, 2.f, 3.f, 4.f, -5.f, 6.f});
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -430,6 +430,58 @@ TEST(GatherOpTest, Gather_axis1_scalar_indices) {
   run_test(false);
   run_test(true);
 }
+
+TEST(GatherOpTest, Gather_axis_last_elements) {
+  // the gathered axis is the innermost one so single elements are gathered
+  constexpr int64_t rows = 64, cols = 300, num_indices = 97;
+  std::vector<int32_t> data(rows * cols);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<int32_t>(i);
+  }
+  std::vector<int64_t> indices(num_indices);
+  for (int64_t i = 0; i < num_indices; ++i) {
+    indices[i] = (i * 37) % cols - (i % 2 == 0 ? cols : 0);
+  }
+  std::vector<int32_t> expected(rows * num_indices);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t i = 0; i < num_indices; ++i) {
+      int64_t idx = indices[i] < 0 ? indices[i] + cols : indices[i];
+      expected[r * num_indices + i] = data[r * cols + idx];
+    }
+  }
+
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 1LL);
+  test.AddInput<int32_t>("data", {rows, cols}, data);
+  test.AddInput<int64_t>("indices", {num_indices}, indices);
+  test.AddOutput<int32_t>("output", {rows, num_indices}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
+TEST(GatherOpTest, Gather_embedding_rows) {
+  // rows of a table gathered at random, large enough to be prefetched
+  constexpr int64_t vocab = 1000, dim = 64, num_indices = 333;
+  std::vector<float> data(vocab * dim);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i % 1013) * 0.5f;
+  }
+  std::vector<int32_t> indices(num_indices);
+  for (int64_t i = 0; i < num_indices; ++i) {
+    indices[i] = static_cast<int32_t>((i * 7919) % vocab);
+  }
+  std::vector<float> expected(num_indices * dim);
+  for (int64_t i = 0; i < num_indices; ++i) {
+    std::copy(data.begin() + indices[i] * dim, data.begin() + (indices[i] + 1) * dim, expected.begin() + i * dim);
+  }
+
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<float>("data", {vocab, dim}, data);
+  test.AddInput<int32_t>("indices", {num_indices}, indices);
+  test.AddOutput<float>("output", {num_indices, dim}, expected);
+  test.Run();
+}
+
 #ifdef ENABLE_TRAINING_OPS
 // Should remove the shrunken_gather include from ENABLE_TRAINING_OPS once 1). compute optimizer is enabled for inference or
 // 2). this is needed by inference for other purpose.
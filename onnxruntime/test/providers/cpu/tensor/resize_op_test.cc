@@ -1245,6 +1245,60 @@ TEST(ResizeOpTest, ResizeOpNearestUpSample_Nearest2xOptimization_Sizes) {
   run_test(true);
 }
 
+TEST(ResizeOpTest, ResizeOpNearestUpSample_IntegerFactors_half_pixel) {
+  OpTester test("Resize", 13);
+  std::vector<float> roi{};
+  std::vector<float> scales{1.0f, 1.0f, 2.0f, 3.0f};
+
+  test.AddAttribute("mode", "nearest");
+
+  constexpr int64_t N = 1, C = 1, H = 2, W = 2;
+  std::vector<float> X = {
+      1.0f, 2.0f,
+      3.0f, 4.0f};
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("scales", {4}, scales);
+
+  std::vector<float> Y = {1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f,
+                          1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f,
+                          3.0f, 3.0f, 3.0f, 4.0f, 4.0f, 4.0f,
+                          3.0f, 3.0f, 3.0f, 4.0f, 4.0f, 4.0f};
+
+  test.AddOutput<float>("Y", {N, C, H * 2, W * 3}, Y);
+  test.Run();
+}
+
+TEST(ResizeOpTest, NhwcResizeOpNearestUpSample_IntegerFactors_uint8) {
+  OpTester test("Resize", 13);
+  std::vector<float> roi{};
+  std::vector<float> scales{1.0f, 3.0f, 2.0f, 1.0f};
+
+  test.AddAttribute("mode", "nearest");
+  test.AddAttribute("coordinate_transformation_mode", "asymmetric");
+  test.AddAttribute("nearest_mode", "floor");
+
+  constexpr int64_t N = 1, H = 2, W = 2, C = 2;
+  std::vector<uint8_t> X = {
+      1, 2, 3, 4,
+      5, 6, 7, 8};
+
+  test.AddInput<uint8_t>("X", {N, H, W, C}, X);
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("scales", {4}, scales);
+
+  std::vector<uint8_t> Y = {1, 2, 1, 2, 3, 4, 3, 4,
+                            1, 2, 1, 2, 3, 4, 3, 4,
+                            1, 2, 1, 2, 3, 4, 3, 4,
+                            5, 6, 5, 6, 7, 8, 7, 8,
+                            5, 6, 5, 6, 7, 8, 7, 8,
+                            5, 6, 5, 6, 7, 8, 7, 8};
+
+  test.AddOutput<uint8_t>("Y", {N, H * 3, W * 2, C}, Y);
+  test.Run();
+}
+
 TEST(ResizeOpTest, ResizeOpCubicDownSampleTest) {
   OpTester test("Resize", 13);
   std::vector<float> scales{1.0f, 1.0f, 0.8f, 0.8f};
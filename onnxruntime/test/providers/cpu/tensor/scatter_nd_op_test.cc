@@ -235,5 +235,40 @@ TEST(ScatterNDOpTest, ScatterND_18_max) {
   test1.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
 }
 
+TEST(ScatterNDOpTest, ScatterND_18_add_duplicated_indices) {
+  // the same rows are updated several times, every update must be accumulated
+  constexpr int64_t rows = 16, cols = 512, num_updates = 200;
+  std::vector<float> data(rows * cols, 1.0f);
+  std::vector<int64_t> indices(num_updates);
+  std::vector<float> updates(num_updates * cols);
+  std::vector<float> expected(data);
+  for (int64_t i = 0; i < num_updates; ++i) {
+    indices[i] = (i * 5) % rows;
+    for (int64_t j = 0; j < cols; ++j) {
+      updates[i * cols + j] = static_cast<float>((i + j) % 7);
+      expected[indices[i] * cols + j] += updates[i * cols + j];
+    }
+  }
+
+  OpTester test("ScatterND", 18);
+  test.AddAttribute("reduction", "add");
+  test.AddInput<float>("data", {rows, cols}, data);
+  test.AddInput<int64_t>("indices", {num_updates, 1}, indices);
+  test.AddInput<float>("updates", {num_updates, cols}, updates);
+  test.AddOutput<float>("output", {rows, cols}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
+TEST(ScatterNDOpTest, ScatterND_invalid_indice) {
+  OpTester test("ScatterND", 13);
+  test.AddInput<float>("data", {4}, {0.0f, 0.0f, 0.0f, 0.0f});
+  test.AddInput<int64_t>("indices", {2, 1}, {1, 4});
+  test.AddInput<float>("updates", {2}, {1.0f, 2.0f});
+  test.AddOutput<float>("output", {4}, {0.0f, 1.0f, 0.0f, 2.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "invalid indice found, indice = 4",
+           {kTensorrtExecutionProvider, kOpenVINOExecutionProvider, kCudaExecutionProvider, kRocmExecutionProvider,
+            kDmlExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 #include "core/framework/to_tensor_proto_element_type.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 
 namespace onnxruntime {
 namespace test {
@@ -815,5 +816,40 @@ TEST(SplitOperatorTest, Split18_NumOutputsUnevenSplitAxis1) {
   RunTest<float>(axis, {}, input, outputs, {kTensorrtExecutionProvider, kQnnExecutionProvider}, false, true, num_outputs, false);
 }
 
+// Split -> Transpose of each output. In builds with strided tensors the outputs of Split are views of its input,
+// which Transpose copies from with their strides.
+class SplitTransposeTester : public OpTester {
+ public:
+  SplitTransposeTester() : OpTester("Split", 13) {}
+
+ protected:
+  void AddNodes(onnxruntime::Graph& graph,
+                std::vector<onnxruntime::NodeArg*>& graph_input_defs,
+                std::vector<onnxruntime::NodeArg*>& graph_output_defs,
+                std::vector<std::function<void(onnxruntime::Node& node)>>& /*add_attribute_funcs*/) override {
+    ASSERT_EQ(graph_input_defs.size(), 1u);
+    ASSERT_EQ(graph_output_defs.size(), 2u);
+
+    auto& Q = graph.GetOrCreateNodeArg("Q", graph_input_defs[0]->TypeAsProto());
+    auto& K = graph.GetOrCreateNodeArg("K", graph_input_defs[0]->TypeAsProto());
+
+    auto& split = graph.AddNode("split", "Split", "", {graph_input_defs[0]}, {&Q, &K});
+    split.AddAttribute("axis", static_cast<int64_t>(1));
+    graph.AddNode("transpose_q", "Transpose", "", {&Q}, {graph_output_defs[0]});
+    graph.AddNode("transpose_k", "Transpose", "", {&K}, {graph_output_defs[1]});
+  }
+};
+
+TEST(SplitOperatorTest, SplitOutputsAsStridedInputs) {
+  SplitTransposeTester test;
+  test.AddInput<float>("X", {2, 6}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f,
+                                     7.f, 8.f, 9.f, 10.f, 11.f, 12.f});
+  test.AddOutput<float>("QT", {3, 2}, {1.f, 7.f, 2.f, 8.f, 3.f, 9.f});
+  test.AddOutput<float>("KT", {3, 2}, {4.f, 10.f, 5.f, 11.f, 6.f, 12.f});
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -721,6 +721,56 @@ TEST(TransposeOpTest, DoTransposeEltWise) {
   }
 }
 
+template <typename T>
+static void TransposeNDimTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  const TensorShape shape(input_shape);
+  std::vector<T> input_vals(static_cast<size_t>(shape.Size()));
+  for (size_t i = 0; i < input_vals.size(); ++i) {
+    input_vals[i] = static_cast<T>(i % 127);
+  }
+
+  std::vector<int64_t> expected_shape(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    expected_shape[i] = input_shape[static_cast<size_t>(perm[i])];
+  }
+
+  // Compute the expected values by walking the output and indexing the input.
+  std::vector<T> expected_vals(input_vals.size());
+  std::vector<int64_t> index(rank, 0);
+  for (size_t i = 0; i < expected_vals.size(); ++i) {
+    int64_t offset = 0;
+    for (size_t axis = 0; axis < rank; ++axis) {
+      offset += index[axis] * shape.SizeFromDimension(static_cast<size_t>(perm[axis]) + 1);
+    }
+    expected_vals[i] = input_vals[static_cast<size_t>(offset)];
+    for (size_t axis = rank; axis-- > 0;) {
+      if (++index[axis] < expected_shape[axis]) {
+        break;
+      }
+      index[axis] = 0;
+    }
+  }
+
+  TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals);
+}
+
+// Exercises the blocked transpose with permutations that aren't handled by the single axis paths.
+TEST(TransposeOpTest, BlockedNDim) {
+  // The innermost axis is preserved: block copies.
+  TransposeNDimTest<float>({3, 5, 7, 9}, {2, 1, 0, 3});
+  TransposeNDimTest<int64_t>({4, 3, 2, 5, 6}, {3, 1, 4, 0, 2});
+  // 2D transposes of the innermost axes, with partial tiles.
+  TransposeNDimTest<float>({2, 70, 3, 130}, {2, 3, 0, 1});
+  TransposeNDimTest<float>({3, 67, 5, 66}, {0, 3, 2, 1});
+  TransposeNDimTest<uint8_t>({2, 65, 3, 71}, {3, 0, 2, 1});
+  TransposeNDimTest<int16_t>({5, 3, 70, 2, 9}, {4, 2, 0, 3, 1});
+  TransposeNDimTest<int64_t>({2, 66, 3, 65}, {3, 2, 0, 1});
+  // Axes of size 1 and adjacent axes are simplified away.
+  TransposeNDimTest<float>({2, 1, 3, 4, 1, 5}, {5, 0, 4, 2, 3, 1});
+  TransposeNDimTest<int32_t>({6, 4, 3, 8, 2}, {3, 4, 0, 1, 2});
+}
+
 #if USE_CUDA
 constexpr const char* kGpuExecutionProvider = kCudaExecutionProvider;
 #elif USE_ROCM
@@ -1,12 +1,16 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <vector>
+
 #include "core/framework/allocator_utils.h"
 #include "gtest/gtest.h"
 #include "cuda_runtime.h"
 #include "core/framework/allocator.h"
+#include "core/framework/stream_handles.h"
 #include "core/providers/cuda/cuda_allocator.h"
 #include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/cuda_weight_offload.h"
 
 namespace onnxruntime {
 namespace test {
@@ -113,5 +117,88 @@ TEST(AllocatorTest, CUDAAllocatorFallbackTest) {
   auto last_error = cudaGetLastError();
   EXPECT_EQ(last_error, cudaSuccess) << "Last error should be cleared if handled gracefully";
 }
+
+TEST(AllocatorTest, CUDAMemPoolAllocatorTest) {
+  OrtDevice::DeviceId cuda_device_id = 0;
+  CUDA_CALL_THROW(cudaSetDevice(cuda_device_id));
+
+  AllocatorCreationInfo mem_pool_info(
+      [](OrtDevice::DeviceId id) { return std::make_unique<CUDAMemPoolAllocator>(id, CUDA, 0); },
+      cuda_device_id, false);
+  auto allocator = CreateAllocator(mem_pool_info);
+  EXPECT_EQ(allocator->Info().alloc_type, OrtDeviceAllocator);
+  EXPECT_TRUE(allocator->IsStreamOrdered());
+
+  cudaStream_t cuda_stream;
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&cuda_stream, cudaStreamNonBlocking));
+  Stream stream(cuda_stream, allocator->Info().device);
+
+  constexpr size_t size = 1024;
+  void* cuda_addr = allocator->AllocStreamOrdered(size, &stream);
+  EXPECT_TRUE(cuda_addr);
+  CUDA_CALL_THROW(cudaMemsetAsync(cuda_addr, -1, size, cuda_stream));
+
+  std::vector<int> cpu_data(size / sizeof(int));
+  CUDA_CALL_THROW(cudaMemcpyAsync(cpu_data.data(), cuda_addr, size, cudaMemcpyDeviceToHost, cuda_stream));
+  CUDA_CALL_THROW(cudaStreamSynchronize(cuda_stream));
+  EXPECT_EQ(cpu_data[0], -1);
+
+  // freed on the stream, then reused for a later allocation on it
+  allocator->Free(cuda_addr);
+  void* reused_addr = allocator->AllocStreamOrdered(size, &stream);
+  EXPECT_TRUE(reused_addr);
+
+  // once the stream is released, the memory is no longer ordered with it
+  CUDA_CALL_THROW(cudaStreamSynchronize(cuda_stream));
+  allocator->ReleaseStreamOrderedBuffers(&stream);
+  allocator->Free(reused_addr);
+
+  void* plain_addr = allocator->Alloc(size);
+  EXPECT_TRUE(plain_addr);
+  allocator->Free(plain_addr);
+
+  CUDA_CALL_THROW(cudaStreamDestroy(cuda_stream));
+  EXPECT_EQ(cudaGetLastError(), cudaSuccess);
+}
+
+TEST(AllocatorTest, CUDAAllocatorWeightOffloadTest) {
+  OrtDevice::DeviceId cuda_device_id = 0;
+  CUDA_CALL_THROW(cudaSetDevice(cuda_device_id));
+  int managed_memory = 0;
+  CUDA_CALL_THROW(cudaDeviceGetAttribute(&managed_memory, cudaDevAttrConcurrentManagedAccess, cuda_device_id));
+  if (managed_memory == 0) {
+    GTEST_SKIP() << "The device does not support concurrent managed memory access";
+  }
+
+  constexpr size_t min_bytes = 1 << 20;
+  auto weight_offload = std::make_shared<CudaWeightOffload>(cuda_device_id, min_bytes, 4 * min_bytes);
+  AllocatorCreationInfo default_memory_info(
+      [weight_offload](OrtDevice::DeviceId id) { return std::make_unique<CUDAAllocator>(id, CUDA, weight_offload); },
+      cuda_device_id);
+  auto allocator = CreateAllocator(default_memory_info);
+
+  // static buffers of at least min_bytes are in managed memory, the others in device memory
+  void* weights = allocator->Reserve(2 * min_bytes);
+  void* small_weights = allocator->Reserve(min_bytes / 2);
+  void* activations = allocator->Alloc(2 * min_bytes);
+
+  cudaPointerAttributes attributes;
+  CUDA_CALL_THROW(cudaPointerGetAttributes(&attributes, weights));
+  EXPECT_EQ(attributes.type, cudaMemoryTypeManaged);
+  CUDA_CALL_THROW(cudaPointerGetAttributes(&attributes, small_weights));
+  EXPECT_EQ(attributes.type, cudaMemoryTypeDevice);
+  CUDA_CALL_THROW(cudaPointerGetAttributes(&attributes, activations));
+  EXPECT_EQ(attributes.type, cudaMemoryTypeDevice);
+
+  // managed memory is usable on the device whether or not it was prefetched
+  CUDA_CALL_THROW(cudaMemset(weights, -1, 2 * min_bytes));
+  CUDA_CALL_THROW(cudaDeviceSynchronize());
+  EXPECT_EQ(static_cast<int*>(weights)[0], -1);
+
+  allocator->Free(activations);
+  allocator->Free(small_weights);
+  allocator->Free(weights);
+  EXPECT_EQ(cudaGetLastError(), cudaSuccess);
+}
 }  // namespace test
 }  // namespace onnxruntime
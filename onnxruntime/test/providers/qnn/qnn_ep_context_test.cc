@@ -732,6 +732,114 @@ TEST_F(QnnHTPBackendTests, QnnContextBinaryCache_SingleNodeNameNotMatchGraphName
   ASSERT_EQ(std::remove(context_bin.string().c_str()), 0);
 }
 
+// Create a model with only the EPContext node node_name of ctx_graph, which references the context binary file
+// context_bin_name.
+static std::string CreateQnnCtxModelWithSingleNode(const Graph& ctx_graph, const std::string& node_name,
+                                                   const std::string& context_bin_name) {
+  const std::unordered_map<std::string, int> domain_to_version = {{"", 13}, {kMSDomain, 1}};
+  auto& logging_manager = DefaultLoggingManager();
+  onnxruntime::Model model("QNN_ctx_model", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), domain_to_version, {},
+                           logging_manager.DefaultLogger());
+  Graph& graph = model.MainGraph();
+  for (const auto& node : ctx_graph.Nodes()) {
+    if (node.Name() != node_name) {
+      continue;
+    }
+    std::vector<NodeArg*> inputs;
+    std::vector<NodeArg*> outputs;
+    for (const auto* input : node.InputDefs()) {
+      inputs.push_back(&graph.GetOrCreateNodeArg(input->Name(), input->TypeAsProto()));
+    }
+    for (const auto* output : node.OutputDefs()) {
+      outputs.push_back(&graph.GetOrCreateNodeArg(output->Name(), output->TypeAsProto()));
+    }
+    Node& ep_context_node = graph.AddNode(node.Name(), node.OpType(), "", inputs, outputs, &node.GetAttributes(),
+                                          node.Domain());
+    ep_context_node.AddAttribute("main_context", static_cast<int64_t>(1));
+    ep_context_node.AddAttribute("ep_cache_context", context_bin_name);
+  }
+  EXPECT_STATUS_OK(graph.Resolve());
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  return model_data;
+}
+
+// Generate a context binary with 2 QNN graphs, split its EP context model into 2 models with 1 EPContext node each,
+// like the encoder and decoder of a model, and create a session from each of them with ep.share_ep_contexts enabled.
+// The 2nd session uses the graph loaded by the 1st one.
+TEST_F(QnnHTPBackendTests, QnnContextBinaryShareEpContexts) {
+  ProviderOptions provider_options;
+#if defined(_WIN32)
+  provider_options["backend_path"] = "QnnHtp.dll";
+#else
+  provider_options["backend_path"] = "libQnnHtp.so";
+#endif
+
+  const std::unordered_map<std::string, int> domain_to_version = {{"", 13}, {kMSDomain, 1}};
+
+  auto& logging_manager = DefaultLoggingManager();
+  logging_manager.SetDefaultLoggerSeverity(logging::Severity::kERROR);
+
+  onnxruntime::Model model("QNN_EP_TestModel", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), domain_to_version, {},
+                           logging_manager.DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ModelTestBuilder helper(graph);
+  BuildGraphWithQAndNonQ(false)(helper);
+  helper.SetGraphOutputs();
+  ASSERT_STATUS_OK(model.MainGraph().Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+
+  const std::string context_binary_file = "./qnn_context_binary_share_ep_contexts_test.onnx";
+  std::remove(context_binary_file.c_str());
+  Ort::SessionOptions so;
+  so.AddConfigEntry(kOrtSessionOptionEpContextEnable, "1");
+  so.AddConfigEntry(kOrtSessionOptionEpContextFilePath, context_binary_file.c_str());
+  so.AddConfigEntry(kOrtSessionOptionEpContextEmbedMode, "0");
+  so.AppendExecutionProvider("QNN", provider_options);
+
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), so);
+  EXPECT_TRUE(std::filesystem::exists(context_binary_file.c_str()));
+
+  std::shared_ptr<Model> ctx_model;
+  ASSERT_STATUS_OK(Model::Load(ToPathString(context_binary_file), ctx_model, nullptr,
+                               DefaultLoggingManager().DefaultLogger()));
+  std::vector<std::string> ep_context_node_names;
+  std::string context_bin_name;
+  for (auto& node : ctx_model->MainGraph().Nodes()) {
+    if (node.OpType() == "EPContext") {
+      ep_context_node_names.push_back(node.Name());
+      auto attr = node.GetAttributes().find("ep_cache_context");
+      if (attr != node.GetAttributes().end()) {
+        context_bin_name = attr->second.s();
+      }
+    }
+  }
+  ASSERT_EQ(ep_context_node_names.size(), 2);
+  ASSERT_FALSE(context_bin_name.empty());
+
+  Ort::SessionOptions so2;
+  // context file path is required if it's non-embed mode and the model is loaded from memory
+  so2.AddConfigEntry(kOrtSessionOptionEpContextFilePath, context_binary_file.c_str());
+  so2.AddConfigEntry(kOrtSessionOptionShareEpContexts, "1");
+  so2.AppendExecutionProvider("QNN", provider_options);
+
+  std::string ctx_model_data1 = CreateQnnCtxModelWithSingleNode(ctx_model->MainGraph(), ep_context_node_names[0],
+                                                                context_bin_name);
+  std::string ctx_model_data2 = CreateQnnCtxModelWithSingleNode(ctx_model->MainGraph(), ep_context_node_names[1],
+                                                                context_bin_name);
+  Ort::Session session1(*ort_env, ctx_model_data1.data(), ctx_model_data1.size(), so2);
+  Ort::Session session2(*ort_env, ctx_model_data2.data(), ctx_model_data2.size(), so2);
+
+  // clean up
+  ASSERT_EQ(std::remove(context_binary_file.c_str()), 0);
+  ASSERT_EQ(std::remove(context_bin_name.c_str()), 0);
+}
+
 #endif  // defined(__aarch64__) || defined(_M_ARM64) || defined(__linux__)
 
 }  // namespace test
@@ -379,6 +379,46 @@ TEST(XnnpackEP, TestSoftMax_axisLast) {
                {ExpectedEPNodeAssignment::All});
 }
 
+TEST(XnnpackEP, TestBinaryElementwise_broadcast) {
+  for (const char* op_type : {"Add", "Sub", "Mul", "Div"}) {
+    auto modelCreater = [op_type](ModelTestBuilder& builder) {
+      auto* input_a = builder.MakeInput<float>({1, 2, 3, 5}, 1.f, 10.f);
+      auto* input_b = builder.MakeInput<float>({3, 1}, 1.f, 10.f);
+      auto* output_arg = builder.MakeOutput();
+      builder.AddNode(op_type, {input_a, input_b}, {output_arg});
+    };
+    RunModelTest(modelCreater,
+                 "xnnpack_test_graph_binary_elementwise",
+                 {ExpectedEPNodeAssignment::All});
+  }
+}
+
+TEST(XnnpackEP, TestTranspose) {
+  auto modelCreater = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({1, 2, 3, 5}, -10.f, 10.f);
+    auto* output_arg = builder.MakeOutput();
+    Node& transpose_node = builder.AddNode("Transpose", {input_arg}, {output_arg});
+    transpose_node.AddAttribute("perm", std::vector<int64_t>{0, 2, 3, 1});
+  };
+  RunModelTest(modelCreater,
+               "xnnpack_test_graph_transpose",
+               {ExpectedEPNodeAssignment::All});
+}
+
+TEST(XnnpackEP, TestConcat) {
+  auto modelCreater = [](ModelTestBuilder& builder) {
+    auto* input_a = builder.MakeInput<float>({2, 3, 4}, -10.f, 10.f);
+    auto* input_b = builder.MakeInput<float>({2, 1, 4}, -10.f, 10.f);
+    auto* input_c = builder.MakeInput<float>({2, 2, 4}, -10.f, 10.f);
+    auto* output_arg = builder.MakeOutput();
+    Node& concat_node = builder.AddNode("Concat", {input_a, input_b, input_c}, {output_arg});
+    concat_node.AddAttribute("axis", static_cast<int64_t>(1));
+  };
+  RunModelTest(modelCreater,
+               "xnnpack_test_graph_concat",
+               {ExpectedEPNodeAssignment::All});
+}
+
 TEST(XnnpackEP, TestQDQSoftMax_axisLast) {
   RunModelTest(BuildQDQSoftMaxTestCase<uint8_t, uint8_t>(
                    {1, 2, 3, 5} /* input_shape */,
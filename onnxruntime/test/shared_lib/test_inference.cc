@@ -2539,6 +2539,43 @@ TEST(CApiTest, basic_cuda_graph_with_annotation) {
   RunWithCudaGraphAnnotation(cg_data_2, session, info_mem, input_data, output_data, "2");
 #endif
 }
+
+#if defined(USE_CUDA)
+// The graphs are keyed by the shapes and buffers of the inputs and outputs instead of annotation ids.
+TEST(CApiTest, cuda_graph_with_auto_annotation) {
+  const auto& api = Ort::GetApi();
+  Ort::SessionOptions session_options;
+  session_options.AddConfigEntry(kOrtSessionOptionsConfigGraphCaptureAutoAnnotation, "1");
+
+  OrtCUDAProviderOptionsV2* cuda_options = nullptr;
+  ASSERT_TRUE(api.CreateCUDAProviderOptions(&cuda_options) == nullptr);
+  std::unique_ptr<OrtCUDAProviderOptionsV2, decltype(api.ReleaseCUDAProviderOptions)>
+      rel_cuda_options(cuda_options, api.ReleaseCUDAProviderOptions);
+  std::vector<const char*> keys{"enable_cuda_graph"};
+  std::vector<const char*> values{"1"};
+  ASSERT_TRUE(api.UpdateCUDAProviderOptions(rel_cuda_options.get(), keys.data(), values.data(), 1) == nullptr);
+
+  ASSERT_TRUE(api.SessionOptionsAppendExecutionProvider_CUDA_V2(
+                  static_cast<OrtSessionOptions*>(session_options),
+                  rel_cuda_options.get()) == nullptr);
+  Ort::MemoryInfo info_mem("Cuda", OrtAllocatorType::OrtArenaAllocator, 0, OrtMemTypeDefault);
+
+  Ort::Session session(*ort_env, CUDA_GRAPH_ANNOTATION_MODEL_URI, session_options);
+
+  Ort::Allocator allocator(session, info_mem);
+  auto input_data = allocator.GetAllocation(6 * sizeof(float));
+  auto output_data = allocator.GetAllocation(6 * sizeof(float));
+  ASSERT_NE(input_data.get(), nullptr);
+  ASSERT_NE(output_data.get(), nullptr);
+
+  RunWithCudaGraphAnnotation(cg_data_0, session, info_mem, input_data, output_data, nullptr);
+  RunWithCudaGraphAnnotation(cg_data_1, session, info_mem, input_data, output_data, nullptr);
+  RunWithCudaGraphAnnotation(cg_data_2, session, info_mem, input_data, output_data, nullptr);
+
+  // The graphs captured for the first shapes are replayed.
+  RunWithCudaGraphAnnotation(cg_data_0, session, info_mem, input_data, output_data, nullptr);
+}
+#endif
 #endif
 
 // The following test uses some ops not supported in the reduced ops build
@@ -10,12 +10,16 @@
 
 #include <iostream>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 namespace {
 OrtEnv* g_env;
 OrtErrorCode g_last_error_code;
 std::string g_last_error_message;
+// WebGPU allocators of the sessions, created by the first OrtCreateGpuTensor() call of a session. The tensors
+// allocated by one refer to it, so it is released with its session.
+std::unordered_map<OrtSession*, OrtAllocator*> g_gpu_allocators;
 }  // namespace
 
 enum DataLocation {
@@ -196,6 +200,11 @@ OrtSession* OrtCreateSession(void* data, size_t data_length, OrtSessionOptions*
 }
 
 void OrtReleaseSession(OrtSession* session) {
+  auto it = g_gpu_allocators.find(session);
+  if (it != g_gpu_allocators.end()) {
+    Ort::GetApi().ReleaseAllocator(it->second);
+    g_gpu_allocators.erase(it);
+  }
   Ort::GetApi().ReleaseSession(session);
 }
 
@@ -280,6 +289,35 @@ OrtValue* OrtCreateTensor(int data_type, void* data, size_t data_length, size_t*
   }
 }
 
+OrtValue* OrtCreateGpuTensor(OrtSession* session, int data_type, size_t* dims, size_t dims_length) {
+  if (data_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
+    CheckStatus(Ort::GetApi().CreateStatus(ORT_INVALID_ARGUMENT, "String tensors cannot be allocated on the GPU."));
+    return nullptr;
+  }
+
+  OrtAllocator*& allocator = g_gpu_allocators[session];
+  if (allocator == nullptr) {
+    OrtMemoryInfo* memory_info = nullptr;
+    RETURN_NULLPTR_IF_ERROR(CreateMemoryInfo, "WebGPU_Buffer", OrtDeviceAllocator, 0, OrtMemTypeDefault, &memory_info);
+    REGISTER_AUTO_RELEASE_HANDLE(MemoryInfo, memory_info);
+    if (CHECK_STATUS(CreateAllocator, session, memory_info, &allocator) != ORT_OK) {
+      g_gpu_allocators.erase(session);
+      return nullptr;
+    }
+  }
+
+  std::vector<int64_t> shapes(dims_length);
+  for (size_t i = 0; i < dims_length; i++) {
+    shapes[i] = dims[i];
+  }
+
+  OrtValue* value = nullptr;
+  int error_code = CHECK_STATUS(CreateTensorAsOrtValue, allocator,
+                                dims_length > 0 ? shapes.data() : nullptr, dims_length,
+                                static_cast<ONNXTensorElementDataType>(data_type), &value);
+  return (error_code == ORT_OK) ? value : nullptr;
+}
+
 int OrtGetTensorData(OrtValue* tensor, int* data_type, void** data, size_t** dims, size_t* dims_length) {
   ONNXType tensor_type;
   RETURN_ERROR_CODE_IF_ERROR(GetValueType, tensor, &tensor_type);
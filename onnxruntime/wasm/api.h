@@ -172,6 +172,21 @@ void EMSCRIPTEN_KEEPALIVE OrtFree(void* ptr);
  */
 ort_tensor_handle_t EMSCRIPTEN_KEEPALIVE OrtCreateTensor(int data_type, void* data, size_t data_length, size_t* dims, size_t dims_length, int data_location);
 
+/**
+ * create an instance of ORT tensor whose data is allocated on the GPU by the WebGPU EP of the specified session.
+ * Unlike the tensors created by OrtCreateTensor() with the GPU buffer location, the buffer is owned by the tensor. The
+ * tensor can be bound as an input and as an output of consecutive runs of the session, so a generation loop can
+ * keep its past/present key and value tensors on the GPU instead of reading them back after every run.
+ * @param session handle of the session. The tensor must be released before the session.
+ * @param data_type data type defined in enum ONNXTensorElementDataType. String tensors are not supported.
+ * @param dims a pointer to an array of dims. the array should contain (dims_length) element(s).
+ * @param dims_length the length of the tensor's dimension
+ * @remarks the data of the tensor is not initialized.
+ * @returns a tensor handle. Caller must release it after use by calling OrtReleaseTensor().
+ */
+ort_tensor_handle_t EMSCRIPTEN_KEEPALIVE OrtCreateGpuTensor(ort_session_handle_t session, int data_type,
+                                                            size_t* dims, size_t dims_length);
+
 /**
  * get type, shape info and data of the specified tensor.
  * @param tensor handle of the tensor.
@@ -1718,6 +1718,46 @@ void RegisterTrainingOpSchemas() {
         }
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(InPlaceGemmAccumulator)
+      .SetDomain(kMSDomain)
+      .SinceVersion(1)
+      .SetDoc(
+          "InPlaceAccumulatorV2 of the product of two matrices, computing "
+          "accumulation_buffer = alpha * A' * B' + accumulation_buffer, where A' is A or its transpose when transA "
+          "is set and B' is B or its transpose when transB is set. The product is accumulated into the buffer by the "
+          "GEMM, instead of being materialized as a gradient tensor and added in a separate pass. "
+          "When `overwrite_flag` is true the buffer is overwritten with the product instead.")
+      .Attr("transA", "Whether A should be transposed", AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("transB", "Whether B should be transposed", AttributeProto::INT, static_cast<int64_t>(0))
+      .Attr("alpha", "Scalar multiplier for the product of A and B.", AttributeProto::FLOAT, 1.0f)
+      .Input(0, "accumulation_buffer", "historical result of accumulator, of shape (M, N)", "T")
+      .Input(1, "A", "Input tensor A of shape (M, K), or (K, M) if transA is set", "T")
+      .Input(2, "B", "Input tensor B of shape (K, N), or (N, K) if transB is set", "T")
+      .Input(3, "overwrite_flag", "Indicates if tensor should be overwritten. Default is accumulation",
+             "T_BOOL", OpSchema::Optional)
+      .Output(0, "updated_flag", "Whether the update was completed", "T_BOOL")
+      .Output(1, "accumulation_buffer_out", "updated result of accumulator", "T", OpSchema::Optional)
+      .TypeConstraint(
+          "T",
+          {"tensor(float)"},
+          "Constrain input and output types to float tensors.")
+      .TypeConstraint(
+          "T_BOOL",
+          {"tensor(bool)"},
+          "Constrain types to boolean tensors.")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::BOOL);
+        ONNX_NAMESPACE::TensorShapeProto updated_shape;
+        updated_shape.add_dim()->set_dim_value(1);
+        updateOutputShape(ctx, 0, updated_shape);
+        if (ctx.getNumOutputs() == 2) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 1);
+          if (hasNInputShapes(ctx, 1)) {
+            propagateShapeFromInputToOutput(ctx, 0, 1);
+          }
+        }
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(ZeroGradient)
       .SetDomain(kMSDomain)
       .SinceVersion(1)
@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/core/optimizer/gemm_accumulator_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsFloatMatrix(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  return type != nullptr && type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+         shape != nullptr && shape->dim_size() == 2;
+}
+
+bool HasSameShape(const ONNX_NAMESPACE::TensorShapeProto& shape0, const ONNX_NAMESPACE::TensorShapeProto& shape1) {
+  if (shape0.dim_size() != shape1.dim_size()) {
+    return false;
+  }
+  for (int i = 0; i < shape0.dim_size(); ++i) {
+    if (shape0.dim(i) != shape1.dim(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Reads the transA, transB and alpha attributes of a supported GEMM node. Returns false if the node is not a GEMM
+// which can be expressed by InPlaceGemmAccumulator.
+bool GetGemmAttributes(const Node& node, int64_t& trans_a, int64_t& trans_b, float& alpha) {
+  trans_a = 0;
+  trans_b = 0;
+  alpha = 1.0f;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13})) {
+    return true;
+  }
+
+  const bool is_gemm = graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gemm", {7, 9, 11, 13});
+  const bool is_fused_matmul = graph_utils::IsSupportedOptypeVersionAndDomain(node, "FusedMatMul", {1}, kMSDomain);
+  if (!is_gemm && !is_fused_matmul) {
+    return false;
+  }
+
+  // the bias of Gemm would have to be accumulated as well
+  const auto& input_defs = node.InputDefs();
+  if (is_gemm && input_defs.size() > 2 && input_defs[2]->Exists()) {
+    return false;
+  }
+
+  const auto& attributes = node.GetAttributes();
+  for (const char* batch_attr : {"transBatchA", "transBatchB"}) {
+    auto it = attributes.find(batch_attr);
+    if (it != attributes.end() && it->second.i() != 0) {
+      return false;
+    }
+  }
+
+  auto it = attributes.find("transA");
+  if (it != attributes.end()) trans_a = it->second.i();
+  it = attributes.find("transB");
+  if (it != attributes.end()) trans_b = it->second.i();
+  it = attributes.find("alpha");
+  if (it != attributes.end()) alpha = it->second.f();
+  return true;
+}
+
+}  // namespace
+
+Status GemmAccumulatorFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                        const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr) continue;  // Node was removed.
+
+    auto& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "InPlaceAccumulatorV2", {1}, kMSDomain) ||
+        !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const Node* p_gemm = graph_utils::GetInputNode(node, 1);
+    int64_t trans_a;
+    int64_t trans_b;
+    float alpha;
+    if (p_gemm == nullptr || p_gemm->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+        !GetGemmAttributes(*p_gemm, trans_a, trans_b, alpha) ||
+        !optimizer_utils::CheckOutputEdges(graph, *p_gemm, 1)) {
+      continue;
+    }
+
+    auto& accumulator_inputs = node.MutableInputDefs();
+    const auto& gemm_inputs = p_gemm->InputDefs();
+    const NodeArg& buffer_def = *accumulator_inputs[0];
+    const NodeArg& gradient_def = *accumulator_inputs[1];
+    if (!IsFloatMatrix(*gemm_inputs[0]) || !IsFloatMatrix(*gemm_inputs[1]) || !IsFloatMatrix(gradient_def) ||
+        buffer_def.Shape() == nullptr || !HasSameShape(*buffer_def.Shape(), *gradient_def.Shape())) {
+      continue;
+    }
+
+    InlinedVector<NodeArg*> new_node_inputs{accumulator_inputs[0],
+                                            const_cast<NodeArg*>(gemm_inputs[0]),
+                                            const_cast<NodeArg*>(gemm_inputs[1])};
+    if (accumulator_inputs.size() > 2 && accumulator_inputs[2]->Exists()) {
+      new_node_inputs.emplace_back(accumulator_inputs[2]);
+    }
+
+    Node& new_node = graph.AddNode(graph.GenerateNodeName("InPlaceGemmAccumulator"),
+                                   "InPlaceGemmAccumulator", "fused GEMM and InPlaceAccumulatorV2",
+                                   new_node_inputs, node.MutableOutputDefs(), nullptr, kMSDomain);
+    new_node.AddAttribute("transA", trans_a);
+    new_node.AddAttribute("transB", trans_b);
+    new_node.AddAttribute("alpha", alpha);
+    new_node.SetExecutionProviderType(node.GetExecutionProviderType());
+
+    const NodeIndex gemm_index = p_gemm->Index();
+    graph_utils::RemoveNodeOutputEdges(graph, node);
+    graph.RemoveNode(node.Index());
+    graph_utils::RemoveNodeOutputEdges(graph, *graph.GetNode(gemm_index));
+    graph.RemoveNode(gemm_index);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GemmAccumulatorFusion
+Fuse MatMul/Gemm/FusedMatMul + InPlaceAccumulatorV2 to InPlaceGemmAccumulator, so that the gradient of a weight is
+accumulated into its persistent gradient buffer by the GEMM (beta = 1) instead of being materialized as a temporary
+tensor and added to the buffer afterwards.
+The GEMM must have 2D inputs, no bias, and its output must only be consumed by the accumulator.
+*/
+class GemmAccumulatorFusion : public GraphTransformer {
+ public:
+  explicit GemmAccumulatorFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GemmAccumulatorFusion", compatible_execution_providers) {
+  }
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
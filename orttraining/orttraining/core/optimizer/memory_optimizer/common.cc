@@ -102,6 +102,8 @@ std::string OptimizationTypeToString(OptimizationType type) {
       return "Recompute";
     case OptimizationType::RecomputeWithCompromise:
       return "RecomputeWithCompromise";
+    case OptimizationType::Offload:
+      return "Offload";
     default:
       ORT_THROW("Unknown optimization type.");
   }
@@ -38,7 +38,8 @@ enum class OptimizationType {
   None = 0,  // Disabled.
   Recompute = 1,
   RecomputeWithCompromise = 2,
-  TypeMax = 3,
+  Offload = 3,  // Copy to host memory in forward, and prefetch back to device for backward.
+  TypeMax = 4,
 };
 
 std::string OptimizationTypeToString(OptimizationType type);
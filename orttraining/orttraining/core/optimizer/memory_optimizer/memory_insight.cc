@@ -264,6 +264,11 @@ Status FindORTModuleMemoryOpportunity(const GraphViewer& graph_viewer,
         memory_opt_planner.AddNodeOptimizationPlan(p_node, std::move(recompute_with_compromise_plan));
       }
     }
+
+    std::unique_ptr<NodeOffloadPlan> offload_plan = CheckNodeForOffload(*p_node, candidate_output_args_map);
+    if (offload_plan != nullptr) {
+      memory_opt_planner.AddNodeOptimizationPlan(p_node, std::move(offload_plan));
+    }
   }
 
   return Status::OK();
@@ -315,6 +320,8 @@ void GetMemoryRecordsGroupedByNodeClusterId(const MemoryOptimizationPlanner& mem
             dynamic_cast<NodeRecomputePlan*>(plan.get())->GetNodesInTopoOrderStr();
       } else if (plan->GetOptimizationType() == OptimizationType::Recompute) {
         record.recompute_subgraph_str = dynamic_cast<NodeRecomputePlan*>(plan.get())->GetNodesInTopoOrderStr();
+      } else if (plan->GetOptimizationType() == OptimizationType::Offload) {
+        record.offload_cluster_id = plan->GetClusterId();
       }
 
       gsl::span<const size_t> output_indices = plan->GetActivationOutputIndices();
@@ -340,6 +347,11 @@ void GetMemoryRecordsGroupedByNodeClusterId(const MemoryOptimizationPlanner& mem
                                                  plan->GetActivationOutputDimParamString(output_index),
                                                  byte_count_per_element,
                                                  plan->GetSaveRatio());
+        } else if (plan->GetOptimizationType() == OptimizationType::Offload) {
+          record.offloaded_outputs.emplace_back(output_index,
+                                                plan->GetActivationOutputDimParamString(output_index),
+                                                byte_count_per_element,
+                                                plan->GetSaveRatio());
         }
       }
     }
@@ -386,6 +398,9 @@ void GetMemoryRecordsGroupedByNodeClusterId(const MemoryOptimizationPlanner& mem
         node_cluster_id_to_record_map[node_cluster_id]->actual_recompute_with_compromise_count += 1;
         node_cluster_id_to_record_map[node_cluster_id]->request_recompute_with_compromise_count =
             apply_context->requested_count;
+      } else if (apply_context->type == OptimizationType::Offload) {
+        node_cluster_id_to_record_map[node_cluster_id]->actual_offload_count += 1;
+        node_cluster_id_to_record_map[node_cluster_id]->request_offload_count = apply_context->requested_count;
       } else {
         ORT_THROW("Unsupported optimization type found.");
       }
@@ -654,6 +669,37 @@ void FormatRecomputeMemoryRecords(int option_index,
                    "% saved");
   }
 }
+
+void FormatOffloadMemoryRecords(int option_index,
+                                const MemoryRecord& record,
+                                InlinedVector<std::string>& rows) {
+  const std::string empty_first_col = "|" + ToFixedLengthString(std::string(), kFirstColumnWidth) + "|";
+
+  rows.push_back(empty_first_col);
+  rows.push_back(empty_first_col +
+                 ToFixedLengthString(">>Option " + std::to_string(option_index), kTitleWidthInSecondColumn) + ": " +
+                 OptimizationTypeToString(OptimizationType::Offload) + " " + record.offload_cluster_id);
+
+  if (record.request_offload_count) {
+    rows.push_back(
+        empty_first_col +
+        ToFixedLengthString("  Status", kTitleWidthInSecondColumn) + ": " + "Enabled, requested count=" +
+        std::to_string(record.request_offload_count) +
+        ", actual applied count=" + std::to_string(record.actual_offload_count));
+  } else {
+    rows.push_back(empty_first_col + ToFixedLengthString("  Status", kTitleWidthInSecondColumn) +
+                   ": Disabled. Enable with export ORTMODULE_MEMORY_OPT_CONFIG=" + record.offload_cluster_id + ":" +
+                   std::to_string(static_cast<int>(OptimizationType::Offload)) + ":-1");
+  }
+
+  rows.push_back(empty_first_col + "  Stashed Activations: ");
+  for (const auto& stat : record.offloaded_outputs) {
+    rows.push_back(empty_first_col +
+                   ToFixedLengthString("   - Output " + std::to_string(stat.output_index), kTitleWidthInSecondColumn) +
+                   ": [" + stat.output_shape_str + "], byte/elem: " +
+                   std::to_string(stat.output_byte_count_per_element) + ", moved to host memory");
+  }
+}
 }  // namespace
 
 std::string SerializeMemoryRecords(
@@ -680,6 +726,11 @@ std::string SerializeMemoryRecords(
       FormatRecomputeMemoryRecords(option_index, record, true, rows);
       option_index++;
     }
+
+    if (record.offloaded_outputs.size() > 0) {
+      FormatOffloadMemoryRecords(option_index, record, rows);
+      option_index++;
+    }
     rows.push_back(kTableRowSeparator);
   }
 
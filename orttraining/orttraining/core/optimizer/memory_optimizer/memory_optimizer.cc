@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <iomanip>
+#include <limits>
 #include <memory>
 #include <utility>
 #include <string>
@@ -50,6 +51,44 @@ bool SetSeedForDropoutNode(Node& node) {
   return false;
 }
 
+// Make the prefetch node run before the backward node producing the other inputs of its first consumer, so that the
+// copy back to device memory is issued one step ahead and overlaps with backward compute, instead of being issued
+// right when the consumer needs it.
+void SchedulePrefetch(Graph& graph,
+                      const Node& prefetch_node,
+                      const InlinedHashMap<NodeIndex, ptrdiff_t>& node_index_to_its_order_in_topological_sort_map,
+                      ptrdiff_t boundary_op_order_in_topological_sort) {
+  const Node* first_consumer = nullptr;
+  ptrdiff_t first_consumer_order = std::numeric_limits<ptrdiff_t>::max();
+  for (auto it = prefetch_node.OutputNodesBegin(), end = prefetch_node.OutputNodesEnd(); it != end; ++it) {
+    auto order_it = node_index_to_its_order_in_topological_sort_map.find(it->Index());
+    if (order_it != node_index_to_its_order_in_topological_sort_map.end() && order_it->second < first_consumer_order) {
+      first_consumer = &*it;
+      first_consumer_order = order_it->second;
+    }
+  }
+
+  if (first_consumer == nullptr) {
+    return;
+  }
+
+  // The latest backward producer of the first consumer. The prefetch node only depends on forward nodes, so a control
+  // edge to a backward node cannot create a cycle.
+  const Node* producer = nullptr;
+  ptrdiff_t producer_order = boundary_op_order_in_topological_sort;
+  for (auto it = first_consumer->InputNodesBegin(), end = first_consumer->InputNodesEnd(); it != end; ++it) {
+    auto order_it = node_index_to_its_order_in_topological_sort_map.find(it->Index());
+    if (order_it != node_index_to_its_order_in_topological_sort_map.end() && order_it->second > producer_order) {
+      producer = &*it;
+      producer_order = order_it->second;
+    }
+  }
+
+  if (producer != nullptr) {
+    graph.AddControlEdge(prefetch_node.Index(), producer->Index());
+  }
+}
+
 }  // namespace
 
 Status MemoryOptimizer::ParseOptimizationConfigFromString(const std::string& memory_optimizer_config,
@@ -74,6 +113,7 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
                                       candidate_output_args_map,
                                   const logging::Logger& logger,
                                   ptrdiff_t boundary_op_order_in_topological_sort,
+                                  Node* yield_op_node,
                                   Node* node,
                                   std::shared_ptr<optimizer::memory_optimizer::NodeOptimizationPlanBase>& node_plan,
                                   std::shared_ptr<optimizer::memory_optimizer::ClusterApplyContext>& apply_context)
@@ -87,7 +127,12 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
 
   if (apply_context->skip_count > skip_count) {
     apply_context->applied_count += 1;
-    Node* replacement_node_ptr = nullptr;
+    // The node and its output index replacing each activation for the backward consumers.
+    InlinedHashMap<size_t, std::pair<Node*, int>> replacement_outputs;
+    // The prefetch node of each activation, scheduled ahead of its backward consumers, if offloaded.
+    InlinedHashMap<size_t, Node*> prefetch_nodes;
+    // Newly added nodes which keep consuming the activation in forward pass.
+    InlinedHashSet<const Node*> forward_consumers_to_keep;
     LOGS(logger, INFO) << "Node " << node->Name() << "(" << node->OpType() << ") is applying following optimization:"
                        << "type [" << optimizer::memory_optimizer::OptimizationTypeToString(apply_context->type)
                        << "], request count [" << apply_context->requested_count << "]";
@@ -96,11 +141,25 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
       optimizer::memory_optimizer::NodeRecomputePlan* recompute_plan =
           dynamic_cast<optimizer::memory_optimizer::NodeRecomputePlan*>(node_plan.get());
       ORT_ENFORCE(recompute_plan != nullptr);
+      Node* replacement_node_ptr = nullptr;
       ORT_ENFORCE(CreateRecomputeGraph(graph, recompute_plan->GetNodesInTopoOrder(), logger, replacement_node_ptr).IsOK());
+      ORT_ENFORCE(replacement_node_ptr);
+      for (size_t output_index : candidate_output_args_map.at(node)) {
+        replacement_outputs[output_index] = {replacement_node_ptr, static_cast<int>(output_index)};
+      }
+    } else if (apply_context->type == optimizer::memory_optimizer::OptimizationType::Offload) {
+      ORT_ENFORCE(yield_op_node != nullptr, "Offload requires YieldOp as the boundary between fw and bw.");
+      for (size_t output_index : candidate_output_args_map.at(node)) {
+        Node* offload_node = nullptr;
+        Node* prefetch_node = nullptr;
+        ORT_ENFORCE(CreateOffloadGraph(graph, *node, output_index, *yield_op_node, offload_node, prefetch_node).IsOK());
+        replacement_outputs[output_index] = {prefetch_node, 0};
+        prefetch_nodes[output_index] = prefetch_node;
+        forward_consumers_to_keep.insert(offload_node);
+      }
     } else {
       ORT_THROW("unsupported optimization type found.");
     }
-    ORT_ENFORCE(replacement_node_ptr);
 
     graph_is_modified = true;
 
@@ -109,7 +168,7 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
       std::vector<graph_utils::GraphEdge> output_edges;
       for (auto it = node->OutputEdgesBegin(), end = node->OutputEdgesEnd(); it != end; ++it) {
         size_t src_output_idx = static_cast<size_t>(it->GetSrcArgIndex());
-        if (src_output_idx != output_index) {
+        if (src_output_idx != output_index || forward_consumers_to_keep.count(&it->GetNode()) > 0) {
           continue;
         }
 
@@ -128,16 +187,23 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
         // Remove the output edges of the node first
         graph_utils::GraphEdge::RemoveGraphEdges(graph, output_edges);
 
+        const auto& [replacement_node_ptr, replacement_output_index] = replacement_outputs.at(output_index);
         // Create connections between the replacement node and the outgoing nodes.
         for (const auto& output_edge : output_edges) {
           graph.RemoveConsumerNode(node->MutableOutputDefs()[output_index]->Name(), node);
 
           // Add new edge connecting the input with the output nodes directly.
           // This also updates the destination node's input node args
-          graph.AddEdge(replacement_node_ptr->Index(), output_edge.dst_node, static_cast<int>(output_index),
+          graph.AddEdge(replacement_node_ptr->Index(), output_edge.dst_node, replacement_output_index,
                         output_edge.dst_arg_index);
         }
       }
+
+      auto prefetch_it = prefetch_nodes.find(output_index);
+      if (prefetch_it != prefetch_nodes.end()) {
+        SchedulePrefetch(graph, *prefetch_it->second, node_index_to_its_order_in_topological_sort_map,
+                         boundary_op_order_in_topological_sort);
+      }
     }
   }
 
@@ -188,6 +254,9 @@ Status MemoryOptimizer::ApplyImpl(Graph& graph, bool& modified, int /*graph_leve
   // The second pass - apply the transformation.
   const auto& node_ids =
       graph_viewer.GetNodesInTopologicalOrder(optimizer::memory_optimizer::TOPOLOGICAL_SORT_ALGORITHM);
+  Node* yield_op_node = yield_op_order_in_topological_sort >= 0
+                            ? graph.GetNode(node_ids[yield_op_order_in_topological_sort])
+                            : nullptr;
   for (int i = static_cast<int>(node_ids.size()) - 1; i >= 0; --i) {
     Node* p_node = graph.GetNode(node_ids[i]);
     if (p_node == nullptr) {
@@ -199,6 +268,7 @@ Status MemoryOptimizer::ApplyImpl(Graph& graph, bool& modified, int /*graph_leve
       has_been_modified = ModifyGraph(graph, node_index_to_its_order_in_topological_sort_map,
                                       candidate_output_args_map, logger,
                                       yield_op_order_in_topological_sort,
+                                      yield_op_node,
                                       p_node,
                                       node_to_opt_plan_map[p_node],
                                       node_to_apply_context_map[p_node]);
@@ -321,4 +391,42 @@ Status MemoryOptimizer::CreateRecomputeGraph(Graph& graph,
  ** Recompute related function implementation ends   **
  ******************************************************/
 
+Status MemoryOptimizer::CreateOffloadGraph(Graph& graph,
+                                           Node& node,
+                                           size_t output_index,
+                                           Node& yield_op_node,
+                                           Node*& offload_node,
+                                           Node*& prefetch_node) const {
+  NodeArg* activation_arg = node.MutableOutputDefs()[output_index];
+  const std::string& activation_name = activation_arg->Name();
+  NodeArg& offloaded_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(activation_name + "_offload"),
+                                                    activation_arg->TypeAsProto());
+  NodeArg& prefetched_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(activation_name + "_prefetch"),
+                                                     activation_arg->TypeAsProto());
+
+  // The device EP places the output of MemcpyToHost and the input of MemcpyFromHost in its host (pinned) memory.
+  offload_node = &graph.AddNode(graph.GenerateNodeName(activation_name + "_offload"), "MemcpyToHost",
+                                "Offload of " + activation_name, {activation_arg}, {&offloaded_arg});
+  prefetch_node = &graph.AddNode(graph.GenerateNodeName(activation_name + "_prefetch"), "MemcpyFromHost",
+                                 "Prefetch of " + activation_name, {&offloaded_arg}, {&prefetched_arg});
+  for (Node* copy_node : {offload_node, prefetch_node}) {
+    copy_node->SetExecutionProviderType(node.GetExecutionProviderType());
+    ORT_RETURN_IF_NOT(graph.SetOpSchemaFromRegistryForNode(*copy_node),
+                      "Failed to set op schema for added offload node.");
+  }
+
+  graph.UpdateProducerNode(offloaded_arg.Name(), offload_node->Index());
+  graph.UpdateProducerNode(prefetched_arg.Name(), prefetch_node->Index());
+  graph.AddConsumerNode(activation_name, offload_node);
+  graph.AddConsumerNode(offloaded_arg.Name(), prefetch_node);
+  graph.AddEdge(node.Index(), offload_node->Index(), static_cast<int>(output_index), 0);
+  graph.AddEdge(offload_node->Index(), prefetch_node->Index(), 0, 0);
+
+  // Run the copy to host memory in forward pass, otherwise it would only be scheduled with its backward consumers.
+  ORT_RETURN_IF_NOT(graph.AddControlEdge(offload_node->Index(), yield_op_node.Index()),
+                    "Failed to add control edge from ", offload_node->Name(), " to ", yield_op_node.Name());
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -16,7 +16,7 @@ namespace onnxruntime {
 /**
 @Class MemoryOptimizer
 
-Find recompute subgraphs and enable them according to user configs. The way we collect subgraphs
+Find recompute subgraphs or activations to offload, and enable them according to user configs. The way we collect subgraphs
 (in orttraining/orttraining/core/optimizer/memory_optimizer/recompute_analysis.h) in brief is:
 1. Find all nodes that generate stashed activations.
 2. For each node, check it data type is supported to recompute
@@ -24,6 +24,10 @@ Find recompute subgraphs and enable them according to user configs. The way we c
   b. otherwise, stop collecting and return the subgraph (could be empty).
 3. Pick up the input node from the queue, and do 2 again. The process ends when the queue is empty or 2.b happens.
 4. Clone the recomputable subgraphs and insert them back to the original graph.
+
+Offloading copies the stashed activations of a node to host memory (MemcpyToHost) before YieldOp, and copies them
+back (MemcpyFromHost) for the backward consumers, ahead of the node producing the other inputs of the first consumer,
+so the copy overlaps with backward compute.
 */
 
 class MemoryOptimizer : public GraphTransformer {
@@ -52,6 +56,7 @@ class MemoryOptimizer : public GraphTransformer {
    *  bw ops.
    * @param logger Logger.
    * @param boundary_op_order_in_topological_sort index of the boundary op between fw and bw.
+   * @param yield_op_node The boundary op between fw and bw.
    * @param subgraph_stores  A store to maintain all found subgraphs.
    * @param node The node we used to look for corresponding optimization graphs.
    * @return true
@@ -64,6 +69,7 @@ class MemoryOptimizer : public GraphTransformer {
                        candidate_output_args_map,
                    const logging::Logger& logger,
                    ptrdiff_t boundary_op_order_in_topological_sort,
+                   Node* yield_op_node,
                    Node* node,
                    std::shared_ptr<optimizer::memory_optimizer::NodeOptimizationPlanBase>& node_plan,
                    std::shared_ptr<optimizer::memory_optimizer::ClusterApplyContext>& apply_context) const;
@@ -101,6 +107,25 @@ class MemoryOptimizer : public GraphTransformer {
    ** Recompute-related function definition ends   **
    *************************************************/
 
+  /**
+   * @brief Create the nodes copying an activation to host memory and back to device memory.
+   * The copy to host memory is made to run before YieldOp, so the activation is released in forward pass.
+   *
+   * @param graph Graph to iterate.
+   * @param node The node producing the activation.
+   * @param output_index The output index of the activation.
+   * @param yield_op_node The boundary op between fw and bw.
+   * @param offload_node Returns the node copying the activation to host memory.
+   * @param prefetch_node Returns the node copying the activation back to device memory.
+   * @return Status
+   */
+  Status CreateOffloadGraph(Graph& graph,
+                            Node& node,
+                            size_t output_index,
+                            Node& yield_op_node,
+                            Node*& offload_node,
+                            Node*& prefetch_node) const;
+
   // User-enabled map of the subgraph string representation to the alleviation type.
   InlinedHashMap<std::string, optimizer::memory_optimizer::UserConfig> pattern_subgraph_to_user_optimizer_config_map_;
   std::string optimizer_config_;
@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <sstream>
+#include <string>
+
+#include "orttraining/core/optimizer/memory_optimizer/offload_analysis.h"
+
+namespace onnxruntime::optimizer::memory_optimizer {
+
+std::string NodeOffloadPlan::GetClusterId() const {
+  return "Offload(" + node->OpType() + ")";
+}
+
+std::string NodeOffloadPlan::NormalizeForNodeClusterId() const {
+  std::ostringstream oss;
+  oss << "offload:" << node->OpType() << "-";
+  for (auto& output_index : GetActivationOutputIndices()) {
+    oss << output_index << ":" << GetActivationOutputDimParamString(output_index);
+    oss << ":" << node->OutputDefs()[output_index]->TypeAsProto()->tensor_type().elem_type() << "-";
+  }
+
+  return oss.str();
+}
+
+std::string NodeOffloadPlan::GetMemorySavingSymbolicString() const {
+  std::string saving_str;
+  for (auto output_index : GetActivationOutputIndices()) {
+    const auto& output_def = node->OutputDefs()[output_index];
+    MLDataType ml_data_type = DataTypeImpl::TypeFromProto(*output_def->TypeAsProto());
+    ORT_ENFORCE(ml_data_type->IsTensorType(), "ml_type must be a tensor type, but it is ",
+                DataTypeImpl::ToString(ml_data_type));
+    const auto byte_count_per_element = ml_data_type->AsTensorType()->GetElementType()->Size();
+
+    if (!saving_str.empty()) {
+      saving_str += " + ";
+    }
+    saving_str += "(" + GetActivationOutputDimParamString(output_index) + " * " +
+                  std::to_string(byte_count_per_element) + ")";
+  }
+
+  ORT_ENFORCE(!saving_str.empty(), "saving_str should not be empty for node: ", node->OpType(), " ", node->Name());
+  return "(" + saving_str + ")";
+}
+
+std::unique_ptr<NodeOffloadPlan> CheckNodeForOffload(const Node& node,
+                                                     const InlinedHashMap<const Node*, InlinedVector<size_t>>&
+                                                         candidate_output_args_map) {
+  // Activations of CPU nodes are already in host memory.
+  const auto& provider_type = node.GetExecutionProviderType();
+  if (provider_type.empty() || provider_type == kCpuExecutionProvider) {
+    return nullptr;
+  }
+
+  auto it = candidate_output_args_map.find(&node);
+  if (it == candidate_output_args_map.end() || it->second.empty()) {
+    return nullptr;
+  }
+
+  for (size_t output_index : it->second) {
+    const auto* type_proto = node.OutputDefs()[output_index]->TypeAsProto();
+    if (type_proto == nullptr || !type_proto->has_tensor_type()) {
+      return nullptr;
+    }
+  }
+
+  return std::make_unique<NodeOffloadPlan>(&node, it->second);
+}
+
+}  // namespace onnxruntime::optimizer::memory_optimizer
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "orttraining/core/optimizer/memory_optimizer/common.h"
+#include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
+
+namespace onnxruntime::optimizer::memory_optimizer {
+
+/**
+ * @brief A child class used for Offload optimization plan.
+ *
+ * For each node generating stashed activations on a device, an offload plan can be created for it. The stashed
+ * activations are copied to host memory once they are produced in forward pass, then copied back to device memory
+ * just ahead of their first consumer in backward pass, so the device memory holding them is released in between.
+ */
+class NodeOffloadPlan : public NodeOptimizationPlanBase {
+ public:
+  NodeOffloadPlan(const Node* node,
+                  const InlinedVector<size_t>& activation_output_indices)
+      : NodeOptimizationPlanBase(node, activation_output_indices, 1.0f) {}
+
+  OptimizationType GetOptimizationType() const override { return OptimizationType::Offload; }
+
+  /**
+   * @brief Get the cluster id for this offload plan, for example, Offload(Gelu).
+   * User can pass such cluster id to enable offloading the activations of all nodes of this op type.
+   */
+  std::string GetClusterId() const override;
+
+  std::string NormalizeForNodeClusterId() const override;
+
+  std::string GetMemorySavingSymbolicString() const override;
+};
+
+/**
+ * @brief For the node producing stashed activation, check whether its activations can be offloaded to host memory.
+ * Only the nodes assigned to an execution provider other than CPU are considered.
+ *
+ * @param node The node producing stashed activations.
+ * @param candidate_output_args_map A map from node to its candidate activations, which are consumed by both fw and
+ *  bw ops.
+ */
+std::unique_ptr<NodeOffloadPlan> CheckNodeForOffload(const Node& node,
+                                                     const InlinedHashMap<const Node*, InlinedVector<size_t>>&
+                                                         candidate_output_args_map);
+
+}  // namespace onnxruntime::optimizer::memory_optimizer
@@ -65,6 +65,31 @@ bool IsFusable(const torch::jit::Node* node) {
   return !found_not_fusable;
 }
 
+// Key of the compiled sub-graph for these inputs. Tensors are identified by
+// their element type, device, requires_grad and, unless "shape_generic" is
+// true, their sizes and strides. Only the rank is used otherwise, because the
+// sub-graph is exported with symbolic dims by SetArgTypes.
+static std::string GetCacheKey(const at::ArrayRef<c10::IValue>& inputs, const bool shape_generic) {
+  std::ostringstream key;
+  for (const auto& input : inputs) {
+    if (input.isTensor()) {
+      const auto& tensor = input.toTensor();
+      key << "T" << static_cast<int>(tensor.scalar_type())
+          << "@" << tensor.device() << (tensor.requires_grad() ? "g" : "");
+      if (shape_generic) {
+        key << "r" << tensor.dim();
+      } else {
+        key << "s" << tensor.sizes() << tensor.strides();
+      }
+    } else {
+      // Scalars are fed as 0-d tensors, so only their kind matters.
+      key << "S" << input.tagKind();
+    }
+    key << ";";
+  }
+  return key.str();
+}
+
 bool Accelerator::Supported(const torch::jit::Node* node) {
   if (!node) {
     return false;
@@ -98,7 +123,20 @@ bool Accelerator::Supported(const torch::jit::Node* node) {
     case aten::ne:
     case aten::abs:
     case aten::max:
-    case aten::min: {
+    case aten::min:
+    case aten::sigmoid:
+    case aten::exp:
+    case aten::log:
+    case aten::neg:
+    case aten::reciprocal:
+    case aten::pow:
+    case aten::transpose:
+    case aten::t:
+    case aten::addmm:
+    case aten::_softmax:
+    case aten::view:
+    case aten::unsqueeze:
+    case aten::squeeze: {
       if (DumpAtenOpHistory()) {
         std::cout << "Supported op: "
                   << ToString(*node) << std::endl;
@@ -143,9 +181,10 @@ void Accelerator::OrtRun(torch::jit::Stack& stack) {
   // do so now.
   // Compile a callable to execute "subgraph_" on the inputs.
   // If such input schema appears before, we can reuse a cached compiled callable.
-  torch::jit::CompleteArgumentSpec spec{false, inputs};
-  if (cache_.find(spec) == cache_.end()) {
-    cache_.emplace(spec, Compile(spec, inputs));
+  const std::string key = GetCacheKey(inputs, ShapeGenericCache());
+  auto it = cache_.find(key);
+  if (it == cache_.end()) {
+    it = cache_.emplace(key, Compile(inputs)).first;
   }
 
   if (DumpInputsOutputs()) {
@@ -153,7 +192,7 @@ void Accelerator::OrtRun(torch::jit::Stack& stack) {
   }
 
   // Run the compiled function!
-  auto outputs = cache_[spec].code(inputs);
+  auto outputs = it->second.code(inputs);
 
   // Discard used inputs.
   torch::jit::drop(stack, inputs.size());
@@ -245,9 +284,13 @@ static void CheckArgs(
 // in ORT.
 // TODO(wechi): Allow ORT to accept models without
 // input types. Then, we can remove this function.
+// If "shape_generic" is true, only the ranks of the
+// inputs are stored, so the exported model accepts
+// inputs of any shape with these ranks.
 static void SetArgTypes(
     const at::ArrayRef<c10::IValue>& inputs,
-    std::shared_ptr<torch::jit::Graph> graph) {
+    std::shared_ptr<torch::jit::Graph> graph,
+    const bool shape_generic) {
   TORCH_CHECK(graph->inputs().size() == inputs.size(),
               "Number of provided inputs must match captured sub-graph's schema.");
   for (size_t i = 0; i < graph->inputs().size(); ++i) {
@@ -260,7 +303,16 @@ static void SetArgTypes(
       // representations in Pytorch.
       continue;
     }
-    input_symbol->setType(input_value.type());
+    if (shape_generic) {
+      const auto& tensor = input_value.toTensor();
+      const size_t rank = static_cast<size_t>(tensor.dim());
+      input_symbol->setType(c10::TensorType::create(
+          tensor.scalar_type(), tensor.device(),
+          c10::SymbolicShape(rank), c10::VaryingShape<c10::Stride>(rank),
+          tensor.requires_grad()));
+    } else {
+      input_symbol->setType(input_value.type());
+    }
   }
 }
 
@@ -271,7 +323,8 @@ static void SetArgTypes(
 // ONNX file.
 static std::string ExportToOnnx(
     std::shared_ptr<torch::jit::Graph> graph,
-    const at::ArrayRef<c10::IValue>& args) {
+    const at::ArrayRef<c10::IValue>& args,
+    const bool shape_generic) {
 #ifdef USE_CUDA
   NvtxRange range(__func__);
 #endif
@@ -288,7 +341,7 @@ static std::string ExportToOnnx(
               .attr("_export_jit_graph_to_onnx_model_proto"));
   // Fill types up. The sub-graphp from LazyTensor doesn't
   // contain input shapes.
-  SetArgTypes(args, new_subgraph);
+  SetArgTypes(args, new_subgraph, shape_generic);
   // Execute Python function.
   auto result = export_to_onnx(new_subgraph, ::torch::onnx::OperatorExportTypes::ONNX);
   return result.cast<std::string>();
@@ -395,8 +448,7 @@ void Accelerator::ExampleRun(at::ArrayRef<c10::IValue> inputs) {
   }
 }
 
-CompiledObject Accelerator::Compile(
-    torch::jit::CompleteArgumentSpec spec, at::ArrayRef<c10::IValue>& args) {
+CompiledObject Accelerator::Compile(at::ArrayRef<c10::IValue>& args) {
   CheckArgs(args);
   DynamicSettings::GetInstance().SetOnnxFusionFlag(false);
   ExampleRun(args);
@@ -410,7 +462,7 @@ CompiledObject Accelerator::Compile(
   // Export subgraph_ to ONNX.
   // The exporter should never fail. If it does, please modify
   // Accelerator::Supported to filter out unsupported operators.
-  const std::string serialized_model = ExportToOnnx(subgraph_, args);
+  const std::string serialized_model = ExportToOnnx(subgraph_, args, ShapeGenericCache());
   // Memory info for all tensors.
   // Assume all inputs are on the same device.
   OrtDevice shared_device = CheckAndGetTensorDevice(args);
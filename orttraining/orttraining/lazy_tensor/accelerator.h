@@ -47,12 +47,13 @@ class Accelerator {
   void PytorchRun(torch::jit::Stack& stack);
   // Create callable to execute "subgraph_" given "args" as inputs.
   // This calllable is cached for repeated uses.
-  CompiledObject Compile(
-      torch::jit::CompleteArgumentSpec spec, at::ArrayRef<c10::IValue>& args);
+  CompiledObject Compile(at::ArrayRef<c10::IValue>& args);
   // The graph to be compiled and executed by ORT.
   std::shared_ptr<torch::jit::Graph> subgraph_;
-  // Previously compiled results.
-  std::unordered_map<torch::jit::CompleteArgumentSpec, CompiledObject> cache_;
+  // Previously compiled results. The key is computed by GetCacheKey in
+  // accelerator.cc from the types of the inputs, and from their shapes
+  // unless LORT_SHAPE_GENERIC_CACHE=1.
+  std::unordered_map<std::string, CompiledObject> cache_;
   // Types of the inputs (typed to IValue) we got when compile the subgraph.
   // Since the subgraph is compiled for these type, feeding
   // inputs with different types may fail.
@@ -28,6 +28,16 @@ double GetEnvironmentVariableDoubleOrDefault(const char* name, const double defa
   return std::atof(number);
 }
 
+size_t GetEnvironmentVariableSizeOrDefault(const char* name, const size_t default_value) {
+  const auto number = std::getenv(name);
+  if (!number) {
+    return default_value;
+  }
+  const auto value = std::atoll(number);
+  ORT_ENFORCE(value >= 0, "Must set ", name, " to a non-negative integer.");
+  return static_cast<size_t>(value);
+}
+
 std::string RunType() {
   const auto run_type = std::getenv("LORT_RUN_TYPE");
   if (!run_type) {
@@ -75,5 +85,13 @@ bool DumpOnnxFusion() {
   return IsEnvironmentVariableOne("LORT_DUMP_ONNX_FUSION");
 }
 
+size_t MinFusionGroupSize() {
+  return GetEnvironmentVariableSizeOrDefault("LORT_MIN_FUSION_GROUP_SIZE", 2);
+}
+
+bool ShapeGenericCache() {
+  return IsEnvironmentVariableOne("LORT_SHAPE_GENERIC_CACHE");
+}
+
 }  // namespace lazytensor
 }  // namespace onnxruntime
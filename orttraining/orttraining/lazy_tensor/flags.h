@@ -43,6 +43,16 @@ double AbsoluteTolerance();
 // |value-expected| <= |expected| * relative_tol + absolute_tol
 double RelativeTolerance();
 bool DumpOnnxFusion();
+// Fusion groups with fewer ops than this number are given back
+// to Pytorch, because running a tiny sub-graph in ORT costs more
+// in session overhead than it saves. Set by
+// LORT_MIN_FUSION_GROUP_SIZE. Default is 2, i.e., keep all groups.
+size_t MinFusionGroupSize();
+// If this function returns true, a sub-graph is compiled once per
+// input types and ranks instead of once per input shapes. Its ONNX
+// model is exported with symbolic dims, so inputs of different shapes
+// reuse the same ORT session. Set by LORT_SHAPE_GENERIC_CACHE=1.
+bool ShapeGenericCache();
 
 class DynamicSettings {
  public:
@@ -7,6 +7,7 @@
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
 #include <torch/csrc/jit/passes/constant_pooling.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/utils/subgraph_utils.h>
 
 namespace onnxruntime {
 namespace lazytensor {
@@ -336,7 +337,7 @@ struct OrtFuser {
 
   void optimizeFusedGraphs() {
     for (torch::jit::Node* node : block_->nodes()) {
-      if (node->kind() != torch::jit::prim::FusionGroup) {
+      if (node->kind() != kind_) {
         continue;
       }
       auto subgraph = node->g(torch::jit::attr::Subgraph);
@@ -385,20 +386,59 @@ struct OrtFuser {
   }
 };
 
+// Number of ops in a fusion group, not counting the constants inlined into it.
+static size_t CountFusedOps(const torch::jit::Graph& subgraph) {
+  size_t count = 0;
+  for (const torch::jit::Node* node : subgraph.nodes()) {
+    if (node->kind() != torch::jit::prim::Constant) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+// Inline the fusion groups having fewer than "min_group_size" ops back into
+// "block", so that Pytorch runs them instead of a tiny ORT session.
+static void UnfuseSmallGroups(torch::jit::Block* block, torch::jit::Symbol kind, size_t min_group_size) {
+  std::vector<torch::jit::Node*> small_groups;
+  for (torch::jit::Node* node : block->nodes()) {
+    if (node->kind() == kind) {
+      if (CountFusedOps(*node->g(torch::jit::attr::Subgraph)) < min_group_size) {
+        small_groups.push_back(node);
+      }
+      continue;
+    }
+    for (torch::jit::Block* sub_block : node->blocks()) {
+      UnfuseSmallGroups(sub_block, kind, min_group_size);
+    }
+  }
+
+  for (torch::jit::Node* group : small_groups) {
+    torch::jit::SubgraphUtils::unmergeSubgraph(group);
+  }
+}
+
 void OrtFuseGraph(
     std::shared_ptr<torch::jit::Graph>& graph,
     const std::function<bool(torch::jit::Node*)>& fn,
     torch::jit::Symbol kind,
-    size_t arg_limit) {
-  torch::jit::AliasDb db(graph);
-  auto g = OrtFuser(
-      &db,
-      graph->block(),
-      [=](OrtFuser* gf, torch::jit::Node* n) { return fn(n) || n->kind() == kind; },
-      kind, false, arg_limit);
-
-  g.run();
-  torch::jit::Lint(&db);
+    size_t arg_limit,
+    size_t min_group_size) {
+  {
+    torch::jit::AliasDb db(graph);
+    auto g = OrtFuser(
+        &db,
+        graph->block(),
+        [=](OrtFuser* gf, torch::jit::Node* n) { return fn(n) || n->kind() == kind; },
+        kind, false, arg_limit);
+
+    g.run();
+    torch::jit::Lint(&db);
+  }
+
+  if (min_group_size > 1) {
+    UnfuseSmallGroups(graph->block(), kind, min_group_size);
+  }
 }
 
 }  // namespace lazytensor
@@ -3,11 +3,15 @@
 namespace onnxruntime {
 namespace lazytensor {
 
+// Fuse the nodes accepted by "fn" into nodes of "kind", each holding
+// a sub-graph. Groups with fewer than "min_group_size" ops (constants
+// excluded) are inlined back into "graph".
 void OrtFuseGraph(
     std::shared_ptr<torch::jit::Graph>& graph,
     const std::function<bool(torch::jit::Node*)>& fn,
     torch::jit::Symbol kind,
-    size_t arg_limit = std::numeric_limits<size_t>::max());
+    size_t arg_limit = std::numeric_limits<size_t>::max(),
+    size_t min_group_size = 1);
 
 }  // namespace lazytensor
 }  // namespace onnxruntime
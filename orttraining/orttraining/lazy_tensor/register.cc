@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <iostream>
+#include <limits>
 // Instead of torch/torch.h, include torch torch/extension.h
 // for extra Python headers.
 #include <torch/extension.h>
@@ -46,7 +47,8 @@ void register_ort_as_torch_jit_executor() {
 
     std::shared_ptr<torch::jit::Graph> new_subgraph_with_shapes(g->copyUnique().release());
 
-    OrtFuseGraph(g, Accelerator::Supported, accelerator_symbol);
+    OrtFuseGraph(g, Accelerator::Supported, accelerator_symbol,
+                 std::numeric_limits<size_t>::max(), MinFusionGroupSize());
     if (DumpOnnxFusion()) {
       std::cout << "[After fusion]\n"
                 << *g;
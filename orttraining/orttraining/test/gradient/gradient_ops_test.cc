@@ -2228,6 +2228,27 @@ TEST(GradientUtilsTest, InPlaceAccumulatorV2Overwrite) {
   test.Run();
 }
 
+TEST(GradientUtilsTest, InPlaceGemmAccumulator_CPU) {
+  for (bool overwrite : {false, true}) {
+    OpTester test("InPlaceGemmAccumulator", 1, onnxruntime::kMSDomain);
+    test.AddAttribute<int64_t>("transB", 1);
+    test.AddAttribute<float>("alpha", 0.5f);
+
+    // 0.5 * A * B' = {2, 1, 5, 2.5}
+    test.AddInput<float>("old_sum", {2, 2}, {1.f, 1.f, 1.f, 1.f});
+    test.AddInput<float>("A", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    test.AddInput<float>("B", {2, 3}, {1.f, 0.f, 1.f, 0.f, 1.f, 0.f});
+    test.AddInput<bool>("overwrite", {1}, {overwrite});
+    test.AddOutput<bool>("updated", {1}, {true});
+    test.AddOutput<float>("new_sum", {2, 2},
+                          overwrite ? std::vector<float>{2.f, 1.f, 5.f, 2.5f} : std::vector<float>{3.f, 2.f, 6.f, 3.5f});
+
+    std::vector<std::unique_ptr<IExecutionProvider>> providers;
+    providers.emplace_back(DefaultCpuExecutionProvider());
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &providers);
+  }
+}
+
 #if defined(USE_CUDA)
 // TODO: Add rocm kernel defs
 TEST(GradientUtilsTest, InPlaceAccumulatorV2_GPU) {
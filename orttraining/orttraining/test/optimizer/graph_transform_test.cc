@@ -30,6 +30,7 @@
 #include "orttraining/core/optimizer/qdq_fusion.h"
 #include "orttraining/core/optimizer/scaled_sum_fusion.h"
 #include "orttraining/core/optimizer/sce_loss_grad_bias_fusion.h"
+#include "orttraining/core/optimizer/gemm_accumulator_fusion.h"
 #include "orttraining/core/optimizer/lstm_replacement.h"
 #include "orttraining/core/optimizer/gru_replacement.h"
 #ifdef ENABLE_TRITON
@@ -518,6 +519,108 @@ TEST_F(GraphTransformationTests, SceLossGradBiasFusion_Invalid) {
   }
 }
 
+TEST_F(GraphTransformationTests, GemmAccumulatorFusion) {
+  // MatMul and Gemm with transposed A and alpha, the gradient being consumed by the accumulator only.
+  for (bool is_gemm : {false, true}) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* a_arg = builder.MakeInput<float>(is_gemm ? std::vector<int64_t>{16, 8} : std::vector<int64_t>{8, 16});
+      auto* b_arg = builder.MakeInput<float>({{16, 4}});
+      auto* buffer_arg = builder.MakeInput<float>({{8, 4}});
+      auto* flag_arg = builder.MakeInput<bool>({{1}});
+      auto* grad_out = builder.MakeIntermediate();
+      auto* updated_out = builder.MakeOutput();
+      auto* buffer_out = builder.MakeOutput();
+      if (is_gemm) {
+        auto& gemm_node = builder.AddNode("Gemm", {a_arg, b_arg}, {grad_out});
+        gemm_node.AddAttribute("transA", static_cast<int64_t>(1));
+        gemm_node.AddAttribute("alpha", 0.5f);
+      } else {
+        builder.AddNode("MatMul", {a_arg, b_arg}, {grad_out});
+      }
+      builder.AddNode("InPlaceAccumulatorV2", {buffer_arg, grad_out, flag_arg}, {updated_out, buffer_out}, kMSDomain);
+    };
+
+    auto pre_graph_checker = [&](Graph& graph) {
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)[is_gemm ? "Gemm" : "MatMul"] == 1);
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.InPlaceAccumulatorV2"] == 1);
+      return Status::OK();
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_to_count = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_to_count[is_gemm ? "Gemm" : "MatMul"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.InPlaceAccumulatorV2"] == 0);
+      TEST_RETURN_IF_NOT(op_to_count["com.microsoft.InPlaceGemmAccumulator"] == 1);
+      for (auto& node : graph.Nodes()) {
+        if (node.OpType() == "InPlaceGemmAccumulator") {
+          auto& attrs = node.GetAttributes();
+          TEST_RETURN_IF_NOT(attrs.at("transA").i() == (is_gemm ? 1 : 0));
+          TEST_RETURN_IF_NOT(attrs.at("transB").i() == 0);
+          TEST_RETURN_IF_NOT(attrs.at("alpha").f() == (is_gemm ? 0.5f : 1.0f));
+          TEST_RETURN_IF_NOT(node.InputDefs().size() == 4);
+          TEST_RETURN_IF_NOT(node.OutputDefs().size() == 2);
+        }
+      }
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<GemmAccumulatorFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+}
+
+TEST_F(GraphTransformationTests, GemmAccumulatorFusion_Invalid) {
+  auto pre_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["MatMul"] == 1);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.InPlaceAccumulatorV2"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["MatMul"] == 1);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.InPlaceAccumulatorV2"] == 1);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.InPlaceGemmAccumulator"] == 0);
+    return Status::OK();
+  };
+
+  // The gradient has more than 1 consumer.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* a_arg = builder.MakeInput<float>({{8, 16}});
+      auto* b_arg = builder.MakeInput<float>({{16, 4}});
+      auto* buffer_arg = builder.MakeInput<float>({{8, 4}});
+      auto* grad_out = builder.MakeIntermediate();
+      auto* updated_out = builder.MakeOutput();
+      auto* identity_out = builder.MakeOutput();
+      builder.AddNode("MatMul", {a_arg, b_arg}, {grad_out});
+      builder.AddNode("InPlaceAccumulatorV2", {buffer_arg, grad_out}, {updated_out}, kMSDomain);
+      builder.AddNode("Identity", {grad_out}, {identity_out});
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<GemmAccumulatorFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+
+  // Batched MatMul.
+  {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* a_arg = builder.MakeInput<float>({{2, 8, 16}});
+      auto* b_arg = builder.MakeInput<float>({{2, 16, 4}});
+      auto* buffer_arg = builder.MakeInput<float>({{2, 8, 4}});
+      auto* grad_out = builder.MakeIntermediate();
+      auto* updated_out = builder.MakeOutput();
+      builder.AddNode("MatMul", {a_arg, b_arg}, {grad_out});
+      builder.AddNode("InPlaceAccumulatorV2", {buffer_arg, grad_out}, {updated_out}, kMSDomain);
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<GemmAccumulatorFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+}
+
 Node* GetNodeByName(Graph& graph, std::string node_name) {
   GraphViewer graph_viewer(graph);
   const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
@@ -91,6 +91,62 @@ TEST(MemoryOptimizerTests, GeluRecompute) {
   ASSERT_EQ(recompute_gelu_node->MutableInputDefs()[0]->Name(), original_gelu_node->MutableInputDefs()[0]->Name());
 }
 
+TEST(MemoryOptimizerTests, GeluOffload) {
+  const logging::Logger* logger = &logging::LoggingManager::DefaultLogger();
+  auto model_uri = MODEL_FOLDER "recompute_gelu.onnx";
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, *logger));
+  Graph& graph = model->MainGraph();
+
+  // Offloading only applies to the activations in device memory.
+  for (auto& node : graph.Nodes()) {
+    node.SetExecutionProviderType(kCudaExecutionProvider);
+  }
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
+
+  const std::string alleviation_config("Offload(Gelu):3:-1");
+  const std::string probe_config("1:0");
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(
+      std::make_unique<MemoryOptimizer>(alleviation_config, probe_config), TransformerLevel::Level3));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level3, *logger));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["com.microsoft.Gelu"], 1);
+  ASSERT_EQ(op_to_count["MemcpyToHost"], 1);
+  ASSERT_EQ(op_to_count["MemcpyFromHost"], 1);
+
+  const Node* gelu_node{nullptr};
+  const Node* offload_node{nullptr};
+  const Node* prefetch_node{nullptr};
+  const Node* yield_op_node{nullptr};
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Gelu") {
+      gelu_node = &node;
+    } else if (node.OpType() == "MemcpyToHost") {
+      offload_node = &node;
+    } else if (node.OpType() == "MemcpyFromHost") {
+      prefetch_node = &node;
+    } else if (node.OpType() == "YieldOp") {
+      yield_op_node = &node;
+    }
+  }
+  ASSERT_TRUE(gelu_node && offload_node && prefetch_node && yield_op_node);
+
+  ASSERT_EQ(offload_node->InputDefs()[0]->Name(), gelu_node->OutputDefs()[0]->Name());
+  ASSERT_EQ(prefetch_node->InputDefs()[0]->Name(), offload_node->OutputDefs()[0]->Name());
+  ASSERT_EQ(offload_node->GetExecutionProviderType(), kCudaExecutionProvider);
+  // The copy to host memory runs in forward pass.
+  ASSERT_EQ(yield_op_node->ControlInputs().count(offload_node->Name()), 1U);
+
+  // The backward consumers read the prefetched activation.
+  ASSERT_GT(prefetch_node->GetOutputEdgesCount(), 0U);
+  for (auto it = prefetch_node->OutputNodesBegin(); it != prefetch_node->OutputNodesEnd(); ++it) {
+    ASSERT_NE(it->OpType(), "YieldOp");
+  }
+}
+
 TEST(MemoryOptimizerTests, TileRecompute) {
   const logging::Logger* logger = &logging::LoggingManager::DefaultLogger();
   auto model_uri = MODEL_FOLDER "recompute_tile.onnx";
@@ -581,4 +581,62 @@ TEST(CheckpointApiTest, SaveOnnxModelAsCheckpoint_ThenLoad_WithExternalData) {
   }
 }
 
+/**
+ * Save a checkpoint state with external data, including the optimizer states,
+ * Then load it, compare with the initial parameter and optimizer state values.
+ */
+TEST(CheckpointApiTest, SaveOptimizerStateAsCheckpoint_ThenLoad_WithExternalData) {
+  const std::vector<std::string> param_names{"fc1.weight", "fc1.bias"};
+  const std::vector<std::vector<int64_t>> param_shapes{{500, 784}, {500}};
+
+  CheckpointState state;
+  state.has_external_data = true;
+  auto group_state = std::make_shared<GroupOptimizerState>();
+  group_state->step = 3;
+  group_state->initial_lr = 0.001f;
+  for (size_t i = 0; i < param_names.size(); ++i) {
+    OrtValue param_value, momentum0, momentum1;
+    GenerateRandomInput(param_shapes[i], param_value);
+    GenerateRandomInput(param_shapes[i], momentum0);
+    GenerateRandomInput(param_shapes[i], momentum1);
+    state.module_checkpoint_state.named_parameters.insert(
+        {param_names[i], std::make_shared<Parameter>(param_names[i], param_value, true /*is_trainable*/)});
+    group_state->param_named_optimizer_states[param_names[i]] = {{"momentum0", momentum0}, {"momentum1", momentum1}};
+  }
+  state.optimizer_checkpoint_state.group_named_optimizer_states.insert({"group0", group_state});
+
+  auto ckpt_test_root_dir = ORT_TSTR("checkpointing_api_test_dir");
+  TemporaryDirectory tmp_dir{ckpt_test_root_dir};
+  PathString checkpoint_path{
+      ConcatPathComponent(tmp_dir.Path(), ORT_TSTR("e2e_ckpt_save_external_optimizer_state"))};
+  ASSERT_STATUS_OK(SaveCheckpoint(state, checkpoint_path, true));
+
+  // The momentums are written to the external data file along with the parameters.
+  constexpr size_t data_size = (500 * 784 + 500) * sizeof(float);
+  ASSERT_LT(std::filesystem::file_size(checkpoint_path), 2000);
+  ASSERT_GE(std::filesystem::file_size(ExternalCheckpointDataPath(checkpoint_path)), 3 * data_size);
+
+  CheckpointState loaded_state;
+  ASSERT_STATUS_OK(LoadCheckpoint(checkpoint_path, loaded_state));
+  ASSERT_TRUE(loaded_state.has_external_data);
+
+  const auto expect_equal = [](const OrtValue& expected, const OrtValue& actual) {
+    const Tensor& expected_tensor = expected.Get<Tensor>();
+    const Tensor& actual_tensor = actual.Get<Tensor>();
+    ASSERT_EQ(expected_tensor.Shape(), actual_tensor.Shape());
+    ASSERT_EQ(std::memcmp(expected_tensor.DataRaw(), actual_tensor.DataRaw(), expected_tensor.SizeInBytes()), 0);
+  };
+
+  auto& loaded_group_state = loaded_state.optimizer_checkpoint_state.group_named_optimizer_states.at("group0");
+  ASSERT_EQ(loaded_group_state->step, 3);
+  for (const auto& name : param_names) {
+    expect_equal(state.module_checkpoint_state.named_parameters.at(name)->Data(),
+                 loaded_state.module_checkpoint_state.named_parameters.at(name)->Data());
+    for (const std::string& momentum_name : {std::string("momentum0"), std::string("momentum1")}) {
+      expect_equal(group_state->param_named_optimizer_states.at(name).at(momentum_name),
+                   loaded_group_state->param_named_optimizer_states.at(name).at(momentum_name));
+    }
+  }
+}
+
 }  // namespace onnxruntime::training::test
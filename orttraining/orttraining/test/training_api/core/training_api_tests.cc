@@ -8,6 +8,7 @@
 
 #include "test/util/include/asserts.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "orttraining/training_api/utils.h"
 #include "orttraining/training_api/module.h"
 #include "orttraining/training_api/optimizer.h"
@@ -253,6 +254,74 @@ TEST(TrainingApiTest, ModuleCopyBufferToParameters) {
   }
 }
 
+TEST(TrainingApiTest, ModuleContiguousParameters) {
+  auto model_uri = MODEL_FOLDER "training_model.onnx";
+
+  onnxruntime::training::api::CheckpointState state;
+  auto checkpoint_to_load_path = MODEL_FOLDER "checkpoint.ckpt";
+  ASSERT_STATUS_OK(onnxruntime::training::api::LoadCheckpoint(checkpoint_to_load_path, state));
+
+  onnxruntime::SessionOptions session_option;
+  ASSERT_STATUS_OK(session_option.config_options.AddConfigEntry(kOrtSessionOptionsConfigTrainingContiguousParameters,
+                                                                "1"));
+  std::unique_ptr<Environment> env;
+  ASSERT_STATUS_OK(Environment::Create(nullptr, env));
+  auto model_identifier = ModelIdentifiers(onnxruntime::ToUTF8String(model_uri),
+                                           std::nullopt,
+                                           std::nullopt);
+  auto model = std::make_unique<onnxruntime::training::api::Module>(model_identifier,
+                                                                    &state, session_option,
+                                                                    *env, std::vector<std::shared_ptr<IExecutionProvider>>());
+
+  OrtValue gradients;
+  ASSERT_STATUS_OK(model->GetContiguousGradients(OrtDevice(), gradients));
+  const int64_t params_size = static_cast<int64_t>(model->GetParametersSize());
+  ASSERT_EQ(gradients.Get<Tensor>().Shape().Size(), params_size);
+
+  // The gradients are views into the contiguous gradient buffer.
+  const float* gradients_begin = gradients.Get<Tensor>().Data<float>();
+  const float* gradients_end = gradients_begin + params_size;
+  for (auto& param : model->Parameters()) {
+    if (param->RequiresGrad()) {
+      const float* gradient = param->Gradient().Get<Tensor>().Data<float>();
+      ASSERT_TRUE(gradient >= gradients_begin && gradient < gradients_end);
+    }
+  }
+
+  std::vector<float> expected_param_buffer(params_size);
+  GenerateRandomData(expected_param_buffer);
+  OrtValue input_params;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(),
+                       {params_size},
+                       reinterpret_cast<void*>(expected_param_buffer.data()),
+                       onnxruntime::test::TestCPUExecutionProvider()->CreatePreferredAllocators()[0]->Info(),
+                       input_params, 0);
+  ASSERT_STATUS_OK(model->CopyBufferToParameters(input_params));
+
+  OrtValue input, target;
+  GenerateRandomInput(std::array<int64_t, 2>{2, 784}, input);
+  target = onnxruntime::test::CreateInputOrtValueOnCPU<int32_t>(
+      std::array<int64_t, 1>{2}, std::vector<int32_t>(2, 1));
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(model->TrainStep({input, target}, fetches));
+
+  // The step accumulated the gradients in the contiguous buffer.
+  std::vector<float> grad_vec;
+  CpuOrtValueToVec(model->NamedParameters()["fc2.weight"]->Gradient(), grad_vec);
+  ASSERT_TRUE(std::any_of(grad_vec.begin(), grad_vec.end(), [](float value) { return value != 0.f; }));
+
+  // The weights were not updated by the training step.
+  OrtValue output_params;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), {params_size},
+                       onnxruntime::test::TestCPUExecutionProvider()->CreatePreferredAllocators()[0],
+                       output_params);
+  ASSERT_STATUS_OK(model->CopyParametersToBuffer(output_params));
+  const float* buffer = output_params.Get<Tensor>().Data<float>();
+  for (int64_t i = 0; i < params_size; i++) {
+    ASSERT_EQ(buffer[i], expected_param_buffer[i]);
+  }
+}
+
 TEST(TrainingApiTest, ModuleTrainStep) {
   auto model_uri = MODEL_FOLDER "training_model.onnx";
 
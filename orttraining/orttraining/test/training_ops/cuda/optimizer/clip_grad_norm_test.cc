@@ -52,6 +52,30 @@ void InplaceClipGradNormNoClippingTest(std::vector<std::unique_ptr<IExecutionPro
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, providers);
 }
 
+// The first gradient spans several of the chunks the CPU kernel splits the tensors into.
+void InplaceClipGradNormMultipleChunksTest(std::vector<std::unique_ptr<IExecutionProvider>>* providers) {
+  OpTester test("InplaceClipGradNorm", 1, onnxruntime::kMSDomain);
+
+  constexpr int64_t large_size = 40000;
+  SeqTensors<float> gradients_input;
+  gradients_input.AddTensor({large_size}, std::vector<float>(large_size, 0.5f));
+  gradients_input.AddTensor({3}, {2.f, 2.f, 2.f});
+
+  test.AddSeqInput<float>("gradients", gradients_input);
+
+  constexpr float max_norm = 10.f;
+  test.AddAttribute("max_norm", max_norm);
+
+  // total norm = sqrt(40000 * 0.25 + 3 * 4)
+  const float clip_coefficient = max_norm / (std::sqrt(10012.f) + 0.000001f);
+  SeqTensors<float> clipped_gradients;
+  clipped_gradients.AddTensor({large_size}, std::vector<float>(large_size, 0.5f * clip_coefficient));
+  clipped_gradients.AddTensor({3}, std::vector<float>(3, 2.f * clip_coefficient));
+  test.AddSeqOutput<float>("clipped_gradients", clipped_gradients);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, providers);
+}
+
 }  // namespace
 
 TEST(OptimizerTest, InplaceClipGradNorm_CPU) {
@@ -66,6 +90,12 @@ TEST(OptimizerTest, InplaceClipGradNormNoClipping_CPU) {
   InplaceClipGradNormNoClippingTest(&providers);
 }
 
+TEST(OptimizerTest, InplaceClipGradNormMultipleChunks_CPU) {
+  std::vector<std::unique_ptr<IExecutionProvider>> providers;
+  providers.emplace_back(DefaultCpuExecutionProvider());
+  InplaceClipGradNormMultipleChunksTest(&providers);
+}
+
 #ifdef USE_CUDA
 
 TEST(OptimizerTest, InplaceClipGradNorm_CUDA) {
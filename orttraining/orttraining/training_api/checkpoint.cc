@@ -8,6 +8,7 @@
 #include "core/framework/framework_common.h"
 #include "core/graph/graph_flatbuffers_utils.h"
 #include "core/framework/tensor_external_data_info.h"
+#include "core/platform/env.h"
 
 namespace onnxruntime::training::api {
 
@@ -18,19 +19,40 @@ PathString ExternalCheckpointDataPath(const PathString& checkpoint_path) {
 namespace {
 
 /**
- * @brief Helper method to read data from an external file.
- * @param external_data_stream Stream that data will be read from.
+ * @brief Helper method to map a file into memory, so that its pages are read on access instead of copying the whole
+ *        file to a buffer first.
+ * @param path Path of the file.
+ * @param mapped_memory The mapped memory, which is unmapped when destroyed.
+ * @param bytes The contents of the file. Empty if the file is empty.
+ * @return Status of the operation.
+ */
+Status MapFileHelper(const PathString& path, Env::MappedMemoryPtr& mapped_memory, gsl::span<const uint8_t>& bytes) {
+  size_t num_bytes = 0;
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(path.c_str(), num_bytes));
+  if (num_bytes == 0) {
+    bytes = {};
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(path.c_str(), 0, num_bytes, mapped_memory));
+  bytes = gsl::make_span(reinterpret_cast<const uint8_t*>(mapped_memory.get()), num_bytes);
+
+  return Status::OK();
+}
+
+/**
+ * @brief Helper method to read data from the mapped external data file.
+ * @param external_data Contents of the external data file.
  * @param offset Offset in the external data file to begin reading from.
  * @param output_buffer Buffer to store the read data.
  * @return Status of the operation.
  */
-Status ReadFromExternalFileHelper(std::ifstream& external_data_stream,
+Status ReadFromExternalDataHelper(gsl::span<const uint8_t> external_data,
                                   uint64_t offset, gsl::span<uint8_t> output_buffer) {
-  external_data_stream.seekg(offset);
-  external_data_stream.read(reinterpret_cast<char*>(output_buffer.data()), output_buffer.size());
-
-  const auto [err, msg] = GetErrnoInfo();
-  ORT_RETURN_IF(external_data_stream.fail(), "Failed reading external checkpoint data. ", msg, " errno:", errno);
+  ORT_RETURN_IF(offset > external_data.size() || output_buffer.size() > external_data.size() - offset,
+                "Failed reading external checkpoint data. Expected ", output_buffer.size(), " bytes at offset ",
+                offset, " of the ", external_data.size(), " bytes of the external data file.");
+  std::copy_n(external_data.data() + offset, output_buffer.size(), output_buffer.data());
 
   return Status::OK();
 }
@@ -438,11 +460,13 @@ Status FromModuleState(const ModuleCheckpointState& module_state,
  *                        and second order momentums ...).
  * @param builder Flatbuffer builder.
  * @param fbs_optimizer_groups Flatbuffer optimizer groups to be populated.
+ * @param external_data_writer Optional delegate to write tensor data to an external file.
  * @return Status of the operation.
  */
 Status FromOptimizerState(const OptimizerCheckpointState& optimizer_state,
                           flatbuffers::FlatBufferBuilder& builder,
-                          std::vector<flatbuffers::Offset<fbs::OptimizerGroup>>& fbs_optimizer_groups) {
+                          std::vector<flatbuffers::Offset<fbs::OptimizerGroup>>& fbs_optimizer_groups,
+                          fbs::utils::ExternalDataWriter external_data_writer = nullptr) {
   if (optimizer_state.group_named_optimizer_states.empty()) {
     return Status::OK();
   }
@@ -462,7 +486,7 @@ Status FromOptimizerState(const OptimizerCheckpointState& optimizer_state,
       ORT_RETURN_IF_ERROR(FlatbufferTensorsFromOrtValues(
           param_optimizer_state,
           optimizer_state.optimizer_session_data_transfer_mgr,
-          builder, momentums));
+          builder, momentums, external_data_writer));
 
       const auto fbs_param_name = builder.CreateString(param_name);
       const auto fbs_momentums = builder.CreateVector(momentums);
@@ -558,9 +582,29 @@ Status FromCheckpointState(
     const CheckpointState& state, const PathString& checkpoint_path, const bool include_optimizer_state) {
   flatbuffers::FlatBufferBuilder builder(1024);
 
+  // The tensor data is streamed to the external data file instead of being copied to the flatbuffer when the
+  // checkpoint was loaded with external data, or when the flatbuffer would get close to its 2GB limit. The external
+  // data is only read back with a module state, which holds the has_external_data flag.
+  size_t tensor_bytes = 0;
+  for (const auto& [name, param] : state.module_checkpoint_state.named_parameters) {
+    tensor_bytes += param->Data().Get<Tensor>().SizeInBytes();
+  }
+  if (include_optimizer_state) {
+    for (const auto& [group_name, group_state] : state.optimizer_checkpoint_state.group_named_optimizer_states) {
+      for (const auto& [param_name, momentums] : group_state->param_named_optimizer_states) {
+        for (const auto& [momentum_name, momentum] : momentums) {
+          tensor_bytes += momentum.Get<Tensor>().SizeInBytes();
+        }
+      }
+    }
+  }
+  const bool use_external_data = state.has_external_data ||
+                                 (!state.module_checkpoint_state.named_parameters.empty() &&
+                                  tensor_bytes >= kExternalDataThreshold);
+
   fbs::utils::ExternalDataWriter external_data_writer = nullptr;
   std::optional<std::ofstream> external_data_stream;
-  if (state.has_external_data) {
+  if (use_external_data) {
     auto data_path = ExternalCheckpointDataPath(checkpoint_path);
     external_data_stream = std::ofstream(data_path, std::ios::binary);
 
@@ -581,7 +625,13 @@ Status FromCheckpointState(
   // Write optimizer state tensors files.
   std::vector<flatbuffers::Offset<fbs::OptimizerGroup>> optimizer_groups;
   if (include_optimizer_state) {
-    ORT_RETURN_IF_ERROR(FromOptimizerState(state.optimizer_checkpoint_state, builder, optimizer_groups));
+    ORT_RETURN_IF_ERROR(FromOptimizerState(state.optimizer_checkpoint_state, builder, optimizer_groups,
+                                           external_data_writer));
+  }
+
+  if (external_data_stream) {
+    ORT_RETURN_IF(external_data_stream->fail(), "Failed writing external checkpoint data.");
+    external_data_stream->close();
   }
 
   flatbuffers::Offset<fbs::PropertyBag> property_bag;
@@ -607,21 +657,16 @@ namespace load {
 /**
  * @brief Load checkpoint flatbuffer from file.
  * @param checkpoint_path Path to the checkpoint file.
+ * @param checkpoint_memory Memory the checkpoint file is mapped to.
  * @param checkpoint_bytes Contents of the checkpoint file in bytes.
- * @param checkpoint_span Checkpoint bytes represented as a span.
  * @return Status of the operation.
  *
  */
-Status FromFile(const PathString& checkpoint_path, InlinedVector<uint8_t>& checkpoint_bytes) {
-  size_t num_bytes = 0;
-  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(checkpoint_path.c_str(), num_bytes));
-  checkpoint_bytes.resize(num_bytes);
-
-  std::ifstream bytes_stream(checkpoint_path, std::ifstream::in | std::ifstream::binary);
-  bytes_stream.read(reinterpret_cast<char*>(checkpoint_bytes.data()), num_bytes);
-
-  ORT_RETURN_IF_NOT(bytes_stream, "Loading checkpoint from ", ToUTF8String(checkpoint_path), " failed. Only ",
-                    bytes_stream.gcount(), "/", num_bytes, " bytes could be read.");
+Status FromFile(const PathString& checkpoint_path, Env::MappedMemoryPtr& checkpoint_memory,
+                gsl::span<const uint8_t>& checkpoint_bytes) {
+  ORT_RETURN_IF_ERROR(MapFileHelper(checkpoint_path, checkpoint_memory, checkpoint_bytes));
+  ORT_RETURN_IF(checkpoint_bytes.empty(), "Loading checkpoint from ", ToUTF8String(checkpoint_path),
+                " failed. The file is empty.");
 
   return Status::OK();
 }
@@ -806,16 +851,16 @@ Status ToModelProto(gsl::span<const uint8_t> checkpoint_bytes,
                 "Expected: Complete checkpoint. Actual: Nominal checkpoint.");
 
   fbs::utils::ExternalDataReader external_data_reader = nullptr;
-  std::optional<std::ifstream> external_data_stream;
+  Env::MappedMemoryPtr external_data_memory;
+  gsl::span<const uint8_t> external_data;
 
   if (module_state->has_external_data()) {
     auto data_path = ExternalCheckpointDataPath(checkpoint_path);
-    external_data_stream = std::ifstream(data_path, std::ios::binary);
-    ORT_RETURN_IF(external_data_stream->fail(),
-                  "Failed to open checkpoint's external data file: ", ToUTF8String(data_path));
+    ORT_RETURN_IF_NOT(MapFileHelper(data_path, external_data_memory, external_data).IsOK(),
+                      "Failed to open checkpoint's external data file: ", ToUTF8String(data_path));
 
-    external_data_reader = [&external_data_stream](uint64_t offset, gsl::span<uint8_t> output_buffer) {
-      return ReadFromExternalFileHelper(external_data_stream.value(), offset, output_buffer);
+    external_data_reader = [external_data](uint64_t offset, gsl::span<uint8_t> output_buffer) {
+      return ReadFromExternalDataHelper(external_data, offset, output_buffer);
     };
   }
 
@@ -876,7 +921,8 @@ Status ToCheckpointState(gsl::span<const uint8_t> checkpoint_bytes, CheckpointSt
   const auto* fbs_module_state = fbs_checkpoint->module_state();
 
   fbs::utils::ExternalDataReader external_data_reader = nullptr;
-  std::optional<std::ifstream> external_data_stream;
+  Env::MappedMemoryPtr external_data_memory;
+  gsl::span<const uint8_t> external_data;
 
   state.has_external_data = false;
   if (nullptr != fbs_module_state && fbs_module_state->has_external_data()) {
@@ -884,17 +930,15 @@ Status ToCheckpointState(gsl::span<const uint8_t> checkpoint_bytes, CheckpointSt
     ORT_RETURN_IF_NOT(checkpoint_path.has_value(),
                       "External data is present in the checkpoint but the checkpoint path is not provided. External data with loading from buffer is not supported yet.");
     auto data_path = ExternalCheckpointDataPath(*checkpoint_path);
-    external_data_stream = std::ifstream(data_path, std::ios::binary);
-
-    if (external_data_stream.value().fail()) {
-      const auto [err, errmsg] = GetErrnoInfo();
+    // The external data is mapped, the tensors are copied from it as they are loaded.
+    if (const auto status = MapFileHelper(data_path, external_data_memory, external_data); !status.IsOK()) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Failed to open checkpoint's external data file: ", ToUTF8String(data_path),
-                             " error:", errmsg, " errno:", err);
+                             " error:", status.ErrorMessage());
     }
 
-    external_data_reader = [&external_data_stream](uint64_t offset, gsl::span<uint8_t> output_buffer) {
-      return ReadFromExternalFileHelper(external_data_stream.value(), offset, output_buffer);
+    external_data_reader = [external_data](uint64_t offset, gsl::span<uint8_t> output_buffer) {
+      return ReadFromExternalDataHelper(external_data, offset, output_buffer);
     };
   }
 
@@ -957,8 +1001,9 @@ Status SaveCheckpoint(const CheckpointState& states, const PathString& checkpoin
 Status LoadCheckpoint(const PathString& checkpoint_path, CheckpointState& checkpoint_states) {
   ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
 
-  InlinedVector<uint8_t> checkpoint_bytes;
-  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_bytes));
+  Env::MappedMemoryPtr checkpoint_memory;
+  gsl::span<const uint8_t> checkpoint_bytes;
+  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_memory, checkpoint_bytes));
   return load::ToCheckpointState(checkpoint_bytes, checkpoint_states, checkpoint_path);
 }
 
@@ -973,8 +1018,9 @@ Status LoadCheckpointToModel(const PathString& checkpoint_path,
                              ONNX_NAMESPACE::ModelProto& model_proto) {
   ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
 
-  InlinedVector<uint8_t> checkpoint_bytes;
-  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_bytes));
+  Env::MappedMemoryPtr checkpoint_memory;
+  gsl::span<const uint8_t> checkpoint_bytes;
+  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_memory, checkpoint_bytes));
   return load::ToModelProto(checkpoint_bytes, model_proto, checkpoint_path);
 }
 #endif
@@ -33,6 +33,12 @@ struct CheckpointState {
   bool has_external_data = false;
 };
 
+/**
+ * Size in bytes of the tensor data from which a checkpoint is saved with external data. The flatbuffer file uses
+ * 32-bit offsets and cannot exceed 2GB, the threshold leaves room for the names and shapes of the tensors.
+ */
+constexpr size_t kExternalDataThreshold = 1800 * 1024 * 1024;  // 1.8GB
+
 /**
  * @brief Get the external data path for a given checkpoint path.
  *
@@ -45,6 +51,8 @@ PathString ExternalCheckpointDataPath(const PathString& checkpoint_path);
  *
  * @param state parameter/optimizer and other user defined training states.
  * @param checkpoint_path file where checkpoint is saved.
+ * @remarks The data of the parameters and optimizer states is written to the external data file, without being
+ *          copied to the flatbuffer, if the state has external data or if it exceeds kExternalDataThreshold.
  * @return Status
  */
 Status SaveCheckpoint(const CheckpointState& state, const PathString& checkpoint_path,
@@ -69,7 +77,7 @@ Status SaveCheckpoint(const CheckpointState& state, const PathString& checkpoint
 Status SaveCheckpoint(gsl::span<const ONNX_NAMESPACE::TensorProto> trainable_tensor_protos,
                       gsl::span<const ONNX_NAMESPACE::TensorProto> non_trainable_tensor_protos,
                       const PathString& checkpoint_path, const bool nominal_checkpoint,
-                      const size_t external_data_threshold = 1800 * 1024 * 1024);  // 1.8GB default
+                      const size_t external_data_threshold = kExternalDataThreshold);
 #endif
 
 /**
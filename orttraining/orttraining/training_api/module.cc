@@ -3,6 +3,8 @@
 
 #include "orttraining/training_api/module.h"
 
+#include <algorithm>
+
 #include "core/common/safeint.h"
 #include "core/common/string_utils.h"
 #include "core/framework/execution_provider.h"
@@ -293,6 +295,9 @@ Module::Module(const ModelIdentifiers& model_identifiers,
         .config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "1";
   }
 
+  use_contiguous_buffers_ = session_options.config_options.GetConfigOrDefault(
+                               kOrtSessionOptionsConfigTrainingContiguousParameters, "0") == "1";
+
   train_sess_ = std::make_unique<onnxruntime::InferenceSession>(session_options, env);
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_MINIMAL_BUILD_CUSTOM_OPS)
   if (!op_domains.empty()) {
@@ -364,6 +369,10 @@ Module::Module(const ModelIdentifiers& model_identifiers,
         gradients_[param_to_grad_index.at(param_name)] = params_iter->second->Gradient();
       }
     }
+
+    if (use_contiguous_buffers_) {
+      ORT_THROW_IF_ERROR(MoveParametersToContiguousBuffers());
+    }
   }
 
   if (model_identifiers.IsEvalModelAvailable()) {
@@ -490,6 +499,14 @@ Status Module::CopyParametersToBuffer(OrtValue& parameters_buffer, const bool tr
 
   const DataTransferManager& sess_data_transfer_manager = train_sess_->GetDataTransferManager();
 
+  if (trainable_only && contiguous_buffers_.size() == 1 && contiguous_buffers_[0].float_only &&
+      onnxruntime::utils::IsPrimitiveDataType<float>(init_tensor->DataType())) {
+    // The trainable parameters are already laid out as in the buffer.
+    const Tensor weights(init_tensor->DataType(), init_tensor->Shape(), contiguous_buffers_[0].weights.get(),
+                         contiguous_buffers_[0].allocator->Info());
+    return sess_data_transfer_manager.CopyTensor(weights, *init_tensor);
+  }
+
   size_t offset = 0;
   for (const auto& param_name : train_input_names_.WeightsInputNames()) {
     auto& param = state_->module_checkpoint_state.named_parameters.at(param_name);
@@ -539,6 +556,15 @@ Status Module::CopyBufferToParameters(OrtValue& parameters_buffer, const bool tr
 
   auto& train_sess_state = train_sess_->GetSessionState();
   const DataTransferManager& sess_data_transfer_manager = train_sess_->GetDataTransferManager();
+
+  if (trainable_only && contiguous_buffers_.size() == 1 && contiguous_buffers_[0].float_only &&
+      onnxruntime::utils::IsPrimitiveDataType<float>(buffer_tensor->DataType())) {
+    // The trainable parameters are already laid out as in the buffer.
+    Tensor weights(buffer_tensor->DataType(), buffer_tensor->Shape(), contiguous_buffers_[0].weights.get(),
+                   contiguous_buffers_[0].allocator->Info());
+    return sess_data_transfer_manager.CopyTensor(*buffer_tensor, weights);
+  }
+
   const auto model_inputs_with_error = GetTrainingModelInputs();
   ORT_RETURN_IF_ERROR(model_inputs_with_error.first);
   ORT_RETURN_IF_NOT(model_inputs_with_error.second, "Training model graph inputs are not defined.");
@@ -607,6 +633,9 @@ Status Module::CopyBufferToParameters(OrtValue& parameters_buffer, const bool tr
   if (state_->module_checkpoint_state.is_nominal_state) {
     // Once the parameters are loaded, the state is no longer a nominal state.
     state_->module_checkpoint_state.is_nominal_state = false;
+    if (use_contiguous_buffers_) {
+      ORT_RETURN_IF_ERROR(MoveParametersToContiguousBuffers());
+    }
   }
 
   return Status::OK();
@@ -722,6 +751,117 @@ std::pair<common::Status, const InputDefList*> Module::GetEvalModelInputs() cons
   return eval_sess_->GetModelInputs();
 }
 
+Status Module::GetContiguousGradients(const OrtDevice& device, OrtValue& gradients) const {
+  ORT_RETURN_IF_NOT(use_contiguous_buffers_, "The module was not created with contiguous parameters.");
+  for (const auto& buffer : contiguous_buffers_) {
+    if (buffer.allocator->Info().device == device) {
+      ORT_RETURN_IF_NOT(buffer.float_only, "The trainable parameters on device ", device.ToString(),
+                        " are not all float.");
+      auto gradients_tensor = std::make_unique<Tensor>(DataTypeImpl::GetType<float>(),
+                                                       TensorShape({static_cast<int64_t>(buffer.size_in_bytes /
+                                                                                         sizeof(float))}),
+                                                       buffer.gradients.get(), buffer.allocator->Info());
+      auto ml_tensor_type = DataTypeImpl::GetType<Tensor>();
+      gradients.Init(gradients_tensor.release(), ml_tensor_type,
+                     [buffer_gradients = buffer.gradients](void* p) { delete static_cast<Tensor*>(p); });
+      return Status::OK();
+    }
+  }
+  return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "No trainable parameter on device ", device.ToString());
+}
+
+Status Module::MoveParametersToContiguousBuffers() {
+  const auto& session_state = train_sess_->GetSessionState();
+  const DataTransferManager& data_transfer_manager = train_sess_->GetDataTransferManager();
+
+  // Place the trainable parameters of each device one after the other, in the order of the weight inputs, at offsets
+  // aligned to their element size. For float parameters this is the layout of CopyParametersToBuffer.
+  struct Placement {
+    Parameter* param;
+    size_t buffer_index;
+    size_t offset;
+  };
+  InlinedVector<Placement> placements;
+  contiguous_buffers_.clear();
+  for (const auto& param_name : train_input_names_.WeightsInputNames()) {
+    auto& param = state_->module_checkpoint_state.named_parameters.at(param_name);
+    if (!param->RequiresGrad()) {
+      continue;
+    }
+
+    const Tensor& weight = param->Data().Get<Tensor>();
+    const OrtDevice& device = weight.Location().device;
+    auto buffer_it = std::find_if(contiguous_buffers_.begin(), contiguous_buffers_.end(),
+                                  [&device](const ContiguousBuffers& buffer) {
+                                    return buffer.allocator->Info().device == device;
+                                  });
+    if (buffer_it == contiguous_buffers_.end()) {
+      AllocatorPtr allocator = session_state.GetAllocator(device);
+      ORT_RETURN_IF(allocator == nullptr, "No allocator for the parameters on device ", device.ToString());
+      contiguous_buffers_.push_back({std::move(allocator)});
+      buffer_it = contiguous_buffers_.end() - 1;
+    }
+
+    const size_t element_size = weight.DataType()->Size();
+    const size_t offset = (buffer_it->size_in_bytes + element_size - 1) / element_size * element_size;
+    placements.push_back({param.get(), static_cast<size_t>(buffer_it - contiguous_buffers_.begin()), offset});
+    buffer_it->size_in_bytes = offset + weight.SizeInBytes();
+    buffer_it->float_only = buffer_it->float_only && weight.IsDataType<float>();
+  }
+
+  for (auto& buffer : contiguous_buffers_) {
+    buffer.weights = IAllocator::MakeUniquePtr<void>(buffer.allocator, buffer.size_in_bytes);
+    buffer.gradients = IAllocator::MakeUniquePtr<void>(buffer.allocator, buffer.size_in_bytes);
+
+    // The gradients start at zero, as the ones of LoadParameter.
+    const OrtMemoryInfo& location = buffer.allocator->Info();
+    if (location.device.Type() == OrtDevice::CPU) {
+      memset(buffer.gradients.get(), 0, buffer.size_in_bytes);
+    } else {
+      const auto shape = TensorShape({static_cast<int64_t>(buffer.size_in_bytes)});
+      Tensor zeros(DataTypeImpl::GetType<uint8_t>(), shape, session_state.GetAllocator(OrtDevice()));
+      memset(zeros.MutableDataRaw(), 0, buffer.size_in_bytes);
+      Tensor gradients(DataTypeImpl::GetType<uint8_t>(), shape, buffer.gradients.get(), location);
+      ORT_RETURN_IF_ERROR(data_transfer_manager.CopyTensor(zeros, gradients));
+    }
+  }
+
+  auto ml_tensor_type = DataTypeImpl::GetType<Tensor>();
+  for (const auto& placement : placements) {
+    const ContiguousBuffers& buffer = contiguous_buffers_[placement.buffer_index];
+    const Tensor& weight = placement.param->Data().Get<Tensor>();
+
+    // The views keep the buffers alive.
+    auto weight_view = std::make_unique<Tensor>(weight.DataType(), weight.Shape(),
+                                                static_cast<uint8_t*>(buffer.weights.get()) + placement.offset,
+                                                buffer.allocator->Info());
+    ORT_RETURN_IF_ERROR(data_transfer_manager.CopyTensor(weight, *weight_view));
+    auto gradient_view = std::make_unique<Tensor>(weight.DataType(), weight.Shape(),
+                                                  static_cast<uint8_t*>(buffer.gradients.get()) + placement.offset,
+                                                  buffer.allocator->Info());
+
+    placement.param->Data().Init(weight_view.release(), ml_tensor_type,
+                                 [weights = buffer.weights](void* p) { delete static_cast<Tensor*>(p); });
+    OrtValue gradient;
+    gradient.Init(gradient_view.release(), ml_tensor_type,
+                  [gradients = buffer.gradients](void* p) { delete static_cast<Tensor*>(p); });
+    ORT_RETURN_IF_ERROR(placement.param->SetGrad(placement.param->GradientName(), gradient));
+  }
+
+  // Feed the views to the training session.
+  const auto param_to_grad_index = BuildParameterToGradInputIndexMap(train_input_names_.GradientInputNames());
+  weights_.clear();
+  for (const auto& param_name : train_input_names_.WeightsInputNames()) {
+    auto& param = state_->module_checkpoint_state.named_parameters.at(param_name);
+    weights_.push_back(param->Data());
+    if (param->RequiresGrad()) {
+      gradients_[param_to_grad_index.at(param_name)] = param->Gradient();
+    }
+  }
+
+  return Status::OK();
+}
+
 Module::TrainInputNames::TrainInputNames(gsl::span<const std::string> user_input_names,
                                          gsl::span<const std::string> weights_input_names,
                                          gsl::span<const std::string> gradient_input_names) {
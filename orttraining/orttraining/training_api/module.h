@@ -164,7 +164,14 @@ struct Module {
   // Returns the input definitions of the Eval model
   std::pair<common::Status, const InputDefList*> GetEvalModelInputs() const noexcept;
 
+  // Returns the contiguous gradient buffer of the trainable parameters on the given device as a flat float tensor,
+  // when the module was created with kOrtSessionOptionsConfigTrainingContiguousParameters and all the trainable
+  // parameters of the device are float. The gradients are views into it, e.g. to all-reduce them in one call.
+  Status GetContiguousGradients(const OrtDevice& device, OrtValue& gradients) const;
+
  private:
+  // Reallocates the trainable parameters and their gradients in one buffer per device.
+  Status MoveParametersToContiguousBuffers();
   std::unique_ptr<onnxruntime::InferenceSession> train_sess_{nullptr};
   std::unique_ptr<onnxruntime::InferenceSession> eval_sess_{nullptr};
 
@@ -194,6 +201,20 @@ struct Module {
   InlinedVector<OrtValue> weights_;
   InlinedVector<OrtValue> gradients_;
 
+  // The trainable parameters and gradients of a device, allocated contiguously when
+  // kOrtSessionOptionsConfigTrainingContiguousParameters is set. The parameter and gradient values hold a reference
+  // to the buffers, which outlive the module if the checkpoint state does.
+  struct ContiguousBuffers {
+    AllocatorPtr allocator;
+    size_t size_in_bytes{0U};
+    bool float_only{true};
+    std::shared_ptr<void> weights;
+    std::shared_ptr<void> gradients;
+  };
+
+  InlinedVector<ContiguousBuffers> contiguous_buffers_;
+  bool use_contiguous_buffers_ = false;
+
   CheckpointState* state_;  // Non owning pointer to the state.
 
   bool accumulate_gradient_ = false;
@@ -7,7 +7,6 @@
 #include "core/framework/TensorSeq.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
-#include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
@@ -89,47 +88,53 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("S_MOMENT", DataTypeImpl::AllFixedSizeSequenceTensorTypes()),
     AdamWOptimizer<float>);
 
+// The updates below are fused into a single pass over each chunk of the tensors, the weight, gradient and momentums
+// being read and written once per step instead of once per Eigen expression.
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode0(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float alpha_correction, float beta_correction) const {
-  // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (MakeEigenArrayMap<T>(weight) * lr * weight_decay_);
-
-  // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
-
-  // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
-
-  // Compute the new weight.
-  auto denom = (MakeEigenArrayMap<T>(momentums_2) / beta_correction).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr * MakeEigenArrayMap<T>(momentums_1)) / (alpha_correction * denom);
-
-  return Status::OK();
+void AdamWOptimizer<T>::AdamWComputeMode0(T* weight, const T* gradient, T* momentums_1, T* momentums_2, int count,
+                                          float lr, float alpha_correction, float beta_correction) const {
+  for (int i = 0; i < count; ++i) {
+    // Perform weight decay.
+    T w = weight[i] - (weight[i] * lr * weight_decay_);
+
+    // Compute exponentially-averaged historical gradient.
+    const T g = gradient[i];
+    const T m1 = alpha_ * momentums_1[i] + (1.f - alpha_) * g;
+
+    // Compute exponentially-averaged historical squared gradient.
+    const T m2 = beta_ * momentums_2[i] + (1.f - beta_) * g * g;
+
+    // Compute the new weight.
+    const T denom = std::sqrt(m2 / beta_correction) + epsilon_;
+    w = w - (lr * m1) / (alpha_correction * denom);
+
+    momentums_1[i] = m1;
+    momentums_2[i] = m2;
+    weight[i] = w;
+  }
 }
 
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode1(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float lr_corrected) const {
-  // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
+void AdamWOptimizer<T>::AdamWComputeMode1(T* weight, const T* gradient, T* momentums_1, T* momentums_2, int count,
+                                          float lr, float lr_corrected) const {
+  for (int i = 0; i < count; ++i) {
+    // Compute exponentially-averaged historical gradient.
+    const T g = gradient[i];
+    const T m1 = alpha_ * momentums_1[i] + (1.f - alpha_) * g;
 
-  // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
+    // Compute exponentially-averaged historical squared gradient.
+    const T m2 = beta_ * momentums_2[i] + (1.f - beta_) * g * g;
 
-  auto denom = MakeEigenArrayMap<T>(momentums_2).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr_corrected * MakeEigenArrayMap<T>(momentums_1) / denom);
+    const T denom = std::sqrt(m2) + epsilon_;
+    T w = weight[i] - (lr_corrected * m1 / denom);
 
-  // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (lr * weight_decay_ * MakeEigenArrayMap<T>(weight));
+    // Perform weight decay.
+    w = w - (lr * weight_decay_ * w);
 
-  return Status::OK();
+    momentums_1[i] = m1;
+    momentums_2[i] = m2;
+    weight[i] = w;
+  }
 }
 
 template <typename T>
@@ -165,22 +170,25 @@ Status AdamWOptimizer<T>::Compute(OpKernelContext* ctx) const {
     //         bias correction is applied on learning rate, then use lr_corrected for subsequent computations.
     //         weight decay is applied after weight is updated.
 
-    for (size_t weight_index = 0; weight_index < p.num_of_weights; ++weight_index) {
-      Tensor& weight = const_cast<Tensor&>(p.weights->Get(weight_index));
-      Tensor& gradient = const_cast<Tensor&>(p.gradients->Get(weight_index));
-      Tensor& momentums_1 = const_cast<Tensor&>(p.momentums_1->Get(weight_index));
-      Tensor& momentums_2 = const_cast<Tensor&>(p.momentums_2->Get(weight_index));
-
-      if (adam_mode_ == 0) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode0(weight, gradient, momentums_1, momentums_2, lr, alpha_correction, beta_correction));
-      } else if (adam_mode_ == 1) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode1(weight, gradient, momentums_1, momentums_2, lr, lr_corrected));
-      } else {
-        ORT_THROW("Unsupported Adamw optimizer mode.");
-      }
-    }
+    ORT_RETURN_IF_NOT(adam_mode_ == 0 || adam_mode_ == 1, "Unsupported Adamw optimizer mode.");
+
+    // All the weights are updated in one parallel loop over chunks of their elements.
+    static constexpr double cost_per_element = 16.0;
+    MultiTensorParallelFor(
+        ctx->GetOperatorThreadPool(), p.grouped_tensor_sizes, cost_per_element,
+        [this, &p, lr, alpha_correction, beta_correction, lr_corrected](int tensor_index, int offset, int count) {
+          const auto& pointers = p.grouped_tensor_pointers[tensor_index];
+          T* weight = static_cast<T*>(pointers[0]) + offset;
+          const T* gradient = static_cast<const T*>(pointers[1]) + offset;
+          T* momentums_1 = static_cast<T*>(pointers[2]) + offset;
+          T* momentums_2 = static_cast<T*>(pointers[3]) + offset;
+          if (adam_mode_ == 0) {
+            AdamWComputeMode0(weight, gradient, momentums_1, momentums_2, count, lr, alpha_correction,
+                              beta_correction);
+          } else {
+            AdamWComputeMode1(weight, gradient, momentums_1, momentums_2, count, lr, lr_corrected);
+          }
+        });
 
     *updated_flag_ptr = true;
   } else {
@@ -1,11 +1,12 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/common/narrow.h"
 #include "core/framework/TensorSeq.h"
 #include "orttraining/training_ops/cpu/optimizer/clip_grad_norm/clip_grad_norm.h"
-#include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/cpu/reduction/reduction_ops.h"
+#include "orttraining/training_ops/cpu/optimizer/common.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -14,26 +15,59 @@ namespace {
 
 constexpr float Epsilon = 0.000001f;
 
+// The gradient sizes, for the multi-tensor loops.
+std::vector<int> GetTensorSizes(const TensorSeq& gradients) {
+  std::vector<int> sizes;
+  sizes.reserve(gradients.Size());
+  for (const auto& tensor : gradients) {
+    sizes.push_back(narrow<int>(tensor.Get<Tensor>().Shape().Size()));
+  }
+  return sizes;
+}
+
 template <typename T>
-T GetL2Norm(const TensorSeq& gradients) {
+T GetL2Norm(concurrency::ThreadPool* tp, const TensorSeq& gradients, const std::vector<int>& sizes) {
+  // The chunks accumulate in their own slot, which are summed in order so that the norm does not depend on the
+  // scheduling of the chunks.
+  std::vector<int> first_chunk(sizes.size() + 1, 0);
+  for (size_t i = 0; i < sizes.size(); i++) {
+    first_chunk[i + 1] = first_chunk[i] + (sizes[i] + kMultiTensorChunkSize - 1) / kMultiTensorChunkSize;
+  }
+  std::vector<T> partial_sums(first_chunk.back(), T(0));
+
+  static constexpr double cost_per_element = 2.0;
+  MultiTensorParallelFor(
+      tp, sizes, cost_per_element,
+      [&gradients, &first_chunk, &partial_sums](int tensor_index, int offset, int count) {
+        const T* data = gradients.Get(tensor_index).Data<T>() + offset;
+        partial_sums[first_chunk[tensor_index] + offset / kMultiTensorChunkSize] =
+            ReduceAggregatorSumSquare<T>(count, *data).aggall(data);
+      });
+
   T l2_norm = 0;
-  for (const auto& tensor : gradients) {
-    l2_norm +=
-        ReduceAggregatorSumSquare<T>(tensor.Get<Tensor>().Shape().Size(), *tensor.Get<Tensor>().Data<T>()).aggall(tensor.Get<Tensor>().Data<T>());
+  for (const T partial_sum : partial_sums) {
+    l2_norm += partial_sum;
   }
   return reduce_sqrt<T>(l2_norm);
 }
 
 template <typename T>
-void ClipGradNorm(T total_norm, T max_norm, TensorSeq& gradients) {
+void ClipGradNorm(concurrency::ThreadPool* tp, T total_norm, T max_norm, TensorSeq& gradients,
+                  const std::vector<int>& sizes) {
   const T clip_coefficient = std::min(max_norm / (total_norm + static_cast<T>(Epsilon)), static_cast<T>(1.0f));
-
-  auto gradients_size = gradients.Size();
-  for (size_t i = 0; i < gradients_size; i++) {
-    const auto& grad = gradients.Get(i);
-    auto& tensor = const_cast<Tensor&>(grad);
-    MakeEigenArrayMap<T>(tensor) *= clip_coefficient;
+  if (clip_coefficient == static_cast<T>(1.0f)) {
+    return;
   }
+
+  static constexpr double cost_per_element = 1.0;
+  MultiTensorParallelFor(
+      tp, sizes, cost_per_element,
+      [&gradients, clip_coefficient](int tensor_index, int offset, int count) {
+        T* data = const_cast<T*>(gradients.Get(tensor_index).Data<T>()) + offset;
+        for (int i = 0; i < count; ++i) {
+          data[i] *= clip_coefficient;
+        }
+      });
 }
 
 Status PopulateOutput(OpKernelContext* ctx, const TensorSeq* gradients, TensorSeq* clipped_gradients) {
@@ -75,10 +109,12 @@ template <typename T>
 Status InplaceClipGradNorm<T>::Compute(OpKernelContext* ctx) const {
   const TensorSeq* gradients = ctx->Input<TensorSeq>(0);
 
-  const T total_norm = GetL2Norm<T>(*gradients);
+  auto* tp = ctx->GetOperatorThreadPool();
+  const std::vector<int> sizes = GetTensorSizes(*gradients);
+  const T total_norm = GetL2Norm<T>(tp, *gradients, sizes);
 
   auto grads = const_cast<TensorSeq*>(gradients);
-  ClipGradNorm(total_norm, max_norm_, *grads);
+  ClipGradNorm(tp, total_norm, static_cast<T>(max_norm_), *grads, sizes);
 
   // Populate the output sequence tensors.
   TensorSeq* clipped_gradients = ctx->Output<TensorSeq>(0);
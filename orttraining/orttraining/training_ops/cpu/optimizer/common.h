@@ -5,7 +5,10 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace onnxruntime {
 namespace contrib {
@@ -19,6 +22,41 @@ TC compute_bias_correction_coefficient(const TC momentum_update_coefficient, con
   }
 }
 
+// Number of elements of the chunks the tensors of a multi-tensor optimizer are split into.
+constexpr int kMultiTensorChunkSize = 16384;
+
+/**
+ * Runs fn(tensor_index, offset, count) over all the elements of a group of tensors in a single parallel loop.
+ * The tensors are split into chunks of at most kMultiTensorChunkSize elements and the chunks of all the tensors are
+ * distributed over the thread pool together, so that a few large tensors and many small ones both keep the threads
+ * busy, as the multi-tensor apply of the CUDA optimizers does.
+ */
+template <typename Fn>
+void MultiTensorParallelFor(concurrency::ThreadPool* tp, const std::vector<int>& tensor_sizes,
+                            double cost_per_element, Fn&& fn) {
+  struct Chunk {
+    int tensor_index;
+    int offset;
+    int count;
+  };
+
+  std::vector<Chunk> chunks;
+  for (int i = 0, end = static_cast<int>(tensor_sizes.size()); i < end; ++i) {
+    for (int offset = 0; offset < tensor_sizes[i]; offset += kMultiTensorChunkSize) {
+      chunks.push_back({i, offset, std::min(kMultiTensorChunkSize, tensor_sizes[i] - offset)});
+    }
+  }
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(chunks.size()), cost_per_element * kMultiTensorChunkSize,
+      [&chunks, &fn](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t c = begin; c != end; ++c) {
+          const Chunk& chunk = chunks[c];
+          fn(chunk.tensor_index, chunk.offset, chunk.count);
+        }
+      });
+}
+
 Status CopyIfNotSameCPUBuffer(OpKernelContext* ctx, size_t number_of_values, const TensorSeq* src_values,
                               TensorSeq* dest_values);
 
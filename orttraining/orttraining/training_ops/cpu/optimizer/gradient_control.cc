@@ -6,6 +6,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/common.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
+#include "core/util/math.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -128,5 +129,61 @@ Status InPlaceAccumulatorV2<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+ONNX_OPERATOR_KERNEL_EX(
+    InPlaceGemmAccumulator,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .Alias(0, 1)  // accumulate tensors in-place
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    InPlaceGemmAccumulator<float>);
+
+template <typename T>
+Status InPlaceGemmAccumulator<T>::Compute(OpKernelContext* context) const {
+  Tensor* accumulation_buffer = const_cast<Tensor*>(context->Input<Tensor>(0));
+  const Tensor* A = context->Input<Tensor>(1);
+  const Tensor* B = context->Input<Tensor>(2);
+  const Tensor* overwrite_tensor = context->Input<Tensor>(3);
+
+  const auto& a_shape = A->Shape();
+  const auto& b_shape = B->Shape();
+  ORT_RETURN_IF_NOT(a_shape.NumDimensions() == 2 && b_shape.NumDimensions() == 2,
+                    "InPlaceGemmAccumulator expects 2D inputs, got A: ", a_shape, ", B: ", b_shape);
+  const int64_t M = trans_a_ ? a_shape[1] : a_shape[0];
+  const int64_t K = trans_a_ ? a_shape[0] : a_shape[1];
+  const int64_t N = trans_b_ ? b_shape[0] : b_shape[1];
+  ORT_RETURN_IF_NOT(K == (trans_b_ ? b_shape[1] : b_shape[0]),
+                    "InPlaceGemmAccumulator inner dimensions mismatch, A: ", a_shape, ", B: ", b_shape);
+  const TensorShape output_shape({M, N});
+  ORT_RETURN_IF_NOT(accumulation_buffer->Shape() == output_shape,
+                    "InPlaceGemmAccumulator accumulation buffer shape ", accumulation_buffer->Shape(),
+                    " does not match the product shape ", output_shape);
+
+  // beta = 1 accumulates the product into the buffer, beta = 0 overwrites it
+  const bool overwrite = overwrite_tensor != nullptr ? *(overwrite_tensor->template Data<bool>()) : false;
+  T* accumulation_buffer_data = accumulation_buffer->template MutableData<T>();
+  if (output_shape.Size() > 0) {
+    math::Gemm<T, concurrency::ThreadPool>(trans_a_ ? CblasTrans : CblasNoTrans,
+                                           trans_b_ ? CblasTrans : CblasNoTrans,
+                                           M, N, K, alpha_, A->template Data<T>(), B->template Data<T>(),
+                                           overwrite ? 0.0f : 1.0f, accumulation_buffer_data,
+                                           context->GetOperatorThreadPool());
+  }
+
+  Tensor* updated_output = context->Output(0, {1});
+  *updated_output->template MutableData<bool>() = true;
+
+  Tensor* accumulated_value_out = context->Output(1, output_shape);
+  if (nullptr != accumulated_value_out) {
+    void* output_data = accumulated_value_out->template MutableData<T>();
+    if (output_data != accumulation_buffer_data) {
+      memcpy(output_data, accumulation_buffer_data, accumulation_buffer->SizeInBytes());
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
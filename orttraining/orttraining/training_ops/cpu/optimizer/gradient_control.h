@@ -29,5 +29,22 @@ class InPlaceAccumulatorV2 final : public OpKernel {
   Status Compute(OpKernelContext* context) const override;
 };
 
+template <typename T>
+class InPlaceGemmAccumulator final : public OpKernel {
+ public:
+  InPlaceGemmAccumulator(const OpKernelInfo& info) : OpKernel(info) {
+    trans_a_ = info.GetAttrOrDefault<int64_t>("transA", 0) != 0;
+    trans_b_ = info.GetAttrOrDefault<int64_t>("transB", 0) != 0;
+    alpha_ = info.GetAttrOrDefault<float>("alpha", 1.0f);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  bool trans_a_;
+  bool trans_b_;
+  float alpha_;
+};
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -6,7 +6,6 @@
 #include "core/framework/op_kernel.h"
 #include "core/framework/TensorSeq.h"
 #include "core/providers/common.h"
-#include "core/providers/cpu/math/element_wise_ops.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -64,14 +63,20 @@ Status SGDOptimizerV2<T>::Compute(OpKernelContext* ctx) const {
   if (update_signal == nullptr || *update_signal->template Data<bool>()) {
     const float lr = *p.learning_rate->template Data<float>();
 
-    for (size_t weight_index = 0; weight_index < p.num_of_weights; ++weight_index) {
-      Tensor& weight = const_cast<Tensor&>(p.weights->Get(weight_index));
-      Tensor& gradient = const_cast<Tensor&>(p.gradients->Get(weight_index));
-
-      // new_weight = weight - lr * gradient
-      const auto& delta = -lr * MakeEigenArrayMap<T>(gradient);
-      MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) + delta;
-    }
+    // All the weights are updated in one parallel loop over chunks of their elements.
+    static constexpr double cost_per_element = 2.0;
+    MultiTensorParallelFor(
+        ctx->GetOperatorThreadPool(), p.grouped_tensor_sizes, cost_per_element,
+        [&p, lr](int tensor_index, int offset, int count) {
+          const auto& pointers = p.grouped_tensor_pointers[tensor_index];
+          T* weight = static_cast<T*>(pointers[0]) + offset;
+          const T* gradient = static_cast<const T*>(pointers[1]) + offset;
+
+          // new_weight = weight - lr * gradient
+          for (int i = 0; i < count; ++i) {
+            weight[i] -= lr * gradient[i];
+          }
+        });
 
     *updated_flag_ptr = true;
   } else {